@@ -49,6 +49,17 @@ public:
         return log_write_fmt(*w, level, rdtsc(), module_id, format_func_id, payload_size, args...);
     }
 
+    // 按 LogFmt 声明写格式化日志（对应 LOG_FMT），实参在编译期校验
+    template <typename Format, typename... Args>
+    bool log_fmt_checked(LogLevel level, uint8_t module_id, uint8_t format_func_id, const Args&... args) {
+        if (!is_initialized()) {
+            if (!init()) return false;
+        }
+        auto* w = writer();
+        if (!w) return false;
+        return log_write_fmt_checked<Format>(*w, level, rdtsc(), module_id, format_func_id, args...);
+    }
+
 private:
     DefaultSingleLog() = default;
     ~DefaultSingleLog() noexcept;
@@ -61,11 +72,10 @@ private:
 // 示例：
 //   LOG_FMT_DEFAULT(LogLevel::info, Module::module1, LogFormatFunc::format1, 3, 2);
 #define LOG_FMT_DEFAULT(level, module_enum, format_name, ...)                            \
-    base_core_log::DefaultSingleLog::instance().log_fmt(                                \
+    base_core_log::DefaultSingleLog::instance().log_fmt_checked<format_name##_args>(    \
         (level),                                                                        \
         static_cast<uint8_t>(module_enum),                                              \
         format_name##_id,                                                               \
-        format_name##_payload_size,                                                     \
         ##__VA_ARGS__)
 
 // 使用 DefaultSingleLog 写字符串日志的便捷宏（对应 LOG_STR）
@@ -2,14 +2,19 @@
 #include "logging/log_format_registry.hpp"
 #include "shm/shm_generic.hpp"
 
+#include <algorithm>
 #include <cerrno>
 #include <chrono>
 #include <cstdio>
 #include <ctime>
 #include <cstring>
 #include <fstream>
+#include <functional>
 #include <iostream>
+#include <limits>
+#include <queue>
 #include <thread>
+#include <utility>
 
 namespace base_core_log {
 
@@ -48,7 +53,7 @@ void log_write_failed(const char* reason) noexcept {
 }
 
 void LogBufferWriter::attach(LogShmHeader* header, LogEntry* buffer, std::size_t capacity,
-                            uint8_t* buffer_var, std::size_t buffer_var_size) noexcept {
+                            uint8_t* buffer_var, std::size_t buffer_var_size, LogShmStats* stats) noexcept {
     header_ = header;
     buffer_ = buffer;
     capacity_ = static_cast<uint32_t>(capacity);
@@ -56,14 +61,149 @@ void LogBufferWriter::attach(LogShmHeader* header, LogEntry* buffer, std::size_t
     buffer_var_ = buffer_var;
     buffer_var_size_ = static_cast<uint32_t>(buffer_var_size);
     write_index_var_ = header_ ? header_->write_index_var.load(std::memory_order_relaxed) : 0;
+    stats_ = stats;
+    fixed_written_ = stats_ ? stats_->fixed_written.load(std::memory_order_relaxed) : 0;
+    var_written_ = stats_ ? stats_->var_written.load(std::memory_order_relaxed) : 0;
+    pending_lost_ = 0;
 }
 
-bool LogBufferWriter::try_push(const LogEntry& e) noexcept {
-    if (!buffer_ || capacity_ == 0) return false;
+void LogBufferWriter::set_overflow_policy(LogOverflowPolicy policy, uint32_t spin_limit) noexcept {
+    for (LogOverflowPolicy& slot : module_policy_) {
+        slot = policy;
+    }
+    spin_limit_ = spin_limit;
+}
+
+void LogBufferWriter::set_module_policy(uint8_t module_id, LogOverflowPolicy policy) noexcept {
+    module_policy_[module_id] = policy;
+}
+
+namespace {
+
+inline void cpu_relax() noexcept {
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    __asm__ __volatile__("yield");
+#endif
+}
+
+}  // namespace
+
+bool LogBufferWriter::wait_fixed_space(LogOverflowPolicy policy, uint32_t needed) noexcept {
+    if (policy == LogOverflowPolicy::OverwriteOld) {
+        return true;
+    }
+    uint32_t spins = (policy == LogOverflowPolicy::BoundedSpin) ? spin_limit_ : 0;
+    for (;;) {
+        const uint64_t read = stats_->fixed_read.load(std::memory_order_acquire);
+        if (fixed_written_ - read + needed <= capacity_) {
+            return true;
+        }
+        if (spins == 0) {
+            return false;
+        }
+        --spins;
+        cpu_relax();
+    }
+}
+
+void LogBufferWriter::push_fixed(const LogEntry& e) noexcept {
     const uint32_t idx = write_index_ % capacity_;
+    if (stats_ && fixed_written_ - stats_->fixed_read.load(std::memory_order_relaxed) >= capacity_) {
+        // 只有 OverwriteOld 会走到这里：被覆盖槽位的模块号仍在原条目里
+        stats_->overwritten.fetch_add(1, std::memory_order_relaxed);
+        stats_->lost_by_module[buffer_[idx].module_id].fetch_add(1, std::memory_order_relaxed);
+    }
     buffer_[idx] = e;
     write_index_ = (idx + 1) % capacity_;
     header_->write_index.store(write_index_, std::memory_order_release);
+    if (stats_) {
+        ++fixed_written_;
+        stats_->fixed_written.store(fixed_written_, std::memory_order_release);
+    }
+}
+
+void LogBufferWriter::record_drop(uint8_t module_id) noexcept {
+    stats_->total_dropped.fetch_add(1, std::memory_order_relaxed);
+    stats_->lost_by_module[module_id].fetch_add(1, std::memory_order_relaxed);
+    ++pending_lost_;
+}
+
+void LogBufferWriter::emit_pending_overrun(uint32_t reserve) noexcept {
+    if (pending_lost_ == 0 || fixed_written_ - stats_->fixed_read.load(std::memory_order_acquire) + reserve + 1 >
+                                  capacity_) {
+        return;
+    }
+    LogEntry marker{};
+    marker.ts_tsc = rdtsc();
+    marker.type_id = static_cast<uint8_t>(LogTypeId::Overrun);
+    marker.level = static_cast<uint8_t>(LogLevel::warn);
+    marker.payload_size = sizeof(pending_lost_);
+    std::memcpy(marker.payload, &pending_lost_, sizeof(pending_lost_));
+    push_fixed(marker);
+    pending_lost_ = 0;
+}
+
+bool LogBufferWriter::try_push(const LogEntry& e) noexcept {
+    if (!buffer_ || capacity_ == 0) return false;
+    if (stats_) {
+        const LogOverflowPolicy policy = module_policy_[e.module_id];
+        if (policy != LogOverflowPolicy::OverwriteOld) {
+            if (!wait_fixed_space(policy, 1)) {
+                record_drop(e.module_id);
+                return true;
+            }
+            emit_pending_overrun(1);
+        }
+    }
+    push_fixed(e);
+    return true;
+}
+
+bool LogBufferWriter::reserve_variable(uint8_t module_id, std::size_t entry_size, uint32_t& out_offset) noexcept {
+    uint32_t idx = write_index_var_ % buffer_var_size_;
+    const uint32_t skip = (idx + entry_size > buffer_var_size_) ? buffer_var_size_ - idx : 0;
+    if (stats_) {
+        const LogOverflowPolicy policy = module_policy_[module_id];
+        const uint64_t needed = skip + entry_size;
+        uint32_t spins = (policy == LogOverflowPolicy::BoundedSpin) ? spin_limit_ : 0;
+        for (;;) {
+            const uint64_t used = var_written_ - stats_->var_read.load(std::memory_order_acquire);
+            if (used + needed <= buffer_var_size_) {
+                break;
+            }
+            if (policy == LogOverflowPolicy::OverwriteOld) {
+                // 变长区无法定位被覆盖的条目，计一条并归入 0 号模块
+                stats_->overwritten.fetch_add(1, std::memory_order_relaxed);
+                stats_->lost_by_module[0].fetch_add(1, std::memory_order_relaxed);
+                break;
+            }
+            if (spins == 0) {
+                record_drop(module_id);
+                return false;
+            }
+            --spins;
+            cpu_relax();
+        }
+        if (policy != LogOverflowPolicy::OverwriteOld) {
+            emit_pending_overrun(0);
+        }
+    }
+
+    if (skip > 0) {
+        // 尾部放不下整条：能放下 header 时写回绕标记，否则读端按剩余不足一个 header 自行回绕
+        if (skip >= sizeof(LogVarEntryHeader)) {
+            LogVarEntryHeader wrap{};
+            wrap.type_id = static_cast<uint8_t>(LogTypeId::VarWrap);
+            std::memcpy(buffer_var_ + idx, &wrap, sizeof(wrap));
+        }
+        idx = 0;
+    }
+    if (stats_) {
+        var_written_ += skip + entry_size;
+    }
+    out_offset = idx;
     return true;
 }
 
@@ -74,9 +214,9 @@ bool LogBufferWriter::try_push_variable(uint64_t ts_tsc, uint8_t type_id, uint8_
     const std::size_t entry_size = sizeof(LogVarEntryHeader) + payload_size;
     if (entry_size > buffer_var_size_) return false;
 
-    uint32_t idx = write_index_var_ % buffer_var_size_;
-    if (idx + entry_size > buffer_var_size_) {
-        idx = 0;
+    uint32_t idx = 0;
+    if (!reserve_variable(module_id, entry_size, idx)) {
+        return true;
     }
 
     LogVarEntryHeader hdr{};
@@ -92,6 +232,9 @@ bool LogBufferWriter::try_push_variable(uint64_t ts_tsc, uint8_t type_id, uint8_
 
     write_index_var_ = static_cast<uint32_t>((idx + entry_size) % buffer_var_size_);
     header_->write_index_var.store(write_index_var_, std::memory_order_release);
+    if (stats_) {
+        stats_->var_written.store(var_written_, std::memory_order_release);
+    }
     return true;
 }
 
@@ -101,10 +244,10 @@ bool LogBufferWriter::try_push_variable_str(uint64_t ts_tsc, uint8_t level, uint
     const uint16_t payload_size = static_cast<uint16_t>(len + 1);
     if (payload_size > buffer_var_size_ - sizeof(LogVarEntryHeader)) return false;
 
-    uint32_t idx = write_index_var_ % buffer_var_size_;
     const std::size_t entry_size = sizeof(LogVarEntryHeader) + payload_size;
-    if (idx + entry_size > buffer_var_size_) {
-        idx = 0;
+    uint32_t idx = 0;
+    if (!reserve_variable(module_id, entry_size, idx)) {
+        return true;
     }
 
     LogVarEntryHeader hdr{};
@@ -121,16 +264,30 @@ bool LogBufferWriter::try_push_variable_str(uint64_t ts_tsc, uint8_t level, uint
 
     write_index_var_ = static_cast<uint32_t>((idx + entry_size) % buffer_var_size_);
     header_->write_index_var.store(write_index_var_, std::memory_order_release);
+    if (stats_) {
+        stats_->var_written.store(var_written_, std::memory_order_release);
+    }
     return true;
 }
 
 ShmLogger::~ShmLogger() noexcept { close(); }
 
+namespace {
+
+// per_thread 环序号：进程内按 init 顺序递增
+std::atomic<std::size_t> g_next_ring_index{0};
+
+}  // namespace
+
 bool ShmLogger::init(const ShmLogConfig& config) {
     close();
-    const std::string& shm_name = config.shm_name;
+    std::string shm_name = config.shm_name;
+    if (config.per_thread) {
+        thread_id_ = g_next_ring_index.fetch_add(1, std::memory_order_relaxed);
+        shm_name += "_" + std::to_string(thread_id_);
+    }
     const std::size_t layout_size = sizeof(LogShmHeader) +
-        config.buffer_capacity * sizeof(LogEntry) + ShmLogger::kBufferVarSize;
+        config.buffer_capacity * sizeof(LogEntry) + ShmLogger::kBufferVarSize + sizeof(LogShmStats);
     if (!shm::create_if_not_exists(shm_name, layout_size)) {
         return false;
     }
@@ -154,17 +311,21 @@ bool ShmLogger::init(const ShmLogConfig& config) {
         hdr->write_index_var.store(0, std::memory_order_relaxed);
         hdr->buffer_var_size = static_cast<uint32_t>(ShmLogger::kBufferVarSize);
     }
-    uint8_t* var_buf = (hdr->version == 3 && layout_size >= ShmLogger::kLayoutSize)
+    uint8_t* var_buf = (hdr->version == 3 && layout_size >= ShmLogger::kLegacyLayoutSize)
                            ? buf_var
                            : nullptr;
     std::size_t var_size = var_buf ? ShmLogger::kBufferVarSize : 0;
-    writer_impl_.attach(hdr, buf, config.buffer_capacity, var_buf, var_size);
+    // 统计区紧跟变长区；新建的共享内存由 ftruncate 清零，计数从 0 开始
+    stats_ = var_buf ? reinterpret_cast<LogShmStats*>(buf_var + ShmLogger::kBufferVarSize) : nullptr;
+    writer_impl_.attach(hdr, buf, config.buffer_capacity, var_buf, var_size, stats_);
+    writer_impl_.set_overflow_policy(config.overflow_policy, config.overflow_spin_limit);
     return true;
 }
 
 void ShmLogger::close() noexcept {
     writer_impl_.attach(nullptr, nullptr, 0, nullptr, 0);
     layout_ptr_ = nullptr;
+    stats_ = nullptr;
     layout_size_ = 0;
     writer_.close();
 }
@@ -185,6 +346,10 @@ const LogShmHeader* ShmLogger::header() const noexcept {
     return static_cast<const LogShmHeader*>(layout_ptr_);
 }
 
+LogShmStats* ShmLogger::stats() noexcept { return stats_; }
+
+const LogShmStats* ShmLogger::stats() const noexcept { return stats_; }
+
 bool ShmLogger::is_open() const noexcept { return layout_ptr_ != nullptr; }
 
 bool init_shm_logger(const ShmLogConfig& config, ShmLogger& logger) {
@@ -202,7 +367,7 @@ bool init_shm_logger(const ShmLogConfig& config, ShmLogger& logger) {
 }
 
 // TSC 转纳秒（Unix Epoch）
-static uint64_t tsc_to_ns(uint64_t tsc, const LogShmHeader* header) {
+uint64_t log_tsc_to_ns(uint64_t tsc, const LogShmHeader* header) noexcept {
     if (!header || header->tsc_freq_ghz <= 0 || header->tsc_freq_ghz > 10.0) {
         return 0;
     }
@@ -224,11 +389,11 @@ static void format_timestamp_ns(uint64_t ns, char* buf, std::size_t buf_size) {
 }
 
 void decode_log_entry(const LogEntry& e, const LogShmHeader* header, char* buf, std::size_t buf_size,
-                      ModuleNameMapper module_mapper) {
+                      ModuleNameMapper module_mapper, const LogFormatTable* formats) {
     if (buf_size < 64) return;
 
     char time_buf[36];
-    const uint64_t ns = tsc_to_ns(e.ts_tsc, header);
+    const uint64_t ns = log_tsc_to_ns(e.ts_tsc, header);
     format_timestamp_ns(ns, time_buf, sizeof(time_buf));
 
     const char* mod = (e.module_id != 0 && module_mapper)
@@ -239,8 +404,10 @@ void decode_log_entry(const LogEntry& e, const LogShmHeader* header, char* buf,
     switch (static_cast<LogTypeId>(e.type_id)) {
         case LogTypeId::MsgFormat: {
             char msg_buf[256];
-            if (base_core_log::LogFormatRegistry::decode(
-                    e.msg_id, e.payload, e.payload_size, msg_buf, sizeof(msg_buf))) {
+            const bool decoded =
+                formats ? formats->decode(e.msg_id, e.payload, e.payload_size, msg_buf, sizeof(msg_buf))
+                        : LogFormatRegistry::decode(e.msg_id, e.payload, e.payload_size, msg_buf, sizeof(msg_buf));
+            if (decoded) {
                 n = std::snprintf(buf, buf_size, "[%s][%s][%s] %s\n",
                     time_buf, to_string(static_cast<LogLevel>(e.level)), mod, msg_buf);
             } else {
@@ -259,6 +426,13 @@ void decode_log_entry(const LogEntry& e, const LogShmHeader* header, char* buf,
                 time_buf, to_string(static_cast<LogLevel>(e.level)), mod, str_buf);
             break;
         }
+        case LogTypeId::Overrun: {
+            uint64_t lost = 0;
+            std::memcpy(&lost, e.payload, sizeof(lost));
+            n = std::snprintf(buf, buf_size, "[%s][%s][log_writer] overrun: %llu entries dropped by writer\n",
+                time_buf, to_string(static_cast<LogLevel>(e.level)), static_cast<unsigned long long>(lost));
+            break;
+        }
         default:
             n = std::snprintf(buf, buf_size, "[%s][%s][%s] unknown type_id=%u\n",
                 time_buf, to_string(static_cast<LogLevel>(e.level)), mod, e.type_id);
@@ -268,11 +442,11 @@ void decode_log_entry(const LogEntry& e, const LogShmHeader* header, char* buf,
 
 void decode_log_entry_var(const LogVarEntryHeader& hdr, const uint8_t* payload,
                           const LogShmHeader* header, char* buf, std::size_t buf_size,
-                          ModuleNameMapper module_mapper) {
+                          ModuleNameMapper module_mapper, const LogFormatTable* formats) {
     if (!payload || buf_size < 64) return;
 
     char time_buf[36];
-    const uint64_t ns = tsc_to_ns(hdr.ts_tsc, header);
+    const uint64_t ns = log_tsc_to_ns(hdr.ts_tsc, header);
     format_timestamp_ns(ns, time_buf, sizeof(time_buf));
 
     const char* mod = (hdr.module_id != 0 && module_mapper)
@@ -283,8 +457,10 @@ void decode_log_entry_var(const LogVarEntryHeader& hdr, const uint8_t* payload,
     switch (static_cast<LogTypeId>(hdr.type_id)) {
         case LogTypeId::MsgFormat: {
             char msg_buf[256];
-            if (base_core_log::LogFormatRegistry::decode(
-                    hdr.msg_id, payload, hdr.payload_size, msg_buf, sizeof(msg_buf))) {
+            const bool decoded =
+                formats ? formats->decode(hdr.msg_id, payload, hdr.payload_size, msg_buf, sizeof(msg_buf))
+                        : LogFormatRegistry::decode(hdr.msg_id, payload, hdr.payload_size, msg_buf, sizeof(msg_buf));
+            if (decoded) {
                 n = std::snprintf(buf, buf_size, "[%s][%s][%s] %s\n",
                     time_buf, to_string(static_cast<LogLevel>(hdr.level)), mod, msg_buf);
             } else {
@@ -327,12 +503,67 @@ namespace {
 
 constexpr std::size_t kDecodeBufSize = 512;
 
+// 带统计区的环：按单调进度逐条回调新条目，读完发布消费进度；落后超过一圈时先回调 on_lag
+template <typename FixedFn, typename VarFn, typename LagFn>
+int consume_stats_ring(const LogShmHeader* header, const LogEntry* buffer, const uint8_t* buffer_var,
+                       LogShmStats* stats, uint64_t& fixed_read, uint64_t& var_read, uint32_t& var_offset,
+                       FixedFn&& on_fixed, VarFn&& on_var, LagFn&& on_lag) {
+    int count = 0;
+    constexpr std::size_t kCapacity = ShmLogger::kBufferCapacity;
+
+    // 固定区：落后超过一圈的部分已被覆盖，跳到仍有效的最旧条目
+    const uint64_t fixed_written = stats->fixed_written.load(std::memory_order_acquire);
+    if (fixed_written - fixed_read > kCapacity) {
+        on_lag("fixed", fixed_written - fixed_read - kCapacity, "entries");
+        fixed_read = fixed_written - kCapacity;
+    }
+    for (; fixed_read != fixed_written; ++fixed_read) {
+        on_fixed(buffer[fixed_read % kCapacity]);
+        ++count;
+    }
+    stats->fixed_read.store(fixed_read, std::memory_order_release);
+
+    // 变长区：被覆盖后找不到条目边界，直接对齐到写端当前位置
+    const uint32_t var_size = header->buffer_var_size;
+    const uint64_t var_written = stats->var_written.load(std::memory_order_acquire);
+    if (var_written - var_read > var_size) {
+        on_lag("variable", var_written - var_read, "bytes");
+        var_read = var_written;
+        var_offset = header->write_index_var.load(std::memory_order_acquire);
+    }
+    while (var_read < var_written) {
+        const uint32_t remaining = var_size - var_offset;
+        const auto* hdr = reinterpret_cast<const LogVarEntryHeader*>(buffer_var + var_offset);
+        if (remaining < sizeof(LogVarEntryHeader) || hdr->type_id == static_cast<uint8_t>(LogTypeId::VarWrap)) {
+            var_read += remaining;
+            var_offset = 0;
+            continue;
+        }
+        const std::size_t entry_size = sizeof(LogVarEntryHeader) + hdr->payload_size;
+        if (entry_size > remaining) {
+            break;
+        }
+
+        on_var(*hdr, buffer_var + var_offset + sizeof(LogVarEntryHeader));
+        ++count;
+
+        var_read += entry_size;
+        var_offset = static_cast<uint32_t>((var_offset + entry_size) % var_size);
+    }
+    stats->var_read_offset.store(var_offset, std::memory_order_relaxed);
+    stats->var_read.store(var_read, std::memory_order_release);
+    return count;
+}
+
 }  // namespace
 
 LogReader::LogReader(std::string shm_name, std::string output_path, ModuleNameMapper module_mapper)
     : shm_name_(std::move(shm_name)), output_path_(std::move(output_path)),
       module_mapper_(module_mapper) {}
 
+LogReader::LogReader(std::string shm_name, base_core::AsyncFileWriter& output, ModuleNameMapper module_mapper)
+    : shm_name_(std::move(shm_name)), module_mapper_(module_mapper), out_(&output) {}
+
 LogReader::~LogReader() {
     close();
 }
@@ -342,8 +573,11 @@ bool LogReader::init() {
         return true;
     }
 
-    // 尝试打开 v3 布局
+    // 依次尝试带统计区的 v3 布局、旧 v3 布局、v2 布局
     ptr_ = writer_.open(shm_name_, ShmLogger::kLayoutSize);
+    if (!ptr_) {
+        ptr_ = writer_.open(shm_name_, ShmLogger::kLegacyLayoutSize);
+    }
     if (!ptr_) {
         // 回退到 v2 布局
         constexpr std::size_t kV2LayoutSize =
@@ -380,9 +614,14 @@ bool LogReader::init() {
         buffer_var_ = reinterpret_cast<const uint8_t*>(base + ShmLogger::kBufferCapacity * sizeof(LogEntry));
     }
 
-    // 打开输出文件
-    out_.open(output_path_, std::ios::app);
-    if (!out_) {
+    if (buffer_var_ && writer_.size() == ShmLogger::kLayoutSize) {
+        stats_ = reinterpret_cast<LogShmStats*>(static_cast<char*>(ptr_) + ShmLogger::kLegacyLayoutSize);
+    }
+
+    // 打开输出文件（借用的写出器由调用方打开）
+    base_core::AsyncFileWriterConfig out_config;
+    out_config.buffer_bytes = kOutputBufferSize;
+    if (out_ == &own_out_ ? !own_out_.open(output_path_, false, out_config) : !out_->is_open()) {
         shm::log_error("logReader: failed to open output path=" + output_path_);
         writer_.close();
         ptr_ = nullptr;
@@ -392,18 +631,58 @@ bool LogReader::init() {
         return false;
     }
 
-    // 初始化读取位置
+    // 初始化读取位置；有统计区时从已发布的消费进度继续
     last_read_index_ = 0;
     last_read_index_var_ = 0;
+    if (stats_) {
+        fixed_read_ = stats_->fixed_read.load(std::memory_order_acquire);
+        var_read_ = stats_->var_read.load(std::memory_order_acquire);
+        var_offset_ = stats_->var_read_offset.load(std::memory_order_acquire);
+    }
     initialized_ = true;
 
     return true;
 }
 
+void LogReader::write_reader_overrun(const char* region, uint64_t lost, const char* unit) {
+    char time_buf[36];
+    format_timestamp_ns(now_ns(), time_buf, sizeof(time_buf));
+    char line[160];
+    const int size =
+        std::snprintf(line, sizeof(line), "[%s][WARN][log_reader] overrun: reader lagged, %llu %s lost in %s region\n",
+                      time_buf, static_cast<unsigned long long>(lost), unit, region);
+    if (size > 0) {
+        out_->write(line, std::min(static_cast<std::size_t>(size), sizeof(line) - 1));
+    }
+}
+
+int LogReader::read_with_stats() {
+    char buf[kDecodeBufSize];
+    const int count = consume_stats_ring(
+        header_, buffer_, buffer_var_, stats_, fixed_read_, var_read_, var_offset_,
+        [&](const LogEntry& e) {
+            decode_log_entry(e, header_, buf, sizeof(buf), module_mapper_);
+            out_->write(std::string_view(buf));
+        },
+        [&](const LogVarEntryHeader& hdr, const uint8_t* payload) {
+            decode_log_entry_var(hdr, payload, header_, buf, sizeof(buf), module_mapper_);
+            out_->write(std::string_view(buf));
+        },
+        [&](const char* region, uint64_t lost, const char* unit) { write_reader_overrun(region, lost, unit); });
+
+    if (count > 0) {
+        out_->flush();
+    }
+    return count;
+}
+
 int LogReader::read_new() {
     if (!initialized_ || !header_ || !buffer_) {
         return -1;
     }
+    if (stats_) {
+        return read_with_stats();
+    }
 
     char buf[kDecodeBufSize];
     int count = 0;
@@ -418,13 +697,13 @@ int LogReader::read_new() {
         // 先读取 [last_read_index_, kCapacity)
         for (uint32_t i = last_read_index_; i < kCapacity; ++i) {
             decode_log_entry(buffer_[i], header_, buf, sizeof(buf), module_mapper_);
-            out_ << buf;
+            out_->write(std::string_view(buf));
             ++count;
         }
         // 再读取 [0, write_index)
         for (uint32_t i = 0; i < write_index; ++i) {
             decode_log_entry(buffer_[i], header_, buf, sizeof(buf), module_mapper_);
-            out_ << buf;
+            out_->write(std::string_view(buf));
             ++count;
         }
     } else {
@@ -432,7 +711,7 @@ int LogReader::read_new() {
         for (uint32_t i = last_read_index_; i != write_index;
              i = (i + 1) % static_cast<uint32_t>(kCapacity)) {
             decode_log_entry(buffer_[i], header_, buf, sizeof(buf), module_mapper_);
-            out_ << buf;
+            out_->write(std::string_view(buf));
             ++count;
         }
     }
@@ -458,7 +737,7 @@ int LogReader::read_new() {
             }
 
             decode_log_entry_var(*hdr, payload, header_, buf, sizeof(buf), module_mapper_);
-            out_ << buf;
+            out_->write(std::string_view(buf));
             ++count;
 
             pos += sizeof(LogVarEntryHeader) + payload_size;
@@ -467,7 +746,7 @@ int LogReader::read_new() {
     }
 
     if (count > 0) {
-        out_.flush();
+        out_->flush();
     }
 
     return count;
@@ -478,6 +757,12 @@ int LogReader::run() {
     if (!init()) {
         return 1;
     }
+    // 有统计区时读取全部未消费条目并发布进度，写端的满检测据此放行
+    if (stats_) {
+        read_with_stats();
+        close();
+        return 0;
+    }
 
     // 读取所有现有数据
     int total = 0;
@@ -492,7 +777,7 @@ int LogReader::run() {
          read_index = (read_index + 1) % static_cast<uint32_t>(kCapacity)) {
         char buf[kDecodeBufSize];
         decode_log_entry(buffer_[read_index], header_, buf, sizeof(buf), module_mapper_);
-        out_ << buf;
+        out_->write(std::string_view(buf));
         ++total;
     }
 
@@ -511,22 +796,23 @@ int LogReader::run() {
             }
 
             decode_log_entry_var(*hdr, payload, header_, buf, sizeof(buf), module_mapper_);
-            out_ << buf;
+            out_->write(std::string_view(buf));
             ++total;
 
             pos += sizeof(LogVarEntryHeader) + payload_size;
         }
     }
 
-    out_.flush();
     close();
 
     return 0;
 }
 
 void LogReader::close() {
-    if (out_.is_open()) {
-        out_.close();
+    if (out_ == &own_out_) {
+        own_out_.close();
+    } else {
+        out_->flush();
     }
     writer_.close();
     ptr_ = nullptr;
@@ -535,11 +821,233 @@ void LogReader::close() {
     buffer_var_ = nullptr;
     last_read_index_ = 0;
     last_read_index_var_ = 0;
+    stats_ = nullptr;
+    fixed_read_ = 0;
+    var_read_ = 0;
+    var_offset_ = 0;
     initialized_ = false;
 }
 
 bool LogReader::is_open() const noexcept {
-    return initialized_ && writer_.is_open() && out_.is_open();
+    return initialized_ && writer_.is_open() && out_->is_open();
+}
+
+// ============ LogMergeReader ============
+LogMergeReader::LogMergeReader(std::vector<std::string> shm_names, std::string output_path,
+                               ModuleNameMapper module_mapper, uint64_t hold_back_ns)
+    : shm_names_(std::move(shm_names)), output_path_(std::move(output_path)), module_mapper_(module_mapper),
+      hold_back_ns_(hold_back_ns) {}
+
+LogMergeReader::~LogMergeReader() { close(); }
+
+std::vector<std::string> LogMergeReader::per_thread_names(const std::string& base_name, std::size_t count) {
+    std::vector<std::string> names;
+    names.reserve(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        names.push_back(base_name + "_" + std::to_string(i));
+    }
+    return names;
+}
+
+bool LogMergeReader::init() {
+    if (initialized_) {
+        return true;
+    }
+    if (shm_names_.empty()) {
+        shm::log_error("logMergeReader: no shm names");
+        return false;
+    }
+
+    rings_.resize(shm_names_.size());
+    streams_.resize(shm_names_.size() * 2);
+    for (std::size_t i = 0; i < rings_.size(); ++i) {
+        Ring& ring = rings_[i];
+        void* ptr = ring.shm.open(shm_names_[i], ShmLogger::kLayoutSize);
+        if (!ptr) {
+            shm::log_error("logMergeReader: failed to open shm name=" + shm_names_[i]);
+            close();
+            return false;
+        }
+        ring.header = static_cast<const LogShmHeader*>(ptr);
+        if (ring.header->magic != 0x4C4F4753 || ring.header->version != 3 ||
+            ring.header->buffer_var_size != ShmLogger::kBufferVarSize) {
+            shm::log_error("logMergeReader: unsupported shm layout name=" + shm_names_[i]);
+            close();
+            return false;
+        }
+        const auto* base = static_cast<const char*>(ptr) + sizeof(LogShmHeader);
+        ring.buffer = reinterpret_cast<const LogEntry*>(base);
+        ring.buffer_var = reinterpret_cast<const uint8_t*>(base + ShmLogger::kBufferCapacity * sizeof(LogEntry));
+        ring.stats = reinterpret_cast<LogShmStats*>(static_cast<char*>(ptr) + ShmLogger::kLegacyLayoutSize);
+        ring.fixed_read = ring.stats->fixed_read.load(std::memory_order_acquire);
+        ring.var_read = ring.stats->var_read.load(std::memory_order_acquire);
+        ring.var_offset = ring.stats->var_read_offset.load(std::memory_order_acquire);
+
+        streams_[2 * i].ring = i;
+        streams_[2 * i + 1].ring = i;
+        streams_[2 * i + 1].variable = true;
+    }
+
+    base_core::AsyncFileWriterConfig out_config;
+    out_config.buffer_bytes = kOutputBufferSize;
+    if (!out_.open(output_path_, false, out_config)) {
+        shm::log_error("logMergeReader: failed to open output path=" + output_path_);
+        close();
+        return false;
+    }
+    initialized_ = true;
+    return true;
+}
+
+void LogMergeReader::collect() {
+    const uint64_t now_tsc = rdtsc();
+    for (std::size_t i = 0; i < rings_.size(); ++i) {
+        Ring& ring = rings_[i];
+        Stream& fixed = streams_[2 * i];
+        Stream& variable = streams_[2 * i + 1];
+        const auto append = [](Stream& stream, const void* data, std::size_t size, uint64_t ts_tsc) {
+            const auto* bytes = static_cast<const uint8_t*>(data);
+            stream.records.push_back(PendingRecord{ts_tsc, static_cast<uint32_t>(stream.bytes.size()),
+                                                   static_cast<uint32_t>(size)});
+            stream.bytes.insert(stream.bytes.end(), bytes, bytes + size);
+            stream.frontier = std::max(stream.frontier, ts_tsc);
+        };
+        consume_stats_ring(
+            ring.header, ring.buffer, ring.buffer_var, ring.stats, ring.fixed_read, ring.var_read, ring.var_offset,
+            [&](const LogEntry& e) { append(fixed, &e, sizeof(LogEntry), e.ts_tsc); },
+            [&](const LogVarEntryHeader& hdr, const uint8_t* /*payload*/) {
+                // header 与 payload 在变长区内连续
+                append(variable, &hdr, sizeof(LogVarEntryHeader) + hdr.payload_size, hdr.ts_tsc);
+            },
+            [&](const char* region, uint64_t lost, const char* unit) {
+                write_reader_overrun(shm_names_[i], region, lost, unit);
+            });
+
+        // 写端在写入前取 ts，尚未发布的条目 ts 不早于 now - hold_back；空闲流据此推进，不会拖住其他环
+        const double freq = ring.header->tsc_freq_ghz;
+        const uint64_t hold_back_tsc =
+            (freq > 0 && freq <= 10.0) ? static_cast<uint64_t>(static_cast<double>(hold_back_ns_) * freq) : 0;
+        const uint64_t idle_frontier = now_tsc > hold_back_tsc ? now_tsc - hold_back_tsc : 0;
+        fixed.frontier = std::max(fixed.frontier, idle_frontier);
+        variable.frontier = std::max(variable.frontier, idle_frontier);
+    }
+}
+
+void LogMergeReader::write_record(const Stream& stream, const PendingRecord& record) {
+    char buf[kDecodeBufSize];
+    const LogShmHeader* header = rings_[stream.ring].header;
+    const uint8_t* bytes = stream.bytes.data() + record.offset;
+    // 暂存区按字节拼接，拷回对齐的结构体再解码
+    if (stream.variable) {
+        LogVarEntryHeader hdr;
+        std::memcpy(&hdr, bytes, sizeof(hdr));
+        decode_log_entry_var(hdr, bytes + sizeof(hdr), header, buf, sizeof(buf), module_mapper_);
+    } else {
+        LogEntry e;
+        std::memcpy(&e, bytes, sizeof(e));
+        decode_log_entry(e, header, buf, sizeof(buf), module_mapper_);
+    }
+    out_.write(std::string_view(buf));
+}
+
+int LogMergeReader::emit_until(uint64_t watermark) {
+    // 小顶堆：(ts, 流下标)，同 ts 时按流下标保证输出稳定
+    using HeapItem = std::pair<uint64_t, std::size_t>;
+    std::priority_queue<HeapItem, std::vector<HeapItem>, std::greater<HeapItem>> heap;
+    for (std::size_t i = 0; i < streams_.size(); ++i) {
+        const Stream& stream = streams_[i];
+        if (stream.head < stream.records.size() && stream.records[stream.head].ts_tsc <= watermark) {
+            heap.emplace(stream.records[stream.head].ts_tsc, i);
+        }
+    }
+
+    int count = 0;
+    while (!heap.empty()) {
+        Stream& stream = streams_[heap.top().second];
+        heap.pop();
+        write_record(stream, stream.records[stream.head]);
+        ++count;
+        ++stream.head;
+        if (stream.head < stream.records.size() && stream.records[stream.head].ts_tsc <= watermark) {
+            heap.emplace(stream.records[stream.head].ts_tsc, static_cast<std::size_t>(&stream - streams_.data()));
+        }
+    }
+
+    // 丢掉已输出的前缀，剩余条目（水位之后）平移到暂存区开头
+    for (Stream& stream : streams_) {
+        if (stream.head == 0) {
+            continue;
+        }
+        if (stream.head == stream.records.size()) {
+            stream.records.clear();
+            stream.bytes.clear();
+        } else {
+            const uint32_t base = stream.records[stream.head].offset;
+            stream.records.erase(stream.records.begin(),
+                                 stream.records.begin() + static_cast<std::ptrdiff_t>(stream.head));
+            stream.bytes.erase(stream.bytes.begin(), stream.bytes.begin() + base);
+            for (PendingRecord& record : stream.records) {
+                record.offset -= base;
+            }
+        }
+        stream.head = 0;
+    }
+
+    if (count > 0) {
+        out_.flush();
+    }
+    return count;
+}
+
+void LogMergeReader::write_reader_overrun(const std::string& ring_name, const char* region, uint64_t lost,
+                                          const char* unit) {
+    char time_buf[36];
+    format_timestamp_ns(now_ns(), time_buf, sizeof(time_buf));
+    char line[256];
+    const int size = std::snprintf(line, sizeof(line),
+                                   "[%s][WARN][log_reader] overrun: reader lagged, %llu %s lost in %s region of %s\n",
+                                   time_buf, static_cast<unsigned long long>(lost), unit, region, ring_name.c_str());
+    if (size > 0) {
+        out_.write(line, std::min(static_cast<std::size_t>(size), sizeof(line) - 1));
+    }
+}
+
+int LogMergeReader::read_new() {
+    if (!initialized_) {
+        return -1;
+    }
+    collect();
+    uint64_t watermark = std::numeric_limits<uint64_t>::max();
+    for (const Stream& stream : streams_) {
+        watermark = std::min(watermark, stream.frontier);
+    }
+    return emit_until(watermark);
+}
+
+int LogMergeReader::finish() {
+    if (!initialized_) {
+        return -1;
+    }
+    collect();
+    return emit_until(std::numeric_limits<uint64_t>::max());
 }
 
+int LogMergeReader::run() {
+    if (!init()) {
+        return 1;
+    }
+    finish();
+    close();
+    return 0;
+}
+
+void LogMergeReader::close() {
+    out_.close();
+    rings_.clear();
+    streams_.clear();
+    initialized_ = false;
+}
+
+bool LogMergeReader::is_open() const noexcept { return initialized_ && out_.is_open(); }
+
 }  // namespace base_core_log
@@ -3,13 +3,17 @@
 #include <atomic>
 #include <cstddef>
 #include <cstdint>
+#include <cstdio>
 #include <cstring>
 #include <fstream>
 #include <string>
 #include <string_view>
 #include <type_traits>
+#include <vector>
  
+#include "logging/log_format_registry.hpp"
 #include "shm/shm_generic.hpp"
+#include "utils/async_file_writer.hpp"
 
 namespace base_core_log {
 
@@ -26,6 +30,15 @@ enum class LogLevel : uint8_t {
 enum class LogTypeId : uint8_t {
     MsgFormat = 6,     // format_func_id + payload（LogFormatFunc）
     MsgString = 7,     // payload 中直接存字符串
+    Overrun = 8,       // 写端丢弃标记：payload 为自上一标记以来丢弃的条目数（uint64）
+    VarWrap = 9,       // 变长区回绕标记：读端跳到变长区起点继续读
+};
+
+// 环形区写满（读端尚未消费）时的写端策略
+enum class LogOverflowPolicy : uint8_t {
+    OverwriteOld = 0,  // 不等待读端，覆盖最旧的未读条目（默认，与历史行为一致）
+    DropNew = 1,       // 丢弃新条目并计数，写端不阻塞
+    BoundedSpin = 2,   // 自旋等待读端推进，超过 overflow_spin_limit 次后按 DropNew 处理
 };
 
 // payload 最大字节数
@@ -108,15 +121,53 @@ std::size_t payload_size(const T& first, const Rest&... rest) {
     }
 }
 
+// 实参能否无损写成声明类型：同类型，或整数/浮点间不丢值域的拓宽（字面量 3 可写入 int64_t，long 不能写入 int）
+template <typename From, typename To>
+constexpr bool log_fmt_lossless() {
+    using F = std::remove_cv_t<std::remove_reference_t<From>>;
+    if constexpr (std::is_same_v<F, To>) {
+        return true;
+    } else if constexpr (std::is_same_v<F, bool> || std::is_same_v<To, bool>) {
+        return false;
+    } else if constexpr (std::is_integral_v<F> && std::is_integral_v<To>) {
+        if constexpr (std::is_signed_v<F> == std::is_signed_v<To>) {
+            return sizeof(F) <= sizeof(To);
+        } else {
+            return std::is_unsigned_v<F> && sizeof(F) < sizeof(To);
+        }
+    } else if constexpr (std::is_floating_point_v<F> && std::is_floating_point_v<To>) {
+        return sizeof(F) <= sizeof(To);
+    } else {
+        return false;
+    }
+}
+
+template <typename T, typename A>
+inline void pack_checked_one(uint8_t* dst, std::size_t& offset, const A& arg) noexcept {
+    static_assert(log_fmt_lossless<A, T>(), "LOG_FMT argument type does not match the LogFmt declaration");
+    const T value = static_cast<T>(arg);
+    std::memcpy(dst + offset, &value, sizeof(T));
+    offset += sizeof(T);
+}
+
+// 按 LogFmtArgs 声明的类型依次写入，布局与 LogFmt 生成的 decode 一致
+template <typename... Ts, typename... Args>
+inline void pack_checked(uint8_t* dst, LogFmtArgs<Ts...> /*format*/, const Args&... args) noexcept {
+    std::size_t offset = 0;
+    (pack_checked_one<Ts>(dst, offset, args), ...);
+    (void)dst;
+    (void)offset;
+}
+
 }  // namespace detail
 
 // 写日志失败时调用（内部使用 shm::log_error）
 void log_write_failed(const char* reason) noexcept;
 
-// LOG_FMT 格式函数 / LOG_STR 字符串
+// LOG_FMT 格式函数（按 format_name##_args 编译期检查实参）/ LOG_STR 字符串
 #define LOG_FMT(writer, level, module_id, format_name, ...) \
-    base_core_log::log_write_fmt((writer), (level), base_core_log::rdtsc(), \
-        static_cast<uint8_t>(module_id), format_name##_id, format_name##_payload_size, ##__VA_ARGS__)
+    base_core_log::log_write_fmt_checked<format_name##_args>((writer), (level), base_core_log::rdtsc(), \
+        static_cast<uint8_t>(module_id), format_name##_id, ##__VA_ARGS__)
 
 #define LOG_STR(writer, level, module_id, str) \
     base_core_log::log_write_str((writer), (level), base_core_log::rdtsc(), \
@@ -128,6 +179,8 @@ struct ShmLogConfig {
     std::size_t buffer_capacity = 4096;
     bool per_thread = true;  // 每线程一文件：shm_name + "_0", "_1", ...
     std::string output_path = "./log_output.txt";  // LogReader 输出文件路径
+    LogOverflowPolicy overflow_policy = LogOverflowPolicy::OverwriteOld;  // 各模块默认策略
+    uint32_t overflow_spin_limit = 65536;  // BoundedSpin 单条日志最多自旋次数
 };
 
 // 变长区 header（32 字节，与 LogEntry 前 32 字节布局兼容）
@@ -164,15 +217,43 @@ struct alignas(64) LogShmHeader {
 
 static_assert(sizeof(LogShmHeader) == 64, "LogShmHeader must be 64 bytes");
 
+constexpr std::size_t kLogModuleCount = 256;
+
+// ============ 统计区（位于变长区之后）：读写进度 + 丢失计数 ============
+// 计数均为单调递增的 64 位值；读端发布消费进度，写端据此判断环形区是否写满。
+// 仅支持一个读端；旧布局（无统计区）的共享内存仍按原方式读取。
+struct alignas(64) LogShmStats {
+    std::atomic<uint64_t> fixed_written{0};    // 固定区累计写入条目数
+    std::atomic<uint64_t> fixed_read{0};       // 固定区读端累计消费条目数
+    std::atomic<uint64_t> var_written{0};      // 变长区累计占用字节数（含回绕跳过的尾部）
+    std::atomic<uint64_t> var_read{0};         // 变长区读端累计消费字节数
+    std::atomic<uint32_t> var_read_offset{0};  // 变长区读端下一条的字节偏移
+    uint32_t pad = 0;
+    std::atomic<uint64_t> total_dropped{0};    // DropNew / BoundedSpin 丢弃的条目数
+    std::atomic<uint64_t> overwritten{0};      // OverwriteOld 覆盖掉的未读条目数
+    uint8_t reserved[8]{};
+    std::atomic<uint64_t> lost_by_module[kLogModuleCount]{};  // 按模块的丢失条目数（变长区覆盖计入 0 号）
+};
+
+static_assert(sizeof(LogShmStats) == 64 + kLogModuleCount * sizeof(uint64_t), "LogShmStats layout changed");
+
 // ============ 直接写 buffer 的 writer（无 tail 检查，满时覆盖） ============
 class LogBufferWriter {
 public:
     LogBufferWriter() = default;
 
+    // stats 为空时不做满检测，行为与无统计区的旧布局一致
     void attach(LogShmHeader* header, LogEntry* buffer, std::size_t capacity,
-               uint8_t* buffer_var, std::size_t buffer_var_size) noexcept;
+               uint8_t* buffer_var, std::size_t buffer_var_size, LogShmStats* stats = nullptr) noexcept;
 
-    // 热路径：直接写 slot + 一次 release store，无 tail load（payload <= 32）
+    // 策略：set_overflow_policy 覆盖全部模块，set_module_policy 单独指定某模块（如审计模块用 BoundedSpin）
+    void set_overflow_policy(LogOverflowPolicy policy, uint32_t spin_limit) noexcept;
+    void set_module_policy(uint8_t module_id, LogOverflowPolicy policy) noexcept;
+    LogOverflowPolicy module_policy(uint8_t module_id) const noexcept { return module_policy_[module_id]; }
+
+    // 热路径：直接写 slot + 一次 release store（payload <= 32）；OverwriteOld 下不等待读端。
+    // 返回 false 仅表示未挂载或参数非法；按策略丢弃的条目计入 LogShmStats 后返回 true，
+    // 并在下一条成功写入前补一条 Overrun 标记。
     bool try_push(const LogEntry& e) noexcept;
 
     // 变长路径：payload > 32，先记录长度再按长度拷贝
@@ -185,6 +266,15 @@ public:
     bool is_attached() const noexcept { return buffer_ != nullptr; }
 
 private:
+    // 变长区写入：按策略预留空间（必要时写回绕标记），返回写入偏移；丢弃时返回 false
+    bool reserve_variable(uint8_t module_id, std::size_t entry_size, uint32_t& out_offset) noexcept;
+    // 等待固定区空出 needed 个槽位；OverwriteOld 直接返回 true
+    bool wait_fixed_space(LogOverflowPolicy policy, uint32_t needed) noexcept;
+    void push_fixed(const LogEntry& e) noexcept;
+    void record_drop(uint8_t module_id) noexcept;
+    // 有待报告的丢弃且固定区还有 reserve 之外的空槽时写 Overrun 标记
+    void emit_pending_overrun(uint32_t reserve) noexcept;
+
     LogShmHeader* header_ = nullptr;
     LogEntry* buffer_ = nullptr;
     uint32_t capacity_ = 0;
@@ -192,6 +282,12 @@ private:
     uint8_t* buffer_var_ = nullptr;
     uint32_t buffer_var_size_ = 0;
     uint32_t write_index_var_ = 0;  // 变长区字节偏移
+    LogShmStats* stats_ = nullptr;
+    uint64_t fixed_written_ = 0;  // stats_->fixed_written 的写端缓存
+    uint64_t var_written_ = 0;    // stats_->var_written 的写端缓存
+    uint64_t pending_lost_ = 0;   // 尚未写出 Overrun 标记的丢弃条目数
+    uint32_t spin_limit_ = 0;
+    LogOverflowPolicy module_policy_[kLogModuleCount]{};
 };
 
 // ============ 共享内存日志器 ============
@@ -220,30 +316,40 @@ public:
 
     LogShmHeader* header() noexcept;
     const LogShmHeader* header() const noexcept;
+    // 统计区；旧布局返回 nullptr
+    LogShmStats* stats() noexcept;
+    const LogShmStats* stats() const noexcept;
 
-    // 本实例的线程 ID（per_thread 时有效）
+    // 本实例的环序号（per_thread 时有效）：进程内按 init 顺序分配，共享内存名为 shm_name + "_" + thread_id
     std::size_t thread_id() const noexcept { return thread_id_; }
 
-    static constexpr std::size_t kLayoutSize =
+    // 无统计区的旧 v3 布局大小，读端据此兼容旧写端
+    static constexpr std::size_t kLegacyLayoutSize =
         sizeof(LogShmHeader) + kBufferCapacity * sizeof(LogEntry) + kBufferVarSize;
+    static constexpr std::size_t kLayoutSize = kLegacyLayoutSize + sizeof(LogShmStats);
 
 private:
     shm::ShmGenericWriter writer_;
     void* layout_ptr_ = nullptr;
+    LogShmStats* stats_ = nullptr;
     std::size_t layout_size_ = 0;
     std::size_t thread_id_ = 0;
     LogBufferWriter writer_impl_;
 };
 
+// 按 header 的校准参数把 TSC 换算为 Unix Epoch 纳秒；校准参数无效时返回 0
+uint64_t log_tsc_to_ns(uint64_t tsc, const LogShmHeader* header) noexcept;
+
 // 解码：将 LogEntry 格式化为字符串，ts_tsc 转为可读时间
-// header 提供 TSC 校准参数，module_mapper 用于将 module_id 映射为模块名
+// header 提供 TSC 校准参数，module_mapper 用于将 module_id 映射为模块名；
+// formats 非空时从该快照查格式函数（多线程解码不取注册表锁），为空时查全局注册表
 void decode_log_entry(const LogEntry& e, const LogShmHeader* header, char* buf, std::size_t buf_size,
-                      ModuleNameMapper module_mapper);
+                      ModuleNameMapper module_mapper, const LogFormatTable* formats = nullptr);
 
 // 解码变长 entry（LogVarEntryHeader + payload）
 void decode_log_entry_var(const LogVarEntryHeader& hdr, const uint8_t* payload,
                           const LogShmHeader* header, char* buf, std::size_t buf_size,
-                          ModuleNameMapper module_mapper);
+                          ModuleNameMapper module_mapper, const LogFormatTable* formats = nullptr);
 
 const char* to_string(LogLevel level) noexcept;
 
@@ -251,11 +357,20 @@ const char* to_string(LogLevel level) noexcept;
 bool init_shm_logger(const ShmLogConfig& config, ShmLogger& logger);
 
 // ============ 共享内存日志读取器 ============
+// 解码结果经 base_core::AsyncFileWriter 追加写出：默认自行打开 output_path，
+// 也可借用调用方长期持有的写出器（反复构造 reader 排空同一个环时免去每次打开文件和分配缓冲）
 class LogReader {
 public:
+    static constexpr std::size_t kOutputBufferSize = 256 * 1024;  // 自行打开输出文件时的单块缓冲
+
     LogReader(std::string shm_name, std::string output_path, ModuleNameMapper module_mapper = nullptr);
+    // 借用已打开的写出器：init 不再打开文件，close 只 flush 不关闭
+    LogReader(std::string shm_name, base_core::AsyncFileWriter& output, ModuleNameMapper module_mapper = nullptr);
     ~LogReader();
 
+    LogReader(const LogReader&) = delete;
+    LogReader& operator=(const LogReader&) = delete;
+
     // 初始化：打开共享内存和输出文件，返回 true 成功
     bool init();
 
@@ -272,19 +387,108 @@ public:
     bool is_open() const noexcept;
 
 private:
+    // 有统计区时按单调进度读取并发布消费进度；读端落后超过环形区容量时输出一行 overrun 说明
+    int read_with_stats();
+    void write_reader_overrun(const char* region, uint64_t lost, const char* unit);
+
     std::string shm_name_;
     std::string output_path_;
     ModuleNameMapper module_mapper_;
 
     // 持续监控模式的状态
     shm::ShmGenericWriter writer_;
-    std::ofstream out_;
+    base_core::AsyncFileWriter own_out_;
+    base_core::AsyncFileWriter* out_ = &own_out_;
     void* ptr_ = nullptr;
     const LogShmHeader* header_ = nullptr;
     const LogEntry* buffer_ = nullptr;
     const uint8_t* buffer_var_ = nullptr;
     uint32_t last_read_index_ = 0;
     uint32_t last_read_index_var_ = 0;
+    LogShmStats* stats_ = nullptr;
+    uint64_t fixed_read_ = 0;
+    uint64_t var_read_ = 0;
+    uint32_t var_offset_ = 0;
+    bool initialized_ = false;
+};
+
+// ============ 多环合并读取器（per_thread 产生的 shm_name_0..N-1） ============
+// 同时跟随多个日志环，按 ts_tsc 做 k 路堆归并后写入同一个输出文件，免去事后对多份文本排序。
+// 各环须为带统计区的布局（同样只支持一个读端）；每个环的固定区与变长区各自按写入顺序单调，作为两条有序流参与归并。
+// 跟随模式只输出水位以内的条目：本轮有新条目的流以其最新 ts 为界，空闲的流以“当前 TSC - hold_back_ns”为界，
+// 避免写端正在落盘的较早条目被越过；finish() 输出全部暂存条目。
+class LogMergeReader {
+public:
+    static constexpr std::size_t kOutputBufferSize = 1 << 20;  // 输出文件 AsyncFileWriter 的单块缓冲
+
+    LogMergeReader(std::vector<std::string> shm_names, std::string output_path,
+                   ModuleNameMapper module_mapper = nullptr, uint64_t hold_back_ns = 1000000);
+    ~LogMergeReader();
+
+    LogMergeReader(const LogMergeReader&) = delete;
+    LogMergeReader& operator=(const LogMergeReader&) = delete;
+
+    // per_thread 写端的共享内存名：base_name + "_0" .. base_name + "_" + (count - 1)
+    static std::vector<std::string> per_thread_names(const std::string& base_name, std::size_t count);
+
+    // 打开全部环和输出文件；任一环打开失败或不是带统计区的布局时返回 false
+    bool init();
+
+    // 拉取各环新条目并输出水位以内的部分，返回输出的条目数；未初始化返回 -1
+    int read_new();
+
+    // 拉取后输出全部暂存条目（停止跟随前调用），返回输出的条目数
+    int finish();
+
+    // 一次性模式：init + finish + close，返回 0 成功，1 失败
+    int run();
+
+    void close();
+    bool is_open() const noexcept;
+
+private:
+    // 暂存条目：bytes 内 [offset, offset + size) 为 LogEntry 或 LogVarEntryHeader + payload 的拷贝
+    struct PendingRecord {
+        uint64_t ts_tsc = 0;
+        uint32_t offset = 0;
+        uint32_t size = 0;
+    };
+
+    // 一条有序流：某个环的固定区或变长区
+    struct Stream {
+        std::size_t ring = 0;
+        bool variable = false;
+        std::vector<uint8_t> bytes;
+        std::vector<PendingRecord> records;
+        std::size_t head = 0;  // 下一条待输出的 records 下标
+        uint64_t frontier = 0;  // 本流之后的条目 ts 不低于此值
+    };
+
+    struct Ring {
+        shm::ShmGenericWriter shm;
+        const LogShmHeader* header = nullptr;
+        const LogEntry* buffer = nullptr;
+        const uint8_t* buffer_var = nullptr;
+        LogShmStats* stats = nullptr;
+        uint64_t fixed_read = 0;
+        uint64_t var_read = 0;
+        uint32_t var_offset = 0;
+    };
+
+    // 把各环新条目拷入暂存并发布消费进度，同时更新各流的 frontier
+    void collect();
+    // 按 ts 归并输出 ts <= watermark 的暂存条目
+    int emit_until(uint64_t watermark);
+    void write_record(const Stream& stream, const PendingRecord& record);
+    void write_reader_overrun(const std::string& ring_name, const char* region, uint64_t lost, const char* unit);
+
+    std::vector<std::string> shm_names_;
+    std::string output_path_;
+    ModuleNameMapper module_mapper_;
+    uint64_t hold_back_ns_;
+    std::vector<Ring> rings_;
+    std::vector<Stream> streams_;  // 下标 2 * ring 为固定区，2 * ring + 1 为变长区
+    base_core::AsyncFileWriter out_;
     bool initialized_ = false;
 };
 
@@ -321,6 +525,40 @@ bool log_write_fmt(Writer& w, LogLevel level, uint64_t ts, uint8_t module_id,
     return true;
 }
 
+// 按 LogFmt 声明写格式化日志：实参个数与类型在编译期校验，payload 长度为常量，固定槽/变长区在编译期选定
+template <typename Format, typename Writer, typename... Args>
+bool log_write_fmt_checked(Writer& w, LogLevel level, uint64_t ts, uint8_t module_id, uint8_t format_func_id,
+                           const Args&... args) {
+    static_assert(sizeof...(Args) == Format::kCount, "LOG_FMT argument count does not match the LogFmt declaration");
+    static_assert(Format::kPayloadSize <= kLogMaxVarPayload, "LogFmt payload exceeds kLogMaxVarPayload");
+    constexpr uint16_t kSize = static_cast<uint16_t>(Format::kPayloadSize);
+
+    if constexpr (kSize <= kLogMaxPayload) {
+        LogEntry e{};
+        e.ts_tsc = ts;
+        e.type_id = static_cast<uint8_t>(LogTypeId::MsgFormat);
+        e.level = static_cast<uint8_t>(level);
+        e.msg_id = format_func_id;
+        e.module_id = module_id;
+        e.payload_size = kSize;
+        detail::pack_checked(e.payload, Format{}, args...);
+        if (!w.try_push(e)) {
+            log_write_failed("log_write_fmt: try_push failed");
+            return false;
+        }
+        return true;
+    } else {
+        alignas(64) uint8_t buf[kSize];
+        detail::pack_checked(buf, Format{}, args...);
+        if (!w.try_push_variable(ts, static_cast<uint8_t>(LogTypeId::MsgFormat), static_cast<uint8_t>(level),
+                                 format_func_id, module_id, buf, kSize)) {
+            log_write_failed("log_write_fmt: try_push_variable failed");
+            return false;
+        }
+        return true;
+    }
+}
+
 // 记录字符串：payload 中直接存字符串内容
 // len <= 32: 固定 64B slot；len > 32: 变长区
 template <typename Writer>
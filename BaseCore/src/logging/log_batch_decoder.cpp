@@ -0,0 +1,263 @@
+#include "logging/log_batch_decoder.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <functional>
+#include <queue>
+#include <string_view>
+#include <thread>
+#include <utility>
+
+#include "shm/shm_generic.hpp"
+#include "utils/async_file_writer.hpp"
+
+namespace base_core_log {
+
+namespace {
+
+constexpr uint32_t kLogShmMagic = 0x4C4F4753;
+constexpr std::size_t kDecodeBufSize = 512;
+
+bool module_filter_empty(const LogDecodeFilter& filter) noexcept {
+    for (const uint64_t word : filter.modules) {
+        if (word != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+}  // namespace
+
+bool LogDecodeFilter::accepts(uint8_t module_id, uint8_t level, uint64_t ts_ns) const noexcept {
+    if (level < static_cast<uint8_t>(min_level) || ts_ns < begin_ns || ts_ns >= end_ns) {
+        return false;
+    }
+    return module_filter_empty(*this) || (modules[module_id / 64] >> (module_id % 64) & 1U) != 0;
+}
+
+LogBatchDecoder::LogBatchDecoder(std::vector<std::string> capture_paths, std::string output_path,
+                                 LogBatchDecodeOptions options)
+    : capture_paths_(std::move(capture_paths)), output_path_(std::move(output_path)), options_(options) {
+    options_.chunk_records = std::max<std::size_t>(options_.chunk_records, 1);
+}
+
+LogBatchDecoder::~LogBatchDecoder() { release_captures(); }
+
+bool LogBatchDecoder::load_capture(const std::string& path, Capture& capture) {
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        shm::log_error("logBatchDecoder: failed to open capture path=" + path);
+        return false;
+    }
+    struct stat st {};
+    const bool sized = ::fstat(fd, &st) == 0 &&
+                       (static_cast<std::size_t>(st.st_size) == ShmLogger::kLayoutSize ||
+                        static_cast<std::size_t>(st.st_size) == ShmLogger::kLegacyLayoutSize);
+    if (!sized) {
+        ::close(fd);
+        shm::log_error("logBatchDecoder: unexpected capture size path=" + path);
+        return false;
+    }
+    const std::size_t size = static_cast<std::size_t>(st.st_size);
+    void* mapping = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        shm::log_error("logBatchDecoder: failed to mmap capture path=" + path);
+        return false;
+    }
+    capture.mapping = mapping;
+    capture.mapped_bytes = size;
+
+    const auto* header = static_cast<const LogShmHeader*>(mapping);
+    if (header->magic != kLogShmMagic || header->version != 3 ||
+        header->buffer_var_size != ShmLogger::kBufferVarSize) {
+        shm::log_error("logBatchDecoder: unsupported capture layout path=" + path);
+        return false;
+    }
+    const auto* base = static_cast<const char*>(mapping) + sizeof(LogShmHeader);
+    capture.header = header;
+    capture.buffer = reinterpret_cast<const LogEntry*>(base);
+    capture.buffer_var = reinterpret_cast<const uint8_t*>(base + ShmLogger::kBufferCapacity * sizeof(LogEntry));
+
+    // 固定区：写指针之前的 count 个槽位按写入顺序排列
+    constexpr std::size_t kCapacity = ShmLogger::kBufferCapacity;
+    const uint32_t write_index = header->write_index.load(std::memory_order_relaxed) % kCapacity;
+    std::size_t count = write_index;
+    if (size == ShmLogger::kLayoutSize) {
+        const auto* stats = reinterpret_cast<const LogShmStats*>(static_cast<const char*>(mapping) +
+                                                                 ShmLogger::kLegacyLayoutSize);
+        count = static_cast<std::size_t>(
+            std::min<uint64_t>(stats->fixed_written.load(std::memory_order_relaxed), kCapacity));
+    } else if (capture.buffer[write_index].ts_tsc != 0) {
+        count = kCapacity;
+    }
+    capture.fixed_slots.reserve(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        capture.fixed_slots.push_back(static_cast<uint32_t>((write_index + kCapacity - count + i) % kCapacity));
+    }
+
+    // 变长区：从起点沿 payload_size 走到写指针，只读条目头
+    const uint32_t var_end =
+        std::min<uint32_t>(header->write_index_var.load(std::memory_order_relaxed), header->buffer_var_size);
+    uint32_t offset = 0;
+    while (offset + sizeof(LogVarEntryHeader) <= var_end) {
+        LogVarEntryHeader hdr;
+        std::memcpy(&hdr, capture.buffer_var + offset, sizeof(hdr));
+        const std::size_t entry_size = sizeof(LogVarEntryHeader) + hdr.payload_size;
+        if (hdr.type_id == static_cast<uint8_t>(LogTypeId::VarWrap) || offset + entry_size > var_end) {
+            break;
+        }
+        capture.var_offsets.push_back(offset);
+        offset += static_cast<uint32_t>(entry_size);
+    }
+    return true;
+}
+
+void LogBatchDecoder::decode_chunk(Chunk& chunk, const LogFormatTable& formats) const {
+    const Capture& capture = captures_[chunk.capture];
+    const LogDecodeFilter& filter = options_.filter;
+    char buf[kDecodeBufSize];
+    const auto append = [&chunk, &buf](uint64_t ts_ns) {
+        const std::size_t size = std::strlen(buf);
+        chunk.lines.push_back(Line{ts_ns, static_cast<uint32_t>(chunk.text.size()), static_cast<uint32_t>(size)});
+        chunk.text.append(buf, size);
+    };
+
+    for (std::size_t i = chunk.begin; i < chunk.end; ++i) {
+        buf[0] = '\0';
+        if (chunk.variable) {
+            const uint8_t* bytes = capture.buffer_var + capture.var_offsets[i];
+            LogVarEntryHeader hdr;
+            std::memcpy(&hdr, bytes, sizeof(hdr));
+            const uint64_t ts_ns = log_tsc_to_ns(hdr.ts_tsc, capture.header);
+            if (!filter.accepts(hdr.module_id, hdr.level, ts_ns)) {
+                continue;
+            }
+            decode_log_entry_var(hdr, bytes + sizeof(hdr), capture.header, buf, sizeof(buf), options_.module_mapper,
+                                 &formats);
+            append(ts_ns);
+        } else {
+            const LogEntry& e = capture.buffer[capture.fixed_slots[i]];
+            const uint64_t ts_ns = log_tsc_to_ns(e.ts_tsc, capture.header);
+            if (!filter.accepts(e.module_id, e.level, ts_ns)) {
+                continue;
+            }
+            decode_log_entry(e, capture.header, buf, sizeof(buf), options_.module_mapper, &formats);
+            append(ts_ns);
+        }
+    }
+
+    // 单个写线程的条目通常已按时间有序，只有显式传入乱序 ts 时才需要重排
+    const auto by_ts = [](const Line& a, const Line& b) { return a.ts_ns < b.ts_ns; };
+    if (!std::is_sorted(chunk.lines.begin(), chunk.lines.end(), by_ts)) {
+        std::stable_sort(chunk.lines.begin(), chunk.lines.end(), by_ts);
+    }
+}
+
+int LogBatchDecoder::run() {
+    stats_ = LogBatchDecodeStats{};
+    release_captures();
+    chunks_.clear();
+
+    base_core::AsyncFileWriter out;
+    base_core::AsyncFileWriterConfig out_config;
+    out_config.buffer_bytes = kOutputBufferSize;
+    if (!out.open(output_path_, false, out_config)) {
+        shm::log_error("logBatchDecoder: failed to open output path=" + output_path_);
+        return 1;
+    }
+
+    captures_.reserve(capture_paths_.size());
+    for (const std::string& path : capture_paths_) {
+        Capture capture;
+        const bool ok = load_capture(path, capture);
+        captures_.push_back(std::move(capture));
+        if (!ok) {
+            ++stats_.rejected_files;
+            continue;
+        }
+        ++stats_.files;
+
+        // 各区按条目数切块，分块边界都落在条目边界上
+        const std::size_t capture_index = captures_.size() - 1;
+        for (const bool variable : {false, true}) {
+            const Capture& loaded = captures_.back();
+            const std::size_t total = variable ? loaded.var_offsets.size() : loaded.fixed_slots.size();
+            stats_.records += total;
+            for (std::size_t begin = 0; begin < total; begin += options_.chunk_records) {
+                Chunk chunk;
+                chunk.capture = capture_index;
+                chunk.variable = variable;
+                chunk.begin = begin;
+                chunk.end = std::min(total, begin + options_.chunk_records);
+                chunks_.push_back(std::move(chunk));
+            }
+        }
+    }
+    stats_.chunks = chunks_.size();
+
+    // 工作线程按原子下标领取分块，格式函数查同一份只读快照
+    const LogFormatTable formats = LogFormatRegistry::snapshot();
+    std::size_t threads = options_.threads != 0 ? options_.threads : std::thread::hardware_concurrency();
+    threads = std::max<std::size_t>(1, std::min(threads, chunks_.size()));
+    std::atomic<std::size_t> next_chunk{0};
+    const auto work = [this, &formats, &next_chunk]() {
+        for (std::size_t i = next_chunk.fetch_add(1, std::memory_order_relaxed); i < chunks_.size();
+             i = next_chunk.fetch_add(1, std::memory_order_relaxed)) {
+            decode_chunk(chunks_[i], formats);
+        }
+    };
+    std::vector<std::thread> workers;
+    workers.reserve(threads - 1);
+    for (std::size_t i = 1; i < threads; ++i) {
+        workers.emplace_back(work);
+    }
+    work();
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+
+    // 小顶堆 (ts, 分块下标) k 路归并；同 ts 时按分块下标（文件、区、条目顺序）保证输出稳定
+    using HeapItem = std::pair<uint64_t, std::size_t>;
+    std::priority_queue<HeapItem, std::vector<HeapItem>, std::greater<HeapItem>> heap;
+    std::vector<std::size_t> heads(chunks_.size(), 0);
+    for (std::size_t i = 0; i < chunks_.size(); ++i) {
+        if (!chunks_[i].lines.empty()) {
+            heap.emplace(chunks_[i].lines.front().ts_ns, i);
+        }
+    }
+    while (!heap.empty()) {
+        const std::size_t index = heap.top().second;
+        heap.pop();
+        const Chunk& chunk = chunks_[index];
+        const Line& line = chunk.lines[heads[index]];
+        out.write(std::string_view(chunk.text.data() + line.offset, line.size));
+        ++stats_.emitted;
+        if (++heads[index] < chunk.lines.size()) {
+            heap.emplace(chunk.lines[heads[index]].ts_ns, index);
+        }
+    }
+    out.close();
+
+    chunks_.clear();
+    release_captures();
+    return stats_.rejected_files == 0 ? 0 : 1;
+}
+
+void LogBatchDecoder::release_captures() noexcept {
+    for (Capture& capture : captures_) {
+        if (capture.mapping) {
+            ::munmap(capture.mapping, capture.mapped_bytes);
+        }
+    }
+    captures_.clear();
+}
+
+}  // namespace base_core_log
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "logging/log.hpp"
+#include "logging/log_format_registry.hpp"
+
+namespace base_core_log {
+
+// 批量解码的过滤条件：只看条目头（模块、级别、换算后的时间），在格式化之前判断，不命中的条目不进入 decode
+struct LogDecodeFilter {
+    std::array<uint64_t, kLogModuleCount / 64> modules{};  // 模块位图；全 0 表示不按模块过滤
+    LogLevel min_level = LogLevel::debug;
+    uint64_t begin_ns = 0;                                  // [begin_ns, end_ns)，Unix Epoch 纳秒
+    uint64_t end_ns = std::numeric_limits<uint64_t>::max();
+
+    void allow_module(uint8_t module_id) noexcept { modules[module_id / 64] |= uint64_t{1} << (module_id % 64); }
+    bool accepts(uint8_t module_id, uint8_t level, uint64_t ts_ns) const noexcept;
+};
+
+struct LogBatchDecodeOptions {
+    std::size_t threads = 0;           // 解码线程数，0 取 hardware_concurrency
+    std::size_t chunk_records = 1024;  // 单个分块的条目数上限
+    LogDecodeFilter filter;
+    ModuleNameMapper module_mapper = nullptr;
+};
+
+struct LogBatchDecodeStats {
+    std::size_t files = 0;           // 成功装载的归档文件数
+    std::size_t rejected_files = 0;  // 打不开或布局不符而跳过的文件数
+    std::size_t chunks = 0;
+    uint64_t records = 0;            // 扫描到的条目数
+    uint64_t emitted = 0;            // 通过过滤并输出的行数
+};
+
+// 归档日志环批量解码器：输入为 per_thread 写端的日志环映像（共享内存文件的拷贝，v3 布局，可带统计区），
+// 只读映射后先只走条目头切出条目边界，按 chunk_records 把固定区/变长区切成分块，多个线程并行过滤与解码，
+// 最后按换算后的纳秒时间 k 路归并写入同一个文本文件，行格式与 LogReader 一致。
+// - 固定区取环内仍有效的全部条目（有统计区时为 min(fixed_written, 容量) 条，否则按写指针处槽位是否非空判断是否回绕）
+// - 变长区取 [0, write_index_var)：最近一次回绕之后写入的条目；回绕前残留的条目边界已不可知，不解码
+// - 格式函数在 run() 开始时从 LogFormatRegistry 取一次快照，各线程查快照不取锁
+class LogBatchDecoder {
+public:
+    static constexpr std::size_t kOutputBufferSize = 1 << 20;
+
+    LogBatchDecoder(std::vector<std::string> capture_paths, std::string output_path,
+                    LogBatchDecodeOptions options = {});
+    ~LogBatchDecoder();
+
+    LogBatchDecoder(const LogBatchDecoder&) = delete;
+    LogBatchDecoder& operator=(const LogBatchDecoder&) = delete;
+
+    // 装载、并行解码并归并输出；输出文件打不开或任一输入被跳过时返回 1，否则返回 0（被跳过的文件不影响其余输出）
+    int run();
+
+    const LogBatchDecodeStats& stats() const noexcept { return stats_; }
+
+private:
+    struct Capture {
+        void* mapping = nullptr;
+        std::size_t mapped_bytes = 0;
+        const LogShmHeader* header = nullptr;
+        const LogEntry* buffer = nullptr;
+        const uint8_t* buffer_var = nullptr;
+        std::vector<uint32_t> fixed_slots;  // 固定区按写入顺序的槽位下标
+        std::vector<uint32_t> var_offsets;  // 变长区按写入顺序的条目字节偏移
+    };
+
+    // 分块内一行：text 中 [offset, offset + size)
+    struct Line {
+        uint64_t ts_ns = 0;
+        uint32_t offset = 0;
+        uint32_t size = 0;
+    };
+
+    // 一个分块：某个文件某个区的 [begin, end) 条目；解码后 lines 按 ts 稳定排序
+    struct Chunk {
+        std::size_t capture = 0;
+        bool variable = false;
+        std::size_t begin = 0;
+        std::size_t end = 0;
+        std::vector<Line> lines;
+        std::string text;
+    };
+
+    bool load_capture(const std::string& path, Capture& capture);
+    void decode_chunk(Chunk& chunk, const LogFormatTable& formats) const;
+    void release_captures() noexcept;
+
+    std::vector<std::string> capture_paths_;
+    std::string output_path_;
+    LogBatchDecodeOptions options_;
+    std::vector<Capture> captures_;
+    std::vector<Chunk> chunks_;
+    LogBatchDecodeStats stats_;
+};
+
+}  // namespace base_core_log
@@ -96,8 +96,9 @@ int main() {
  
     logger.close();
 
-    //3.生成日志文本文件
-    LogReader reader(config.shm_name, config.output_path, default_module_mapper);
+    //3.生成日志文本文件（per_thread 写端的共享内存名带环序号后缀）
+    LogReader reader(config.shm_name + "_" + std::to_string(logger.thread_id()), config.output_path,
+                     default_module_mapper);
     if (reader.run() != 0) {
         std::cerr << "log_demo: LogReader failed\n";
         return 1;
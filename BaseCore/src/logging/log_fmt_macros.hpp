@@ -1,7 +1,8 @@
 #pragma once
 
 /**
- * LogFmt 宏定义：按参数个数分发，自动生成 id、payload_size、decode、注册
+ * LogFmt 宏定义：按参数个数分发，自动生成参数类型列表 name##_args、id、payload_size、decode、注册
+ * id 由格式名在编译期散列得到；LOG_FMT 按 name##_args 检查实参个数与类型
  * 由 log_demo_format_func.hpp 引用
  */
 
@@ -32,8 +33,9 @@
 #define LogFmt(name, ...) LOG_FMT_CAT(LOG_FMT_IMPL_, LOG_FMT_NARG(__VA_ARGS__))(name, __VA_ARGS__)
 
 #define LOG_FMT_IMPL_1(name, T1) \
-    static constexpr uint8_t name##_id = 64 + (__COUNTER__ % 192); \
-    static constexpr uint16_t name##_payload_size = sizeof(T1); \
+    using name##_args = LogFmtArgs<T1>; \
+    static constexpr uint8_t name##_id = log_fmt_id(#name); \
+    static constexpr uint16_t name##_payload_size = static_cast<uint16_t>(name##_args::kPayloadSize); \
     static void name##_decode(const uint8_t* p, uint16_t sz, char* buf, std::size_t buf_sz) { \
         if (sz != sizeof(T1)) { LogFormatRegistry::on_error(name##_id, sz); return; } \
         T1 a1; std::memcpy(&a1, p, sizeof(T1)); \
@@ -43,8 +45,9 @@
     LOG_FMT_REGISTER(name)
 
 #define LOG_FMT_IMPL_2(name, T1, T2) \
-    static constexpr uint8_t name##_id = 64 + (__COUNTER__ % 192); \
-    static constexpr uint16_t name##_payload_size = sizeof(T1) + sizeof(T2); \
+    using name##_args = LogFmtArgs<T1, T2>; \
+    static constexpr uint8_t name##_id = log_fmt_id(#name); \
+    static constexpr uint16_t name##_payload_size = static_cast<uint16_t>(name##_args::kPayloadSize); \
     static void name##_decode(const uint8_t* p, uint16_t sz, char* buf, std::size_t buf_sz) { \
         if (sz != sizeof(T1) + sizeof(T2)) { LogFormatRegistry::on_error(name##_id, sz); return; } \
         T1 a1; T2 a2; \
@@ -55,8 +58,9 @@
     LOG_FMT_REGISTER(name)
 
 #define LOG_FMT_IMPL_3(name, T1, T2, T3) \
-    static constexpr uint8_t name##_id = 64 + (__COUNTER__ % 192); \
-    static constexpr uint16_t name##_payload_size = sizeof(T1) + sizeof(T2) + sizeof(T3); \
+    using name##_args = LogFmtArgs<T1, T2, T3>; \
+    static constexpr uint8_t name##_id = log_fmt_id(#name); \
+    static constexpr uint16_t name##_payload_size = static_cast<uint16_t>(name##_args::kPayloadSize); \
     static void name##_decode(const uint8_t* p, uint16_t sz, char* buf, std::size_t buf_sz) { \
         if (sz != name##_payload_size) { LogFormatRegistry::on_error(name##_id, sz); return; } \
         T1 a1; T2 a2; T3 a3; \
@@ -68,8 +72,9 @@
     LOG_FMT_REGISTER(name)
 
 #define LOG_FMT_IMPL_4(name, T1, T2, T3, T4) \
-    static constexpr uint8_t name##_id = 64 + (__COUNTER__ % 192); \
-    static constexpr uint16_t name##_payload_size = sizeof(T1) + sizeof(T2) + sizeof(T3) + sizeof(T4); \
+    using name##_args = LogFmtArgs<T1, T2, T3, T4>; \
+    static constexpr uint8_t name##_id = log_fmt_id(#name); \
+    static constexpr uint16_t name##_payload_size = static_cast<uint16_t>(name##_args::kPayloadSize); \
     static void name##_decode(const uint8_t* p, uint16_t sz, char* buf, std::size_t buf_sz) { \
         if (sz != name##_payload_size) { LogFormatRegistry::on_error(name##_id, sz); return; } \
         T1 a1; T2 a2; T3 a3; T4 a4; \
@@ -82,8 +87,9 @@
     LOG_FMT_REGISTER(name)
 
 #define LOG_FMT_IMPL_5(name, T1, T2, T3, T4, T5) \
-    static constexpr uint8_t name##_id = 64 + (__COUNTER__ % 192); \
-    static constexpr uint16_t name##_payload_size = sizeof(T1) + sizeof(T2) + sizeof(T3) + sizeof(T4) + sizeof(T5); \
+    using name##_args = LogFmtArgs<T1, T2, T3, T4, T5>; \
+    static constexpr uint8_t name##_id = log_fmt_id(#name); \
+    static constexpr uint16_t name##_payload_size = static_cast<uint16_t>(name##_args::kPayloadSize); \
     static void name##_decode(const uint8_t* p, uint16_t sz, char* buf, std::size_t buf_sz) { \
         if (sz != name##_payload_size) { LogFormatRegistry::on_error(name##_id, sz); return; } \
         T1 a1; T2 a2; T3 a3; T4 a4; T5 a5; \
@@ -97,8 +103,9 @@
     LOG_FMT_REGISTER(name)
 
 #define LOG_FMT_IMPL_6(name, T1, T2, T3, T4, T5, T6) \
-    static constexpr uint8_t name##_id = 64 + (__COUNTER__ % 192); \
-    static constexpr uint16_t name##_payload_size = sizeof(T1) + sizeof(T2) + sizeof(T3) + sizeof(T4) + sizeof(T5) + sizeof(T6); \
+    using name##_args = LogFmtArgs<T1, T2, T3, T4, T5, T6>; \
+    static constexpr uint8_t name##_id = log_fmt_id(#name); \
+    static constexpr uint16_t name##_payload_size = static_cast<uint16_t>(name##_args::kPayloadSize); \
     static void name##_decode(const uint8_t* p, uint16_t sz, char* buf, std::size_t buf_sz) { \
         if (sz != name##_payload_size) { LogFormatRegistry::on_error(name##_id, sz); return; } \
         T1 a1; T2 a2; T3 a3; T4 a4; T5 a5; T6 a6; \
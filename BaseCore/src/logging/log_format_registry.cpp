@@ -30,7 +30,11 @@ std::mutex& LogFormatRegistry::mutex() {
 
 bool LogFormatRegistry::register_func(uint8_t id, DecodeFunc decode, uint16_t expected_payload_size) {
     std::lock_guard<std::mutex> lock(mutex());
-    registry()[id] = {decode, expected_payload_size};
+    auto [it, inserted] = registry().try_emplace(id, Entry{decode, expected_payload_size});
+    if (!inserted && (it->second.decode != decode || it->second.expected_payload_size != expected_payload_size)) {
+        std::fprintf(stderr, "[LogFormatRegistry] format_id collision: format_id=%u\n", static_cast<unsigned>(id));
+        return false;
+    }
     return true;
 }
 
@@ -50,7 +54,7 @@ bool LogFormatRegistry::decode(uint8_t id, const uint8_t* payload, uint16_t size
         }
         entry = it->second;
     }
-    if (size != entry.expected_payload_size) {
+    if (entry.expected_payload_size != kVariablePayloadSize && size != entry.expected_payload_size) {
         on_error(id, size);
         return false;
     }
@@ -60,4 +64,31 @@ bool LogFormatRegistry::decode(uint8_t id, const uint8_t* payload, uint16_t size
     return true;
 }
 
+LogFormatTable LogFormatRegistry::snapshot() {
+    LogFormatTable table;
+    std::lock_guard<std::mutex> lock(mutex());
+    for (const auto& [id, entry] : registry()) {
+        table.slots_[id] = LogFormatTable::Slot{entry.decode, entry.expected_payload_size, true};
+    }
+    return table;
+}
+
+bool LogFormatTable::decode(uint8_t id, const uint8_t* payload, uint16_t size, char* buf,
+                            std::size_t buf_size) const {
+    const Slot& slot = slots_[id];
+    if (!slot.registered) {
+        std::fprintf(stderr, "[LogFormatRegistry] unknown format_id=%u\n", static_cast<unsigned>(id));
+        return false;
+    }
+    if (slot.expected_payload_size != LogFormatRegistry::kVariablePayloadSize &&
+        size != slot.expected_payload_size) {
+        LogFormatRegistry::on_error(id, size);
+        return false;
+    }
+    if (slot.decode) {
+        slot.decode(payload, size, buf, buf_size);
+    }
+    return true;
+}
+
 }  // namespace base_core_log
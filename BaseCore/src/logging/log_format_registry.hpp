@@ -1,15 +1,40 @@
 #pragma once
 
+#include <array>
 #include <cstddef>
 #include <cstdint>
 #include <cstring>
 #include <functional>
 #include <mutex>
 #include <string>
+#include <string_view>
+#include <type_traits>
 #include <unordered_map>
 
 namespace base_core_log {
 
+// ============ 编译期格式描述：LogFmt 为每个格式生成 name##_args / name##_id ============
+// 参数类型列表：payload 按声明类型依次 memcpy，总长在编译期确定，写端不再按实参计算长度
+template <typename... Ts>
+struct LogFmtArgs {
+    static_assert((std::is_trivially_copyable_v<Ts> && ...), "LogFmt argument types must be trivially copyable");
+    static_assert((!std::is_pointer_v<Ts> && ...), "LogFmt argument types must not be pointers, use LOG_STR for text");
+
+    static constexpr std::size_t kCount = sizeof...(Ts);
+    static constexpr std::size_t kPayloadSize = (std::size_t{0} + ... + sizeof(Ts));
+};
+
+// 格式 id：格式名的 FNV-1a 散列映射到 64..255，与包含顺序无关，各编译单元一致；撞号在注册时报告
+consteval uint8_t log_fmt_id(std::string_view name) {
+    uint32_t hash = 2166136261u;
+    for (const char c : name) {
+        hash = (hash ^ static_cast<uint8_t>(c)) * 16777619u;
+    }
+    return static_cast<uint8_t>(64 + hash % 192);
+}
+
+class LogFormatTable;
+
 /**
  * 格式函数注册表：format_func_id -> (decode 函数, expected_payload_size)
  * 写端通过 LogFmt 宏注册，logReader 启动时静态初始化完成注册，decode 时查表调用
@@ -18,10 +43,16 @@ class LogFormatRegistry {
 public:
     using DecodeFunc = void (*)(const uint8_t* payload, uint16_t size, char* buf, std::size_t buf_size);
 
+    // 以此值注册的格式不做长度校验，由 decode 函数按 payload 内的长度字段自行校验
+    static constexpr uint16_t kVariablePayloadSize = 0xFFFF;
+
     static uint8_t next_id() noexcept;
+    // 同一 id 重复注册相同的 decode 与长度视为成功；已被其他格式占用时拒绝并输出到 stderr
     static bool register_func(uint8_t id, DecodeFunc decode, uint16_t expected_payload_size);
     static void on_error(uint8_t id, uint16_t actual_size) noexcept;
     static bool decode(uint8_t id, const uint8_t* payload, uint16_t size, char* buf, std::size_t buf_size);
+    // 拷出当前注册表的只读快照，批量解码的各线程共享快照查表，不再逐条取锁
+    static LogFormatTable snapshot();
 
 private:
     struct Entry {
@@ -32,6 +63,23 @@ private:
     static std::mutex& mutex();
 };
 
+// 注册表快照：按 format_id 直接下标，构造后只读，可被多个线程同时使用；快照之后的注册不可见
+class LogFormatTable {
+public:
+    // 与 LogFormatRegistry::decode 相同的长度校验与错误输出
+    bool decode(uint8_t id, const uint8_t* payload, uint16_t size, char* buf, std::size_t buf_size) const;
+
+private:
+    friend class LogFormatRegistry;
+
+    struct Slot {
+        LogFormatRegistry::DecodeFunc decode = nullptr;
+        uint16_t expected_payload_size = 0;
+        bool registered = false;
+    };
+    std::array<Slot, 256> slots_{};
+};
+
 // 兼容性别名（逐步迁移后可移除）
 using log_format_registry = LogFormatRegistry;
 
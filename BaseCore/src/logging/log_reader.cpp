@@ -1,6 +1,7 @@
 /**
  * log_reader: 从共享内存读取日志，将 TSC 转为可读时间，写入文本文件
  * 用法: log_reader [shm_name] [output_path]
+ *       log_reader --merge base_name ring_count [output_path]  按 TSC 归并 per_thread 写端的 base_name_0..N-1
  * 默认: shm_name=/log_shm, output_path=./log_output.txt
  */
 
@@ -8,6 +9,7 @@
 #include "logging/log_demo_format_func.hpp"
 #include "logging/log_demo_module.hpp"
 
+#include <cstdlib>
 #include <cstring>
 #include <iostream>
 #include <string>
@@ -30,10 +32,25 @@ int main(int argc, char* argv[]) {
     if (argc >= 2) {
         if (std::strcmp(argv[1], "-h") == 0 || std::strcmp(argv[1], "--help") == 0) {
             std::cerr << "Usage: " << argv[0] << " [shm_name] [output_path]\n"
+                      << "       " << argv[0] << " --merge base_name ring_count [output_path]\n"
                       << "  shm_name:    shared memory name (default: /tmp/log_shm)\n"
-                      << "  output_path: output text file (default: ./log_output.txt)\n";
+                      << "  output_path: output text file (default: ./log_output.txt)\n"
+                      << "  --merge:     merge per-thread rings base_name_0..N-1 into one TSC-ordered file\n";
             return 0;
         }
+        if (std::strcmp(argv[1], "--merge") == 0) {
+            const std::size_t ring_count = argc >= 4 ? std::strtoul(argv[3], nullptr, 10) : 0;
+            if (ring_count == 0) {
+                std::cerr << "log_reader: --merge requires base_name and ring_count > 0\n";
+                return 1;
+            }
+            if (argc >= 5) {
+                output_path = argv[4];
+            }
+            base_core_log::LogMergeReader reader(base_core_log::LogMergeReader::per_thread_names(argv[2], ring_count),
+                                                 output_path, default_module_mapper);
+            return reader.run();
+        }
         shm_name = argv[1];
     }
     if (argc >= 3) {
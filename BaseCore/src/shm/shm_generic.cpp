@@ -1,10 +1,12 @@
 #include "shm/shm_generic.hpp"
 #include "shm/shm_common.hpp"
 
+#include <dirent.h>
 #include <fcntl.h>
 #include <stdlib.h>
 #include <sys/mman.h>
 #include <sys/stat.h>
+#include <sys/syscall.h>
 #include <unistd.h>
 
 #include <cerrno>
@@ -20,6 +22,61 @@ inline bool use_file_backend() {
     return internal::use_file_backend();
 }
 
+// 与 <numaif.h> 一致，直接走系统调用以免引入 libnuma 依赖
+constexpr int kMpolPreferred = 1;
+
+bool bind_numa_node(void* ptr, std::size_t size, int node) {
+#if defined(SYS_mbind)
+    constexpr unsigned long kMaxNodes = sizeof(unsigned long) * 8;
+    if (node < 0 || static_cast<unsigned long>(node) >= kMaxNodes) {
+        return false;
+    }
+    const unsigned long nodemask = 1UL << node;
+    return syscall(SYS_mbind, ptr, size, kMpolPreferred, &nodemask, kMaxNodes, 0) == 0;
+#else
+    (void)ptr;
+    (void)size;
+    (void)node;
+    return false;
+#endif
+}
+
+// 逐页触碰完成预取；可写映射用原子加零写入，保证页面按 mbind 策略实际分配
+void prefault_pages(void* ptr, std::size_t size, bool writable) {
+    const long page = sysconf(_SC_PAGESIZE);
+    const std::size_t step = page > 0 ? static_cast<std::size_t>(page) : 4096;
+#if defined(MADV_POPULATE_WRITE) && defined(MADV_POPULATE_READ)
+    if (madvise(ptr, size, writable ? MADV_POPULATE_WRITE : MADV_POPULATE_READ) == 0) {
+        return;
+    }
+#endif
+    auto* bytes = static_cast<volatile char*>(ptr);
+    for (std::size_t offset = 0; offset < size; offset += step) {
+        if (writable) {
+            __atomic_fetch_add(reinterpret_cast<char*>(ptr) + offset, 0, __ATOMIC_RELAXED);
+        } else {
+            (void)bytes[offset];
+        }
+    }
+}
+
+// 顺序固定为 大页建议 -> NUMA 绑定 -> 预取，预取时页面才真正落到目标节点
+void apply_map_options(void* ptr, std::size_t size, const ShmMapOptions& options, bool writable,
+                       const std::string& name) {
+#if defined(MADV_HUGEPAGE)
+    if (options.huge_pages && madvise(ptr, size, MADV_HUGEPAGE) != 0) {
+        log_error("shm map: madvise(MADV_HUGEPAGE) failed name=" + name + " errno=" + std::to_string(errno));
+    }
+#endif
+    if (options.numa_node >= 0 && !bind_numa_node(ptr, size, options.numa_node)) {
+        log_error("shm map: mbind failed name=" + name + " node=" + std::to_string(options.numa_node) +
+                  " errno=" + std::to_string(errno));
+    }
+    if (options.prefault) {
+        prefault_pages(ptr, size, writable);
+    }
+}
+
 }  // namespace
 
 void log_error(const std::string& msg) noexcept {
@@ -34,6 +91,26 @@ bool create_only(const std::string& name, std::size_t size) {
     return internal::create_shm_impl(name, size, true);
 }
 
+int numa_node_of_cpu(int cpu) {
+    if (cpu < 0) {
+        return -1;
+    }
+    const std::string path = "/sys/devices/system/cpu/cpu" + std::to_string(cpu);
+    DIR* dir = opendir(path.c_str());
+    if (!dir) {
+        return -1;
+    }
+    int node = -1;
+    while (dirent* entry = readdir(dir)) {
+        if (std::strncmp(entry->d_name, "node", 4) == 0 && entry->d_name[4] >= '0' && entry->d_name[4] <= '9') {
+            node = std::atoi(entry->d_name + 4);
+            break;
+        }
+    }
+    closedir(dir);
+    return node;
+}
+
 // ============ ShmGenericWriter ============
 
 ShmGenericWriter::ShmGenericWriter() = default;
@@ -64,6 +141,10 @@ ShmGenericWriter& ShmGenericWriter::operator=(ShmGenericWriter&& other) noexcept
 }
 
 void* ShmGenericWriter::open(const std::string& name, std::size_t size) {
+    return open(name, size, ShmMapOptions{});
+}
+
+void* ShmGenericWriter::open(const std::string& name, std::size_t size, const ShmMapOptions& options) {
     if (is_open()) {
         close();
     }
@@ -106,6 +187,7 @@ void* ShmGenericWriter::open(const std::string& name, std::size_t size) {
         ::close(fd);
         return nullptr;
     }
+    apply_map_options(ptr, size, options, true, name_str);
 
     name_ = name_str;
     ptr_ = ptr;
@@ -215,6 +297,10 @@ ShmGenericReader& ShmGenericReader::operator=(ShmGenericReader&& other) noexcept
 }
 
 const void* ShmGenericReader::open(const std::string& name, std::size_t size) {
+    return open(name, size, ShmMapOptions{});
+}
+
+const void* ShmGenericReader::open(const std::string& name, std::size_t size, const ShmMapOptions& options) {
     if (is_open()) {
         close();
     }
@@ -257,6 +343,7 @@ const void* ShmGenericReader::open(const std::string& name, std::size_t size) {
         ::close(fd);
         return nullptr;
     }
+    apply_map_options(ptr, size, options, false, name_str);
 
     name_ = name_str;
     ptr_ = ptr;
@@ -19,6 +19,16 @@ bool create_if_not_exists(const std::string& name, std::size_t size);
 // 返回 true 表示创建成功，false 表示已存在或创建失败
 bool create_only(const std::string& name, std::size_t size);
 
+// 映射选项：均为尽力而为，内核不支持时仅记录日志，映射照常可用
+struct ShmMapOptions {
+    bool huge_pages = false;  // madvise(MADV_HUGEPAGE)，tmpfs 需 shmem_enabled=advise
+    bool prefault = false;    // 映射后立即预取全部页面，避免热路径首次缺页
+    int numa_node = -1;       // >=0 时 mbind 到该节点（先于预取生效），-1 不绑定
+};
+
+// 返回 CPU 所在 NUMA 节点（读取 /sys/devices/system/cpu/cpuN/nodeM），未知返回 -1
+int numa_node_of_cpu(int cpu);
+
 // ============ 写端：一写 ============
 // 职责：打开已存在的可写共享内存，提供 write_at 写入接口
 class ShmGenericWriter {
@@ -34,6 +44,7 @@ public:
     // 打开已存在的可写共享内存，失败返回 nullptr
     void* open(const std::string& name, std::size_t size);
     void* open(const std::string& account, const std::string& name, std::size_t size);
+    void* open(const std::string& name, std::size_t size, const ShmMapOptions& options);
 
     // 在 offset 处写入 data，长度为 size 字节
     bool write_at(std::size_t offset, const void* data, std::size_t size) noexcept;
@@ -69,6 +80,7 @@ public:
     // 打开已存在的只读共享内存，失败返回 nullptr
     const void* open(const std::string& name, std::size_t size);
     const void* open(const std::string& account, const std::string& name, std::size_t size);
+    const void* open(const std::string& name, std::size_t size, const ShmMapOptions& options);
 
     bool read_at(std::size_t offset, void* buf, std::size_t size) const noexcept;
 
@@ -0,0 +1,262 @@
+#pragma once
+
+#include "shm/shm_common.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+
+#include <sys/mman.h>
+
+namespace shm {
+
+// ============ 共享内存布局 ============
+// [Header: 64字节] + [Slot 0] + [Slot 1] + ... + [Slot N-1]，每个 Slot = [stamp: 64字节] + [Data: 对齐到64字节]
+//
+// 与 ShmSeqLockWriter 的单副本覆盖不同，写者轮流写 N 个槽位：版本 v 写入槽位 v % N，写完后才发布 latest=v。
+// 读者按 latest 直接定位最近一份完整版本，只有写者在一次拷贝期间又完成 N-1 次以上发布时才需要重试，
+// 大对象 + 高频写入下读者基本一次读成。
+//
+// Header 结构：
+// - latest: atomic<uint64_t>  // 最近一次完整发布的版本号（0 表示尚未发布）
+// - data_size: uint32_t       // 数据大小
+// - version: uint32_t         // 布局版本号（当前为1）
+// - slot_count: uint32_t      // 槽位数 N
+//
+// Slot stamp：版本 v 写入中为 2v-1，写完为 2v；读者据此确认槽位里正是它要读的版本
+
+constexpr uint32_t kShmMultiVersionLayoutVersion = 1;
+constexpr uint32_t kShmMultiVersionHeaderSize = 64;
+
+struct alignas(64) ShmMultiVersionHeader {
+    std::atomic<uint64_t> latest{0};
+    uint32_t data_size = 0;
+    uint32_t version = kShmMultiVersionLayoutVersion;
+    uint32_t slot_count = 0;
+    uint8_t reserved[44]{};
+
+    uint64_t load_latest() const noexcept { return latest.load(std::memory_order_acquire); }
+};
+
+static_assert(sizeof(ShmMultiVersionHeader) == 64, "ShmMultiVersionHeader must be 64 bytes");
+
+template <typename T>
+struct alignas(64) ShmMultiVersionSlot {
+    alignas(64) std::atomic<uint64_t> stamp{0};
+    alignas(64) T data;
+};
+
+// ============ 写者：单写者 ============
+// 职责：打开共享内存，轮流写入 N 个槽位并发布最新版本
+// 线程安全：单线程写入（不检查多写者）
+template <typename T, std::size_t N = 3>
+class ShmMultiVersionWriter {
+    static_assert(std::is_trivially_copyable_v<T>, "T must be trivially copyable");
+    static_assert(N >= 2, "multi-version store needs at least two slots");
+
+public:
+    using Slot = ShmMultiVersionSlot<T>;
+    static constexpr std::size_t kTotalSize = kShmMultiVersionHeaderSize + N * sizeof(Slot);
+
+    ShmMultiVersionWriter() = default;
+    ~ShmMultiVersionWriter() noexcept { close(); }
+
+    ShmMultiVersionWriter(const ShmMultiVersionWriter&) = delete;
+    ShmMultiVersionWriter& operator=(const ShmMultiVersionWriter&) = delete;
+
+    // 打开共享内存（不存在则创建）；已发布的版本号沿用，重启后的读者不会看到版本回退
+    bool open(const std::string& name);
+    bool open(const std::string& account, const std::string& name) { return open(name + "_" + account); }
+
+    // 写入数据（无阻塞）：写下一个槽位，完成后发布
+    bool write(const T& data) noexcept;
+
+    void close() noexcept;
+    bool is_open() const noexcept { return header_ != nullptr; }
+    const std::string& name() const noexcept { return name_; }
+
+    // 最近一次发布的版本号
+    uint64_t latest_version() const noexcept { return header_ ? header_->load_latest() : 0; }
+
+private:
+    std::string name_;
+    void* ptr_ = nullptr;
+    ShmMultiVersionHeader* header_ = nullptr;
+    Slot* slots_ = nullptr;
+};
+
+// ============ 读者：多读者 ============
+// 职责：打开共享内存，读取最近一份完整版本
+// 线程安全：多线程安全，各读者独立
+template <typename T, std::size_t N = 3>
+class ShmMultiVersionReader {
+    static_assert(std::is_trivially_copyable_v<T>, "T must be trivially copyable");
+
+public:
+    using Slot = ShmMultiVersionSlot<T>;
+    static constexpr std::size_t kTotalSize = ShmMultiVersionWriter<T, N>::kTotalSize;
+
+    ShmMultiVersionReader() = default;
+    ~ShmMultiVersionReader() noexcept { close(); }
+
+    ShmMultiVersionReader(const ShmMultiVersionReader&) = delete;
+    ShmMultiVersionReader& operator=(const ShmMultiVersionReader&) = delete;
+
+    bool open(const std::string& name);
+    bool open(const std::string& account, const std::string& name) { return open(name + "_" + account); }
+
+    // 读取最近一份完整版本；out_version 非空时写入读到的版本号
+    // 返回 false 表示尚未发布，或拷贝期间该槽位被覆盖（写者已领先 N-1 个版本以上，建议重试）
+    bool read_latest(T& out, uint64_t* out_version = nullptr) const noexcept;
+
+    // 带重试读取：每次重试都重新定位最新版本
+    bool read_latest_with_retry(T& out, int max_retries = 3, uint64_t* out_version = nullptr) const noexcept;
+
+    void close() noexcept;
+    bool is_open() const noexcept { return header_ != nullptr; }
+    const std::string& name() const noexcept { return name_; }
+
+    // 最近一次发布的版本号（用于检测是否有新数据）
+    uint64_t current_version() const noexcept { return header_ ? header_->load_latest() : 0; }
+
+private:
+    std::string name_;
+    const void* ptr_ = nullptr;
+    const ShmMultiVersionHeader* header_ = nullptr;
+    const Slot* slots_ = nullptr;
+};
+
+// ============ 实现 ============
+
+template <typename T, std::size_t N>
+bool ShmMultiVersionWriter<T, N>::open(const std::string& name) {
+    close();
+    if (!internal::create_shm_impl(name, kTotalSize, false)) {
+        return false;
+    }
+    void* ptr = internal::open_shm_write_impl(name, kTotalSize);
+    if (!ptr) {
+        return false;
+    }
+
+    auto* hdr = static_cast<ShmMultiVersionHeader*>(ptr);
+    if (hdr->version != kShmMultiVersionLayoutVersion || hdr->data_size != sizeof(T) || hdr->slot_count != N) {
+        std::memset(ptr, 0, kTotalSize);
+        hdr->data_size = sizeof(T);
+        hdr->version = kShmMultiVersionLayoutVersion;
+        hdr->slot_count = static_cast<uint32_t>(N);
+        hdr->latest.store(0, std::memory_order_release);
+    }
+
+    name_ = name;
+    ptr_ = ptr;
+    header_ = hdr;
+    slots_ = reinterpret_cast<Slot*>(static_cast<char*>(ptr) + kShmMultiVersionHeaderSize);
+    return true;
+}
+
+template <typename T, std::size_t N>
+bool ShmMultiVersionWriter<T, N>::write(const T& data) noexcept {
+    if (!header_) {
+        return false;
+    }
+
+    // 1. 槽位 stamp 置 2v-1（写入中）  2. 拷贝数据  3. stamp 置 2v  4. 发布 latest=v
+    const uint64_t next = header_->latest.load(std::memory_order_relaxed) + 1;
+    Slot& slot = slots_[next % N];
+    slot.stamp.store(next * 2 - 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    std::memcpy(&slot.data, &data, sizeof(T));
+
+    slot.stamp.store(next * 2, std::memory_order_release);
+    header_->latest.store(next, std::memory_order_release);
+    return true;
+}
+
+template <typename T, std::size_t N>
+void ShmMultiVersionWriter<T, N>::close() noexcept {
+    if (ptr_ && ptr_ != MAP_FAILED) {
+        munmap(ptr_, kTotalSize);
+    }
+    name_.clear();
+    ptr_ = nullptr;
+    header_ = nullptr;
+    slots_ = nullptr;
+}
+
+template <typename T, std::size_t N>
+bool ShmMultiVersionReader<T, N>::open(const std::string& name) {
+    close();
+    const void* ptr = internal::open_shm_read_impl(name, kTotalSize);
+    if (!ptr) {
+        return false;
+    }
+
+    const auto* hdr = static_cast<const ShmMultiVersionHeader*>(ptr);
+    if (hdr->version != kShmMultiVersionLayoutVersion || hdr->data_size != sizeof(T) || hdr->slot_count != N) {
+        munmap(const_cast<void*>(ptr), kTotalSize);
+        return false;
+    }
+
+    name_ = name;
+    ptr_ = ptr;
+    header_ = hdr;
+    slots_ = reinterpret_cast<const Slot*>(static_cast<const char*>(ptr) + kShmMultiVersionHeaderSize);
+    return true;
+}
+
+template <typename T, std::size_t N>
+bool ShmMultiVersionReader<T, N>::read_latest(T& out, uint64_t* out_version) const noexcept {
+    if (!header_) {
+        return false;
+    }
+
+    const uint64_t version = header_->latest.load(std::memory_order_acquire);
+    if (version == 0) {
+        return false;
+    }
+    const Slot& slot = slots_[version % N];
+    const uint64_t expected = version * 2;
+    if (slot.stamp.load(std::memory_order_acquire) != expected) {
+        return false;
+    }
+
+    std::memcpy(&out, &slot.data, sizeof(T));
+
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (slot.stamp.load(std::memory_order_relaxed) != expected) {
+        return false;
+    }
+    if (out_version) {
+        *out_version = version;
+    }
+    return true;
+}
+
+template <typename T, std::size_t N>
+bool ShmMultiVersionReader<T, N>::read_latest_with_retry(T& out, int max_retries,
+                                                         uint64_t* out_version) const noexcept {
+    for (int attempt = 0; attempt <= max_retries; ++attempt) {
+        if (read_latest(out, out_version)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+template <typename T, std::size_t N>
+void ShmMultiVersionReader<T, N>::close() noexcept {
+    if (ptr_ && ptr_ != MAP_FAILED) {
+        munmap(const_cast<void*>(ptr_), kTotalSize);
+    }
+    name_.clear();
+    ptr_ = nullptr;
+    header_ = nullptr;
+    slots_ = nullptr;
+}
+
+}  // namespace shm
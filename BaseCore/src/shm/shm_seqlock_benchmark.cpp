@@ -0,0 +1,225 @@
+/**
+ * shm_seqlock_benchmark: 单副本 SeqLock 与多版本槽位的读者重试率 / 延迟对比
+ * 用法: shm_seqlock_benchmark [duration_ms] [writer_cpu] [reader_cpu]
+ *   duration_ms: 每组参数的测试时长，默认 200
+ *   writer_cpu / reader_cpu: 绑定 CPU 核，-1 表示不绑定，默认 -1
+ * 扫描 payload 大小 × 写入间隔，每组分别跑 ShmSeqLockWriter 与 ShmMultiVersionWriter，
+ * 输出读者单次尝试失败率、每次成功读取（含重试）的 p50/p99/max 延迟，以及校验出的撕裂读次数（应为 0）。
+ * 支持 SHM_USE_FILE=1 时使用文件后端
+ */
+
+#include "shm/shm_generic.hpp"
+#include "shm/shm_multi_version.hpp"
+#include "shm/shm_seqlock.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if defined(__linux__)
+#include <sched.h>
+#endif
+#include <unistd.h>
+
+namespace {
+
+// 载荷：首尾各写一次序号，中间按序号低字节填充，读者据此检出撕裂读
+template <std::size_t Bytes>
+struct alignas(64) Payload {
+    static_assert(Bytes >= 64 && Bytes % 64 == 0, "payload must be a multiple of 64 bytes");
+    uint64_t head;
+    char body[Bytes - 2 * sizeof(uint64_t)];
+    uint64_t tail;
+};
+
+struct BenchResult {
+    uint64_t writes = 0;
+    uint64_t reads = 0;
+    uint64_t attempts = 0;
+    uint64_t torn = 0;
+    uint64_t p50_ns = 0;
+    uint64_t p99_ns = 0;
+    uint64_t max_ns = 0;
+};
+
+void pin_to_cpu(int cpu) {
+#if defined(__linux__)
+    if (cpu < 0) {
+        return;
+    }
+    cpu_set_t cpuset;
+    CPU_ZERO(&cpuset);
+    CPU_SET(cpu, &cpuset);
+    (void)sched_setaffinity(0, sizeof(cpuset), &cpuset);
+#else
+    (void)cpu;
+#endif
+}
+
+uint64_t now_ns() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                     std::chrono::steady_clock::now().time_since_epoch())
+                                     .count());
+}
+
+std::string make_bench_name(const char* tag) {
+    std::ostringstream oss;
+    const char* env = std::getenv("SHM_USE_FILE");
+    oss << ((env && env[0] == '1') ? "/tmp/" : "/") << "shm_seqlock_bench_" << tag << "_" << getpid();
+    return oss.str();
+}
+
+template <typename P>
+void fill_payload(P& payload, uint64_t seq) {
+    payload.head = seq;
+    std::memset(payload.body, static_cast<int>(seq & 0xFF), sizeof(payload.body));
+    payload.tail = seq;
+}
+
+template <typename P>
+bool payload_is_torn(const P& payload) {
+    const char expected = static_cast<char>(payload.head & 0xFF);
+    return payload.head != payload.tail || payload.body[0] != expected ||
+           payload.body[sizeof(payload.body) - 1] != expected ||
+           payload.body[sizeof(payload.body) / 2] != expected;
+}
+
+// 写者按 interval_ns 定速发布（0 表示全速）；读者连续读取，每次成功读取记一次延迟样本
+template <typename P, typename Writer, typename Reader>
+BenchResult run_pair(const std::string& name, uint64_t interval_ns, uint64_t duration_ms, int writer_cpu,
+                     int reader_cpu) {
+    BenchResult result;
+    Writer writer;
+    if (!writer.open(name)) {
+        std::fprintf(stderr, "shm_seqlock_benchmark: writer open failed: %s\n", name.c_str());
+        return result;
+    }
+    P initial{};
+    fill_payload(initial, 0);
+    writer.write(initial);
+
+    Reader reader;
+    if (!reader.open(name)) {
+        std::fprintf(stderr, "shm_seqlock_benchmark: reader open failed: %s\n", name.c_str());
+        return result;
+    }
+
+    std::atomic<bool> stop{false};
+    std::thread writer_thread([&]() {
+        pin_to_cpu(writer_cpu);
+        P payload{};
+        uint64_t seq = 0;
+        uint64_t next_deadline = now_ns();
+        while (!stop.load(std::memory_order_relaxed)) {
+            if (interval_ns != 0) {
+                while (now_ns() < next_deadline) {
+                }
+                next_deadline += interval_ns;
+            }
+            fill_payload(payload, ++seq);
+            writer.write(payload);
+        }
+        result.writes = seq;
+    });
+
+    std::vector<uint32_t> samples;
+    samples.reserve(1U << 20);
+    std::thread reader_thread([&]() {
+        pin_to_cpu(reader_cpu);
+        P payload{};
+        const uint64_t end = now_ns() + duration_ms * 1000000ULL;
+        while (true) {
+            const uint64_t begin = now_ns();
+            if (begin >= end) {
+                break;
+            }
+            uint64_t tries = 1;
+            while (!reader.read_latest(payload)) {
+                ++tries;
+            }
+            const uint64_t elapsed = now_ns() - begin;
+            result.attempts += tries;
+            ++result.reads;
+            result.torn += payload_is_torn(payload) ? 1 : 0;
+            if (samples.size() < samples.capacity()) {
+                samples.push_back(static_cast<uint32_t>(std::min<uint64_t>(elapsed, UINT32_MAX)));
+            }
+        }
+    });
+
+    reader_thread.join();
+    stop.store(true, std::memory_order_relaxed);
+    writer_thread.join();
+    reader.close();
+    writer.close();
+    shm::ShmGenericWriter::unlink(name);
+
+    if (!samples.empty()) {
+        std::sort(samples.begin(), samples.end());
+        result.p50_ns = samples[samples.size() / 2];
+        result.p99_ns = samples[std::min(samples.size() - 1, samples.size() * 99 / 100)];
+        result.max_ns = samples.back();
+    }
+    return result;
+}
+
+void print_row(const char* impl, std::size_t bytes, uint64_t interval_ns, const BenchResult& r) {
+    const double retry_rate =
+        r.attempts == 0 ? 0.0 : static_cast<double>(r.attempts - r.reads) / static_cast<double>(r.attempts);
+    std::printf("%-13s %7zu %10llu %10llu %10llu %9.4f%% %8llu %8llu %10llu %6llu\n", impl, bytes,
+                static_cast<unsigned long long>(interval_ns), static_cast<unsigned long long>(r.writes),
+                static_cast<unsigned long long>(r.reads), retry_rate * 100.0,
+                static_cast<unsigned long long>(r.p50_ns), static_cast<unsigned long long>(r.p99_ns),
+                static_cast<unsigned long long>(r.max_ns), static_cast<unsigned long long>(r.torn));
+}
+
+template <std::size_t Bytes>
+void run_payload(uint64_t duration_ms, int writer_cpu, int reader_cpu) {
+    using P = Payload<Bytes>;
+    static constexpr uint64_t kIntervals[] = {0, 1000, 10000, 100000};
+    for (const uint64_t interval_ns : kIntervals) {
+        const BenchResult single =
+            run_pair<P, shm::ShmSeqLockWriter<P>, shm::ShmSeqLockReader<P>>(make_bench_name("single"), interval_ns,
+                                                                           duration_ms, writer_cpu, reader_cpu);
+        print_row("seqlock", Bytes, interval_ns, single);
+        const BenchResult multi = run_pair<P, shm::ShmMultiVersionWriter<P>, shm::ShmMultiVersionReader<P>>(
+            make_bench_name("multi"), interval_ns, duration_ms, writer_cpu, reader_cpu);
+        print_row("multi_version", Bytes, interval_ns, multi);
+    }
+}
+
+long parse_arg(int argc, char* argv[], int index, long fallback, long min_value, long max_value) {
+    if (argc <= index) {
+        return fallback;
+    }
+    char* end = nullptr;
+    const long value = std::strtol(argv[index], &end, 10);
+    if (end == argv[index] || value < min_value || value > max_value) {
+        return fallback;
+    }
+    return value;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    const uint64_t duration_ms = static_cast<uint64_t>(parse_arg(argc, argv, 1, 200, 1, 600000));
+    const int writer_cpu = static_cast<int>(parse_arg(argc, argv, 2, -1, -1, 1023));
+    const int reader_cpu = static_cast<int>(parse_arg(argc, argv, 3, -1, -1, 1023));
+
+    std::printf("%-13s %7s %10s %10s %10s %10s %8s %8s %10s %6s\n", "impl", "bytes", "interval", "writes", "reads",
+                "retry", "p50_ns", "p99_ns", "max_ns", "torn");
+    run_payload<64>(duration_ms, writer_cpu, reader_cpu);
+    run_payload<448>(duration_ms, writer_cpu, reader_cpu);
+    run_payload<4096>(duration_ms, writer_cpu, reader_cpu);
+    run_payload<16384>(duration_ms, writer_cpu, reader_cpu);
+    return 0;
+}
@@ -0,0 +1,634 @@
+#include "utils/async_file_writer.hpp"
+
+#include <fcntl.h>
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+
+namespace base_core {
+
+namespace {
+
+constexpr std::size_t kPageSize = 4096;
+constexpr uint64_t kSyncUserData = ~uint64_t{0};
+
+int64_t steady_now_ns() noexcept {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+int sys_io_uring_setup(unsigned entries, io_uring_params* params) noexcept {
+    return static_cast<int>(::syscall(__NR_io_uring_setup, entries, params));
+}
+
+int sys_io_uring_enter(int fd, unsigned to_submit, unsigned min_complete, unsigned flags) noexcept {
+    return static_cast<int>(::syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags, nullptr, 0));
+}
+
+}  // namespace
+
+// 不依赖 liburing：直接 mmap 内核的 SQ/CQ 环。只有调用线程提交与收割，无需额外同步
+struct AsyncFileWriter::Ring {
+    int fd = -1;
+    void* sq_ptr = nullptr;
+    std::size_t sq_size = 0;
+    void* cq_ptr = nullptr;
+    std::size_t cq_size = 0;
+    io_uring_sqe* sqes = nullptr;
+    std::size_t sqes_size = 0;
+    unsigned* sq_head = nullptr;
+    unsigned* sq_tail = nullptr;
+    unsigned* sq_mask = nullptr;
+    unsigned* sq_array = nullptr;
+    unsigned sq_entries = 0;
+    unsigned* cq_head = nullptr;
+    unsigned* cq_tail = nullptr;
+    unsigned* cq_mask = nullptr;
+    io_uring_cqe* cqes = nullptr;
+    std::vector<iovec> iov{};  // 每块缓冲一个，SQE 提交到完成期间须保持有效
+};
+
+AsyncFileWriter::AsyncFileWriter() = default;
+
+AsyncFileWriter::~AsyncFileWriter() { close(); }
+
+bool AsyncFileWriter::open(const std::string& path, bool truncate, const AsyncFileWriterConfig& config) {
+    close();
+
+    int flags = O_WRONLY | O_CREAT | O_CLOEXEC;
+    if (truncate) {
+        flags |= O_TRUNC;
+    }
+    const int fd = ::open(path.c_str(), flags, 0644);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat st{};
+    if (::fstat(fd, &st) != 0) {
+        ::close(fd);
+        return false;
+    }
+
+    config_ = config;
+    buffer_bytes_ = std::max(kPageSize, (config.buffer_bytes + kPageSize - 1) / kPageSize * kPageSize);
+    const uint32_t count = std::clamp<uint32_t>(config.buffer_count, 2, IOV_MAX);
+    void* arena = std::aligned_alloc(kPageSize, buffer_bytes_ * count);
+    if (arena == nullptr) {
+        ::close(fd);
+        return false;
+    }
+    // 预先触页，避免写入路径上的缺页
+    std::memset(arena, 0, buffer_bytes_ * count);
+    arena_ = std::unique_ptr<char, void (*)(void*)>(static_cast<char*>(arena), std::free);
+
+    buffers_.assign(count, Buffer{});
+    free_.clear();
+    free_.reserve(count);
+    queued_.clear();
+    queued_.reserve(count);
+    for (uint32_t i = 0; i < count; ++i) {
+        buffers_[i].data = arena_.get() + static_cast<std::size_t>(i) * buffer_bytes_;
+        free_.push_back(count - 1 - i);
+    }
+
+    fd_ = fd;
+    has_current_ = false;
+    next_offset_ = static_cast<uint64_t>(st.st_size);
+    bytes_since_sync_ = 0;
+    last_sync_ns_ = steady_now_ns();
+    stats_ = AsyncFileWriterStats{};
+    io_busy_ = 0;
+    sync_requested_ = false;
+    stop_ = false;
+
+    if (config.use_io_uring && ring_init(count + 1)) {
+        backend_ = Backend::IoUring;
+    } else {
+        backend_ = Backend::Pwritev;
+        io_thread_ = std::thread([this]() { io_thread_main(); });
+    }
+    return true;
+}
+
+bool AsyncFileWriter::write(const void* data, std::size_t size) {
+    if (fd_ < 0) {
+        return false;
+    }
+    const auto* bytes = static_cast<const char*>(data);
+    while (size > 0) {
+        if (!has_current_) {
+            current_ = acquire_buffer();
+            has_current_ = true;
+        }
+        Buffer& buffer = buffers_[current_];
+        const std::size_t chunk = std::min(size, buffer_bytes_ - buffer.size);
+        std::memcpy(buffer.data + buffer.size, bytes, chunk);
+        buffer.size += chunk;
+        bytes += chunk;
+        size -= chunk;
+        if (buffer.size == buffer_bytes_) {
+            submit_current();
+        }
+    }
+    return true;
+}
+
+void AsyncFileWriter::flush() {
+    if (fd_ < 0) {
+        return;
+    }
+    submit_current();
+    if (backend_ == Backend::IoUring) {
+        ring_reap(false);
+    }
+    maybe_sync();
+}
+
+bool AsyncFileWriter::drain() {
+    if (fd_ < 0) {
+        return false;
+    }
+    const uint64_t errors_before = stats().errors;
+    submit_current();
+    wait_idle();
+    return stats().errors == errors_before;
+}
+
+bool AsyncFileWriter::sync() {
+    if (fd_ < 0) {
+        return false;
+    }
+    const uint64_t errors_before = stats().errors;
+    submit_current();
+    wait_idle();
+    if (::fdatasync(fd_) == 0) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ++stats_.syncs;
+    } else {
+        record_error(errno);
+    }
+    bytes_since_sync_ = 0;
+    last_sync_ns_ = steady_now_ns();
+    return stats().errors == errors_before;
+}
+
+bool AsyncFileWriter::rewrite(const void* data, std::size_t size) {
+    if (fd_ < 0) {
+        return false;
+    }
+    // 未提交的旧内容属于被覆盖的版本，直接丢弃
+    if (has_current_) {
+        buffers_[current_].size = 0;
+    }
+    wait_idle();
+    if (::ftruncate(fd_, 0) != 0) {
+        record_error(errno);
+        return false;
+    }
+    next_offset_ = 0;
+    (void)write(data, size);
+    flush();
+    return true;
+}
+
+void AsyncFileWriter::close() noexcept {
+    if (fd_ < 0) {
+        return;
+    }
+    submit_current();
+    wait_idle();
+    if ((config_.sync_bytes != 0 || config_.sync_interval_ms != 0) && ::fdatasync(fd_) == 0) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ++stats_.syncs;
+    }
+    if (io_thread_.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        cv_.notify_all();
+        io_thread_.join();
+    }
+    ring_close();
+    ::close(fd_);
+    fd_ = -1;
+    backend_ = Backend::None;
+    has_current_ = false;
+    buffers_.clear();
+    arena_.reset();
+    free_.clear();
+    queued_.clear();
+}
+
+const char* AsyncFileWriter::backend_name() const noexcept {
+    switch (backend_) {
+        case Backend::IoUring:
+            return "io_uring";
+        case Backend::Pwritev:
+            return "pwritev";
+        case Backend::None:
+        default:
+            return "none";
+    }
+}
+
+AsyncFileWriterStats AsyncFileWriter::stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+void AsyncFileWriter::submit_current() {
+    if (!has_current_ || buffers_[current_].size == 0) {
+        return;
+    }
+    Buffer& buffer = buffers_[current_];
+    buffer.offset = next_offset_;
+    buffer.done = 0;
+    next_offset_ += buffer.size;
+    bytes_since_sync_ += buffer.size;
+    has_current_ = false;
+
+    if (backend_ == Backend::IoUring) {
+        ++ring_inflight_;
+        ring_submit_write(current_);
+        ring_reap(false);
+    } else {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            queued_.push_back(current_);
+        }
+        cv_.notify_all();
+    }
+    maybe_sync();
+}
+
+uint32_t AsyncFileWriter::acquire_buffer() {
+    uint32_t index = 0;
+    if (backend_ == Backend::IoUring) {
+        ring_reap(false);
+        if (free_.empty()) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            ++stats_.stalls;
+        }
+        while (free_.empty()) {
+            ring_reap(true);
+        }
+        index = free_.back();
+        free_.pop_back();
+    } else {
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (free_.empty()) {
+            ++stats_.stalls;
+            cv_.wait(lock, [this]() { return !free_.empty(); });
+        }
+        index = free_.back();
+        free_.pop_back();
+    }
+    buffers_[index].size = 0;
+    buffers_[index].done = 0;
+    return index;
+}
+
+void AsyncFileWriter::wait_idle() {
+    if (backend_ == Backend::IoUring) {
+        while (ring_inflight_ > 0 || ring_sync_inflight_) {
+            ring_reap(true);
+        }
+        return;
+    }
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait(lock, [this]() { return queued_.empty() && io_busy_ == 0 && !sync_requested_; });
+}
+
+void AsyncFileWriter::maybe_sync() {
+    if (bytes_since_sync_ == 0) {
+        return;
+    }
+    bool due = config_.sync_bytes != 0 && bytes_since_sync_ >= config_.sync_bytes;
+    int64_t now = 0;
+    if (!due && config_.sync_interval_ms != 0) {
+        now = steady_now_ns();
+        due = now - last_sync_ns_ >= static_cast<int64_t>(config_.sync_interval_ms) * 1000000;
+    }
+    if (!due) {
+        return;
+    }
+
+    if (backend_ == Backend::IoUring) {
+        // 上一次同步未完成时顺延，不堆积 fsync
+        if (ring_sync_inflight_) {
+            return;
+        }
+        ring_submit_sync();
+    } else {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            sync_requested_ = true;
+        }
+        cv_.notify_all();
+    }
+    bytes_since_sync_ = 0;
+    last_sync_ns_ = now != 0 ? now : steady_now_ns();
+}
+
+bool AsyncFileWriter::ring_init(uint32_t entries) {
+    io_uring_params params{};
+    const int fd = sys_io_uring_setup(entries, &params);
+    if (fd < 0) {
+        return false;
+    }
+
+    auto ring = std::make_unique<Ring>();
+    ring->fd = fd;
+    ring->sq_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    ring->cq_size = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    const bool single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (single_mmap) {
+        ring->sq_size = ring->cq_size = std::max(ring->sq_size, ring->cq_size);
+    }
+    ring->sq_ptr = ::mmap(nullptr, ring->sq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd,
+                          IORING_OFF_SQ_RING);
+    if (ring->sq_ptr == MAP_FAILED) {
+        ring->sq_ptr = nullptr;
+        ring_ = std::move(ring);
+        ring_close();
+        return false;
+    }
+    if (single_mmap) {
+        ring->cq_ptr = ring->sq_ptr;
+    } else {
+        ring->cq_ptr = ::mmap(nullptr, ring->cq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd,
+                              IORING_OFF_CQ_RING);
+        if (ring->cq_ptr == MAP_FAILED) {
+            ring->cq_ptr = nullptr;
+            ring_ = std::move(ring);
+            ring_close();
+            return false;
+        }
+    }
+    ring->sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+    void* sqes = ::mmap(nullptr, ring->sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd,
+                        IORING_OFF_SQES);
+    if (sqes == MAP_FAILED) {
+        ring_ = std::move(ring);
+        ring_close();
+        return false;
+    }
+    ring->sqes = static_cast<io_uring_sqe*>(sqes);
+
+    auto* sq = static_cast<char*>(ring->sq_ptr);
+    auto* cq = static_cast<char*>(ring->cq_ptr);
+    ring->sq_head = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+    ring->sq_tail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+    ring->sq_mask = reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+    ring->sq_array = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+    ring->sq_entries = params.sq_entries;
+    ring->cq_head = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+    ring->cq_tail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+    ring->cq_mask = reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+    ring->cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+    ring->iov.resize(buffers_.size());
+
+    ring_ = std::move(ring);
+    ring_inflight_ = 0;
+    ring_sync_inflight_ = false;
+    return true;
+}
+
+void AsyncFileWriter::ring_close() noexcept {
+    if (!ring_) {
+        return;
+    }
+    if (ring_->sqes != nullptr) {
+        ::munmap(ring_->sqes, ring_->sqes_size);
+    }
+    if (ring_->cq_ptr != nullptr && ring_->cq_ptr != ring_->sq_ptr) {
+        ::munmap(ring_->cq_ptr, ring_->cq_size);
+    }
+    if (ring_->sq_ptr != nullptr) {
+        ::munmap(ring_->sq_ptr, ring_->sq_size);
+    }
+    if (ring_->fd >= 0) {
+        ::close(ring_->fd);
+    }
+    ring_.reset();
+    ring_inflight_ = 0;
+    ring_sync_inflight_ = false;
+}
+
+namespace {
+
+// 取一个空闲 SQE 填好后立即提交；SQ 容量不小于缓冲块数 + 1，正常不会满
+template <typename Fill>
+void ring_push_and_enter(int ring_fd, unsigned* sq_head, unsigned* sq_tail, const unsigned* sq_mask,
+                         unsigned* sq_array, unsigned sq_entries, io_uring_sqe* sqes, Fill&& fill) {
+    const unsigned tail = *sq_tail;
+    while (tail - __atomic_load_n(sq_head, __ATOMIC_ACQUIRE) >= sq_entries) {
+        (void)sys_io_uring_enter(ring_fd, 0, 1, IORING_ENTER_GETEVENTS);
+    }
+    const unsigned index = tail & *sq_mask;
+    io_uring_sqe* sqe = &sqes[index];
+    std::memset(sqe, 0, sizeof(*sqe));
+    fill(*sqe);
+    sq_array[index] = index;
+    __atomic_store_n(sq_tail, tail + 1, __ATOMIC_RELEASE);
+    while (true) {
+        const int rc = sys_io_uring_enter(ring_fd, 1, 0, 0);
+        if (rc >= 0 || (errno != EINTR && errno != EAGAIN && errno != EBUSY)) {
+            return;
+        }
+    }
+}
+
+}  // namespace
+
+void AsyncFileWriter::ring_submit_write(uint32_t index) {
+    Buffer& buffer = buffers_[index];
+    iovec& iov = ring_->iov[index];
+    iov.iov_base = buffer.data + buffer.done;
+    iov.iov_len = buffer.size - buffer.done;
+    const int fd = fd_;
+    ring_push_and_enter(ring_->fd, ring_->sq_head, ring_->sq_tail, ring_->sq_mask, ring_->sq_array,
+                        ring_->sq_entries, ring_->sqes, [&](io_uring_sqe& sqe) {
+                            sqe.opcode = IORING_OP_WRITEV;
+                            sqe.fd = fd;
+                            sqe.addr = reinterpret_cast<uint64_t>(&iov);
+                            sqe.len = 1;
+                            sqe.off = buffer.offset + buffer.done;
+                            sqe.user_data = index;
+                        });
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++stats_.writes;
+}
+
+void AsyncFileWriter::ring_submit_sync() {
+    const int fd = fd_;
+    ring_sync_inflight_ = true;
+    // IO_DRAIN：等此前提交的写全部完成后才执行，保证同步覆盖它们
+    ring_push_and_enter(ring_->fd, ring_->sq_head, ring_->sq_tail, ring_->sq_mask, ring_->sq_array,
+                        ring_->sq_entries, ring_->sqes, [&](io_uring_sqe& sqe) {
+                            sqe.opcode = IORING_OP_FSYNC;
+                            sqe.fd = fd;
+                            sqe.fsync_flags = IORING_FSYNC_DATASYNC;
+                            sqe.flags = IOSQE_IO_DRAIN;
+                            sqe.user_data = kSyncUserData;
+                        });
+}
+
+void AsyncFileWriter::ring_reap(bool wait_one) {
+    if (!ring_) {
+        return;
+    }
+    unsigned head = *ring_->cq_head;
+    if (wait_one && head == __atomic_load_n(ring_->cq_tail, __ATOMIC_ACQUIRE) &&
+        (ring_inflight_ > 0 || ring_sync_inflight_)) {
+        (void)sys_io_uring_enter(ring_->fd, 0, 1, IORING_ENTER_GETEVENTS);
+    }
+    const unsigned tail = __atomic_load_n(ring_->cq_tail, __ATOMIC_ACQUIRE);
+    while (head != tail) {
+        const io_uring_cqe cqe = ring_->cqes[head & *ring_->cq_mask];
+        ++head;
+        if (cqe.user_data == kSyncUserData) {
+            ring_sync_inflight_ = false;
+            if (cqe.res < 0) {
+                record_error(-cqe.res);
+            } else {
+                std::lock_guard<std::mutex> lock(mutex_);
+                ++stats_.syncs;
+            }
+            continue;
+        }
+
+        const auto index = static_cast<uint32_t>(cqe.user_data);
+        Buffer& buffer = buffers_[index];
+        if (cqe.res == -EINTR || cqe.res == -EAGAIN) {
+            ring_submit_write(index);
+            continue;
+        }
+        if (cqe.res <= 0) {
+            record_error(cqe.res < 0 ? -cqe.res : EIO);
+        } else {
+            record_write(static_cast<std::size_t>(cqe.res));
+            buffer.done += static_cast<std::size_t>(cqe.res);
+            if (buffer.done < buffer.size) {
+                ring_submit_write(index);
+                continue;
+            }
+        }
+        --ring_inflight_;
+        free_.push_back(index);
+    }
+    __atomic_store_n(ring_->cq_head, head, __ATOMIC_RELEASE);
+}
+
+void AsyncFileWriter::io_thread_main() {
+    std::vector<uint32_t> batch;
+    batch.reserve(buffers_.size());
+    std::vector<iovec> iov(buffers_.size());
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        cv_.wait(lock, [this]() { return stop_ || !queued_.empty() || sync_requested_; });
+        if (!queued_.empty()) {
+            batch.swap(queued_);
+            io_busy_ = static_cast<uint32_t>(batch.size());
+            lock.unlock();
+
+            // 偏移相邻的块合并为一次 pwritev，短写时从断点续写
+            std::size_t begin = 0;
+            while (begin < batch.size()) {
+                std::size_t end = begin + 1;
+                while (end < batch.size() && buffers_[batch[end]].offset ==
+                                                 buffers_[batch[end - 1]].offset + buffers_[batch[end - 1]].size) {
+                    ++end;
+                }
+                int count = 0;
+                for (std::size_t i = begin; i < end; ++i) {
+                    iov[count].iov_base = buffers_[batch[i]].data;
+                    iov[count].iov_len = buffers_[batch[i]].size;
+                    ++count;
+                }
+                uint64_t offset = buffers_[batch[begin]].offset;
+                iovec* cursor = iov.data();
+                while (count > 0) {
+                    const ssize_t written = ::pwritev(fd_, cursor, count, static_cast<off_t>(offset));
+                    if (written < 0 && errno == EINTR) {
+                        continue;
+                    }
+                    if (written <= 0) {
+                        record_error(written < 0 ? errno : EIO);
+                        break;
+                    }
+                    {
+                        std::lock_guard<std::mutex> guard(mutex_);
+                        ++stats_.writes;
+                    }
+                    record_write(static_cast<std::size_t>(written));
+                    offset += static_cast<uint64_t>(written);
+                    std::size_t left = static_cast<std::size_t>(written);
+                    while (count > 0 && left >= cursor->iov_len) {
+                        left -= cursor->iov_len;
+                        ++cursor;
+                        --count;
+                    }
+                    if (count > 0) {
+                        cursor->iov_base = static_cast<char*>(cursor->iov_base) + left;
+                        cursor->iov_len -= left;
+                    }
+                }
+                begin = end;
+            }
+
+            lock.lock();
+            free_.insert(free_.end(), batch.begin(), batch.end());
+            batch.clear();
+            io_busy_ = 0;
+            cv_.notify_all();
+            continue;
+        }
+        if (sync_requested_) {
+            io_busy_ = 1;
+            lock.unlock();
+            const int rc = ::fdatasync(fd_);
+            const int err = errno;
+            lock.lock();
+            if (rc == 0) {
+                ++stats_.syncs;
+            } else {
+                ++stats_.errors;
+                stats_.last_errno = err;
+            }
+            sync_requested_ = false;
+            io_busy_ = 0;
+            cv_.notify_all();
+            continue;
+        }
+        if (stop_) {
+            return;
+        }
+    }
+}
+
+void AsyncFileWriter::record_write(std::size_t bytes) noexcept {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stats_.bytes_written += bytes;
+}
+
+void AsyncFileWriter::record_error(int err) noexcept {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++stats_.errors;
+    stats_.last_errno = err;
+}
+
+}  // namespace base_core
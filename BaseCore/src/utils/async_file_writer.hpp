@@ -0,0 +1,129 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace base_core {
+
+struct AsyncFileWriterConfig {
+    std::size_t buffer_bytes = std::size_t{1} << 20;  // 单块缓冲大小，向上取整到 4096
+    uint32_t buffer_count = 4;                        // 缓冲块数，至少 2：一块在填，其余在途
+    uint64_t sync_bytes = 0;                          // 距上次 fdatasync 累计写出达到该字节数时再同步，0 不按字节
+    uint32_t sync_interval_ms = 0;                    // 距上次 fdatasync 超过该间隔且有新数据时再同步，0 不按时间
+    bool use_io_uring = true;                         // false 或内核不支持时退回 pwritev 后台线程
+};
+
+struct AsyncFileWriterStats {
+    uint64_t bytes_written = 0;   // 已确认落到页缓存的字节数
+    uint64_t writes = 0;          // 提交的写请求数（io_uring SQE 或 pwritev 调用）
+    uint64_t syncs = 0;           // 完成的 fdatasync 次数
+    uint64_t stalls = 0;          // 缓冲全部在途、写入方等待完成的次数
+    uint64_t errors = 0;          // 写或同步失败次数（失败的块被丢弃）
+    int last_errno = 0;
+};
+
+// 追加写文件的异步写出器：调用方把字节拷进 4 KiB 对齐的大块缓冲，写满或 flush() 时整块交给内核，
+// 写入方不等待磁盘。io_uring 后端在调用线程直接提交 SQE 并顺手收割完成；pwritev 后端由一个后台线程把
+// 相邻的待写块合并成一次 pwritev。fdatasync 按字节/时间批量触发，不跟随每次写出。
+// 只有在所有缓冲都在途时 write() 才会阻塞（计入 stats().stalls），磁盘抖动由缓冲块数吸收。
+// 接口只允许单线程调用；文件按显式偏移写，不使用 O_APPEND。
+class AsyncFileWriter {
+public:
+    enum class Backend : uint8_t { None = 0, IoUring = 1, Pwritev = 2 };
+
+    AsyncFileWriter();
+    ~AsyncFileWriter();
+
+    AsyncFileWriter(const AsyncFileWriter&) = delete;
+    AsyncFileWriter& operator=(const AsyncFileWriter&) = delete;
+
+    // 打开（不存在则创建）文件，truncate=false 时从文件末尾续写
+    bool open(const std::string& path, bool truncate = false, const AsyncFileWriterConfig& config = {});
+
+    // 拷贝追加；只在文件未打开时返回 false，写出失败体现在 stats().errors
+    bool write(const void* data, std::size_t size);
+    bool write(std::string_view text) { return write(text.data(), text.size()); }
+
+    // 把当前未满的缓冲交给内核，不等待完成
+    void flush();
+
+    // flush 并等待全部在途写完成（数据已进页缓存、对读者可见），不 fdatasync；返回期间是否无错误
+    bool drain();
+
+    // drain 后 fdatasync，返回期间是否无错误
+    bool sync();
+
+    // 覆盖写整个文件：等在途写完成、截断为 0 后写入 data（快照类输出使用），不等待本次写完成
+    bool rewrite(const void* data, std::size_t size);
+    bool rewrite(std::string_view text) { return rewrite(text.data(), text.size()); }
+
+    // flush、等待在途写完成；配置了同步策略时再 fdatasync 一次，然后关闭文件
+    void close() noexcept;
+
+    bool is_open() const noexcept { return fd_ >= 0; }
+    Backend backend() const noexcept { return backend_; }
+    const char* backend_name() const noexcept;
+    AsyncFileWriterStats stats() const;
+
+private:
+    struct Buffer {
+        char* data = nullptr;
+        std::size_t size = 0;     // 已填字节
+        std::size_t done = 0;     // 已写出字节（短写续写用）
+        uint64_t offset = 0;      // 文件偏移
+    };
+    struct Ring;
+
+    void submit_current();
+    uint32_t acquire_buffer();
+    void wait_idle();
+    void maybe_sync();
+
+    // io_uring 后端
+    bool ring_init(uint32_t entries);
+    void ring_close() noexcept;
+    void ring_submit_write(uint32_t index);
+    void ring_submit_sync();
+    void ring_reap(bool wait_one);
+
+    // pwritev 后端
+    void io_thread_main();
+    void record_write(std::size_t bytes) noexcept;
+    void record_error(int err) noexcept;
+
+    int fd_ = -1;
+    Backend backend_ = Backend::None;
+    AsyncFileWriterConfig config_{};
+    std::size_t buffer_bytes_ = 0;
+    std::unique_ptr<char, void (*)(void*)> arena_{nullptr, nullptr};
+    std::vector<Buffer> buffers_{};
+    uint32_t current_ = 0;
+    bool has_current_ = false;
+    uint64_t next_offset_ = 0;
+    uint64_t bytes_since_sync_ = 0;
+    int64_t last_sync_ns_ = 0;
+
+    std::unique_ptr<Ring> ring_{};
+    uint32_t ring_inflight_ = 0;
+    bool ring_sync_inflight_ = false;
+
+    // 以下由 mutex_ 保护（io_uring 后端只有调用线程访问，锁不争用）
+    mutable std::mutex mutex_{};
+    std::condition_variable cv_{};
+    std::vector<uint32_t> free_{};
+    std::vector<uint32_t> queued_{};   // pwritev 后端待写块，按文件偏移递增
+    uint32_t io_busy_ = 0;             // pwritev 线程正在写的块数
+    bool sync_requested_ = false;
+    bool stop_ = false;
+    AsyncFileWriterStats stats_{};
+    std::thread io_thread_{};
+};
+
+}  // namespace base_core
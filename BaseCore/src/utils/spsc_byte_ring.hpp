@@ -0,0 +1,271 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace base_core {
+
+// 单生产者单消费者变长记录字节环，可直接放在共享内存中（init() 初始化，不持有指针）
+// Capacity 为数据区字节数，必须是 2 的幂
+//
+// 记录布局：[SpscByteRecordHeader: 8字节] + [payload]，整体按 8 字节对齐；
+// 环尾剩余空间放不下一条记录时写一条填充记录跳到环头，payload 因此总是连续的，读写都可原地进行。
+//
+// 生产者：try_claim 在环内原地申请 payload 空间（可连续申请多条），commit 一次 release 发布全部已申请记录；
+// 消费者：read_batch 一次 acquire 取得可读范围，逐条回调后一次 release 归还整批空间。
+// head_/tail_ 为单调递增的字节位置（不取模），生产者/消费者各自在本侧缓存行内缓存对端位置。
+
+struct SpscByteRecordHeader {
+    uint32_t size;  // payload 字节数（不含头部与对齐填充）
+    uint32_t type;  // 调用方自定义的记录类型；kSpscBytePaddingType 为环尾填充
+};
+
+static_assert(sizeof(SpscByteRecordHeader) == 8, "SpscByteRecordHeader must be 8 bytes");
+
+inline constexpr uint32_t kSpscBytePaddingType = 0xFFFFFFFFU;
+inline constexpr std::size_t kSpscByteRecordAlign = 8;
+
+// 消费者看到的一条记录：data 指向环内 payload，仅在本次回调 / pop_front 之前有效
+struct SpscByteRecordView {
+    uint32_t type = 0;
+    uint32_t size = 0;
+    const void* data = nullptr;
+};
+
+template <std::size_t Capacity>
+class alignas(64) SpscByteRing {
+    static_assert((Capacity & (Capacity - 1)) == 0, "Capacity must be power of 2");
+    static_assert(Capacity >= 64, "Capacity must be at least 64 bytes");
+
+public:
+    // 单条记录 payload 上限：保证空环时任何位置都能放下“环尾填充 + 记录”
+    static constexpr std::size_t kMaxRecordSize = Capacity / 2 - sizeof(SpscByteRecordHeader);
+
+    // 共享内存中初始化
+    void init() noexcept;
+
+    // 生产者：原地申请 size 字节 payload，返回可写指针（8 字节对齐），空间不足或超过上限返回 nullptr；
+    // 申请的记录在 commit 前对消费者不可见，可连续申请多条后一次提交
+    void* try_claim(uint32_t type, std::size_t size) noexcept;
+
+    // 生产者：发布全部已申请的记录
+    void commit() noexcept;
+
+    // 生产者：放弃全部尚未提交的申请
+    void abort_claims() noexcept;
+
+    // 生产者：拷贝写入一条记录并立即发布（已有未提交申请时一并发布）
+    bool try_write(uint32_t type, const void* data, std::size_t size) noexcept;
+
+    // 生产者：当前可写字节数（含记录头与对齐开销），传 needed 时本侧缓存已够则不读对端位置
+    std::size_t free_bytes(std::size_t needed = Capacity) noexcept;
+
+    // 消费者：最多读取 max_records 条记录，逐条调用 fn(const SpscByteRecordView&)，结束后一次归还空间；返回条数
+    template <typename Fn>
+    std::size_t read_batch(Fn&& fn, std::size_t max_records = SIZE_MAX) noexcept;
+
+    // 消费者：查看下一条记录但不取走
+    bool try_peek(SpscByteRecordView& out) noexcept;
+
+    // 消费者：取走 try_peek 看到的那条记录
+    void pop_front() noexcept;
+
+    // 已发布未消费的字节数（近似值，含记录头与填充）
+    std::size_t size_bytes() const noexcept;
+
+    // 是否为空
+    bool empty() const noexcept;
+
+    // 数据区容量
+    static constexpr std::size_t capacity() noexcept { return Capacity; }
+
+    // 记录在环内占用的字节数（头部 + payload，对齐到 8 字节）
+    static constexpr std::size_t record_bytes(std::size_t size) noexcept {
+        return (sizeof(SpscByteRecordHeader) + size + kSpscByteRecordAlign - 1) & ~(kSpscByteRecordAlign - 1);
+    }
+
+private:
+    static constexpr std::size_t kMask = Capacity - 1;
+
+    SpscByteRecordHeader* header_at(uint64_t pos) noexcept {
+        return reinterpret_cast<SpscByteRecordHeader*>(&buffer_[pos & kMask]);
+    }
+
+    // 消费者：跳过 tail 处的填充记录，返回下一条真实记录位置；ready 为已发布终点
+    uint64_t skip_padding(uint64_t tail, uint64_t ready) noexcept;
+
+    // 生产者独占缓存行：已发布位置、已申请未提交位置与消费者位置副本
+    alignas(64) std::atomic<uint64_t> head_{0};
+    uint64_t pending_head_{0};
+    uint64_t cached_tail_{0};
+    // 消费者独占缓存行：已归还位置与生产者位置副本
+    alignas(64) std::atomic<uint64_t> tail_{0};
+    uint64_t cached_head_{0};
+    alignas(64) unsigned char buffer_[Capacity];
+};
+
+// ============ 实现 ============
+
+template <std::size_t Capacity>
+void SpscByteRing<Capacity>::init() noexcept {
+    head_.store(0, std::memory_order_relaxed);
+    tail_.store(0, std::memory_order_relaxed);
+    pending_head_ = 0;
+    cached_tail_ = 0;
+    cached_head_ = 0;
+}
+
+template <std::size_t Capacity>
+std::size_t SpscByteRing<Capacity>::free_bytes(std::size_t needed) noexcept {
+    std::size_t free = Capacity - static_cast<std::size_t>(pending_head_ - cached_tail_);
+    if (free < needed) {
+        cached_tail_ = tail_.load(std::memory_order_acquire);
+        free = Capacity - static_cast<std::size_t>(pending_head_ - cached_tail_);
+    }
+    return free;
+}
+
+template <std::size_t Capacity>
+void* SpscByteRing<Capacity>::try_claim(uint32_t type, std::size_t size) noexcept {
+    if (size > kMaxRecordSize) {
+        return nullptr;
+    }
+
+    const std::size_t bytes = record_bytes(size);
+    const std::size_t offset = static_cast<std::size_t>(pending_head_ & kMask);
+    const std::size_t to_end = Capacity - offset;
+    const std::size_t padding = (bytes <= to_end) ? 0 : to_end;
+    if (free_bytes(padding + bytes) < padding + bytes) {
+        return nullptr;
+    }
+
+    if (padding != 0) {
+        SpscByteRecordHeader* pad = header_at(pending_head_);
+        pad->size = static_cast<uint32_t>(padding - sizeof(SpscByteRecordHeader));
+        pad->type = kSpscBytePaddingType;
+        pending_head_ += padding;
+    }
+
+    SpscByteRecordHeader* header = header_at(pending_head_);
+    header->size = static_cast<uint32_t>(size);
+    header->type = type;
+    pending_head_ += bytes;
+    return header + 1;
+}
+
+template <std::size_t Capacity>
+void SpscByteRing<Capacity>::commit() noexcept {
+    if (pending_head_ != head_.load(std::memory_order_relaxed)) {
+        head_.store(pending_head_, std::memory_order_release);
+    }
+}
+
+template <std::size_t Capacity>
+void SpscByteRing<Capacity>::abort_claims() noexcept {
+    pending_head_ = head_.load(std::memory_order_relaxed);
+}
+
+template <std::size_t Capacity>
+bool SpscByteRing<Capacity>::try_write(uint32_t type, const void* data, std::size_t size) noexcept {
+    void* payload = try_claim(type, size);
+    if (payload == nullptr) {
+        return false;
+    }
+    if (size != 0) {
+        std::memcpy(payload, data, size);
+    }
+    commit();
+    return true;
+}
+
+template <std::size_t Capacity>
+uint64_t SpscByteRing<Capacity>::skip_padding(uint64_t tail, uint64_t ready) noexcept {
+    // 填充记录只出现在环尾，且后面紧跟一条真实记录，最多跳过一次
+    if (tail != ready) {
+        const SpscByteRecordHeader* header = header_at(tail);
+        if (header->type == kSpscBytePaddingType) {
+            tail += sizeof(SpscByteRecordHeader) + header->size;
+        }
+    }
+    return tail;
+}
+
+template <std::size_t Capacity>
+template <typename Fn>
+std::size_t SpscByteRing<Capacity>::read_batch(Fn&& fn, std::size_t max_records) noexcept {
+    const uint64_t start = tail_.load(std::memory_order_relaxed);
+    if (cached_head_ == start) {
+        cached_head_ = head_.load(std::memory_order_acquire);
+    }
+    const uint64_t ready = cached_head_;
+
+    uint64_t tail = start;
+    std::size_t count = 0;
+    while (count < max_records) {
+        tail = skip_padding(tail, ready);
+        if (tail == ready) {
+            break;
+        }
+        const SpscByteRecordHeader* header = header_at(tail);
+        SpscByteRecordView view;
+        view.type = header->type;
+        view.size = header->size;
+        view.data = header + 1;
+        fn(static_cast<const SpscByteRecordView&>(view));
+        tail += record_bytes(header->size);
+        ++count;
+    }
+
+    if (tail != start) {
+        tail_.store(tail, std::memory_order_release);
+    }
+    return count;
+}
+
+template <std::size_t Capacity>
+bool SpscByteRing<Capacity>::try_peek(SpscByteRecordView& out) noexcept {
+    uint64_t tail = tail_.load(std::memory_order_relaxed);
+    if (cached_head_ == tail) {
+        cached_head_ = head_.load(std::memory_order_acquire);
+    }
+    const uint64_t skipped = skip_padding(tail, cached_head_);
+    if (skipped != tail) {
+        // 填充记录直接归还，生产者可尽早复用环尾空间
+        tail = skipped;
+        tail_.store(tail, std::memory_order_release);
+    }
+    if (tail == cached_head_) {
+        return false;
+    }
+    const SpscByteRecordHeader* header = header_at(tail);
+    out.type = header->type;
+    out.size = header->size;
+    out.data = header + 1;
+    return true;
+}
+
+template <std::size_t Capacity>
+void SpscByteRing<Capacity>::pop_front() noexcept {
+    const uint64_t tail = skip_padding(tail_.load(std::memory_order_relaxed), cached_head_);
+    if (tail == cached_head_) {
+        return;
+    }
+    const SpscByteRecordHeader* header = header_at(tail);
+    tail_.store(tail + record_bytes(header->size), std::memory_order_release);
+}
+
+template <std::size_t Capacity>
+std::size_t SpscByteRing<Capacity>::size_bytes() const noexcept {
+    const uint64_t head = head_.load(std::memory_order_acquire);
+    const uint64_t tail = tail_.load(std::memory_order_acquire);
+    return static_cast<std::size_t>(head - tail);
+}
+
+template <std::size_t Capacity>
+bool SpscByteRing<Capacity>::empty() const noexcept {
+    return head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_acquire);
+}
+
+}  // namespace base_core
@@ -0,0 +1,186 @@
+/**
+ * spsc_byte_ring_benchmark: 变长字节环与定长元素环的跨线程吞吐对比
+ * 用法: spsc_byte_ring_benchmark [messages] [producer_cpu] [consumer_cpu]
+ *   messages: 每组搬运的消息条数，默认 5000000
+ *   producer_cpu / consumer_cpu: 绑定 CPU 核，-1 表示不绑定，默认 -1
+ * 消息长度在 [min, max] 内按序号轮转；定长环每个元素按 max 占位，字节环按实际长度占位。
+ * 每组输出 消息/秒、有效载荷 MB/秒 与校验失败次数（应为 0）。
+ */
+
+#include "utils/spsc_byte_ring.hpp"
+#include "utils/spsc_queue.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <thread>
+
+#if defined(__linux__)
+#include <sched.h>
+#endif
+
+namespace {
+
+constexpr std::size_t kMaxMessage = 256;
+constexpr std::size_t kRingBytes = 1U << 20;
+constexpr std::size_t kQueueSlots = kRingBytes / kMaxMessage;
+
+struct FixedMessage {
+    uint32_t size;
+    uint32_t seq;
+    unsigned char body[kMaxMessage - 2 * sizeof(uint32_t)];
+};
+
+struct BenchResult {
+    double seconds = 0.0;
+    uint64_t payload_bytes = 0;
+    uint64_t errors = 0;
+};
+
+void pin_to_cpu(int cpu) {
+#if defined(__linux__)
+    if (cpu < 0) {
+        return;
+    }
+    cpu_set_t cpuset;
+    CPU_ZERO(&cpuset);
+    CPU_SET(cpu, &cpuset);
+    (void)sched_setaffinity(0, sizeof(cpuset), &cpuset);
+#else
+    (void)cpu;
+#endif
+}
+
+// 消息长度：至少能放下序号
+std::size_t message_size(uint32_t seq, std::size_t min_size, std::size_t max_size) {
+    return min_size + (static_cast<std::size_t>(seq) * 61U) % (max_size - min_size + 1);
+}
+
+BenchResult run_fixed(uint64_t messages, std::size_t min_size, std::size_t max_size, int producer_cpu,
+                      int consumer_cpu) {
+    using Queue = base_core::SpscQueue<FixedMessage, kQueueSlots>;
+    auto queue = std::make_unique<Queue>();
+    queue->init();
+
+    BenchResult result;
+    const auto begin = std::chrono::steady_clock::now();
+    std::thread producer([&]() {
+        pin_to_cpu(producer_cpu);
+        FixedMessage message{};
+        for (uint32_t seq = 0; seq < messages;) {
+            message.seq = seq;
+            message.size = static_cast<uint32_t>(message_size(seq, min_size, max_size));
+            std::memset(message.body, static_cast<int>(seq & 0xFF), message.size - 2 * sizeof(uint32_t));
+            if (queue->try_push(message)) {
+                ++seq;
+            }
+        }
+    });
+
+    pin_to_cpu(consumer_cpu);
+    FixedMessage batch[32];
+    uint64_t expected = 0;
+    while (expected < messages) {
+        const std::size_t n = queue->try_pop_bulk(batch, 32);
+        for (std::size_t i = 0; i < n; ++i) {
+            result.errors += (batch[i].seq != expected) ? 1 : 0;
+            result.payload_bytes += batch[i].size;
+            ++expected;
+        }
+    }
+    producer.join();
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    return result;
+}
+
+BenchResult run_bytes(uint64_t messages, std::size_t min_size, std::size_t max_size, std::size_t commit_every,
+                      int producer_cpu, int consumer_cpu) {
+    using Ring = base_core::SpscByteRing<kRingBytes>;
+    auto ring = std::make_unique<Ring>();
+    ring->init();
+
+    BenchResult result;
+    const auto begin = std::chrono::steady_clock::now();
+    std::thread producer([&]() {
+        pin_to_cpu(producer_cpu);
+        std::size_t pending = 0;
+        for (uint32_t seq = 0; seq < messages;) {
+            const std::size_t size = message_size(seq, min_size, max_size);
+            auto* slot = static_cast<unsigned char*>(ring->try_claim(1, size));
+            if (slot == nullptr) {
+                ring->commit();
+                pending = 0;
+                continue;
+            }
+            // 原地写：序号 + 填充
+            std::memcpy(slot, &seq, sizeof(seq));
+            std::memset(slot + sizeof(seq), static_cast<int>(seq & 0xFF), size - sizeof(seq));
+            ++seq;
+            if (++pending >= commit_every) {
+                ring->commit();
+                pending = 0;
+            }
+        }
+        ring->commit();
+    });
+
+    pin_to_cpu(consumer_cpu);
+    uint64_t expected = 0;
+    while (expected < messages) {
+        (void)ring->read_batch(
+            [&](const base_core::SpscByteRecordView& view) {
+                uint32_t seq = 0;
+                std::memcpy(&seq, view.data, sizeof(seq));
+                result.errors += (seq != expected) ? 1 : 0;
+                result.payload_bytes += view.size;
+                ++expected;
+            },
+            32);
+    }
+    producer.join();
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    return result;
+}
+
+void print_row(const char* impl, std::size_t min_size, std::size_t max_size, uint64_t messages,
+               const BenchResult& r) {
+    const double rate = r.seconds > 0 ? static_cast<double>(messages) / r.seconds : 0.0;
+    const double mbps = r.seconds > 0 ? static_cast<double>(r.payload_bytes) / r.seconds / 1e6 : 0.0;
+    std::printf("%-16s %5zu-%-5zu %12.0f %10.1f %6llu\n", impl, min_size, max_size, rate, mbps,
+                static_cast<unsigned long long>(r.errors));
+}
+
+long parse_arg(int argc, char* argv[], int index, long fallback, long min_value, long max_value) {
+    if (argc <= index) {
+        return fallback;
+    }
+    char* end = nullptr;
+    const long value = std::strtol(argv[index], &end, 10);
+    if (end == argv[index] || value < min_value || value > max_value) {
+        return fallback;
+    }
+    return value;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    const uint64_t messages = static_cast<uint64_t>(parse_arg(argc, argv, 1, 5000000, 1, 2000000000));
+    const int producer_cpu = static_cast<int>(parse_arg(argc, argv, 2, -1, -1, 1023));
+    const int consumer_cpu = static_cast<int>(parse_arg(argc, argv, 3, -1, -1, 1023));
+
+    std::printf("%-16s %11s %12s %10s %6s\n", "impl", "size", "msgs/s", "MB/s", "errors");
+    static constexpr std::size_t kRanges[][2] = {{16, 64}, {16, 256}, {200, 256}};
+    for (const auto& range : kRanges) {
+        print_row("fixed_queue", range[0], range[1], messages,
+                  run_fixed(messages, range[0], range[1], producer_cpu, consumer_cpu));
+        print_row("byte_ring_c1", range[0], range[1], messages,
+                  run_bytes(messages, range[0], range[1], 1, producer_cpu, consumer_cpu));
+        print_row("byte_ring_c16", range[0], range[1], messages,
+                  run_bytes(messages, range[0], range[1], 16, producer_cpu, consumer_cpu));
+    }
+    return 0;
+}
@@ -2,13 +2,16 @@
 
 #include <atomic>
 #include <cstddef>
+#include <cstring>
 #include <type_traits>
 
 namespace base_core {
 
 // 单生产者单消费者无锁环形队列
-// T 必须可拷贝赋值（支持含 std::atomic 成员的类型）
+// T 必须可拷贝赋值；可平凡拷贝时批量接口按整块内存拷贝搬运，否则逐个赋值
 // Capacity 必须是 2 的幂
+// 生产者/消费者各自在本侧缓存行内缓存对端索引，只有缓存不足时才 acquire 对端索引，
+// 批量接口一次 acquire + 一次 release 完成整批搬运，减少跨核缓存行往返。
 template <typename T, std::size_t Capacity>
 class alignas(64) SpscQueue {
     static_assert(std::is_copy_assignable_v<T>, "T must be copy assignable");
@@ -21,9 +24,24 @@ public:
     // 生产者：尝试写入
     bool try_push(const T& item) noexcept;
 
+    // 生产者：批量写入最多 count 个元素，返回实际写入数量
+    std::size_t try_push_bulk(const T* items, std::size_t count) noexcept;
+
+    // 生产者：跳过已申请未提交的 skip 个槽位，原地申请至多 max_count 个连续空槽（不跨环尾），返回数量
+    std::size_t try_claim(std::size_t skip, std::size_t max_count, T*& out_first) noexcept;
+
+    // 生产者：提交 try_claim 所得的前 count 个已写好的槽位
+    void commit(std::size_t count) noexcept;
+
+    // 生产者：当前可写入的空槽数；本侧缓存已够 needed 时不读对端索引，传 capacity() 取精确值
+    std::size_t free_slots(std::size_t needed) noexcept;
+
     // 消费者：尝试读取
     bool try_pop(T& item) noexcept;
 
+    // 消费者：批量读取最多 max_count 个元素，返回实际读取数量
+    std::size_t try_pop_bulk(T* out, std::size_t max_count) noexcept;
+
     // 消费者：只看不取
     bool try_peek(T& item) const noexcept;
 
@@ -39,8 +57,20 @@ public:
 private:
     static constexpr std::size_t kMask = Capacity - 1;
 
+    // 生产者视角的剩余空间；缓存不足 needed 时才刷新对端 tail。
+    std::size_t producer_free_slots(std::size_t head, std::size_t needed) noexcept;
+
+    // 消费者视角的可读元素数；缓存不足 needed 时才刷新对端 head。
+    std::size_t consumer_ready_slots(std::size_t tail, std::size_t needed) noexcept;
+
+    static void copy_items(T* dst, const T* src, std::size_t count) noexcept;
+
+    // 生产者独占缓存行：head_ 与生产者缓存的 tail 副本
     alignas(64) std::atomic<std::size_t> head_{0};
+    std::size_t cached_tail_{0};
+    // 消费者独占缓存行：tail_ 与消费者缓存的 head 副本
     alignas(64) std::atomic<std::size_t> tail_{0};
+    std::size_t cached_head_{0};
     alignas(64) T buffer_[Capacity];
 };
 
@@ -50,14 +80,52 @@ template <typename T, std::size_t Capacity>
 void SpscQueue<T, Capacity>::init() noexcept {
     head_.store(0, std::memory_order_relaxed);
     tail_.store(0, std::memory_order_relaxed);
+    cached_tail_ = 0;
+    cached_head_ = 0;
+}
+
+template <typename T, std::size_t Capacity>
+void SpscQueue<T, Capacity>::copy_items(T* dst, const T* src, std::size_t count) noexcept {
+    if constexpr (std::is_trivially_copyable_v<T>) {
+        std::memcpy(static_cast<void*>(dst), static_cast<const void*>(src), count * sizeof(T));
+    } else {
+        for (std::size_t i = 0; i < count; ++i) {
+            dst[i] = src[i];
+        }
+    }
+}
+
+template <typename T, std::size_t Capacity>
+std::size_t SpscQueue<T, Capacity>::producer_free_slots(std::size_t head, std::size_t needed) noexcept {
+    std::size_t free_slots = (cached_tail_ - head - 1) & kMask;
+    if (free_slots < needed) {
+        cached_tail_ = tail_.load(std::memory_order_acquire);
+        free_slots = (cached_tail_ - head - 1) & kMask;
+    }
+    return free_slots;
+}
+
+template <typename T, std::size_t Capacity>
+std::size_t SpscQueue<T, Capacity>::consumer_ready_slots(std::size_t tail, std::size_t needed) noexcept {
+    std::size_t ready = (cached_head_ - tail) & kMask;
+    if (ready < needed) {
+        cached_head_ = head_.load(std::memory_order_acquire);
+        ready = (cached_head_ - tail) & kMask;
+    }
+    return ready;
+}
+
+template <typename T, std::size_t Capacity>
+std::size_t SpscQueue<T, Capacity>::free_slots(std::size_t needed) noexcept {
+    return producer_free_slots(head_.load(std::memory_order_relaxed), needed);
 }
 
 template <typename T, std::size_t Capacity>
 bool SpscQueue<T, Capacity>::try_push(const T& item) noexcept {
     const std::size_t head = head_.load(std::memory_order_relaxed);
-    const std::size_t tail = tail_.load(std::memory_order_acquire);
 
-    if (((head + 1) & kMask) == tail) {
+    // 检查队列是否已满
+    if (producer_free_slots(head, 1) == 0) {
         return false;
     }
 
@@ -66,12 +134,66 @@ bool SpscQueue<T, Capacity>::try_push(const T& item) noexcept {
     return true;
 }
 
+template <typename T, std::size_t Capacity>
+std::size_t SpscQueue<T, Capacity>::try_push_bulk(const T* items, std::size_t count) noexcept {
+    if (items == nullptr || count == 0) {
+        return 0;
+    }
+
+    const std::size_t head = head_.load(std::memory_order_relaxed);
+    const std::size_t free_slots = producer_free_slots(head, count);
+    const std::size_t n = (count < free_slots) ? count : free_slots;
+    if (n == 0) {
+        return 0;
+    }
+
+    // 环尾剩余段与回绕段分两次整块拷贝
+    const std::size_t first = (n < Capacity - head) ? n : Capacity - head;
+    copy_items(&buffer_[head], items, first);
+    if (n > first) {
+        copy_items(&buffer_[0], items + first, n - first);
+    }
+
+    head_.store((head + n) & kMask, std::memory_order_release);
+    return n;
+}
+
+template <typename T, std::size_t Capacity>
+std::size_t SpscQueue<T, Capacity>::try_claim(std::size_t skip, std::size_t max_count, T*& out_first) noexcept {
+    out_first = nullptr;
+    if (max_count == 0) {
+        return 0;
+    }
+
+    const std::size_t head = head_.load(std::memory_order_relaxed);
+    const std::size_t free_slots = producer_free_slots(head, skip + max_count);
+    if (free_slots <= skip) {
+        return 0;
+    }
+
+    const std::size_t start = (head + skip) & kMask;
+    std::size_t n = free_slots - skip;
+    n = (max_count < n) ? max_count : n;
+    n = (n < Capacity - start) ? n : Capacity - start;
+    out_first = &buffer_[start];
+    return n;
+}
+
+template <typename T, std::size_t Capacity>
+void SpscQueue<T, Capacity>::commit(std::size_t count) noexcept {
+    if (count == 0) {
+        return;
+    }
+    const std::size_t head = head_.load(std::memory_order_relaxed);
+    head_.store((head + count) & kMask, std::memory_order_release);
+}
+
 template <typename T, std::size_t Capacity>
 bool SpscQueue<T, Capacity>::try_pop(T& item) noexcept {
     const std::size_t tail = tail_.load(std::memory_order_relaxed);
-    const std::size_t head = head_.load(std::memory_order_acquire);
 
-    if (tail == head) {
+    // 检查队列是否为空
+    if (consumer_ready_slots(tail, 1) == 0) {
         return false;
     }
 
@@ -80,6 +202,29 @@ bool SpscQueue<T, Capacity>::try_pop(T& item) noexcept {
     return true;
 }
 
+template <typename T, std::size_t Capacity>
+std::size_t SpscQueue<T, Capacity>::try_pop_bulk(T* out, std::size_t max_count) noexcept {
+    if (out == nullptr || max_count == 0) {
+        return 0;
+    }
+
+    const std::size_t tail = tail_.load(std::memory_order_relaxed);
+    const std::size_t ready = consumer_ready_slots(tail, max_count);
+    const std::size_t n = (max_count < ready) ? max_count : ready;
+    if (n == 0) {
+        return 0;
+    }
+
+    const std::size_t first = (n < Capacity - tail) ? n : Capacity - tail;
+    copy_items(out, &buffer_[tail], first);
+    if (n > first) {
+        copy_items(out + first, &buffer_[0], n - first);
+    }
+
+    tail_.store((tail + n) & kMask, std::memory_order_release);
+    return n;
+}
+
 template <typename T, std::size_t Capacity>
 bool SpscQueue<T, Capacity>::try_peek(T& item) const noexcept {
     const std::size_t tail = tail_.load(std::memory_order_relaxed);
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+namespace acct_service::bench {
+
+// 单个基准的运行状态：用例先做准备，再用 while (state.keep_running()) { ... } 跑被测操作。
+// 首次调用开始计时，跑满 iterations() 次后停止计时，夹具的析构不计入。
+class state {
+public:
+    state(uint64_t iterations, uint64_t arg) noexcept : iterations_(iterations), remaining_(iterations), arg_(arg) {}
+
+    uint64_t iterations() const noexcept { return iterations_; }
+    // 注册时指定的参数（如会话数），未指定为 0
+    uint64_t arg() const noexcept { return arg_; }
+
+    bool keep_running() noexcept {
+        if (!started_) {
+            start();
+        }
+        if (remaining_ == 0) {
+            stop();
+            return false;
+        }
+        --remaining_;
+        return true;
+    }
+
+    // 用例中途返回（如夹具准备失败）时由运行器调用
+    void stop() noexcept;
+
+    std::chrono::nanoseconds elapsed() const noexcept { return elapsed_; }
+    uint64_t allocations() const noexcept { return allocations_; }
+
+    // 声明计时区间内不允许堆分配：运行器发现 allocs/op 非 0 时报错并以非 0 退出
+    void require_no_allocations() noexcept { no_allocations_required_ = true; }
+    bool no_allocations_required() const noexcept { return no_allocations_required_; }
+
+private:
+    void start() noexcept;
+
+    uint64_t iterations_ = 0;
+    uint64_t remaining_ = 0;
+    uint64_t arg_ = 0;
+    bool started_ = false;
+    bool running_ = false;
+    std::chrono::steady_clock::time_point started_at_{};
+    uint64_t allocations_at_start_ = 0;
+    std::chrono::nanoseconds elapsed_{0};
+    uint64_t allocations_ = 0;
+    bool no_allocations_required_ = false;
+};
+
+using bench_fn = void (*)(state&);
+
+// 注册基准；max_iterations 非 0 时限制单轮迭代数（被测操作会消耗有限资源时使用，如订单池槽位）
+bool register_bench(const char* name, bench_fn fn, uint64_t arg = 0, uint64_t max_iterations = 0);
+
+// 当前线程累计的 operator new 次数，由 acct_alloc_guard 统计；未启用 ACCT_ENABLE_ALLOC_GUARD 时恒为 0
+uint64_t allocation_count() noexcept;
+
+// 阻止编译器把被测结果当作死代码消除
+template <typename T>
+inline void do_not_optimize(const T& value) noexcept {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+}  // namespace acct_service::bench
+
+#define ACCT_BENCH_CAT_(a, b) a##b
+#define ACCT_BENCH_CAT(a, b) ACCT_BENCH_CAT_(a, b)
+
+// 以参数 arg 注册已定义的基准函数，同一函数可按不同参数注册多次
+#define ACCT_BENCH_REGISTER(fn, arg, max_iterations)                                                \
+    static const bool ACCT_BENCH_CAT(fn##_registered_, __LINE__) =                                  \
+        ::acct_service::bench::register_bench(#fn, fn, (arg), (max_iterations))
+
+// 定义并注册无参数基准
+#define ACCT_BENCH(fn)                          \
+    static void fn(::acct_service::bench::state& state); \
+    ACCT_BENCH_REGISTER(fn, 0, 0);              \
+    static void fn(::acct_service::bench::state& state)
@@ -0,0 +1,157 @@
+#include <cstring>
+#include <memory>
+
+#include "bench.hpp"
+#include "core/event_loop.hpp"
+#include "order/order_router.hpp"
+#include "portfolio/position_manager.hpp"
+#include "risk/risk_manager.hpp"
+#include "shm/orders_shm.hpp"
+
+using namespace acct_service;
+
+namespace {
+
+// 订单池容量有限，单轮迭代数不超过此值；预热另占少量槽位
+constexpr uint64_t kMaxCycleIterations = 100'000;
+constexpr int kWarmupCycles = 16;
+
+// 按 trades_shm 队列的紧凑编码写入一条回报。
+bool push_trade_response(trades_shm_layout& trades, const TradeResponse& response) {
+    trade_response_message message;
+    pack_trade_response_message(response, message);
+    return trades.response_queue.try_push(message);
+}
+
+void init_header(SHMHeader& header) {
+    header.magic = SHMHeader::kMagic;
+    header.version = SHMHeader::kVersion;
+    header.create_time = now_ns();
+    header.last_update = header.create_time;
+    header.next_id_epoch.store(1, std::memory_order_relaxed);
+}
+
+std::unique_ptr<orders_shm_layout> make_orders_shm() {
+    auto shm = std::make_unique<orders_shm_layout>();
+    shm->header.magic = OrdersHeader::kMagic;
+    shm->header.version = OrdersHeader::kVersion;
+    shm->header.header_size = static_cast<uint32_t>(sizeof(OrdersHeader));
+    shm->header.total_size = static_cast<uint32_t>(sizeof(orders_shm_layout));
+    shm->header.capacity = static_cast<uint32_t>(kDailyOrderPoolCapacity);
+    shm->header.init_state = 1;
+    shm->header.next_index.store(0, std::memory_order_relaxed);
+    std::memcpy(shm->header.trading_day, "19700101", 9);
+    return shm;
+}
+
+std::unique_ptr<positions_shm_layout> make_positions_shm() {
+    auto shm = std::make_unique<positions_shm_layout>();
+    shm->header.magic = PositionsHeader::kMagic;
+    shm->header.version = PositionsHeader::kVersion;
+    shm->header.header_size = static_cast<uint32_t>(sizeof(PositionsHeader));
+    shm->header.total_size = static_cast<uint32_t>(sizeof(positions_shm_layout));
+    shm->header.capacity = static_cast<uint32_t>(kMaxPositions);
+    shm->header.init_state = 0;
+    shm->header.id.store(1, std::memory_order_relaxed);
+    shm->position_count.store(0, std::memory_order_relaxed);
+    return shm;
+}
+
+// 单线程 run_once 驱动完整订单周期：新单 -> 风控 -> 下游，报单确认，全部成交 -> 终态归档。
+// 预热后计时区间内要求零堆分配
+void event_loop_order_cycle(bench::state& state) {
+    state.require_no_allocations();
+    auto upstream = std::make_unique<upstream_shm_layout>();
+    init_header(upstream->header);
+    upstream->upstream_order_queue.init();
+    auto downstream = std::make_unique<downstream_shm_layout>();
+    init_header(downstream->header);
+    downstream->order_queue.init();
+    auto trades = std::make_unique<trades_shm_layout>();
+    init_header(trades->header);
+    trades->response_queue.init();
+    auto orders_shm = make_orders_shm();
+    auto positions_shm = make_positions_shm();
+
+    PositionManager positions(positions_shm.get());
+    if (!positions.initialize(1)) {
+        return;
+    }
+    const InternalSecurityId security_id = positions.add_security("000001", "PingAn", Market::SZ);
+    // 每个周期买入 100 股 @ 1000，资金按最大迭代数备足，避免中途资金不足改走拒单路径
+    const DValue cycle_value = 100 * 1000;
+    if (!positions.add_fund(cycle_value * static_cast<DValue>(kMaxCycleIterations + kWarmupCycles), 0)) {
+        return;
+    }
+
+    RiskConfig risk_cfg;
+    risk_cfg.enable_position_check = false;
+    risk_cfg.enable_price_limit_check = false;
+    risk_cfg.enable_duplicate_check = false;
+    risk_cfg.max_order_volume = 0;
+    risk_cfg.max_order_value = 0;
+    risk_cfg.max_orders_per_second = 0;
+    RiskManager risk(positions, risk_cfg);
+
+    auto book = std::make_unique<OrderBook>();
+    order_router router(*book, downstream.get(), orders_shm.get(), upstream.get());
+
+    EventLoopConfig loop_cfg;
+    loop_cfg.poll_batch_size = 8;
+    loop_cfg.stats_interval_ms = 0;
+    loop_cfg.archive_terminal_orders = true;
+    loop_cfg.terminal_archive_delay_ms = 0;
+    EventLoop loop(loop_cfg, upstream.get(), downstream.get(), trades.get(), orders_shm.get(), *book, router, positions,
+                   risk, nullptr, nullptr, nullptr);
+    if (!loop.start()) {
+        return;
+    }
+
+    OrderRequest request;
+    request.init_new("000001", security_id, 0, TradeSide::Buy, Market::SZ, 100, 1000, 93000000);
+    TradeResponse response{};
+    response.internal_security_id = security_id;
+    response.trade_side = TradeSide::Buy;
+    response.md_time_traded = 93100000;
+
+    InternalOrderId next_id = 1;
+    const auto run_cycle = [&]() {
+        request.internal_order_id = next_id;
+        request.order_state.store(OrderState::UserSubmitted, std::memory_order_relaxed);
+        OrderIndex order_index = kInvalidOrderIndex;
+        (void)orders_shm_append(orders_shm.get(), request, OrderSlotState::UpstreamQueued, order_slot_source_t::User,
+                                now_ns(), order_index);
+        (void)upstream->upstream_order_queue.try_push(order_index);
+        (void)loop.run_once();
+        OrderIndex downstream_index = kInvalidOrderIndex;
+        (void)downstream->order_queue.try_pop(downstream_index);
+
+        response.internal_order_id = next_id;
+        response.new_state = OrderState::MarketAccepted;
+        response.volume_traded = 0;
+        response.dprice_traded = 0;
+        response.dvalue_traded = 0;
+        (void)push_trade_response(*trades, response);
+        (void)loop.run_once();
+
+        response.new_state = OrderState::Finished;
+        response.volume_traded = 100;
+        response.dprice_traded = 1000;
+        response.dvalue_traded = 100000;
+        (void)push_trade_response(*trades, response);
+        (void)loop.run_once();
+        (void)loop.run_once();
+        ++next_id;
+    };
+
+    for (int i = 0; i < kWarmupCycles; ++i) {
+        run_cycle();
+    }
+    while (state.keep_running()) {
+        run_cycle();
+    }
+    loop.finish();
+}
+ACCT_BENCH_REGISTER(event_loop_order_cycle, 0, kMaxCycleIterations);
+
+}  // namespace
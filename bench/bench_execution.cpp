@@ -0,0 +1,200 @@
+#include <unistd.h>
+
+#include <cstring>
+#include <memory>
+#include <string>
+
+#include "bench.hpp"
+#include "common/time_utils.hpp"
+#include "core/config_manager.hpp"
+#include "execution/execution_engine.hpp"
+#include "market_data/market_data_replay.hpp"
+#include "market_data/market_data_service.hpp"
+#include "order/order_book.hpp"
+#include "order/order_router.hpp"
+#include "shm/orders_shm.hpp"
+
+using namespace acct_service;
+
+namespace {
+
+constexpr TimestampNs kIntervalNs = 1'000'000;
+
+void init_header(SHMHeader& header) {
+    header.magic = SHMHeader::kMagic;
+    header.version = SHMHeader::kVersion;
+    header.create_time = now_ns();
+    header.last_update = header.create_time;
+    header.next_id_epoch.store(1, std::memory_order_relaxed);
+}
+
+std::unique_ptr<orders_shm_layout> make_orders_shm() {
+    auto shm = std::make_unique<orders_shm_layout>();
+    shm->header.magic = OrdersHeader::kMagic;
+    shm->header.version = OrdersHeader::kVersion;
+    shm->header.header_size = static_cast<uint32_t>(sizeof(OrdersHeader));
+    shm->header.total_size = static_cast<uint32_t>(sizeof(orders_shm_layout));
+    shm->header.capacity = static_cast<uint32_t>(kDailyOrderPoolCapacity);
+    shm->header.init_state = 1;
+    shm->header.next_index.store(0, std::memory_order_relaxed);
+    std::memcpy(shm->header.trading_day, "19700101", 9);
+    return shm;
+}
+
+// N 个 TWAP 会话的执行引擎夹具；默认行情不可用，按订单价回退定价，不依赖 snapshot 文件
+struct execution_fixture {
+    explicit execution_fixture(uint64_t session_count,
+                               const MarketDataConfig& market_data_config = make_market_data_config())
+        : upstream(std::make_unique<upstream_shm_layout>()),
+          downstream(std::make_unique<downstream_shm_layout>()),
+          orders_shm(make_orders_shm()),
+          book(std::make_unique<OrderBook>(order_book_threading::SingleThreaded)),
+          market_data(market_data_config),
+          router(*book, downstream.get(), orders_shm.get(), upstream.get()),
+          engine(make_split_config(), *book, router, &market_data, nullptr, nullptr) {
+        init_header(upstream->header);
+        upstream->upstream_order_queue.init();
+        init_header(downstream->header);
+        downstream->order_queue.init();
+        (void)market_data.initialize();
+
+        // 父单与路由器生成的子单订单号都按订单池槽位编码，不会撞号
+        for (uint64_t i = 0; i < session_count; ++i) {
+            OrderEntry entry{};
+            entry.request.init_new("000001", InternalSecurityId("XSHE_000001"), 0, TradeSide::Buy, Market::SZ,
+                                   100'000'000, 1000, 93000000);
+            entry.request.passive_execution_algo = PassiveExecutionAlgo::TWAP;
+            entry.request.order_state.store(OrderState::UserSubmitted, std::memory_order_relaxed);
+            entry.submit_time_ns = now;
+            entry.last_update_ns = now;
+            entry.strategy_id = static_cast<StrategyId>(1);
+            entry.risk_result = RiskResult::Pass;
+            OrderIndex index = kInvalidOrderIndex;
+            if (!orders_shm_append_assign_id(orders_shm.get(), entry.request, OrderSlotState::UpstreamQueued,
+                                             order_slot_source_t::User, now, index)) {
+                return;
+            }
+            entry.shm_order_index = index;
+            (void)book->add_order(entry);
+            (void)engine.start_session(index, entry.request, entry.strategy_id, now);
+        }
+    }
+
+    static MarketDataConfig make_market_data_config() {
+        MarketDataConfig config{};
+        config.enabled = false;
+        config.allow_order_price_fallback = true;
+        return config;
+    }
+
+    static split_config make_split_config() {
+        split_config config{};
+        config.strategy = SplitStrategy::None;
+        config.max_child_volume = 100;
+        config.min_child_volume = 1;
+        config.max_child_count = 1'000'000;
+        config.interval_ms = static_cast<uint32_t>(kIntervalNs / 1'000'000);
+        return config;
+    }
+
+    // 子单进入下游队列即视为已发出，清空以免队列写满
+    void drain_downstream() {
+        OrderIndex drained[256];
+        while (downstream->order_queue.try_pop_bulk(drained, 256) != 0) {
+        }
+    }
+
+    TimestampNs now = 93'000'000'000'000ULL;
+    std::unique_ptr<upstream_shm_layout> upstream;
+    std::unique_ptr<downstream_shm_layout> downstream;
+    std::unique_ptr<orders_shm_layout> orders_shm;
+    std::unique_ptr<OrderBook> book;
+    MarketDataService market_data;
+    order_router router;
+    ExecutionEngine engine;
+};
+
+// 时间不前进：没有到期定时器，衡量空转 tick 随会话数的开销
+void execution_engine_tick_idle(bench::state& state) {
+    execution_fixture fixture(state.arg());
+    fixture.engine.tick(fixture.now);
+    fixture.drain_downstream();
+    while (state.keep_running()) {
+        fixture.engine.tick(fixture.now);
+    }
+}
+ACCT_BENCH_REGISTER(execution_engine_tick_idle, 16, 0);
+ACCT_BENCH_REGISTER(execution_engine_tick_idle, 256, 0);
+
+// 每轮推进一个间隔，全部会话到期（子单不回报成交，会话按在途量节流）；子单占用订单池槽位，故限制单轮迭代数
+void execution_engine_tick_due(bench::state& state) {
+    execution_fixture fixture(state.arg());
+    while (state.keep_running()) {
+        fixture.now += kIntervalNs;
+        fixture.engine.tick(fixture.now);
+        fixture.drain_downstream();
+    }
+}
+ACCT_BENCH_REGISTER(execution_engine_tick_due, 16, 2000);
+ACCT_BENCH_REGISTER(execution_engine_tick_due, 256, 2000);
+
+// 单标的合成录制：每条记录间隔一个拆单周期，买一/卖一逐条抖动，供回放基准按历史节奏驱动行情
+bool write_synthetic_replay(const std::string& path, uint32_t record_count) {
+    MarketDataRecorder recorder;
+    if (!recorder.open(path, 19700101, {"XSHE_000001"})) {
+        return false;
+    }
+    for (uint32_t i = 0; i < record_count; ++i) {
+        MarketDataReplayRecord record{};
+        record.offset_ns = static_cast<uint64_t>(i) * kIntervalNs;
+        record.flags = snapshot_shm::kSnapshotSlotFlagHasSignal | snapshot_shm::kSnapshotSlotFlagSignalFresh;
+        record.prediction_state = static_cast<uint8_t>(snapshot_shm::SnapshotPredictionState::kFresh);
+        record.snapshot.time_of_day = 93'000'000 + i;
+        record.snapshot.total_bid_levels = 1;
+        record.snapshot.total_ask_levels = 1;
+        record.snapshot.bids[0] = snapshot_shm::SnapshotLevel{999 - i % 3, 10'000};
+        record.snapshot.asks[0] = snapshot_shm::SnapshotLevel{1000 + i % 3, 10'000};
+        if (!recorder.append(record)) {
+            return false;
+        }
+    }
+    return recorder.close();
+}
+
+// 回放行情驱动 tick：每轮先发布一条录制快照，再推进一个间隔让全部会话按盘口定价；对比 tick_due 即行情读取开销
+void execution_engine_tick_replay(bench::state& state) {
+    constexpr uint32_t kReplayRecords = 4096;
+    const std::string prefix = "/tmp/acct_bench_replay_" + std::to_string(static_cast<long long>(::getpid()));
+    const std::string replay_path = prefix + ".bin";
+    const std::string snapshot_path = prefix + ".snap";
+    if (!write_synthetic_replay(replay_path, kReplayRecords)) {
+        return;
+    }
+    MarketDataReplayFile file;
+    MarketDataReplayer replayer(file);
+    if (!file.open(replay_path) || !replayer.open_output(snapshot_path)) {
+        (void)::unlink(replay_path.c_str());
+        return;
+    }
+    (void)replayer.publish_next(1);
+
+    MarketDataConfig config{};
+    config.enabled = true;
+    config.snapshot_shm_name = snapshot_path;
+    execution_fixture fixture(state.arg(), config);
+    while (state.keep_running()) {
+        if (replayer.done()) {
+            replayer.rewind();
+        }
+        (void)replayer.publish_next(1);
+        fixture.now += kIntervalNs;
+        fixture.engine.tick(fixture.now);
+        fixture.drain_downstream();
+    }
+    replayer.close_output(true);
+    (void)::unlink(replay_path.c_str());
+}
+ACCT_BENCH_REGISTER(execution_engine_tick_replay, 16, 2000);
+ACCT_BENCH_REGISTER(execution_engine_tick_replay, 256, 2000);
+
+}  // namespace
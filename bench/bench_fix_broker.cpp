@@ -0,0 +1,179 @@
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <thread>
+
+#include "bench.hpp"
+#include "fix_broker_adapter.hpp"
+#include "fix_codec.hpp"
+
+using namespace acct_service;
+
+namespace {
+
+std::string make_fix_frame(std::string_view body) {
+    std::string text(body);
+    for (char& c : text) {
+        if (c == '|') {
+            c = gateway::fix::kSoh;
+        }
+    }
+    std::string frame = "8=FIX.4.4";
+    frame += gateway::fix::kSoh;
+    frame += "9=" + std::to_string(text.size());
+    frame += gateway::fix::kSoh;
+    frame += text;
+    char trailer[8];
+    std::snprintf(trailer, sizeof(trailer), "10=%03u", gateway::fix::fix_checksum(frame.data(), frame.size()));
+    frame += trailer;
+    frame += gateway::fix::kSoh;
+    return frame;
+}
+
+// 回环对端：应答 Logon 后丢弃全部入站字节，只用于给适配器提供一条真实 TCP 会话
+class fix_sink {
+public:
+    fix_sink() {
+        listen_fd_ = ::socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        (void)::bind(listen_fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+        (void)::listen(listen_fd_, 1);
+        socklen_t len = sizeof(addr);
+        (void)::getsockname(listen_fd_, reinterpret_cast<sockaddr*>(&addr), &len);
+        port_ = ntohs(addr.sin_port);
+        thread_ = std::thread([this]() {
+            const int fd = ::accept(listen_fd_, nullptr, nullptr);
+            if (fd < 0) {
+                return;
+            }
+            const std::string logon = make_fix_frame("35=A|49=BRK|56=ACCT|34=1|52=20260101-09:30:00.000|98=0|108=30|");
+            char chunk[1 << 16];
+            bool logged_on = false;
+            while (true) {
+                const ssize_t n = ::recv(fd, chunk, sizeof(chunk), 0);
+                if (n <= 0) {
+                    break;
+                }
+                if (!logged_on) {
+                    (void)::send(fd, logon.data(), logon.size(), MSG_NOSIGNAL);
+                    logged_on = true;
+                }
+            }
+            ::close(fd);
+        });
+    }
+
+    ~fix_sink() {
+        thread_.join();
+        ::close(listen_fd_);
+    }
+
+    uint16_t port() const noexcept { return port_; }
+
+private:
+    int listen_fd_ = -1;
+    uint16_t port_ = 0;
+    std::thread thread_;
+};
+
+broker_api::broker_order_request make_new_request(uint32_t internal_order_id) {
+    broker_api::broker_order_request request;
+    request.internal_order_id = internal_order_id;
+    request.type = broker_api::request_type::New;
+    request.trade_side = broker_api::side::Buy;
+    request.order_market = broker_api::market::SZ;
+    request.volume = 100;
+    request.price = 1000;
+    request.md_time = 93000000;
+    std::memcpy(request.security_id, "000001", 7);
+    std::memcpy(request.internal_security_id, "XSHE_000001", 12);
+    return request;
+}
+
+// 预渲染模板编码一笔新单（不含 socket）
+ACCT_BENCH(fix_render_new_order) {
+    gateway::fix::fix_template templ;
+    (void)templ.compile("FIX.4.4", "35=D|49=ACCT|56=BROKER|34=$seq|52=$time|1=FUND1|11=$clordid|21=1|55=$symbol|"
+                                   "207=$exchange|54=$side|38=$qty|40=2|44=$price|59=0|60=$time|");
+    char time_text[gateway::fix::kSendingTimeSize];
+    gateway::fix::format_sending_time(now_ns(), time_text);
+    gateway::fix::fix_slot_values values;
+    values.sending_time = time_text;
+    values.symbol = "000001";
+    values.exchange = "XSHE";
+    values.order_qty = 100;
+    values.price_cents = 1234;
+    char out[512];
+    uint32_t id = 0;
+    while (state.keep_running()) {
+        values.seq_num = ++id;
+        values.cl_ord_id = id;
+        bench::do_not_optimize(templ.render(out, sizeof(out), values));
+    }
+}
+
+// 解析一条成交执行回报并取出映射所需字段
+ACCT_BENCH(fix_parse_execution_report) {
+    const std::string frame = make_fix_frame(
+        "35=8|49=BROKER|56=ACCT|34=100|52=20260101-09:30:00.000|37=70001|17=E1|11=1001|150=F|39=2|55=000001|54=1|"
+        "38=100|32=100|31=10.00|14=100|151=0|12=0.50|");
+    gateway::fix::fix_message_view message;
+    while (state.keep_running()) {
+        std::size_t consumed = 0;
+        (void)gateway::fix::fix_parse(frame.data(), frame.size(), message, consumed);
+        uint64_t qty = 0;
+        uint64_t px = 0;
+        (void)message.get_uint(gateway::fix::tag::LastQty, qty);
+        (void)message.get_cents(gateway::fix::tag::LastPx, px);
+        bench::do_not_optimize(qty + px + consumed);
+    }
+}
+
+// 与 sim_broker_submit_poll/0 对照：一笔新单经真实 TCP 会话发出，受理 + 整单成交两条执行回报经 ingest 映射后由 poll 取走
+ACCT_BENCH(fix_adapter_submit_poll) {
+    fix_sink sink;
+    gateway::fix_session_config config;
+    config.port = sink.port();
+    config.sender_comp_id = "ACCT";
+    config.target_comp_id = "BRK";
+    config.logon_timeout_ms = 2000;
+    {
+        gateway::fix_broker_adapter adapter(config);
+        broker_api::broker_runtime_config runtime_config;
+        if (!adapter.initialize(runtime_config)) {
+            return;
+        }
+
+        // 回报按 ClOrdID 查表：每次迭代重写 11= 后重算校验和代价过高，这里按编号预先渲染一批轮转
+        constexpr uint32_t kReportSets = 4096;
+        std::string reports[kReportSets];
+        for (uint32_t i = 0; i < kReportSets; ++i) {
+            const std::string id = std::to_string(i + 1);
+            reports[i] = make_fix_frame("35=8|37=7" + id + "|11=" + id + "|150=0|39=0|") +
+                         make_fix_frame("35=8|37=7" + id + "|11=" + id + "|150=F|39=2|32=100|31=10.00|14=100|");
+        }
+
+        broker_api::broker_order_request request = make_new_request(1);
+        broker_api::broker_event events[64];
+        uint32_t next = 0;
+        while (state.keep_running()) {
+            request.internal_order_id = next + 1;
+            bench::do_not_optimize(adapter.submit(request));
+            const std::string& report = reports[next];
+            bench::do_not_optimize(adapter.ingest(report.data(), report.size()));
+            bench::do_not_optimize(adapter.poll_events(events, 64));
+            next = (next + 1) % kReportSets;
+        }
+        adapter.shutdown();
+    }
+}
+
+}  // namespace
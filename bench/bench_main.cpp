@@ -0,0 +1,146 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "bench.hpp"
+#include "common/alloc_guard.hpp"
+
+namespace acct_service::bench {
+
+namespace {
+
+// 用例未进入计时循环时耗时恒为 0，以此上限收住放大循环
+constexpr uint64_t kMaxIterations = 1'000'000'000;
+
+struct bench_case {
+    const char* name = nullptr;
+    bench_fn fn = nullptr;
+    uint64_t arg = 0;
+    uint64_t max_iterations = 0;
+};
+
+std::vector<bench_case>& registry() {
+    static std::vector<bench_case> cases;
+    return cases;
+}
+
+std::string display_name(const bench_case& entry) {
+    std::string name = entry.name;
+    if (entry.arg != 0) {
+        name += "/" + std::to_string(entry.arg);
+    }
+    return name;
+}
+
+void print_usage(const char* program_name) {
+    std::fprintf(stderr, "Usage: %s [--filter=SUBSTR] [--min-time-ms=N] [--list]\n", program_name);
+}
+
+}  // namespace
+
+void state::start() noexcept {
+    allocations_at_start_ = allocation_count();
+    started_ = true;
+    running_ = true;
+    started_at_ = std::chrono::steady_clock::now();
+}
+
+void state::stop() noexcept {
+    if (!running_) {
+        return;
+    }
+    elapsed_ = std::chrono::steady_clock::now() - started_at_;
+    allocations_ = allocation_count() - allocations_at_start_;
+    running_ = false;
+}
+
+bool register_bench(const char* name, bench_fn fn, uint64_t arg, uint64_t max_iterations) {
+    registry().push_back(bench_case{name, fn, arg, max_iterations});
+    return true;
+}
+
+uint64_t allocation_count() noexcept {
+#if ACCT_ALLOC_GUARD
+    return thread_allocation_count();
+#else
+    return 0;
+#endif
+}
+
+// 迭代数从 1 起按 10 倍放大，直到单轮耗时达到 min_time 或触及 max_iterations；报告最后一轮的均值
+int run_main(int argc, char** argv) {
+    std::string_view filter;
+    uint64_t min_time_ms = 200;
+    bool list_only = false;
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg(argv[i]);
+        if (arg.starts_with("--filter=")) {
+            filter = arg.substr(std::strlen("--filter="));
+        } else if (arg.starts_with("--min-time-ms=")) {
+            min_time_ms = std::strtoull(argv[i] + std::strlen("--min-time-ms="), nullptr, 10);
+        } else if (arg == "--list") {
+            list_only = true;
+        } else {
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+
+    std::vector<bench_case> cases = registry();
+    std::sort(cases.begin(), cases.end(), [](const bench_case& lhs, const bench_case& rhs) {
+        const int order = std::strcmp(lhs.name, rhs.name);
+        return order != 0 ? order < 0 : lhs.arg < rhs.arg;
+    });
+
+    if (!list_only) {
+        std::printf("%-48s %12s %12s %12s\n", "benchmark", "iterations", "ns/op", "allocs/op");
+    }
+    const auto min_time = std::chrono::milliseconds(min_time_ms);
+    bool failed = false;
+    for (const bench_case& entry : cases) {
+        const std::string name = display_name(entry);
+        if (!filter.empty() && name.find(filter) == std::string::npos) {
+            continue;
+        }
+        if (list_only) {
+            std::printf("%s\n", name.c_str());
+            continue;
+        }
+
+        uint64_t iterations = 1;
+        for (;;) {
+            state run(iterations, entry.arg);
+            entry.fn(run);
+            run.stop();
+            const bool last = run.elapsed() >= min_time || iterations >= kMaxIterations ||
+                              (entry.max_iterations != 0 && iterations >= entry.max_iterations);
+            if (last) {
+                const double ns_per_op =
+                    static_cast<double>(run.elapsed().count()) / static_cast<double>(iterations);
+                const double allocs_per_op =
+                    static_cast<double>(run.allocations()) / static_cast<double>(iterations);
+                std::printf("%-48s %12llu %12.1f %12.3f\n", name.c_str(),
+                            static_cast<unsigned long long>(iterations), ns_per_op, allocs_per_op);
+                if (run.no_allocations_required() && run.allocations() != 0) {
+                    std::fprintf(stderr, "%s: %llu heap allocations in a zero-allocation benchmark\n", name.c_str(),
+                                 static_cast<unsigned long long>(run.allocations()));
+                    failed = true;
+                }
+                break;
+            }
+            iterations *= 10;
+            if (entry.max_iterations != 0) {
+                iterations = std::min(iterations, entry.max_iterations);
+            }
+        }
+    }
+    return failed ? 1 : 0;
+}
+
+}  // namespace acct_service::bench
+
+int main(int argc, char** argv) { return acct_service::bench::run_main(argc, argv); }
@@ -0,0 +1,138 @@
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "bench.hpp"
+#include "common/time_utils.hpp"
+#include "order/order_book.hpp"
+
+using namespace acct_service;
+
+namespace {
+
+// 常驻订单数：find/update 在有一定规模的簿上测量
+constexpr InternalOrderId kResidentOrders = 10000;
+
+OrderEntry make_entry(InternalOrderId order_id) {
+    OrderEntry entry{};
+    entry.request.init_new("000001", InternalSecurityId("XSHE_000001"), order_id, TradeSide::Buy, Market::SZ, 1000000,
+                           1000, 93000000);
+    entry.request.order_state.store(OrderState::UserSubmitted, std::memory_order_relaxed);
+    entry.submit_time_ns = now_ns();
+    entry.last_update_ns = entry.submit_time_ns;
+    entry.strategy_id = static_cast<StrategyId>(1);
+    entry.risk_result = RiskResult::Pass;
+    entry.retry_count = 0;
+    entry.is_split_child = false;
+    entry.parent_order_id = 0;
+    return entry;
+}
+
+// 与主服务一致使用单线程簿（事件循环独占）
+std::unique_ptr<OrderBook> make_book_with_resident_orders() {
+    auto book = std::make_unique<OrderBook>(order_book_threading::SingleThreaded);
+    for (InternalOrderId id = 1; id <= kResidentOrders; ++id) {
+        (void)book->add_order(make_entry(id));
+    }
+    return book;
+}
+
+// 随机访问场景的常驻订单数与访问序列长度：簿规模远超缓存，逐笔访问基本都落在冷条目上
+constexpr InternalOrderId kColdResidentOrders = 262144;
+constexpr std::size_t kColdTouchSequence = 65536;
+constexpr std::size_t kColdPrefetchDistance = 8;
+
+std::unique_ptr<OrderBook> make_book_with_cold_orders() {
+    auto book = std::make_unique<OrderBook>(order_book_threading::SingleThreaded);
+    for (InternalOrderId id = 1; id <= kColdResidentOrders; ++id) {
+        (void)book->add_order(make_entry(id));
+    }
+    return book;
+}
+
+std::vector<InternalOrderId> make_cold_sequence() {
+    std::vector<InternalOrderId> ids(kColdTouchSequence);
+    uint64_t x = 0x9E3779B97F4A7C15ULL;
+    for (InternalOrderId& id : ids) {
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+        id = 1 + x % kColdResidentOrders;
+    }
+    return ids;
+}
+
+// 模拟回报排空：每次迭代随机写一笔订单条目，可选对 k 项后的订单提前预取
+void touch_cold_orders(bench::state& state, bool prefetch) {
+    auto book = make_book_with_cold_orders();
+    const std::vector<InternalOrderId> ids = make_cold_sequence();
+    std::size_t cursor = 0;
+    while (state.keep_running()) {
+        if (prefetch) {
+            book->prefetch_order(ids[(cursor + kColdPrefetchDistance) % kColdTouchSequence]);
+        }
+        OrderEntry* entry = book->find_order(ids[cursor]);
+        entry->last_update_ns += 1;
+        bench::do_not_optimize(entry);
+        cursor = (cursor + 1) % kColdTouchSequence;
+    }
+}
+
+// 新单入簿后立即归档：槽位与索引在循环内复用
+ACCT_BENCH(order_book_add_archive) {
+    auto book = make_book_with_resident_orders();
+    OrderEntry entry = make_entry(0);
+    InternalOrderId next_id = kResidentOrders + 1;
+    while (state.keep_running()) {
+        entry.request.internal_order_id = next_id;
+        (void)book->add_order(entry);
+        (void)book->archive_order(next_id);
+        ++next_id;
+    }
+}
+
+ACCT_BENCH(order_book_find_order) {
+    auto book = make_book_with_resident_orders();
+    InternalOrderId id = 1;
+    while (state.keep_running()) {
+        bench::do_not_optimize(book->find_order(id));
+        id = id == kResidentOrders ? 1 : id + 1;
+    }
+}
+
+// 每次 1 股成交；常驻单委托量足够大，不会在测量中走到终态
+ACCT_BENCH(order_book_update_trade) {
+    auto book = make_book_with_resident_orders();
+    InternalOrderId id = 1;
+    while (state.keep_running()) {
+        (void)book->update_trade(id, 1, 1000, 1000, 1);
+        id = id == kResidentOrders ? 1 : id + 1;
+    }
+}
+
+ACCT_BENCH(order_book_random_touch) { touch_cold_orders(state, false); }
+
+ACCT_BENCH(order_book_random_touch_prefetched) { touch_cold_orders(state, true); }
+
+// 全簿活跃订单扫描：对照拷贝 ID 列表再逐个查找与直接走位图访问者
+ACCT_BENCH(order_book_active_scan_ids) {
+    auto book = make_book_with_resident_orders();
+    while (state.keep_running()) {
+        Volume total = 0;
+        for (const InternalOrderId id : book->get_active_order_ids()) {
+            total += book->find_order(id)->request.volume_remain;
+        }
+        bench::do_not_optimize(total);
+    }
+}
+
+ACCT_BENCH(order_book_active_scan_visitor) {
+    auto book = make_book_with_resident_orders();
+    while (state.keep_running()) {
+        Volume total = 0;
+        book->for_each_active([&total](const OrderEntry& entry) { total += entry.request.volume_remain; });
+        bench::do_not_optimize(total);
+    }
+}
+
+}  // namespace
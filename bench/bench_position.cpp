@@ -0,0 +1,148 @@
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "bench.hpp"
+#include "portfolio/position_manager.hpp"
+
+using namespace acct_service;
+
+namespace {
+
+std::unique_ptr<positions_shm_layout> make_positions_shm() {
+    auto shm = std::make_unique<positions_shm_layout>();
+    shm->header.magic = PositionsHeader::kMagic;
+    shm->header.version = PositionsHeader::kVersion;
+    shm->header.header_size = static_cast<uint32_t>(sizeof(PositionsHeader));
+    shm->header.total_size = static_cast<uint32_t>(sizeof(positions_shm_layout));
+    shm->header.capacity = static_cast<uint32_t>(kMaxPositions);
+    shm->header.init_state = 0;
+    shm->header.id.store(1, std::memory_order_relaxed);
+    shm->position_count.store(0, std::memory_order_relaxed);
+    return shm;
+}
+
+// 买单资金生命周期：冻结 -> 成交结算（扣冻结、计费）-> 卖出回款，资金总额在循环内保持稳定
+ACCT_BENCH(position_manager_fund_freeze_settle) {
+    auto shm = make_positions_shm();
+    PositionManager positions(shm.get());
+    if (!positions.initialize(1)) {
+        return;
+    }
+    uint64_t i = 0;
+    while (state.keep_running()) {
+        ++i;
+        const InternalOrderId order_id = static_cast<InternalOrderId>(i);
+        (void)positions.freeze_fund(100000, order_id);
+        (void)positions.apply_buy_trade_fund(100000, 5, order_id);
+        (void)positions.apply_sell_trade_fund(100000, 5, order_id);
+    }
+}
+
+// 卖单持仓生命周期（句柄路径）：买入入账 -> 冻结 -> 成交扣减
+ACCT_BENCH(position_manager_position_freeze_settle) {
+    auto shm = make_positions_shm();
+    PositionManager positions(shm.get());
+    if (!positions.initialize(1)) {
+        return;
+    }
+    const SecurityHandle handle =
+        positions.resolve_security_handle(positions.add_security("000001", "PingAn", Market::SZ));
+    {
+        position* row = positions.get_position_mut(handle);
+        position_lock guard(*row);
+        row->volume_available_t0 = 1'000'000;
+    }
+    uint64_t i = 0;
+    while (state.keep_running()) {
+        ++i;
+        const InternalOrderId order_id = static_cast<InternalOrderId>(i);
+        (void)positions.freeze_position(handle, 100, order_id);
+        (void)positions.deduct_position(handle, 100, 100000, order_id);
+        {
+            position* row = positions.get_position_mut(handle);
+            position_lock guard(*row);
+            row->volume_available_t0 += 100;
+        }
+    }
+}
+
+// 句柄解析：启动期装载的证券命中完美哈希表，运行期新增证券走归一化 + 查表
+constexpr std::size_t kResolveSecurities = 4000;
+
+void resolve_security_handles(bench::state& state, bool startup_loaded) {
+    auto shm = make_positions_shm();
+    std::vector<InternalSecurityId> ids;
+    for (std::size_t i = 0; i < kResolveSecurities; ++i) {
+        char code[8];
+        std::snprintf(code, sizeof(code), "%06zu", i * 7);
+        ids.emplace_back(std::string("XSHE_") + code);
+    }
+    if (startup_loaded) {
+        shm->header.init_state = 1;
+        shm->position_count.store(kResolveSecurities, std::memory_order_relaxed);
+        for (std::size_t i = 0; i < kResolveSecurities; ++i) {
+            shm->positions[kFirstSecurityPositionIndex + i].id = ids[i];
+        }
+    }
+    PositionManager positions(shm.get());
+    if (!positions.initialize(1)) {
+        return;
+    }
+    if (!startup_loaded) {
+        for (const InternalSecurityId& id : ids) {
+            (void)positions.add_security(id.view().substr(5), id.view(), Market::SZ);
+        }
+    }
+    std::size_t cursor = 0;
+    while (state.keep_running()) {
+        bench::do_not_optimize(positions.resolve_security_handle(ids[cursor]));
+        cursor = cursor + 1 == kResolveSecurities ? 0 : cursor + 1;
+    }
+}
+
+ACCT_BENCH(position_manager_resolve_interned) { resolve_security_handles(state, true); }
+
+ACCT_BENCH(position_manager_resolve_slow_path) { resolve_security_handles(state, false); }
+
+// 证券键哈希表查找：FixedString 逐字哈希/比较 对照 按 string_view 的 strlen + 字节哈希与 strcmp
+struct legacy_key_hash {
+    std::size_t operator()(const InternalSecurityId& key) const noexcept {
+        return std::hash<std::string_view>{}(key.view());
+    }
+};
+
+struct legacy_key_equal {
+    bool operator()(const InternalSecurityId& lhs, const InternalSecurityId& rhs) const noexcept {
+        return std::strcmp(lhs.data, rhs.data) == 0;
+    }
+};
+
+template <typename Map>
+void find_security_keys(bench::state& state) {
+    Map map;
+    std::vector<InternalSecurityId> ids;
+    for (std::size_t i = 0; i < kResolveSecurities; ++i) {
+        char code[8];
+        std::snprintf(code, sizeof(code), "%06zu", i * 7);
+        ids.emplace_back(std::string("XSHE_") + code);
+        map.emplace(ids.back(), i);
+    }
+    std::size_t cursor = 0;
+    while (state.keep_running()) {
+        bench::do_not_optimize(map.find(ids[cursor]));
+        cursor = cursor + 1 == kResolveSecurities ? 0 : cursor + 1;
+    }
+}
+
+ACCT_BENCH(fixed_string_map_find) { find_security_keys<std::unordered_map<InternalSecurityId, std::size_t>>(state); }
+
+ACCT_BENCH(fixed_string_map_find_legacy_hash) {
+    find_security_keys<std::unordered_map<InternalSecurityId, std::size_t, legacy_key_hash, legacy_key_equal>>(state);
+}
+
+}  // namespace
@@ -0,0 +1,60 @@
+#include <memory>
+
+#include "bench.hpp"
+#include "portfolio/position_manager.hpp"
+#include "risk/risk_manager.hpp"
+
+using namespace acct_service;
+
+namespace {
+
+std::unique_ptr<positions_shm_layout> make_positions_shm() {
+    auto shm = std::make_unique<positions_shm_layout>();
+    shm->header.magic = PositionsHeader::kMagic;
+    shm->header.version = PositionsHeader::kVersion;
+    shm->header.header_size = static_cast<uint32_t>(sizeof(PositionsHeader));
+    shm->header.total_size = static_cast<uint32_t>(sizeof(positions_shm_layout));
+    shm->header.capacity = static_cast<uint32_t>(kMaxPositions);
+    shm->header.init_state = 0;
+    shm->header.id.store(1, std::memory_order_relaxed);
+    shm->position_count.store(0, std::memory_order_relaxed);
+    return shm;
+}
+
+// 全部规则开启且都能通过：限额与速率放到足够大，价格落在涨跌停内，每单订单号不同以避开重复单拒绝
+ACCT_BENCH(risk_manager_check_order_all_rules) {
+    auto shm = make_positions_shm();
+    PositionManager positions(shm.get());
+    if (!positions.initialize(1)) {
+        return;
+    }
+    const InternalSecurityId security_id = positions.add_security("000001", "PingAn", Market::SZ);
+
+    RiskConfig config;
+    config.max_order_value = 1'000'000'000;
+    config.max_order_volume = 1'000'000;
+    config.max_daily_turnover = 0;
+    config.max_orders_per_second = 1'000'000'000;
+    config.max_orders_per_second_per_strategy = 1'000'000'000;
+    config.max_orders_per_second_per_security = 1'000'000'000;
+    config.enable_price_limit_check = true;
+    config.enable_duplicate_check = true;
+    config.enable_fund_check = true;
+    config.enable_position_check = true;
+    config.duplicate_window_ns = 1;  // 仍走重复单查表，但窗口极短不会误判循环内的订单
+    RiskManager manager(positions, config);
+    (void)manager.update_price_limits(security_id, 1500, 800);
+
+    OrderRequest request;
+    request.init_new("000001", security_id, 1, TradeSide::Buy, Market::SZ, 100, 1000, 93000000);
+    request.order_state.store(OrderState::UserSubmitted, std::memory_order_relaxed);
+    uint64_t i = 0;
+    while (state.keep_running()) {
+        ++i;
+        request.internal_order_id = static_cast<InternalOrderId>(i);
+        request.volume_entrust = 100 + (i & 0xFF);
+        bench::do_not_optimize(manager.check_order(request, 1));
+    }
+}
+
+}  // namespace
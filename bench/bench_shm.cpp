@@ -0,0 +1,129 @@
+#include <cstring>
+#include <memory>
+
+#include "bench.hpp"
+#include "common/time_utils.hpp"
+#include "shm/orders_shm.hpp"
+#include "shm/spsc_queue.hpp"
+
+using namespace acct_service;
+
+namespace {
+
+using bench_queue = spsc_queue<OrderIndex, 4096>;
+using bench_byte_ring = spsc_byte_ring<65536>;
+
+// 订单池夹具：与测试一致，只填头部，槽位由 orders_shm_append 分配
+std::unique_ptr<orders_shm_layout> make_orders_shm() {
+    auto shm = std::make_unique<orders_shm_layout>();
+    shm->header.magic = OrdersHeader::kMagic;
+    shm->header.version = OrdersHeader::kVersion;
+    shm->header.header_size = static_cast<uint32_t>(sizeof(OrdersHeader));
+    shm->header.total_size = static_cast<uint32_t>(sizeof(orders_shm_layout));
+    shm->header.capacity = static_cast<uint32_t>(kDailyOrderPoolCapacity);
+    shm->header.init_state = 1;
+    shm->header.next_index.store(0, std::memory_order_relaxed);
+    return shm;
+}
+
+// 单线程交替 push/pop：不含跨核缓存行往返，衡量队列本身的指令开销
+ACCT_BENCH(spsc_queue_push_pop) {
+    auto queue = std::make_unique<bench_queue>();
+    queue->init();
+    OrderIndex value = 0;
+    uint64_t i = 0;
+    while (state.keep_running()) {
+        ++i;
+        (void)queue->try_push(static_cast<OrderIndex>(i));
+        (void)queue->try_pop(value);
+        bench::do_not_optimize(value);
+    }
+}
+
+// 每批 64 个：批量接口把索引发布摊到整批
+ACCT_BENCH(spsc_queue_bulk_64) {
+    auto queue = std::make_unique<bench_queue>();
+    queue->init();
+    OrderIndex items[64];
+    for (OrderIndex i = 0; i < 64; ++i) {
+        items[i] = i;
+    }
+    OrderIndex out[64];
+    while (state.keep_running()) {
+        (void)queue->try_push_bulk(items, 64);
+        bench::do_not_optimize(queue->try_pop_bulk(out, 64));
+    }
+}
+
+// 变长字节环：单条 64 字节记录原地申请 + 提交，再单批读出
+ACCT_BENCH(spsc_byte_ring_claim_read_64) {
+    auto ring = std::make_unique<bench_byte_ring>();
+    ring->init();
+    uint64_t sum = 0;
+    uint64_t i = 0;
+    while (state.keep_running()) {
+        ++i;
+        void* slot = ring->try_claim(1, 64);
+        if (slot != nullptr) {
+            std::memcpy(slot, &i, sizeof(i));
+        }
+        ring->commit();
+        (void)ring->read_batch([&sum](const spsc_byte_record_view& view) { sum += view.size; });
+        bench::do_not_optimize(sum);
+    }
+}
+
+// 每批 32 条 16..256 字节变长记录：一次 commit 发布、一次 read_batch 归还
+ACCT_BENCH(spsc_byte_ring_batch_32) {
+    auto ring = std::make_unique<bench_byte_ring>();
+    ring->init();
+    uint64_t sum = 0;
+    uint64_t i = 0;
+    while (state.keep_running()) {
+        for (uint32_t k = 0; k < 32; ++k) {
+            ++i;
+            void* slot = ring->try_claim(k, 16 + (i * 61U) % 241U);
+            if (slot != nullptr) {
+                std::memcpy(slot, &i, sizeof(i));
+            }
+        }
+        ring->commit();
+        bench::do_not_optimize(ring->read_batch([&sum](const spsc_byte_record_view& view) { sum += view.size; }));
+        bench::do_not_optimize(sum);
+    }
+}
+
+// 一次 seqlock 写区间 + 变更日志追加
+ACCT_BENCH(orders_shm_mutate_slot) {
+    auto shm = make_orders_shm();
+    OrderRequest request;
+    request.init_new("000001", InternalSecurityId("XSHE_000001"), 1, TradeSide::Buy, Market::SZ, 100, 1000, 93000000);
+    OrderIndex index = kInvalidOrderIndex;
+    if (!orders_shm_append(shm.get(), request, OrderSlotState::UpstreamQueued, order_slot_source_t::User, now_ns(),
+                           index)) {
+        return;
+    }
+    uint64_t i = 0;
+    while (state.keep_running()) {
+        ++i;
+        (void)orders_shm_mutate_slot(shm.get(), index, static_cast<TimestampNs>(i),
+                                     [i](OrderSlot& slot) { slot.request.volume_traded = static_cast<Volume>(i); });
+    }
+}
+
+// vDSO clock_gettime(CLOCK_REALTIME)，热路径逐次取时的基线
+ACCT_BENCH(clock_gettime_realtime) {
+    while (state.keep_running()) {
+        bench::do_not_optimize(now_ns());
+    }
+}
+
+// 校准后的 TSC 换算，每秒一次 clock_gettime 重新锚定
+ACCT_BENCH(tsc_clock_now_realtime) {
+    (void)tsc_clock::calibrate();
+    while (state.keep_running()) {
+        bench::do_not_optimize(tsc_clock::now_realtime_ns());
+    }
+}
+
+}  // namespace
@@ -0,0 +1,47 @@
+#include <cstring>
+
+#include "bench.hpp"
+#include "sim_broker_adapter.hpp"
+
+using namespace acct_service;
+
+namespace {
+
+broker_api::broker_order_request make_new_request(uint32_t internal_order_id) {
+    broker_api::broker_order_request request;
+    request.internal_order_id = internal_order_id;
+    request.type = broker_api::request_type::New;
+    request.trade_side = broker_api::side::Buy;
+    request.order_market = broker_api::market::SZ;
+    request.volume = 100;
+    request.price = 1000;
+    request.md_time = 93000000;
+    std::memcpy(request.security_id, "000001", 7);
+    std::memcpy(request.internal_security_id, "XSHE_000001", 12);
+    return request;
+}
+
+// 每次迭代提交一笔新单并取走回报；arg 为单片成交延迟（微秒），0 表示受理即成交
+void sim_broker_submit_poll(bench::state& state) {
+    gateway::sim_fill_model model;
+    model.fill_latency_us = static_cast<uint32_t>(state.arg());
+    model.partial_fill_pct = state.arg() == 0 ? 0 : 20;
+    gateway::sim_broker_adapter adapter(model);
+    broker_api::broker_runtime_config runtime_config;
+    runtime_config.auto_fill = true;
+    (void)adapter.initialize(runtime_config);
+
+    broker_api::broker_order_request request = make_new_request(1);
+    broker_api::broker_event events[64];
+    uint32_t next_id = 1;
+    while (state.keep_running()) {
+        request.internal_order_id = next_id++;
+        bench::do_not_optimize(adapter.submit(request));
+        bench::do_not_optimize(adapter.poll_events(events, 64));
+    }
+    adapter.shutdown();
+}
+ACCT_BENCH_REGISTER(sim_broker_submit_poll, 0, 0);
+ACCT_BENCH_REGISTER(sim_broker_submit_poll, 50, 0);
+
+}  // namespace
@@ -0,0 +1,54 @@
+#include <atomic>
+
+#include "bench.hpp"
+#include "common/spinlock.hpp"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <emmintrin.h>
+#endif
+
+using namespace acct_service;
+
+namespace {
+
+// 对照组：改为进程号锁字之前的布尔标志 TTAS 锁，只保留快速路径与退避，用于比较无竞争开销
+class alignas(64) flag_spinlock {
+public:
+    void lock() noexcept {
+        bool expected = false;
+        while (!flag_.compare_exchange_weak(expected, true, std::memory_order_acquire, std::memory_order_relaxed)) {
+            expected = false;
+            while (flag_.load(std::memory_order_relaxed)) {
+#if defined(__x86_64__) || defined(__i386__)
+                _mm_pause();
+#endif
+            }
+        }
+    }
+    void unlock() noexcept { flag_.store(false, std::memory_order_release); }
+
+private:
+    std::atomic<bool> flag_{false};
+};
+
+template <typename Lock>
+void run_uncontended(bench::state& state) {
+    Lock lock;
+    uint64_t counter = 0;
+    state.require_no_allocations();
+    while (state.keep_running()) {
+        lock.lock();
+        ++counter;
+        bench::do_not_optimize(counter);
+        lock.unlock();
+    }
+}
+
+}  // namespace
+
+// 无竞争加解锁：单线程反复进出临界区
+ACCT_BENCH(spinlock_flag_baseline_uncontended) { run_uncontended<flag_spinlock>(state); }
+
+ACCT_BENCH(spinlock_uncontended) { run_uncontended<SpinLock>(state); }
+
+ACCT_BENCH(ticket_spinlock_uncontended) { run_uncontended<TicketSpinLock>(state); }
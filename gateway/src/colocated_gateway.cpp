@@ -0,0 +1,54 @@
+#include "colocated_gateway.hpp"
+
+namespace acct_service::gateway {
+
+colocated_gateway::~colocated_gateway() { stop(); }
+
+bool colocated_gateway::initialize(const std::string& config_path, const gateway_account_lane& lane,
+                                   std::string& error_message, stats_shm_layout* stats_shm) {
+    stop();
+    loop_.reset();
+    if (!load_gateway_config(config_path, config_, error_message)) {
+        return false;
+    }
+    config_.account_id = lane.account_id;
+    config_.accounts.clear();
+    if (!adapters_.create(config_, error_message) || !adapters_.initialize(lane.account_id, error_message)) {
+        return false;
+    }
+    loop_ = std::make_unique<gateway_loop>(config_, std::vector<gateway_account_lane>{lane}, adapters_.adapters());
+    loop_->attach_stats(stats_shm);
+    return true;
+}
+
+bool colocated_gateway::start(bool inline_poll) {
+    if (!loop_ || started_ || adapters_.adapters().empty()) {
+        return false;
+    }
+    // 两种模式都在调用线程上 start，启动失败直接返回，兄弟线程也不会错过随后的 stop()
+    if (!loop_->start()) {
+        return false;
+    }
+    if (!inline_poll) {
+        thread_ = std::thread([this]() { (void)loop_->run(); });
+    }
+    started_ = true;
+    return true;
+}
+
+void colocated_gateway::stop() noexcept {
+    if (loop_) {
+        loop_->stop();
+    }
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+    if (loop_ && started_) {
+        loop_->finish();
+    }
+    started_ = false;
+    // 保留 loop_ 供停机后读取统计；适配器会话随即关闭，需重新 initialize 才能再次启动
+    adapters_.shutdown();
+}
+
+}  // namespace acct_service::gateway
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include "gateway_adapters.hpp"
+#include "gateway_config.hpp"
+#include "gateway_loop.hpp"
+
+namespace acct_service::gateway {
+
+// 进程内网关阶段：在账户服务进程里按网关配置加载适配器（sim 或插件），直接消费本进程已映射的
+// 下游队列、回报队列与订单池，订单不再跨进程搬运，订单池仍对外部监控可见。
+// 网关配置中的 account_id / shm 名 / accounts 被忽略，一律以宿主账户为准。
+class colocated_gateway {
+public:
+    colocated_gateway() = default;
+    ~colocated_gateway();
+
+    colocated_gateway(const colocated_gateway&) = delete;
+    colocated_gateway& operator=(const colocated_gateway&) = delete;
+
+    // 加载网关配置并初始化适配器会话；失败时 error_message 给出原因。
+    // stats_shm 非空时把柜台往返延迟与 gateway.* 指标写进宿主统计段（网关配置的 stats_shm 被忽略）
+    bool initialize(const std::string& config_path, const gateway_account_lane& lane, std::string& error_message,
+                    stats_shm_layout* stats_shm = nullptr);
+
+    // inline_poll=false 时在兄弟线程上运行 gateway_loop::run（按网关配置空闲退避与绑核）；
+    // inline_poll=true 时只进入运行态，由宿主事件循环每轮调用 poll_once。
+    bool start(bool inline_poll);
+    // 内联模式下执行一轮网关（重试 -> 新单 -> 回报），返回本轮是否有工作。
+    std::size_t poll_once() { return loop_->run_once() ? 1 : 0; }
+    // 停止网关并回收线程与适配器会话，可重复调用；之后仍可读取 stats()。
+    void stop() noexcept;
+
+    const gateway_config& config() const noexcept { return config_; }
+    bool initialized() const noexcept { return loop_ != nullptr; }
+    const gateway_stats& stats() const noexcept { return loop_->stats(); }
+
+private:
+    gateway_config config_{};
+    gateway_adapter_set adapters_{};
+    std::unique_ptr<gateway_loop> loop_{};
+    std::thread thread_{};
+    bool started_ = false;
+};
+
+}  // namespace acct_service::gateway
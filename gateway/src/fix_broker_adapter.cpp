@@ -0,0 +1,836 @@
+#include "fix_broker_adapter.hpp"
+
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <string_view>
+
+#include "common/time_utils.hpp"
+
+namespace acct_service::gateway {
+
+namespace {
+
+// 与 sim 适配器同一编号段：-100 未初始化、-101 非法订单号、-102 新单字段非法、-103 撤单缺原单号、-104 未知请求类型
+constexpr int32_t kFixNotInitializedError = -100;
+constexpr int32_t kFixInvalidOrderIdError = -101;
+constexpr int32_t kFixInvalidNewError = -102;
+constexpr int32_t kFixMissingOrigError = -103;
+constexpr int32_t kFixUnknownTypeError = -104;
+// FIX 特有：会话未登录、发送缓冲已满、订单跟踪表已满（均可重试）
+constexpr int32_t kFixSessionDownError = -201;
+constexpr int32_t kFixSendBufferFullError = -202;
+constexpr int32_t kFixOrderTableFullError = -203;
+// 每条入站消息至多映射出的回报条数（撤单完成 = 撤单受理 + 原单完成）
+constexpr std::size_t kMaxEventsPerMessage = 2;
+// 回报队列按每笔在途订单平均 4 条回报预分配
+constexpr std::size_t kEventsPerActiveOrder = 4;
+
+std::size_t round_up_pow2(std::size_t value) noexcept {
+    std::size_t result = 1;
+    while (result < value) {
+        result <<= 1;
+    }
+    return result;
+}
+
+std::string_view bounded_view(const char* text, std::size_t capacity) noexcept {
+    std::size_t size = 0;
+    while (size < capacity && text[size] != '\0') {
+        ++size;
+    }
+    return std::string_view(text, size);
+}
+
+std::string_view exchange_code(broker_api::market market) noexcept {
+    switch (market) {
+        case broker_api::market::SZ:
+            return "XSHE";
+        case broker_api::market::SH:
+            return "XSHG";
+        case broker_api::market::BJ:
+            return "XBSE";
+        case broker_api::market::HK:
+            return "XHKG";
+        default:
+            return "";
+    }
+}
+
+char side_code(broker_api::side side) noexcept { return side == broker_api::side::Sell ? '2' : '1'; }
+
+// OrderID 为纯数字且不超过 32 位时直接使用，否则取 FNV-1a 哈希作为 broker_order_id
+uint32_t broker_order_id_of(std::string_view order_id) noexcept {
+    uint64_t value = 0;
+    bool numeric = !order_id.empty() && order_id.size() <= 10;
+    for (const char c : order_id) {
+        if (c < '0' || c > '9') {
+            numeric = false;
+            break;
+        }
+        value = value * 10 + static_cast<uint64_t>(c - '0');
+    }
+    if (numeric && value <= UINT32_MAX) {
+        return static_cast<uint32_t>(value);
+    }
+    uint32_t hash = 2166136261U;
+    for (const char c : order_id) {
+        hash = (hash ^ static_cast<unsigned char>(c)) * 16777619U;
+    }
+    return hash;
+}
+
+// 会话字段会拼进模板字面量，不能含分隔符与占位符前缀
+bool session_field_valid(const std::string& value) noexcept {
+    return !value.empty() && value.find_first_of("|$=\x01") == std::string::npos;
+}
+
+template <typename T>
+void read_env_uint(const char* name, T& out) {
+    const char* value = std::getenv(name);
+    if (value == nullptr || value[0] == '\0') {
+        return;
+    }
+    char* end = nullptr;
+    const unsigned long long parsed = std::strtoull(value, &end, 10);
+    if (end != value && *end == '\0') {
+        out = static_cast<T>(parsed);
+    }
+}
+
+void read_env_string(const char* name, std::string& out) {
+    const char* value = std::getenv(name);
+    if (value != nullptr && value[0] != '\0') {
+        out = value;
+    }
+}
+
+}  // namespace
+
+fix_session_config fix_session_config_from_env() {
+    fix_session_config config;
+    read_env_string("ACCT_FIX_HOST", config.host);
+    read_env_uint("ACCT_FIX_PORT", config.port);
+    read_env_string("ACCT_FIX_BEGIN_STRING", config.begin_string);
+    read_env_string("ACCT_FIX_SENDER_COMP_ID", config.sender_comp_id);
+    read_env_string("ACCT_FIX_TARGET_COMP_ID", config.target_comp_id);
+    read_env_string("ACCT_FIX_ACCOUNT", config.account);
+    read_env_uint("ACCT_FIX_HEARTBEAT_S", config.heartbeat_interval_s);
+    read_env_uint("ACCT_FIX_LOGON_TIMEOUT_MS", config.logon_timeout_ms);
+    read_env_uint("ACCT_FIX_MAX_ACTIVE_ORDERS", config.max_active_orders);
+    return config;
+}
+
+fix_broker_adapter::fix_broker_adapter(const fix_session_config& config)
+    : config_(config),
+      send_buffer_(new char[std::max<std::size_t>(config.send_buffer_bytes, 4096)]),
+      recv_buffer_(new char[std::max<std::size_t>(config.recv_buffer_bytes, 4096)]),
+      orders_(static_cast<std::size_t>(std::max<uint32_t>(config.max_active_orders, 1)) * 2),
+      events_(round_up_pow2(static_cast<std::size_t>(std::max<uint32_t>(config.max_active_orders, 1)) *
+                            kEventsPerActiveOrder)) {
+    config_.max_active_orders = std::max<uint32_t>(config_.max_active_orders, 1);
+    config_.send_buffer_bytes = std::max<std::size_t>(config_.send_buffer_bytes, 4096);
+    config_.recv_buffer_bytes = std::max<std::size_t>(config_.recv_buffer_bytes, 4096);
+    config_.heartbeat_interval_s = std::max<uint32_t>(config_.heartbeat_interval_s, 1);
+}
+
+fix_broker_adapter::~fix_broker_adapter() { shutdown(); }
+
+// 编译模板、建立 TCP 连接并完成 Logon；任一步失败返回 false，网关启动随之失败。
+bool fix_broker_adapter::initialize(const broker_api::broker_runtime_config& config) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    close_session();
+    runtime_config_ = config;
+    initialized_ = false;
+    next_seq_num_ = 1;
+    sending_time_ms_ = 0;
+    send_head_ = 0;
+    send_tail_ = 0;
+    recv_size_ = 0;
+    orders_.clear();
+    event_head_ = 0;
+    event_tail_ = 0;
+
+    if (!session_field_valid(config_.sender_comp_id) || !session_field_valid(config_.target_comp_id) ||
+        (!config_.account.empty() && !session_field_valid(config_.account))) {
+        return false;
+    }
+
+    // 会话头与静态字段在这里一次拼好，热路径只填占位符
+    const std::string header = "|49=" + config_.sender_comp_id + "|56=" + config_.target_comp_id + "|34=$seq|52=$time|";
+    const std::string account = config_.account.empty() ? std::string() : "1=" + config_.account + "|";
+    const std::string& begin = config_.begin_string;
+    const bool compiled =
+        logon_template_.compile(begin, "35=A" + header + "98=0|108=" + std::to_string(config_.heartbeat_interval_s) +
+                                           "|141=Y|") &&
+        logout_template_.compile(begin, "35=5" + header) && heartbeat_template_.compile(begin, "35=0" + header) &&
+        test_heartbeat_template_.compile(begin, "35=0" + header + "112=$testreqid|") &&
+        new_template_.compile(begin, "35=D" + header + account +
+                                         "11=$clordid|21=1|55=$symbol|207=$exchange|54=$side|38=$qty|40=2|44=$price|"
+                                         "59=0|60=$time|") &&
+        cancel_template_.compile(begin, "35=F" + header +
+                                            "41=$origclordid|11=$clordid|55=$symbol|207=$exchange|54=$side|38=$qty|"
+                                            "60=$time|") &&
+        replace_template_.compile(begin, "35=G" + header + account +
+                                             "41=$origclordid|11=$clordid|21=1|55=$symbol|207=$exchange|54=$side|"
+                                             "38=$qty|40=2|44=$price|59=0|60=$time|");
+    if (!compiled || !connect_session()) {
+        close_session();
+        return false;
+    }
+
+    fix::fix_slot_values values;
+    if (!send_message(logon_template_, values) || !wait_for_logon()) {
+        close_session();
+        return false;
+    }
+    initialized_ = true;
+    return true;
+}
+
+broker_api::send_result fix_broker_adapter::submit(const broker_api::broker_order_request& request) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const broker_api::send_result result = encode_request(request);
+    if (result.accepted) {
+        (void)flush_send();
+    }
+    return result;
+}
+
+void fix_broker_adapter::submit_batch(const broker_api::broker_order_request* requests, std::size_t count,
+                                      broker_api::send_result* out_results) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (std::size_t i = 0; i < count; ++i) {
+        out_results[i] = encode_request(requests[i]);
+    }
+    (void)flush_send();
+}
+
+broker_api::send_result fix_broker_adapter::encode_request(const broker_api::broker_order_request& request) {
+    if (!initialized_) {
+        return broker_api::send_result::fatal_error(kFixNotInitializedError);
+    }
+    if (request.internal_order_id == 0) {
+        return broker_api::send_result::fatal_error(kFixInvalidOrderIdError);
+    }
+    if (!logged_on_) {
+        return broker_api::send_result::retryable_error(kFixSessionDownError);
+    }
+
+    const fix::fix_template* templ = nullptr;
+    const order_state* original = nullptr;
+    switch (request.type) {
+        case broker_api::request_type::New:
+            if (request.trade_side == broker_api::side::Unknown || exchange_code(request.order_market).empty() ||
+                request.volume == 0 || request.price == 0 || request.security_id[0] == 0) {
+                return broker_api::send_result::fatal_error(kFixInvalidNewError);
+            }
+            templ = &new_template_;
+            break;
+        case broker_api::request_type::Cancel:
+        case broker_api::request_type::Replace:
+            if (request.orig_internal_order_id == 0) {
+                return broker_api::send_result::fatal_error(kFixMissingOrigError);
+            }
+            templ = request.type == broker_api::request_type::Cancel ? &cancel_template_ : &replace_template_;
+            original = orders_.find(request.orig_internal_order_id);
+            break;
+        default:
+            return broker_api::send_result::fatal_error(kFixUnknownTypeError);
+    }
+
+    if (send_tail_ + templ->max_size() > config_.send_buffer_bytes && !flush_send()) {
+        return broker_api::send_result::retryable_error(kFixSendBufferFullError);
+    }
+    if (send_tail_ + templ->max_size() > config_.send_buffer_bytes) {
+        return broker_api::send_result::retryable_error(kFixSendBufferFullError);
+    }
+    if (orders_.size() >= config_.max_active_orders || orders_.contains(request.internal_order_id)) {
+        return broker_api::send_result::retryable_error(kFixOrderTableFullError);
+    }
+    order_state* state = orders_.try_emplace(request.internal_order_id);
+    if (state == nullptr) {
+        return broker_api::send_result::retryable_error(kFixOrderTableFullError);
+    }
+    // try_emplace 不会挪动已有槽位，original 仍然有效
+    state->internal_order_id = request.internal_order_id;
+    state->owner_order_id =
+        request.type == broker_api::request_type::New ? request.internal_order_id : request.orig_internal_order_id;
+    state->type = request.type;
+    state->order_market = request.order_market;
+    state->entrust_volume = request.volume;
+    state->price = request.price;
+    state->md_time = request.md_time;
+    std::memcpy(state->internal_security_id, request.internal_security_id, sizeof(state->internal_security_id));
+    std::memcpy(state->security_id, request.security_id, sizeof(state->security_id));
+    state->trade_side = request.trade_side;
+    if (original != nullptr) {
+        // 撤单/改单沿用原单的证券、方向与市场，网关下发的撤单请求不一定带全这些字段
+        if (state->security_id[0] == 0) {
+            std::memcpy(state->security_id, original->security_id, sizeof(state->security_id));
+        }
+        if (state->internal_security_id[0] == 0) {
+            std::memcpy(state->internal_security_id, original->internal_security_id,
+                        sizeof(state->internal_security_id));
+        }
+        if (state->trade_side == broker_api::side::Unknown) {
+            state->trade_side = original->trade_side;
+        }
+        if (state->order_market == broker_api::market::Unknown) {
+            state->order_market = original->order_market;
+        }
+        if (request.type == broker_api::request_type::Cancel) {
+            state->entrust_volume = original->entrust_volume;
+        }
+    }
+
+    fix::fix_slot_values values;
+    values.cl_ord_id = request.internal_order_id;
+    values.orig_cl_ord_id = request.type == broker_api::request_type::New ? 0 : request.orig_internal_order_id;
+    // 改单链上原单已被改过时，OrigClOrdID 须是最近一次生效的改单编号
+    if (original != nullptr && original->alias_order_id != 0) {
+        values.orig_cl_ord_id = original->alias_order_id;
+    }
+    values.symbol = bounded_view(state->security_id, sizeof(state->security_id));
+    values.exchange = exchange_code(state->order_market);
+    values.side = side_code(state->trade_side);
+    values.order_qty = state->entrust_volume;
+    values.price_cents = state->price;
+    if (!send_message(*templ, values)) {
+        orders_.erase(request.internal_order_id);
+        return broker_api::send_result::retryable_error(kFixSendBufferFullError);
+    }
+    return broker_api::send_result::ok();
+}
+
+// 重启前的 ClOrdID 在柜台侧仍然有效，跟踪表按原订单号登记后撤单、改单与执行回报照常关联原单
+std::size_t fix_broker_adapter::recover(const broker_api::broker_inflight_order* orders, std::size_t count) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!initialized_ || orders == nullptr) {
+        return 0;
+    }
+
+    std::size_t recovered = 0;
+    for (std::size_t i = 0; i < count; ++i) {
+        const broker_api::broker_order_request& request = orders[i].request;
+        if (request.type != broker_api::request_type::New || request.internal_order_id == 0 ||
+            orders_.contains(request.internal_order_id)) {
+            continue;
+        }
+        if (orders_.size() >= config_.max_active_orders) {
+            break;
+        }
+        order_state* state = orders_.try_emplace(request.internal_order_id);
+        if (state == nullptr) {
+            break;
+        }
+        state->internal_order_id = request.internal_order_id;
+        state->owner_order_id = request.internal_order_id;
+        state->broker_order_id = orders[i].broker_order_id;
+        state->type = request.type;
+        state->order_market = request.order_market;
+        state->accepted = orders[i].broker_order_id != 0;
+        state->entrust_volume = request.volume;
+        state->traded_volume = orders[i].traded_volume;
+        state->price = request.price;
+        state->md_time = request.md_time;
+        std::memcpy(state->internal_security_id, request.internal_security_id, sizeof(state->internal_security_id));
+        std::memcpy(state->security_id, request.security_id, sizeof(state->security_id));
+        state->trade_side = request.trade_side;
+        ++recovered;
+    }
+    return recovered;
+}
+
+// 先推进 socket（读入执行回报、冲刷发送缓冲、心跳），再批量交出回报。
+std::size_t fix_broker_adapter::poll_events(broker_api::broker_event* out_events, std::size_t max_events) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!initialized_ || out_events == nullptr || max_events == 0) {
+        return 0;
+    }
+
+    service_socket();
+    const std::size_t mask = events_.size() - 1;
+    const std::size_t count = std::min(max_events, event_tail_ - event_head_);
+    for (std::size_t i = 0; i < count; ++i) {
+        out_events[i] = events_[(event_head_ + i) & mask];
+    }
+    event_head_ += count;
+    return count;
+}
+
+void fix_broker_adapter::shutdown() noexcept {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (fd_ >= 0 && logged_on_) {
+        fix::fix_slot_values values;
+        if (send_message(logout_template_, values)) {
+            (void)flush_send();
+        }
+    }
+    close_session();
+    orders_.clear();
+    event_head_ = 0;
+    event_tail_ = 0;
+    initialized_ = false;
+}
+
+std::size_t fix_broker_adapter::ingest(const char* data, std::size_t size) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return ingest_locked(data, size, now_ns());
+}
+
+bool fix_broker_adapter::send_message(const fix::fix_template& templ, fix::fix_slot_values& values) {
+    if (send_tail_ + templ.max_size() > config_.send_buffer_bytes) {
+        return false;
+    }
+    values.seq_num = next_seq_num_;
+    values.sending_time = sending_time();
+    const std::size_t written = templ.render(send_buffer_.get() + send_tail_, config_.send_buffer_bytes - send_tail_,
+                                             values);
+    if (written == 0) {
+        return false;
+    }
+    send_tail_ += written;
+    ++next_seq_num_;
+    ++messages_sent_;
+    return true;
+}
+
+// 尽量写出发送缓冲；返回 true 表示缓冲已清空。未写完的部分前移，为后续消息腾出尾部空间。
+bool fix_broker_adapter::flush_send() noexcept {
+    if (fd_ < 0) {
+        return send_head_ == send_tail_;
+    }
+    while (send_head_ < send_tail_) {
+        const ssize_t sent =
+            ::send(fd_, send_buffer_.get() + send_head_, send_tail_ - send_head_, MSG_NOSIGNAL | MSG_DONTWAIT);
+        if (sent > 0) {
+            send_head_ += static_cast<std::size_t>(sent);
+            last_send_mono_ns_ = now_monotonic_ns();
+            continue;
+        }
+        if (sent < 0 && errno == EINTR) {
+            continue;
+        }
+        if (sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            break;
+        }
+        close_session();
+        return false;
+    }
+    if (send_head_ == send_tail_) {
+        send_head_ = 0;
+        send_tail_ = 0;
+        return true;
+    }
+    if (send_head_ != 0) {
+        std::memmove(send_buffer_.get(), send_buffer_.get() + send_head_, send_tail_ - send_head_);
+        send_tail_ -= send_head_;
+        send_head_ = 0;
+    }
+    return false;
+}
+
+void fix_broker_adapter::service_socket() {
+    if (fd_ < 0) {
+        return;
+    }
+    (void)flush_send();
+
+    const TimestampNs recv_ns = now_ns();
+    // 上一轮因回报队列满而留下的完整帧先处理
+    if (recv_size_ != 0) {
+        const std::size_t consumed = ingest_locked(recv_buffer_.get(), recv_size_, recv_ns);
+        if (consumed != 0) {
+            std::memmove(recv_buffer_.get(), recv_buffer_.get() + consumed, recv_size_ - consumed);
+            recv_size_ -= consumed;
+        }
+    }
+
+    epoll_event ready{};
+    const int ready_count = fd_ >= 0 ? ::epoll_wait(epoll_fd_, &ready, 1, 0) : 0;
+    if (ready_count > 0 && fd_ >= 0) {
+        if ((ready.events & EPOLLIN) != 0 && recv_size_ < config_.recv_buffer_bytes) {
+            const ssize_t received =
+                ::recv(fd_, recv_buffer_.get() + recv_size_, config_.recv_buffer_bytes - recv_size_, MSG_DONTWAIT);
+            if (received > 0) {
+                recv_size_ += static_cast<std::size_t>(received);
+                last_recv_mono_ns_ = now_monotonic_ns();
+                const std::size_t consumed = ingest_locked(recv_buffer_.get(), recv_size_, recv_ns);
+                if (consumed != 0) {
+                    std::memmove(recv_buffer_.get(), recv_buffer_.get() + consumed, recv_size_ - consumed);
+                    recv_size_ -= consumed;
+                }
+                if (recv_size_ == config_.recv_buffer_bytes && has_event_room(kMaxEventsPerMessage)) {
+                    // 整个接收缓冲放不下一帧：对端消息超长，按失步处理
+                    ++bad_frames_;
+                    close_session();
+                }
+            } else if (received == 0 || (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)) {
+                close_session();
+            }
+        } else if ((ready.events & (EPOLLERR | EPOLLHUP)) != 0) {
+            close_session();
+        }
+    }
+
+    if (!logged_on_) {
+        return;
+    }
+    const TimestampNs now_mono = now_monotonic_ns();
+    const TimestampNs heartbeat_ns = static_cast<TimestampNs>(config_.heartbeat_interval_s) * 1000000000ULL;
+    if (now_mono - last_recv_mono_ns_ > 2 * heartbeat_ns) {
+        // 对端超过两个心跳周期无任何消息：会话视为中断，submit 随即返回可重试错误
+        close_session();
+        return;
+    }
+    if (now_mono - last_send_mono_ns_ >= heartbeat_ns) {
+        fix::fix_slot_values values;
+        if (send_message(heartbeat_template_, values)) {
+            (void)flush_send();
+        }
+    }
+}
+
+std::size_t fix_broker_adapter::ingest_locked(const char* data, std::size_t size, TimestampNs recv_ns) {
+    std::size_t offset = 0;
+    fix::fix_message_view message;
+    while (offset < size && has_event_room(kMaxEventsPerMessage)) {
+        std::size_t consumed = 0;
+        const fix::fix_parse_status status = fix::fix_parse(data + offset, size - offset, message, consumed);
+        if (status == fix::fix_parse_status::Incomplete) {
+            break;
+        }
+        if (status == fix::fix_parse_status::Malformed) {
+            // 流已失步，丢弃剩余字节并断开会话
+            ++bad_frames_;
+            close_session();
+            return size;
+        }
+        offset += consumed;
+        if (status == fix::fix_parse_status::BadChecksum) {
+            ++bad_frames_;
+            continue;
+        }
+        ++messages_received_;
+        handle_message(message, recv_ns);
+    }
+    return offset;
+}
+
+void fix_broker_adapter::handle_message(const fix::fix_message_view& message, TimestampNs recv_ns) {
+    const std::string_view type = message.msg_type();
+    if (type.size() != 1) {
+        return;
+    }
+    switch (type[0]) {
+        case '8':
+            handle_execution_report(message, recv_ns);
+            break;
+        case '9':
+            handle_cancel_reject(message, recv_ns);
+            break;
+        case 'A':
+            logged_on_ = true;
+            last_recv_mono_ns_ = now_monotonic_ns();
+            break;
+        case '1': {
+            std::string_view test_req_id;
+            fix::fix_slot_values values;
+            if (message.get(fix::tag::TestReqID, test_req_id)) {
+                values.test_req_id = test_req_id;
+                (void)send_message(test_heartbeat_template_, values);
+            } else {
+                (void)send_message(heartbeat_template_, values);
+            }
+            break;
+        }
+        case '5':
+            close_session();
+            break;
+        default:
+            break;
+    }
+}
+
+void fix_broker_adapter::handle_execution_report(const fix::fix_message_view& message, TimestampNs recv_ns) {
+    uint64_t cl_ord_id = 0;
+    char exec_type = 0;
+    order_state* state = nullptr;
+    if (message.get_uint(fix::tag::ClOrdID, cl_ord_id) && cl_ord_id <= UINT32_MAX &&
+        message.get_char(fix::tag::ExecType, exec_type)) {
+        state = orders_.find(static_cast<uint32_t>(cl_ord_id));
+    }
+    if (state == nullptr) {
+        ++unmatched_reports_;
+        return;
+    }
+    const uint32_t id = state->internal_order_id;
+    order_state* owner = state->type == broker_api::request_type::New ? state : orders_.find(state->owner_order_id);
+
+    std::string_view order_id;
+    if (message.get(fix::tag::OrderID, order_id) && owner != nullptr) {
+        owner->broker_order_id = broker_order_id_of(order_id);
+    }
+    if (state != owner && owner != nullptr) {
+        state->broker_order_id = owner->broker_order_id;
+    }
+
+    switch (exec_type) {
+        case '0':  // New
+            if (state->type == broker_api::request_type::New && !state->accepted) {
+                state->accepted = true;
+                push_event(make_event(broker_api::event_kind::BrokerAccepted, *state, id, recv_ns));
+            }
+            break;
+        case '6':  // Pending Cancel
+        case 'E':  // Pending Replace
+            if (state->type != broker_api::request_type::New && !state->accepted) {
+                state->accepted = true;
+                push_event(make_event(broker_api::event_kind::BrokerAccepted, *state, id, recv_ns));
+            }
+            break;
+        case '8':  // Rejected
+            push_event(make_event(broker_api::event_kind::BrokerRejected, *state, id, recv_ns));
+            if (state->type == broker_api::request_type::New) {
+                const uint32_t alias = state->alias_order_id;
+                orders_.erase(id);
+                if (alias != 0) {
+                    orders_.erase(alias);
+                }
+            } else {
+                orders_.erase(id);
+            }
+            break;
+        case '5': {  // Replaced：改单请求受理并完成，原单改量改价，之后的回报以改单编号为 ClOrdID
+            if (state->type != broker_api::request_type::Replace || owner == nullptr) {
+                ++unmatched_reports_;
+                break;
+            }
+            if (!state->accepted) {
+                state->accepted = true;
+                push_event(make_event(broker_api::event_kind::BrokerAccepted, *state, id, recv_ns));
+            }
+            push_event(make_event(broker_api::event_kind::Finished, *state, id, recv_ns));
+            uint64_t order_qty = 0;
+            owner->entrust_volume = message.get_uint(fix::tag::OrderQty, order_qty) ? order_qty : state->entrust_volume;
+            owner->price = state->price;
+            const uint32_t previous_alias = owner->alias_order_id;
+            owner->alias_order_id = id;
+            if (previous_alias != 0 && previous_alias != id) {
+                orders_.erase(previous_alias);
+            }
+            break;
+        }
+        case '4':    // Canceled
+        case 'C': {  // Expired
+            if (state->type == broker_api::request_type::Cancel) {
+                if (!state->accepted) {
+                    push_event(make_event(broker_api::event_kind::BrokerAccepted, *state, id, recv_ns));
+                }
+                const uint32_t owner_id = state->owner_order_id;
+                orders_.erase(id);
+                owner = orders_.find(owner_id);
+            }
+            if (owner == nullptr) {
+                break;
+            }
+            uint64_t cum_qty = 0;
+            if (message.get_uint(fix::tag::CumQty, cum_qty) && cum_qty > owner->traded_volume) {
+                owner->traded_volume = cum_qty;
+            }
+            const uint64_t cancelled =
+                owner->entrust_volume > owner->traded_volume ? owner->entrust_volume - owner->traded_volume : 0;
+            finish_order(*owner, cancelled, recv_ns);
+            break;
+        }
+        case 'F':  // Trade（FIX 4.4）
+        case '1':  // Partial fill（FIX 4.2）
+        case '2': {  // Fill（FIX 4.2）
+            if (owner == nullptr) {
+                ++unmatched_reports_;
+                break;
+            }
+            uint64_t last_qty = 0;
+            uint64_t last_px = 0;
+            if (!message.get_uint(fix::tag::LastQty, last_qty) || last_qty == 0 ||
+                !message.get_cents(fix::tag::LastPx, last_px)) {
+                break;
+            }
+            broker_api::broker_event trade =
+                make_event(broker_api::event_kind::Trade, *owner, owner->internal_order_id, recv_ns);
+            trade.volume_traded = last_qty;
+            trade.price_traded = last_px;
+            trade.value_traded = last_qty * last_px;
+            uint64_t commission = 0;
+            trade.fee = message.get_cents(fix::tag::Commission, commission) ? commission : 0;
+            push_event(trade);
+            owner->traded_volume += last_qty;
+
+            char ord_status = 0;
+            if ((message.get_char(fix::tag::OrdStatus, ord_status) && ord_status == '2') ||
+                owner->traded_volume >= owner->entrust_volume) {
+                finish_order(*owner, 0, recv_ns);
+            }
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+// 撤单/改单被拒：请求本身以 BrokerRejected 结束，原单不受影响
+void fix_broker_adapter::handle_cancel_reject(const fix::fix_message_view& message, TimestampNs recv_ns) {
+    uint64_t cl_ord_id = 0;
+    order_state* state = nullptr;
+    if (message.get_uint(fix::tag::ClOrdID, cl_ord_id) && cl_ord_id <= UINT32_MAX) {
+        state = orders_.find(static_cast<uint32_t>(cl_ord_id));
+    }
+    if (state == nullptr || state->type == broker_api::request_type::New) {
+        ++unmatched_reports_;
+        return;
+    }
+    const uint32_t id = state->internal_order_id;
+    push_event(make_event(broker_api::event_kind::BrokerRejected, *state, id, recv_ns));
+    orders_.erase(id);
+}
+
+void fix_broker_adapter::finish_order(order_state& owner, uint64_t cancelled_volume, TimestampNs recv_ns) {
+    broker_api::broker_event finish =
+        make_event(broker_api::event_kind::Finished, owner, owner.internal_order_id, recv_ns);
+    finish.cancelled_volume = cancelled_volume;
+    push_event(finish);
+    const uint32_t id = owner.internal_order_id;
+    const uint32_t alias = owner.alias_order_id;
+    orders_.erase(id);
+    if (alias != 0) {
+        orders_.erase(alias);
+    }
+}
+
+broker_api::broker_event fix_broker_adapter::make_event(broker_api::event_kind kind, const order_state& state,
+                                                        uint32_t internal_order_id, TimestampNs recv_ns) const noexcept {
+    broker_api::broker_event event;
+    event.kind = kind;
+    event.internal_order_id = internal_order_id;
+    event.broker_order_id = state.broker_order_id;
+    std::memcpy(event.internal_security_id, state.internal_security_id, sizeof(event.internal_security_id));
+    event.trade_side = state.trade_side;
+    event.md_time_traded = state.md_time;
+    event.recv_time_ns = recv_ns;
+    return event;
+}
+
+bool fix_broker_adapter::has_event_room(std::size_t count) const noexcept {
+    return (event_tail_ - event_head_) + count <= events_.size();
+}
+
+void fix_broker_adapter::push_event(const broker_api::broker_event& event) noexcept {
+    events_[event_tail_ & (events_.size() - 1)] = event;
+    ++event_tail_;
+}
+
+bool fix_broker_adapter::connect_session() {
+    addrinfo hints{};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo* resolved = nullptr;
+    const uint32_t port = static_cast<uint32_t>(config_.port) + runtime_config_.session_index;
+    if (config_.port == 0 || port > 65535 ||
+        ::getaddrinfo(config_.host.c_str(), std::to_string(port).c_str(), &hints, &resolved) != 0) {
+        return false;
+    }
+
+    for (addrinfo* candidate = resolved; candidate != nullptr && fd_ < 0; candidate = candidate->ai_next) {
+        const int fd = ::socket(candidate->ai_family, candidate->ai_socktype | SOCK_CLOEXEC, candidate->ai_protocol);
+        if (fd < 0) {
+            continue;
+        }
+        if (::connect(fd, candidate->ai_addr, candidate->ai_addrlen) != 0) {
+            ::close(fd);
+            continue;
+        }
+        fd_ = fd;
+    }
+    ::freeaddrinfo(resolved);
+    if (fd_ < 0) {
+        return false;
+    }
+
+    const int one = 1;
+    (void)::setsockopt(fd_, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    epoll_fd_ = ::epoll_create1(EPOLL_CLOEXEC);
+    if (epoll_fd_ < 0) {
+        return false;
+    }
+    epoll_event interest{};
+    interest.events = EPOLLIN;
+    interest.data.fd = fd_;
+    if (::epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd_, &interest) != 0) {
+        return false;
+    }
+    const TimestampNs now_mono = now_monotonic_ns();
+    last_send_mono_ns_ = now_mono;
+    last_recv_mono_ns_ = now_mono;
+    return true;
+}
+
+bool fix_broker_adapter::wait_for_logon() {
+    const TimestampNs deadline = now_monotonic_ns() + static_cast<TimestampNs>(config_.logon_timeout_ms) * 1000000ULL;
+    while (!logged_on_ && fd_ >= 0) {
+        (void)flush_send();
+        const TimestampNs now_mono = now_monotonic_ns();
+        if (now_mono >= deadline) {
+            return false;
+        }
+        epoll_event ready{};
+        const int timeout_ms = static_cast<int>(std::max<TimestampNs>((deadline - now_mono) / 1000000ULL, 1));
+        if (::epoll_wait(epoll_fd_, &ready, 1, timeout_ms) <= 0) {
+            continue;
+        }
+        const ssize_t received =
+            ::recv(fd_, recv_buffer_.get() + recv_size_, config_.recv_buffer_bytes - recv_size_, MSG_DONTWAIT);
+        if (received == 0 || (received < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)) {
+            return false;
+        }
+        if (received > 0) {
+            recv_size_ += static_cast<std::size_t>(received);
+            const std::size_t consumed = ingest_locked(recv_buffer_.get(), recv_size_, now_ns());
+            std::memmove(recv_buffer_.get(), recv_buffer_.get() + consumed, recv_size_ - consumed);
+            recv_size_ -= consumed;
+        }
+    }
+    return logged_on_;
+}
+
+void fix_broker_adapter::close_session() noexcept {
+    if (epoll_fd_ >= 0) {
+        ::close(epoll_fd_);
+        epoll_fd_ = -1;
+    }
+    if (fd_ >= 0) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+    logged_on_ = false;
+}
+
+// SendingTime 精确到毫秒，同一毫秒内的多条消息复用格式化结果
+const char* fix_broker_adapter::sending_time() noexcept {
+    const TimestampNs now_ms = now_ns() / 1000000ULL;
+    if (now_ms != sending_time_ms_) {
+        fix::format_sending_time(now_ms * 1000000ULL, sending_time_);
+        sending_time_ms_ = now_ms;
+    }
+    return sending_time_;
+}
+
+}  // namespace acct_service::gateway
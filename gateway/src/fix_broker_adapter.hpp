@@ -0,0 +1,142 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "broker_api/broker_api.hpp"
+#include "common/flat_hash_map.hpp"
+#include "common/types.hpp"
+#include "fix_codec.hpp"
+
+namespace acct_service::gateway {
+
+// FIX 会话参数。插件入口只拿到 broker_runtime_config，连接参数由 fix_session_config_from_env() 从环境变量读取。
+struct fix_session_config {
+    std::string host = "127.0.0.1";
+    uint16_t port = 0;                     // 多会话分片时第 i 个会话连 port + session_index
+    std::string begin_string = "FIX.4.4";
+    std::string sender_comp_id = "ACCT";
+    std::string target_comp_id = "BROKER";
+    std::string account;                   // 非空时新单/改单带 tag 1
+    uint32_t heartbeat_interval_s = 30;
+    uint32_t logon_timeout_ms = 5000;
+    uint32_t max_active_orders = 16384;    // 在途订单（含撤单/改单请求）跟踪表容量
+    std::size_t send_buffer_bytes = std::size_t{1} << 20;
+    std::size_t recv_buffer_bytes = std::size_t{1} << 20;
+};
+
+// ACCT_FIX_HOST / ACCT_FIX_PORT / ACCT_FIX_BEGIN_STRING / ACCT_FIX_SENDER_COMP_ID / ACCT_FIX_TARGET_COMP_ID /
+// ACCT_FIX_ACCOUNT / ACCT_FIX_HEARTBEAT_S / ACCT_FIX_LOGON_TIMEOUT_MS / ACCT_FIX_MAX_ACTIVE_ORDERS，未设置的保持默认
+fix_session_config fix_session_config_from_env();
+
+// FIX 券商适配器参考实现：非阻塞 TCP + epoll 单会话，New/Cancel/Replace 走预渲染模板，执行回报零分配解码后直接映射为 broker_event。
+// 收发缓冲、订单跟踪表与回报队列在构造时按配置预分配，稳态下 submit/poll 不分配内存。
+// 会话层只覆盖 Logon(A，ResetSeqNumFlag=Y) / Heartbeat / TestRequest / Logout，不做重传与补缺；断线后 submit 返回可重试错误。
+class fix_broker_adapter final : public broker_api::IBrokerAdapter {
+public:
+    fix_broker_adapter() : fix_broker_adapter(fix_session_config_from_env()) {}
+    explicit fix_broker_adapter(const fix_session_config& config);
+    ~fix_broker_adapter() override;
+
+    bool initialize(const broker_api::broker_runtime_config& config) override;
+    broker_api::send_result submit(const broker_api::broker_order_request& request) override;
+    // 整批编码进发送缓冲后一次 send
+    void submit_batch(const broker_api::broker_order_request* requests, std::size_t count,
+                      broker_api::send_result* out_results) override;
+    std::size_t poll_events(broker_api::broker_event* out_events, std::size_t max_events) override;
+    bool supports_replace() const noexcept override { return true; }
+    // 热重启：只重建订单跟踪表，不发消息；柜台侧的状态以其后到达的执行回报为准
+    std::size_t recover(const broker_api::broker_inflight_order* orders, std::size_t count) override;
+    void shutdown() noexcept override;
+
+    // 解析一段入站字节并映射回报（socket 读路径同样经过这里；离线回放与基准可直接喂入），返回已消费字节数
+    std::size_t ingest(const char* data, std::size_t size);
+
+    bool logged_on() const noexcept { return logged_on_; }
+    uint64_t messages_sent() const noexcept { return messages_sent_; }
+    uint64_t messages_received() const noexcept { return messages_received_; }
+    // 找不到对应订单的执行回报与校验和错误的帧数
+    uint64_t unmatched_reports() const noexcept { return unmatched_reports_; }
+    uint64_t bad_frames() const noexcept { return bad_frames_; }
+
+private:
+    struct order_state {
+        uint32_t internal_order_id = 0;
+        uint32_t owner_order_id = 0;  // New 为自身；Cancel/Replace 为原单，回报按原单归属
+        uint32_t alias_order_id = 0;  // 原单最近一次生效的改单编号，之后的回报 ClOrdID 为该编号
+        uint32_t broker_order_id = 0;
+        char internal_security_id[broker_api::kInternalSecurityIdSize]{};
+        char security_id[broker_api::kSecurityIdSize]{};
+        broker_api::request_type type = broker_api::request_type::Unknown;
+        broker_api::side trade_side = broker_api::side::Unknown;
+        broker_api::market order_market = broker_api::market::Unknown;
+        bool accepted = false;
+        uint64_t entrust_volume = 0;
+        uint64_t traded_volume = 0;
+        uint64_t price = 0;
+        uint32_t md_time = 0;
+    };
+
+    // 调用方持锁
+    broker_api::send_result encode_request(const broker_api::broker_order_request& request);
+    bool send_message(const fix::fix_template& templ, fix::fix_slot_values& values);
+    bool flush_send() noexcept;
+    void service_socket();
+    std::size_t ingest_locked(const char* data, std::size_t size, TimestampNs recv_ns);
+    void handle_message(const fix::fix_message_view& message, TimestampNs recv_ns);
+    void handle_execution_report(const fix::fix_message_view& message, TimestampNs recv_ns);
+    void handle_cancel_reject(const fix::fix_message_view& message, TimestampNs recv_ns);
+    // 原单完成：吐出 Finished 并释放原单与改单别名
+    void finish_order(order_state& owner, uint64_t cancelled_volume, TimestampNs recv_ns);
+    broker_api::broker_event make_event(broker_api::event_kind kind, const order_state& state,
+                                        uint32_t internal_order_id, TimestampNs recv_ns) const noexcept;
+    bool has_event_room(std::size_t count) const noexcept;
+    void push_event(const broker_api::broker_event& event) noexcept;
+    bool connect_session();
+    bool wait_for_logon();
+    void close_session() noexcept;
+    const char* sending_time() noexcept;
+
+    std::mutex mutex_;
+    fix_session_config config_{};
+    broker_api::broker_runtime_config runtime_config_{};
+    bool initialized_ = false;
+    bool logged_on_ = false;
+    int fd_ = -1;
+    int epoll_fd_ = -1;
+
+    fix::fix_template logon_template_;
+    fix::fix_template logout_template_;
+    fix::fix_template heartbeat_template_;
+    fix::fix_template test_heartbeat_template_;
+    fix::fix_template new_template_;
+    fix::fix_template cancel_template_;
+    fix::fix_template replace_template_;
+    uint64_t next_seq_num_ = 1;
+    char sending_time_[fix::kSendingTimeSize]{};
+    TimestampNs sending_time_ms_ = 0;  // sending_time_ 对应的毫秒，同一毫秒内复用
+    TimestampNs last_send_mono_ns_ = 0;
+    TimestampNs last_recv_mono_ns_ = 0;
+
+    std::unique_ptr<char[]> send_buffer_;
+    std::size_t send_head_ = 0;
+    std::size_t send_tail_ = 0;
+    std::unique_ptr<char[]> recv_buffer_;
+    std::size_t recv_size_ = 0;
+
+    flat_hash_map<uint32_t, order_state> orders_;
+    std::vector<broker_api::broker_event> events_;
+    std::size_t event_head_ = 0;
+    std::size_t event_tail_ = 0;
+
+    uint64_t messages_sent_ = 0;
+    uint64_t messages_received_ = 0;
+    uint64_t unmatched_reports_ = 0;
+    uint64_t bad_frames_ = 0;
+};
+
+}  // namespace acct_service::gateway
@@ -0,0 +1,454 @@
+#include "fix_codec.hpp"
+
+#include <cstring>
+#include <ctime>
+
+namespace acct_service::gateway::fix {
+
+namespace {
+
+// "10=XXX\x01"
+constexpr std::size_t kTrailerSize = 7;
+// "9=" + 至多 6 位长度 + SOH
+constexpr std::size_t kBodyLengthFieldMax = 9;
+
+struct slot_name {
+    std::string_view name;
+    fix_slot slot;
+    std::size_t max_bytes;
+};
+
+constexpr slot_name kSlotNames[] = {
+    {"seq", fix_slot::SeqNum, 20},
+    {"time", fix_slot::SendingTime, kSendingTimeSize},
+    {"clordid", fix_slot::ClOrdId, 10},
+    {"origclordid", fix_slot::OrigClOrdId, 10},
+    {"symbol", fix_slot::Symbol, fix_template::kMaxSlotBytes},
+    {"exchange", fix_slot::Exchange, fix_template::kMaxSlotBytes},
+    {"side", fix_slot::Side, 1},
+    {"qty", fix_slot::OrderQty, 20},
+    {"price", fix_slot::Price, 24},
+    {"testreqid", fix_slot::TestReqId, fix_template::kMaxSlotBytes},
+};
+
+uint32_t byte_sum(const char* data, std::size_t size) noexcept {
+    uint32_t sum = 0;
+    for (std::size_t i = 0; i < size; ++i) {
+        sum += static_cast<unsigned char>(data[i]);
+    }
+    return sum;
+}
+
+// 无符号整数写入 out（至多 20 位），返回位数
+std::size_t write_uint(uint64_t value, char* out) noexcept {
+    char digits[20];
+    std::size_t count = 0;
+    do {
+        digits[count++] = static_cast<char>('0' + value % 10);
+        value /= 10;
+    } while (value != 0);
+    for (std::size_t i = 0; i < count; ++i) {
+        out[i] = digits[count - 1 - i];
+    }
+    return count;
+}
+
+std::size_t write_cents(uint64_t cents, char* out) noexcept {
+    std::size_t n = write_uint(cents / 100, out);
+    const uint64_t fraction = cents % 100;
+    out[n++] = '.';
+    out[n++] = static_cast<char>('0' + fraction / 10);
+    out[n++] = static_cast<char>('0' + fraction % 10);
+    return n;
+}
+
+std::size_t write_view(std::string_view value, char* out) noexcept {
+    const std::size_t n = value.size() < fix_template::kMaxSlotBytes ? value.size() : fix_template::kMaxSlotBytes;
+    std::memcpy(out, value.data(), n);
+    return n;
+}
+
+bool parse_uint(const char* data, std::size_t size, uint64_t& out) noexcept {
+    if (size == 0 || size > 19) {
+        return false;
+    }
+    uint64_t value = 0;
+    for (std::size_t i = 0; i < size; ++i) {
+        const unsigned digit = static_cast<unsigned>(data[i] - '0');
+        if (digit > 9) {
+            return false;
+        }
+        value = value * 10 + digit;
+    }
+    out = value;
+    return true;
+}
+
+const fix_field* find_field(const fix_field* fields, std::size_t count, uint32_t tag) noexcept {
+    for (std::size_t i = 0; i < count; ++i) {
+        if (fields[i].tag == tag) {
+            return &fields[i];
+        }
+    }
+    return nullptr;
+}
+
+}  // namespace
+
+bool fix_message_view::get(uint32_t tag, std::string_view& out) const noexcept {
+    const fix_field* field = find_field(fields_, count_, tag);
+    if (field == nullptr) {
+        return false;
+    }
+    out = std::string_view(data_ + field->offset, field->length);
+    return true;
+}
+
+bool fix_message_view::get_char(uint32_t tag, char& out) const noexcept {
+    const fix_field* field = find_field(fields_, count_, tag);
+    if (field == nullptr || field->length == 0) {
+        return false;
+    }
+    out = data_[field->offset];
+    return true;
+}
+
+bool fix_message_view::get_uint(uint32_t tag, uint64_t& out) const noexcept {
+    const fix_field* field = find_field(fields_, count_, tag);
+    return field != nullptr && parse_uint(data_ + field->offset, field->length, out);
+}
+
+bool fix_message_view::get_cents(uint32_t tag, uint64_t& out) const noexcept {
+    const fix_field* field = find_field(fields_, count_, tag);
+    if (field == nullptr || field->length == 0) {
+        return false;
+    }
+    const char* value = data_ + field->offset;
+    const std::size_t size = field->length;
+    std::size_t dot = 0;
+    while (dot < size && value[dot] != '.') {
+        ++dot;
+    }
+    uint64_t integer = 0;
+    if (!parse_uint(value, dot, integer)) {
+        return false;
+    }
+    uint64_t fraction = 0;
+    bool round_up = false;
+    for (std::size_t i = dot + 1, place = 0; i < size; ++i, ++place) {
+        const unsigned digit = static_cast<unsigned>(value[i] - '0');
+        if (digit > 9) {
+            return false;
+        }
+        if (place < 2) {
+            fraction = fraction * 10 + digit;
+        } else if (place == 2) {
+            round_up = digit >= 5;
+        }
+    }
+    // 只有一位小数时补齐到分
+    if (dot + 2 == size) {
+        fraction *= 10;
+    }
+    out = integer * 100 + fraction + (round_up ? 1 : 0);
+    return true;
+}
+
+fix_parse_status fix_parse(const char* data, std::size_t size, fix_message_view& out, std::size_t& consumed) noexcept {
+    consumed = 0;
+    // 8=<BeginString>\x01
+    if (size < 2) {
+        return fix_parse_status::Incomplete;
+    }
+    if (data[0] != '8' || data[1] != '=') {
+        return fix_parse_status::Malformed;
+    }
+    const void* begin_end = std::memchr(data + 2, kSoh, size - 2 > 16 ? 16 : size - 2);
+    if (begin_end == nullptr) {
+        return size - 2 >= 16 ? fix_parse_status::Malformed : fix_parse_status::Incomplete;
+    }
+    std::size_t pos = static_cast<std::size_t>(static_cast<const char*>(begin_end) - data) + 1;
+
+    // 9=<BodyLength>\x01
+    if (size < pos + 2) {
+        return fix_parse_status::Incomplete;
+    }
+    if (data[pos] != '9' || data[pos + 1] != '=') {
+        return fix_parse_status::Malformed;
+    }
+    pos += 2;
+    std::size_t length_end = pos;
+    while (length_end < size && data[length_end] != kSoh) {
+        if (length_end - pos >= kBodyLengthFieldMax - 3) {
+            return fix_parse_status::Malformed;
+        }
+        ++length_end;
+    }
+    if (length_end == size) {
+        return fix_parse_status::Incomplete;
+    }
+    uint64_t body_length = 0;
+    if (!parse_uint(data + pos, length_end - pos, body_length)) {
+        return fix_parse_status::Malformed;
+    }
+    const std::size_t body_begin = length_end + 1;
+    const std::size_t body_end = body_begin + static_cast<std::size_t>(body_length);
+    const std::size_t total = body_end + kTrailerSize;
+    if (size < total) {
+        return fix_parse_status::Incomplete;
+    }
+    if (data[body_end] != '1' || data[body_end + 1] != '0' || data[body_end + 2] != '=' ||
+        data[total - 1] != kSoh) {
+        return fix_parse_status::Malformed;
+    }
+    consumed = total;
+
+    uint64_t expected = 0;
+    if (!parse_uint(data + body_end + 3, 3, expected) || expected != fix_checksum(data, body_end)) {
+        return fix_parse_status::BadChecksum;
+    }
+
+    // 正文逐字段切分：tag 数字直到 '='，值直到 SOH
+    out.data_ = data;
+    out.count_ = 0;
+    out.msg_type_ = std::string_view();
+    pos = body_begin;
+    while (pos < body_end) {
+        uint32_t field_tag = 0;
+        std::size_t cursor = pos;
+        while (cursor < body_end && data[cursor] != '=') {
+            const unsigned digit = static_cast<unsigned>(data[cursor] - '0');
+            if (digit > 9) {
+                return fix_parse_status::Malformed;
+            }
+            field_tag = field_tag * 10 + digit;
+            ++cursor;
+        }
+        if (cursor == pos || cursor == body_end) {
+            return fix_parse_status::Malformed;
+        }
+        const std::size_t value_begin = cursor + 1;
+        const void* value_end = std::memchr(data + value_begin, kSoh, body_end - value_begin);
+        if (value_end == nullptr) {
+            return fix_parse_status::Malformed;
+        }
+        const std::size_t value_size = static_cast<std::size_t>(static_cast<const char*>(value_end) - data) - value_begin;
+        if (field_tag == tag::MsgType) {
+            out.msg_type_ = std::string_view(data + value_begin, value_size);
+        }
+        if (out.count_ < kMaxMessageFields) {
+            fix_field& field = out.fields_[out.count_++];
+            field.tag = field_tag;
+            field.offset = static_cast<uint32_t>(value_begin);
+            field.length = static_cast<uint32_t>(value_size);
+        }
+        pos = value_begin + value_size + 1;
+    }
+    return out.msg_type_.empty() ? fix_parse_status::Malformed : fix_parse_status::Ok;
+}
+
+bool fix_template::compile(std::string_view begin_string, std::string_view pattern) noexcept {
+    part_count_ = 0;
+    literal_size_ = 0;
+    slot_mask_ = 0;
+    max_size_ = 0;
+    if (begin_string.empty() || begin_string.size() >= sizeof(begin_string_)) {
+        return false;
+    }
+    std::memcpy(begin_string_, begin_string.data(), begin_string.size());
+    begin_string_size_ = begin_string.size();
+
+    std::size_t body_max = 0;
+    std::size_t pos = 0;
+    while (pos < pattern.size()) {
+        if (part_count_ == kMaxParts) {
+            part_count_ = 0;
+            return false;
+        }
+        part& current = parts_[part_count_];
+        if (pattern[pos] == '$') {
+            std::size_t end = pos + 1;
+            while (end < pattern.size() && pattern[end] >= 'a' && pattern[end] <= 'z') {
+                ++end;
+            }
+            const std::string_view name = pattern.substr(pos + 1, end - pos - 1);
+            const slot_name* found = nullptr;
+            for (const slot_name& candidate : kSlotNames) {
+                if (candidate.name == name) {
+                    found = &candidate;
+                    break;
+                }
+            }
+            if (found == nullptr) {
+                part_count_ = 0;
+                return false;
+            }
+            current = part{};
+            current.slot = found->slot;
+            slot_mask_ |= 1U << static_cast<uint32_t>(found->slot);
+            body_max += found->max_bytes;
+            ++part_count_;
+            pos = end;
+            continue;
+        }
+
+        // 字面量段：到下一个占位符为止，'|' 换成 SOH
+        std::size_t end = pos;
+        while (end < pattern.size() && pattern[end] != '$') {
+            ++end;
+        }
+        const std::size_t length = end - pos;
+        if (literal_size_ + length > kMaxLiteralBytes) {
+            part_count_ = 0;
+            return false;
+        }
+        current = part{};
+        current.offset = static_cast<uint16_t>(literal_size_);
+        current.length = static_cast<uint16_t>(length);
+        for (std::size_t i = 0; i < length; ++i) {
+            literal_[literal_size_ + i] = pattern[pos + i] == '|' ? kSoh : pattern[pos + i];
+        }
+        current.sum = byte_sum(literal_ + literal_size_, length);
+        literal_size_ += length;
+        body_max += length;
+        ++part_count_;
+        pos = end;
+    }
+
+    // "8=" + BeginString + SOH + "9=" + 长度 + SOH + 正文 + "10=XXX" + SOH
+    max_size_ = 2 + begin_string_size_ + 1 + kBodyLengthFieldMax + body_max + kTrailerSize;
+    return part_count_ != 0;
+}
+
+std::size_t fix_template::render(char* out, std::size_t capacity, const fix_slot_values& values) const noexcept {
+    if (out == nullptr || part_count_ == 0 || capacity < max_size_) {
+        return 0;
+    }
+
+    // 先格式化本模板用到的占位符，得到正文长度后再一次写出整帧
+    char slot_text[static_cast<std::size_t>(fix_slot::Count)][kMaxSlotBytes];
+    std::size_t slot_size[static_cast<std::size_t>(fix_slot::Count)]{};
+    uint32_t slot_sum[static_cast<std::size_t>(fix_slot::Count)]{};
+    for (std::size_t i = 0; i < static_cast<std::size_t>(fix_slot::Count); ++i) {
+        if ((slot_mask_ & (1U << i)) == 0) {
+            continue;
+        }
+        char* text = slot_text[i];
+        std::size_t n = 0;
+        switch (static_cast<fix_slot>(i)) {
+            case fix_slot::SeqNum:
+                n = write_uint(values.seq_num, text);
+                break;
+            case fix_slot::SendingTime:
+                if (values.sending_time != nullptr) {
+                    std::memcpy(text, values.sending_time, kSendingTimeSize);
+                    n = kSendingTimeSize;
+                }
+                break;
+            case fix_slot::ClOrdId:
+                n = write_uint(values.cl_ord_id, text);
+                break;
+            case fix_slot::OrigClOrdId:
+                n = write_uint(values.orig_cl_ord_id, text);
+                break;
+            case fix_slot::Symbol:
+                n = write_view(values.symbol, text);
+                break;
+            case fix_slot::Exchange:
+                n = write_view(values.exchange, text);
+                break;
+            case fix_slot::Side:
+                text[0] = values.side;
+                n = 1;
+                break;
+            case fix_slot::OrderQty:
+                n = write_uint(values.order_qty, text);
+                break;
+            case fix_slot::Price:
+                n = write_cents(values.price_cents, text);
+                break;
+            case fix_slot::TestReqId:
+                n = write_view(values.test_req_id, text);
+                break;
+            default:
+                break;
+        }
+        slot_size[i] = n;
+        slot_sum[i] = byte_sum(text, n);
+    }
+
+    std::size_t body_length = literal_size_;
+    for (std::size_t i = 0; i < part_count_; ++i) {
+        if (parts_[i].slot != fix_slot::Count) {
+            body_length += slot_size[static_cast<std::size_t>(parts_[i].slot)];
+        }
+    }
+
+    std::size_t pos = 0;
+    out[pos++] = '8';
+    out[pos++] = '=';
+    std::memcpy(out + pos, begin_string_, begin_string_size_);
+    pos += begin_string_size_;
+    out[pos++] = kSoh;
+    out[pos++] = '9';
+    out[pos++] = '=';
+    pos += write_uint(body_length, out + pos);
+    out[pos++] = kSoh;
+    uint32_t sum = byte_sum(out, pos);
+
+    for (std::size_t i = 0; i < part_count_; ++i) {
+        const part& current = parts_[i];
+        if (current.slot == fix_slot::Count) {
+            std::memcpy(out + pos, literal_ + current.offset, current.length);
+            pos += current.length;
+            sum += current.sum;
+        } else {
+            const std::size_t index = static_cast<std::size_t>(current.slot);
+            std::memcpy(out + pos, slot_text[index], slot_size[index]);
+            pos += slot_size[index];
+            sum += slot_sum[index];
+        }
+    }
+
+    const uint32_t checksum = sum & 0xFFU;
+    out[pos++] = '1';
+    out[pos++] = '0';
+    out[pos++] = '=';
+    out[pos++] = static_cast<char>('0' + checksum / 100);
+    out[pos++] = static_cast<char>('0' + (checksum / 10) % 10);
+    out[pos++] = static_cast<char>('0' + checksum % 10);
+    out[pos++] = kSoh;
+    return pos;
+}
+
+void format_sending_time(TimestampNs ns, char* out) noexcept {
+    const time_t seconds = static_cast<time_t>(ns / 1000000000ULL);
+    const uint32_t millis = static_cast<uint32_t>((ns / 1000000ULL) % 1000ULL);
+    std::tm tm{};
+    gmtime_r(&seconds, &tm);
+    const uint32_t year = static_cast<uint32_t>(tm.tm_year + 1900);
+    const uint32_t fields[] = {static_cast<uint32_t>(tm.tm_mon + 1), static_cast<uint32_t>(tm.tm_mday),
+                               static_cast<uint32_t>(tm.tm_hour), static_cast<uint32_t>(tm.tm_min),
+                               static_cast<uint32_t>(tm.tm_sec)};
+    out[0] = static_cast<char>('0' + (year / 1000) % 10);
+    out[1] = static_cast<char>('0' + (year / 100) % 10);
+    out[2] = static_cast<char>('0' + (year / 10) % 10);
+    out[3] = static_cast<char>('0' + year % 10);
+    // MMDD-HH:MM:SS
+    static constexpr std::size_t kOffsets[] = {4, 6, 9, 12, 15};
+    for (std::size_t i = 0; i < 5; ++i) {
+        out[kOffsets[i]] = static_cast<char>('0' + fields[i] / 10);
+        out[kOffsets[i] + 1] = static_cast<char>('0' + fields[i] % 10);
+    }
+    out[8] = '-';
+    out[11] = ':';
+    out[14] = ':';
+    out[17] = '.';
+    out[18] = static_cast<char>('0' + millis / 100);
+    out[19] = static_cast<char>('0' + (millis / 10) % 10);
+    out[20] = static_cast<char>('0' + millis % 10);
+}
+
+uint32_t fix_checksum(const char* data, std::size_t size) noexcept { return byte_sum(data, size) & 0xFFU; }
+
+}  // namespace acct_service::gateway::fix
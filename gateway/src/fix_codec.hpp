@@ -0,0 +1,158 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+#include "common/types.hpp"
+
+namespace acct_service::gateway::fix {
+
+// 零分配 FIX tag=value 编解码：解码只在原缓冲区上记录字段偏移，编码按初始化期编译好的模板直接写入调用方缓冲区。
+
+inline constexpr char kSoh = '\x01';
+inline constexpr std::size_t kMaxMessageFields = 64;
+inline constexpr std::size_t kSendingTimeSize = 21;  // YYYYMMDD-HH:MM:SS.sss（UTC）
+
+namespace tag {
+inline constexpr uint32_t Account = 1;
+inline constexpr uint32_t BeginString = 8;
+inline constexpr uint32_t BodyLength = 9;
+inline constexpr uint32_t CheckSum = 10;
+inline constexpr uint32_t ClOrdID = 11;
+inline constexpr uint32_t Commission = 12;
+inline constexpr uint32_t CumQty = 14;
+inline constexpr uint32_t LastPx = 31;
+inline constexpr uint32_t LastQty = 32;
+inline constexpr uint32_t MsgSeqNum = 34;
+inline constexpr uint32_t MsgType = 35;
+inline constexpr uint32_t OrderID = 37;
+inline constexpr uint32_t OrderQty = 38;
+inline constexpr uint32_t OrdStatus = 39;
+inline constexpr uint32_t OrigClOrdID = 41;
+inline constexpr uint32_t Price = 44;
+inline constexpr uint32_t SenderCompID = 49;
+inline constexpr uint32_t SendingTime = 52;
+inline constexpr uint32_t Side = 54;
+inline constexpr uint32_t Symbol = 55;
+inline constexpr uint32_t TargetCompID = 56;
+inline constexpr uint32_t Text = 58;
+inline constexpr uint32_t HeartBtInt = 108;
+inline constexpr uint32_t TestReqID = 112;
+inline constexpr uint32_t ExecType = 150;
+inline constexpr uint32_t LeavesQty = 151;
+}  // namespace tag
+
+struct fix_field {
+    uint32_t tag = 0;
+    uint32_t offset = 0;  // 值在消息内的起始偏移
+    uint32_t length = 0;
+};
+
+enum class fix_parse_status : uint8_t {
+    Ok = 0,
+    Incomplete = 1,   // 缓冲区内还不是一条完整消息
+    BadChecksum = 2,  // 帧完整但校验和不符，consumed 为整帧长度，可跳过
+    Malformed = 3,    // 帧头无法识别，流已失步
+};
+
+class fix_message_view;
+
+// 从 data 头部解析一条消息；Ok / BadChecksum 时 consumed 为该帧字节数。字段超过 kMaxMessageFields 时多余字段被忽略。
+fix_parse_status fix_parse(const char* data, std::size_t size, fix_message_view& out, std::size_t& consumed) noexcept;
+
+// 一条已校验消息的字段视图；字段值指向被解析的缓冲区，缓冲区被覆盖前有效
+class fix_message_view {
+public:
+    std::string_view msg_type() const noexcept { return msg_type_; }
+    std::size_t field_count() const noexcept { return count_; }
+    const fix_field& field(std::size_t index) const noexcept { return fields_[index]; }
+
+    bool get(uint32_t tag, std::string_view& out) const noexcept;
+    bool get_char(uint32_t tag, char& out) const noexcept;
+    bool get_uint(uint32_t tag, uint64_t& out) const noexcept;
+    // 十进制数值换算为分（两位小数，第三位起四舍五入），用于价格与金额字段
+    bool get_cents(uint32_t tag, uint64_t& out) const noexcept;
+
+private:
+    friend fix_parse_status fix_parse(const char* data, std::size_t size, fix_message_view& out,
+                                      std::size_t& consumed) noexcept;
+
+    const char* data_ = nullptr;
+    std::string_view msg_type_;
+    fix_field fields_[kMaxMessageFields];
+    std::size_t count_ = 0;
+};
+
+// 模板占位符
+enum class fix_slot : uint8_t {
+    SeqNum = 0,      // $seq
+    SendingTime,     // $time
+    ClOrdId,         // $clordid
+    OrigClOrdId,     // $origclordid
+    Symbol,          // $symbol
+    Exchange,        // $exchange
+    Side,            // $side
+    OrderQty,        // $qty
+    Price,           // $price（分 -> 两位小数）
+    TestReqId,       // $testreqid
+    Count,
+};
+
+struct fix_slot_values {
+    uint64_t seq_num = 0;
+    const char* sending_time = nullptr;  // kSendingTimeSize 字节，由 format_sending_time 生成
+    uint32_t cl_ord_id = 0;
+    uint32_t orig_cl_ord_id = 0;
+    std::string_view symbol;
+    std::string_view exchange;
+    char side = '1';
+    uint64_t order_qty = 0;
+    uint64_t price_cents = 0;
+    std::string_view test_req_id;
+};
+
+// 预渲染消息模板：初始化期把 "35=D|49=S|56=T|34=$seq|..." 编译为字面量段与占位符序列（'|' 表示 SOH），
+// 字面量段的字节和预先算好；渲染时只格式化占位符，BodyLength 与 CheckSum 随写随算，不做二次扫描。
+class fix_template {
+public:
+    static constexpr std::size_t kMaxLiteralBytes = 512;
+    static constexpr std::size_t kMaxParts = 40;
+    static constexpr std::size_t kMaxSlotBytes = 32;
+
+    // 编译模板（仅初始化期调用）；占位符未知、字面量超长或段数过多返回 false
+    bool compile(std::string_view begin_string, std::string_view pattern) noexcept;
+
+    // 渲染完整消息（8= / 9= 头、正文与 10= 校验和）写入 out，返回字节数；容量不足 max_size() 时返回 0
+    std::size_t render(char* out, std::size_t capacity, const fix_slot_values& values) const noexcept;
+
+    // 单条渲染结果的字节上限，调用方据此判断发送缓冲余量
+    std::size_t max_size() const noexcept { return max_size_; }
+
+    bool compiled() const noexcept { return part_count_ != 0; }
+
+private:
+    struct part {
+        uint16_t offset = 0;
+        uint16_t length = 0;
+        uint32_t sum = 0;
+        fix_slot slot = fix_slot::Count;  // Count 表示字面量段
+    };
+
+    char begin_string_[16]{};
+    std::size_t begin_string_size_ = 0;
+    char literal_[kMaxLiteralBytes]{};
+    std::size_t literal_size_ = 0;
+    part parts_[kMaxParts]{};
+    std::size_t part_count_ = 0;
+    uint32_t slot_mask_ = 0;
+    std::size_t max_size_ = 0;
+};
+
+// UTC 时间格式化为 SendingTime/TransactTime（kSendingTimeSize 字节，不含结尾 '\0'）
+void format_sending_time(TimestampNs ns, char* out) noexcept;
+
+// 消息字节和 mod 256 的三位十进制校验和
+uint32_t fix_checksum(const char* data, std::size_t size) noexcept;
+
+}  // namespace acct_service::gateway::fix
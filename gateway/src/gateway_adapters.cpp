@@ -0,0 +1,68 @@
+#include "gateway_adapters.hpp"
+
+#include <string>
+
+namespace acct_service::gateway {
+
+gateway_adapter_set::~gateway_adapter_set() { shutdown(); }
+
+bool gateway_adapter_set::create(const gateway_config& config, std::string& error_message) {
+    shutdown();
+    plugin_adapters_.resize(config.adapter_shards);
+
+    // 支持两种适配器模式：内置 sim 或外部插件。
+    for (uint32_t shard = 0; shard < config.adapter_shards; ++shard) {
+        if (config.broker_type == "sim") {
+            // 各会话用不同种子，避免多分片时成交节奏完全同步
+            sim_fill_model model;
+            model.fill_latency_us = config.sim_fill_latency_us;
+            model.fill_jitter_us = config.sim_fill_jitter_us;
+            model.partial_fill_pct = config.sim_partial_fill_pct;
+            model.partial_fill_slices = config.sim_partial_fill_slices;
+            model.reject_pct = config.sim_reject_pct;
+            model.seed = static_cast<uint64_t>(config.sim_seed) + shard;
+            model.max_active_orders = config.sim_max_active_orders;
+            sim_adapters_.push_back(std::make_unique<sim_broker_adapter>(model));
+            adapters_.push_back(sim_adapters_.back().get());
+        } else if (config.broker_type == "plugin") {
+            std::string load_error;
+            if (!load_adapter_plugin(config.adapter_plugin_so, plugin_adapters_[shard], load_error)) {
+                error_message = "failed to load adapter plugin: " + load_error;
+                return false;
+            }
+            adapters_.push_back(plugin_adapters_[shard].get());
+        } else {
+            error_message = "unsupported broker_type: " + config.broker_type;
+            return false;
+        }
+    }
+    return true;
+}
+
+bool gateway_adapter_set::initialize(AccountId account_id, std::string& error_message) {
+    for (uint32_t shard = 0; shard < adapters_.size(); ++shard) {
+        broker_api::broker_runtime_config runtime_config;
+        runtime_config.account_id = account_id;
+        runtime_config.auto_fill = true;
+        runtime_config.session_index = shard;
+        if (!adapters_[shard] || !adapters_[shard]->initialize(runtime_config)) {
+            error_message = "failed to initialize broker adapter (session " + std::to_string(shard) + ")";
+            shutdown();
+            return false;
+        }
+        ++initialized_;
+    }
+    return true;
+}
+
+void gateway_adapter_set::shutdown() noexcept {
+    for (std::size_t i = 0; i < initialized_; ++i) {
+        adapters_[i]->shutdown();
+    }
+    initialized_ = 0;
+    adapters_.clear();
+    sim_adapters_.clear();
+    plugin_adapters_.clear();
+}
+
+}  // namespace acct_service::gateway
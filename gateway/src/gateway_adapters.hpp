@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "adapter_loader.hpp"
+#include "broker_api/broker_api.hpp"
+#include "gateway_config.hpp"
+#include "sim_broker_adapter.hpp"
+
+namespace acct_service::gateway {
+
+// 按网关配置创建的一组适配器实例（每个分片一个柜台会话），独立网关进程与进程内网关共用。
+class gateway_adapter_set {
+public:
+    gateway_adapter_set() = default;
+    ~gateway_adapter_set();
+
+    gateway_adapter_set(const gateway_adapter_set&) = delete;
+    gateway_adapter_set& operator=(const gateway_adapter_set&) = delete;
+
+    // 按 broker_type 创建 adapter_shards 个内置 sim 适配器或插件实例；插件重复 dlopen 同一 .so 由动态链接器引用计数。
+    bool create(const gateway_config& config, std::string& error_message);
+    // 逐个会话初始化，session_index 为分片序号；任一失败时回收已初始化的会话。
+    bool initialize(AccountId account_id, std::string& error_message);
+    // 关闭已初始化的会话、释放适配器并卸载插件，可重复调用。
+    void shutdown() noexcept;
+
+    const std::vector<broker_api::IBrokerAdapter*>& adapters() const noexcept { return adapters_; }
+
+private:
+    std::vector<broker_api::IBrokerAdapter*> adapters_;
+    std::vector<std::unique_ptr<sim_broker_adapter>> sim_adapters_;
+    std::vector<loaded_adapter> plugin_adapters_;
+    std::size_t initialized_ = 0;
+};
+
+}  // namespace acct_service::gateway
@@ -11,6 +11,8 @@
 
 #include <yaml-cpp/yaml.h>
 
+#include "common/thread_setup.hpp"
+
 namespace acct_service::gateway {
 
 namespace {
@@ -20,6 +22,7 @@ constexpr const char* kDefaultGatewayConfigPath = "config/gateway.yaml";
 enum class GatewayConfigParseError {
     InvalidBool,
     InvalidU32,
+    InvalidI32,
     InvalidTradingDay,
     NonPositiveValue,
     OutOfRange,
@@ -32,6 +35,8 @@ const char* gateway_config_parse_error_message(GatewayConfigParseError error) no
             return "invalid boolean value";
         case GatewayConfigParseError::InvalidU32:
             return "invalid uint32 value";
+        case GatewayConfigParseError::InvalidI32:
+            return "invalid int32 value";
         case GatewayConfigParseError::InvalidTradingDay:
             return "invalid trading day";
         case GatewayConfigParseError::NonPositiveValue:
@@ -95,6 +100,11 @@ std::expected<uint32_t, GatewayConfigParseError> parse_u32(std::string_view text
     return parse_integral<uint32_t>(text, GatewayConfigParseError::InvalidU32);
 }
 
+// 解析 int32 参数（绑核编号允许 -1 表示不绑）。
+std::expected<int32_t, GatewayConfigParseError> parse_i32(std::string_view text) {
+    return parse_integral<int32_t>(text, GatewayConfigParseError::InvalidI32);
+}
+
 // 解析布尔参数（支持常见文本形式）。
 std::expected<bool, GatewayConfigParseError> parse_bool(std::string_view raw_text) {
     std::string text = trim_copy(std::string(raw_text));
@@ -186,6 +196,10 @@ std::expected<void, GatewayConfigParseError> apply_config_value(
         config.orders_shm_name = value;
         return {};
     }
+    if (key == "stats_shm" || key == "stats_shm_name") {
+        config.stats_shm_name = value;
+        return {};
+    }
 
     if (key == "trading_day") {
         if (!is_valid_trading_day(value)) {
@@ -224,10 +238,38 @@ std::expected<void, GatewayConfigParseError> apply_config_value(
         return assign_parsed(parse_u32(value), config.idle_sleep_us);
     }
 
+    if (key == "adaptive_idle") {
+        return assign_parsed(parse_bool(value), config.adaptive_idle);
+    }
+
+    if (key == "idle_spin_iterations") {
+        return assign_parsed(parse_u32(value), config.idle_spin_iterations);
+    }
+
+    if (key == "idle_yield_iterations") {
+        return assign_parsed(parse_u32(value), config.idle_yield_iterations);
+    }
+
+    if (key == "idle_park_timeout_us") {
+        const auto parsed = parse_u32(value);
+        if (!parsed) {
+            return std::unexpected(parsed.error());
+        }
+        if (*parsed == 0) {
+            return std::unexpected(GatewayConfigParseError::NonPositiveValue);
+        }
+        config.idle_park_timeout_us = *parsed;
+        return {};
+    }
+
     if (key == "stats_interval_ms") {
         return assign_parsed(parse_u32(value), config.stats_interval_ms);
     }
 
+    if (key == "queue_depth_sample_iterations") {
+        return assign_parsed(parse_u32(value), config.queue_depth_sample_iterations);
+    }
+
     if (key == "max_retries" || key == "max_retry_attempts") {
         return assign_parsed(parse_u32(value), config.max_retry_attempts);
     }
@@ -236,9 +278,205 @@ std::expected<void, GatewayConfigParseError> apply_config_value(
         return assign_parsed(parse_u32(value), config.retry_interval_us);
     }
 
+    if (key == "adapter_shards") {
+        const auto parsed = parse_u32(value);
+        if (!parsed) {
+            return std::unexpected(parsed.error());
+        }
+        if (*parsed == 0) {
+            return std::unexpected(GatewayConfigParseError::NonPositiveValue);
+        }
+        if (*parsed > kMaxAdapterShards) {
+            return std::unexpected(GatewayConfigParseError::OutOfRange);
+        }
+        config.adapter_shards = *parsed;
+        return {};
+    }
+
+    if (key == "broker_rate_limit" || key == "broker_rate_limits") {
+        // 逗号分隔的每会话上限，单个值对所有会话生效
+        std::vector<uint32_t> limits;
+        std::string_view rest = value;
+        while (true) {
+            const std::size_t comma = rest.find(',');
+            const auto parsed = parse_u32(rest.substr(0, comma));
+            if (!parsed) {
+                return std::unexpected(parsed.error());
+            }
+            limits.push_back(*parsed);
+            if (comma == std::string_view::npos) {
+                break;
+            }
+            rest.remove_prefix(comma + 1);
+        }
+        if (limits.size() > kMaxAdapterShards) {
+            return std::unexpected(GatewayConfigParseError::OutOfRange);
+        }
+        config.broker_rate_limits = std::move(limits);
+        return {};
+    }
+    if (key == "broker_rate_burst_ms") {
+        const auto parsed = parse_u32(value);
+        if (!parsed) {
+            return std::unexpected(parsed.error());
+        }
+        if (*parsed == 0) {
+            return std::unexpected(GatewayConfigParseError::NonPositiveValue);
+        }
+        if (*parsed > 1000) {
+            return std::unexpected(GatewayConfigParseError::OutOfRange);
+        }
+        config.broker_rate_burst_ms = *parsed;
+        return {};
+    }
+    if (key == "broker_cancel_reserve_pct") {
+        const auto parsed = parse_u32(value);
+        if (!parsed) {
+            return std::unexpected(parsed.error());
+        }
+        if (*parsed > 100) {
+            return std::unexpected(GatewayConfigParseError::OutOfRange);
+        }
+        config.broker_cancel_reserve_pct = *parsed;
+        return {};
+    }
+
+    if (key == "adapter_poll_thread") {
+        return assign_parsed(parse_bool(value), config.adapter_poll_thread);
+    }
+    if (key == "direct_responses") {
+        return assign_parsed(parse_bool(value), config.direct_responses);
+    }
+    if (key == "coalesce_fills") {
+        return assign_parsed(parse_bool(value), config.coalesce_fills);
+    }
+
+    if (key == "main_cpu_core" || key == "adapter_poll_cpu_core") {
+        const auto parsed = parse_i32(value);
+        if (!parsed) {
+            return std::unexpected(parsed.error());
+        }
+        if (*parsed < -1) {
+            return std::unexpected(GatewayConfigParseError::OutOfRange);
+        }
+        (key == "main_cpu_core" ? config.main_cpu_core : config.adapter_poll_cpu_core) = *parsed;
+        return {};
+    }
+    if (key == "main_priority" || key == "adapter_poll_priority") {
+        const auto parsed = parse_i32(value);
+        if (!parsed) {
+            return std::unexpected(parsed.error());
+        }
+        if (*parsed < 0 || *parsed > kMaxFifoPriority) {
+            return std::unexpected(GatewayConfigParseError::OutOfRange);
+        }
+        (key == "main_priority" ? config.main_priority : config.adapter_poll_priority) = *parsed;
+        return {};
+    }
+    if (key == "lock_memory") {
+        return assign_parsed(parse_bool(value), config.lock_memory);
+    }
+    if (key == "warm_restart") {
+        return assign_parsed(parse_bool(value), config.warm_restart);
+    }
+
+    if (key == "sim_fill_latency_us") {
+        return assign_parsed(parse_u32(value), config.sim_fill_latency_us);
+    }
+    if (key == "sim_fill_jitter_us") {
+        return assign_parsed(parse_u32(value), config.sim_fill_jitter_us);
+    }
+    if (key == "sim_seed") {
+        return assign_parsed(parse_u32(value), config.sim_seed);
+    }
+
+    if (key == "sim_partial_fill_pct" || key == "sim_reject_pct") {
+        const auto parsed = parse_u32(value);
+        if (!parsed) {
+            return std::unexpected(parsed.error());
+        }
+        if (*parsed > 100) {
+            return std::unexpected(GatewayConfigParseError::OutOfRange);
+        }
+        (key == "sim_partial_fill_pct" ? config.sim_partial_fill_pct : config.sim_reject_pct) = *parsed;
+        return {};
+    }
+
+    if (key == "sim_partial_fill_slices") {
+        const auto parsed = parse_u32(value);
+        if (!parsed) {
+            return std::unexpected(parsed.error());
+        }
+        if (*parsed < 2 || *parsed > kSimMaxFillSlices) {
+            return std::unexpected(GatewayConfigParseError::OutOfRange);
+        }
+        config.sim_partial_fill_slices = *parsed;
+        return {};
+    }
+
+    if (key == "sim_max_active_orders") {
+        const auto parsed = parse_u32(value);
+        if (!parsed) {
+            return std::unexpected(parsed.error());
+        }
+        if (*parsed == 0) {
+            return std::unexpected(GatewayConfigParseError::NonPositiveValue);
+        }
+        config.sim_max_active_orders = *parsed;
+        return {};
+    }
+
     return std::unexpected(GatewayConfigParseError::UnknownKey);
 }
 
+// 解析多账户列表：每项为 {account_id, downstream_shm, trades_shm, orders_shm} 标量映射。
+bool load_account_bindings(const YAML::Node& node, gateway_config& config, std::string& error_message) {
+    if (!node.IsSequence()) {
+        error_message = "gateway config accounts must be a YAML sequence";
+        return false;
+    }
+    config.accounts.clear();
+    for (const auto& item : node) {
+        if (!item.IsMap()) {
+            error_message = "gateway config accounts entry must be a YAML map";
+            return false;
+        }
+        gateway_account_binding binding;
+        for (const auto& field : item) {
+            std::string key;
+            std::string value;
+            try {
+                key = field.first.as<std::string>();
+                value = trim_copy(field.second.as<std::string>());
+            } catch (const YAML::Exception& ex) {
+                error_message = std::string("failed to parse gateway accounts field: ") + ex.what();
+                return false;
+            }
+
+            if (key == "account_id") {
+                const auto parsed = parse_u32(value);
+                if (!parsed || *parsed == 0) {
+                    error_message = make_invalid_value_message(
+                        "accounts.account_id", parsed ? GatewayConfigParseError::NonPositiveValue : parsed.error());
+                    return false;
+                }
+                binding.account_id = static_cast<AccountId>(*parsed);
+            } else if (key == "downstream_shm" || key == "downstream_shm_name") {
+                binding.downstream_shm_name = value;
+            } else if (key == "trades_shm" || key == "trades_shm_name") {
+                binding.trades_shm_name = value;
+            } else if (key == "orders_shm" || key == "orders_shm_name") {
+                binding.orders_shm_name = value;
+            } else {
+                error_message = "unknown gateway accounts key: " + key;
+                return false;
+            }
+        }
+        config.accounts.push_back(std::move(binding));
+    }
+    return true;
+}
+
 bool load_config_yaml(const std::string& config_path, gateway_config& config, std::string& error_message) {
     if (config_path.empty()) {
         error_message = "empty --config path";
@@ -264,9 +502,15 @@ bool load_config_yaml(const std::string& config_path, gateway_config& config, st
     }
 
     static constexpr std::string_view kAllowedKeys[] = {"account_id", "downstream_shm", "downstream_shm_name",
-        "trades_shm", "trades_shm_name", "orders_shm", "orders_shm_name", "trading_day", "broker_type",
-        "adapter_so", "adapter_plugin_so", "create_if_not_exist", "poll_batch_size", "idle_sleep_us",
-        "stats_interval_ms", "max_retries", "max_retry_attempts", "retry_interval_us"};
+        "trades_shm", "trades_shm_name", "orders_shm", "orders_shm_name", "stats_shm", "stats_shm_name",
+        "trading_day", "broker_type", "adapter_so", "adapter_plugin_so", "create_if_not_exist", "poll_batch_size",
+        "idle_sleep_us", "adaptive_idle", "idle_spin_iterations", "idle_yield_iterations", "idle_park_timeout_us",
+        "stats_interval_ms", "queue_depth_sample_iterations", "max_retries", "max_retry_attempts", "retry_interval_us",
+        "adapter_poll_thread", "direct_responses", "coalesce_fills", "main_cpu_core", "adapter_poll_cpu_core",
+        "main_priority", "adapter_poll_priority", "lock_memory", "warm_restart", "adapter_shards", "broker_rate_limit",
+        "broker_rate_limits", "broker_rate_burst_ms", "broker_cancel_reserve_pct", "sim_fill_latency_us",
+        "sim_fill_jitter_us", "sim_partial_fill_pct", "sim_partial_fill_slices", "sim_reject_pct", "sim_seed",
+        "sim_max_active_orders"};
 
     for (const auto& entry : root) {
         const YAML::Node key_node = entry.first;
@@ -276,6 +520,12 @@ bool load_config_yaml(const std::string& config_path, gateway_config& config, st
             error_message = "gateway config key must be scalar";
             return false;
         }
+        if (key_node.as<std::string>() == "accounts") {
+            if (!load_account_bindings(value_node, config, error_message)) {
+                return false;
+            }
+            continue;
+        }
         if (!value_node.IsScalar()) {
             std::string key_text;
             try {
@@ -334,11 +584,55 @@ bool validate_config(const gateway_config& config, std::string& error_message) {
         return false;
     }
 
+    if (config.broker_rate_limits.size() > 1 && config.broker_rate_limits.size() != config.adapter_shards) {
+        error_message = "broker_rate_limit must list one value or one per adapter shard";
+        return false;
+    }
+
+    if (config.accounts.size() > kMaxGatewayAccounts) {
+        error_message = "too many gateway accounts (max " + std::to_string(kMaxGatewayAccounts) + ")";
+        return false;
+    }
+    for (std::size_t i = 0; i < config.accounts.size(); ++i) {
+        const gateway_account_binding& binding = config.accounts[i];
+        if (binding.account_id == 0 || binding.downstream_shm_name.empty() || binding.trades_shm_name.empty() ||
+            binding.orders_shm_name.empty()) {
+            error_message = "gateway accounts entry requires account_id, downstream_shm, trades_shm and orders_shm";
+            return false;
+        }
+        // 同一账户或同一队列挂载两次会让两条通道互相抢消费
+        for (std::size_t j = 0; j < i; ++j) {
+            const gateway_account_binding& other = config.accounts[j];
+            if (other.account_id == binding.account_id || other.downstream_shm_name == binding.downstream_shm_name ||
+                other.trades_shm_name == binding.trades_shm_name || other.orders_shm_name == binding.orders_shm_name) {
+                error_message = "gateway accounts must have distinct account_id and shm names";
+                return false;
+            }
+        }
+    }
+
     return true;
 }
 
 }  // namespace
 
+bool load_gateway_config(const std::string& config_path, gateway_config& config, std::string& error_message) {
+    error_message.clear();
+    return load_config_yaml(config_path, config, error_message) && validate_config(config, error_message);
+}
+
+std::vector<gateway_account_binding> resolve_gateway_accounts(const gateway_config& config) {
+    if (!config.accounts.empty()) {
+        return config.accounts;
+    }
+    gateway_account_binding binding;
+    binding.account_id = config.account_id;
+    binding.downstream_shm_name = config.downstream_shm_name;
+    binding.trades_shm_name = config.trades_shm_name;
+    binding.orders_shm_name = config.orders_shm_name;
+    return {binding};
+}
+
 // 打印网关命令行参数说明。
 void print_usage(const char* program) {
     std::fprintf(stderr,
@@ -1,11 +1,28 @@
 #pragma once
 
+#include <cstddef>
 #include <string>
+#include <vector>
 
 #include "common/types.hpp"
 
 namespace acct_service::gateway {
 
+// 单个网关进程可挂载的适配器分片（柜台会话）上限。
+inline constexpr std::size_t kMaxAdapterShards = 16;
+// 单个网关进程可挂载的账户（下游/回报队列对）上限，账户序号占会话订单号高 4 位。
+inline constexpr std::size_t kMaxGatewayAccounts = 16;
+// sim 适配器分片成交的片数上限。
+inline constexpr uint32_t kSimMaxFillSlices = 16;
+
+// 一个挂载账户的共享内存名（orders_shm 为基础名，按 trading_day 加日期后缀）。
+struct gateway_account_binding {
+    AccountId account_id = 0;
+    std::string downstream_shm_name;
+    std::string trades_shm_name;
+    std::string orders_shm_name;
+};
+
 // gateway 运行时配置（命令行解析结果）。
 struct gateway_config {
     std::string config_file;
@@ -13,17 +30,53 @@ struct gateway_config {
     std::string downstream_shm_name = "/downstream_order_shm";
     std::string trades_shm_name = "/trades_shm";
     std::string orders_shm_name = "/orders_shm";
+    std::string stats_shm_name;  // 独立网关的统计段（往返延迟直方图与 gateway.* 指标），空时不导出；进程内网关写宿主统计段
     std::string trading_day = "19700101";
     std::string broker_type = "sim";
     std::string adapter_plugin_so;
     bool create_if_not_exist = false;
     uint32_t poll_batch_size = 64;
     uint32_t idle_sleep_us = 50;
+    bool adaptive_idle = false;           // 空闲分级退避（自旋 -> yield -> 门铃挂起），开启后忽略 idle_sleep_us
+    uint32_t idle_spin_iterations = 2000;  // 退避自旋轮数
+    uint32_t idle_yield_iterations = 200;  // 退避 sched_yield 轮数
+    uint32_t idle_park_timeout_us = 1000;  // 单次挂起上限（微秒），也是适配器事件的最大感知延迟
     uint32_t stats_interval_ms = 1000;
+    uint32_t queue_depth_sample_iterations = 64;  // 每隔这么多轮采样一次下游队列深度写入统计段直方图，0 关闭
     uint32_t max_retry_attempts = 3;
     uint32_t retry_interval_us = 200;
+    bool adapter_poll_thread = false;  // 独立线程拉取适配器事件，经进程内 SPSC 环交给主循环发布回报
+    bool direct_responses = true;      // 适配器支持时经 response_writer 原地写回报；false 时一律走 poll_events
+    bool coalesce_fills = false;       // 同一批内同一订单的相邻成交合并为一条回报，逐笔明细写 debug 日志
+    int main_cpu_core = -1;            // 主循环线程绑核，-1 表示不绑
+    int adapter_poll_cpu_core = -1;    // 适配器轮询线程绑核，-1 表示不绑；多分片时第 i 个线程绑 core + i
+    int main_priority = 0;             // 主循环线程 SCHED_FIFO 优先级 1-99，0 保持默认调度
+    int adapter_poll_priority = 0;     // 适配器轮询线程 SCHED_FIFO 优先级，0 保持默认调度
+    bool lock_memory = false;          // 独立进程启动时 mlockall(MCL_CURRENT|MCL_FUTURE)；进程内网关由账户服务决定
+    uint32_t adapter_shards = 1;       // 适配器实例（柜台会话）数，订单按证券哈希分片
+    bool warm_restart = false;         // 启动时从订单池重建已出队未终态的在途新单并交给适配器 recover
+    // 柜台报单节流：每会话一个令牌桶，令牌不足的新单在网关内按序排队，撤单用预留份额优先通过
+    std::vector<uint32_t> broker_rate_limits;  // 每秒消息上限：一项时各会话共用，多项时按会话序号，0 或为空不节流
+    uint32_t broker_rate_burst_ms = 10;        // 桶深 = 上限 * burst_ms / 1000 个令牌（至少 1 个）
+    uint32_t broker_cancel_reserve_pct = 20;   // 桶深中只给撤单使用的百分比
+    // 内置 sim 适配器的成交模型（broker_type=sim 生效），全部为 0 时受理即全额成交
+    uint32_t sim_fill_latency_us = 0;       // 受理到每片成交的基础延迟
+    uint32_t sim_fill_jitter_us = 0;        // 每片叠加 [0, jitter] 的均匀抖动
+    uint32_t sim_partial_fill_pct = 0;      // 分片成交的订单占比 0-100
+    uint32_t sim_partial_fill_slices = 2;   // 分片成交的片数 2-16
+    uint32_t sim_reject_pct = 0;            // 柜台拒单占比 0-100
+    uint32_t sim_seed = 1;                  // 成交模型随机种子，相同种子与请求序列回报完全一致
+    uint32_t sim_max_active_orders = 16384;  // 每个会话的在途新单池容量（预分配）
+    // 多账户共用柜台会话时的账户列表；为空时只挂载上面 account_id 与三个 shm 名描述的单个账户。
+    // 非空时 account_id 仅作为柜台会话账户下发给适配器
+    std::vector<gateway_account_binding> accounts;
 };
 
+// 从 YAML 文件加载并校验网关配置（进程内网关复用，不经过命令行）。
+bool load_gateway_config(const std::string& config_path, gateway_config& config, std::string& error_message);
+// 实际挂载的账户列表：accounts 为空时由单账户字段合成一项。
+std::vector<gateway_account_binding> resolve_gateway_accounts(const gateway_config& config);
+
 enum class parse_result_t {
     Ok,
     Help,
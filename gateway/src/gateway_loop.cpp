@@ -2,6 +2,7 @@
 
 #include <algorithm>
 #include <array>
+#include <bit>
 #include <chrono>
 #include <cstdio>
 #include <cstring>
@@ -10,6 +11,7 @@
 #include "common/error.hpp"
 #include "common/log.hpp"
 #include "common/security_identity.hpp"
+#include "common/thread_setup.hpp"
 #include "order_mapper.hpp"
 #include "response_mapper.hpp"
 #include "shm/orders_shm.hpp"
@@ -18,91 +20,588 @@ namespace acct_service::gateway {
 
 namespace {
 
-// 回报队列写入失败时的本地重试次数。
+// 溢出环也写满时的本地重试次数。
 constexpr uint32_t kResponsePushAttempts = 3;
+// 重试时间轮精度与预分配槽位数：柜台抖动时积压数千笔也无需分配。
+constexpr TimestampNs kRetryTimerResolutionNs = 10000;
+constexpr std::size_t kRetryPoolCapacity = 4096;
+// 单轮从下游队列搬运并提交的订单上限。
+constexpr std::size_t kMaxOrderBatch = 256;
+// 单次拉取/发布的适配器事件上限。
+constexpr std::size_t kMaxEventBatch = 256;
+// 多分片时在途新单 -> 分片映射容量；表满时撤单回落到证券哈希（与原单一致，除非撤单未带证券）。
+constexpr std::size_t kOrderShardCapacity = 65536;
+// 证券转换缓存可登记的证券数，覆盖全市场股票；登记满后新证券逐笔转换且不携带令牌。
+constexpr std::size_t kSecurityCacheCapacity = 8192;
+// 往返延迟跟踪的在途新单容量；表满时新单不计入直方图，不影响报单。
+constexpr std::size_t kOrderRttCapacity = 65536;
+// 每个开启节流的会话可排队等待令牌的请求数；剩余空间不足一轮搬运量时暂停搬运下游新单。
+constexpr std::size_t kPacedCapacity = 4096;
+// 统计段指标的发布间隔。
+constexpr TimestampNs kMetricsPublishIntervalNs = 100'000'000;
+
+static_assert(kMaxAdapterShards <= kMaxBrokerSessions, "broker latency table must cover every adapter shard");
+
+// FNV-1a 证券哈希：跨进程重启稳定，同一证券始终落在同一分片。
+uint32_t hash_security_id(const char* security_id, std::size_t capacity) noexcept {
+    uint32_t hash = 2166136261U;
+    for (std::size_t i = 0; i < capacity && security_id[i] != '\0'; ++i) {
+        hash ^= static_cast<uint8_t>(security_id[i]);
+        hash *= 16777619U;
+    }
+    return hash;
+}
+
+// 终态事件之后不会再有该单的撤单需要路由。
+bool is_terminal_event(broker_api::event_kind kind) noexcept {
+    return kind == broker_api::event_kind::Finished || kind == broker_api::event_kind::BrokerRejected ||
+           kind == broker_api::event_kind::MarketRejected;
+}
+
+bool is_terminal_state(OrderState state) noexcept {
+    return state == OrderState::Finished || state == OrderState::BrokerRejected || state == OrderState::MarketRejected;
+}
+
+// 同一订单相邻两笔成交能否合并：账户侧按累计金额 / 累计数量回推均价，金额缺失时只有同价才能合并。
+bool can_coalesce_fill(const TradeResponse& into, const TradeResponse& next) noexcept {
+    if (into.new_state != OrderState::MarketAccepted || next.new_state != OrderState::MarketAccepted ||
+        into.internal_order_id != next.internal_order_id) {
+        return false;
+    }
+    if (into.dvalue_traded > 0 && next.dvalue_traded > 0) {
+        return true;
+    }
+    return into.dvalue_traded == 0 && next.dvalue_traded == 0 && into.dprice_traded == next.dprice_traded;
+}
+
+// 单笔成交明细日志：合并后账户侧只见汇总，逐笔价位留在网关日志里。
+void log_coalesced_fill(const TradeResponse& fill) {
+    ACCT_LOG_DEBUG("gateway_loop", "coalesced fill order=" + std::to_string(fill.internal_order_id) +
+                                       " broker=" + std::to_string(fill.broker_order_id) +
+                                       " volume=" + std::to_string(fill.volume_traded) +
+                                       " price=" + std::to_string(fill.dprice_traded) +
+                                       " value=" + std::to_string(fill.dvalue_traded) +
+                                       " fee=" + std::to_string(fill.dfee) +
+                                       " md_time=" + std::to_string(fill.md_time_traded));
+}
 
 }  // namespace
 
+// 直写句柄：claim 在分片回报环上跳过已发布未提交的槽位原地申请，publish 只记账，poll_responses 返回后由网关整批 commit。
+struct gateway_loop::response_sink {
+    response_ring* queue = nullptr;
+    TradeResponse* claimed = nullptr;
+    std::size_t claimed_count = 0;
+    std::size_t published = 0;  // 适配器发布的条数，含校验丢弃项
+    std::size_t pending = 0;    // 已发布、待 commit 的条数
+
+    static std::size_t claim(void* context, std::size_t max_count,
+                             broker_api::trade_response_record** out_slots) noexcept {
+        response_sink& self = *static_cast<response_sink*>(context);
+        if (out_slots == nullptr) {
+            return 0;
+        }
+        TradeResponse* first = nullptr;
+        self.claimed_count = self.queue->try_claim(self.pending, max_count, first);
+        self.claimed = first;
+        *out_slots = first != nullptr ? as_response_records(first) : nullptr;
+        return self.claimed_count;
+    }
+
+    static void publish(void* context, std::size_t count) noexcept {
+        response_sink& self = *static_cast<response_sink*>(context);
+        count = std::min(count, self.claimed_count);
+        self.published += count;
+        self.pending += count;
+        self.claimed_count = 0;
+    }
+
+    broker_api::response_writer writer() noexcept { return broker_api::response_writer{this, &claim, &publish}; }
+};
+
 gateway_loop::gateway_loop(const gateway_config& config, downstream_shm_layout* downstream_shm,
                            trades_shm_layout* trades_shm, orders_shm_layout* orders_shm,
                            broker_api::IBrokerAdapter& adapter)
+    : gateway_loop(config, downstream_shm, trades_shm, orders_shm, std::vector<broker_api::IBrokerAdapter*>{&adapter}) {}
+
+gateway_loop::gateway_loop(const gateway_config& config, downstream_shm_layout* downstream_shm,
+                           trades_shm_layout* trades_shm, orders_shm_layout* orders_shm,
+                           std::vector<broker_api::IBrokerAdapter*> adapters)
+    : gateway_loop(config,
+                   std::vector<gateway_account_lane>{
+                       gateway_account_lane{config.account_id, downstream_shm, trades_shm, orders_shm, {}}},
+                   std::move(adapters)) {}
+
+gateway_loop::gateway_loop(const gateway_config& config, std::vector<gateway_account_lane> lanes,
+                           std::vector<broker_api::IBrokerAdapter*> adapters)
     : config_(config),
-      downstream_shm_(downstream_shm),
-      trades_shm_(trades_shm),
-      orders_shm_(orders_shm),
-      adapter_(adapter) {}
+      lanes_(std::move(lanes)),
+      shards_(adapters.size()),
+      order_shards_(adapters.size() > 1 ? kOrderShardCapacity : 1),
+      security_cache_(kSecurityCacheCapacity, &gateway_loop::resolve_security_token, this),
+      idle_backoff_(idle_policy{config.idle_spin_iterations, config.idle_yield_iterations,
+                                config.idle_park_timeout_us}),
+      retry_timers_(kRetryTimerResolutionNs, kRetryPoolCapacity),
+      order_rtt_(kOrderRttCapacity),
+      local_broker_latency_(std::make_unique<broker_latency_stats>()),
+      broker_latency_(local_broker_latency_.get()) {
+    retry_items_.resize(kRetryPoolCapacity);
+    retry_free_slots_.reserve(kRetryPoolCapacity);
+    for (std::size_t slot = kRetryPoolCapacity; slot > 0; --slot) {
+        retry_free_slots_.push_back(static_cast<uint32_t>(slot - 1));
+    }
+    for (std::size_t shard = 0; shard < adapters.size(); ++shard) {
+        shards_[shard].adapter = adapters[shard];
+        // 单个上限对各会话生效，否则按会话序号取；节流环只为开启节流的会话预分配
+        const std::vector<uint32_t>& limits = config.broker_rate_limits;
+        const uint32_t limit = limits.size() == 1 ? limits[0] : (shard < limits.size() ? limits[shard] : 0);
+        shards_[shard].pacer.configure(limit, config.broker_rate_burst_ms, config.broker_cancel_reserve_pct);
+        if (shards_[shard].pacer.enabled()) {
+            shards_[shard].paced.resize(kPacedCapacity);
+        }
+    }
+    // 回报溢出环按账户预分配，账户服务停顿时暂存回报，不在热路径上分配
+    response_spills_.reserve(lanes_.size());
+    for (std::size_t lane = 0; lane < lanes_.size(); ++lane) {
+        response_spills_.push_back(std::make_unique<response_spill>());
+        response_spills_.back()->init();
+    }
+    stats_.shard_count = static_cast<uint32_t>(shards_.size());
+    stats_.account_count = static_cast<uint32_t>(lanes_.size());
+    // 账户序号占高 bit_width(n-1) 位：2 个账户 1 位，16 个账户 4 位；单账户不编码
+    if (lanes_.size() > 1) {
+        lane_shift_ = 32 - static_cast<uint32_t>(std::bit_width(lanes_.size() - 1));
+    }
+}
 
 int gateway_loop::run() {
-    // 启动前先校验共享内存依赖。
-    if (!downstream_shm_ || !trades_shm_ || !orders_shm_) {
-        ErrorStatus status = ACCT_MAKE_ERROR(ErrorDomain::core, ErrorCode::ComponentUnavailable, "gateway_loop",
-                                             "shared memory not available", 0);
-        record_error(status);
-        ACCT_LOG_ERROR_STATUS(status);
+    if (!started_ && !start()) {
         return 1;
     }
+    (void)apply_thread_realtime("gateway_main", thread_realtime_config{config_.main_cpu_core, config_.main_priority});
+
+    while (running_.load(std::memory_order_acquire)) {
+        if (!run_once()) {
+            if (config_.adaptive_idle) {
+                idle_backoff_.idle([this](uint32_t timeout_us) { park_idle(timeout_us); });
+            } else if (config_.idle_sleep_us > 0) {
+                std::this_thread::sleep_for(std::chrono::microseconds(config_.idle_sleep_us));
+            }
+        } else {
+            idle_backoff_.reset();
+        }
+    }
+
+    finish();
+    return 0;
+}
 
-    running_.store(true, std::memory_order_release);
+bool gateway_loop::start() {
+    // 启动前先校验共享内存依赖。
+    const bool lanes_ready =
+        !lanes_.empty() && lanes_.size() <= kMaxGatewayAccounts &&
+        std::all_of(lanes_.begin(), lanes_.end(), [](const gateway_account_lane& lane) {
+            return lane.downstream_shm != nullptr && lane.trades_shm != nullptr && lane.orders_shm != nullptr;
+        });
+    if (!lanes_ready) {
+        ACCT_REPORT_ERROR(ErrorDomain::core, ErrorCode::ComponentUnavailable, "gateway_loop",
+                          "shared memory not available", 0);
+        return false;
+    }
+    const bool adapters_ready =
+        !shards_.empty() && shards_.size() <= kMaxAdapterShards &&
+        std::all_of(shards_.begin(), shards_.end(), [](const adapter_shard& shard) { return shard.adapter != nullptr; });
+    if (!adapters_ready) {
+        ACCT_REPORT_ERROR(ErrorDomain::core, ErrorCode::ComponentUnavailable, "gateway_loop",
+                          "broker adapters not available", 0);
+        return false;
+    }
+    bool expected = false;
+    if (!running_.compare_exchange_strong(expected, true, std::memory_order_acq_rel)) {
+        return false;
+    }
+    started_ = true;
     last_stats_print_ns_ = now_ns();
 
-    // 单线程循环：重试 -> 新单 -> 回报。
-    while (running_.load(std::memory_order_acquire)) {
-        ++stats_.loop_iterations;
+    // 改单能力须所有分片都支持，撤改单与原单同分片，任一分片不支持即不通告
+    const bool replace_supported = std::all_of(shards_.begin(), shards_.end(), [](const adapter_shard& shard) {
+        return shard.adapter->supports_replace();
+    });
+    const bool dense_broker_ids = std::all_of(shards_.begin(), shards_.end(), [](const adapter_shard& shard) {
+        return shard.adapter->dense_broker_order_ids();
+    });
+    const uint32_t capabilities =
+        (replace_supported ? kBrokerCapReplace : 0U) | (dense_broker_ids ? kBrokerCapDenseBrokerIds : 0U);
+    for (gateway_account_lane& lane : lanes_) {
+        lane.downstream_shm->broker_capabilities.store(capabilities, std::memory_order_release);
+    }
+    // 恢复须在首笔 submit 与轮询线程启动之前完成，适配器 recover 不与其它调用并发
+    if (config_.warm_restart) {
+        recover_in_flight_orders();
+    }
 
-        bool did_work = false;
-        did_work = process_retry_queue() || did_work;
-        did_work = process_orders(config_.poll_batch_size) || did_work;
-        did_work = process_events(config_.poll_batch_size) || did_work;
+    // 直写回报先写分片回报环（与 trade_response_record 同布局），再逐条编码进 trades_shm 紧凑回报队列
+    for (adapter_shard& entry : shards_) {
+        entry.direct_responses = config_.direct_responses && entry.adapter->supports_response_writer();
+        if (entry.direct_responses) {
+            if (!entry.responses) {
+                entry.responses = std::make_unique<response_ring>();
+            }
+            entry.responses->init();
+        }
+    }
 
-        if (!did_work) {
-            ++stats_.idle_iterations;
-            if (config_.idle_sleep_us > 0) {
-                std::this_thread::sleep_for(std::chrono::microseconds(config_.idle_sleep_us));
+    if (config_.adapter_poll_thread) {
+        for (uint32_t shard = 0; shard < shards_.size(); ++shard) {
+            adapter_shard& entry = shards_[shard];
+            if (!entry.direct_responses) {
+                if (!entry.events) {
+                    entry.events = std::make_unique<event_ring>();
+                }
+                entry.events->init();
+            }
+            entry.poll_thread = std::thread([this, shard]() { adapter_poll_main(shard); });
+        }
+    }
+    return true;
+}
+
+void gateway_loop::recover_in_flight_orders() {
+    const TimestampNs scan_start = now_monotonic_ns();
+    std::vector<std::vector<broker_api::broker_inflight_order>> by_shard(shards_.size());
+    for (uint32_t lane = 0; lane < lanes_.size(); ++lane) {
+        const orders_shm_layout* orders_shm = lanes_[lane].orders_shm;
+        const OrderIndex upper = std::min(orders_shm->header.next_index.load(std::memory_order_acquire),
+                                          orders_shm->header.capacity);
+        collect_in_flight_orders(lane, orders_shm, 0, upper, by_shard);
+        const uint32_t overflow_segments = orders_shm->header.overflow_segments.load(std::memory_order_acquire);
+        for (uint32_t segment = 1; segment <= overflow_segments; ++segment) {
+            const orders_shm_layout* overflow = orders_shm_overflow(orders_shm, segment);
+            if (!overflow) {
+                continue;
             }
+            const OrderIndex begin = make_orders_index(segment, 0);
+            const OrderIndex end = begin + std::min(overflow->header.next_index.load(std::memory_order_acquire),
+                                                    overflow->header.capacity);
+            collect_in_flight_orders(lane, orders_shm, begin, end, by_shard);
         }
+    }
 
-        if (config_.stats_interval_ms > 0) {
-            const TimestampNs now = now_ns();
-            const uint64_t interval_ns = static_cast<uint64_t>(config_.stats_interval_ms) * 1000000ULL;
-            if (now >= last_stats_print_ns_ + interval_ns) {
-                print_periodic_stats();
-                last_stats_print_ns_ = now;
+    std::size_t found = 0;
+    for (uint32_t shard = 0; shard < shards_.size(); ++shard) {
+        const std::vector<broker_api::broker_inflight_order>& orders = by_shard[shard];
+        found += orders.size();
+        if (orders.empty()) {
+            continue;
+        }
+        const std::size_t recovered = shards_[shard].adapter->recover(orders.data(), orders.size());
+        stats_.orders_recovered += std::min(recovered, orders.size());
+        if (shards_.size() > 1) {
+            for (const broker_api::broker_inflight_order& order : orders) {
+                (void)order_shards_.insert_or_assign(order.request.internal_order_id, shard);
             }
         }
     }
+    stats_.security_cache_hits = security_cache_.hits();
+    stats_.security_cache_misses = security_cache_.misses();
+    ACCT_LOG_INFO("gateway_loop", "warm restart recovered " + std::to_string(stats_.orders_recovered) + "/" +
+                                      std::to_string(found) + " in-flight orders in " +
+                                      std::to_string((now_monotonic_ns() - scan_start) / 1000) + "us");
+}
 
-    return 0;
+// 只收已由网关出队的新单：仍在下游队列中的订单重启后照常搬运，撤单与改单请求不恢复
+void gateway_loop::collect_in_flight_orders(uint32_t lane, const orders_shm_layout* orders_shm, OrderIndex begin,
+                                            OrderIndex end,
+                                            std::vector<std::vector<broker_api::broker_inflight_order>>& out) {
+    for (OrderIndex index = begin; index < end; ++index) {
+        bool in_flight = false;
+        OrderSlotState stage = OrderSlotState::Empty;
+        TimestampNs last_update_ns = 0;
+        broker_api::broker_inflight_order order;
+        const bool read_ok = orders_shm_read_slot(orders_shm, index, [&](const OrderSlot& slot) {
+            const OrderRequest& request = slot.request;
+            stage = slot.stage;
+            // 出队阶段记在网关进度字里，槽位阶段可能仍停在 DownstreamQueued，读完后再合并判定
+            in_flight = (stage == OrderSlotState::DownstreamQueued || stage == OrderSlotState::DownstreamDequeued) &&
+                        request.order_type == OrderType::New &&
+                        !is_terminal_order_state(request.order_state.load(std::memory_order_acquire));
+            if (!in_flight) {
+                return;
+            }
+            in_flight = map_order_request_to_broker(request, order.request, &security_cache_) &&
+                        encode_session_order_id(lane, order.request.internal_order_id);
+            order.traded_volume = request.volume_traded;
+            order.broker_order_id = static_cast<uint32_t>(request.broker_order_id.as_uint);
+        });
+        if (!read_ok || !in_flight) {
+            continue;
+        }
+        orders_shm_merge_downstream_at(orders_shm, index, stage, last_update_ns);
+        if (stage == OrderSlotState::DownstreamDequeued) {
+            out[route_request(order.request)].push_back(order);
+        }
+    }
+}
+
+// 单轮：补写溢出回报 -> 重试 -> 节流放行 -> 新单 -> 回报；拆分模式下回报来自事件环。
+bool gateway_loop::run_once() {
+    if (!running_.load(std::memory_order_acquire)) {
+        return false;
+    }
+    ++stats_.loop_iterations;
+    // 出队前采样，记下本轮看到的积压
+    if (queue_depth_countdown_ != 0 && --queue_depth_countdown_ == 0) {
+        sample_queue_depths();
+        queue_depth_countdown_ = config_.queue_depth_sample_iterations;
+    }
+
+    bool did_work = drain_response_spills();
+    did_work = process_retry_queue() || did_work;
+    did_work = release_paced_orders(false) || did_work;
+    did_work = process_orders(config_.poll_batch_size) || did_work;
+    if (spill_backpressure()) {
+        ++stats_.spill_backpressure;
+    } else if (config_.adapter_poll_thread) {
+        did_work = process_event_rings(config_.poll_batch_size) || did_work;
+    } else {
+        did_work = process_events(config_.poll_batch_size) || did_work;
+    }
+    if (!did_work) {
+        ++stats_.idle_iterations;
+    }
+
+    if (config_.stats_interval_ms > 0) {
+        const TimestampNs now = now_ns();
+        const uint64_t interval_ns = static_cast<uint64_t>(config_.stats_interval_ms) * 1000000ULL;
+        if (now >= last_stats_print_ns_ + interval_ns) {
+            print_periodic_stats();
+            last_stats_print_ns_ = now;
+        }
+    }
+    if (metrics_enabled_) {
+        const TimestampNs now = now_monotonic_ns();
+        if (now >= last_metrics_publish_ns_ + kMetricsPublishIntervalNs) {
+            publish_metrics();
+            last_metrics_publish_ns_ = now;
+        }
+    }
+    return did_work;
+}
+
+void gateway_loop::finish() {
+    running_.store(false, std::memory_order_release);
+    started_ = false;
+    for (adapter_shard& entry : shards_) {
+        if (entry.poll_thread.joinable()) {
+            entry.poll_thread.join();
+        }
+    }
+    // 仍在节流环中的请求已从下游队列取出，退出前不等令牌提交，不留在网关内
+    (void)release_paced_orders(true);
+    // 退出前尽量补写溢出环，账户服务仍未腾出空间的部分计入丢弃
+    (void)drain_response_spills();
+    for (const std::unique_ptr<response_spill>& spill : response_spills_) {
+        stats_.responses_dropped += spill->size();
+        spill->init();
+    }
+    stats_.spill_depth = 0;
+    if (metrics_enabled_) {
+        publish_metrics();
+    }
 }
 
 void gateway_loop::stop() noexcept { running_.store(false, std::memory_order_release); }
 
 const gateway_stats& gateway_loop::stats() const noexcept { return stats_; }
 
-bool gateway_loop::process_retry_queue() {
-    if (retry_queue_.empty()) {
-        return false;
+void gateway_loop::attach_stats(stats_shm_layout* stats_shm) {
+    if (!stats_shm) {
+        return;
     }
+    broker_latency_ = &stats_shm->brokers;
+    broker_latency_->reset();
+    metrics_registry registry(&stats_shm->metrics);
+    metrics_.loop_iterations = registry.add("gateway.loop_iterations");
+    metrics_.idle_iterations = registry.add("gateway.idle_iterations");
+    metrics_.orders_received = registry.add("gateway.orders_received");
+    metrics_.orders_inline = registry.add("gateway.orders_inline");
+    metrics_.priority_cancels = registry.add("gateway.priority_cancels");
+    metrics_.orders_submitted = registry.add("gateway.orders_submitted");
+    metrics_.submit_batches = registry.add("gateway.submit_batches");
+    metrics_.orders_failed = registry.add("gateway.orders_failed");
+    metrics_.retries_scheduled = registry.add("gateway.retries_scheduled");
+    metrics_.retries_exhausted = registry.add("gateway.retries_exhausted");
+    metrics_.events_received = registry.add("gateway.events_received");
+    metrics_.direct_responses = registry.add("gateway.direct_responses");
+    metrics_.fills_coalesced = registry.add("gateway.fills_coalesced");
+    metrics_.responses_pushed = registry.add("gateway.responses_pushed");
+    metrics_.responses_dropped = registry.add("gateway.responses_dropped");
+    metrics_.responses_spilled = registry.add("gateway.responses_spilled");
+    metrics_.spill_depth = registry.add("gateway.spill_depth", metric_kind::Gauge);
+    metrics_.spill_backpressure = registry.add("gateway.spill_backpressure");
+    metrics_.retry_queue = registry.add("gateway.retry_queue", metric_kind::Gauge);
+    metrics_.security_cache_hits = registry.add("gateway.security_cache_hits");
+    metrics_.security_cache_misses = registry.add("gateway.security_cache_misses");
+    metrics_.rtt_tracked = registry.add("gateway.rtt_tracked", metric_kind::Gauge);
+    metrics_.rtt_untracked = registry.add("gateway.rtt_untracked");
+    metrics_.paced_orders = registry.add("gateway.paced_orders");
+    metrics_.paced_depth = registry.add("gateway.paced_depth", metric_kind::Gauge);
+    metrics_.paced_flushes = registry.add("gateway.paced_flushes");
+    metrics_.paced_backpressure = registry.add("gateway.paced_backpressure");
+    metrics_.orders_recovered = registry.add("gateway.orders_recovered");
+    metrics_enabled_ = true;
 
-    bool did_work = false;
-    const TimestampNs now = now_ns();
-    const std::size_t count = retry_queue_.size();
+    queue_depths_ = &stats_shm->queues;
+    (*queue_depths_)[shm_queue_id::DownstreamOrders].reset(kDownstreamQueueCapacity);
+    (*queue_depths_)[shm_queue_id::DownstreamPayloads].reset(kDownstreamPayloadQueueCapacity);
+    (*queue_depths_)[shm_queue_id::DownstreamCancels].reset(kDownstreamCancelQueueCapacity);
+    queue_depth_countdown_ = config_.queue_depth_sample_iterations;
+}
 
-    // 只处理本轮已存在的重试项，避免长时间占用循环。
-    for (std::size_t i = 0; i < count; ++i) {
-        retry_item item = retry_queue_.front();
-        retry_queue_.pop_front();
+void gateway_loop::sample_queue_depths() {
+    std::size_t depths[3] = {0, 0, 0};
+    for (const gateway_account_lane& lane : lanes_) {
+        depths[0] = std::max(depths[0], lane.downstream_shm->order_queue.size());
+        depths[1] = std::max(depths[1], lane.downstream_shm->order_payload_queue.size());
+        depths[2] = std::max(depths[2], lane.downstream_shm->cancel_queue.size());
+    }
+    constexpr shm_queue_id kQueues[3] = {shm_queue_id::DownstreamOrders, shm_queue_id::DownstreamPayloads,
+                                         shm_queue_id::DownstreamCancels};
+    for (std::size_t i = 0; i < 3; ++i) {
+        queue_depth_histogram& histogram = (*queue_depths_)[kQueues[i]];
+        if (histogram.record(depths[i])) {
+            ACCT_LOG_WARN("gateway_loop", std::string("queue depth crossed alert threshold queue=") +
+                                              shm_queue_name(kQueues[i]) + " depth=" + std::to_string(depths[i]) +
+                                              " capacity=" + std::to_string(histogram.capacity.load()));
+        }
+    }
+}
 
-        if (item.next_retry_at_ns > now) {
-            retry_queue_.push_back(item);
-            continue;
+void gateway_loop::publish_metrics() {
+    metrics_.loop_iterations.set(stats_.loop_iterations);
+    metrics_.idle_iterations.set(stats_.idle_iterations);
+    metrics_.orders_received.set(stats_.orders_received);
+    metrics_.orders_inline.set(stats_.orders_inline);
+    metrics_.priority_cancels.set(stats_.priority_cancels);
+    metrics_.orders_submitted.set(stats_.orders_submitted);
+    metrics_.submit_batches.set(stats_.submit_batches);
+    metrics_.orders_failed.set(stats_.orders_failed);
+    metrics_.retries_scheduled.set(stats_.retries_scheduled);
+    metrics_.retries_exhausted.set(stats_.retries_exhausted);
+    metrics_.events_received.set(stats_.events_received);
+    metrics_.direct_responses.set(stats_.direct_responses);
+    metrics_.fills_coalesced.set(stats_.fills_coalesced);
+    metrics_.responses_pushed.set(stats_.responses_pushed);
+    metrics_.responses_dropped.set(stats_.responses_dropped);
+    metrics_.responses_spilled.set(stats_.responses_spilled);
+    metrics_.spill_depth.set(stats_.spill_depth);
+    metrics_.spill_backpressure.set(stats_.spill_backpressure);
+    metrics_.retry_queue.set(stats_.retry_queue_size);
+    metrics_.security_cache_hits.set(stats_.security_cache_hits);
+    metrics_.security_cache_misses.set(stats_.security_cache_misses);
+    metrics_.rtt_tracked.set(stats_.rtt_tracked);
+    metrics_.rtt_untracked.set(stats_.rtt_untracked);
+    metrics_.paced_orders.set(stats_.paced_orders);
+    metrics_.paced_depth.set(stats_.paced_depth);
+    metrics_.paced_flushes.set(stats_.paced_flushes);
+    metrics_.paced_backpressure.set(stats_.paced_backpressure);
+    metrics_.orders_recovered.set(stats_.orders_recovered);
+}
+
+void gateway_loop::start_order_rtt(const broker_api::broker_order_request& request, uint32_t shard,
+                                   TimestampNs submitted_ns) {
+    if (request.type != broker_api::request_type::New) {
+        return;
+    }
+    order_rtt_entry* entry = order_rtt_.try_emplace(request.internal_order_id);
+    if (!entry) {
+        ++stats_.rtt_untracked;
+        return;
+    }
+    *entry = order_rtt_entry{submitted_ns, 0, shard};
+    stats_.rtt_tracked = order_rtt_.size();
+}
+
+// 回报在主循环映射时打点：拆分轮询线程时含事件环内的排队时间，各会话口径一致，可横向比较。
+void gateway_loop::track_order_rtt(const TradeResponse& response, TimestampNs now_ns_value) {
+    order_rtt_entry* entry = order_rtt_.find(response.internal_order_id);
+    if (!entry) {
+        return;
+    }
+    broker_session_latency& session = broker_latency_->sessions[entry->shard];
+    if (response.new_state == OrderState::BrokerAccepted) {
+        if (entry->accepted_ns == 0) {
+            session.submit_to_accept.record(now_ns_value - entry->submitted_ns);
+            entry->accepted_ns = now_ns_value;
+        }
+        return;
+    }
+    if (response.new_state == OrderState::MarketAccepted) {
+        // 柜台未单独回受理时没有受理时刻，只结束跟踪
+        if (entry->accepted_ns != 0) {
+            session.accept_to_first_trade.record(now_ns_value - entry->accepted_ns);
         }
+    } else if (!is_terminal_state(response.new_state)) {
+        return;
+    }
+    (void)order_rtt_.erase(response.internal_order_id);
+    stats_.rtt_tracked = order_rtt_.size();
+}
 
-        did_work = true;
-        submit_request(item.request, item.attempts);
+bool gateway_loop::process_retry_queue() {
+    if (retry_timers_.empty()) {
+        return false;
     }
 
-    stats_.retry_queue_size = retry_queue_.size();
-    return did_work;
+    // 时间轮只触发已到期槽位；先收齐到期槽位再提交，重新登记的重试顺延到下一 tick，不会本轮重复提交。
+    retry_due_.clear();
+    retry_timers_.advance(now_ns(), [this](uint32_t slot) { retry_due_.push_back(slot); });
+    if (retry_due_.empty()) {
+        return false;
+    }
+
+    // 撤单先于新单重试；原单也在本批到期时撤单排在其后，保证柜台先收到原单
+    const auto waits_for_orig = [this](const broker_api::broker_order_request& cancel) {
+        return std::any_of(retry_due_.begin(), retry_due_.end(), [this, &cancel](uint32_t slot) {
+            const broker_api::broker_order_request& request = retry_items_[slot].request;
+            return request.type == broker_api::request_type::New &&
+                   request.internal_order_id == cancel.orig_internal_order_id;
+        });
+    };
+    (void)std::stable_partition(retry_due_.begin(), retry_due_.end(), [&](uint32_t slot) {
+        const broker_api::broker_order_request& request = retry_items_[slot].request;
+        return request.type == broker_api::request_type::Cancel && !waits_for_orig(request);
+    });
+    for (const uint32_t slot : retry_due_) {
+        const retry_item& item = retry_items_[slot];
+        // 重试已等过重试间隔，不再排队，只计入会话令牌
+        if (shards_[item.shard].pacer.enabled()) {
+            shards_[item.shard].pacer.charge(now_monotonic_ns());
+        }
+        const broker_api::send_result result = shards_[item.shard].adapter->submit(item.request);
+        if (result.accepted) {
+            start_order_rtt(item.request, item.shard, now_monotonic_ns());
+        }
+        if (!handle_send_result(item.request, item.shard, item.attempts, result, slot)) {
+            retry_free_slots_.push_back(slot);
+        }
+    }
+
+    stats_.retry_queue_size = retry_timers_.size();
+    return true;
+}
+
+uint32_t gateway_loop::acquire_retry_slot(const broker_api::broker_order_request& request) {
+    uint32_t slot = 0;
+    if (!retry_free_slots_.empty()) {
+        slot = retry_free_slots_.back();
+        retry_free_slots_.pop_back();
+    } else {
+        slot = static_cast<uint32_t>(retry_items_.size());
+        retry_items_.emplace_back();
+    }
+    retry_items_[slot].request = request;
+    return slot;
 }
 
 bool gateway_loop::process_orders(std::size_t batch_limit) {
@@ -110,99 +609,712 @@ bool gateway_loop::process_orders(std::size_t batch_limit) {
         return false;
     }
 
+    // 撤单优先：先清空全部账户的撤单队列，撤单不再排在其它账户或本账户的大批新单之后
+    const uint32_t lane_count = static_cast<uint32_t>(lanes_.size());
     bool did_work = false;
-    std::size_t processed = 0;
-    OrderIndex index = kInvalidOrderIndex;
+    for (uint32_t lane = 0; lane < lane_count; ++lane) {
+        const std::size_t cancels = process_lane_messages(lane, lanes_[lane].downstream_shm->cancel_queue, batch_limit);
+        stats_.priority_cancels += cancels;
+        did_work = cancels > 0 || did_work;
+    }
 
-    // 批量消费下游订单，减少每轮函数调用开销。
-    while (processed < batch_limit && downstream_shm_->order_queue.try_pop(index)) {
-        ++processed;
+    // 节流环快写满时新单留在下游队列里，由账户侧队列承接积压
+    if (paced_backpressure(batch_limit)) {
+        ++stats_.paced_backpressure;
+        return did_work;
+    }
+
+    // 起始账户逐轮后移，繁忙账户持续占满配额时其余账户也不会总排在最后
+    for (uint32_t offset = 0; offset < lane_count; ++offset) {
+        const uint32_t lane = next_lane_ + offset < lane_count ? next_lane_ + offset : next_lane_ + offset - lane_count;
+        did_work = process_lane_orders(lane, batch_limit) || did_work;
+    }
+    next_lane_ = next_lane_ + 1 < lane_count ? next_lane_ + 1 : 0;
+    return did_work;
+}
+
+bool gateway_loop::process_lane_orders(uint32_t lane, std::size_t batch_limit) {
+    downstream_shm_layout* downstream_shm = lanes_[lane].downstream_shm;
+    std::size_t processed = process_lane_messages(lane, downstream_shm->order_payload_queue, batch_limit);
+    bool did_work = processed > 0;
+
+    // 批量消费下游订单：每块只读一次生产者索引，减少跨核缓存行往返；
+    // 映射成功的请求整块交给 submit_batch，一块只发生一次适配器调用。
+    std::array<OrderIndex, kMaxOrderBatch> indices{};
+    std::array<OrderIndex, kMaxOrderBatch> mapped_indices{};
+    std::array<broker_api::broker_order_request, kMaxOrderBatch> requests{};
+    while (processed < batch_limit) {
+        const std::size_t want = std::min(batch_limit - processed, indices.size());
+        const std::size_t popped = downstream_shm->order_queue.try_pop_bulk(indices.data(), want);
+        if (popped == 0) {
+            break;
+        }
+        processed += popped;
         did_work = true;
-        ++stats_.orders_received;
-        stats_.last_order_time_ns = now_ns();
-
-        order_slot_snapshot snapshot;
-        if (!orders_shm_read_snapshot(orders_shm_, index, snapshot)) {
-            ++stats_.orders_failed;
-            ErrorStatus status = ACCT_MAKE_ERROR(ErrorDomain::order, ErrorCode::OrderNotFound, "gateway_loop",
-                                                 "failed to read downstream order slot", 0);
-            record_error(status);
-            ACCT_LOG_ERROR_STATUS(status);
-            continue;
+
+        std::size_t mapped = 0;
+        for (std::size_t i = 0; i < popped; ++i) {
+            // 标记之前的下标属于旧池，先整块提交再切池
+            if (indices[i] == kOrdersRolloverMarker) {
+                dispatch_mapped_orders(lane, requests.data(), mapped_indices.data(), mapped, 0);
+                mapped = 0;
+                if (!follow_orders_rollover(lane)) {
+                    return true;
+                }
+                continue;
+            }
+            if (handle_downstream_index(lane, indices[i], requests[mapped])) {
+                mapped_indices[mapped++] = indices[i];
+            }
         }
+        dispatch_mapped_orders(lane, requests.data(), mapped_indices.data(), mapped, 0);
+        if (popped < want) {
+            break;
+        }
+    }
+
+    return did_work;
+}
 
-        (void)orders_shm_update_stage(orders_shm_, index, OrderSlotState::DownstreamDequeued, now_ns());
-        const OrderRequest& request = snapshot.request;
+template <typename Queue>
+std::size_t gateway_loop::process_lane_messages(uint32_t lane, Queue& queue, std::size_t batch_limit) {
+    std::size_t processed = 0;
+
+    // 消息本身即报单字段，按队列顺序读取即可映射，不随机访问订单池
+    std::array<downstream_order_message, kMaxOrderBatch> messages{};
+    std::array<OrderIndex, kMaxOrderBatch> mapped_indices{};
+    std::array<broker_api::broker_order_request, kMaxOrderBatch> requests{};
+    while (processed < batch_limit) {
+        const std::size_t want = std::min(batch_limit - processed, messages.size());
+        const std::size_t popped = queue.try_pop_bulk(messages.data(), want);
+        if (popped == 0) {
+            break;
+        }
+        processed += popped;
+        const TimestampNs dequeued_ns = now_monotonic_ns();
 
-        broker_api::broker_order_request mapped;
-        if (!map_order_request_to_broker(request, mapped)) {
-            ++stats_.orders_failed;
-            emit_trader_error(request.internal_order_id, request.internal_security_id, request.trade_side);
+        std::size_t mapped = 0;
+        for (std::size_t i = 0; i < popped; ++i) {
+            const downstream_order_message& message = messages[i];
+            if (message.index == kOrdersRolloverMarker) {
+                dispatch_mapped_orders(lane, requests.data(), mapped_indices.data(), mapped, dequeued_ns);
+                mapped = 0;
+                if (!follow_orders_rollover(lane)) {
+                    return processed;
+                }
+                continue;
+            }
+            const bool ok = (message.flags & downstream_order_message::kReadSlot) != 0
+                                ? handle_downstream_index(lane, message.index, requests[mapped])
+                                : handle_downstream_message(lane, message, requests[mapped]);
+            if (ok) {
+                mapped_indices[mapped++] = message.index;
+            }
+        }
+        dispatch_mapped_orders(lane, requests.data(), mapped_indices.data(), mapped, dequeued_ns);
+        if (popped < want) {
+            break;
+        }
+    }
+    return processed;
+}
+
+bool gateway_loop::follow_orders_rollover(uint32_t lane) {
+    gateway_account_lane& target = lanes_[lane];
+    const uint32_t successor = orders_shm_successor_day(target.orders_shm);
+    if (successor == 0) {
+        return true;
+    }
+    // 节流环中的请求按旧池槽位打点，切池前先全部提交
+    (void)release_paced_orders(true);
+    // 账户服务只切到已建好的订单池，按 Open 打开；容量沿用已存在段
+    orders_shm_layout* next = nullptr;
+    if (!target.orders_shm_name.empty()) {
+        auto manager = std::make_unique<SHMManager>();
+        next = manager->open_orders(make_orders_shm_name(target.orders_shm_name, trading_day_string(successor)),
+                                    shm_mode::Open, target.account_id, 0);
+        if (next) {
+            rollover_shm_.push_back(std::move(manager));
+        }
+    }
+    if (!next) {
+        stop();
+        ACCT_REPORT_ERROR(ErrorDomain::shm, ErrorCode::ShmOpenFailed, "gateway_loop",
+                          "failed to follow orders shm rollover", 0);
+        return false;
+    }
+    target.orders_shm = next;
+    ACCT_LOG_INFO("gateway_loop", "account " + std::to_string(target.account_id) +
+                                      " followed orders shm to trading day " + trading_day_string(successor));
+    return true;
+}
+
+void gateway_loop::dispatch_mapped_orders(uint32_t lane, const broker_api::broker_order_request* requests,
+                                          const OrderIndex* indices, std::size_t count, TimestampNs dequeued_ns) {
+    stats_.security_cache_hits = security_cache_.hits();
+    stats_.security_cache_misses = security_cache_.misses();
+    if (count == 0) {
+        return;
+    }
+    const uint32_t shard_count = static_cast<uint32_t>(shards_.size());
+    if (shard_count == 1) {
+        stats_.shards[0].orders_routed += count;
+        pace_shard_batch(lane, 0, requests, indices, count, dequeued_ns);
+        return;
+    }
+
+    // 多分片时按分片计数排序后的请求副本，使每个分片的请求连续、一次 submit_batch
+    std::array<uint32_t, kMaxOrderBatch> request_shards{};
+    std::array<OrderIndex, kMaxOrderBatch> sorted_indices{};
+    std::array<broker_api::broker_order_request, kMaxOrderBatch> sorted_requests{};
+    std::array<uint32_t, kMaxAdapterShards + 1> offsets{};
+    for (std::size_t i = 0; i < count; ++i) {
+        const uint32_t shard = route_request(requests[i]);
+        request_shards[i] = shard;
+        ++offsets[shard + 1];
+        if (requests[i].type == broker_api::request_type::New) {
+            (void)order_shards_.insert_or_assign(requests[i].internal_order_id, shard);
+        }
+    }
+    for (uint32_t shard = 0; shard < shard_count; ++shard) {
+        stats_.shards[shard].orders_routed += offsets[shard + 1];
+        offsets[shard + 1] += offsets[shard];
+    }
+    std::array<uint32_t, kMaxAdapterShards> cursor{};
+    for (std::size_t i = 0; i < count; ++i) {
+        const uint32_t shard = request_shards[i];
+        const uint32_t pos = offsets[shard] + cursor[shard]++;
+        sorted_requests[pos] = requests[i];
+        sorted_indices[pos] = indices[i];
+    }
+    for (uint32_t shard = 0; shard < shard_count; ++shard) {
+        const std::size_t shard_orders = offsets[shard + 1] - offsets[shard];
+        if (shard_orders > 0) {
+            pace_shard_batch(lane, shard, sorted_requests.data() + offsets[shard],
+                               sorted_indices.data() + offsets[shard], shard_orders, dequeued_ns);
+        }
+    }
+}
+
+uint32_t gateway_loop::route_request(const broker_api::broker_order_request& request) const noexcept {
+    const uint32_t shard_count = static_cast<uint32_t>(shards_.size());
+    if (shard_count == 1) {
+        return 0;
+    }
+    if (request.type == broker_api::request_type::Cancel || request.type == broker_api::request_type::Replace) {
+        if (const uint32_t* shard = order_shards_.find(request.orig_internal_order_id)) {
+            return *shard;
+        }
+    }
+    return hash_security_id(request.internal_security_id, sizeof(request.internal_security_id)) % shard_count;
+}
+
+// 新单按证券哈希选分片，撤单与改单跟随原单，同一证券的全部请求都落在哈希分片上，令牌只需向该分片协商。
+uint64_t gateway_loop::resolve_security_token(void* context, const broker_api::broker_order_request& request) noexcept {
+    gateway_loop& loop = *static_cast<gateway_loop*>(context);
+    const uint32_t shard_count = static_cast<uint32_t>(loop.shards_.size());
+    const uint32_t shard =
+        shard_count == 1 ? 0
+                         : hash_security_id(request.internal_security_id, sizeof(request.internal_security_id)) %
+                               shard_count;
+    return loop.shards_[shard].adapter->resolve_security(request);
+}
+
+void gateway_loop::submit_shard_batch(uint32_t lane, uint32_t shard, const broker_api::broker_order_request* requests,
+                                      const OrderIndex* indices, std::size_t count, TimestampNs dequeued_ns) {
+    orders_shm_layout* orders_shm = lanes_[lane].orders_shm;
+    std::array<broker_api::send_result, kMaxOrderBatch> results{};
+    const TimestampNs submit_start_ns = now_monotonic_ns();
+    shards_[shard].adapter->submit_batch(requests, count, results.data());
+    ++stats_.submit_batches;
+    ++stats_.shards[shard].submit_batches;
+    // 只记录首次提交返回；重试队列中的再次提交不覆盖该跳
+    const TimestampNs submitted_ns = now_monotonic_ns();
+    broker_latency_->sessions[shard].submit_call.record(submitted_ns - submit_start_ns);
+    if (dequeued_ns != 0) {
+        // 内联消息路径：出队阶段推迟到提交之后回写，回报要到本线程下一轮才发布，阶段不会倒退
+        const TimestampNs update_ns = now_ns();
+        for (std::size_t i = 0; i < count; ++i) {
+            orders_shm_mark_hop(orders_shm, indices[i], OrderLatencyHop::GatewayDequeued, dequeued_ns);
+            (void)orders_shm_mark_downstream(orders_shm, indices[i], OrderSlotState::DownstreamDequeued, update_ns);
+        }
+    }
+    for (std::size_t i = 0; i < count; ++i) {
+        orders_shm_mark_hop(orders_shm, indices[i], OrderLatencyHop::AdapterSubmitted, submitted_ns);
+        if (results[i].accepted) {
+            start_order_rtt(requests[i], shard, submitted_ns);
+        }
+        (void)handle_send_result(requests[i], shard, 0, results[i]);
+    }
+}
+
+void gateway_loop::pace_shard_batch(uint32_t lane, uint32_t shard, const broker_api::broker_order_request* requests,
+                                    const OrderIndex* indices, std::size_t count, TimestampNs dequeued_ns) {
+    adapter_shard& entry = shards_[shard];
+    if (!entry.pacer.enabled()) {
+        submit_shard_batch(lane, shard, requests, indices, count, dequeued_ns);
+        return;
+    }
+
+    // 放行的请求保持原相对顺序整批提交；排队的新单在节流环中保持到达顺序
+    std::array<broker_api::broker_order_request, kMaxOrderBatch> ready{};
+    std::array<OrderIndex, kMaxOrderBatch> ready_indices{};
+    std::size_t ready_count = 0;
+    const TimestampNs now = now_monotonic_ns();
+    for (std::size_t i = 0; i < count; ++i) {
+        const broker_api::broker_order_request& request = requests[i];
+        bool pass = false;
+        if (request.type == broker_api::request_type::Cancel) {
+            // 撤单不排在新单之后，只有原单仍在排队时才跟在原单后面
+            pass = !is_paced(entry, request.orig_internal_order_id);
+            if (pass) {
+                entry.pacer.charge(now);
+            }
+        } else {
+            pass = entry.paced_count == 0 && entry.pacer.try_acquire_new(now);
+        }
+        if (!pass) {
+            enqueue_paced(lane, shard, request, indices[i], dequeued_ns);
             continue;
         }
+        ready[ready_count] = request;
+        ready_indices[ready_count] = indices[i];
+        ++ready_count;
+    }
+    if (ready_count > 0) {
+        submit_shard_batch(lane, shard, ready.data(), ready_indices.data(), ready_count, dequeued_ns);
+    }
+}
+
+void gateway_loop::enqueue_paced(uint32_t lane, uint32_t shard, const broker_api::broker_order_request& request,
+                                 OrderIndex index, TimestampNs dequeued_ns) {
+    adapter_shard& entry = shards_[shard];
+    if (entry.paced_count == entry.paced.size()) {
+        ++stats_.paced_flushes;
+        (void)release_paced(shard, true);
+    }
+    if (dequeued_ns != 0) {
+        // 内联消息路径：放行时不再携带出队时刻，出队阶段在入队时补写
+        orders_shm_layout* orders_shm = lanes_[lane].orders_shm;
+        orders_shm_mark_hop(orders_shm, index, OrderLatencyHop::GatewayDequeued, dequeued_ns);
+        (void)orders_shm_mark_downstream(orders_shm, index, OrderSlotState::DownstreamDequeued, now_ns());
+    }
+    const std::size_t tail = (entry.paced_head + entry.paced_count) % entry.paced.size();
+    entry.paced[tail] = paced_request{request, index, lane};
+    ++entry.paced_count;
+    ++stats_.paced_orders;
+    ++stats_.paced_depth;
+}
+
+bool gateway_loop::release_paced(uint32_t shard, bool force) {
+    adapter_shard& entry = shards_[shard];
+    if (entry.paced_count == 0) {
+        return false;
+    }
 
-        submit_request(mapped, 0);
+    // 连续同账户的请求合成一批提交；账户切换或凑满一批时先提交已取出的部分
+    std::array<broker_api::broker_order_request, kMaxOrderBatch> batch{};
+    std::array<OrderIndex, kMaxOrderBatch> batch_indices{};
+    std::size_t batch_count = 0;
+    uint32_t batch_lane = 0;
+    bool released = false;
+    const TimestampNs now = now_monotonic_ns();
+    while (entry.paced_count > 0) {
+        const paced_request& head = entry.paced[entry.paced_head];
+        if (batch_count > 0 && (head.lane != batch_lane || batch_count == batch.size())) {
+            submit_shard_batch(batch_lane, shard, batch.data(), batch_indices.data(), batch_count, 0);
+            batch_count = 0;
+        }
+        if (force || head.request.type == broker_api::request_type::Cancel) {
+            entry.pacer.charge(now);
+        } else if (!entry.pacer.try_acquire_new(now)) {
+            break;
+        }
+        batch[batch_count] = head.request;
+        batch_indices[batch_count] = head.index;
+        ++batch_count;
+        batch_lane = head.lane;
+        entry.paced_head = entry.paced_head + 1 < entry.paced.size() ? entry.paced_head + 1 : 0;
+        --entry.paced_count;
+        --stats_.paced_depth;
+        released = true;
+    }
+    if (batch_count > 0) {
+        submit_shard_batch(batch_lane, shard, batch.data(), batch_indices.data(), batch_count, 0);
     }
+    return released;
+}
 
+bool gateway_loop::release_paced_orders(bool force) {
+    if (stats_.paced_depth == 0) {
+        return false;
+    }
+    bool did_work = false;
+    for (uint32_t shard = 0; shard < shards_.size(); ++shard) {
+        did_work = release_paced(shard, force) || did_work;
+    }
     return did_work;
 }
 
+bool gateway_loop::is_paced(const adapter_shard& entry, uint32_t order_id) const noexcept {
+    for (std::size_t i = 0, pos = entry.paced_head; i < entry.paced_count; ++i) {
+        const broker_api::broker_order_request& request = entry.paced[pos].request;
+        if (request.type != broker_api::request_type::Cancel && request.internal_order_id == order_id) {
+            return true;
+        }
+        pos = pos + 1 < entry.paced.size() ? pos + 1 : 0;
+    }
+    return false;
+}
+
+bool gateway_loop::paced_backpressure(std::size_t batch_limit) const noexcept {
+    if (stats_.paced_depth == 0) {
+        return false;
+    }
+    return std::any_of(shards_.begin(), shards_.end(), [batch_limit](const adapter_shard& entry) {
+        return entry.pacer.enabled() && entry.paced.size() - entry.paced_count < batch_limit;
+    });
+}
+
+bool gateway_loop::encode_session_order_id(uint32_t lane, uint32_t& order_id) const noexcept {
+    if (lane_shift_ >= 32 || order_id == 0) {
+        return true;
+    }
+    if ((order_id >> lane_shift_) != 0) {
+        return false;
+    }
+    order_id |= lane << lane_shift_;
+    return true;
+}
+
+uint32_t gateway_loop::decode_session_order_id(uint32_t session_order_id, uint32_t& out_order_id) const noexcept {
+    if (lane_shift_ >= 32) {
+        out_order_id = session_order_id;
+        return 0;
+    }
+    out_order_id = session_order_id & ((1U << lane_shift_) - 1U);
+    return session_order_id >> lane_shift_;
+}
+
+bool gateway_loop::handle_downstream_index(uint32_t lane, OrderIndex index,
+                                           broker_api::broker_order_request& out_request) {
+    orders_shm_layout* orders_shm = lanes_[lane].orders_shm;
+    ++stats_.orders_received;
+    ++stats_.accounts[lane].orders_received;
+    stats_.last_order_time_ns = now_ns();
+
+    // 直接在槽位上映射所需字段，不拷贝整份订单快照；映射失败时顺带取出回写 TraderError 所需字段
+    bool mapped = false;
+    InternalOrderId failed_order_id = 0;
+    InternalSecurityId failed_security_id;
+    TradeSide failed_side = TradeSide::NotSet;
+    const bool read_ok = orders_shm_read_slot(orders_shm, index, [&](const OrderSlot& slot) {
+        const OrderRequest& request = slot.request;
+        // 多账户共用会话时订单号高位写入账户序号，超出低位范围的订单按映射失败回写 TraderError
+        mapped = map_order_request_to_broker(request, out_request, &security_cache_) &&
+                 encode_session_order_id(lane, out_request.internal_order_id) &&
+                 encode_session_order_id(lane, out_request.orig_internal_order_id);
+        if (!mapped) {
+            failed_order_id = request.internal_order_id;
+            failed_security_id = request.internal_security_id;
+            failed_side = request.trade_side;
+        }
+    });
+    if (!read_ok) {
+        ++stats_.orders_failed;
+        ACCT_REPORT_ERROR(ErrorDomain::order, ErrorCode::OrderNotFound, "gateway_loop",
+                          "failed to read downstream order slot", 0);
+        return false;
+    }
+
+    orders_shm_mark_hop(orders_shm, index, OrderLatencyHop::GatewayDequeued, now_monotonic_ns());
+    (void)orders_shm_mark_downstream(orders_shm, index, OrderSlotState::DownstreamDequeued, now_ns());
+
+    if (!mapped) {
+        ++stats_.orders_failed;
+        emit_trader_error(lane, failed_order_id, failed_security_id, failed_side);
+        return false;
+    }
+    return true;
+}
+
+bool gateway_loop::handle_downstream_message(uint32_t lane, const downstream_order_message& message,
+                                             broker_api::broker_order_request& out_request) {
+    ++stats_.orders_received;
+    ++stats_.orders_inline;
+    ++stats_.accounts[lane].orders_received;
+    stats_.last_order_time_ns = now_ns();
+
+    const bool mapped = map_downstream_message_to_broker(message, out_request, &security_cache_) &&
+                        encode_session_order_id(lane, out_request.internal_order_id) &&
+                        encode_session_order_id(lane, out_request.orig_internal_order_id);
+    if (!mapped) {
+        orders_shm_layout* orders_shm = lanes_[lane].orders_shm;
+        orders_shm_mark_hop(orders_shm, message.index, OrderLatencyHop::GatewayDequeued, now_monotonic_ns());
+        (void)orders_shm_mark_downstream(orders_shm, message.index, OrderSlotState::DownstreamDequeued, now_ns());
+        ++stats_.orders_failed;
+        emit_trader_error(lane, message.internal_order_id, message.internal_security_id, message.trade_side);
+        return false;
+    }
+    return true;
+}
+
 bool gateway_loop::process_events(std::size_t batch_limit) {
     if (batch_limit == 0) {
         return false;
     }
 
-    constexpr std::size_t kMaxEventBatch = 256;
+    bool did_work = false;
     std::array<broker_api::broker_event, kMaxEventBatch> events{};
     const std::size_t max_events = std::min<std::size_t>(batch_limit, events.size());
-    const std::size_t count = adapter_.poll_events(events.data(), max_events);
-    if (count == 0) {
+    for (uint32_t shard = 0; shard < shards_.size(); ++shard) {
+        if (shards_[shard].direct_responses) {
+            did_work = poll_direct_responses(shard, max_events) || did_work;
+            continue;
+        }
+        const std::size_t count = shards_[shard].adapter->poll_events(events.data(), max_events);
+        if (count > 0) {
+            publish_events(shard, events.data(), count);
+            did_work = true;
+        }
+    }
+    return did_work;
+}
+
+bool gateway_loop::process_event_rings(std::size_t batch_limit) {
+    if (batch_limit == 0) {
         return false;
     }
 
+    bool did_work = false;
+    std::array<broker_api::broker_event, kMaxEventBatch> events{};
+    const std::size_t max_events = std::min<std::size_t>(batch_limit, events.size());
+    for (uint32_t shard = 0; shard < shards_.size(); ++shard) {
+        if (shards_[shard].direct_responses) {
+            did_work = drain_response_ring(shard, max_events) || did_work;
+            continue;
+        }
+        const std::size_t count = shards_[shard].events->try_pop_bulk(events.data(), max_events);
+        if (count > 0) {
+            publish_events(shard, events.data(), count);
+            did_work = true;
+        }
+    }
+    return did_work;
+}
+
+void gateway_loop::adapter_poll_main(uint32_t shard) {
+    const int core =
+        config_.adapter_poll_cpu_core >= 0 ? config_.adapter_poll_cpu_core + static_cast<int>(shard) : -1;
+    (void)apply_thread_realtime("gateway_adapter_poll", thread_realtime_config{core, config_.adapter_poll_priority});
+    broker_api::IBrokerAdapter& adapter = *shards_[shard].adapter;
+    const std::size_t max_events = std::min<std::size_t>(config_.poll_batch_size, kMaxEventBatch);
+
+    if (shards_[shard].direct_responses) {
+        // 适配器直接写回报环，环满时 claim 返回 0，未写回报留在适配器内下次再交
+        response_sink sink{shards_[shard].responses.get()};
+        while (running_.load(std::memory_order_acquire)) {
+            sink.pending = 0;
+            (void)adapter.poll_responses(sink.writer(), max_events);
+            if (sink.pending > 0) {
+                sink.queue->commit(sink.pending);
+                doorbell_ring(&lanes_.front().orders_shm->header.gateway_doorbell);
+                continue;
+            }
+            if (config_.idle_sleep_us > 0) {
+                std::this_thread::sleep_for(std::chrono::microseconds(config_.idle_sleep_us));
+            } else {
+                std::this_thread::yield();
+            }
+        }
+        return;
+    }
+
+    event_ring& ring = *shards_[shard].events;
+    std::array<broker_api::broker_event, kMaxEventBatch> events{};
+    std::size_t pending = 0;
+    std::size_t offset = 0;
+    while (running_.load(std::memory_order_acquire)) {
+        if (offset == pending) {
+            offset = 0;
+            pending = adapter.poll_events(events.data(), max_events);
+            if (pending == 0) {
+                if (config_.idle_sleep_us > 0) {
+                    std::this_thread::sleep_for(std::chrono::microseconds(config_.idle_sleep_us));
+                } else {
+                    std::this_thread::yield();
+                }
+                continue;
+            }
+        }
+
+        const std::size_t pushed = ring.try_push_bulk(events.data() + offset, pending - offset);
+        offset += pushed;
+        if (pushed > 0) {
+            doorbell_ring(&lanes_.front().orders_shm->header.gateway_doorbell);
+        }
+        if (offset < pending) {
+            // 主循环来不及消费时等待腾出空间，事件不能丢
+            std::this_thread::yield();
+        }
+    }
+}
+
+void gateway_loop::publish_events(uint32_t shard, const broker_api::broker_event* events, std::size_t count) {
     stats_.events_received += count;
+    stats_.shards[shard].events_received += count;
 
-    // 将适配器事件逐条映射为 TradeResponse。
+    // 将适配器事件逐条映射为 TradeResponse（调用方保证 count <= kMaxEventBatch），按需合并相邻成交后
+    // 在主线程按订单号高位汇入所属账户的回报队列。
+    std::array<TradeResponse, kMaxEventBatch> responses;
+    std::size_t mapped = 0;
+    const TimestampNs observed_ns = order_rtt_.size() > 0 ? now_monotonic_ns() : 0;
     for (std::size_t i = 0; i < count; ++i) {
-        TradeResponse response;
-        if (!map_broker_event_to_trade_response(events[i], response)) {
+        if (shards_.size() > 1 && is_terminal_event(events[i].kind)) {
+            (void)order_shards_.erase(events[i].internal_order_id);
+        }
+        if (!map_broker_event_to_trade_response(events[i], responses[mapped])) {
             ++stats_.responses_dropped;
             continue;
         }
+        if (observed_ns != 0) {
+            track_order_rtt(responses[mapped], observed_ns);
+        }
+        ++mapped;
+    }
+    const std::size_t kept = coalesce_fills(responses.data(), mapped);
+    for (std::size_t i = 0; i < kept; ++i) {
+        if (!deliver_response(responses[i])) {
+            break;
+        }
+    }
+}
 
-        if (!push_response(response)) {
+bool gateway_loop::poll_direct_responses(uint32_t shard, std::size_t batch_limit) {
+    adapter_shard& entry = shards_[shard];
+    // trades_shm 元素为紧凑编码，与 trade_response_record 布局不同：先落分片回报环，再校验、编码并按账户路由
+    response_sink sink{entry.responses.get()};
+    (void)entry.adapter->poll_responses(sink.writer(), batch_limit);
+    sink.queue->commit(sink.pending);
+    return drain_response_ring(shard, batch_limit) || sink.published > 0;
+}
+
+std::size_t gateway_loop::accept_direct_responses(uint32_t shard, TradeResponse* responses, std::size_t count) {
+    stats_.events_received += count;
+    stats_.direct_responses += count;
+    stats_.shards[shard].events_received += count;
+    stats_.shards[shard].direct_responses += count;
+
+    std::size_t kept = 0;
+    const TimestampNs observed_ns = order_rtt_.size() > 0 ? now_monotonic_ns() : 0;
+    for (std::size_t i = 0; i < count; ++i) {
+        TradeResponse& response = responses[i];
+        if (shards_.size() > 1 && is_terminal_state(response.new_state)) {
+            (void)order_shards_.erase(response.internal_order_id);
+        }
+        if (!finalize_trade_response(response)) {
             ++stats_.responses_dropped;
-            stop();
-            ErrorStatus status = ACCT_MAKE_ERROR(ErrorDomain::order, ErrorCode::QueuePushFailed, "gateway_loop",
-                                                 "failed to push trade response", 0);
-            record_error(status);
-            ACCT_LOG_ERROR_STATUS(status);
+            continue;
+        }
+        if (observed_ns != 0) {
+            track_order_rtt(response, observed_ns);
+        }
+        if (kept != i) {
+            responses[kept] = response;
+        }
+        ++kept;
+    }
+    return coalesce_fills(responses, kept);
+}
+
+std::size_t gateway_loop::coalesce_fills(TradeResponse* responses, std::size_t count) {
+    if (!config_.coalesce_fills || count < 2) {
+        return count;
+    }
+    const bool trace = logger_enabled(LogLevel::debug);
+    std::size_t kept = 1;
+    bool head_merged = false;  // responses[kept - 1] 是否已是汇总回报
+    for (std::size_t i = 1; i < count; ++i) {
+        TradeResponse& head = responses[kept - 1];
+        const TradeResponse& next = responses[i];
+        if (can_coalesce_fill(head, next)) {
+            if (trace) {
+                if (!head_merged) {
+                    log_coalesced_fill(head);
+                }
+                log_coalesced_fill(next);
+            }
+            // 数量、金额、费用累加；价格与时间取最后一笔，金额缺失时两笔同价
+            head.volume_traded += next.volume_traded;
+            head.dvalue_traded += next.dvalue_traded;
+            head.dfee += next.dfee;
+            head.dprice_traded = next.dprice_traded;
+            head.md_time_traded = next.md_time_traded;
+            head.recv_time_ns = next.recv_time_ns;
+            head_merged = true;
+            ++stats_.fills_coalesced;
+            continue;
+        }
+        if (kept != i) {
+            responses[kept] = next;
+        }
+        ++kept;
+        head_merged = false;
+    }
+    return kept;
+}
+
+bool gateway_loop::drain_response_ring(uint32_t shard, std::size_t batch_limit) {
+    std::array<TradeResponse, kMaxEventBatch> responses;
+    const std::size_t count =
+        shards_[shard].responses->try_pop_bulk(responses.data(), std::min(batch_limit, responses.size()));
+    if (count == 0) {
+        return false;
+    }
+    const std::size_t kept = accept_direct_responses(shard, responses.data(), count);
+    for (std::size_t i = 0; i < kept; ++i) {
+        if (!deliver_response(responses[i])) {
             break;
         }
+    }
+    return true;
+}
 
-        ++stats_.responses_pushed;
+bool gateway_loop::deliver_response(TradeResponse& response) {
+    const uint32_t lane = decode_session_order_id(response.internal_order_id, response.internal_order_id);
+    if (lane >= lanes_.size() || response.internal_order_id == 0) {
+        ++stats_.responses_dropped;
+        return true;
     }
 
+    if (!push_response(lane, response)) {
+        ++stats_.responses_dropped;
+        stop();
+        ACCT_REPORT_ERROR(ErrorDomain::order, ErrorCode::QueuePushFailed, "gateway_loop",
+                          "failed to push trade response", 0);
+        return false;
+    }
     return true;
 }
 
-void gateway_loop::submit_request(const broker_api::broker_order_request& request, uint32_t attempts) {
-    const broker_api::send_result result = adapter_.submit(request);
+bool gateway_loop::handle_send_result(const broker_api::broker_order_request& request, uint32_t shard,
+    uint32_t attempts, const broker_api::send_result& result, uint32_t retry_slot) {
     if (result.accepted) {
         ++stats_.orders_submitted;
-        return;
+        ++stats_.shards[shard].orders_submitted;
+        return false;
     }
 
     // 可重试错误：按策略延后重试。
     if (result.retryable && attempts < config_.max_retry_attempts) {
-        retry_item item;
-        item.request = request;
-        item.attempts = attempts + 1;
-        item.next_retry_at_ns = now_ns() + static_cast<uint64_t>(config_.retry_interval_us) * 1000ULL;
-        retry_queue_.push_back(item);
+        const uint32_t slot = retry_slot != kNoRetrySlot ? retry_slot : acquire_retry_slot(request);
+        retry_items_[slot].attempts = attempts + 1;
+        retry_items_[slot].shard = shard;
+        const TimestampNs now = now_ns();
+        (void)retry_timers_.schedule(now, now + static_cast<uint64_t>(config_.retry_interval_us) * 1000ULL, slot);
         ++stats_.retries_scheduled;
-        stats_.retry_queue_size = retry_queue_.size();
-        return;
+        stats_.retry_queue_size = retry_timers_.size();
+        return true;
     }
 
     // 不可重试或重试耗尽：回写 TraderError。
@@ -210,31 +1322,110 @@ void gateway_loop::submit_request(const broker_api::broker_order_request& reques
     if (attempts > 0) {
         ++stats_.retries_exhausted;
     }
+    if (shards_.size() > 1 && request.type == broker_api::request_type::New) {
+        (void)order_shards_.erase(request.internal_order_id);
+    }
     InternalSecurityId internal_security_id;
     const std::size_t sec_id_len = ::strnlen(request.internal_security_id, sizeof(request.internal_security_id));
     const std::string_view raw_security_id(request.internal_security_id, sec_id_len);
     if (!raw_security_id.empty() && !normalize_internal_security_id(raw_security_id, internal_security_id)) {
         internal_security_id.assign(raw_security_id);
     }
-    emit_trader_error(request.internal_order_id, internal_security_id, to_order_side(request.trade_side));
+    InternalOrderId internal_order_id = 0;
+    const uint32_t lane = decode_session_order_id(request.internal_order_id, internal_order_id);
+    emit_trader_error(lane, internal_order_id, internal_security_id, to_order_side(request.trade_side));
+    return false;
 }
 
-bool gateway_loop::push_response(const TradeResponse& response) {
-    // 回报写队列满时短暂重试，尽量避免丢失状态。
-    for (uint32_t attempt = 0; attempt < kResponsePushAttempts; ++attempt) {
-        if (trades_shm_->response_queue.try_push(response)) {
+void gateway_loop::park_idle(uint32_t timeout_us) {
+    // 有待重试订单时不晚于重试间隔醒来
+    if (!retry_timers_.empty() && config_.retry_interval_us > 0) {
+        timeout_us = std::min(timeout_us, config_.retry_interval_us);
+    }
+    // 单线程模式下适配器事件不经过门铃，其延迟上限即 timeout_us；拆分模式由轮询线程写环后敲门铃。
+    // 多账户时只能挂在首个账户的门铃上，其余账户的新订单延迟上限同为 timeout_us
+    doorbell_wait(&lanes_.front().orders_shm->header.gateway_doorbell, timeout_us, [this]() {
+        const bool orders_pending = std::any_of(lanes_.begin(), lanes_.end(), [](const gateway_account_lane& lane) {
+            return !lane.downstream_shm->cancel_queue.empty() || !lane.downstream_shm->order_queue.empty() ||
+                   !lane.downstream_shm->order_payload_queue.empty();
+        });
+        if (orders_pending) {
             return true;
         }
-        if (config_.retry_interval_us > 0) {
-            std::this_thread::sleep_for(std::chrono::microseconds(config_.retry_interval_us));
+        return std::any_of(shards_.begin(), shards_.end(), [](const adapter_shard& shard) {
+            return (shard.events && !shard.events->empty()) || (shard.responses && !shard.responses->empty());
+        });
+    });
+}
+
+bool gateway_loop::drain_response_spills() {
+    bool drained = false;
+    uint64_t depth = 0;
+    for (uint32_t lane = 0; lane < response_spills_.size(); ++lane) {
+        if (!response_spills_[lane]->empty()) {
+            drained = drain_response_spill(lane) > 0 || drained;
+            depth += response_spills_[lane]->size();
+        }
+    }
+    stats_.spill_depth = depth;
+    return drained;
+}
+
+std::size_t gateway_loop::drain_response_spill(uint32_t lane) {
+    const gateway_account_lane& target = lanes_[lane];
+    response_spill& spill = *response_spills_[lane];
+    std::size_t drained = 0;
+    trade_response_message message;
+    while (spill.try_peek(message) && target.trades_shm->response_queue.try_push(message)) {
+        (void)spill.try_pop(message);
+        ++drained;
+    }
+    if (drained > 0) {
+        doorbell_ring(&target.orders_shm->header.account_doorbell);
+        stats_.responses_pushed += drained;
+        stats_.accounts[lane].responses_pushed += drained;
+    }
+    return drained;
+}
+
+bool gateway_loop::spill_backpressure() const noexcept {
+    // 高水位留出 1/4 余量，足够容纳满分片（16 x 256）一轮已取出的事件
+    constexpr std::size_t kHighWatermark = response_spill::capacity() - response_spill::capacity() / 4;
+    return std::any_of(response_spills_.begin(), response_spills_.end(),
+                       [](const std::unique_ptr<response_spill>& spill) { return spill->size() >= kHighWatermark; });
+}
+
+bool gateway_loop::push_response(uint32_t lane, const TradeResponse& response) {
+    const gateway_account_lane& target = lanes_[lane];
+    response_spill& spill = *response_spills_[lane];
+    trade_response_message message;
+    pack_trade_response_message(response, message);
+    // 溢出环非空时新回报必须排在积压之后，保持同一订单的回报顺序
+    if (spill.empty() && target.trades_shm->response_queue.try_push(message)) {
+        doorbell_ring(&target.orders_shm->header.account_doorbell);
+        ++stats_.responses_pushed;
+        ++stats_.accounts[lane].responses_pushed;
+        return true;
+    }
+    // 溢出环也满时短暂重试，每次先补写积压再入环，尽量避免丢失状态。
+    for (uint32_t attempt = 0; attempt <= kResponsePushAttempts; ++attempt) {
+        if (attempt > 0) {
+            if (config_.retry_interval_us > 0) {
+                std::this_thread::sleep_for(std::chrono::microseconds(config_.retry_interval_us));
+            }
+            (void)drain_response_spill(lane);
+        }
+        if (spill.try_push(message)) {
+            ++stats_.responses_spilled;
+            return true;
         }
     }
     return false;
 }
 
-void gateway_loop::emit_trader_error(InternalOrderId internal_order_id, InternalSecurityId internal_security_id,
-                                     TradeSide side_value) {
-    if (internal_order_id == 0) {
+void gateway_loop::emit_trader_error(uint32_t lane, InternalOrderId internal_order_id,
+                                     InternalSecurityId internal_security_id, TradeSide side_value) {
+    if (internal_order_id == 0 || lane >= lanes_.size()) {
         return;
     }
 
@@ -253,26 +1444,58 @@ void gateway_loop::emit_trader_error(InternalOrderId internal_order_id, Internal
     response.recv_time_ns = now_ns();
 
     // 尝试把失败状态写回上游，保证链路可观测。
-    if (push_response(response)) {
-        ++stats_.responses_pushed;
-    } else {
+    if (!push_response(lane, response)) {
         ++stats_.responses_dropped;
     }
 }
 
 void gateway_loop::print_periodic_stats() {
     std::fprintf(stderr,
-                 "[gateway] loops=%llu idle=%llu received=%llu submitted=%llu failed=%llu "
-                 "retry_q=%llu events=%llu responses=%llu dropped=%llu\n",
+                 "[gateway] loops=%llu idle=%llu received=%llu inline=%llu cancels=%llu submitted=%llu failed=%llu "
+                 "retry_q=%llu events=%llu direct=%llu coalesced=%llu responses=%llu dropped=%llu spilled=%llu "
+                 "spill_q=%llu spill_bp=%llu sec_hit=%llu sec_miss=%llu paced=%llu paced_q=%llu paced_bp=%llu\n",
                  static_cast<unsigned long long>(stats_.loop_iterations),
                  static_cast<unsigned long long>(stats_.idle_iterations),
                  static_cast<unsigned long long>(stats_.orders_received),
+                 static_cast<unsigned long long>(stats_.orders_inline),
+                 static_cast<unsigned long long>(stats_.priority_cancels),
                  static_cast<unsigned long long>(stats_.orders_submitted),
                  static_cast<unsigned long long>(stats_.orders_failed),
                  static_cast<unsigned long long>(stats_.retry_queue_size),
                  static_cast<unsigned long long>(stats_.events_received),
+                 static_cast<unsigned long long>(stats_.direct_responses),
+                 static_cast<unsigned long long>(stats_.fills_coalesced),
                  static_cast<unsigned long long>(stats_.responses_pushed),
-                 static_cast<unsigned long long>(stats_.responses_dropped));
+                 static_cast<unsigned long long>(stats_.responses_dropped),
+                 static_cast<unsigned long long>(stats_.responses_spilled),
+                 static_cast<unsigned long long>(stats_.spill_depth),
+                 static_cast<unsigned long long>(stats_.spill_backpressure),
+                 static_cast<unsigned long long>(stats_.security_cache_hits),
+                 static_cast<unsigned long long>(stats_.security_cache_misses),
+                 static_cast<unsigned long long>(stats_.paced_orders),
+                 static_cast<unsigned long long>(stats_.paced_depth),
+                 static_cast<unsigned long long>(stats_.paced_backpressure));
+    if (shards_.size() > 1) {
+        for (uint32_t shard = 0; shard < shards_.size(); ++shard) {
+            const gateway_shard_stats& shard_stats = stats_.shards[shard];
+            std::fprintf(stderr,
+                         "[gateway]   shard=%u routed=%llu submitted=%llu batches=%llu events=%llu direct=%llu\n",
+                         shard, static_cast<unsigned long long>(shard_stats.orders_routed),
+                         static_cast<unsigned long long>(shard_stats.orders_submitted),
+                         static_cast<unsigned long long>(shard_stats.submit_batches),
+                         static_cast<unsigned long long>(shard_stats.events_received),
+                         static_cast<unsigned long long>(shard_stats.direct_responses));
+        }
+    }
+    if (lanes_.size() > 1) {
+        for (uint32_t lane = 0; lane < lanes_.size(); ++lane) {
+            const gateway_account_stats& account_stats = stats_.accounts[lane];
+            std::fprintf(stderr, "[gateway]   account=%u received=%llu responses=%llu\n",
+                         static_cast<unsigned>(lanes_[lane].account_id),
+                         static_cast<unsigned long long>(account_stats.orders_received),
+                         static_cast<unsigned long long>(account_stats.responses_pushed));
+        }
+    }
 }
 
 }  // namespace acct_service::gateway
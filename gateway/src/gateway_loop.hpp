@@ -1,76 +1,332 @@
 #pragma once
 
+#include <array>
 #include <atomic>
-#include <deque>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
 
 #include "broker_api/broker_api.hpp"
+#include "common/flat_hash_map.hpp"
+#include "common/idle_strategy.hpp"
+#include "common/timer_wheel.hpp"
 #include "gateway_config.hpp"
+#include "order_mapper.hpp"
 #include "shm/shm_layout.hpp"
+#include "shm/shm_manager.hpp"
+#include "shm/spsc_queue.hpp"
+#include "submit_pacer.hpp"
 
 namespace acct_service::gateway {
 
+// 单个适配器分片（柜台会话）的指标。
+struct gateway_shard_stats {
+    uint64_t orders_routed = 0;
+    uint64_t orders_submitted = 0;
+    uint64_t submit_batches = 0;
+    uint64_t events_received = 0;
+    uint64_t direct_responses = 0;  // 经 response_writer 原地写入的回报数（计入 events_received）
+};
+
+// 单个挂载账户（下游/回报队列对）的指标。
+struct gateway_account_stats {
+    uint64_t orders_received = 0;
+    uint64_t responses_pushed = 0;
+};
+
 // gateway 运行时指标，用于观察处理状态。
 struct gateway_stats {
     uint64_t loop_iterations = 0;
     uint64_t idle_iterations = 0;
     uint64_t orders_received = 0;
+    uint64_t orders_inline = 0;  // 经内联订单消息队列收到、无需回读订单池槽位的订单数（计入 orders_received）
+    uint64_t priority_cancels = 0;  // 经撤单优先队列收到的撤单数（计入 orders_inline）
     uint64_t orders_submitted = 0;
+    uint64_t submit_batches = 0;
     uint64_t orders_failed = 0;
     uint64_t retries_scheduled = 0;
     uint64_t retries_exhausted = 0;
     uint64_t events_received = 0;
+    uint64_t direct_responses = 0;
+    uint64_t fills_coalesced = 0;  // 并入同单前一笔成交、未单独发布的成交回报数（coalesce_fills 开启时）
     uint64_t responses_pushed = 0;
     uint64_t responses_dropped = 0;
+    uint64_t responses_spilled = 0;   // 回报队列满时暂存进溢出环的回报数，补写后计入 responses_pushed
+    uint64_t spill_depth = 0;         // 本轮起始时各账户溢出环积压之和
+    uint64_t spill_backpressure = 0;  // 溢出环越过高水位、暂停拉取适配器事件的轮数
     uint64_t retry_queue_size = 0;
+    uint64_t security_cache_hits = 0;    // 证券字段经转换缓存整块拷贝的映射次数
+    uint64_t security_cache_misses = 0;  // 缓存未命中、逐笔转换证券字段的映射次数
+    uint64_t rtt_tracked = 0;    // 正在跟踪往返延迟的在途新单数
+    uint64_t rtt_untracked = 0;  // 跟踪表已满、未计入往返延迟的新单数
+    uint64_t paced_orders = 0;        // 因会话令牌不足在网关内排队后才提交的请求数
+    uint64_t paced_depth = 0;         // 各会话节流队列当前积压之和
+    uint64_t paced_flushes = 0;       // 节流队列写满、不等令牌整队提交的次数
+    uint64_t paced_backpressure = 0;  // 节流队列接近写满、暂停搬运下游新单的轮数
+    uint64_t orders_recovered = 0;    // warm_restart 启动时适配器接管的在途新单数
     TimestampNs last_order_time_ns = 0;
+    uint32_t shard_count = 0;
+    std::array<gateway_shard_stats, kMaxAdapterShards> shards{};
+    uint32_t account_count = 0;
+    std::array<gateway_account_stats, kMaxGatewayAccounts> accounts{};
+};
+
+// 一个挂载账户的共享内存：下游订单队列、成交回报队列与当日订单池。
+struct gateway_account_lane {
+    AccountId account_id = 0;
+    downstream_shm_layout* downstream_shm = nullptr;
+    trades_shm_layout* trades_shm = nullptr;
+    orders_shm_layout* orders_shm = nullptr;
+    std::string orders_shm_name;  // 订单池基础名（不含交易日），账户服务换日后据此打开后继交易日的订单池；空时不跟随
 };
 
 // gateway 主循环：
 // 读取下游订单 -> 调用适配器 -> 写回成交回报。
+// adapter_poll_thread 开启时 poll_events 移到独立线程，事件经 SPSC 环交回主循环映射发布，
+// 此时适配器须允许 submit 与 poll_events 在两个线程上并发调用。
+// 适配器支持直写回报（ABI v6）时改调 poll_responses：先写分片内的 TradeResponse 环，再由主循环校验、
+// 编码为紧凑消息并按账户路由；不支持时回落 poll_events 通用路径。
+// 多个适配器实例（独立柜台会话）时按证券哈希分片下单，撤单跟随原单分片，回报统一汇入 trades_shm。
+// 挂载多个账户时各账户队列轮转公平搬运，共用同一组柜台会话：提交前在订单号高位打上账户序号，
+// 回报按高位路由回该账户的 trades_shm 并还原订单号，柜台侧不同账户的同号订单不会冲突。
 class gateway_loop {
 public:
     gateway_loop(const gateway_config& config, downstream_shm_layout* downstream_shm, trades_shm_layout* trades_shm,
         orders_shm_layout* orders_shm, broker_api::IBrokerAdapter& adapter);
+    // adapters[i] 为第 i 个分片的适配器，数量 1..kMaxAdapterShards。
+    gateway_loop(const gateway_config& config, downstream_shm_layout* downstream_shm, trades_shm_layout* trades_shm,
+        orders_shm_layout* orders_shm, std::vector<broker_api::IBrokerAdapter*> adapters);
+    // lanes[i] 为第 i 个挂载账户，数量 1..kMaxGatewayAccounts。
+    gateway_loop(const gateway_config& config, std::vector<gateway_account_lane> lanes,
+        std::vector<broker_api::IBrokerAdapter*> adapters);
 
     int run();
     void stop() noexcept;
 
+    // 外部调度模式（进程内网关挂在账户事件循环上）：start() 校验依赖并进入运行态（拆分模式下启动轮询线程），
+    // 不绑核；调度方反复调用 run_once()，结束时 finish() 回收轮询线程。run() 即 start + 循环 + finish 的阻塞组合，
+    // 已 start() 时直接进入循环，start 与 run 之间的 stop() 不会丢失
+    bool start();
+    // 执行一轮且不做空闲等待，返回本轮是否有工作；未运行时返回 false
+    bool run_once();
+    void finish();
+
     const gateway_stats& stats() const noexcept;
+    // 各柜台会话的往返延迟直方图：导出到统计段后即段内 brokers，否则为进程内副本
+    const broker_latency_stats& broker_latency() const noexcept { return *broker_latency_; }
+
+    // 把往返延迟直方图改写到统计段，在段的指标表登记 gateway.* 指标并开始采样下游队列深度；须在 start() 之前、
+    // 与该段其它指标登记同一线程上调用。stats_shm 为空时为空操作
+    void attach_stats(stats_shm_layout* stats_shm);
 
 private:
-    // 失败后等待重试的请求项。
+    static constexpr uint32_t kNoRetrySlot = UINT32_MAX;
+    static constexpr std::size_t kAdapterEventRingCapacity = 4096;
+    static constexpr std::size_t kResponseSpillCapacity = 16384;
+
+    using event_ring = spsc_queue<broker_api::broker_event, kAdapterEventRingCapacity>;
+    using response_ring = spsc_queue<TradeResponse, kAdapterEventRingCapacity>;
+    // 账户回报队列满时的进程内溢出环，存已编码的紧凑消息，只在主循环线程读写。
+    using response_spill = spsc_queue<trade_response_message, kResponseSpillCapacity>;
+
+    // 等待会话令牌的请求：账户序号与订单池槽位随请求保存，放行时按原账户提交与打点。
+    struct paced_request {
+        broker_api::broker_order_request request;
+        OrderIndex index = 0;
+        uint32_t lane = 0;
+    };
+
+    // 一个柜台会话：适配器及拆分模式下的轮询线程与事件环；直写回报时另有回报环。
+    // 开启节流时另有令牌桶与按到达顺序排队的节流环（预分配，只在主循环线程读写）。
+    struct adapter_shard {
+        broker_api::IBrokerAdapter* adapter = nullptr;
+        bool direct_responses = false;
+        std::unique_ptr<event_ring> events;
+        std::unique_ptr<response_ring> responses;
+        std::thread poll_thread;
+        submit_pacer pacer;
+        std::vector<paced_request> paced;
+        std::size_t paced_head = 0;
+        std::size_t paced_count = 0;
+    };
+
+    // 借给适配器的直写句柄上下文，定义见 gateway_loop.cpp。
+    struct response_sink;
+
+    // 在途新单的往返延迟打点，按会话订单号登记，首笔成交或终态后删除。
+    struct order_rtt_entry {
+        TimestampNs submitted_ns = 0;  // 提交返回时刻（单调时钟）
+        TimestampNs accepted_ns = 0;   // 看到 BrokerAccepted 的时刻，0 表示尚未受理
+        uint32_t shard = 0;
+    };
+
+    // 导出到统计段的指标句柄：gateway_stats 的标量字段逐项对应 gateway.<字段>（retry_queue_size 为 gateway.retry_queue），
+    // 分片与账户明细只在周期日志中输出；未调用 attach_stats 时全部未绑定
+    struct gateway_metrics {
+        metric_counter loop_iterations;
+        metric_counter idle_iterations;
+        metric_counter orders_received;
+        metric_counter orders_inline;
+        metric_counter priority_cancels;
+        metric_counter orders_submitted;
+        metric_counter submit_batches;
+        metric_counter orders_failed;
+        metric_counter retries_scheduled;
+        metric_counter retries_exhausted;
+        metric_counter events_received;
+        metric_counter direct_responses;
+        metric_counter fills_coalesced;
+        metric_counter responses_pushed;
+        metric_counter responses_dropped;
+        metric_counter responses_spilled;
+        metric_counter spill_depth;
+        metric_counter spill_backpressure;
+        metric_counter retry_queue;
+        metric_counter security_cache_hits;
+        metric_counter security_cache_misses;
+        metric_counter rtt_tracked;
+        metric_counter rtt_untracked;
+        metric_counter paced_orders;
+        metric_counter paced_depth;
+        metric_counter paced_flushes;
+        metric_counter paced_backpressure;
+        metric_counter orders_recovered;
+    };
+
+    // 失败后等待重试的请求项，存放在预分配槽位池中，由时间轮按槽号调度。
     struct retry_item {
         broker_api::broker_order_request request;
         uint32_t attempts = 0;
-        TimestampNs next_retry_at_ns = 0;
+        uint32_t shard = 0;
     };
 
-    // 处理到期重试请求。
+    // warm_restart：扫描各账户订单池中已出队、未终态的新单，按原分片交给适配器 recover 接管，并登记撤单分片
+    void recover_in_flight_orders();
+    // 扫描一段订单池槽位 [begin, end)，把可恢复的新单按分片追加到 out（订单号已编码账户序号）。
+    void collect_in_flight_orders(uint32_t lane, const orders_shm_layout* orders_shm, OrderIndex begin,
+        OrderIndex end, std::vector<std::vector<broker_api::broker_inflight_order>>& out);
+    // 只处理已到期的重试请求。
     bool process_retry_queue();
-    // 处理下游订单队列。
+    // 取一个空闲重试槽位并写入请求；池耗尽时才扩容。
+    uint32_t acquire_retry_slot(const broker_api::broker_order_request& request);
+    // 处理各账户下游订单队列：每轮起始账户轮转，每个账户至多搬运 batch_limit 笔。
     bool process_orders(std::size_t batch_limit);
-    // 拉取适配器事件并写回回报队列。
+    // 处理单个账户的下游订单队列：先消费内联消息队列，再消费下标队列。
+    bool process_lane_orders(uint32_t lane, std::size_t batch_limit);
+    // 消费内联订单消息（订单消息队列或撤单优先队列），返回搬运条数；映射只读消息本身，槽位阶段与打点推迟到提交之后。
+    template <typename Queue>
+    std::size_t process_lane_messages(uint32_t lane, Queue& queue, std::size_t batch_limit);
+    // 读到换日标记：把该账户切到账户服务发布的后继交易日订单池，本次换日已跟随过时为空操作；
+    // 打不开后继订单池时停机并返回 false（其后的下标无法按旧池解释）
+    bool follow_orders_rollover(uint32_t lane);
+    // 处理单个下游订单索引：读槽位并映射为券商请求（订单号已编码账户序号）；失败时已回写 TraderError。
+    bool handle_downstream_index(uint32_t lane, OrderIndex index, broker_api::broker_order_request& out_request);
+    // 处理单条内联订单消息，语义同 handle_downstream_index，但不触碰订单池槽位。
+    bool handle_downstream_message(uint32_t lane, const downstream_order_message& message,
+        broker_api::broker_order_request& out_request);
+    // 一批已映射请求按分片分组后逐片提交；dequeued_ns 非 0 时提交后补写网关出队阶段与打点。
+    void dispatch_mapped_orders(uint32_t lane, const broker_api::broker_order_request* requests,
+        const OrderIndex* indices, std::size_t count, TimestampNs dequeued_ns);
+    // 把账户内订单号编码为柜台会话订单号；超出低位可表示范围时返回 false。
+    bool encode_session_order_id(uint32_t lane, uint32_t& order_id) const noexcept;
+    // 从柜台会话订单号还原账户序号与账户内订单号。
+    uint32_t decode_session_order_id(uint32_t session_order_id, uint32_t& out_order_id) const noexcept;
+    // 选择请求的分片：新单按证券哈希，撤单优先跟随原单所在分片。
+    uint32_t route_request(const broker_api::broker_order_request& request) const noexcept;
+    // 证券转换缓存的令牌协商回调：向该证券新单所落分片的适配器协商一次。
+    static uint64_t resolve_security_token(void* context, const broker_api::broker_order_request& request) noexcept;
+    // 一个分片的一批请求整体交给 submit_batch，并逐笔处理返回。
+    void submit_shard_batch(uint32_t lane, uint32_t shard, const broker_api::broker_order_request* requests,
+        const OrderIndex* indices, std::size_t count, TimestampNs dequeued_ns);
+    // 开启节流的分片先取令牌：新单（含改单）令牌不足或前面已有排队时入节流环，撤单除非原单仍在排队否则直接放行。
+    void pace_shard_batch(uint32_t lane, uint32_t shard, const broker_api::broker_order_request* requests,
+        const OrderIndex* indices, std::size_t count, TimestampNs dequeued_ns);
+    // 把一笔请求追加到分片节流环；环满时先不等令牌整队提交。dequeued_ns 非 0 时立即补写出队阶段与打点。
+    void enqueue_paced(uint32_t lane, uint32_t shard, const broker_api::broker_order_request& request,
+        OrderIndex index, TimestampNs dequeued_ns);
+    // 按令牌从节流环头部放行，force 时不等令牌全部提交；返回是否有提交。
+    bool release_paced(uint32_t shard, bool force);
+    // 各分片节流环依次放行。
+    bool release_paced_orders(bool force);
+    // 原单是否仍在该分片节流环中排队。
+    bool is_paced(const adapter_shard& entry, uint32_t order_id) const noexcept;
+    // 任一分片节流环剩余空间不足一轮搬运量：本轮不再搬运下游新单，撤单优先队列照常处理。
+    bool paced_backpressure(std::size_t batch_limit) const noexcept;
+    // 登记一笔已受理新单的提交时刻；跟踪表满时只计数。
+    void start_order_rtt(const broker_api::broker_order_request& request, uint32_t shard, TimestampNs submitted_ns);
+    // 按回报推进在途新单的往返延迟：受理记 submit_to_accept，首笔成交记 accept_to_first_trade 后删除，终态删除。
+    void track_order_rtt(const TradeResponse& response, TimestampNs now_ns_value);
+    // 把网关指标写入统计段（每 kMetricsPublishIntervalNs 一次）。
+    void publish_metrics();
+    // 按游标差采样各账户下游队列深度，每类队列记最深的账户写入统计段直方图；越过告警线时告警一次。
+    void sample_queue_depths();
+    // 拉取各分片适配器事件并写回回报队列。
     bool process_events(std::size_t batch_limit);
+    // 消费各分片轮询线程交来的事件（拆分模式下替代 process_events）。
+    bool process_event_rings(std::size_t batch_limit);
+    // 将一批适配器事件映射为 TradeResponse 并写回。
+    void publish_events(uint32_t shard, const broker_api::broker_event* events, std::size_t count);
+    // 直写分片一轮：适配器写分片回报环后立即校验并路由。
+    bool poll_direct_responses(uint32_t shard, std::size_t batch_limit);
+    // 原地校验一段直写回报并压实被丢弃项，返回保留条数；多分片时顺带清理终态订单的分片映射。
+    std::size_t accept_direct_responses(uint32_t shard, TradeResponse* responses, std::size_t count);
+    // coalesce_fills 开启时把同一订单的相邻成交原地合并为一条，返回保留条数；被合并的逐笔明细写 debug 日志。
+    std::size_t coalesce_fills(TradeResponse* responses, std::size_t count);
+    // 取出分片回报环中的直写回报，校验后按账户路由写回。
+    bool drain_response_ring(uint32_t shard, std::size_t batch_limit);
+    // 按会话订单号高位找回账户并写回一条回报；写队列失败时停机并返回 false。
+    bool deliver_response(TradeResponse& response);
+    // 把溢出环中的回报按序补写回各账户 trades_shm，返回是否有写出。
+    bool drain_response_spills();
+    // 补写单个账户的溢出环，直到回报队列再次写满或溢出环清空，返回写出条数。
+    std::size_t drain_response_spill(uint32_t lane);
+    // 任一账户溢出环越过高水位：本轮不再拉取适配器事件，回报留在适配器或事件环内。
+    bool spill_backpressure() const noexcept;
+    // 适配器轮询线程主体：poll_events -> 事件环（直写时 poll_responses -> 回报环），环满时保留未写部分不丢弃。
+    void adapter_poll_main(uint32_t shard);
 
-    // 提交一次请求（含重试入队逻辑）。
-    void submit_request(const broker_api::broker_order_request& request, uint32_t attempts);
-    // 写 TradeResponse 到共享内存（带短重试）。
-    bool push_response(const TradeResponse& response);
-    // 发送 TraderError 回报（不可恢复失败兜底）。
-    void emit_trader_error(InternalOrderId internal_order_id, InternalSecurityId internal_security_id,
+    // 按提交结果计数、重试入队或回写 TraderError；返回是否已登记重试。
+    // retry_slot 为重试路径上请求所在槽位，重新登记时原地复用，不再拷贝请求。
+    bool handle_send_result(const broker_api::broker_order_request& request, uint32_t shard, uint32_t attempts,
+        const broker_api::send_result& result, uint32_t retry_slot = kNoRetrySlot);
+    // 空闲退避进入挂起级：在首个账户的 gateway_doorbell 上等待任一账户新订单（拆分模式下含事件环）或超时。
+    void park_idle(uint32_t timeout_us);
+    // 写 TradeResponse 到对应账户的共享内存；队列满或溢出环非空时排进溢出环，溢出环也满时短重试。
+    // 写入队列或溢出环即返回 true，responses_pushed 在实际落入队列时计数。
+    bool push_response(uint32_t lane, const TradeResponse& response);
+    // 发送 TraderError 回报（不可恢复失败兜底），internal_order_id 为账户内订单号。
+    void emit_trader_error(uint32_t lane, InternalOrderId internal_order_id, InternalSecurityId internal_security_id,
         TradeSide side_value);
     // 周期打印核心指标。
     void print_periodic_stats();
 
     gateway_config config_;
-    downstream_shm_layout* downstream_shm_ = nullptr;
-    trades_shm_layout* trades_shm_ = nullptr;
-    orders_shm_layout* orders_shm_ = nullptr;
-    broker_api::IBrokerAdapter& adapter_;
+    std::vector<gateway_account_lane> lanes_;
+    uint32_t lane_shift_ = 32;          // 账户序号所在的起始位；单账户时为 32，即不编码
+    uint32_t next_lane_ = 0;            // 下一轮最先搬运的账户
+    std::vector<adapter_shard> shards_;
+    flat_hash_map<uint32_t, uint32_t> order_shards_;  // 在途新单 -> 分片，仅多分片时维护
+    security_conversion_cache security_cache_;        // 各账户共用：证券转换结果与各证券在所属分片协商的令牌
+    std::vector<std::unique_ptr<response_spill>> response_spills_;  // 按账户序号，构造时预分配
+    std::vector<std::unique_ptr<SHMManager>> rollover_shm_;  // 换日后自行映射的订单池，旧池映射随调用方保留
+    idle_backoff idle_backoff_;
     std::atomic<bool> running_{false};
-    std::deque<retry_item> retry_queue_;
+    bool started_ = false;  // start() 之后、finish() 之前，只由启动/收尾线程读写
+    std::vector<retry_item> retry_items_;    // 重试槽位池
+    std::vector<uint32_t> retry_free_slots_;  // 空闲槽位栈
+    std::vector<uint32_t> retry_due_;         // 本轮到期的重试槽位（复用容量），撤单先于新单提交
+    timer_wheel<uint32_t> retry_timers_;      // 按重试截止时间调度槽位号
+    flat_hash_map<uint32_t, order_rtt_entry> order_rtt_;  // 在途新单往返延迟打点，预分配
+    std::unique_ptr<broker_latency_stats> local_broker_latency_;  // 未导出统计段时使用的进程内直方图
+    broker_latency_stats* broker_latency_ = nullptr;               // 当前写入的往返延迟直方图
+    gateway_metrics metrics_{};
+    bool metrics_enabled_ = false;
+    queue_depth_stats* queue_depths_ = nullptr;  // 统计段中的队列深度直方图，只写下游三项
+    uint32_t queue_depth_countdown_ = 0;         // 距下一次深度采样的轮数，0 表示不采样
     gateway_stats stats_{};
     TimestampNs last_stats_print_ns_ = 0;
+    TimestampNs last_metrics_publish_ns_ = 0;
 };
 
 }  // namespace acct_service::gateway
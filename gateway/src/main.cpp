@@ -1,18 +1,20 @@
 #include <atomic>
 #include <csignal>
 #include <cstdio>
+#include <memory>
 #include <string>
 #include <string_view>
+#include <vector>
 
-#include "adapter_loader.hpp"
 #include "common/error.hpp"
 #include "common/log.hpp"
+#include "common/thread_setup.hpp"
 #include "core/config_manager.hpp"
+#include "gateway_adapters.hpp"
 #include "gateway_config.hpp"
 #include "gateway_loop.hpp"
 #include "shm/orders_shm.hpp"
 #include "shm/shm_manager.hpp"
-#include "sim_broker_adapter.hpp"
 
 namespace {
 
@@ -93,84 +95,91 @@ int main(int argc, char* argv[]) {
     }
     logger_guard.arm();
 
-    // 打开共享内存：读取下游订单，写入成交回报。
-    SHMManager downstream_manager;
-    SHMManager trades_manager;
-    SHMManager orders_manager;
+    // 逐个挂载账户打开共享内存：读取下游订单，写入成交回报。
+    const std::vector<gateway::gateway_account_binding> bindings = gateway::resolve_gateway_accounts(config);
+    std::vector<std::unique_ptr<SHMManager>> shm_managers;
+    std::vector<gateway::gateway_account_lane> lanes;
     const shm_mode mode = config.create_if_not_exist ? shm_mode::OpenOrCreate : shm_mode::Open;
-
-    downstream_shm_layout* downstream =
-        downstream_manager.open_downstream(config.downstream_shm_name, mode, config.account_id);
-    if (!downstream) {
-        const ErrorStatus& status = latest_error();
-        std::fprintf(stderr, "failed to open downstream shm: domain=%s code=%s msg=%s\n", to_string(status.domain),
-                     to_string(status.code), status.message.c_str());
-        return 1;
-    }
-
-    trades_shm_layout* trades = trades_manager.open_trades(config.trades_shm_name, mode, config.account_id);
-    if (!trades) {
+    const auto print_open_error = [](const char* what, AccountId account_id) {
         const ErrorStatus& status = latest_error();
-        std::fprintf(stderr, "failed to open trades shm: domain=%s code=%s msg=%s\n", to_string(status.domain),
-                     to_string(status.code), status.message.c_str());
-        return 1;
-    }
+        std::fprintf(stderr, "failed to open %s shm for account %u: domain=%s code=%s msg=%s\n", what,
+                     static_cast<unsigned>(account_id), to_string(status.domain), to_string(status.code),
+                     status.message.c_str());
+    };
+
+    for (const gateway::gateway_account_binding& binding : bindings) {
+        gateway::gateway_account_lane lane;
+        lane.account_id = binding.account_id;
+        lane.orders_shm_name = binding.orders_shm_name;
+
+        shm_managers.push_back(std::make_unique<SHMManager>());
+        lane.downstream_shm =
+            shm_managers.back()->open_downstream(binding.downstream_shm_name, mode, binding.account_id);
+        if (!lane.downstream_shm) {
+            print_open_error("downstream", binding.account_id);
+            return 1;
+        }
 
-    const std::string dated_orders_name = make_orders_shm_name(config.orders_shm_name, config.trading_day);
-    orders_shm_layout* orders = orders_manager.open_orders(dated_orders_name, mode, config.account_id);
-    if (!orders) {
-        const ErrorStatus& status = latest_error();
-        std::fprintf(stderr, "failed to open orders shm: domain=%s code=%s msg=%s\n", to_string(status.domain),
-                     to_string(status.code), status.message.c_str());
-        return 1;
-    }
+        shm_managers.push_back(std::make_unique<SHMManager>());
+        lane.trades_shm = shm_managers.back()->open_trades(binding.trades_shm_name, mode, binding.account_id);
+        if (!lane.trades_shm) {
+            print_open_error("trades", binding.account_id);
+            return 1;
+        }
 
-    broker_api::IBrokerAdapter* adapter_ptr = nullptr;
-    gateway::sim_broker_adapter sim_adapter;
-    gateway::loaded_adapter plugin_adapter;
-
-    // 支持两种适配器模式：内置 sim 或外部插件。
-    if (config.broker_type == "sim") {
-        adapter_ptr = &sim_adapter;
-    } else if (config.broker_type == "plugin") {
-        std::string error_message;
-        if (!gateway::load_adapter_plugin(config.adapter_plugin_so, plugin_adapter, error_message)) {
-            std::fprintf(stderr, "failed to load adapter plugin: %s\n", error_message.c_str());
+        const std::string dated_orders_name = make_orders_shm_name(binding.orders_shm_name, config.trading_day);
+        // 订单池容量由账户服务配置决定，gateway 沿用已存在段的容量
+        shm_managers.push_back(std::make_unique<SHMManager>());
+        lane.orders_shm = shm_managers.back()->open_orders(dated_orders_name, mode, binding.account_id, 0);
+        if (!lane.orders_shm) {
+            print_open_error("orders", binding.account_id);
             return 1;
         }
-        adapter_ptr = plugin_adapter.get();
-    } else {
-        std::fprintf(stderr, "unsupported --broker-type: %s\n", config.broker_type.c_str());
-        return 2;
+        // 每笔订单都直接读订单池槽位，映射一次后尽量用大页承载
+        if (!shm_managers.back()->advise_huge_pages()) {
+            ACCT_LOG_WARN("gateway", "huge pages unavailable for orders shm, using regular pages");
+        }
+        lanes.push_back(lane);
     }
 
-    broker_api::broker_runtime_config runtime_config;
-    // 组装适配器运行时参数并完成初始化。
-    runtime_config.account_id = config.account_id;
-    runtime_config.auto_fill = true;
-
-    if (!adapter_ptr || !adapter_ptr->initialize(runtime_config)) {
-        std::fprintf(stderr, "failed to initialize broker adapter\n");
+    // 每个分片一个独立适配器实例（柜台会话），逐个会话初始化。
+    gateway::gateway_adapter_set adapter_set;
+    std::string adapter_error;
+    if (!adapter_set.create(config, adapter_error) || !adapter_set.initialize(config.account_id, adapter_error)) {
+        std::fprintf(stderr, "%s\n", adapter_error.c_str());
         return 1;
     }
 
-    gateway::gateway_loop loop(config, downstream, trades, orders, *adapter_ptr);
+    gateway::gateway_loop loop(config, lanes, adapter_set.adapters());
+    // 独立网关的统计段由本进程单写，不可与账户服务的 shm.stats_shm_name 同名
+    if (!config.stats_shm_name.empty()) {
+        shm_managers.push_back(std::make_unique<SHMManager>());
+        stats_shm_layout* stats_shm =
+            shm_managers.back()->open_stats(config.stats_shm_name, shm_mode::OpenOrCreate, config.account_id);
+        if (!stats_shm) {
+            print_open_error("stats", config.account_id);
+            return 1;
+        }
+        stats_shm->metrics.reset();
+        loop.attach_stats(stats_shm);
+    }
     // 将 loop 指针暴露给信号处理逻辑，再进入主循环。
     g_gateway_loop.store(&loop, std::memory_order_release);
     install_signal_handler();
+    // 共享内存与适配器就绪后再锁页，RLIMIT_MEMLOCK 不足时只告警
+    if (config.lock_memory) {
+        (void)lock_process_memory();
+    }
 
     // 进入主循环，直到信号或内部停止。
     const int run_rc = loop.run();
 
     // 无论 run 返回何值都按固定顺序回收资源。
     g_gateway_loop.store(nullptr, std::memory_order_release);
-    if (adapter_ptr) {
-        adapter_ptr->shutdown();
+    adapter_set.shutdown();
+    for (const std::unique_ptr<SHMManager>& manager : shm_managers) {
+        manager->close();
     }
-    plugin_adapter.reset();
-    downstream_manager.close();
-    trades_manager.close();
-    orders_manager.close();
 
     return run_rc;
 }
@@ -16,6 +16,8 @@ broker_api::request_type to_broker_request_type(OrderType type_value) noexcept {
             return broker_api::request_type::New;
         case OrderType::Cancel:
             return broker_api::request_type::Cancel;
+        case OrderType::Replace:
+            return broker_api::request_type::Replace;
         default:
             return broker_api::request_type::Unknown;
     }
@@ -37,38 +39,108 @@ broker_api::market to_broker_market(Market market_value) noexcept {
     }
 }
 
-// 拷贝证券代码到定长 C 字符串。
-void copy_security_id(const SecurityId& source, char* destination, std::size_t capacity) {
-    if (capacity == 0) {
-        return;
-    }
+static_assert(sizeof(SecurityId::data) == broker_api::kSecurityIdSize, "security id width must match broker_api");
+static_assert(sizeof(InternalSecurityId::data) == broker_api::kInternalSecurityIdSize,
+              "internal security id width must match broker_api");
 
-    std::memset(destination, 0, capacity);
-    const std::string_view sec_id = source.view();
-    const std::size_t copy_size = std::min(sec_id.size(), capacity - 1);
-    if (copy_size > 0) {
-        std::memcpy(destination, sec_id.data(), copy_size);
-    }
+// 定长证券代码整块拷贝，末字节强制结尾；FixedString 写入时已以 '\0' 截断。
+void copy_security_id(const SecurityId& source, char (&destination)[broker_api::kSecurityIdSize]) noexcept {
+    std::memcpy(destination, source.data, sizeof(destination));
+    destination[sizeof(destination) - 1] = '\0';
 }
 
-// 拷贝内部证券键到定长 C 字符串，保持 MIC_security_id 语义。
-void copy_internal_security_id(const InternalSecurityId& source, char* destination, std::size_t capacity) {
-    if (capacity == 0) {
+// 拷贝内部证券键，保持 MIC_security_id 语义：已是 canonical MIC 键时整块拷贝，旧格式才走规范化。
+void copy_internal_security_id(const InternalSecurityId& source,
+                               char (&destination)[broker_api::kInternalSecurityIdSize]) noexcept {
+    if (has_canonical_mic_prefix(source.data)) {
+        std::memcpy(destination, source.data, sizeof(destination));
+        destination[sizeof(destination) - 1] = '\0';
         return;
     }
 
-    std::memset(destination, 0, capacity);
+    std::memset(destination, 0, sizeof(destination));
     InternalSecurityId normalized_id;
     const std::string_view id =
         normalize_internal_security_id(source.view(), normalized_id) ? normalized_id.view() : source.view();
-    const std::size_t copy_size = std::min(id.size(), capacity - 1);
+    const std::size_t copy_size = std::min(id.size(), sizeof(destination) - 1);
     if (copy_size > 0) {
         std::memcpy(destination, id.data(), copy_size);
     }
 }
 
+// 缓存键按字读入内部证券键，终止符之后的残留字节清零，与 FixedString 相等语义一致。
+security_cache_key make_security_cache_key(const InternalSecurityId& internal_security_id, Market market) noexcept {
+    static_assert(sizeof(InternalSecurityId::data) == sizeof(security_cache_key::words),
+                  "cache key must cover the whole internal security id");
+    security_cache_key key;
+    bool terminated = false;
+    key.words[0] = fixed_string_detail::load_masked_word(internal_security_id.data, 0, terminated);
+    if (!terminated) {
+        key.words[1] = fixed_string_detail::load_masked_word(internal_security_id.data, 1, terminated);
+    }
+    key.market = market;
+    return key;
+}
+
+// 填写证券键与市场：缓存命中时整块拷贝转换结果与令牌并返回 true，否则逐笔转换。
+bool map_security_fields(const InternalSecurityId& internal_security_id, Market market,
+                         broker_api::broker_order_request& out_request, security_conversion_cache* cache) noexcept {
+    if (cache) {
+        if (const security_conversion* cached = cache->find(internal_security_id, market)) {
+            std::memcpy(out_request.internal_security_id, cached->internal_security_id,
+                        sizeof(out_request.internal_security_id));
+            out_request.order_market = cached->order_market;
+            out_request.security_token = cached->security_token;
+            return true;
+        }
+    }
+    copy_internal_security_id(internal_security_id, out_request.internal_security_id);
+    out_request.order_market = to_broker_market(market);
+    return false;
+}
+
+// 新单需要检查关键下单字段。
+bool new_order_fields_valid(const broker_api::broker_order_request& request) noexcept {
+    return request.trade_side != broker_api::side::Unknown && request.order_market != broker_api::market::Unknown &&
+           request.volume != 0 && request.price != 0 && request.security_id[0] != 0;
+}
+
+// 改单必须指明原单与改后的数量、价格。
+bool replace_fields_valid(const broker_api::broker_order_request& request) noexcept {
+    return request.orig_internal_order_id != 0 && request.volume != 0 && request.price != 0;
+}
+
 }  // namespace
 
+security_conversion_cache::security_conversion_cache(std::size_t capacity, security_token_resolver resolver,
+                                                     void* resolver_context)
+    : entries_(capacity * 2), capacity_(capacity), resolver_(resolver), resolver_context_(resolver_context) {}
+
+const security_conversion* security_conversion_cache::find(const InternalSecurityId& internal_security_id,
+                                                           Market market) noexcept {
+    const security_conversion* entry = entries_.find(make_security_cache_key(internal_security_id, market));
+    ++(entry ? hits_ : misses_);
+    return entry;
+}
+
+// 探测表按两倍容量分配，登记数达到 capacity_ 即停止，避免线性探测在高负载下退化。
+const security_conversion* security_conversion_cache::insert(const InternalSecurityId& internal_security_id,
+                                                             Market market,
+                                                             broker_api::broker_order_request& request) noexcept {
+    if (entries_.size() >= capacity_) {
+        return nullptr;
+    }
+    security_conversion* entry = entries_.try_emplace(make_security_cache_key(internal_security_id, market));
+    if (!entry) {
+        return nullptr;
+    }
+    std::memcpy(entry->internal_security_id, request.internal_security_id, sizeof(entry->internal_security_id));
+    entry->order_market = request.order_market;
+    entry->security_token = resolver_ ? resolver_(resolver_context_, request) : 0;
+    request.security_token = entry->security_token;
+    return entry;
+}
+
 // 将交易方向从共享内存协议映射到 broker_api 枚举。
 broker_api::side to_broker_side(TradeSide side_value) noexcept {
     switch (side_value) {
@@ -94,7 +166,8 @@ TradeSide to_order_side(broker_api::side side_value) noexcept {
 }
 
 // 将上游 OrderRequest 转换为 broker_order_request；输入不合法时返回 false。
-bool map_order_request_to_broker(const OrderRequest& request, broker_api::broker_order_request& out_request) noexcept {
+bool map_order_request_to_broker(const OrderRequest& request, broker_api::broker_order_request& out_request,
+                                 security_conversion_cache* cache) noexcept {
     // 基本合法性检查。
     if (request.internal_order_id == 0) {
         return false;
@@ -109,26 +182,60 @@ bool map_order_request_to_broker(const OrderRequest& request, broker_api::broker
     out_request = broker_api::broker_order_request{};
     out_request.internal_order_id = request.internal_order_id;
     out_request.orig_internal_order_id = request.orig_internal_order_id;
-    copy_internal_security_id(request.internal_security_id, out_request.internal_security_id,
-                              sizeof(out_request.internal_security_id));
+    const bool cached = map_security_fields(request.internal_security_id, request.market, out_request, cache);
     out_request.type = mapped_type;
     out_request.trade_side = to_broker_side(request.trade_side);
-    out_request.order_market = to_broker_market(request.market);
     out_request.volume = request.volume_entrust;
     out_request.price = request.dprice_entrust;
     out_request.md_time = (request.md_time_entrust != 0) ? request.md_time_entrust : request.md_time_driven;
 
-    // 新单需要检查关键下单字段。
-    if (out_request.type == broker_api::request_type::New) {
-        if (out_request.trade_side == broker_api::side::Unknown ||
-            out_request.order_market == broker_api::market::Unknown || out_request.volume == 0 ||
-            out_request.price == 0) {
-            return false;
+    if (out_request.type == broker_api::request_type::New || out_request.type == broker_api::request_type::Replace) {
+        copy_security_id(request.security_id, out_request.security_id);
+        const bool valid = out_request.type == broker_api::request_type::New ? new_order_fields_valid(out_request)
+                                                                             : replace_fields_valid(out_request);
+        if (valid && cache && !cached) {
+            (void)cache->insert(request.internal_security_id, request.market, out_request);
         }
-        copy_security_id(request.security_id, out_request.security_id, sizeof(out_request.security_id));
-        if (out_request.security_id[0] == 0) {
-            return false;
+        return valid;
+    }
+
+    return true;
+}
+
+// 内联消息的 md_time 已由账户服务解析，证券代码不足内联宽度时整块拷贝后补零。
+bool map_downstream_message_to_broker(const downstream_order_message& message,
+                                      broker_api::broker_order_request& out_request,
+                                      security_conversion_cache* cache) noexcept {
+    if (message.internal_order_id == 0) {
+        return false;
+    }
+
+    const broker_api::request_type mapped_type = to_broker_request_type(message.order_type);
+    if (mapped_type == broker_api::request_type::Unknown) {
+        return false;
+    }
+
+    out_request = broker_api::broker_order_request{};
+    out_request.internal_order_id = message.internal_order_id;
+    out_request.orig_internal_order_id = message.orig_internal_order_id;
+    const bool cached = map_security_fields(message.internal_security_id, message.market, out_request, cache);
+    out_request.type = mapped_type;
+    out_request.trade_side = to_broker_side(message.trade_side);
+    out_request.volume = message.volume;
+    out_request.price = message.dprice;
+    out_request.md_time = message.md_time;
+
+    if (out_request.type == broker_api::request_type::New || out_request.type == broker_api::request_type::Replace) {
+        static_assert(downstream_order_message::kSecurityIdSize < broker_api::kSecurityIdSize,
+                      "inline security id must fit broker_api width");
+        std::memcpy(out_request.security_id, message.security_id, sizeof(message.security_id));
+        out_request.security_id[sizeof(message.security_id) - 1] = '\0';
+        const bool valid = out_request.type == broker_api::request_type::New ? new_order_fields_valid(out_request)
+                                                                             : replace_fields_valid(out_request);
+        if (valid && cache && !cached) {
+            (void)cache->insert(message.internal_security_id, message.market, out_request);
         }
+        return valid;
     }
 
     return true;
@@ -1,7 +1,12 @@
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
+
 #include "broker_api/broker_api.hpp"
+#include "common/flat_hash_map.hpp"
 #include "order/order_request.hpp"
+#include "shm/shm_layout.hpp"
 
 namespace acct_service::gateway {
 
@@ -9,8 +14,67 @@ namespace acct_service::gateway {
 broker_api::side to_broker_side(TradeSide side_value) noexcept;
 TradeSide to_order_side(broker_api::side side_value) noexcept;
 
-// 将共享内存订单请求转换为 broker_api 请求。
-bool map_order_request_to_broker(
-    const OrderRequest& request, broker_api::broker_order_request& out_request) noexcept;
+// 证券转换缓存键：原始内部证券键 16 字节按两个机器字比较，另带市场枚举。
+struct security_cache_key {
+    uint64_t words[2]{};
+    Market market = Market::NotSet;
+
+    bool operator==(const security_cache_key& other) const noexcept {
+        return words[0] == other.words[0] && words[1] == other.words[1] && market == other.market;
+    }
+};
+
+struct security_cache_key_hash {
+    std::size_t operator()(const security_cache_key& key) const noexcept {
+        return flat_hash<uint64_t>{}(key.words[0] ^ (key.words[1] * 0x9E3779B97F4A7C15ULL) ^
+                                     static_cast<uint64_t>(key.market));
+    }
+};
+
+// 一只证券的转换结果：规范化后的内部证券键、broker 市场枚举与适配器协商的令牌。
+struct security_conversion {
+    char internal_security_id[broker_api::kInternalSecurityIdSize]{};
+    broker_api::market order_market = broker_api::market::Unknown;
+    uint64_t security_token = 0;
+};
+
+// 适配器令牌协商回调：证券首次登记时调用一次，request 已填好证券与市场字段。
+using security_token_resolver = uint64_t (*)(void* context, const broker_api::broker_order_request& request) noexcept;
+
+// 按证券缓存订单映射中的证券转换：命中时整块拷贝规范化结果与令牌，跳过 MIC 前缀判断、规范化与市场枚举推导。
+// 只由新单/改单（携带完整证券字段）登记；固定容量，登记满后新证券回落逐笔转换。非线程安全。
+class security_conversion_cache {
+public:
+    explicit security_conversion_cache(std::size_t capacity, security_token_resolver resolver = nullptr,
+                                       void* resolver_context = nullptr);
+
+    // 查找证券的转换结果并计入命中/未命中
+    const security_conversion* find(const InternalSecurityId& internal_security_id, Market market) noexcept;
+    // 登记 request 中已转换好的证券字段并协商令牌，写回 request.security_token；已满时返回 nullptr
+    const security_conversion* insert(const InternalSecurityId& internal_security_id, Market market,
+                                      broker_api::broker_order_request& request) noexcept;
+
+    std::size_t size() const noexcept { return entries_.size(); }
+    std::size_t capacity() const noexcept { return capacity_; }
+    uint64_t hits() const noexcept { return hits_; }
+    uint64_t misses() const noexcept { return misses_; }
+
+private:
+    flat_hash_map<security_cache_key, security_conversion, security_cache_key_hash> entries_;
+    std::size_t capacity_ = 0;
+    security_token_resolver resolver_ = nullptr;
+    void* resolver_context_ = nullptr;
+    uint64_t hits_ = 0;
+    uint64_t misses_ = 0;
+};
+
+// 将共享内存订单请求转换为 broker_api 请求；cache 非空时证券字段经缓存转换并携带适配器令牌。
+bool map_order_request_to_broker(const OrderRequest& request, broker_api::broker_order_request& out_request,
+                                 security_conversion_cache* cache = nullptr) noexcept;
+
+// 将下游内联订单消息转换为 broker_api 请求，校验规则与 map_order_request_to_broker 一致。
+bool map_downstream_message_to_broker(const downstream_order_message& message,
+                                      broker_api::broker_order_request& out_request,
+                                      security_conversion_cache* cache = nullptr) noexcept;
 
 }  // namespace acct_service::gateway
@@ -1,5 +1,6 @@
 #include "response_mapper.hpp"
 
+#include <cstddef>
 #include <cstring>
 #include <string_view>
 
@@ -10,6 +11,35 @@ namespace acct_service::gateway {
 
 namespace {
 
+using broker_api::trade_response_record;
+
+// 直写记录与回报队列元素必须逐字节兼容，适配器才能原地填写队列槽位。
+static_assert(sizeof(trade_response_record) == sizeof(TradeResponse), "direct response size must match");
+static_assert(alignof(trade_response_record) == alignof(TradeResponse), "direct response alignment must match");
+static_assert(offsetof(trade_response_record, internal_order_id) == offsetof(TradeResponse, internal_order_id));
+static_assert(offsetof(trade_response_record, broker_order_id) == offsetof(TradeResponse, broker_order_id));
+static_assert(offsetof(trade_response_record, internal_security_id) == offsetof(TradeResponse, internal_security_id));
+static_assert(offsetof(trade_response_record, trade_side) == offsetof(TradeResponse, trade_side));
+static_assert(offsetof(trade_response_record, new_state) == offsetof(TradeResponse, new_state));
+static_assert(offsetof(trade_response_record, volume_traded) == offsetof(TradeResponse, volume_traded));
+static_assert(offsetof(trade_response_record, cancelled_volume) == offsetof(TradeResponse, cancelled_volume));
+static_assert(offsetof(trade_response_record, price_traded) == offsetof(TradeResponse, dprice_traded));
+static_assert(offsetof(trade_response_record, value_traded) == offsetof(TradeResponse, dvalue_traded));
+static_assert(offsetof(trade_response_record, fee) == offsetof(TradeResponse, dfee));
+static_assert(offsetof(trade_response_record, md_time_traded) == offsetof(TradeResponse, md_time_traded));
+static_assert(offsetof(trade_response_record, recv_time_ns) == offsetof(TradeResponse, recv_time_ns));
+static_assert(static_cast<uint8_t>(broker_api::response_state::BrokerRejected) ==
+              static_cast<uint8_t>(OrderState::BrokerRejected));
+static_assert(static_cast<uint8_t>(broker_api::response_state::BrokerAccepted) ==
+              static_cast<uint8_t>(OrderState::BrokerAccepted));
+static_assert(static_cast<uint8_t>(broker_api::response_state::MarketRejected) ==
+              static_cast<uint8_t>(OrderState::MarketRejected));
+static_assert(static_cast<uint8_t>(broker_api::response_state::MarketAccepted) ==
+              static_cast<uint8_t>(OrderState::MarketAccepted));
+static_assert(static_cast<uint8_t>(broker_api::response_state::Finished) == static_cast<uint8_t>(OrderState::Finished));
+static_assert(static_cast<uint8_t>(broker_api::side::Buy) == static_cast<uint8_t>(TradeSide::Buy));
+static_assert(static_cast<uint8_t>(broker_api::side::Sell) == static_cast<uint8_t>(TradeSide::Sell));
+
 // broker_event 类型与 OrderState 的映射关系。
 OrderState map_event_kind_to_state(broker_api::event_kind kind) noexcept {
     switch (kind) {
@@ -47,9 +77,16 @@ bool map_broker_event_to_trade_response(const broker_api::broker_event& event, T
     out_response = TradeResponse{};
     out_response.internal_order_id = event.internal_order_id;
     out_response.broker_order_id = event.broker_order_id;
+    static_assert(sizeof(event.internal_security_id) == sizeof(out_response.internal_security_id.data),
+                  "internal security id width must match broker_api");
     const std::size_t key_len = ::strnlen(event.internal_security_id, sizeof(event.internal_security_id));
     const std::string_view raw_security_id(event.internal_security_id, key_len);
-    if (!raw_security_id.empty()) {
+    if (key_len > 4 && has_canonical_mic_prefix(event.internal_security_id)) {
+        // canonical MIC 键直接整块拷贝
+        std::memcpy(out_response.internal_security_id.data, event.internal_security_id,
+                    sizeof(out_response.internal_security_id.data));
+        out_response.internal_security_id.data[sizeof(out_response.internal_security_id.data) - 1] = '\0';
+    } else if (!raw_security_id.empty()) {
         // 兼容历史插件仍回传旧格式证券键，但服务内始终存 canonical MIC。
         if (!normalize_internal_security_id(raw_security_id, out_response.internal_security_id)) {
             return false;
@@ -69,4 +106,40 @@ bool map_broker_event_to_trade_response(const broker_api::broker_event& event, T
     return true;
 }
 
+bool finalize_trade_response(TradeResponse& response) noexcept {
+    if (response.internal_order_id == 0) {
+        return false;
+    }
+    switch (response.new_state) {
+        case OrderState::BrokerAccepted:
+        case OrderState::BrokerRejected:
+        case OrderState::MarketRejected:
+        case OrderState::MarketAccepted:
+        case OrderState::Finished:
+            break;
+        default:
+            return false;
+    }
+
+    char* key = response.internal_security_id.data;
+    key[sizeof(response.internal_security_id.data) - 1] = '\0';
+    const std::size_t key_len = ::strnlen(key, sizeof(response.internal_security_id.data));
+    if (key_len > 0 && !(key_len > 4 && has_canonical_mic_prefix(key))) {
+        // 与 broker_event 路径一致：旧格式证券键规整为 canonical MIC，规整失败即丢弃
+        InternalSecurityId normalized;
+        if (!normalize_internal_security_id(std::string_view(key, key_len), normalized)) {
+            return false;
+        }
+        response.internal_security_id = normalized;
+    }
+    if (response.trade_side != TradeSide::Buy && response.trade_side != TradeSide::Sell) {
+        response.trade_side = TradeSide::NotSet;
+    }
+    response.padding0 = 0;
+    if (response.recv_time_ns == 0) {
+        response.recv_time_ns = now_ns();
+    }
+    return true;
+}
+
 }  // namespace acct_service::gateway
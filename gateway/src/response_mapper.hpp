@@ -9,4 +9,12 @@ namespace acct_service::gateway {
 bool map_broker_event_to_trade_response(
     const broker_api::broker_event& event, TradeResponse& out_response) noexcept;
 
+// 校验并规整适配器原地写入的直写回报：订单号非空、状态可识别、证券键规整为 canonical MIC、补接收时间。
+bool finalize_trade_response(TradeResponse& response) noexcept;
+
+// 分片回报环槽位按直写记录布局交给适配器填写（两者布局在 response_mapper.cpp 中逐字段断言一致）。
+inline broker_api::trade_response_record* as_response_records(TradeResponse* responses) noexcept {
+    return reinterpret_cast<broker_api::trade_response_record*>(responses);
+}
+
 }  // namespace acct_service::gateway
@@ -9,9 +9,24 @@ namespace acct_service::gateway {
 
 namespace {
 
-// 生成回报事件的通用字段，避免重复填充。
-broker_api::broker_event make_base_event(
-    broker_api::event_kind kind, const broker_api::broker_order_request& request, uint32_t broker_order_id) {
+// 成交定时器精度；模拟延迟以微秒配置，更细的粒度没有意义。
+constexpr TimestampNs kFillTimerResolutionNs = 1000;
+// 回报队列按每笔在途新单平均 4 条回报（受理 + 成交 + 完成 + 撤单受理）预分配。
+constexpr std::size_t kEventsPerActiveOrder = 4;
+// 在途池或回报队列已满：gateway 按可重试错误稍后重发。
+constexpr int32_t kSimBackpressureError = -105;
+
+std::size_t round_up_pow2(std::size_t value) noexcept {
+    std::size_t result = 1;
+    while (result < value) {
+        result <<= 1;
+    }
+    return result;
+}
+
+// 生成回报事件的通用字段，避免重复填充；同一次 submit/poll 产生的回报共用一个接收时间。
+broker_api::broker_event make_base_event(broker_api::event_kind kind, const broker_api::broker_order_request& request,
+                                         uint32_t broker_order_id, TimestampNs recv_ns) {
     broker_api::broker_event event;
     event.kind = kind;
     event.internal_order_id = request.internal_order_id;
@@ -19,23 +34,43 @@ broker_api::broker_event make_base_event(
     std::memcpy(event.internal_security_id, request.internal_security_id, sizeof(event.internal_security_id));
     event.trade_side = request.trade_side;
     event.md_time_traded = request.md_time;
-    event.recv_time_ns = now_ns();
+    event.recv_time_ns = recv_ns;
     return event;
 }
 
 }  // namespace
 
+sim_broker_adapter::sim_broker_adapter(const sim_fill_model& model)
+    : model_(model),
+      active_orders_(static_cast<std::size_t>(std::max<uint32_t>(model.max_active_orders, 1)) * 2),
+      fill_timers_(kFillTimerResolutionNs, std::max<uint32_t>(model.max_active_orders, 1)),
+      events_(round_up_pow2(static_cast<std::size_t>(std::max<uint32_t>(model.max_active_orders, 1)) *
+                            kEventsPerActiveOrder)) {
+    model_.max_active_orders = std::max<uint32_t>(model_.max_active_orders, 1);
+    model_.partial_fill_pct = std::min<uint32_t>(model_.partial_fill_pct, 100);
+    model_.reject_pct = std::min<uint32_t>(model_.reject_pct, 100);
+    model_.partial_fill_slices = std::clamp<uint32_t>(model_.partial_fill_slices, 2, kSimMaxFillSlices);
+}
+
 // 生成自然完成事件，保持“完成但未撤单”的 cancelled_volume 为 0。
-broker_api::broker_event sim_broker_adapter::make_natural_finish_event(const broker_api::broker_order_request& request,
-                                                                       uint32_t broker_order_id) {
-    broker_api::broker_event event = make_base_event(broker_api::event_kind::Finished, request, broker_order_id);
+broker_api::broker_event sim_broker_adapter::make_natural_finish_event(const active_order_state& active_order,
+                                                                       TimestampNs recv_ns) {
+    broker_api::broker_event event;
+    event.kind = broker_api::event_kind::Finished;
+    event.internal_order_id = active_order.internal_order_id;
+    event.broker_order_id = active_order.broker_order_id;
+    std::memcpy(event.internal_security_id, active_order.internal_security_id, sizeof(event.internal_security_id));
+    event.trade_side = active_order.trade_side;
+    event.md_time_traded = active_order.md_time;
+    event.recv_time_ns = recv_ns;
     event.cancelled_volume = 0;
     return event;
 }
 
 // 生成撤单完成事件，并把当前未成交剩余量作为权威 cancelled_volume 返回。
 broker_api::broker_event sim_broker_adapter::make_cancel_finish_event(const broker_api::broker_order_request& request,
-                                                                      const active_order_state& active_order) {
+                                                                      const active_order_state& active_order,
+                                                                      TimestampNs recv_ns) {
     broker_api::broker_order_request original_request{};
     original_request.internal_order_id = request.orig_internal_order_id;
     original_request.orig_internal_order_id = request.orig_internal_order_id;
@@ -49,26 +84,33 @@ broker_api::broker_event sim_broker_adapter::make_cancel_finish_event(const brok
     original_request.md_time = request.md_time;
 
     broker_api::broker_event event = make_base_event(broker_api::event_kind::Finished, original_request,
-                                                     active_order.broker_order_id);
+                                                     active_order.broker_order_id, recv_ns);
     event.cancelled_volume =
         (active_order.traded_volume >= active_order.entrust_volume) ? 0 : (active_order.entrust_volume - active_order.traded_volume);
     return event;
 }
 
-// 初始化模拟适配器运行状态。
+// 初始化模拟适配器运行状态；池与队列在构造时已分配，这里只清空。
 bool sim_broker_adapter::initialize(const broker_api::broker_runtime_config& config) {
+    std::lock_guard<std::mutex> lock(mutex_);
     runtime_config_ = config;
     initialized_ = true;
     next_broker_order_id_ = 1;
+    rng_state_ = model_.seed;
     active_orders_.clear();
-    pending_events_.clear();
+    fill_timers_.clear();
+    event_head_ = 0;
+    event_tail_ = 0;
+    reserved_events_ = 0;
     return true;
 }
 
 // 模拟 submit 行为：
-// - New: 受理，按配置可自动产生成交+完成回报
-// - Cancel: 受理并完成
+// - New: 按成交模型受理或拒单；受理后按配置立即或延迟分片产生成交+完成回报
+// - Cancel: 受理并完成，在途新单返回权威剩余撤销量
+// - Replace: 在途新单改量改价后受理并完成改单请求
 broker_api::send_result sim_broker_adapter::submit(const broker_api::broker_order_request& request) {
+    std::lock_guard<std::mutex> lock(mutex_);
     if (!initialized_) {
         return broker_api::send_result::fatal_error(-100);
     }
@@ -77,82 +119,334 @@ broker_api::send_result sim_broker_adapter::submit(const broker_api::broker_orde
     }
 
     if (request.type == broker_api::request_type::New) {
-        if (request.trade_side == broker_api::side::Unknown || request.order_market == broker_api::market::Unknown ||
-            request.volume == 0 || request.price == 0 || request.security_id[0] == 0) {
-            return broker_api::send_result::fatal_error(-102);
+        return submit_new(request, now_ns());
+    }
+    if (request.type == broker_api::request_type::Cancel) {
+        return submit_cancel(request, now_ns());
+    }
+    if (request.type == broker_api::request_type::Replace) {
+        return submit_replace(request, now_ns());
+    }
+    return broker_api::send_result::fatal_error(-104);
+}
+
+broker_api::send_result sim_broker_adapter::submit_new(const broker_api::broker_order_request& request,
+                                                       TimestampNs recv_ns) {
+    if (request.trade_side == broker_api::side::Unknown || request.order_market == broker_api::market::Unknown ||
+        request.volume == 0 || request.price == 0 || request.security_id[0] == 0) {
+        return broker_api::send_result::fatal_error(-102);
+    }
+
+    if (model_.reject_pct != 0 && roll_pct(model_.reject_pct)) {
+        if (!has_event_room(1)) {
+            return broker_api::send_result::retryable_error(kSimBackpressureError);
         }
+        push_event(
+            make_base_event(broker_api::event_kind::BrokerRejected, request, next_broker_order_id_++, recv_ns));
+        return broker_api::send_result::ok();
+    }
+
+    // 受理 1 条 + 每片成交 1 条 + 完成 1 条；不自动成交时只为将来撤单的完成事件预留 1 条。
+    uint32_t slices = 0;
+    if (runtime_config_.auto_fill) {
+        slices = (model_.partial_fill_pct != 0 && roll_pct(model_.partial_fill_pct)) ? model_.partial_fill_slices : 1;
+        slices = static_cast<uint32_t>(std::min<uint64_t>(slices, request.volume));
+    }
+    const uint32_t future_events = slices + 1;
+    if (active_orders_.size() >= model_.max_active_orders || !has_event_room(1 + future_events)) {
+        return broker_api::send_result::retryable_error(kSimBackpressureError);
+    }
+    active_order_state* active_order = active_orders_.try_emplace(request.internal_order_id);
+    if (active_order == nullptr) {
+        return broker_api::send_result::retryable_error(kSimBackpressureError);
+    }
+
+    const uint32_t broker_order_id = next_broker_order_id_++;
+    active_order->internal_order_id = request.internal_order_id;
+    active_order->broker_order_id = broker_order_id;
+    std::memcpy(active_order->internal_security_id, request.internal_security_id,
+                sizeof(active_order->internal_security_id));
+    active_order->trade_side = request.trade_side;
+    active_order->entrust_volume = request.volume;
+    active_order->traded_volume = 0;
+    active_order->price = request.price;
+    active_order->md_time = request.md_time;
+    active_order->slices_left = slices;
+    active_order->slice_volume = slices == 0 ? 0 : request.volume / slices;
+    active_order->reserved_events = future_events;
+    active_order->fill_timer = kInvalidTimerId;
+    reserved_events_ += future_events;
+    push_event(make_base_event(broker_api::event_kind::BrokerAccepted, request, broker_order_id, recv_ns));
+
+    if (slices == 0) {
+        return broker_api::send_result::ok();
+    }
+    const TimestampNs delay_ns = sample_fill_delay_ns();
+    if (delay_ns == 0 && slices == 1) {
+        // 零延迟整单成交：与原先的 auto_fill 行为一致，在 submit 内直接吐出成交与完成。
+        emit_fill_slice(*active_order, 0, recv_ns);
+        return broker_api::send_result::ok();
+    }
+    const TimestampNs now_mono = now_monotonic_ns();
+    active_order->fill_timer = fill_timers_.schedule(now_mono, now_mono + delay_ns, request.internal_order_id);
+    return broker_api::send_result::ok();
+}
+
+broker_api::send_result sim_broker_adapter::submit_cancel(const broker_api::broker_order_request& request,
+                                                          TimestampNs recv_ns) {
+    if (request.orig_internal_order_id == 0) {
+        return broker_api::send_result::fatal_error(-103);
+    }
+
+    active_order_state* active_order = active_orders_.find(request.orig_internal_order_id);
+    // 在途单的完成事件已有预留，只需为撤单受理留 1 条；未知订单需受理 + 完成 2 条。
+    if (!has_event_room(active_order != nullptr ? 1 : 2)) {
+        return broker_api::send_result::retryable_error(kSimBackpressureError);
+    }
 
-        const uint32_t broker_order_id = next_broker_order_id_++;
-        active_order_state active_order{};
-        active_order.broker_order_id = broker_order_id;
-        active_order.trade_side = request.trade_side;
-        active_order.entrust_volume = request.volume;
-        active_order.traded_volume = 0;
-        active_order.price = request.price;
-        active_order.md_time = request.md_time;
-        active_orders_[request.internal_order_id] = active_order;
-        pending_events_.push_back(make_base_event(broker_api::event_kind::BrokerAccepted, request, broker_order_id));
-
-        if (runtime_config_.auto_fill) {
-            broker_api::broker_event trade_event = make_base_event(broker_api::event_kind::Trade, request, broker_order_id);
-            trade_event.volume_traded = request.volume;
-            trade_event.price_traded = request.price;
-            trade_event.value_traded = calc_trade_value(request.volume, request.price);
-            trade_event.fee = calc_fee(trade_event.value_traded);
-            active_orders_[request.internal_order_id].traded_volume = request.volume;
-            pending_events_.push_back(trade_event);
-            pending_events_.push_back(make_natural_finish_event(request, broker_order_id));
-            active_orders_.erase(request.internal_order_id);
+    const uint32_t broker_order_id = next_broker_order_id_++;
+    push_event(make_base_event(broker_api::event_kind::BrokerAccepted, request, broker_order_id, recv_ns));
+
+    if (active_order != nullptr) {
+        if (active_order->fill_timer != kInvalidTimerId) {
+            (void)fill_timers_.cancel(active_order->fill_timer);
         }
+        reserved_events_ -= active_order->reserved_events;
+        push_event(make_cancel_finish_event(request, *active_order, recv_ns));
+        active_orders_.erase(request.orig_internal_order_id);
+    } else {
+        broker_api::broker_event finish_event =
+            make_base_event(broker_api::event_kind::Finished, request, broker_order_id, recv_ns);
+        finish_event.cancelled_volume = 0;
+        push_event(finish_event);
+    }
+    return broker_api::send_result::ok();
+}
+
+broker_api::send_result sim_broker_adapter::submit_replace(const broker_api::broker_order_request& request,
+                                                           TimestampNs recv_ns) {
+    if (request.orig_internal_order_id == 0 || request.volume == 0 || request.price == 0) {
+        return broker_api::send_result::fatal_error(-106);
+    }
+
+    active_order_state* active_order = active_orders_.find(request.orig_internal_order_id);
+    const bool amendable = active_order != nullptr && request.volume > active_order->traded_volume;
+    if (!has_event_room(amendable ? 2 : 1)) {
+        return broker_api::send_result::retryable_error(kSimBackpressureError);
+    }
 
+    const uint32_t broker_order_id = next_broker_order_id_++;
+    if (!amendable) {
+        push_event(make_base_event(broker_api::event_kind::BrokerRejected, request, broker_order_id, recv_ns));
         return broker_api::send_result::ok();
     }
 
-    if (request.type == broker_api::request_type::Cancel) {
-        if (request.orig_internal_order_id == 0) {
-            return broker_api::send_result::fatal_error(-103);
+    // 剩余片数不变，按改后的剩余量重新均分
+    active_order->entrust_volume = request.volume;
+    active_order->price = request.price;
+    if (active_order->slices_left > 0) {
+        active_order->slice_volume =
+            std::max<uint64_t>(1, (request.volume - active_order->traded_volume) / active_order->slices_left);
+    }
+    push_event(make_base_event(broker_api::event_kind::BrokerAccepted, request, broker_order_id, recv_ns));
+    broker_api::broker_event finish_event =
+        make_base_event(broker_api::event_kind::Finished, request, broker_order_id, recv_ns);
+    finish_event.cancelled_volume = 0;
+    push_event(finish_event);
+    return broker_api::send_result::ok();
+}
+
+// 重启前的柜台会话视为仍然有效：在途单按快照中的已成交量续上，编号序列跳过已分配的柜台编号。
+// 在途池或回报队列不足时停止接管，余下订单由账户侧按未知订单处理。
+std::size_t sim_broker_adapter::recover(const broker_api::broker_inflight_order* orders, std::size_t count) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!initialized_ || orders == nullptr) {
+        return 0;
+    }
+
+    const TimestampNs now_mono = now_monotonic_ns();
+    std::size_t recovered = 0;
+    for (std::size_t i = 0; i < count; ++i) {
+        const broker_api::broker_order_request& request = orders[i].request;
+        if (request.type != broker_api::request_type::New || request.internal_order_id == 0 ||
+            orders[i].traded_volume >= request.volume || active_orders_.contains(request.internal_order_id)) {
+            continue;
+        }
+        const uint32_t slices = runtime_config_.auto_fill ? 1 : 0;
+        const uint32_t future_events = slices + 1;
+        if (active_orders_.size() >= model_.max_active_orders || !has_event_room(future_events)) {
+            break;
+        }
+        active_order_state* active_order = active_orders_.try_emplace(request.internal_order_id);
+        if (active_order == nullptr) {
+            break;
         }
 
-        const uint32_t broker_order_id = next_broker_order_id_++;
-        pending_events_.push_back(make_base_event(broker_api::event_kind::BrokerAccepted, request, broker_order_id));
-
-        const auto active_it = active_orders_.find(request.orig_internal_order_id);
-        if (active_it != active_orders_.end()) {
-            pending_events_.push_back(make_cancel_finish_event(request, active_it->second));
-            active_orders_.erase(active_it);
-        } else {
-            broker_api::broker_event finish_event = make_base_event(broker_api::event_kind::Finished, request,
-                                                                    broker_order_id);
-            finish_event.cancelled_volume = 0;
-            pending_events_.push_back(finish_event);
+        uint32_t broker_order_id = orders[i].broker_order_id;
+        if (broker_order_id == 0) {
+            broker_order_id = next_broker_order_id_++;
         }
-        return broker_api::send_result::ok();
+        next_broker_order_id_ = std::max(next_broker_order_id_, broker_order_id + 1);
+        active_order->internal_order_id = request.internal_order_id;
+        active_order->broker_order_id = broker_order_id;
+        std::memcpy(active_order->internal_security_id, request.internal_security_id,
+                    sizeof(active_order->internal_security_id));
+        active_order->trade_side = request.trade_side;
+        active_order->entrust_volume = request.volume;
+        active_order->traded_volume = orders[i].traded_volume;
+        active_order->price = request.price;
+        active_order->md_time = request.md_time;
+        active_order->slices_left = slices;
+        active_order->slice_volume = request.volume - orders[i].traded_volume;
+        active_order->reserved_events = future_events;
+        active_order->fill_timer = kInvalidTimerId;
+        reserved_events_ += future_events;
+        if (slices != 0) {
+            active_order->fill_timer =
+                fill_timers_.schedule(now_mono, now_mono + sample_fill_delay_ns(), request.internal_order_id);
+        }
+        ++recovered;
     }
+    return recovered;
+}
 
-    return broker_api::send_result::fatal_error(-104);
+// 按片均分委托量，余量并入最后一片。
+void sim_broker_adapter::emit_fill_slice(active_order_state& active_order, TimestampNs now_mono_ns,
+                                         TimestampNs recv_ns) {
+    const uint64_t remaining = active_order.entrust_volume - active_order.traded_volume;
+    const uint64_t volume = active_order.slices_left <= 1 ? remaining : std::min(remaining, active_order.slice_volume);
+
+    broker_api::broker_event trade_event;
+    trade_event.kind = broker_api::event_kind::Trade;
+    trade_event.internal_order_id = active_order.internal_order_id;
+    trade_event.broker_order_id = active_order.broker_order_id;
+    std::memcpy(trade_event.internal_security_id, active_order.internal_security_id,
+                sizeof(trade_event.internal_security_id));
+    trade_event.trade_side = active_order.trade_side;
+    trade_event.md_time_traded = active_order.md_time;
+    trade_event.recv_time_ns = recv_ns;
+    trade_event.volume_traded = volume;
+    trade_event.price_traded = active_order.price;
+    trade_event.value_traded = calc_trade_value(volume, active_order.price);
+    trade_event.fee = calc_fee(trade_event.value_traded);
+
+    active_order.traded_volume += volume;
+    --active_order.slices_left;
+    --active_order.reserved_events;
+    --reserved_events_;
+    push_event(trade_event);
+
+    if (active_order.slices_left == 0) {
+        reserved_events_ -= active_order.reserved_events;
+        push_event(make_natural_finish_event(active_order, recv_ns));
+        active_order.fill_timer = kInvalidTimerId;
+        active_orders_.erase(active_order.internal_order_id);
+        return;
+    }
+    active_order.fill_timer = fill_timers_.schedule(now_mono_ns, now_mono_ns + sample_fill_delay_ns(),
+                                                    active_order.internal_order_id);
 }
 
-// 批量拉取回报事件给 gateway。
+// 先推进成交定时器把到期成交排入队列，再批量拉取回报事件给 gateway。
 std::size_t sim_broker_adapter::poll_events(broker_api::broker_event* out_events, std::size_t max_events) {
+    std::lock_guard<std::mutex> lock(mutex_);
     if (!initialized_ || !out_events || max_events == 0) {
         return 0;
     }
 
-    const std::size_t count = std::min(max_events, pending_events_.size());
+    advance_fill_timers();
+    const std::size_t mask = events_.size() - 1;
+    const std::size_t count = std::min(max_events, event_tail_ - event_head_);
     for (std::size_t i = 0; i < count; ++i) {
-        out_events[i] = pending_events_.front();
-        pending_events_.pop_front();
+        out_events[i] = events_[(event_head_ + i) & mask];
     }
+    event_head_ += count;
     return count;
 }
 
-// 关闭适配器并清理缓存事件。
+// 逐段申请网关回报槽位并原地填写；网关回报环满时剩余事件留在本地队列，下次再交。
+std::size_t sim_broker_adapter::poll_responses(const broker_api::response_writer& writer, std::size_t max_responses) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!initialized_ || writer.claim == nullptr || writer.publish == nullptr || max_responses == 0) {
+        return 0;
+    }
+
+    advance_fill_timers();
+    const std::size_t mask = events_.size() - 1;
+    std::size_t written = 0;
+    while (written < max_responses && event_head_ != event_tail_) {
+        broker_api::trade_response_record* slots = nullptr;
+        const std::size_t wanted = std::min(max_responses - written, event_tail_ - event_head_);
+        const std::size_t claimed = writer.claim(writer.context, wanted, &slots);
+        if (claimed == 0 || slots == nullptr) {
+            break;
+        }
+        std::size_t filled = 0;
+        for (std::size_t i = 0; i < claimed; ++i) {
+            if (broker_api::fill_response_record(events_[(event_head_ + i) & mask], slots[filled])) {
+                ++filled;
+            }
+        }
+        event_head_ += claimed;
+        writer.publish(writer.context, filled);
+        written += filled;
+    }
+    return written;
+}
+
+void sim_broker_adapter::advance_fill_timers() {
+    if (fill_timers_.empty()) {
+        return;
+    }
+    const TimestampNs now_mono = now_monotonic_ns();
+    const TimestampNs recv_ns = now_ns();
+    fill_timers_.advance(now_mono, [this, now_mono, recv_ns](uint32_t internal_order_id) {
+        active_order_state* active_order = active_orders_.find(internal_order_id);
+        if (active_order != nullptr) {
+            active_order->fill_timer = kInvalidTimerId;
+            emit_fill_slice(*active_order, now_mono, recv_ns);
+        }
+    });
+}
+
+// 关闭适配器并清理缓存事件与在途订单。
 void sim_broker_adapter::shutdown() noexcept {
+    std::lock_guard<std::mutex> lock(mutex_);
     active_orders_.clear();
-    pending_events_.clear();
+    fill_timers_.clear();
+    event_head_ = 0;
+    event_tail_ = 0;
+    reserved_events_ = 0;
     initialized_ = false;
 }
 
+bool sim_broker_adapter::has_event_room(std::size_t count) const noexcept {
+    return (event_tail_ - event_head_) + reserved_events_ + count <= events_.size();
+}
+
+void sim_broker_adapter::push_event(const broker_api::broker_event& event) noexcept {
+    events_[event_tail_ & (events_.size() - 1)] = event;
+    ++event_tail_;
+}
+
+// splitmix64：状态只由 seed 与调用次数决定，保证回放确定性。
+uint64_t sim_broker_adapter::next_random() noexcept {
+    uint64_t value = (rng_state_ += 0x9E3779B97F4A7C15ULL);
+    value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    value = (value ^ (value >> 27)) * 0x94D049BB133111EBULL;
+    return value ^ (value >> 31);
+}
+
+bool sim_broker_adapter::roll_pct(uint32_t pct) noexcept { return next_random() % 100 < pct; }
+
+TimestampNs sim_broker_adapter::sample_fill_delay_ns() noexcept {
+    uint64_t delay_us = model_.fill_latency_us;
+    if (model_.fill_jitter_us != 0) {
+        delay_us += next_random() % (static_cast<uint64_t>(model_.fill_jitter_us) + 1);
+    }
+    return static_cast<TimestampNs>(delay_us) * 1000ULL;
+}
+
 // 简化的成交金额计算。
 uint64_t sim_broker_adapter::calc_trade_value(uint64_t volume, uint64_t price) noexcept {
     if (volume == 0 || price == 0) {
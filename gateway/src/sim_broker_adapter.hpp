@@ -1,52 +1,111 @@
 #pragma once
 
-#include <deque>
-#include <unordered_map>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
 
 #include "broker_api/broker_api.hpp"
+#include "common/flat_hash_map.hpp"
+#include "common/timer_wheel.hpp"
+#include "gateway_config.hpp"
 
 namespace acct_service::gateway {
 
-// 模拟券商适配器：用于本地联调和端到端测试。
+// 模拟柜台成交模型：全部为 0 时与原先一致，受理即全额成交；同一 seed 与同一请求序列产生完全相同的回报序列。
+struct sim_fill_model {
+    uint32_t fill_latency_us = 0;      // 受理到每片成交的基础延迟
+    uint32_t fill_jitter_us = 0;       // 每片在基础延迟上叠加 [0, jitter] 的均匀抖动
+    uint32_t partial_fill_pct = 0;     // 按分片成交的订单占比（0-100），其余订单一次成交
+    uint32_t partial_fill_slices = 2;  // 分片成交的片数 [2, kSimMaxFillSlices]
+    uint32_t reject_pct = 0;           // 新单柜台拒单占比（0-100）
+    uint64_t seed = 1;
+    uint32_t max_active_orders = 16384;  // 在途新单池容量，满时 submit 返回可重试错误
+};
+
+// 模拟券商适配器：用于本地联调、端到端测试与压测。
+// 在途订单、回报队列与成交定时器都在构造时按 max_active_orders 预分配，稳态下 submit/poll 不分配内存。
 class sim_broker_adapter final : public broker_api::IBrokerAdapter {
 public:
+    sim_broker_adapter() : sim_broker_adapter(sim_fill_model{}) {}
+    explicit sim_broker_adapter(const sim_fill_model& model);
+
     bool initialize(const broker_api::broker_runtime_config& config) override;
     broker_api::send_result submit(const broker_api::broker_order_request& request) override;
     std::size_t poll_events(broker_api::broker_event* out_events, std::size_t max_events) override;
+    bool supports_replace() const noexcept override { return true; }
+    // 模拟高吞吐柜台：回报直接填进网关借出的回报槽位
+    bool supports_response_writer() const noexcept override { return true; }
+    std::size_t poll_responses(const broker_api::response_writer& writer, std::size_t max_responses) override;
+    // 柜台编号按会话从 1 递增分配
+    bool dense_broker_order_ids() const noexcept override { return true; }
+    // 热重启：按快照重建在途表，不补发受理；auto_fill 时剩余量在一次成交延迟后整片成交
+    std::size_t recover(const broker_api::broker_inflight_order* orders, std::size_t count) override;
     void shutdown() noexcept override;
 
 private:
     struct active_order_state {
+        uint32_t internal_order_id = 0;
         uint32_t broker_order_id = 0;
+        char internal_security_id[broker_api::kInternalSecurityIdSize]{};
         broker_api::side trade_side = broker_api::side::Unknown;
         uint64_t entrust_volume = 0;
         uint64_t traded_volume = 0;
         uint64_t price = 0;
         uint32_t md_time = 0;
-        bool finalized = false;
+        uint64_t slice_volume = 0;     // 非末片的单片成交量，末片补足余量
+        uint32_t slices_left = 0;      // 尚未吐出的成交片数，0 表示不自动成交（等待撤单）
+        uint32_t reserved_events = 0;  // 已为本单预留、尚未入队的回报条数
+        timer_id fill_timer = kInvalidTimerId;
     };
 
     // 生成自然完成事件，明确 cancelled_volume 为 0。
-    static broker_api::broker_event make_natural_finish_event(const broker_api::broker_order_request& request,
-                                                              uint32_t broker_order_id);
+    static broker_api::broker_event make_natural_finish_event(const active_order_state& active_order,
+                                                              TimestampNs recv_ns);
 
     // 生成撤单完成事件，并带上权威剩余撤销量。
     static broker_api::broker_event make_cancel_finish_event(const broker_api::broker_order_request& request,
-                                                             const active_order_state& active_order);
+                                                             const active_order_state& active_order,
+                                                             TimestampNs recv_ns);
 
     // 计算成交金额（volume * price，单位保持为分）。
     static uint64_t calc_trade_value(uint64_t volume, uint64_t price) noexcept;
     // 计算简化手续费（MVP 近似模型）。
     static uint64_t calc_fee(uint64_t traded_value) noexcept;
 
+    broker_api::send_result submit_new(const broker_api::broker_order_request& request, TimestampNs recv_ns);
+    broker_api::send_result submit_cancel(const broker_api::broker_order_request& request, TimestampNs recv_ns);
+    // 改单：在途新单就地改量改价；原单不在途或改后数量不足已成交量时拒绝改单
+    broker_api::send_result submit_replace(const broker_api::broker_order_request& request, TimestampNs recv_ns);
+    // 吐出一片成交；最后一片同时吐出完成事件并释放在途槽位，否则按下一片延迟重新登记定时器。
+    void emit_fill_slice(active_order_state& active_order, TimestampNs now_mono_ns, TimestampNs recv_ns);
+    // 触发已到期的成交定时器，调用方持锁。
+    void advance_fill_timers();
+    // 需要的回报条数超过队列剩余容量（扣除已预留部分）时返回 false。
+    bool has_event_room(std::size_t count) const noexcept;
+    void push_event(const broker_api::broker_event& event) noexcept;
+    uint64_t next_random() noexcept;
+    bool roll_pct(uint32_t pct) noexcept;
+    TimestampNs sample_fill_delay_ns() noexcept;
+
+    // 网关拆分轮询线程时 submit 与 poll_events 会并发进入，统一加锁保护下列状态。
+    std::mutex mutex_;
+    sim_fill_model model_{};
     broker_api::broker_runtime_config runtime_config_{};
     bool initialized_ = false;
     // 模拟柜台订单号自增序列。
     uint32_t next_broker_order_id_ = 1;
-    // 跟踪在途新单，供撤单完成事件回填权威剩余撤销量。
-    std::unordered_map<uint32_t, active_order_state> active_orders_;
-    // 待吐出的回报队列（由 poll_events 批量取走）。
-    std::deque<broker_api::broker_event> pending_events_;
+    uint64_t rng_state_ = 0;
+    // 跟踪在途新单，供分片成交与撤单完成事件回填权威剩余撤销量。
+    flat_hash_map<uint32_t, active_order_state> active_orders_;
+    // 按成交时刻调度在途新单的下一片成交，载荷为 internal_order_id。
+    timer_wheel<uint32_t> fill_timers_;
+    // 待吐出的回报环形队列（由 poll_events 批量取走），容量为 2 的幂。
+    std::vector<broker_api::broker_event> events_;
+    std::size_t event_head_ = 0;
+    std::size_t event_tail_ = 0;
+    // 在途订单将来还会入队的回报条数，submit 按此为其预留队列空间，定时器触发时不会写满。
+    std::size_t reserved_events_ = 0;
 };
 
 }  // namespace acct_service::gateway
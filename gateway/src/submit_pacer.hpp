@@ -0,0 +1,76 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+
+#include "common/types.hpp"
+
+namespace acct_service::gateway {
+
+// 单个柜台会话的报单节流令牌桶：按每秒 rate 个令牌匀速补充，桶深为 burst_ms 内的补充量。
+// 新单只能取用预留份额之上的令牌；撤单可取用全部令牌，余额不足时透支（撤单从不等待），
+// 透支在后续补充中先行扣回，长期速率仍不超过 rate。
+// 整数定点表示：1 个令牌 = kUnit 个单位，每纳秒补充 rate 个单位。
+class submit_pacer {
+public:
+    static constexpr int64_t kUnit = 1'000'000'000LL;
+
+    // per_second 为 0 时关闭节流；cancel_reserve_pct 为桶深中留给撤单的百分比，至少给新单留 1 个令牌
+    void configure(uint32_t per_second, uint32_t burst_ms, uint32_t cancel_reserve_pct) noexcept {
+        rate_ = per_second;
+        last_refill_ns_ = 0;
+        if (rate_ == 0) {
+            tokens_ = capacity_ = reserve_ = 0;
+            return;
+        }
+        const int64_t burst_tokens = std::max<int64_t>(1, static_cast<int64_t>(per_second) * burst_ms / 1000);
+        const int64_t reserve_tokens =
+            std::min<int64_t>(burst_tokens * std::min<uint32_t>(cancel_reserve_pct, 100) / 100, burst_tokens - 1);
+        capacity_ = burst_tokens * kUnit;
+        reserve_ = reserve_tokens * kUnit;
+        tokens_ = capacity_;
+    }
+
+    bool enabled() const noexcept { return rate_ != 0; }
+
+    // 为一笔新单（或改单）取令牌；余额不高于撤单预留时返回 false，调用方应排队等待
+    bool try_acquire_new(TimestampNs now) noexcept {
+        refill(now);
+        if (tokens_ - kUnit < reserve_) {
+            return false;
+        }
+        tokens_ -= kUnit;
+        return true;
+    }
+
+    // 为一笔撤单或重试提交扣令牌，不足时透支
+    void charge(TimestampNs now) noexcept {
+        refill(now);
+        tokens_ -= kUnit;
+    }
+
+private:
+    void refill(TimestampNs now) noexcept {
+        if (last_refill_ns_ == 0 || now <= last_refill_ns_) {
+            last_refill_ns_ = last_refill_ns_ == 0 ? now : last_refill_ns_;
+            return;
+        }
+        const uint64_t elapsed = now - last_refill_ns_;
+        last_refill_ns_ = now;
+        // 先按缺口换算补满所需时间，避免 elapsed * rate 溢出
+        const uint64_t deficit = static_cast<uint64_t>(capacity_ - tokens_);
+        if (elapsed >= deficit / rate_ + 1) {
+            tokens_ = capacity_;
+        } else {
+            tokens_ += static_cast<int64_t>(elapsed * rate_);
+        }
+    }
+
+    int64_t tokens_ = 0;
+    int64_t capacity_ = 0;
+    int64_t reserve_ = 0;
+    uint64_t rate_ = 0;
+    TimestampNs last_refill_ns_ = 0;  // 0 表示尚未使用，首次使用时桶为满
+};
+
+}  // namespace acct_service::gateway
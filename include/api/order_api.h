@@ -33,6 +33,10 @@ typedef enum {
     ACCT_ERR_ORDER_NOT_FOUND = -5,
     ACCT_ERR_CACHE_FULL = -6,       // 订单缓存已满
     ACCT_ERR_ORDER_POOL_FULL = -7,  // 订单池容量耗尽
+    ACCT_ERR_NO_FREE_LANE = -8,     // 上游 lane 已被其他策略进程占满
+    ACCT_ERR_BASKET_ABORTED = -9,   // 整篮下单因其他条目失败而整体放弃
+    ACCT_ERR_TIMEOUT = -10,         // 等待超时，条件尚未满足
+    ACCT_ERR_RISK_REJECTED = -11,   // 本地风控预检拒绝（单笔金额/数量超限或价格超出涨跌停），未占用订单池槽位
     ACCT_ERR_INTERNAL = -99,
 } acct_error_t;
 
@@ -60,6 +64,19 @@ typedef enum {
     ACCT_PASSIVE_EXEC_ICEBERG = 5,
 } acct_passive_exec_algo_t;
 
+// ============ 批量撤单范围 ============
+typedef enum {
+    ACCT_MASS_CANCEL_ACCOUNT = 1,   // 账户内全部在途订单
+    ACCT_MASS_CANCEL_STRATEGY = 2,  // 指定策略的在途订单（策略ID即上游 lane 编号）
+    ACCT_MASS_CANCEL_SECURITY = 3,  // 指定证券的在途订单
+    ACCT_MASS_CANCEL_PARENT = 4,    // 指定父单及其子单
+} acct_mass_cancel_scope_t;
+
+// ============ 篮子下单选项 ============
+typedef enum {
+    ACCT_BASKET_ALL_OR_NOTHING = 1,  // 全部条目合法才提交；账户服务任一腿未通过风控或合并资金预留失败时整篮拒绝
+} acct_basket_flags_t;
+
 // ============ 上下文句柄 ============
 typedef struct acct_context* acct_ctx_t;
 
@@ -79,6 +96,51 @@ typedef struct acct_order_exec_options {
     uint8_t reserved[7];
 } acct_order_exec_options_t;
 
+// ============ 批量下单条目 ============
+// ============ 批量撤单条件 ============
+typedef struct acct_mass_cancel_spec {
+    uint8_t scope;             // acct_mass_cancel_scope_t
+    uint8_t market;            // SECURITY 范围使用
+    uint16_t strategy_id;      // STRATEGY 范围使用
+    uint32_t parent_order_id;  // PARENT 范围使用
+    const char* security_id;   // SECURITY 范围使用 (如 "000001")
+} acct_mass_cancel_spec_t;
+
+typedef struct acct_order_spec {
+    const char* security_id;    // 证券代码 (如 "000001")
+    uint64_t volume;            // 委托数量
+    double price;               // 委托价格 (单位: 元)
+    uint8_t side;               // acct_side_t
+    uint8_t market;             // acct_market_t
+    uint8_t passive_exec_algo;  // acct_passive_exec_algo_t，0=ACCT_PASSIVE_EXEC_DEFAULT
+    uint8_t reserved[5];
+} acct_order_spec_t;
+
+// acct_wait_order 的等待条件位，任一位满足即返回
+typedef enum {
+    ACCT_WAIT_DEQUEUED = 0x01,  // 账户服务已取走（槽位离开 Reserved/UpstreamQueued）
+    ACCT_WAIT_ACCEPTED = 0x02,  // 柜台或交易所已受理
+    ACCT_WAIT_TRADED = 0x04,    // 已有成交
+    ACCT_WAIT_REJECTED = 0x08,  // 风控/柜台/交易所拒绝或下发失败
+    ACCT_WAIT_TERMINAL = 0x10,  // 已终态（全部成交、撤单完成、拒绝等）
+} acct_wait_mask_t;
+
+// 本方订单回报（acct_poll_order_updates 输出）：账户服务在订单状态或成交变化时写入，金额与价格单位为分
+typedef struct acct_order_update {
+    uint32_t order_id;       // 订单号
+    uint32_t orig_order_id;  // 撤单对应的原单号（新单为 0）
+    uint8_t order_status;    // 内部状态码（与 order_monitor_api 快照的 order_status 同口径）
+    uint8_t event;           // 1=入簿 2=状态更新 3=成交更新 5=受管父单进度刷新 6=改单生效
+    uint8_t order_type;      // 1=New,2=Cancel,3=MassCancel,4=Replace
+    uint8_t reserved[5];
+    uint64_t volume_traded;  // 已成交数量
+    uint64_t volume_remain;  // 剩余数量
+    uint64_t dvalue_traded;  // 已成交金额（分）
+    uint64_t dprice_traded;  // 成交均价（分）
+    uint64_t dfee_executed;  // 已发生手续费（分）
+    uint64_t update_ns;      // 账户服务写入回报时的循环时间（ns）
+} acct_order_update_t;
+
 // ============ 初始化/销毁 ============
 
 /**
@@ -93,6 +155,8 @@ ACCT_API acct_error_t acct_init(acct_ctx_t* out_ctx);
  * @param options 初始化选项，允许传 NULL 使用默认值
  * @param out_ctx 输出参数：上下文句柄指针
  * @return 错误码，ACCT_OK 表示成功
+ * @note 账户服务配置 shm.upstream_lane_count > 1 时，每个上下文会独占认领一条上游 lane，
+ *       因此账户服务需先于策略进程启动；lane 全部被占用时返回 ACCT_ERR_NO_FREE_LANE
  */
 ACCT_API acct_error_t acct_init_ex(const acct_init_options_t* options, acct_ctx_t* out_ctx);
 
@@ -103,6 +167,18 @@ ACCT_API acct_error_t acct_init_ex(const acct_init_options_t* options, acct_ctx_
  */
 ACCT_API acct_error_t acct_destroy(acct_ctx_t ctx);
 
+/**
+ * @brief 从已初始化的上下文派生一个线程上下文，供多线程策略的单个线程独占使用
+ * @param ctx 已初始化的进程上下文（不能是线程上下文）
+ * @param out_thread_ctx 输出参数：线程上下文句柄
+ * @return 错误码，ACCT_OK 表示成功
+ * @note 线程上下文独占一条上游 lane，并持有自己的订单池映射、下标块与订单缓存，
+ *       各线程下单互不加锁、不共享可写缓存行；上游段映射借用 ctx，可直接用于全部下单/撤单接口。
+ *       需要 shm.upstream_lane_count > 1，lane 用尽时返回 ACCT_ERR_NO_FREE_LANE；
+ *       线程上下文以 acct_destroy 销毁，且须先于 ctx 销毁，否则 acct_destroy(ctx) 返回 ACCT_ERR_INVALID_PARAM
+ */
+ACCT_API acct_error_t acct_ctx_thread_attach(acct_ctx_t ctx, acct_ctx_t* out_thread_ctx);
+
 /**
  * @brief 清理共享内存（删除共享内存文件）
  * @return 错误码，ACCT_OK 表示成功
@@ -130,6 +206,8 @@ ACCT_API acct_error_t acct_new_order(acct_ctx_t ctx, const char* security_id, ui
 /**
  * @brief 创建新订单并指定逐单被动执行算法
  * @param exec_options 执行选项，可传 NULL 使用默认值
+ * @note 账户服务开启 shm.risk_params 时，占用槽位前按其发布的单笔金额/数量上限与涨跌停价格带预检，
+ *       不通过返回 ACCT_ERR_RISK_REJECTED（不记错误日志）；账户服务照常复检。new/submit 各接口相同
  */
 ACCT_API acct_error_t acct_new_order_ex(acct_ctx_t ctx, const char* security_id, uint8_t side, uint8_t market,
                                         uint64_t volume, double price, uint32_t valid_sec,
@@ -166,6 +244,32 @@ ACCT_API acct_error_t acct_submit_order_ex(acct_ctx_t ctx, const char* security_
                                            uint64_t volume, double price, uint32_t valid_sec,
                                            const acct_order_exec_options_t* exec_options, uint32_t* out_order_id);
 
+/**
+ * @brief 批量创建并发送订单（篮子下单）
+ * @param ctx 上下文
+ * @param specs 订单条目数组
+ * @param count 条目数量
+ * @param out_ids 输出参数：逐条订单ID，失败条目为 0
+ * @param out_results 输出参数：逐条错误码（与 specs 等长）
+ * @return 全部成功返回 ACCT_OK，否则返回首个失败条目的错误码
+ * @note 合法条目一次性预留连续订单池槽位与订单ID，写完槽位后按篮（每篮至多 256 条）入队并只敲一次门铃；
+ *       非法条目记 ACCT_ERR_INVALID_PARAM、本地风控预检不通过记 ACCT_ERR_RISK_REJECTED，均不占用槽位，订单池或队列不足时尾部条目
+ *       分别记 ACCT_ERR_ORDER_POOL_FULL / ACCT_ERR_QUEUE_FULL，已成功条目不受影响
+ */
+ACCT_API acct_error_t acct_submit_orders(acct_ctx_t ctx, const acct_order_spec_t* specs, size_t count,
+                                         uint32_t* out_ids, acct_error_t* out_results);
+
+/**
+ * @brief 篮子下单并指定篮子选项
+ * @param flags acct_basket_flags_t 按位组合，0 时与 acct_submit_orders 相同
+ * @return 同 acct_submit_orders
+ * @note 合法条目按每篮至多 256 条分篮入队，账户服务对一篮内的买单只合并冻结一次资金；
+ *       ACCT_BASKET_ALL_OR_NOTHING 要求条目数不超过 256 且全部合法、订单池与队列一次容纳，
+ *       否则不提交任何条目（其余合法条目记 ACCT_ERR_BASKET_ABORTED 或对应的容量错误）
+ */
+ACCT_API acct_error_t acct_submit_basket(acct_ctx_t ctx, const acct_order_spec_t* specs, size_t count,
+                                         uint32_t flags, uint32_t* out_ids, acct_error_t* out_results);
+
 // ============ 撤单接口 ============
 
 /**
@@ -175,10 +279,22 @@ ACCT_API acct_error_t acct_submit_order_ex(acct_ctx_t ctx, const char* security_
  * @param valid_sec 保留参数（暂未使用，传入 0 即可）
  * @param out_cancel_id 输出参数：撤单请求ID
  * @return 错误码，ACCT_OK 表示成功
+ * @note 撤单写入本 lane 的撤单优先队列，账户服务先于新单处理；原单尚未出队时撤单等原单入簿后再处理
  */
 ACCT_API acct_error_t acct_cancel_order(acct_ctx_t ctx, uint32_t orig_order_id, uint32_t valid_sec,
                                         uint32_t* out_cancel_id);
 
+/**
+ * @brief 发送批量撤单请求（异步）
+ * @param ctx 上下文
+ * @param spec 撤单范围与条件
+ * @param out_request_id 输出参数：批量撤单请求ID
+ * @return 错误码，ACCT_OK 表示已入队
+ * @note 仅向上游写入一条请求；账户服务按订单簿索引展开为逐笔撤单并一次批量推入下游，
+ *       请求本身不下发柜台，展开完成后即终结。入队成功不代表目标订单都已撤销
+ */
+ACCT_API acct_error_t acct_mass_cancel(acct_ctx_t ctx, const acct_mass_cancel_spec_t* spec, uint32_t* out_request_id);
+
 // ============ 辅助接口 ============
 
 /**
@@ -189,6 +305,72 @@ ACCT_API acct_error_t acct_cancel_order(acct_ctx_t ctx, uint32_t orig_order_id,
  */
 ACCT_API acct_error_t acct_queue_size(acct_ctx_t ctx, size_t* out_size);
 
+/**
+ * @brief 获取本上下文订单队列当前可用的入队额度
+ * @param ctx 上下文
+ * @param out_credits 输出参数：可立即入队的订单条数（队列容量减去账户服务尚未取走的条数）
+ * @return 错误码，ACCT_OK 表示成功
+ * @note 额度为 0 时下单直接返回 ACCT_ERR_QUEUE_FULL，不占用订单池槽位；
+ *       单笔撤单走撤单优先队列，不占该额度；篮子需整篮额度足够才会入队
+ */
+ACCT_API acct_error_t acct_available_credits(acct_ctx_t ctx, size_t* out_credits);
+
+/**
+ * @brief 等待本上下文订单队列的可用额度达到 min_credits
+ * @param ctx 上下文
+ * @param min_credits 需要的额度，1 到队列容量之间
+ * @param timeout_us 最长等待时间（微秒），0 表示只检查一次
+ * @param out_credits 可选输出：返回时的可用额度
+ * @return ACCT_OK 表示额度已足够；超时仍不足返回 ACCT_ERR_QUEUE_FULL（不记错误日志）
+ * @note 账户服务每轮从上游 lane 取走订单后按需唤醒等待者，等待期间线程休眠在 futex 上不占 CPU
+ */
+ACCT_API acct_error_t acct_wait_credits(acct_ctx_t ctx, size_t min_credits, uint32_t timeout_us,
+                                        size_t* out_credits);
+
+/**
+ * @brief 获取当前上下文写入的上游 lane 编号
+ * @param ctx 上下文
+ * @param out_lane 输出参数：lane 编号（单生产者模式恒为 0）
+ * @return 错误码，ACCT_OK 表示成功
+ */
+ACCT_API acct_error_t acct_upstream_lane(acct_ctx_t ctx, uint32_t* out_lane);
+
+/**
+ * @brief 阻塞等待订单达到指定条件
+ * @param ctx 上下文
+ * @param order_id 订单号（本上下文当前交易日订单池内的订单）
+ * @param state_mask acct_wait_mask_t 按位或，不能为 0
+ * @param timeout_ns 最长等待时间（ns），0 表示只判断一次
+ * @return ACCT_OK 表示条件已满足；超时返回 ACCT_ERR_TIMEOUT（不记错误日志）；
+ *         槽位不属于该订单返回 ACCT_ERR_ORDER_NOT_FOUND
+ * @note 在订单槽位 seq 上以 futex 休眠，账户服务写槽位时仅在有等待者时唤醒，无人等待时写路径不增加开销；
+ *       面向同步风格的工具与测试，低延迟策略应使用 acct_poll_order_updates
+ */
+ACCT_API acct_error_t acct_wait_order(acct_ctx_t ctx, uint32_t order_id, uint32_t state_mask, uint64_t timeout_ns);
+
+/**
+ * @brief 读取本上下文所提交订单的状态/成交回报
+ * @param ctx 上下文
+ * @param out_updates 输出数组
+ * @param max_updates 输出数组容量
+ * @param out_count 输出参数：本次取到的回报数，无新回报时为 0
+ * @return 错误码，ACCT_OK 表示成功
+ * @note 回报按账户服务处理顺序写入本上下文 lane 的回报环，读取为一次 SPSC 批量出队，无需扫描订单池；
+ *       拆单子单不单独回报，受管父单以 event=5 反映执行进度。同一 lane 只应由持有它的上下文读取，
+ *       接入时会丢弃该 lane 上前一持有者遗留的回报
+ */
+ACCT_API acct_error_t acct_poll_order_updates(acct_ctx_t ctx, acct_order_update_t* out_updates, size_t max_updates,
+                                              size_t* out_count);
+
+/**
+ * @brief 获取本上下文 lane 因回报环已满被丢弃的回报累计数
+ * @param ctx 上下文
+ * @param out_dropped 输出参数：累计丢弃数（lane 生命期内单调递增）
+ * @return 错误码，ACCT_OK 表示成功
+ * @note 计数增长说明读取不及时，丢失期间的订单状态需经 order_monitor_api 补读
+ */
+ACCT_API acct_error_t acct_order_updates_dropped(acct_ctx_t ctx, uint64_t* out_dropped);
+
 /**
  * @brief 获取错误描述字符串
  * @param err 错误码
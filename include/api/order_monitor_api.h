@@ -30,6 +30,8 @@ typedef enum {
     ACCT_MON_ERR_SHM_FAILED = -3,       // 共享内存打开/映射/校验失败
     ACCT_MON_ERR_NOT_FOUND = -4,        // 索引不可见（如 index >= next_index）
     ACCT_MON_ERR_RETRY = -5,            // 与写进程并发冲突，建议短暂退避后重试
+    ACCT_MON_ERR_LAGGED = -6,           // 变更游标落后超过日志环容量，部分变更已丢失，需全量补扫
+    ACCT_MON_ERR_UNAVAILABLE = -7,      // 订单二级索引未启用或不属于当前交易日，改用 read_range 扫描
     ACCT_MON_ERR_INTERNAL = -99,        // 内部错误
 } acct_mon_error_t;
 
@@ -40,6 +42,9 @@ typedef struct acct_orders_monitor_context* acct_orders_mon_ctx_t;
 #define ACCT_MON_SECURITY_ID_LEN 16
 #define ACCT_MON_INTERNAL_SECURITY_ID_LEN 16
 #define ACCT_MON_BROKER_ORDER_ID_LEN 32
+#define ACCT_MON_LATENCY_HOP_COUNT 6
+#define ACCT_MON_MAX_OVERFLOW_SEGMENTS 3  // 订单池溢出段上限
+#define ACCT_MON_INDEX_SEGMENT_SHIFT 20   // 槽位索引高位为段号：index = (段号 << 20) | 段内下标，段号 0 为主段
 
 // ============ 订单槽位阶段 ============
 typedef enum {
@@ -61,10 +66,22 @@ typedef enum {
     ACCT_MON_SOURCE_ACCOUNT_INTERNAL = 2,  // 账户服务内部生成（拆单/内部撤单等）
 } acct_mon_order_source_t;
 
+// ============ 全链路打点 ============
+typedef enum {
+    ACCT_MON_HOP_UPSTREAM_DEQUEUED = 0,  // 账户服务上游出队
+    ACCT_MON_HOP_RISK_ACCEPTED = 1,      // 风控通过
+    ACCT_MON_HOP_DOWNSTREAM_QUEUED = 2,  // 推入下游队列
+    ACCT_MON_HOP_GATEWAY_DEQUEUED = 3,   // gateway 出队
+    ACCT_MON_HOP_ADAPTER_SUBMITTED = 4,  // 适配器 submit 返回
+    ACCT_MON_HOP_FIRST_RESPONSE = 5,     // 账户服务处理首个回报
+} acct_mon_latency_hop_t;
+
 // ============ 打开参数 ============
 typedef struct acct_orders_mon_options {
     const char* orders_shm_name;  // 订单池 SHM 基础名（默认 "/orders_shm"）
     const char* trading_day;      // 交易日 YYYYMMDD（默认 ACCT_TRADING_DAY，否则 "19700101"）
+    uint32_t read_spin_count;     // acct_orders_mon_read 遇写入冲突时的 pause 自旋重试次数（0 取默认 64）
+    uint32_t read_yield_count;    // 自旋用尽后 sched_yield 再重试的次数（0 取默认 4），仍冲突才返回 RETRY
 } acct_orders_mon_options_t;
 
 // ============ 订单池头部信息 ============
@@ -77,6 +94,11 @@ typedef struct acct_orders_mon_info {
     uint64_t create_time_ns;                         // 创建时间（Unix Epoch ns）
     uint64_t last_update_ns;                         // 最近更新时间（Unix Epoch ns）
     char trading_day[ACCT_MON_TRADING_DAY_LEN + 1];  // 交易日字符串（以 '\0' 结尾）
+    uint64_t journal_cursor;                         // 变更日志当前写入位置（从此处开始 poll_changes 只看新变更）
+    char successor_trading_day[ACCT_MON_TRADING_DAY_LEN + 1];  // 账户服务已换日时为后继交易日，否则为空串
+    uint32_t overflow_segments;  // 已链上的溢出段数（主段写满前由账户服务按水位预建）
+    // 第 k+1 个溢出段的已发布上界（全局索引），该段索引区间为 [(k+1) << 20, overflow_next_index[k])；未链上时为 0
+    uint32_t overflow_next_index[ACCT_MON_MAX_OVERFLOW_SEGMENTS];
 } acct_orders_mon_info_t;
 
 // ============ 订单快照 ============
@@ -88,7 +110,7 @@ typedef struct acct_orders_mon_snapshot {
 
     uint8_t stage;                    // acct_mon_order_stage_t
     uint8_t source;                   // acct_mon_order_source_t
-    uint8_t order_type;               // 0=NotSet,1=New,2=Cancel,255=Unknown
+    uint8_t order_type;               // 0=NotSet,1=New,2=Cancel,3=MassCancel,4=Replace,255=Unknown
     uint8_t passive_exec_algo;        // 逐单被动执行算法（default/none/fixed/twap/...）
     uint8_t trade_side;               // 0=NotSet,1=Buy,2=Sell
     uint8_t market;                   // 1=SZ,2=SH,3=BJ,4=HK
@@ -162,6 +184,89 @@ ACCT_MON_API acct_mon_error_t acct_orders_mon_info(acct_orders_mon_ctx_t ctx, ac
 ACCT_MON_API acct_mon_error_t acct_orders_mon_read(acct_orders_mon_ctx_t ctx, uint32_t index,
                                                    acct_orders_mon_snapshot_t* out_snapshot);
 
+/**
+ * @brief 批量读取 [begin, end) 内已发布槽位的快照，每个槽位只做一次 seqlock 读取
+ * @param ctx 监控上下文
+ * @param begin 起始索引（含）
+ * @param end 结束索引（不含），超过 begin 所在段已发布上界的部分自动截断（一次调用不跨段）
+ * @param out_snapshots 输出快照数组，需至少容纳 end - begin 条；稳定快照按索引升序紧凑写入
+ * @param out_count 输出稳定快照条数
+ * @param out_unstable 可选，输出读取时处于写入中的槽位索引，需至少容纳 end - begin 条
+ * @param out_unstable_count 可选，输出不稳定槽位数量
+ * @return 错误码；存在不稳定槽位时返回 ACCT_MON_ERR_RETRY，其余输出仍有效，调用方稍后逐个重读即可
+ */
+ACCT_MON_API acct_mon_error_t acct_orders_mon_read_range(acct_orders_mon_ctx_t ctx, uint32_t begin, uint32_t end,
+                                                         acct_orders_mon_snapshot_t* out_snapshots, size_t* out_count,
+                                                         uint32_t* out_unstable, size_t* out_unstable_count);
+
+// ============ 订单全链路延迟 ============
+// 说明：时间源为 CLOCK_MONOTONIC，hop_delta_ns[i] 为第 i 跳相对 submit_ns 的增量（纳秒，饱和到 UINT32_MAX）。
+typedef struct acct_orders_mon_latency {
+    uint32_t index;                                     // 槽位索引
+    uint64_t submit_ns;                                 // API 提交时间，0 表示该槽位未打点（如内部拆单子单）
+    uint32_t hop_delta_ns[ACCT_MON_LATENCY_HOP_COUNT];  // 各跳增量，0 表示尚未到达（下标见 acct_mon_latency_hop_t）
+} acct_orders_mon_latency_t;
+
+/**
+ * @brief 按索引读取订单全链路打点
+ * @param ctx 监控上下文
+ * @param index 订单槽位索引
+ * @param out_latency 输出打点信息
+ * @return 错误码
+ * @note 各跳由不同进程单独写入，不受 seqlock 保护；读到 0 表示该跳尚未到达
+ */
+ACCT_MON_API acct_mon_error_t acct_orders_mon_read_latency(acct_orders_mon_ctx_t ctx, uint32_t index,
+                                                           acct_orders_mon_latency_t* out_latency);
+
+// ============ 订单变更增量 ============
+typedef struct acct_orders_mon_change {
+    uint32_t index;  // 发生变更的槽位索引
+    uint32_t seq;    // 本次发布后的 seqlock 序号低 32 位（可与快照 seq 比较去重）
+} acct_orders_mon_change_t;
+
+/**
+ * @brief 从变更日志读取增量，只返回自 cursor 以来发布过的槽位
+ * @param ctx 监控上下文
+ * @param cursor 输入输出游标：首次可传 0（当日起点）或 info.journal_cursor，返回时推进到已读位置
+ * @param out_changes 输出变更数组
+ * @param max_changes out_changes 容量
+ * @param out_count 输出实际条数
+ * @return 错误码
+ * @note 同一槽位可能出现多次；返回 ACCT_MON_ERR_LAGGED 时 out_changes 仍有效，但之前有变更被覆盖，
+ *       调用方应对 [0, next_index) 及各溢出段区间全量补扫一次，再继续用返回的 cursor 轮询
+ */
+ACCT_MON_API acct_mon_error_t acct_orders_mon_poll_changes(acct_orders_mon_ctx_t ctx, uint64_t* cursor,
+                                                           acct_orders_mon_change_t* out_changes,
+                                                           size_t max_changes, size_t* out_count);
+
+// ============ 按条件过滤查询（需账户服务开启 shm.orders_index） ============
+#define ACCT_MON_QUERY_SECURITY 0x01U  // 只返回 internal_security_id 匹配的订单
+#define ACCT_MON_QUERY_STRATEGY 0x02U  // 只返回 strategy_id 匹配的订单
+#define ACCT_MON_QUERY_LIVE 0x04U      // 只返回在途（非终态）订单
+
+typedef struct acct_orders_mon_query {
+    uint32_t filters;                                              // ACCT_MON_QUERY_* 按位或，至少一位
+    uint16_t strategy_id;                                          // filters 含 STRATEGY 时有效
+    char internal_security_id[ACCT_MON_INTERNAL_SECURITY_ID_LEN];  // filters 含 SECURITY 时有效，如 "SZ.000001"
+} acct_orders_mon_query_t;
+
+/**
+ * @brief 按证券/策略/在途条件分页读取订单快照，由账户服务维护的索引段直接定位命中槽位
+ * @param ctx 监控上下文
+ * @param query 过滤条件，多个条件同时生效
+ * @param cursor 输入输出游标：首次传 0，返回 0 表示已遍历完
+ * @param out_snapshots 输出快照数组
+ * @param max_snapshots out_snapshots 容量
+ * @param out_count 输出实际条数
+ * @return 错误码；索引未启用返回 ACCT_MON_ERR_UNAVAILABLE
+ * @note 按证券或策略过滤时新单在前，仅按在途过滤时按索引升序。返回 ACCT_MON_ERR_RETRY 时已输出部分有效，
+ *       cursor 停在不稳定槽位，稍后以同一 cursor 重试；返回 ACCT_MON_ERR_LAGGED 表示遍历期间索引已换日重建，
+ *       需从 cursor=0 重新开始
+ */
+ACCT_MON_API acct_mon_error_t acct_orders_mon_query(acct_orders_mon_ctx_t ctx, const acct_orders_mon_query_t* query,
+                                                    uint64_t* cursor, acct_orders_mon_snapshot_t* out_snapshots,
+                                                    size_t max_snapshots, size_t* out_count);
+
 /**
  * @brief 获取错误码描述
  * @param err 错误码
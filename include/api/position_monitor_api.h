@@ -54,6 +54,7 @@ typedef struct acct_positions_mon_info {
     uint32_t next_security_id;  // 下一个证券编号（由服务侧维护）
     uint64_t create_time_ns;    // 创建时间（Unix Epoch ns）
     uint64_t last_update_ns;    // 最近更新时间（Unix Epoch ns）
+    uint64_t change_version;    // 行变更全局版本，可作为 poll_dirty 的起始游标
 } acct_positions_mon_info_t;
 
 // ============ 资金行快照 ============
@@ -91,6 +92,12 @@ typedef struct acct_positions_mon_position_snapshot {
     uint64_t volume_sell_traded;
     uint64_t dvalue_sell_traded;
     uint64_t count_order;
+
+    // 盈亏（v6/v7 布局恒为 0）：成本与已实现随成交增量更新，浮动盈亏随周期盯市刷新
+    uint64_t cost_basis;      // 持仓成本（含买入费用）
+    int64_t realized_pnl;     // 已实现盈亏
+    int64_t unrealized_pnl;   // 浮动盈亏（按 mark_price）
+    uint64_t mark_price;      // 最近一次盯市价格，0 表示尚未盯市
 } acct_positions_mon_position_snapshot_t;
 
 /**
@@ -139,6 +146,37 @@ ACCT_POS_MON_API acct_pos_mon_error_t acct_positions_mon_read_fund(acct_position
 ACCT_POS_MON_API acct_pos_mon_error_t acct_positions_mon_read_position(
     acct_positions_mon_ctx_t ctx, uint32_t index, acct_positions_mon_position_snapshot_t* out_snapshot);
 
+/**
+ * @brief 一次读取资金行与全部证券行快照
+ * @param ctx 监控上下文
+ * @param out_fund 输出资金行快照
+ * @param out_rows 输出证券行快照，按逻辑索引升序
+ * @param max_rows out_rows 容量；小于 position_count 时只读前 max_rows 行
+ * @param out_count 输出实际行数
+ * @param out_generation 输出读取开始时的行变更全局版本（与 info.change_version 同一序列）
+ * @return 错误码；读取期间无任何行被改写时返回 ACCT_POS_MON_OK，整份视图跨行一致
+ * @note 返回 ACCT_POS_MON_ERR_RETRY 时各行仍是单行稳定快照（id 为空的行未读到稳定值），但行间可能不一致：
+ *       以 *out_generation 为游标调用 poll_dirty 取得期间变更的行，只重读这些行即可。
+ */
+ACCT_POS_MON_API acct_pos_mon_error_t acct_positions_mon_read_all(
+    acct_positions_mon_ctx_t ctx, acct_positions_mon_fund_snapshot_t* out_fund,
+    acct_positions_mon_position_snapshot_t* out_rows, size_t max_rows, size_t* out_count, uint64_t* out_generation);
+
+/**
+ * @brief 拉取自游标以来变更过的持仓行
+ * @param ctx 监控上下文
+ * @param cursor 输入上次返回的游标（首次传 0 取全部已写入行），输出推进后的游标
+ * @param out_rows 输出物理行号（升序）：0=资金行，其余为证券行 index + 1
+ * @param max_rows out_rows 容量
+ * @param out_count 输出实际行数
+ * @return 错误码
+ * @note 只返回行号，调用方再用 read_fund/read_position 读取稳定快照；同一行可能重复返回（至少一次语义）。
+ *       out_rows 放不下时只返回较早的变更并相应推进游标，剩余行下次调用继续返回；
+ *       服务重建持仓池导致版本回退时自动从头拉取。
+ */
+ACCT_POS_MON_API acct_pos_mon_error_t acct_positions_mon_poll_dirty(
+    acct_positions_mon_ctx_t ctx, uint64_t* cursor, uint32_t* out_rows, size_t max_rows, size_t* out_count);
+
 /**
  * @brief 获取错误码描述
  * @param err 错误码
@@ -8,7 +8,7 @@
 namespace acct_service::broker_api {
 
 // broker_api ABI 版本，用于调用方做兼容性检查。
-inline constexpr uint32_t kBrokerApiAbiVersion = 3;
+inline constexpr uint32_t kBrokerApiAbiVersion = 10;
 inline constexpr std::size_t kSecurityIdSize = 16;
 inline constexpr std::size_t kInternalSecurityIdSize = 16;
 inline constexpr std::size_t kBrokerOrderIdSize = 32;
@@ -17,6 +17,7 @@ enum class request_type : uint8_t {
     Unknown = 0,
     New = 1,
     Cancel = 2,
+    Replace = 3,  // 改单（ABI v7 起）：按 orig_internal_order_id 就地修改委托数量/价格，仅 supports_replace() 时下发
 };
 
 enum class side : uint8_t {
@@ -46,9 +47,11 @@ enum class event_kind : uint8_t {
 struct broker_runtime_config {
     uint32_t account_id = 1;
     bool auto_fill = true;
+    uint32_t session_index = 0;  // 多会话分片时的会话序号（0..adapter_shards-1），ABI v5 起
 };
 
 // gateway 发给券商适配器的统一订单请求。
+// Replace 时 volume/price 为改单后的总委托数量与价格，internal_order_id 为改单请求自身编号，回报按该编号返回。
 struct broker_order_request {
     uint32_t internal_order_id = 0;
     uint32_t orig_internal_order_id = 0;
@@ -60,6 +63,16 @@ struct broker_order_request {
     uint64_t price = 0;
     uint32_t md_time = 0;
     char security_id[kSecurityIdSize]{};
+    uint64_t security_token = 0;  // 适配器经 resolve_security() 为该证券分配的不透明令牌，0 表示未协商（ABI v9 起）
+};
+
+// 网关热重启时交还适配器的在途新单（ABI v10 起）：request 与首次提交时相同（订单号已编码账户序号），
+// traded_volume 与 broker_order_id 取自账户服务最近同步的订单快照，broker_order_id 为 0 表示尚未收到受理回报。
+struct broker_inflight_order {
+    broker_order_request request{};
+    uint64_t traded_volume = 0;
+    uint32_t broker_order_id = 0;
+    uint32_t reserved0 = 0;
 };
 
 // 适配器 submit 返回结果：成功、可重试失败、不可重试失败。
@@ -91,6 +104,85 @@ struct broker_event {
     uint64_t recv_time_ns = 0;
 };
 
+// 直写回报的订单状态，取值与账户服务 OrderState 一致（ABI v6 起）。
+enum class response_state : uint8_t {
+    None = 0,
+    BrokerRejected = 0x41,
+    BrokerAccepted = 0x42,
+    MarketRejected = 0x51,
+    MarketAccepted = 0x52,  // 成交
+    Finished = 0x62,
+};
+
+// 直写回报记录（ABI v6 起）：布局与 trades_shm 回报队列元素逐字节一致（128 字节），
+// 适配器原地填写后网关不再做 broker_event 映射与拷贝；internal_security_id 须为 canonical 证券键。
+struct alignas(64) trade_response_record {
+    uint32_t internal_order_id = 0;
+    uint32_t broker_order_id = 0;
+    char internal_security_id[kInternalSecurityIdSize]{};
+    side trade_side = side::Unknown;
+    response_state new_state = response_state::None;
+    uint64_t volume_traded = 0;
+    uint64_t cancelled_volume = 0;
+    uint64_t price_traded = 0;
+    uint64_t value_traded = 0;
+    uint64_t fee = 0;
+    uint32_t md_time_traded = 0;
+    uint32_t reserved0 = 0;
+    uint64_t recv_time_ns = 0;  // 0 时网关以本地时间兜底
+};
+
+static_assert(sizeof(trade_response_record) == 128, "trade_response_record must be 128 bytes");
+
+// 网关借给适配器的回报直写句柄（ABI v6 起）：只在 poll_responses 调用期间、在调用线程上有效。
+// claim 申请至多 max_count 个连续空槽并由 *out_slots 指向首槽，返回 0 表示环已满，适配器须保留未写回报下次再交；
+// publish 提交最近一次 claim 所得槽位中的前 count 个，未提交的槽位会被下次 claim 复用。
+struct response_writer {
+    void* context = nullptr;
+    std::size_t (*claim)(void* context, std::size_t max_count, trade_response_record** out_slots) = nullptr;
+    void (*publish)(void* context, std::size_t count) = nullptr;
+};
+
+// 把 broker_event 原地填成直写记录，便于已有事件模型的适配器切换；kind 无对应回报状态时返回 false。
+inline bool fill_response_record(const broker_event& event, trade_response_record& out_record) noexcept {
+    response_state state = response_state::None;
+    switch (event.kind) {
+        case event_kind::BrokerAccepted:
+            state = response_state::BrokerAccepted;
+            break;
+        case event_kind::BrokerRejected:
+            state = response_state::BrokerRejected;
+            break;
+        case event_kind::MarketRejected:
+            state = response_state::MarketRejected;
+            break;
+        case event_kind::Trade:
+            state = response_state::MarketAccepted;
+            break;
+        case event_kind::Finished:
+            state = response_state::Finished;
+            break;
+        default:
+            return false;
+    }
+    out_record.internal_order_id = event.internal_order_id;
+    out_record.broker_order_id = event.broker_order_id;
+    for (std::size_t i = 0; i < kInternalSecurityIdSize; ++i) {
+        out_record.internal_security_id[i] = event.internal_security_id[i];
+    }
+    out_record.trade_side = event.trade_side;
+    out_record.new_state = state;
+    out_record.volume_traded = event.volume_traded;
+    out_record.cancelled_volume = event.cancelled_volume;
+    out_record.price_traded = event.price_traded;
+    out_record.value_traded = event.value_traded;
+    out_record.fee = event.fee;
+    out_record.md_time_traded = event.md_time_traded;
+    out_record.reserved0 = 0;
+    out_record.recv_time_ns = event.recv_time_ns;
+    return true;
+}
+
 // 券商适配器抽象接口：外部券商实现只需实现这个接口。
 class IBrokerAdapter {
 public:
@@ -98,7 +190,42 @@ public:
 
     virtual bool initialize(const broker_runtime_config& config) = 0;
     virtual send_result submit(const broker_order_request& request) = 0;
+    // 批量提交 count 笔请求，out_results[i] 对应 requests[i]（ABI v4 起）。
+    // 默认逐笔回落到 submit()；柜台支持批量报单时覆盖为一次网络往返。
+    virtual void submit_batch(const broker_order_request* requests, std::size_t count, send_result* out_results) {
+        for (std::size_t i = 0; i < count; ++i) {
+            out_results[i] = submit(requests[i]);
+        }
+    }
     virtual std::size_t poll_events(broker_event* out_events, std::size_t max_events) = 0;
+    // 是否支持改单请求（ABI v7 起）；全部分片都支持时网关才向账户服务通告改单能力，否则账户服务不生成 Replace。
+    virtual bool supports_replace() const noexcept { return false; }
+    // 是否支持直写回报（ABI v6 起）；返回 true 时网关改调 poll_responses，不再调用 poll_events。
+    virtual bool supports_response_writer() const noexcept { return false; }
+    // 经 writer 把至多 max_responses 条回报原地写入网关回报环，返回已 publish 的条数（ABI v6 起）。
+    virtual std::size_t poll_responses(const response_writer& writer, std::size_t max_responses) {
+        (void)writer;
+        (void)max_responses;
+        return 0;
+    }
+    // broker_order_id 是否为会话内递增分配的数字编号（ABI v8 起）；全部分片都声明时网关向账户服务通告，
+    // 账户服务改用基址偏移直接数组登记编号，字符串或哈希编号保持默认 false
+    virtual bool dense_broker_order_ids() const noexcept { return false; }
+    // 为一只证券协商不透明令牌（ABI v9 起）：网关在该证券首笔新单/改单时调用一次，request 已填好证券与市场字段，
+    // 此后同证券请求的 security_token 均携带该值，适配器可据此直接取回自己的柜台代码而不再解析字符串；
+    // 返回 0 表示不使用令牌。只在调用 submit 的线程上调用
+    virtual uint64_t resolve_security(const broker_order_request& request) noexcept {
+        (void)request;
+        return 0;
+    }
+    // 热重启恢复在途新单（ABI v10 起）：网关在 start 阶段、首笔 submit 与轮询线程启动之前调用一次，
+    // orders 为重启前已出队提交、账户侧尚未终态的新单。适配器据此重建在途表（必要时向柜台核对），
+    // 使重启后的撤单与成交回报仍能关联原单；不得对这些订单重新报单。返回接管的笔数，默认不接管
+    virtual std::size_t recover(const broker_inflight_order* orders, std::size_t count) {
+        (void)orders;
+        (void)count;
+        return 0;
+    }
     virtual void shutdown() noexcept = 0;
 };
 
@@ -1,9 +1,13 @@
 #include "api/order_api.h"
 
 #include <sys/mman.h>
+#include <unistd.h>
 
+#include <algorithm>
+#include <atomic>
 #include <cerrno>
 #include <cstdlib>
+#include <iterator>
 #include <memory>
 #include <new>
 #include <string>
@@ -14,8 +18,11 @@
 #include "common/log.hpp"
 #include "common/security_identity.hpp"
 #include "order/order_request.hpp"
+#include "shm/basecore_shm_bridge.hpp"
 #include "shm/orders_shm.hpp"
+#include "shm/risk_params_shm.hpp"
 #include "shm/shm_manager.hpp"
+#include "shm/upstream_lanes.hpp"
 #include "version.h"
 
 namespace {
@@ -23,6 +30,9 @@ namespace {
 // 最大缓存订单数
 constexpr std::size_t kMaxCachedOrders = 1024;
 
+// 每个上下文一次向订单池预留的槽位数，块内下标在本地分发，避免每笔下单都争用 next_index
+constexpr std::size_t kClientIndexBlockSize = 256;
+
 // 获取当前系统时间的 md_time（HHMMSSmmm 格式）
 inline acct_service::MdTime get_current_md_time() {
     struct timespec ts;
@@ -83,6 +93,36 @@ bool resolve_init_options(const acct_init_options_t* options, std::string& upstr
     return true;
 }
 
+// 按 acct_wait_mask_t 判断槽位快照是否满足等待条件
+bool order_wait_matched(const acct_service::order_slot_snapshot& snapshot, uint32_t state_mask) {
+    using acct_service::OrderSlotState;
+    using acct_service::OrderState;
+
+    const OrderSlotState stage = snapshot.stage;
+    const OrderState state = snapshot.request.order_state.load(std::memory_order_relaxed);
+    const bool rejected = stage == OrderSlotState::RiskRejected || stage == OrderSlotState::QueuePushFailed ||
+                          state == OrderState::RiskControllerRejected || state == OrderState::TraderRejected ||
+                          state == OrderState::TraderError || state == OrderState::BrokerRejected ||
+                          state == OrderState::MarketRejected;
+    const bool terminal = rejected || stage == OrderSlotState::Terminal || acct_service::order_state_is_terminal(state);
+    const bool dequeued = stage != OrderSlotState::Empty && stage != OrderSlotState::Reserved &&
+                          stage != OrderSlotState::UpstreamQueued;
+    const bool accepted = state == OrderState::BrokerAccepted || state == OrderState::MarketAccepted ||
+                          (state == OrderState::Finished && snapshot.request.volume_traded > 0);
+    return ((state_mask & ACCT_WAIT_DEQUEUED) != 0 && dequeued) ||
+           ((state_mask & ACCT_WAIT_ACCEPTED) != 0 && accepted) ||
+           ((state_mask & ACCT_WAIT_TRADED) != 0 && snapshot.request.volume_traded > 0) ||
+           ((state_mask & ACCT_WAIT_REJECTED) != 0 && rejected) || ((state_mask & ACCT_WAIT_TERMINAL) != 0 && terminal);
+}
+
+// 接入 lane 时丢弃前一持有者未读完的回报，保证读到的回报都属于本上下文提交的订单
+void discard_order_updates(acct_service::upstream_shm_layout* upstream, uint32_t lane) {
+    acct_service::order_update_message buffer[64];
+    auto& queue = upstream->order_updates(lane).queue;
+    while (queue.try_pop_bulk(buffer, std::size(buffer)) != 0) {
+    }
+}
+
 bool should_recreate_shm_on_init_failure(acct_service::ErrorCode code) {
     return code == acct_service::ErrorCode::ShmResizeFailed || code == acct_service::ErrorCode::ShmHeaderInvalid;
 }
@@ -122,7 +162,8 @@ bool resolve_passive_execution_algo(const acct_order_exec_options_t* exec_option
 // 构造新单请求并填充统一的内部字段，避免 new/submit 两条路径重复漂移。
 bool build_new_order_request(const char* security_id, uint8_t side, uint8_t market, uint64_t volume, double price,
                              acct_service::PassiveExecutionAlgo passive_execution_algo, uint32_t order_id,
-                             acct_service::OrderRequest& out_request, acct_error_t& out_error) {
+                             acct_service::MdTime md_time, acct_service::OrderRequest& out_request,
+                             acct_error_t& out_error) {
     using namespace acct_service;
 
     if (side != ACCT_SIDE_BUY && side != ACCT_SIDE_SELL) {
@@ -145,7 +186,6 @@ bool build_new_order_request(const char* security_id, uint8_t side, uint8_t mark
     }
 
     const DPrice internal_price = static_cast<DPrice>(price * 100.0 + 0.5);
-    const MdTime md_time = get_current_md_time();
 
     out_request.init_new(std::string_view(security_id), internal_security_id, static_cast<InternalOrderId>(order_id),
                          static_cast<TradeSide>(side), static_cast<Market>(market), static_cast<Volume>(volume),
@@ -159,54 +199,397 @@ bool build_new_order_request(const char* security_id, uint8_t side, uint8_t mark
 
 using namespace acct_service;
 
-// 内部上下文结构
-struct acct_context {
+// 内部上下文结构；按缓存行对齐，各线程上下文的可写状态互不共享缓存行
+struct alignas(64) acct_context {
     SHMManager upstream_shm_manager;
     SHMManager orders_shm_manager;
+    SHMManager risk_params_shm_manager;
 
     upstream_shm_layout* upstream_shm = nullptr;
     orders_shm_layout* orders_shm = nullptr;
+    const risk_params_shm_layout* risk_params = nullptr;  // 账户服务未发布风控参数段时为空，新单不做本地预检
 
     std::string upstream_shm_name;
     std::string orders_base_name;
     std::string orders_dated_name;
     std::string trading_day;
 
-    // 缓存的订单（new_order 创建，send_order 发送）
+    uint32_t upstream_lane = 0;        // 本上下文写入的上游 lane
+    uint32_t upstream_lane_owner = 0;  // 认领 lane 时登记的 pid，0=未认领（单生产者模式）
+
+    // 缓存的订单（new_order 创建并占下槽位，send_order 发送）；槽位由订单号低位直接得到
     std::unordered_map<uint32_t, OrderRequest> cached_orders;
 
+    // 本地预留的订单池下标块 [index_block_next, index_block_end)
+    OrderIndex index_block_next = 0;
+    OrderIndex index_block_end = 0;
+
+    // 换日后尚未推入换日标记的 lane 队列；标记之前的下标由账户服务按旧池解释
+    bool order_marker_pending = false;
+    bool cancel_marker_pending = false;
+
     bool initialized = false;
+
+    // 线程上下文指向派生它的进程上下文（借用其上游段映射），进程上下文为 nullptr
+    acct_context* parent = nullptr;
+    // 进程上下文上尚未销毁的线程上下文数
+    std::atomic<uint32_t> attached_threads{0};
 };
 
 namespace {
 
-acct_error_t enqueue_order(acct_context* context, const OrderRequest& request, order_slot_source_t source,
-                           OrderIndex* out_index = nullptr) {
+// 本地无状态风控预检：与账户服务同口径的单笔金额/数量/价格带规则，不通过的新单不占用订单池槽位。
+// 失控策略可能连续触发，拒绝不记错误日志
+acct_error_t precheck_new_order(const acct_context* context, const OrderRequest& request) {
+    if (!context->risk_params) {
+        return ACCT_OK;
+    }
+    const RiskResult result = risk_params_precheck(*context->risk_params, request.internal_security_id,
+                                                   request.volume_entrust, request.dprice_entrust);
+    return result == RiskResult::Pass ? ACCT_OK : ACCT_ERR_RISK_REJECTED;
+}
+
+// 从本地下标块取一个槽位，块用尽时一次 CAS 再预留一块（池尾不足一块时取剩余部分）。
+bool acquire_order_index(acct_context* context, OrderIndex& out_index) {
+    if (context->index_block_next == context->index_block_end) {
+        OrderIndex begin = kInvalidOrderIndex;
+        const std::size_t granted = orders_shm_try_allocate_range(context->orders_shm, kClientIndexBlockSize, begin);
+        if (granted == 0) {
+            return false;
+        }
+        context->index_block_next = begin;
+        context->index_block_end = begin + static_cast<OrderIndex>(granted);
+    }
+    out_index = context->index_block_next++;
+    return true;
+}
+
+// 销毁上下文时归还未用完的下标块；之后已有他人分配时尾部保持 Empty。
+void release_order_index_block(acct_context* context) {
+    if (context->orders_shm && context->index_block_next < context->index_block_end) {
+        (void)orders_shm_release_range(context->orders_shm, context->index_block_next, context->index_block_end);
+    }
+    context->index_block_next = 0;
+    context->index_block_end = 0;
+}
+
+// 跟随账户服务的换日切换：旧池发布了后继交易日时归还旧池下标块，沿后继链打开最新交易日的订单池，
+// 丢弃未发送的缓存订单，再向本 lane 的两条队列各推入一个换日标记。未换日时只有一次 acquire 读
+acct_error_t follow_orders_rollover(acct_context* context) {
+    if (orders_shm_successor_day(context->orders_shm) == 0 && !context->order_marker_pending &&
+        !context->cancel_marker_pending) {
+        return ACCT_OK;
+    }
+
+    for (uint32_t successor = orders_shm_successor_day(context->orders_shm); successor != 0;
+         successor = orders_shm_successor_day(context->orders_shm)) {
+        const std::string trading_day = trading_day_string(successor);
+        const std::string dated_name = make_orders_shm_name(context->orders_base_name, trading_day);
+        SHMManager next_manager;
+        next_manager.set_orders_window_bytes(orders_window_bytes_from_env());
+        orders_shm_layout* next = next_manager.open_orders(dated_name, shm_mode::Open, 0, 0);
+        if (!next) {
+            return api_error(ACCT_ERR_SHM_FAILED, ErrorCode::ShmOpenFailed, "follow orders shm rollover failed");
+        }
+        release_order_index_block(context);
+        context->orders_shm_manager.close();
+        context->orders_shm_manager = std::move(next_manager);
+        context->orders_shm = next;
+        context->orders_dated_name = dated_name;
+        context->trading_day = trading_day;
+        context->cached_orders.clear();
+        context->order_marker_pending = true;
+        context->cancel_marker_pending = true;
+        (void)orders_shm_bind_id_epoch(context->orders_shm, context->upstream_shm);
+    }
+
+    if (context->order_marker_pending) {
+        if (!context->upstream_shm->lane(context->upstream_lane).try_push(kOrdersRolloverMarker)) {
+            return api_error(ACCT_ERR_QUEUE_FULL, ErrorCode::QueuePushFailed, "orders rollover marker push failed");
+        }
+        context->order_marker_pending = false;
+    }
+    if (context->cancel_marker_pending) {
+        if (!context->upstream_shm->cancel_lane(context->upstream_lane).try_push(kOrdersRolloverMarker)) {
+            return api_error(ACCT_ERR_QUEUE_FULL, ErrorCode::QueuePushFailed, "orders rollover marker push failed");
+        }
+        context->cancel_marker_pending = false;
+    }
+    return ACCT_OK;
+}
+
+// 按 Queue 写入本上下文 lane 的订单队列或撤单优先队列；入队失败时槽位标记 QueuePushFailed。
+template <typename Queue>
+acct_error_t push_upstream_index(acct_context* context, Queue& queue, OrderIndex index, const char* queue_name) {
+    if (!queue.try_push(index)) {
+        (void)orders_shm_update_stage(context->orders_shm, index & ~kUpstreamInlineIndexFlag,
+                                      OrderSlotState::QueuePushFailed, now_ns());
+        const std::string message = std::string("enqueue ") + queue_name +
+                                    " push failed: queue_size=" + std::to_string(queue.size()) + "/" +
+                                    std::to_string(Queue::capacity());
+        return api_error(ACCT_ERR_QUEUE_FULL, ErrorCode::QueuePushFailed, message);
+    }
+    return ACCT_OK;
+}
+
+// 内联模式下先把请求推入 lane 的消息环，返回带 kUpstreamInlineIndexFlag 的下标；
+// 请求不可内联或消息环已满时返回原下标，账户服务回落读槽位。须在下标入队前调用，保证出队时消息已可见
+OrderIndex push_upstream_payload(acct_context* context, const OrderRequest& request, OrderIndex index) {
+    if (!upstream_inline_orders(context->upstream_shm)) {
+        return index;
+    }
+    upstream_order_message message;
+    if (!fill_upstream_order_message(request, index, message) ||
+        !context->upstream_shm->payload_lane(context->upstream_lane).try_push(message)) {
+        return index;
+    }
+    return index | kUpstreamInlineIndexFlag;
+}
+
+// index 为 kInvalidOrderIndex 时现取槽位，并按槽位为 request 编码订单号；
+// priority_cancel 为 true 时写入撤单优先队列，账户服务先于订单队列处理，不再排在大篮子之后。
+acct_error_t enqueue_order(acct_context* context, OrderRequest& request, order_slot_source_t source,
+                           OrderIndex index = kInvalidOrderIndex, bool priority_cancel = false) {
     if (!context || !context->upstream_shm || !context->orders_shm) {
         return api_error(ACCT_ERR_NOT_INITIALIZED, ErrorCode::InvalidState, "enqueue called before init");
     }
 
-    OrderIndex index = kInvalidOrderIndex;
-    if (!orders_shm_append(context->orders_shm, request, OrderSlotState::UpstreamQueued, source, now_ns(), index)) {
-        return api_error(ACCT_ERR_ORDER_POOL_FULL, ErrorCode::OrderPoolFull, "orders shm pool full");
+    // 预先占好槽位的请求（send_order）已在查缓存前跟随过换日
+    if (index == kInvalidOrderIndex) {
+        const acct_error_t follow_rc = follow_orders_rollover(context);
+        if (follow_rc != ACCT_OK) {
+            return follow_rc;
+        }
     }
 
-    if (!context->upstream_shm->upstream_order_queue.try_push(index)) {
-        (void)orders_shm_update_stage(context->orders_shm, index, OrderSlotState::QueuePushFailed, now_ns());
-        const std::size_t queue_size = context->upstream_shm->upstream_order_queue.size();
-        const std::size_t queue_capacity = kUpstreamOrderQueueCapacity - 1;
-        const std::string message = "enqueue upstream queue push failed: queue_size=" + std::to_string(queue_size) +
-                                    "/" + std::to_string(queue_capacity);
-        return api_error(ACCT_ERR_QUEUE_FULL, ErrorCode::QueuePushFailed, message);
+    // 本上下文是 lane 唯一生产者：先查额度，队列满时直接返回，不再占用槽位后标记 QueuePushFailed
+    const bool queue_full = priority_cancel
+                                ? context->upstream_shm->cancel_lane(context->upstream_lane).free_slots(1) == 0
+                                : context->upstream_shm->lane(context->upstream_lane).free_slots(1) == 0;
+    if (queue_full) {
+        return api_error(ACCT_ERR_QUEUE_FULL, ErrorCode::QueueFull,
+                         priority_cancel ? "upstream cancel queue has no credits" : "upstream queue has no credits");
     }
 
-    context->upstream_shm->header.last_update = now_ns();
-    if (out_index) {
-        *out_index = index;
+    const TimestampNs submit_ns = now_monotonic_ns();
+    if (index == kInvalidOrderIndex) {
+        if (!acquire_order_index(context, index)) {
+            return api_error(ACCT_ERR_ORDER_POOL_FULL, ErrorCode::OrderPoolFull, "orders shm pool full");
+        }
+        request.internal_order_id = orders_shm_order_id(context->orders_shm, index);
+    }
+    if (!orders_shm_write_order(context->orders_shm, index, request, OrderSlotState::UpstreamQueued, source,
+                                now_ns())) {
+        return api_error(ACCT_ERR_ORDER_POOL_FULL, ErrorCode::OrderPoolFull, "orders shm pool full");
+    }
+    // 打点须早于入队，保证账户服务出队时 submit_ns 已可见
+    orders_shm_mark_submit(context->orders_shm, index, submit_ns);
+
+    const acct_error_t rc =
+        priority_cancel
+            ? push_upstream_index(context, context->upstream_shm->cancel_lane(context->upstream_lane), index,
+                                  "upstream cancel queue")
+            : push_upstream_index(context, context->upstream_shm->lane(context->upstream_lane),
+                                  push_upstream_payload(context, request, index), "upstream queue");
+    if (rc != ACCT_OK) {
+        return rc;
     }
+
+    context->upstream_shm->header.last_update = now_ns();
+    doorbell_ring(&context->orders_shm->header.account_doorbell);
     return ACCT_OK;
 }
 
+// 篮子内单条校验：与 build_new_order_request 同一口径并做本地风控预检，供预留槽位前计数。
+acct_error_t validate_order_spec(const acct_context* context, const acct_order_spec_t& spec,
+                                 PassiveExecutionAlgo& out_algo) {
+    if (!spec.security_id) {
+        return api_error(ACCT_ERR_INVALID_PARAM, ErrorCode::InvalidParam, "acct_submit_orders security_id is null");
+    }
+    acct_order_exec_options_t exec_options{};
+    exec_options.passive_exec_algo = spec.passive_exec_algo;
+    if (!resolve_passive_execution_algo(&exec_options, out_algo)) {
+        return api_error(ACCT_ERR_INVALID_PARAM, ErrorCode::InvalidParam, "acct_submit_orders invalid passive_exec_algo");
+    }
+    OrderRequest scratch{};
+    acct_error_t rc = ACCT_OK;
+    if (!build_new_order_request(spec.security_id, spec.side, spec.market, spec.volume, spec.price, out_algo, 0, 0,
+                                 scratch, rc)) {
+        return rc;
+    }
+    return precheck_new_order(context, scratch);
+}
+
+// 按篮入队：每篮（至多 kMaxBasketLegs 条连续下标）空闲容量足够时才一次推入，保证账户服务出队时整篮可见；
+// 返回成功入队的条数，首个放不下的篮子及其后全部不入队
+std::size_t push_basket_range(upstream_shm_layout::lane_queue& queue, OrderIndex begin, std::size_t count) {
+    OrderIndex chunk[kMaxBasketLegs];
+    std::size_t pushed = 0;
+    while (pushed < count) {
+        const std::size_t n = (count - pushed < kMaxBasketLegs) ? count - pushed : kMaxBasketLegs;
+        if (queue.capacity() - queue.size() < n) {
+            break;
+        }
+        for (std::size_t i = 0; i < n; ++i) {
+            chunk[i] = begin + static_cast<OrderIndex>(pushed + i);
+        }
+        const std::size_t accepted = queue.try_push_bulk(chunk, n);
+        pushed += accepted;
+        if (accepted < n) {
+            break;
+        }
+    }
+    return pushed;
+}
+
+// 整篮放弃时把所有合法条目的结果改记为 code
+void mark_valid_results(acct_error_t* out_results, std::size_t count, acct_error_t code) {
+    for (std::size_t i = 0; i < count; ++i) {
+        if (out_results[i] == ACCT_OK) {
+            out_results[i] = code;
+        }
+    }
+}
+
+// 篮子下单公共实现：合法条目按 kMaxBasketLegs 分篮，各腿标记所属篮子，每篮一次入队；
+// basket_flags 含 kBasketAllOrNothing 时要求全部条目合法且一次预留、一次入队，否则整篮不提交
+acct_error_t submit_order_specs(acct_ctx_t ctx, const acct_order_spec_t* specs, std::size_t count,
+                                uint8_t basket_flags, uint32_t* out_ids, acct_error_t* out_results) {
+    if (!ctx || (count != 0 && (!specs || !out_ids || !out_results))) {
+        return api_error(ACCT_ERR_INVALID_PARAM, ErrorCode::InvalidParam, "acct_submit_orders invalid arguments");
+    }
+
+    auto* context = ctx;
+    if (!context->initialized || !context->upstream_shm || !context->orders_shm) {
+        return api_error(ACCT_ERR_NOT_INITIALIZED, ErrorCode::InvalidState, "acct_submit_orders called before init");
+    }
+
+    // 第一遍：逐条校验并计数，非法条目不占用槽位与订单ID
+    std::size_t valid_count = 0;
+    for (std::size_t i = 0; i < count; ++i) {
+        PassiveExecutionAlgo algo = PassiveExecutionAlgo::Default;
+        out_ids[i] = 0;
+        out_results[i] = validate_order_spec(context, specs[i], algo);
+        if (out_results[i] == ACCT_OK) {
+            ++valid_count;
+        }
+    }
+    if (valid_count == 0) {
+        return count == 0 ? ACCT_OK : out_results[0];
+    }
+    const acct_error_t follow_rc = follow_orders_rollover(context);
+    if (follow_rc != ACCT_OK) {
+        mark_valid_results(out_results, count, follow_rc);
+        return follow_rc;
+    }
+
+    upstream_shm_layout::lane_queue& queue = context->upstream_shm->lane(context->upstream_lane);
+    const bool all_or_nothing = (basket_flags & kBasketAllOrNothing) != 0;
+    if (all_or_nothing) {
+        if (count > kMaxBasketLegs) {
+            mark_valid_results(out_results, count, ACCT_ERR_INVALID_PARAM);
+            return api_error(ACCT_ERR_INVALID_PARAM, ErrorCode::InvalidParam,
+                             "acct_submit_basket all-or-nothing basket exceeds max legs");
+        }
+        if (valid_count < count) {
+            mark_valid_results(out_results, count, ACCT_ERR_BASKET_ABORTED);
+            return ACCT_ERR_INVALID_PARAM;
+        }
+        // 本上下文是 lane 唯一生产者，此刻的空闲容量在入队前只增不减
+        if (queue.capacity() - queue.size() < valid_count) {
+            mark_valid_results(out_results, count, ACCT_ERR_QUEUE_FULL);
+            return api_error(ACCT_ERR_QUEUE_FULL, ErrorCode::QueueFull, "acct_submit_basket upstream queue full");
+        }
+    }
+
+    // 一次 CAS 预留连续槽位，订单号按槽位编码
+    OrderIndex begin = kInvalidOrderIndex;
+    std::size_t reserved = orders_shm_try_allocate_range(context->orders_shm, valid_count, begin);
+    if (all_or_nothing && reserved < valid_count) {
+        if (reserved > 0) {
+            (void)orders_shm_release_range(context->orders_shm, begin, begin + static_cast<OrderIndex>(reserved));
+        }
+        mark_valid_results(out_results, count, ACCT_ERR_ORDER_POOL_FULL);
+        return api_error(ACCT_ERR_ORDER_POOL_FULL, ErrorCode::OrderPoolFull, "acct_submit_basket orders shm pool full");
+    }
+    const MdTime md_time = get_current_md_time();
+    const TimestampNs submit_ns = now_monotonic_ns();
+    const TimestampNs update_ns = now_ns();
+
+    // 第二遍：按条目顺序写入预留槽位，未预留到槽位的合法条目记 ORDER_POOL_FULL
+    std::size_t written = 0;
+    for (std::size_t i = 0; i < count; ++i) {
+        if (out_results[i] != ACCT_OK) {
+            continue;
+        }
+        if (written >= reserved) {
+            out_results[i] = ACCT_ERR_ORDER_POOL_FULL;
+            continue;
+        }
+
+        PassiveExecutionAlgo algo = PassiveExecutionAlgo::Default;
+        acct_order_exec_options_t exec_options{};
+        exec_options.passive_exec_algo = specs[i].passive_exec_algo;
+        (void)resolve_passive_execution_algo(&exec_options, algo);
+
+        const OrderIndex index = begin + static_cast<OrderIndex>(written);
+        const uint32_t order_id = orders_shm_order_id(context->orders_shm, index);
+        OrderRequest request{};
+        acct_error_t build_rc = ACCT_OK;
+        (void)build_new_order_request(specs[i].security_id, specs[i].side, specs[i].market, specs[i].volume,
+                                      specs[i].price, algo, order_id, md_time, request, build_rc);
+        request.order_state.store(OrderState::UserSubmitted, std::memory_order_relaxed);
+        // 按入队分篮：首腿订单ID即篮子ID，只有一腿的篮子按普通订单处理
+        const std::size_t basket_begin = written - written % kMaxBasketLegs;
+        const std::size_t basket_legs = std::min(kMaxBasketLegs, reserved - basket_begin);
+        if (basket_legs > 1) {
+            request.basket_id = orders_shm_order_id(context->orders_shm, begin + static_cast<OrderIndex>(basket_begin));
+            request.basket_legs = static_cast<uint16_t>(basket_legs);
+            request.basket_flags = basket_flags;
+        }
+        (void)orders_shm_write_order(context->orders_shm, index, request, OrderSlotState::UpstreamQueued,
+                                     order_slot_source_t::User, update_ns);
+        // 打点须早于入队，保证账户服务出队时 submit_ns 已可见
+        orders_shm_mark_submit(context->orders_shm, index, submit_ns);
+        out_ids[i] = order_id;
+        ++written;
+    }
+
+    const std::size_t pushed = push_basket_range(queue, begin, written);
+    if (pushed > 0) {
+        context->upstream_shm->header.last_update = update_ns;
+        doorbell_ring(&context->orders_shm->header.account_doorbell);
+    }
+
+    // 已写槽位但未入队的尾部条目记 QUEUE_FULL，槽位标记为 QueuePushFailed
+    acct_error_t first_error = ACCT_OK;
+    std::size_t slot = 0;
+    for (std::size_t i = 0; i < count; ++i) {
+        if (out_results[i] == ACCT_OK) {
+            if (slot >= pushed) {
+                (void)orders_shm_update_stage(context->orders_shm, begin + static_cast<OrderIndex>(slot),
+                                              OrderSlotState::QueuePushFailed, now_ns());
+                out_ids[i] = 0;
+                out_results[i] = ACCT_ERR_QUEUE_FULL;
+            }
+            ++slot;
+        }
+        if (first_error == ACCT_OK && out_results[i] != ACCT_OK) {
+            first_error = out_results[i];
+        }
+    }
+
+    if (reserved < valid_count) {
+        (void)api_error(ACCT_ERR_ORDER_POOL_FULL, ErrorCode::OrderPoolFull, "acct_submit_orders orders shm pool full");
+    }
+    if (pushed < written) {
+        const std::string message = "acct_submit_orders upstream queue push failed: pushed=" +
+                                    std::to_string(pushed) + "/" + std::to_string(written);
+        (void)api_error(ACCT_ERR_QUEUE_FULL, ErrorCode::QueuePushFailed, message);
+    }
+    return first_error;
+}
+
 }  // namespace
 
 extern "C" {
@@ -242,19 +625,51 @@ ACCT_API acct_error_t acct_init_ex(const acct_init_options_t* options, acct_ctx_
         return api_error(ACCT_ERR_SHM_FAILED, ErrorCode::ShmOpenFailed, "acct_init_ex open upstream shm failed");
     }
 
+    // 多 lane 模式下每个生产者独占一条 SPSC lane，保持单写者语义
+    if (upstream_lane_count(ctx->upstream_shm) > 1) {
+        const uint32_t pid = static_cast<uint32_t>(::getpid());
+        if (!upstream_claim_lane(ctx->upstream_shm, pid, ctx->upstream_lane)) {
+            return api_error(ACCT_ERR_NO_FREE_LANE, ErrorCode::QueueFull, "acct_init_ex no free upstream lane");
+        }
+        ctx->upstream_lane_owner = pid;
+    }
+    discard_order_updates(ctx->upstream_shm, ctx->upstream_lane);
+
     ctx->orders_dated_name = make_orders_shm_name(orders_base_name, trading_day);
-    ctx->orders_shm = ctx->orders_shm_manager.open_orders(ctx->orders_dated_name, mode, 0);
+    // 订单池容量由账户服务按账户配置决定，接入方沿用已存在段的容量；已存在段按窗口映射，只下几笔单的接入方
+    // 不必为整段建立映射与页表
+    ctx->orders_shm_manager.set_orders_window_bytes(orders_window_bytes_from_env());
+    ctx->orders_shm = ctx->orders_shm_manager.open_orders(ctx->orders_dated_name, mode, 0, 0);
     if (!ctx->orders_shm && create_if_not_exist && should_recreate_shm_on_init_failure(latest_error().code)) {
         (void)SHMManager::unlink(ctx->orders_dated_name);
-        ctx->orders_shm = ctx->orders_shm_manager.open_orders(ctx->orders_dated_name, shm_mode::Create, 0);
+        ctx->orders_shm = ctx->orders_shm_manager.open_orders(ctx->orders_dated_name, shm_mode::Create, 0, 0);
     }
     if (!ctx->orders_shm) {
         return api_error(ACCT_ERR_SHM_FAILED, ErrorCode::ShmOpenFailed, "acct_init_ex open orders shm failed");
     }
+    // 账户服务未启动时由首个接入方绑定纪元
+    (void)orders_shm_bind_id_epoch(ctx->orders_shm, ctx->upstream_shm);
+
+    // 风控参数段由账户服务按 shm.risk_params 创建，只读接入；段不存在时跳过本地预检
+    const std::string risk_params_name = make_risk_params_shm_name(upstream_name);
+    std::size_t risk_params_size = 0;
+    if (basecore_shm_bridge::segment_size(risk_params_name, risk_params_size) &&
+        risk_params_size == sizeof(risk_params_shm_layout)) {
+        ctx->risk_params = ctx->risk_params_shm_manager.open_risk_params(risk_params_name, shm_mode::Open, 0);
+    }
 
     ctx->upstream_shm_name = upstream_name;
     ctx->orders_base_name = orders_base_name;
     ctx->trading_day = trading_day;
+    // 换日切入的池：本 lane 可能仍挂在旧池上，先推标记；按旧交易日接入时沿后继链跟随到最新池
+    if (ctx->orders_shm->header.predecessor_day.load(std::memory_order_acquire) != 0) {
+        ctx->order_marker_pending = true;
+        ctx->cancel_marker_pending = true;
+    }
+    const acct_error_t follow_rc = follow_orders_rollover(ctx.get());
+    if (follow_rc != ACCT_OK) {
+        return follow_rc;
+    }
     ctx->initialized = true;
     *out_ctx = ctx.release();
     return ACCT_OK;
@@ -266,12 +681,92 @@ ACCT_API acct_error_t acct_destroy(acct_ctx_t ctx) {
     }
 
     auto* context = ctx;
+    if (context->attached_threads.load(std::memory_order_acquire) != 0) {
+        return api_error(ACCT_ERR_INVALID_PARAM, ErrorCode::InvalidState,
+                         "acct_destroy ctx still has attached thread contexts");
+    }
+    release_order_index_block(context);
+    if (context->upstream_shm && context->upstream_lane_owner != 0) {
+        upstream_release_lane(context->upstream_shm, context->upstream_lane, context->upstream_lane_owner);
+    }
+    if (context->parent) {
+        context->parent->attached_threads.fetch_sub(1, std::memory_order_acq_rel);
+    }
     context->upstream_shm = nullptr;
     context->orders_shm = nullptr;
     delete context;
     return ACCT_OK;
 }
 
+ACCT_API acct_error_t acct_ctx_thread_attach(acct_ctx_t ctx, acct_ctx_t* out_thread_ctx) {
+    if (!out_thread_ctx) {
+        return api_error(ACCT_ERR_INVALID_PARAM, ErrorCode::InvalidParam,
+                         "acct_ctx_thread_attach out_thread_ctx is null");
+    }
+    *out_thread_ctx = nullptr;
+
+    if (!ctx) {
+        return api_error(ACCT_ERR_INVALID_PARAM, ErrorCode::InvalidParam, "acct_ctx_thread_attach ctx is null");
+    }
+    auto* parent = ctx;
+    if (!parent->initialized || !parent->upstream_shm) {
+        return api_error(ACCT_ERR_NOT_INITIALIZED, ErrorCode::InvalidState,
+                         "acct_ctx_thread_attach called before init");
+    }
+    if (parent->parent) {
+        return api_error(ACCT_ERR_INVALID_PARAM, ErrorCode::InvalidParam,
+                         "acct_ctx_thread_attach ctx is a thread context");
+    }
+    // 单 lane 模式下 lane 0 已由进程上下文写入，线程无法获得独占生产者 lane
+    if (upstream_lane_count(parent->upstream_shm) <= 1) {
+        return api_error(ACCT_ERR_NO_FREE_LANE, ErrorCode::QueueFull,
+                         "acct_ctx_thread_attach requires upstream_lane_count > 1");
+    }
+
+    auto thread_ctx = std::unique_ptr<acct_context>(new (std::nothrow) acct_context());
+    if (!thread_ctx) {
+        return api_error(ACCT_ERR_INTERNAL, ErrorCode::InternalError, "acct_context allocation failed");
+    }
+
+    // lane 仍按进程 pid 登记（进程退出后可回收），但不复用本进程已持有的 lane，每个线程上下文独占一条
+    const uint32_t pid = static_cast<uint32_t>(::getpid());
+    if (!upstream_claim_lane(parent->upstream_shm, pid, thread_ctx->upstream_lane, false)) {
+        return api_error(ACCT_ERR_NO_FREE_LANE, ErrorCode::QueueFull, "acct_ctx_thread_attach no free upstream lane");
+    }
+    thread_ctx->upstream_lane_owner = pid;
+    thread_ctx->upstream_shm = parent->upstream_shm;
+    thread_ctx->risk_params = parent->risk_params;
+    discard_order_updates(thread_ctx->upstream_shm, thread_ctx->upstream_lane);
+    thread_ctx->parent = parent;
+
+    // 订单池映射各线程独立持有：换日时各自跟随，不受进程上下文关闭旧池影响
+    thread_ctx->orders_shm_manager.set_orders_window_bytes(orders_window_bytes_from_env());
+    thread_ctx->orders_shm = thread_ctx->orders_shm_manager.open_orders(parent->orders_dated_name, shm_mode::Open, 0, 0);
+    if (!thread_ctx->orders_shm) {
+        upstream_release_lane(thread_ctx->upstream_shm, thread_ctx->upstream_lane, pid);
+        return api_error(ACCT_ERR_SHM_FAILED, ErrorCode::ShmOpenFailed, "acct_ctx_thread_attach open orders shm failed");
+    }
+    thread_ctx->upstream_shm_name = parent->upstream_shm_name;
+    thread_ctx->orders_base_name = parent->orders_base_name;
+    thread_ctx->orders_dated_name = parent->orders_dated_name;
+    thread_ctx->trading_day = parent->trading_day;
+    if (thread_ctx->orders_shm->header.predecessor_day.load(std::memory_order_acquire) != 0) {
+        thread_ctx->order_marker_pending = true;
+        thread_ctx->cancel_marker_pending = true;
+    }
+    const acct_error_t follow_rc = follow_orders_rollover(thread_ctx.get());
+    if (follow_rc != ACCT_OK) {
+        release_order_index_block(thread_ctx.get());
+        upstream_release_lane(thread_ctx->upstream_shm, thread_ctx->upstream_lane, pid);
+        return follow_rc;
+    }
+
+    parent->attached_threads.fetch_add(1, std::memory_order_acq_rel);
+    thread_ctx->initialized = true;
+    *out_thread_ctx = thread_ctx.release();
+    return ACCT_OK;
+}
+
 ACCT_API acct_error_t acct_new_order(acct_ctx_t ctx, const char* security_id, uint8_t side, uint8_t market,
                                      uint64_t volume, double price, uint32_t valid_sec, uint32_t* out_order_id) {
     return acct_new_order_ex(ctx, security_id, side, market, volume, price, valid_sec, nullptr, out_order_id);
@@ -294,6 +789,10 @@ ACCT_API acct_error_t acct_new_order_ex(acct_ctx_t ctx, const char* security_id,
         return api_error(ACCT_ERR_NOT_INITIALIZED, ErrorCode::InvalidState, "acct_new_order_ex called before init");
     }
 
+    const acct_error_t follow_rc = follow_orders_rollover(context);
+    if (follow_rc != ACCT_OK) {
+        return follow_rc;
+    }
     if (context->cached_orders.size() >= kMaxCachedOrders) {
         return api_error(ACCT_ERR_CACHE_FULL, ErrorCode::QueueFull, "acct_new_order_ex cache full");
     }
@@ -304,17 +803,28 @@ ACCT_API acct_error_t acct_new_order_ex(acct_ctx_t ctx, const char* security_id,
                          "acct_new_order_ex invalid passive_exec_algo");
     }
 
-    uint32_t order_id = context->upstream_shm->header.next_order_id.fetch_add(1, std::memory_order_relaxed);
     (void)valid_sec;
 
     OrderRequest request{};
     acct_error_t build_rc = ACCT_OK;
-    if (!build_new_order_request(security_id, side, market, volume, price, passive_execution_algo, order_id, request,
-                                 build_rc)) {
+    if (!build_new_order_request(security_id, side, market, volume, price, passive_execution_algo, 0,
+                                 get_current_md_time(), request, build_rc)) {
         return build_rc;
     }
+    const acct_error_t precheck_rc = precheck_new_order(context, request);
+    if (precheck_rc != ACCT_OK) {
+        return precheck_rc;
+    }
     request.order_state.store(OrderState::NotSet, std::memory_order_relaxed);
 
+    // 订单号要在发送前返回，此时就占下槽位；未发送即销毁上下文的槽位保持 Empty
+    OrderIndex index = kInvalidOrderIndex;
+    if (!acquire_order_index(context, index)) {
+        return api_error(ACCT_ERR_ORDER_POOL_FULL, ErrorCode::OrderPoolFull, "acct_new_order_ex orders shm pool full");
+    }
+    const uint32_t order_id = orders_shm_order_id(context->orders_shm, index);
+    request.internal_order_id = order_id;
+
     context->cached_orders[order_id] = request;
     *out_order_id = order_id;
     return ACCT_OK;
@@ -330,13 +840,20 @@ ACCT_API acct_error_t acct_send_order(acct_ctx_t ctx, uint32_t order_id) {
         return api_error(ACCT_ERR_NOT_INITIALIZED, ErrorCode::InvalidState, "acct_send_order called before init");
     }
 
+    // 换日后缓存随旧池一并丢弃，上一交易日创建的订单按未缓存处理
+    const acct_error_t follow_rc = follow_orders_rollover(context);
+    if (follow_rc != ACCT_OK) {
+        return follow_rc;
+    }
     auto it = context->cached_orders.find(order_id);
     if (it == context->cached_orders.end()) {
         return api_error(ACCT_ERR_ORDER_NOT_FOUND, ErrorCode::OrderNotFound, "acct_send_order order not cached");
     }
 
     it->second.order_state.store(OrderState::UserSubmitted, std::memory_order_release);
-    const acct_error_t rc = enqueue_order(context, it->second, order_slot_source_t::User, nullptr);
+    const acct_error_t rc =
+        enqueue_order(context, it->second, order_slot_source_t::User,
+                      orders_shm_index_for_order_id(context->orders_shm, order_id));
     if (rc != ACCT_OK) {
         return rc;
     }
@@ -374,26 +891,43 @@ ACCT_API acct_error_t acct_submit_order_ex(acct_ctx_t ctx, const char* security_
                          "acct_submit_order_ex invalid passive_exec_algo");
     }
 
-    const uint32_t order_id = context->upstream_shm->header.next_order_id.fetch_add(1, std::memory_order_relaxed);
     (void)valid_sec;
 
     OrderRequest request{};
     acct_error_t build_rc = ACCT_OK;
-    if (!build_new_order_request(security_id, side, market, volume, price, passive_execution_algo, order_id, request,
-                                 build_rc)) {
+    if (!build_new_order_request(security_id, side, market, volume, price, passive_execution_algo, 0,
+                                 get_current_md_time(), request, build_rc)) {
         return build_rc;
     }
+    const acct_error_t precheck_rc = precheck_new_order(context, request);
+    if (precheck_rc != ACCT_OK) {
+        return precheck_rc;
+    }
     request.order_state.store(OrderState::UserSubmitted, std::memory_order_release);
 
-    const acct_error_t rc = enqueue_order(context, request, order_slot_source_t::User, nullptr);
+    const acct_error_t rc = enqueue_order(context, request, order_slot_source_t::User);
     if (rc != ACCT_OK) {
         return rc;
     }
 
-    *out_order_id = order_id;
+    *out_order_id = request.internal_order_id;
     return ACCT_OK;
 }
 
+ACCT_API acct_error_t acct_submit_orders(acct_ctx_t ctx, const acct_order_spec_t* specs, size_t count,
+                                         uint32_t* out_ids, acct_error_t* out_results) {
+    return submit_order_specs(ctx, specs, count, 0, out_ids, out_results);
+}
+
+ACCT_API acct_error_t acct_submit_basket(acct_ctx_t ctx, const acct_order_spec_t* specs, size_t count,
+                                         uint32_t flags, uint32_t* out_ids, acct_error_t* out_results) {
+    if ((flags & ~static_cast<uint32_t>(ACCT_BASKET_ALL_OR_NOTHING)) != 0) {
+        return api_error(ACCT_ERR_INVALID_PARAM, ErrorCode::InvalidParam, "acct_submit_basket unknown flags");
+    }
+    const uint8_t basket_flags = (flags & ACCT_BASKET_ALL_OR_NOTHING) != 0 ? kBasketAllOrNothing : 0;
+    return submit_order_specs(ctx, specs, count, basket_flags, out_ids, out_results);
+}
+
 ACCT_API acct_error_t acct_cancel_order(acct_ctx_t ctx, uint32_t orig_order_id, uint32_t valid_sec,
                                         uint32_t* out_cancel_id) {
     if (!out_cancel_id) {
@@ -410,20 +944,71 @@ ACCT_API acct_error_t acct_cancel_order(acct_ctx_t ctx, uint32_t orig_order_id,
         return api_error(ACCT_ERR_NOT_INITIALIZED, ErrorCode::InvalidState, "acct_cancel_order called before init");
     }
 
-    const uint32_t cancel_id = context->upstream_shm->header.next_order_id.fetch_add(1, std::memory_order_relaxed);
     const MdTime md_time = get_current_md_time();
     (void)valid_sec;
 
     OrderRequest request;
-    request.init_cancel(static_cast<InternalOrderId>(cancel_id), md_time, static_cast<InternalOrderId>(orig_order_id));
+    request.init_cancel(0, md_time, static_cast<InternalOrderId>(orig_order_id));
     request.order_state.store(OrderState::UserSubmitted, std::memory_order_release);
 
-    const acct_error_t rc = enqueue_order(context, request, order_slot_source_t::User, nullptr);
+    const acct_error_t rc = enqueue_order(context, request, order_slot_source_t::User, kInvalidOrderIndex, true);
     if (rc != ACCT_OK) {
         return rc;
     }
 
-    *out_cancel_id = cancel_id;
+    *out_cancel_id = request.internal_order_id;
+    return ACCT_OK;
+}
+
+ACCT_API acct_error_t acct_mass_cancel(acct_ctx_t ctx, const acct_mass_cancel_spec_t* spec, uint32_t* out_request_id) {
+    if (!out_request_id) {
+        return api_error(ACCT_ERR_INVALID_PARAM, ErrorCode::InvalidParam, "acct_mass_cancel out_request_id is null");
+    }
+    *out_request_id = 0;
+
+    if (!ctx || !spec) {
+        return api_error(ACCT_ERR_INVALID_PARAM, ErrorCode::InvalidParam, "acct_mass_cancel invalid ctx/spec");
+    }
+
+    auto* context = ctx;
+    if (!context->initialized || !context->upstream_shm) {
+        return api_error(ACCT_ERR_NOT_INITIALIZED, ErrorCode::InvalidState, "acct_mass_cancel called before init");
+    }
+
+    InternalSecurityId internal_security_id;
+    switch (spec->scope) {
+        case ACCT_MASS_CANCEL_ACCOUNT:
+        case ACCT_MASS_CANCEL_STRATEGY:
+            break;
+        case ACCT_MASS_CANCEL_SECURITY:
+            if (!spec->security_id || spec->market < ACCT_MARKET_SZ || spec->market > ACCT_MARKET_HK ||
+                !build_internal_security_id(static_cast<Market>(spec->market), std::string_view(spec->security_id),
+                                            internal_security_id)) {
+                return api_error(ACCT_ERR_INVALID_PARAM, ErrorCode::InvalidParam,
+                                 "acct_mass_cancel invalid security_id/market");
+            }
+            break;
+        case ACCT_MASS_CANCEL_PARENT:
+            if (spec->parent_order_id == 0) {
+                return api_error(ACCT_ERR_INVALID_PARAM, ErrorCode::InvalidParam, "acct_mass_cancel parent id is zero");
+            }
+            break;
+        default:
+            return api_error(ACCT_ERR_INVALID_PARAM, ErrorCode::InvalidParam, "acct_mass_cancel invalid scope");
+    }
+
+    OrderRequest request;
+    request.init_mass_cancel(0, get_current_md_time(), static_cast<MassCancelScope>(spec->scope),
+                             static_cast<StrategyId>(spec->strategy_id), internal_security_id,
+                             static_cast<InternalOrderId>(spec->parent_order_id));
+    request.order_state.store(OrderState::UserSubmitted, std::memory_order_release);
+
+    const acct_error_t rc = enqueue_order(context, request, order_slot_source_t::User);
+    if (rc != ACCT_OK) {
+        return rc;
+    }
+
+    *out_request_id = request.internal_order_id;
     return ACCT_OK;
 }
 
@@ -442,7 +1027,185 @@ ACCT_API acct_error_t acct_queue_size(acct_ctx_t ctx, size_t* out_size) {
         return api_error(ACCT_ERR_NOT_INITIALIZED, ErrorCode::InvalidState, "acct_queue_size called before init");
     }
 
-    *out_size = context->upstream_shm->upstream_order_queue.size();
+    *out_size = context->upstream_shm->lane(context->upstream_lane).size();
+    return ACCT_OK;
+}
+
+ACCT_API acct_error_t acct_available_credits(acct_ctx_t ctx, size_t* out_credits) {
+    if (!out_credits) {
+        return api_error(ACCT_ERR_INVALID_PARAM, ErrorCode::InvalidParam, "acct_available_credits out_credits is null");
+    }
+    *out_credits = 0;
+
+    if (!ctx) {
+        return api_error(ACCT_ERR_INVALID_PARAM, ErrorCode::InvalidParam, "acct_available_credits ctx is null");
+    }
+
+    auto* context = ctx;
+    if (!context->initialized || !context->upstream_shm) {
+        return api_error(ACCT_ERR_NOT_INITIALIZED, ErrorCode::InvalidState,
+                         "acct_available_credits called before init");
+    }
+
+    upstream_shm_layout::lane_queue& queue = context->upstream_shm->lane(context->upstream_lane);
+    *out_credits = queue.free_slots(queue.capacity());
+    return ACCT_OK;
+}
+
+ACCT_API acct_error_t acct_wait_credits(acct_ctx_t ctx, size_t min_credits, uint32_t timeout_us,
+                                        size_t* out_credits) {
+    if (out_credits) {
+        *out_credits = 0;
+    }
+    if (!ctx) {
+        return api_error(ACCT_ERR_INVALID_PARAM, ErrorCode::InvalidParam, "acct_wait_credits ctx is null");
+    }
+
+    auto* context = ctx;
+    if (!context->initialized || !context->upstream_shm) {
+        return api_error(ACCT_ERR_NOT_INITIALIZED, ErrorCode::InvalidState, "acct_wait_credits called before init");
+    }
+    upstream_shm_layout::lane_queue& queue = context->upstream_shm->lane(context->upstream_lane);
+    if (min_credits == 0 || min_credits > queue.capacity()) {
+        return api_error(ACCT_ERR_INVALID_PARAM, ErrorCode::InvalidParam, "acct_wait_credits invalid min_credits");
+    }
+
+    // 缓存额度已够时不读对端索引；不够时刷新一次，仍不够再在额度门铃上等待
+    std::size_t credits = queue.free_slots(min_credits);
+    const TimestampNs deadline_ns = now_monotonic_ns() + static_cast<TimestampNs>(timeout_us) * 1000;
+    while (credits < min_credits) {
+        const TimestampNs now = now_monotonic_ns();
+        if (now >= deadline_ns) {
+            break;
+        }
+        const uint32_t remaining_us = static_cast<uint32_t>((deadline_ns - now + 999) / 1000);
+        doorbell_wait(&context->upstream_shm->lane_table.credit_doorbell, remaining_us,
+                      [&]() { return queue.free_slots(min_credits) >= min_credits; });
+        credits = queue.free_slots(min_credits);
+    }
+    if (out_credits) {
+        *out_credits = credits;
+    }
+    // 超时属于正常的节流结果，不写错误日志
+    return credits >= min_credits ? ACCT_OK : ACCT_ERR_QUEUE_FULL;
+}
+
+ACCT_API acct_error_t acct_upstream_lane(acct_ctx_t ctx, uint32_t* out_lane) {
+    if (!out_lane) {
+        return api_error(ACCT_ERR_INVALID_PARAM, ErrorCode::InvalidParam, "acct_upstream_lane out_lane is null");
+    }
+    *out_lane = 0;
+
+    if (!ctx) {
+        return api_error(ACCT_ERR_INVALID_PARAM, ErrorCode::InvalidParam, "acct_upstream_lane ctx is null");
+    }
+
+    auto* context = ctx;
+    if (!context->initialized || !context->upstream_shm) {
+        return api_error(ACCT_ERR_NOT_INITIALIZED, ErrorCode::InvalidState, "acct_upstream_lane called before init");
+    }
+
+    *out_lane = context->upstream_lane;
+    return ACCT_OK;
+}
+
+ACCT_API acct_error_t acct_wait_order(acct_ctx_t ctx, uint32_t order_id, uint32_t state_mask, uint64_t timeout_ns) {
+    constexpr uint32_t kAllWaitBits =
+        ACCT_WAIT_DEQUEUED | ACCT_WAIT_ACCEPTED | ACCT_WAIT_TRADED | ACCT_WAIT_REJECTED | ACCT_WAIT_TERMINAL;
+    if (!ctx || order_id == 0 || state_mask == 0 || (state_mask & ~kAllWaitBits) != 0) {
+        return api_error(ACCT_ERR_INVALID_PARAM, ErrorCode::InvalidParam, "acct_wait_order invalid ctx/order_id/mask");
+    }
+
+    auto* context = ctx;
+    if (!context->initialized || !context->orders_shm) {
+        return api_error(ACCT_ERR_NOT_INITIALIZED, ErrorCode::InvalidState, "acct_wait_order called before init");
+    }
+
+    // 槽位可能仍是空槽或已被其他订单占用：订单号不符时视为不存在，不进入等待
+    bool foreign = false;
+    order_slot_snapshot snapshot;
+    const orders_slot_wait_result result = orders_shm_wait_slot(
+        context->orders_shm, order_id_slot_index(order_id), timeout_ns,
+        [&](const order_slot_snapshot& current) {
+            foreign = current.request.internal_order_id != order_id;
+            return foreign || order_wait_matched(current, state_mask);
+        },
+        snapshot);
+    if (result == orders_slot_wait_result::NotFound || foreign) {
+        return api_error(ACCT_ERR_ORDER_NOT_FOUND, ErrorCode::OrderNotFound, "acct_wait_order order not in pool");
+    }
+    return result == orders_slot_wait_result::Matched ? ACCT_OK : ACCT_ERR_TIMEOUT;
+}
+
+ACCT_API acct_error_t acct_poll_order_updates(acct_ctx_t ctx, acct_order_update_t* out_updates, size_t max_updates,
+                                              size_t* out_count) {
+    if (!out_count) {
+        return api_error(ACCT_ERR_INVALID_PARAM, ErrorCode::InvalidParam, "acct_poll_order_updates out_count is null");
+    }
+    *out_count = 0;
+
+    if (!ctx || (!out_updates && max_updates != 0)) {
+        return api_error(ACCT_ERR_INVALID_PARAM, ErrorCode::InvalidParam,
+                         "acct_poll_order_updates invalid ctx/out_updates");
+    }
+
+    auto* context = ctx;
+    if (!context->initialized || !context->upstream_shm) {
+        return api_error(ACCT_ERR_NOT_INITIALIZED, ErrorCode::InvalidState,
+                         "acct_poll_order_updates called before init");
+    }
+
+    // 分块批量出队后转换为 C ABI 结构；块大小只影响栈上缓冲，不改变单次读取语义
+    auto& queue = context->upstream_shm->order_updates(context->upstream_lane).queue;
+    order_update_message buffer[64];
+    size_t taken = 0;
+    while (taken < max_updates) {
+        const std::size_t want = std::min<std::size_t>(std::size(buffer), max_updates - taken);
+        const std::size_t got = queue.try_pop_bulk(buffer, want);
+        for (std::size_t i = 0; i < got; ++i) {
+            const order_update_message& message = buffer[i];
+            acct_order_update_t& out = out_updates[taken + i];
+            out = acct_order_update_t{};
+            out.order_id = message.internal_order_id;
+            out.orig_order_id = message.orig_internal_order_id;
+            out.order_status = static_cast<uint8_t>(message.order_state);
+            out.event = message.event;
+            out.order_type = static_cast<uint8_t>(message.order_type);
+            out.volume_traded = message.volume_traded;
+            out.volume_remain = message.volume_remain;
+            out.dvalue_traded = message.dvalue_traded;
+            out.dprice_traded = message.dprice_traded;
+            out.dfee_executed = message.dfee_executed;
+            out.update_ns = message.update_ns;
+        }
+        taken += got;
+        if (got < want) {
+            break;
+        }
+    }
+    *out_count = taken;
+    return ACCT_OK;
+}
+
+ACCT_API acct_error_t acct_order_updates_dropped(acct_ctx_t ctx, uint64_t* out_dropped) {
+    if (!out_dropped) {
+        return api_error(ACCT_ERR_INVALID_PARAM, ErrorCode::InvalidParam,
+                         "acct_order_updates_dropped out_dropped is null");
+    }
+    *out_dropped = 0;
+
+    if (!ctx) {
+        return api_error(ACCT_ERR_INVALID_PARAM, ErrorCode::InvalidParam, "acct_order_updates_dropped ctx is null");
+    }
+
+    auto* context = ctx;
+    if (!context->initialized || !context->upstream_shm) {
+        return api_error(ACCT_ERR_NOT_INITIALIZED, ErrorCode::InvalidState,
+                         "acct_order_updates_dropped called before init");
+    }
+
+    *out_dropped =
+        context->upstream_shm->order_updates(context->upstream_lane).dropped.load(std::memory_order_relaxed);
     return ACCT_OK;
 }
 
@@ -464,6 +1227,14 @@ ACCT_API const char* acct_strerror(acct_error_t err) {
             return "Order cache is full";
         case ACCT_ERR_ORDER_POOL_FULL:
             return "Order pool is full";
+        case ACCT_ERR_NO_FREE_LANE:
+            return "No free upstream lane";
+        case ACCT_ERR_BASKET_ABORTED:
+            return "Basket aborted by another leg";
+        case ACCT_ERR_TIMEOUT:
+            return "Wait timed out";
+        case ACCT_ERR_RISK_REJECTED:
+            return "Rejected by local pre-trade check";
         case ACCT_ERR_INTERNAL:
             return "Internal error";
         default:
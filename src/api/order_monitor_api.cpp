@@ -1,5 +1,6 @@
 #include "api/order_monitor_api.h"
 
+#include <algorithm>
 #include <atomic>
 #include <cctype>
 #include <cstdlib>
@@ -10,7 +11,11 @@
 #include <string_view>
 
 #include "common/constants.hpp"
+#include "common/idle_strategy.hpp"
 #include "shm/basecore_shm_bridge.hpp"
+#include "shm/orders_index_shm.hpp"
+#include "shm/orders_shm.hpp"
+#include "shm/orders_window_map.hpp"
 #include "shm/shm_layout.hpp"
 
 namespace {
@@ -19,6 +24,12 @@ static_assert(ACCT_MON_SECURITY_ID_LEN == acct_service::kSecurityIdSize, "securi
 static_assert(ACCT_MON_INTERNAL_SECURITY_ID_LEN == acct_service::kInternalSecurityIdSize,
               "internal security id size mismatch");
 static_assert(ACCT_MON_BROKER_ORDER_ID_LEN == acct_service::kBrokerOrderIdSize, "broker order id size mismatch");
+static_assert(ACCT_MON_LATENCY_HOP_COUNT == acct_service::kOrderLatencyHopCount, "latency hop count mismatch");
+static_assert(ACCT_MON_HOP_FIRST_RESPONSE == static_cast<int>(acct_service::OrderLatencyHop::FirstResponse),
+              "latency hop enum mismatch");
+static_assert(ACCT_MON_MAX_OVERFLOW_SEGMENTS == acct_service::kMaxOrdersOverflowSegments,
+              "overflow segment count mismatch");
+static_assert(ACCT_MON_INDEX_SEGMENT_SHIFT == acct_service::kOrderIndexSegmentShift, "index segment shift mismatch");
 
 bool is_valid_trading_day(std::string_view trading_day) noexcept {
     if (trading_day.size() != 8) {
@@ -68,12 +79,9 @@ bool resolve_options(const acct_orders_mon_options_t* options, std::string& base
     return is_valid_trading_day(trading_day);
 }
 
-bool is_index_visible(const acct_service::orders_shm_layout* shm, uint32_t index) noexcept {
-    if (!shm) {
-        return false;
-    }
-    const uint32_t upper = shm->header.next_index.load(std::memory_order_acquire);
-    return index < upper && index < shm->header.capacity;
+// 段内已发布上界（不超过容量）
+uint32_t segment_upper(const acct_service::orders_shm_layout* segment) noexcept {
+    return std::min(segment->header.next_index.load(std::memory_order_acquire), segment->header.capacity);
 }
 
 void fill_snapshot(acct_orders_mon_snapshot_t& out, uint32_t index, uint64_t seq, uint64_t last_update_ns,
@@ -125,28 +133,45 @@ void fill_snapshot(acct_orders_mon_snapshot_t& out, uint32_t index, uint64_t seq
     std::memcpy(out.broker_order_id, request.broker_order_id.as_str.data, sizeof(out.broker_order_id));
 }
 
-bool try_read_stable_snapshot(const acct_service::orders_shm_layout* shm, uint32_t index,
-                              acct_orders_mon_snapshot_t& out_snapshot) {
-    if (!is_index_visible(shm, index)) {
+// 单次 seqlock 读取：写入中或读取期间被改写返回 false；稳定读出后合并网关下游进度
+bool read_slot_once(const acct_service::orders_shm_layout& segment, uint32_t local, uint32_t index,
+                    acct_orders_mon_snapshot_t& out_snapshot) {
+    const acct_service::OrderSlot& slot = segment.slots[local];
+    const uint64_t seq0 = slot.seq.load(std::memory_order_acquire);
+    if ((seq0 & 1ULL) != 0U) {
         return false;
     }
 
-    const acct_service::OrderSlot& slot = shm->slots[index];
-    for (uint32_t attempt = 0; attempt < 32; ++attempt) {
-        const uint64_t seq0 = slot.seq.load(std::memory_order_acquire);
-        if ((seq0 & 1ULL) != 0U) {
-            continue;
-        }
+    uint64_t last_update_ns = slot.last_update_ns;
+    acct_service::OrderSlotState stage = slot.stage;
+    const acct_service::order_slot_source_t source = slot.source;
+    const acct_service::OrderRequest request = slot.request;
+
+    std::atomic_thread_fence(std::memory_order_acquire);
+    const uint64_t seq1 = slot.seq.load(std::memory_order_acquire);
+    if (seq0 != seq1) {
+        return false;
+    }
+    acct_service::orders_shm_merge_downstream(&segment, local, stage, last_update_ns);
+    fill_snapshot(out_snapshot, index, seq1, last_update_ns, stage, source, request);
+    return true;
+}
 
-        const uint64_t last_update_ns = slot.last_update_ns;
-        const acct_service::OrderSlotState stage = slot.stage;
-        const acct_service::order_slot_source_t source = slot.source;
-        const acct_service::OrderRequest request = slot.request;
+constexpr uint32_t kDefaultReadSpinCount = 64;
+constexpr uint32_t kDefaultReadYieldCount = 4;
 
-        std::atomic_thread_fence(std::memory_order_acquire);
-        const uint64_t seq1 = slot.seq.load(std::memory_order_acquire);
-        if (seq0 == seq1 && (seq1 & 1ULL) == 0U) {
-            fill_snapshot(out_snapshot, index, seq1, last_update_ns, stage, source, request);
+// 有界重试：先 pause 自旋等写端完成，再让出 CPU 几次；始终不睡眠，冲突持续则交给调用方延后重读。
+bool try_read_stable_snapshot(const acct_service::orders_shm_layout& segment, uint32_t local, uint32_t index,
+                              uint32_t spin_count, uint32_t yield_count, acct_orders_mon_snapshot_t& out_snapshot) {
+    for (uint32_t attempt = 0; attempt < spin_count; ++attempt) {
+        if (read_slot_once(segment, local, index, out_snapshot)) {
+            return true;
+        }
+        acct_service::cpu_relax();
+    }
+    for (uint32_t attempt = 0; attempt < yield_count; ++attempt) {
+        ::sched_yield();
+        if (read_slot_once(segment, local, index, out_snapshot)) {
             return true;
         }
     }
@@ -154,7 +179,9 @@ bool try_read_stable_snapshot(const acct_service::orders_shm_layout* shm, uint32
     return false;
 }
 
-bool validate_header(const acct_service::orders_shm_layout* shm, std::string_view expected_trading_day) noexcept {
+// 段大小由账户服务按配置容量决定，头部 total_size/capacity 须与实际映射大小一致
+bool validate_header(const acct_service::orders_shm_layout* shm, std::size_t mapped_size,
+                     std::string_view expected_trading_day) noexcept {
     if (!shm) {
         return false;
     }
@@ -169,10 +196,10 @@ bool validate_header(const acct_service::orders_shm_layout* shm, std::string_vie
     if (header.header_size != static_cast<uint32_t>(sizeof(acct_service::OrdersHeader))) {
         return false;
     }
-    if (header.total_size != static_cast<uint32_t>(sizeof(acct_service::orders_shm_layout))) {
+    if (header.total_size != static_cast<uint32_t>(mapped_size)) {
         return false;
     }
-    if (header.capacity != static_cast<uint32_t>(acct_service::kDailyOrderPoolCapacity)) {
+    if (acct_service::orders_shm_capacity_for_size(mapped_size) != header.capacity) {
         return false;
     }
     if (header.init_state != 1U) {
@@ -187,18 +214,107 @@ struct acct_orders_monitor_context {
     acct_orders_monitor_context() = default;
 
     shm::ShmGenericReader reader{};
+    // 默认按窗口只读映射主段：打开时只映射头部与变更日志，槽位在首次读取时映射（ACCT_ORDERS_MAP_WINDOW_KB=0 整段映射）
+    acct_service::orders_window_map windows{};
     const acct_service::orders_shm_layout* orders_shm = nullptr;
+    // 溢出段在主段头部发布后首次访问时只读映射，随上下文关闭解除
+    shm::ShmGenericReader overflow_readers[acct_service::kMaxOrdersOverflowSegments]{};
+    const acct_service::orders_shm_layout* overflow_shm[acct_service::kMaxOrdersOverflowSegments]{};
+    // 二级索引段在首次过滤查询时只读映射；段不存在时每次查询重试
+    shm::ShmGenericReader index_reader{};
+    const acct_service::orders_index_shm_layout* orders_index = nullptr;
 
     std::string orders_base_name;
     std::string trading_day;
     std::string orders_dated_name;
 
+    uint32_t read_spin_count = kDefaultReadSpinCount;
+    uint32_t read_yield_count = kDefaultReadYieldCount;
     bool initialized = false;
 
     acct_orders_monitor_context(const acct_orders_monitor_context&) = delete;
     acct_orders_monitor_context& operator=(const acct_orders_monitor_context&) = delete;
 };
 
+namespace {
+
+// 段号对应的段：0 为主段；溢出段未发布、映射或校验失败时返回 nullptr，下次访问重试
+const acct_service::orders_shm_layout* monitor_segment(acct_orders_monitor_context& context, uint32_t segment) {
+    if (segment == 0) {
+        return context.orders_shm;
+    }
+    if (segment > acct_service::kMaxOrdersOverflowSegments ||
+        segment > context.orders_shm->header.overflow_segments.load(std::memory_order_acquire)) {
+        return nullptr;
+    }
+    const acct_service::orders_shm_layout*& mapped = context.overflow_shm[segment - 1];
+    if (mapped) {
+        return mapped;
+    }
+
+    shm::ShmGenericReader& reader = context.overflow_readers[segment - 1];
+    const std::string name = acct_service::make_orders_overflow_shm_name(context.orders_dated_name, segment);
+    std::size_t mapped_size = 0;
+    if (!acct_service::basecore_shm_bridge::segment_size(name, mapped_size) ||
+        acct_service::orders_shm_capacity_for_size(mapped_size) == 0 ||
+        !acct_service::basecore_shm_bridge::open_reader(reader, name, mapped_size)) {
+        return nullptr;
+    }
+    const auto* layout = static_cast<const acct_service::orders_shm_layout*>(reader.data());
+    if (!validate_header(layout, mapped_size, context.trading_day) || layout->header.overflow_index != segment) {
+        reader.close();
+        return nullptr;
+    }
+    mapped = layout;
+    return mapped;
+}
+
+// 全局索引所在的段与段内下标，槽位未发布或不可见时返回 nullptr
+const acct_service::orders_shm_layout* find_visible_segment(acct_orders_monitor_context& context, uint32_t index,
+                                                            uint32_t& out_local) {
+    const acct_service::orders_shm_layout* segment =
+        monitor_segment(context, acct_service::orders_index_segment(index));
+    out_local = acct_service::orders_index_local(index);
+    if (!segment || out_local >= segment_upper(segment) ||
+        !acct_service::orders_shm_slots_mapped(segment, out_local, out_local + 1)) {
+        return nullptr;
+    }
+    return segment;
+}
+
+// 二级索引段：大小与头部须与本进程布局一致，交易日由调用方逐次比对
+const acct_service::orders_index_shm_layout* monitor_orders_index(acct_orders_monitor_context& context) {
+    if (context.orders_index) {
+        return context.orders_index;
+    }
+    const std::string name = acct_service::make_orders_index_shm_name(context.orders_base_name);
+    std::size_t mapped_size = 0;
+    if (!acct_service::basecore_shm_bridge::segment_size(name, mapped_size) ||
+        mapped_size != acct_service::orders_index_shm_layout::total_size() ||
+        !acct_service::basecore_shm_bridge::open_reader(context.index_reader, name, mapped_size)) {
+        return nullptr;
+    }
+    const auto* layout = static_cast<const acct_service::orders_index_shm_layout*>(context.index_reader.data());
+    if (layout->header.magic != acct_service::SHMHeader::kMagic ||
+        layout->header.version != acct_service::SHMHeader::kVersion) {
+        context.index_reader.close();
+        return nullptr;
+    }
+    context.orders_index = layout;
+    return layout;
+}
+
+constexpr uint32_t kKnownQueryFilters = ACCT_MON_QUERY_SECURITY | ACCT_MON_QUERY_STRATEGY | ACCT_MON_QUERY_LIVE;
+
+enum class query_walk : uint8_t { security, strategy, live };
+
+// 游标高 32 位为索引代数，低 32 位为下一个待读节点 + 1；0 保留给“从头开始/已遍历完”
+uint64_t make_query_cursor(uint64_t generation, uint32_t node) noexcept {
+    return (generation << 32) | (static_cast<uint64_t>(node) + 1);
+}
+
+}  // namespace
+
 extern "C" {
 
 ACCT_MON_API acct_mon_error_t acct_orders_mon_open(const acct_orders_mon_options_t* options,
@@ -224,18 +340,32 @@ ACCT_MON_API acct_mon_error_t acct_orders_mon_open(const acct_orders_mon_options
     }
 
     ctx->orders_dated_name = make_orders_shm_name(base_name, trading_day);
-    if (!acct_service::basecore_shm_bridge::open_reader(ctx->reader, ctx->orders_dated_name,
-                                                        sizeof(acct_service::orders_shm_layout))) {
+    std::size_t mapped_size = 0;
+    if (!acct_service::basecore_shm_bridge::segment_size(ctx->orders_dated_name, mapped_size) ||
+        acct_service::orders_shm_capacity_for_size(mapped_size) == 0) {
         return ACCT_MON_ERR_SHM_FAILED;
     }
-
-    ctx->orders_shm = static_cast<const acct_service::orders_shm_layout*>(ctx->reader.data());
-    if (!validate_header(ctx->orders_shm, trading_day)) {
+    const std::size_t window_bytes = acct_service::orders_window_bytes_from_env();
+    if (window_bytes > 0) {
+        ctx->orders_shm = ctx->windows.open(ctx->orders_dated_name, mapped_size, window_bytes, false, false);
+    } else if (acct_service::basecore_shm_bridge::open_reader(ctx->reader, ctx->orders_dated_name, mapped_size)) {
+        ctx->orders_shm = static_cast<const acct_service::orders_shm_layout*>(ctx->reader.data());
+    }
+    if (!ctx->orders_shm) {
+        return ACCT_MON_ERR_SHM_FAILED;
+    }
+    if (!validate_header(ctx->orders_shm, mapped_size, trading_day)) {
         return ACCT_MON_ERR_SHM_FAILED;
     }
 
     ctx->orders_base_name = base_name;
     ctx->trading_day = trading_day;
+    if (options && options->read_spin_count != 0) {
+        ctx->read_spin_count = options->read_spin_count;
+    }
+    if (options && options->read_yield_count != 0) {
+        ctx->read_yield_count = options->read_yield_count;
+    }
     ctx->initialized = true;
     *out_ctx = ctx.release();
     return ACCT_MON_OK;
@@ -271,6 +401,26 @@ ACCT_MON_API acct_mon_error_t acct_orders_mon_info(acct_orders_mon_ctx_t ctx, ac
     out_info->last_update_ns = header.last_update;
     std::memset(out_info->trading_day, 0, sizeof(out_info->trading_day));
     std::memcpy(out_info->trading_day, header.trading_day, ACCT_MON_TRADING_DAY_LEN);
+    out_info->journal_cursor = context->orders_shm->journal.write_cursor.load(std::memory_order_acquire);
+    std::memset(out_info->successor_trading_day, 0, sizeof(out_info->successor_trading_day));
+    const uint32_t successor = acct_service::orders_shm_successor_day(context->orders_shm);
+    if (successor != 0) {
+        const std::string successor_day = acct_service::trading_day_string(successor);
+        std::memcpy(out_info->successor_trading_day, successor_day.data(), ACCT_MON_TRADING_DAY_LEN);
+    }
+    out_info->overflow_segments = 0;
+    std::memset(out_info->overflow_next_index, 0, sizeof(out_info->overflow_next_index));
+    const uint32_t published = std::min<uint32_t>(header.overflow_segments.load(std::memory_order_acquire),
+                                                  acct_service::kMaxOrdersOverflowSegments);
+    for (uint32_t segment = 1; segment <= published; ++segment) {
+        const acct_service::orders_shm_layout* overflow = monitor_segment(*context, segment);
+        if (!overflow) {
+            break;
+        }
+        out_info->overflow_segments = segment;
+        out_info->overflow_next_index[segment - 1] =
+            acct_service::make_orders_index(segment, 0) + segment_upper(overflow);
+    }
     return ACCT_MON_OK;
 }
 
@@ -285,17 +435,232 @@ ACCT_MON_API acct_mon_error_t acct_orders_mon_read(acct_orders_mon_ctx_t ctx, ui
         return ACCT_MON_ERR_NOT_INITIALIZED;
     }
 
-    if (!is_index_visible(context->orders_shm, index)) {
+    uint32_t local = 0;
+    const acct_service::orders_shm_layout* segment = find_visible_segment(*context, index, local);
+    if (!segment) {
         return ACCT_MON_ERR_NOT_FOUND;
     }
 
-    if (!try_read_stable_snapshot(context->orders_shm, index, *out_snapshot)) {
+    if (!try_read_stable_snapshot(*segment, local, index, context->read_spin_count, context->read_yield_count,
+                                  *out_snapshot)) {
         return ACCT_MON_ERR_RETRY;
     }
 
     return ACCT_MON_OK;
 }
 
+ACCT_MON_API acct_mon_error_t acct_orders_mon_read_latency(acct_orders_mon_ctx_t ctx, uint32_t index,
+                                                           acct_orders_mon_latency_t* out_latency) {
+    if (!ctx || !out_latency) {
+        return ACCT_MON_ERR_INVALID_PARAM;
+    }
+
+    auto* context = ctx;
+    if (!context->initialized || !context->orders_shm) {
+        return ACCT_MON_ERR_NOT_INITIALIZED;
+    }
+
+    uint32_t local = 0;
+    const acct_service::orders_shm_layout* segment = find_visible_segment(*context, index, local);
+    if (!segment) {
+        return ACCT_MON_ERR_NOT_FOUND;
+    }
+
+    const acct_service::OrderSlot& slot = segment->slots[local];
+    out_latency->index = index;
+    out_latency->submit_ns = slot.submit_ns.load(std::memory_order_relaxed);
+    for (std::size_t i = 0; i < ACCT_MON_LATENCY_HOP_COUNT; ++i) {
+        out_latency->hop_delta_ns[i] = slot.hop_delta_ns[i].load(std::memory_order_relaxed);
+    }
+    return ACCT_MON_OK;
+}
+
+ACCT_MON_API acct_mon_error_t acct_orders_mon_read_range(acct_orders_mon_ctx_t ctx, uint32_t begin, uint32_t end,
+                                                         acct_orders_mon_snapshot_t* out_snapshots, size_t* out_count,
+                                                         uint32_t* out_unstable, size_t* out_unstable_count) {
+    if (!ctx || !out_count || begin > end || (!out_snapshots && end > begin)) {
+        return ACCT_MON_ERR_INVALID_PARAM;
+    }
+    *out_count = 0;
+    if (out_unstable_count) {
+        *out_unstable_count = 0;
+    }
+
+    auto* context = ctx;
+    if (!context->initialized || !context->orders_shm) {
+        return ACCT_MON_ERR_NOT_INITIALIZED;
+    }
+
+    // 区间不跨段：按 begin 所在段截断，段号不可达时视为空区间
+    const uint32_t segment_id = acct_service::orders_index_segment(begin);
+    const acct_service::orders_shm_layout* shm = monitor_segment(*context, segment_id);
+    if (!shm) {
+        return ACCT_MON_OK;
+    }
+    const uint32_t base = acct_service::make_orders_index(segment_id, 0);
+    const uint32_t stop = std::min(end, base + segment_upper(shm));
+    if (begin < stop && !acct_service::orders_shm_slots_mapped(shm, begin - base, stop - base)) {
+        return ACCT_MON_ERR_SHM_FAILED;
+    }
+
+    // 顺序扫描时提前预取后续槽位，把内存延迟与当前槽位的拷贝重叠
+    constexpr uint32_t kPrefetchDistance = 8;
+    std::size_t unstable = 0;
+    for (uint32_t index = begin; index < stop; ++index) {
+        if (index + kPrefetchDistance < stop) {
+            const char* ahead = reinterpret_cast<const char*>(&shm->slots[index - base + kPrefetchDistance]);
+            for (std::size_t offset = 0; offset < sizeof(acct_service::OrderSlot); offset += 64) {
+                __builtin_prefetch(ahead + offset, 0, 0);
+            }
+        }
+        if (read_slot_once(*shm, index - base, index, out_snapshots[*out_count])) {
+            ++*out_count;
+            continue;
+        }
+        if (out_unstable) {
+            out_unstable[unstable] = index;
+        }
+        ++unstable;
+    }
+
+    if (out_unstable_count) {
+        *out_unstable_count = unstable;
+    }
+    return unstable == 0 ? ACCT_MON_OK : ACCT_MON_ERR_RETRY;
+}
+
+ACCT_MON_API acct_mon_error_t acct_orders_mon_poll_changes(acct_orders_mon_ctx_t ctx, uint64_t* cursor,
+                                                           acct_orders_mon_change_t* out_changes,
+                                                           size_t max_changes, size_t* out_count) {
+    if (!ctx || !cursor || !out_count || (!out_changes && max_changes > 0)) {
+        return ACCT_MON_ERR_INVALID_PARAM;
+    }
+    *out_count = 0;
+
+    auto* context = ctx;
+    if (!context->initialized || !context->orders_shm) {
+        return ACCT_MON_ERR_NOT_INITIALIZED;
+    }
+
+    // 分批读入栈上缓冲再转成 C ABI 结构，避免为每次轮询分配内存
+    constexpr std::size_t kChunk = 256;
+    acct_service::OrderIndex indices[kChunk];
+    uint64_t seqs[kChunk];
+    bool lagged = false;
+    while (*out_count < max_changes) {
+        const std::size_t want = std::min(kChunk, max_changes - *out_count);
+        bool chunk_lagged = false;
+        const std::size_t got =
+            acct_service::orders_shm_journal_read(context->orders_shm, *cursor, indices, seqs, want, chunk_lagged);
+        lagged = lagged || chunk_lagged;
+        for (std::size_t i = 0; i < got; ++i) {
+            out_changes[*out_count + i].index = indices[i];
+            out_changes[*out_count + i].seq = static_cast<uint32_t>(seqs[i]);
+        }
+        *out_count += got;
+        if (got < want) {
+            break;
+        }
+    }
+    return lagged ? ACCT_MON_ERR_LAGGED : ACCT_MON_OK;
+}
+
+ACCT_MON_API acct_mon_error_t acct_orders_mon_query(acct_orders_mon_ctx_t ctx, const acct_orders_mon_query_t* query,
+                                                    uint64_t* cursor, acct_orders_mon_snapshot_t* out_snapshots,
+                                                    size_t max_snapshots, size_t* out_count) {
+    if (!ctx || !query || !cursor || !out_count || (!out_snapshots && max_snapshots > 0) || query->filters == 0 ||
+        (query->filters & ~kKnownQueryFilters) != 0) {
+        return ACCT_MON_ERR_INVALID_PARAM;
+    }
+    *out_count = 0;
+
+    auto* context = ctx;
+    if (!context->initialized || !context->orders_shm) {
+        return ACCT_MON_ERR_NOT_INITIALIZED;
+    }
+
+    const acct_service::orders_index_shm_layout* index = monitor_orders_index(*context);
+    if (!index) {
+        return ACCT_MON_ERR_UNAVAILABLE;
+    }
+    const uint64_t generation = index->generation.load(std::memory_order_acquire);
+    if ((generation & 1ULL) != 0) {
+        return ACCT_MON_ERR_RETRY;
+    }
+    if (index->trading_day.load(std::memory_order_acquire) != acct_service::trading_day_number(context->trading_day)) {
+        return ACCT_MON_ERR_UNAVAILABLE;
+    }
+
+    acct_service::InternalSecurityId security_id{};
+    if ((query->filters & ACCT_MON_QUERY_SECURITY) != 0) {
+        security_id.assign(std::string_view(query->internal_security_id,
+                                            ::strnlen(query->internal_security_id, ACCT_MON_INTERNAL_SECURITY_ID_LEN)));
+        if (security_id.empty()) {
+            return ACCT_MON_ERR_INVALID_PARAM;
+        }
+    }
+    const bool by_strategy = (query->filters & ACCT_MON_QUERY_STRATEGY) != 0;
+    const bool live_only = (query->filters & ACCT_MON_QUERY_LIVE) != 0;
+    const query_walk walk = (query->filters & ACCT_MON_QUERY_SECURITY) != 0 ? query_walk::security
+                            : by_strategy                                  ? query_walk::strategy
+                                                                           : query_walk::live;
+
+    // 证券链与策略链都只含当日入簿订单，剩余条件逐节点比对；只按在途过滤时直接扫位图
+    uint32_t node = acct_service::kOrdersIndexNil;
+    if (*cursor != 0) {
+        if ((*cursor >> 32) != (generation & 0xFFFFFFFFULL)) {
+            *cursor = 0;
+            return ACCT_MON_ERR_LAGGED;
+        }
+        node = static_cast<uint32_t>(*cursor & 0xFFFFFFFFULL) - 1;
+    } else if (walk == query_walk::security) {
+        const std::size_t bucket = acct_service::orders_index_find_security(*index, security_id);
+        if (bucket != acct_service::kInvalidOrdersIndexBucket) {
+            node = index->securities[bucket].head.load(std::memory_order_acquire);
+        }
+    } else if (walk == query_walk::strategy) {
+        node = index->strategies[query->strategy_id].head.load(std::memory_order_acquire);
+    } else {
+        node = acct_service::orders_index_next_live(*index, 0);
+    }
+
+    while (node != acct_service::kOrdersIndexNil && node < acct_service::kOrdersIndexNodeCount &&
+           *out_count < max_snapshots) {
+        const bool matched =
+            (walk != query_walk::security || !by_strategy ||
+             index->node_strategy[node].load(std::memory_order_relaxed) == query->strategy_id) &&
+            (walk == query_walk::live || !live_only || acct_service::orders_index_test_bit(index->live_bits, node));
+        if (matched) {
+            uint32_t local = 0;
+            const acct_service::orders_shm_layout* segment = find_visible_segment(*context, node, local);
+            if (!segment || !try_read_stable_snapshot(*segment, local, node, context->read_spin_count,
+                                                      context->read_yield_count, out_snapshots[*out_count])) {
+                *cursor = make_query_cursor(generation, node);
+                return ACCT_MON_ERR_RETRY;
+            }
+            ++*out_count;
+        }
+
+        if (walk == query_walk::security) {
+            node = index->next_by_security[node].load(std::memory_order_acquire);
+        } else if (walk == query_walk::strategy) {
+            node = index->next_by_strategy[node].load(std::memory_order_acquire);
+        } else {
+            node = acct_service::orders_index_next_live(*index, node + 1);
+        }
+    }
+
+    // 遍历期间换日重建：已读节点可能混入旧链，要求调用方从头再来
+    if (index->generation.load(std::memory_order_acquire) != generation) {
+        *cursor = 0;
+        return ACCT_MON_ERR_LAGGED;
+    }
+    *cursor = (node == acct_service::kOrdersIndexNil || node >= acct_service::kOrdersIndexNodeCount)
+                  ? 0
+                  : make_query_cursor(generation, node);
+    return ACCT_MON_OK;
+}
+
 ACCT_MON_API const char* acct_orders_mon_strerror(acct_mon_error_t err) {
     switch (err) {
         case ACCT_MON_OK:
@@ -310,6 +675,10 @@ ACCT_MON_API const char* acct_orders_mon_strerror(acct_mon_error_t err) {
             return "Order index not found";
         case ACCT_MON_ERR_RETRY:
             return "Snapshot not stable, retry";
+        case ACCT_MON_ERR_LAGGED:
+            return "Change cursor lagged behind journal";
+        case ACCT_MON_ERR_UNAVAILABLE:
+            return "Order index unavailable";
         case ACCT_MON_ERR_INTERNAL:
             return "Internal error";
         default:
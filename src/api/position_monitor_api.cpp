@@ -1,5 +1,10 @@
 #include "api/position_monitor_api.h"
 
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
 #include <atomic>
 #include <cstring>
 #include <memory>
@@ -9,6 +14,7 @@
 #include "common/constants.hpp"
 #include "portfolio/positions.h"
 #include "shm/basecore_shm_bridge.hpp"
+#include "shm/positions_shm.hpp"
 #include "shm/shm_layout.hpp"
 
 namespace {
@@ -36,8 +42,34 @@ bool resolve_options(const acct_positions_mon_options_t* options, std::string& p
     return !positions_shm_name.empty();
 }
 
-// 校验持仓共享内存头部，确保读者视图与当前布局一致。
-bool validate_header(const acct_service::positions_shm_layout* shm) noexcept {
+// 按共享内存段大小识别布局版本：v6/v7/v8 段大小互不相同；未知大小返回 0。
+uint32_t probe_layout_version(const std::string& positions_shm_name) noexcept {
+    const int fd = ::shm_open(positions_shm_name.c_str(), O_RDONLY | O_CLOEXEC, 0);
+    if (fd < 0) {
+        return 0;
+    }
+    struct stat shm_stat {};
+    const bool ok = ::fstat(fd, &shm_stat) == 0;
+    ::close(fd);
+    if (!ok) {
+        return 0;
+    }
+    const auto size = static_cast<std::size_t>(shm_stat.st_size);
+    if (size == sizeof(acct_service::positions_shm_layout)) {
+        return acct_service::PositionsHeader::kVersion;
+    }
+    if (size == sizeof(acct_service::positions_shm_layout_v7)) {
+        return acct_service::PositionsHeader::kVersionV7;
+    }
+    if (size == sizeof(acct_service::positions_shm_layout_v6)) {
+        return acct_service::PositionsHeader::kVersionV6;
+    }
+    return 0;
+}
+
+// 校验持仓共享内存头部，确保读者视图与所选布局一致。
+template <typename Layout>
+bool validate_header(const Layout* shm, uint32_t expected_version) noexcept {
     if (shm == nullptr) {
         return false;
     }
@@ -46,13 +78,13 @@ bool validate_header(const acct_service::positions_shm_layout* shm) noexcept {
     if (header.magic != acct_service::PositionsHeader::kMagic) {
         return false;
     }
-    if (header.version != acct_service::PositionsHeader::kVersion) {
+    if (header.version != expected_version) {
         return false;
     }
     if (header.header_size != static_cast<uint32_t>(sizeof(acct_service::PositionsHeader))) {
         return false;
     }
-    if (header.total_size != static_cast<uint32_t>(sizeof(acct_service::positions_shm_layout))) {
+    if (header.total_size != static_cast<uint32_t>(sizeof(Layout))) {
         return false;
     }
     if (header.capacity != static_cast<uint32_t>(acct_service::kMaxPositions)) {
@@ -61,29 +93,49 @@ bool validate_header(const acct_service::positions_shm_layout* shm) noexcept {
     return header.init_state == 1U;
 }
 
-// 抓取稳定资金行快照：仅在行锁前后都为未锁定时返回成功。
+void fill_fund_snapshot(const fund_info& fund, acct_positions_mon_fund_snapshot_t& out_snapshot) noexcept {
+    out_snapshot.total_asset = fund.total_asset;
+    out_snapshot.available = fund.available;
+    out_snapshot.frozen = fund.frozen;
+    out_snapshot.market_value = fund.market_value;
+}
+
+// 当前布局：资金取自 fund_row 读者快照，标识取自第 0 行（初始化后不再改写）。
 bool try_read_stable_fund_snapshot(
     const acct_service::positions_shm_layout* shm, acct_positions_mon_fund_snapshot_t& out_snapshot) {
-    const position& fund_row = shm->positions[kFundPositionIndex];
     for (uint32_t attempt = 0; attempt < 32; ++attempt) {
-        if (fund_row.locked.load(std::memory_order_acquire) != 0U) {
-            continue;
+        fund_info fund;
+        if (acct_service::positions_shm_try_read_fund(*shm, fund)) {
+            acct_positions_mon_fund_snapshot_t snapshot{};
+            const position& fund_row = shm->positions[kFundPositionIndex];
+            snapshot.last_update_ns = shm->header.last_update;
+            std::memcpy(snapshot.id, fund_row.id.data, sizeof(snapshot.id));
+            std::memcpy(snapshot.name, fund_row.name.data, sizeof(snapshot.name));
+            fill_fund_snapshot(fund, snapshot);
+            out_snapshot = snapshot;
+            return true;
         }
+    }
+    return false;
+}
 
-        out_snapshot = acct_positions_mon_fund_snapshot_t{};
-        out_snapshot.last_update_ns = shm->header.last_update;
-
-        std::memcpy(out_snapshot.id, fund_row.id.data, sizeof(out_snapshot.id));
-        std::memcpy(out_snapshot.name, fund_row.name.data, sizeof(out_snapshot.name));
-
-        out_snapshot.total_asset = fund_total_asset_field(fund_row);
-        out_snapshot.available = fund_available_field(fund_row);
-        out_snapshot.frozen = fund_frozen_field(fund_row);
-        out_snapshot.market_value = fund_market_value_field(fund_row);
-        out_snapshot.count_order = fund_row.count_order;
-
-        std::atomic_thread_fence(std::memory_order_acquire);
-        if (fund_row.locked.load(std::memory_order_acquire) == 0U) {
+// v6/v7 布局：资金复用第 0 行证券列，按行 seqlock 重试，写者从不等待读者。
+template <typename Layout>
+bool try_read_stable_fund_snapshot(const Layout* shm, acct_positions_mon_fund_snapshot_t& out_snapshot) {
+    const auto& fund_row = shm->positions[kFundPositionIndex];
+    for (uint32_t attempt = 0; attempt < 32; ++attempt) {
+        acct_positions_mon_fund_snapshot_t snapshot{};
+        const bool stable = position_try_read(fund_row, [&](const auto& row) {
+            snapshot.last_update_ns = shm->header.last_update;
+
+            std::memcpy(snapshot.id, row.id.data, sizeof(snapshot.id));
+            std::memcpy(snapshot.name, row.name.data, sizeof(snapshot.name));
+
+            fill_fund_snapshot(load_legacy_fund_info(row), snapshot);
+            snapshot.count_order = row.count_order;
+        });
+        if (stable) {
+            out_snapshot = snapshot;
             return true;
         }
     }
@@ -91,43 +143,47 @@ bool try_read_stable_fund_snapshot(
 }
 
 // 抓取稳定证券行快照：返回逻辑索引对应的一致视图。
+template <typename Layout>
 bool try_read_stable_position_snapshot(
-    const acct_service::positions_shm_layout* shm, uint32_t index, acct_positions_mon_position_snapshot_t& out_snapshot) {
+    const Layout* shm, uint32_t index, acct_positions_mon_position_snapshot_t& out_snapshot) {
     const uint32_t row_index = index + static_cast<uint32_t>(kFirstSecurityPositionIndex);
     if (row_index >= acct_service::kMaxPositions) {
         return false;
     }
 
-    const position& row = shm->positions[row_index];
+    const auto& row = shm->positions[row_index];
     for (uint32_t attempt = 0; attempt < 32; ++attempt) {
-        if (row.locked.load(std::memory_order_acquire) != 0U) {
-            continue;
-        }
-
-        out_snapshot = acct_positions_mon_position_snapshot_t{};
-        out_snapshot.index = index;
-        out_snapshot.row_index = row_index;
-        out_snapshot.last_update_ns = shm->header.last_update;
-
-        std::memcpy(out_snapshot.id, row.id.data, sizeof(out_snapshot.id));
-        std::memcpy(out_snapshot.name, row.name.data, sizeof(out_snapshot.name));
-
-        out_snapshot.available = row.available;
-        out_snapshot.volume_available_t0 = row.volume_available_t0;
-        out_snapshot.volume_available_t1 = row.volume_available_t1;
-        out_snapshot.volume_buy = row.volume_buy;
-        out_snapshot.dvalue_buy = row.dvalue_buy;
-        out_snapshot.volume_buy_traded = row.volume_buy_traded;
-        out_snapshot.dvalue_buy_traded = row.dvalue_buy_traded;
-        out_snapshot.volume_sell = row.volume_sell;
-        out_snapshot.dvalue_sell = row.dvalue_sell;
-        out_snapshot.volume_sell_traded = row.volume_sell_traded;
-        out_snapshot.dvalue_sell_traded = row.dvalue_sell_traded;
-        out_snapshot.count_order = row.count_order;
-
-        std::atomic_thread_fence(std::memory_order_acquire);
-        if (row.locked.load(std::memory_order_acquire) == 0U) {
-            return !row.id.empty();
+        acct_positions_mon_position_snapshot_t snapshot{};
+        const bool stable = position_try_read(row, [&](const auto& current) {
+            snapshot.index = index;
+            snapshot.row_index = row_index;
+            snapshot.last_update_ns = shm->header.last_update;
+
+            std::memcpy(snapshot.id, current.id.data, sizeof(snapshot.id));
+            std::memcpy(snapshot.name, current.name.data, sizeof(snapshot.name));
+
+            snapshot.available = current.available;
+            snapshot.volume_available_t0 = current.volume_available_t0;
+            snapshot.volume_available_t1 = current.volume_available_t1;
+            snapshot.volume_buy = current.volume_buy;
+            snapshot.dvalue_buy = current.dvalue_buy;
+            snapshot.volume_buy_traded = current.volume_buy_traded;
+            snapshot.dvalue_buy_traded = current.dvalue_buy_traded;
+            snapshot.volume_sell = current.volume_sell;
+            snapshot.dvalue_sell = current.dvalue_sell;
+            snapshot.volume_sell_traded = current.volume_sell_traded;
+            snapshot.dvalue_sell_traded = current.dvalue_sell_traded;
+            snapshot.count_order = current.count_order;
+            if constexpr (requires { current.realized_pnl; }) {
+                snapshot.cost_basis = current.cost_basis;
+                snapshot.realized_pnl = current.realized_pnl;
+                snapshot.unrealized_pnl = current.unrealized_pnl;
+                snapshot.mark_price = current.mark_price;
+            }
+        });
+        if (stable) {
+            out_snapshot = snapshot;
+            return snapshot.id[0] != '\0';
         }
     }
     return false;
@@ -139,14 +195,48 @@ struct acct_positions_monitor_context {
     acct_positions_monitor_context() = default;
 
     shm::ShmGenericReader reader{};
+    // 三者恰有一个非空：当前版本布局或 v7/v6 兼容布局
     const acct_service::positions_shm_layout* positions_shm = nullptr;
+    const acct_service::positions_shm_layout_v7* positions_shm_v7 = nullptr;
+    const acct_service::positions_shm_layout_v6* positions_shm_v6 = nullptr;
     std::string positions_shm_name;
     bool initialized = false;
 
+    // 按打开时识别的布局版本分派读取逻辑
+    template <typename Fn>
+    decltype(auto) visit(Fn&& fn) const {
+        if (positions_shm_v6 != nullptr) {
+            return fn(*positions_shm_v6);
+        }
+        if (positions_shm_v7 != nullptr) {
+            return fn(*positions_shm_v7);
+        }
+        return fn(*positions_shm);
+    }
+
     acct_positions_monitor_context(const acct_positions_monitor_context&) = delete;
     acct_positions_monitor_context& operator=(const acct_positions_monitor_context&) = delete;
 };
 
+namespace {
+
+// 映射并校验指定版本的布局，成功后挂到上下文。
+template <typename Layout>
+bool attach_layout(acct_positions_monitor_context& ctx, const std::string& positions_shm_name,
+                   uint32_t expected_version, const Layout*& out_layout) {
+    if (!acct_service::basecore_shm_bridge::open_reader(ctx.reader, positions_shm_name, sizeof(Layout))) {
+        return false;
+    }
+    const auto* layout = static_cast<const Layout*>(ctx.reader.data());
+    if (!validate_header(layout, expected_version)) {
+        return false;
+    }
+    out_layout = layout;
+    return true;
+}
+
+}  // namespace
+
 extern "C" {
 
 // 打开持仓监控上下文，并校验共享内存布局兼容性。
@@ -171,13 +261,23 @@ ACCT_POS_MON_API acct_pos_mon_error_t acct_positions_mon_open(
         return ACCT_POS_MON_ERR_SHM_FAILED;
     }
 
-    if (!acct_service::basecore_shm_bridge::open_reader(
-            ctx->reader, positions_shm_name, sizeof(acct_service::positions_shm_layout))) {
-        return ACCT_POS_MON_ERR_SHM_FAILED;
+    // 各版本段大小不同，先按大小选定布局，避免按错误尺寸映射
+    bool attached = false;
+    switch (probe_layout_version(positions_shm_name)) {
+        case acct_service::PositionsHeader::kVersionV6:
+            attached =
+                attach_layout(*ctx, positions_shm_name, acct_service::PositionsHeader::kVersionV6, ctx->positions_shm_v6);
+            break;
+        case acct_service::PositionsHeader::kVersionV7:
+            attached =
+                attach_layout(*ctx, positions_shm_name, acct_service::PositionsHeader::kVersionV7, ctx->positions_shm_v7);
+            break;
+        default:
+            attached =
+                attach_layout(*ctx, positions_shm_name, acct_service::PositionsHeader::kVersion, ctx->positions_shm);
+            break;
     }
-
-    ctx->positions_shm = static_cast<const acct_service::positions_shm_layout*>(ctx->reader.data());
-    if (!validate_header(ctx->positions_shm)) {
+    if (!attached) {
         return ACCT_POS_MON_ERR_SHM_FAILED;
     }
 
@@ -205,20 +305,22 @@ ACCT_POS_MON_API acct_pos_mon_error_t acct_positions_mon_info(
     }
 
     auto* context = ctx;
-    if (!context->initialized || context->positions_shm == nullptr) {
+    if (!context->initialized) {
         return ACCT_POS_MON_ERR_NOT_INITIALIZED;
     }
 
-    const acct_service::PositionsHeader& header = context->positions_shm->header;
-    out_info->magic = header.magic;
-    out_info->version = header.version;
-    out_info->capacity = header.capacity;
-    out_info->init_state = header.init_state;
-    out_info->position_count =
-        clamp_position_count(context->positions_shm->position_count.load(std::memory_order_acquire));
-    out_info->next_security_id = header.id.load(std::memory_order_acquire);
-    out_info->create_time_ns = header.create_time;
-    out_info->last_update_ns = header.last_update;
+    context->visit([out_info](const auto& shm) {
+        const acct_service::PositionsHeader& header = shm.header;
+        out_info->magic = header.magic;
+        out_info->version = header.version;
+        out_info->capacity = header.capacity;
+        out_info->init_state = header.init_state;
+        out_info->position_count = clamp_position_count(shm.position_count.load(std::memory_order_acquire));
+        out_info->next_security_id = header.id.load(std::memory_order_acquire);
+        out_info->create_time_ns = header.create_time;
+        out_info->last_update_ns = header.last_update;
+        out_info->change_version = shm.changes.version.load(std::memory_order_acquire);
+    });
     return ACCT_POS_MON_OK;
 }
 
@@ -230,11 +332,13 @@ ACCT_POS_MON_API acct_pos_mon_error_t acct_positions_mon_read_fund(
     }
 
     auto* context = ctx;
-    if (!context->initialized || context->positions_shm == nullptr) {
+    if (!context->initialized) {
         return ACCT_POS_MON_ERR_NOT_INITIALIZED;
     }
 
-    if (!try_read_stable_fund_snapshot(context->positions_shm, *out_snapshot)) {
+    const bool stable =
+        context->visit([out_snapshot](const auto& shm) { return try_read_stable_fund_snapshot(&shm, *out_snapshot); });
+    if (!stable) {
         return ACCT_POS_MON_ERR_RETRY;
     }
     return ACCT_POS_MON_OK;
@@ -248,18 +352,86 @@ ACCT_POS_MON_API acct_pos_mon_error_t acct_positions_mon_read_position(
     }
 
     auto* context = ctx;
-    if (!context->initialized || context->positions_shm == nullptr) {
+    if (!context->initialized) {
         return ACCT_POS_MON_ERR_NOT_INITIALIZED;
     }
 
-    const uint32_t count = clamp_position_count(context->positions_shm->position_count.load(std::memory_order_acquire));
-    if (index >= count) {
-        return ACCT_POS_MON_ERR_NOT_FOUND;
+    return context->visit([index, out_snapshot](const auto& shm) {
+        const uint32_t count = clamp_position_count(shm.position_count.load(std::memory_order_acquire));
+        if (index >= count) {
+            return ACCT_POS_MON_ERR_NOT_FOUND;
+        }
+        if (!try_read_stable_position_snapshot(&shm, index, *out_snapshot)) {
+            return ACCT_POS_MON_ERR_RETRY;
+        }
+        return ACCT_POS_MON_OK;
+    });
+}
+
+// 整表读取：前后各取一次全局变更版本，两者相等说明期间没有写区间开始，逐行稳定快照拼起来即一致视图。
+ACCT_POS_MON_API acct_pos_mon_error_t acct_positions_mon_read_all(
+    acct_positions_mon_ctx_t ctx, acct_positions_mon_fund_snapshot_t* out_fund,
+    acct_positions_mon_position_snapshot_t* out_rows, size_t max_rows, size_t* out_count, uint64_t* out_generation) {
+    if (ctx == nullptr || out_fund == nullptr || out_count == nullptr || out_generation == nullptr ||
+        (out_rows == nullptr && max_rows != 0)) {
+        return ACCT_POS_MON_ERR_INVALID_PARAM;
     }
+    *out_count = 0;
 
-    if (!try_read_stable_position_snapshot(context->positions_shm, index, *out_snapshot)) {
-        return ACCT_POS_MON_ERR_RETRY;
+    auto* context = ctx;
+    if (!context->initialized) {
+        return ACCT_POS_MON_ERR_NOT_INITIALIZED;
     }
+
+    return context->visit([&](const auto& shm) {
+        // 行写区间先推进版本再改行，acquire 读到的版本之后开始的写入都会让结束时的版本变化
+        const uint64_t generation = shm.changes.version.load(std::memory_order_acquire);
+        *out_generation = generation;
+
+        bool stable = try_read_stable_fund_snapshot(&shm, *out_fund);
+        const uint32_t count = clamp_position_count(shm.position_count.load(std::memory_order_acquire));
+        const std::size_t rows = count < max_rows ? count : max_rows;
+        for (std::size_t i = 0; i < rows; ++i) {
+            const uint32_t index = static_cast<uint32_t>(i);
+            if (!try_read_stable_position_snapshot(&shm, index, out_rows[i])) {
+                out_rows[i] = acct_positions_mon_position_snapshot_t{};
+                out_rows[i].index = index;
+                out_rows[i].row_index = index + static_cast<uint32_t>(kFirstSecurityPositionIndex);
+                stable = false;
+            }
+        }
+        *out_count = rows;
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (!stable || shm.changes.version.load(std::memory_order_relaxed) != generation) {
+            return ACCT_POS_MON_ERR_RETRY;
+        }
+        return ACCT_POS_MON_OK;
+    });
+}
+
+// 按变更戳增量拉取行号：整组跳过未变更的 64 行，不读取行数据本身。
+ACCT_POS_MON_API acct_pos_mon_error_t acct_positions_mon_poll_dirty(
+    acct_positions_mon_ctx_t ctx, uint64_t* cursor, uint32_t* out_rows, size_t max_rows, size_t* out_count) {
+    if (ctx == nullptr || cursor == nullptr || out_count == nullptr || (out_rows == nullptr && max_rows != 0)) {
+        return ACCT_POS_MON_ERR_INVALID_PARAM;
+    }
+    *out_count = 0;
+
+    auto* context = ctx;
+    if (!context->initialized) {
+        return ACCT_POS_MON_ERR_NOT_INITIALIZED;
+    }
+
+    context->visit([&](const auto& shm) {
+        uint64_t from = *cursor;
+        if (from > shm.changes.version.load(std::memory_order_acquire)) {
+            from = 0;  // 持仓池已重建
+        }
+        uint64_t next_cursor = from;
+        *out_count = acct_service::positions_shm_collect_changed(shm, from, out_rows, max_rows, next_cursor);
+        *cursor = next_cursor;
+    });
     return ACCT_POS_MON_OK;
 }
 
@@ -0,0 +1,68 @@
+#include "common/alloc_guard.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+// 常量初始化的线程局部计数，首次分配前无需动态初始化
+thread_local uint64_t t_allocations = 0;
+std::atomic<uint64_t> g_allocations{0};
+
+void count_allocation() noexcept {
+    ++t_allocations;
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+}
+
+}  // namespace
+
+namespace acct_service {
+
+uint64_t thread_allocation_count() noexcept { return t_allocations; }
+
+uint64_t process_allocation_count() noexcept { return g_allocations.load(std::memory_order_relaxed); }
+
+}  // namespace acct_service
+
+// 替换全局分配函数，只计次数；对齐版本同样计入
+void* operator new(std::size_t size) {
+    count_allocation();
+    if (void* ptr = std::malloc(size == 0 ? 1 : size)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) { return ::operator new(size); }
+
+void* operator new(std::size_t size, std::align_val_t align) {
+    count_allocation();
+    const std::size_t alignment = static_cast<std::size_t>(align);
+    const std::size_t rounded = (std::max<std::size_t>(size, 1) + alignment - 1) / alignment * alignment;
+    if (void* ptr = std::aligned_alloc(alignment, rounded)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size, std::align_val_t align) { return ::operator new(size, align); }
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    count_allocation();
+    return std::malloc(size == 0 ? 1 : size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t& tag) noexcept { return ::operator new(size, tag); }
+
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete[](void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, std::size_t) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::align_val_t) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, std::align_val_t) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::size_t, std::align_val_t) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, std::size_t, std::align_val_t) noexcept { std::free(ptr); }
+void operator delete(void* ptr, const std::nothrow_t&) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept { std::free(ptr); }
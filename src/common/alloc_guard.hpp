@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstdint>
+
+namespace acct_service {
+
+// 分配守卫：仅测试与基准链接 acct_alloc_guard（CMake 选项 ACCT_ENABLE_ALLOC_GUARD），
+// 它替换全局 operator new，按线程与进程累计调用次数；链接后目标带 ACCT_ALLOC_GUARD=1 定义。
+// 生产可执行文件不链接此库，分配函数保持标准库实现
+
+// 当前线程累计的 operator new 次数（含数组与对齐版本）
+uint64_t thread_allocation_count() noexcept;
+
+// 进程累计的 operator new 次数
+uint64_t process_allocation_count() noexcept;
+
+// 作用域计数：构造时记下当前线程的计数，allocations() 返回此后本线程新增的分配次数
+class allocation_scope {
+public:
+    allocation_scope() noexcept : start_(thread_allocation_count()) {}
+
+    uint64_t allocations() const noexcept { return thread_allocation_count() - start_; }
+
+private:
+    uint64_t start_ = 0;
+};
+
+}  // namespace acct_service
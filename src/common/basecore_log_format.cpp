@@ -3,6 +3,8 @@
 #include <cstdio>
 #include <cstring>
 
+#include "common/error.hpp"
+
 namespace acct_service::basecore_log_adapter {
 
 namespace {
@@ -55,10 +57,36 @@ void ProjectLogFormat::decode_record_log(const uint8_t* payload, uint16_t size,
     std::snprintf(buffer, buffer_size, "%s", rendered.c_str());
 }
 
+// Decodes a CompactRecordHead payload into the same line body as record_log().
+void ProjectLogFormat::decode_compact_record_log(const uint8_t* payload, uint16_t size, char* buffer,
+                                                 std::size_t buffer_size) {
+    if (!payload || !buffer || buffer_size == 0 || size < sizeof(CompactRecordHead)) {
+        return;
+    }
+
+    CompactRecordHead head{};
+    std::memcpy(&head, payload, sizeof(head));
+    const std::size_t text_size = size - sizeof(head);
+    if (head.file_size > text_size) {
+        return;
+    }
+
+    const char* file = reinterpret_cast<const char*>(payload + sizeof(head));
+    const char* message = file + head.file_size;
+    std::snprintf(buffer, buffer_size, "[%.*s:%u] severity=%s code=%s domain=%s errno=%d msg=%.*s",
+                  static_cast<int>(head.file_size), file, head.line,
+                  to_string(static_cast<ErrorSeverity>(head.severity)), to_string(static_cast<ErrorCode>(head.code)),
+                  to_string(static_cast<ErrorDomain>(head.domain)), head.sys_errno,
+                  static_cast<int>(text_size - head.file_size), message);
+}
+
 // Registers account_services-specific format decoders into BaseCore.
 bool ProjectLogFormat::register_formats() noexcept {
     return base_core_log::LogFormatRegistry::register_func(kRecordLogId, &ProjectLogFormat::decode_record_log,
-                                                           kRecordLogPayloadSize);
+                                                           kRecordLogPayloadSize) &&
+           base_core_log::LogFormatRegistry::register_func(
+               kCompactRecordLogId, &ProjectLogFormat::decode_compact_record_log,
+               base_core_log::LogFormatRegistry::kVariablePayloadSize);
 }
 
 }  // namespace acct_service::basecore_log_adapter
@@ -15,6 +15,20 @@ using CodeField = std::array<char, 32>;
 using DomainField = std::array<char, 16>;
 using MessageField = std::array<char, 256>;
 
+// Fixed head of a compact record; file and message bytes follow without terminators.
+// Error context stays numeric so the writer only stores integers and copies the actual text length.
+struct CompactRecordHead {
+    uint32_t line = 0;
+    int32_t sys_errno = 0;
+    uint16_t code = 0;
+    uint8_t domain = 0;
+    uint8_t severity = 0;
+    uint8_t file_size = 0;
+    uint8_t reserved[3]{};
+};
+
+static_assert(sizeof(CompactRecordHead) == 16, "CompactRecordHead must stay 16 bytes");
+
 // Formats account_services log records during LogReader decode.
 class ProjectLogFormat {
 public:
@@ -22,6 +36,7 @@ public:
     static constexpr uint16_t kRecordLogPayloadSize =
         static_cast<uint16_t>(sizeof(FileField) + sizeof(uint32_t) + sizeof(SeverityField) + sizeof(CodeField) +
                               sizeof(DomainField) + sizeof(int) + sizeof(MessageField));
+    static constexpr uint8_t kCompactRecordLogId = 65;
 
     // Renders the common account_services log payload into a readable line body.
     static std::string record_log(const FileField& file, uint32_t line, const SeverityField& severity,
@@ -31,6 +46,10 @@ public:
     // Decodes the fixed-size payload layout used by account_services log records.
     static void decode_record_log(const uint8_t* payload, uint16_t size, char* buffer, std::size_t buffer_size);
 
+    // Decodes a CompactRecordHead payload into the same line body as record_log().
+    static void decode_compact_record_log(const uint8_t* payload, uint16_t size, char* buffer,
+                                          std::size_t buffer_size);
+
     // Registers account_services-specific format decoders into BaseCore.
     static bool register_formats() noexcept;
 };
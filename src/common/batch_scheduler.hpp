@@ -0,0 +1,110 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+namespace acct_service {
+
+// 自适应批量参数：单轮时间预算、回报与撤单的保底份额、单类批量上下限
+struct batch_budget_policy {
+    uint64_t iteration_budget_ns = 50000;  // 单轮工作（出队 + tick + 归档）的目标耗时
+    uint32_t guaranteed_share_pct = 25;    // 回报与优先撤单合计的保底份额（百分比）
+    std::size_t min_batch = 8;             // 有积压时每类至少出队的笔数，保证预算估计偏大时仍有进展
+    std::size_t max_batch = 4096;          // 每类单轮出队上限
+};
+
+// 本轮各类出队额度
+struct batch_plan {
+    std::size_t orders = 0;     // 上游新单与普通撤单
+    std::size_t cancels = 0;    // 撤单优先队列
+    std::size_t responses = 0;  // 成交回报
+    std::size_t archives = 0;   // 到期归档
+};
+
+// 按队列深度与单轮时间预算为每类输入分配出队额度。单笔耗时与维护耗时（tick + 归档）按 EWMA 跟踪：
+// 维护耗时先从预算中扣除，但最多占去一半，维护膨胀时出队收窄而不会饿死；剩余预算先按保底份额分给回报与
+// 优先撤单，再按深度分给新单，新单用不完的部分回流给回报。单线程使用。
+class adaptive_batch_scheduler {
+public:
+    static constexpr uint64_t kInitialItemCostNs = 1000;  // 尚无样本时的单笔耗时估计（偏保守）
+
+    explicit adaptive_batch_scheduler(const batch_budget_policy& policy = {}) noexcept : policy_(policy) {
+        if (policy_.min_batch == 0) {
+            policy_.min_batch = 1;
+        }
+        policy_.max_batch = std::max(policy_.max_batch, policy_.min_batch);
+        policy_.guaranteed_share_pct = std::min<uint32_t>(policy_.guaranteed_share_pct, 100);
+    }
+
+    batch_plan plan(std::size_t order_depth, std::size_t cancel_depth, std::size_t response_depth) const noexcept {
+        const uint64_t budget = policy_.iteration_budget_ns;
+        const uint64_t available = budget - std::min(maintenance_ns_, budget / 2);
+        const uint64_t guaranteed = available * policy_.guaranteed_share_pct / 100;
+
+        batch_plan result;
+        // 保底份额：两类都有积压时平分，只有一类时全给它
+        const uint64_t cancel_share = response_depth == 0 ? guaranteed
+                                      : cancel_depth == 0 ? 0
+                                                          : guaranteed / 2;
+        result.cancels = fit(cancel_depth, cancel_share, order_cost_ns_);
+        result.responses = fit(response_depth, guaranteed - cancel_share, response_cost_ns_);
+
+        const uint64_t used = result.cancels * order_cost_ns_ + result.responses * response_cost_ns_;
+        const uint64_t remaining = available > used ? available - used : 0;
+        result.orders = fit(order_depth, remaining, order_cost_ns_);
+
+        const uint64_t leftover = remaining - std::min(remaining, result.orders * order_cost_ns_);
+        if (leftover > 0 && result.responses < response_depth) {
+            result.responses =
+                std::min(result.responses + fit(response_depth - result.responses, leftover, response_cost_ns_),
+                         policy_.max_batch);
+        }
+        // 归档只用维护份额之外的余量，至少推进 min_batch 笔，积压在后续轮次分摊
+        result.archives = std::max<std::size_t>(policy_.min_batch, leftover / response_cost_ns_);
+        return result;
+    }
+
+    void record_orders(std::size_t count, uint64_t elapsed_ns) noexcept { observe(order_cost_ns_, count, elapsed_ns); }
+    void record_responses(std::size_t count, uint64_t elapsed_ns) noexcept {
+        observe(response_cost_ns_, count, elapsed_ns);
+    }
+    void record_maintenance(uint64_t elapsed_ns) noexcept { smooth(maintenance_ns_, elapsed_ns); }
+
+    uint64_t order_cost_ns() const noexcept { return order_cost_ns_; }
+    uint64_t response_cost_ns() const noexcept { return response_cost_ns_; }
+    uint64_t maintenance_ns() const noexcept { return maintenance_ns_; }
+    const batch_budget_policy& policy() const noexcept { return policy_; }
+
+private:
+    // 预算内能容纳的笔数，夹在 [min_batch, max_batch] 且不超过积压
+    std::size_t fit(std::size_t depth, uint64_t budget_ns, uint64_t cost_ns) const noexcept {
+        if (depth == 0) {
+            return 0;
+        }
+        const std::size_t affordable = static_cast<std::size_t>(budget_ns / cost_ns);
+        return std::min(depth, std::clamp(affordable, policy_.min_batch, policy_.max_batch));
+    }
+
+    static void observe(uint64_t& cost_ns, std::size_t count, uint64_t elapsed_ns) noexcept {
+        if (count == 0) {
+            return;
+        }
+        smooth(cost_ns, elapsed_ns / count);
+        // 单笔耗时不低于 1ns，plan() 以它作除数
+        cost_ns = std::max<uint64_t>(cost_ns, 1);
+    }
+
+    // 权重 1/8 的 EWMA
+    static void smooth(uint64_t& average, uint64_t sample) noexcept {
+        const int64_t delta = static_cast<int64_t>(sample) - static_cast<int64_t>(average);
+        average = static_cast<uint64_t>(static_cast<int64_t>(average) + delta / 8);
+    }
+
+    batch_budget_policy policy_;
+    uint64_t order_cost_ns_ = kInitialItemCostNs;
+    uint64_t response_cost_ns_ = kInitialItemCostNs;
+    uint64_t maintenance_ns_ = 0;
+};
+
+}  // namespace acct_service
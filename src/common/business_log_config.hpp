@@ -12,6 +12,12 @@ struct BusinessLogConfig {
     std::string output_dir = "./logs";
     std::size_t queue_capacity = 65536;
     uint32_t flush_interval_ms = 100;
+    uint32_t sync_interval_ms = 1000;           // 文本日志 fdatasync 批量周期（由写出器异步提交），0 不主动同步
+    bool binary_journal = false;                // 订单簿事件改写二进制 mmap 日志（不再写文本业务日志）
+    uint32_t journal_segment_records = 262144;   // 单个日志段的记录容量，写满后滚动到下一段
+    bool delta_records = false;                 // 文本日志改写为同单增量编码的 .evd 文件，由 order_journal_dump 还原
+    int writer_cpu_core = -1;                   // 后台写线程绑核，-1 不绑
+    int writer_priority = 0;                    // 后台写线程 SCHED_FIFO 优先级 1-99，0 保持默认调度
 };
 
 }  // namespace acct_service
@@ -8,10 +8,23 @@ namespace acct_service {
 // 队列容量定义（必须是2的幂）
 inline constexpr std::size_t kUpstreamOrderQueueCapacity = 262144;
 inline constexpr std::size_t kDownstreamQueueCapacity = 262144;
+inline constexpr std::size_t kDownstreamPayloadQueueCapacity = 65536;  // 内联订单消息队列（64 字节/条）
+inline constexpr std::size_t kUpstreamCancelQueueCapacity = 16384;    // 每条上游 lane 的撤单优先队列
+inline constexpr std::size_t kUpstreamPayloadQueueCapacity = 16384;   // 每条上游 lane 的内联订单消息环（64 字节/条）
+inline constexpr std::size_t kOrderUpdateQueueCapacity = 4096;        // 每条上游 lane 的本方订单回报环（账户→策略）
+inline constexpr std::size_t kDownstreamCancelQueueCapacity = 16384;  // 下游撤单优先队列（内联消息）
 inline constexpr std::size_t kResponseQueueCapacity = 262144;
 inline constexpr std::size_t kMaxPositions = 8192;
 inline constexpr std::size_t kMaxActiveOrders = 1048576;  // 2^20
 inline constexpr std::size_t kDailyOrderPoolCapacity = kMaxActiveOrders;
+inline constexpr std::size_t kMaxOrdersOverflowSegments = 3;  // 订单池写满后可链上的溢出段数（段号占 OrderIndex 高位）
+// 订单簿容量上限：订单池连同全部溢出段的槽位数
+inline constexpr std::size_t kMaxOrderBookCapacity = kMaxActiveOrders * (1 + kMaxOrdersOverflowSegments);
+inline constexpr std::size_t kDailyTradeCapacity = 262144;  // 当日成交记录池容量（启动时一次性分配）
+inline constexpr std::size_t kDailyEntrustCapacity = 262144;  // 当日委托记录池容量（启动时一次性分配）
+inline constexpr std::size_t kMaxUpstreamLanes = 8;  // 上游多生产者 lane 上限（lane 0 为兼容队列）
+inline constexpr std::size_t kOrderJournalCapacity = 65536;  // 订单池变更日志环容量（2 的幂）
+inline constexpr std::size_t kMaxBasketLegs = 256;  // 单个篮子的最大条目数（账户服务整篮出队、合并预留资金）
 
 // 默认共享内存名称
 inline constexpr const char* kUpstreamOrderShmName = "/upstream_order_shm";
@@ -1,13 +1,24 @@
 #include "common/error.hpp"
 
+#include <algorithm>
+
+#include "common/time_utils.hpp"
+
 namespace acct_service {
 
 namespace {
 
 thread_local ErrorStatus g_thread_last_error{};
-ErrorStatus g_latest_error{};
+thread_local error_event g_thread_last_event{};
+thread_local bool g_thread_event_pending = false;  // g_thread_last_event 比 g_thread_last_error 新，读时再还原
+ErrorStatus g_latest_error{};  // 最近一次动态消息错误（静态站点错误从事件环还原）
 SpinLock g_latest_error_lock;
 
+// 站点表只追加：登记走锁（每个调用点一次），查询按已发布数量无锁读取
+std::array<error_site, kMaxErrorSites> g_error_sites{};
+std::atomic<uint32_t> g_error_site_count{0};
+SpinLock g_error_site_lock;
+
 std::atomic<int> g_shutdown_reason{-1};
 
 const ErrorPolicy kRecoverablePolicy{ErrorSeverity::Recoverable, false, false};
@@ -252,49 +263,173 @@ ErrorStatus make_error_status(ErrorDomain domain, ErrorCode code, std::string_vi
     return status;
 }
 
-void ErrorRegistry::record(const ErrorStatus& status) {
-    LockGuard<SpinLock> guard(lock_);
+uint32_t register_error_site(std::string_view module, std::string_view file, uint32_t line,
+                             std::string_view message) noexcept {
+    LockGuard<SpinLock> guard(g_error_site_lock);
+    const uint32_t count = g_error_site_count.load(std::memory_order_relaxed);
+    if (count >= kMaxErrorSites) {
+        return 0;
+    }
+    g_error_sites[count] = error_site{module, file, message, line};
+    g_error_site_count.store(count + 1, std::memory_order_release);
+    return count + 1;
+}
 
-    ++counters_[status.code];
-    history_[history_pos_] = status;
-    history_pos_ = (history_pos_ + 1) % kHistoryCapacity;
-    if (history_size_ < kHistoryCapacity) {
-        ++history_size_;
+const error_site* find_error_site(uint32_t site_id) noexcept {
+    if (site_id == 0 || site_id > g_error_site_count.load(std::memory_order_acquire)) {
+        return nullptr;
     }
+    return &g_error_sites[site_id - 1];
 }
 
-uint64_t ErrorRegistry::count(ErrorCode code) const {
-    LockGuard<SpinLock> guard(lock_);
-    const auto it = counters_.find(code);
-    if (it == counters_.end()) {
-        return 0;
+ErrorStatus to_error_status(const error_event& event) noexcept {
+    ErrorStatus status;
+    status.domain = event.domain;
+    status.code = event.code;
+    status.sys_errno = event.sys_errno;
+    status.ts_ns = event.ts_ns;
+    if (const error_site* site = find_error_site(event.site_id)) {
+        status.line = site->line;
+        status.module.assign(site->module);
+        status.file.assign(site->file);
+        status.message.assign(site->message);
     }
-    return it->second;
+    return status;
 }
 
-std::vector<ErrorStatus> ErrorRegistry::recent_errors() const {
-    LockGuard<SpinLock> guard(lock_);
+ErrorRegistry::~ErrorRegistry() {
+    counter_block* block = counter_blocks_.load(std::memory_order_acquire);
+    while (block != nullptr) {
+        counter_block* next = block->next;
+        delete block;
+        block = next;
+    }
+}
 
-    std::vector<ErrorStatus> errors;
-    errors.reserve(history_size_);
+std::size_t ErrorRegistry::counter_slot(ErrorCode code) noexcept {
+    const uint16_t value = static_cast<uint16_t>(code);
+    const std::size_t slot = static_cast<std::size_t>(value / 1000) * 100 + value % 1000;
+    return (value % 1000 < 100 && slot < kCounterSlots) ? slot : 0;
+}
 
-    std::size_t start = 0;
-    if (history_size_ == kHistoryCapacity) {
-        start = history_pos_;
+// 每线程首次上报时挂一组计数到链表头，之后只做本线程缓存命中判断
+ErrorRegistry::counter_block& ErrorRegistry::local_counters() noexcept {
+    thread_local char thread_tag = 0;
+    thread_local const ErrorRegistry* cached_registry = nullptr;
+    thread_local counter_block* cached_block = nullptr;
+    if (cached_registry == this) {
+        return *cached_block;
     }
 
-    for (std::size_t i = 0; i < history_size_; ++i) {
-        const std::size_t index = (start + i) % kHistoryCapacity;
-        errors.push_back(history_[index]);
+    counter_block* head = counter_blocks_.load(std::memory_order_acquire);
+    for (counter_block* block = head; block != nullptr; block = block->next) {
+        if (block->owner == &thread_tag) {
+            cached_registry = this;
+            cached_block = block;
+            return *block;
+        }
+    }
+
+    auto* block = new counter_block();
+    block->owner = &thread_tag;
+    block->next = head;
+    while (!counter_blocks_.compare_exchange_weak(block->next, block, std::memory_order_acq_rel,
+                                                  std::memory_order_acquire)) {
+    }
+    cached_registry = this;
+    cached_block = block;
+    return *block;
+}
+
+void ErrorRegistry::record(const ErrorStatus& status) noexcept {
+    error_event event;
+    event.ts_ns = status.ts_ns;
+    event.domain = status.domain;
+    event.code = status.code;
+    event.sys_errno = status.sys_errno;
+    record(event);
+}
+
+void ErrorRegistry::record(const error_event& event) noexcept {
+    std::atomic<uint64_t>& counter = local_counters().counts[counter_slot(event.code)];
+    counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+
+    const uint64_t pos = write_cursor_.fetch_add(1, std::memory_order_relaxed);
+    event_slot& slot = history_[pos & (kHistoryCapacity - 1)];
+    slot.seq.store(pos * 2 + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.event = event;
+    slot.seq.store(pos * 2 + 2, std::memory_order_release);
+}
+
+uint64_t ErrorRegistry::count(ErrorCode code) const noexcept {
+    const std::size_t slot = counter_slot(code);
+    uint64_t total = 0;
+    for (counter_block* block = counter_blocks_.load(std::memory_order_acquire); block != nullptr;
+         block = block->next) {
+        total += block->counts[slot].load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+bool ErrorRegistry::read_event(uint64_t pos, error_event& out_event) const noexcept {
+    const event_slot& slot = history_[pos & (kHistoryCapacity - 1)];
+    const uint64_t expected = pos * 2 + 2;
+    if (slot.seq.load(std::memory_order_acquire) != expected) {
+        return false;
+    }
+    out_event = slot.event;
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return slot.seq.load(std::memory_order_relaxed) == expected;
+}
+
+std::vector<error_event> ErrorRegistry::recent_events() const {
+    const uint64_t end = write_cursor_.load(std::memory_order_acquire);
+    const uint64_t floor = read_floor_.load(std::memory_order_acquire);
+    const uint64_t begin = std::max(floor, end > kHistoryCapacity ? end - kHistoryCapacity : 0);
+
+    std::vector<error_event> events;
+    events.reserve(static_cast<std::size_t>(end - std::min(begin, end)));
+    error_event event;
+    for (uint64_t pos = begin; pos < end; ++pos) {
+        if (read_event(pos, event)) {
+            events.push_back(event);
+        }
+    }
+    return events;
+}
+
+std::vector<ErrorStatus> ErrorRegistry::recent_errors() const {
+    const std::vector<error_event> events = recent_events();
+    std::vector<ErrorStatus> errors;
+    errors.reserve(events.size());
+    for (const error_event& event : events) {
+        errors.push_back(to_error_status(event));
     }
     return errors;
 }
 
-void ErrorRegistry::reset() {
-    LockGuard<SpinLock> guard(lock_);
-    counters_.clear();
-    history_pos_ = 0;
-    history_size_ = 0;
+bool ErrorRegistry::latest_event(error_event& out_event) const noexcept {
+    const uint64_t floor = read_floor_.load(std::memory_order_acquire);
+    // 最新槽位可能仍在写入，向前找最近一条已发布的事件
+    const uint64_t end = write_cursor_.load(std::memory_order_acquire);
+    for (uint64_t pos = end; pos > floor && end - pos < kHistoryCapacity; --pos) {
+        if (read_event(pos - 1, out_event)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// 计数清零与游标截断不与并发写者互斥，仅用于测试与运维重置
+void ErrorRegistry::reset() noexcept {
+    for (counter_block* block = counter_blocks_.load(std::memory_order_acquire); block != nullptr;
+         block = block->next) {
+        for (std::atomic<uint64_t>& counter : block->counts) {
+            counter.store(0, std::memory_order_relaxed);
+        }
+    }
+    read_floor_.store(write_cursor_.load(std::memory_order_acquire), std::memory_order_release);
 }
 
 ErrorRegistry& global_error_registry() {
@@ -302,8 +437,23 @@ ErrorRegistry& global_error_registry() {
     return registry;
 }
 
+namespace {
+
+void apply_error_policy(ErrorDomain domain, ErrorCode code) noexcept {
+    const ErrorPolicy& policy = classify(domain, code);
+    if (policy.stop_service || policy.exit_process) {
+        // 统一在这里触发 shutdown 闩锁：
+        // 仅当 policy.stop_service / policy.exit_process 为 true 时才停服退出。
+        // 例如 api 域即便是 Critical/Fatal，也不会替调用方进程做退出决策。
+        request_shutdown(policy.severity);
+    }
+}
+
+}  // namespace
+
 void record_error(const ErrorStatus& status) {
     g_thread_last_error = status;
+    g_thread_event_pending = false;
 
     {
         LockGuard<SpinLock> guard(g_latest_error_lock);
@@ -312,26 +462,52 @@ void record_error(const ErrorStatus& status) {
 
     if (!status.ok()) {
         global_error_registry().record(status);
-        const ErrorPolicy& policy = classify(status.domain, status.code);
-        if (policy.stop_service || policy.exit_process) {
-            // 统一在这里触发 shutdown 闩锁：
-            // 仅当 policy.stop_service / policy.exit_process 为 true 时才停服退出。
-            // 例如 api 域即便是 Critical/Fatal，也不会替调用方进程做退出决策。
-            request_shutdown(policy.severity);
-        }
+        apply_error_policy(status.domain, status.code);
     }
 }
 
-const ErrorStatus& last_error() noexcept { return g_thread_last_error; }
+error_event record_error_event(ErrorDomain domain, ErrorCode code, uint32_t site_id, int sys_errno) noexcept {
+    error_event event;
+    event.ts_ns = tsc_clock::now_realtime_ns();
+    event.domain = domain;
+    event.code = code;
+    event.site_id = site_id;
+    event.sys_errno = sys_errno;
+
+    g_thread_last_event = event;
+    g_thread_event_pending = true;
+    if (code != ErrorCode::Ok) {
+        global_error_registry().record(event);
+        apply_error_policy(domain, code);
+    }
+    return event;
+}
 
+const ErrorStatus& last_error() noexcept {
+    if (g_thread_event_pending) {
+        g_thread_last_error = to_error_status(g_thread_last_event);
+        g_thread_event_pending = false;
+    }
+    return g_thread_last_error;
+}
+
+// 事件环最新一条来自静态站点时按站点还原，否则取最近一次动态消息错误
 const ErrorStatus& latest_error() noexcept {
     static thread_local ErrorStatus snapshot{};
+    error_event event;
+    if (global_error_registry().latest_event(event) && event.site_id != 0) {
+        snapshot = to_error_status(event);
+        return snapshot;
+    }
     LockGuard<SpinLock> guard(g_latest_error_lock);
     snapshot = g_latest_error;
     return snapshot;
 }
 
-void clear_last_error() noexcept { g_thread_last_error = ErrorStatus{}; }
+void clear_last_error() noexcept {
+    g_thread_last_error = ErrorStatus{};
+    g_thread_event_pending = false;
+}
 
 void request_shutdown(ErrorSeverity severity) noexcept {
     int expected = g_shutdown_reason.load(std::memory_order_acquire);
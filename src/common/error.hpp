@@ -5,7 +5,6 @@
 #include <cstddef>
 #include <cstdint>
 #include <string_view>
-#include <unordered_map>
 #include <vector>
 
 #include "common/fixed_string.hpp"
@@ -103,29 +102,87 @@ const ErrorPolicy& classify(ErrorDomain domain, ErrorCode code) noexcept;
 ErrorStatus make_error_status(ErrorDomain domain, ErrorCode code, std::string_view module, std::string_view file,
     uint32_t line, std::string_view message, int sys_errno = 0);
 
+// 错误站点：调用点的静态信息，进程内每个调用点只登记一次，错误事件只携带其 id
+struct error_site {
+    std::string_view module{};
+    std::string_view file{};
+    std::string_view message{};
+    uint32_t line = 0;
+};
+
+// 紧凑错误事件：热路径只写这几个定长字段，不拷贝任何字符串
+struct error_event {
+    TimestampNs ts_ns = 0;
+    ErrorDomain domain = ErrorDomain::none;
+    ErrorCode code = ErrorCode::Ok;
+    uint32_t site_id = 0;  // 0 表示经 record_error(ErrorStatus) 上报的动态消息
+    int32_t sys_errno = 0;
+};
+
+static_assert(sizeof(error_event) == 24, "error_event must stay compact");
+
+inline constexpr uint32_t kMaxErrorSites = 4096;
+
+// 登记静态站点（字符串须为静态存储期），返回站点 id；站点表满时返回 0
+uint32_t register_error_site(std::string_view module, std::string_view file, uint32_t line,
+                             std::string_view message) noexcept;
+// 按 id 查站点，未登记返回 nullptr
+const error_site* find_error_site(uint32_t site_id) noexcept;
+// 事件还原为完整状态：静态站点补齐模块/文件/消息，动态消息事件只保留域、错误码与 errno
+ErrorStatus to_error_status(const error_event& event) noexcept;
+
+// 错误计数与最近错误环：计数为每线程一组 relaxed 原子，读时汇总；
+// 最近错误为无锁覆盖环，写者只竞争一次游标 fetch_add，读者按槽位序号校验丢弃被覆盖的槽位
 class ErrorRegistry {
 public:
     static constexpr std::size_t kHistoryCapacity = 4096;
 
-    void record(const ErrorStatus& status);
-    uint64_t count(ErrorCode code) const;
+    ErrorRegistry() = default;
+    ~ErrorRegistry();
+
+    ErrorRegistry(const ErrorRegistry&) = delete;
+    ErrorRegistry& operator=(const ErrorRegistry&) = delete;
+
+    void record(const ErrorStatus& status) noexcept;
+    void record(const error_event& event) noexcept;
+    uint64_t count(ErrorCode code) const noexcept;
     std::vector<ErrorStatus> recent_errors() const;
-    void reset();
+    std::vector<error_event> recent_events() const;
+    // 最近一条错误事件，环为空时返回 false
+    bool latest_event(error_event& out_event) const noexcept;
+    void reset() noexcept;
 
 private:
-    struct ErrorCodeHash {
-        std::size_t operator()(ErrorCode code) const noexcept { return static_cast<std::size_t>(code); }
+    // 错误码按 (千位, 低两位) 压成稠密下标：各号段均为 [x000, x099]
+    static constexpr std::size_t kCounterSlots = 10 * 100;
+    static_assert((kHistoryCapacity & (kHistoryCapacity - 1)) == 0, "history capacity must be a power of two");
+
+    struct counter_block {
+        std::array<std::atomic<uint64_t>, kCounterSlots> counts{};
+        const void* owner = nullptr;  // 所属线程的标识
+        counter_block* next = nullptr;
     };
 
-    mutable SpinLock lock_;
-    std::unordered_map<ErrorCode, uint64_t, ErrorCodeHash> counters_;
-    std::array<ErrorStatus, kHistoryCapacity> history_{};
-    std::size_t history_pos_ = 0;
-    std::size_t history_size_ = 0;
+    // 槽位 seq 为 2*pos+2 时内容对应第 pos 条事件，奇数表示写入中
+    struct event_slot {
+        std::atomic<uint64_t> seq{0};
+        error_event event{};
+    };
+
+    static std::size_t counter_slot(ErrorCode code) noexcept;
+    counter_block& local_counters() noexcept;
+    bool read_event(uint64_t pos, error_event& out_event) const noexcept;
+
+    std::atomic<counter_block*> counter_blocks_{nullptr};
+    alignas(64) std::atomic<uint64_t> write_cursor_{0};
+    std::atomic<uint64_t> read_floor_{0};  // reset 时的游标，之前的事件不再返回
+    std::array<event_slot, kHistoryCapacity> history_{};
 };
 
 ErrorRegistry& global_error_registry();
 void record_error(const ErrorStatus& status);
+// 热路径上报：只推送紧凑事件并累加计数，线程最近错误在读取时按站点还原
+error_event record_error_event(ErrorDomain domain, ErrorCode code, uint32_t site_id, int sys_errno = 0) noexcept;
 const ErrorStatus& last_error() noexcept;
 const ErrorStatus& latest_error() noexcept;
 void clear_last_error() noexcept;
@@ -141,3 +198,11 @@ bool should_exit_process() noexcept;
 #define ACCT_MAKE_ERROR(domain, code, module, message, sys_errno) \
     ::acct_service::make_error_status(                            \
         (domain), (code), (module), __FILE__, static_cast<uint32_t>(__LINE__), (message), (sys_errno))
+
+// 调用点静态登记一次站点后只上报紧凑事件；module/message 必须是字符串字面量
+#define ACCT_RECORD_ERROR_EVENT(domain, code, module, message, sys_errno)                                          \
+    [&]() noexcept {                                                                                               \
+        static const uint32_t acct_error_site_id = ::acct_service::register_error_site(                          \
+            "" module, __FILE__, static_cast<uint32_t>(__LINE__), "" message);                                   \
+        return ::acct_service::record_error_event((domain), (code), acct_error_site_id, (sys_errno));            \
+    }()
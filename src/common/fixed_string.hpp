@@ -1,11 +1,52 @@
 #pragma once
 
 #include <algorithm>
+#include <bit>
 #include <cstddef>
+#include <cstdint>
 #include <cstring>
 #include <functional>
 #include <string_view>
 
+#if defined(__SSE4_2__)
+#include <nmmintrin.h>
+#endif
+
+// 按 8 字节字比较与哈希定长字符串：终止符之后可能残留旧内容，读入后先清掉终止符及其后的字节。
+// CRC32C 仅在编译目标带 SSE4.2 时启用（ACCT_ENABLE_NATIVE_ARCH 打开 -march=native），否则用乘法混合；
+// 哈希只在进程内使用，两种实现不需要互相兼容。
+namespace fixed_string_detail {
+
+static_assert(std::endian::native == std::endian::little, "fixed_string word ops assume little-endian");
+
+inline constexpr uint64_t kLowBits = 0x0101010101010101ULL;
+inline constexpr uint64_t kHighBits = 0x8080808080808080ULL;
+
+// 读第 word 个字并清掉终止符及之后的字节；out_terminated 表示终止符落在该字内。
+// SWAR 零字节检测的借位误报只出现在真实零字节之后，最低置位恒准确
+inline uint64_t load_masked_word(const char* data, std::size_t word, bool& out_terminated) noexcept {
+    uint64_t value = 0;
+    std::memcpy(&value, data + word * 8, 8);
+    const uint64_t zero_bits = (value - kLowBits) & ~value & kHighBits;
+    out_terminated = zero_bits != 0;
+    if (zero_bits == 0) {
+        return value;
+    }
+    const unsigned kept_bits = static_cast<unsigned>(std::countr_zero(zero_bits)) & ~7U;
+    return kept_bits == 0 ? 0 : value & (~uint64_t{0} >> (64 - kept_bits));
+}
+
+inline uint64_t mix_word(uint64_t hash, uint64_t word) noexcept {
+#if defined(__SSE4_2__)
+    return _mm_crc32_u64(hash, word);
+#else
+    hash = (hash ^ word) * 0x9E3779B97F4A7C15ULL;
+    return hash ^ (hash >> 32);
+#endif
+}
+
+}  // namespace fixed_string_detail
+
 // 定长字符串模板类，用于共享内存结构
 // 不使用 std::string 以避免动态内存分配
 template <std::size_t N>
@@ -34,7 +75,45 @@ struct FixedString {
 
     bool empty() const { return data[0] == '\0'; }
 
-    bool operator==(const FixedString &other) const { return std::strcmp(data, other.data) == 0; }
+    // N 为 8 的倍数时逐字比较，首个含终止符的字比较完即结束
+    bool operator==(const FixedString &other) const {
+        if constexpr (N % 8 == 0) {
+            for (std::size_t word = 0; word < N / 8; ++word) {
+                bool terminated = false;
+                bool other_terminated = false;
+                if (fixed_string_detail::load_masked_word(data, word, terminated) !=
+                    fixed_string_detail::load_masked_word(other.data, word, other_terminated)) {
+                    return false;
+                }
+                if (terminated) {
+                    return true;
+                }
+            }
+            return true;
+        } else {
+            return std::strcmp(data, other.data) == 0;
+        }
+    }
+
+    // 与 operator== 一致：只覆盖终止符之前的内容
+    std::size_t hash() const noexcept {
+        if constexpr (N % 8 == 0) {
+            uint64_t value = N;
+            for (std::size_t word = 0; word < N / 8; ++word) {
+                bool terminated = false;
+                value = fixed_string_detail::mix_word(value, fixed_string_detail::load_masked_word(data, word, terminated));
+                if (terminated) {
+                    break;
+                }
+            }
+            value ^= value >> 33;
+            value *= 0xFF51AFD7ED558CCDULL;
+            value ^= value >> 33;
+            return static_cast<std::size_t>(value);
+        } else {
+            return std::hash<std::string_view>{}(view());
+        }
+    }
 
     bool operator==(std::string_view sv) const { return view() == sv; }
 
@@ -47,9 +126,7 @@ namespace std {
 
 template <std::size_t N>
 struct hash<FixedString<N>> {
-    std::size_t operator()(const FixedString<N>& value) const noexcept {
-        return std::hash<std::string_view>{}(value.view());
-    }
+    std::size_t operator()(const FixedString<N>& value) const noexcept { return value.hash(); }
 };
 
 }  // namespace std
@@ -0,0 +1,233 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#include "common/lazy_region.hpp"
+
+namespace acct_service {
+
+// 整数键使用 murmur3 finalizer 打散，避免递增 ID 在线性探测中聚簇；其余类型回落 std::hash
+template <typename Key, typename Enable = void>
+struct flat_hash {
+    std::size_t operator()(const Key& key) const noexcept { return std::hash<Key>{}(key); }
+};
+
+template <typename Key>
+struct flat_hash<Key, std::enable_if_t<std::is_integral_v<Key>>> {
+    std::size_t operator()(Key key) const noexcept {
+        uint64_t value = static_cast<uint64_t>(key);
+        value ^= value >> 33;
+        value *= 0xFF51AFD7ED558CCDULL;
+        value ^= value >> 33;
+        value *= 0xC4CEB9FE1A85EC53ULL;
+        value ^= value >> 33;
+        return static_cast<std::size_t>(value);
+    }
+};
+
+// 固定容量开放寻址哈希表：线性探测 + 回移删除（无墓碑），构造时一次性分配，运行期不再分配内存。
+// 容量向上取 2 的幂；表满时插入失败由调用方按容量错误处理。非线程安全。
+// 键值均为平凡类型且槽位数组不小于 kLazySlotBytes 时放在惰性落页映射中（全零即空槽），常驻内存随写入的槽位增长
+template <typename Key, typename Value, typename Hash = flat_hash<Key>>
+class flat_hash_map {
+public:
+    explicit flat_hash_map(std::size_t capacity) : capacity_(round_up_pow2(capacity)), mask_(capacity_ - 1) {
+        if constexpr (std::is_trivially_copyable_v<slot_entry>) {
+            if (capacity_ * sizeof(slot_entry) >= kLazySlotBytes) {
+                lazy_slots_ = lazy_region(capacity_ * sizeof(slot_entry), false);
+                slots_ = static_cast<slot_entry*>(lazy_slots_.data());
+                return;
+            }
+        }
+        owned_slots_ = std::make_unique<slot_entry[]>(capacity_);
+        slots_ = owned_slots_.get();
+    }
+
+    flat_hash_map(const flat_hash_map&) = delete;
+    flat_hash_map& operator=(const flat_hash_map&) = delete;
+
+    Value* find(const Key& key) noexcept {
+        const std::size_t index = locate(key);
+        return index == kNotFound ? nullptr : &slots_[index].value;
+    }
+
+    const Value* find(const Key& key) const noexcept {
+        const std::size_t index = locate(key);
+        return index == kNotFound ? nullptr : &slots_[index].value;
+    }
+
+    bool contains(const Key& key) const noexcept { return locate(key) != kNotFound; }
+
+    // 返回键对应的值，不存在时插入默认值；表满返回 nullptr
+    Value* try_emplace(const Key& key) {
+        std::size_t slot = hash_(key) & mask_;
+        for (std::size_t probe = 0; probe < capacity_; ++probe) {
+            if (!slots_[slot].used) {
+                slots_[slot].used = 1;
+                slots_[slot].key = key;
+                slots_[slot].value = Value{};
+                ++size_;
+                return &slots_[slot].value;
+            }
+            if (slots_[slot].key == key) {
+                return &slots_[slot].value;
+            }
+            slot = (slot + 1) & mask_;
+        }
+        return nullptr;
+    }
+
+    // 插入或覆盖；表满返回 false
+    bool insert_or_assign(const Key& key, Value value) {
+        Value* slot = try_emplace(key);
+        if (!slot) {
+            return false;
+        }
+        *slot = std::move(value);
+        return true;
+    }
+
+    // 删除键并把后续探测链回移，保持查找无需墓碑
+    bool erase(const Key& key) {
+        std::size_t hole = locate(key);
+        if (hole == kNotFound) {
+            return false;
+        }
+
+        std::size_t next = hole;
+        while (true) {
+            next = (next + 1) & mask_;
+            if (!slots_[next].used) {
+                break;
+            }
+            const std::size_t home = hash_(slots_[next].key) & mask_;
+            // home 不在 (hole, next] 循环区间内时，next 处元素可以回移到 hole
+            const bool movable = (hole <= next) ? (home <= hole || home > next) : (home <= hole && home > next);
+            if (movable) {
+                slots_[hole].key = std::move(slots_[next].key);
+                slots_[hole].value = std::move(slots_[next].value);
+                hole = next;
+            }
+        }
+        slots_[hole].used = 0;
+        slots_[hole].key = Key{};
+        slots_[hole].value = Value{};
+        --size_;
+        return true;
+    }
+
+    void clear() {
+        if (size_ == 0) {
+            return;
+        }
+        for (std::size_t slot = 0; slot < capacity_; ++slot) {
+            if (slots_[slot].used) {
+                slots_[slot].used = 0;
+                slots_[slot].key = Key{};
+                slots_[slot].value = Value{};
+            }
+        }
+        size_ = 0;
+    }
+
+    // 遍历全部键值对：fn(const Key&, Value&)
+    template <typename Fn>
+    void for_each(Fn&& fn) {
+        for (std::size_t slot = 0; slot < capacity_ && size_ != 0; ++slot) {
+            if (slots_[slot].used) {
+                fn(static_cast<const Key&>(slots_[slot].key), slots_[slot].value);
+            }
+        }
+    }
+
+    // 只读遍历：fn(const Key&, const Value&)
+    template <typename Fn>
+    void for_each(Fn&& fn) const {
+        for (std::size_t slot = 0; slot < capacity_ && size_ != 0; ++slot) {
+            if (slots_[slot].used) {
+                fn(static_cast<const Key&>(slots_[slot].key), static_cast<const Value&>(slots_[slot].value));
+            }
+        }
+    }
+
+    std::size_t size() const noexcept { return size_; }
+    std::size_t capacity() const noexcept { return capacity_; }
+    bool empty() const noexcept { return size_ == 0; }
+    // 槽位数组按容量预留、按已用槽位计在用
+    memory_usage memory() const noexcept { return element_memory(capacity_, size_, sizeof(slot_entry)); }
+
+private:
+    static constexpr std::size_t kNotFound = static_cast<std::size_t>(-1);
+    static constexpr std::size_t kLazySlotBytes = std::size_t{1} << 20;
+
+    // 键、占用标记与值同槽存放，一次探测只触达一条缓存行
+    struct slot_entry {
+        Key key{};
+        uint8_t used = 0;
+        Value value{};
+    };
+
+    static std::size_t round_up_pow2(std::size_t value) noexcept {
+        std::size_t result = 1;
+        while (result < value) {
+            result <<= 1;
+        }
+        return result;
+    }
+
+    std::size_t locate(const Key& key) const noexcept {
+        if (size_ == 0) {
+            return kNotFound;
+        }
+        std::size_t slot = hash_(key) & mask_;
+        for (std::size_t probe = 0; probe < capacity_; ++probe) {
+            if (!slots_[slot].used) {
+                return kNotFound;
+            }
+            if (slots_[slot].key == key) {
+                return slot;
+            }
+            slot = (slot + 1) & mask_;
+        }
+        return kNotFound;
+    }
+
+    std::size_t capacity_;
+    std::size_t mask_;
+    std::size_t size_ = 0;
+    Hash hash_{};
+    lazy_region lazy_slots_;
+    std::unique_ptr<slot_entry[]> owned_slots_;
+    slot_entry* slots_ = nullptr;
+};
+
+// 固定容量开放寻址集合
+template <typename Key, typename Hash = flat_hash<Key>>
+class flat_hash_set {
+public:
+    explicit flat_hash_set(std::size_t capacity) : map_(capacity) {}
+
+    bool contains(const Key& key) const noexcept { return map_.contains(key); }
+
+    // 插入键；表满返回 false，已存在视为成功
+    bool insert(const Key& key) { return map_.try_emplace(key) != nullptr; }
+
+    bool erase(const Key& key) { return map_.erase(key); }
+
+    void clear() { map_.clear(); }
+
+    std::size_t size() const noexcept { return map_.size(); }
+    bool empty() const noexcept { return map_.empty(); }
+    memory_usage memory() const noexcept { return map_.memory(); }
+
+private:
+    struct unit {};
+    flat_hash_map<Key, unit, Hash> map_;
+};
+
+}  // namespace acct_service
@@ -0,0 +1,213 @@
+#include "common/huge_page_arena.hpp"
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+namespace acct_service {
+
+namespace {
+
+std::size_t round_up(std::size_t bytes, std::size_t unit) noexcept { return (bytes + unit - 1) / unit * unit; }
+
+std::size_t system_page_size() noexcept {
+    const long page = ::sysconf(_SC_PAGESIZE);
+    return page > 0 ? static_cast<std::size_t>(page) : 4096;
+}
+
+// 多映射一个大页长度再裁掉首尾，使起始地址按大页对齐，透明大页从首字节起即可合并
+void* map_aligned(std::size_t length, std::size_t alignment) noexcept {
+    void* raw = ::mmap(nullptr, length + alignment, PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (raw == MAP_FAILED) {
+        return nullptr;
+    }
+    const auto base = reinterpret_cast<std::uintptr_t>(raw);
+    const std::uintptr_t aligned = (base + alignment - 1) & ~(static_cast<std::uintptr_t>(alignment) - 1);
+    if (aligned > base) {
+        (void)::munmap(raw, aligned - base);
+    }
+    const std::uintptr_t tail = aligned + length;
+    const std::uintptr_t end = base + length + alignment;
+    if (end > tail) {
+        (void)::munmap(reinterpret_cast<void*>(tail), end - tail);
+    }
+    return reinterpret_cast<void*>(aligned);
+}
+
+}  // namespace
+
+const char* arena_backing_name(arena_backing backing) noexcept {
+    switch (backing) {
+        case arena_backing::SmallPages:
+            return "small_pages";
+        case arena_backing::Transparent:
+            return "transparent";
+        case arena_backing::Explicit:
+            return "hugetlb";
+        case arena_backing::Heap:
+            return "heap";
+    }
+    return "unknown";
+}
+
+huge_page_arena& huge_page_arena::instance() noexcept {
+    static huge_page_arena arena;
+    return arena;
+}
+
+void huge_page_arena::set_explicit_huge_pages(bool enabled) noexcept {
+    std::lock_guard<std::mutex> guard(mutex_);
+    explicit_huge_pages_ = enabled;
+}
+
+bool huge_page_arena::explicit_huge_pages() const noexcept {
+    std::lock_guard<std::mutex> guard(mutex_);
+    return explicit_huge_pages_;
+}
+
+arena_block huge_page_arena::allocate(std::size_t bytes, bool huge_pages, const char* tag) noexcept {
+    arena_block block;
+    if (bytes == 0) {
+        return block;
+    }
+    block.bytes = bytes;
+
+    // hugetlb 不带 MAP_NORESERVE：预留池不足时在映射时失败并回落，而不是在首次写入时 SIGBUS
+    if (huge_pages && explicit_huge_pages()) {
+#if defined(MAP_HUGETLB)
+        const std::size_t length = round_up(bytes, kHugePageSize);
+        void* mapped = ::mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB,
+                              -1, 0);
+        if (mapped != MAP_FAILED) {
+            block.data = mapped;
+            block.mapped_bytes = length;
+            block.backing = arena_backing::Explicit;
+            account(block, tag, true);
+            return block;
+        }
+#endif
+        std::lock_guard<std::mutex> guard(mutex_);
+        ++explicit_fallbacks_;
+    }
+
+    if (huge_pages && bytes >= kHugePageSize) {
+        const std::size_t length = round_up(bytes, kHugePageSize);
+        if (void* mapped = map_aligned(length, kHugePageSize)) {
+#if defined(MADV_HUGEPAGE)
+            (void)::madvise(mapped, length, MADV_HUGEPAGE);
+#endif
+            block.data = mapped;
+            block.mapped_bytes = length;
+            block.backing = arena_backing::Transparent;
+            account(block, tag, true);
+            return block;
+        }
+    } else {
+        const std::size_t length = round_up(bytes, system_page_size());
+        void* mapped = ::mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE,
+                              -1, 0);
+        if (mapped != MAP_FAILED) {
+            block.data = mapped;
+            block.mapped_bytes = length;
+            block.backing = arena_backing::SmallPages;
+            account(block, tag, true);
+            return block;
+        }
+    }
+
+    constexpr std::size_t kFallbackAlign = 64;
+    const std::size_t length = round_up(bytes, kFallbackAlign);
+    block.data = std::aligned_alloc(kFallbackAlign, length);
+    if (!block.data) {
+        block.bytes = 0;
+        return block;
+    }
+    std::memset(block.data, 0, length);
+    block.mapped_bytes = length;
+    block.backing = arena_backing::Heap;
+    account(block, tag, true);
+    return block;
+}
+
+void huge_page_arena::release(arena_block& block) noexcept {
+    if (!block.data) {
+        return;
+    }
+    account(block, nullptr, false);
+    if (block.backing == arena_backing::Heap) {
+        std::free(block.data);
+    } else {
+        (void)::munmap(block.data, block.mapped_bytes);
+    }
+    block = arena_block{};
+}
+
+void huge_page_arena::account(const arena_block& block, const char* tag, bool add) noexcept {
+    std::lock_guard<std::mutex> guard(mutex_);
+    std::size_t& total = backing_bytes_[static_cast<std::size_t>(block.backing)];
+    if (add) {
+        total += block.mapped_bytes;
+        ++region_count_;
+    } else {
+        total -= block.mapped_bytes;
+        --region_count_;
+    }
+
+    if (add) {
+        if (!tag) {
+            return;
+        }
+        for (tagged_region& region : regions_) {
+            if (!region.data) {
+                region = tagged_region{block.data, block.bytes, block.mapped_bytes, tag, block.backing};
+                return;
+            }
+        }
+        return;
+    }
+    for (tagged_region& region : regions_) {
+        if (region.data == block.data) {
+            region = tagged_region{};
+            return;
+        }
+    }
+}
+
+std::size_t huge_page_arena::resident_bytes(const tagged_region& region) noexcept {
+    if (region.backing == arena_backing::Heap) {
+        return region.mapped_bytes;
+    }
+    const std::size_t page = system_page_size();
+    std::vector<unsigned char> pages(region.mapped_bytes / page);
+    if (pages.empty() || ::mincore(const_cast<void*>(region.data), region.mapped_bytes, pages.data()) != 0) {
+        return 0;
+    }
+    std::size_t resident = 0;
+    for (unsigned char bit : pages) {
+        resident += (bit & 1U) != 0 ? page : 0;
+    }
+    return resident;
+}
+
+arena_footprint huge_page_arena::footprint() const {
+    arena_footprint out;
+    std::size_t resident = 0;
+    for_each_region([&resident](const arena_region_info& region) { resident += region.resident_bytes; });
+
+    std::lock_guard<std::mutex> guard(mutex_);
+    out.regions = region_count_;
+    out.small_page_bytes = backing_bytes_[static_cast<std::size_t>(arena_backing::SmallPages)];
+    out.transparent_bytes = backing_bytes_[static_cast<std::size_t>(arena_backing::Transparent)];
+    out.explicit_bytes = backing_bytes_[static_cast<std::size_t>(arena_backing::Explicit)];
+    out.heap_bytes = backing_bytes_[static_cast<std::size_t>(arena_backing::Heap)];
+    out.reserved_bytes = out.small_page_bytes + out.transparent_bytes + out.explicit_bytes + out.heap_bytes;
+    out.resident_bytes = resident;
+    out.explicit_fallbacks = explicit_fallbacks_;
+    return out;
+}
+
+}  // namespace acct_service
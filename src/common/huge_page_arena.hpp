@@ -0,0 +1,104 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+
+namespace acct_service {
+
+// 单个区块实际落到的页类型
+enum class arena_backing : uint8_t {
+    SmallPages = 0,   // 普通匿名映射
+    Transparent = 1,  // 已建议透明大页（是否真正合并由内核决定）
+    Explicit = 2,     // hugetlb 映射
+    Heap = 3,         // 映射失败后退回的堆内存
+};
+
+const char* arena_backing_name(arena_backing backing) noexcept;
+
+// 一次分配得到的区块；bytes 为调用方请求的字节数，映射长度按页类型向上取整后由 arena 记录
+struct arena_block {
+    void* data = nullptr;
+    std::size_t bytes = 0;
+    std::size_t mapped_bytes = 0;
+    arena_backing backing = arena_backing::SmallPages;
+};
+
+// 带名字的区块快照，供启动日志与诊断按组件列出占用
+struct arena_region_info {
+    const char* tag = nullptr;
+    std::size_t bytes = 0;
+    std::size_t resident_bytes = 0;  // mincore 统计的已落页字节数（hugetlb 区块按整页计）
+    arena_backing backing = arena_backing::SmallPages;
+};
+
+// 全部区块合计：带名与匿名区块都计入，resident_bytes 只统计带名区块
+struct arena_footprint {
+    std::size_t regions = 0;
+    std::size_t reserved_bytes = 0;
+    std::size_t explicit_bytes = 0;
+    std::size_t transparent_bytes = 0;
+    std::size_t small_page_bytes = 0;
+    std::size_t heap_bytes = 0;
+    std::size_t resident_bytes = 0;
+    std::size_t explicit_fallbacks = 0;  // 开启 explicit 时 MAP_HUGETLB 失败、回落透明大页的次数
+};
+
+// 进程级大数组分配器：订单簿、成交/委托记录池、执行会话池等按容量一次性预留的数组都经此映射。
+// 组件按自身的大页开关申请；开关打开的区块默认建议透明大页，启动时开启 explicit 后先从 hugetlb 预留池映射，
+// 池不足时回落透明大页。各组件仍各自持有区块、析构时归还。
+// 分配与释放只在组件构造/析构的冷路径发生，内部以互斥锁保护登记表
+class huge_page_arena {
+public:
+    static constexpr std::size_t kHugePageSize = std::size_t{2} << 20;
+    static constexpr std::size_t kMaxTaggedRegions = 64;
+
+    static huge_page_arena& instance() noexcept;
+
+    // 应在各组件构造前调用；之后的分配按新设置进行，已有区块不受影响
+    void set_explicit_huge_pages(bool enabled) noexcept;
+    bool explicit_huge_pages() const noexcept;
+
+    // 映射 bytes 字节全零内存：huge_pages 为 false 时只用普通页；为 true 时按 hugetlb -> 透明大页依次尝试，
+    // 透明大页只用于不小于 kHugePageSize 的区块并按大页对齐。tag 为静态字符串时登记到区块表（登记表满时只计入合计）
+    arena_block allocate(std::size_t bytes, bool huge_pages, const char* tag = nullptr) noexcept;
+    void release(arena_block& block) noexcept;
+
+    arena_footprint footprint() const;
+
+    // 逐个带名区块回调 fn(const arena_region_info&)，按登记顺序；resident_bytes 现场以 mincore 统计
+    template <typename Fn>
+    void for_each_region(Fn&& fn) const {
+        std::lock_guard<std::mutex> guard(mutex_);
+        for (std::size_t i = 0; i < kMaxTaggedRegions; ++i) {
+            const tagged_region& region = regions_[i];
+            if (!region.data) {
+                continue;
+            }
+            fn(arena_region_info{region.tag, region.bytes, resident_bytes(region), region.backing});
+        }
+    }
+
+private:
+    struct tagged_region {
+        const void* data = nullptr;
+        std::size_t bytes = 0;
+        std::size_t mapped_bytes = 0;
+        const char* tag = nullptr;
+        arena_backing backing = arena_backing::SmallPages;
+    };
+
+    huge_page_arena() = default;
+
+    static std::size_t resident_bytes(const tagged_region& region) noexcept;
+    void account(const arena_block& block, const char* tag, bool add) noexcept;
+
+    mutable std::mutex mutex_;
+    bool explicit_huge_pages_ = false;
+    tagged_region regions_[kMaxTaggedRegions];
+    std::size_t region_count_ = 0;
+    std::size_t backing_bytes_[4] = {};
+    std::size_t explicit_fallbacks_ = 0;
+};
+
+}  // namespace acct_service
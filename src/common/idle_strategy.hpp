@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstdint>
+
+#include <sched.h>
+
+namespace acct_service {
+
+// 自旋等待提示，降低超线程争用与功耗
+inline void cpu_relax() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield" ::: "memory");
+#endif
+}
+
+// 分级退避参数：先自旋，再让出 CPU，最后挂起等待（门铃或超时）
+struct idle_policy {
+    uint32_t spin_iterations = 2000;  // pause 自旋轮数
+    uint32_t yield_iterations = 200;  // sched_yield 轮数
+    uint32_t park_timeout_us = 1000;  // 单次挂起上限（微秒），同时约束定时任务的最大延迟
+};
+
+// 分级退避状态机：有活时 reset()，空闲时 idle() 逐级升级
+class idle_backoff {
+public:
+    explicit idle_backoff(const idle_policy& policy) noexcept : policy_(policy) {}
+
+    // 有活可做时调用，回到自旋级
+    void reset() noexcept { idle_rounds_ = 0; }
+
+    // 空闲一轮；进入挂起级后调用 park(timeout_us)
+    template <typename Park>
+    void idle(Park&& park) {
+        if (idle_rounds_ < policy_.spin_iterations) {
+            ++idle_rounds_;
+            cpu_relax();
+            return;
+        }
+        if (idle_rounds_ - policy_.spin_iterations < policy_.yield_iterations) {
+            ++idle_rounds_;
+            (void)::sched_yield();
+            return;
+        }
+        park(policy_.park_timeout_us);
+    }
+
+    // 是否已进入挂起级
+    bool parked() const noexcept {
+        return idle_rounds_ >= policy_.spin_iterations &&
+               idle_rounds_ - policy_.spin_iterations >= policy_.yield_iterations;
+    }
+
+private:
+    idle_policy policy_;
+    uint32_t idle_rounds_ = 0;
+};
+
+}  // namespace acct_service
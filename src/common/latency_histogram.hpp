@@ -0,0 +1,149 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace acct_service {
+
+// 对数分桶延迟直方图（HDR 风格）：每个 2 的幂区间再线性切 8 个子桶，相对误差 <= 12.5%。
+// 单写者记录、跨进程只读：写侧使用 relaxed load/store 避免原子 RMW，可直接放入共享内存。
+struct alignas(64) latency_histogram {
+    static constexpr uint32_t kSubBucketBits = 3;
+    static constexpr std::size_t kSubBucketCount = std::size_t{1} << kSubBucketBits;
+    static constexpr std::size_t kBucketCount = (64 - kSubBucketBits + 1) * kSubBucketCount;
+
+    std::atomic<uint64_t> count{0};     // 样本数
+    std::atomic<uint64_t> total_ns{0};  // 样本累计值（纳秒）
+    std::atomic<uint64_t> max_ns{0};    // 最大样本（纳秒）
+    uint64_t reserved[5]{};             // 预留字段
+    std::atomic<uint64_t> buckets[kBucketCount]{};
+
+    // 计算样本所在桶：小于子桶数的值精确落桶，其余按最高位分段
+    static constexpr std::size_t bucket_index(uint64_t value) noexcept {
+        if (value < kSubBucketCount) {
+            return static_cast<std::size_t>(value);
+        }
+        const uint32_t msb = 63U - static_cast<uint32_t>(__builtin_clzll(value));
+        const uint32_t shift = msb - kSubBucketBits;
+        const std::size_t sub = static_cast<std::size_t>((value >> shift) & (kSubBucketCount - 1));
+        return (static_cast<std::size_t>(shift) + 1) * kSubBucketCount + sub;
+    }
+
+    // 桶上界（包含），用于保守地估计分位数
+    static constexpr uint64_t bucket_upper_bound(std::size_t index) noexcept {
+        if (index < kSubBucketCount) {
+            return static_cast<uint64_t>(index);
+        }
+        const uint32_t shift = static_cast<uint32_t>(index / kSubBucketCount) - 1U;
+        const uint64_t sub = static_cast<uint64_t>(index % kSubBucketCount);
+        const uint64_t lower = (kSubBucketCount + sub) << shift;
+        return lower + ((uint64_t{1} << shift) - 1);
+    }
+
+    // 记录一个样本（仅允许单写者调用）
+    void record(uint64_t value_ns) noexcept {
+        std::atomic<uint64_t>& bucket = buckets[bucket_index(value_ns)];
+        bucket.store(bucket.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        total_ns.store(total_ns.load(std::memory_order_relaxed) + value_ns, std::memory_order_relaxed);
+        if (value_ns > max_ns.load(std::memory_order_relaxed)) {
+            max_ns.store(value_ns, std::memory_order_relaxed);
+        }
+        count.store(count.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    // 估算分位数（quantile 取值 [0, 1]），结果不超过最大样本；无样本返回 0
+    uint64_t percentile(double quantile) const noexcept {
+        const uint64_t samples = count.load(std::memory_order_acquire);
+        if (samples == 0) {
+            return 0;
+        }
+        if (quantile < 0.0) {
+            quantile = 0.0;
+        }
+        if (quantile > 1.0) {
+            quantile = 1.0;
+        }
+
+        uint64_t target = static_cast<uint64_t>(quantile * static_cast<double>(samples) + 0.5);
+        if (target == 0) {
+            target = 1;
+        }
+
+        const uint64_t max_value = max_ns.load(std::memory_order_relaxed);
+        uint64_t seen = 0;
+        for (std::size_t i = 0; i < kBucketCount; ++i) {
+            seen += buckets[i].load(std::memory_order_relaxed);
+            if (seen >= target) {
+                const uint64_t upper = bucket_upper_bound(i);
+                return upper < max_value ? upper : max_value;
+            }
+        }
+        return max_value;
+    }
+
+    // 平均样本值（纳秒）
+    double mean_ns() const noexcept {
+        const uint64_t samples = count.load(std::memory_order_acquire);
+        if (samples == 0) {
+            return 0.0;
+        }
+        return static_cast<double>(total_ns.load(std::memory_order_relaxed)) / static_cast<double>(samples);
+    }
+
+    // 清空统计（仅允许写者调用）
+    void reset() noexcept {
+        count.store(0, std::memory_order_relaxed);
+        total_ns.store(0, std::memory_order_relaxed);
+        max_ns.store(0, std::memory_order_relaxed);
+        for (std::atomic<uint64_t>& bucket : buckets) {
+            bucket.store(0, std::memory_order_relaxed);
+        }
+    }
+};
+
+static_assert(latency_histogram::bucket_index(UINT64_MAX) == latency_histogram::kBucketCount - 1,
+              "latency_histogram bucket range must cover uint64_t");
+
+// 事件循环分阶段延迟直方图
+struct stage_latency_stats {
+    latency_histogram upstream_to_risk;    // 上游出队 -> 风控完成
+    latency_histogram risk_to_downstream;  // 风控完成 -> 下游入队
+    latency_histogram response_to_settle;  // 成交回报出队 -> 持仓/资金结算完成
+    latency_histogram execution_tick;      // ExecutionEngine::tick 单次耗时
+
+    void reset() noexcept {
+        upstream_to_risk.reset();
+        risk_to_downstream.reset();
+        response_to_settle.reset();
+        execution_tick.reset();
+    }
+};
+
+// 单个柜台会话的往返延迟直方图（网关单写）
+struct broker_session_latency {
+    latency_histogram submit_call;            // 一次 submit_batch 调用耗时（按批记录）
+    latency_histogram submit_to_accept;       // 新单提交返回 -> 看到 BrokerAccepted
+    latency_histogram accept_to_first_trade;  // BrokerAccepted -> 看到首笔成交
+
+    void reset() noexcept {
+        submit_call.reset();
+        submit_to_accept.reset();
+        accept_to_first_trade.reset();
+    }
+};
+
+// 网关各柜台会话的往返延迟，下标为适配器分片序号
+inline constexpr std::size_t kMaxBrokerSessions = 16;
+
+struct broker_latency_stats {
+    broker_session_latency sessions[kMaxBrokerSessions];
+
+    void reset() noexcept {
+        for (broker_session_latency& session : sessions) {
+            session.reset();
+        }
+    }
+};
+
+}  // namespace acct_service
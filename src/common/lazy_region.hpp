@@ -0,0 +1,87 @@
+#pragma once
+
+#include <sys/mman.h>
+
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+
+#include "common/huge_page_arena.hpp"
+#include "common/memory_accounting.hpp"
+
+namespace acct_service {
+
+// 惰性落页的大块存储：经进程级 huge_page_arena 匿名私有映射，页在首次写入时才由内核分配并清零，
+// 未触达部分不计入常驻内存。huge_pages 为 true 时按 arena 设置选 hugetlb 或透明大页，尽力而为；
+// tag 非空时区块按名登记，供启动日志列出占用。映射失败时退回按缓存行对齐的堆内存并清零（失去惰性）；
+// 开启 lock_memory（mlockall MCL_FUTURE）时映射即全部落页
+class lazy_region {
+public:
+    lazy_region() = default;
+
+    lazy_region(std::size_t bytes, bool huge_pages, const char* tag = nullptr) noexcept
+        : block_(huge_page_arena::instance().allocate(bytes, huge_pages, tag)) {}
+
+    ~lazy_region() { huge_page_arena::instance().release(block_); }
+
+    lazy_region(const lazy_region&) = delete;
+    lazy_region& operator=(const lazy_region&) = delete;
+
+    lazy_region(lazy_region&& other) noexcept : block_(std::exchange(other.block_, arena_block{})) {}
+
+    lazy_region& operator=(lazy_region&& other) noexcept {
+        if (this != &other) {
+            huge_page_arena::instance().release(block_);
+            block_ = std::exchange(other.block_, arena_block{});
+        }
+        return *this;
+    }
+
+    void* data() const noexcept { return block_.data; }
+    std::size_t size() const noexcept { return block_.bytes; }
+    arena_backing backing() const noexcept { return block_.backing; }
+    explicit operator bool() const noexcept { return block_.data != nullptr; }
+
+    // 整段恢复为全零：映射时 MADV_DONTNEED 归还已落页，再次访问按需清零落页；堆内存回退时逐字节清零
+    void reset() noexcept {
+        if (!block_.data) {
+            return;
+        }
+        if (block_.backing != arena_backing::Heap && ::madvise(block_.data, block_.mapped_bytes, MADV_DONTNEED) == 0) {
+            return;
+        }
+        std::memset(block_.data, 0, block_.bytes);
+    }
+
+private:
+    arena_block block_;
+};
+
+// 定长平凡类型数组，初值为全零字节；只适用于全零即合法初值、或元素总在读取前写入的类型
+template <typename T>
+class lazy_array {
+    static_assert(std::is_trivially_copyable_v<T> && std::is_trivially_destructible_v<T>,
+                  "lazy_array requires trivially copyable elements");
+
+public:
+    lazy_array() = default;
+    lazy_array(std::size_t count, bool huge_pages, const char* tag = nullptr) noexcept
+        : region_(count * sizeof(T), huge_pages, tag) {}
+
+    T* data() const noexcept { return static_cast<T*>(region_.data()); }
+    std::size_t size() const noexcept { return region_.size() / sizeof(T); }
+    explicit operator bool() const noexcept { return static_cast<bool>(region_); }
+    // 按映射长度预留，在用量由调用方给出已写入的元素数
+    memory_usage memory(std::size_t used_count) const noexcept { return element_memory(size(), used_count, sizeof(T)); }
+
+    T& operator[](std::size_t index) noexcept { return data()[index]; }
+    const T& operator[](std::size_t index) const noexcept { return data()[index]; }
+
+    void reset() noexcept { region_.reset(); }
+
+private:
+    lazy_region region_;
+};
+
+}  // namespace acct_service
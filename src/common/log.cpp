@@ -2,9 +2,11 @@
 
 #include <unistd.h>
 
+#include <algorithm>
 #include <array>
 #include <cerrno>
 #include <cstdio>
+#include <cstring>
 #include <filesystem>
 #include <memory>
 #include <string>
@@ -21,8 +23,6 @@ namespace acct_service {
 namespace {
 
 constexpr std::string_view kDefaultLoggerInstanceName = "account_service";
-constexpr std::size_t kFixedBufferCapacity = base_core_log::ShmLogger::kBufferCapacity;
-constexpr std::size_t kVariableBufferCapacity = base_core_log::ShmLogger::kBufferVarSize;
 
 // Parses the configured minimum log level into the internal enum.
 LogLevel parse_level(const std::string& level) {
@@ -65,11 +65,18 @@ base_core_log::LogLevel to_basecore_level(LogLevel level) noexcept {
 bool should_sync_fallback(LogLevel level) { return level == LogLevel::error || level == LogLevel::fatal; }
 
 // Emits a best-effort stderr line when the structured logger is unavailable.
-void write_fallback_stderr(const LogRecord& record) {
-    std::fprintf(stderr, "[%llu][%s][%s][%s:%u] severity=%s code=%s domain=%s errno=%d msg=%s\n",
-                 static_cast<unsigned long long>(record.ts_ns), to_string(record.level), record.module.c_str(),
-                 record.file.c_str(), record.line, to_string(record.severity), to_string(record.code),
-                 to_string(record.domain), record.sys_errno, record.message.c_str());
+void write_fallback_stderr(const LogView& view) {
+    std::fprintf(stderr, "[%llu][%s][%.*s][%.*s:%u] severity=%s code=%s domain=%s errno=%d msg=%.*s\n",
+                 static_cast<unsigned long long>(now_ns()), to_string(view.level), static_cast<int>(view.module.size()),
+                 view.module.data(), static_cast<int>(view.file.size()), view.file.data(), view.line,
+                 to_string(view.severity), to_string(view.code), to_string(view.domain), view.sys_errno,
+                 static_cast<int>(view.message.size()), view.message.data());
+}
+
+// Keeps only the file name so the compact payload does not carry the build directory.
+std::string_view file_basename(std::string_view file) noexcept {
+    const std::size_t slash = file.rfind('/');
+    return slash == std::string_view::npos ? file : file.substr(slash + 1);
 }
 
 // Normalizes the logical logger name so shm names and filenames remain predictable.
@@ -112,33 +119,32 @@ std::string build_output_path(const LogConfig& config, AccountId account_id, std
     return config.log_dir + "/" + std::string(instance_name) + "_" + std::to_string(account_id) + ".log";
 }
 
-// Copies text into a fixed-size payload field used by BaseCore format decoding.
-template <typename Field>
-Field make_field(std::string_view text) {
-    Field field{};
-    const std::size_t copy_size = (text.size() < (field.size() - 1)) ? text.size() : (field.size() - 1);
-    if (copy_size > 0) {
-        text.copy(field.data(), copy_size);
+// Compact payload limits: message keeps the historical 255-byte cap, which LogReader's line body buffer also bounds.
+constexpr std::size_t kCompactMaxFileSize = 64;
+constexpr std::size_t kCompactMaxMessageSize = 255;
+static_assert(sizeof(basecore_log_adapter::CompactRecordHead) + kCompactMaxFileSize + kCompactMaxMessageSize <=
+                  base_core_log::kLogMaxVarPayload,
+              "compact log payload must fit one BaseCore variable entry");
+
+// Lays out head, file bytes and message bytes back to back as decode_compact_record_log() expects.
+void pack_compact_payload(uint8_t* dst, const basecore_log_adapter::CompactRecordHead& head, const char* file,
+                          std::size_t file_size, const char* message, std::size_t message_size) noexcept {
+    std::memcpy(dst, &head, sizeof(head));
+    if (file_size > 0) {
+        std::memcpy(dst + sizeof(head), file, file_size);
     }
-    field[copy_size] = '\0';
-    return field;
-}
-
-// Tracks unread payload volume so overwrite-driven loss remains visible via dropped_count().
-void account_pending_payload(std::size_t payload_size, std::size_t& pending_fixed_entries,
-                             std::size_t& pending_variable_bytes, std::atomic<uint64_t>& dropped) {
-    if (payload_size <= base_core_log::kLogMaxPayload) {
-        ++pending_fixed_entries;
-        if (pending_fixed_entries > kFixedBufferCapacity) {
-            dropped.fetch_add(1, std::memory_order_relaxed);
-        }
-        return;
+    if (message_size > 0) {
+        std::memcpy(dst + sizeof(head) + file_size, message, message_size);
     }
+}
 
-    pending_variable_bytes += sizeof(base_core_log::LogVarEntryHeader) + payload_size;
-    if (pending_variable_bytes > kVariableBufferCapacity) {
-        dropped.fetch_add(1, std::memory_order_relaxed);
+// Sums entries the current ring lost to overwrite or drop policy, as counted by BaseCore.
+uint64_t ring_lost_entries(const base_core_log::ShmLogger& logger) noexcept {
+    const base_core_log::LogShmStats* stats = logger.stats();
+    if (!stats) {
+        return 0;
     }
+    return stats->overwritten.load(std::memory_order_relaxed) + stats->total_dropped.load(std::memory_order_relaxed);
 }
 
 }  // namespace
@@ -150,10 +156,9 @@ struct AsyncLogger::Impl {
     LogLevel min_level = LogLevel::info;
     bool async_enabled = true;
     std::atomic<bool> healthy{false};
-    std::atomic<uint64_t> dropped{0};
-    std::size_t pending_fixed_entries_ = 0;
-    std::size_t pending_variable_bytes_ = 0;
+    std::atomic<uint64_t> dropped{0};  // 写入失败 + 已关闭环形区的丢失数；当前环形区的丢失数在 BaseCore 统计区
     SpinLock io_lock;
+    base_core::AsyncFileWriter output{};  // Kept open across drains so each LogReader pass only copies and submits.
 
     // Opens a fresh shared-memory ring for subsequent writes after init or drain.
     bool reopen_locked() {
@@ -163,8 +168,6 @@ struct AsyncLogger::Impl {
             return false;
         }
 
-        pending_fixed_entries_ = 0;
-        pending_variable_bytes_ = 0;
         healthy.store(true, std::memory_order_release);
         return true;
     }
@@ -177,17 +180,15 @@ struct AsyncLogger::Impl {
         }
 
         // Read and append the current ring before tearing it down to avoid duplicate drains.
-        base_core_log::LogReader reader(shm_config.shm_name, shm_config.output_path,
-                                        &basecore_log_adapter::project_log_module_mapper);
+        base_core_log::LogReader reader(shm_config.shm_name, output, &basecore_log_adapter::project_log_module_mapper);
         if (reader.run() != 0) {
             healthy.store(false, std::memory_order_release);
             return false;
         }
 
+        dropped.fetch_add(ring_lost_entries(logger), std::memory_order_relaxed);
         logger.close();
         (void)shm::ShmGenericWriter::unlink(shm_config.shm_name);
-        pending_fixed_entries_ = 0;
-        pending_variable_bytes_ = 0;
 
         if (!reopen_after_drain) {
             healthy.store(false, std::memory_order_release);
@@ -196,40 +197,62 @@ struct AsyncLogger::Impl {
         return reopen_locked();
     }
 
-    // Writes one fully structured record into BaseCore shared memory.
-    bool write_record_locked(const LogRecord& record) {
+    // Writes one compact record into BaseCore shared memory; text rendering is left to LogReader.
+    bool write_view_locked(const LogView& view) {
         auto* writer = logger.writer();
         if (!writer || !writer->is_attached()) {
             healthy.store(false, std::memory_order_release);
             return false;
         }
 
-        const std::string_view file = record.file.empty() ? std::string_view("<unknown>") : record.file.view();
-        const auto file_field = make_field<basecore_log_adapter::FileField>(file);
-        const auto severity_field = make_field<basecore_log_adapter::SeverityField>(to_string(record.severity));
-        const auto code_field = make_field<basecore_log_adapter::CodeField>(to_string(record.code));
-        const auto domain_field = make_field<basecore_log_adapter::DomainField>(to_string(record.domain));
-        const auto message_field = make_field<basecore_log_adapter::MessageField>(
-            record.message.empty() ? std::string_view("") : record.message.view());
-        const auto module = basecore_log_adapter::project_log_module_from_name(record.module.view());
-
-        // Always use the structured format entry so reader output remains stable across all call sites.
-        const bool ok = base_core_log::log_write_fmt(
-            *writer, to_basecore_level(record.level), base_core_log::rdtsc(), static_cast<uint8_t>(module),
-            basecore_log_adapter::ProjectLogFormat::kRecordLogId,
-            basecore_log_adapter::ProjectLogFormat::kRecordLogPayloadSize, file_field, record.line, severity_field,
-            code_field, domain_field, record.sys_errno, message_field);
+        basecore_log_adapter::CompactRecordHead head{};
+        head.line = view.line;
+        head.sys_errno = view.sys_errno;
+        head.code = static_cast<uint16_t>(view.code);
+        head.domain = static_cast<uint8_t>(view.domain);
+        head.severity = static_cast<uint8_t>(view.severity);
+
+        const std::string_view file = view.file.empty() ? std::string_view("<unknown>") : file_basename(view.file);
+        const std::size_t file_size = file.size() < kCompactMaxFileSize ? file.size() : kCompactMaxFileSize;
+        const std::size_t message_size =
+            view.message.size() < kCompactMaxMessageSize ? view.message.size() : kCompactMaxMessageSize;
+        head.file_size = static_cast<uint8_t>(file_size);
+        const std::size_t payload_size = sizeof(head) + file_size + message_size;
+        const auto module = basecore_log_adapter::project_log_module_from_name(view.module);
+        const uint64_t ts = base_core_log::rdtsc();
+
+        // 短消息整条落进 64 字节固定槽，其余按实际长度进变长区
+        bool ok = false;
+        if (payload_size <= base_core_log::kLogMaxPayload) {
+            base_core_log::LogEntry entry{};
+            entry.ts_tsc = ts;
+            entry.type_id = static_cast<uint8_t>(base_core_log::LogTypeId::MsgFormat);
+            entry.level = static_cast<uint8_t>(to_basecore_level(view.level));
+            entry.msg_id = basecore_log_adapter::ProjectLogFormat::kCompactRecordLogId;
+            entry.module_id = static_cast<uint8_t>(module);
+            entry.payload_size = static_cast<uint16_t>(payload_size);
+            pack_compact_payload(entry.payload, head, file.data(), file_size, view.message.data(), message_size);
+            ok = writer->try_push(entry);
+        } else {
+            alignas(64) uint8_t payload[base_core_log::kLogMaxVarPayload];
+            pack_compact_payload(payload, head, file.data(), file_size, view.message.data(), message_size);
+            ok = writer->try_push_variable(ts, static_cast<uint8_t>(base_core_log::LogTypeId::MsgFormat),
+                                           static_cast<uint8_t>(to_basecore_level(view.level)),
+                                           basecore_log_adapter::ProjectLogFormat::kCompactRecordLogId,
+                                           static_cast<uint8_t>(module), payload,
+                                           static_cast<uint16_t>(payload_size));
+        }
         if (!ok) {
             healthy.store(false, std::memory_order_release);
             return false;
         }
 
-        account_pending_payload(basecore_log_adapter::ProjectLogFormat::kRecordLogPayloadSize, pending_fixed_entries_,
-                                pending_variable_bytes_, dropped);
         return true;
     }
 };
 
+AsyncLogger::AsyncLogger() = default;
+
 AsyncLogger::~AsyncLogger() noexcept { shutdown(); }
 
 // Preserves the historical service logger entrypoint with the default instance name.
@@ -268,6 +291,12 @@ bool AsyncLogger::init(const LogConfig& config, AccountId account_id, std::strin
             return false;
         }
 
+        base_core::AsyncFileWriterConfig output_config;
+        output_config.buffer_bytes = base_core_log::LogReader::kOutputBufferSize;
+        if (!state->output.open(state->shm_config.output_path, false, output_config)) {
+            return false;
+        }
+
         // Remove any leftover object from an unclean previous exit before creating a new ring.
         (void)shm::ShmGenericWriter::unlink(state->shm_config.shm_name);
         if (!state->reopen_locked()) {
@@ -288,6 +317,7 @@ void AsyncLogger::shutdown() noexcept {
     {
         LockGuard<SpinLock> guard(state->io_lock);
         (void)state->drain_locked(false);
+        state->output.close();
         state->logger.close();
         if (!state->shm_config.shm_name.empty()) {
             (void)shm::ShmGenericWriter::unlink(state->shm_config.shm_name);
@@ -304,35 +334,52 @@ bool AsyncLogger::flush(uint32_t timeout_ms) {
     }
 
     LockGuard<SpinLock> guard(impl_->io_lock);
-    return impl_->drain_locked(true);
+    const bool drained = impl_->drain_locked(true);
+    // Callers read the file right after flush, so wait until the submitted writes have landed.
+    return impl_->output.drain() && drained;
 }
 
-// Converts one LogRecord into the shared-memory format used by BaseCore.
+// Keeps the LogRecord entrypoint for existing callers; the record is written through its view.
 bool AsyncLogger::log(const LogRecord& record) {
+    LogView view;
+    view.level = record.level;
+    view.severity = record.severity;
+    view.sys_errno = record.sys_errno;
+    view.line = record.line;
+    view.module = record.module.view();
+    view.file = record.file.view();
+    view.message = record.message.view();
+    view.domain = record.domain;
+    view.code = record.code;
+    return log(view);
+}
+
+// Writes one log call into the shared-memory format used by BaseCore.
+bool AsyncLogger::log(const LogView& view) {
     if (!impl_) {
-        if (should_sync_fallback(record.level)) {
-            write_fallback_stderr(record);
+        if (should_sync_fallback(view.level)) {
+            write_fallback_stderr(view);
         }
         return false;
     }
 
-    if (static_cast<uint8_t>(record.level) < static_cast<uint8_t>(impl_->min_level)) {
+    if (!enabled(view.level)) {
         return true;
     }
 
     LockGuard<SpinLock> guard(impl_->io_lock);
-    if (!impl_->write_record_locked(record)) {
+    if (!impl_->write_view_locked(view)) {
         impl_->dropped.fetch_add(1, std::memory_order_relaxed);
-        if (should_sync_fallback(record.level)) {
-            write_fallback_stderr(record);
+        if (should_sync_fallback(view.level)) {
+            write_fallback_stderr(view);
         }
         return false;
     }
 
     if (!impl_->async_enabled && !impl_->drain_locked(true)) {
         impl_->dropped.fetch_add(1, std::memory_order_relaxed);
-        if (should_sync_fallback(record.level)) {
-            write_fallback_stderr(record);
+        if (should_sync_fallback(view.level)) {
+            write_fallback_stderr(view);
         }
         return false;
     }
@@ -340,11 +387,43 @@ bool AsyncLogger::log(const LogRecord& record) {
     return true;
 }
 
+// Uninitialized loggers report enabled so error/fatal calls still reach the stderr fallback.
+bool AsyncLogger::enabled(LogLevel level) const noexcept {
+    if (!impl_) {
+        return true;
+    }
+    return static_cast<uint8_t>(level) >= static_cast<uint8_t>(impl_->min_level);
+}
+
 uint64_t AsyncLogger::dropped_count() const noexcept {
     if (!impl_) {
         return 0;
     }
-    return impl_->dropped.load(std::memory_order_relaxed);
+    LockGuard<SpinLock> guard(impl_->io_lock);
+    return impl_->dropped.load(std::memory_order_relaxed) + ring_lost_entries(impl_->logger);
+}
+
+// Reserves the whole shm ring; counts fixed entries and variable bytes the drain has not consumed yet as used.
+memory_usage AsyncLogger::memory() const noexcept {
+    if (!impl_) {
+        return {};
+    }
+    LockGuard<SpinLock> guard(impl_->io_lock);
+    if (!impl_->logger.is_open()) {
+        return {};
+    }
+    memory_usage usage{base_core_log::ShmLogger::kLayoutSize, sizeof(base_core_log::LogShmHeader)};
+    if (const base_core_log::LogShmStats* stats = impl_->logger.stats()) {
+        const uint64_t fixed = stats->fixed_written.load(std::memory_order_relaxed) -
+                               stats->fixed_read.load(std::memory_order_relaxed);
+        const uint64_t var = stats->var_written.load(std::memory_order_relaxed) -
+                             stats->var_read.load(std::memory_order_relaxed);
+        usage.used_bytes += element_memory(base_core_log::ShmLogger::kBufferCapacity, fixed,
+                                           sizeof(base_core_log::LogEntry))
+                                .used_bytes;
+        usage.used_bytes += std::min<uint64_t>(var, base_core_log::ShmLogger::kBufferVarSize);
+    }
+    return usage;
 }
 
 bool AsyncLogger::healthy() const noexcept {
@@ -378,37 +457,63 @@ bool logger_healthy() noexcept { return global_logger().healthy(); }
 
 uint64_t logger_dropped_count() noexcept { return global_logger().dropped_count(); }
 
+memory_usage logger_memory_usage() noexcept { return global_logger().memory(); }
+
+bool logger_enabled(LogLevel level) noexcept { return global_logger().enabled(level); }
+
+// Filters by level first, then forwards caller strings by view; no intermediate LogRecord copy.
 void log_message(LogLevel level, std::string_view module, std::string_view file, uint32_t line,
                  std::string_view message, const ErrorStatus* status, int sys_errno) {
-    LogRecord record;
-    record.ts_ns = now_ns();
-    record.level = level;
-    record.sys_errno = sys_errno;
-    record.line = line;
-    record.module.assign(module);
-    record.file.assign(file);
-    record.message.assign(message);
-
-    if (status) {
-        record.domain = status->domain;
-        record.code = status->code;
-        record.severity = classify(status->domain, status->code).severity;
-        if (record.sys_errno == 0) {
-            record.sys_errno = status->sys_errno;
-        }
-    } else {
+    AsyncLogger& logger = global_logger();
+    if (!logger.enabled(level)) {
+        return;
+    }
+
+    LogView view;
+    view.level = level;
+    view.sys_errno = sys_errno;
+    view.line = line;
+    view.module = module;
+    view.file = file;
+    view.message = message;
+
+    const ErrorStatus* context = status;
+    if (!context) {
         const ErrorStatus& last = last_error();
-        if (!last.ok()) {
-            record.domain = last.domain;
-            record.code = last.code;
-            record.severity = classify(last.domain, last.code).severity;
-            if (record.sys_errno == 0) {
-                record.sys_errno = last.sys_errno;
-            }
+        context = last.ok() ? nullptr : &last;
+    }
+    if (context) {
+        view.domain = context->domain;
+        view.code = context->code;
+        view.severity = classify(context->domain, context->code).severity;
+        if (view.sys_errno == 0) {
+            view.sys_errno = context->sys_errno;
         }
     }
 
-    (void)global_logger().log(record);
+    (void)logger.log(view);
+}
+
+void log_error_event(LogLevel level, const error_event& event) {
+    AsyncLogger& logger = global_logger();
+    if (!logger.enabled(level)) {
+        return;
+    }
+
+    LogView view;
+    view.level = level;
+    view.sys_errno = event.sys_errno;
+    view.domain = event.domain;
+    view.code = event.code;
+    view.severity = classify(event.domain, event.code).severity;
+    if (const error_site* site = find_error_site(event.site_id)) {
+        view.line = site->line;
+        view.module = site->module;
+        view.file = site->file;
+        view.message = site->message;
+    }
+
+    (void)logger.log(view);
 }
 
 const char* to_string(LogLevel level) noexcept {
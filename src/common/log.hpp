@@ -6,6 +6,7 @@
 
 #include "common/error.hpp"
 #include "common/fixed_string.hpp"
+#include "common/memory_accounting.hpp"
 #include "common/spinlock.hpp"
 #include "common/types.hpp"
 
@@ -34,9 +35,22 @@ struct LogRecord {
     ErrorCode code = ErrorCode::Ok;
 };
 
+// 日志调用的零拷贝视图：字段引用调用方的字符串，写入共享内存时才按实际长度拷贝一次
+struct LogView {
+    LogLevel level = LogLevel::info;
+    ErrorSeverity severity = ErrorSeverity::Recoverable;
+    int sys_errno = 0;
+    uint32_t line = 0;
+    std::string_view module{};
+    std::string_view file{};
+    std::string_view message{};
+    ErrorDomain domain = ErrorDomain::none;
+    ErrorCode code = ErrorCode::Ok;
+};
+
 class AsyncLogger {
 public:
-    AsyncLogger() = default;
+    AsyncLogger();
     ~AsyncLogger() noexcept;
 
     bool init(const LogConfig& config, AccountId account_id);
@@ -44,8 +58,13 @@ public:
     void shutdown() noexcept;
     bool flush(uint32_t timeout_ms);
     bool log(const LogRecord& record);
+    bool log(const LogView& view);
+    // 低于配置级别的日志在调用方直接返回，不做任何拷贝
+    bool enabled(LogLevel level) const noexcept;
 
     uint64_t dropped_count() const noexcept;
+    // 共享内存日志环的占用：整环计预留，写端已写入、读端尚未排空的条目与变长字节计在用
+    memory_usage memory() const noexcept;
     bool healthy() const noexcept;
 
 private:
@@ -62,9 +81,14 @@ void shutdown_logger();
 bool flush_logger(uint32_t timeout_ms);
 bool logger_healthy() noexcept;
 uint64_t logger_dropped_count() noexcept;
+memory_usage logger_memory_usage() noexcept;
+// 全局 logger 是否输出该级别；调用方拼装明细日志前先判断，关闭时不付出格式化开销
+bool logger_enabled(LogLevel level) noexcept;
 
 void log_message(LogLevel level, std::string_view module, std::string_view file, uint32_t line,
                  std::string_view message, const ErrorStatus* status = nullptr, int sys_errno = 0);
+// 按错误事件的静态站点写日志，不经 ErrorStatus
+void log_error_event(LogLevel level, const error_event& event);
 
 const char* to_string(LogLevel level) noexcept;
 
@@ -90,6 +114,11 @@ const char* to_string(LogLevel level) noexcept;
     ::acct_service::log_message(::acct_service::LogLevel::fatal, (module), __FILE__, static_cast<uint32_t>(__LINE__), \
                                 (message))
 
+// 热路径错误上报：登记站点、推送紧凑错误事件并写错误日志，module/message 必须是字符串字面量
+#define ACCT_REPORT_ERROR(domain, code, module, message, sys_errno) \
+    ::acct_service::log_error_event(                                \
+        ::acct_service::LogLevel::error, ACCT_RECORD_ERROR_EVENT((domain), (code), module, message, (sys_errno)))
+
 #define ACCT_LOG_ERROR_STATUS(status)                                                                \
     ::acct_service::log_message(::acct_service::LogLevel::error, (status).module.view(), __FILE__,   \
                                 static_cast<uint32_t>(__LINE__), (status).message.view(), &(status), \
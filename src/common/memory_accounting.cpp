@@ -0,0 +1,56 @@
+#include "common/memory_accounting.hpp"
+
+#include <string>
+
+#include "common/log.hpp"
+
+namespace acct_service {
+
+void memory_accounting::add(const char* name, source_fn fn, const void* context) noexcept {
+    if (!name || !fn || count_ == kMaxComponents) {
+        return;
+    }
+    component& entry = components_[count_++];
+    entry.name = name;
+    entry.fn = fn;
+    entry.context = context;
+}
+
+void memory_accounting::bind_metrics(metrics_registry& registry) noexcept {
+    for (std::size_t i = 0; i < count_; ++i) {
+        component& entry = components_[i];
+        const std::string prefix = std::string("mem.") + entry.name;
+        entry.reserved = registry.add(prefix + ".reserved", metric_kind::Gauge);
+        entry.used = registry.add(prefix + ".used", metric_kind::Gauge);
+    }
+}
+
+void memory_accounting::publish() noexcept {
+    for (std::size_t i = 0; i < count_; ++i) {
+        component& entry = components_[i];
+        const memory_usage usage = entry.fn(entry.context);
+        entry.reserved.set(usage.reserved_bytes);
+        entry.used.set(usage.used_bytes);
+    }
+}
+
+memory_usage memory_accounting::total() const noexcept {
+    memory_usage sum;
+    for (std::size_t i = 0; i < count_; ++i) {
+        sum += components_[i].fn(components_[i].context);
+    }
+    return sum;
+}
+
+void memory_accounting::log(std::string_view module) const {
+    memory_usage sum;
+    for_each([&sum, module](const char* name, const memory_usage& usage) {
+        sum += usage;
+        ACCT_LOG_INFO(module, std::string("memory component ") + name + " reserved=" +
+                                  std::to_string(usage.reserved_bytes) + " used=" + std::to_string(usage.used_bytes));
+    });
+    ACCT_LOG_INFO(module, "memory total components=" + std::to_string(count_) + " reserved=" +
+                              std::to_string(sum.reserved_bytes) + " used=" + std::to_string(sum.used_bytes));
+}
+
+}  // namespace acct_service
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstddef>
+#include <string_view>
+
+#include "common/metrics_registry.hpp"
+
+namespace acct_service {
+
+// 组件内存占用：reserved_bytes 为按容量一次性预留的字节数（映射长度、容器容量），
+// used_bytes 为按当前条目数折算的在用字节数。两者都是逻辑口径，不经 mincore，统计节拍上可廉价取得
+struct memory_usage {
+    std::size_t reserved_bytes = 0;
+    std::size_t used_bytes = 0;
+
+    memory_usage& operator+=(const memory_usage& other) noexcept {
+        reserved_bytes += other.reserved_bytes;
+        used_bytes += other.used_bytes;
+        return *this;
+    }
+};
+
+// 定长元素存储的占用：预留 capacity 个、在用 count 个（count 超过 capacity 时按 capacity 计）
+constexpr memory_usage element_memory(std::size_t capacity, std::size_t count, std::size_t element_bytes) noexcept {
+    return memory_usage{capacity * element_bytes, (count < capacity ? count : capacity) * element_bytes};
+}
+
+// 按组件登记的内存占用表：每个组件提供一个取值函数，启动时整表输出到日志，
+// 绑定指标表后每个组件登记 mem.<name>.reserved / mem.<name>.used 两个瞬时值，由事件循环按节拍 publish()。
+// 登记、绑定与 publish 在同一线程进行；取值函数在该线程上调用，只读组件自身状态
+class memory_accounting {
+public:
+    using source_fn = memory_usage (*)(const void* context) noexcept;
+
+    static constexpr std::size_t kMaxComponents = 16;
+
+    // name 须为静态字符串；表满或 fn 为空时忽略
+    void add(const char* name, source_fn fn, const void* context) noexcept;
+
+    // 为已登记组件在指标表中登记瞬时值；之后 add 的组件不再补登
+    void bind_metrics(metrics_registry& registry) noexcept;
+
+    // 取各组件当前占用写入已绑定的指标
+    void publish() noexcept;
+
+    // 每个组件一行 "memory component ..." 与一行 "memory total ..."
+    void log(std::string_view module) const;
+
+    std::size_t size() const noexcept { return count_; }
+    memory_usage total() const noexcept;
+
+    // 逐个组件回调 fn(const char* name, const memory_usage& usage)，按登记顺序
+    template <typename Fn>
+    void for_each(Fn&& fn) const {
+        for (std::size_t i = 0; i < count_; ++i) {
+            fn(components_[i].name, components_[i].fn(components_[i].context));
+        }
+    }
+
+private:
+    struct component {
+        const char* name = nullptr;
+        source_fn fn = nullptr;
+        const void* context = nullptr;
+        metric_counter reserved;
+        metric_counter used;
+    };
+
+    component components_[kMaxComponents];
+    std::size_t count_ = 0;
+};
+
+}  // namespace acct_service
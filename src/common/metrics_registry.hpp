@@ -0,0 +1,105 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+namespace acct_service {
+
+enum class metric_kind : uint8_t {
+    Counter = 0,  // 单调递增
+    Gauge = 1,    // 瞬时值（如队列深度）
+};
+
+inline constexpr std::size_t kMetricSlotCount = 128;
+inline constexpr std::size_t kMetricNameSize = 48;
+
+// 单个指标槽位：名字与类型在注册时写入一次，之后只有值变化
+struct alignas(64) metric_slot {
+    std::atomic<uint64_t> value{0};
+    metric_kind kind = metric_kind::Counter;
+    uint8_t reserved[7]{};
+    char name[kMetricNameSize]{};
+};
+
+// 指标表：各组件按固定槽位登记计数器与瞬时值，可直接放入共享内存。
+// slot_count 以 release 发布，读者 acquire 读到的槽位名字与类型都已写好；值为 relaxed 单写
+struct alignas(64) metrics_table {
+    std::atomic<uint32_t> slot_count{0};
+    uint32_t reserved[15]{};
+    metric_slot slots[kMetricSlotCount];
+
+    // 清空全部登记（仅允许写者在启动时调用）
+    void reset() noexcept {
+        slot_count.store(0, std::memory_order_release);
+        for (metric_slot& slot : slots) {
+            slot.value.store(0, std::memory_order_relaxed);
+            slot.kind = metric_kind::Counter;
+            std::memset(slot.name, 0, sizeof(slot.name));
+        }
+    }
+};
+
+// 指标句柄：指向槽位值，未绑定时写入为空操作。每个槽位只允许一个写线程
+class metric_counter {
+public:
+    metric_counter() = default;
+    explicit metric_counter(std::atomic<uint64_t>* value) noexcept : value_(value) {}
+
+    explicit operator bool() const noexcept { return value_ != nullptr; }
+
+    void set(uint64_t value) noexcept {
+        if (value_) {
+            value_->store(value, std::memory_order_relaxed);
+        }
+    }
+
+    void add(uint64_t delta = 1) noexcept {
+        if (value_) {
+            value_->store(value_->load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
+        }
+    }
+
+private:
+    std::atomic<uint64_t>* value_ = nullptr;
+};
+
+// 写端登记入口：同名指标复用已有槽位，表满返回未绑定句柄。
+// 登记只在启动期进行，多个组件登记同一张表时须在同一线程上完成
+class metrics_registry {
+public:
+    explicit metrics_registry(metrics_table* table) noexcept : table_(table) {}
+
+    metric_counter add(std::string_view name, metric_kind kind = metric_kind::Counter) noexcept {
+        if (!table_ || name.empty()) {
+            return {};
+        }
+        const std::size_t count = std::min<std::size_t>(table_->slot_count.load(std::memory_order_relaxed),
+                                                        kMetricSlotCount);
+        for (std::size_t i = 0; i < count; ++i) {
+            if (name == table_->slots[i].name) {
+                return metric_counter(&table_->slots[i].value);
+            }
+        }
+        if (count == kMetricSlotCount) {
+            return {};
+        }
+
+        metric_slot& slot = table_->slots[count];
+        const std::size_t length = std::min(name.size(), kMetricNameSize - 1);
+        std::memcpy(slot.name, name.data(), length);
+        slot.name[length] = '\0';
+        slot.kind = kind;
+        slot.value.store(0, std::memory_order_relaxed);
+        table_->slot_count.store(static_cast<uint32_t>(count + 1), std::memory_order_release);
+        return metric_counter(&slot.value);
+    }
+
+private:
+    metrics_table* table_ = nullptr;
+};
+
+}  // namespace acct_service
@@ -0,0 +1,148 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace acct_service {
+
+// 队列深度直方图：消费者每隔若干轮按生产者/消费者游标差采样一次所排空队列的积压深度。
+// 桶 0 为空队列，桶 i (i >= 1) 覆盖 [2^(i-1), 2^i)，最后一个桶收纳更深的样本。
+// 单写者记录、跨进程只读：写侧使用 relaxed load/store 避免原子 RMW，可直接放入共享内存。
+struct alignas(64) queue_depth_histogram {
+    static constexpr std::size_t kBucketCount = 24;  // 覆盖到 2^23 深度，大于任一 SHM 队列容量
+
+    std::atomic<uint64_t> samples{0};         // 采样次数
+    std::atomic<uint64_t> high_watermark{0};  // 采样到的最大深度
+    std::atomic<uint64_t> last_depth{0};      // 最近一次采样深度
+    std::atomic<uint64_t> capacity{0};        // 队列容量（写者登记一次），监控据此计算占用比例
+    std::atomic<uint64_t> alerts{0};          // 采样深度自下而上越过告警线的次数
+    uint64_t reserved[3]{};                   // 预留字段
+    std::atomic<uint64_t> buckets[kBucketCount]{};
+
+    static constexpr std::size_t bucket_index(uint64_t depth) noexcept {
+        if (depth == 0) {
+            return 0;
+        }
+        const std::size_t index = static_cast<std::size_t>(64 - __builtin_clzll(depth));
+        return index < kBucketCount ? index : kBucketCount - 1;
+    }
+
+    // 桶上界（包含）；最后一个桶无上界，由调用方以高水位截断
+    static constexpr uint64_t bucket_upper_bound(std::size_t index) noexcept {
+        return index == 0 ? 0 : (uint64_t{1} << index) - 1;
+    }
+
+    // 告警线取容量的 3/4：try_push 失败之前留出一段余量
+    uint64_t alert_threshold() const noexcept { return capacity.load(std::memory_order_relaxed) / 4 * 3; }
+
+    // 记录一个样本（仅允许单写者调用）；返回本次采样是否自下而上越过告警线，容量未登记时恒为 false
+    bool record(uint64_t depth) noexcept {
+        std::atomic<uint64_t>& bucket = buckets[bucket_index(depth)];
+        bucket.store(bucket.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        if (depth > high_watermark.load(std::memory_order_relaxed)) {
+            high_watermark.store(depth, std::memory_order_relaxed);
+        }
+        const uint64_t previous = last_depth.load(std::memory_order_relaxed);
+        last_depth.store(depth, std::memory_order_relaxed);
+        const uint64_t threshold = alert_threshold();
+        const bool crossed = threshold != 0 && depth >= threshold && previous < threshold;
+        if (crossed) {
+            alerts.store(alerts.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        }
+        samples.store(samples.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+        return crossed;
+    }
+
+    // 估算分位数（quantile 取值 [0, 1]），结果为所在桶上界且不超过高水位；无样本返回 0
+    uint64_t percentile(double quantile) const noexcept {
+        const uint64_t count = samples.load(std::memory_order_acquire);
+        if (count == 0) {
+            return 0;
+        }
+        if (quantile < 0.0) {
+            quantile = 0.0;
+        }
+        if (quantile > 1.0) {
+            quantile = 1.0;
+        }
+
+        uint64_t target = static_cast<uint64_t>(quantile * static_cast<double>(count) + 0.5);
+        if (target == 0) {
+            target = 1;
+        }
+
+        const uint64_t max_depth = high_watermark.load(std::memory_order_relaxed);
+        uint64_t seen = 0;
+        for (std::size_t i = 0; i < kBucketCount; ++i) {
+            seen += buckets[i].load(std::memory_order_relaxed);
+            if (seen >= target) {
+                const uint64_t upper = bucket_upper_bound(i);
+                return upper < max_depth ? upper : max_depth;
+            }
+        }
+        return max_depth;
+    }
+
+    // 清空统计并登记容量（仅允许写者调用）
+    void reset(uint64_t queue_capacity) noexcept {
+        samples.store(0, std::memory_order_relaxed);
+        high_watermark.store(0, std::memory_order_relaxed);
+        last_depth.store(0, std::memory_order_relaxed);
+        alerts.store(0, std::memory_order_relaxed);
+        for (std::atomic<uint64_t>& bucket : buckets) {
+            bucket.store(0, std::memory_order_relaxed);
+        }
+        capacity.store(queue_capacity, std::memory_order_relaxed);
+    }
+};
+
+static_assert(sizeof(queue_depth_histogram) == 256, "queue_depth_histogram layout changed");
+
+// 统计段中按队列编号排列的深度直方图；上游 lane 类队列按采样时最深的一条 lane 记录（容量按单条 lane 计）
+enum class shm_queue_id : uint8_t {
+    UpstreamOrders = 0,      // 上游 lane 订单索引队列（账户服务排空）
+    UpstreamCancels = 1,     // 上游 lane 撤单优先队列（账户服务排空）
+    UpstreamPayloads = 2,    // 上游 lane 内联订单消息环（账户服务排空）
+    Responses = 3,           // 成交回报队列（账户服务排空）
+    DownstreamOrders = 4,    // 下游订单索引队列（网关排空）
+    DownstreamPayloads = 5,  // 下游内联订单消息队列（网关排空）
+    DownstreamCancels = 6,   // 下游撤单优先队列（网关排空）
+    Count,
+};
+
+inline constexpr std::size_t kShmQueueCount = static_cast<std::size_t>(shm_queue_id::Count);
+
+inline constexpr const char* shm_queue_name(shm_queue_id id) noexcept {
+    switch (id) {
+        case shm_queue_id::UpstreamOrders:
+            return "upstream_orders";
+        case shm_queue_id::UpstreamCancels:
+            return "upstream_cancels";
+        case shm_queue_id::UpstreamPayloads:
+            return "upstream_payloads";
+        case shm_queue_id::Responses:
+            return "responses";
+        case shm_queue_id::DownstreamOrders:
+            return "downstream_orders";
+        case shm_queue_id::DownstreamPayloads:
+            return "downstream_payloads";
+        case shm_queue_id::DownstreamCancels:
+            return "downstream_cancels";
+        case shm_queue_id::Count:
+            break;
+    }
+    return "unknown";
+}
+
+// 各 SHM 队列的深度直方图：上游与回报由账户服务事件循环单写，下游由网关主循环单写
+struct queue_depth_stats {
+    queue_depth_histogram queues[kShmQueueCount];
+
+    queue_depth_histogram& operator[](shm_queue_id id) noexcept { return queues[static_cast<std::size_t>(id)]; }
+    const queue_depth_histogram& operator[](shm_queue_id id) const noexcept {
+        return queues[static_cast<std::size_t>(id)];
+    }
+};
+
+}  // namespace acct_service
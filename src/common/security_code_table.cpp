@@ -0,0 +1,123 @@
+#include "common/security_code_table.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <numeric>
+
+namespace acct_service {
+
+namespace {
+
+constexpr uint32_t kMaxDisplacement = 1U << 20;  // 单桶位移搜索上限，负载 0.5 下实际只需个位数次尝试
+constexpr std::size_t kKeysPerBucket = 4;
+
+}  // namespace
+
+security_code_table::packed_key security_code_table::pack_key(const InternalSecurityId& key) noexcept {
+    static_assert(sizeof(key.data) == 16, "packed_key assumes 16-byte internal security ids");
+    packed_key packed;
+    bool terminated = false;
+    packed.lo = fixed_string_detail::load_masked_word(key.data, 0, terminated);
+    packed.hi = terminated ? 0 : fixed_string_detail::load_masked_word(key.data, 1, terminated);
+    return packed;
+}
+
+uint64_t security_code_table::hash_key(const packed_key& key) noexcept {
+    uint64_t value = key.lo * 0x9E3779B97F4A7C15ULL ^ std::rotl(key.hi * 0xC2B2AE3D27D4EB4FULL, 31);
+    value ^= value >> 33;
+    value *= 0xFF51AFD7ED558CCDULL;
+    value ^= value >> 33;
+    return value;
+}
+
+// 桶号取哈希低位，槽位由高位与位移重新打散，两者互不相关
+std::size_t security_code_table::slot_index(uint64_t hash, uint32_t displacement, std::size_t slot_mask) noexcept {
+    uint64_t value = (hash >> 29) + static_cast<uint64_t>(displacement) * 0x9E3779B97F4A7C15ULL;
+    value ^= value >> 32;
+    value *= 0xD6E8FEB86659FD93ULL;
+    value ^= value >> 32;
+    return static_cast<std::size_t>(value) & slot_mask;
+}
+
+bool security_code_table::build(const std::vector<std::pair<InternalSecurityId, SecurityHandle>>& entries) {
+    clear();
+    if (entries.empty()) {
+        return true;
+    }
+
+    const std::size_t count = entries.size();
+    slot_count_ = std::bit_ceil(count * 2);
+    const std::size_t bucket_count = std::bit_ceil(std::max<std::size_t>(count / kKeysPerBucket, 1));
+    bucket_mask_ = bucket_count - 1;
+
+    std::vector<packed_key> keys(count);
+    std::vector<uint64_t> hashes(count);
+    std::vector<std::vector<std::size_t>> buckets(bucket_count);
+    for (std::size_t i = 0; i < count; ++i) {
+        keys[i] = pack_key(entries[i].first);
+        hashes[i] = hash_key(keys[i]);
+        buckets[hashes[i] & bucket_mask_].push_back(i);
+    }
+
+    // 大桶先放，空槽越多越容易找到位移
+    std::vector<std::size_t> order(bucket_count);
+    std::iota(order.begin(), order.end(), std::size_t{0});
+    std::stable_sort(order.begin(), order.end(),
+                     [&buckets](std::size_t lhs, std::size_t rhs) { return buckets[lhs].size() > buckets[rhs].size(); });
+
+    slots_ = std::make_unique<slot_entry[]>(slot_count_);
+    displacements_ = std::make_unique<uint32_t[]>(bucket_count);
+    std::vector<uint8_t> occupied(slot_count_, 0);
+    std::vector<std::size_t> placed;
+    for (const std::size_t bucket : order) {
+        const std::vector<std::size_t>& members = buckets[bucket];
+        if (members.empty()) {
+            break;
+        }
+        for (std::size_t a = 0; a < members.size(); ++a) {
+            for (std::size_t b = a + 1; b < members.size(); ++b) {
+                if (keys[members[a]].lo == keys[members[b]].lo && keys[members[a]].hi == keys[members[b]].hi) {
+                    clear();
+                    return false;
+                }
+            }
+        }
+
+        bool found = false;
+        for (uint32_t displacement = 0; displacement < kMaxDisplacement && !found; ++displacement) {
+            placed.clear();
+            found = true;
+            for (const std::size_t member : members) {
+                const std::size_t slot = slot_index(hashes[member], displacement, slot_count_ - 1);
+                if (occupied[slot] != 0 || std::find(placed.begin(), placed.end(), slot) != placed.end()) {
+                    found = false;
+                    break;
+                }
+                placed.push_back(slot);
+            }
+            if (found) {
+                displacements_[bucket] = displacement;
+            }
+        }
+        if (!found) {
+            clear();
+            return false;
+        }
+        for (std::size_t i = 0; i < members.size(); ++i) {
+            occupied[placed[i]] = 1;
+            slots_[placed[i]] = slot_entry{keys[members[i]].lo, keys[members[i]].hi, entries[members[i]].second};
+        }
+    }
+    size_ = count;
+    return true;
+}
+
+void security_code_table::clear() noexcept {
+    slots_.reset();
+    displacements_.reset();
+    slot_count_ = 0;
+    bucket_mask_ = 0;
+    size_ = 0;
+}
+
+}  // namespace acct_service
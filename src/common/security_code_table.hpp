@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "common/types.hpp"
+
+namespace acct_service {
+
+// 启动期构造的证券键完美哈希表：canonical 内部证券键 -> SecurityHandle。
+// 采用 hash-and-displace：键先落桶，每个桶选一个位移使桶内键映射到互不冲突的槽位，
+// 查找固定为一次桶读 + 一次槽读 + 16 字节比较，不探测。构造后只读，运行期新增的证券由调用方走慢路径。
+class security_code_table {
+public:
+    struct packed_key {
+        uint64_t lo = 0;
+        uint64_t hi = 0;
+    };
+
+    struct slot_entry {
+        uint64_t lo = 0;
+        uint64_t hi = 0;
+        SecurityHandle handle = kInvalidSecurityHandle;
+    };
+
+    security_code_table() = default;
+
+    security_code_table(const security_code_table&) = delete;
+    security_code_table& operator=(const security_code_table&) = delete;
+
+    // 以 (canonical 键, 句柄) 重建；键需互不相同。位移搜索失败时表置空并返回 false，调用方全走慢路径
+    bool build(const std::vector<std::pair<InternalSecurityId, SecurityHandle>>& entries);
+
+    // 按键原始字节查找（终止符后的残留字节不参与比较）；未命中返回 kInvalidSecurityHandle
+    SecurityHandle find(const InternalSecurityId& key) const noexcept {
+        if (slot_count_ == 0) {
+            return kInvalidSecurityHandle;
+        }
+        const packed_key packed = pack_key(key);
+        const uint64_t hash = hash_key(packed);
+        const uint32_t displacement = displacements_[hash & bucket_mask_];
+        const slot_entry& slot = slots_[slot_index(hash, displacement, slot_count_ - 1)];
+        return (slot.lo == packed.lo && slot.hi == packed.hi) ? slot.handle : kInvalidSecurityHandle;
+    }
+
+    void clear() noexcept;
+    std::size_t size() const noexcept { return size_; }
+
+    // 构造结果的只读视图，供把表整体拷进共享内存（如证券主数据段）后按同一算法查找
+    std::size_t slot_count() const noexcept { return slot_count_; }
+    std::size_t bucket_count() const noexcept { return slot_count_ == 0 ? 0 : bucket_mask_ + 1; }
+    const slot_entry* slots() const noexcept { return slots_.get(); }
+    const uint32_t* displacements() const noexcept { return displacements_.get(); }
+
+    // 按 8 字节字读入键并清掉终止符之后的残留字节（同 FixedString 的逐字比较）
+    static packed_key pack_key(const InternalSecurityId& key) noexcept;
+    static uint64_t hash_key(const packed_key& key) noexcept;
+    // 桶号取哈希低位（hash & bucket_mask），槽位由高位与位移重新打散；slot_mask = 槽数 - 1
+    static std::size_t slot_index(uint64_t hash, uint32_t displacement, std::size_t slot_mask) noexcept;
+
+private:
+    std::unique_ptr<slot_entry[]> slots_;
+    std::unique_ptr<uint32_t[]> displacements_;
+    std::size_t slot_count_ = 0;
+    std::size_t bucket_mask_ = 0;
+    std::size_t size_ = 0;
+};
+
+}  // namespace acct_service
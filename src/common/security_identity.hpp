@@ -1,6 +1,8 @@
 #pragma once
 
 #include <array>
+#include <cstdint>
+#include <cstring>
 #include <string_view>
 
 #include "common/types.hpp"
@@ -66,6 +68,25 @@ inline bool parse_mic_market_prefix(std::string_view prefix, Market& market) noe
     return false;
 }
 
+// 定长内部证券键是否以 "<MIC>_" 开头（四位 MIC + 下划线），供热路径跳过完整解析。
+inline bool has_canonical_mic_prefix(const char* internal_id) noexcept {
+    Market market = Market::NotSet;
+    return internal_id[4] == '_' && parse_mic_market_prefix(std::string_view(internal_id, 4), market);
+}
+
+// A 股 / 北交所常见的 6 位纯数字代码：整段读入一个字后按字节并行判断（SWAR），不逐字符循环。
+inline bool is_six_digit_code(std::string_view code) noexcept {
+    if (code.size() != 6) {
+        return false;
+    }
+    uint64_t word = 0;
+    std::memcpy(&word, code.data(), 6);
+    constexpr uint64_t kDigitBytes = 0x0000303030303030ULL;  // 6 个 '0'
+    constexpr uint64_t kHighNibbles = 0x0000F0F0F0F0F0F0ULL;
+    // 每字节高半字节须为 0x3，且加 6 后不进位到高半字节（即低半字节 <= 9）
+    return (word & kHighNibbles) == kDigitBytes && ((word + 0x0000060606060606ULL) & kHighNibbles) == kDigitBytes;
+}
+
 // 按指定分隔符切开内部证券键，便于兼容旧格式和新格式。
 inline bool split_internal_security_id(std::string_view internal_id, char delimiter, std::string_view& prefix,
                                        std::string_view& code) noexcept {
@@ -104,6 +125,15 @@ inline bool build_internal_security_id(Market market, std::string_view security_
         return false;
     }
 
+    // MIC 前缀恒为 4 字节；6 位数字代码按定长拷贝直接写入，其余代码走通用拷贝
+    if (prefix.size() == 4 && is_six_digit_code(security_id)) {
+        std::memcpy(out_id.data, prefix.data(), 4);
+        out_id.data[4] = '_';
+        std::memcpy(out_id.data + 5, security_id.data(), 6);
+        std::memset(out_id.data + 11, 0, kInternalSecurityIdSize - 11U);
+        return true;
+    }
+
     std::array<char, kInternalSecurityIdCapacity + 1U> buffer{};
     for (std::size_t i = 0; i < prefix.size(); ++i) {
         buffer[i] = prefix[i];
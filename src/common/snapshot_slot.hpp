@@ -0,0 +1,57 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+namespace acct_service {
+
+// 单写单读的双缓冲快照：写端把新值写入读端不会访问的那格后以 release 发布新纪元，
+// 读端每轮一次 acquire 读纪元，变化时拷出并回写已消费纪元。写端在读端确认上一版之前不会复写任何一格，
+// 双方都不加锁；上一版未被取走时 publish 返回 false，由写端稍后重试。
+// T 须可拷贝赋值；读端拷出目标由调用方持有，可复用其容量
+template <typename T>
+class snapshot_slot {
+public:
+    snapshot_slot() = default;
+
+    snapshot_slot(const snapshot_slot&) = delete;
+    snapshot_slot& operator=(const snapshot_slot&) = delete;
+
+    // 写端：上一版尚未被读端取走时返回 false 且不改动快照
+    bool publish(const T& value) {
+        const uint64_t epoch = published_.load(std::memory_order_relaxed);
+        if (consumed_.load(std::memory_order_acquire) != epoch) {
+            return false;
+        }
+        const uint64_t next = epoch + 1;
+        buffers_[next & 1] = value;
+        published_.store(next, std::memory_order_release);
+        return true;
+    }
+
+    // 读端：是否有未取走的新版本，只做一次 acquire 读
+    bool has_update() const noexcept { return published_.load(std::memory_order_acquire) != seen_; }
+
+    // 读端：有新版本时拷入 out 并确认，返回 true
+    bool consume(T& out) {
+        const uint64_t epoch = published_.load(std::memory_order_acquire);
+        if (epoch == seen_) {
+            return false;
+        }
+        out = buffers_[epoch & 1];
+        seen_ = epoch;
+        consumed_.store(epoch, std::memory_order_release);
+        return true;
+    }
+
+    // 已发布的版本数
+    uint64_t published_count() const noexcept { return published_.load(std::memory_order_acquire); }
+
+private:
+    T buffers_[2]{};
+    alignas(64) std::atomic<uint64_t> published_{0};  // 写端写、读端读
+    alignas(64) std::atomic<uint64_t> consumed_{0};   // 读端写、写端读
+    uint64_t seen_ = 0;                               // 读端私有
+};
+
+}  // namespace acct_service
@@ -1,5 +1,12 @@
 #include "common/spinlock.hpp"
 
+#include <pthread.h>
+#include <signal.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
 #include <thread>
 
 // x86 PAUSE 指令支持
@@ -15,35 +22,89 @@
 
 namespace acct_service {
 
+namespace {
+
+// 退避上限：单轮最多 PAUSE 次数
+constexpr int kMaxBackoff = 1024;
+// 退避到上限后再空转的轮数，之后每轮睡眠一次并检查持有者是否存活
+constexpr int kSpinRoundsAtCap = 16;
+// 票号锁每个排在前面的等待方对应的 PAUSE 次数
+constexpr uint32_t kTicketBackoffPerWaiter = 64;
+constexpr int kTicketSpinRounds = 64;
+// 长时间拿不到锁时的睡眠时长：让出 CPU 给可能被抢占的持有者（SCHED_FIFO 下 sched_yield 不让给低优先级）
+constexpr std::chrono::microseconds kContendedSleep{50};
+
+std::atomic<uint32_t> g_process_id{0};
+std::atomic<uint64_t> g_dead_owner_recoveries{0};
+
+void refresh_process_id() noexcept { g_process_id.store(static_cast<uint32_t>(::getpid()), std::memory_order_relaxed); }
+
+// 缓存进程号（getpid 在新版 glibc 中每次都是系统调用），fork 后由子进程回调刷新
+uint32_t current_process_id() noexcept {
+    const uint32_t pid = g_process_id.load(std::memory_order_relaxed);
+    if (pid != 0) {
+        return pid;
+    }
+    static const int registered = ::pthread_atfork(nullptr, nullptr, refresh_process_id);
+    (void)registered;
+    refresh_process_id();
+    return g_process_id.load(std::memory_order_relaxed);
+}
+
+// ESRCH 才算已退出；EPERM 说明进程存在但属于其他用户
+bool process_alive(uint32_t pid) noexcept { return ::kill(static_cast<pid_t>(pid), 0) == 0 || errno != ESRCH; }
+
+void pause_n(uint32_t count) noexcept {
+    for (uint32_t i = 0; i < count; ++i) {
+        CPU_PAUSE();
+    }
+}
+
+}  // namespace
+
+uint64_t spinlock_dead_owner_recoveries() noexcept { return g_dead_owner_recoveries.load(std::memory_order_relaxed); }
+
 void SpinLock::lock() noexcept {
     // TTAS (Test-And-Test-And-Set) + compare_exchange_weak + 指数退避优化
     // compare_exchange_weak 在失败时只读，减少缓存一致性流量
-
-    bool expected = false;
+    const uint32_t self = current_process_id();
+    uint32_t expected = 0;
 
     // 快速路径：尝试立即获取锁
-    if (flag_.compare_exchange_weak(expected, true, std::memory_order_acquire, std::memory_order_relaxed)) {
+    if (owner_.compare_exchange_weak(expected, self, std::memory_order_acquire, std::memory_order_relaxed)) {
         return;
     }
 
-    // 慢速路径：TTAS + 指数退避
+    // 慢速路径：TTAS + 指数退避，退避到上限后转为睡眠并检查持有者
     int backoff = 1;
-    const int max_backoff = 1024;
+    int rounds_at_cap = 0;
 
     while (true) {
         // 第一步：Test - 检查锁是否被持有（只读，不触发缓存失效风暴）
-        while (flag_.load(std::memory_order_relaxed)) {
-            // 指数退避：PAUSE 次数逐渐增加
-            for (int i = 0; i < backoff; ++i) {
-                CPU_PAUSE();
+        uint32_t holder = owner_.load(std::memory_order_relaxed);
+        while (holder != 0) {
+            if (backoff < kMaxBackoff) {
+                pause_n(static_cast<uint32_t>(backoff));
+                backoff <<= 1;
+            } else if (rounds_at_cap < kSpinRoundsAtCap) {
+                pause_n(kMaxBackoff);
+                ++rounds_at_cap;
+            } else {
+                // 持有者进程已退出：直接把锁字从它的进程号换成自己的
+                if (holder != self && !process_alive(holder) &&
+                    owner_.compare_exchange_strong(holder, self, std::memory_order_acquire,
+                                                   std::memory_order_relaxed)) {
+                    g_dead_owner_recoveries.fetch_add(1, std::memory_order_relaxed);
+                    return;
+                }
+                std::this_thread::sleep_for(kContendedSleep);
             }
-            // 增加退避时间，但不超过上限
-            backoff = (backoff < max_backoff) ? (backoff << 1) : max_backoff;
+            holder = owner_.load(std::memory_order_relaxed);
         }
 
         // 第二步：尝试获取锁（compare_exchange_weak 可能更快）
-        expected = false;
-        if (flag_.compare_exchange_weak(expected, true, std::memory_order_acquire, std::memory_order_relaxed)) {
+        expected = 0;
+        if (owner_.compare_exchange_weak(expected, self, std::memory_order_acquire, std::memory_order_relaxed)) {
             return;
         }
 
@@ -53,13 +114,86 @@ void SpinLock::lock() noexcept {
 
 bool SpinLock::try_lock() noexcept {
     // 使用 compare_exchange_weak 尝试获取锁
-    bool expected = false;
-    return flag_.compare_exchange_weak(expected, true, std::memory_order_acquire, std::memory_order_relaxed);
+    uint32_t expected = 0;
+    return owner_.compare_exchange_weak(expected, current_process_id(), std::memory_order_acquire,
+                                        std::memory_order_relaxed);
 }
 
-void SpinLock::unlock() noexcept { flag_.store(false, std::memory_order_release); }
+void SpinLock::unlock() noexcept { owner_.store(0, std::memory_order_release); }
+
+bool SpinLock::is_locked() const noexcept { return owner_.load(std::memory_order_relaxed) != 0; }
 
-bool SpinLock::is_locked() const noexcept { return flag_.load(std::memory_order_relaxed); }
+bool SpinLock::recover_if_owner_dead() noexcept {
+    uint32_t holder = owner_.load(std::memory_order_relaxed);
+    if (holder == 0 || process_alive(holder)) {
+        return false;
+    }
+    if (!owner_.compare_exchange_strong(holder, 0, std::memory_order_acq_rel, std::memory_order_relaxed)) {
+        return false;
+    }
+    g_dead_owner_recoveries.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+void TicketSpinLock::lock() noexcept {
+    const uint32_t self = current_process_id();
+    const uint32_t ticket = next_.fetch_add(1, std::memory_order_relaxed);
+
+    // 按前面排队人数成比例退避：排得越后越少读 serving_，轮到时延迟与排队长度无关
+    int rounds = 0;
+    uint32_t serving = serving_.load(std::memory_order_acquire);
+    while (serving != ticket) {
+        if (rounds < kTicketSpinRounds) {
+            const uint32_t ahead = ticket - serving;
+            pause_n(std::min<uint32_t>(ahead * kTicketBackoffPerWaiter, kMaxBackoff));
+            ++rounds;
+        } else {
+            uint32_t holder = owner_.load(std::memory_order_relaxed);
+            if (holder != 0 && holder != self && !process_alive(holder) &&
+                owner_.compare_exchange_strong(holder, 0, std::memory_order_acq_rel, std::memory_order_relaxed)) {
+                serving_.store(serving + 1, std::memory_order_release);
+                g_dead_owner_recoveries.fetch_add(1, std::memory_order_relaxed);
+            } else {
+                std::this_thread::sleep_for(kContendedSleep);
+            }
+        }
+        serving = serving_.load(std::memory_order_acquire);
+    }
+    owner_.store(self, std::memory_order_relaxed);
+}
+
+bool TicketSpinLock::try_lock() noexcept {
+    uint32_t serving = serving_.load(std::memory_order_acquire);
+    if (!next_.compare_exchange_strong(serving, serving + 1, std::memory_order_acquire, std::memory_order_relaxed)) {
+        return false;
+    }
+    owner_.store(current_process_id(), std::memory_order_relaxed);
+    return true;
+}
+
+// 只有持有者写 serving_，无需读改写
+void TicketSpinLock::unlock() noexcept {
+    owner_.store(0, std::memory_order_relaxed);
+    serving_.store(serving_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+bool TicketSpinLock::is_locked() const noexcept {
+    return next_.load(std::memory_order_relaxed) != serving_.load(std::memory_order_relaxed);
+}
+
+bool TicketSpinLock::recover_if_owner_dead() noexcept {
+    uint32_t holder = owner_.load(std::memory_order_relaxed);
+    if (holder == 0 || process_alive(holder)) {
+        return false;
+    }
+    const uint32_t serving = serving_.load(std::memory_order_acquire);
+    if (!owner_.compare_exchange_strong(holder, 0, std::memory_order_acq_rel, std::memory_order_relaxed)) {
+        return false;
+    }
+    serving_.store(serving + 1, std::memory_order_release);
+    g_dead_owner_recoveries.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
 
 // LockGuard 实现
 template <typename Lock>
@@ -106,5 +240,7 @@ void UniqueLock<Lock>::unlock() {
 // 显式实例化
 template class LockGuard<SpinLock>;
 template class UniqueLock<SpinLock>;
+template class LockGuard<TicketSpinLock>;
+template class UniqueLock<TicketSpinLock>;
 
 }  // namespace acct_service
@@ -1,10 +1,15 @@
 #pragma once
 
 #include <atomic>
+#include <cstdint>
 
 namespace acct_service {
 
-// 高性能自旋锁（64字节对齐避免false sharing）
+// 高性能自旋锁（64字节对齐避免false sharing）。
+// 锁字保存持有者进程号（0 为未上锁），可放入共享内存跨进程使用：持有者进程退出后等待方能识别并接管。
+// 竞争时 TTAS + 指数 PAUSE 退避；长时间拿不到锁时转为短暂睡眠并检查持有者是否存活，
+// 避免 SCHED_FIFO 线程在同核上空转饿死被抢占的低优先级持有者（如监控进程）。
+// 同一进程内的线程共用进程号，只有跨进程放置时死锁恢复才有意义。
 class alignas(64) SpinLock {
 public:
     SpinLock() noexcept = default;
@@ -16,11 +21,43 @@ public:
     void unlock() noexcept;
     bool is_locked() const noexcept;
 
+    // 当前持有者进程号，未上锁为 0
+    uint32_t owner_pid() const noexcept { return owner_.load(std::memory_order_relaxed); }
+    // 持有者进程已不存在时释放锁并返回 true；锁内状态可能只改了一半，由调用方决定是否重建
+    bool recover_if_owner_dead() noexcept;
+
 private:
-    std::atomic<bool> flag_{false};
-    char padding_[63];
+    std::atomic<uint32_t> owner_{0};
+    char padding_[60];
 };
 
+// 票号自旋锁：按到达顺序授予，等待方按前面排队人数成比例退避；与 SpinLock 同样记录持有者进程号。
+// 只能恢复已打上进程号的死持有者；拿到票号后、打戳前退出的进程，以及排队中退出的等待方都会使锁永久停住，
+// 因此跨进程放置时优先用 SpinLock，票号锁用于同进程内需要公平性的场合
+class alignas(64) TicketSpinLock {
+public:
+    TicketSpinLock() noexcept = default;
+    TicketSpinLock(const TicketSpinLock&) = delete;
+    TicketSpinLock& operator=(const TicketSpinLock&) = delete;
+
+    void lock() noexcept;
+    bool try_lock() noexcept;
+    void unlock() noexcept;
+    bool is_locked() const noexcept;
+
+    uint32_t owner_pid() const noexcept { return owner_.load(std::memory_order_relaxed); }
+    bool recover_if_owner_dead() noexcept;
+
+private:
+    std::atomic<uint32_t> next_{0};
+    std::atomic<uint32_t> serving_{0};
+    std::atomic<uint32_t> owner_{0};
+    char padding_[52];
+};
+
+// 因持有者进程退出而被强制释放的锁次数（本进程内累计，含 lock() 内自动接管）
+uint64_t spinlock_dead_owner_recoveries() noexcept;
+
 // RAII锁守卫
 template <typename Lock>
 class LockGuard {
@@ -0,0 +1,64 @@
+#include "common/thread_setup.hpp"
+
+#include <sched.h>
+#include <sys/mman.h>
+
+#include <cerrno>
+#include <cstring>
+#include <string>
+
+#include "common/log.hpp"
+
+namespace acct_service {
+
+namespace {
+
+void warn_thread_setup(std::string_view role, std::string_view what, int sys_errno) {
+    ACCT_LOG_WARN("ThreadSetup", std::string(role) + ": " + std::string(what) + " failed: " + std::strerror(sys_errno));
+}
+
+}  // namespace
+
+bool apply_thread_realtime(std::string_view role, const thread_realtime_config& config) {
+#if defined(__linux__)
+    bool ok = true;
+    if (config.cpu_core >= 0) {
+        cpu_set_t cpuset;
+        CPU_ZERO(&cpuset);
+        CPU_SET(config.cpu_core, &cpuset);
+        if (sched_setaffinity(0, sizeof(cpu_set_t), &cpuset) != 0) {
+            warn_thread_setup(role, "sched_setaffinity(cpu=" + std::to_string(config.cpu_core) + ")", errno);
+            ok = false;
+        }
+    }
+    if (config.fifo_priority > 0) {
+        sched_param param{};
+        param.sched_priority = config.fifo_priority;
+        // 需要 CAP_SYS_NICE 或 RLIMIT_RTPRIO，权限不足时保持原调度策略
+        if (sched_setscheduler(0, SCHED_FIFO, &param) != 0) {
+            warn_thread_setup(role, "SCHED_FIFO(priority=" + std::to_string(config.fifo_priority) + ")", errno);
+            ok = false;
+        }
+    }
+    if (ok && (config.cpu_core >= 0 || config.fifo_priority > 0)) {
+        ACCT_LOG_INFO("ThreadSetup", std::string(role) + ": cpu_core=" + std::to_string(config.cpu_core) +
+                                         " fifo_priority=" + std::to_string(config.fifo_priority));
+    }
+    return ok;
+#else
+    (void)role;
+    (void)config;
+    return true;
+#endif
+}
+
+bool lock_process_memory() {
+    if (mlockall(MCL_CURRENT | MCL_FUTURE) != 0) {
+        warn_thread_setup("process", "mlockall(MCL_CURRENT|MCL_FUTURE)", errno);
+        return false;
+    }
+    ACCT_LOG_INFO("ThreadSetup", "process memory locked (MCL_CURRENT|MCL_FUTURE)");
+    return true;
+}
+
+}  // namespace acct_service
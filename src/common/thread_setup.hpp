@@ -0,0 +1,21 @@
+#pragma once
+
+#include <string_view>
+
+namespace acct_service {
+
+inline constexpr int kMaxFifoPriority = 99;
+
+// 单个线程角色的实时设置：cpu_core 为绑核目标（-1 不绑），fifo_priority 为 SCHED_FIFO 优先级（0 保持默认调度）
+struct thread_realtime_config {
+    int cpu_core = -1;
+    int fifo_priority = 0;
+};
+
+// 在当前线程上应用绑核与调度策略；失败只写 WARN 日志（带角色与 errno）并继续运行，返回是否全部生效
+bool apply_thread_realtime(std::string_view role, const thread_realtime_config& config);
+
+// 启动时调用 mlockall(MCL_CURRENT | MCL_FUTURE)，避免热路径缺页换出；失败写 WARN 日志
+bool lock_process_memory();
+
+}  // namespace acct_service
@@ -1,10 +1,98 @@
 #include "common/time_utils.hpp"
 
+#include <algorithm>
+#include <chrono>
 #include <cstdio>
 #include <ctime>
+#include <thread>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#endif
 
 namespace acct_service {
 
+namespace {
+
+constexpr auto kCalibrationWindow = std::chrono::milliseconds(10);
+constexpr double kMaxRefineDrift = 0.01;  // 单线程细化频率与全局校准值的偏差上限，超出视为迁核跳变
+
+// 恒频 TSC（invariant TSC）不随调频/睡眠变化，才能直接换算墙上时间
+bool tsc_is_invariant() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+    unsigned int eax = 0;
+    unsigned int ebx = 0;
+    unsigned int ecx = 0;
+    unsigned int edx = 0;
+    if (__get_cpuid(0x80000007U, &eax, &ebx, &ecx, &edx) == 0) {
+        return false;
+    }
+    return (edx & (1U << 8)) != 0;
+#elif defined(__aarch64__)
+    return true;  // 通用定时器 cntvct_el0 恒频
+#else
+    return false;
+#endif
+}
+
+double measure_ns_per_tick() noexcept {
+    const uint64_t t0_tsc = tsc_clock::read_ticks();
+    const TimestampNs t0_ns = now_monotonic_ns();
+    std::this_thread::sleep_for(kCalibrationWindow);
+    const uint64_t t1_tsc = tsc_clock::read_ticks();
+    const TimestampNs t1_ns = now_monotonic_ns();
+    if (t1_tsc <= t0_tsc || t1_ns <= t0_ns) {
+        return 0.0;
+    }
+    return static_cast<double>(t1_ns - t0_ns) / static_cast<double>(t1_tsc - t0_tsc);
+}
+
+}  // namespace
+
+bool tsc_clock::calibrate() noexcept {
+    static const bool calibrated = []() noexcept {
+        if (!tsc_is_invariant()) {
+            return false;
+        }
+        const double ns_per_tick = measure_ns_per_tick();
+        if (ns_per_tick <= 0.0) {
+            return false;
+        }
+        tsc_detail::g_ns_per_tick.store(ns_per_tick, std::memory_order_relaxed);
+        return true;
+    }();
+    return calibrated;
+}
+
+namespace tsc_detail {
+
+void resync(thread_anchor& anchor, uint64_t tsc) noexcept {
+    const TimestampNs monotonic = now_monotonic_ns();
+    const TimestampNs realtime = now_ns();
+    const double global_ns_per_tick = g_ns_per_tick.load(std::memory_order_relaxed);
+
+    // 锚点间隔不足半个周期（首次锚定）时沿用全局校准值
+    double ns_per_tick = global_ns_per_tick;
+    if (anchor.resync_ticks != 0 && tsc > anchor.tsc && monotonic > anchor.monotonic_ns &&
+        monotonic - anchor.monotonic_ns >= tsc_clock::kResyncIntervalNs / 2) {
+        const double refined =
+            static_cast<double>(monotonic - anchor.monotonic_ns) / static_cast<double>(tsc - anchor.tsc);
+        if (refined > global_ns_per_tick * (1.0 - kMaxRefineDrift) &&
+            refined < global_ns_per_tick * (1.0 + kMaxRefineDrift)) {
+            ns_per_tick = refined;
+        }
+    }
+
+    anchor.tsc = tsc;
+    anchor.realtime_ns = realtime;
+    anchor.monotonic_ns = monotonic;
+    anchor.ns_per_tick = ns_per_tick;
+    anchor.resync_ticks =
+        std::max<uint64_t>(1, static_cast<uint64_t>(static_cast<double>(tsc_clock::kResyncIntervalNs) / ns_per_tick));
+}
+
+}  // namespace tsc_detail
+
 void md_time_to_str(MdTime t, char* buf, std::size_t buf_size) {
     if (buf_size < 13) {  // HH:MM:SS.MMM 需要12字符 + null
         if (buf_size > 0) {
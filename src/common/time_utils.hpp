@@ -1,5 +1,6 @@
 #pragma once
 
+#include <atomic>
 #include <cstdint>
 #include <ctime>
 
@@ -26,4 +27,129 @@ inline uint64_t ns_to_us(TimestampNs ns) { return ns / 1000; }
 // 纳秒转毫秒
 inline uint64_t ns_to_ms(TimestampNs ns) { return ns / 1'000'000; }
 
+namespace tsc_detail {
+
+// 每线程 TSC 锚点：锚定时刻的 TSC 与实时/单调时钟，resync_ticks 为 0 表示尚未锚定
+struct thread_anchor {
+    uint64_t tsc = 0;
+    TimestampNs realtime_ns = 0;
+    TimestampNs monotonic_ns = 0;
+    TimestampNs last_monotonic_ns = 0;  // 保证本线程单调读数不回退
+    double ns_per_tick = 0.0;
+    uint64_t resync_ticks = 0;
+};
+
+inline std::atomic<double> g_ns_per_tick{0.0};  // 进程级校准结果，0 表示未启用
+
+inline thread_anchor& current_anchor() noexcept {
+    thread_local thread_anchor anchor;
+    return anchor;
+}
+
+// 用 clock_gettime 重新锚定，并按上一锚点以来的区间细化本线程频率
+void resync(thread_anchor& anchor, uint64_t tsc) noexcept;
+
+}  // namespace tsc_detail
+
+// TSC 时钟：calibrate() 校准频率后读 TSC 换算纳秒，热路径不再逐次 clock_gettime；
+// 每线程每 kResyncIntervalNs 用一次 clock_gettime 重新锚定，吸收 NTP 调整与频率漂移。
+// 未校准或 TSC 非恒频时回退 clock_gettime
+class tsc_clock {
+public:
+    static constexpr TimestampNs kResyncIntervalNs = 1'000'000'000ULL;
+
+    // 进程内首次调用时校准（约 10ms），之后直接返回首次结果；返回 false 表示继续使用 clock_gettime
+    static bool calibrate() noexcept;
+
+    static bool enabled() noexcept { return tsc_detail::g_ns_per_tick.load(std::memory_order_relaxed) > 0.0; }
+
+    static uint64_t read_ticks() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+        uint32_t lo = 0;
+        uint32_t hi = 0;
+        __asm__ __volatile__("rdtsc" : "=a"(lo), "=d"(hi));
+        return (static_cast<uint64_t>(hi) << 32) | lo;
+#elif defined(__aarch64__)
+        uint64_t value = 0;
+        __asm__ __volatile__("mrs %0, cntvct_el0" : "=r"(value));
+        return value;
+#else
+        return 0;
+#endif
+    }
+
+    // 等价于 now_ns()（CLOCK_REALTIME）
+    static TimestampNs now_realtime_ns() noexcept {
+        if (!enabled()) {
+            return now_ns();
+        }
+        const uint64_t tsc = read_ticks();
+        const tsc_detail::thread_anchor& anchor = anchor_at(tsc);
+        return anchor.realtime_ns + elapsed_ns(anchor, tsc);
+    }
+
+    // 等价于 now_monotonic_ns()（CLOCK_MONOTONIC），同一线程内不回退
+    static TimestampNs now_monotonic_ns() noexcept {
+        if (!enabled()) {
+            return acct_service::now_monotonic_ns();
+        }
+        const uint64_t tsc = read_ticks();
+        tsc_detail::thread_anchor& anchor = anchor_at(tsc);
+        const TimestampNs value = anchor.monotonic_ns + elapsed_ns(anchor, tsc);
+        if (value < anchor.last_monotonic_ns) {
+            return anchor.last_monotonic_ns;
+        }
+        anchor.last_monotonic_ns = value;
+        return value;
+    }
+
+private:
+    static tsc_detail::thread_anchor& anchor_at(uint64_t tsc) noexcept {
+        tsc_detail::thread_anchor& anchor = tsc_detail::current_anchor();
+        if (anchor.resync_ticks == 0 || tsc - anchor.tsc >= anchor.resync_ticks) {
+            tsc_detail::resync(anchor, tsc);
+        }
+        return anchor;
+    }
+
+    static TimestampNs elapsed_ns(const tsc_detail::thread_anchor& anchor, uint64_t tsc) noexcept {
+        return static_cast<TimestampNs>(static_cast<double>(tsc - anchor.tsc) * anchor.ns_per_tick);
+    }
+};
+
+// 模拟时钟：测试、压测与回放挂到事件循环上代替 TSC 读数，时间只随 set()/advance() 前进，
+// 长时间调度（TWAP 切片、延迟归档）可按 CPU 速度确定性地推进。驱动线程与事件循环线程可以不同
+class sim_clock {
+public:
+    explicit sim_clock(TimestampNs start_ns = 0) noexcept : now_ns_(start_ns) {}
+
+    TimestampNs now_ns() const noexcept { return now_ns_.load(std::memory_order_acquire); }
+    void set(TimestampNs value) noexcept { now_ns_.store(value, std::memory_order_release); }
+    void advance(TimestampNs delta_ns) noexcept { now_ns_.fetch_add(delta_ns, std::memory_order_acq_rel); }
+
+private:
+    std::atomic<TimestampNs> now_ns_;
+};
+
+// 事件循环的每轮时间：EventLoop 每轮开头 refresh() 一次，本轮内订单状态时间戳都取缓存值，
+// 一次订单状态迁移不再触发时钟调用；阶段耗时直方图仍用 tsc_clock 逐点测量
+class loop_clock {
+public:
+    void refresh() noexcept { now_ns_ = tsc_clock::now_realtime_ns(); }
+
+    // 从注入的模拟时钟取本轮时间；只由挂接了模拟时钟的循环实例调用
+    void refresh_from(const sim_clock& clock) noexcept { now_ns_ = clock.now_ns(); }
+
+    // 本轮开始时的 CLOCK_REALTIME 纳秒时间戳
+    TimestampNs now_ns() const noexcept { return now_ns_; }
+
+private:
+    TimestampNs now_ns_ = 0;
+};
+
+// 组件未挂接循环时钟（单测、恢复流程）时回退逐次取时
+inline TimestampNs clock_now_ns(const loop_clock* clock) noexcept {
+    return clock ? clock->now_ns() : tsc_clock::now_realtime_ns();
+}
+
 }  // namespace acct_service
@@ -0,0 +1,274 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "common/types.hpp"
+
+namespace acct_service {
+
+// 定时器句柄：低 32 位为节点下标，高 32 位为代数，防止句柄复用后误取消
+using timer_id = uint64_t;
+inline constexpr timer_id kInvalidTimerId = 0;
+
+// 分层时间轮：4 层 x 64 槽，单层占用位图跳过空槽；节点来自预分配池，稳态下调度/到期均不分配内存。
+// 到期时间按 resolution 向上取整，只会晚到不会早到；单线程使用。
+template <typename Payload>
+class timer_wheel {
+public:
+    static constexpr uint32_t kSlotBits = 6;
+    static constexpr uint32_t kSlotCount = 1U << kSlotBits;
+    static constexpr uint32_t kLevelCount = 4;
+
+    // resolution_ns 为单个 tick 的时长，capacity 为预分配节点数（超出时按倍数扩容）
+    explicit timer_wheel(TimestampNs resolution_ns = 1000000ULL, std::size_t capacity = 1024)
+        : resolution_ns_(resolution_ns == 0 ? 1 : resolution_ns) {
+        reserve(capacity);
+        for (auto& level : slots_) {
+            for (uint32_t& head : level) {
+                head = kNil;
+            }
+        }
+    }
+
+    // 预分配节点池
+    void reserve(std::size_t capacity) {
+        if (capacity <= nodes_.size()) {
+            return;
+        }
+        const std::size_t old_size = nodes_.size();
+        nodes_.resize(capacity);
+        for (std::size_t i = capacity; i > old_size; --i) {
+            nodes_[i - 1].next = free_head_;
+            free_head_ = static_cast<uint32_t>(i - 1);
+        }
+    }
+
+    // 登记一个到期时间为 deadline_ns 的定时器；已过期的定时器在下一次 advance 时触发
+    timer_id schedule(TimestampNs now_ns_value, TimestampNs deadline_ns, const Payload& payload) {
+        if (!started_) {
+            current_tick_ = now_ns_value / resolution_ns_;
+            started_ = true;
+        }
+        if (free_head_ == kNil) {
+            reserve(nodes_.empty() ? 64 : nodes_.size() * 2);
+        }
+
+        const uint32_t index = free_head_;
+        node& item = nodes_[index];
+        free_head_ = item.next;
+
+        uint64_t deadline_tick = deadline_ns / resolution_ns_ + (deadline_ns % resolution_ns_ != 0 ? 1 : 0);
+        const uint64_t earliest_tick = expiring_ ? current_tick_ + 1 : current_tick_;
+        if (deadline_tick < earliest_tick) {
+            deadline_tick = earliest_tick;
+        }
+        item.deadline_tick = deadline_tick;
+        item.payload = payload;
+        item.active = true;
+        ++item.generation;
+        if (item.generation == 0) {
+            item.generation = 1;
+        }
+        link(index);
+        ++size_;
+        return (static_cast<timer_id>(item.generation) << 32) | index;
+    }
+
+    // 取消尚未触发的定时器；句柄已失效时返回 false
+    bool cancel(timer_id id) noexcept {
+        const uint32_t index = static_cast<uint32_t>(id & 0xFFFFFFFFULL);
+        const uint32_t generation = static_cast<uint32_t>(id >> 32);
+        if (id == kInvalidTimerId || index >= nodes_.size()) {
+            return false;
+        }
+        node& item = nodes_[index];
+        if (!item.active || item.generation != generation) {
+            return false;
+        }
+        unlink(index);
+        release(index);
+        return true;
+    }
+
+    // 推进到 now_ns_value，依次对到期定时器调用 on_expire(payload)；回调内允许再次 schedule/cancel
+    template <typename OnExpire>
+    void advance(TimestampNs now_ns_value, OnExpire&& on_expire) {
+        const uint64_t target_tick = now_ns_value / resolution_ns_;
+        if (!started_) {
+            current_tick_ = target_tick;
+            started_ = true;
+        }
+
+        while (current_tick_ <= target_tick) {
+            if (size_ == 0) {
+                current_tick_ = target_tick + 1;
+                return;
+            }
+
+            const uint32_t slot = static_cast<uint32_t>(current_tick_ & (kSlotCount - 1));
+            if (slot == 0) {
+                cascade();
+            }
+
+            // 本圈剩余槽位全空时直接跳到下一个有数据的槽或下一圈起点
+            const uint64_t pending = occupied_[0] >> slot;
+            if (pending == 0) {
+                const uint64_t next_round = (current_tick_ | (kSlotCount - 1)) + 1;
+                if (next_round > target_tick) {
+                    current_tick_ = target_tick + 1;
+                    return;
+                }
+                current_tick_ = next_round;
+                continue;
+            }
+            const uint32_t skip = static_cast<uint32_t>(__builtin_ctzll(pending));
+            if (skip != 0) {
+                if (current_tick_ + skip > target_tick) {
+                    current_tick_ = target_tick + 1;
+                    return;
+                }
+                current_tick_ += skip;
+                continue;
+            }
+
+            expire_slot(slot, on_expire);
+            ++current_tick_;
+        }
+    }
+
+    // 丢弃全部定时器并回收节点，保留已分配容量；之前发出的句柄全部失效
+    void clear() noexcept {
+        for (std::size_t i = 0; i < nodes_.size(); ++i) {
+            node& item = nodes_[i];
+            item.active = false;
+            item.prev = kNil;
+            item.next = i + 1 < nodes_.size() ? static_cast<uint32_t>(i + 1) : kNil;
+        }
+        free_head_ = nodes_.empty() ? kNil : 0;
+        for (auto& level : slots_) {
+            for (uint32_t& head : level) {
+                head = kNil;
+            }
+        }
+        for (uint64_t& bits : occupied_) {
+            bits = 0;
+        }
+        size_ = 0;
+        started_ = false;
+        expiring_ = false;
+    }
+
+    // 当前登记的定时器数量
+    std::size_t size() const noexcept { return size_; }
+
+    bool empty() const noexcept { return size_ == 0; }
+
+private:
+    static constexpr uint32_t kNil = UINT32_MAX;
+
+    struct node {
+        uint64_t deadline_tick = 0;
+        Payload payload{};
+        uint32_t prev = kNil;
+        uint32_t next = kNil;
+        uint32_t generation = 0;
+        uint8_t level = 0;
+        uint8_t slot = 0;
+        bool active = false;
+    };
+
+    // 按距当前 tick 的差值选择层级；超出最高层范围的定时器挂在最高层，级联时重新放置
+    void link(uint32_t index) noexcept {
+        node& item = nodes_[index];
+        const uint64_t delta = item.deadline_tick - current_tick_;
+        uint32_t level = 0;
+        while (level + 1 < kLevelCount && delta >= (uint64_t{1} << ((level + 1) * kSlotBits))) {
+            ++level;
+        }
+        uint64_t tick = item.deadline_tick;
+        if (level == kLevelCount - 1 && delta >= (uint64_t{1} << (kLevelCount * kSlotBits))) {
+            tick = current_tick_ + (uint64_t{1} << (kLevelCount * kSlotBits)) - 1;
+        }
+        const uint32_t slot = static_cast<uint32_t>((tick >> (level * kSlotBits)) & (kSlotCount - 1));
+
+        item.level = static_cast<uint8_t>(level);
+        item.slot = static_cast<uint8_t>(slot);
+        item.prev = kNil;
+        item.next = slots_[level][slot];
+        if (item.next != kNil) {
+            nodes_[item.next].prev = index;
+        }
+        slots_[level][slot] = index;
+        occupied_[level] |= uint64_t{1} << slot;
+    }
+
+    void unlink(uint32_t index) noexcept {
+        node& item = nodes_[index];
+        if (item.prev != kNil) {
+            nodes_[item.prev].next = item.next;
+        } else {
+            slots_[item.level][item.slot] = item.next;
+            if (item.next == kNil) {
+                occupied_[item.level] &= ~(uint64_t{1} << item.slot);
+            }
+        }
+        if (item.next != kNil) {
+            nodes_[item.next].prev = item.prev;
+        }
+    }
+
+    void release(uint32_t index) noexcept {
+        node& item = nodes_[index];
+        item.active = false;
+        item.prev = kNil;
+        item.next = free_head_;
+        free_head_ = index;
+        --size_;
+    }
+
+    // 当前 tick 跨越低层整圈时，把上层对应槽位的定时器重新放置到更低层
+    void cascade() noexcept {
+        for (uint32_t level = 1; level < kLevelCount; ++level) {
+            const uint32_t slot = static_cast<uint32_t>((current_tick_ >> (level * kSlotBits)) & (kSlotCount - 1));
+            uint32_t index = slots_[level][slot];
+            slots_[level][slot] = kNil;
+            occupied_[level] &= ~(uint64_t{1} << slot);
+            while (index != kNil) {
+                const uint32_t next = nodes_[index].next;
+                link(index);
+                index = next;
+            }
+            if (slot != 0) {
+                break;
+            }
+        }
+    }
+
+    // 逐个摘下并触发；回调中登记的已到期定时器顺延到下一个 tick，避免本轮重复触发
+    template <typename OnExpire>
+    void expire_slot(uint32_t slot, OnExpire& on_expire) {
+        expiring_ = true;
+        while (slots_[0][slot] != kNil) {
+            const uint32_t index = slots_[0][slot];
+            const Payload payload = nodes_[index].payload;
+            unlink(index);
+            release(index);
+            on_expire(payload);
+        }
+        expiring_ = false;
+    }
+
+    TimestampNs resolution_ns_;
+    uint64_t current_tick_ = 0;  // 下一个待处理的 tick
+    bool started_ = false;
+    bool expiring_ = false;
+    std::size_t size_ = 0;
+    uint32_t free_head_ = kNil;
+    std::vector<node> nodes_;
+    uint32_t slots_[kLevelCount][kSlotCount];
+    uint64_t occupied_[kLevelCount] = {};
+};
+
+}  // namespace acct_service
@@ -22,6 +22,9 @@ using AccountId = uint32_t;
 using StrategyId = uint16_t;
 using Sequence = uint64_t;
 using TimestampNs = uint64_t;  // Unix Epoch 纳秒时间戳
+using SecurityHandle = uint16_t;  // 持仓行句柄（positions_shm 行下标，0 表示未解析）
+
+inline constexpr SecurityHandle kInvalidSecurityHandle = 0;
 
 // ========== 枚举类型 ==========
 
@@ -37,6 +40,11 @@ enum class RiskResult : uint8_t {
     RejectSecurityNotAllowed = 7,
     RejectAccountFrozen = 8,
     RejectDuplicateOrder = 9,
+    RejectSelfTrade = 10,
+    RejectFirmLimit = 11,       // 跨账户公司级敞口 / 集中度超限
+    RejectOrderRatio = 12,      // 委托成交比 / 撤单率超限
+    RejectParentBudget = 13,    // 执行引擎子单超出父单预算（剩余量 / 委托金额）
+    RejectStrategyPaused = 14,  // 来源策略已被运维指令暂停
     RejectUnknown = 0xFF,
 };
 
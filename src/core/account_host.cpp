@@ -0,0 +1,334 @@
+#include "core/account_host.hpp"
+
+#include <sched.h>
+
+#include <algorithm>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <numeric>
+#include <unordered_set>
+
+#include "common/log.hpp"
+#include "core/config_manager.hpp"
+#include "core/config_reloader.hpp"
+
+namespace acct_service {
+
+namespace {
+
+constexpr char kHostInstanceName[] = "account_host";
+constexpr uint32_t kControlTickMs = 10;  // 重排线程检查停止条件的粒度
+
+std::atomic<AccountHost*> g_active_host{nullptr};
+
+void host_signal_handler(int signo) {
+    (void)signo;
+    AccountHost* host = g_active_host.load(std::memory_order_acquire);
+    if (host) {
+        host->stop();
+    }
+}
+
+void pin_current_thread(int core) {
+#if defined(__linux__)
+    if (core < 0) {
+        return;
+    }
+    cpu_set_t cpuset;
+    CPU_ZERO(&cpuset);
+    CPU_SET(core, &cpuset);
+    (void)sched_setaffinity(0, sizeof(cpu_set_t), &cpuset);
+#else
+    (void)core;
+#endif
+}
+
+}  // namespace
+
+account_placement plan_account_placement(const std::vector<double>& busy_ratios, std::size_t worker_count,
+                                         double dedicated_busy_ratio) {
+    const std::size_t account_count = busy_ratios.size();
+    account_placement placement;
+    placement.worker_of.assign(account_count, 0);
+    worker_count = std::max<std::size_t>(worker_count, 1);
+
+    std::vector<std::size_t> order(account_count);
+    std::iota(order.begin(), order.end(), std::size_t{0});
+    std::stable_sort(order.begin(), order.end(),
+                     [&busy_ratios](std::size_t lhs, std::size_t rhs) { return busy_ratios[lhs] > busy_ratios[rhs]; });
+
+    // 忙账户各占一个 worker；后面还有账户时必须留下至少一个共享 worker
+    std::size_t dedicated = 0;
+    for (const std::size_t index : order) {
+        if (busy_ratios[index] < dedicated_busy_ratio) {
+            break;
+        }
+        const bool accounts_left = account_count - dedicated - 1 > 0;
+        const bool workers_left = worker_count - dedicated - 1 > 0;
+        if (!workers_left && (accounts_left || dedicated == 0)) {
+            break;
+        }
+        placement.worker_of[index] = static_cast<uint32_t>(dedicated);
+        ++dedicated;
+    }
+    placement.dedicated_workers = dedicated;
+
+    const std::size_t shared_begin = std::min(dedicated, worker_count - 1);
+    std::vector<double> loads(worker_count, 0.0);
+    std::vector<std::size_t> counts(worker_count, 0);
+    for (std::size_t rank = dedicated; rank < account_count; ++rank) {
+        const std::size_t index = order[rank];
+        std::size_t target = shared_begin;
+        for (std::size_t worker = shared_begin + 1; worker < worker_count; ++worker) {
+            if (loads[worker] < loads[target] || (loads[worker] == loads[target] && counts[worker] < counts[target])) {
+                target = worker;
+            }
+        }
+        loads[target] += busy_ratios[index];
+        ++counts[target];
+        placement.worker_of[index] = static_cast<uint32_t>(target);
+    }
+    return placement;
+}
+
+AccountHost::AccountHost() = default;
+
+AccountHost::~AccountHost() {
+    stop();
+    for (auto& worker : workers_) {
+        if (worker->thread.joinable()) {
+            worker->thread.join();
+        }
+    }
+    cleanup();
+}
+
+bool AccountHost::initialize(const std::vector<std::string>& config_paths, const account_host_options& options) {
+    clear_shutdown_reason();
+    clear_last_error();
+    cleanup();
+
+    if (config_paths.empty()) {
+        return fail(ErrorCode::InvalidConfig, "account host requires at least one config");
+    }
+    options_ = options;
+    if (options_.worker_cores.empty()) {
+        options_.worker_cores.push_back(-1);
+    }
+    if (options_.rebalance_interval_ms == 0) {
+        return fail(ErrorCode::InvalidConfig, "account host rebalance_interval_ms must be positive");
+    }
+
+    // 日志器全进程一份：按第一个账户的 log 配置以宿主实例名初始化
+    ConfigManager first_config;
+    if (!first_config.load_from_file(config_paths.front())) {
+        return fail(ErrorCode::ConfigParseFailed, "failed to load first account config");
+    }
+    if (!init_logger(first_config.log(), first_config.account_id(), kHostInstanceName)) {
+        return fail(ErrorCode::LoggerInitFailed, "failed to initialize host logger");
+    }
+    logger_owned_ = true;
+
+    std::unordered_set<AccountId> account_ids;
+    accounts_.reserve(config_paths.size());
+    for (const std::string& path : config_paths) {
+        auto slot = std::make_unique<hosted_account>();
+        slot->service = std::make_unique<AccountService>(service_hosting::Hosted);
+        if (!slot->service->initialize(path)) {
+            last_error_ = slot->service->last_error();
+            cleanup();
+            return false;
+        }
+        if (!account_ids.insert(slot->service->config().account_id()).second) {
+            (void)fail(ErrorCode::ConfigValidateFailed, "duplicated account_id in hosted configs");
+            cleanup();
+            return false;
+        }
+        accounts_.push_back(std::move(slot));
+    }
+
+    workers_.reserve(options_.worker_cores.size());
+    for (const int core : options_.worker_cores) {
+        auto worker = std::make_unique<host_worker>();
+        worker->core = core;
+        workers_.push_back(std::move(worker));
+    }
+
+    // 启动时尚无忙时数据，先按账户数均摊到各 worker
+    rebalance(0);
+    return true;
+}
+
+int AccountHost::run() {
+    if (accounts_.empty() || workers_.empty()) {
+        (void)fail(ErrorCode::ComponentUnavailable, "account host not initialized");
+        return -1;
+    }
+    bool expected = false;
+    if (!running_.compare_exchange_strong(expected, true, std::memory_order_acq_rel)) {
+        (void)fail(ErrorCode::InvalidState, "account host already running");
+        return -1;
+    }
+
+    std::size_t started = 0;
+    for (; started < accounts_.size(); ++started) {
+        if (!accounts_[started]->service->start_hosted()) {
+            last_error_ = accounts_[started]->service->last_error();
+            running_.store(false, std::memory_order_release);
+            break;
+        }
+    }
+
+    if (running_.load(std::memory_order_acquire)) {
+        setup_signal_handlers();
+        g_active_host.store(this, std::memory_order_release);
+
+        for (uint32_t worker_id = 0; worker_id < workers_.size(); ++worker_id) {
+            workers_[worker_id]->thread = std::thread([this, worker_id]() { worker_main(worker_id); });
+        }
+
+        const uint64_t interval_ns = static_cast<uint64_t>(options_.rebalance_interval_ms) * 1000000ULL;
+        TimestampNs last_rebalance = now_monotonic_ns();
+        while (running_.load(std::memory_order_acquire)) {
+            std::this_thread::sleep_for(
+                std::chrono::milliseconds(std::min(kControlTickMs, options_.rebalance_interval_ms)));
+            if (should_stop_service() || !any_account_polling()) {
+                break;
+            }
+            const TimestampNs now = now_monotonic_ns();
+            if (now - last_rebalance >= interval_ns) {
+                rebalance(now - last_rebalance);
+                last_rebalance = now;
+            }
+        }
+
+        running_.store(false, std::memory_order_release);
+        for (auto& worker : workers_) {
+            if (worker->thread.joinable()) {
+                worker->thread.join();
+            }
+        }
+        AccountHost* active = this;
+        g_active_host.compare_exchange_strong(active, nullptr, std::memory_order_release, std::memory_order_relaxed);
+    }
+
+    // worker 已全部退出，收尾在调用线程上串行执行
+    int rc = started == accounts_.size() ? 0 : -1;
+    for (std::size_t index = 0; index < started; ++index) {
+        if (accounts_[index]->service->finish_hosted() != 0) {
+            rc = -1;
+        }
+    }
+    return rc;
+}
+
+void AccountHost::stop() noexcept { running_.store(false, std::memory_order_release); }
+
+uint32_t AccountHost::worker_of(std::size_t index) const noexcept {
+    return accounts_[index]->worker.load(std::memory_order_acquire);
+}
+
+// 每轮按顺序调度分配给本 worker 的账户；重排后旧 worker 可能仍在调度该账户，polling 失败时本轮跳过
+void AccountHost::worker_main(uint32_t worker_id) {
+    host_worker& self = *workers_[worker_id];
+    pin_current_thread(self.core);
+
+    while (running_.load(std::memory_order_acquire)) {
+        bool any_work = false;
+        for (auto& slot : accounts_) {
+            if (slot->worker.load(std::memory_order_acquire) != worker_id ||
+                slot->polling.exchange(true, std::memory_order_acquire)) {
+                continue;
+            }
+            const TimestampNs start = now_monotonic_ns();
+            if (slot->service->poll_once() != 0) {
+                slot->busy_ns.fetch_add(now_monotonic_ns() - start, std::memory_order_relaxed);
+                any_work = true;
+            }
+            slot->polling.store(false, std::memory_order_release);
+        }
+
+        if (any_work || self.dedicated.load(std::memory_order_relaxed)) {
+            continue;
+        }
+        if (options_.shared_idle_sleep_us > 0) {
+            std::this_thread::sleep_for(std::chrono::microseconds(options_.shared_idle_sleep_us));
+        } else {
+            std::this_thread::yield();
+        }
+    }
+}
+
+void AccountHost::rebalance(uint64_t elapsed_ns) {
+    std::vector<double> busy_ratios(accounts_.size(), 0.0);
+    for (std::size_t index = 0; index < accounts_.size(); ++index) {
+        hosted_account& slot = *accounts_[index];
+        const uint64_t busy_ns = slot.busy_ns.load(std::memory_order_relaxed);
+        if (elapsed_ns > 0) {
+            busy_ratios[index] = static_cast<double>(busy_ns - slot.last_busy_ns) / static_cast<double>(elapsed_ns);
+        }
+        slot.last_busy_ns = busy_ns;
+    }
+
+    const account_placement placement =
+        plan_account_placement(busy_ratios, workers_.size(), options_.dedicated_busy_ratio);
+    for (std::size_t worker = 0; worker < workers_.size(); ++worker) {
+        workers_[worker]->dedicated.store(worker < placement.dedicated_workers, std::memory_order_relaxed);
+    }
+    for (std::size_t index = 0; index < accounts_.size(); ++index) {
+        hosted_account& slot = *accounts_[index];
+        const uint32_t previous = slot.worker.exchange(placement.worker_of[index], std::memory_order_acq_rel);
+        if (previous != placement.worker_of[index]) {
+            ACCT_LOG_INFO("AccountHost", "account " + std::to_string(slot.service->config().account_id()) +
+                                             " moved to worker " + std::to_string(placement.worker_of[index]));
+        }
+    }
+    dedicated_workers_.store(placement.dedicated_workers, std::memory_order_release);
+}
+
+bool AccountHost::any_account_polling() const noexcept {
+    return std::any_of(accounts_.begin(), accounts_.end(),
+                       [](const std::unique_ptr<hosted_account>& slot) { return slot->service->is_polling(); });
+}
+
+void AccountHost::setup_signal_handlers() {
+    struct sigaction sa {};
+    sa.sa_handler = host_signal_handler;
+    sigemptyset(&sa.sa_mask);
+    sa.sa_flags = 0;
+
+    sigaction(SIGINT, &sa, nullptr);
+    sigaction(SIGTERM, &sa, nullptr);
+    install_config_reload_signal_handler();
+}
+
+void AccountHost::print_stats() const {
+    for (std::size_t index = 0; index < accounts_.size(); ++index) {
+        const hosted_account& slot = *accounts_[index];
+        std::fprintf(stderr, "[AccountHost] account=%u worker=%u busy_ms=%.1f\n",
+                     static_cast<unsigned>(slot.service->config().account_id()),
+                     static_cast<unsigned>(slot.worker.load(std::memory_order_acquire)),
+                     static_cast<double>(slot.busy_ns.load(std::memory_order_relaxed)) / 1e6);
+        slot.service->print_stats();
+    }
+}
+
+void AccountHost::cleanup() {
+    accounts_.clear();
+    workers_.clear();
+    dedicated_workers_.store(0, std::memory_order_release);
+    if (logger_owned_) {
+        shutdown_logger();
+        logger_owned_ = false;
+    }
+}
+
+bool AccountHost::fail(ErrorCode code, std::string_view message) {
+    last_error_ = ACCT_MAKE_ERROR(ErrorDomain::core, code, "AccountHost", message, 0);
+    record_error(last_error_);
+    ACCT_LOG_ERROR_STATUS(last_error_);
+    return false;
+}
+
+}  // namespace acct_service
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "common/error.hpp"
+#include "core/account_service.hpp"
+
+namespace acct_service {
+
+// 多账户托管选项
+struct account_host_options {
+    std::vector<int> worker_cores{};     // 每个元素一个 worker 线程并绑到该核（-1 不绑核）；为空时单 worker 不绑核
+    uint32_t rebalance_interval_ms = 1000;  // 按忙时重排账户的周期
+    double dedicated_busy_ratio = 0.3;      // 单周期忙时占比不低于该值的账户独占一个 worker
+    uint32_t shared_idle_sleep_us = 50;     // 共享 worker 整轮无事可做时的休眠；独占 worker 始终忙轮询
+};
+
+// 账户到 worker 的分配结果：[0, dedicated_workers) 为独占 worker，各承载一个忙账户
+struct account_placement {
+    std::vector<uint32_t> worker_of{};  // 账户下标 -> worker 下标
+    std::size_t dedicated_workers = 0;
+};
+
+// 按忙时占比规划分配：忙账户从高到低各占一个 worker，且至少保留一个共享 worker 承载其余账户；
+// 其余账户按忙时贪心放到负载最轻的共享 worker（同负载时取账户数少的），worker_count 为 0 时视为 1
+account_placement plan_account_placement(const std::vector<double>& busy_ratios, std::size_t worker_count,
+                                         double dedicated_busy_ratio);
+
+// 单进程托管多个账户：每个账户仍是独立的 AccountService（风控、持仓、订单簿、SHM 各自隔离），
+// 事件循环由宿主的 M 个 worker 线程轮流调度，日志器进程内只初始化一次
+class AccountHost {
+public:
+    AccountHost();
+    ~AccountHost();
+
+    AccountHost(const AccountHost&) = delete;
+    AccountHost& operator=(const AccountHost&) = delete;
+
+    // 按配置文件逐个初始化账户；日志按第一个配置初始化，account_id 重复时失败
+    bool initialize(const std::vector<std::string>& config_paths, const account_host_options& options);
+
+    // 启动全部 worker 并在调用线程上周期性重排（阻塞），直到 stop() 或全部账户停止
+    int run();
+
+    // 请求停止（可在信号处理或其他线程调用）
+    void stop() noexcept;
+
+    std::size_t account_count() const noexcept { return accounts_.size(); }
+    const AccountService& account(std::size_t index) const { return *accounts_[index]->service; }
+    // 账户当前所在 worker
+    uint32_t worker_of(std::size_t index) const noexcept;
+    // 当前独占 worker 数量
+    std::size_t dedicated_workers() const noexcept { return dedicated_workers_.load(std::memory_order_acquire); }
+
+    void print_stats() const;
+    const ErrorStatus& last_error() const noexcept { return last_error_; }
+
+private:
+    // 托管账户槽位：worker 只调度 worker 字段等于自身的账户，polling 保证重排交接期间不会被两个 worker 同时调度
+    struct alignas(64) hosted_account {
+        std::unique_ptr<AccountService> service;
+        std::atomic<uint32_t> worker{0};
+        std::atomic<bool> polling{false};
+        std::atomic<uint64_t> busy_ns{0};  // 有输入的轮次累计耗时，只由当前调度 worker 累加
+        uint64_t last_busy_ns = 0;         // 上次重排时的 busy_ns，仅重排线程使用
+    };
+
+    struct host_worker {
+        int core = -1;
+        std::atomic<bool> dedicated{false};
+        std::thread thread{};
+    };
+
+    void worker_main(uint32_t worker_id);
+    // 按上个周期的忙时占比重新分配账户
+    void rebalance(uint64_t elapsed_ns);
+    bool any_account_polling() const noexcept;
+    void setup_signal_handlers();
+    void cleanup();
+    bool fail(ErrorCode code, std::string_view message);
+
+    account_host_options options_{};
+    std::vector<std::unique_ptr<hosted_account>> accounts_{};
+    std::vector<std::unique_ptr<host_worker>> workers_{};
+    std::atomic<bool> running_{false};
+    std::atomic<std::size_t> dedicated_workers_{0};
+    bool logger_owned_ = false;
+    ErrorStatus last_error_{};
+};
+
+}  // namespace acct_service
@@ -1,11 +1,24 @@
 #include "core/account_service.hpp"
 
 #include <cassert>
+#include <cstddef>
 #include <cstdio>
 #include <string>
+#include <vector>
 
+#include "colocated_gateway.hpp"
+#include "common/huge_page_arena.hpp"
 #include "common/log.hpp"
+#include "common/thread_setup.hpp"
+#include "core/startup_warmup.hpp"
+#include "order/order_journal.hpp"
+#include "portfolio/position_loader.hpp"
+#include "portfolio/security_master.hpp"
+#include "shm/admin_shm.hpp"
+#include "shm/orders_index_shm.hpp"
+#include "shm/risk_params_shm.hpp"
 #include "shm/orders_shm.hpp"
+#include "shm/upstream_lanes.hpp"
 #include "strategy/active_strategy.hpp"
 
 namespace acct_service {
@@ -16,6 +29,26 @@ ErrorStatus make_service_error(ErrorCode code, std::string_view message, int sys
     return ACCT_MAKE_ERROR(ErrorDomain::core, code, "AccountService", message, sys_errno);
 }
 
+// 启动完成后列出进程内大数组的预留量、页类型与已落页量，便于核对大页是否生效
+void log_arena_footprint() {
+    huge_page_arena& arena = huge_page_arena::instance();
+    arena.for_each_region([](const arena_region_info& region) {
+        ACCT_LOG_INFO("AccountService", std::string("arena region ") + region.tag +
+                                            " bytes=" + std::to_string(region.bytes) +
+                                            " resident=" + std::to_string(region.resident_bytes) +
+                                            " backing=" + arena_backing_name(region.backing));
+    });
+    const arena_footprint total = arena.footprint();
+    ACCT_LOG_INFO("AccountService", "arena footprint regions=" + std::to_string(total.regions) +
+                                        " reserved=" + std::to_string(total.reserved_bytes) +
+                                        " hugetlb=" + std::to_string(total.explicit_bytes) +
+                                        " transparent=" + std::to_string(total.transparent_bytes) +
+                                        " small_pages=" + std::to_string(total.small_page_bytes) +
+                                        " heap=" + std::to_string(total.heap_bytes) +
+                                        " resident=" + std::to_string(total.resident_bytes) +
+                                        " hugetlb_fallbacks=" + std::to_string(total.explicit_fallbacks));
+}
+
 }  // namespace
 
 bool should_log_startup_config() noexcept {
@@ -26,12 +59,14 @@ bool should_log_startup_config() noexcept {
 #endif
 }
 
-AccountService::AccountService() = default;
+AccountService::AccountService(service_hosting hosting) : hosting_(hosting) {}
 
 AccountService::~AccountService() {
     stop();
     cleanup();
-    shutdown_logger();
+    if (hosting_ == service_hosting::Standalone) {
+        shutdown_logger();
+    }
     state_.store(ServiceState::Stopped, std::memory_order_release);
 }
 
@@ -48,8 +83,9 @@ bool AccountService::initialize(const std::string& config_path) {
 
     state_.store(ServiceState::Initializing, std::memory_order_release);
     cleanup();
+    startup_report_.begin();
 
-    if (!init_config(config_path)) {
+    if (!startup_report_.run("config", [&]() { return init_config(config_path); })) {
         state_.store(ServiceState::Error, std::memory_order_release);
         cleanup();
         return false;
@@ -57,40 +93,236 @@ bool AccountService::initialize(const std::string& config_path) {
 
     print_loaded_config();
 
-    if (!init_logger(config_manager_.log(), config_manager_.account_id())) {
+    // 托管模式下多个账户共用宿主初始化的日志器，重复 init 会关闭其他账户正在写的日志
+    if (hosting_ == service_hosting::Standalone &&
+        !startup_report_.run("logger", [&]() { return init_logger(config_manager_.log(), config_manager_.account_id()); })) {
         raise_service_error(make_service_error(ErrorCode::LoggerInitFailed, "failed to initialize logger"));
         state_.store(ServiceState::Error, std::memory_order_release);
         cleanup();
         return false;
     }
 
-    if (!init_order_event_recorder() || !init_shared_memory() || !init_portfolio() || !init_risk_manager() ||
-        !init_order_components() || !init_market_data() || !init_execution_engine() || !init_event_loop()) {
+    // 订单簿、成交/委托记录池与执行会话池在后续阶段经进程级 arena 映射，须先定好是否取 hugetlb 预留页
+    huge_page_arena::instance().set_explicit_huge_pages(config_manager_.shm().hugetlb_arena);
+
+    // 互不依赖的阶段并发执行：业务日志文件、共享内存映射（含预取）与行情 reader 接入一组；
+    // 持仓/流水加载与订单恢复只依赖各自的共享内存段，映射完成后再并发一组。其余阶段有先后依赖，保持串行
+    const startup_task attach_tasks[] = {
+        {"shared_memory", [this]() { return init_shared_memory(); }},
+        {"order_event_recorder", [this]() { return init_order_event_recorder(); }},
+        {"market_data", [this]() { return init_market_data(); }},
+    };
+    const startup_task recover_tasks[] = {
+        {"portfolio", [this]() { return init_portfolio(); }},
+        {"order_recovery", [this]() { return init_order_components(); }},
+    };
+    const bool ok = startup_report_.run_parallel("attach", attach_tasks) &&
+                    startup_report_.run_parallel("recover", recover_tasks) &&
+                    startup_report_.run("risk_manager", [this]() { return init_risk_manager(); }) &&
+                    startup_report_.run("execution_engine", [this]() { return init_execution_engine(); }) &&
+                    startup_report_.run("event_loop", [this]() { return init_event_loop(); }) &&
+                    startup_report_.run("in_process_gateway", [this]() { return init_in_process_gateway(); }) &&
+                    startup_report_.run("warmup", [this]() { return run_warmup(); });
+    if (!ok) {
+        startup_report_.finish(false);
+        startup_report_.log("AccountService");
         state_.store(ServiceState::Error, std::memory_order_release);
         flush_logger(200);
         cleanup();
         return false;
     }
 
+    // 各段映射完成后再锁页：MCL_CURRENT 覆盖已映射的共享内存，RLIMIT_MEMLOCK 不足时只告警，不影响映射本身
+    if (config_manager_.EventLoop().lock_memory) {
+        (void)startup_report_.run("lock_memory", []() { return lock_process_memory(); });
+    }
+
+    startup_report_.finish(true);
+    startup_report_.log("AccountService");
+    log_arena_footprint();
+    register_memory_components();
     state_.store(ServiceState::Ready, std::memory_order_release);
     return true;
 }
 
+// 组件按登记顺序输出；共享内存段只登记随日内条目增长的订单段与持仓段，其余段定长且已在启动日志中给出
+void AccountService::register_memory_components() {
+    memory_accounting_ = memory_accounting{};
+    memory_accounting_.add(
+        "order_book.orders",
+        [](const void* context) noexcept {
+            return static_cast<const AccountService*>(context)->order_book_->storage_memory();
+        },
+        this);
+    memory_accounting_.add(
+        "order_book.index",
+        [](const void* context) noexcept {
+            return static_cast<const AccountService*>(context)->order_book_->index_memory();
+        },
+        this);
+    memory_accounting_.add(
+        "trade_records",
+        [](const void* context) noexcept {
+            return static_cast<const AccountService*>(context)->trade_records_->memory();
+        },
+        this);
+    memory_accounting_.add(
+        "entrust_records",
+        [](const void* context) noexcept {
+            return static_cast<const AccountService*>(context)->entrust_records_->memory();
+        },
+        this);
+    memory_accounting_.add(
+        "execution.sessions",
+        [](const void* context) noexcept {
+            return static_cast<const AccountService*>(context)->execution_engine_->memory();
+        },
+        this);
+    if (order_event_recorder_) {
+        memory_accounting_.add(
+            "order_event_recorder",
+            [](const void* context) noexcept {
+                return static_cast<const AccountService*>(context)->order_event_recorder_->memory();
+            },
+            this);
+    }
+    if (flight_recorder_) {
+        memory_accounting_.add(
+            "flight_recorder",
+            [](const void* context) noexcept {
+                return static_cast<const AccountService*>(context)->flight_recorder_->memory();
+            },
+            this);
+    }
+    memory_accounting_.add("logger", [](const void*) noexcept { return logger_memory_usage(); }, nullptr);
+    memory_accounting_.add(
+        "shm.orders",
+        [](const void* context) noexcept {
+            const auto* self = static_cast<const AccountService*>(context);
+            const std::size_t next = self->orders_shm_->header.next_index.load(std::memory_order_relaxed);
+            const std::size_t mapped = self->orders_shm_manager_.mapped_bytes();
+            const std::size_t used = orders_shm_size(next);
+            return memory_usage{mapped, used < mapped ? used : mapped};
+        },
+        this);
+    memory_accounting_.add(
+        "shm.positions",
+        [](const void* context) noexcept {
+            const auto* self = static_cast<const AccountService*>(context);
+            const std::size_t rows = self->positions_shm_->position_count.load(std::memory_order_relaxed) +
+                                     kFirstSecurityPositionIndex;
+            constexpr std::size_t kHeaderBytes = offsetof(positions_shm_layout, positions);
+            memory_usage usage = element_memory(kMaxPositions, rows, sizeof(position));
+            usage += memory_usage{kHeaderBytes, kHeaderBytes};
+            return usage;
+        },
+        this);
+
+    memory_accounting_.log("AccountService");
+    if (stats_shm_) {
+        metrics_registry registry(&stats_shm_->metrics);
+        memory_accounting_.bind_metrics(registry);
+    }
+    event_loop_->set_memory_accounting(&memory_accounting_);
+}
+
 int AccountService::run() {
+    if (!enter_running()) {
+        return -1;
+    }
+    install_config_reload_signal_handler();
+    event_loop_->run();
+    stop_in_process_gateway();
+    return leave_running();
+}
+
+bool AccountService::start_hosted() {
+    if (!enter_running()) {
+        return false;
+    }
+    if (!event_loop_->start()) {
+        config_reloader_.stop();
+        orders_roller_.stop();
+        stop_in_process_gateway();
+        raise_service_error(make_service_error(ErrorCode::InvalidState, "event loop already running"));
+        state_.store(ServiceState::Error, std::memory_order_release);
+        return false;
+    }
+    return true;
+}
+
+std::size_t AccountService::poll_once() { return event_loop_ ? event_loop_->run_once() : 0; }
+
+bool AccountService::is_polling() const noexcept { return event_loop_ && event_loop_->is_running(); }
+
+int AccountService::finish_hosted() {
     if (!event_loop_) {
-        raise_service_error(make_service_error(ErrorCode::ComponentUnavailable, "event loop not initialized"));
         return -1;
     }
+    event_loop_->finish();
+    stop_in_process_gateway();
+    return leave_running();
+}
+
+bool AccountService::enter_running() {
+    if (!event_loop_) {
+        raise_service_error(make_service_error(ErrorCode::ComponentUnavailable, "event loop not initialized"));
+        return false;
+    }
 
     const ServiceState current = state();
     if (current != ServiceState::Ready && current != ServiceState::Stopped) {
         raise_service_error(make_service_error(ErrorCode::InvalidState, "run called in invalid state"));
-        return -1;
+        return false;
+    }
+    if (!start_in_process_gateway()) {
+        return false;
+    }
+    const std::string current_day =
+        orders_roller_.trading_day().empty() ? config_manager_.get().trading_day : orders_roller_.trading_day();
+    const SHMConfig& shm_cfg = config_manager_.shm();
+    orders_roller_.set_overflow_segments(shm_cfg.orders_overflow_segments);
+    if (orders_roller_.start(shm_cfg.orders_shm_name, current_day, shm_cfg.orders_capacity,
+                             config_manager_.account_id(), map_options_, *event_loop_) &&
+        !shm_cfg.next_trading_day.empty()) {
+        (void)orders_roller_.prepare(shm_cfg.next_trading_day);
     }
+    (void)config_reloader_.start(config_manager_.config_path(), *event_loop_, &orders_roller_);
 
     state_.store(ServiceState::Running, std::memory_order_release);
-    event_loop_->run();
+    return true;
+}
 
+bool AccountService::start_in_process_gateway() {
+    if (!in_process_gateway_) {
+        return true;
+    }
+    const bool inline_poll = config_manager_.gateway().inline_poll;
+    if (!in_process_gateway_->start(inline_poll)) {
+        raise_service_error(make_service_error(ErrorCode::ComponentUnavailable, "failed to start in-process gateway"));
+        return false;
+    }
+    // 内联模式由事件循环线程在处理回报前执行一轮网关，订单无需跨线程交接
+    event_loop_->set_inline_stage(inline_poll ? loop_stage_hook::bind<gateway::colocated_gateway,
+                                                                      &gateway::colocated_gateway::poll_once>(
+                                                    in_process_gateway_.get())
+                                              : loop_stage_hook{});
+    return true;
+}
+
+void AccountService::stop_in_process_gateway() noexcept {
+    if (!in_process_gateway_) {
+        return;
+    }
+    if (event_loop_) {
+        event_loop_->set_inline_stage({});
+    }
+    in_process_gateway_->stop();
+}
+
+int AccountService::leave_running() {
+    config_reloader_.stop();
+    orders_roller_.stop();
     if (should_terminate_due_to_error() || should_stop_service()) {
         stop();
         state_.store(ServiceState::Error, std::memory_order_release);
@@ -117,12 +349,38 @@ void AccountService::stop() {
     }
 }
 
+void AccountService::request_config_reload() noexcept {
+    if (state() == ServiceState::Running) {
+        config_reloader_.request_reload();
+    }
+}
+
+bool AccountService::prepare_trading_day(const std::string& trading_day) {
+    return state() == ServiceState::Running && orders_roller_.prepare(trading_day);
+}
+
+bool AccountService::request_trading_day_rollover(const std::string& trading_day) {
+    return state() == ServiceState::Running && orders_roller_.request_rollover(trading_day);
+}
+
+bool AccountService::promote_standby() {
+    if (!replication_receiver_ || !event_loop_) {
+        return false;
+    }
+    // 先停接收，收件环里已有的记录由事件循环在提升前全部重放
+    replication_receiver_->stop();
+    event_loop_->request_promotion();
+    return true;
+}
+
 bool AccountService::has_fatal_error() const noexcept {
     return shutdown_reason_.load(std::memory_order_acquire) == ErrorSeverity::Fatal;
 }
 
 const ErrorStatus& AccountService::last_error() const noexcept { return last_error_; }
 
+const startup_report& AccountService::last_startup_report() const noexcept { return startup_report_; }
+
 ServiceState AccountService::state() const noexcept { return state_.load(std::memory_order_acquire); }
 
 const ConfigManager& AccountService::config() const { return config_manager_; }
@@ -157,7 +415,7 @@ void AccountService::print_stats() const {
     }
 
     if (risk_manager_) {
-        const RiskState& stats = risk_manager_->stats();
+        const RiskState stats = risk_manager_->stats();
         std::fprintf(stderr, "[AccountService] risk_checks=%llu passed=%llu rejected=%llu\n",
                      static_cast<unsigned long long>(stats.total_checks), static_cast<unsigned long long>(stats.passed),
                      static_cast<unsigned long long>(stats.rejected));
@@ -199,37 +457,145 @@ bool AccountService::init_shared_memory() {
     const AccountId account_id = config_manager_.account_id();
     const shm_mode mode = shm_cfg.create_if_not_exist ? shm_mode::OpenOrCreate : shm_mode::Open;
 
-    upstream_shm_ = upstream_shm_manager_.open_upstream(shm_cfg.upstream_shm_name, mode, account_id);
+    // 映射页面就近落在事件循环绑核所在节点，未显式指定节点时由 cpu_core 推导
+    shm::ShmMapOptions map_options;
+    map_options.huge_pages = shm_cfg.huge_pages;
+    map_options.prefault = shm_cfg.prefault;
+    map_options.numa_node = shm_cfg.numa_node;
+    if (map_options.numa_node < 0 && cfg.EventLoop.pin_cpu) {
+        map_options.numa_node = shm::numa_node_of_cpu(cfg.EventLoop.cpu_core);
+    }
+    for (SHMManager* manager : {&upstream_shm_manager_, &downstream_shm_manager_, &trades_shm_manager_,
+                                &orders_shm_manager_, &positions_shm_manager_, &stats_shm_manager_}) {
+        manager->set_map_options(map_options);
+    }
+    map_options_ = map_options;
+
+    // 五个主段各由独立的 SHMManager 映射，并发打开以重叠页面预取；全部结束后按原顺序检查并上报
+    const std::string dated_orders_name = make_orders_shm_name(shm_cfg.orders_shm_name, cfg.trading_day);
+    const startup_task segment_tasks[] = {
+        {"shm.upstream",
+         [&]() {
+             upstream_shm_ = upstream_shm_manager_.open_upstream(shm_cfg.upstream_shm_name, mode, account_id);
+             return upstream_shm_ != nullptr;
+         }},
+        {"shm.downstream",
+         [&]() {
+             downstream_shm_ = downstream_shm_manager_.open_downstream(shm_cfg.downstream_shm_name, mode, account_id);
+             return downstream_shm_ != nullptr;
+         }},
+        {"shm.trades",
+         [&]() {
+             trades_shm_ = trades_shm_manager_.open_trades(shm_cfg.trades_shm_name, mode, account_id);
+             return trades_shm_ != nullptr;
+         }},
+        {"shm.orders",
+         [&]() {
+             orders_shm_ =
+                 orders_shm_manager_.open_orders(dated_orders_name, mode, account_id, shm_cfg.orders_capacity);
+             return orders_shm_ != nullptr;
+         }},
+        {"shm.positions",
+         [&]() {
+             positions_shm_ = positions_shm_manager_.open_positions(shm_cfg.positions_shm_name, mode, account_id);
+             return positions_shm_ != nullptr;
+         }},
+    };
+    (void)startup_report_.run_parallel("shared_memory", segment_tasks);
+
     if (!upstream_shm_) {
         raise_service_error(make_service_error(ErrorCode::ShmOpenFailed, "failed to open upstream shm"));
         return false;
     }
+    // 账户服务是 lane 数的唯一写入方，策略进程在 acct_init_ex 中按此认领 lane
+    upstream_set_lane_count(upstream_shm_, shm_cfg.upstream_lane_count);
+    upstream_set_inline_orders(upstream_shm_, shm_cfg.upstream_inline_orders);
 
-    downstream_shm_ = downstream_shm_manager_.open_downstream(shm_cfg.downstream_shm_name, mode, account_id);
     if (!downstream_shm_) {
         raise_service_error(make_service_error(ErrorCode::ShmOpenFailed, "failed to open downstream shm"));
         return false;
     }
-
-    trades_shm_ = trades_shm_manager_.open_trades(shm_cfg.trades_shm_name, mode, account_id);
     if (!trades_shm_) {
         raise_service_error(make_service_error(ErrorCode::ShmOpenFailed, "failed to open trades shm"));
         return false;
     }
-
-    const std::string dated_orders_name = make_orders_shm_name(shm_cfg.orders_shm_name, cfg.trading_day);
-    orders_shm_ = orders_shm_manager_.open_orders(dated_orders_name, mode, account_id);
     if (!orders_shm_) {
         raise_service_error(make_service_error(ErrorCode::ShmOpenFailed, "failed to open orders shm"));
         return false;
     }
-
-    positions_shm_ = positions_shm_manager_.open_positions(shm_cfg.positions_shm_name, mode, account_id);
     if (!positions_shm_) {
         raise_service_error(make_service_error(ErrorCode::ShmOpenFailed, "failed to open positions shm"));
         return false;
     }
 
+    // 统计段仅用于监控，打开失败时降级为进程内直方图，不阻断启动
+    if (!shm_cfg.stats_shm_name.empty()) {
+        stats_shm_ = stats_shm_manager_.open_stats(shm_cfg.stats_shm_name, shm_mode::OpenOrCreate, account_id);
+        if (!stats_shm_) {
+            ACCT_LOG_WARN("AccountService", "failed to open stats shm, stage latency stays process-local");
+        } else {
+            stats_shm_->stages.reset();
+            stats_shm_->risk.reset();
+            stats_shm_->metrics.reset();
+            stats_shm_->brokers.reset();
+        }
+    }
+
+    // 跨账户合计段由聚合进程创建，账户侧只在配置了公司级限额时打开、不创建；缺失时公司级规则放行
+    const RiskConfig& risk_cfg = config_manager_.risk();
+    if (!shm_cfg.firm_risk_shm_name.empty() &&
+        (risk_cfg.max_firm_gross_value > 0 || risk_cfg.max_firm_security_volume > 0)) {
+        firm_risk_shm_ = firm_risk_shm_manager_.open_firm_risk(shm_cfg.firm_risk_shm_name, shm_mode::Open, account_id);
+        if (!firm_risk_shm_) {
+            ACCT_LOG_WARN("AccountService", "firm risk shm unavailable, firm-level limits stay inactive");
+        }
+    }
+
+    // 订单池二级索引随订单池跨重启保留；段属于其他交易日或上次重置中途退出时整段重置
+    if (shm_cfg.orders_index) {
+        const std::string index_name = make_orders_index_shm_name(shm_cfg.orders_shm_name);
+        orders_index_shm_ = orders_index_shm_manager_.open_orders_index(index_name, shm_mode::OpenOrCreate, account_id);
+        if (!orders_index_shm_) {
+            ACCT_LOG_WARN("AccountService", "orders index shm unavailable, monitor queries fall back to scans");
+        } else {
+            const uint32_t day = trading_day_number(cfg.trading_day);
+            if (orders_index_shm_->trading_day.load(std::memory_order_acquire) != day ||
+                (orders_index_shm_->generation.load(std::memory_order_acquire) & 1ULL) != 0) {
+                orders_index_reset(orders_index_shm_, day);
+            }
+        }
+    }
+
+    // 风控参数段随上游段命名，由风控管理器接入后发布；打开失败只是策略侧少了本地预检
+    if (shm_cfg.risk_params) {
+        const std::string risk_params_name = make_risk_params_shm_name(shm_cfg.upstream_shm_name);
+        risk_params_shm_ = risk_params_shm_manager_.open_risk_params(risk_params_name, shm_mode::OpenOrCreate, account_id);
+        if (!risk_params_shm_) {
+            ACCT_LOG_WARN("AccountService", "risk params shm unavailable, order api skips local pre-trade checks");
+        }
+    }
+
+    // 运维指令段随上游段命名；打开失败时运维操作退回信号与重启
+    if (shm_cfg.admin_channel) {
+        const std::string admin_name = make_admin_shm_name(shm_cfg.upstream_shm_name);
+        admin_shm_ = admin_shm_manager_.open_admin(admin_name, shm_mode::OpenOrCreate, account_id);
+        if (!admin_shm_) {
+            ACCT_LOG_WARN("AccountService", "admin shm unavailable, admin commands are not polled");
+        }
+    }
+
+    // 主机级证券主数据只读接入；未发布或不是当日数据时回到逐账户解析
+    if (!shm_cfg.security_master_shm_name.empty()) {
+        const security_master_shm_layout* master =
+            security_master_shm_manager_.open_security_master(shm_cfg.security_master_shm_name, shm_mode::Open);
+        if (master && security_master_ready(*master, trading_day_number(cfg.trading_day))) {
+            security_master_shm_ = master;
+        } else {
+            security_master_shm_manager_.close();
+            ACCT_LOG_WARN("AccountService", "security master not published for trading day, parsing per account");
+        }
+    }
+
     return true;
 }
 
@@ -253,19 +619,40 @@ bool AccountService::init_order_event_recorder() {
 
 bool AccountService::init_portfolio() {
     account_info_ = std::make_unique<account_info_manager>();
-    trade_records_ = std::make_unique<trade_record_manager>();
-    entrust_records_ = std::make_unique<entrust_record_manager>();
-
     const acct_service::Config& cfg = config_manager_.get();
+    trade_records_ = std::make_unique<trade_record_manager>(kDailyTradeCapacity, cfg.shm.huge_pages);
+    // 成交库须在加载当日成交之前打开：库内已有记录即为重启前的当日成交，加载阶段不再覆盖
+    if (!cfg.db.trade_store_dir.empty() &&
+        !trade_records_->open_store(cfg.db.trade_store_dir, cfg.account_id, cfg.trading_day)) {
+        raise_service_error(make_service_error(ErrorCode::ComponentUnavailable, "failed to open trade store"));
+        return false;
+    }
+    entrust_records_ = std::make_unique<entrust_record_manager>(kDailyEntrustCapacity, cfg.shm.huge_pages);
+
     position_manager_ =
-        std::make_unique<PositionManager>(positions_shm_, cfg.config_file, cfg.db.db_path, cfg.db.enable_persistence);
+        std::make_unique<PositionManager>(positions_shm_, cfg.config_file, cfg.db.db_path, cfg.db.enable_persistence,
+                                          cfg.db.position_snapshot_path, trading_day_number(cfg.trading_day));
     if (!position_manager_ || !position_manager_->initialize(config_manager_.account_id())) {
         raise_service_error(
             make_service_error(ErrorCode::ComponentUnavailable, "failed to initialize position manager"));
         return false;
     }
 
-    return load_account_info() && load_positions() && load_today_trades() && load_today_entrusts();
+    if (!load_account_info() || !load_positions() || !load_today_trades() || !load_today_entrusts()) {
+        return false;
+    }
+
+    // 持仓与 FUND 行变更按变更戳在后台合并写回同一份数据库，事件循环不参与落库
+    if (cfg.db.enable_persistence && !cfg.db.db_path.empty() && cfg.db.sync_interval_ms > 0) {
+        position_persister_ = std::make_unique<position_persister>();
+        if (!position_persister_->start(cfg.db.db_path, config_manager_.account_id(), positions_shm_,
+                                        cfg.db.sync_interval_ms)) {
+            raise_service_error(
+                make_service_error(ErrorCode::ComponentUnavailable, "failed to start position persister"));
+            return false;
+        }
+    }
+    return true;
 }
 
 bool AccountService::init_risk_manager() {
@@ -273,12 +660,16 @@ bool AccountService::init_risk_manager() {
         raise_service_error(make_service_error(ErrorCode::ComponentUnavailable, "position manager unavailable"));
         return false;
     }
-    risk_manager_ = std::make_unique<RiskManager>(*position_manager_, config_manager_.risk());
+    // 配置统计段时风控计数直接落在段内，监控无需经由服务线程
+    risk_manager_ = std::make_unique<RiskManager>(*position_manager_, config_manager_.risk(), risk_check_hook{},
+                                                  stats_shm_ ? &stats_shm_->risk : nullptr);
     if (!risk_manager_) {
         raise_service_error(make_service_error(ErrorCode::ComponentUnavailable, "failed to create risk manager"));
         return false;
     }
-    return true;
+    risk_manager_->attach_firm_risk(firm_risk_shm_);
+    risk_manager_->attach_risk_params(risk_params_shm_);
+    return load_price_limits();
 }
 
 bool AccountService::init_order_components() {
@@ -287,18 +678,43 @@ bool AccountService::init_order_components() {
         return false;
     }
 
-    order_book_ = std::make_unique<OrderBook>();
+    const acct_service::Config& cfg = config_manager_.get();
+    // 订单簿只在事件循环线程内访问，按单线程模型构造以省去每次调用的加锁；容量覆盖订单池及全部溢出段，
+    // 存储惰性落页，溢出段未启用时不多占常驻内存；大页开关与共享内存段一致
+    const std::size_t book_capacity =
+        static_cast<std::size_t>(orders_shm_->header.capacity) * (1 + cfg.shm.orders_overflow_segments);
+    order_book_ = std::make_unique<OrderBook>(order_book_threading::SingleThreaded, book_capacity,
+                                              cfg.shm.huge_pages);
     order_router_ = std::make_unique<order_router>(*order_book_, downstream_shm_, orders_shm_, upstream_shm_);
     if (!order_book_ || !order_router_) {
         raise_service_error(
             make_service_error(ErrorCode::ComponentUnavailable, "failed to initialize order components"));
         return false;
     }
-    if (!order_router_->recover_downstream_active_orders(upstream_shm_)) {
+    order_router_->set_inline_downstream(cfg.shm.downstream_inline_orders);
+    // 重启检查点可用时按检查点重建订单簿与父子关系；二进制订单日志开启时按日志定位在途槽位，避免扫描整个订单池
+    const order_journal_location journal{cfg.business_log.output_dir, cfg.account_id, cfg.trading_day};
+    const bool use_journal = cfg.business_log.enabled && cfg.business_log.binary_journal;
+    const order_recovery_baseline* baseline = nullptr;
+    if (cfg.EventLoop.checkpoint_interval_ms > 0) {
+        auto checkpoint = std::make_unique<restart_checkpoint>();
+        const std::string path = restart_checkpoint_path(cfg.EventLoop.checkpoint_dir, cfg.account_id, cfg.trading_day);
+        if (read_restart_checkpoint(path, *checkpoint) && checkpoint->account_id == cfg.account_id &&
+            checkpoint->trading_day == cfg.trading_day) {
+            restored_checkpoint_ = std::move(checkpoint);
+            baseline = &restored_checkpoint_->orders;
+        }
+    }
+    bool baseline_applied = false;
+    if (!order_router_->recover_downstream_active_orders(use_journal ? &journal : nullptr, baseline,
+                                                         &baseline_applied)) {
         raise_service_error(
             make_service_error(ErrorCode::ComponentUnavailable, "failed to recover downstream active orders"));
         return false;
     }
+    if (!baseline_applied) {
+        restored_checkpoint_.reset();
+    }
     return true;
 }
 
@@ -324,20 +740,39 @@ bool AccountService::init_execution_engine() {
         return false;
     }
 
-    std::unique_ptr<ActiveStrategy> active_strategy = StrategyRegistry::create(config_manager_.active_strategy());
-    if (config_manager_.active_strategy().enabled && config_manager_.active_strategy().name != "none" &&
-        !active_strategy) {
-        raise_service_error(make_service_error(ErrorCode::InvalidConfig, "unknown active strategy name"));
+    std::string strategy_error;
+    std::unique_ptr<ActiveStrategy> active_strategy =
+        StrategyRegistry::create(config_manager_.active_strategy(), strategy_error);
+    if (!active_strategy && !strategy_error.empty()) {
+        raise_service_error(make_service_error(ErrorCode::InvalidConfig, strategy_error));
         return false;
     }
 
+    const std::string& vwap_profile_path = config_manager_.split().vwap_profile_path;
+    if (!vwap_profile_path.empty()) {
+        volume_profile_ = std::make_unique<volume_profile>();
+        if (!volume_profile_->open(vwap_profile_path)) {
+            raise_service_error(make_service_error(ErrorCode::InvalidConfig, "failed to load vwap volume profile"));
+            return false;
+        }
+    }
+
     execution_engine_ = std::make_unique<ExecutionEngine>(config_manager_.split(), *order_book_, *order_router_,
                                                           market_data_service_.get(), order_event_recorder_.get(),
-                                                          std::move(active_strategy));
+                                                          std::move(active_strategy), volume_profile_.get(),
+                                                          config_manager_.get().shm.huge_pages);
     if (!execution_engine_) {
         raise_service_error(make_service_error(ErrorCode::ComponentUnavailable, "failed to create execution engine"));
         return false;
     }
+    // 订单簿已按检查点恢复时，在途执行会话随之重建并对账检查点之后的子单回报
+    if (restored_checkpoint_) {
+        const std::size_t sessions =
+            execution_engine_->restore_checkpoint(restored_checkpoint_->sessions, restored_checkpoint_->children);
+        ACCT_LOG_INFO("AccountService", "restored execution sessions from restart checkpoint count=" +
+                                            std::to_string(static_cast<unsigned long long>(sessions)));
+        restored_checkpoint_.reset();
+    }
     return true;
 }
 
@@ -348,14 +783,130 @@ bool AccountService::init_event_loop() {
         return false;
     }
 
+    const acct_service::Config& cfg = config_manager_.get();
+    if (cfg.EventLoop.checkpoint_interval_ms > 0) {
+        checkpoint_writer_ = std::make_unique<restart_checkpoint_writer>();
+        if (!checkpoint_writer_->start(
+                restart_checkpoint_path(cfg.EventLoop.checkpoint_dir, cfg.account_id, cfg.trading_day),
+                cfg.account_id, cfg.trading_day)) {
+            raise_service_error(
+                make_service_error(ErrorCode::ComponentUnavailable, "failed to start restart checkpoint writer"));
+            return false;
+        }
+    }
+
     event_loop_ = std::make_unique<EventLoop>(config_manager_.EventLoop(), upstream_shm_, downstream_shm_, trades_shm_,
                                               orders_shm_, *order_book_, *order_router_, *position_manager_,
                                               *risk_manager_, account_info_ ? &account_info_->info() : nullptr,
-                                              execution_engine_.get(), order_event_recorder_.get());
+                                              execution_engine_.get(), order_event_recorder_.get(), stats_shm_,
+                                              checkpoint_writer_.get());
     if (!event_loop_) {
         raise_service_error(make_service_error(ErrorCode::ComponentUnavailable, "failed to initialize event loop"));
         return false;
     }
+
+    if (cfg.EventLoop.flight_recorder_threshold_us > 0) {
+        flight_recorder_ = std::make_unique<iteration_flight_recorder>();
+        if (!flight_recorder_->start(
+                iteration_flight_recorder::path_for(cfg.log.log_dir, cfg.account_id, cfg.trading_day),
+                static_cast<uint64_t>(cfg.EventLoop.flight_recorder_threshold_us) * 1000ULL,
+                cfg.EventLoop.flight_recorder_context)) {
+            raise_service_error(
+                make_service_error(ErrorCode::ComponentUnavailable, "failed to start iteration flight recorder"));
+            return false;
+        }
+        event_loop_->set_flight_recorder(flight_recorder_.get());
+    }
+    if (cfg.EventLoop.traffic_capture_records > 0) {
+        traffic_capture_ = std::make_unique<traffic_capture>();
+        if (!traffic_capture_->open(traffic_capture::path_for(cfg.log.log_dir, cfg.account_id, cfg.trading_day),
+                                    cfg.EventLoop.traffic_capture_records, cfg.account_id,
+                                    orders_shm_->header.id_epoch.load(std::memory_order_acquire),
+                                    trading_day_number(cfg.trading_day))) {
+            raise_service_error(
+                make_service_error(ErrorCode::ComponentUnavailable, "failed to open traffic capture file"));
+            return false;
+        }
+        event_loop_->set_traffic_capture(traffic_capture_.get());
+    }
+    event_loop_->set_orders_index(orders_index_shm_);
+    event_loop_->set_admin_channel(admin_shm_);
+    event_loop_->set_reload_requester(
+        [](void* context) { static_cast<config_reloader*>(context)->request_reload(); }, &config_reloader_);
+    if (market_data_service_ && market_data_service_->is_enabled()) {
+        event_loop_->set_market_data(market_data_service_.get());
+    }
+    return init_replication();
+}
+
+// 主机在初始化末尾开始连接备机，备机开始监听；两端都在进入 Running 前就绪，首轮起即按处理顺序复制
+bool AccountService::init_replication() {
+    const ReplicationConfig& replication_cfg = config_manager_.replication();
+    const acct_service::Config& cfg = config_manager_.get();
+    const uint32_t trading_day = trading_day_number(cfg.trading_day);
+    if (replication_cfg.role == ReplicationRole::Primary) {
+        replication_sender_ = std::make_unique<replication_sender>();
+        if (!replication_sender_->start(replication_cfg, cfg.account_id,
+                                        orders_shm_->header.id_epoch.load(std::memory_order_acquire), trading_day)) {
+            raise_service_error(
+                make_service_error(ErrorCode::ComponentUnavailable, "failed to start replication sender"));
+            return false;
+        }
+        event_loop_->set_replication_sink(replication_sender_.get());
+    } else if (replication_cfg.role == ReplicationRole::Standby) {
+        replication_receiver_ = std::make_unique<replication_receiver>();
+        if (!replication_receiver_->start(replication_cfg, cfg.account_id, trading_day)) {
+            raise_service_error(
+                make_service_error(ErrorCode::ComponentUnavailable, "failed to start replication receiver"));
+            return false;
+        }
+        event_loop_->set_replication_source(replication_receiver_.get());
+    }
+    return true;
+}
+
+// 进程内网关直接复用本服务映射的下游/回报/订单池，适配器会话在此建立，Running 时才开始收单
+bool AccountService::init_in_process_gateway() {
+    const InProcessGatewayConfig& gateway_cfg = config_manager_.gateway();
+    if (!gateway_cfg.in_process) {
+        return true;
+    }
+
+    gateway::gateway_account_lane lane;
+    lane.account_id = config_manager_.account_id();
+    lane.downstream_shm = downstream_shm_;
+    lane.trades_shm = trades_shm_;
+    lane.orders_shm = orders_shm_;
+    lane.orders_shm_name = config_manager_.shm().orders_shm_name;
+    in_process_gateway_ = std::make_unique<gateway::colocated_gateway>();
+    std::string error_message;
+    if (!in_process_gateway_->initialize(gateway_cfg.config_file, lane, error_message, stats_shm_)) {
+        raise_service_error(make_service_error(ErrorCode::ComponentUnavailable,
+                                               "failed to initialize in-process gateway: " + error_message));
+        return false;
+    }
+    ACCT_LOG_INFO("AccountService", "in-process gateway ready broker_type=" + in_process_gateway_->config().broker_type +
+                                        " shards=" + std::to_string(in_process_gateway_->config().adapter_shards) +
+                                        (gateway_cfg.inline_poll ? " mode=inline" : " mode=thread"));
+    return true;
+}
+
+// 预热放在装配完成之后、进入 Ready 之前，开盘首批订单不再承担缺页与冷分支
+bool AccountService::run_warmup() {
+    const uint32_t warmup_orders = config_manager_.EventLoop().warmup_orders;
+    if (warmup_orders == 0) {
+        return true;
+    }
+
+    warmup_stats stats;
+    if (!run_startup_warmup(warmup_orders, *order_book_, orders_shm_, *position_manager_, config_manager_.risk(),
+                            stats)) {
+        raise_service_error(make_service_error(ErrorCode::ComponentUnavailable, "startup warmup failed"));
+        return false;
+    }
+    ACCT_LOG_INFO("AccountService", "startup warmup done orders=" + std::to_string(stats.orders_submitted) +
+                                        " routed=" + std::to_string(stats.orders_routed) +
+                                        " elapsed_us=" + std::to_string(stats.elapsed_ns / 1000));
     return true;
 }
 
@@ -430,9 +981,51 @@ bool AccountService::load_today_entrusts() {
     return true;
 }
 
+// 每次启动都从持仓快照同源（DB 或 config_file 旁的 CSV）加载当日涨跌停价格带。
+bool AccountService::load_price_limits() {
+    if (!risk_manager_->config().enable_price_limit_check) {
+        return true;
+    }
+
+    std::vector<price_limit_entry> entries;
+    if (security_master_shm_) {
+        security_master_price_limits(*security_master_shm_, entries);
+        if (risk_manager_->load_price_limits(entries) != entries.size()) {
+            raise_service_error(make_service_error(ErrorCode::InternalError, "price limit table is full"));
+            return false;
+        }
+        return true;
+    }
+
+    const acct_service::Config& cfg = config_manager_.get();
+    const bool use_db = cfg.db.enable_persistence && !cfg.db.db_path.empty();
+    const position_loader loader = use_db ? position_loader(position_loader::db_source{cfg.db.db_path})
+                                          : position_loader(position_loader::file_source{cfg.config_file});
+    if (!loader.load_price_limits(entries)) {
+        raise_service_error(make_service_error(ErrorCode::InternalError, "failed to load price limits"));
+        return false;
+    }
+    if (risk_manager_->load_price_limits(entries) != entries.size()) {
+        raise_service_error(make_service_error(ErrorCode::InternalError, "price limit table is full"));
+        return false;
+    }
+    return true;
+}
+
 void AccountService::cleanup() {
+    config_reloader_.stop();
+    orders_roller_.stop();
+    in_process_gateway_.reset();
     event_loop_.reset();
+    replication_sender_.reset();
+    replication_receiver_.reset();
+    flight_recorder_.reset();
+    traffic_capture_.reset();
+    checkpoint_writer_.reset();
+    position_persister_.reset();
+    restored_checkpoint_.reset();
     execution_engine_.reset();
+    volume_profile_.reset();
     market_data_service_.reset();
     order_router_.reset();
     order_book_.reset();
@@ -449,6 +1042,12 @@ void AccountService::cleanup() {
     trades_shm_ = nullptr;
     orders_shm_ = nullptr;
     positions_shm_ = nullptr;
+    stats_shm_ = nullptr;
+    firm_risk_shm_ = nullptr;
+    security_master_shm_ = nullptr;
+    orders_index_shm_ = nullptr;
+    risk_params_shm_ = nullptr;
+    admin_shm_ = nullptr;
 
     // 共享内存不删除只关闭映射
     upstream_shm_manager_.close();
@@ -456,10 +1055,21 @@ void AccountService::cleanup() {
     trades_shm_manager_.close();
     orders_shm_manager_.close();
     positions_shm_manager_.close();
+    stats_shm_manager_.close();
+    firm_risk_shm_manager_.close();
+    security_master_shm_manager_.close();
+    orders_index_shm_manager_.close();
+    risk_params_shm_manager_.close();
+    admin_shm_manager_.close();
+    orders_roller_.close();
 }
 
 void AccountService::raise_service_error(const ErrorStatus& status) {
-    last_error_ = status;
+    {
+        // 启动阶段并发执行时可能由多个线程同时上报
+        std::lock_guard<std::mutex> lock(last_error_mutex_);
+        last_error_ = status;
+    }
     record_error(status);
     ACCT_LOG_ERROR_STATUS(status);
 
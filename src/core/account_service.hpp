@@ -2,11 +2,19 @@
 
 #include <atomic>
 #include <memory>
+#include <mutex>
 #include <string>
 
 #include "common/error.hpp"
+#include "common/memory_accounting.hpp"
 #include "core/config_manager.hpp"
+#include "core/config_reloader.hpp"
 #include "core/event_loop.hpp"
+#include "core/flight_recorder.hpp"
+#include "core/orders_rollover.hpp"
+#include "core/restart_checkpoint.hpp"
+#include "core/startup_report.hpp"
+#include "core/traffic_capture.hpp"
 #include "execution/execution_engine.hpp"
 #include "market_data/market_data_service.hpp"
 #include "order/order_book.hpp"
@@ -15,12 +23,17 @@
 #include "portfolio/account_info.hpp"
 #include "portfolio/entrust_record.hpp"
 #include "portfolio/position_manager.hpp"
+#include "portfolio/position_persister.hpp"
 #include "portfolio/trade_record.hpp"
 #include "risk/risk_manager.hpp"
 #include "shm/shm_manager.hpp"
 
 namespace acct_service {
 
+namespace gateway {
+class colocated_gateway;
+}
+
 // 账户服务状态
 enum class ServiceState {
     Created,
@@ -32,12 +45,19 @@ enum class ServiceState {
     Error,
 };
 
+// 运行形态：Standalone 独占进程（自管日志、阻塞 run、事件循环自行绑核与注册信号）；
+// Hosted 由 AccountHost 托管（日志由宿主初始化，事件循环经 poll_once 被宿主 worker 调度）
+enum class service_hosting {
+    Standalone,
+    Hosted,
+};
+
 bool should_log_startup_config() noexcept;
 
 // 账户服务主类
 class AccountService {
 public:
-    AccountService();
+    explicit AccountService(service_hosting hosting = service_hosting::Standalone);
     ~AccountService();
 
     // 禁止拷贝
@@ -50,9 +70,28 @@ public:
     // 运行服务（阻塞）
     int run();
 
+    // 托管调度：start_hosted 进入 Running，poll_once 执行一轮事件循环（不做空闲等待），
+    // finish_hosted 收尾并返回与 run() 相同的退出码。同一时刻只允许一个线程调用 poll_once
+    bool start_hosted();
+    std::size_t poll_once();
+    bool is_polling() const noexcept;
+    int finish_hosted();
+
     // 请求停止
     void stop();
 
+    // 请求在后台重新加载配置文件，事件循环下一轮开头应用可热更新部分（仅 Running 期间生效）
+    void request_config_reload() noexcept;
+
+    // 在服换日（仅 Running 期间生效）：prepare_trading_day 后台预建并预取该交易日订单池，
+    // request_trading_day_rollover 在事件循环静默时把订单池切到该交易日；交易日须晚于当前交易日
+    bool prepare_trading_day(const std::string& trading_day);
+    bool request_trading_day_rollover(const std::string& trading_day);
+
+    // 热备备机提升为主机：停止接收主机记录，事件循环排空已收记录后恢复正常轮询；非备机时返回 false。
+    // 独立进程形态下也可向进程发送 SIGUSR2
+    bool promote_standby();
+
     // 获取服务状态
     ServiceState state() const noexcept;
 
@@ -68,6 +107,12 @@ public:
     bool has_fatal_error() const noexcept;
     const ErrorStatus& last_error() const noexcept;
 
+    // 最近一次 initialize() 的分阶段耗时报告（并发阶段各自计时）
+    const startup_report& last_startup_report() const noexcept;
+
+    // 按组件的内存占用表，初始化成功后可用；启动时输出到日志，开启统计段时由事件循环周期写入 mem.* 指标
+    const memory_accounting& memory() const noexcept { return memory_accounting_; }
+
 private:
     // 初始化各组件
     bool init_config(const std::string& config_path);
@@ -79,20 +124,35 @@ private:
     bool init_execution_engine();
     bool init_order_event_recorder();
     bool init_event_loop();
+    bool init_replication();
+    bool init_in_process_gateway();
+    bool run_warmup();
+    // 登记各组件的内存占用取值函数，绑定统计段指标并交给事件循环周期发布
+    void register_memory_components();
 
     // 加载历史数据
     bool load_account_info();
     bool load_positions();
     bool load_today_trades();
     bool load_today_entrusts();
+    bool load_price_limits();
 
     // 清理资源
     void cleanup();
     void print_loaded_config() const;
     void raise_service_error(const ErrorStatus& status);
     bool should_terminate_due_to_error() const noexcept;
+    bool enter_running();
+    int leave_running();
+    // 进程内网关随服务进入/离开 Running 启停；未开启时为空操作
+    bool start_in_process_gateway();
+    void stop_in_process_gateway() noexcept;
 
+    const service_hosting hosting_;
     mutable ErrorStatus last_error_{};
+    std::mutex last_error_mutex_;
+    startup_report startup_report_;
+    memory_accounting memory_accounting_;
     std::atomic<ErrorSeverity> shutdown_reason_{ErrorSeverity::Recoverable};
 
     std::atomic<ServiceState> state_{ServiceState::Created};
@@ -106,6 +166,12 @@ private:
     SHMManager trades_shm_manager_;
     SHMManager orders_shm_manager_;
     SHMManager positions_shm_manager_;
+    SHMManager stats_shm_manager_;
+    SHMManager firm_risk_shm_manager_;
+    SHMManager security_master_shm_manager_;
+    SHMManager orders_index_shm_manager_;
+    SHMManager risk_params_shm_manager_;
+    SHMManager admin_shm_manager_;
 
     // 共享内存指针
     upstream_shm_layout* upstream_shm_ = nullptr;
@@ -113,21 +179,53 @@ private:
     trades_shm_layout* trades_shm_ = nullptr;
     orders_shm_layout* orders_shm_ = nullptr;
     positions_shm_layout* positions_shm_ = nullptr;
+    stats_shm_layout* stats_shm_ = nullptr;
+    firm_risk_shm_layout* firm_risk_shm_ = nullptr;
+    const security_master_shm_layout* security_master_shm_ = nullptr;  // 仅当日已发布时非空
+    orders_index_shm_layout* orders_index_shm_ = nullptr;              // shm.orders_index 开启时非空
+    risk_params_shm_layout* risk_params_shm_ = nullptr;                // shm.risk_params 开启时非空
+    admin_shm_layout* admin_shm_ = nullptr;                            // shm.admin_channel 开启时非空
 
     // 核心组件
     std::unique_ptr<account_info_manager> account_info_;
     std::unique_ptr<PositionManager> position_manager_;
+    std::unique_ptr<position_persister> position_persister_;  // 持仓 write-behind（未开启持久化时为空）
     std::unique_ptr<OrderBook> order_book_;
     std::unique_ptr<OrderEventRecorder> order_event_recorder_;
     std::unique_ptr<order_router> order_router_;
     std::unique_ptr<RiskManager> risk_manager_;
     std::unique_ptr<MarketDataService> market_data_service_;
+    std::unique_ptr<volume_profile> volume_profile_;  // VWAP 成交量分布（未配置时为空）
     std::unique_ptr<ExecutionEngine> execution_engine_;
     std::unique_ptr<trade_record_manager> trade_records_;
     std::unique_ptr<entrust_record_manager> entrust_records_;
 
+    // 重启检查点：启动时读入的检查点在执行会话恢复后释放；写线程在事件循环之后停止
+    std::unique_ptr<restart_checkpoint> restored_checkpoint_;
+    std::unique_ptr<restart_checkpoint_writer> checkpoint_writer_;
+
+    // 迭代飞行记录仪（flight_recorder_threshold_us 为 0 时为空），在事件循环之后停止
+    std::unique_ptr<iteration_flight_recorder> flight_recorder_;
+
+    // SHM 队列流量录制（traffic_capture_records 为 0 时为空），在事件循环之后关闭
+    std::unique_ptr<traffic_capture> traffic_capture_;
+
     // 事件循环
     std::unique_ptr<EventLoop> event_loop_;
+
+    // 热备复制（replication.role 为 none 时均为空），事件循环持有裸指针，须在事件循环之后释放
+    std::unique_ptr<replication_sender> replication_sender_;
+    std::unique_ptr<replication_receiver> replication_receiver_;
+
+    // 进程内网关（gateway.in_process 关闭时为空），先于共享内存关闭
+    std::unique_ptr<gateway::colocated_gateway> in_process_gateway_;
+
+    // 配置热更新线程：随服务进入/离开 Running 启停，持有事件循环引用，须先于事件循环停止
+    config_reloader config_reloader_;
+
+    // 订单池换日线程：随服务进入/离开 Running 启停；换日建立的订单池映射保留到 cleanup
+    orders_day_roller orders_roller_;
+    shm::ShmMapOptions map_options_;  // 启动时各段所用的映射选项，换日新建的订单池沿用
 };
 
 }  // namespace acct_service
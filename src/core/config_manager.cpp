@@ -13,14 +13,20 @@
 #include <string>
 #include <string_view>
 
+#include "common/constants.hpp"
 #include "common/error.hpp"
 #include "common/log.hpp"
+#include "common/thread_setup.hpp"
 #include "common/types.hpp"
 
 namespace acct_service {
 
 namespace {
 
+constexpr uint32_t kMaxEvalWorkers = 64;  // split.eval_workers 上限，超过后抢块争用抵消并行收益
+constexpr uint32_t kMaxFlightRecorderContext = 4096;  // event_loop.flight_recorder_context 上限，环容量随之翻倍
+constexpr uint32_t kMaxReplicationBatchRecords = 1024;  // replication.batch_records 上限，单帧约 320KB
+
 enum class ConfigValueParseError {
     InvalidBool,
     InvalidU32,
@@ -28,6 +34,7 @@ enum class ConfigValueParseError {
     InvalidI32,
     InvalidDouble,
     InvalidSplitStrategy,
+    InvalidReplicationRole,
     InvalidTradingDay,
     OutOfRange,
     UnknownKey,
@@ -57,6 +64,8 @@ const char* config_value_parse_error_message(ConfigValueParseError error) noexce
             return "invalid double value";
         case ConfigValueParseError::InvalidSplitStrategy:
             return "invalid split strategy";
+        case ConfigValueParseError::InvalidReplicationRole:
+            return "invalid replication role";
         case ConfigValueParseError::InvalidTradingDay:
             return "invalid trading day";
         case ConfigValueParseError::OutOfRange:
@@ -205,6 +214,34 @@ const char* split_strategy_to_string(SplitStrategy strategy) {
     }
 }
 
+ConfigValueParseResult<ReplicationRole> parse_replication_role(std::string_view raw_value) {
+    std::string value = trim_copy(std::string(raw_value));
+    std::transform(value.begin(), value.end(), value.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+
+    if (value == "none") {
+        return ReplicationRole::None;
+    }
+    if (value == "primary") {
+        return ReplicationRole::Primary;
+    }
+    if (value == "standby") {
+        return ReplicationRole::Standby;
+    }
+    return make_parse_failure<ReplicationRole>(ConfigValueParseError::InvalidReplicationRole);
+}
+
+const char* replication_role_to_string(ReplicationRole role) {
+    switch (role) {
+        case ReplicationRole::Primary:
+            return "primary";
+        case ReplicationRole::Standby:
+            return "standby";
+        default:
+            return "none";
+    }
+}
+
 std::string escape_yaml_string(std::string_view value);
 
 std::string escape_log_value(std::string_view value);
@@ -219,39 +256,88 @@ void write_config_yaml(std::ostream& out, const Config& config) {
     out << "  trades_shm_name: \"" << escape_yaml_string(config.shm.trades_shm_name) << "\"\n";
     out << "  orders_shm_name: \"" << escape_yaml_string(config.shm.orders_shm_name) << "\"\n";
     out << "  positions_shm_name: \"" << escape_yaml_string(config.shm.positions_shm_name) << "\"\n";
-    out << "  create_if_not_exist: " << (config.shm.create_if_not_exist ? "true" : "false") << "\n\n";
+    out << "  stats_shm_name: \"" << escape_yaml_string(config.shm.stats_shm_name) << "\"\n";
+    out << "  firm_risk_shm_name: \"" << escape_yaml_string(config.shm.firm_risk_shm_name) << "\"\n";
+    out << "  security_master_shm_name: \"" << escape_yaml_string(config.shm.security_master_shm_name) << "\"\n";
+    out << "  create_if_not_exist: " << (config.shm.create_if_not_exist ? "true" : "false") << "\n";
+    out << "  upstream_lane_count: " << config.shm.upstream_lane_count << "\n";
+    out << "  huge_pages: " << (config.shm.huge_pages ? "true" : "false") << "\n";
+    out << "  prefault: " << (config.shm.prefault ? "true" : "false") << "\n";
+    out << "  hugetlb_arena: " << (config.shm.hugetlb_arena ? "true" : "false") << "\n";
+    out << "  numa_node: " << config.shm.numa_node << "\n";
+    out << "  orders_capacity: " << config.shm.orders_capacity << "\n";
+    out << "  orders_overflow_segments: " << config.shm.orders_overflow_segments << "\n";
+    out << "  orders_index: " << (config.shm.orders_index ? "true" : "false") << "\n";
+    out << "  risk_params: " << (config.shm.risk_params ? "true" : "false") << "\n";
+    out << "  admin_channel: " << (config.shm.admin_channel ? "true" : "false") << "\n";
+    out << "  downstream_inline_orders: " << (config.shm.downstream_inline_orders ? "true" : "false") << "\n";
+    out << "  upstream_inline_orders: " << (config.shm.upstream_inline_orders ? "true" : "false") << "\n";
+    out << "  next_trading_day: \"" << escape_yaml_string(config.shm.next_trading_day) << "\"\n\n";
 
     out << "EventLoop:\n";
     out << "  busy_polling: " << (config.EventLoop.busy_polling ? "true" : "false") << "\n";
     out << "  poll_batch_size: " << config.EventLoop.poll_batch_size << "\n";
     out << "  idle_sleep_us: " << config.EventLoop.idle_sleep_us << "\n";
+    out << "  adaptive_idle: " << (config.EventLoop.adaptive_idle ? "true" : "false") << "\n";
+    out << "  idle_spin_iterations: " << config.EventLoop.idle_spin_iterations << "\n";
+    out << "  idle_yield_iterations: " << config.EventLoop.idle_yield_iterations << "\n";
+    out << "  idle_park_timeout_us: " << config.EventLoop.idle_park_timeout_us << "\n";
     out << "  stats_interval_ms: " << config.EventLoop.stats_interval_ms << "\n";
+    out << "  response_preempt_batch: " << config.EventLoop.response_preempt_batch << "\n";
     out << "  archive_terminal_orders: " << (config.EventLoop.archive_terminal_orders ? "true" : "false") << "\n";
     out << "  terminal_archive_delay_ms: " << config.EventLoop.terminal_archive_delay_ms << "\n";
     out << "  pin_cpu: " << (config.EventLoop.pin_cpu ? "true" : "false") << "\n";
-    out << "  cpu_core: " << config.EventLoop.cpu_core << "\n\n";
+    out << "  cpu_core: " << config.EventLoop.cpu_core << "\n";
+    out << "  fifo_priority: " << config.EventLoop.fifo_priority << "\n";
+    out << "  lock_memory: " << (config.EventLoop.lock_memory ? "true" : "false") << "\n";
+    out << "  warmup_orders: " << config.EventLoop.warmup_orders << "\n";
+    out << "  checkpoint_interval_ms: " << config.EventLoop.checkpoint_interval_ms << "\n";
+    out << "  checkpoint_dir: \"" << escape_yaml_string(config.EventLoop.checkpoint_dir) << "\"\n";
+    out << "  flight_recorder_threshold_us: " << config.EventLoop.flight_recorder_threshold_us << "\n";
+    out << "  flight_recorder_context: " << config.EventLoop.flight_recorder_context << "\n";
+    out << "  traffic_capture_records: " << config.EventLoop.traffic_capture_records << "\n";
+    out << "  mark_to_market_interval_ms: " << config.EventLoop.mark_to_market_interval_ms << "\n";
+    out << "  adaptive_batching: " << (config.EventLoop.adaptive_batching ? "true" : "false") << "\n";
+    out << "  iteration_budget_us: " << config.EventLoop.iteration_budget_us << "\n";
+    out << "  response_share_pct: " << config.EventLoop.response_share_pct << "\n";
+    out << "  queue_depth_sample_iterations: " << config.EventLoop.queue_depth_sample_iterations << "\n";
+    out << "  admin_poll_iterations: " << config.EventLoop.admin_poll_iterations << "\n\n";
 
     out << "market_data:\n";
     out << "  enabled: " << (config.market_data.enabled ? "true" : "false") << "\n";
     out << "  snapshot_shm_name: \"" << escape_yaml_string(config.market_data.snapshot_shm_name) << "\"\n";
+    out << "  sz_snapshot_shm_name: \"" << escape_yaml_string(config.market_data.sz_snapshot_shm_name) << "\"\n";
+    out << "  sh_snapshot_shm_name: \"" << escape_yaml_string(config.market_data.sh_snapshot_shm_name) << "\"\n";
     out << "  allow_order_price_fallback: " << (config.market_data.allow_order_price_fallback ? "true" : "false")
         << "\n\n";
 
     out << "active_strategy:\n";
     out << "  enabled: " << (config.active_strategy.enabled ? "true" : "false") << "\n";
     out << "  name: \"" << escape_yaml_string(config.active_strategy.name) << "\"\n";
-    out << "  signal_threshold: " << config.active_strategy.signal_threshold << "\n\n";
+    out << "  signal_threshold: " << config.active_strategy.signal_threshold << "\n";
+    out << "  plugin_path: \"" << escape_yaml_string(config.active_strategy.plugin_path) << "\"\n\n";
 
     out << "risk:\n";
     out << "  max_order_value: " << config.risk.max_order_value << "\n";
     out << "  max_order_volume: " << config.risk.max_order_volume << "\n";
     out << "  max_daily_turnover: " << config.risk.max_daily_turnover << "\n";
     out << "  max_orders_per_second: " << config.risk.max_orders_per_second << "\n";
+    out << "  max_orders_per_second_per_strategy: " << config.risk.max_orders_per_second_per_strategy << "\n";
+    out << "  max_orders_per_second_per_security: " << config.risk.max_orders_per_second_per_security << "\n";
+    out << "  rate_limit_burst_ms: " << config.risk.rate_limit_burst_ms << "\n";
     out << "  enable_price_limit_check: " << (config.risk.enable_price_limit_check ? "true" : "false") << "\n";
     out << "  enable_duplicate_check: " << (config.risk.enable_duplicate_check ? "true" : "false") << "\n";
     out << "  enable_fund_check: " << (config.risk.enable_fund_check ? "true" : "false") << "\n";
     out << "  enable_position_check: " << (config.risk.enable_position_check ? "true" : "false") << "\n";
-    out << "  duplicate_window_ns: " << config.risk.duplicate_window_ns << "\n\n";
+    out << "  enable_self_trade_check: " << (config.risk.enable_self_trade_check ? "true" : "false") << "\n";
+    out << "  max_firm_gross_value: " << config.risk.max_firm_gross_value << "\n";
+    out << "  max_firm_security_volume: " << config.risk.max_firm_security_volume << "\n";
+    out << "  max_order_to_trade_ratio: " << config.risk.max_order_to_trade_ratio << "\n";
+    out << "  max_cancel_ratio_pct: " << config.risk.max_cancel_ratio_pct << "\n";
+    out << "  order_ratio_min_orders: " << config.risk.order_ratio_min_orders << "\n";
+    out << "  duplicate_window_ns: " << config.risk.duplicate_window_ns << "\n";
+    out << "  profile_rules: " << (config.risk.profile_rules ? "true" : "false") << "\n";
+    out << "  rule_reorder_interval: " << config.risk.rule_reorder_interval << "\n\n";
 
     out << "split:\n";
     out << "  strategy: \"" << split_strategy_to_string(config.split.strategy) << "\"\n";
@@ -259,7 +345,14 @@ void write_config_yaml(std::ostream& out, const Config& config) {
     out << "  min_child_volume: " << config.split.min_child_volume << "\n";
     out << "  max_child_count: " << config.split.max_child_count << "\n";
     out << "  interval_ms: " << config.split.interval_ms << "\n";
-    out << "  randomize_factor: " << config.split.randomize_factor << "\n\n";
+    out << "  randomize_factor: " << config.split.randomize_factor << "\n";
+    out << "  max_sessions: " << config.split.max_sessions << "\n";
+    out << "  eval_workers: " << config.split.eval_workers << "\n";
+    out << "  child_risk_check: " << (config.split.child_risk_check ? "true" : "false") << "\n";
+    out << "  child_max_order_volume: " << config.split.child_max_order_volume << "\n";
+    out << "  child_max_order_value: " << config.split.child_max_order_value << "\n";
+    out << "  coroutine_sessions: " << (config.split.coroutine_sessions ? "true" : "false") << "\n";
+    out << "  vwap_profile_path: \"" << escape_yaml_string(config.split.vwap_profile_path) << "\"\n\n";
 
     out << "log:\n";
     out << "  log_dir: \"" << escape_yaml_string(config.log.log_dir) << "\"\n";
@@ -271,12 +364,33 @@ void write_config_yaml(std::ostream& out, const Config& config) {
     out << "  enabled: " << (config.business_log.enabled ? "true" : "false") << "\n";
     out << "  output_dir: \"" << escape_yaml_string(config.business_log.output_dir) << "\"\n";
     out << "  queue_capacity: " << config.business_log.queue_capacity << "\n";
-    out << "  flush_interval_ms: " << config.business_log.flush_interval_ms << "\n\n";
+    out << "  flush_interval_ms: " << config.business_log.flush_interval_ms << "\n";
+    out << "  sync_interval_ms: " << config.business_log.sync_interval_ms << "\n";
+    out << "  binary_journal: " << (config.business_log.binary_journal ? "true" : "false") << "\n";
+    out << "  journal_segment_records: " << config.business_log.journal_segment_records << "\n";
+    out << "  delta_records: " << (config.business_log.delta_records ? "true" : "false") << "\n";
+    out << "  writer_cpu_core: " << config.business_log.writer_cpu_core << "\n";
+    out << "  writer_priority: " << config.business_log.writer_priority << "\n\n";
 
     out << "db:\n";
     out << "  db_path: \"" << escape_yaml_string(config.db.db_path) << "\"\n";
     out << "  enable_persistence: " << (config.db.enable_persistence ? "true" : "false") << "\n";
     out << "  sync_interval_ms: " << config.db.sync_interval_ms << "\n";
+    out << "  position_snapshot_path: \"" << escape_yaml_string(config.db.position_snapshot_path) << "\"\n";
+    out << "  trade_store_dir: \"" << escape_yaml_string(config.db.trade_store_dir) << "\"\n\n";
+
+    out << "gateway:\n";
+    out << "  in_process: " << (config.gateway.in_process ? "true" : "false") << "\n";
+    out << "  config_file: \"" << escape_yaml_string(config.gateway.config_file) << "\"\n";
+    out << "  inline_poll: " << (config.gateway.inline_poll ? "true" : "false") << "\n\n";
+
+    out << "replication:\n";
+    out << "  role: \"" << replication_role_to_string(config.replication.role) << "\"\n";
+    out << "  peer_host: \"" << escape_yaml_string(config.replication.peer_host) << "\"\n";
+    out << "  bind_address: \"" << escape_yaml_string(config.replication.bind_address) << "\"\n";
+    out << "  port: " << config.replication.port << "\n";
+    out << "  batch_records: " << config.replication.batch_records << "\n";
+    out << "  cpu_core: " << config.replication.cpu_core << "\n";
 }
 
 void write_config_log_line(std::ostream& out, std::string_view section, std::string_view key, std::string_view value) {
@@ -312,35 +426,89 @@ void write_config_log(std::ostream& out, const Config& config) {
     write_config_log_line(out, "shm", "trades_shm_name", config.shm.trades_shm_name);
     write_config_log_line(out, "shm", "orders_shm_name", config.shm.orders_shm_name);
     write_config_log_line(out, "shm", "positions_shm_name", config.shm.positions_shm_name);
+    write_config_log_line(out, "shm", "stats_shm_name", config.shm.stats_shm_name);
+    write_config_log_line(out, "shm", "firm_risk_shm_name", config.shm.firm_risk_shm_name);
+    write_config_log_line(out, "shm", "security_master_shm_name", config.shm.security_master_shm_name);
     write_config_log_line(out, "shm", "create_if_not_exist", config.shm.create_if_not_exist);
+    write_config_log_line(out, "shm", "upstream_lane_count", config.shm.upstream_lane_count);
+    write_config_log_line(out, "shm", "huge_pages", config.shm.huge_pages);
+    write_config_log_line(out, "shm", "prefault", config.shm.prefault);
+    write_config_log_line(out, "shm", "hugetlb_arena", config.shm.hugetlb_arena);
+    write_config_log_line(out, "shm", "numa_node", config.shm.numa_node);
+    write_config_log_line(out, "shm", "orders_capacity", config.shm.orders_capacity);
+    write_config_log_line(out, "shm", "orders_overflow_segments", config.shm.orders_overflow_segments);
+    write_config_log_line(out, "shm", "orders_index", config.shm.orders_index);
+    write_config_log_line(out, "shm", "risk_params", config.shm.risk_params);
+    write_config_log_line(out, "shm", "admin_channel", config.shm.admin_channel);
+    write_config_log_line(out, "shm", "downstream_inline_orders", config.shm.downstream_inline_orders);
+    write_config_log_line(out, "shm", "upstream_inline_orders", config.shm.upstream_inline_orders);
+    write_config_log_line(out, "shm", "next_trading_day", config.shm.next_trading_day);
 
     write_config_log_line(out, "event_loop", "busy_polling", config.EventLoop.busy_polling);
     write_config_log_line(out, "event_loop", "poll_batch_size", config.EventLoop.poll_batch_size);
     write_config_log_line(out, "event_loop", "idle_sleep_us", config.EventLoop.idle_sleep_us);
+    write_config_log_line(out, "event_loop", "adaptive_idle", config.EventLoop.adaptive_idle);
+    write_config_log_line(out, "event_loop", "idle_spin_iterations", config.EventLoop.idle_spin_iterations);
+    write_config_log_line(out, "event_loop", "idle_yield_iterations", config.EventLoop.idle_yield_iterations);
+    write_config_log_line(out, "event_loop", "idle_park_timeout_us", config.EventLoop.idle_park_timeout_us);
     write_config_log_line(out, "event_loop", "stats_interval_ms", config.EventLoop.stats_interval_ms);
+    write_config_log_line(out, "event_loop", "response_preempt_batch", config.EventLoop.response_preempt_batch);
     write_config_log_line(out, "event_loop", "archive_terminal_orders", config.EventLoop.archive_terminal_orders);
     write_config_log_line(out, "event_loop", "terminal_archive_delay_ms", config.EventLoop.terminal_archive_delay_ms);
     write_config_log_line(out, "event_loop", "pin_cpu", config.EventLoop.pin_cpu);
     write_config_log_line(out, "event_loop", "cpu_core", config.EventLoop.cpu_core);
+    write_config_log_line(out, "event_loop", "fifo_priority", config.EventLoop.fifo_priority);
+    write_config_log_line(out, "event_loop", "lock_memory", config.EventLoop.lock_memory);
+    write_config_log_line(out, "event_loop", "warmup_orders", config.EventLoop.warmup_orders);
+    write_config_log_line(out, "event_loop", "checkpoint_interval_ms", config.EventLoop.checkpoint_interval_ms);
+    write_config_log_line(out, "event_loop", "checkpoint_dir", config.EventLoop.checkpoint_dir);
+    write_config_log_line(out, "event_loop", "flight_recorder_threshold_us",
+                          config.EventLoop.flight_recorder_threshold_us);
+    write_config_log_line(out, "event_loop", "flight_recorder_context", config.EventLoop.flight_recorder_context);
+    write_config_log_line(out, "event_loop", "traffic_capture_records", config.EventLoop.traffic_capture_records);
+    write_config_log_line(out, "event_loop", "mark_to_market_interval_ms",
+                          config.EventLoop.mark_to_market_interval_ms);
+    write_config_log_line(out, "event_loop", "adaptive_batching", config.EventLoop.adaptive_batching);
+    write_config_log_line(out, "event_loop", "iteration_budget_us", config.EventLoop.iteration_budget_us);
+    write_config_log_line(out, "event_loop", "response_share_pct", config.EventLoop.response_share_pct);
+    write_config_log_line(out, "event_loop", "queue_depth_sample_iterations",
+                          config.EventLoop.queue_depth_sample_iterations);
+    write_config_log_line(out, "event_loop", "admin_poll_iterations", config.EventLoop.admin_poll_iterations);
 
     write_config_log_line(out, "market_data", "enabled", config.market_data.enabled);
     write_config_log_line(out, "market_data", "snapshot_shm_name", config.market_data.snapshot_shm_name);
+    write_config_log_line(out, "market_data", "sz_snapshot_shm_name", config.market_data.sz_snapshot_shm_name);
+    write_config_log_line(out, "market_data", "sh_snapshot_shm_name", config.market_data.sh_snapshot_shm_name);
     write_config_log_line(out, "market_data", "allow_order_price_fallback",
                           config.market_data.allow_order_price_fallback);
 
     write_config_log_line(out, "active_strategy", "enabled", config.active_strategy.enabled);
     write_config_log_line(out, "active_strategy", "name", config.active_strategy.name);
     write_config_log_line(out, "active_strategy", "signal_threshold", config.active_strategy.signal_threshold);
+    write_config_log_line(out, "active_strategy", "plugin_path", config.active_strategy.plugin_path);
 
     write_config_log_line(out, "risk", "max_order_value", config.risk.max_order_value);
     write_config_log_line(out, "risk", "max_order_volume", config.risk.max_order_volume);
     write_config_log_line(out, "risk", "max_daily_turnover", config.risk.max_daily_turnover);
     write_config_log_line(out, "risk", "max_orders_per_second", config.risk.max_orders_per_second);
+    write_config_log_line(out, "risk", "max_orders_per_second_per_strategy",
+                          config.risk.max_orders_per_second_per_strategy);
+    write_config_log_line(out, "risk", "max_orders_per_second_per_security",
+                          config.risk.max_orders_per_second_per_security);
+    write_config_log_line(out, "risk", "rate_limit_burst_ms", config.risk.rate_limit_burst_ms);
     write_config_log_line(out, "risk", "enable_price_limit_check", config.risk.enable_price_limit_check);
     write_config_log_line(out, "risk", "enable_duplicate_check", config.risk.enable_duplicate_check);
     write_config_log_line(out, "risk", "enable_fund_check", config.risk.enable_fund_check);
     write_config_log_line(out, "risk", "enable_position_check", config.risk.enable_position_check);
+    write_config_log_line(out, "risk", "enable_self_trade_check", config.risk.enable_self_trade_check);
+    write_config_log_line(out, "risk", "max_firm_gross_value", config.risk.max_firm_gross_value);
+    write_config_log_line(out, "risk", "max_firm_security_volume", config.risk.max_firm_security_volume);
+    write_config_log_line(out, "risk", "max_order_to_trade_ratio", config.risk.max_order_to_trade_ratio);
+    write_config_log_line(out, "risk", "max_cancel_ratio_pct", config.risk.max_cancel_ratio_pct);
+    write_config_log_line(out, "risk", "order_ratio_min_orders", config.risk.order_ratio_min_orders);
     write_config_log_line(out, "risk", "duplicate_window_ns", config.risk.duplicate_window_ns);
+    write_config_log_line(out, "risk", "profile_rules", config.risk.profile_rules);
+    write_config_log_line(out, "risk", "rule_reorder_interval", config.risk.rule_reorder_interval);
 
     write_config_log_line(out, "split", "strategy", split_strategy_to_string(config.split.strategy));
     write_config_log_line(out, "split", "max_child_volume", config.split.max_child_volume);
@@ -348,6 +516,13 @@ void write_config_log(std::ostream& out, const Config& config) {
     write_config_log_line(out, "split", "max_child_count", config.split.max_child_count);
     write_config_log_line(out, "split", "interval_ms", config.split.interval_ms);
     write_config_log_line(out, "split", "randomize_factor", config.split.randomize_factor);
+    write_config_log_line(out, "split", "max_sessions", config.split.max_sessions);
+    write_config_log_line(out, "split", "eval_workers", config.split.eval_workers);
+    write_config_log_line(out, "split", "child_risk_check", config.split.child_risk_check);
+    write_config_log_line(out, "split", "child_max_order_volume", config.split.child_max_order_volume);
+    write_config_log_line(out, "split", "child_max_order_value", config.split.child_max_order_value);
+    write_config_log_line(out, "split", "coroutine_sessions", config.split.coroutine_sessions);
+    write_config_log_line(out, "split", "vwap_profile_path", config.split.vwap_profile_path);
 
     write_config_log_line(out, "log", "log_dir", config.log.log_dir);
     write_config_log_line(out, "log", "log_level", config.log.log_level);
@@ -358,10 +533,30 @@ void write_config_log(std::ostream& out, const Config& config) {
     write_config_log_line(out, "business_log", "output_dir", config.business_log.output_dir);
     write_config_log_line(out, "business_log", "queue_capacity", config.business_log.queue_capacity);
     write_config_log_line(out, "business_log", "flush_interval_ms", config.business_log.flush_interval_ms);
+    write_config_log_line(out, "business_log", "sync_interval_ms", config.business_log.sync_interval_ms);
+    write_config_log_line(out, "business_log", "binary_journal", config.business_log.binary_journal);
+    write_config_log_line(out, "business_log", "journal_segment_records",
+                          config.business_log.journal_segment_records);
+    write_config_log_line(out, "business_log", "delta_records", config.business_log.delta_records);
+    write_config_log_line(out, "business_log", "writer_cpu_core", config.business_log.writer_cpu_core);
+    write_config_log_line(out, "business_log", "writer_priority", config.business_log.writer_priority);
 
     write_config_log_line(out, "db", "db_path", config.db.db_path);
     write_config_log_line(out, "db", "enable_persistence", config.db.enable_persistence);
     write_config_log_line(out, "db", "sync_interval_ms", config.db.sync_interval_ms);
+    write_config_log_line(out, "db", "position_snapshot_path", config.db.position_snapshot_path);
+    write_config_log_line(out, "db", "trade_store_dir", config.db.trade_store_dir);
+
+    write_config_log_line(out, "gateway", "in_process", config.gateway.in_process);
+    write_config_log_line(out, "gateway", "config_file", config.gateway.config_file);
+    write_config_log_line(out, "gateway", "inline_poll", config.gateway.inline_poll);
+
+    write_config_log_line(out, "replication", "role", replication_role_to_string(config.replication.role));
+    write_config_log_line(out, "replication", "peer_host", config.replication.peer_host);
+    write_config_log_line(out, "replication", "bind_address", config.replication.bind_address);
+    write_config_log_line(out, "replication", "port", config.replication.port);
+    write_config_log_line(out, "replication", "batch_records", config.replication.batch_records);
+    write_config_log_line(out, "replication", "cpu_core", config.replication.cpu_core);
 }
 
 bool is_valid_trading_day_value(std::string_view trading_day) noexcept {
@@ -455,9 +650,64 @@ ConfigValueApplyResult apply_value(Config& cfg, std::string_view key, std::strin
         cfg.shm.positions_shm_name = value;
         return {};
     }
+    if (key == "shm.stats_shm_name") {
+        cfg.shm.stats_shm_name = value;
+        return {};
+    }
+    if (key == "shm.firm_risk_shm_name") {
+        cfg.shm.firm_risk_shm_name = value;
+        return {};
+    }
+    if (key == "shm.security_master_shm_name") {
+        cfg.shm.security_master_shm_name = value;
+        return {};
+    }
     if (key == "shm.create_if_not_exist") {
         return assign_parsed(parse_bool(value), cfg.shm.create_if_not_exist);
     }
+    if (key == "shm.upstream_lane_count") {
+        return assign_parsed(parse_u32(value), cfg.shm.upstream_lane_count);
+    }
+    if (key == "shm.huge_pages") {
+        return assign_parsed(parse_bool(value), cfg.shm.huge_pages);
+    }
+    if (key == "shm.hugetlb_arena") {
+        return assign_parsed(parse_bool(value), cfg.shm.hugetlb_arena);
+    }
+    if (key == "shm.prefault") {
+        return assign_parsed(parse_bool(value), cfg.shm.prefault);
+    }
+    if (key == "shm.numa_node") {
+        return assign_parsed(parse_i32(value), cfg.shm.numa_node);
+    }
+    if (key == "shm.orders_capacity") {
+        return assign_parsed(parse_u32(value), cfg.shm.orders_capacity);
+    }
+    if (key == "shm.orders_overflow_segments") {
+        return assign_parsed(parse_u32(value), cfg.shm.orders_overflow_segments);
+    }
+    if (key == "shm.orders_index") {
+        return assign_parsed(parse_bool(value), cfg.shm.orders_index);
+    }
+    if (key == "shm.risk_params") {
+        return assign_parsed(parse_bool(value), cfg.shm.risk_params);
+    }
+    if (key == "shm.admin_channel") {
+        return assign_parsed(parse_bool(value), cfg.shm.admin_channel);
+    }
+    if (key == "shm.downstream_inline_orders") {
+        return assign_parsed(parse_bool(value), cfg.shm.downstream_inline_orders);
+    }
+    if (key == "shm.upstream_inline_orders") {
+        return assign_parsed(parse_bool(value), cfg.shm.upstream_inline_orders);
+    }
+    if (key == "shm.next_trading_day") {
+        if (!value.empty() && !is_valid_trading_day_value(value)) {
+            return std::unexpected(ConfigValueParseError::InvalidTradingDay);
+        }
+        cfg.shm.next_trading_day = value;
+        return {};
+    }
 
     if (key == "event_loop.busy_polling" || key == "EventLoop.busy_polling") {
         return assign_parsed(parse_bool(value), cfg.EventLoop.busy_polling);
@@ -468,9 +718,24 @@ ConfigValueApplyResult apply_value(Config& cfg, std::string_view key, std::strin
     if (key == "event_loop.idle_sleep_us" || key == "EventLoop.idle_sleep_us") {
         return assign_parsed(parse_u32(value), cfg.EventLoop.idle_sleep_us);
     }
+    if (key == "event_loop.adaptive_idle" || key == "EventLoop.adaptive_idle") {
+        return assign_parsed(parse_bool(value), cfg.EventLoop.adaptive_idle);
+    }
+    if (key == "event_loop.idle_spin_iterations" || key == "EventLoop.idle_spin_iterations") {
+        return assign_parsed(parse_u32(value), cfg.EventLoop.idle_spin_iterations);
+    }
+    if (key == "event_loop.idle_yield_iterations" || key == "EventLoop.idle_yield_iterations") {
+        return assign_parsed(parse_u32(value), cfg.EventLoop.idle_yield_iterations);
+    }
+    if (key == "event_loop.idle_park_timeout_us" || key == "EventLoop.idle_park_timeout_us") {
+        return assign_parsed(parse_u32(value), cfg.EventLoop.idle_park_timeout_us);
+    }
     if (key == "event_loop.stats_interval_ms" || key == "EventLoop.stats_interval_ms") {
         return assign_parsed(parse_u32(value), cfg.EventLoop.stats_interval_ms);
     }
+    if (key == "event_loop.response_preempt_batch" || key == "EventLoop.response_preempt_batch") {
+        return assign_parsed(parse_u32(value), cfg.EventLoop.response_preempt_batch);
+    }
     if (key == "event_loop.archive_terminal_orders" || key == "EventLoop.archive_terminal_orders") {
         return assign_parsed(parse_bool(value), cfg.EventLoop.archive_terminal_orders);
     }
@@ -483,6 +748,49 @@ ConfigValueApplyResult apply_value(Config& cfg, std::string_view key, std::strin
     if (key == "event_loop.cpu_core" || key == "EventLoop.cpu_core") {
         return assign_parsed(parse_i32(value), cfg.EventLoop.cpu_core);
     }
+    if (key == "event_loop.fifo_priority" || key == "EventLoop.fifo_priority") {
+        return assign_parsed(parse_i32(value), cfg.EventLoop.fifo_priority);
+    }
+    if (key == "event_loop.lock_memory" || key == "EventLoop.lock_memory") {
+        return assign_parsed(parse_bool(value), cfg.EventLoop.lock_memory);
+    }
+    if (key == "event_loop.warmup_orders" || key == "EventLoop.warmup_orders") {
+        return assign_parsed(parse_u32(value), cfg.EventLoop.warmup_orders);
+    }
+    if (key == "event_loop.checkpoint_interval_ms" || key == "EventLoop.checkpoint_interval_ms") {
+        return assign_parsed(parse_u32(value), cfg.EventLoop.checkpoint_interval_ms);
+    }
+    if (key == "event_loop.checkpoint_dir" || key == "EventLoop.checkpoint_dir") {
+        cfg.EventLoop.checkpoint_dir = value;
+        return {};
+    }
+    if (key == "event_loop.flight_recorder_threshold_us" || key == "EventLoop.flight_recorder_threshold_us") {
+        return assign_parsed(parse_u32(value), cfg.EventLoop.flight_recorder_threshold_us);
+    }
+    if (key == "event_loop.flight_recorder_context" || key == "EventLoop.flight_recorder_context") {
+        return assign_parsed(parse_u32(value), cfg.EventLoop.flight_recorder_context);
+    }
+    if (key == "event_loop.traffic_capture_records" || key == "EventLoop.traffic_capture_records") {
+        return assign_parsed(parse_u32(value), cfg.EventLoop.traffic_capture_records);
+    }
+    if (key == "event_loop.mark_to_market_interval_ms" || key == "EventLoop.mark_to_market_interval_ms") {
+        return assign_parsed(parse_u32(value), cfg.EventLoop.mark_to_market_interval_ms);
+    }
+    if (key == "event_loop.adaptive_batching" || key == "EventLoop.adaptive_batching") {
+        return assign_parsed(parse_bool(value), cfg.EventLoop.adaptive_batching);
+    }
+    if (key == "event_loop.iteration_budget_us" || key == "EventLoop.iteration_budget_us") {
+        return assign_parsed(parse_u32(value), cfg.EventLoop.iteration_budget_us);
+    }
+    if (key == "event_loop.response_share_pct" || key == "EventLoop.response_share_pct") {
+        return assign_parsed(parse_u32(value), cfg.EventLoop.response_share_pct);
+    }
+    if (key == "event_loop.queue_depth_sample_iterations" || key == "EventLoop.queue_depth_sample_iterations") {
+        return assign_parsed(parse_u32(value), cfg.EventLoop.queue_depth_sample_iterations);
+    }
+    if (key == "event_loop.admin_poll_iterations" || key == "EventLoop.admin_poll_iterations") {
+        return assign_parsed(parse_u32(value), cfg.EventLoop.admin_poll_iterations);
+    }
 
     if (key == "market_data.enabled") {
         return assign_parsed(parse_bool(value), cfg.market_data.enabled);
@@ -491,6 +799,14 @@ ConfigValueApplyResult apply_value(Config& cfg, std::string_view key, std::strin
         cfg.market_data.snapshot_shm_name = value;
         return {};
     }
+    if (key == "market_data.sz_snapshot_shm_name") {
+        cfg.market_data.sz_snapshot_shm_name = value;
+        return {};
+    }
+    if (key == "market_data.sh_snapshot_shm_name") {
+        cfg.market_data.sh_snapshot_shm_name = value;
+        return {};
+    }
     if (key == "market_data.allow_order_price_fallback") {
         return assign_parsed(parse_bool(value), cfg.market_data.allow_order_price_fallback);
     }
@@ -505,6 +821,10 @@ ConfigValueApplyResult apply_value(Config& cfg, std::string_view key, std::strin
     if (key == "active_strategy.signal_threshold") {
         return assign_parsed(parse_double(value), cfg.active_strategy.signal_threshold);
     }
+    if (key == "active_strategy.plugin_path") {
+        cfg.active_strategy.plugin_path = value;
+        return {};
+    }
 
     if (key == "risk.max_order_value") {
         return assign_parsed(parse_u64(value), cfg.risk.max_order_value);
@@ -518,12 +838,39 @@ ConfigValueApplyResult apply_value(Config& cfg, std::string_view key, std::strin
     if (key == "risk.max_orders_per_second") {
         return assign_parsed(parse_u32(value), cfg.risk.max_orders_per_second);
     }
+    if (key == "risk.max_orders_per_second_per_strategy") {
+        return assign_parsed(parse_u32(value), cfg.risk.max_orders_per_second_per_strategy);
+    }
+    if (key == "risk.max_orders_per_second_per_security") {
+        return assign_parsed(parse_u32(value), cfg.risk.max_orders_per_second_per_security);
+    }
+    if (key == "risk.rate_limit_burst_ms") {
+        return assign_parsed(parse_u32(value), cfg.risk.rate_limit_burst_ms);
+    }
     if (key == "risk.enable_price_limit_check") {
         return assign_parsed(parse_bool(value), cfg.risk.enable_price_limit_check);
     }
     if (key == "risk.enable_duplicate_check") {
         return assign_parsed(parse_bool(value), cfg.risk.enable_duplicate_check);
     }
+    if (key == "risk.enable_self_trade_check") {
+        return assign_parsed(parse_bool(value), cfg.risk.enable_self_trade_check);
+    }
+    if (key == "risk.max_firm_gross_value") {
+        return assign_parsed(parse_u64(value), cfg.risk.max_firm_gross_value);
+    }
+    if (key == "risk.max_firm_security_volume") {
+        return assign_parsed(parse_u64(value), cfg.risk.max_firm_security_volume);
+    }
+    if (key == "risk.max_order_to_trade_ratio") {
+        return assign_parsed(parse_u32(value), cfg.risk.max_order_to_trade_ratio);
+    }
+    if (key == "risk.max_cancel_ratio_pct") {
+        return assign_parsed(parse_u32(value), cfg.risk.max_cancel_ratio_pct);
+    }
+    if (key == "risk.order_ratio_min_orders") {
+        return assign_parsed(parse_u32(value), cfg.risk.order_ratio_min_orders);
+    }
     if (key == "risk.enable_fund_check") {
         return assign_parsed(parse_bool(value), cfg.risk.enable_fund_check);
     }
@@ -533,6 +880,12 @@ ConfigValueApplyResult apply_value(Config& cfg, std::string_view key, std::strin
     if (key == "risk.duplicate_window_ns") {
         return assign_parsed(parse_u64(value), cfg.risk.duplicate_window_ns);
     }
+    if (key == "risk.profile_rules") {
+        return assign_parsed(parse_bool(value), cfg.risk.profile_rules);
+    }
+    if (key == "risk.rule_reorder_interval") {
+        return assign_parsed(parse_u32(value), cfg.risk.rule_reorder_interval);
+    }
 
     if (key == "split.strategy") {
         return assign_parsed(parse_split_strategy(value), cfg.split.strategy);
@@ -552,6 +905,28 @@ ConfigValueApplyResult apply_value(Config& cfg, std::string_view key, std::strin
     if (key == "split.randomize_factor") {
         return assign_parsed(parse_double(value), cfg.split.randomize_factor);
     }
+    if (key == "split.max_sessions") {
+        return assign_parsed(parse_u32(value), cfg.split.max_sessions);
+    }
+    if (key == "split.eval_workers") {
+        return assign_parsed(parse_u32(value), cfg.split.eval_workers);
+    }
+    if (key == "split.child_risk_check") {
+        return assign_parsed(parse_bool(value), cfg.split.child_risk_check);
+    }
+    if (key == "split.child_max_order_volume") {
+        return assign_parsed(parse_u64(value), cfg.split.child_max_order_volume);
+    }
+    if (key == "split.child_max_order_value") {
+        return assign_parsed(parse_u64(value), cfg.split.child_max_order_value);
+    }
+    if (key == "split.coroutine_sessions") {
+        return assign_parsed(parse_bool(value), cfg.split.coroutine_sessions);
+    }
+    if (key == "split.vwap_profile_path") {
+        cfg.split.vwap_profile_path = value;
+        return {};
+    }
 
     if (key == "log.log_dir") {
         cfg.log.log_dir = value;
@@ -581,6 +956,24 @@ ConfigValueApplyResult apply_value(Config& cfg, std::string_view key, std::strin
     if (key == "business_log.flush_interval_ms") {
         return assign_parsed(parse_u32(value), cfg.business_log.flush_interval_ms);
     }
+    if (key == "business_log.sync_interval_ms") {
+        return assign_parsed(parse_u32(value), cfg.business_log.sync_interval_ms);
+    }
+    if (key == "business_log.binary_journal") {
+        return assign_parsed(parse_bool(value), cfg.business_log.binary_journal);
+    }
+    if (key == "business_log.journal_segment_records") {
+        return assign_parsed(parse_u32(value), cfg.business_log.journal_segment_records);
+    }
+    if (key == "business_log.delta_records") {
+        return assign_parsed(parse_bool(value), cfg.business_log.delta_records);
+    }
+    if (key == "business_log.writer_cpu_core") {
+        return assign_parsed(parse_i32(value), cfg.business_log.writer_cpu_core);
+    }
+    if (key == "business_log.writer_priority") {
+        return assign_parsed(parse_i32(value), cfg.business_log.writer_priority);
+    }
 
     if (key == "db.db_path") {
         cfg.db.db_path = value;
@@ -592,6 +985,46 @@ ConfigValueApplyResult apply_value(Config& cfg, std::string_view key, std::strin
     if (key == "db.sync_interval_ms") {
         return assign_parsed(parse_u32(value), cfg.db.sync_interval_ms);
     }
+    if (key == "db.position_snapshot_path") {
+        cfg.db.position_snapshot_path = value;
+        return {};
+    }
+    if (key == "db.trade_store_dir") {
+        cfg.db.trade_store_dir = value;
+        return {};
+    }
+
+    if (key == "gateway.in_process") {
+        return assign_parsed(parse_bool(value), cfg.gateway.in_process);
+    }
+    if (key == "gateway.config_file") {
+        cfg.gateway.config_file = value;
+        return {};
+    }
+    if (key == "gateway.inline_poll") {
+        return assign_parsed(parse_bool(value), cfg.gateway.inline_poll);
+    }
+
+    if (key == "replication.role") {
+        return assign_parsed(parse_replication_role(value), cfg.replication.role);
+    }
+    if (key == "replication.peer_host") {
+        cfg.replication.peer_host = value;
+        return {};
+    }
+    if (key == "replication.bind_address") {
+        cfg.replication.bind_address = value;
+        return {};
+    }
+    if (key == "replication.port") {
+        return assign_parsed(parse_u32(value), cfg.replication.port);
+    }
+    if (key == "replication.batch_records") {
+        return assign_parsed(parse_u32(value), cfg.replication.batch_records);
+    }
+    if (key == "replication.cpu_core") {
+        return assign_parsed(parse_i32(value), cfg.replication.cpu_core);
+    }
 
     return std::unexpected(ConfigValueParseError::UnknownKey);
 }
@@ -741,7 +1174,8 @@ bool ConfigManager::load_from_file(const std::string& config_path) {
     if (root && root.IsMap()) {
         if (!check_allowed_keys(root, "",
                                 {"account_id", "trading_day", "shm", "event_loop", "EventLoop", "market_data",
-                                 "active_strategy", "risk", "split", "log", "business_log", "db"})) {
+                                 "active_strategy", "risk", "split", "log", "business_log", "db", "gateway",
+                                 "replication"})) {
             return false;
         }
 
@@ -771,41 +1205,64 @@ bool ConfigManager::load_from_file(const std::string& config_path) {
 
         if (!parse_section(loaded, root, "shm",
                            {"upstream_shm_name", "downstream_shm_name", "trades_shm_name", "orders_shm_name",
-                            "positions_shm_name", "create_if_not_exist"})) {
+                            "positions_shm_name", "stats_shm_name", "firm_risk_shm_name", "security_master_shm_name",
+                            "create_if_not_exist", "upstream_lane_count", "huge_pages", "prefault", "hugetlb_arena",
+                            "numa_node", "orders_capacity", "orders_overflow_segments",
+                            "orders_index", "risk_params", "admin_channel", "downstream_inline_orders",
+                            "upstream_inline_orders", "next_trading_day"})) {
             return false;
         }
 
         if (!parse_section(loaded, root, "event_loop",
-                           {"busy_polling", "poll_batch_size", "idle_sleep_us", "stats_interval_ms",
-                            "archive_terminal_orders", "terminal_archive_delay_ms", "pin_cpu", "cpu_core"})) {
+                           {"busy_polling", "poll_batch_size", "idle_sleep_us", "adaptive_idle", "idle_spin_iterations",
+                            "idle_yield_iterations", "idle_park_timeout_us", "stats_interval_ms",
+                            "response_preempt_batch", "archive_terminal_orders", "terminal_archive_delay_ms",
+                            "pin_cpu", "cpu_core", "fifo_priority", "lock_memory", "warmup_orders",
+                            "checkpoint_interval_ms", "checkpoint_dir", "flight_recorder_threshold_us",
+                            "flight_recorder_context", "traffic_capture_records", "mark_to_market_interval_ms",
+                            "adaptive_batching", "iteration_budget_us", "response_share_pct",
+                            "queue_depth_sample_iterations", "admin_poll_iterations"})) {
             return false;
         }
 
         if (!parse_section(loaded, root, "EventLoop",
-                           {"busy_polling", "poll_batch_size", "idle_sleep_us", "stats_interval_ms",
-                            "archive_terminal_orders", "terminal_archive_delay_ms", "pin_cpu", "cpu_core"})) {
+                           {"busy_polling", "poll_batch_size", "idle_sleep_us", "adaptive_idle", "idle_spin_iterations",
+                            "idle_yield_iterations", "idle_park_timeout_us", "stats_interval_ms",
+                            "response_preempt_batch", "archive_terminal_orders", "terminal_archive_delay_ms",
+                            "pin_cpu", "cpu_core", "fifo_priority", "lock_memory", "warmup_orders",
+                            "checkpoint_interval_ms", "checkpoint_dir", "flight_recorder_threshold_us",
+                            "flight_recorder_context", "traffic_capture_records", "mark_to_market_interval_ms",
+                            "adaptive_batching", "iteration_budget_us", "response_share_pct",
+                            "queue_depth_sample_iterations", "admin_poll_iterations"})) {
             return false;
         }
 
         if (!parse_section(loaded, root, "market_data",
-                           {"enabled", "snapshot_shm_name", "allow_order_price_fallback"})) {
+                           {"enabled", "snapshot_shm_name", "sz_snapshot_shm_name", "sh_snapshot_shm_name",
+                            "allow_order_price_fallback"})) {
             return false;
         }
 
-        if (!parse_section(loaded, root, "active_strategy", {"enabled", "name", "signal_threshold"})) {
+        if (!parse_section(loaded, root, "active_strategy", {"enabled", "name", "signal_threshold", "plugin_path"})) {
             return false;
         }
 
         if (!parse_section(loaded, root, "risk",
                            {"max_order_value", "max_order_volume", "max_daily_turnover", "max_orders_per_second",
-                            "enable_price_limit_check", "enable_duplicate_check", "enable_fund_check",
-                            "enable_position_check", "duplicate_window_ns"})) {
+                            "max_orders_per_second_per_strategy", "max_orders_per_second_per_security",
+                            "rate_limit_burst_ms", "enable_price_limit_check", "enable_duplicate_check",
+                            "enable_fund_check", "enable_position_check", "enable_self_trade_check",
+                            "max_firm_gross_value", "max_firm_security_volume", "max_order_to_trade_ratio",
+                            "max_cancel_ratio_pct", "order_ratio_min_orders", "duplicate_window_ns",
+                            "profile_rules", "rule_reorder_interval"})) {
             return false;
         }
 
         if (!parse_section(loaded, root, "split",
                            {"strategy", "max_child_volume", "min_child_volume", "max_child_count", "interval_ms",
-                            "randomize_factor"})) {
+                            "randomize_factor", "max_sessions", "eval_workers", "child_risk_check",
+                            "child_max_order_volume", "child_max_order_value", "coroutine_sessions",
+                            "vwap_profile_path"})) {
             return false;
         }
 
@@ -814,11 +1271,24 @@ bool ConfigManager::load_from_file(const std::string& config_path) {
         }
 
         if (!parse_section(loaded, root, "business_log",
-                           {"enabled", "output_dir", "queue_capacity", "flush_interval_ms"})) {
+                           {"enabled", "output_dir", "queue_capacity", "flush_interval_ms", "sync_interval_ms",
+                            "binary_journal", "journal_segment_records", "delta_records", "writer_cpu_core",
+                            "writer_priority"})) {
             return false;
         }
 
-        if (!parse_section(loaded, root, "db", {"db_path", "enable_persistence", "sync_interval_ms"})) {
+        if (!parse_section(loaded, root, "db",
+                           {"db_path", "enable_persistence", "sync_interval_ms", "position_snapshot_path",
+                            "trade_store_dir"})) {
+            return false;
+        }
+
+        if (!parse_section(loaded, root, "gateway", {"in_process", "config_file", "inline_poll"})) {
+            return false;
+        }
+
+        if (!parse_section(loaded, root, "replication",
+                           {"role", "peer_host", "bind_address", "port", "batch_records", "cpu_core"})) {
             return false;
         }
     }
@@ -979,6 +1449,26 @@ bool ConfigManager::validate() const {
         (void)report_config_error(ErrorCode::ConfigValidateFailed, "shm names must be non-empty");
         return false;
     }
+    if (config_.shm.upstream_lane_count == 0 || config_.shm.upstream_lane_count > kMaxUpstreamLanes) {
+        (void)report_config_error(ErrorCode::ConfigValidateFailed, "shm upstream_lane_count must be in [1, kMaxUpstreamLanes]");
+        return false;
+    }
+    if (config_.shm.orders_capacity == 0 || config_.shm.orders_capacity > kDailyOrderPoolCapacity) {
+        (void)report_config_error(
+            ErrorCode::ConfigValidateFailed, "shm orders_capacity must be in [1, kDailyOrderPoolCapacity]");
+        return false;
+    }
+    if (config_.shm.orders_overflow_segments > kMaxOrdersOverflowSegments) {
+        (void)report_config_error(ErrorCode::ConfigValidateFailed,
+                                  "shm orders_overflow_segments must be in [0, kMaxOrdersOverflowSegments]");
+        return false;
+    }
+    if (!config_.shm.next_trading_day.empty() && (!is_valid_trading_day_value(config_.shm.next_trading_day) ||
+                                                  config_.shm.next_trading_day == config_.trading_day)) {
+        (void)report_config_error(
+            ErrorCode::ConfigValidateFailed, "shm next_trading_day must be YYYYMMDD and differ from trading_day");
+        return false;
+    }
 
     if (config_.market_data.enabled && config_.market_data.snapshot_shm_name.empty()) {
         (void)report_config_error(ErrorCode::ConfigValidateFailed, "market_data snapshot_shm_name must be non-empty");
@@ -999,12 +1489,71 @@ bool ConfigManager::validate() const {
         (void)report_config_error(ErrorCode::ConfigValidateFailed, "poll_batch_size must be non-zero");
         return false;
     }
+    if (config_.EventLoop.adaptive_idle && config_.EventLoop.idle_park_timeout_us == 0) {
+        (void)report_config_error(ErrorCode::ConfigValidateFailed, "adaptive_idle requires idle_park_timeout_us > 0");
+        return false;
+    }
+    if (config_.EventLoop.adaptive_batching &&
+        (config_.EventLoop.iteration_budget_us == 0 || config_.EventLoop.response_share_pct > 100)) {
+        (void)report_config_error(ErrorCode::ConfigValidateFailed,
+                                  "adaptive_batching requires iteration_budget_us > 0 and response_share_pct <= 100");
+        return false;
+    }
+    if (config_.EventLoop.checkpoint_interval_ms > 0 && config_.EventLoop.checkpoint_dir.empty()) {
+        (void)report_config_error(ErrorCode::ConfigValidateFailed, "checkpoint_interval_ms requires checkpoint_dir");
+        return false;
+    }
+    if (config_.EventLoop.fifo_priority < 0 || config_.EventLoop.fifo_priority > kMaxFifoPriority ||
+        config_.business_log.writer_priority < 0 || config_.business_log.writer_priority > kMaxFifoPriority) {
+        (void)report_config_error(ErrorCode::ConfigValidateFailed, "SCHED_FIFO priority must be in [0, 99]");
+        return false;
+    }
+    if (config_.EventLoop.flight_recorder_context > kMaxFlightRecorderContext) {
+        (void)report_config_error(ErrorCode::ConfigValidateFailed, "flight_recorder_context too large");
+        return false;
+    }
+    if (config_.gateway.in_process && config_.gateway.config_file.empty()) {
+        (void)report_config_error(ErrorCode::ConfigValidateFailed, "gateway.in_process requires gateway.config_file");
+        return false;
+    }
+    if (config_.replication.role != ReplicationRole::None) {
+        const ReplicationConfig& replication = config_.replication;
+        if (replication.port == 0 || replication.port > 65535) {
+            (void)report_config_error(ErrorCode::ConfigValidateFailed, "replication.port must be in [1, 65535]");
+            return false;
+        }
+        if (replication.role == ReplicationRole::Primary && replication.peer_host.empty()) {
+            (void)report_config_error(ErrorCode::ConfigValidateFailed, "replication primary requires peer_host");
+            return false;
+        }
+        if (replication.batch_records == 0 || replication.batch_records > kMaxReplicationBatchRecords) {
+            (void)report_config_error(ErrorCode::ConfigValidateFailed,
+                                      "replication.batch_records must be in [1, 1024]");
+            return false;
+        }
+        // 影子模式不向柜台发单，进程内网关会把备机重放出的订单真的发出去
+        if (replication.role == ReplicationRole::Standby && config_.gateway.in_process) {
+            (void)report_config_error(ErrorCode::ConfigValidateFailed,
+                                      "replication standby cannot run with gateway.in_process");
+            return false;
+        }
+    }
 
     if (config_.split.strategy != SplitStrategy::None && config_.split.max_child_count == 0) {
         (void)report_config_error(ErrorCode::ConfigValidateFailed, "split max_child_count must be non-zero");
         return false;
     }
 
+    if (config_.split.max_sessions == 0) {
+        (void)report_config_error(ErrorCode::ConfigValidateFailed, "split max_sessions must be non-zero");
+        return false;
+    }
+
+    if (config_.split.eval_workers > kMaxEvalWorkers) {
+        (void)report_config_error(ErrorCode::ConfigValidateFailed, "split eval_workers exceeds 64");
+        return false;
+    }
+
     if (config_.business_log.enabled) {
         if (config_.business_log.output_dir.empty()) {
             (void)report_config_error(ErrorCode::ConfigValidateFailed, "business_log output_dir must be non-empty");
@@ -1024,6 +1573,11 @@ bool ConfigManager::validate() const {
                                       "business_log flush_interval_ms must be non-zero");
             return false;
         }
+        if (config_.business_log.binary_journal && config_.business_log.journal_segment_records == 0) {
+            (void)report_config_error(ErrorCode::ConfigValidateFailed,
+                                      "business_log journal_segment_records must be non-zero");
+            return false;
+        }
     }
 
     return true;
@@ -1053,6 +1607,10 @@ const BusinessLogConfig& ConfigManager::business_log() const noexcept { return c
 
 const DBConfig& ConfigManager::db() const noexcept { return config_.db; }
 
+const InProcessGatewayConfig& ConfigManager::gateway() const noexcept { return config_.gateway; }
+
+const ReplicationConfig& ConfigManager::replication() const noexcept { return config_.replication; }
+
 bool ConfigManager::reload() {
     if (config_path_.empty()) {
         return report_config_error(ErrorCode::InvalidState, "reload requested before load_from_file");
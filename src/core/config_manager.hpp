@@ -16,7 +16,23 @@ struct SHMConfig {
     std::string trades_shm_name = "/trades_shm";
     std::string orders_shm_name = "/orders_shm";
     std::string positions_shm_name = "/positions_shm";
+    std::string stats_shm_name = "/stats_shm";  // 事件循环分阶段延迟统计 SHM，空字符串表示不导出
+    std::string firm_risk_shm_name = "/firm_risk_shm";  // 跨账户风控合计 SHM（聚合进程创建），配置公司级限额时只读接入
+    std::string security_master_shm_name;  // 主机级证券主数据 SHM（每日发布一次），非空且当日已发布时替代逐账户解析价格带
     bool create_if_not_exist = true;
+    uint32_t upstream_lane_count = 1;  // 上游生产者 lane 数（1=单策略进程，>1 时各策略进程独占一条 lane）
+    bool huge_pages = false;           // 各段映射 madvise(MADV_HUGEPAGE)，降低大段随机访问的 TLB miss
+    bool prefault = false;             // 映射后预取全部页面，避免首笔订单承担缺页
+    bool hugetlb_arena = false;        // huge_pages 开启时进程内大数组先从 hugetlb 预留池映射，池不足回落透明大页
+    int numa_node = -1;                // 映射绑定的 NUMA 节点；-1 表示事件循环绑核时跟随 cpu_core 所在节点
+    uint32_t orders_capacity = kDailyOrderPoolCapacity;  // 订单池槽位数，同时决定订单簿容量，按账户日内订单量配置
+    uint32_t orders_overflow_segments = 1;  // 订单池写满前可后台链上的同容量溢出段数，0 关闭
+    bool orders_index = false;  // 维护订单池二级索引段（orders_shm_name + "_idx"），供监控按证券/策略/在途查询
+    bool risk_params = false;  // 发布无状态风控参数段（upstream_shm_name + "_risk"），下单 API 据此在占用槽位前预检
+    bool admin_channel = false;  // 建运维指令段（upstream_shm_name + "_admin"），事件循环轮询执行运维指令
+    bool downstream_inline_orders = false;  // 下游改发 64 字节内联订单消息，网关无需回读订单池槽位
+    bool upstream_inline_orders = false;    // 上游 lane 另推 64 字节内联订单消息，账户服务出队时只回写槽位阶段
+    std::string next_trading_day;  // 非空时进入运行态后后台预建并预取该交易日订单池，供在服换日；空字符串关闭
 };
 
 // 事件循环配置
@@ -24,17 +40,38 @@ struct EventLoopConfig {
     bool busy_polling = true;
     uint32_t poll_batch_size = 64;
     uint32_t idle_sleep_us = 0;
+    bool adaptive_idle = false;           // 空闲时分级退避（自旋 -> yield -> 门铃挂起），开启后忽略 busy_polling/idle_sleep_us
+    uint32_t idle_spin_iterations = 2000;  // 退避自旋轮数
+    uint32_t idle_yield_iterations = 200;  // 退避 sched_yield 轮数
+    uint32_t idle_park_timeout_us = 1000;  // 单次挂起上限（微秒）
     uint32_t stats_interval_ms = 1000;
+    uint32_t response_preempt_batch = 0;  // 成交回报每排空这么多笔检查一次上游，有待处理订单时先处理上游；0 关闭
     bool archive_terminal_orders = false;
     uint32_t terminal_archive_delay_ms = 2000;
     bool pin_cpu = false;
     int cpu_core = -1;
+    int fifo_priority = 0;     // 事件循环线程 SCHED_FIFO 优先级 1-99，0 保持默认调度
+    bool lock_memory = false;  // 启动时 mlockall(MCL_CURRENT|MCL_FUTURE)，失败只告警
+    uint32_t warmup_orders = 0;  // 启动预热的合成订单笔数，0 关闭；预热完成前服务不进入 Ready
+    uint32_t checkpoint_interval_ms = 0;    // 重启检查点采集周期，0 关闭；开启后启动时优先按检查点恢复
+    std::string checkpoint_dir = "./data";  // 重启检查点目录
+    uint32_t flight_recorder_threshold_us = 0;  // 单轮工作耗时超过该值时转储前后若干轮记录，0 关闭
+    uint32_t flight_recorder_context = 16;      // 异常轮前后各转储的轮数
+    uint32_t traffic_capture_records = 0;       // 录制上游出队与回报出队流量的预分配记录数，0 关闭
+    uint32_t mark_to_market_interval_ms = 0;    // 持仓浮动盈亏按行情盯市的周期（需开启 market_data），0 关闭
+    bool adaptive_batching = false;    // 按队列深度与单轮时间预算分配各类出队额度，开启后 poll_batch_size 只作单类上限
+    uint32_t iteration_budget_us = 50;  // 自适应批量的单轮工作预算（微秒），含 tick 与归档
+    uint32_t response_share_pct = 25;   // 自适应批量中回报与优先撤单合计的保底份额（百分比）
+    uint32_t queue_depth_sample_iterations = 64;  // 每隔这么多轮采样一次所排空队列的深度写入统计段直方图，0 关闭
+    uint32_t admin_poll_iterations = 256;  // 开启 shm.admin_channel 时每隔这么多轮取一次运维指令，0 不取
 };
 
 // 行情读取配置
 struct MarketDataConfig {
     bool enabled = false;
-    std::string snapshot_shm_name = "/signal_xshg_v2";
+    std::string snapshot_shm_name = "/signal_xshg_v2";  // 默认快照源，未单独配置的市场都读这里
+    std::string sz_snapshot_shm_name;                   // 深市快照源，空表示沿用默认源
+    std::string sh_snapshot_shm_name;                   // 沪市快照源，空表示沿用默认源
     bool allow_order_price_fallback = false;
 };
 
@@ -43,6 +80,7 @@ struct ActiveStrategyConfig {
     bool enabled = false;
     std::string name = "none";
     double signal_threshold = 0.0;
+    std::string plugin_path;  // 非空时从该 .so 插件加载策略，name 需与插件 name() 一致
 };
 
 // 日志配置
@@ -58,6 +96,33 @@ struct DBConfig {
     std::string db_path;
     bool enable_persistence = true;
     uint32_t sync_interval_ms = 1000;
+    std::string position_snapshot_path;  // 盘后生成的二进制持仓镜像；存在时 fresh SHM 优先用它装载持仓
+    std::string trade_store_dir;  // 当日成交库目录；非空时成交记录直接写入 trades_<account>_<day>.bin，重启扫描恢复
+};
+
+// 进程内网关配置：开启后账户服务按 config_file 指定的网关配置加载适配器，在本进程内运行网关阶段，
+// 不再需要独立的 acct_broker_gateway_main 进程
+struct InProcessGatewayConfig {
+    bool in_process = false;
+    std::string config_file = "config/gateway.yaml";  // 网关 YAML（broker_type/adapter_so/分片/重试等），shm 名被忽略
+    bool inline_poll = false;  // true：在事件循环线程上每轮内联执行；false：在兄弟线程上运行网关循环
+};
+
+// 热备复制角色：primary 把上游订单与成交回报按处理顺序发给备机，standby 以影子模式经同一组事件循环处理函数重放
+enum class ReplicationRole : uint8_t {
+    None = 0,
+    Primary = 1,
+    Standby = 2,
+};
+
+// 热备复制配置：primary 主动连接 peer_host:port，standby 监听 bind_address:port；两端账户与交易日须一致
+struct ReplicationConfig {
+    ReplicationRole role = ReplicationRole::None;
+    std::string peer_host;                   // primary：备机地址（IPv4 或主机名）
+    std::string bind_address = "0.0.0.0";    // standby：监听地址
+    uint32_t port = 0;
+    uint32_t batch_records = 64;             // primary：单帧最多携带的记录数
+    int cpu_core = -1;                       // 发送/接收线程绑核，-1 不绑
 };
 
 // 完整配置
@@ -75,6 +140,8 @@ struct Config {
     LogConfig log;
     BusinessLogConfig business_log;
     DBConfig db;
+    InProcessGatewayConfig gateway;
+    ReplicationConfig replication;
 };
 
 // 配置管理器
@@ -107,9 +174,13 @@ public:
     const LogConfig& log() const noexcept;
     const BusinessLogConfig& business_log() const noexcept;
     const DBConfig& db() const noexcept;
+    const InProcessGatewayConfig& gateway() const noexcept;
+    const ReplicationConfig& replication() const noexcept;
 
     // 热更新支持
     bool reload();
+    // 最近一次 load_from_file 的路径
+    const std::string& config_path() const noexcept { return config_path_; }
 
     // 将当前配置序列化为日志文本
     std::string to_log_string() const;
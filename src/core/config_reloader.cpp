@@ -0,0 +1,136 @@
+#include "core/config_reloader.hpp"
+
+#include <chrono>
+#include <csignal>
+#include <utility>
+
+#include "common/log.hpp"
+#include "core/config_manager.hpp"
+#include "core/event_loop.hpp"
+#include "core/orders_rollover.hpp"
+#include "shm/orders_shm.hpp"
+
+namespace acct_service {
+
+namespace {
+
+constexpr std::chrono::milliseconds kReloadPollInterval{100};  // 轮询进程级请求代数的间隔
+constexpr std::chrono::milliseconds kPublishRetryInterval{1};
+constexpr uint32_t kMaxPublishRetries = 5000;  // 循环停转时放弃本次发布
+
+std::atomic<uint64_t> g_reload_generation{0};
+
+void reload_signal_handler(int signo) {
+    (void)signo;
+    request_process_config_reload();
+}
+
+}  // namespace
+
+void request_process_config_reload() noexcept { g_reload_generation.fetch_add(1, std::memory_order_relaxed); }
+
+void install_config_reload_signal_handler() {
+    struct sigaction sa {};
+    sa.sa_handler = reload_signal_handler;
+    sigemptyset(&sa.sa_mask);
+    sa.sa_flags = SA_RESTART;
+    sigaction(SIGHUP, &sa, nullptr);
+}
+
+config_reloader::~config_reloader() { stop(); }
+
+bool config_reloader::start(std::string config_path, EventLoop& loop, orders_day_roller* roller) {
+    stop();
+    config_path_ = std::move(config_path);
+    loop_ = &loop;
+    roller_ = roller;
+    seen_generation_ = g_reload_generation.load(std::memory_order_relaxed);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_requested_ = false;
+        reload_requested_ = false;
+    }
+    thread_ = std::thread([this]() { reload_loop(); });
+    return true;
+}
+
+void config_reloader::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_requested_ = true;
+    }
+    cv_.notify_all();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+void config_reloader::request_reload() noexcept {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        reload_requested_ = true;
+    }
+    cv_.notify_one();
+}
+
+void config_reloader::reload_loop() {
+    for (;;) {
+        bool requested = false;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            cv_.wait_for(lock, kReloadPollInterval, [this]() { return reload_requested_ || stop_requested_; });
+            if (stop_requested_) {
+                return;
+            }
+            requested = reload_requested_;
+            reload_requested_ = false;
+        }
+
+        const uint64_t generation = g_reload_generation.load(std::memory_order_relaxed);
+        if (generation != seen_generation_) {
+            seen_generation_ = generation;
+            requested = true;
+        }
+        if (requested) {
+            reload_once();
+        }
+    }
+}
+
+void config_reloader::reload_once() {
+    ConfigManager reloaded;
+    if (!reloaded.load_from_file(config_path_)) {
+        failed_.fetch_add(1, std::memory_order_release);
+        ACCT_LOG_WARN("config_reloader", "config reload rejected, keeping current config");
+        return;
+    }
+    if (roller_) {
+        const SHMConfig& shm_cfg = reloaded.shm();
+        if (!shm_cfg.next_trading_day.empty() && !roller_->prepared(shm_cfg.next_trading_day)) {
+            (void)roller_->prepare(shm_cfg.next_trading_day);
+        }
+        // 只向后换日；配置仍写着已切出的交易日时不再触发
+        if (trading_day_number(reloaded.get().trading_day) > trading_day_number(roller_->trading_day())) {
+            (void)roller_->request_rollover(reloaded.get().trading_day);
+        }
+    }
+
+    for (uint32_t attempt = 0; attempt < kMaxPublishRetries; ++attempt) {
+        if (loop_->publish_config(reloaded.EventLoop(), reloaded.risk())) {
+            published_.fetch_add(1, std::memory_order_release);
+            ACCT_LOG_INFO("config_reloader", "published reloaded config");
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (stop_requested_) {
+                return;
+            }
+        }
+        std::this_thread::sleep_for(kPublishRetryInterval);
+    }
+    failed_.fetch_add(1, std::memory_order_release);
+    ACCT_LOG_WARN("config_reloader", "event loop did not pick up previous config, reload dropped");
+}
+
+}  // namespace acct_service
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace acct_service {
+
+class EventLoop;
+class orders_day_roller;
+
+// 进程级重载请求：只递增原子代数，可在信号处理中调用；各 config_reloader 按代数变化各自重载
+void request_process_config_reload() noexcept;
+
+// 把 SIGHUP 绑定到 request_process_config_reload()
+void install_config_reload_signal_handler();
+
+// 配置热更新线程：收到重载请求后在后台重新解析并校验配置文件，经 EventLoop::publish_config 发布；
+// 解析、校验与发布重试都不占用事件循环线程，循环侧每轮只有一次 acquire 读。解析失败时保留当前配置。
+// 绑定换日线程时，重载出的 shm.next_trading_day 触发预建，trading_day 变化触发在服换日
+class config_reloader {
+public:
+    config_reloader() = default;
+    ~config_reloader();
+
+    config_reloader(const config_reloader&) = delete;
+    config_reloader& operator=(const config_reloader&) = delete;
+
+    // 启动后台线程；启动时刻之前的进程级请求不触发重载
+    bool start(std::string config_path, EventLoop& loop, orders_day_roller* roller = nullptr);
+    void stop();
+
+    // 请求重载本实例的配置
+    void request_reload() noexcept;
+
+    uint64_t published_count() const noexcept { return published_.load(std::memory_order_acquire); }
+    uint64_t failed_count() const noexcept { return failed_.load(std::memory_order_acquire); }
+
+private:
+    void reload_loop();
+    // 重新解析并发布一次；循环尚未取走上一版时短暂等待后重试
+    void reload_once();
+
+    std::string config_path_;
+    EventLoop* loop_ = nullptr;
+    orders_day_roller* roller_ = nullptr;
+    uint64_t seen_generation_ = 0;  // 已处理的进程级请求代数，仅后台线程使用
+    bool reload_requested_ = false;
+    bool stop_requested_ = false;
+    std::atomic<uint64_t> published_{0};
+    std::atomic<uint64_t> failed_{0};
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::thread thread_;
+};
+
+}  // namespace acct_service
@@ -1,8 +1,11 @@
 #include "core/event_loop.hpp"
 
+#include <algorithm>
+#include <array>
 #include <chrono>
 #include <csignal>
 #include <cstdio>
+#include <cstring>
 #include <limits>
 #include <thread>
 #include <vector>
@@ -10,14 +13,14 @@
 #include "common/error.hpp"
 #include "common/log.hpp"
 #include "common/security_identity.hpp"
+#include "common/thread_setup.hpp"
 #include "execution/execution_engine.hpp"
+#include "order/order_state_machine.hpp"
 #include "portfolio/account_info.hpp"
+#include "shm/admin_shm.hpp"
+#include "shm/orders_index_shm.hpp"
 #include "shm/orders_shm.hpp"
-
-#if defined(__linux__)
-#include <sched.h>
-#include <unistd.h>
-#endif
+#include "shm/upstream_lanes.hpp"
 
 namespace acct_service {
 
@@ -25,6 +28,50 @@ namespace {
 
 std::atomic<EventLoop*> g_active_loop{nullptr};
 
+// 单次批量出队的栈上缓冲上限；poll_batch_size 更大时按块循环出队。
+constexpr std::size_t kMaxDrainChunk = 256;
+
+// 块内流水预取距离：处理第 i 项前为第 i+k 项发起槽位/订单条目预取，为第 i+1 项预取其依赖的持仓行与订单槽位
+constexpr std::size_t kDrainPrefetchDistance = 8;
+
+// 终态归档时间轮精度与预分配容量（收盘前集中终态时避免扩容）。
+constexpr TimestampNs kArchiveTimerResolutionNs = 1000000ULL;
+constexpr std::size_t kArchiveTimerCapacity = kMaxActiveOrders / 4;
+
+// 指标发布周期：只在周期到达时读统计与队列游标，轮内热路径不碰指标槽位
+constexpr TimestampNs kMetricsPublishIntervalNs = 1000000ULL;
+
+// 内存占用发布周期：取值要遍历各组件并持簿锁，只需跟上秒级监控
+constexpr TimestampNs kMemoryPublishIntervalNs = 1000000000ULL;
+
+// 影子模式单次从收件环取出的记录数（栈上缓冲，单条 320 字节）
+constexpr std::size_t kReplicationApplyChunk = 64;
+
+// 自适应批量时有积压的每类至少出队的笔数
+constexpr std::size_t kAdaptiveMinBatch = 8;
+
+std::size_t fixed_batch_limit(const EventLoopConfig& config) noexcept {
+    return config.poll_batch_size == 0 ? 1 : config.poll_batch_size;
+}
+
+// poll_batch_size 作为每类单轮上限
+batch_budget_policy make_batch_policy(const EventLoopConfig& config) noexcept {
+    const std::size_t max_batch = fixed_batch_limit(config);
+    return batch_budget_policy{static_cast<uint64_t>(config.iteration_budget_us) * 1000ULL, config.response_share_pct,
+                               std::min(kAdaptiveMinBatch, max_batch), max_batch};
+}
+
+// 内联下标只会回写槽位首行的阶段与打点，只预取该行；普通下标预取整个槽位
+void prefetch_upstream_slot(const orders_shm_layout* shm, OrderIndex entry) noexcept {
+    if ((entry & kUpstreamInlineIndexFlag) == 0) {
+        orders_shm_prefetch_slot(shm, entry);
+        return;
+    }
+    if (const OrderSlot* slot = orders_shm_find_slot(shm, entry & ~kUpstreamInlineIndexFlag)) {
+        __builtin_prefetch(slot, 1, 3);
+    }
+}
+
 void signal_handler(int signo) {
     (void)signo;
     EventLoop* loop = g_active_loop.load(std::memory_order_acquire);
@@ -33,21 +80,16 @@ void signal_handler(int signo) {
     }
 }
 
-bool is_terminal_state(OrderState status) {
-    switch (status) {
-        case OrderState::RiskControllerRejected:
-        case OrderState::TraderRejected:
-        case OrderState::TraderError:
-        case OrderState::BrokerRejected:
-        case OrderState::MarketRejected:
-        case OrderState::Finished:
-        case OrderState::Unknown:
-            return true;
-        default:
-            return false;
+void promotion_signal_handler(int signo) {
+    (void)signo;
+    EventLoop* loop = g_active_loop.load(std::memory_order_acquire);
+    if (loop) {
+        loop->request_promotion();
     }
 }
 
+constexpr bool is_terminal_state(OrderState status) noexcept { return order_state_is_terminal(status); }
+
 bool try_calculate_trade_value(Volume volume, DPrice price, DValue& out_value) {
     const __uint128_t value = static_cast<__uint128_t>(volume) * static_cast<__uint128_t>(price);
     if (value > static_cast<__uint128_t>(std::numeric_limits<DValue>::max())) {
@@ -79,7 +121,8 @@ EventLoop::EventLoop(const EventLoopConfig& config, upstream_shm_layout* upstrea
                      downstream_shm_layout* downstream_shm, trades_shm_layout* trades_shm,
                      orders_shm_layout* orders_shm, OrderBook& OrderBook, order_router& router,
                      PositionManager& positions, RiskManager& risk, const account_info* account_info,
-                     ExecutionEngine* execution_engine, OrderEventRecorder* order_event_recorder)
+                     ExecutionEngine* execution_engine, OrderEventRecorder* order_event_recorder,
+                     stats_shm_layout* stats_shm, restart_checkpoint_writer* checkpoint_writer)
     : config_(config),
       upstream_shm_(upstream_shm),
       downstream_shm_(downstream_shm),
@@ -91,9 +134,39 @@ EventLoop::EventLoop(const EventLoopConfig& config, upstream_shm_layout* upstrea
       risk_(risk),
       account_info_(account_info),
       execution_engine_(execution_engine),
-      order_event_recorder_(order_event_recorder) {
-    order_book_.set_change_callback(
-        [this](const OrderEntry& entry, order_book_event_t event) { on_order_book_changed(entry, event); });
+      order_event_recorder_(order_event_recorder),
+      checkpoint_writer_(checkpoint_writer),
+      stage_latency_(stats_shm ? &stats_shm->stages : &local_stage_latency_),
+      idle_backoff_(idle_policy{config.idle_spin_iterations, config.idle_yield_iterations,
+                                config.idle_park_timeout_us}),
+      batch_scheduler_(make_batch_policy(config)),
+      archive_timers_(kArchiveTimerResolutionNs, config.archive_terminal_orders ? kArchiveTimerCapacity : 0) {
+    order_book_.set_change_hook(order_observers_.hook());
+    // 自成交检查按订单簿容量建表，检查点恢复进订单簿的在簿订单先补登一遍
+    if (risk_.config().enable_self_trade_check) {
+        risk_.track_resting_orders(order_book_.capacity());
+        order_book_.for_each_active([this](const OrderEntry& entry) { risk_.on_order_update(entry.request); });
+    }
+    register_metrics(stats_shm);
+    basket_legs_.reserve(kMaxBasketLegs);
+    basket_starts_.reserve(kMaxBasketLegs);
+    basket_start_results_.reserve(kMaxBasketLegs);
+    (void)tsc_clock::calibrate();
+    loop_clock_.refresh();
+    order_book_.set_clock(&loop_clock_);
+    router_.set_clock(&loop_clock_);
+
+    // 检查点恢复会带回尚未归档的终态订单，按其最近更新时间补登归档定时器
+    if (config_.archive_terminal_orders) {
+        const TimestampNs now = loop_clock_.now_ns();
+        const TimestampNs delay_ns = static_cast<TimestampNs>(config_.terminal_archive_delay_ms) * 1000000ULL;
+        order_book_.for_each_active([&](const OrderEntry& entry) {
+            if (is_terminal_state(entry.request.order_state.load(std::memory_order_acquire))) {
+                (void)archive_timers_.schedule(now, std::max(now, entry.last_update_ns + delay_ns),
+                                               entry.request.internal_order_id);
+            }
+        });
+    }
 }
 
 // 为新单补齐手续费估算，避免风控通过但成交结算时手续费不足。
@@ -110,22 +183,30 @@ void EventLoop::prepare_order_estimate(OrderRequest& request) const {
     // 优先使用账户费率；单测或缺省场景回退到默认费率模型。
     static const account_info default_account_info{};
     const account_info* fee_model = account_info_ != nullptr ? account_info_ : &default_account_info;
-    request.dfee_estimate = fee_model->calculate_fee(request.trade_side, order_value);
+    request.dfee_estimate = fee_model->calculate_fee(request.market, request.trade_side, order_value);
 }
 
 // 在订单真正下游前冻结买单总额，避免并发新单重复占用同一笔可用资金。
-bool EventLoop::reserve_order_resources(OrderEntry& entry) {
+bool EventLoop::order_fund_requirement(const OrderEntry& entry, DValue& out_total) const {
+    out_total = 0;
     if (entry.request.order_type != OrderType::New || entry.request.trade_side != TradeSide::Buy) {
         return true;
     }
 
     DValue order_value = 0;
+    return try_calculate_trade_value(entry.request.volume_entrust, entry.request.dprice_entrust, order_value) &&
+           try_total_with_fee(order_value, entry.request.dfee_estimate, out_total);
+}
+
+bool EventLoop::reserve_order_resources(OrderEntry& entry) {
     DValue total = 0;
-    if (!try_calculate_trade_value(entry.request.volume_entrust, entry.request.dprice_entrust, order_value) ||
-        !try_total_with_fee(order_value, entry.request.dfee_estimate, total)) {
+    if (!order_fund_requirement(entry, total)) {
         ACCT_LOG_WARN("EventLoop", "buy order fund reservation overflow");
         return false;
     }
+    if (total == 0) {
+        return true;
+    }
     if (!positions_.freeze_fund(total, entry.request.internal_order_id)) {
         return false;
     }
@@ -134,6 +215,39 @@ bool EventLoop::reserve_order_resources(OrderEntry& entry) {
     return true;
 }
 
+void EventLoop::apply_replace(const OrderRequest& replace) {
+    const InternalOrderId orig_id = replace.orig_internal_order_id;
+    if (!order_book_.amend_order(orig_id, replace.volume_entrust, replace.dprice_entrust)) {
+        return;
+    }
+    OrderEntry* orig = order_book_.find_order(orig_id);
+    if (!orig || orig->fund_frozen == 0) {
+        return;
+    }
+
+    DValue remaining_value = 0;
+    DValue target = 0;
+    if (!try_calculate_trade_value(orig->request.volume_remain, orig->request.dprice_entrust, remaining_value) ||
+        !try_total_with_fee(remaining_value, orig->request.dfee_estimate, target)) {
+        ACCT_LOG_WARN("EventLoop", "replaced buy order fund reservation overflow");
+        return;
+    }
+    // 柜台已受理改单，资金调整失败只告警
+    if (target > orig->fund_frozen) {
+        if (positions_.freeze_fund(target - orig->fund_frozen, orig_id)) {
+            orig->fund_frozen = target;
+        } else {
+            ACCT_LOG_WARN("EventLoop", "failed to freeze additional fund for replaced buy order");
+        }
+    } else if (target < orig->fund_frozen) {
+        if (positions_.unfreeze_fund(orig->fund_frozen - target, orig_id)) {
+            orig->fund_frozen = target;
+        } else {
+            ACCT_LOG_WARN("EventLoop", "failed to unfreeze fund for replaced buy order");
+        }
+    }
+}
+
 // 释放订单剩余冻结资金，供发送失败、拒单和撤单完成后的尾款回收使用。
 void EventLoop::release_order_resources(OrderEntry& entry) {
     if (entry.request.order_type != OrderType::New || entry.request.trade_side != TradeSide::Buy ||
@@ -172,48 +286,161 @@ bool EventLoop::settle_buy_trade_fund(OrderEntry& entry, DValue amount, DValue f
 
 EventLoop::~EventLoop() {
     stop();
-    order_book_.set_change_callback({});
+    order_book_.set_change_hook({});
+    order_book_.set_clock(nullptr);
+    router_.set_clock(nullptr);
 
     EventLoop* expected = this;
     g_active_loop.compare_exchange_strong(expected, nullptr, std::memory_order_release, std::memory_order_relaxed);
 }
 
 void EventLoop::run() {
-    bool expected = false;
-    if (!running_.compare_exchange_strong(expected, true, std::memory_order_acq_rel)) {
+    if (!start()) {
         return;
     }
 
-    if (config_.pin_cpu && config_.cpu_core >= 0) {
-        set_cpu_affinity(config_.cpu_core);
-    }
+    (void)apply_thread_realtime("event_loop", thread_realtime_config{config_.pin_cpu ? config_.cpu_core : -1,
+                                                                     config_.fifo_priority});
 
     setup_signal_handlers();
     g_active_loop.store(this, std::memory_order_release);
 
-    stats_.start_time = now_ns();
-    last_stats_time_ = now_monotonic_ns();
+    while (running_.load(std::memory_order_acquire)) {
+        switch (select_loop_shape()) {
+            case kLoopShapeMinimal:
+                run_shape<kLoopShapeMinimal>();
+                break;
+            case kLoopShapeDirect:
+                run_shape<kLoopShapeDirect>();
+                break;
+            case kLoopShapeArchiving:
+                run_shape<kLoopShapeArchiving>();
+                break;
+            default:
+                run_shape<kLoopFeaturesAll>();
+                break;
+        }
+    }
+
+    finish();
+
+    EventLoop* active = this;
+    g_active_loop.compare_exchange_strong(active, nullptr, std::memory_order_release, std::memory_order_relaxed);
+}
+
+bool EventLoop::start() {
+    bool expected = false;
+    if (!running_.compare_exchange_strong(expected, true, std::memory_order_acq_rel)) {
+        return false;
+    }
+
+    refresh_loop_clock();
+    stats_.start_time = loop_clock_.now_ns();
+    last_stats_time_ = tsc_clock::now_monotonic_ns();
+    last_checkpoint_time_ = last_stats_time_;
+    return true;
+}
+
+std::size_t EventLoop::run_once() {
+    if (!running_.load(std::memory_order_acquire)) {
+        return 0;
+    }
+
+    // 托管方可能在两轮之间挂接组件，每轮重新选择实例
+    switch (select_loop_shape()) {
+        case kLoopShapeMinimal:
+            return run_once_as<kLoopShapeMinimal>();
+        case kLoopShapeDirect:
+            return run_once_as<kLoopShapeDirect>();
+        case kLoopShapeArchiving:
+            return run_once_as<kLoopShapeArchiving>();
+        default:
+            return run_once_as<kLoopFeaturesAll>();
+    }
+}
+
+template <uint32_t Features>
+std::size_t EventLoop::run_once_as() {
+    active_shape_ = Features;
+    const TimestampNs start = tsc_clock::now_monotonic_ns();
+    const std::size_t processed = poll_inputs<Features>();
+    finish_iteration<Features>(start);
+    if (should_stop_service()) {
+        running_.store(false, std::memory_order_release);
+    }
+    return processed;
+}
 
+template <uint32_t Features>
+void EventLoop::run_shape() {
+    active_shape_ = Features;
+    // 所需特性只会随配置热更新变化，按热更新计数判断是否需要换实例
+    const uint64_t reloads = stats_.config_reloads;
     while (running_.load(std::memory_order_acquire)) {
-        loop_iteration();
+        loop_iteration<Features>();
         if (should_stop_service()) {
             running_.store(false, std::memory_order_release);
         }
+        if constexpr (Features != kLoopFeaturesAll) {
+            if (stats_.config_reloads != reloads && (required_loop_features() & ~Features) != 0) {
+                return;
+            }
+        }
+    }
+}
+
+uint32_t EventLoop::required_loop_features() const noexcept {
+    uint32_t features = 0;
+    if (execution_engine_) {
+        features |= kLoopFeatureExecution;
+    }
+    if (config_.archive_terminal_orders) {
+        features |= kLoopFeatureArchives;
+    }
+    if (inline_stage_) {
+        features |= kLoopFeatureInlineStage;
+    }
+    if (config_.stats_interval_ms > 0 || (checkpoint_writer_ && config_.checkpoint_interval_ms > 0) ||
+        (market_data_ && config_.mark_to_market_interval_ms > 0) || metrics_enabled_ ||
+        (admin_shm_ && config_.admin_poll_iterations > 0)) {
+        features |= kLoopFeaturePeriodic;
+    }
+    if (flight_recorder_ || traffic_capture_ || replication_source_ || sim_clock_) {
+        features |= kLoopFeatureDiagnostics;
+    }
+    return features;
+}
+
+uint32_t EventLoop::select_loop_shape() const noexcept {
+    const uint32_t required = required_loop_features();
+    for (const uint32_t shape : {kLoopShapeMinimal, kLoopShapeDirect, kLoopShapeArchiving}) {
+        if ((required & ~shape) == 0) {
+            return shape;
+        }
     }
+    return kLoopFeaturesAll;
+}
 
+void EventLoop::finish() {
     running_.store(false, std::memory_order_release);
-
-    EventLoop* active = this;
-    g_active_loop.compare_exchange_strong(active, nullptr, std::memory_order_release, std::memory_order_relaxed);
+    // 正常停机留一份最新检查点，下次启动无需回放停机前的变更
+    capture_checkpoint();
 }
 
 void EventLoop::stop() noexcept { running_.store(false, std::memory_order_release); }
 
+void EventLoop::set_inline_stage(loop_stage_hook hook) noexcept { inline_stage_ = hook; }
+
 bool EventLoop::is_running() const noexcept { return running_.load(std::memory_order_acquire); }
 
 const event_loop_stats& EventLoop::stats() const noexcept { return stats_; }
 
-void EventLoop::reset_stats() noexcept { stats_ = event_loop_stats{}; }
+const stage_latency_stats& EventLoop::stage_latency() const noexcept { return *stage_latency_; }
+
+void EventLoop::reset_stats() noexcept {
+    stats_ = event_loop_stats{};
+    stage_latency_->reset();
+}
 
 void EventLoop::setup_signal_handlers() {
     struct sigaction sa {};
@@ -223,29 +450,326 @@ void EventLoop::setup_signal_handlers() {
 
     sigaction(SIGINT, &sa, nullptr);
     sigaction(SIGTERM, &sa, nullptr);
+
+    // SIGUSR2：热备备机提升为主机
+    struct sigaction promote {};
+    promote.sa_handler = promotion_signal_handler;
+    sigemptyset(&promote.sa_mask);
+    promote.sa_flags = SA_RESTART;
+    sigaction(SIGUSR2, &promote, nullptr);
 }
 
+template <uint32_t Features>
 void EventLoop::loop_iteration() {
-    const TimestampNs start = now_monotonic_ns();
+    const TimestampNs start = tsc_clock::now_monotonic_ns();
+    if (poll_inputs<Features>() == 0) {
+        if (config_.adaptive_idle) {
+            idle_backoff_.idle([this](uint32_t timeout_us) { park_idle(timeout_us); });
+        } else if (!config_.busy_polling && config_.idle_sleep_us > 0) {
+            std::this_thread::sleep_for(std::chrono::microseconds(config_.idle_sleep_us));
+        }
+    } else {
+        idle_backoff_.reset();
+    }
+    finish_iteration<Features>(start);
+}
+
+template <uint32_t Features>
+std::size_t EventLoop::poll_inputs() {
     ++stats_.total_iterations;
+    // 模拟时钟随诊断特性实例化，部署形态实例编译为直接读 TSC
+    if constexpr ((Features & kLoopFeatureDiagnostics) != 0) {
+        refresh_loop_clock();
+    } else {
+        loop_clock_.refresh();
+    }
+    if (config_updates_.has_update()) {
+        apply_config_update();
+    }
+    if (pending_rollover_.load(std::memory_order_relaxed) != nullptr) {
+        try_apply_orders_rollover();
+    }
+    // 出队前采样，记下消费者本轮看到的积压；导出统计段时必然带周期特性
+    if constexpr ((Features & kLoopFeaturePeriodic) != 0) {
+        if (queue_depth_countdown_ != 0 && --queue_depth_countdown_ == 0) {
+            sample_queue_depths();
+            queue_depth_countdown_ = config_.queue_depth_sample_iterations;
+        }
+        // 运维指令在出队之前执行，暂停与撤单对本轮出队的订单即时生效
+        if (admin_countdown_ != 0 && --admin_countdown_ == 0) {
+            (void)process_admin_commands();
+            admin_countdown_ = config_.admin_poll_iterations;
+        }
+    }
 
-    const std::size_t orders = process_upstream_orders();
-    const std::size_t responses = process_downstream_responses();
-    if (execution_engine_) {
-        execution_engine_->tick(now_ns());
+    // 飞行记录仪开启时每阶段结束多取一次时；裁掉诊断特性的实例里 record 恒为空，分阶段取时随之消去
+    iteration_record* record = nullptr;
+    if constexpr ((Features & kLoopFeatureDiagnostics) != 0) {
+        record = flight_recorder_ ? &flight_recorder_->begin() : nullptr;
     }
-    if (config_.archive_terminal_orders) {
-        process_pending_archives(now_ns());
+    current_record_ = record;
+    TimestampNs phase_start = record ? tsc_clock::now_monotonic_ns() : 0;
+    const auto end_phase = [&record, &phase_start](iteration_phase phase) {
+        if (record) {
+            const TimestampNs now = tsc_clock::now_monotonic_ns();
+            record->phase_ns[static_cast<std::size_t>(phase)] =
+                static_cast<uint32_t>(std::min<uint64_t>(now - phase_start, UINT32_MAX));
+            phase_start = now;
+        }
+    };
+    if (record) {
+        record->start_ns = phase_start;
+    }
+
+    // 影子模式下重放记录计入订单阶段，本机上游、内联阶段、回报与执行会话都不推进
+    bool shadow = false;
+    if constexpr ((Features & kLoopFeatureDiagnostics) != 0) {
+        shadow = replication_source_ != nullptr;
+    }
+    // 自适应批量按实测耗时回馈单笔与维护耗时估计；关闭时不额外取时
+    const bool adaptive = config_.adaptive_batching && !shadow;
+    plan_drains();
+    const TimestampNs work_start = adaptive ? tsc_clock::now_monotonic_ns() : 0;
+    std::size_t orders = shadow ? process_replicated_inputs() : process_upstream_orders();
+    TimestampNs drain_end = adaptive ? tsc_clock::now_monotonic_ns() : 0;
+    if (adaptive) {
+        batch_scheduler_.record_orders(orders, drain_end - work_start);
+    }
+    end_phase(iteration_phase::Upstream);
+    std::size_t inline_work = 0;
+    if constexpr ((Features & kLoopFeatureInlineStage) != 0) {
+        inline_work = !shadow && inline_stage_ ? inline_stage_() : 0;
+    }
+    end_phase(iteration_phase::InlineStage);
+    const TimestampNs responses_start = adaptive ? tsc_clock::now_monotonic_ns() : 0;
+    const std::size_t responses = shadow ? 0 : process_downstream_responses<Features>(orders);
+    if (adaptive) {
+        drain_end = tsc_clock::now_monotonic_ns();
+        batch_scheduler_.record_responses(responses, drain_end - responses_start);
+    }
+    end_phase(iteration_phase::Responses);
+    std::size_t sessions_ticked = 0;
+    if constexpr ((Features & kLoopFeatureExecution) != 0) {
+        if (execution_engine_ && !shadow) {
+            const TimestampNs tick_start = tsc_clock::now_monotonic_ns();
+            sessions_ticked = execution_engine_->tick(loop_clock_.now_ns());
+            stage_latency_->execution_tick.record(tsc_clock::now_monotonic_ns() - tick_start);
+        }
+    }
+    end_phase(iteration_phase::Execution);
+    std::size_t archives = 0;
+    if constexpr ((Features & kLoopFeatureArchives) != 0) {
+        if (config_.archive_terminal_orders) {
+            archives = process_pending_archives(loop_clock_.now_ns());
+        }
+    }
+    end_phase(iteration_phase::Archives);
+    if (adaptive) {
+        const TimestampNs work_end = tsc_clock::now_monotonic_ns();
+        batch_scheduler_.record_maintenance(work_end - drain_end);
+        if (work_end - work_start > batch_scheduler_.policy().iteration_budget_ns) {
+            ++stats_.budget_overruns;
+        }
     }
 
-    if (orders == 0 && responses == 0) {
+    if (record) {
+        record->orders = static_cast<uint32_t>(orders);
+        record->responses = static_cast<uint32_t>(responses);
+        record->inline_work = static_cast<uint32_t>(inline_work);
+        record->sessions_ticked = static_cast<uint32_t>(sessions_ticked);
+        record->archives = static_cast<uint32_t>(archives);
+        record->work_ns = phase_start - record->start_ns;
+    }
+
+    if (orders == 0 && responses == 0 && inline_work == 0) {
         ++stats_.idle_iterations;
-        if (!config_.busy_polling && config_.idle_sleep_us > 0) {
-            std::this_thread::sleep_for(std::chrono::microseconds(config_.idle_sleep_us));
+    }
+    return orders + responses + inline_work;
+}
+
+void EventLoop::plan_drains() {
+    if (!config_.adaptive_batching || replication_source_) {
+        const std::size_t batch_limit = fixed_batch_limit(config_);
+        drain_plan_ = batch_plan{batch_limit, batch_limit, batch_limit, SIZE_MAX};
+        return;
+    }
+
+    std::size_t order_depth = 0;
+    std::size_t cancel_depth = 0;
+    if (upstream_shm_ && orders_shm_) {
+        const uint32_t lane_count = upstream_lane_count(upstream_shm_);
+        for (uint32_t lane = 0; lane < lane_count; ++lane) {
+            order_depth += upstream_shm_->lane(lane).size();
+            cancel_depth += upstream_shm_->cancel_lane(lane).size();
         }
     }
+    const std::size_t response_depth = trades_shm_ ? trades_shm_->response_queue.size() : 0;
+    drain_plan_ = batch_scheduler_.plan(order_depth, cancel_depth, response_depth);
+}
+
+bool EventLoop::publish_config(const EventLoopConfig& loop_config, const RiskConfig& risk_config) {
+    return config_updates_.publish(runtime_config{loop_config, risk_config});
+}
+
+void EventLoop::apply_config_update() {
+    if (!config_updates_.consume(applied_config_)) {
+        return;
+    }
+
+    const EventLoopConfig& loop_config = applied_config_.loop;
+    config_.busy_polling = loop_config.busy_polling;
+    config_.poll_batch_size = loop_config.poll_batch_size;
+    config_.idle_sleep_us = loop_config.idle_sleep_us;
+    config_.adaptive_idle = loop_config.adaptive_idle;
+    config_.idle_spin_iterations = loop_config.idle_spin_iterations;
+    config_.idle_yield_iterations = loop_config.idle_yield_iterations;
+    config_.idle_park_timeout_us = loop_config.idle_park_timeout_us;
+    config_.stats_interval_ms = loop_config.stats_interval_ms;
+    config_.response_preempt_batch = loop_config.response_preempt_batch;
+    config_.terminal_archive_delay_ms = loop_config.terminal_archive_delay_ms;
+    config_.adaptive_batching = loop_config.adaptive_batching;
+    config_.iteration_budget_us = loop_config.iteration_budget_us;
+    config_.response_share_pct = loop_config.response_share_pct;
+    config_.queue_depth_sample_iterations = loop_config.queue_depth_sample_iterations;
+    queue_depth_countdown_ = queue_depths_ ? config_.queue_depth_sample_iterations : 0;
+    config_.admin_poll_iterations = loop_config.admin_poll_iterations;
+    admin_countdown_ = admin_shm_ ? config_.admin_poll_iterations : 0;
+    batch_scheduler_ = adaptive_batch_scheduler(make_batch_policy(config_));
+    idle_backoff_ = idle_backoff(
+        idle_policy{config_.idle_spin_iterations, config_.idle_yield_iterations, config_.idle_park_timeout_us});
+
+    // 风控重新装配规则；自成交检查首次打开时补建在簿价位
+    risk_.update_config(applied_config_.risk);
+    if (applied_config_.risk.enable_self_trade_check && !risk_.tracking_resting_orders()) {
+        risk_.track_resting_orders(order_book_.capacity());
+        order_book_.for_each_active([this](const OrderEntry& entry) { risk_.on_order_update(entry.request); });
+    }
+
+    ++stats_.config_reloads;
+    ACCT_LOG_INFO("EventLoop", "hot reloaded event loop and risk config");
+}
+
+bool EventLoop::request_orders_rollover(orders_shm_layout* next_orders_shm) noexcept {
+    if (!next_orders_shm) {
+        return false;
+    }
+    orders_shm_layout* expected = nullptr;
+    return pending_rollover_.compare_exchange_strong(expected, next_orders_shm, std::memory_order_acq_rel,
+                                                     std::memory_order_relaxed);
+}
 
-    const TimestampNs now = now_monotonic_ns();
+void EventLoop::try_apply_orders_rollover() {
+    orders_shm_layout* next = pending_rollover_.load(std::memory_order_acquire);
+    if (!next || !orders_shm_ || !upstream_shm_ || !downstream_shm_) {
+        return;
+    }
+    if (next == orders_shm_) {
+        pending_rollover_.store(nullptr, std::memory_order_release);
+        return;
+    }
+    // 静默条件：上一交易日的订单都已终态、入口与出口队列都已排空。下游队列里的下标属于旧池，
+    // 必须先被网关取走；终态订单的迟到回报按未知订单处理
+    if (upstream_pending_size(upstream_shm_) > 0 || !deferred_cancels_.empty() ||
+        !downstream_shm_->order_queue.empty() || !downstream_shm_->order_payload_queue.empty() ||
+        !downstream_shm_->cancel_queue.empty() || (execution_engine_ && execution_engine_->session_count() > 0)) {
+        return;
+    }
+    bool live_orders = false;
+    mass_cancel_targets_.clear();
+    order_book_.for_each_active([this, &live_orders](const OrderEntry& entry) {
+        if (entry.is_terminal()) {
+            mass_cancel_targets_.push_back(entry.request.internal_order_id);
+        } else {
+            live_orders = true;
+        }
+    });
+    if (live_orders) {
+        return;
+    }
+    // 剩余终态订单先归档（镜像仍写旧池），再整段归还订单簿存储
+    for (InternalOrderId order_id : mass_cancel_targets_) {
+        (void)order_book_.archive_order(order_id);
+    }
+    mass_cancel_targets_.clear();
+    order_book_.clear();
+
+    orders_shm_layout* previous = orders_shm_;
+    (void)orders_shm_bind_id_epoch(next, upstream_shm_);
+    orders_shm_ = next;
+    orders_index_reset(orders_index_, trading_day_number(std::string_view(next->header.trading_day, 8)));
+    router_.set_orders_shm(next);
+
+    // 此刻起各 lane 出队的下标仍按旧池解释，直到读到该 lane 生产者推入的换日标记；
+    // 换日前已挂在更早旧池上的 lane 保持原指向
+    for (uint32_t lane = 0; lane < kMaxUpstreamLanes; ++lane) {
+        if (!retired_order_lanes_[lane]) {
+            retired_order_lanes_[lane] = previous;
+        }
+        if (!retired_cancel_lanes_[lane]) {
+            retired_cancel_lanes_[lane] = previous;
+        }
+    }
+    orders_shm_link_successor(previous, next);
+
+    // 下游三条队列此刻为空，换日标记必然入队；网关读到标记后切到新池，其后的下标与消息都属于新池
+    downstream_order_message marker{};
+    marker.index = kOrdersRolloverMarker;
+    (void)downstream_shm_->order_queue.try_push(kOrdersRolloverMarker);
+    (void)downstream_shm_->order_payload_queue.try_push(marker);
+    (void)downstream_shm_->cancel_queue.try_push(marker);
+    doorbell_ring(&previous->header.gateway_doorbell);
+
+    ++stats_.orders_rollovers;
+    pending_rollover_.store(nullptr, std::memory_order_release);
+    ACCT_LOG_INFO("EventLoop", std::string("orders shm rolled over to trading day ") +
+                                   std::string(next->header.trading_day, 8));
+}
+
+template <typename Queue>
+std::size_t EventLoop::drain_retired_lane(uint32_t lane_id, Queue& queue, orders_shm_layout*& retired,
+                                          std::size_t budget) {
+    std::size_t drained = 0;
+    OrderIndex index = kInvalidOrderIndex;
+    while (retired && drained < budget && queue.try_pop(index)) {
+        if (index == kOrdersRolloverMarker) {
+            retired = nullptr;
+            break;
+        }
+        // 旧池下标的内联消息同样出环，保持消息环与下标对齐
+        if ((index & kUpstreamInlineIndexFlag) != 0) {
+            index &= ~kUpstreamInlineIndexFlag;
+            OrderRequest discarded;
+            (void)pop_upstream_payload(lane_id, index, discarded);
+        }
+        // 上一交易日的请求不再入簿，只在旧池槽位上留下拒绝阶段供接入方与监控观察
+        (void)orders_shm_update_stage(retired, index, OrderSlotState::RiskRejected, loop_clock_.now_ns());
+        ++stats_.stale_orders_rejected;
+        ++drained;
+    }
+    return drained;
+}
+
+template <uint32_t Features>
+void EventLoop::finish_iteration(TimestampNs start) {
+    const TimestampNs now = tsc_clock::now_monotonic_ns();
+    if constexpr ((Features & kLoopFeaturePeriodic) != 0) {
+        run_periodic_tasks(now);
+    }
+
+    if constexpr ((Features & kLoopFeatureDiagnostics) != 0) {
+        if (current_record_) {
+            // 本轮总耗时扣除工作耗时即空闲等待
+            const uint64_t total = now > start ? now - start : 0;
+            current_record_->idle_ns = total > current_record_->work_ns ? total - current_record_->work_ns : 0;
+            flight_recorder_->commit();
+            current_record_ = nullptr;
+        }
+    }
+
+    update_latency_stats(start, now);
+}
+
+void EventLoop::run_periodic_tasks(TimestampNs now) {
     if (config_.stats_interval_ms > 0) {
         const TimestampNs interval_ns = static_cast<TimestampNs>(config_.stats_interval_ms) * 1000000ULL;
         if (now >= last_stats_time_ && now - last_stats_time_ >= interval_ns) {
@@ -254,7 +778,304 @@ void EventLoop::loop_iteration() {
         }
     }
 
-    update_latency_stats(start, now);
+    if (checkpoint_writer_ && config_.checkpoint_interval_ms > 0) {
+        const TimestampNs interval_ns = static_cast<TimestampNs>(config_.checkpoint_interval_ms) * 1000000ULL;
+        if (now >= last_checkpoint_time_ && now - last_checkpoint_time_ >= interval_ns) {
+            capture_checkpoint();
+            last_checkpoint_time_ = now;
+        }
+    }
+
+    if (market_data_ && config_.mark_to_market_interval_ms > 0) {
+        const TimestampNs interval_ns = static_cast<TimestampNs>(config_.mark_to_market_interval_ms) * 1000000ULL;
+        if (now >= last_mark_time_ && now - last_mark_time_ >= interval_ns) {
+            mark_positions();
+            last_mark_time_ = now;
+        }
+    }
+
+    if (metrics_enabled_ && now - last_metrics_time_ >= kMetricsPublishIntervalNs) {
+        publish_metrics();
+        last_metrics_time_ = now;
+    }
+
+    if (memory_ && metrics_enabled_ && now - last_memory_time_ >= kMemoryPublishIntervalNs) {
+        memory_->publish();
+        last_memory_time_ = now;
+    }
+}
+
+void EventLoop::mark_positions() {
+    const std::size_t rows = positions_.position_count() + kFirstSecurityPositionIndex;
+    while (mark_handles_.size() < rows) {
+        const position* pos = positions_.get_position(static_cast<SecurityHandle>(mark_handles_.size()));
+        mark_handles_.push_back(pos ? market_data_->resolve(pos->id.view()) : MarketDataHandle{});
+    }
+
+    // 盯市价取买一卖一中间价，单边盘口取仅有的一侧；读不到行情的行给 0，保留上次结果
+    mark_prices_.assign(rows, 0);
+    for (std::size_t row = kFirstSecurityPositionIndex; row < rows; ++row) {
+        if (!mark_handles_[row].is_valid() || !market_data_->read(mark_handles_[row], mark_view_)) {
+            continue;
+        }
+        const snapshot_shm::LobSnapshot& book = mark_view_.snapshot;
+        const DPrice bid = book.total_bid_levels > 0 ? book.bids[0].price : 0;
+        const DPrice ask = book.total_ask_levels > 0 ? book.asks[0].price : 0;
+        mark_prices_[row] = (bid != 0 && ask != 0) ? (bid + ask) / 2 : (bid != 0 ? bid : ask);
+    }
+    (void)positions_.mark_to_market(mark_prices_);
+}
+
+void EventLoop::register_metrics(stats_shm_layout* stats_shm) {
+    if (!stats_shm) {
+        return;
+    }
+    metrics_registry registry(&stats_shm->metrics);
+    metrics_.iterations = registry.add("loop.iterations");
+    metrics_.idle_iterations = registry.add("loop.idle_iterations");
+    metrics_.orders_processed = registry.add("loop.orders_processed");
+    metrics_.responses_processed = registry.add("loop.responses_processed");
+    metrics_.stale_responses = registry.add("loop.stale_responses");
+    metrics_.archived_responses = registry.add("loop.archived_responses");
+    metrics_.archived_trades = registry.add("loop.archived_trades");
+    metrics_.priority_cancels = registry.add("loop.priority_cancels");
+    metrics_.config_reloads = registry.add("loop.config_reloads");
+    metrics_.ingress_preemptions = registry.add("loop.ingress_preemptions");
+    metrics_.budget_overruns = registry.add("loop.budget_overruns");
+    metrics_.inline_orders = registry.add("loop.inline_orders");
+    metrics_.inline_skipped = registry.add("loop.inline_skipped");
+    metrics_.orders_rollovers = registry.add("loop.orders_rollovers");
+    metrics_.stale_orders_rejected = registry.add("loop.stale_orders_rejected");
+    metrics_.router_orders_sent = registry.add("router.orders_sent");
+    metrics_.router_orders_rejected = registry.add("router.orders_rejected");
+    metrics_.router_queue_full = registry.add("router.queue_full");
+    metrics_.upstream_depth = registry.add("queue.upstream_depth", metric_kind::Gauge);
+    metrics_.downstream_depth = registry.add("queue.downstream_depth", metric_kind::Gauge);
+    metrics_.response_depth = registry.add("queue.response_depth", metric_kind::Gauge);
+    metrics_.active_orders = registry.add("order_book.active_orders", metric_kind::Gauge);
+    metrics_.business_log_dropped = registry.add("business_log.dropped");
+    if (execution_engine_ && execution_engine_->child_risk().enabled()) {
+        metrics_.child_risk_checks = registry.add("execution.child_risk_checks");
+        metrics_.child_risk_rejects = registry.add("execution.child_risk_rejects");
+    }
+    risk_.register_metrics(registry);
+    metrics_enabled_ = true;
+
+    queue_depths_ = &stats_shm->queues;
+    (*queue_depths_)[shm_queue_id::UpstreamOrders].reset(kUpstreamOrderQueueCapacity);
+    (*queue_depths_)[shm_queue_id::UpstreamCancels].reset(kUpstreamCancelQueueCapacity);
+    (*queue_depths_)[shm_queue_id::UpstreamPayloads].reset(kUpstreamPayloadQueueCapacity);
+    (*queue_depths_)[shm_queue_id::Responses].reset(kResponseQueueCapacity);
+    queue_depth_countdown_ = config_.queue_depth_sample_iterations;
+}
+
+// 上游各类队列的容量按单条 lane 计，记最深的一条 lane，直接对照容量常量
+void EventLoop::sample_queue_depths() {
+    if (upstream_shm_) {
+        std::size_t orders = 0;
+        std::size_t cancels = 0;
+        std::size_t payloads = 0;
+        const uint32_t lane_count = upstream_lane_count(upstream_shm_);
+        for (uint32_t lane = 0; lane < lane_count; ++lane) {
+            orders = std::max(orders, upstream_shm_->lane(lane).size());
+            cancels = std::max(cancels, upstream_shm_->cancel_lane(lane).size());
+            payloads = std::max(payloads, upstream_shm_->payload_lane(lane).size());
+        }
+        record_queue_depth(shm_queue_id::UpstreamOrders, orders);
+        record_queue_depth(shm_queue_id::UpstreamCancels, cancels);
+        record_queue_depth(shm_queue_id::UpstreamPayloads, payloads);
+    }
+    if (trades_shm_) {
+        record_queue_depth(shm_queue_id::Responses, trades_shm_->response_queue.size());
+    }
+}
+
+void EventLoop::record_queue_depth(shm_queue_id id, std::size_t depth) {
+    queue_depth_histogram& histogram = (*queue_depths_)[id];
+    if (histogram.record(depth)) {
+        ACCT_LOG_WARN("EventLoop", std::string("queue depth crossed alert threshold queue=") + shm_queue_name(id) +
+                                       " depth=" + std::to_string(depth) +
+                                       " capacity=" + std::to_string(histogram.capacity.load()));
+    }
+}
+
+void EventLoop::publish_metrics() {
+    metrics_.iterations.set(stats_.total_iterations);
+    metrics_.idle_iterations.set(stats_.idle_iterations);
+    metrics_.orders_processed.set(stats_.orders_processed);
+    metrics_.responses_processed.set(stats_.responses_processed);
+    metrics_.stale_responses.set(stats_.stale_responses);
+    metrics_.archived_responses.set(stats_.archived_responses);
+    metrics_.archived_trades.set(stats_.archived_trades);
+    metrics_.priority_cancels.set(stats_.priority_cancels);
+    metrics_.config_reloads.set(stats_.config_reloads);
+    metrics_.ingress_preemptions.set(stats_.ingress_preemptions);
+    metrics_.budget_overruns.set(stats_.budget_overruns);
+    metrics_.inline_orders.set(stats_.inline_orders);
+    metrics_.inline_skipped.set(stats_.inline_skipped);
+    risk_.publish_rule_metrics();
+    metrics_.orders_rollovers.set(stats_.orders_rollovers);
+    metrics_.stale_orders_rejected.set(stats_.stale_orders_rejected);
+
+    const router_stats& routed = router_.stats();
+    metrics_.router_orders_sent.set(routed.orders_sent);
+    metrics_.router_orders_rejected.set(routed.orders_rejected);
+    metrics_.router_queue_full.set(routed.queue_full_count);
+
+    // 队列深度为生产者/消费者游标差，读到的是发布时刻的近似值
+    if (upstream_shm_) {
+        metrics_.upstream_depth.set(upstream_pending_size(upstream_shm_));
+    }
+    if (downstream_shm_) {
+        metrics_.downstream_depth.set(downstream_shm_->order_queue.size() +
+                                      downstream_shm_->order_payload_queue.size() +
+                                      downstream_shm_->cancel_queue.size());
+    }
+    if (trades_shm_) {
+        metrics_.response_depth.set(trades_shm_->response_queue.size());
+    }
+    metrics_.active_orders.set(order_book_.active_count());
+    if (order_event_recorder_) {
+        metrics_.business_log_dropped.set(order_event_recorder_->dropped_count());
+    }
+    if (execution_engine_) {
+        metrics_.child_risk_checks.set(execution_engine_->child_risk().checks());
+        metrics_.child_risk_rejects.set(execution_engine_->child_risk().rejects());
+    }
+}
+
+// 事件循环线程只复制活跃订单与会话进度，编码和落盘由写线程完成；写线程忙时跳过，下个周期重试。
+void EventLoop::capture_checkpoint() {
+    if (!checkpoint_writer_) {
+        return;
+    }
+    capture_restart_checkpoint(order_book_, orders_shm_, execution_engine_, checkpoint_buffer_);
+    (void)checkpoint_writer_->submit(checkpoint_buffer_);
+}
+
+std::size_t EventLoop::route_mass_cancel_request(const OrderRequest& request) {
+    const std::size_t sent = router_.route_mass_cancel(request, mass_cancel_targets_);
+    for (InternalOrderId target : mass_cancel_targets_) {
+        record_cancel_flow(target);
+    }
+    // 受管父单的执行会话需要立即感知撤单，与单笔撤单路由成功后的唤醒一致
+    if (execution_engine_) {
+        for (InternalOrderId target : mass_cancel_targets_) {
+            execution_engine_->on_cancel_routed(target);
+        }
+    }
+    return sent;
+}
+
+// 单次取指令条数有上限，积压的指令留到后续轮次；完成环满时结果丢弃计数，不阻塞循环
+std::size_t EventLoop::process_admin_commands() {
+    std::size_t executed = 0;
+    admin_command command{};
+    while (executed < kAdminCommandsPerPoll && admin_shm_->commands.try_pop(command)) {
+        const admin_response response = execute_admin_command(command);
+        ++executed;
+        ++stats_.admin_commands;
+        admin_shm_->executed.fetch_add(1, std::memory_order_relaxed);
+        if (!admin_shm_->responses.try_push(response)) {
+            admin_shm_->dropped_responses.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+    return executed;
+}
+
+admin_response EventLoop::execute_admin_command(const admin_command& command) {
+    admin_response response{};
+    response.command_id = command.command_id;
+    response.type = command.type;
+    response.strategy_id = command.strategy_id;
+    response.status = admin_command_status::Done;
+
+    switch (command.type) {
+        case admin_command_type::ReloadConfig:
+            // 解析与校验由配置热更新线程完成，结果照常经 publish_config 在后续轮次应用
+            if (!reload_requester_) {
+                response.status = admin_command_status::Rejected;
+                break;
+            }
+            reload_requester_.fn(reload_requester_.context);
+            response.status = admin_command_status::Accepted;
+            break;
+        case admin_command_type::CancelAll:
+        case admin_command_type::CancelStrategy: {
+            // 影子模式下路由产生的下游消息会被丢弃，撤单须在主机上执行
+            if (replication_source_) {
+                response.status = admin_command_status::Rejected;
+                break;
+            }
+            OrderRequest request;
+            const bool strategy_scope = command.type == admin_command_type::CancelStrategy;
+            request.init_mass_cancel(0, 0, strategy_scope ? MassCancelScope::Strategy : MassCancelScope::Account,
+                                     command.strategy_id, InternalSecurityId{}, 0);
+            response.affected = static_cast<uint32_t>(route_mass_cancel_request(request));
+            if (response.affected != mass_cancel_targets_.size()) {
+                ACCT_REPORT_ERROR(ErrorDomain::order, ErrorCode::RouteFailed, "EventLoop",
+                                  "admin cancel could not route every target", 0);
+            }
+            break;
+        }
+        case admin_command_type::PauseStrategy:
+            paused_strategies_.set(command.strategy_id);
+            break;
+        case admin_command_type::ResumeStrategy:
+            paused_strategies_.reset(command.strategy_id);
+            break;
+        case admin_command_type::DumpState:
+            dump_state();
+            break;
+        case admin_command_type::Checkpoint:
+            if (!checkpoint_writer_) {
+                response.status = admin_command_status::Rejected;
+                break;
+            }
+            capture_restart_checkpoint(order_book_, orders_shm_, execution_engine_, checkpoint_buffer_);
+            if (!checkpoint_writer_->submit(checkpoint_buffer_)) {
+                response.status = admin_command_status::Rejected;
+            }
+            break;
+        case admin_command_type::None:
+        default:
+            response.status = admin_command_status::Unsupported;
+            break;
+    }
+
+    ACCT_LOG_INFO("EventLoop", std::string("admin command ") + admin_command_name(command.type) + " " +
+                                   admin_status_name(response.status));
+    response.done_ns = loop_clock_.now_ns();
+    return response;
+}
+
+void EventLoop::dump_state() {
+    print_periodic_stats();
+    ACCT_LOG_INFO("EventLoop", "state iterations=" + std::to_string(stats_.total_iterations) +
+                                   " active_orders=" + std::to_string(order_book_.active_count()) +
+                                   " sessions=" +
+                                   std::to_string(execution_engine_ ? execution_engine_->session_count() : 0) +
+                                   " paused_strategies=" + std::to_string(paused_strategies_.count()) +
+                                   " shadowing=" + (shadowing() ? "true" : "false"));
+}
+
+void EventLoop::park_idle(uint32_t timeout_us) {
+    if (!orders_shm_) {
+        std::this_thread::sleep_for(std::chrono::microseconds(timeout_us));
+        return;
+    }
+    // 挂起时长受 timeout 约束，执行引擎 tick 与延迟归档最多推迟一个周期
+    doorbell_wait(&orders_shm_->header.account_doorbell, timeout_us, [this]() { return has_pending_input(); });
+}
+
+bool EventLoop::has_pending_input() const noexcept {
+    if (replication_source_) {
+        return replication_source_->has_pending() || promotion_requested_.load(std::memory_order_relaxed);
+    }
+    if (upstream_shm_ && upstream_pending_size(upstream_shm_) > 0) {
+        return true;
+    }
+    return trades_shm_ && !trades_shm_->response_queue.empty();
 }
 
 std::size_t EventLoop::process_upstream_orders() {
@@ -262,85 +1083,563 @@ std::size_t EventLoop::process_upstream_orders() {
         return 0;
     }
 
-    const std::size_t batch_limit = (config_.poll_batch_size == 0) ? 1 : config_.poll_batch_size;
+    const uint32_t lane_count = upstream_lane_count(upstream_shm_);
+    const std::size_t cancel_limit = drain_plan_.cancels;
+    std::size_t cancels = 0;
+
+    // 撤单优先：先排空各 lane 的撤单队列，排在大篮子后面的撤单不再等整篮处理完
+    for (uint32_t lane = 0; lane < lane_count && cancels < cancel_limit; ++lane) {
+        cancels += drain_cancel_lane(lane, cancel_limit - cancels);
+    }
+
+    // 固定批量时撤单与新单共用一份额度；自适应批量时撤单有单独的保底额度
+    const std::size_t order_limit =
+        config_.adaptive_batching ? drain_plan_.orders : drain_plan_.orders - std::min(cancels, drain_plan_.orders);
     std::size_t processed = 0;
 
-    OrderIndex order_index = kInvalidOrderIndex;
-    while (processed < batch_limit && upstream_shm_->upstream_order_queue.try_pop(order_index)) {
-        order_slot_snapshot snapshot;
-        if (!orders_shm_read_snapshot(orders_shm_, order_index, snapshot)) {
-            ErrorStatus status = ACCT_MAKE_ERROR(ErrorDomain::order, ErrorCode::OrderNotFound, "EventLoop",
-                                                 "failed to read order slot from upstream index", 0);
-            record_error(status);
-            ACCT_LOG_ERROR_STATUS(status);
-            continue;
+    // 多 lane 时按轮转起点依次排空，避免靠前的 lane 长期独占本轮预算。
+    const uint32_t start_lane = (upstream_lane_cursor_ < lane_count) ? upstream_lane_cursor_ : 0;
+    for (uint32_t offset = 0; offset < lane_count && processed < order_limit; ++offset) {
+        const uint32_t lane = (start_lane + offset) % lane_count;
+        processed += drain_upstream_lane(lane, order_limit - processed);
+    }
+    processed += cancels;
+    upstream_lane_cursor_ = (start_lane + 1) % lane_count;
+    if (!deferred_cancels_.empty()) {
+        process_deferred_cancels();
+    }
+
+    if (processed > 0) {
+        stats_.orders_processed += processed;
+        stats_.last_order_time = loop_clock_.now_ns();
+        // 腾出了队列额度：唤醒在 acct_wait_credits 上等待的策略进程，无等待者时只有一次 fence
+        doorbell_ring(&upstream_shm_->lane_table.credit_doorbell);
+    }
+
+    return processed;
+}
+
+std::size_t EventLoop::drain_upstream_lane(uint32_t lane_id, std::size_t budget) {
+    upstream_shm_layout::lane_queue& queue = upstream_shm_->lane(lane_id);
+    // 每个策略进程独占一条 lane，lane 编号即订单来源策略
+    const StrategyId strategy_id = static_cast<StrategyId>(lane_id);
+    std::size_t processed = 0;
+    if (retired_order_lanes_[lane_id]) {
+        processed = drain_retired_lane(lane_id, queue, retired_order_lanes_[lane_id], budget);
+        if (retired_order_lanes_[lane_id]) {
+            return processed;
+        }
+    }
+
+    // 批量出队：每块只做一次对端索引 acquire 和一次本端索引 release。
+    std::array<OrderIndex, kMaxDrainChunk> indices;
+    while (processed < budget) {
+        const std::size_t want = std::min(budget - processed, indices.size());
+        const std::size_t popped = queue.try_pop_bulk(indices.data(), want);
+        if (popped == 0) {
+            break;
+        }
+        const TimestampNs dequeue_ns = tsc_clock::now_monotonic_ns();
+        for (std::size_t i = 0; i < popped; ++i) {
+            orders_shm_mark_hop(orders_shm_, indices[i] & ~kUpstreamInlineIndexFlag, OrderLatencyHop::UpstreamDequeued,
+                                dequeue_ns);
+        }
+
+        for (std::size_t i = 0; i < std::min(popped, kDrainPrefetchDistance); ++i) {
+            prefetch_upstream_slot(orders_shm_, indices[i]);
         }
+        for (std::size_t i = 0; i < popped; ++i) {
+            if (i + kDrainPrefetchDistance < popped) {
+                prefetch_upstream_slot(orders_shm_, indices[i + kDrainPrefetchDistance]);
+            }
+            // 已跟随当前池的 lane 上重复的换日标记（如新接入方打开换日切入的池）直接跳过
+            if (indices[i] == kOrdersRolloverMarker) {
+                continue;
+            }
+            OrderIndex order_index = kInvalidOrderIndex;
+            OrderRequest request;
+            if (!consume_upstream_order(lane_id, indices[i], order_index, request)) {
+                ACCT_REPORT_ERROR(ErrorDomain::order, ErrorCode::OrderNotFound, "EventLoop",
+                                  "failed to read order slot from upstream index", 0);
+                continue;
+            }
+            if (traffic_capture_) {
+                traffic_capture_->capture_order(traffic_capture_kind::Order, lane_id, order_index,
+                                                orders_shm_->header.next_index.load(std::memory_order_relaxed),
+                                                request);
+            }
+
+            // 篮子首腿：收齐其余各腿后整篮入簿风控、合并预留资金
+            if (request.basket_legs > 1 && request.basket_id == request.internal_order_id) {
+                std::size_t chunk_taken = 0;
+                processed += drain_basket(queue, indices.data() + i + 1, popped - i - 1, order_index, request,
+                                          strategy_id, dequeue_ns, chunk_taken);
+                i += chunk_taken;
+                continue;
+            }
 
-        (void)orders_shm_update_stage(orders_shm_, order_index, OrderSlotState::UpstreamDequeued, now_ns());
-        handle_order_request(order_index, snapshot.request);
+            handle_order_request(order_index, request, strategy_id, dequeue_ns);
+            ++processed;
+        }
+        if (popped < want) {
+            break;
+        }
+    }
+
+    return processed;
+}
+
+bool EventLoop::consume_upstream_order(uint32_t lane_id, OrderIndex entry, OrderIndex& out_index,
+                                       OrderRequest& out_request) {
+    out_index = entry & ~kUpstreamInlineIndexFlag;
+    if (entry != out_index && pop_upstream_payload(lane_id, out_index, out_request)) {
+        ++stats_.inline_orders;
+        return orders_shm_update_stage(orders_shm_, out_index, OrderSlotState::UpstreamDequeued, loop_clock_.now_ns());
+    }
+    // 出队后账户服务是该槽位唯一写入方，取出请求与阶段切换合并为一次 seqlock 区间。
+    return orders_shm_consume_order(orders_shm_, out_index, OrderSlotState::UpstreamDequeued, loop_clock_.now_ns(),
+                                    out_request);
+}
+
+// 消息环与带标记的下标同序入队；生产者在两次入队之间退出时环里会多出孤立消息，按下标向后对齐
+bool EventLoop::pop_upstream_payload(uint32_t lane_id, OrderIndex index, OrderRequest& out_request) {
+    upstream_shm_layout::payload_queue& payloads = upstream_shm_->payload_lane(lane_id);
+    upstream_order_message message;
+    while (payloads.try_pop(message)) {
+        if (message.index == index) {
+            return read_upstream_order_message(message, out_request);
+        }
+        ++stats_.inline_skipped;
+    }
+    return false;
+}
+
+std::size_t EventLoop::drain_basket(upstream_shm_layout::lane_queue& queue, const OrderIndex* chunk_rest,
+                                    std::size_t chunk_rest_count, OrderIndex first_index,
+                                    const OrderRequest& first_request, StrategyId strategy_id,
+                                    TimestampNs dequeue_ns, std::size_t& out_chunk_taken) {
+    const InternalOrderId basket_id = first_request.basket_id;
+    const std::size_t legs = std::min<std::size_t>(first_request.basket_legs, kMaxBasketLegs);
+    basket_legs_.clear();
+    basket_legs_.push_back(basket_leg{first_index, first_request, 0, 0, false});
+
+    // SDK 整篮一次入队，其余腿紧随首腿：先取本块剩余下标，不足部分直接从 lane 补取
+    const std::size_t from_chunk = std::min(legs - 1, chunk_rest_count);
+    std::array<OrderIndex, kMaxBasketLegs> extra;
+    std::size_t extra_count = 0;
+    if (from_chunk < legs - 1) {
+        extra_count = queue.try_pop_bulk(extra.data(), legs - 1 - from_chunk);
+        const TimestampNs extra_ns = tsc_clock::now_monotonic_ns();
+        for (std::size_t i = 0; i < extra_count; ++i) {
+            orders_shm_mark_hop(orders_shm_, extra[i] & ~kUpstreamInlineIndexFlag, OrderLatencyHop::UpstreamDequeued,
+                                extra_ns);
+        }
+    }
+    out_chunk_taken = from_chunk;
+
+    std::size_t processed = 1;
+    for (std::size_t i = 0; i < from_chunk + extra_count; ++i) {
+        OrderIndex index = kInvalidOrderIndex;
+        OrderRequest request;
+        if (!consume_upstream_order(strategy_id, i < from_chunk ? chunk_rest[i] : extra[i - from_chunk], index,
+                                    request)) {
+            ACCT_REPORT_ERROR(ErrorDomain::order, ErrorCode::OrderNotFound, "EventLoop",
+                              "failed to read basket leg from upstream index", 0);
+            continue;
+        }
+        if (traffic_capture_) {
+            traffic_capture_->capture_order(traffic_capture_kind::Order, strategy_id, index,
+                                            orders_shm_->header.next_index.load(std::memory_order_relaxed), request);
+        }
         ++processed;
+        // 不属于本篮的订单（SDK 契约外）按普通订单处理
+        if (request.basket_id != basket_id) {
+            handle_order_request(index, request, strategy_id, dequeue_ns);
+            continue;
+        }
+        basket_legs_.push_back(basket_leg{index, request, 0, 0, false});
     }
 
+    handle_basket(strategy_id, dequeue_ns);
+    return processed;
+}
+
+void EventLoop::handle_basket(StrategyId strategy_id, TimestampNs dequeue_ns) {
+    if (replication_sink_) {
+        const OrderIndex next_index_hint = orders_shm_->header.next_index.load(std::memory_order_relaxed);
+        const auto basket_size = static_cast<uint16_t>(basket_legs_.size());
+        for (std::size_t i = 0; i < basket_legs_.size(); ++i) {
+            replication_sink_->publish_basket_leg(basket_legs_[i].index, basket_legs_[i].request, strategy_id,
+                                                  next_index_hint, basket_size, static_cast<uint16_t>(i));
+        }
+    }
+    const InternalOrderId basket_id = basket_legs_.front().request.basket_id;
+    const bool all_or_nothing = (basket_legs_.front().request.basket_flags & kBasketAllOrNothing) != 0;
+    const std::size_t expected_legs =
+        std::min<std::size_t>(basket_legs_.front().request.basket_legs, kMaxBasketLegs);
+    bool all_admitted = basket_legs_.size() == expected_legs;
+
+    // 第一遍：逐腿入簿并风控，合计普通买单腿需冻结的资金（受管父单不走一次性冻结）
+    DValue basket_total = 0;
+    bool overflow = false;
+    for (basket_leg& leg : basket_legs_) {
+        leg.fund_need = 0;
+        OrderEntry* active = admit_order(leg.index, leg.request, strategy_id, dequeue_ns, leg.risk_done_ns);
+        leg.admitted = active != nullptr;
+        if (!active) {
+            all_admitted = false;
+            continue;
+        }
+        if (execution_engine_ && execution_engine_->should_manage(active->request)) {
+            continue;
+        }
+        if (!order_fund_requirement(*active, leg.fund_need) || basket_total + leg.fund_need < basket_total) {
+            overflow = true;
+            leg.fund_need = 0;
+            continue;
+        }
+        basket_total += leg.fund_need;
+    }
+
+    // 合并预留：整篮只改写一次资金行；非原子篮子预留失败时退回逐腿冻结
+    bool reserved = false;
+    if (!all_or_nothing || all_admitted) {
+        reserved = !overflow && (basket_total == 0 || positions_.freeze_fund(basket_total, basket_id));
+    }
+    if (all_or_nothing && !reserved) {
+        for (const basket_leg& leg : basket_legs_) {
+            if (!leg.admitted) {
+                continue;
+            }
+            order_book_.update_state(leg.request.internal_order_id, OrderState::RiskControllerRejected);
+            (void)orders_shm_update_stage(orders_shm_, leg.index, OrderSlotState::RiskRejected, loop_clock_.now_ns());
+        }
+        ACCT_LOG_WARN("EventLoop", "all-or-nothing basket rejected as a whole");
+        return;
+    }
+
+    // 受管腿先收集，其余腿分发完后一次 start_sessions() 批量建会话
+    basket_starts_.clear();
+    for (const basket_leg& leg : basket_legs_) {
+        if (!leg.admitted) {
+            continue;
+        }
+        OrderEntry* active = order_book_.find_order(leg.request.internal_order_id);
+        if (!active) {
+            if (reserved && leg.fund_need > 0) {
+                (void)positions_.unfreeze_fund(leg.fund_need, leg.request.internal_order_id);
+            }
+            continue;
+        }
+        if (execution_engine_ && execution_engine_->should_manage(active->request)) {
+            prepare_managed_start(*active);
+            basket_starts_.push_back(
+                session_start_request{leg.index, &active->request, active->strategy_id, active->submit_time_ns});
+            continue;
+        }
+        if (reserved) {
+            active->fund_frozen = leg.fund_need;
+        }
+        dispatch_order(*active, leg.index, leg.risk_done_ns, reserved);
+    }
+    if (basket_starts_.empty()) {
+        return;
+    }
+
+    basket_start_results_.resize(basket_starts_.size());
+    (void)execution_engine_->start_sessions(basket_starts_, basket_start_results_);
+    for (std::size_t i = 0; i < basket_starts_.size(); ++i) {
+        if (basket_start_results_[i] != ExecutionEngine::SessionStartResult::Started) {
+            on_session_start_failed(basket_starts_[i].parent_request->internal_order_id, basket_starts_[i].parent_index,
+                                    basket_start_results_[i]);
+        }
+    }
+}
+
+std::size_t EventLoop::drain_cancel_lane(uint32_t lane_id, std::size_t budget) {
+    upstream_shm_layout::cancel_queue& queue = upstream_shm_->cancel_lane(lane_id);
+    const StrategyId strategy_id = static_cast<StrategyId>(lane_id);
+    std::size_t processed = 0;
+    if (retired_cancel_lanes_[lane_id]) {
+        processed = drain_retired_lane(lane_id, queue, retired_cancel_lanes_[lane_id], budget);
+        if (retired_cancel_lanes_[lane_id]) {
+            return processed;
+        }
+    }
+
+    std::array<OrderIndex, kMaxDrainChunk> indices;
+    while (processed < budget) {
+        const std::size_t want = std::min(budget - processed, indices.size());
+        const std::size_t popped = queue.try_pop_bulk(indices.data(), want);
+        if (popped == 0) {
+            break;
+        }
+        const TimestampNs dequeue_ns = tsc_clock::now_monotonic_ns();
+        for (std::size_t i = 0; i < std::min(popped, kDrainPrefetchDistance); ++i) {
+            orders_shm_prefetch_slot(orders_shm_, indices[i]);
+        }
+        for (std::size_t i = 0; i < popped; ++i) {
+            const OrderIndex order_index = indices[i];
+            if (i + kDrainPrefetchDistance < popped) {
+                orders_shm_prefetch_slot(orders_shm_, indices[i + kDrainPrefetchDistance]);
+            }
+            if (order_index == kOrdersRolloverMarker) {
+                continue;
+            }
+            orders_shm_mark_hop(orders_shm_, order_index, OrderLatencyHop::UpstreamDequeued, dequeue_ns);
+            OrderRequest request;
+            if (!orders_shm_consume_order(orders_shm_, order_index, OrderSlotState::UpstreamDequeued,
+                                          loop_clock_.now_ns(), request)) {
+                ACCT_REPORT_ERROR(ErrorDomain::order, ErrorCode::OrderNotFound, "EventLoop",
+                                  "failed to read order slot from upstream cancel index", 0);
+                continue;
+            }
+            if (traffic_capture_) {
+                traffic_capture_->capture_order(traffic_capture_kind::Cancel, lane_id, order_index,
+                                                orders_shm_->header.next_index.load(std::memory_order_relaxed),
+                                                request);
+            }
+
+            ++processed;
+            ++stats_.priority_cancels;
+            // 撤单越过了仍在订单队列中的原单时先挂起，避免把不存在的原单撤单推给柜台
+            if (request.order_type == OrderType::Cancel &&
+                order_book_.find_order(request.orig_internal_order_id) == nullptr &&
+                !upstream_shm_->lane(lane_id).empty()) {
+                ++stats_.deferred_cancels;
+                deferred_cancels_.push_back(deferred_cancel{order_index, request, strategy_id, dequeue_ns});
+                continue;
+            }
+            handle_order_request(order_index, request, strategy_id, dequeue_ns);
+        }
+        if (popped < want) {
+            break;
+        }
+    }
+
+    return processed;
+}
+
+void EventLoop::process_deferred_cancels() {
+    std::size_t kept = 0;
+    for (std::size_t i = 0; i < deferred_cancels_.size(); ++i) {
+        deferred_cancel& item = deferred_cancels_[i];
+        const bool ready = order_book_.find_order(item.request.orig_internal_order_id) != nullptr ||
+                           upstream_shm_->lane(item.strategy_id).empty();
+        if (!ready) {
+            if (kept != i) {
+                deferred_cancels_[kept] = item;
+            }
+            ++kept;
+            continue;
+        }
+        handle_order_request(item.index, item.request, item.strategy_id, item.dequeue_ns);
+    }
+    deferred_cancels_.resize(kept);
+}
+
+std::size_t EventLoop::process_replicated_inputs() {
+    if (!orders_shm_) {
+        return 0;
+    }
+    // 备机订单号须与主机一致：沿用主机订单池纪元，本机槽位即按主机订单号编码
+    const uint32_t primary_epoch = replication_source_->primary_id_epoch();
+    if (primary_epoch != 0 && orders_shm_->header.id_epoch.load(std::memory_order_relaxed) != primary_epoch) {
+        orders_shm_->header.id_epoch.store(primary_epoch, std::memory_order_release);
+    }
+
+    // 提升时不限预算，收件环排空后才切回正常轮询
+    const bool promoting = promotion_requested_.load(std::memory_order_acquire);
+    const std::size_t batch_limit = (config_.poll_batch_size == 0) ? 1 : config_.poll_batch_size;
+    std::size_t processed = 0;
+    std::array<replication_record, kReplicationApplyChunk> records;
+    while (promoting || processed < batch_limit) {
+        const std::size_t want = promoting ? records.size() : std::min(batch_limit - processed, records.size());
+        const std::size_t popped = replication_source_->try_pop_bulk(records.data(), want);
+        for (std::size_t i = 0; i < popped; ++i) {
+            apply_replicated_record(records[i]);
+        }
+        processed += popped;
+        if (popped < want) {
+            break;
+        }
+    }
     if (processed > 0) {
-        stats_.orders_processed += processed;
-        stats_.last_order_time = now_ns();
+        stats_.replicated_records += processed;
+        discard_shadow_downstream();
     }
 
+    if (promoting) {
+        if (replication_source_->out_of_sync()) {
+            ACCT_LOG_ERROR("EventLoop", "promoting standby that is out of sync with primary");
+        }
+        replication_source_ = nullptr;
+        promotion_requested_.store(false, std::memory_order_release);
+        ACCT_LOG_INFO("EventLoop", "standby promoted, resuming upstream and response polling");
+    }
     return processed;
 }
 
-std::size_t EventLoop::process_downstream_responses() {
+void EventLoop::apply_replicated_record(const replication_record& record) {
+    const TimestampNs dequeue_ns = tsc_clock::now_monotonic_ns();
+    if (record.kind == replication_record_kind::Response) {
+        TradeResponse response;
+        std::memcpy(&response, record.payload, sizeof(TradeResponse));
+        handle_trade_response(response);
+        ++stats_.responses_processed;
+        stats_.last_response_time = loop_clock_.now_ns();
+        return;
+    }
+
+    // 溢出段与跨日订单池不跟随，只重放主段槽位
+    if (orders_index_segment(record.index) != 0 || record.index >= orders_shm_->header.capacity) {
+        ACCT_REPORT_ERROR(ErrorDomain::order, ErrorCode::OrderNotFound, "EventLoop",
+                          "replicated order outside primary orders segment", 0);
+        return;
+    }
+    // 主机处理前的 next_index 之前都已被接入方预留，备机抬到同一位置后拆单/撤单子单落在与主机相同的下标
+    (void)orders_shm_reserve_through(orders_shm_, std::max<OrderIndex>(record.index + 1, record.next_index_hint));
+    OrderRequest request;
+    std::memcpy(static_cast<void*>(&request), record.payload, sizeof(OrderRequest));
+    (void)orders_shm_write_order(orders_shm_, record.index, request, OrderSlotState::UpstreamDequeued,
+                                 order_slot_source_t::User, loop_clock_.now_ns());
+    ++stats_.orders_processed;
+    stats_.last_order_time = loop_clock_.now_ns();
+
+    if (record.kind == replication_record_kind::BasketLeg) {
+        if (record.basket_position == 0) {
+            basket_legs_.clear();
+        }
+        basket_legs_.push_back(basket_leg{record.index, request, 0, 0, false});
+        if (basket_legs_.size() == record.basket_size) {
+            handle_basket(record.strategy_id, dequeue_ns);
+        }
+        return;
+    }
+    handle_order_request(record.index, request, record.strategy_id, dequeue_ns);
+}
+
+void EventLoop::discard_shadow_downstream() {
+    if (!downstream_shm_) {
+        return;
+    }
+    std::array<OrderIndex, kMaxDrainChunk> indices;
+    while (downstream_shm_->order_queue.try_pop_bulk(indices.data(), indices.size()) == indices.size()) {
+    }
+    std::array<downstream_order_message, 16> messages;
+    while (downstream_shm_->order_payload_queue.try_pop_bulk(messages.data(), messages.size()) == messages.size()) {
+    }
+    while (downstream_shm_->cancel_queue.try_pop_bulk(messages.data(), messages.size()) == messages.size()) {
+    }
+}
+
+// 成交风暴时一整批回报会让同一轮到达的新单多等一批的结算耗时；开启 response_preempt_batch 后按该粒度分块，
+// 块间上游有待处理订单就先走一遍 process_upstream_orders()。两者仍在同一线程，订单簿与持仓维持单写者
+template <uint32_t Features>
+std::size_t EventLoop::process_downstream_responses(std::size_t& preempted_orders) {
     if (!trades_shm_) {
         return 0;
     }
 
-    const std::size_t batch_limit = (config_.poll_batch_size == 0) ? 1 : config_.poll_batch_size;
+    const std::size_t batch_limit = drain_plan_.responses;
+    const std::size_t chunk_limit =
+        config_.response_preempt_batch == 0 ? kMaxDrainChunk
+                                            : std::min<std::size_t>(config_.response_preempt_batch, kMaxDrainChunk);
     std::size_t processed = 0;
 
+    std::array<trade_response_message, kMaxDrainChunk> responses;
     TradeResponse response;
-    while (processed < batch_limit && trades_shm_->response_queue.try_pop(response)) {
-        handle_trade_response(response);
-        ++processed;
+    while (processed < batch_limit) {
+        if (processed > 0 && config_.response_preempt_batch != 0 && upstream_shm_ &&
+            upstream_pending_size(upstream_shm_) > 0) {
+            preempted_orders += process_upstream_orders();
+            ++stats_.ingress_preemptions;
+        }
+        const std::size_t want = std::min(batch_limit - processed, chunk_limit);
+        const std::size_t popped = trades_shm_->response_queue.try_pop_bulk(responses.data(), want);
+        const TimestampNs popped_ns = tsc_clock::now_monotonic_ns();
+        for (std::size_t i = 0; i < std::min(popped, kDrainPrefetchDistance); ++i) {
+            order_book_.prefetch_order(responses[i].internal_order_id);
+        }
+        for (std::size_t i = 0; i < popped; ++i) {
+            if (i + kDrainPrefetchDistance < popped) {
+                order_book_.prefetch_order(responses[i + kDrainPrefetchDistance].internal_order_id);
+            }
+            if (i + 1 < popped) {
+                prefetch_response_dependents(responses[i + 1].internal_order_id);
+            }
+            // 紧凑消息就地解码为进程内 TradeResponse，下游处理（含复制与执行引擎）不感知队列编码
+            unpack_trade_response_message(responses[i], response);
+            if constexpr ((Features & kLoopFeatureDiagnostics) != 0) {
+                if (traffic_capture_) {
+                    traffic_capture_->capture_response(response);
+                }
+            }
+            handle_trade_response(response);
+            if constexpr ((Features & kLoopFeatureExecution) != 0) {
+                if (execution_engine_) {
+                    execution_engine_->replenish_clips(loop_clock_.now_ns());
+                }
+            }
+            stage_latency_->response_to_settle.record(tsc_clock::now_monotonic_ns() - popped_ns);
+        }
+        processed += popped;
+        if (popped < want) {
+            break;
+        }
     }
 
     if (processed > 0) {
         stats_.responses_processed += processed;
-        stats_.last_response_time = now_ns();
+        stats_.last_response_time = loop_clock_.now_ns();
     }
 
     return processed;
 }
 
-void EventLoop::handle_order_request(OrderIndex index, OrderRequest& request) {
+// 条目已在 k 项前预取，此处读出持仓行句柄与订单槽位下标，让两次依赖访问与当前回报处理重叠
+void EventLoop::prefetch_response_dependents(InternalOrderId order_id) {
+    const OrderEntry* entry = order_book_.find_order(order_id);
+    if (!entry) {
+        return;
+    }
+    positions_.prefetch_position(entry->request.security_handle);
+    orders_shm_prefetch_slot(orders_shm_, entry->shm_order_index);
+}
+
+OrderEntry* EventLoop::admit_order(OrderIndex index, OrderRequest& request, StrategyId strategy_id,
+                                   TimestampNs dequeue_ns, TimestampNs& out_risk_done_ns) {
     if (request.order_type == OrderType::New && request.internal_security_id.empty() && !request.security_id.empty()) {
         if (!build_internal_security_id(request.market, request.security_id.view(), request.internal_security_id)) {
             request.order_state.store(OrderState::TraderError, std::memory_order_release);
-            (void)orders_shm_sync_order(orders_shm_, index, request, now_ns());
-            (void)orders_shm_update_stage(orders_shm_, index, OrderSlotState::QueuePushFailed, now_ns());
-            ErrorStatus status = ACCT_MAKE_ERROR(ErrorDomain::order, ErrorCode::InvalidParam, "EventLoop",
-                                                 "invalid market/security_id for internal key", 0);
-            record_error(status);
-            ACCT_LOG_ERROR_STATUS(status);
-            return;
+            const TimestampNs update_ns = loop_clock_.now_ns();
+            (void)orders_shm_mutate_slot(orders_shm_, index, update_ns, [&](OrderSlot& slot) {
+                (void)orders_shm_copy_changed_lines(slot.request, request);
+                slot.stage = OrderSlotState::QueuePushFailed;
+                slot.last_update_ns = update_ns;
+            });
+            ACCT_REPORT_ERROR(ErrorDomain::order, ErrorCode::InvalidParam, "EventLoop",
+                              "invalid market/security_id for internal key", 0);
+            return nullptr;
         }
     }
 
     if (request.internal_order_id == 0) {
-        if (upstream_shm_) {
-            request.internal_order_id = upstream_shm_->header.next_order_id.fetch_add(1, std::memory_order_relaxed);
-        } else {
-            request.internal_order_id = order_book_.next_order_id();
-        }
-        (void)orders_shm_sync_order(orders_shm_, index, request, now_ns());
+        request.internal_order_id = orders_shm_order_id(orders_shm_, index);
+        (void)orders_shm_sync_order_delta(orders_shm_, index, request, loop_clock_.now_ns());
     }
 
     prepare_order_estimate(request);
+    // 入簿时解析一次持仓行句柄，后续风控与成交结算直接按下标访问持仓行
+    if (request.order_type == OrderType::New && !request.internal_security_id.empty()) {
+        request.security_handle = positions_.resolve_security_handle(request.internal_security_id);
+    }
 
     OrderEntry entry{};
     entry.request = request;
-    entry.submit_time_ns = now_ns();
+    entry.submit_time_ns = loop_clock_.now_ns();
     entry.last_update_ns = entry.submit_time_ns;
-    entry.strategy_id = static_cast<StrategyId>(0);
+    entry.strategy_id = strategy_id;
     entry.risk_result = RiskResult::Pass;
     entry.retry_count = 0;
     entry.is_split_child = false;
@@ -348,18 +1647,22 @@ void EventLoop::handle_order_request(OrderIndex index, OrderRequest& request) {
     entry.shm_order_index = index;
 
     if (!order_book_.add_order(entry)) {
-        (void)orders_shm_update_stage(orders_shm_, index, OrderSlotState::QueuePushFailed, now_ns());
-        ErrorStatus status =
-            ACCT_MAKE_ERROR(ErrorDomain::order, ErrorCode::OrderBookFull, "EventLoop", "OrderBook add_order failed", 0);
-        record_error(status);
-        ACCT_LOG_ERROR_STATUS(status);
-        return;
+        (void)orders_shm_update_stage(orders_shm_, index, OrderSlotState::QueuePushFailed, loop_clock_.now_ns());
+        ACCT_REPORT_ERROR(ErrorDomain::order, ErrorCode::OrderBookFull, "EventLoop", "OrderBook add_order failed", 0);
+        return nullptr;
     }
     // 风控检查
     order_book_.update_state(request.internal_order_id, OrderState::RiskControllerPending);
 
     if (request.order_type == OrderType::New) {
-        const risk_check_result risk_result = risk_.check_order(request);
+        // 暂停的来源策略在风控之前拒绝，不占用风控的流速与自成交状态
+        const bool paused = paused_strategies_.test(strategy_id);
+        const risk_check_result risk_result =
+            paused ? risk_check_result::reject(RiskResult::RejectStrategyPaused, risk_message_id::StrategyPaused)
+                   : risk_.check_order(request, strategy_id);
+        if (paused) {
+            ++stats_.paused_rejects;
+        }
 
         if (OrderEntry* active = order_book_.find_order(request.internal_order_id)) {
             active->risk_result = risk_result.code;
@@ -367,102 +1670,260 @@ void EventLoop::handle_order_request(OrderIndex index, OrderRequest& request) {
 
         if (!risk_result.passed()) {
             order_book_.update_state(request.internal_order_id, OrderState::RiskControllerRejected);
-            (void)orders_shm_update_stage(orders_shm_, index, OrderSlotState::RiskRejected, now_ns());
-            return;
+            (void)orders_shm_update_stage(orders_shm_, index, OrderSlotState::RiskRejected, loop_clock_.now_ns());
+            stage_latency_->upstream_to_risk.record(tsc_clock::now_monotonic_ns() - dequeue_ns);
+            return nullptr;
         }
 
         order_book_.update_state(request.internal_order_id, OrderState::RiskControllerAccepted);
     } else {
         order_book_.update_state(request.internal_order_id, OrderState::RiskControllerAccepted);
     }
+    const TimestampNs risk_done_ns = tsc_clock::now_monotonic_ns();
+    stage_latency_->upstream_to_risk.record(risk_done_ns - dequeue_ns);
+    orders_shm_mark_hop(orders_shm_, index, OrderLatencyHop::RiskAccepted, risk_done_ns);
+
+    out_risk_done_ns = risk_done_ns;
+    return order_book_.find_order(request.internal_order_id);
+}
 
+void EventLoop::handle_order_request(OrderIndex index, OrderRequest& request, StrategyId strategy_id,
+                                     TimestampNs dequeue_ns) {
+    // 在处理函数入口发布，推迟的优先撤单与篮子中混入的普通单都按主机实际处理顺序出现
+    if (replication_sink_) {
+        replication_sink_->publish_order(index, request, strategy_id,
+                                         orders_shm_->header.next_index.load(std::memory_order_relaxed));
+    }
+    TimestampNs risk_done_ns = 0;
     // 风控通过后立刻冻结买单资金，阻断并发订单重复占用可用余额。
-    OrderEntry* active = order_book_.find_order(request.internal_order_id);
-    if (!active) {
+    if (OrderEntry* active = admit_order(index, request, strategy_id, dequeue_ns, risk_done_ns)) {
+        dispatch_order(*active, index, risk_done_ns, false);
+    }
+}
+
+void EventLoop::prepare_managed_start(OrderEntry& active) {
+    active.request.active_strategy_claimed = execution_engine_->has_active_strategy() ? 1U : 0U;
+    order_book_.update_state(active.request.internal_order_id, OrderState::TraderPending);
+}
+
+void EventLoop::on_session_start_failed(InternalOrderId order_id, OrderIndex index,
+                                        ExecutionEngine::SessionStartResult start_result) {
+    const bool rejected = start_result == ExecutionEngine::SessionStartResult::Unsupported ||
+                          start_result == ExecutionEngine::SessionStartResult::MarketDataUnavailable ||
+                          start_result == ExecutionEngine::SessionStartResult::Unsplittable ||
+                          start_result == ExecutionEngine::SessionStartResult::VolumeProfileUnavailable ||
+                          start_result == ExecutionEngine::SessionStartResult::PoolExhausted;
+    order_book_.update_state(order_id, rejected ? OrderState::TraderRejected : OrderState::TraderError);
+    const char* error_message = "failed to start execution session";
+    if (start_result == ExecutionEngine::SessionStartResult::Unsupported) {
+        error_message = "unsupported passive execution algo";
+    } else if (start_result == ExecutionEngine::SessionStartResult::MarketDataUnavailable) {
+        error_message = "managed execution requires ready market data";
+    } else if (start_result == ExecutionEngine::SessionStartResult::Unsplittable) {
+        error_message = "order is not splittable under current split config";
+    } else if (start_result == ExecutionEngine::SessionStartResult::VolumeProfileUnavailable) {
+        error_message = "vwap requires a volume profile for the security";
+    } else if (start_result == ExecutionEngine::SessionStartResult::PoolExhausted) {
+        error_message = "execution session pool exhausted";
+    }
+    (void)orders_shm_update_stage(orders_shm_, index, OrderSlotState::QueuePushFailed, loop_clock_.now_ns());
+    ErrorStatus status = ACCT_MAKE_ERROR(ErrorDomain::order,
+                                         rejected ? ErrorCode::InvalidParam : ErrorCode::SplitFailed, "EventLoop",
+                                         error_message, 0);
+    record_error(status);
+    ACCT_LOG_ERROR_STATUS(status);
+}
+
+void EventLoop::dispatch_order(OrderEntry& active, OrderIndex index, TimestampNs risk_done_ns, bool fund_reserved) {
+    // 路由可能改写条目，先取出后续要用的标识
+    const InternalOrderId order_id = active.request.internal_order_id;
+    const OrderType order_type = active.request.order_type;
+    const InternalOrderId orig_order_id = active.request.orig_internal_order_id;
+    const SecurityHandle security_handle = active.request.security_handle;
+    if (order_type == OrderType::MassCancel) {
+        handle_mass_cancel(active);
+        stage_latency_->risk_to_downstream.record(tsc_clock::now_monotonic_ns() - risk_done_ns);
         return;
     }
 
     // 时间片执行算法交给长期执行引擎管理，避免沿用一次性拆单/冻结路径。
-    if (execution_engine_ && execution_engine_->should_manage(active->request)) {
-        active->request.active_strategy_claimed = execution_engine_->has_active_strategy() ? 1U : 0U;
-        order_book_.update_state(request.internal_order_id, OrderState::TraderPending);
+    if (execution_engine_ && execution_engine_->should_manage(active.request)) {
+        prepare_managed_start(active);
         const ExecutionEngine::SessionStartResult start_result =
-            execution_engine_->start_session(index, active->request, active->strategy_id, active->submit_time_ns);
+            execution_engine_->start_session(index, active.request, active.strategy_id, active.submit_time_ns);
         if (start_result != ExecutionEngine::SessionStartResult::Started) {
-            const bool rejected = start_result == ExecutionEngine::SessionStartResult::Unsupported ||
-                                  start_result == ExecutionEngine::SessionStartResult::MarketDataUnavailable ||
-                                  start_result == ExecutionEngine::SessionStartResult::Unsplittable;
-            order_book_.update_state(request.internal_order_id,
-                                     rejected ? OrderState::TraderRejected : OrderState::TraderError);
-            const char* error_message = "failed to start execution session";
-            if (start_result == ExecutionEngine::SessionStartResult::Unsupported) {
-                error_message = "unsupported passive execution algo";
-            } else if (start_result == ExecutionEngine::SessionStartResult::MarketDataUnavailable) {
-                error_message = "managed execution requires ready market data";
-            } else if (start_result == ExecutionEngine::SessionStartResult::Unsplittable) {
-                error_message = "order is not splittable under current split config";
-            }
-            (void)orders_shm_update_stage(orders_shm_, index, OrderSlotState::QueuePushFailed, now_ns());
-            ErrorStatus status =
-                ACCT_MAKE_ERROR(ErrorDomain::order, rejected ? ErrorCode::InvalidParam : ErrorCode::SplitFailed,
-                                "EventLoop", error_message, 0);
-            record_error(status);
-            ACCT_LOG_ERROR_STATUS(status);
+            on_session_start_failed(order_id, index, start_result);
+        } else {
+            // 受管父单按一笔新单计入申报流量，子单成交照常计入成交回报
+            positions_.record_order_flow(security_handle, order_flow_event::NewOrder);
         }
         return;
     }
 
-    if (!reserve_order_resources(*active)) {
-        order_book_.update_state(request.internal_order_id, OrderState::RiskControllerRejected);
-        (void)orders_shm_update_stage(orders_shm_, index, OrderSlotState::RiskRejected, now_ns());
+    if (!fund_reserved && !reserve_order_resources(active)) {
+        order_book_.update_state(order_id, OrderState::RiskControllerRejected);
+        (void)orders_shm_update_stage(orders_shm_, index, OrderSlotState::RiskRejected, loop_clock_.now_ns());
         ACCT_LOG_WARN("EventLoop", "buy order fund reservation failed after risk pass");
         return;
     }
 
     // 进入订单路由
-    if (!router_.route_order(*active)) {
-        release_order_resources(*active);
-        order_book_.update_state(request.internal_order_id, OrderState::TraderError);
-        (void)orders_shm_update_stage(orders_shm_, index, OrderSlotState::QueuePushFailed, now_ns());
-        ErrorStatus status =
-            ACCT_MAKE_ERROR(ErrorDomain::order, ErrorCode::RouteFailed, "EventLoop", "route_order failed", 0);
-        record_error(status);
-        ACCT_LOG_ERROR_STATUS(status);
+    if (!router_.route_order(active)) {
+        release_order_resources(active);
+        order_book_.update_state(order_id, OrderState::TraderError);
+        (void)orders_shm_update_stage(orders_shm_, index, OrderSlotState::QueuePushFailed, loop_clock_.now_ns());
+        ACCT_REPORT_ERROR(ErrorDomain::order, ErrorCode::RouteFailed, "EventLoop", "route_order failed", 0);
+        return;
     }
+    if (order_type == OrderType::New) {
+        positions_.record_order_flow(security_handle, order_flow_event::NewOrder);
+    } else if (order_type == OrderType::Cancel) {
+        record_cancel_flow(orig_order_id);
+    }
+    // 执行会话在撤单回报到达前处于等待事件状态，路由成功后立即唤醒以刷新父单镜像
+    if (execution_engine_ && order_type == OrderType::Cancel) {
+        execution_engine_->on_cancel_routed(orig_order_id);
+    }
+    stage_latency_->risk_to_downstream.record(tsc_clock::now_monotonic_ns() - risk_done_ns);
 }
 
-void EventLoop::on_order_book_changed(const OrderEntry& entry, order_book_event_t event) {
-    if (!orders_shm_ || entry.shm_order_index == kInvalidOrderIndex) {
+void EventLoop::handle_mass_cancel(OrderEntry& entry) {
+    const std::size_t sent = route_mass_cancel_request(entry.request);
+
+    // 批量撤单请求本身不下发柜台，展开后即终结，由归档定时器回收
+    const InternalOrderId request_id = entry.request.internal_order_id;
+    order_book_.update_state(request_id, sent == mass_cancel_targets_.size() ? OrderState::Finished
+                                                                             : OrderState::TraderError);
+    if (sent != mass_cancel_targets_.size()) {
+        ACCT_REPORT_ERROR(ErrorDomain::order, ErrorCode::RouteFailed, "EventLoop",
+                          "mass cancel could not route every target", 0);
+    }
+}
+
+void EventLoop::record_cancel_flow(InternalOrderId orig_order_id) {
+    const OrderEntry* original = order_book_.find_order(orig_order_id);
+    positions_.record_order_flow(original ? original->request.security_handle : kInvalidSecurityHandle,
+                                 order_flow_event::Cancel);
+}
+
+void EventLoop::orders_shm_mirror::on_order_change(const OrderEntry& entry, order_book_event_t event) {
+    orders_shm_layout* orders_shm = loop->orders_shm_;
+    if (!orders_shm || entry.shm_order_index == kInvalidOrderIndex) {
         return;
     }
 
     const OrderState status = entry.request.order_state.load(std::memory_order_acquire);
-    const TimestampNs update_ns = now_ns();
+    const TimestampNs update_ns = loop->loop_clock_.now_ns();
 
     bool synced = false;
     if (event == order_book_event_t::Archived || is_terminal_state(status)) {
-        synced = orders_shm_write_order(orders_shm_, entry.shm_order_index, entry.request, OrderSlotState::Terminal,
-                                        order_slot_source_t::AccountInternal, update_ns);
+        synced = orders_shm_write_order_delta(orders_shm, entry.shm_order_index, entry.request,
+                                              OrderSlotState::Terminal, order_slot_source_t::AccountInternal, update_ns);
     } else if (status == OrderState::RiskControllerRejected) {
-        synced = orders_shm_write_order(orders_shm_, entry.shm_order_index, entry.request, OrderSlotState::RiskRejected,
-                                        order_slot_source_t::AccountInternal, update_ns);
+        synced = orders_shm_write_order_delta(orders_shm, entry.shm_order_index, entry.request,
+                                              OrderSlotState::RiskRejected, order_slot_source_t::AccountInternal,
+                                              update_ns);
     } else {
-        synced = orders_shm_sync_order(orders_shm_, entry.shm_order_index, entry.request, update_ns);
+        synced = orders_shm_sync_order_delta(orders_shm, entry.shm_order_index, entry.request, update_ns);
     }
 
     if (!synced) {
-        ErrorStatus status_err = ACCT_MAKE_ERROR(ErrorDomain::order, ErrorCode::OrderNotFound, "EventLoop",
-                                                 "failed to sync order book snapshot to orders shm", 0);
-        record_error(status_err);
-        ACCT_LOG_ERROR_STATUS(status_err);
+        ACCT_REPORT_ERROR(ErrorDomain::order, ErrorCode::OrderNotFound, "EventLoop",
+                          "failed to sync order book snapshot to orders shm", 0);
     }
+}
 
-    if (order_event_recorder_) {
-        order_event_recorder_->record_order_event(entry, event);
+// 与订单池镜像同口径：只记录已占用 orders_shm 槽位的订单
+void EventLoop::order_event_journal::on_order_change(const OrderEntry& entry, order_book_event_t event) {
+    if (!loop->order_event_recorder_ || !loop->orders_shm_ || entry.shm_order_index == kInvalidOrderIndex) {
+        return;
+    }
+    loop->order_event_recorder_->record_order_event(entry, event);
+}
+
+void EventLoop::resting_price_feed::on_order_change(const OrderEntry& entry, order_book_event_t event) {
+    if (!loop->risk_.tracking_resting_orders()) {
+        return;
+    }
+    if (event == order_book_event_t::Archived) {
+        loop->risk_.on_order_removed(entry.request.internal_order_id);
+    } else {
+        loop->risk_.on_order_update(entry.request);
+    }
+}
+
+// 只索引已占用 orders_shm 槽位的订单；链按入簿顺序头插，之后的事件只刷新在途位
+void EventLoop::orders_index_feed::on_order_change(const OrderEntry& entry, order_book_event_t event) {
+    orders_index_shm_layout* index = loop->orders_index_;
+    if (!index || entry.shm_order_index == kInvalidOrderIndex) {
+        return;
+    }
+    const bool live = event != order_book_event_t::Archived && !entry.is_terminal();
+    if (event == order_book_event_t::Added) {
+        (void)orders_index_add(index, entry.shm_order_index, entry.request.internal_security_id, entry.strategy_id,
+                               live);
+    } else {
+        orders_index_set_live(index, entry.shm_order_index, live);
     }
 }
 
+// 来源 lane 即 strategy_id；归档不改变订单状态，拆单子单的进展经父单的 ParentRefreshed 反映
+void EventLoop::order_update_feed::on_order_change(const OrderEntry& entry, order_book_event_t event) {
+    upstream_shm_layout* upstream = loop->upstream_shm_;
+    if (!upstream || event == order_book_event_t::Archived || entry.is_split_child ||
+        entry.strategy_id >= upstream_lane_count(upstream)) {
+        return;
+    }
+    const OrderRequest& request = entry.request;
+    order_update_message message{};
+    message.internal_order_id = request.internal_order_id;
+    message.orig_internal_order_id = request.orig_internal_order_id;
+    message.index = entry.shm_order_index;
+    message.order_state = request.order_state.load(std::memory_order_relaxed);
+    message.event = static_cast<uint8_t>(event);
+    message.order_type = request.order_type;
+    message.volume_traded = request.volume_traded;
+    message.volume_remain = request.volume_remain;
+    message.dvalue_traded = request.dvalue_traded;
+    message.dprice_traded = request.dprice_traded;
+    message.dfee_executed = request.dfee_executed;
+    message.update_ns = loop->loop_clock_.now_ns();
+    (void)upstream_publish_order_update(upstream, entry.strategy_id, message);
+}
+
+void EventLoop::handle_archived_response(const TradeResponse& response, OrderIndex shm_order_index) {
+    ++stats_.archived_responses;
+    if (response.volume_traded == 0) {
+        return;
+    }
+
+    // 终态后的成交（如撤单与成交交叉）：镜像补记成交量供对账，资金持仓随订单上下文已释放，不在此结算
+    ++stats_.archived_trades;
+    const TimestampNs now = loop_clock_.now_ns();
+    (void)orders_shm_mutate_slot(orders_shm_, shm_order_index, now, [&](OrderSlot& slot) {
+        OrderRequest& request = slot.request;
+        request.volume_traded += response.volume_traded;
+        if (request.volume_entrust > 0 && request.volume_traded > request.volume_entrust) {
+            request.volume_traded = request.volume_entrust;
+        }
+        request.volume_remain =
+            response.volume_traded >= request.volume_remain ? 0 : request.volume_remain - response.volume_traded;
+        request.dvalue_traded += response.dvalue_traded;
+        request.dfee_executed += response.dfee;
+        if (request.volume_traded > 0 && request.dvalue_traded > 0) {
+            request.dprice_traded = request.dvalue_traded / request.volume_traded;
+        }
+        slot.last_update_ns = now;
+    });
+    // 撤单与成交交叉时属预期路径，已计入 archived_trades，只留一条告警供对账，不走错误上报
+    ACCT_LOG_WARN("EventLoop", "late fill for archived order " + std::to_string(response.internal_order_id) +
+                                   ", applied to orders_shm only");
+}
+
 void EventLoop::handle_trade_response(const TradeResponse& response) {
+    if (replication_sink_) {
+        replication_sink_->publish_response(response);
+    }
     if (execution_engine_) {
         execution_engine_->on_trade_response(response);
     }
@@ -471,7 +1932,38 @@ void EventLoop::handle_trade_response(const TradeResponse& response) {
         return;
     }
 
-    order_book_.update_state(response.internal_order_id, response.new_state);
+    // 已归档订单的迟到回报在进入订单簿更新前分流，避免 update_state/update_trade/archive_order 逐个报未找到
+    OrderIndex archived_index = kInvalidOrderIndex;
+    if (order_book_.find_order(response.internal_order_id) == nullptr &&
+        order_book_.find_archived(response.internal_order_id, archived_index)) {
+        handle_archived_response(response, archived_index);
+        return;
+    }
+
+    // 首个回报打点须在状态推进前完成，终态订单可能随后被归档移出订单簿
+    order_transition step = order_state_transition(OrderState::NotSet, response.new_state);
+    if (const OrderEntry* responded = order_book_.find_order(response.internal_order_id)) {
+        if (response.broker_order_id != 0 && responded->request.broker_order_id.as_uint == 0) {
+            const bool dense = downstream_shm_ != nullptr &&
+                               (downstream_shm_->broker_capabilities.load(std::memory_order_acquire) &
+                                kBrokerCapDenseBrokerIds) != 0;
+            (void)order_book_.bind_broker_order_id(response.internal_order_id, response.broker_order_id, dense);
+        }
+        orders_shm_mark_hop(orders_shm_, responded->shm_order_index, OrderLatencyHop::FirstResponse,
+                            tsc_clock::now_monotonic_ns());
+        step = order_state_transition(responded->request.order_state.load(std::memory_order_acquire),
+                                      response.new_state);
+        if ((step.effects & kOrderStepApplyReplace) != 0 && responded->request.order_type == OrderType::Replace) {
+            apply_replace(responded->request);
+        }
+    }
+
+    // 乱序或终态后的迟到回报不回退状态，成交数量仍照常累计
+    if ((step.effects & kOrderStepStore) != 0) {
+        order_book_.update_state(response.internal_order_id, step.next);
+    } else if ((step.effects & kOrderStepStale) != 0) {
+        ++stats_.stale_responses;
+    }
 
     OrderEntry* order = order_book_.find_order(response.internal_order_id);
 
@@ -483,67 +1975,61 @@ void EventLoop::handle_trade_response(const TradeResponse& response) {
         if (order && order->request.order_type == OrderType::New) {
             if (response.trade_side == TradeSide::Buy) {
                 if (!settle_buy_trade_fund(*order, response.dvalue_traded, response.dfee)) {
-                    ErrorStatus status =
-                        ACCT_MAKE_ERROR(ErrorDomain::portfolio, ErrorCode::PositionUpdateFailed, "EventLoop",
-                                        "failed to settle buy fund from trade response", 0);
-                    record_error(status);
-                    ACCT_LOG_ERROR_STATUS(status);
+                    ACCT_REPORT_ERROR(ErrorDomain::portfolio, ErrorCode::PositionUpdateFailed, "EventLoop",
+                                      "failed to settle buy fund from trade response", 0);
                 }
             } else if (response.trade_side == TradeSide::Sell) {
                 if (!positions_.apply_sell_trade_fund(response.dvalue_traded, response.dfee,
                                                       response.internal_order_id)) {
-                    ErrorStatus status =
-                        ACCT_MAKE_ERROR(ErrorDomain::portfolio, ErrorCode::PositionUpdateFailed, "EventLoop",
-                                        "failed to settle sell fund from trade response", 0);
-                    record_error(status);
-                    ACCT_LOG_ERROR_STATUS(status);
+                    ACCT_REPORT_ERROR(ErrorDomain::portfolio, ErrorCode::PositionUpdateFailed, "EventLoop",
+                                      "failed to settle sell fund from trade response", 0);
                 }
             }
 
-            const InternalSecurityId security_id = response.internal_security_id.empty()
-                                                       ? order->request.internal_security_id
-                                                       : response.internal_security_id;
+            const bool response_matches_order = response.internal_security_id.empty() ||
+                                                response.internal_security_id == order->request.internal_security_id;
+            const InternalSecurityId security_id =
+                response_matches_order ? order->request.internal_security_id : response.internal_security_id;
 
             if (!security_id.empty()) {
-                if (!positions_.get_position(security_id) && !order->request.security_id.empty()) {
+                SecurityHandle handle = response_matches_order ? order->request.security_handle
+                                                               : kInvalidSecurityHandle;
+                if (handle == kInvalidSecurityHandle) {
+                    handle = positions_.resolve_security_handle(security_id);
+                }
+                if (handle == kInvalidSecurityHandle && !order->request.security_id.empty()) {
                     const std::string_view position_name = !order->request.internal_security_id.empty()
                                                                ? order->request.internal_security_id.view()
                                                                : security_id.view();
                     const InternalSecurityId added = positions_.add_security(order->request.security_id.view(),
                                                                              position_name, order->request.market);
                     if (added.empty()) {
-                        ErrorStatus status = ACCT_MAKE_ERROR(ErrorDomain::portfolio, ErrorCode::PositionUpdateFailed,
-                                                             "EventLoop", "failed to create missing position row", 0);
-                        record_error(status);
-                        ACCT_LOG_ERROR_STATUS(status);
+                        ACCT_REPORT_ERROR(ErrorDomain::portfolio, ErrorCode::PositionUpdateFailed, "EventLoop",
+                                          "failed to create missing position row", 0);
                     } else if (added != security_id) {
-                        ErrorStatus status =
-                            ACCT_MAKE_ERROR(ErrorDomain::portfolio, ErrorCode::OrderInvariantBroken, "EventLoop",
-                                            "security id mismatch while creating position row", 0);
-                        record_error(status);
-                        ACCT_LOG_ERROR_STATUS(status);
+                        ACCT_REPORT_ERROR(ErrorDomain::portfolio, ErrorCode::OrderInvariantBroken, "EventLoop",
+                                          "security id mismatch while creating position row", 0);
                     }
+                    handle = positions_.resolve_security_handle(security_id);
+                }
+                if (response_matches_order) {
+                    order->request.security_handle = handle;
                 }
 
                 if (response.trade_side == TradeSide::Buy) {
-                    if (!positions_.add_position(security_id, response.volume_traded, response.dprice_traded,
-                                                 response.internal_order_id)) {
-                        ErrorStatus status =
-                            ACCT_MAKE_ERROR(ErrorDomain::portfolio, ErrorCode::PositionUpdateFailed, "EventLoop",
-                                            "failed to add position from trade response", 0);
-                        record_error(status);
-                        ACCT_LOG_ERROR_STATUS(status);
+                    if (!positions_.add_position(handle, response.volume_traded, response.dprice_traded,
+                                                 response.internal_order_id, response.dfee)) {
+                        ACCT_REPORT_ERROR(ErrorDomain::portfolio, ErrorCode::PositionUpdateFailed, "EventLoop",
+                                          "failed to add position from trade response", 0);
                     }
                 } else if (response.trade_side == TradeSide::Sell) {
-                    if (!positions_.deduct_position(security_id, response.volume_traded, response.dvalue_traded,
-                                                    response.internal_order_id)) {
-                        ErrorStatus status =
-                            ACCT_MAKE_ERROR(ErrorDomain::portfolio, ErrorCode::PositionUpdateFailed, "EventLoop",
-                                            "failed to deduct position from trade response", 0);
-                        record_error(status);
-                        ACCT_LOG_ERROR_STATUS(status);
+                    if (!positions_.deduct_position(handle, response.volume_traded, response.dvalue_traded,
+                                                    response.internal_order_id, response.dfee)) {
+                        ACCT_REPORT_ERROR(ErrorDomain::portfolio, ErrorCode::PositionUpdateFailed, "EventLoop",
+                                          "failed to deduct position from trade response", 0);
                     }
                 }
+                positions_.record_order_flow(handle, order_flow_event::Fill);
             }
         }
     }
@@ -559,55 +2045,50 @@ void EventLoop::handle_trade_response(const TradeResponse& response) {
         }
     }
 
-    if (!is_terminal_state(response.new_state)) {
-        pending_archive_deadlines_ns_.erase(response.internal_order_id);
-        return;
-    }
-
-    if (!config_.archive_terminal_orders) {
-        pending_archive_deadlines_ns_.erase(response.internal_order_id);
+    if ((step.effects & kOrderStepTerminal) == 0 || !config_.archive_terminal_orders) {
         return;
     }
 
     if (config_.terminal_archive_delay_ms == 0) {
         (void)order_book_.archive_order(response.internal_order_id);
-        pending_archive_deadlines_ns_.erase(response.internal_order_id);
         return;
     }
 
-    const TimestampNs deadline_ns = now_ns() + static_cast<TimestampNs>(config_.terminal_archive_delay_ms) * 1000000ULL;
-    pending_archive_deadlines_ns_[response.internal_order_id] = deadline_ns;
-}
-
-void EventLoop::process_pending_archives(TimestampNs now_ns_value) {
-    if (pending_archive_deadlines_ns_.empty()) {
+    // 已在归档等待中的订单不重复登记，迟到回报的顺延由到期时按 last_update_ns 复查
+    if ((step.effects & kOrderStepBecameTerminal) == 0) {
         return;
     }
+    const TimestampNs now = loop_clock_.now_ns();
+    const TimestampNs deadline_ns = now + static_cast<TimestampNs>(config_.terminal_archive_delay_ms) * 1000000ULL;
+    (void)archive_timers_.schedule(now, deadline_ns, response.internal_order_id);
+}
 
-    std::vector<InternalOrderId> due_order_ids;
-    due_order_ids.reserve(pending_archive_deadlines_ns_.size());
-    for (const auto& item : pending_archive_deadlines_ns_) {
-        if (now_ns_value >= item.second) {
-            due_order_ids.push_back(item.first);
+std::size_t EventLoop::process_pending_archives(TimestampNs now_ns_value) {
+    // 只触达到期槽位；到期时订单已归档或不再是终态则跳过，期间又有回报则按最近更新时间顺延
+    const TimestampNs delay_ns = static_cast<TimestampNs>(config_.terminal_archive_delay_ms) * 1000000ULL;
+    // 超出本轮归档额度的到期项顺延到下一个 tick，收盘前集中到期时分摊到后续轮次
+    const std::size_t archive_limit = drain_plan_.archives;
+    std::size_t archived = 0;
+    archive_timers_.advance(now_ns_value, [this, now_ns_value, delay_ns, archive_limit,
+                                           &archived](InternalOrderId order_id) {
+        if (archived >= archive_limit) {
+            (void)archive_timers_.schedule(now_ns_value, now_ns_value, order_id);
+            return;
         }
-    }
-
-    for (InternalOrderId order_id : due_order_ids) {
         const OrderEntry* entry = order_book_.find_order(order_id);
-        if (!entry) {
-            pending_archive_deadlines_ns_.erase(order_id);
-            continue;
+        if (!entry || !is_terminal_state(entry->request.order_state.load(std::memory_order_acquire))) {
+            return;
         }
-
-        const OrderState status = entry->request.order_state.load(std::memory_order_acquire);
-        if (!is_terminal_state(status)) {
-            pending_archive_deadlines_ns_.erase(order_id);
-            continue;
+        const TimestampNs deadline_ns = entry->last_update_ns + delay_ns;
+        if (deadline_ns > now_ns_value) {
+            (void)archive_timers_.schedule(now_ns_value, deadline_ns, order_id);
+            return;
         }
-
-        (void)order_book_.archive_order(order_id);
-        pending_archive_deadlines_ns_.erase(order_id);
-    }
+        if (order_book_.archive_order(order_id)) {
+            ++archived;
+        }
+    });
+    return archived;
 }
 
 void EventLoop::update_latency_stats(TimestampNs start, TimestampNs end) {
@@ -624,28 +2105,34 @@ void EventLoop::update_latency_stats(TimestampNs start, TimestampNs end) {
 
 void EventLoop::print_periodic_stats() {
     std::fprintf(stderr,
-                 "[EventLoop] iter=%llu orders=%llu responses=%llu idle=%llu avg_ns=%.0f min_ns=%llu max_ns=%llu\n",
+                 "[EventLoop] iter=%llu orders=%llu cancels=%llu deferred=%llu responses=%llu idle=%llu avg_ns=%.0f "
+                 "min_ns=%llu max_ns=%llu\n",
                  static_cast<unsigned long long>(stats_.total_iterations),
                  static_cast<unsigned long long>(stats_.orders_processed),
+                 static_cast<unsigned long long>(stats_.priority_cancels),
+                 static_cast<unsigned long long>(stats_.deferred_cancels),
                  static_cast<unsigned long long>(stats_.responses_processed),
                  static_cast<unsigned long long>(stats_.idle_iterations), stats_.avg_latency_ns(),
                  static_cast<unsigned long long>(stats_.min_latency_ns == UINT64_MAX ? 0 : stats_.min_latency_ns),
                  static_cast<unsigned long long>(stats_.max_latency_ns));
-}
 
-void EventLoop::set_cpu_affinity(int core) {
-#if defined(__linux__)
-    if (core < 0) {
-        return;
-    }
-
-    cpu_set_t cpuset;
-    CPU_ZERO(&cpuset);
-    CPU_SET(core, &cpuset);
-    (void)sched_setaffinity(0, sizeof(cpu_set_t), &cpuset);
-#else
-    (void)core;
-#endif
+    const auto print_stage = [](const char* stage, const latency_histogram& histogram) {
+        const uint64_t count = histogram.count.load(std::memory_order_acquire);
+        if (count == 0) {
+            return;
+        }
+        std::fprintf(stderr,
+                     "[EventLoop] stage=%s count=%llu p50_ns=%llu p99_ns=%llu p999_ns=%llu max_ns=%llu\n", stage,
+                     static_cast<unsigned long long>(count),
+                     static_cast<unsigned long long>(histogram.percentile(0.50)),
+                     static_cast<unsigned long long>(histogram.percentile(0.99)),
+                     static_cast<unsigned long long>(histogram.percentile(0.999)),
+                     static_cast<unsigned long long>(histogram.max_ns.load(std::memory_order_relaxed)));
+    };
+    print_stage("upstream_to_risk", stage_latency_->upstream_to_risk);
+    print_stage("risk_to_downstream", stage_latency_->risk_to_downstream);
+    print_stage("response_to_settle", stage_latency_->response_to_settle);
+    print_stage("execution_tick", stage_latency_->execution_tick);
 }
 
 }  // namespace acct_service
@@ -1,11 +1,27 @@
 #pragma once
 
+#include <array>
 #include <atomic>
+#include <bitset>
 #include <cstdint>
-#include <unordered_map>
-
+#include <vector>
+
+#include "common/batch_scheduler.hpp"
+#include "common/idle_strategy.hpp"
+#include "common/latency_histogram.hpp"
+#include "common/memory_accounting.hpp"
+#include "common/metrics_registry.hpp"
+#include "common/snapshot_slot.hpp"
+#include "common/time_utils.hpp"
+#include "common/timer_wheel.hpp"
 #include "common/types.hpp"
 #include "core/config_manager.hpp"
+#include "core/flight_recorder.hpp"
+#include "core/replication.hpp"
+#include "core/restart_checkpoint.hpp"
+#include "core/traffic_capture.hpp"
+#include "execution/execution_engine.hpp"
+#include "market_data/market_data_service.hpp"
 #include "order/order_book.hpp"
 #include "order/order_event_recorder.hpp"
 #include "order/order_router.hpp"
@@ -16,14 +32,28 @@
 namespace acct_service {
 
 struct account_info;
-class ExecutionEngine;
 
 // 事件循环统计
 struct event_loop_stats {
     uint64_t total_iterations = 0;       // 事件循环总迭代次数
     uint64_t orders_processed = 0;       // 已处理上游订单总数
+    uint64_t priority_cancels = 0;       // 经撤单优先队列出队的撤单数（计入 orders_processed）
+    uint64_t deferred_cancels = 0;       // 原单尚未入簿、推迟到订单队列之后处理的优先撤单数
     uint64_t responses_processed = 0;    // 已处理下游成交回报总数
+    uint64_t stale_responses = 0;        // 乱序或终态后到达、按状态机保持原状态的回报数
+    uint64_t archived_responses = 0;     // 订单已归档后到达、经归档索引识别的回报数（不进入订单簿查找错误路径）
+    uint64_t archived_trades = 0;        // 其中带成交的回报数：只累计到 orders_shm 镜像，不结算资金持仓
     uint64_t idle_iterations = 0;        // 空闲迭代次数（无订单且无回报）
+    uint64_t config_reloads = 0;         // 已应用的配置热更新次数
+    uint64_t ingress_preemptions = 0;    // 回报排空中途让位给上游订单的次数（response_preempt_batch）
+    uint64_t orders_rollovers = 0;       // 已完成的订单池换日切换次数
+    uint64_t stale_orders_rejected = 0;  // 换日后仍写入旧订单池、被就地拒绝的上游请求数
+    uint64_t replicated_records = 0;     // 影子模式下重放的主机记录数（订单与回报另计入上两项）
+    uint64_t budget_overruns = 0;        // 自适应批量开启时单轮工作超出 iteration_budget_us 的轮数
+    uint64_t inline_orders = 0;          // 经 lane 内联消息环取得请求、未读订单池槽位的上游订单数
+    uint64_t inline_skipped = 0;         // 与下标对不上而丢弃的孤立内联消息数（生产者在两次入队之间退出）
+    uint64_t admin_commands = 0;         // 已执行的运维指令数（含拒绝与不支持）
+    uint64_t paused_rejects = 0;         // 来源策略被运维指令暂停而拒绝的新单数
     TimestampNs start_time = 0;          // 事件循环启动时间（Unix Epoch 纳秒）
     TimestampNs last_order_time = 0;     // 最近一次处理订单时间（Unix Epoch 纳秒）
     TimestampNs last_response_time = 0;  // 最近一次处理回报时间（Unix Epoch 纳秒）
@@ -37,6 +67,39 @@ struct event_loop_stats {
     double avg_latency_ns() const;
 };
 
+// 事件循环内联阶段：每轮在处理完上游订单、处理回报之前调用，返回本轮工作量（计入空闲判定）。
+// 进程内网关以此挂到事件循环线程上，新单在同一轮内完成下游提交，同步产生的回报也在同一轮入账
+struct loop_stage_hook {
+    std::size_t (*fn)(void* context) = nullptr;
+    void* context = nullptr;
+
+    explicit operator bool() const noexcept { return fn != nullptr; }
+    std::size_t operator()() const { return fn(context); }
+
+    template <typename T, std::size_t (T::*Method)()>
+    static loop_stage_hook bind(T* object) noexcept {
+        loop_stage_hook hook;
+        hook.fn = [](void* context) { return (static_cast<T*>(context)->*Method)(); };
+        hook.context = object;
+        return hook;
+    }
+};
+
+// 事件循环可裁剪特性：循环骨架按特性位集合实例化，位清零的特性在该实例中编译期去除，
+// 置位的特性仍按运行时指针与配置判定。订单入簿与风控路径不参与裁剪
+inline constexpr uint32_t kLoopFeatureExecution = 0x1;      // 执行引擎 tick 与回报后补量
+inline constexpr uint32_t kLoopFeatureArchives = 0x2;       // 终态延迟归档
+inline constexpr uint32_t kLoopFeatureInlineStage = 0x4;    // 内联阶段（进程内网关）
+inline constexpr uint32_t kLoopFeaturePeriodic = 0x8;       // 周期统计、检查点、盯市与指标发布
+inline constexpr uint32_t kLoopFeatureDiagnostics = 0x10;   // 飞行记录仪、流量录制、影子模式与模拟时钟
+inline constexpr uint32_t kLoopFeaturesAll = 0x1F;          // 通用实例（兜底）
+
+// 预置的部署形态实例，启动时取第一个覆盖所需特性的形态，都不覆盖时用通用实例：
+// Minimal 无执行引擎、无归档、无周期任务；Direct 直连柜台只带周期任务；Archiving 再加终态归档
+inline constexpr uint32_t kLoopShapeMinimal = 0;
+inline constexpr uint32_t kLoopShapeDirect = kLoopFeaturePeriodic;
+inline constexpr uint32_t kLoopShapeArchiving = kLoopFeaturePeriodic | kLoopFeatureArchives;
+
 // 事件循环
 class EventLoop {
 public:
@@ -44,7 +107,8 @@ public:
     EventLoop(const EventLoopConfig& config, upstream_shm_layout* upstream_shm, downstream_shm_layout* downstream_shm,
               trades_shm_layout* trades_shm, orders_shm_layout* orders_shm, OrderBook& OrderBook, order_router& router,
               PositionManager& positions, RiskManager& risk, const account_info* account_info = nullptr,
-              ExecutionEngine* execution_engine = nullptr, OrderEventRecorder* order_event_recorder = nullptr);
+              ExecutionEngine* execution_engine = nullptr, OrderEventRecorder* order_event_recorder = nullptr,
+              stats_shm_layout* stats_shm = nullptr, restart_checkpoint_writer* checkpoint_writer = nullptr);
 
     // 析构时会确保循环停止
     ~EventLoop();
@@ -56,33 +120,224 @@ public:
     // 运行事件循环（阻塞）
     void run();
 
+    // 外部调度模式（多账户托管）：start() 进入运行态但不绑核、不注册信号，由调度方反复调用 run_once()，
+    // 结束时调用 finish() 落最后一份检查点。run() 即 start + 循环 + finish 的阻塞组合
+    bool start();
+    // 执行一轮且不做空闲等待，返回本轮处理的订单、回报与内联阶段工作量；未运行时返回 0
+    std::size_t run_once();
+    void finish();
+
     // 请求停止
     void stop() noexcept;
 
+    // 设置内联阶段（需在 run/start 之前设置，空钩子表示关闭）
+    void set_inline_stage(loop_stage_hook hook) noexcept;
+
+    // 挂接迭代飞行记录仪（可为空）；记录仪须比事件循环活得久
+    void set_flight_recorder(iteration_flight_recorder* recorder) noexcept { flight_recorder_ = recorder; }
+
+    // 热备主机：挂接复制发送端（可为空），订单与回报在处理函数入口按处理顺序发布；须在 run/start 之前设置
+    void set_replication_sink(replication_sender* sink) noexcept { replication_sink_ = sink; }
+
+    // 挂接 SHM 队列流量录制（可为空）：上游槽位出队与回报出队时按处理顺序落盘；须在 run/start 之前设置
+    void set_traffic_capture(traffic_capture* capture) noexcept { traffic_capture_ = capture; }
+
+    // 挂接订单池二级索引段（可为空）：订单入簿时入链、状态变化时刷新在途位，换日时随订单池一起重置；
+    // 段须已绑定当前交易日（orders_index_reset），须在 run/start 之前设置
+    void set_orders_index(orders_index_shm_layout* index) noexcept { orders_index_ = index; }
+
+    // 挂接运维指令段（可为空）：每 admin_poll_iterations 轮取一次指令，单次最多执行 kAdminCommandsPerPoll 条，
+    // 结果写回完成环；须在 run/start 之前设置
+    void set_admin_channel(admin_shm_layout* admin) noexcept {
+        admin_shm_ = admin;
+        admin_countdown_ = admin ? config_.admin_poll_iterations : 0;
+    }
+
+    // ReloadConfig 指令的转交目标（通常为配置热更新线程的 request_reload），未设置时该指令以 Rejected 返回；
+    // 在循环线程调用，须不阻塞。须在 run/start 之前设置
+    void set_reload_requester(void (*fn)(void* context), void* context) noexcept {
+        reload_requester_ = reload_requester{fn, context};
+    }
+
+    // 挂接组件内存占用表（可为空）：开启指标时按秒级周期 publish() 到已绑定的 mem.* 指标；须在 run/start 之前设置
+    void set_memory_accounting(memory_accounting* memory) noexcept { memory_ = memory; }
+
+    // 来源策略是否被 PauseStrategy 指令暂停（仅循环线程，或循环停转后读取）
+    bool strategy_paused(StrategyId strategy_id) const noexcept { return paused_strategies_.test(strategy_id); }
+
+    // 挂接行情服务（可为空）：mark_to_market_interval_ms > 0 时按周期给持仓行盯市；须在 run/start 之前设置
+    void set_market_data(MarketDataService* market_data) noexcept { market_data_ = market_data; }
+
+    // 挂接模拟时钟（可为空）：每轮循环时间、执行会话 tick 与归档到期改按模拟时钟推进，阶段耗时仍测真实耗时。
+    // 供测试、压测与回放按 CPU 速度驱动长时间调度；预置部署形态不含该特性，生产实例仍直接读 TSC。
+    // 须在 run/start 之前设置，时钟须比事件循环活得久
+    void set_sim_clock(const sim_clock* clock) noexcept {
+        sim_clock_ = clock;
+        refresh_loop_clock();
+    }
+
+    // 热备备机：挂接复制接收端后进入影子模式，每轮只重放主机记录，不读本机上游与回报、不推进执行会话，
+    // 路由产生的下游消息直接丢弃（主机网关已发出）。须在 run/start 之前设置
+    void set_replication_source(replication_receiver* source) noexcept { replication_source_ = source; }
+
+    // 提升备机：任意线程（含信号处理）调用，循环在下一轮排空收件环后退出影子模式、恢复正常轮询
+    void request_promotion() noexcept { promotion_requested_.store(true, std::memory_order_release); }
+
+    // 是否仍处于影子模式（仅循环线程，或循环停转后读取）
+    bool shadowing() const noexcept { return replication_source_ != nullptr; }
+
     // 是否正在运行
     bool is_running() const noexcept;
 
+    // 当前挂接的组件与配置所需的特性位集合
+    uint32_t required_loop_features() const noexcept;
+
+    // 最近一轮运行的实例特性位集合（kLoopShape* 或 kLoopFeaturesAll）
+    uint32_t active_loop_shape() const noexcept { return active_shape_; }
+
     // 获取统计信息
     const event_loop_stats& stats() const noexcept;
 
+    // 获取分阶段延迟直方图（导出到 stats_shm 时即为共享内存中的实例）
+    const stage_latency_stats& stage_latency() const noexcept;
+
     // 重置统计
     void reset_stats() noexcept;
 
     // 注册信号处理
     void setup_signal_handlers();
 
+    // 配置热更新：由单一非循环线程调用，循环在下一轮开头取走并应用事件循环可热更新字段与整份风控配置；
+    // 上一版尚未被循环取走时返回 false。绑核、检查点、归档开关与容量类字段仍只在启动时生效
+    bool publish_config(const EventLoopConfig& loop_config, const RiskConfig& risk_config);
+
+    // 换日切换：由非循环线程交给循环一个已预取的新订单池。循环在某轮开头确认静默（无在途订单与执行会话、
+    // 上下游队列为空）后归档剩余终态订单，一次性把循环与路由切到新池，再在旧池发布后继交易日、向下游三条队列
+    // 推入换日标记，策略、网关与监控据此各自跟随；未静默时逐轮重试。上一次请求尚未完成时返回 false
+    bool request_orders_rollover(orders_shm_layout* next_orders_shm) noexcept;
+    bool orders_rollover_pending() const noexcept {
+        return pending_rollover_.load(std::memory_order_acquire) != nullptr;
+    }
+
+    // 当前订单池；换日后即新池（仅循环线程，或循环停转后读取）
+    orders_shm_layout* orders_shm() const noexcept { return orders_shm_; }
+    upstream_shm_layout* upstream_shm() const noexcept { return upstream_shm_; }
+
 private:
+    // 热更新快照：发布端整份拷入，循环线程拷出到 applied_config_ 后逐项应用
+    struct runtime_config {
+        EventLoopConfig loop;
+        RiskConfig risk;
+    };
+
+    // 取走并应用热更新快照（仅在循环线程调用）
+    void apply_config_update();
+
+    // 静默时执行待处理的换日切换（仅在循环线程调用）
+    void try_apply_orders_rollover();
+
+    // 换日后仍挂在旧池上的 lane：换日标记之前的下标属于旧池，逐笔把旧池槽位置为风控拒绝；读到标记后恢复正常排空
+    template <typename Queue>
+    std::size_t drain_retired_lane(uint32_t lane_id, Queue& queue, orders_shm_layout*& retired, std::size_t budget);
+
+    // 选出覆盖 required_loop_features() 的实例特性位集合
+    uint32_t select_loop_shape() const noexcept;
+
+    // 以特性实例 Features 持续运行，所需特性超出该实例（配置热更新后）时返回，由 run() 重新选择
+    template <uint32_t Features>
+    void run_shape();
+
+    // 以特性实例 Features 执行一轮，供 run_once() 分派
+    template <uint32_t Features>
+    std::size_t run_once_as();
+
     // 执行单轮事件循环
+    template <uint32_t Features>
     void loop_iteration();
 
+    // 单轮输入处理（订单、内联阶段、回报、执行引擎、延迟归档），返回处理的订单、回报与内联阶段工作量
+    template <uint32_t Features>
+    std::size_t poll_inputs();
+
+    // 刷新每轮循环时间：挂接了模拟时钟时取模拟时间，否则读 TSC
+    void refresh_loop_clock() noexcept {
+        if (sim_clock_) {
+            loop_clock_.refresh_from(*sim_clock_);
+        } else {
+            loop_clock_.refresh();
+        }
+    }
+
+    // 按本轮队列深度确定各类出队额度：未开启 adaptive_batching 或处于影子模式时各类都取 poll_batch_size
+    void plan_drains();
+
+    // 单轮收尾：周期统计、检查点与迭代耗时
+    template <uint32_t Features>
+    void finish_iteration(TimestampNs start);
+
+    // 周期任务：统计打印、检查点采集、盯市与指标发布
+    void run_periodic_tasks(TimestampNs now);
+
     // 批量处理上游订单，返回本轮处理数量
     std::size_t process_upstream_orders();
 
-    // 批量处理下游回报，返回本轮处理数量
-    std::size_t process_downstream_responses();
+    // 影子模式：按序重放收件环中的主机记录，返回重放数量；收到提升请求时排空收件环后退出影子模式
+    std::size_t process_replicated_inputs();
+
+    // 重放单条主机记录：订单先写回同一槽位再走 handle_order_request / handle_basket，回报走 handle_trade_response
+    void apply_replicated_record(const replication_record& record);
+
+    // 丢弃影子模式下路由推入本机下游三条队列的消息
+    void discard_shadow_downstream();
+
+    // 排空单条上游 lane，最多处理 budget 笔，返回处理数量
+    std::size_t drain_upstream_lane(uint32_t lane_id, std::size_t budget);
+
+    // 取出一条上游请求：带 kUpstreamInlineIndexFlag 的下标从 lane 消息环顺序读取并只回写阶段，
+    // 其余下标（或消息缺失时）读槽位并切换阶段；out_index 为去掉标记后的槽位下标
+    bool consume_upstream_order(uint32_t lane_id, OrderIndex entry, OrderIndex& out_index, OrderRequest& out_request);
+
+    // 从 lane 消息环取下标为 index 的内联消息；下标不符的孤立消息丢弃计数，环空时返回 false
+    bool pop_upstream_payload(uint32_t lane_id, OrderIndex index, OrderRequest& out_request);
+
+    // 排空单条 lane 的撤单优先队列，最多处理 budget 笔；原单尚未入簿的撤单登记到 deferred_cancels_
+    std::size_t drain_cancel_lane(uint32_t lane_id, std::size_t budget);
+
+    // 处理推迟的撤单：原单已入簿，或其 lane 的订单队列已排空（原单不会再到达）时按普通撤单处理
+    void process_deferred_cancels();
+
+    // 批量处理下游回报，返回本轮处理数量；开启 response_preempt_batch 时中途处理的上游订单数累加到 preempted_orders
+    template <uint32_t Features>
+    std::size_t process_downstream_responses(std::size_t& preempted_orders);
+    // 预取下一笔回报依赖的持仓行与订单槽位（订单条目须已预取）
+    void prefetch_response_dependents(InternalOrderId order_id);
 
-    // 处理单笔上游订单请求
-    void handle_order_request(OrderIndex index, OrderRequest& request);
+    // 处理单笔上游订单请求，strategy_id 为来源 lane
+    void handle_order_request(OrderIndex index, OrderRequest& request, StrategyId strategy_id, TimestampNs dequeue_ns);
+
+    // 入簿并完成风控：返回风控通过、待分发的订单条目（nullptr 表示已就地拒绝或失败），out_risk_done_ns 为风控完成时刻
+    OrderEntry* admit_order(OrderIndex index, OrderRequest& request, StrategyId strategy_id, TimestampNs dequeue_ns,
+                            TimestampNs& out_risk_done_ns);
+
+    // 分发风控通过的订单：批量撤单展开、受管执行或冻结资金后路由；fund_reserved 表示资金已由篮子合并预留
+    void dispatch_order(OrderEntry& active, OrderIndex index, TimestampNs risk_done_ns, bool fund_reserved);
+
+    // 受管父单建会话前的公共步骤：登记主动策略认领并进入 TraderPending
+    void prepare_managed_start(OrderEntry& active);
+
+    // 会话未能启动：按结果把父单置为拒绝或错误并上报
+    void on_session_start_failed(InternalOrderId order_id, OrderIndex index,
+                                 ExecutionEngine::SessionStartResult start_result);
+
+    // 篮子首腿出队后收齐其余各腿（先取本块剩余下标，不足时直接从 lane 补取），整篮处理；
+    // out_chunk_taken 返回占用的本块下标数，返回值为处理的腿数
+    std::size_t drain_basket(upstream_shm_layout::lane_queue& queue, const OrderIndex* chunk_rest,
+                             std::size_t chunk_rest_count, OrderIndex first_index, const OrderRequest& first_request,
+                             StrategyId strategy_id, TimestampNs dequeue_ns, std::size_t& out_chunk_taken);
+
+    // 整篮处理 basket_legs_：逐腿入簿风控后合并冻结一次买单资金，再逐腿分发；
+    // kBasketAllOrNothing 篮子缺腿、任一腿未通过或合并预留失败时整篮拒绝
+    void handle_basket(StrategyId strategy_id, TimestampNs dequeue_ns);
 
     // 为新单补齐手续费估算，保证风控与冻结使用一致口径。
     void prepare_order_estimate(OrderRequest& request) const;
@@ -90,31 +345,101 @@ private:
     // 在路由前冻结买单资金，防止并发订单超用可用资金。
     bool reserve_order_resources(OrderEntry& entry);
 
+    // 计算买单需冻结的总额（委托金额 + 预估手续费）；非普通买单为 0，溢出返回 false
+    bool order_fund_requirement(const OrderEntry& entry, DValue& out_total) const;
+
     // 在终态或发送失败时释放订单剩余冻结资金。
     void release_order_resources(OrderEntry& entry);
 
     // 优先从订单冻结资金结算买入成交；旧订单回退到可用资金结算。
     bool settle_buy_trade_fund(OrderEntry& entry, DValue amount, DValue fee);
 
-    // 订单簿变更回调，回写订单池镜像
-    void on_order_book_changed(const OrderEntry& entry, order_book_event_t event);
+    // 柜台受理改单后就地修改原单，并按改后的剩余委托重算买单冻结资金。
+    void apply_replace(const OrderRequest& replace);
+
+    // 展开批量撤单请求：按范围逐笔撤单后一次批量下发，请求本身随即终结
+    void handle_mass_cancel(OrderEntry& entry);
+    // 按批量撤单请求的范围路由撤单并唤醒受管父单会话，返回成功路由的目标数（目标留在 mass_cancel_targets_）
+    std::size_t route_mass_cancel_request(const OrderRequest& request);
+    // 撤单路由成功后按原单证券计入申报流量，原单已不在订单簿时只计入账户合计
+    void record_cancel_flow(InternalOrderId orig_order_id);
+
+    // 订单簿变更观察者：回写订单池镜像
+    struct orders_shm_mirror {
+        EventLoop* loop;
+        void on_order_change(const OrderEntry& entry, order_book_event_t event);
+    };
+
+    // 订单簿变更观察者：转交独立订单业务日志 recorder
+    struct order_event_journal {
+        EventLoop* loop;
+        void on_order_change(const OrderEntry& entry, order_book_event_t event);
+    };
+
+    // 订单簿变更观察者：维护自成交检查的在簿价位（风控未建表时直接返回）
+    struct resting_price_feed {
+        EventLoop* loop;
+        void on_order_change(const OrderEntry& entry, order_book_event_t event);
+    };
+
+    // 订单簿变更观察者：维护订单池二级索引（未挂接索引段时直接返回）
+    struct orders_index_feed {
+        EventLoop* loop;
+        void on_order_change(const OrderEntry& entry, order_book_event_t event);
+    };
+
+    // 订单簿变更观察者：把策略直接提交的订单（非拆单子单）的状态/成交变化写入来源 lane 的回报环
+    struct order_update_feed {
+        EventLoop* loop;
+        void on_order_change(const OrderEntry& entry, order_book_event_t event);
+    };
 
     // 处理单笔成交回报
     void handle_trade_response(const TradeResponse& response);
 
+    // 订单已归档后的迟到回报：状态回报只计数；成交回报累计到 orders_shm 镜像并报一次可恢复错误
+    void handle_archived_response(const TradeResponse& response, OrderIndex shm_order_index);
+
     // 处理到期的终态订单归档任务
-    void process_pending_archives(TimestampNs now_ns_value);
+    std::size_t process_pending_archives(TimestampNs now_ns_value);
 
     // 更新延迟统计
     void update_latency_stats(TimestampNs start, TimestampNs end);
 
+    // 空闲退避进入挂起级：有门铃时在 account_doorbell 上等待，否则定时休眠
+    void park_idle(uint32_t timeout_us);
+
+    // 上游/回报队列是否有待处理数据（挂起前复查，避免丢失唤醒）
+    bool has_pending_input() const noexcept;
+
     // 按周期打印统计信息
     void print_periodic_stats();
 
-    // 绑定线程 CPU 亲和性（可选）
-    void set_cpu_affinity(int core);
+    // 在统计段指标表中登记本循环指标；按固定周期把运行统计与队列深度写入槽位
+    void register_metrics(stats_shm_layout* stats_shm);
+    void publish_metrics();
+
+    // 按游标差采样上游与回报队列深度写入统计段直方图；越过告警线时告警一次
+    void sample_queue_depths();
+    void record_queue_depth(shm_queue_id id, std::size_t depth);
+
+    // 采集重启检查点并交给写线程；写线程仍忙时跳过本次
+    void capture_checkpoint();
+
+    // 从运维指令环取至多 kAdminCommandsPerPoll 条逐条执行并写回完成环，返回执行条数
+    std::size_t process_admin_commands();
+    admin_response execute_admin_command(const admin_command& command);
+
+    // DumpState：循环统计、在途订单、执行会话与暂停策略数写入日志
+    void dump_state();
+
+    // 按行情给全部持仓行盯市，刷新行内浮动盈亏
+    void mark_positions();
 
     EventLoopConfig config_;  // 事件循环配置快照
+    snapshot_slot<runtime_config> config_updates_;  // 热更新快照，循环每轮开头一次 acquire 读
+    runtime_config applied_config_;                 // 最近取走的热更新快照（复用字符串容量）
+    std::atomic<orders_shm_layout*> pending_rollover_{nullptr};  // 待切换的新订单池，切换完成后清空
 
     upstream_shm_layout* upstream_shm_;      // 上游共享内存（策略->账户）
     downstream_shm_layout* downstream_shm_;  // 下游共享内存（账户->交易）
@@ -128,12 +453,114 @@ private:
     const account_info* account_info_ = nullptr;          // 账户费率快照（可为空）
     ExecutionEngine* execution_engine_ = nullptr;         // 长期执行引擎（可为空）
     OrderEventRecorder* order_event_recorder_ = nullptr;  // 独立订单业务日志 recorder（可为空）
+    restart_checkpoint_writer* checkpoint_writer_ = nullptr;  // 重启检查点写线程（可为空）
+    loop_stage_hook inline_stage_{};                          // 内联阶段（进程内网关，可为空）
+    iteration_flight_recorder* flight_recorder_ = nullptr;    // 迭代飞行记录仪（可为空）
+    replication_sender* replication_sink_ = nullptr;          // 热备复制发送端（主机，可为空）
+    replication_receiver* replication_source_ = nullptr;      // 热备复制接收端（影子模式，提升后清空）
+    MarketDataService* market_data_ = nullptr;                // 盯市行情（可为空）
+    traffic_capture* traffic_capture_ = nullptr;              // SHM 队列流量录制（可为空）
+    orders_index_shm_layout* orders_index_ = nullptr;         // 订单池二级索引段（可为空）
+    std::atomic<bool> promotion_requested_{false};            // 待处理的备机提升请求
+    iteration_record* current_record_ = nullptr;              // 本轮记录槽位，finish_iteration 时提交
+    // 订单簿变更观察者，按声明顺序分发
+    order_change_observers<orders_shm_mirror, order_event_journal, resting_price_feed, orders_index_feed,
+                           order_update_feed>
+        order_observers_{orders_shm_mirror{this}, order_event_journal{this}, resting_price_feed{this},
+                         orders_index_feed{this}, order_update_feed{this}};
+    restart_checkpoint checkpoint_buffer_;                    // 检查点采集缓冲，与写线程交换复用容量
+    stage_latency_stats local_stage_latency_;              // 未导出 stats_shm 时使用的进程内直方图
+    stage_latency_stats* stage_latency_ = nullptr;         // 当前写入的分阶段直方图
+
+    idle_backoff idle_backoff_;                            // 空闲分级退避状态（adaptive_idle 时使用）
+    uint32_t active_shape_ = kLoopFeaturesAll;              // 最近一轮运行的特性实例
+    adaptive_batch_scheduler batch_scheduler_;             // 出队额度与单笔耗时估计（adaptive_batching 时使用）
+    batch_plan drain_plan_;                                // 本轮各类出队额度
+
+    // 导出到统计段的指标句柄；未配置 stats_shm 时全部未绑定
+    struct loop_metrics {
+        metric_counter iterations;
+        metric_counter idle_iterations;
+        metric_counter orders_processed;
+        metric_counter responses_processed;
+        metric_counter stale_responses;
+        metric_counter archived_responses;
+        metric_counter archived_trades;
+        metric_counter priority_cancels;
+        metric_counter config_reloads;
+        metric_counter ingress_preemptions;
+        metric_counter budget_overruns;
+        metric_counter inline_orders;
+        metric_counter inline_skipped;
+        metric_counter orders_rollovers;
+        metric_counter stale_orders_rejected;
+        metric_counter router_orders_sent;
+        metric_counter router_orders_rejected;
+        metric_counter router_queue_full;
+        metric_counter upstream_depth;
+        metric_counter downstream_depth;
+        metric_counter response_depth;
+        metric_counter active_orders;
+        metric_counter business_log_dropped;
+        metric_counter child_risk_checks;
+        metric_counter child_risk_rejects;
+    };
+    loop_metrics metrics_;
+    bool metrics_enabled_ = false;
+    queue_depth_stats* queue_depths_ = nullptr;  // 统计段中的队列深度直方图；未配置 stats_shm 时为空
+    uint32_t queue_depth_countdown_ = 0;         // 距下一次深度采样的轮数，0 表示不采样
+    admin_shm_layout* admin_shm_ = nullptr;      // 运维指令段（可为空）
+    uint32_t admin_countdown_ = 0;               // 距下一次取运维指令的轮数，0 表示不取
+    std::bitset<std::size_t{1} << (sizeof(StrategyId) * 8)> paused_strategies_;  // 按来源策略的暂停位
+    struct reload_requester {
+        void (*fn)(void* context) = nullptr;
+        void* context = nullptr;
+
+        explicit operator bool() const noexcept { return fn != nullptr; }
+    };
+    reload_requester reload_requester_{};  // ReloadConfig 指令的转交目标（可为空）
 
     std::atomic<bool> running_{false};  // 运行状态标志
     event_loop_stats stats_;            // 运行统计
+    loop_clock loop_clock_;             // 每轮开头刷新的循环时间，订单簿与路由共用
+    const sim_clock* sim_clock_ = nullptr;  // 注入的模拟时钟，为空时循环时间读 TSC
 
-    std::unordered_map<InternalOrderId, TimestampNs> pending_archive_deadlines_ns_;  // 终态订单 -> 延迟归档到期时间
+    timer_wheel<InternalOrderId> archive_timers_;  // 终态订单延迟归档定时器（到期时复查订单仍为终态）
     TimestampNs last_stats_time_ = 0;  // 最近一次打印统计的单调时钟时间
+    TimestampNs last_checkpoint_time_ = 0;  // 最近一次采集检查点的单调时钟时间
+    TimestampNs last_metrics_time_ = 0;     // 最近一次发布指标的单调时钟时间
+    memory_accounting* memory_ = nullptr;
+    TimestampNs last_memory_time_ = 0;      // 最近一次发布内存占用的单调时钟时间
+    TimestampNs last_mark_time_ = 0;        // 最近一次盯市的单调时钟时间
+    std::vector<MarketDataHandle> mark_handles_;  // 按持仓行号缓存的行情句柄，新增行在下次盯市时补解析
+    std::vector<DPrice> mark_prices_;             // 按持仓行号的盯市价格（复用容量）
+    MarketDataView mark_view_{};
+    uint32_t upstream_lane_cursor_ = 0;  // 下一轮优先排空的上游 lane
+    std::vector<InternalOrderId> mass_cancel_targets_;  // 批量撤单展开目标（复用容量）
+    // 换日后尚未读到换日标记的 lane 所挂的旧订单池，nullptr 表示已跟随当前池
+    std::array<orders_shm_layout*, kMaxUpstreamLanes> retired_order_lanes_{};
+    std::array<orders_shm_layout*, kMaxUpstreamLanes> retired_cancel_lanes_{};
+
+    // 越过了原单的优先撤单：出队时已消费槽位，保存请求等原单入簿
+    struct deferred_cancel {
+        OrderIndex index;
+        OrderRequest request;
+        StrategyId strategy_id;
+        TimestampNs dequeue_ns;
+    };
+    std::vector<deferred_cancel> deferred_cancels_;
+
+    // 篮子各腿：出队后暂存请求，整篮入簿风控后再合并预留资金
+    struct basket_leg {
+        OrderIndex index;
+        OrderRequest request;
+        TimestampNs risk_done_ns;
+        DValue fund_need;
+        bool admitted;
+    };
+    std::vector<basket_leg> basket_legs_;  // 当前篮子（复用容量，预留 kMaxBasketLegs）
+    std::vector<session_start_request> basket_starts_;                    // 当前篮子的受管腿
+    std::vector<ExecutionEngine::SessionStartResult> basket_start_results_;  // 与 basket_starts_ 按下标对应
 };
 
 }  // namespace acct_service
@@ -0,0 +1,223 @@
+#include "core/flight_recorder.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <utility>
+
+#include "common/error.hpp"
+#include "common/log.hpp"
+
+namespace acct_service {
+
+namespace {
+
+constexpr std::chrono::milliseconds kWriterWakeInterval{100};
+constexpr std::size_t kMinRingCapacity = 64;
+
+bool report_flight_recorder_error(std::string_view message, int sys_errno = 0) {
+    ErrorStatus status =
+        ACCT_MAKE_ERROR(ErrorDomain::core, ErrorCode::InvalidParam, "flight_recorder", message, sys_errno);
+    record_error(status);
+    ACCT_LOG_ERROR_STATUS(status);
+    return false;
+}
+
+// 每次转储一个头行 + 每轮一行，异常轮以 outlier=1 标出
+bool append_window(const std::string& path, uint64_t trigger, uint64_t threshold_ns,
+                   const std::vector<iteration_record>& window) {
+    std::FILE* file = std::fopen(path.c_str(), "a");
+    if (!file) {
+        return false;
+    }
+    std::fprintf(file, "dump trigger_iteration=%" PRIu64 " threshold_ns=%" PRIu64 " iterations=%zu\n", trigger,
+                 threshold_ns, window.size());
+    for (const iteration_record& record : window) {
+        std::fprintf(file,
+                     "iteration=%" PRIu64 " outlier=%d start_ns=%" PRIu64 " work_ns=%" PRIu64 " idle_ns=%" PRIu64
+                     " orders=%u responses=%u inline_work=%u sessions_ticked=%u archives=%u",
+                     record.iteration, record.iteration == trigger ? 1 : 0, record.start_ns, record.work_ns,
+                     record.idle_ns, record.orders, record.responses, record.inline_work, record.sessions_ticked,
+                     record.archives);
+        for (std::size_t phase = 0; phase < kIterationPhaseCount; ++phase) {
+            std::fprintf(file, " %s_ns=%u", iteration_phase_name(static_cast<iteration_phase>(phase)),
+                         record.phase_ns[phase]);
+        }
+        std::fputc('\n', file);
+    }
+    const bool ok = std::ferror(file) == 0;
+    return std::fclose(file) == 0 && ok;
+}
+
+}  // namespace
+
+const char* iteration_phase_name(iteration_phase phase) noexcept {
+    switch (phase) {
+        case iteration_phase::Upstream:
+            return "upstream";
+        case iteration_phase::InlineStage:
+            return "inline_stage";
+        case iteration_phase::Responses:
+            return "responses";
+        case iteration_phase::Execution:
+            return "execution";
+        case iteration_phase::Archives:
+            return "archives";
+        default:
+            return "unknown";
+    }
+}
+
+std::string iteration_flight_recorder::path_for(const std::string& dir, AccountId account_id,
+                                                const std::string& trading_day) {
+    return dir + "/flight_recorder_" + std::to_string(account_id) + "_" + trading_day + ".log";
+}
+
+iteration_flight_recorder::~iteration_flight_recorder() { stop(); }
+
+bool iteration_flight_recorder::start(std::string path, uint64_t threshold_ns, uint32_t context_iterations) {
+    stop();
+    if (path.empty()) {
+        return report_flight_recorder_error("flight recorder path is empty");
+    }
+    if (threshold_ns == 0) {
+        return report_flight_recorder_error("flight recorder threshold must be positive");
+    }
+
+    // 环至少容纳异常轮前后各 context 轮
+    const std::size_t capacity =
+        std::bit_ceil(std::max<std::size_t>(kMinRingCapacity, std::size_t{context_iterations} * 2 + 2));
+    ring_.assign(capacity, iteration_record{});
+    mask_ = capacity - 1;
+    head_ = 0;
+    threshold_ns_ = threshold_ns;
+    context_ = context_iterations;
+    post_remaining_ = 0;
+    window_pending_ = false;
+    outliers_ = 0;
+    capture_.reserve(std::size_t{context_iterations} * 2 + 1);
+    path_ = std::move(path);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        pending_.reserve(std::size_t{context_iterations} * 2 + 1);
+        stop_requested_ = false;
+        has_pending_ = false;
+    }
+    thread_ = std::thread([this]() { writer_loop(); });
+    return true;
+}
+
+void iteration_flight_recorder::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_requested_ = true;
+    }
+    cv_.notify_all();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+void iteration_flight_recorder::commit() noexcept {
+    const iteration_record& record = ring_[head_ & mask_];
+    ++head_;
+
+    // 收集窗口期间的后续异常轮并入同一份转储
+    if (window_pending_) {
+        if (post_remaining_ > 0) {
+            --post_remaining_;
+        }
+        if (post_remaining_ == 0) {
+            capture_window();
+        }
+        return;
+    }
+    if (record.work_ns < threshold_ns_) {
+        return;
+    }
+
+    ++outliers_;
+    trigger_ = record.iteration;
+    post_remaining_ = context_;
+    window_pending_ = true;
+    if (post_remaining_ == 0) {
+        capture_window();
+    }
+}
+
+void iteration_flight_recorder::capture_window() {
+    window_pending_ = false;
+    const uint64_t first = trigger_ >= context_ ? trigger_ - context_ : 0;
+    capture_.clear();
+    for (uint64_t iteration = first; iteration < head_; ++iteration) {
+        capture_.push_back(ring_[iteration & mask_]);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (has_pending_ || stop_requested_ || !thread_.joinable()) {
+            ++dropped_;
+            return;
+        }
+        std::swap(pending_, capture_);
+        pending_trigger_ = trigger_;
+        has_pending_ = true;
+    }
+    cv_.notify_one();
+}
+
+uint64_t iteration_flight_recorder::dumped_count() const noexcept {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return dumped_;
+}
+
+uint64_t iteration_flight_recorder::dropped_count() const noexcept {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return dropped_;
+}
+
+memory_usage iteration_flight_recorder::memory() const noexcept {
+    memory_usage usage = element_memory(ring_.size(), static_cast<std::size_t>(head_), sizeof(iteration_record));
+    usage += element_memory(capture_.capacity(), capture_.size(), sizeof(iteration_record));
+    std::lock_guard<std::mutex> lock(mutex_);
+    usage += element_memory(pending_.capacity(), pending_.size(), sizeof(iteration_record));
+    return usage;
+}
+
+// 停止时仍写完已提交的一份
+void iteration_flight_recorder::writer_loop() {
+    std::vector<iteration_record> writing;
+    for (;;) {
+        uint64_t trigger = 0;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            cv_.wait_for(lock, kWriterWakeInterval, [this]() { return has_pending_ || stop_requested_; });
+            if (!has_pending_) {
+                if (stop_requested_) {
+                    return;
+                }
+                continue;
+            }
+            std::swap(writing, pending_);
+            trigger = pending_trigger_;
+        }
+
+        const bool ok = append_window(path_, trigger, threshold_ns_, writing);
+        if (!ok) {
+            ACCT_LOG_WARN("flight_recorder", "failed to append flight recorder dump to " + path_);
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            has_pending_ = false;
+            if (ok) {
+                ++dumped_;
+            } else {
+                ++dropped_;
+            }
+        }
+    }
+}
+
+}  // namespace acct_service
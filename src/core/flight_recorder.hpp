@@ -0,0 +1,104 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "common/memory_accounting.hpp"
+#include "common/types.hpp"
+
+namespace acct_service {
+
+// 单轮事件循环的阶段，顺序与 EventLoop::poll_inputs() 一致
+enum class iteration_phase : uint8_t {
+    Upstream = 0,  // 上游订单出队、风控与路由
+    InlineStage,   // 内联阶段（进程内网关）
+    Responses,     // 成交回报处理
+    Execution,     // 执行引擎 tick
+    Archives,      // 终态订单延迟归档
+    Count,
+};
+
+inline constexpr std::size_t kIterationPhaseCount = static_cast<std::size_t>(iteration_phase::Count);
+
+const char* iteration_phase_name(iteration_phase phase) noexcept;
+
+// 单轮记录：各阶段工作量与耗时，work_ns 不含空闲等待
+struct iteration_record {
+    uint64_t iteration = 0;
+    TimestampNs start_ns = 0;  // 单调时钟
+    uint32_t orders = 0;
+    uint32_t responses = 0;
+    uint32_t inline_work = 0;
+    uint32_t sessions_ticked = 0;
+    uint32_t archives = 0;
+    uint32_t phase_ns[kIterationPhaseCount]{};
+    uint64_t work_ns = 0;
+    uint64_t idle_ns = 0;
+};
+
+// 迭代飞行记录仪：事件循环线程单写的环形缓冲，保存最近若干轮记录。
+// 某轮 work_ns 超过阈值时，再等 context 轮后把异常轮前后各 context 轮复制出来交给写线程，
+// 以文本追加到 <dir>/flight_recorder_<account>_<trading_day>.log；写线程仍忙时丢弃本次并计数。
+// 热路径只有环内定长写，不加锁不分配；只有异常轮才复制窗口并短暂持锁交换缓冲
+class iteration_flight_recorder {
+public:
+    iteration_flight_recorder() = default;
+    ~iteration_flight_recorder();
+
+    iteration_flight_recorder(const iteration_flight_recorder&) = delete;
+    iteration_flight_recorder& operator=(const iteration_flight_recorder&) = delete;
+
+    bool start(std::string path, uint64_t threshold_ns, uint32_t context_iterations);
+    void stop();
+
+    // 事件循环线程：取本轮记录槽位（已清零），填完后 commit
+    iteration_record& begin() noexcept {
+        iteration_record& record = ring_[head_ & mask_];
+        record = iteration_record{};
+        record.iteration = head_;
+        return record;
+    }
+    void commit() noexcept;
+
+    uint64_t threshold_ns() const noexcept { return threshold_ns_; }
+    uint64_t outlier_count() const noexcept { return outliers_; }
+    uint64_t dumped_count() const noexcept;
+    uint64_t dropped_count() const noexcept;
+    // 环形缓冲与两份窗口缓冲的内存占用；环按已写入轮数计在用，窗口缓冲按当前内容计在用
+    memory_usage memory() const noexcept;
+
+    static std::string path_for(const std::string& dir, AccountId account_id, const std::string& trading_day);
+
+private:
+    void capture_window();
+    void writer_loop();
+
+    std::vector<iteration_record> ring_;
+    uint64_t mask_ = 0;
+    uint64_t head_ = 0;  // 下一轮写入的序号
+    uint64_t threshold_ns_ = 0;
+    uint32_t context_ = 0;
+    uint64_t trigger_ = 0;           // 待转储窗口的异常轮序号
+    uint32_t post_remaining_ = 0;    // 异常轮之后还需收集的轮数
+    bool window_pending_ = false;
+    uint64_t outliers_ = 0;
+    std::vector<iteration_record> capture_;  // 事件循环侧窗口缓冲，与写线程交换复用容量
+
+    std::string path_;
+    std::vector<iteration_record> pending_;
+    uint64_t pending_trigger_ = 0;
+    bool has_pending_ = false;
+    bool stop_requested_ = false;
+    uint64_t dumped_ = 0;
+    uint64_t dropped_ = 0;
+    mutable std::mutex mutex_;
+    std::condition_variable cv_;
+    std::thread thread_;
+};
+
+}  // namespace acct_service
@@ -0,0 +1,225 @@
+#include "core/orders_rollover.hpp"
+
+#include <chrono>
+#include <utility>
+
+#include "common/error.hpp"
+#include "common/log.hpp"
+#include "core/event_loop.hpp"
+#include "shm/orders_shm.hpp"
+
+namespace acct_service {
+
+namespace {
+
+constexpr std::chrono::milliseconds kWorkerWakeInterval{100};
+constexpr std::chrono::milliseconds kRolloverPollInterval{1};
+
+bool report_rollover_error(ErrorCode code, std::string_view message) {
+    ErrorStatus status = ACCT_MAKE_ERROR(ErrorDomain::core, code, "orders_day_roller", message, 0);
+    record_error(status);
+    ACCT_LOG_ERROR_STATUS(status);
+    return false;
+}
+
+}  // namespace
+
+orders_day_roller::~orders_day_roller() {
+    stop();
+    close();
+}
+
+bool orders_day_roller::start(std::string base_name, std::string trading_day, std::size_t capacity,
+                              AccountId account_id, const shm::ShmMapOptions& map_options, EventLoop& loop) {
+    stop();
+    if (!is_valid_trading_day(trading_day)) {
+        return report_rollover_error(ErrorCode::InvalidParam, "current trading day must be YYYYMMDD");
+    }
+    base_name_ = std::move(base_name);
+    capacity_ = capacity;
+    account_id_ = account_id;
+    // 预建段在换日前完成缺页，切换后首批订单不再缺页
+    map_options_ = map_options;
+    map_options_.prefault = true;
+    loop_ = &loop;
+    // 换日只在本线程发起，启动时读取事件循环当前池无竞争
+    current_orders_ = loop.orders_shm();
+    upstream_ = loop.upstream_shm();
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        current_day_ = std::move(trading_day);
+        prepare_day_.clear();
+        rollover_day_.clear();
+        stop_requested_ = false;
+    }
+    thread_ = std::thread([this]() { worker_loop(); });
+    return true;
+}
+
+void orders_day_roller::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_requested_ = true;
+    }
+    cv_.notify_all();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+void orders_day_roller::close() noexcept {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (day_segment& segment : segments_) {
+        segment.manager->close();
+    }
+    segments_.clear();
+}
+
+bool orders_day_roller::prepare(std::string_view trading_day) {
+    if (!is_valid_trading_day(trading_day)) {
+        return report_rollover_error(ErrorCode::InvalidParam, "prepared trading day must be YYYYMMDD");
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!thread_.joinable() || trading_day_number(trading_day) <= trading_day_number(current_day_)) {
+            return false;
+        }
+        prepare_day_.assign(trading_day);
+    }
+    cv_.notify_one();
+    return true;
+}
+
+bool orders_day_roller::request_rollover(std::string_view trading_day) {
+    if (!is_valid_trading_day(trading_day)) {
+        return report_rollover_error(ErrorCode::InvalidParam, "rollover trading day must be YYYYMMDD");
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!thread_.joinable()) {
+            return false;
+        }
+        if (trading_day_number(trading_day) <= trading_day_number(current_day_)) {
+            return report_rollover_error(ErrorCode::InvalidParam, "rollover trading day must be after current day");
+        }
+        rollover_day_.assign(trading_day);
+    }
+    cv_.notify_one();
+    return true;
+}
+
+std::string orders_day_roller::trading_day() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return current_day_;
+}
+
+bool orders_day_roller::prepared(std::string_view trading_day) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const day_segment& segment : segments_) {
+        if (segment.trading_day == trading_day) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void orders_day_roller::extend_overflow() {
+    if (overflow_segments_ == 0 || !current_orders_) {
+        return;
+    }
+    if (extend_orders_overflow(current_orders_, overflow_segments_, map_options_, upstream_) != 0) {
+        overflow_extends_.fetch_add(1, std::memory_order_release);
+    }
+}
+
+bool orders_day_roller::stop_requested() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stop_requested_;
+}
+
+void orders_day_roller::worker_loop() {
+    for (;;) {
+        std::string prepare_day;
+        std::string rollover_day;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            cv_.wait_for(lock, kWorkerWakeInterval,
+                         [this]() { return stop_requested_ || !prepare_day_.empty() || !rollover_day_.empty(); });
+            if (stop_requested_) {
+                return;
+            }
+            prepare_day.swap(prepare_day_);
+            rollover_day.swap(rollover_day_);
+        }
+
+        if (!prepare_day.empty() && !open_day(prepare_day)) {
+            failed_.fetch_add(1, std::memory_order_release);
+        }
+        if (!rollover_day.empty()) {
+            apply_rollover(rollover_day);
+        }
+        extend_overflow();
+    }
+}
+
+orders_shm_layout* orders_day_roller::open_day(const std::string& trading_day) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const day_segment& segment : segments_) {
+            if (segment.trading_day == trading_day) {
+                return segment.layout;
+            }
+        }
+    }
+
+    // 建段与预取在锁外进行，可能耗时数百毫秒
+    auto manager = std::make_unique<SHMManager>();
+    manager->set_map_options(map_options_);
+    orders_shm_layout* layout = manager->open_orders(make_orders_shm_name(base_name_, trading_day),
+                                                     shm_mode::OpenOrCreate, account_id_, capacity_);
+    if (!layout) {
+        report_rollover_error(ErrorCode::ShmOpenFailed, "failed to prepare orders shm for trading day " + trading_day);
+        return nullptr;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        segments_.push_back(day_segment{trading_day, std::move(manager), layout});
+    }
+    ACCT_LOG_INFO("orders_day_roller", "prepared orders shm for trading day " + trading_day);
+    return layout;
+}
+
+void orders_day_roller::apply_rollover(const std::string& trading_day) {
+    orders_shm_layout* next = open_day(trading_day);
+    if (!next) {
+        failed_.fetch_add(1, std::memory_order_release);
+        return;
+    }
+
+    // 上一次切换仍在等待静默时排队重试，停转时放弃
+    // 等待期间旧池仍在接单，溢出链照常扩展
+    while (!loop_->request_orders_rollover(next)) {
+        if (stop_requested()) {
+            return;
+        }
+        extend_overflow();
+        std::this_thread::sleep_for(kRolloverPollInterval);
+    }
+    ACCT_LOG_INFO("orders_day_roller", "waiting for event loop quiescence to roll over to " + trading_day);
+    while (loop_->orders_rollover_pending()) {
+        if (stop_requested()) {
+            return;
+        }
+        extend_overflow();
+        std::this_thread::sleep_for(kRolloverPollInterval);
+    }
+    current_orders_ = next;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        current_day_ = trading_day;
+    }
+    rollovers_.fetch_add(1, std::memory_order_release);
+    ACCT_LOG_INFO("orders_day_roller", "rolled over orders shm to trading day " + trading_day);
+}
+
+}  // namespace acct_service
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "common/types.hpp"
+#include "shm/shm_manager.hpp"
+
+namespace acct_service {
+
+class EventLoop;
+
+// 订单池换日线程：后台预建并预取后续交易日的订单池，收到换日请求时交给 EventLoop 在静默时一次性切换。
+// 同一线程每次唤醒检查当前订单池的溢出链，链尾段用量过 80% 时预建下一溢出段（见 extend_orders_overflow）。
+// 建段、预取与等待静默都不占用事件循环线程；交易日只能向后切换。
+// 切出的旧池映射保留到 close()，供迟到的网关回读与监控使用
+class orders_day_roller {
+public:
+    orders_day_roller() = default;
+    ~orders_day_roller();
+
+    orders_day_roller(const orders_day_roller&) = delete;
+    orders_day_roller& operator=(const orders_day_roller&) = delete;
+
+    // 当前订单池可链上的溢出段数，0 关闭；须在 start 之前设置
+    void set_overflow_segments(uint32_t segments) noexcept { overflow_segments_ = segments; }
+
+    // 启动后台线程；trading_day 为事件循环当前所用订单池的交易日（该段由调用方持有）
+    bool start(std::string base_name, std::string trading_day, std::size_t capacity, AccountId account_id,
+               const shm::ShmMapOptions& map_options, EventLoop& loop);
+    void stop();
+
+    // 解除本实例建立的全部映射；须在事件循环与同进程网关停止之后调用
+    void close() noexcept;
+
+    // 异步预建交易日订单池（OpenOrCreate + 预取），已建过时为空操作
+    bool prepare(std::string_view trading_day);
+
+    // 异步换日：未预建时先建段，再等待事件循环静默后切换；交易日须晚于当前交易日
+    bool request_rollover(std::string_view trading_day);
+
+    std::string trading_day() const;
+    bool prepared(std::string_view trading_day) const;
+    uint64_t rollover_count() const noexcept { return rollovers_.load(std::memory_order_acquire); }
+    uint64_t failed_count() const noexcept { return failed_.load(std::memory_order_acquire); }
+    uint64_t overflow_extend_count() const noexcept { return overflow_extends_.load(std::memory_order_acquire); }
+
+private:
+    struct day_segment {
+        std::string trading_day;
+        std::unique_ptr<SHMManager> manager;
+        orders_shm_layout* layout = nullptr;
+    };
+
+    void worker_loop();
+    // 查找或建立交易日订单池（仅后台线程）
+    orders_shm_layout* open_day(const std::string& trading_day);
+    // 交给事件循环并等待切换完成（仅后台线程）
+    void apply_rollover(const std::string& trading_day);
+    // 按水位为当前订单池链上下一溢出段（仅后台线程）
+    void extend_overflow();
+    bool stop_requested() const;
+
+    std::string base_name_;
+    std::size_t capacity_ = 0;
+    AccountId account_id_ = 0;
+    shm::ShmMapOptions map_options_;
+    EventLoop* loop_ = nullptr;
+    uint32_t overflow_segments_ = 0;
+    orders_shm_layout* current_orders_ = nullptr;  // 事件循环当前所用订单池（仅后台线程在启动后改写）
+    upstream_shm_layout* upstream_ = nullptr;      // 溢出段纪元的取号来源
+
+    std::string current_day_;
+    std::vector<day_segment> segments_;
+    std::string prepare_day_;   // 待预建的交易日，空表示无
+    std::string rollover_day_;  // 待切换的交易日，空表示无
+    bool stop_requested_ = false;
+    std::atomic<uint64_t> rollovers_{0};
+    std::atomic<uint64_t> failed_{0};
+    std::atomic<uint64_t> overflow_extends_{0};
+    mutable std::mutex mutex_;
+    std::condition_variable cv_;
+    std::thread thread_;
+};
+
+}  // namespace acct_service
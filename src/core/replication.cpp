@@ -0,0 +1,416 @@
+#include "core/replication.hpp"
+
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+
+#include "common/error.hpp"
+#include "common/log.hpp"
+#include "common/thread_setup.hpp"
+
+namespace acct_service {
+
+namespace {
+
+constexpr std::chrono::milliseconds kReconnectBackoff{100};
+constexpr std::chrono::microseconds kIdleSleep{50};
+constexpr int kAcceptPollMs = 100;
+constexpr int kSocketTimeoutMs = 100;
+
+bool report_replication_error(std::string_view message, int sys_errno = 0) {
+    ErrorStatus status =
+        ACCT_MAKE_ERROR(ErrorDomain::core, ErrorCode::ComponentUnavailable, "replication", message, sys_errno);
+    record_error(status);
+    ACCT_LOG_ERROR_STATUS(status);
+    return false;
+}
+
+void close_fd(int& fd) noexcept {
+    if (fd >= 0) {
+        ::close(fd);
+        fd = -1;
+    }
+}
+
+// 收发超时让阻塞调用定期返回，线程据此检查停止请求
+void set_socket_timeouts(int fd) noexcept {
+    timeval tv{};
+    tv.tv_sec = kSocketTimeoutMs / 1000;
+    tv.tv_usec = (kSocketTimeoutMs % 1000) * 1000;
+    (void)::setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    (void)::setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+    const int one = 1;
+    (void)::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+}
+
+// 写完全部 iovec；超时只重试，对端断开或出错返回 false
+bool send_fully(int fd, iovec* iov, int count, const std::atomic<bool>& stop_requested) {
+    while (count > 0) {
+        msghdr msg{};
+        msg.msg_iov = iov;
+        msg.msg_iovlen = static_cast<std::size_t>(count);
+        const ssize_t written = ::sendmsg(fd, &msg, MSG_NOSIGNAL);
+        if (written < 0) {
+            if ((errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) &&
+                !stop_requested.load(std::memory_order_relaxed)) {
+                continue;
+            }
+            return false;
+        }
+        std::size_t remaining = static_cast<std::size_t>(written);
+        while (count > 0 && remaining >= iov->iov_len) {
+            remaining -= iov->iov_len;
+            ++iov;
+            --count;
+        }
+        if (count > 0) {
+            iov->iov_base = static_cast<unsigned char*>(iov->iov_base) + remaining;
+            iov->iov_len -= remaining;
+        }
+    }
+    return true;
+}
+
+}  // namespace
+
+replication_sender::~replication_sender() { stop(); }
+
+bool replication_sender::start(const ReplicationConfig& config, AccountId account_id, uint32_t id_epoch,
+                               uint32_t trading_day) {
+    stop();
+    if (config.peer_host.empty() || config.port == 0 || config.batch_records == 0 ||
+        config.batch_records > kMaxReplicationFrameRecords) {
+        return report_replication_error("invalid replication sender config");
+    }
+    config_ = config;
+    account_id_ = account_id;
+    id_epoch_ = id_epoch;
+    trading_day_ = trading_day;
+    if (!ring_) {
+        ring_ = std::make_unique<replication_ring>();
+    }
+    ring_->init();
+    batch_.resize(config_.batch_records);
+    next_seq_ = 1;
+    stop_requested_.store(false, std::memory_order_release);
+    thread_ = std::thread([this]() { sender_loop(); });
+    return true;
+}
+
+void replication_sender::stop() {
+    stop_requested_.store(true, std::memory_order_release);
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+    disconnect();
+}
+
+replication_record* replication_sender::claim(replication_record_kind kind) noexcept {
+    const uint64_t seq = next_seq_++;
+    replication_record* record = nullptr;
+    if (!ring_ || ring_->try_claim(0, 1, record) == 0) {
+        // 序号照常占用，备机据缺口判定失步
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+    }
+    record->seq = seq;
+    record->kind = kind;
+    return record;
+}
+
+void replication_sender::commit() noexcept {
+    ring_->commit(1);
+    published_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void replication_sender::publish_order(OrderIndex index, const OrderRequest& request, StrategyId strategy_id,
+                                       OrderIndex next_index_hint) noexcept {
+    replication_record* record = claim(replication_record_kind::Order);
+    if (!record) {
+        return;
+    }
+    record->index = index;
+    record->next_index_hint = next_index_hint;
+    record->strategy_id = strategy_id;
+    record->basket_size = 0;
+    record->basket_position = 0;
+    std::memcpy(record->payload, &request, sizeof(OrderRequest));
+    commit();
+}
+
+void replication_sender::publish_basket_leg(OrderIndex index, const OrderRequest& request, StrategyId strategy_id,
+                                            OrderIndex next_index_hint, uint16_t basket_size,
+                                            uint16_t basket_position) noexcept {
+    replication_record* record = claim(replication_record_kind::BasketLeg);
+    if (!record) {
+        return;
+    }
+    record->index = index;
+    record->next_index_hint = next_index_hint;
+    record->strategy_id = strategy_id;
+    record->basket_size = basket_size;
+    record->basket_position = basket_position;
+    std::memcpy(record->payload, &request, sizeof(OrderRequest));
+    commit();
+}
+
+void replication_sender::publish_response(const TradeResponse& response) noexcept {
+    replication_record* record = claim(replication_record_kind::Response);
+    if (!record) {
+        return;
+    }
+    record->index = kInvalidOrderIndex;
+    record->next_index_hint = 0;
+    record->strategy_id = 0;
+    record->basket_size = 0;
+    record->basket_position = 0;
+    std::memcpy(record->payload, &response, sizeof(TradeResponse));
+    commit();
+}
+
+void replication_sender::sender_loop() {
+    (void)apply_thread_realtime("replication_sender", thread_realtime_config{config_.cpu_core, 0});
+    while (!stop_requested_.load(std::memory_order_acquire)) {
+        if (fd_ < 0 && !connect_peer()) {
+            // 未连接期间积压的记录直接丢弃，避免重连后把过时的大批记录一次压给备机
+            const std::size_t discarded = ring_->try_pop_bulk(batch_.data(), batch_.size());
+            dropped_.fetch_add(discarded, std::memory_order_relaxed);
+            if (discarded == 0) {
+                std::this_thread::sleep_for(kReconnectBackoff);
+            }
+            continue;
+        }
+
+        const std::size_t popped = ring_->try_pop_bulk(batch_.data(), batch_.size());
+        if (popped == 0) {
+            // 绑核时自旋让出，否则短暂休眠
+            if (config_.cpu_core >= 0) {
+                std::this_thread::yield();
+            } else {
+                std::this_thread::sleep_for(kIdleSleep);
+            }
+            continue;
+        }
+        if (!send_frame(replication_frame_type::Records, static_cast<uint32_t>(popped), batch_[0].seq)) {
+            dropped_.fetch_add(popped, std::memory_order_relaxed);
+            ACCT_LOG_WARN("replication", "standby connection lost, reconnecting");
+            disconnect();
+            continue;
+        }
+        sent_.fetch_add(popped, std::memory_order_relaxed);
+    }
+}
+
+bool replication_sender::connect_peer() {
+    addrinfo hints{};
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo* result = nullptr;
+    const std::string port = std::to_string(config_.port);
+    if (::getaddrinfo(config_.peer_host.c_str(), port.c_str(), &hints, &result) != 0 || !result) {
+        return false;
+    }
+    fd_ = ::socket(result->ai_family, result->ai_socktype, result->ai_protocol);
+    if (fd_ >= 0) {
+        // 发送超时同样约束 connect，对端不可达时不会卡住停止
+        set_socket_timeouts(fd_);
+    }
+    const bool ok = fd_ >= 0 && ::connect(fd_, result->ai_addr, result->ai_addrlen) == 0;
+    ::freeaddrinfo(result);
+    if (!ok) {
+        close_fd(fd_);
+        return false;
+    }
+    if (!send_frame(replication_frame_type::Hello, 0, 0)) {
+        close_fd(fd_);
+        return false;
+    }
+    connected_.store(true, std::memory_order_release);
+    reconnects_.fetch_add(1, std::memory_order_relaxed);
+    ACCT_LOG_INFO("replication", "connected to standby " + config_.peer_host + ":" + port);
+    return true;
+}
+
+void replication_sender::disconnect() noexcept {
+    connected_.store(false, std::memory_order_release);
+    close_fd(fd_);
+}
+
+bool replication_sender::send_frame(replication_frame_type type, uint32_t record_count, uint64_t first_seq) {
+    replication_frame_header header;
+    header.type = static_cast<uint16_t>(type);
+    header.account_id = account_id_;
+    header.record_count = record_count;
+    header.first_seq = first_seq;
+    header.id_epoch = id_epoch_;
+    header.trading_day = trading_day_;
+    iovec iov[2];
+    iov[0].iov_base = &header;
+    iov[0].iov_len = sizeof(header);
+    iov[1].iov_base = batch_.data();
+    iov[1].iov_len = record_count * sizeof(replication_record);
+    return send_fully(fd_, iov, record_count == 0 ? 1 : 2, stop_requested_);
+}
+
+replication_receiver::~replication_receiver() { stop(); }
+
+bool replication_receiver::start(const ReplicationConfig& config, AccountId account_id, uint32_t trading_day) {
+    stop();
+    config_ = config;
+    account_id_ = account_id;
+    trading_day_ = trading_day;
+    if (!inbox_) {
+        inbox_ = std::make_unique<replication_ring>();
+    }
+    inbox_->init();
+    frame_.resize(kMaxReplicationFrameRecords);
+    expected_seq_ = 1;
+    out_of_sync_.store(false, std::memory_order_relaxed);
+
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(static_cast<uint16_t>(config_.port));
+    if (::inet_pton(AF_INET, config_.bind_address.c_str(), &addr.sin_addr) != 1) {
+        return report_replication_error("invalid replication bind_address");
+    }
+    listen_fd_ = ::socket(AF_INET, SOCK_STREAM, 0);
+    if (listen_fd_ < 0) {
+        return report_replication_error("failed to create replication socket", errno);
+    }
+    const int one = 1;
+    (void)::setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    if (::bind(listen_fd_, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) != 0 ||
+        ::listen(listen_fd_, 1) != 0) {
+        const int bind_errno = errno;
+        close_fd(listen_fd_);
+        return report_replication_error("failed to listen on replication port", bind_errno);
+    }
+    stop_requested_.store(false, std::memory_order_release);
+    thread_ = std::thread([this]() { receiver_loop(); });
+    return true;
+}
+
+void replication_receiver::stop() {
+    stop_requested_.store(true, std::memory_order_release);
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+    close_fd(listen_fd_);
+    connected_.store(false, std::memory_order_release);
+}
+
+std::size_t replication_receiver::try_pop_bulk(replication_record* out, std::size_t max_count) noexcept {
+    return inbox_ ? inbox_->try_pop_bulk(out, max_count) : 0;
+}
+
+void replication_receiver::receiver_loop() {
+    (void)apply_thread_realtime("replication_receiver", thread_realtime_config{config_.cpu_core, 0});
+    while (!stop_requested_.load(std::memory_order_acquire)) {
+        pollfd pfd{listen_fd_, POLLIN, 0};
+        if (::poll(&pfd, 1, kAcceptPollMs) <= 0 || (pfd.revents & POLLIN) == 0) {
+            continue;
+        }
+        int fd = ::accept(listen_fd_, nullptr, nullptr);
+        if (fd < 0) {
+            continue;
+        }
+        set_socket_timeouts(fd);
+        serve_connection(fd);
+        connected_.store(false, std::memory_order_release);
+        close_fd(fd);
+    }
+}
+
+void replication_receiver::serve_connection(int fd) {
+    replication_frame_header header;
+    if (!recv_exact(fd, &header, sizeof(header)) || header.magic != replication_frame_header::kMagic ||
+        header.version != replication_frame_header::kVersion ||
+        header.type != static_cast<uint16_t>(replication_frame_type::Hello)) {
+        ACCT_LOG_WARN("replication", "rejected replication peer: bad hello frame");
+        return;
+    }
+    if (header.account_id != account_id_ || (trading_day_ != 0 && header.trading_day != trading_day_)) {
+        ACCT_LOG_ERROR("replication", "rejected replication peer: account or trading day mismatch");
+        return;
+    }
+    primary_id_epoch_.store(header.id_epoch, std::memory_order_release);
+    connected_.store(true, std::memory_order_release);
+    ACCT_LOG_INFO("replication", "primary connected");
+
+    while (!stop_requested_.load(std::memory_order_acquire)) {
+        if (!recv_exact(fd, &header, sizeof(header))) {
+            ACCT_LOG_WARN("replication", "primary connection closed");
+            return;
+        }
+        if (header.magic != replication_frame_header::kMagic ||
+            header.type != static_cast<uint16_t>(replication_frame_type::Records) ||
+            header.record_count == 0 || header.record_count > kMaxReplicationFrameRecords) {
+            ACCT_LOG_ERROR("replication", "malformed replication frame, dropping connection");
+            return;
+        }
+        if (!recv_exact(fd, frame_.data(), header.record_count * sizeof(replication_record))) {
+            ACCT_LOG_WARN("replication", "primary connection closed mid-frame");
+            return;
+        }
+        if (!deliver(frame_.data(), header.record_count)) {
+            return;
+        }
+    }
+}
+
+bool replication_receiver::recv_exact(int fd, void* data, std::size_t size) {
+    auto* bytes = static_cast<unsigned char*>(data);
+    std::size_t received = 0;
+    while (received < size) {
+        const ssize_t n = ::recv(fd, bytes + received, size - received, 0);
+        if (n > 0) {
+            received += static_cast<std::size_t>(n);
+            continue;
+        }
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) &&
+            !stop_requested_.load(std::memory_order_acquire)) {
+            continue;
+        }
+        return false;
+    }
+    return true;
+}
+
+bool replication_receiver::deliver(const replication_record* records, std::size_t count) {
+    for (std::size_t i = 0; i < count; ++i) {
+        if (records[i].seq != expected_seq_) {
+            gaps_.fetch_add(1, std::memory_order_relaxed);
+            if (!out_of_sync_.exchange(true, std::memory_order_acq_rel)) {
+                ACCT_LOG_ERROR("replication", "replication sequence gap: expected " + std::to_string(expected_seq_) +
+                                                  " got " + std::to_string(records[i].seq) +
+                                                  ", standby is out of sync");
+            }
+        }
+        expected_seq_ = records[i].seq + 1;
+    }
+
+    // 收件环满时等待事件循环取走，TCP 接收窗口随之收紧反压主机
+    std::size_t pushed = 0;
+    while (pushed < count) {
+        pushed += inbox_->try_push_bulk(records + pushed, count - pushed);
+        if (pushed < count) {
+            if (stop_requested_.load(std::memory_order_acquire)) {
+                return false;
+            }
+            std::this_thread::sleep_for(kIdleSleep);
+        }
+    }
+    received_.fetch_add(count, std::memory_order_relaxed);
+    return true;
+}
+
+}  // namespace acct_service
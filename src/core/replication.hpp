@@ -0,0 +1,180 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "common/types.hpp"
+#include "core/config_manager.hpp"
+#include "order/order_request.hpp"
+#include "shm/shm_layout.hpp"
+#include "shm/spsc_queue.hpp"
+
+namespace acct_service {
+
+// 热备复制：主机事件循环在处理函数入口按处理顺序记下上游订单（出队时的槽位内容）与成交回报，
+// 发送线程按批打包成带序号的 TCP 帧发往备机；备机接收线程校验序号后交给备机事件循环，
+// 由同一组处理函数以影子模式重放（不向柜台发单），主机失效时提升即可接管，无需冷启动恢复。
+
+enum class replication_record_kind : uint8_t {
+    Order = 1,      // 单笔订单（含撤单、改单、批量撤单与推迟的优先撤单）
+    BasketLeg = 2,  // 篮子的一条腿，同一篮子各腿连续出现
+    Response = 3,   // 成交回报
+};
+
+inline constexpr std::size_t kReplicationPayloadSize = 256;
+
+static_assert(sizeof(OrderRequest) <= kReplicationPayloadSize, "OrderRequest must fit replication payload");
+static_assert(sizeof(TradeResponse) <= kReplicationPayloadSize, "TradeResponse must fit replication payload");
+
+// 定长记录：64 字节头 + 256 字节载荷（OrderRequest 或 TradeResponse 的原始字节）。
+// seq 从 1 起连续，主机环满丢弃的记录也占用序号，备机据此发现缺口
+struct alignas(64) replication_record {
+    uint64_t seq = 0;
+    OrderIndex index = kInvalidOrderIndex;  // 订单槽位下标（回报为 kInvalidOrderIndex）
+    OrderIndex next_index_hint = 0;         // 主机处理前主段的 next_index，备机据此对齐内部分配下标
+    StrategyId strategy_id = 0;
+    replication_record_kind kind = replication_record_kind::Order;
+    uint8_t reserved0 = 0;
+    uint16_t basket_size = 0;      // 篮子腿数（仅 BasketLeg）
+    uint16_t basket_position = 0;  // 本腿在篮子中的位置（仅 BasketLeg）
+    uint8_t reserved[40] = {};
+    alignas(64) unsigned char payload[kReplicationPayloadSize] = {};
+};
+
+static_assert(sizeof(replication_record) == 320, "replication_record must be 320 bytes");
+static_assert(std::is_trivially_copyable_v<replication_record>, "replication_record must be trivially copyable");
+
+enum class replication_frame_type : uint16_t {
+    Hello = 1,    // 每次建连后首帧：账户、交易日与主机订单号纪元
+    Records = 2,  // 紧随帧头 record_count 条 replication_record
+};
+
+struct replication_frame_header {
+    static constexpr uint32_t kMagic = 0x464C5052;  // "RPLF"
+    static constexpr uint16_t kVersion = 1;
+
+    uint32_t magic = kMagic;
+    uint16_t version = kVersion;
+    uint16_t type = 0;  // replication_frame_type
+    AccountId account_id = 0;
+    uint32_t record_count = 0;
+    uint64_t first_seq = 0;
+    uint32_t id_epoch = 0;     // Hello：主机订单池纪元
+    uint32_t trading_day = 0;  // Hello：YYYYMMDD 数值
+};
+
+static_assert(sizeof(replication_frame_header) == 32, "replication_frame_header must be 32 bytes");
+
+// 单帧记录数上限，与 replication.batch_records 校验上限一致
+inline constexpr uint32_t kMaxReplicationFrameRecords = 1024;
+// 主机待发环与备机收件环的容量（条）
+inline constexpr std::size_t kReplicationRingCapacity = 16384;
+
+using replication_ring = spsc_queue<replication_record, kReplicationRingCapacity>;
+
+// 主机发送端：publish_* 只在事件循环线程调用，写入环后立即返回；连接、打包与发送都在发送线程。
+// 环满或未连接时记录被丢弃并计数，备机随后会因序号缺口进入失步状态
+class replication_sender {
+public:
+    replication_sender() = default;
+    ~replication_sender();
+
+    replication_sender(const replication_sender&) = delete;
+    replication_sender& operator=(const replication_sender&) = delete;
+
+    bool start(const ReplicationConfig& config, AccountId account_id, uint32_t id_epoch, uint32_t trading_day);
+    void stop();
+
+    void publish_order(OrderIndex index, const OrderRequest& request, StrategyId strategy_id,
+                       OrderIndex next_index_hint) noexcept;
+    void publish_basket_leg(OrderIndex index, const OrderRequest& request, StrategyId strategy_id,
+                            OrderIndex next_index_hint, uint16_t basket_size, uint16_t basket_position) noexcept;
+    void publish_response(const TradeResponse& response) noexcept;
+
+    bool connected() const noexcept { return connected_.load(std::memory_order_acquire); }
+    uint64_t published_count() const noexcept { return published_.load(std::memory_order_relaxed); }
+    uint64_t sent_count() const noexcept { return sent_.load(std::memory_order_relaxed); }
+    uint64_t dropped_count() const noexcept { return dropped_.load(std::memory_order_relaxed); }
+    uint64_t reconnect_count() const noexcept { return reconnects_.load(std::memory_order_relaxed); }
+
+private:
+    // 申请一条环槽位并填好公共头字段；环满时计入丢弃，返回 nullptr
+    replication_record* claim(replication_record_kind kind) noexcept;
+    void commit() noexcept;
+
+    void sender_loop();
+    bool connect_peer();
+    void disconnect() noexcept;
+    bool send_frame(replication_frame_type type, uint32_t record_count, uint64_t first_seq);
+
+    ReplicationConfig config_;
+    AccountId account_id_ = 0;
+    uint32_t id_epoch_ = 0;
+    uint32_t trading_day_ = 0;
+    std::unique_ptr<replication_ring> ring_;
+    std::vector<replication_record> batch_;  // 发送线程本帧记录（复用容量）
+    uint64_t next_seq_ = 1;                  // 仅事件循环线程
+    int fd_ = -1;
+    std::atomic<bool> stop_requested_{false};
+    std::atomic<bool> connected_{false};
+    std::atomic<uint64_t> published_{0};
+    std::atomic<uint64_t> sent_{0};
+    std::atomic<uint64_t> dropped_{0};
+    std::atomic<uint64_t> reconnects_{0};
+    std::thread thread_;
+};
+
+// 备机接收端：接收线程监听并校验帧，按序号写入收件环；try_pop_bulk 只在备机事件循环线程调用。
+// 收件环满时接收线程等待（TCP 随之反压主机），序号不连续时置 out_of_sync 并继续重放，需冷启动重新同步
+class replication_receiver {
+public:
+    replication_receiver() = default;
+    ~replication_receiver();
+
+    replication_receiver(const replication_receiver&) = delete;
+    replication_receiver& operator=(const replication_receiver&) = delete;
+
+    bool start(const ReplicationConfig& config, AccountId account_id, uint32_t trading_day);
+    // 停止接收；已进入收件环的记录仍可取出，提升前先 stop 再由事件循环排空
+    void stop();
+
+    std::size_t try_pop_bulk(replication_record* out, std::size_t max_count) noexcept;
+    bool has_pending() const noexcept { return inbox_ && !inbox_->empty(); }
+
+    // 最近一次 Hello 携带的主机订单号纪元，0 表示尚未收到
+    uint32_t primary_id_epoch() const noexcept { return primary_id_epoch_.load(std::memory_order_acquire); }
+    bool connected() const noexcept { return connected_.load(std::memory_order_acquire); }
+    bool out_of_sync() const noexcept { return out_of_sync_.load(std::memory_order_acquire); }
+    uint64_t received_count() const noexcept { return received_.load(std::memory_order_relaxed); }
+    uint64_t gap_count() const noexcept { return gaps_.load(std::memory_order_relaxed); }
+
+private:
+    void receiver_loop();
+    // 处理一条连接直到断开或停止
+    void serve_connection(int fd);
+    bool recv_exact(int fd, void* data, std::size_t size);
+    bool deliver(const replication_record* records, std::size_t count);
+
+    ReplicationConfig config_;
+    AccountId account_id_ = 0;
+    uint32_t trading_day_ = 0;
+    std::unique_ptr<replication_ring> inbox_;
+    std::vector<replication_record> frame_;  // 接收线程本帧记录（复用容量）
+    uint64_t expected_seq_ = 1;              // 仅接收线程
+    int listen_fd_ = -1;
+    std::atomic<bool> stop_requested_{false};
+    std::atomic<bool> connected_{false};
+    std::atomic<bool> out_of_sync_{false};
+    std::atomic<uint32_t> primary_id_epoch_{0};
+    std::atomic<uint64_t> received_{0};
+    std::atomic<uint64_t> gaps_{0};
+    std::thread thread_;
+};
+
+}  // namespace acct_service
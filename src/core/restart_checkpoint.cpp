@@ -0,0 +1,357 @@
+#include "core/restart_checkpoint.hpp"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <type_traits>
+#include <utility>
+
+#include "common/error.hpp"
+#include "common/log.hpp"
+
+namespace acct_service {
+
+namespace {
+
+constexpr std::chrono::milliseconds kWriterWakeInterval{100};
+
+// 文件头之后依次为 order_count 条订单、session_count 条会话、child_count 条子单账本，均为定长记录。
+struct restart_checkpoint_header {
+    static constexpr uint32_t kMagic = 0x54504B43;  // "CKPT"
+    static constexpr uint32_t kVersion = 1;
+
+    uint32_t magic = kMagic;
+    uint32_t version = kVersion;
+    uint32_t order_record_size = 0;
+    uint32_t session_record_size = 0;
+    uint32_t child_record_size = 0;
+    AccountId account_id = 0;
+    uint32_t order_count = 0;
+    uint32_t session_count = 0;
+    uint32_t child_count = 0;
+    OrderIndex next_index = 0;
+    TimestampNs created_ns = 0;
+    uint64_t journal_cursor = 0;
+    char trading_day[16] = {};
+};
+
+// OrderRequest 可平凡拷贝，直接按值存放（布局与原先的字节数组一致）。
+struct checkpoint_order_record {
+    OrderRequest request;
+    TimestampNs submit_time_ns;
+    TimestampNs last_update_ns;
+    DValue fund_frozen;
+    InternalOrderId parent_order_id;
+    OrderIndex shm_order_index;
+    StrategyId strategy_id;
+    RiskResult risk_result;
+    uint8_t retry_count;
+    uint8_t is_split_child;
+};
+
+static_assert(std::is_trivially_copyable_v<restart_checkpoint_header>, "checkpoint header must be trivially copyable");
+static_assert(std::is_trivially_copyable_v<checkpoint_order_record>, "checkpoint order must be trivially copyable");
+static_assert(std::is_trivially_copyable_v<execution_session_checkpoint>, "session checkpoint must be trivially copyable");
+static_assert(std::is_trivially_copyable_v<execution_child_checkpoint>, "child checkpoint must be trivially copyable");
+
+bool report_checkpoint_error(std::string_view message, int sys_errno = 0) {
+    ErrorStatus status =
+        ACCT_MAKE_ERROR(ErrorDomain::core, ErrorCode::InvalidParam, "restart_checkpoint", message, sys_errno);
+    record_error(status);
+    ACCT_LOG_ERROR_STATUS(status);
+    return false;
+}
+
+template <typename T>
+void append_records(std::vector<char>& buffer, const T* records, std::size_t count) {
+    const std::size_t bytes = sizeof(T) * count;
+    const std::size_t offset = buffer.size();
+    buffer.resize(offset + bytes);
+    if (bytes != 0) {
+        std::memcpy(buffer.data() + offset, records, bytes);
+    }
+}
+
+template <typename T>
+bool read_records(const std::vector<char>& buffer, std::size_t& offset, std::vector<T>& out, std::size_t count) {
+    const std::size_t bytes = sizeof(T) * count;
+    if (buffer.size() - offset < bytes) {
+        return false;
+    }
+    out.resize(count);
+    if (bytes != 0) {
+        std::memcpy(out.data(), buffer.data() + offset, bytes);
+    }
+    offset += bytes;
+    return true;
+}
+
+bool write_all(int fd, const char* data, std::size_t size) {
+    while (size > 0) {
+        const ssize_t written = ::write(fd, data, size);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        data += written;
+        size -= static_cast<std::size_t>(written);
+    }
+    return true;
+}
+
+}  // namespace
+
+std::string restart_checkpoint_path(const std::string& dir, AccountId account_id, const std::string& trading_day) {
+    return dir + "/restart_checkpoint_" + std::to_string(account_id) + "_" + trading_day + ".bin";
+}
+
+void capture_restart_checkpoint(const OrderBook& book, const orders_shm_layout* orders_shm,
+                                const ExecutionEngine* execution_engine, restart_checkpoint& out) {
+    out.created_ns = now_ns();
+    out.orders.journal_cursor = orders_shm ? orders_shm->journal.write_cursor.load(std::memory_order_acquire) : 0;
+    out.orders.next_index = orders_shm ? orders_shm->header.next_index.load(std::memory_order_acquire) : 0;
+
+    out.orders.orders.clear();
+    out.orders.orders.reserve(book.active_count());
+    book.for_each_active([&out](const OrderEntry& entry) { out.orders.orders.push_back(entry); });
+
+    if (execution_engine) {
+        execution_engine->export_checkpoint(out.sessions, out.children);
+    } else {
+        out.sessions.clear();
+        out.children.clear();
+    }
+}
+
+bool write_restart_checkpoint(const std::string& path, const restart_checkpoint& checkpoint) {
+    restart_checkpoint_header header{};
+    header.order_record_size = sizeof(checkpoint_order_record);
+    header.session_record_size = sizeof(execution_session_checkpoint);
+    header.child_record_size = sizeof(execution_child_checkpoint);
+    header.account_id = checkpoint.account_id;
+    header.order_count = static_cast<uint32_t>(checkpoint.orders.orders.size());
+    header.session_count = static_cast<uint32_t>(checkpoint.sessions.size());
+    header.child_count = static_cast<uint32_t>(checkpoint.children.size());
+    header.next_index = checkpoint.orders.next_index;
+    header.created_ns = checkpoint.created_ns;
+    header.journal_cursor = checkpoint.orders.journal_cursor;
+    std::strncpy(header.trading_day, checkpoint.trading_day.c_str(), sizeof(header.trading_day) - 1);
+
+    std::vector<char> buffer;
+    buffer.reserve(sizeof(header) + sizeof(checkpoint_order_record) * header.order_count +
+                   sizeof(execution_session_checkpoint) * header.session_count +
+                   sizeof(execution_child_checkpoint) * header.child_count);
+    append_records(buffer, &header, 1);
+    for (const OrderEntry& entry : checkpoint.orders.orders) {
+        checkpoint_order_record record{};
+        record.request = entry.request;
+        record.submit_time_ns = entry.submit_time_ns;
+        record.last_update_ns = entry.last_update_ns;
+        record.fund_frozen = entry.fund_frozen;
+        record.parent_order_id = entry.parent_order_id;
+        record.shm_order_index = entry.shm_order_index;
+        record.strategy_id = entry.strategy_id;
+        record.risk_result = entry.risk_result;
+        record.retry_count = entry.retry_count;
+        record.is_split_child = entry.is_split_child ? 1 : 0;
+        append_records(buffer, &record, 1);
+    }
+    append_records(buffer, checkpoint.sessions.data(), checkpoint.sessions.size());
+    append_records(buffer, checkpoint.children.data(), checkpoint.children.size());
+
+    std::error_code ec;
+    const std::filesystem::path parent = std::filesystem::path(path).parent_path();
+    if (!parent.empty()) {
+        std::filesystem::create_directories(parent, ec);
+    }
+
+    // 先写临时文件再 rename，崩溃时只会留下旧检查点或完整的新检查点
+    const std::string tmp_path = path + ".tmp";
+    const int fd = ::open(tmp_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        return report_checkpoint_error("failed to open restart checkpoint", errno);
+    }
+    const bool written = write_all(fd, buffer.data(), buffer.size()) && ::fsync(fd) == 0;
+    const int write_err = errno;
+    ::close(fd);
+    if (!written) {
+        return report_checkpoint_error("failed to write restart checkpoint", write_err);
+    }
+    if (std::rename(tmp_path.c_str(), path.c_str()) != 0) {
+        return report_checkpoint_error("failed to publish restart checkpoint", errno);
+    }
+    return true;
+}
+
+bool read_restart_checkpoint(const std::string& path, restart_checkpoint& out) {
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        if (errno == ENOENT) {
+            return false;
+        }
+        return report_checkpoint_error("failed to open restart checkpoint", errno);
+    }
+    struct stat file_stat {};
+    if (::fstat(fd, &file_stat) != 0) {
+        const int err = errno;
+        ::close(fd);
+        return report_checkpoint_error("failed to stat restart checkpoint", err);
+    }
+
+    std::vector<char> buffer(static_cast<std::size_t>(file_stat.st_size));
+    std::size_t offset = 0;
+    while (offset < buffer.size()) {
+        const ssize_t bytes = ::read(fd, buffer.data() + offset, buffer.size() - offset);
+        if (bytes < 0 && errno == EINTR) {
+            continue;
+        }
+        if (bytes <= 0) {
+            break;
+        }
+        offset += static_cast<std::size_t>(bytes);
+    }
+    ::close(fd);
+    if (offset != buffer.size() || buffer.size() < sizeof(restart_checkpoint_header)) {
+        return report_checkpoint_error("restart checkpoint is truncated");
+    }
+
+    restart_checkpoint_header header{};
+    std::memcpy(&header, buffer.data(), sizeof(header));
+    if (header.magic != restart_checkpoint_header::kMagic || header.version != restart_checkpoint_header::kVersion ||
+        header.order_record_size != sizeof(checkpoint_order_record) ||
+        header.session_record_size != sizeof(execution_session_checkpoint) ||
+        header.child_record_size != sizeof(execution_child_checkpoint)) {
+        return report_checkpoint_error("restart checkpoint header is invalid");
+    }
+
+    std::vector<checkpoint_order_record> orders;
+    offset = sizeof(header);
+    if (!read_records(buffer, offset, orders, header.order_count) ||
+        !read_records(buffer, offset, out.sessions, header.session_count) ||
+        !read_records(buffer, offset, out.children, header.child_count) || offset != buffer.size()) {
+        return report_checkpoint_error("restart checkpoint body does not match header");
+    }
+
+    out.account_id = header.account_id;
+    header.trading_day[sizeof(header.trading_day) - 1] = '\0';
+    out.trading_day = header.trading_day;
+    out.created_ns = header.created_ns;
+    out.orders.journal_cursor = header.journal_cursor;
+    out.orders.next_index = header.next_index;
+    out.orders.orders.clear();
+    out.orders.orders.reserve(orders.size());
+    for (const checkpoint_order_record& record : orders) {
+        OrderEntry entry{};
+        entry.request = record.request;
+        entry.submit_time_ns = record.submit_time_ns;
+        entry.last_update_ns = record.last_update_ns;
+        entry.fund_frozen = record.fund_frozen;
+        entry.parent_order_id = record.parent_order_id;
+        entry.shm_order_index = record.shm_order_index;
+        entry.strategy_id = record.strategy_id;
+        entry.risk_result = record.risk_result;
+        entry.retry_count = record.retry_count;
+        entry.is_split_child = record.is_split_child != 0;
+        out.orders.orders.push_back(entry);
+    }
+    for (const execution_session_checkpoint& session : out.sessions) {
+        if (static_cast<std::size_t>(session.child_begin) + session.child_count > out.children.size()) {
+            return report_checkpoint_error("restart checkpoint session references missing children");
+        }
+    }
+    return true;
+}
+
+restart_checkpoint_writer::~restart_checkpoint_writer() { stop(); }
+
+bool restart_checkpoint_writer::start(std::string path, AccountId account_id, std::string trading_day) {
+    stop();
+    if (path.empty()) {
+        return report_checkpoint_error("restart checkpoint path is empty");
+    }
+    path_ = std::move(path);
+    account_id_ = account_id;
+    trading_day_ = std::move(trading_day);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_requested_ = false;
+        has_pending_ = false;
+    }
+    thread_ = std::thread([this]() { writer_loop(); });
+    return true;
+}
+
+void restart_checkpoint_writer::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_requested_ = true;
+    }
+    cv_.notify_all();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+bool restart_checkpoint_writer::submit(restart_checkpoint& checkpoint) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (has_pending_ || stop_requested_ || !thread_.joinable()) {
+            return false;
+        }
+        std::swap(pending_, checkpoint);
+        has_pending_ = true;
+    }
+    cv_.notify_one();
+    return true;
+}
+
+uint64_t restart_checkpoint_writer::written_count() const noexcept {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return written_;
+}
+
+uint64_t restart_checkpoint_writer::failed_count() const noexcept {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return failed_;
+}
+
+// 停止时仍写完已提交的一份，保证正常退出后留下最新检查点。
+void restart_checkpoint_writer::writer_loop() {
+    restart_checkpoint writing;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            cv_.wait_for(lock, kWriterWakeInterval, [this]() { return has_pending_ || stop_requested_; });
+            if (!has_pending_) {
+                if (stop_requested_) {
+                    return;
+                }
+                continue;
+            }
+            std::swap(writing, pending_);
+        }
+
+        writing.account_id = account_id_;
+        writing.trading_day = trading_day_;
+        const bool ok = write_restart_checkpoint(path_, writing);
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            has_pending_ = false;
+            if (ok) {
+                ++written_;
+            } else {
+                ++failed_;
+            }
+        }
+    }
+}
+
+}  // namespace acct_service
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "common/types.hpp"
+#include "execution/execution_engine.hpp"
+#include "order/order_book.hpp"
+#include "order/order_recovery.hpp"
+#include "shm/shm_layout.hpp"
+
+namespace acct_service {
+
+// 重启检查点：订单簿全部条目（含父子关系与受管标记）+ 执行会话进度，配合 orders_shm 变更日志游标做增量恢复。
+// 文件路径为 <dir>/restart_checkpoint_<account>_<trading_day>.bin，每次整体覆盖写（先写临时文件再 rename）。
+struct restart_checkpoint {
+    AccountId account_id = 0;
+    std::string trading_day;
+    TimestampNs created_ns = 0;
+    order_recovery_baseline orders;
+    std::vector<execution_session_checkpoint> sessions;
+    std::vector<execution_child_checkpoint> children;
+};
+
+std::string restart_checkpoint_path(const std::string& dir, AccountId account_id, const std::string& trading_day);
+
+// 在事件循环线程采集检查点：先取 orders_shm 变更日志写游标，再复制订单簿与会话，游标之后的变更由恢复时回放。
+void capture_restart_checkpoint(const OrderBook& book, const orders_shm_layout* orders_shm,
+                                const ExecutionEngine* execution_engine, restart_checkpoint& out);
+
+bool write_restart_checkpoint(const std::string& path, const restart_checkpoint& checkpoint);
+
+// 文件缺失返回 false 且不记错误；文件存在但格式不符时记错误并返回 false。
+bool read_restart_checkpoint(const std::string& path, restart_checkpoint& out);
+
+// 检查点写线程：事件循环只做内存采集并交换缓冲，编码与落盘在后台完成。
+class restart_checkpoint_writer {
+public:
+    restart_checkpoint_writer() = default;
+    ~restart_checkpoint_writer();
+
+    restart_checkpoint_writer(const restart_checkpoint_writer&) = delete;
+    restart_checkpoint_writer& operator=(const restart_checkpoint_writer&) = delete;
+
+    // 账户与交易日写入每份检查点的文件头，恢复时据此拒绝其他账户或交易日的文件。
+    bool start(std::string path, AccountId account_id, std::string trading_day);
+    void stop();
+
+    // 上一份尚未写完时返回 false 且不改动 checkpoint；否则与内部缓冲交换，调用方拿回可复用容量的旧缓冲。
+    bool submit(restart_checkpoint& checkpoint);
+
+    uint64_t written_count() const noexcept;
+    uint64_t failed_count() const noexcept;
+
+private:
+    void writer_loop();
+
+    std::string path_;
+    AccountId account_id_ = 0;
+    std::string trading_day_;
+    restart_checkpoint pending_;
+    bool has_pending_ = false;
+    bool stop_requested_ = false;
+    uint64_t written_ = 0;
+    uint64_t failed_ = 0;
+    mutable std::mutex mutex_;
+    std::condition_variable cv_;
+    std::thread thread_;
+};
+
+}  // namespace acct_service
@@ -0,0 +1,94 @@
+#include "core/startup_report.hpp"
+
+#include <cstdio>
+#include <thread>
+
+#include "common/log.hpp"
+#include "common/types.hpp"
+
+namespace acct_service {
+
+void startup_report::begin() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    begin_ns_ = now_monotonic_ns();
+    total_ns_ = 0;
+    ok_ = false;
+    phases_.clear();
+}
+
+bool startup_report::run_in_group(std::string_view name, std::string_view group, const std::function<bool()>& fn) {
+    const uint64_t start_ns = now_monotonic_ns();
+    const bool ok = fn();
+    const uint64_t end_ns = now_monotonic_ns();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    startup_phase_timing timing;
+    timing.name.assign(name);
+    timing.group.assign(group);
+    timing.start_ns = start_ns >= begin_ns_ ? start_ns - begin_ns_ : 0;
+    timing.duration_ns = end_ns - start_ns;
+    timing.ok = ok;
+    phases_.push_back(std::move(timing));
+    return ok;
+}
+
+bool startup_report::run_parallel(std::string_view group, std::span<const startup_task> tasks) {
+    if (tasks.empty()) {
+        return true;
+    }
+    std::vector<char> results(tasks.size(), 0);
+    std::vector<std::thread> workers;
+    workers.reserve(tasks.size() - 1);
+    for (std::size_t i = 1; i < tasks.size(); ++i) {
+        workers.emplace_back([this, group, &tasks, &results, i]() {
+            results[i] = run_in_group(tasks[i].name, group, tasks[i].fn) ? 1 : 0;
+        });
+    }
+    results[0] = run_in_group(tasks[0].name, group, tasks[0].fn) ? 1 : 0;
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+    bool ok = true;
+    for (char result : results) {
+        ok = ok && result != 0;
+    }
+    return ok;
+}
+
+void startup_report::finish(bool ok) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    total_ns_ = now_monotonic_ns() - begin_ns_;
+    ok_ = ok;
+}
+
+uint64_t startup_report::total_ns() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return total_ns_;
+}
+
+bool startup_report::ok() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return ok_;
+}
+
+std::vector<startup_phase_timing> startup_report::phases() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return phases_;
+}
+
+void startup_report::log(std::string_view module) const {
+    const std::vector<startup_phase_timing> snapshot = phases();
+    char line[256];
+    for (const startup_phase_timing& phase : snapshot) {
+        std::snprintf(line, sizeof(line), "startup phase name=%s group=%s start_us=%llu duration_us=%llu ok=%d",
+                      phase.name.c_str(), phase.group.empty() ? "-" : phase.group.c_str(),
+                      static_cast<unsigned long long>(phase.start_ns / 1000),
+                      static_cast<unsigned long long>(phase.duration_ns / 1000), phase.ok ? 1 : 0);
+        ACCT_LOG_INFO(module, line);
+    }
+    std::snprintf(line, sizeof(line), "startup report phases=%zu total_us=%llu ok=%d", snapshot.size(),
+                  static_cast<unsigned long long>(total_ns() / 1000), ok() ? 1 : 0);
+    ACCT_LOG_INFO(module, line);
+}
+
+}  // namespace acct_service
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace acct_service {
+
+// 单个启动阶段的耗时记录；时间为相对 startup_report::begin() 的单调时钟偏移
+struct startup_phase_timing {
+    std::string name;
+    std::string group;         // 所属并发组，串行阶段为空
+    uint64_t start_ns = 0;
+    uint64_t duration_ns = 0;
+    bool ok = false;
+};
+
+// 并发组中的一个独立阶段
+struct startup_task {
+    std::string_view name;
+    std::function<bool()> fn;
+};
+
+// 启动阶段计时与报告：串行阶段用 run()，彼此独立的阶段用 run_parallel() 同时执行。
+// 记录可在任意线程写入（加锁，仅启动期使用）；log() 以每阶段一行 key=value 输出结构化报告。
+class startup_report {
+public:
+    // 清空记录并以当前时刻为零点
+    void begin();
+
+    // 计时执行一个串行阶段，返回 fn 的结果
+    bool run(std::string_view name, const std::function<bool()>& fn) { return run_in_group(name, {}, fn); }
+
+    // 并发执行一组互不依赖的阶段：首个阶段在调用线程执行，其余各起一个线程，全部结束后返回；
+    // 任一阶段失败返回 false，但不取消其他阶段（各自失败由调用方的 cleanup 统一回收）
+    bool run_parallel(std::string_view group, std::span<const startup_task> tasks);
+
+    // 以 begin() 起的总耗时结束报告
+    void finish(bool ok);
+
+    uint64_t total_ns() const;
+    bool ok() const;
+    std::vector<startup_phase_timing> phases() const;
+
+    // 输出 "startup phase ..." 明细与 "startup report ..." 汇总
+    void log(std::string_view module) const;
+
+private:
+    bool run_in_group(std::string_view name, std::string_view group, const std::function<bool()>& fn);
+
+    mutable std::mutex mutex_;
+    uint64_t begin_ns_ = 0;
+    uint64_t total_ns_ = 0;
+    bool ok_ = false;
+    std::vector<startup_phase_timing> phases_;
+};
+
+}  // namespace acct_service
@@ -0,0 +1,130 @@
+#include "core/startup_warmup.hpp"
+
+#include <sys/mman.h>
+
+#include <algorithm>
+#include <memory>
+
+#include "common/error.hpp"
+#include "common/log.hpp"
+#include "order/order_router.hpp"
+#include "shm/orders_shm.hpp"
+
+namespace acct_service {
+
+namespace {
+
+constexpr std::size_t kPageSize = 4096;
+
+bool report_warmup_error(ErrorCode code, std::string_view message, int sys_errno = 0) {
+    ErrorStatus status = ACCT_MAKE_ERROR(ErrorDomain::core, code, "startup_warmup", message, sys_errno);
+    record_error(status);
+    ACCT_LOG_ERROR_STATUS(status);
+    return false;
+}
+
+// 读触碰真实订单池中即将分配的槽位；shmem 读缺页即分配页面，且不改动槽位内容
+void touch_live_order_slots(const orders_shm_layout* orders_shm, uint32_t count) noexcept {
+    if (!orders_shm) {
+        return;
+    }
+    const uint32_t begin = orders_shm->header.next_index.load(std::memory_order_acquire);
+    const uint32_t end = static_cast<uint32_t>(
+        std::min<uint64_t>(static_cast<uint64_t>(begin) + count, orders_shm->header.capacity));
+    if (end <= begin) {
+        return;
+    }
+    const auto* bytes = reinterpret_cast<const volatile unsigned char*>(&orders_shm->slots[begin]);
+    const std::size_t size = static_cast<std::size_t>(end - begin) * sizeof(OrderSlot);
+    for (std::size_t offset = 0; offset < size; offset += kPageSize) {
+        (void)bytes[offset];
+    }
+}
+
+// 暂存订单池只预留地址空间，合成订单写到哪页才落哪页
+struct scratch_orders_region {
+    orders_shm_layout* layout = nullptr;
+    std::size_t size = 0;
+
+    ~scratch_orders_region() {
+        if (layout) {
+            ::munmap(layout, size);
+        }
+    }
+};
+
+}  // namespace
+
+bool run_startup_warmup(uint32_t order_count, OrderBook& live_book, orders_shm_layout* live_orders_shm,
+                        PositionManager& positions, const RiskConfig& risk_config, warmup_stats& out_stats) {
+    out_stats = warmup_stats{};
+    if (order_count == 0) {
+        return true;
+    }
+    const TimestampNs start_ns = now_monotonic_ns();
+
+    live_book.prefault_slots(order_count);
+    touch_live_order_slots(live_orders_shm, order_count);
+
+    const uint32_t scratch_capacity = std::min<uint32_t>(order_count, live_book.capacity());
+    scratch_orders_region scratch_orders;
+    scratch_orders.size = orders_shm_size(scratch_capacity);
+    void* mapping = ::mmap(nullptr, scratch_orders.size, PROT_READ | PROT_WRITE,
+                           MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (mapping == MAP_FAILED) {
+        return report_warmup_error(ErrorCode::ComponentUnavailable, "failed to map scratch orders shm", errno);
+    }
+    scratch_orders.layout = static_cast<orders_shm_layout*>(mapping);
+    scratch_orders.layout->header.capacity = scratch_capacity;
+
+    auto scratch_downstream = std::make_unique<downstream_shm_layout>();
+    auto scratch_book = std::make_unique<OrderBook>(order_book_threading::SingleThreaded, scratch_capacity);
+    order_router scratch_router(*scratch_book, scratch_downstream.get(), scratch_orders.layout);
+    RiskManager scratch_risk(positions, risk_config);
+
+    // 沪深、买卖交替，价格逐笔变化，避免被重复单规则短路
+    static constexpr const char* kSecurityIds[] = {"600000", "000001"};
+    static constexpr Market kMarkets[] = {Market::SH, Market::SZ};
+    static constexpr const char* kInternalIds[] = {"XSHG_600000", "XSHE_000001"};
+
+    for (uint32_t i = 0; i < order_count; ++i) {
+        const std::size_t venue = i & 1U;
+        const TradeSide side = (i & 2U) == 0 ? TradeSide::Buy : TradeSide::Sell;
+        OrderRequest request;
+        request.init_new(kSecurityIds[venue], InternalSecurityId(kInternalIds[venue]),
+                         static_cast<InternalOrderId>(i + 1), side, kMarkets[venue], static_cast<Volume>(100),
+                         static_cast<DPrice>(1000 + (i % 1000)), 93000000);
+
+        OrderIndex index = kInvalidOrderIndex;
+        if (!orders_shm_append(scratch_orders.layout, request, OrderSlotState::UpstreamDequeued,
+                               order_slot_source_t::AccountInternal, now_ns(), index)) {
+            break;
+        }
+        ++out_stats.orders_submitted;
+        request.security_handle = positions.resolve_security_handle(request.internal_security_id);
+
+        OrderEntry entry{};
+        entry.request = request;
+        entry.submit_time_ns = now_ns();
+        entry.last_update_ns = entry.submit_time_ns;
+        entry.shm_order_index = index;
+        if (!scratch_book->add_order(entry)) {
+            continue;
+        }
+
+        const risk_check_result risk_result = scratch_risk.check_order(request);
+        OrderEntry* active = scratch_book->find_order(request.internal_order_id);
+        if (active && risk_result.passed() && scratch_router.route_order(*active)) {
+            ++out_stats.orders_routed;
+            OrderIndex downstream_index = kInvalidOrderIndex;
+            (void)scratch_downstream->order_queue.try_pop(downstream_index);
+        }
+        (void)scratch_book->update_state(request.internal_order_id, OrderState::Finished);
+        (void)scratch_book->archive_order(request.internal_order_id);
+    }
+
+    out_stats.elapsed_ns = now_monotonic_ns() - start_ns;
+    return true;
+}
+
+}  // namespace acct_service
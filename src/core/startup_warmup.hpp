@@ -0,0 +1,25 @@
+#pragma once
+
+#include <cstdint>
+
+#include "order/order_book.hpp"
+#include "portfolio/position_manager.hpp"
+#include "risk/risk_manager.hpp"
+#include "shm/shm_layout.hpp"
+
+namespace acct_service {
+
+// 启动预热统计
+struct warmup_stats {
+    uint32_t orders_submitted = 0;  // 合成订单笔数
+    uint32_t orders_routed = 0;     // 风控通过并推入暂存下游队列的笔数
+    uint64_t elapsed_ns = 0;        // 预热总耗时（纳秒）
+};
+
+// 启动预热：先触碰真实订单簿与订单池即将使用的页面，再让合成订单在暂存 SHM 上走一遍
+// 订单池写入 -> 订单簿 -> 风控 -> 路由 -> 下游出队，训练分支预测与指令缓存。
+// 暂存组件与真实状态隔离，不消耗订单号、风控额度和真实下游队列；持仓只读。
+bool run_startup_warmup(uint32_t order_count, OrderBook& live_book, orders_shm_layout* live_orders_shm,
+                        PositionManager& positions, const RiskConfig& risk_config, warmup_stats& out_stats);
+
+}  // namespace acct_service
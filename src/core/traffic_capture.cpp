@@ -0,0 +1,298 @@
+#include "core/traffic_capture.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <new>
+
+#include "common/constants.hpp"
+#include "common/error.hpp"
+#include "common/log.hpp"
+#include "common/time_utils.hpp"
+#include "shm/orders_shm.hpp"
+#include "shm/upstream_lanes.hpp"
+
+namespace acct_service {
+
+namespace {
+
+constexpr const char* kLogModule = "traffic_capture";
+
+bool report_capture_error(std::string_view message, int sys_errno = 0) {
+    ErrorStatus status =
+        ACCT_MAKE_ERROR(ErrorDomain::core, ErrorCode::InvalidParam, kLogModule, message, sys_errno);
+    record_error(status);
+    ACCT_LOG_ERROR_STATUS(status);
+    return false;
+}
+
+// 文件头与文件尺寸一致才可回放，避免把其他版本或截断文件当作录制数据
+bool is_valid_capture_file(const traffic_capture_header& header, std::size_t file_size) noexcept {
+    return header.magic == traffic_capture_header::kMagic && header.version == traffic_capture_header::kVersion &&
+           header.record_size == sizeof(traffic_capture_record) && header.ns_per_tick > 0.0 &&
+           file_size >= sizeof(traffic_capture_header) &&
+           (file_size - sizeof(traffic_capture_header)) / sizeof(traffic_capture_record) >= header.record_count;
+}
+
+}  // namespace
+
+std::string traffic_capture::path_for(const std::string& dir, AccountId account_id, const std::string& trading_day) {
+    return dir + "/traffic_capture_" + std::to_string(account_id) + "_" + trading_day + ".bin";
+}
+
+traffic_capture::~traffic_capture() { (void)close(); }
+
+bool traffic_capture::open(const std::string& path, uint64_t capacity, AccountId account_id, uint32_t id_epoch,
+                           uint32_t trading_day) {
+    (void)close();
+    if (capacity == 0) {
+        return report_capture_error("traffic capture capacity must be positive");
+    }
+
+    const std::size_t size = sizeof(traffic_capture_header) + static_cast<std::size_t>(capacity) *
+                                                                  sizeof(traffic_capture_record);
+    const int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        return report_capture_error("failed to create traffic capture file", errno);
+    }
+    if (::ftruncate(fd, static_cast<off_t>(size)) != 0) {
+        const int saved_errno = errno;
+        ::close(fd);
+        return report_capture_error("failed to size traffic capture file", saved_errno);
+    }
+    void* mapping = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (mapping == MAP_FAILED) {
+        const int saved_errno = errno;
+        ::close(fd);
+        return report_capture_error("failed to mmap traffic capture file", saved_errno);
+    }
+
+    use_tsc_ = tsc_clock::enabled();
+    header_ = new (mapping) traffic_capture_header{};
+    header_->record_size = static_cast<uint32_t>(sizeof(traffic_capture_record));
+    header_->account_id = account_id;
+    header_->id_epoch = id_epoch;
+    header_->trading_day = trading_day;
+    header_->ns_per_tick = use_tsc_ ? tsc_detail::g_ns_per_tick.load(std::memory_order_relaxed) : 1.0;
+    header_->capacity = capacity;
+
+    fd_ = fd;
+    mapping_ = mapping;
+    mapping_size_ = size;
+    records_ = reinterpret_cast<traffic_capture_record*>(static_cast<char*>(mapping) +
+                                                         sizeof(traffic_capture_header));
+    ACCT_LOG_INFO(kLogModule, "traffic capture enabled: " + path);
+    return true;
+}
+
+bool traffic_capture::close() noexcept {
+    if (!header_) {
+        return true;
+    }
+    const uint64_t count = header_->record_count;
+    const uint64_t dropped = header_->dropped_count;
+    ::munmap(mapping_, mapping_size_);
+    const std::size_t used = sizeof(traffic_capture_header) + static_cast<std::size_t>(count) *
+                                                                  sizeof(traffic_capture_record);
+    const bool ok = ::ftruncate(fd_, static_cast<off_t>(used)) == 0;
+    ::close(fd_);
+    fd_ = -1;
+    mapping_ = nullptr;
+    mapping_size_ = 0;
+    header_ = nullptr;
+    records_ = nullptr;
+    if (dropped > 0) {
+        ACCT_LOG_WARN(kLogModule, "traffic capture full, dropped " + std::to_string(dropped) + " records");
+    }
+    return ok;
+}
+
+traffic_capture_record* traffic_capture::claim(traffic_capture_kind kind) noexcept {
+    if (!header_) {
+        return nullptr;
+    }
+    if (header_->record_count >= header_->capacity) {
+        ++header_->dropped_count;
+        return nullptr;
+    }
+    traffic_capture_record* record = &records_[header_->record_count];
+    record->tsc = use_tsc_ ? tsc_clock::read_ticks() : now_monotonic_ns();
+    record->kind = kind;
+    return record;
+}
+
+void traffic_capture::capture_order(traffic_capture_kind kind, uint32_t lane, OrderIndex index,
+                                    OrderIndex next_index_hint, const OrderRequest& request) noexcept {
+    traffic_capture_record* record = claim(kind);
+    if (!record) {
+        return;
+    }
+    record->index = index;
+    record->next_index_hint = next_index_hint;
+    record->lane = static_cast<uint16_t>(lane);
+    std::memcpy(record->payload, static_cast<const void*>(&request), sizeof(OrderRequest));
+    header_->lane_count = std::max(header_->lane_count, lane + 1);
+    ++header_->record_count;
+}
+
+void traffic_capture::capture_response(const TradeResponse& response) noexcept {
+    traffic_capture_record* record = claim(traffic_capture_kind::Response);
+    if (!record) {
+        return;
+    }
+    record->index = kInvalidOrderIndex;
+    record->next_index_hint = 0;
+    record->lane = 0;
+    std::memcpy(record->payload, &response, sizeof(TradeResponse));
+    ++header_->record_count;
+}
+
+traffic_capture_file::~traffic_capture_file() { close(); }
+
+bool traffic_capture_file::open(const std::string& path) {
+    close();
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return report_capture_error("failed to open traffic capture file", errno);
+    }
+    struct stat file_stat {};
+    if (::fstat(fd, &file_stat) != 0 || static_cast<std::size_t>(file_stat.st_size) < sizeof(traffic_capture_header)) {
+        ::close(fd);
+        return report_capture_error("traffic capture file is truncated");
+    }
+    const std::size_t file_size = static_cast<std::size_t>(file_stat.st_size);
+    void* mapping = ::mmap(nullptr, file_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        return report_capture_error("failed to mmap traffic capture file", errno);
+    }
+
+    const auto* header = static_cast<const traffic_capture_header*>(mapping);
+    if (!is_valid_capture_file(*header, file_size)) {
+        ::munmap(mapping, file_size);
+        return report_capture_error("traffic capture file header is invalid");
+    }
+    (void)::madvise(mapping, file_size, MADV_SEQUENTIAL);
+
+    mapping_ = mapping;
+    mapping_size_ = file_size;
+    header_ = header;
+    records_ = reinterpret_cast<const traffic_capture_record*>(static_cast<const char*>(mapping) +
+                                                               sizeof(traffic_capture_header));
+    return true;
+}
+
+void traffic_capture_file::close() noexcept {
+    if (mapping_ != nullptr) {
+        ::munmap(mapping_, mapping_size_);
+    }
+    mapping_ = nullptr;
+    mapping_size_ = 0;
+    header_ = nullptr;
+    records_ = nullptr;
+}
+
+uint64_t traffic_capture_file::offset_ns(std::size_t index) const noexcept {
+    if (index >= record_count()) {
+        return 0;
+    }
+    const uint64_t ticks = records_[index].tsc - records_[0].tsc;
+    return static_cast<uint64_t>(static_cast<double>(ticks) * header_->ns_per_tick);
+}
+
+uint64_t traffic_capture_file::duration_ns() const noexcept {
+    const std::size_t count = record_count();
+    return count == 0 ? 0 : offset_ns(count - 1);
+}
+
+traffic_replayer::traffic_replayer(const traffic_capture_file& file, upstream_shm_layout* upstream,
+                                   trades_shm_layout* trades, orders_shm_layout* orders)
+    : file_(file), upstream_(upstream), trades_(trades), orders_(orders) {}
+
+void traffic_replayer::prepare() noexcept {
+    if (!file_.is_open()) {
+        return;
+    }
+    const traffic_capture_header& header = file_.header();
+    if (orders_ && header.id_epoch != 0) {
+        orders_->header.id_epoch.store(header.id_epoch, std::memory_order_release);
+    }
+    if (upstream_ && header.lane_count > upstream_lane_count(upstream_)) {
+        upstream_set_lane_count(upstream_, header.lane_count);
+    }
+}
+
+uint64_t traffic_replayer::next_offset_ns() const noexcept {
+    return done() ? UINT64_MAX : file_.offset_ns(cursor_);
+}
+
+bool traffic_replayer::publish_record(const traffic_capture_record& record) noexcept {
+    if (record.kind == traffic_capture_kind::Response) {
+        if (!trades_) {
+            return true;
+        }
+        TradeResponse response;
+        std::memcpy(&response, record.payload, sizeof(TradeResponse));
+        trade_response_message message;
+        pack_trade_response_message(response, message);
+        if (!trades_->response_queue.try_push(message)) {
+            return false;
+        }
+        ++responses_published_;
+        return true;
+    }
+
+    if (!upstream_ || !orders_ || record.lane >= kMaxUpstreamLanes) {
+        return true;
+    }
+    // 溢出段不跟随，只回放主段槽位
+    if (orders_index_segment(record.index) != 0 || record.index >= orders_->header.capacity) {
+        return true;
+    }
+    // 录制时出队前的 next_index 之前都已被接入方预留，回放抬到同一位置后拆单子单落在与录制时相同的下标
+    (void)orders_shm_reserve_through(orders_, std::max<OrderIndex>(record.index + 1, record.next_index_hint));
+    OrderRequest request;
+    std::memcpy(static_cast<void*>(&request), record.payload, sizeof(OrderRequest));
+    (void)orders_shm_write_order(orders_, record.index, request, OrderSlotState::UpstreamQueued,
+                                 order_slot_source_t::User, now_ns());
+    // 队列满时本条留待下次重推，重写同一槽位无副作用
+    const bool pushed = record.kind == traffic_capture_kind::Cancel
+                            ? upstream_->cancel_lane(record.lane).try_push(record.index)
+                            : upstream_->lane(record.lane).try_push(record.index);
+    if (!pushed) {
+        return false;
+    }
+    ++orders_published_;
+    return true;
+}
+
+std::size_t traffic_replayer::publish_until(uint64_t offset_ns, std::size_t max_records) noexcept {
+    std::size_t published = 0;
+    while (published < max_records && !done() && file_.offset_ns(cursor_) <= offset_ns) {
+        if (!publish_record(file_.record(cursor_))) {
+            break;
+        }
+        ++cursor_;
+        ++published;
+    }
+    return published;
+}
+
+std::size_t traffic_replayer::publish_next(std::size_t count) noexcept {
+    std::size_t published = 0;
+    while (published < count && !done()) {
+        if (!publish_record(file_.record(cursor_))) {
+            break;
+        }
+        ++cursor_;
+        ++published;
+    }
+    return published;
+}
+
+}  // namespace acct_service
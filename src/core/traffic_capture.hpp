@@ -0,0 +1,162 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+
+#include "common/types.hpp"
+#include "order/order_request.hpp"
+#include "shm/shm_layout.hpp"
+
+namespace acct_service {
+
+// SHM 队列流量录制：事件循环在上游槽位出队（取出请求后）与成交回报出队时，把 TSC 时间戳、来源队列与
+// 原始载荷按处理顺序追加到预分配的 mmap 文件；traffic_replayer 再把文件按录制节奏或尽快喂回全新的事件循环，
+// 开盘时段的真实流量由此成为可重复的性能回归基准。
+
+enum class traffic_capture_kind : uint8_t {
+    Order = 1,     // 上游 lane 订单队列出队的槽位（含篮子各腿）
+    Cancel = 2,    // 上游 lane 撤单优先队列出队的槽位
+    Response = 3,  // trades_shm 出队的成交回报（已解码）
+};
+
+inline constexpr std::size_t kTrafficCapturePayloadSize = 256;
+
+static_assert(sizeof(OrderRequest) <= kTrafficCapturePayloadSize, "OrderRequest must fit capture payload");
+static_assert(sizeof(TradeResponse) <= kTrafficCapturePayloadSize, "TradeResponse must fit capture payload");
+
+// 录制文件头；record_count 每追加一条即回写，进程异常退出时已写入的记录仍可回放
+struct alignas(64) traffic_capture_header {
+    static constexpr uint32_t kMagic = 0x50414354;  // "TCAP"
+    static constexpr uint32_t kVersion = 1;
+
+    uint32_t magic = kMagic;
+    uint32_t version = kVersion;
+    uint32_t record_size = 0;
+    AccountId account_id = 0;
+    uint32_t id_epoch = 0;      // 录制时订单池纪元，回放池沿用，回报中的订单号才能对上槽位
+    uint32_t trading_day = 0;   // YYYYMMDD 数值
+    uint32_t lane_count = 0;    // 出现过的最大 lane 编号 + 1
+    uint32_t reserved0 = 0;
+    double ns_per_tick = 0.0;   // TSC 换算系数；未校准 TSC 时记录单调时钟纳秒，系数为 1
+    uint64_t capacity = 0;      // 预分配记录数
+    uint64_t record_count = 0;
+    uint64_t dropped_count = 0;  // 文件写满后丢弃的记录数
+};
+
+static_assert(sizeof(traffic_capture_header) == 64, "traffic_capture_header must be 64 bytes");
+
+// 定长记录：64 字节头 + 256 字节载荷（OrderRequest 或 TradeResponse 的原始字节）
+struct alignas(64) traffic_capture_record {
+    uint64_t tsc = 0;
+    OrderIndex index = kInvalidOrderIndex;  // 订单槽位下标（回报为 kInvalidOrderIndex）
+    OrderIndex next_index_hint = 0;         // 出队时订单池 next_index，回放时抬到同一位置再入队
+    uint16_t lane = 0;
+    traffic_capture_kind kind = traffic_capture_kind::Order;
+    uint8_t reserved[45] = {};
+    alignas(64) unsigned char payload[kTrafficCapturePayloadSize] = {};
+};
+
+static_assert(sizeof(traffic_capture_record) == 320, "traffic_capture_record must be 320 bytes");
+static_assert(std::is_trivially_copyable_v<traffic_capture_record>, "traffic_capture_record must be trivially copyable");
+
+// 录制端：open 时按容量 ftruncate 并整段映射，capture_* 只在事件循环线程调用，写映射区不做系统调用；
+// 写满后丢弃并计数。close 把文件截到实际记录数
+class traffic_capture {
+public:
+    traffic_capture() = default;
+    ~traffic_capture();
+
+    traffic_capture(const traffic_capture&) = delete;
+    traffic_capture& operator=(const traffic_capture&) = delete;
+
+    bool open(const std::string& path, uint64_t capacity, AccountId account_id, uint32_t id_epoch,
+              uint32_t trading_day);
+    bool close() noexcept;
+
+    void capture_order(traffic_capture_kind kind, uint32_t lane, OrderIndex index, OrderIndex next_index_hint,
+                       const OrderRequest& request) noexcept;
+    void capture_response(const TradeResponse& response) noexcept;
+
+    bool is_open() const noexcept { return header_ != nullptr; }
+    uint64_t record_count() const noexcept { return header_ ? header_->record_count : 0; }
+    uint64_t dropped_count() const noexcept { return header_ ? header_->dropped_count : 0; }
+
+    static std::string path_for(const std::string& dir, AccountId account_id, const std::string& trading_day);
+
+private:
+    // 取下一条记录槽位并填好时间戳；写满时计入丢弃，返回 nullptr
+    traffic_capture_record* claim(traffic_capture_kind kind) noexcept;
+
+    int fd_ = -1;
+    void* mapping_ = nullptr;
+    std::size_t mapping_size_ = 0;
+    traffic_capture_header* header_ = nullptr;
+    traffic_capture_record* records_ = nullptr;
+    bool use_tsc_ = false;
+};
+
+// 只读 mmap 一个录制文件，记录数组直接指向映射区
+class traffic_capture_file {
+public:
+    traffic_capture_file() = default;
+    ~traffic_capture_file();
+
+    traffic_capture_file(const traffic_capture_file&) = delete;
+    traffic_capture_file& operator=(const traffic_capture_file&) = delete;
+
+    // 文件头不合法或尺寸与记录数不符时返回 false
+    bool open(const std::string& path);
+    void close() noexcept;
+
+    bool is_open() const noexcept { return header_ != nullptr; }
+    const traffic_capture_header& header() const noexcept { return *header_; }
+    std::size_t record_count() const noexcept { return header_ ? static_cast<std::size_t>(header_->record_count) : 0; }
+    const traffic_capture_record& record(std::size_t index) const noexcept { return records_[index]; }
+    // 第 index 条记录相对首条的录制时刻（纳秒）
+    uint64_t offset_ns(std::size_t index) const noexcept;
+    uint64_t duration_ns() const noexcept;
+
+private:
+    void* mapping_ = nullptr;
+    std::size_t mapping_size_ = 0;
+    const traffic_capture_header* header_ = nullptr;
+    const traffic_capture_record* records_ = nullptr;
+};
+
+// 回放端：把录制文件按原顺序喂回一组全新的上游/回报共享内存。订单写回录制时的槽位再推入同号 lane，
+// 回报编码后推入 trades_shm；目标队列满时停在该条，下次调用继续。账户服务侧照常出队处理
+class traffic_replayer {
+public:
+    traffic_replayer(const traffic_capture_file& file, upstream_shm_layout* upstream, trades_shm_layout* trades,
+                     orders_shm_layout* orders);
+
+    // 沿用录制纪元并启用录制时的 lane 数；须在事件循环 start 之前调用
+    void prepare() noexcept;
+
+    // 推入录制时刻不晚于 offset_ns 的全部未推记录，单次最多 max_records 条，返回本次推入条数
+    std::size_t publish_until(uint64_t offset_ns, std::size_t max_records = SIZE_MAX) noexcept;
+    // 不看时刻，直接推入接下来的 count 条记录（尽快回放）
+    std::size_t publish_next(std::size_t count) noexcept;
+
+    bool done() const noexcept { return cursor_ >= file_.record_count(); }
+    std::size_t cursor() const noexcept { return cursor_; }
+    // 下一条待推记录的录制时刻，已推完时返回 UINT64_MAX
+    uint64_t next_offset_ns() const noexcept;
+    uint64_t orders_published() const noexcept { return orders_published_; }
+    uint64_t responses_published() const noexcept { return responses_published_; }
+
+private:
+    bool publish_record(const traffic_capture_record& record) noexcept;
+
+    const traffic_capture_file& file_;
+    upstream_shm_layout* upstream_ = nullptr;
+    trades_shm_layout* trades_ = nullptr;
+    orders_shm_layout* orders_ = nullptr;
+    std::size_t cursor_ = 0;
+    uint64_t orders_published_ = 0;
+    uint64_t responses_published_ = 0;
+};
+
+}  // namespace acct_service
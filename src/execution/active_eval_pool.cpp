@@ -0,0 +1,126 @@
+#include "execution/active_eval_pool.hpp"
+
+#include <algorithm>
+#include <cstdint>
+
+#include "common/idle_strategy.hpp"
+
+namespace acct_service {
+
+namespace {
+
+constexpr std::size_t kMinChunkContexts = 4;  // 单块最少候选数，块过小时抢块开销盖过评估本身
+constexpr std::size_t kChunksPerThread = 4;   // 每线程平均块数，慢块可被其他线程摊掉
+constexpr std::size_t kMaxChunks = 0xFFFF;    // 领取字中块数字段的上限
+
+// worker 先长时间自旋等下一轮，久无批量再挂起；发布线程自己也领块，worker 唤醒慢不会阻塞本轮
+constexpr idle_policy kWorkerIdlePolicy{20000, 1000, 0};
+// 发布线程等最后几块时先自旋再让出 CPU，避免领块的 worker 被抢占时空转整个时间片
+constexpr idle_policy kPublisherWaitPolicy{2000, UINT32_MAX, 0};
+
+std::size_t ceil_div(std::size_t lhs, std::size_t rhs) noexcept { return (lhs + rhs - 1) / rhs; }
+
+}  // namespace
+
+active_eval_pool::active_eval_pool(ActiveStrategy& strategy, uint32_t worker_count) : strategy_(strategy) {
+    workers_.reserve(worker_count);
+    for (uint32_t i = 0; i < worker_count; ++i) {
+        workers_.emplace_back([this]() { worker_main(); });
+    }
+}
+
+// 轮次加一但不带可领块，只为唤醒挂起的 worker 看到停止标志
+active_eval_pool::~active_eval_pool() {
+    stopping_.store(true, std::memory_order_seq_cst);
+    claim_.fetch_add(1ULL << kRoundShift, std::memory_order_seq_cst);
+    claim_.notify_all();
+    for (std::thread& worker : workers_) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+}
+
+void active_eval_pool::evaluate(std::span<const ActiveStrategyContext> contexts,
+                                std::span<ActiveDecision> out_decisions) {
+    const std::size_t count = std::min(contexts.size(), out_decisions.size());
+    const std::size_t threads = workers_.size() + 1;
+    std::size_t chunk_size = std::max(kMinChunkContexts, ceil_div(count, threads * kChunksPerThread));
+    chunk_size = std::max(chunk_size, ceil_div(count, kMaxChunks));
+    const std::size_t chunk_count = count == 0 ? 0 : ceil_div(count, chunk_size);
+    if (workers_.empty() || chunk_count < 2) {
+        strategy_.evaluate_many(contexts.first(count), out_decisions.first(count));
+        return;
+    }
+
+    contexts_ = contexts.data();
+    decisions_ = out_decisions.data();
+    count_ = count;
+    chunk_size_ = chunk_size;
+    done_chunks_.store(0, std::memory_order_relaxed);
+    ++round_;
+    // seq_cst 与 worker 登记 sleeping_ 后的复查配对：两边至少一方看到对方，挂起的 worker 不会漏掉本轮
+    claim_.store((static_cast<uint64_t>(round_) << kRoundShift) | (static_cast<uint64_t>(chunk_count) << kCountShift),
+                 std::memory_order_seq_cst);
+    if (sleeping_.load(std::memory_order_seq_cst) != 0) {
+        claim_.notify_all();
+    }
+
+    (void)run_chunks();
+    idle_backoff backoff(kPublisherWaitPolicy);
+    while (done_chunks_.load(std::memory_order_acquire) != chunk_count) {
+        backoff.idle([](uint32_t timeout_us) {
+            (void)timeout_us;
+            (void)::sched_yield();
+        });
+    }
+}
+
+bool active_eval_pool::run_chunks() {
+    bool claimed = false;
+    uint64_t word = claim_.load(std::memory_order_acquire);
+    while (true) {
+        const std::size_t index = static_cast<std::size_t>(word & kIndexMask);
+        const std::size_t chunks = static_cast<std::size_t>((word >> kCountShift) & kIndexMask);
+        if (index >= chunks) {
+            return claimed;
+        }
+        if (claim_.compare_exchange_weak(word, word + 1, std::memory_order_acq_rel, std::memory_order_acquire)) {
+            run_chunk(index);
+            done_chunks_.fetch_add(1, std::memory_order_release);
+            claimed = true;
+            word = claim_.load(std::memory_order_acquire);
+        }
+    }
+}
+
+void active_eval_pool::run_chunk(std::size_t chunk) noexcept {
+    const std::size_t begin = chunk * chunk_size_;
+    const std::size_t size = std::min(chunk_size_, count_ - begin);
+    strategy_.evaluate_many(std::span<const ActiveStrategyContext>(contexts_ + begin, size),
+                            std::span<ActiveDecision>(decisions_ + begin, size));
+}
+
+void active_eval_pool::worker_main() {
+    idle_backoff backoff(kWorkerIdlePolicy);
+    while (!stopping_.load(std::memory_order_acquire)) {
+        if (run_chunks()) {
+            backoff.reset();
+            continue;
+        }
+        backoff.idle([this](uint32_t timeout_us) {
+            (void)timeout_us;
+            const uint64_t seen = claim_.load(std::memory_order_acquire);
+            if ((seen & kIndexMask) < ((seen >> kCountShift) & kIndexMask)) {
+                return;
+            }
+            sleeping_.fetch_add(1, std::memory_order_seq_cst);
+            if (claim_.load(std::memory_order_seq_cst) == seen && !stopping_.load(std::memory_order_acquire)) {
+                claim_.wait(seen, std::memory_order_acquire);
+            }
+            sleeping_.fetch_sub(1, std::memory_order_seq_cst);
+        });
+    }
+}
+
+}  // namespace acct_service
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <thread>
+#include <vector>
+
+#include "strategy/active_strategy.hpp"
+
+namespace acct_service {
+
+// 主动评估 worker 池：事件循环线程把一轮候选切成若干块发布，worker 与发布线程一起按原子游标抢块，
+// 每块调用一次 evaluate_many() 写入互不重叠的决策下标；发布线程等全部块完成后返回，
+// 决策仍由事件循环线程交回会话并路由子单，订单簿保持单写者。
+// 启用后策略的 evaluate() / evaluate_many() 会被多个线程并发调用，须可重入。
+class active_eval_pool {
+public:
+    active_eval_pool(ActiveStrategy& strategy, uint32_t worker_count);
+    ~active_eval_pool();
+
+    active_eval_pool(const active_eval_pool&) = delete;
+    active_eval_pool& operator=(const active_eval_pool&) = delete;
+
+    // 评估一轮候选，out_decisions 与 contexts 等长；批量不足两块时在调用线程内直接评估。
+    void evaluate(std::span<const ActiveStrategyContext> contexts, std::span<ActiveDecision> out_decisions);
+
+    uint32_t worker_count() const noexcept { return static_cast<uint32_t>(workers_.size()); }
+
+private:
+    // 领取字：高 32 位为轮次，中 16 位为本轮块数，低 16 位为下一个待领块；整字 CAS 领块，
+    // 领到的块必属于该字所在轮次，轮次字段在该轮全部块完成前不会被改写。
+    static constexpr uint64_t kIndexMask = 0xFFFFULL;
+    static constexpr unsigned kCountShift = 16;
+    static constexpr unsigned kRoundShift = 32;
+
+    void worker_main();
+    // 抢块直到本轮无块可领，返回是否领到过块
+    bool run_chunks();
+    void run_chunk(std::size_t chunk) noexcept;
+
+    ActiveStrategy& strategy_;
+    std::vector<std::thread> workers_;
+
+    // 当前轮的输入输出，只在发布前由发布线程写入
+    const ActiveStrategyContext* contexts_ = nullptr;
+    ActiveDecision* decisions_ = nullptr;
+    std::size_t count_ = 0;
+    std::size_t chunk_size_ = 0;
+
+    alignas(64) std::atomic<uint64_t> claim_{0};
+    alignas(64) std::atomic<std::size_t> done_chunks_{0};
+    alignas(64) std::atomic<uint32_t> sleeping_{0};
+    std::atomic<bool> stopping_{false};
+    uint32_t round_ = 0;
+};
+
+}  // namespace acct_service
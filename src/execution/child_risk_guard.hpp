@@ -0,0 +1,81 @@
+#pragma once
+
+#include <cstdint>
+
+#include "common/types.hpp"
+#include "execution/execution_config.hpp"
+#include "order/order_request.hpp"
+
+namespace acct_service {
+
+// 父单预算快照：由执行会话按差量维护的合计直接给出，校验时不遍历子单账本
+struct child_budget {
+    TradeSide side = TradeSide::NotSet;
+    DPrice parent_price = 0;        // 父单委托价，0 表示市价父单（不做限价与金额预算校验）
+    Volume schedulable_volume = 0;  // 父单尚可释放的数量
+    DValue parent_value = 0;        // 父单委托金额（委托量 * 委托价）
+    DValue committed_value = 0;     // 已成交额 + 在途子单未结算部分按委托价计的金额
+};
+
+// 子单轻量风控：父单入场时已过完整风控链，子单只校验不超出父单预算（剩余量、委托金额、父单限价），
+// 再按配置执行单笔数量 / 金额上限等无状态规则，全部 O(1)。split.child_risk_check 关闭时恒放行。
+// 事件循环线程单写
+class child_risk_guard {
+public:
+    explicit child_risk_guard(const split_config& config) noexcept
+        : enabled_(config.child_risk_check),
+          max_order_volume_(config.child_max_order_volume),
+          max_order_value_(config.child_max_order_value) {}
+
+    bool enabled() const noexcept { return enabled_; }
+
+    RiskResult check(const child_budget& budget, Volume volume, DPrice price) noexcept {
+        if (!enabled_) {
+            return RiskResult::Pass;
+        }
+        ++checks_;
+        const RiskResult result = evaluate(budget, volume, price);
+        if (result != RiskResult::Pass) {
+            ++rejects_;
+        }
+        return result;
+    }
+
+    uint64_t checks() const noexcept { return checks_; }
+    uint64_t rejects() const noexcept { return rejects_; }
+
+private:
+    RiskResult evaluate(const child_budget& budget, Volume volume, DPrice price) const noexcept {
+        if (volume > budget.schedulable_volume) {
+            return RiskResult::RejectParentBudget;
+        }
+        const __uint128_t value = static_cast<__uint128_t>(volume) * static_cast<__uint128_t>(price);
+        if (budget.parent_price != 0) {
+            // 父单限价即子单价格带：买单不高于、卖单不低于父单委托价
+            const bool crosses = budget.side == TradeSide::Buy ? price > budget.parent_price
+                                                               : price < budget.parent_price;
+            if (crosses) {
+                return RiskResult::RejectPriceOutOfRange;
+            }
+            if (static_cast<__uint128_t>(budget.committed_value) + value >
+                static_cast<__uint128_t>(budget.parent_value)) {
+                return RiskResult::RejectParentBudget;
+            }
+        }
+        if (max_order_volume_ != 0 && volume > max_order_volume_) {
+            return RiskResult::RejectExceedMaxOrderVolume;
+        }
+        if (max_order_value_ != 0 && value > static_cast<__uint128_t>(max_order_value_)) {
+            return RiskResult::RejectExceedMaxOrderValue;
+        }
+        return RiskResult::Pass;
+    }
+
+    bool enabled_ = false;
+    Volume max_order_volume_ = 0;
+    DValue max_order_value_ = 0;
+    uint64_t checks_ = 0;
+    uint64_t rejects_ = 0;
+};
+
+}  // namespace acct_service
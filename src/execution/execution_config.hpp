@@ -1,5 +1,7 @@
 #pragma once
 
+#include <string>
+
 #include "common/types.hpp"
 
 namespace acct_service {
@@ -12,6 +14,13 @@ struct split_config {
     uint32_t max_child_count = 100;
     uint32_t interval_ms = 0;
     double randomize_factor = 0.0;
+    uint32_t max_sessions = 4096;       // 执行会话池容量：启动时一次性预留，占满后新父单以 PoolExhausted 拒绝
+    uint32_t eval_workers = 0;          // 主动策略并行评估的 worker 线程数；0 表示在事件循环线程内串行评估
+    std::string vwap_profile_path;      // VWAP 日内成交量分布文件；为空时 VWAP 父单被拒绝
+    bool child_risk_check = false;      // 子单按父单预算做 O(1) 校验（剩余量、委托金额、父单限价），不重走风控链
+    Volume child_max_order_volume = 0;  // 子单单笔数量上限，0 表示不限；仅 child_risk_check 开启时生效
+    DValue child_max_order_value = 0;   // 子单单笔金额上限，0 表示不限；仅 child_risk_check 开启时生效
+    bool coroutine_sessions = false;    // TWAP / VWAP 改用协程会话，帧从按 max_sessions 预留的帧池分配
 };
 
 }  // namespace acct_service
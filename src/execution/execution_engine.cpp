@@ -1,19 +1,28 @@
 #include "execution/execution_engine.hpp"
 
 #include <algorithm>
+#include <array>
 #include <cstdio>
+#include <ctime>
 #include <limits>
 #include <memory>
 #include <utility>
 #include <vector>
 
+#include "common/flat_hash_map.hpp"
+#include "common/lazy_region.hpp"
 #include "common/log.hpp"
+#include "execution/active_eval_pool.hpp"
+#include "execution/session_coroutine.hpp"
 #include "order/passive_execution.hpp"
 
 namespace acct_service {
 
 namespace {
 
+// next_wakeup_ns 返回该值表示会话只等待子单回报或撤单事件，不进就绪队列也不挂定时器
+constexpr TimestampNs kWakeOnEvent = std::numeric_limits<TimestampNs>::max();
+
 // 做饱和加法，避免累计成交额和手续费时无界溢出。
 uint64_t saturating_add(uint64_t lhs, uint64_t rhs) noexcept {
     const uint64_t limit = std::numeric_limits<uint64_t>::max();
@@ -47,9 +56,9 @@ bool is_supported_session_strategy(SplitStrategy strategy) noexcept {
     switch (strategy) {
         case SplitStrategy::FixedSize:
         case SplitStrategy::TWAP:
+        case SplitStrategy::VWAP:
         case SplitStrategy::Iceberg:
             return true;
-        case SplitStrategy::VWAP:
         case SplitStrategy::None:
         default:
             return false;
@@ -92,6 +101,29 @@ int status_progress_rank(OrderState status) noexcept {
     }
 }
 
+// status_progress_rank 的取值个数，会话按档位计数子单状态以 O(1) 求最佳进度。
+constexpr std::size_t kProgressRankCount = 8;
+
+// status_progress_rank 的逆映射，0 档（终态及未知）回落 TraderPending。
+OrderState progress_rank_state(int rank) noexcept {
+    switch (rank) {
+        case 7:
+            return OrderState::MarketAccepted;
+        case 6:
+            return OrderState::BrokerAccepted;
+        case 5:
+            return OrderState::TraderSubmitted;
+        case 3:
+            return OrderState::RiskControllerAccepted;
+        case 2:
+            return OrderState::RiskControllerPending;
+        case 1:
+            return OrderState::UserSubmitted;
+        default:
+            return OrderState::TraderPending;
+    }
+}
+
 // 统一解析顺序型执行算法的 clip/display 口径。
 Volume resolve_clip_volume(const split_config& split_config) noexcept {
     if (split_config.max_child_volume != 0) {
@@ -169,28 +201,46 @@ std::string_view format_submit_price_trace_detail(const submit_price_trace_conte
     return std::string_view(buffer, detail_size);
 }
 
-// 复用旧 TWAP 的切片口径，预先生成每个时间片应消耗的预算。
-bool build_twap_slice_plan(const OrderRequest& parent_request, const split_config& split_config,
-                           std::vector<Volume>& out_slice_volumes) {
-    out_slice_volumes.clear();
+// 时间片计划中的一片：片额与绝对发单时点；start_session 时一次算好，tick 只与下一项比较。
+struct slice_plan_entry {
+    Volume volume = 0;
+    TimestampNs deadline_ns = 0;
+};
+
+// VWAP 计划生成的临时缓冲：由会话池持有并跨会话复用，批量启动时不再逐会话分配。
+struct slice_plan_scratch {
+    std::vector<uint64_t> weights;
+    std::vector<Volume> volumes;
+    std::vector<std::pair<uint64_t, std::size_t>> remainders;
+};
+
+// 复用旧 TWAP 的切片口径计算时间片个数。
+std::size_t resolve_slice_count(const OrderRequest& parent_request, const split_config& split_config) noexcept {
     if (parent_request.volume_entrust == 0 || split_config.max_child_count == 0) {
-        return false;
+        return 0;
     }
-
     const Volume target_volume = resolve_clip_volume(split_config);
     if (target_volume == 0) {
-        return false;
+        return 0;
     }
 
     std::size_t child_count =
         static_cast<std::size_t>((parent_request.volume_entrust + target_volume - 1) / target_volume);
     child_count = std::max<std::size_t>(child_count, 1);
-    child_count = std::min<std::size_t>(child_count, split_config.max_child_count);
+    return std::min<std::size_t>(child_count, split_config.max_child_count);
+}
+
+// 复用旧 TWAP 的切片口径，预先生成每个时间片应消耗的预算。
+bool build_twap_slice_plan(const OrderRequest& parent_request, const split_config& split_config,
+                           TimestampNs start_time_ns, std::vector<slice_plan_entry>& out_plan) {
+    out_plan.clear();
+    const std::size_t child_count = resolve_slice_count(parent_request, split_config);
     if (child_count == 0) {
         return false;
     }
 
-    out_slice_volumes.reserve(child_count);
+    out_plan.reserve(child_count);
+    const TimestampNs interval_ns = static_cast<TimestampNs>(split_config.interval_ms) * 1'000'000ULL;
     const Volume base_volume = parent_request.volume_entrust / child_count;
     Volume remainder = parent_request.volume_entrust % child_count;
     for (std::size_t i = 0; i < child_count; ++i) {
@@ -200,10 +250,96 @@ bool build_twap_slice_plan(const OrderRequest& parent_request, const split_confi
             --remainder;
         }
         if (slice_volume > 0) {
-            out_slice_volumes.push_back(slice_volume);
+            out_plan.push_back(
+                slice_plan_entry{slice_volume, start_time_ns + static_cast<TimestampNs>(out_plan.size()) * interval_ns});
         }
     }
-    return !out_slice_volumes.empty();
+    return !out_plan.empty();
+}
+
+// 把 HHMMSSmmm 形式的行情时间换算成当日毫秒；格式非法返回 false。
+bool md_time_to_ms_of_day(MdTime md_time, uint32_t& out_ms) noexcept {
+    const uint32_t hours = md_time / 10'000'000U;
+    const uint32_t minutes = (md_time / 100'000U) % 100U;
+    const uint32_t seconds = (md_time / 1'000U) % 100U;
+    const uint32_t millis = md_time % 1'000U;
+    if (md_time == 0 || hours >= 24 || minutes >= 60 || seconds >= 60) {
+        return false;
+    }
+    out_ms = ((hours * 60U + minutes) * 60U + seconds) * 1'000U + millis;
+    return true;
+}
+
+// 会话起点的当日毫秒：优先父单行情时间，缺失时按本地墙钟折算。
+uint32_t resolve_session_ms_of_day(const OrderRequest& parent_request, TimestampNs start_time_ns) noexcept {
+    uint32_t ms_of_day = 0;
+    if (md_time_to_ms_of_day(parent_request.md_time_driven, ms_of_day)) {
+        return ms_of_day;
+    }
+    const time_t seconds = static_cast<time_t>(start_time_ns / 1'000'000'000ULL);
+    std::tm local_time{};
+    if (!localtime_r(&seconds, &local_time)) {
+        return 0;
+    }
+    return static_cast<uint32_t>(((local_time.tm_hour * 60 + local_time.tm_min) * 60 + local_time.tm_sec) * 1000) +
+           static_cast<uint32_t>((start_time_ns / 1'000'000ULL) % 1000ULL);
+}
+
+// 按成交量分布为各时间片分配父单数量：片数与间隔沿用 TWAP 口径，片额与该片时间窗内的分布权重成正比，
+// 余量按最大余数分配；零额片（如午休）直接略过，后续片保留原时点。全程无权重时退化为等分。
+bool build_vwap_slice_plan(const OrderRequest& parent_request, const split_config& split_config,
+                           const volume_profile& profile, const uint16_t* bins, uint32_t start_ms_of_day,
+                           TimestampNs start_time_ns, slice_plan_scratch& scratch,
+                           std::vector<slice_plan_entry>& out_plan) {
+    out_plan.clear();
+    const std::size_t child_count = resolve_slice_count(parent_request, split_config);
+    if (child_count == 0 || split_config.interval_ms == 0 || !bins) {
+        return false;
+    }
+
+    std::vector<uint64_t>& weights = scratch.weights;
+    weights.assign(child_count, 0);
+    uint64_t total_weight = 0;
+    for (std::size_t i = 0; i < child_count; ++i) {
+        const uint64_t begin_ms = static_cast<uint64_t>(start_ms_of_day) + i * split_config.interval_ms;
+        const uint64_t end_ms = begin_ms + split_config.interval_ms;
+        if (begin_ms < UINT32_MAX) {
+            weights[i] = profile.window_weight(bins, static_cast<uint32_t>(begin_ms),
+                                               static_cast<uint32_t>(std::min<uint64_t>(end_ms, UINT32_MAX)));
+        }
+        total_weight += weights[i];
+    }
+    if (total_weight == 0) {
+        std::fill(weights.begin(), weights.end(), 1);
+        total_weight = child_count;
+    }
+
+    const Volume target = parent_request.volume_entrust;
+    std::vector<Volume>& volumes = scratch.volumes;
+    volumes.assign(child_count, 0);
+    std::vector<std::pair<uint64_t, std::size_t>>& remainders = scratch.remainders;
+    remainders.clear();
+    Volume assigned = 0;
+    for (std::size_t i = 0; i < child_count; ++i) {
+        const __uint128_t scaled = static_cast<__uint128_t>(target) * weights[i];
+        volumes[i] = static_cast<Volume>(scaled / total_weight);
+        assigned += volumes[i];
+        remainders.emplace_back(static_cast<uint64_t>(scaled % total_weight), i);
+    }
+    std::stable_sort(remainders.begin(), remainders.end(),
+                     [](const auto& lhs, const auto& rhs) { return lhs.first > rhs.first; });
+    for (std::size_t i = 0; assigned < target; i = (i + 1) % child_count) {
+        ++volumes[remainders[i].second];
+        ++assigned;
+    }
+
+    const TimestampNs interval_ns = static_cast<TimestampNs>(split_config.interval_ms) * 1'000'000ULL;
+    for (std::size_t i = 0; i < child_count; ++i) {
+        if (volumes[i] > 0) {
+            out_plan.push_back(slice_plan_entry{volumes[i], start_time_ns + static_cast<TimestampNs>(i) * interval_ns});
+        }
+    }
+    return !out_plan.empty();
 }
 
 // 在内部子单上保留父单基础字段，只重置执行过程相关的可变状态。
@@ -263,6 +399,64 @@ struct child_execution_ledger {
     }
 };
 
+// 会话池槽位的账本存储：会话回收时清空但保留容量，同槽位的下一个会话直接复用，稳态下子单入账与计划生成不再分配。
+class child_ledger_store {
+public:
+    std::vector<child_execution_ledger> ledgers;  // 按提交顺序存放，下标即子单槽位
+    std::vector<slice_plan_entry> slice_plan;     // 时间片会话的计划，顺序型会话不使用
+
+    // 按子单 ID 查找账本；非本会话子单返回 nullptr。
+    child_execution_ledger* find(InternalOrderId child_order_id) noexcept {
+        const uint32_t* slot = slot_by_id_ ? slot_by_id_->find(child_order_id) : nullptr;
+        return slot ? &ledgers[*slot] : nullptr;
+    }
+
+    // 新子单入账；重复 ID 保留首个槽位的索引。
+    void append(const child_execution_ledger& ledger) {
+        if (!slot_by_id_ || (ledgers.size() + 1) * 2 > slot_by_id_->capacity()) {
+            grow_index();
+        }
+        if (!slot_by_id_->contains(ledger.child_order_id)) {
+            (void)slot_by_id_->insert_or_assign(ledger.child_order_id, static_cast<uint32_t>(ledgers.size()));
+        }
+        ledgers.push_back(ledger);
+    }
+
+    void reset() noexcept {
+        ledgers.clear();
+        slice_plan.clear();
+        if (slot_by_id_) {
+            slot_by_id_->clear();
+        }
+    }
+
+    // 账本、计划与索引的堆占用：回收后保留的容量计入预留，当前会话的条目计入在用
+    memory_usage memory() const noexcept {
+        memory_usage usage = element_memory(ledgers.capacity(), ledgers.size(), sizeof(child_execution_ledger));
+        usage += element_memory(slice_plan.capacity(), slice_plan.size(), sizeof(slice_plan_entry));
+        if (slot_by_id_) {
+            usage += slot_by_id_->memory();
+        }
+        return usage;
+    }
+
+private:
+    static constexpr std::size_t kInitialIndexCapacity = 64;
+
+    // 负载超过一半时按两倍容量从账本重建索引；扩出的索引随槽位保留，后续会话不再重复扩容。
+    void grow_index() {
+        const std::size_t capacity = slot_by_id_ ? slot_by_id_->capacity() * 2 : kInitialIndexCapacity;
+        slot_by_id_ = std::make_unique<flat_hash_map<InternalOrderId, uint32_t>>(capacity);
+        for (std::size_t slot = 0; slot < ledgers.size(); ++slot) {
+            if (!slot_by_id_->contains(ledgers[slot].child_order_id)) {
+                (void)slot_by_id_->insert_or_assign(ledgers[slot].child_order_id, static_cast<uint32_t>(slot));
+            }
+        }
+    }
+
+    std::unique_ptr<flat_hash_map<InternalOrderId, uint32_t>> slot_by_id_;  // 子单 ID -> ledgers 下标
+};
+
 // 用账本中的累计成交额/量回推成交均价，和订单簿上的 child 聚合口径保持一致。
 DPrice average_traded_price(const child_execution_ledger& ledger) noexcept {
     if (ledger.confirmed_traded_volume == 0) {
@@ -276,11 +470,11 @@ DPrice average_traded_price(const child_execution_ledger& ledger) noexcept {
 
 class ExecutionSession {
 public:
-    // 保存父单上下文和统一账本依赖，供各算法派生类复用。
-    ExecutionSession(OrderIndex parent_index, const OrderRequest& parent_request, StrategyId strategy_id,
-                     PassiveExecutionAlgo execution_algo, OrderBook& order_book, order_router& order_router,
-                     MarketDataService* market_data_service, OrderEventRecorder* order_event_recorder,
-                     ActiveStrategy* active_strategy)
+    // 保存父单上下文和统一账本依赖，供各算法派生类复用；账本存放在会话池槽位的 ledger_store 中。
+    ExecutionSession(child_ledger_store& ledger_store, OrderIndex parent_index, const OrderRequest& parent_request,
+                     StrategyId strategy_id, PassiveExecutionAlgo execution_algo, OrderBook& order_book,
+                     order_router& order_router, MarketDataService* market_data_service,
+                     OrderEventRecorder* order_event_recorder, ActiveStrategy* active_strategy)
         : parent_index_(parent_index),
           parent_request_(parent_request),
           strategy_id_(strategy_id),
@@ -289,10 +483,19 @@ public:
           order_router_(order_router),
           market_data_service_(market_data_service),
           order_event_recorder_(order_event_recorder),
-          active_strategy_(active_strategy) {}
+          active_strategy_(active_strategy),
+          ledger_store_(ledger_store),
+          child_ledgers_(ledger_store.ledgers) {
+        if (market_data_service_) {
+            market_data_handle_ = market_data_service_->resolve(parent_request_.internal_security_id.view());
+        }
+    }
 
     virtual ~ExecutionSession() = default;
 
+    // 会话所在池槽位的账本存储，供会话池回收时定位槽位。
+    child_ledger_store& ledger_store() noexcept { return ledger_store_; }
+
     // 返回是否满足本会话的最小创建条件。
     virtual bool is_valid() const noexcept { return true; }
 
@@ -301,12 +504,12 @@ public:
 
     // 用统一账本消费子单回报，供预算释放和父单镜像同步使用。
     virtual void on_trade_response(const TradeResponse& response) {
-        const auto child_it = child_ledgers_.find(response.internal_order_id);
-        if (child_it == child_ledgers_.end()) {
+        child_execution_ledger* found = find_ledger(response.internal_order_id);
+        if (!found) {
             return;
         }
 
-        child_execution_ledger& ledger = child_it->second;
+        child_execution_ledger& ledger = *found;
         if (ledger.finalized) {
             if (response.volume_traded > 0 || response.cancelled_volume > 0) {
                 ACCT_LOG_WARN("ExecutionEngine", "ignored conflicting late trade response after child finalized");
@@ -315,13 +518,10 @@ public:
         }
 
         if (response.volume_traded > 0) {
-            ledger.confirmed_traded_volume =
-                std::min<Volume>(ledger.entrust_volume, ledger.confirmed_traded_volume + response.volume_traded);
-            ledger.confirmed_traded_value = saturating_add(ledger.confirmed_traded_value, response.dvalue_traded);
-            ledger.confirmed_fee = saturating_add(ledger.confirmed_fee, response.dfee);
+            record_child_fill(ledger, response.volume_traded, response.dvalue_traded, response.dfee);
         }
 
-        ledger.order_state = response.new_state;
+        set_child_state(ledger, response.new_state);
         if (response.new_state == OrderState::Finished) {
             finalize_finished_child(ledger, response.cancelled_volume);
             on_child_finalized(ledger.child_order_id);
@@ -329,27 +529,149 @@ public:
         }
 
         if (is_failure_terminal_state(response.new_state)) {
-            ledger.final_cancelled_volume = ledger.unresolved_volume();
-            ledger.finalized = true;
+            mark_child_finalized(ledger, ledger.unresolved_volume());
             failed_ = true;
             emit_child_finalized_trace(ledger);
             on_child_finalized(ledger.child_order_id);
         }
     }
 
+    // 回报处理后是否应当场推进（顺序型 clip 补单），不等本轮回报批次处理完再 tick。
+    virtual bool refills_on_response() const noexcept { return false; }
+
+    // 下一次需要 tick 的时间；不大于 now 表示下一轮继续推进（默认行为），kWakeOnEvent 表示等待事件唤醒。
+    virtual TimestampNs next_wakeup_ns(TimestampNs now_ns_value) const noexcept { return now_ns_value; }
+
+    // 是否需要在父单证券行情前进时被唤醒（由引擎统一批量观察快照序号）。
+    virtual bool watches_market_data() const noexcept { return false; }
+
+    MarketDataHandle market_data_handle() const noexcept { return market_data_handle_; }
+
+    // 挂接引擎的节拍行情缓存：同证券会话在一个节拍内共享同一份视图，不再各自读快照。
+    void attach_view_cache(MarketDataTickCache* cache) noexcept { view_cache_ = cache; }
+
+    // 挂接引擎的证券特征表：主动评估前把本轮视图纳入特征（同一发布序号只计一次），随上下文交给策略。
+    void attach_feature_store(SymbolFeatureStore* store) noexcept { feature_store_ = store; }
+
+    // 挂接引擎的子单轻量风控；nullptr 时子单不做校验直接提交。
+    void attach_child_risk(child_risk_guard* guard) noexcept { child_risk_ = guard; }
+
+    // 取本证券纳入 market_data_view 后的特征；未挂接特征表时返回 nullptr
+    const SymbolFeatures* update_features(const MarketDataView& market_data_view) {
+        return feature_store_ ? feature_store_->update(market_data_handle_, market_data_view) : nullptr;
+    }
+
+    // 批量主动评估的候选收集：当前窗口有预算且读到未评估过的 fresh prediction 时，
+    // 缓存本轮行情视图供 tick 复用，并返回候选上下文。
+    bool collect_active_candidate(Volume& out_budget_volume) {
+        if (!active_strategy_ || terminal_ || failed_) {
+            return false;
+        }
+        const Volume budget_volume = active_budget_volume();
+        if (budget_volume == 0) {
+            return false;
+        }
+        const MarketDataView* view = read_market_data_view();
+        if (!view || !view->prediction.has_fresh_prediction() ||
+            view->prediction.publish_seq_no == last_active_publish_seq_no_) {
+            return false;
+        }
+        out_budget_volume = budget_volume;
+        return true;
+    }
+
+    const OrderRequest& parent_request() const noexcept { return parent_request_; }
+    // 仅在 collect_active_candidate() 返回 true 后、本轮 clear_prefetch() 前调用
+    const MarketDataView& prefetched_view() const noexcept { return *tick_view_; }
+
+    // 批量评估结果在本轮 tick 的主动尝试中消费，替代逐会话 evaluate()。
+    void set_prefetched_active_decision(const ActiveDecision& decision) noexcept {
+        prefetched_decision_ = decision;
+        prefetched_decision_valid_ = true;
+    }
+
+    // tick 结束后丢弃本轮预取，下一轮重新读取行情。
+    void clear_prefetch() noexcept {
+        tick_view_ = nullptr;
+        tick_view_read_ = false;
+        prefetched_decision_valid_ = false;
+    }
+
     // 暴露父单 ID 给引擎做会话索引和回收。
     InternalOrderId parent_order_id() const noexcept { return parent_request_.internal_order_id; }
 
+    // 导出会话状态与账本；账本追加到 children 尾部。
+    void export_checkpoint(execution_session_checkpoint& out, std::vector<execution_child_checkpoint>& children) const {
+        out.parent_order_id = parent_request_.internal_order_id;
+        out.parent_index = parent_index_;
+        out.strategy_id = strategy_id_;
+        out.failed = failed_;
+        out.child_begin = static_cast<uint32_t>(children.size());
+        out.child_count = static_cast<uint32_t>(child_ledgers_.size());
+        for (const child_execution_ledger& ledger : child_ledgers_) {
+            execution_child_checkpoint child{};
+            child.child_order_id = ledger.child_order_id;
+            child.shm_order_index = ledger.shm_order_index;
+            child.entrust_volume = ledger.entrust_volume;
+            child.entrust_price = ledger.entrust_price;
+            child.confirmed_traded_volume = ledger.confirmed_traded_volume;
+            child.confirmed_traded_value = ledger.confirmed_traded_value;
+            child.confirmed_fee = ledger.confirmed_fee;
+            child.final_cancelled_volume = ledger.final_cancelled_volume;
+            child.order_state = ledger.order_state;
+            child.finalized = ledger.finalized;
+            child.cancel_requested = ledger.cancel_requested;
+            children.push_back(child);
+        }
+        export_progress(out);
+    }
+
+    // 从检查点装回账本与调度进度，再按订单簿对账检查点之后的回报。
+    void restore_checkpoint(const execution_session_checkpoint& state, const execution_child_checkpoint* children) {
+        failed_ = state.failed;
+        for (uint32_t i = 0; i < state.child_count; ++i) {
+            const execution_child_checkpoint& child = children[i];
+            child_execution_ledger ledger{};
+            ledger.child_order_id = child.child_order_id;
+            ledger.shm_order_index = child.shm_order_index;
+            ledger.entrust_volume = child.entrust_volume;
+            ledger.entrust_price = child.entrust_price;
+            ledger.confirmed_traded_volume = child.confirmed_traded_volume;
+            ledger.confirmed_traded_value = child.confirmed_traded_value;
+            ledger.confirmed_fee = child.confirmed_fee;
+            ledger.final_cancelled_volume = child.final_cancelled_volume;
+            ledger.order_state = child.order_state;
+            ledger.finalized = child.finalized;
+            ledger.cancel_requested = child.cancel_requested;
+            append_ledger(ledger);
+            confirmed_traded_value_ = saturating_add(confirmed_traded_value_, ledger.confirmed_traded_value);
+            confirmed_fee_ = saturating_add(confirmed_fee_, ledger.confirmed_fee);
+        }
+        restore_progress(state);
+        reconcile_children_with_book();
+    }
+
     // 标识会话是否已经收敛，可以从引擎中回收。
     bool is_terminal() const noexcept { return terminal_; }
 
 protected:
-    // 读取父单最新盘口快照，供主动/被动共用定价逻辑复用。
-    bool read_market_data_view(MarketDataView& out_view) const {
+    // 读取父单最新盘口快照，供主动/被动共用定价逻辑复用；一轮推进内只读一次，clear_prefetch() 后重新读取。
+    // 挂接了节拍缓存时返回与同证券会话共享的视图，否则读入会话自有缓冲。不可读时返回 nullptr
+    const MarketDataView* read_market_data_view() {
+        if (tick_view_read_) {
+            return tick_view_;
+        }
+        tick_view_read_ = true;
+        tick_view_ = nullptr;
         if (!market_data_service_ || !market_data_service_->is_ready()) {
-            return false;
+            return nullptr;
+        }
+        if (view_cache_) {
+            tick_view_ = view_cache_->read(market_data_handle_);
+        } else if (market_data_service_->read(market_data_handle_, own_view_)) {
+            tick_view_ = &own_view_;
         }
-        return market_data_service_->read(parent_request_.internal_security_id.view(), out_view);
+        return tick_view_;
     }
 
     // 判断当前会话是否允许在行情不可用时回退到父单委托价。
@@ -403,14 +725,13 @@ protected:
     }
 
     // 先尝试按行情定价；若启用了调试回退，则在行情缺失或脏数据时改用父单委托价。
-    bool resolve_submit_price(MarketDataView& out_view, bool& has_market_data_view, DPrice& out_price,
+    bool resolve_submit_price(const MarketDataView*& out_view, DPrice& out_price,
                               submit_price_trace_context& out_trace_context) {
-        has_market_data_view = false;
         out_trace_context = submit_price_trace_context{};
-        if (read_market_data_view(out_view)) {
-            has_market_data_view = true;
-            out_trace_context = make_submit_price_trace_context(out_view, SubmitPriceSource::Market);
-            if (resolve_market_price(out_view, out_price)) {
+        out_view = read_market_data_view();
+        if (out_view) {
+            out_trace_context = make_submit_price_trace_context(*out_view, SubmitPriceSource::Market);
+            if (resolve_market_price(*out_view, out_price)) {
                 return true;
             }
             if (!allow_order_price_fallback()) {
@@ -443,19 +764,20 @@ protected:
         }
 
         cancel_requested_ = false;
-        const std::vector<InternalOrderId> related_ids = order_book_.get_children(parent_request_.internal_order_id);
-        for (InternalOrderId related_id : related_ids) {
-            const OrderEntry* entry = order_book_.find_order(related_id);
-            if (!entry || entry->request.order_type != OrderType::Cancel) {
-                continue;
-            }
-
-            cancel_requested_ = true;
-            const auto child_it = child_ledgers_.find(entry->request.orig_internal_order_id);
-            if (child_it != child_ledgers_.end()) {
-                child_it->second.cancel_requested = true;
-            }
-        }
+        order_book_.for_each_child(parent_request_.internal_order_id,
+                                   [this](InternalOrderId related_id, const OrderEntry* entry) {
+                                       (void)related_id;
+                                       if (!entry || entry->request.order_type != OrderType::Cancel) {
+                                           return;
+                                       }
+
+                                       cancel_requested_ = true;
+                                       child_execution_ledger* ledger =
+                                           find_ledger(entry->request.orig_internal_order_id);
+                                       if (ledger) {
+                                           ledger->cancel_requested = true;
+                                       }
+                                   });
         return true;
     }
 
@@ -474,44 +796,16 @@ protected:
     }
 
     // 当前账本已确认成交量累计。
-    Volume confirmed_traded_volume() const noexcept {
-        Volume total = 0;
-        for (const auto& [child_id, ledger] : child_ledgers_) {
-            (void)child_id;
-            total = saturating_add(total, ledger.confirmed_traded_volume);
-        }
-        return total;
-    }
+    Volume confirmed_traded_volume() const noexcept { return confirmed_traded_volume_; }
 
     // 当前账本已确认成交额累计。
-    DValue confirmed_traded_value() const noexcept {
-        DValue total = 0;
-        for (const auto& [child_id, ledger] : child_ledgers_) {
-            (void)child_id;
-            total = saturating_add(total, ledger.confirmed_traded_value);
-        }
-        return total;
-    }
+    DValue confirmed_traded_value() const noexcept { return confirmed_traded_value_; }
 
     // 当前账本已确认手续费累计。
-    DValue confirmed_fee() const noexcept {
-        DValue total = 0;
-        for (const auto& [child_id, ledger] : child_ledgers_) {
-            (void)child_id;
-            total = saturating_add(total, ledger.confirmed_fee);
-        }
-        return total;
-    }
+    DValue confirmed_fee() const noexcept { return confirmed_fee_; }
 
     // 当前所有未 finalize 子单占用的 working_volume。
-    Volume working_volume() const noexcept {
-        Volume total = 0;
-        for (const auto& [child_id, ledger] : child_ledgers_) {
-            (void)child_id;
-            total = saturating_add(total, ledger.unresolved_volume());
-        }
-        return total;
-    }
+    Volume working_volume() const noexcept { return working_volume_; }
 
     // 当前父单剩余目标量，仅由已确认成交量派生。
     Volume remaining_target() const noexcept {
@@ -532,6 +826,17 @@ protected:
         return remaining - working;
     }
 
+    // 子单风控读取的父单预算：剩余量与已占用金额都来自差量维护的会话合计。
+    child_budget child_budget_view() const noexcept {
+        child_budget budget;
+        budget.side = parent_request_.trade_side;
+        budget.parent_price = parent_request_.dprice_entrust;
+        budget.schedulable_volume = schedulable_volume();
+        budget.parent_value = parent_request_.volume_entrust * parent_request_.dprice_entrust;
+        budget.committed_value = saturating_add(confirmed_traded_value_, working_value_);
+        return budget;
+    }
+
     // 判断当前是否还有未终态的活动子单。
     bool has_working_children() const noexcept { return working_volume() > 0; }
 
@@ -581,8 +886,7 @@ protected:
 
         OrderEntry child_entry{};
         child_entry.request = make_child_request(parent_request_, 0, volume, price, active_claimed);
-        child_entry.submit_time_ns = now_ns();
-        child_entry.last_update_ns = child_entry.submit_time_ns;
+        // 提交时间留空，由路由按循环时钟补齐，与同轮其余状态迁移共用一次取时（挂接模拟时钟时取模拟时间）
         child_entry.strategy_id = strategy_id_;
         child_entry.risk_result = RiskResult::Pass;
         child_entry.retry_count = 0;
@@ -591,6 +895,12 @@ protected:
         child_entry.shm_order_index = kInvalidOrderIndex;
         emit_child_submit_attempt_trace(child_entry.request.internal_order_id, volume, price, active_claimed,
                                         price_trace_context);
+        // 超出父单预算的子单本轮不提交，会话保持在管，下一轮按最新预算重新生成
+        if (child_risk_ && child_risk_->check(child_budget_view(), volume, price) != RiskResult::Pass) {
+            emit_child_submit_result_trace(child_entry.request.internal_order_id, child_entry.shm_order_index,
+                                           child_entry.request.dprice_entrust, false, "child_risk_rejected");
+            return false;
+        }
 
         if (!order_router_.submit_internal_order(child_entry)) {
             emit_child_submit_result_trace(child_entry.request.internal_order_id, child_entry.shm_order_index,
@@ -607,7 +917,7 @@ protected:
         ledger.entrust_volume = volume;
         ledger.entrust_price = price;
         ledger.order_state = OrderState::TraderSubmitted;
-        child_ledgers_.emplace(ledger.child_order_id, ledger);
+        append_ledger(ledger);
         emit_child_submit_result_trace(child_entry.request.internal_order_id, child_entry.shm_order_index,
                                        child_entry.request.dprice_entrust, true, "submitted");
         return true;
@@ -627,7 +937,11 @@ protected:
         }
 
         const ActiveDecision decision =
-            active_strategy_->evaluate(ActiveStrategyContext{parent_request_, market_data_view, budget_volume});
+            prefetched_decision_valid_
+                ? prefetched_decision_
+                : active_strategy_->evaluate(ActiveStrategyContext{parent_request_, market_data_view, budget_volume,
+                                                                   update_features(market_data_view)});
+        prefetched_decision_valid_ = false;
         last_active_publish_seq_no_ = market_data_view.prediction.publish_seq_no;
         if (!decision.should_submit || decision.volume == 0 || decision.volume > budget_volume) {
             return false;
@@ -636,29 +950,134 @@ protected:
         return submit_child(decision.volume, market_price, true, price_trace_context);
     }
 
+    // 按子单 ID 查找账本槽位；非本会话子单返回 nullptr。
+    child_execution_ledger* find_ledger(InternalOrderId child_order_id) noexcept {
+        return ledger_store_.find(child_order_id);
+    }
+
+    // 新子单入账：占用 working_volume，并计入当前进度档位。
+    void append_ledger(const child_execution_ledger& ledger) {
+        ledger_store_.append(ledger);
+        working_volume_ = saturating_add(working_volume_, ledger.unresolved_volume());
+        working_value_ = saturating_add(working_value_, ledger.unresolved_volume() * ledger.entrust_price);
+        confirmed_traded_volume_ = saturating_add(confirmed_traded_volume_, ledger.confirmed_traded_volume);
+        ++progress_rank_counts_[static_cast<std::size_t>(status_progress_rank(ledger.order_state))];
+    }
+
+    // 账本字段只经 append_ledger 与以下三个入口写入，按差量维护会话级合计，避免逐轮遍历全部子单。
+    void record_child_fill(child_execution_ledger& ledger, Volume volume, DValue value, DValue fee) noexcept {
+        const Volume unresolved_before = ledger.unresolved_volume();
+        const Volume traded_before = ledger.confirmed_traded_volume;
+        ledger.confirmed_traded_volume =
+            std::min<Volume>(ledger.entrust_volume, ledger.confirmed_traded_volume + volume);
+        ledger.confirmed_traded_value = saturating_add(ledger.confirmed_traded_value, value);
+        ledger.confirmed_fee = saturating_add(ledger.confirmed_fee, fee);
+
+        const Volume resolved = unresolved_before - ledger.unresolved_volume();
+        working_volume_ -= resolved;
+        working_value_ -= std::min(working_value_, resolved * ledger.entrust_price);
+        confirmed_traded_volume_ =
+            saturating_add(confirmed_traded_volume_, ledger.confirmed_traded_volume - traded_before);
+        confirmed_traded_value_ = saturating_add(confirmed_traded_value_, value);
+        confirmed_fee_ = saturating_add(confirmed_fee_, fee);
+    }
+
+    void set_child_state(child_execution_ledger& ledger, OrderState state) noexcept {
+        --progress_rank_counts_[static_cast<std::size_t>(status_progress_rank(ledger.order_state))];
+        ledger.order_state = state;
+        ++progress_rank_counts_[static_cast<std::size_t>(status_progress_rank(state))];
+    }
+
+    void mark_child_finalized(child_execution_ledger& ledger, Volume final_cancelled_volume) noexcept {
+        working_volume_ -= ledger.unresolved_volume();
+        working_value_ -= std::min(working_value_, ledger.unresolved_volume() * ledger.entrust_price);
+        ledger.final_cancelled_volume = final_cancelled_volume;
+        ledger.finalized = true;
+    }
+
+    // 派生类导出/装回各自的调度进度。
+    virtual void export_progress(execution_session_checkpoint& out) const { (void)out; }
+    virtual void restore_progress(const execution_session_checkpoint& state) { (void)state; }
+
+    // 检查点之后的回报只落在订单簿：先收编账本外的新子单，再把成交差量与终态补记进账本。
+    void reconcile_children_with_book() {
+        std::vector<child_execution_ledger> adopted;
+        order_book_.for_each_child(parent_request_.internal_order_id,
+                                   [this, &adopted](InternalOrderId child_id, const OrderEntry* entry) {
+                                       if (!entry || entry->request.order_type != OrderType::New ||
+                                           find_ledger(child_id)) {
+                                           return;
+                                       }
+                                       child_execution_ledger ledger{};
+                                       ledger.child_order_id = child_id;
+                                       ledger.shm_order_index = entry->shm_order_index;
+                                       ledger.entrust_volume = entry->request.volume_entrust;
+                                       ledger.entrust_price = entry->request.dprice_entrust;
+                                       ledger.order_state = OrderState::TraderSubmitted;
+                                       adopted.push_back(ledger);
+                                   });
+        for (const child_execution_ledger& ledger : adopted) {
+            append_ledger(ledger);
+        }
+
+        for (child_execution_ledger& ledger : child_ledgers_) {
+            if (ledger.finalized) {
+                continue;
+            }
+            const OrderEntry* entry = order_book_.find_order(ledger.child_order_id);
+            if (!entry) {
+                continue;
+            }
+            const OrderRequest& request = entry->request;
+            if (request.volume_traded > ledger.confirmed_traded_volume) {
+                const DValue value = request.dvalue_traded > ledger.confirmed_traded_value
+                                         ? request.dvalue_traded - ledger.confirmed_traded_value
+                                         : 0;
+                const DValue fee =
+                    request.dfee_executed > ledger.confirmed_fee ? request.dfee_executed - ledger.confirmed_fee : 0;
+                record_child_fill(ledger, request.volume_traded - ledger.confirmed_traded_volume, value, fee);
+            }
+
+            const OrderState state = request.order_state.load(std::memory_order_acquire);
+            if (state != ledger.order_state) {
+                set_child_state(ledger, state);
+            }
+            if (state == OrderState::Finished) {
+                finalize_finished_child(ledger, ledger.unresolved_volume());
+                on_child_finalized(ledger.child_order_id);
+            } else if (is_failure_terminal_state(state)) {
+                mark_child_finalized(ledger, ledger.unresolved_volume());
+                failed_ = true;
+                on_child_finalized(ledger.child_order_id);
+            }
+        }
+    }
+
     // 当子单终态落地后，由派生类决定如何推进后续算法步骤。
     virtual void on_child_finalized(InternalOrderId child_order_id) { (void)child_order_id; }
 
+    // 下一次 tick 主动尝试可用的预算；0 表示本轮不会询问主动策略。
+    virtual Volume active_budget_volume() const noexcept { return 0; }
+
     // 统一把 finished 事件收口成 child ledger 的 final_cancelled_volume。
     void finalize_finished_child(child_execution_ledger& ledger, Volume cancelled_volume) {
         const Volume unresolved_before = ledger.unresolved_volume();
+        Volume final_cancelled_volume = 0;
         if (cancelled_volume > 0) {
             const Volume max_cancelled = (ledger.confirmed_traded_volume >= ledger.entrust_volume)
                                              ? 0
                                              : (ledger.entrust_volume - ledger.confirmed_traded_volume);
-            ledger.final_cancelled_volume = std::min(cancelled_volume, max_cancelled);
+            final_cancelled_volume = std::min(cancelled_volume, max_cancelled);
             if (ledger.confirmed_traded_volume + cancelled_volume > ledger.entrust_volume) {
                 ACCT_LOG_WARN("ExecutionEngine", "clamped conflicting cancelled_volume on child finish");
             }
-        } else if (unresolved_before == 0) {
-            ledger.final_cancelled_volume = 0;
-        } else {
+        } else if (unresolved_before != 0) {
             // 兼容仍未补齐 cancelled_volume 的旧链路，但明确打日志暴露协议缺口。
             ACCT_LOG_WARN("ExecutionEngine", "inferred remaining child volume on finish without cancelled_volume");
-            ledger.final_cancelled_volume = unresolved_before;
+            final_cancelled_volume = unresolved_before;
         }
 
-        ledger.finalized = true;
+        mark_child_finalized(ledger, final_cancelled_volume);
         if (cancel_requested_ && !has_working_children()) {
             last_active_publish_seq_no_ = 0;
         }
@@ -674,17 +1093,13 @@ protected:
             return OrderState::Finished;
         }
 
-        OrderState best_progress_status = OrderState::TraderPending;
-        int best_rank = status_progress_rank(best_progress_status);
-        for (const auto& [child_id, ledger] : child_ledgers_) {
-            (void)child_id;
-            const int rank = status_progress_rank(ledger.order_state);
-            if (rank > best_rank) {
-                best_rank = rank;
-                best_progress_status = ledger.order_state;
+        const int floor_rank = status_progress_rank(OrderState::TraderPending);
+        for (int rank = static_cast<int>(kProgressRankCount) - 1; rank > floor_rank; --rank) {
+            if (progress_rank_counts_[static_cast<std::size_t>(rank)] != 0) {
+                return progress_rank_state(rank);
             }
         }
-        return best_progress_status;
+        return OrderState::TraderPending;
     }
 
     // 统一输出新的执行态字段，供 monitor 区分 Running/Cancelling/Finished/Failed。
@@ -726,10 +1141,26 @@ protected:
     OrderBook& order_book_;
     order_router& order_router_;
     MarketDataService* market_data_service_ = nullptr;
+    MarketDataHandle market_data_handle_{};  // 会话创建时 resolve 一次，逐轮读取不再规范化证券键
     OrderEventRecorder* order_event_recorder_ = nullptr;
     ActiveStrategy* active_strategy_ = nullptr;
-    std::unordered_map<InternalOrderId, child_execution_ledger> child_ledgers_;
+    child_ledger_store& ledger_store_;
+    std::vector<child_execution_ledger>& child_ledgers_;              // 即 ledger_store_.ledgers，下标即子单槽位
+    Volume working_volume_ = 0;                                        // 未 finalize 子单的未结算量合计
+    DValue working_value_ = 0;                                         // 上述未结算量按各子单委托价计的金额
+    Volume confirmed_traded_volume_ = 0;
+    DValue confirmed_traded_value_ = 0;
+    DValue confirmed_fee_ = 0;
+    std::array<uint32_t, kProgressRankCount> progress_rank_counts_{};  // 各进度档位上的子单数
     uint64_t last_active_publish_seq_no_ = 0;
+    MarketDataTickCache* view_cache_ = nullptr;  // 引擎节拍缓存，未挂接时读入 own_view_
+    SymbolFeatureStore* feature_store_ = nullptr;  // 引擎证券特征表，未挂接时上下文不带特征
+    child_risk_guard* child_risk_ = nullptr;       // 引擎子单风控，未挂接时不校验
+    const MarketDataView* tick_view_ = nullptr;  // 本轮推进读到的行情视图（共享或自有）
+    MarketDataView own_view_{};
+    ActiveDecision prefetched_decision_{};
+    bool tick_view_read_ = false;
+    bool prefetched_decision_valid_ = false;
     bool order_price_fallback_logged_ = false;
     bool cancel_requested_ = false;
     bool failed_ = false;
@@ -739,12 +1170,12 @@ protected:
 class SequentialClipSession : public ExecutionSession {
 public:
     // 用统一 clip 逻辑驱动 FixedSize / Iceberg 这两类顺序型算法。
-    SequentialClipSession(OrderIndex parent_index, const OrderRequest& parent_request, StrategyId strategy_id,
-                          PassiveExecutionAlgo execution_algo, const split_config& split_config, OrderBook& order_book,
-                          order_router& order_router, MarketDataService* market_data_service,
+    SequentialClipSession(child_ledger_store& ledger_store, OrderIndex parent_index, const OrderRequest& parent_request,
+                          StrategyId strategy_id, PassiveExecutionAlgo execution_algo, const split_config& split_config,
+                          OrderBook& order_book, order_router& order_router, MarketDataService* market_data_service,
                           OrderEventRecorder* order_event_recorder, ActiveStrategy* active_strategy)
-        : ExecutionSession(parent_index, parent_request, strategy_id, execution_algo, order_book, order_router,
-                           market_data_service, order_event_recorder, active_strategy),
+        : ExecutionSession(ledger_store, parent_index, parent_request, strategy_id, execution_algo, order_book,
+                           order_router, market_data_service, order_event_recorder, active_strategy),
           clip_volume_(resolve_clip_volume(split_config)) {}
 
     // 顺序型算法的创建条件是 clip/display 口径非零。
@@ -784,22 +1215,41 @@ public:
             return;
         }
 
-        MarketDataView market_data_view{};
-        bool has_market_data_view = false;
+        const MarketDataView* market_data_view = nullptr;
         DPrice market_price = 0;
         submit_price_trace_context price_trace_context{};
-        if (!resolve_submit_price(market_data_view, has_market_data_view, market_price, price_trace_context)) {
+        if (!resolve_submit_price(market_data_view, market_price, price_trace_context)) {
             sync_parent_view();
             return;
         }
 
-        if (!(has_market_data_view &&
-              try_active_submit(market_data_view, market_price, budget_volume, price_trace_context))) {
+        if (!(market_data_view &&
+              try_active_submit(*market_data_view, market_price, budget_volume, price_trace_context))) {
             (void)submit_child(budget_volume, market_price, false, price_trace_context);
         }
         sync_parent_view();
     }
 
+    // 有在途子单时 tick 只同步镜像，直到子单回报或撤单才需要再次推进。
+    TimestampNs next_wakeup_ns(TimestampNs now_ns_value) const noexcept override {
+        if (!terminal_ && !failed_ && has_working_children()) {
+            return kWakeOnEvent;
+        }
+        return now_ns_value;
+    }
+
+    // 当前 clip 已终态且会话仍在管时，补单延迟决定冰山单排队位置，随回报当场发出下一笔。
+    bool refills_on_response() const noexcept override { return !terminal_ && !has_working_children(); }
+
+protected:
+    // 无在途子单且未撤单时，下一笔 clip 会先询问主动策略。
+    Volume active_budget_volume() const noexcept override {
+        if (cancel_requested_ || has_working_children()) {
+            return 0;
+        }
+        return std::min<Volume>(clip_volume_, schedulable_volume());
+    }
+
 private:
     Volume clip_volume_ = 0;
 };
@@ -807,42 +1257,31 @@ private:
 class FixedSizeSession final : public SequentialClipSession {
 public:
     // 使用固定 clip 逐笔释放预算，直到目标量完成或父单取消。
-    FixedSizeSession(OrderIndex parent_index, const OrderRequest& parent_request, StrategyId strategy_id,
-                     const split_config& split_config, OrderBook& order_book, order_router& order_router,
-                     MarketDataService* market_data_service, OrderEventRecorder* order_event_recorder,
-                     ActiveStrategy* active_strategy)
-        : SequentialClipSession(parent_index, parent_request, strategy_id, PassiveExecutionAlgo::FixedSize,
-                                split_config, order_book, order_router, market_data_service, order_event_recorder,
-                                active_strategy) {}
+    FixedSizeSession(child_ledger_store& ledger_store, OrderIndex parent_index, const OrderRequest& parent_request,
+                     StrategyId strategy_id, const split_config& split_config, OrderBook& order_book,
+                     order_router& order_router, MarketDataService* market_data_service,
+                     OrderEventRecorder* order_event_recorder, ActiveStrategy* active_strategy)
+        : SequentialClipSession(ledger_store, parent_index, parent_request, strategy_id,
+                                PassiveExecutionAlgo::FixedSize, split_config, order_book, order_router,
+                                market_data_service, order_event_recorder, active_strategy) {}
 };
 
 class IcebergSession final : public SequentialClipSession {
 public:
     // 首版 Iceberg 与 FixedSize 共享推进器，只保留独立会话类型和状态命名。
-    IcebergSession(OrderIndex parent_index, const OrderRequest& parent_request, StrategyId strategy_id,
-                   const split_config& split_config, OrderBook& order_book, order_router& order_router,
-                   MarketDataService* market_data_service, OrderEventRecorder* order_event_recorder,
-                   ActiveStrategy* active_strategy)
-        : SequentialClipSession(parent_index, parent_request, strategy_id, PassiveExecutionAlgo::Iceberg, split_config,
-                                order_book, order_router, market_data_service, order_event_recorder, active_strategy) {}
+    IcebergSession(child_ledger_store& ledger_store, OrderIndex parent_index, const OrderRequest& parent_request,
+                   StrategyId strategy_id, const split_config& split_config, OrderBook& order_book,
+                   order_router& order_router, MarketDataService* market_data_service,
+                   OrderEventRecorder* order_event_recorder, ActiveStrategy* active_strategy)
+        : SequentialClipSession(ledger_store, parent_index, parent_request, strategy_id, PassiveExecutionAlgo::Iceberg,
+                                split_config, order_book, order_router, market_data_service, order_event_recorder,
+                                active_strategy) {}
 };
 
-class TwapSession final : public ExecutionSession {
+// TWAP / VWAP 共用的时间片会话：按预先生成的计划逐片推进，片额与片时点由子类的计划决定。
+class ScheduledSliceSession : public ExecutionSession {
 public:
-    // 记录 TWAP 的时间片计划和当前片节奏，按固定时钟持续推进。
-    TwapSession(OrderIndex parent_index, const OrderRequest& parent_request, StrategyId strategy_id,
-                const split_config& split_config, TimestampNs start_time_ns, OrderBook& order_book,
-                order_router& order_router, MarketDataService* market_data_service,
-                OrderEventRecorder* order_event_recorder, ActiveStrategy* active_strategy)
-        : ExecutionSession(parent_index, parent_request, strategy_id, PassiveExecutionAlgo::TWAP, order_book,
-                           order_router, market_data_service, order_event_recorder, active_strategy),
-          start_time_ns_(start_time_ns),
-          interval_ns_(static_cast<TimestampNs>(split_config.interval_ms) * 1'000'000ULL),
-          next_deadline_ns_(start_time_ns) {
-        valid_ = interval_ns_ != 0 && build_twap_slice_plan(parent_request, split_config, slice_volumes_);
-    }
-
-    // TWAP 只有在 interval 与切片计划都有效时才能创建。
+    // 计划为空的会话无效；interval 等约束由计划生成函数校验。
     bool is_valid() const noexcept override { return valid_; }
 
     // 每轮先给当前时间片一个主动尝试机会，到片末再回落被动片额。
@@ -859,7 +1298,7 @@ public:
         }
 
         advance_slice_if_ready();
-        if (slice_index_ >= slice_volumes_.size()) {
+        if (slice_index_ >= slice_plan_.size()) {
             if (!has_working_children()) {
                 terminal_ = true;
                 sync_parent_view();
@@ -879,18 +1318,17 @@ public:
 
         const Volume budget_volume = current_budget_volume();
         if (budget_volume > 0) {
-            MarketDataView market_data_view{};
-            bool has_market_data_view = false;
+            const MarketDataView* market_data_view = nullptr;
             DPrice market_price = 0;
             submit_price_trace_context price_trace_context{};
-            if (!resolve_submit_price(market_data_view, has_market_data_view, market_price, price_trace_context)) {
+            if (!resolve_submit_price(market_data_view, market_price, price_trace_context)) {
                 sync_parent_view();
                 return;
             }
 
-            if (!slice_consumed_ && has_market_data_view) {
+            if (!slice_consumed_ && market_data_view) {
                 slice_consumed_ =
-                    try_active_submit(market_data_view, market_price, budget_volume, price_trace_context);
+                    try_active_submit(*market_data_view, market_price, budget_volume, price_trace_context);
             }
             if (!slice_consumed_ && now_ns_value >= next_deadline_ns_) {
                 slice_consumed_ = submit_child(budget_volume, market_price, false, price_trace_context);
@@ -898,7 +1336,7 @@ public:
         }
 
         advance_slice_if_ready();
-        if (slice_index_ >= slice_volumes_.size()) {
+        if (slice_index_ >= slice_plan_.size()) {
             if (!has_working_children()) {
                 terminal_ = true;
             }
@@ -908,20 +1346,85 @@ public:
         }
     }
 
+    // 当前片已发出（或已撤单、已无剩余片）且有在途子单时只等回报；
+    // 未到片时点时停到片时点，主动策略由行情序号前进提前唤醒；无法观察行情时保持就绪逐轮评估。
+    TimestampNs next_wakeup_ns(TimestampNs now_ns_value) const noexcept override {
+        if (terminal_ || failed_) {
+            return now_ns_value;
+        }
+        const bool slices_done = slice_index_ >= slice_plan_.size();
+        if (has_working_children() && (slice_consumed_ || cancel_requested_ || slices_done)) {
+            return kWakeOnEvent;
+        }
+        if ((active_strategy_ && !watches_market_data()) || cancel_requested_ || slice_consumed_ || slices_done) {
+            return now_ns_value;
+        }
+        return next_deadline_ns_;
+    }
+
+    // 主动策略只在当前片窗口内评估新预测值，行情前进即可触发。
+    bool watches_market_data() const noexcept override {
+        return active_strategy_ != nullptr && market_data_service_ != nullptr && market_data_handle_.is_valid();
+    }
+
 protected:
+    ScheduledSliceSession(child_ledger_store& ledger_store, OrderIndex parent_index, const OrderRequest& parent_request,
+                          StrategyId strategy_id, PassiveExecutionAlgo execution_algo, TimestampNs start_time_ns,
+                          OrderBook& order_book, order_router& order_router, MarketDataService* market_data_service,
+                          OrderEventRecorder* order_event_recorder, ActiveStrategy* active_strategy)
+        : ExecutionSession(ledger_store, parent_index, parent_request, strategy_id, execution_algo, order_book,
+                           order_router, market_data_service, order_event_recorder, active_strategy),
+          start_time_ns_(start_time_ns),
+          next_deadline_ns_(start_time_ns),
+          slice_plan_(ledger_store.slice_plan) {}
+
+    // 子类构造时把计划直接生成到池槽位的计划存储中，再调用 finish_slice_plan。
+    std::vector<slice_plan_entry>& slice_plan_storage() noexcept { return slice_plan_; }
+
+    // 首片时点取计划首项的绝对时点。
+    void finish_slice_plan(bool built) {
+        valid_ = built && !slice_plan_.empty();
+        if (valid_) {
+            next_deadline_ns_ = slice_plan_.front().deadline_ns;
+        }
+    }
+
     // 当前片子单全部终态后，推进到下一时间片并恢复主动评估机会。
     void on_child_finalized(InternalOrderId child_order_id) override {
         (void)child_order_id;
         advance_slice_if_ready();
     }
 
+    void export_progress(execution_session_checkpoint& out) const override {
+        out.start_time_ns = start_time_ns_;
+        out.slice_index = static_cast<uint32_t>(slice_index_);
+        out.slice_consumed = slice_consumed_;
+    }
+
+    // 计划已由同一 start_time_ns 在构造时重建，这里只装回片进度。
+    void restore_progress(const execution_session_checkpoint& state) override {
+        slice_index_ = std::min<std::size_t>(state.slice_index, slice_plan_.size());
+        slice_consumed_ = state.slice_consumed;
+        if (slice_index_ < slice_plan_.size()) {
+            next_deadline_ns_ = slice_plan_[slice_index_].deadline_ns;
+        }
+    }
+
+    // 当前片尚未发出且未撤单时，本片预算可交给主动策略。
+    Volume active_budget_volume() const noexcept override {
+        if (cancel_requested_ || slice_consumed_) {
+            return 0;
+        }
+        return current_budget_volume();
+    }
+
 private:
     // 返回当前片在 remaining/working 约束下还能消耗的预算。
     Volume current_budget_volume() const noexcept {
-        if (slice_index_ >= slice_volumes_.size()) {
+        if (slice_index_ >= slice_plan_.size()) {
             return 0;
         }
-        return std::min<Volume>(slice_volumes_[slice_index_], schedulable_volume());
+        return std::min<Volume>(slice_plan_[slice_index_].volume, schedulable_volume());
     }
 
     // 当前片已有子单且全部终态后，切到下一片并按固定时钟继续推进。
@@ -929,61 +1432,389 @@ private:
         if (!slice_consumed_ || has_working_children()) {
             return;
         }
-        if (slice_index_ < slice_volumes_.size()) {
+        if (slice_index_ < slice_plan_.size()) {
             ++slice_index_;
         }
         slice_consumed_ = false;
         last_active_publish_seq_no_ = 0;
-        next_deadline_ns_ = start_time_ns_ + static_cast<TimestampNs>(slice_index_) * interval_ns_;
+        if (slice_index_ < slice_plan_.size()) {
+            next_deadline_ns_ = slice_plan_[slice_index_].deadline_ns;
+        }
     }
 
     bool valid_ = false;
     TimestampNs start_time_ns_ = 0;
-    TimestampNs interval_ns_ = 0;
     TimestampNs next_deadline_ns_ = 0;
     std::size_t slice_index_ = 0;
     bool slice_consumed_ = false;
-    std::vector<Volume> slice_volumes_;
+    std::vector<slice_plan_entry>& slice_plan_;  // 即 ledger_store.slice_plan，容量随池槽位保留
+};
+
+class TwapSession final : public ScheduledSliceSession {
+public:
+    // 记录 TWAP 的等分时间片计划，按固定时钟持续推进。
+    TwapSession(child_ledger_store& ledger_store, OrderIndex parent_index, const OrderRequest& parent_request,
+                StrategyId strategy_id, const split_config& split_config, TimestampNs start_time_ns,
+                OrderBook& order_book, order_router& order_router, MarketDataService* market_data_service,
+                OrderEventRecorder* order_event_recorder, ActiveStrategy* active_strategy)
+        : ScheduledSliceSession(ledger_store, parent_index, parent_request, strategy_id, PassiveExecutionAlgo::TWAP,
+                                start_time_ns, order_book, order_router, market_data_service, order_event_recorder,
+                                active_strategy) {
+        const bool built =
+            split_config.interval_ms != 0 && build_twap_slice_plan(parent_request, split_config, start_time_ns, slice_plan_storage());
+        finish_slice_plan(built);
+    }
+};
+
+class VwapSession final : public ScheduledSliceSession {
+public:
+    // 按证券的日内成交量分布把父单分配到各时间片，片时点与 TWAP 同口径。
+    VwapSession(child_ledger_store& ledger_store, OrderIndex parent_index, const OrderRequest& parent_request,
+                StrategyId strategy_id, const split_config& split_config, TimestampNs start_time_ns,
+                const volume_profile& profile, slice_plan_scratch& scratch, OrderBook& order_book,
+                order_router& order_router, MarketDataService* market_data_service,
+                OrderEventRecorder* order_event_recorder, ActiveStrategy* active_strategy)
+        : ScheduledSliceSession(ledger_store, parent_index, parent_request, strategy_id, PassiveExecutionAlgo::VWAP,
+                                start_time_ns, order_book, order_router, market_data_service, order_event_recorder,
+                                active_strategy) {
+        const bool built = build_vwap_slice_plan(parent_request, split_config, profile,
+                                                 profile.find(parent_request.internal_security_id.view()),
+                                                 resolve_session_ms_of_day(parent_request, start_time_ns),
+                                                 start_time_ns, scratch, slice_plan_storage());
+        finish_slice_plan(built);
+    }
+};
+
+// TWAP / VWAP 的协程实现（split.coroutine_sessions）：片内等待与片间推进写成顺序代码，协程停在哪个 co_await
+// 就是当前进度，tick 只恢复协程，不再逐轮重算所处阶段。父单失败、撤单等横切状态仍由 tick 在恢复前统一处理；
+// 计划与检查点口径和 ScheduledSliceSession 一致，帧来自引擎的 coroutine_frame_pool。
+class CoroutineSliceSession final : public ExecutionSession {
+public:
+    CoroutineSliceSession(child_ledger_store& ledger_store, OrderIndex parent_index, const OrderRequest& parent_request,
+                          StrategyId strategy_id, PassiveExecutionAlgo execution_algo, const split_config& split_config,
+                          TimestampNs start_time_ns, const volume_profile* profile, slice_plan_scratch& scratch,
+                          coroutine_frame_pool& frames, OrderBook& order_book, order_router& order_router,
+                          MarketDataService* market_data_service, OrderEventRecorder* order_event_recorder,
+                          ActiveStrategy* active_strategy)
+        : ExecutionSession(ledger_store, parent_index, parent_request, strategy_id, execution_algo, order_book,
+                           order_router, market_data_service, order_event_recorder, active_strategy),
+          start_time_ns_(start_time_ns),
+          slice_plan_(ledger_store.slice_plan) {
+        bool built = false;
+        if (execution_algo == PassiveExecutionAlgo::VWAP) {
+            built = profile != nullptr &&
+                    build_vwap_slice_plan(parent_request, split_config, *profile,
+                                          profile->find(parent_request.internal_security_id.view()),
+                                          resolve_session_ms_of_day(parent_request, start_time_ns), start_time_ns,
+                                          scratch, slice_plan_);
+        } else {
+            built = split_config.interval_ms != 0 &&
+                    build_twap_slice_plan(parent_request, split_config, start_time_ns, slice_plan_);
+        }
+        if (built && !slice_plan_.empty()) {
+            const coroutine_frame_pool::binding frame_binding(frames);
+            task_ = run();
+        }
+    }
+
+    bool is_valid() const noexcept override { return static_cast<bool>(task_); }
+
+    void tick(TimestampNs now_ns_value) override {
+        if (!refresh_parent_state()) {
+            sync_parent_view();
+            return;
+        }
+        if (failed_) {
+            terminal_ = true;
+            sync_parent_view();
+            return;
+        }
+        // 撤单后不再发新片，等在途子单全部终态
+        if (cancel_requested_) {
+            finalize_parent_if_idle();
+            if (!terminal_) {
+                sync_parent_view();
+            }
+            return;
+        }
+
+        now_ns_ = now_ns_value;
+        task_.resume();
+        if (terminal_) {
+            return;
+        }
+        if (task_.done()) {
+            terminal_ = true;
+        }
+        sync_parent_view();
+    }
+
+    // 撤单中只等回报；其余按协程最近一次挂起时声明的时间推进
+    TimestampNs next_wakeup_ns(TimestampNs now_ns_value) const noexcept override {
+        if (terminal_ || failed_) {
+            return now_ns_value;
+        }
+        if (cancel_requested_) {
+            return has_working_children() ? kWakeOnEvent : now_ns_value;
+        }
+        return task_.wake_ns();
+    }
+
+    bool watches_market_data() const noexcept override {
+        return active_strategy_ != nullptr && market_data_service_ != nullptr && market_data_handle_.is_valid();
+    }
+
+protected:
+    void export_progress(execution_session_checkpoint& out) const override {
+        out.start_time_ns = start_time_ns_;
+        out.slice_index = static_cast<uint32_t>(slice_index_);
+        out.slice_consumed = slice_consumed_;
+    }
+
+    // 恢复发生在协程首次 resume 之前，协程从装回的片进度开始执行。
+    void restore_progress(const execution_session_checkpoint& state) override {
+        slice_index_ = std::min<std::size_t>(state.slice_index, slice_plan_.size());
+        slice_consumed_ = state.slice_consumed;
+    }
+
+    Volume active_budget_volume() const noexcept override {
+        if (cancel_requested_ || slice_consumed_) {
+            return 0;
+        }
+        return current_budget_volume();
+    }
+
+private:
+    Volume current_budget_volume() const noexcept {
+        if (slice_index_ >= slice_plan_.size()) {
+            return 0;
+        }
+        return std::min<Volume>(slice_plan_[slice_index_].volume, schedulable_volume());
+    }
+
+    // 逐片执行：片内每次恢复先给主动策略一次机会，到片时点回落被动片额；本片子单全部终态后进入下一片。
+    // 剩余目标已全部成交时提前结束
+    session_task run() {
+        for (; slice_index_ < slice_plan_.size(); ++slice_index_) {
+            const TimestampNs deadline_ns = slice_plan_[slice_index_].deadline_ns;
+            while (!slice_consumed_) {
+                const Volume budget_volume = current_budget_volume();
+                if (budget_volume == 0) {
+                    if (!has_working_children()) {
+                        co_return;
+                    }
+                    co_await session_wait{kWakeOnEvent};
+                    continue;
+                }
+
+                const MarketDataView* market_data_view = nullptr;
+                DPrice market_price = 0;
+                submit_price_trace_context price_trace_context{};
+                if (resolve_submit_price(market_data_view, market_price, price_trace_context)) {
+                    if (market_data_view) {
+                        slice_consumed_ =
+                            try_active_submit(*market_data_view, market_price, budget_volume, price_trace_context);
+                    }
+                    if (!slice_consumed_ && now_ns_ >= deadline_ns) {
+                        slice_consumed_ = submit_child(budget_volume, market_price, false, price_trace_context);
+                    }
+                    if (terminal_) {
+                        co_return;
+                    }
+                }
+                if (!slice_consumed_) {
+                    // 无法观察行情的主动策略逐轮评估，其余停到片时点，行情前进可提前唤醒
+                    co_await session_wait{active_strategy_ && !watches_market_data() ? now_ns_ : deadline_ns};
+                }
+            }
+            while (has_working_children()) {
+                co_await session_wait{kWakeOnEvent};
+            }
+            slice_consumed_ = false;
+            last_active_publish_seq_no_ = 0;
+        }
+        while (has_working_children()) {
+            co_await session_wait{kWakeOnEvent};
+        }
+    }
+
+    TimestampNs start_time_ns_ = 0;
+    TimestampNs now_ns_ = 0;  // 本次 tick 的时刻，协程恢复后读取
+    std::size_t slice_index_ = 0;
+    bool slice_consumed_ = false;
+    std::vector<slice_plan_entry>& slice_plan_;  // 即 ledger_store.slice_plan，容量随池槽位保留
+    session_task task_;                          // 帧在 coroutine_frame_pool 槽位上，随会话析构归还
+};
+
+// 执行会话池：按 split.max_sessions 一次性预留全部会话的定长槽位，会话在槽位上原位构造；
+// 回收时原位析构并清空槽位的账本存储（保留容量），会话启停不再经过堆分配器。
+class execution_session_pool {
+public:
+    execution_session_pool(uint32_t capacity, bool huge_pages)
+        : capacity_(std::max<uint32_t>(capacity, 1)),
+          slots_(capacity_, huge_pages, "execution.session_slots"),
+          stores_(std::make_unique<child_ledger_store[]>(capacity_)) {
+        free_slots_.reserve(capacity_);
+        for (uint32_t slot = capacity_; slot > 0; --slot) {
+            free_slots_.push_back(slot - 1);
+        }
+    }
+
+    execution_session_pool(const execution_session_pool&) = delete;
+    execution_session_pool& operator=(const execution_session_pool&) = delete;
+
+    bool exhausted() const noexcept { return free_slots_.empty(); }
+    std::size_t capacity() const noexcept { return capacity_; }
+    std::size_t in_use() const noexcept { return capacity_ - free_slots_.size(); }
+    // 尚可创建的会话数，批量启动前一次性判断余量。
+    std::size_t available() const noexcept { return free_slots_.size(); }
+    slice_plan_scratch& scratch() noexcept { return scratch_; }
+
+    // 会话槽位与各槽位账本存储的占用，逐槽位累加（冷路径，按统计节拍调用）
+    memory_usage memory() const noexcept {
+        memory_usage usage = slots_.memory(in_use());
+        usage += element_memory(capacity_, in_use(), sizeof(child_ledger_store));
+        for (uint32_t slot = 0; slot < capacity_; ++slot) {
+            usage += stores_[slot].memory();
+        }
+        usage += element_memory(free_slots_.capacity(), free_slots_.size(), sizeof(uint32_t));
+        return usage;
+    }
+
+    // 取最近回收的槽位构造会话（账本容量与缓存都是热的）；池满返回空。
+    template <typename Session, typename... Args>
+    pooled_execution_session emplace(Args&&... args) {
+        static_assert(sizeof(Session) <= sizeof(session_storage) && alignof(Session) <= alignof(session_storage),
+                      "session type exceeds pooled slot");
+        if (free_slots_.empty()) {
+            return pooled_execution_session{};
+        }
+        const uint32_t slot = free_slots_.back();
+        free_slots_.pop_back();
+        ExecutionSession* session =
+            ::new (static_cast<void*>(slots_[slot].bytes)) Session(stores_[slot], std::forward<Args>(args)...);
+        return pooled_execution_session{session, execution_session_releaser{this}};
+    }
+
+    // 析构会话并把槽位归还空闲栈；槽位由会话持有的账本存储反推。
+    void release(ExecutionSession* session) noexcept {
+        child_ledger_store& store = session->ledger_store();
+        const auto slot = static_cast<uint32_t>(&store - stores_.get());
+        session->~ExecutionSession();
+        store.reset();
+        free_slots_.push_back(slot);
+    }
+
+private:
+    static constexpr std::size_t kSlotSize = std::max({sizeof(FixedSizeSession), sizeof(IcebergSession),
+                                                       sizeof(TwapSession), sizeof(VwapSession),
+                                                       sizeof(CoroutineSliceSession)});
+    static constexpr std::size_t kSlotAlign = std::max({alignof(FixedSizeSession), alignof(IcebergSession),
+                                                        alignof(TwapSession), alignof(VwapSession),
+                                                        alignof(CoroutineSliceSession)});
+
+    struct alignas(kSlotAlign) session_storage {
+        unsigned char bytes[kSlotSize];
+    };
+
+    uint32_t capacity_;
+    lazy_array<session_storage> slots_;             // 会话原位构造的裸存储，槽位首次取用时才落页
+    std::unique_ptr<child_ledger_store[]> stores_;  // 与 slots_ 按下标对应
+    std::vector<uint32_t> free_slots_;              // 空闲槽位栈，容量构造时预留
+    slice_plan_scratch scratch_;                    // 计划生成缓冲，会话构造期间临时使用
 };
 
-// 用统一执行会话工厂创建具体的被动算法实现。
-std::unique_ptr<ExecutionSession> create_execution_session(
-    const split_config& split_config, OrderIndex parent_index, const OrderRequest& parent_request,
-    StrategyId strategy_id, TimestampNs start_time_ns, OrderBook& order_book, order_router& order_router,
-    MarketDataService* market_data_service, OrderEventRecorder* order_event_recorder, ActiveStrategy* active_strategy) {
+void execution_session_releaser::operator()(ExecutionSession* session) const noexcept { pool->release(session); }
+
+// 用统一执行会话工厂在会话池上创建具体的被动算法实现；池满或缺少依赖时返回空。
+// frames 非空时 TWAP / VWAP 改用协程会话。
+pooled_execution_session create_execution_session(
+    execution_session_pool& pool, coroutine_frame_pool* frames, const split_config& split_config,
+    OrderIndex parent_index, const OrderRequest& parent_request, StrategyId strategy_id, TimestampNs start_time_ns,
+    OrderBook& order_book, order_router& order_router, MarketDataService* market_data_service,
+    OrderEventRecorder* order_event_recorder, ActiveStrategy* active_strategy, const volume_profile* volume_profile) {
     const SplitStrategy strategy = resolve_execution_strategy(parent_request, split_config);
+    if (frames && (strategy == SplitStrategy::TWAP || strategy == SplitStrategy::VWAP)) {
+        if (strategy == SplitStrategy::VWAP && !volume_profile) {
+            return pooled_execution_session{};
+        }
+        return pool.emplace<CoroutineSliceSession>(
+            parent_index, parent_request, strategy_id, split_strategy_to_passive_execution_algo(strategy),
+            split_config, start_time_ns, volume_profile, pool.scratch(), *frames, order_book, order_router,
+            market_data_service, order_event_recorder, active_strategy);
+    }
     switch (strategy) {
         case SplitStrategy::FixedSize:
-            return std::make_unique<FixedSizeSession>(parent_index, parent_request, strategy_id, split_config,
-                                                      order_book, order_router, market_data_service,
-                                                      order_event_recorder, active_strategy);
+            return pool.emplace<FixedSizeSession>(parent_index, parent_request, strategy_id, split_config, order_book,
+                                                  order_router, market_data_service, order_event_recorder,
+                                                  active_strategy);
         case SplitStrategy::Iceberg:
-            return std::make_unique<IcebergSession>(parent_index, parent_request, strategy_id, split_config, order_book,
-                                                    order_router, market_data_service, order_event_recorder,
-                                                    active_strategy);
+            return pool.emplace<IcebergSession>(parent_index, parent_request, strategy_id, split_config, order_book,
+                                                order_router, market_data_service, order_event_recorder,
+                                                active_strategy);
         case SplitStrategy::TWAP:
-            return std::make_unique<TwapSession>(parent_index, parent_request, strategy_id, split_config, start_time_ns,
-                                                 order_book, order_router, market_data_service, order_event_recorder,
-                                                 active_strategy);
+            return pool.emplace<TwapSession>(parent_index, parent_request, strategy_id, split_config, start_time_ns,
+                                             order_book, order_router, market_data_service, order_event_recorder,
+                                             active_strategy);
         case SplitStrategy::VWAP:
+            if (!volume_profile) {
+                return pooled_execution_session{};
+            }
+            return pool.emplace<VwapSession>(parent_index, parent_request, strategy_id, split_config, start_time_ns,
+                                             *volume_profile, pool.scratch(), order_book, order_router,
+                                             market_data_service, order_event_recorder, active_strategy);
         case SplitStrategy::None:
         default:
-            return nullptr;
+            return pooled_execution_session{};
     }
 }
 
 ExecutionEngine::ExecutionEngine(const split_config& split_config, OrderBook& order_book, order_router& order_router,
                                  MarketDataService* market_data_service, OrderEventRecorder* order_event_recorder,
-                                 std::unique_ptr<ActiveStrategy> active_strategy)
+                                 std::unique_ptr<ActiveStrategy> active_strategy,
+                                 const volume_profile* volume_profile, bool huge_pages)
     : split_config_(split_config),
       order_book_(order_book),
       order_router_(order_router),
       market_data_service_(market_data_service),
       order_event_recorder_(order_event_recorder),
-      active_strategy_(std::move(active_strategy)) {}
+      active_strategy_(std::move(active_strategy)),
+      volume_profile_(volume_profile),
+      frame_pool_(split_config.coroutine_sessions
+                      ? std::make_unique<coroutine_frame_pool>(split_config.max_sessions, huge_pages)
+                      : nullptr),
+      session_pool_(std::make_unique<execution_session_pool>(split_config.max_sessions, huge_pages)),
+      sessions_(session_pool_->capacity() * 2),
+      view_cache_(market_data_service),
+      child_risk_(split_config) {
+    retired_.reserve(session_pool_->capacity());
+    if (active_strategy_ && split_config.eval_workers > 0) {
+        eval_pool_ = std::make_unique<active_eval_pool>(*active_strategy_, split_config.eval_workers);
+    }
+}
 
 ExecutionEngine::~ExecutionEngine() = default;
 
+std::size_t ExecutionEngine::session_capacity() const noexcept { return session_pool_->capacity(); }
+
+memory_usage ExecutionEngine::memory() const noexcept {
+    memory_usage usage = session_pool_->memory();
+    usage += sessions_.memory();
+    usage += element_memory(retired_.capacity(), retired_.size(), sizeof(pooled_execution_session));
+    usage += element_memory(ready_.capacity(), ready_.size(), sizeof(InternalOrderId));
+    usage += element_memory(ticking_.capacity(), ticking_.size(), sizeof(InternalOrderId));
+    usage += element_memory(refills_.capacity(), refills_.size(), sizeof(InternalOrderId));
+    return usage;
+}
+
+std::size_t ExecutionEngine::coroutine_frames_in_use() const noexcept {
+    return frame_pool_ ? frame_pool_->in_use() : 0;
+}
+
+uint64_t ExecutionEngine::coroutine_frame_fallbacks() const noexcept {
+    return frame_pool_ ? frame_pool_->heap_fallbacks() : 0;
+}
+
 // 所有显式执行算法都统一进入执行引擎，不再回退旧的一次性 splitter 运行时路径。
 bool ExecutionEngine::should_manage(const OrderRequest& request) const noexcept {
     if (request.order_type != OrderType::New) {
@@ -994,10 +1825,55 @@ bool ExecutionEngine::should_manage(const OrderRequest& request) const noexcept
 
 bool ExecutionEngine::has_active_strategy() const noexcept { return active_strategy_ != nullptr; }
 
-// 为父单创建统一执行会话，VWAP 明确拒绝，运行时无法满足拆单约束时返回不可拆单。
+const SymbolFeatureStore& ExecutionEngine::feature_store() const noexcept { return feature_store_; }
+
+// 为父单创建统一执行会话，VWAP 缺少该证券成交量分布时拒绝，运行时无法满足拆单约束时返回不可拆单。
 ExecutionEngine::SessionStartResult ExecutionEngine::start_session(OrderIndex parent_index,
                                                                    const OrderRequest& parent_request,
                                                                    StrategyId strategy_id, TimestampNs start_time_ns) {
+    view_cache_.begin_tick();
+    return start_one_session(parent_index, parent_request, strategy_id, start_time_ns, market_data_usable());
+}
+
+// 篮子各腿共用同一轮行情可用性判断与会话池的计划生成缓冲，逐腿只做与父单相关的校验和计划生成。
+std::size_t ExecutionEngine::start_sessions(std::span<const session_start_request> requests,
+                                            std::span<SessionStartResult> out_results) {
+    const std::size_t count = std::min(requests.size(), out_results.size());
+    const bool market_data_ok = market_data_usable();
+    // 各腿首轮推进前按证券去重一次读完快照，同证券的腿共享视图
+    view_cache_.begin_tick();
+    if (market_data_ok && market_data_service_ && market_data_service_->is_ready()) {
+        basket_handles_.clear();
+        for (std::size_t i = 0; i < count; ++i) {
+            basket_handles_.push_back(
+                market_data_service_->resolve(requests[i].parent_request->internal_security_id.view()));
+        }
+        view_cache_.prefetch(basket_handles_);
+    }
+    std::size_t started = 0;
+    for (std::size_t i = 0; i < count; ++i) {
+        const session_start_request& request = requests[i];
+        out_results[i] = start_one_session(request.parent_index, *request.parent_request, request.strategy_id,
+                                           request.start_time_ns, market_data_ok);
+        if (out_results[i] == SessionStartResult::Started) {
+            ++started;
+        }
+    }
+    return started;
+}
+
+bool ExecutionEngine::market_data_usable() const noexcept {
+    if (!market_data_service_) {
+        return false;
+    }
+    return market_data_service_->is_ready() || market_data_service_->allow_order_price_fallback();
+}
+
+ExecutionEngine::SessionStartResult ExecutionEngine::start_one_session(OrderIndex parent_index,
+                                                                       const OrderRequest& parent_request,
+                                                                       StrategyId strategy_id,
+                                                                       TimestampNs start_time_ns,
+                                                                       bool market_data_ok) {
     if (!should_manage(parent_request)) {
         if (order_event_recorder_) {
             order_event_recorder_->record_session_start_rejected(parent_request, strategy_id,
@@ -1005,7 +1881,7 @@ ExecutionEngine::SessionStartResult ExecutionEngine::start_session(OrderIndex pa
         }
         return SessionStartResult::InvalidConfig;
     }
-    if (sessions_.find(parent_request.internal_order_id) != sessions_.end()) {
+    if (sessions_.contains(parent_request.internal_order_id)) {
         if (order_event_recorder_) {
             order_event_recorder_->record_session_start_rejected(parent_request, strategy_id,
                                                                  PassiveExecutionAlgo::None, "duplicate_session");
@@ -1022,20 +1898,37 @@ ExecutionEngine::SessionStartResult ExecutionEngine::start_session(OrderIndex pa
         }
         return SessionStartResult::Unsupported;
     }
-    const bool market_data_ready = market_data_service_ != nullptr && market_data_service_->is_ready();
-    const bool allow_order_price_fallback =
-        market_data_service_ != nullptr && market_data_service_->allow_order_price_fallback();
-    if (!market_data_ready && !allow_order_price_fallback) {
+    if (strategy == SplitStrategy::VWAP &&
+        (!volume_profile_ || !volume_profile_->find(parent_request.internal_security_id.view()))) {
+        if (order_event_recorder_) {
+            order_event_recorder_->record_session_start_rejected(parent_request, strategy_id, execution_algo,
+                                                                 "volume_profile_unavailable");
+        }
+        return SessionStartResult::VolumeProfileUnavailable;
+    }
+    if (!market_data_ok) {
         if (order_event_recorder_) {
             order_event_recorder_->record_session_start_rejected(parent_request, strategy_id, execution_algo,
                                                                  "market_data_unavailable");
         }
         return SessionStartResult::MarketDataUnavailable;
     }
+    if (session_pool_->exhausted()) {
+        // 池满时先当场回收一个待回收会话，只有确实全部在管时才拒绝
+        reclaim_retired(1);
+    }
+    if (session_pool_->exhausted()) {
+        if (order_event_recorder_) {
+            order_event_recorder_->record_session_start_rejected(parent_request, strategy_id, execution_algo,
+                                                                 "session_pool_exhausted");
+        }
+        return SessionStartResult::PoolExhausted;
+    }
 
-    std::unique_ptr<ExecutionSession> session =
-        create_execution_session(split_config_, parent_index, parent_request, strategy_id, start_time_ns, order_book_,
-                                 order_router_, market_data_service_, order_event_recorder_, active_strategy_.get());
+    pooled_execution_session session =
+        create_execution_session(*session_pool_, frame_pool_.get(), split_config_, parent_index, parent_request,
+                                 strategy_id, start_time_ns, order_book_, order_router_, market_data_service_,
+                                 order_event_recorder_, active_strategy_.get(), volume_profile_);
     if (!session) {
         if (order_event_recorder_) {
             order_event_recorder_->record_session_start_rejected(parent_request, strategy_id, execution_algo,
@@ -1059,48 +1952,308 @@ ExecutionEngine::SessionStartResult ExecutionEngine::start_session(OrderIndex pa
         return SessionStartResult::InvalidConfig;
     }
 
-    sessions_.emplace(parent_request.internal_order_id, std::move(session));
+    // 表容量为池容量的两倍，池未满时插入不会失败
+    const InternalOrderId parent_order_id = parent_request.internal_order_id;
+    session_slot& slot = *sessions_.try_emplace(parent_order_id);
+    slot.session = std::move(session);
+    slot.session->attach_view_cache(&view_cache_);
+    slot.session->attach_feature_store(&feature_store_);
+    slot.session->attach_child_risk(child_risk_.enabled() ? &child_risk_ : nullptr);
+    watch_market_data(parent_order_id, slot);
     if (order_event_recorder_) {
         order_event_recorder_->record_session_started(parent_request, strategy_id, execution_algo);
     }
-    sessions_.at(parent_request.internal_order_id)->tick(start_time_ns);
+    slot.session->tick(start_time_ns);
+    slot.session->clear_prefetch();
+    schedule_session(parent_order_id, slot, start_time_ns);
     return SessionStartResult::Started;
 }
 
-// 推进所有活跃会话，并在终态后及时回收会话对象。
-void ExecutionEngine::tick(TimestampNs now_ns_value) {
-    std::vector<InternalOrderId> finished_sessions;
-    finished_sessions.reserve(sessions_.size());
+void ExecutionEngine::export_checkpoint(std::vector<execution_session_checkpoint>& out_sessions,
+                                        std::vector<execution_child_checkpoint>& out_children) const {
+    out_sessions.clear();
+    out_children.clear();
+    out_sessions.reserve(sessions_.size());
+    sessions_.for_each([&out_sessions, &out_children](InternalOrderId parent_order_id, const session_slot& slot) {
+        (void)parent_order_id;
+        if (!slot.session || slot.session->is_terminal()) {
+            return;
+        }
+        execution_session_checkpoint state{};
+        slot.session->export_checkpoint(state, out_children);
+        out_sessions.push_back(state);
+    });
+}
+
+// 重建的会话直接入就绪队列，由下一轮 tick 按对账后的账本继续推进，不重放 start_session 的首轮 tick。
+std::size_t ExecutionEngine::restore_checkpoint(const std::vector<execution_session_checkpoint>& sessions,
+                                                const std::vector<execution_child_checkpoint>& children) {
+    std::size_t restored = 0;
+    for (const execution_session_checkpoint& state : sessions) {
+        if (static_cast<std::size_t>(state.child_begin) + state.child_count > children.size() ||
+            sessions_.contains(state.parent_order_id)) {
+            continue;
+        }
+        const OrderEntry* parent = order_book_.find_order(state.parent_order_id);
+        if (!parent || parent->is_terminal() || !should_manage(parent->request)) {
+            continue;
+        }
+
+        const OrderRequest parent_request = parent->request;
+        if (session_pool_->exhausted()) {
+            reclaim_retired(1);
+        }
+        pooled_execution_session session = create_execution_session(
+            *session_pool_, frame_pool_.get(), split_config_, state.parent_index, parent_request, state.strategy_id,
+            state.start_time_ns, order_book_, order_router_, market_data_service_, order_event_recorder_,
+            active_strategy_.get(), volume_profile_);
+        if (!session || !session->is_valid() || !order_book_.mark_managed_parent(state.parent_order_id)) {
+            ACCT_LOG_WARN("ExecutionEngine", "skipped checkpointed session that can no longer be rebuilt");
+            continue;
+        }
+        session->restore_checkpoint(state, children.data() + state.child_begin);
+
+        session_slot& slot = *sessions_.try_emplace(state.parent_order_id);
+        slot.session = std::move(session);
+        slot.session->attach_view_cache(&view_cache_);
+        slot.session->attach_feature_store(&feature_store_);
+        slot.session->attach_child_risk(child_risk_.enabled() ? &child_risk_ : nullptr);
+        watch_market_data(state.parent_order_id, slot);
+        wake_session(state.parent_order_id, slot);
+        ++restored;
+    }
+    return restored;
+}
+
+// 行情前进与到期定时器先转入就绪队列，再只推进本轮就绪会话；同证券会话共享本轮一次快照读取，终态会话移入待回收列表，
+// 末尾最多归还 kRetiredReclaimPerTick 个，收盘集中终态时清理开销摊到后续各轮。
+std::size_t ExecutionEngine::tick(TimestampNs now_ns_value) {
+    // 未被 replenish_clips() 当场推进的补单会话转入就绪队列，由本轮照常推进
+    for (InternalOrderId parent_order_id : refills_) {
+        if (session_slot* slot = sessions_.find(parent_order_id)) {
+            wake_session(parent_order_id, *slot);
+        }
+    }
+    refills_.clear();
+    view_cache_.begin_tick();
+    poll_market_data();
+    wakeups_.advance(now_ns_value, [this](InternalOrderId parent_order_id) {
+        session_slot* slot = sessions_.find(parent_order_id);
+        if (slot) {
+            slot->wakeup = kInvalidTimerId;
+            wake_session(parent_order_id, *slot);
+        }
+    });
+
+    // 交换后推进期间产生的唤醒进入新的 ready_，留到下一轮处理
+    ticking_.swap(ready_);
+    evaluate_active_batch();
+    for (InternalOrderId parent_order_id : ticking_) {
+        session_slot* found = sessions_.find(parent_order_id);
+        if (!found) {
+            continue;
+        }
+        found->queued = false;
+        advance_session(parent_order_id, *found, now_ns_value);
+    }
+    const std::size_t ticked = ticking_.size();
+    ticking_.clear();
+    reclaim_retired(kRetiredReclaimPerTick);
+    return ticked;
+}
+
+void ExecutionEngine::flush_refills(TimestampNs now_ns_value) {
+    view_cache_.begin_tick();
+    for (InternalOrderId parent_order_id : refills_) {
+        session_slot* slot = sessions_.find(parent_order_id);
+        if (slot) {
+            advance_session(parent_order_id, *slot, now_ns_value);
+        }
+    }
+    refills_.clear();
+}
+
+// 推进单个会话一次：终态时撤定时器、退订行情，会话移入待回收列表后删除槽位，否则按下一次推进时间重新登记。
+void ExecutionEngine::advance_session(InternalOrderId parent_order_id, session_slot& slot, TimestampNs now_ns_value) {
+    if (!slot.session) {
+        (void)sessions_.erase(parent_order_id);
+        return;
+    }
+
+    slot.session->tick(now_ns_value);
+    slot.session->clear_prefetch();
+    if (slot.session->is_terminal()) {
+        (void)wakeups_.cancel(slot.wakeup);
+        unwatch_market_data(parent_order_id, slot);
+        // 会话的析构与账本清理推迟到 tick 末尾分批进行；回移删除会挪动其他条目，此后不再持有任何 slot 引用
+        retired_.push_back(std::move(slot.session));
+        (void)sessions_.erase(parent_order_id);
+        return;
+    }
+    schedule_session(parent_order_id, slot, now_ns_value);
+}
+
+// 后终态的会话先回收：账本存储与会话槽位仍在缓存中，且与会话池“取最近回收槽位”的顺序一致。
+void ExecutionEngine::reclaim_retired(std::size_t max_sessions) noexcept {
+    for (; max_sessions > 0 && !retired_.empty(); --max_sessions) {
+        retired_.pop_back();
+    }
+}
 
-    for (auto& [parent_order_id, session] : sessions_) {
-        if (!session) {
-            finished_sessions.push_back(parent_order_id);
+// 下一次推进时间不晚于当前时刻时留在就绪队列，晚于当前时刻时挂入时间轮，等待事件时两者皆不登记。
+void ExecutionEngine::schedule_session(InternalOrderId parent_order_id, session_slot& slot,
+                                       TimestampNs now_ns_value) {
+    if (slot.queued) {
+        return;
+    }
+    const TimestampNs wakeup_ns = slot.session->next_wakeup_ns(now_ns_value);
+    if (wakeup_ns == kWakeOnEvent) {
+        return;
+    }
+    if (wakeup_ns > now_ns_value) {
+        slot.wakeup = wakeups_.schedule(now_ns_value, wakeup_ns, parent_order_id);
+        return;
+    }
+    wake_session(parent_order_id, slot);
+}
+
+// 每个行情槽位只登记一次服务侧观察，槽位下挂全部观察该证券的会话。
+void ExecutionEngine::watch_market_data(InternalOrderId parent_order_id, session_slot& slot) {
+    if (!market_data_service_ || !slot.session->watches_market_data()) {
+        return;
+    }
+    slot.market_data = slot.session->market_data_handle();
+    if (market_data_watchers_.size() <= slot.market_data.slot) {
+        market_data_watchers_.resize(slot.market_data.slot + 1);
+    }
+    std::vector<InternalOrderId>& watchers = market_data_watchers_[slot.market_data.slot];
+    if (watchers.empty()) {
+        market_data_service_->watch(slot.market_data);
+    }
+    watchers.push_back(parent_order_id);
+}
+
+void ExecutionEngine::unwatch_market_data(InternalOrderId parent_order_id, session_slot& slot) noexcept {
+    if (!slot.market_data.is_valid()) {
+        return;
+    }
+    std::vector<InternalOrderId>& watchers = market_data_watchers_[slot.market_data.slot];
+    const auto it = std::find(watchers.begin(), watchers.end(), parent_order_id);
+    if (it != watchers.end()) {
+        *it = watchers.back();
+        watchers.pop_back();
+    }
+    if (watchers.empty()) {
+        market_data_service_->unwatch(slot.market_data);
+    }
+    slot.market_data = MarketDataHandle{};
+}
+
+// 本轮就绪会话中有主动评估机会的父单一次交给 evaluate_many()，各会话 tick 时消费对应决策。
+void ExecutionEngine::evaluate_active_batch() {
+    if (!active_strategy_) {
+        return;
+    }
+    active_batch_sessions_.clear();
+    active_batch_contexts_.clear();
+    for (InternalOrderId parent_order_id : ticking_) {
+        const session_slot* slot = sessions_.find(parent_order_id);
+        if (!slot || !slot->session) {
             continue;
         }
+        ExecutionSession& session = *slot->session;
+        Volume budget_volume = 0;
+        if (session.collect_active_candidate(budget_volume)) {
+            active_batch_sessions_.push_back(&session);
+            const MarketDataView& view = session.prefetched_view();
+            active_batch_contexts_.push_back(ActiveStrategyContext{session.parent_request(), view, budget_volume,
+                                                                   session.update_features(view)});
+        }
+    }
+    if (active_batch_sessions_.empty()) {
+        return;
+    }
 
-        session->tick(now_ns_value);
-        if (session->is_terminal()) {
-            finished_sessions.push_back(parent_order_id);
+    active_batch_decisions_.assign(active_batch_sessions_.size(), ActiveDecision{});
+    if (eval_pool_) {
+        eval_pool_->evaluate(active_batch_contexts_, active_batch_decisions_);
+    } else {
+        active_strategy_->evaluate_many(active_batch_contexts_, active_batch_decisions_);
+    }
+    for (std::size_t i = 0; i < active_batch_sessions_.size(); ++i) {
+        active_batch_sessions_[i]->set_prefetched_active_decision(active_batch_decisions_[i]);
+    }
+}
+
+// 一次批量检查全部被观察证券，只唤醒证券行情前进的会话。
+void ExecutionEngine::poll_market_data() {
+    if (!market_data_service_ || market_data_watchers_.empty()) {
+        return;
+    }
+    advanced_market_data_.clear();
+    if (market_data_service_->poll_updates(advanced_market_data_) == 0) {
+        return;
+    }
+    for (MarketDataHandle handle : advanced_market_data_) {
+        for (InternalOrderId parent_order_id : market_data_watchers_[handle.slot]) {
+            session_slot* slot = sessions_.find(parent_order_id);
+            if (slot) {
+                wake_session(parent_order_id, *slot);
+            }
         }
     }
+}
 
-    for (InternalOrderId parent_order_id : finished_sessions) {
-        sessions_.erase(parent_order_id);
+void ExecutionEngine::wake_session(InternalOrderId parent_order_id, session_slot& slot) noexcept {
+    if (slot.wakeup != kInvalidTimerId) {
+        (void)wakeups_.cancel(slot.wakeup);
+        slot.wakeup = kInvalidTimerId;
+    }
+    if (slot.queued) {
+        return;
     }
+    slot.queued = true;
+    ready_.push_back(parent_order_id);
 }
 
-// 把子单回报路由回所属会话，用统一账本释放预算并刷新父单镜像。
+// 把子单回报路由回所属会话，用统一账本释放预算，再唤醒会话刷新父单镜像。
 void ExecutionEngine::on_trade_response(const TradeResponse& response) noexcept {
     InternalOrderId parent_order_id = 0;
     if (!order_book_.try_get_parent(response.internal_order_id, parent_order_id)) {
         return;
     }
 
-    const auto session_it = sessions_.find(parent_order_id);
-    if (session_it == sessions_.end() || !session_it->second) {
+    session_slot* slot = sessions_.find(parent_order_id);
+    if (!slot || !slot->session) {
         return;
     }
-    session_it->second->on_trade_response(response);
+    slot->session->on_trade_response(response);
+    // 补单会话先记下，由 replenish_clips() 当场推进；已在就绪队列中的仍留在队列，tick 时再同步一次镜像
+    if (slot->session->refills_on_response()) {
+        if (slot->wakeup != kInvalidTimerId) {
+            (void)wakeups_.cancel(slot->wakeup);
+            slot->wakeup = kInvalidTimerId;
+        }
+        refills_.push_back(parent_order_id);
+        return;
+    }
+    wake_session(parent_order_id, *slot);
+}
+
+// 撤单可能针对父单本身或其子单，两种情况都唤醒所属会话。
+void ExecutionEngine::on_cancel_routed(InternalOrderId orig_order_id) noexcept {
+    InternalOrderId parent_order_id = orig_order_id;
+    session_slot* slot = sessions_.find(parent_order_id);
+    if (!slot) {
+        if (!order_book_.try_get_parent(orig_order_id, parent_order_id)) {
+            return;
+        }
+        slot = sessions_.find(parent_order_id);
+        if (!slot) {
+            return;
+        }
+    }
+    wake_session(parent_order_id, *slot);
 }
 
 }  // namespace acct_service
@@ -1,9 +1,16 @@
 #pragma once
 
 #include <memory>
-#include <unordered_map>
+#include <span>
+#include <vector>
 
+#include "common/flat_hash_map.hpp"
+#include "common/memory_accounting.hpp"
+#include "common/timer_wheel.hpp"
+
+#include "execution/child_risk_guard.hpp"
 #include "execution/execution_config.hpp"
+#include "execution/volume_profile.hpp"
 #include "market_data/market_data_service.hpp"
 #include "order/order_book.hpp"
 #include "order/order_event_recorder.hpp"
@@ -13,8 +20,55 @@
 namespace acct_service {
 
 class ExecutionSession;
+class execution_session_pool;
+class coroutine_frame_pool;
+class active_eval_pool;
+
+// 会话归还会话池：原位析构后回收槽位，不经过堆分配器。
+struct execution_session_releaser {
+    execution_session_pool* pool = nullptr;
+    void operator()(ExecutionSession* session) const noexcept;
+};
+
+using pooled_execution_session = std::unique_ptr<ExecutionSession, execution_session_releaser>;
+
+// 子单账本检查点：与会话内 child ledger 逐字段对应。
+struct execution_child_checkpoint {
+    InternalOrderId child_order_id = 0;
+    OrderIndex shm_order_index = kInvalidOrderIndex;
+    Volume entrust_volume = 0;
+    DPrice entrust_price = 0;
+    Volume confirmed_traded_volume = 0;
+    DValue confirmed_traded_value = 0;
+    DValue confirmed_fee = 0;
+    Volume final_cancelled_volume = 0;
+    OrderState order_state = OrderState::NotSet;
+    bool finalized = false;
+    bool cancel_requested = false;
+};
+
+// 执行会话检查点：重建会话所需的调度进度；账本为 children 数组中 [child_begin, child_begin + child_count)。
+struct execution_session_checkpoint {
+    InternalOrderId parent_order_id = 0;
+    OrderIndex parent_index = kInvalidOrderIndex;
+    StrategyId strategy_id = 0;
+    bool failed = false;
+    bool slice_consumed = false;
+    uint32_t slice_index = 0;
+    TimestampNs start_time_ns = 0;  // 时间片会话的计划起点，同配置下按它重建出同一份计划
+    uint32_t child_begin = 0;
+    uint32_t child_count = 0;
+};
+
+// 篮子批量启动中的一条受管父单；parent_request 在 start_sessions() 返回前须保持有效。
+struct session_start_request {
+    OrderIndex parent_index = kInvalidOrderIndex;
+    const OrderRequest* parent_request = nullptr;
+    StrategyId strategy_id = 0;
+    TimestampNs start_time_ns = 0;
+};
 
-// 长期执行引擎：首版只托管需要时间片推进的 TWAP 父单。
+// 长期执行引擎：托管 FixedSize / Iceberg 顺序 clip 与 TWAP / VWAP 时间片父单。
 class ExecutionEngine {
 public:
     enum class SessionStartResult : uint8_t {
@@ -24,11 +78,16 @@ public:
         Duplicate = 3,
         MarketDataUnavailable = 4,
         Unsplittable = 5,
+        VolumeProfileUnavailable = 6,
+        PoolExhausted = 7,
     };
 
+    // volume_profile 为空时 VWAP 父单以 VolumeProfileUnavailable 拒绝；会话池按 split_config.max_sessions 预留，
+    // 会话槽位经 huge_page_arena 惰性映射，huge_pages 为 true 时以大页承载。
     ExecutionEngine(const split_config& split_config, OrderBook& order_book, order_router& order_router,
                     MarketDataService* market_data_service, OrderEventRecorder* order_event_recorder,
-                    std::unique_ptr<ActiveStrategy> active_strategy);
+                    std::unique_ptr<ActiveStrategy> active_strategy, const volume_profile* volume_profile = nullptr,
+                    bool huge_pages = false);
     ~ExecutionEngine();
 
     ExecutionEngine(const ExecutionEngine&) = delete;
@@ -40,24 +99,134 @@ public:
     // 当前服务是否启用了可发主动子单的覆盖策略。
     bool has_active_strategy() const noexcept;
 
+    // 主动策略评估用的证券增量特征表（只读，供观测与测试）
+    const SymbolFeatureStore& feature_store() const noexcept;
+
     // 为受管父单创建执行会话；调用方根据结果决定拒绝还是错误。
     SessionStartResult start_session(OrderIndex parent_index, const OrderRequest& parent_request,
                                      StrategyId strategy_id, TimestampNs start_time_ns);
 
-    // 推进所有活跃会话：先尝试主动覆盖，再在应发时点回落到被动 TWAP。
-    void tick(TimestampNs now_ns_value);
+    // 篮子批量启动：行情可用性只判断一次，各腿按顺序创建并完成首轮推进；
+    // out_results 与 requests 按下标对应，返回成功启动的会话数。
+    std::size_t start_sessions(std::span<const session_start_request> requests,
+                               std::span<SessionStartResult> out_results);
+
+    // 推进就绪会话：到期定时器先入就绪队列，只 tick 队列中的会话，开销与事件数成正比。返回本轮推进的会话数
+    std::size_t tick(TimestampNs now_ns_value);
 
-    // 预留的回报通知入口；首版会话主要通过 OrderBook 轮询子单状态。
+    // 子单回报先记入会话账本，再唤醒所属会话在下一轮 tick 推进；顺序型 clip 终态后改记为待补单。
     void on_trade_response(const TradeResponse& response) noexcept;
 
+    // 立即推进 on_trade_response() 记下的待补单会话，下一笔 clip 随该回报一并发出；
+    // 调用方须在回报已写入订单簿后调用。未调用时待补单会话在下一次 tick 中推进。
+    void replenish_clips(TimestampNs now_ns_value) {
+        if (!refills_.empty()) {
+            flush_refills(now_ns_value);
+        }
+    }
+
+    // 父单撤单已路由时唤醒会话，使父单镜像及时进入 Cancelling。
+    void on_cancel_routed(InternalOrderId orig_order_id) noexcept;
+
+    // 导出全部在管会话的检查点，须在事件循环线程调用。
+    void export_checkpoint(std::vector<execution_session_checkpoint>& out_sessions,
+                           std::vector<execution_child_checkpoint>& out_children) const;
+
+    // 按检查点重建会话：父单须已恢复到订单簿且未终态；账本再按订单簿中子单的最新回报对账，
+    // 检查点之后登记到该父单下的子单一并收编。返回恢复的会话数。
+    std::size_t restore_checkpoint(const std::vector<execution_session_checkpoint>& sessions,
+                                   const std::vector<execution_child_checkpoint>& children);
+
+    // 当前托管中的会话数。
+    std::size_t session_count() const noexcept { return sessions_.size(); }
+
+    // 已终态、尚未归还会话池的会话数；每轮 tick 末尾最多回收 kRetiredReclaimPerTick 个。
+    std::size_t retired_session_count() const noexcept { return retired_.size(); }
+
+    // 会话池容量；在管与待回收会话数之和达到容量且无可回收会话时，新父单以 PoolExhausted 拒绝。
+    std::size_t session_capacity() const noexcept;
+
+    // 会话池（槽位与账本存储）、会话表与调度队列的内存占用。
+    memory_usage memory() const noexcept;
+
+    // split.coroutine_sessions 开启时在管协程会话占用的帧槽位数，与帧超出槽位或池空而退回堆分配的累计次数。
+    std::size_t coroutine_frames_in_use() const noexcept;
+    uint64_t coroutine_frame_fallbacks() const noexcept;
+
+    // 下一轮 tick 将推进的会话数。
+    std::size_t ready_session_count() const noexcept { return ready_.size(); }
+
+    // 子单轻量风控（split.child_risk_check）的累计校验与拒绝笔数。
+    const child_risk_guard& child_risk() const noexcept { return child_risk_; }
+
+    // 每轮 tick 归还会话池的终态会话上限：收盘集中终态时把析构与账本清理摊到后续各轮。
+    static constexpr std::size_t kRetiredReclaimPerTick = 32;
+
 private:
+    // 行情已就绪，或允许以委托价回落定价。
+    bool market_data_usable() const noexcept;
+
+    // start_session / start_sessions 的共用实现，market_data_ok 由调用方按批判断。
+    SessionStartResult start_one_session(OrderIndex parent_index, const OrderRequest& parent_request,
+                                         StrategyId strategy_id, TimestampNs start_time_ns, bool market_data_ok);
+
+    // 会话调度状态：queued 表示已在就绪队列，wakeup 有效表示停靠在时间轮，二者皆无表示等待回报事件。
+    // market_data 有效表示会话登记了行情前进唤醒。
+    struct session_slot {
+        pooled_execution_session session;
+        timer_id wakeup = kInvalidTimerId;
+        MarketDataHandle market_data{};
+        bool queued = false;
+    };
+
+    // 按会话声明的下一次推进时间决定入就绪队列、停靠时间轮或等待事件。
+    void schedule_session(InternalOrderId parent_order_id, session_slot& slot, TimestampNs now_ns_value);
+
+    // 取消停靠定时器并放入就绪队列（已在队列中则忽略）。
+    void wake_session(InternalOrderId parent_order_id, session_slot& slot) noexcept;
+
+    // 推进单个会话一次并按结果删除或重新登记；slot 引用在会话终态删除后失效。
+    void advance_session(InternalOrderId parent_order_id, session_slot& slot, TimestampNs now_ns_value);
+    void flush_refills(TimestampNs now_ns_value);
+
+    // 从待回收列表末尾归还至多 max_sessions 个会话（析构并清空账本存储）。
+    void reclaim_retired(std::size_t max_sessions) noexcept;
+
+    // 登记/注销会话的行情前进唤醒。
+    void watch_market_data(InternalOrderId parent_order_id, session_slot& slot);
+    void unwatch_market_data(InternalOrderId parent_order_id, session_slot& slot) noexcept;
+
+    // 批量检查被观察证券的快照序号，把行情前进的会话转入就绪队列。
+    void poll_market_data();
+
+    // 收集本轮就绪会话的主动评估候选，一次 evaluate_many()（或经 eval_pool_ 分块并行）后把决策交回各会话。
+    void evaluate_active_batch();
+
     split_config split_config_;
     OrderBook& order_book_;
     order_router& order_router_;
     MarketDataService* market_data_service_ = nullptr;
     OrderEventRecorder* order_event_recorder_ = nullptr;
     std::unique_ptr<ActiveStrategy> active_strategy_;
-    std::unordered_map<InternalOrderId, std::unique_ptr<ExecutionSession>> sessions_;
+    std::unique_ptr<active_eval_pool> eval_pool_;  // split.eval_workers > 0 时并行评估主动候选，须先于策略析构
+    const volume_profile* volume_profile_ = nullptr;
+    std::unique_ptr<coroutine_frame_pool> frame_pool_;      // 协程会话帧池，须晚于会话析构；未开启时为空
+    std::unique_ptr<execution_session_pool> session_pool_;  // 须先于 sessions_ 构造、晚于其析构
+    flat_hash_map<InternalOrderId, session_slot> sessions_;  // 容量为池容量两倍，运行期不再分配
+    std::vector<pooled_execution_session> retired_;          // 已终态待归还的会话，容量按池容量预留
+    timer_wheel<InternalOrderId> wakeups_;  // 等待片时点会话的唤醒时间轮（与终态归档共用实现）
+    std::vector<InternalOrderId> ready_;    // 下一轮待推进会话
+    std::vector<InternalOrderId> ticking_;  // 本轮正在推进的会话（与 ready_ 交换复用，避免逐轮分配）
+    std::vector<InternalOrderId> refills_;  // 待随回报当场补单的会话
+    std::vector<std::vector<InternalOrderId>> market_data_watchers_;  // 行情槽位 -> 观察该证券的会话
+    std::vector<MarketDataHandle> advanced_market_data_;              // 本轮序号前进的行情槽位（复用缓冲）
+    std::vector<ExecutionSession*> active_batch_sessions_;            // 本轮主动评估候选会话
+    std::vector<ActiveStrategyContext> active_batch_contexts_;        // 与候选会话按下标对应的评估上下文
+    std::vector<ActiveDecision> active_batch_decisions_;              // evaluate_many() 输出
+    MarketDataTickCache view_cache_;                  // 同证券会话每轮共享一次快照读取
+    std::vector<MarketDataHandle> basket_handles_;    // start_sessions 预读缓冲
+    SymbolFeatureStore feature_store_;                // 主动策略的证券增量特征，按发布序号前进更新一次
+    child_risk_guard child_risk_;                     // 子单按父单预算的轻量校验，会话共用
 };
 
 }  // namespace acct_service
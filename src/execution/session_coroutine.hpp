@@ -0,0 +1,182 @@
+#pragma once
+
+#include <algorithm>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <utility>
+#include <vector>
+
+#include "common/lazy_region.hpp"
+#include "common/types.hpp"
+
+namespace acct_service {
+
+// 协程会话的帧池：按会话池容量一次性预留定长帧槽位，协程帧在槽位上分配、随会话析构归还，
+// 会话启停不经过堆分配器。帧大小超出槽位或池已取空时退回全局 operator new 并计数。
+// 事件循环线程单写
+class coroutine_frame_pool {
+public:
+    static constexpr std::size_t kFrameSlotBytes = 1024;
+
+    coroutine_frame_pool(uint32_t capacity, bool huge_pages)
+        : capacity_(std::max<uint32_t>(capacity, 1)), slots_(capacity_, huge_pages, "execution.coroutine_frames") {
+        free_slots_.reserve(capacity_);
+        for (uint32_t slot = capacity_; slot > 0; --slot) {
+            free_slots_.push_back(slot - 1);
+        }
+    }
+
+    coroutine_frame_pool(const coroutine_frame_pool&) = delete;
+    coroutine_frame_pool& operator=(const coroutine_frame_pool&) = delete;
+
+    // 取一个帧槽位；bytes 超出槽位或池空时返回 nullptr，由调用方退回堆分配
+    void* allocate(std::size_t bytes) noexcept {
+        if (bytes > kFrameSlotBytes || free_slots_.empty()) {
+            ++heap_fallbacks_;
+            return nullptr;
+        }
+        const uint32_t slot = free_slots_.back();
+        free_slots_.pop_back();
+        return slots_[slot].bytes;
+    }
+
+    void deallocate(void* frame) noexcept {
+        const auto* bytes = static_cast<const unsigned char*>(frame);
+        const auto slot = static_cast<uint32_t>((bytes - slots_[0].bytes) / sizeof(frame_slot));
+        free_slots_.push_back(slot);
+    }
+
+    std::size_t capacity() const noexcept { return capacity_; }
+    std::size_t in_use() const noexcept { return capacity_ - free_slots_.size(); }
+    uint64_t heap_fallbacks() const noexcept { return heap_fallbacks_; }
+
+    // 作用域内本线程新建的会话协程从 pool 分配帧；作用域外新建的协程帧走堆
+    class binding {
+    public:
+        explicit binding(coroutine_frame_pool& pool) noexcept : previous_(std::exchange(current_, &pool)) {}
+        ~binding() { current_ = previous_; }
+
+        binding(const binding&) = delete;
+        binding& operator=(const binding&) = delete;
+
+    private:
+        coroutine_frame_pool* previous_;
+    };
+
+    static coroutine_frame_pool* current() noexcept { return current_; }
+
+private:
+    static inline thread_local coroutine_frame_pool* current_ = nullptr;
+
+    struct alignas(__STDCPP_DEFAULT_NEW_ALIGNMENT__) frame_slot {
+        unsigned char bytes[kFrameSlotBytes];
+    };
+
+    uint32_t capacity_;
+    lazy_array<frame_slot> slots_;      // 帧槽位裸存储，首次取用时才落页
+    std::vector<uint32_t> free_slots_;  // 空闲槽位栈，容量构造时预留
+    uint64_t heap_fallbacks_ = 0;
+};
+
+// 执行会话协程：首次 resume 前挂起，每次挂起时经 promise 声明下一次需要推进的时间，
+// 由会话的 next_wakeup_ns() 交给引擎挂时间轮或等待回报事件；结束后停在 final_suspend，随会话析构销毁帧。
+// 在 coroutine_frame_pool::binding 作用域内调用协程函数时帧从该池分配
+class session_task {
+public:
+    struct promise_type {
+        TimestampNs wake_ns = 0;
+
+        // 帧前置一个头部记下来源池（堆回退时为 nullptr），释放时据此归还
+        struct frame_header {
+            coroutine_frame_pool* pool = nullptr;
+        };
+        static constexpr std::size_t kHeaderBytes = __STDCPP_DEFAULT_NEW_ALIGNMENT__;
+        static_assert(sizeof(frame_header) <= kHeaderBytes);
+
+        static void* operator new(std::size_t bytes) {
+            coroutine_frame_pool* pool = coroutine_frame_pool::current();
+            void* raw = pool ? pool->allocate(bytes + kHeaderBytes) : nullptr;
+            coroutine_frame_pool* owner = raw ? pool : nullptr;
+            if (!raw) {
+                raw = ::operator new(bytes + kHeaderBytes);
+            }
+            ::new (raw) frame_header{owner};
+            return static_cast<unsigned char*>(raw) + kHeaderBytes;
+        }
+
+        static void operator delete(void* frame, std::size_t bytes) noexcept {
+            (void)bytes;
+            void* raw = static_cast<unsigned char*>(frame) - kHeaderBytes;
+            coroutine_frame_pool* pool = static_cast<frame_header*>(raw)->pool;
+            if (pool) {
+                pool->deallocate(raw);
+            } else {
+                ::operator delete(raw);
+            }
+        }
+
+        session_task get_return_object() noexcept {
+            return session_task(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+        std::suspend_always initial_suspend() const noexcept { return {}; }
+        std::suspend_always final_suspend() const noexcept { return {}; }
+        void return_void() const noexcept {}
+        // 推进中的异常照常从 resume() 抛给调用方，与状态机会话的 tick 一致
+        void unhandled_exception() const { throw; }
+    };
+
+    session_task() = default;
+    ~session_task() {
+        if (handle_) {
+            handle_.destroy();
+        }
+    }
+
+    session_task(const session_task&) = delete;
+    session_task& operator=(const session_task&) = delete;
+
+    session_task(session_task&& other) noexcept : handle_(std::exchange(other.handle_, {})) {}
+    session_task& operator=(session_task&& other) noexcept {
+        if (this != &other) {
+            if (handle_) {
+                handle_.destroy();
+            }
+            handle_ = std::exchange(other.handle_, {});
+        }
+        return *this;
+    }
+
+    explicit operator bool() const noexcept { return static_cast<bool>(handle_); }
+    bool done() const noexcept { return !handle_ || handle_.done(); }
+
+    // 从上一个挂起点继续，直到下一次 co_await 或结束
+    void resume() {
+        if (!done()) {
+            handle_.resume();
+        }
+    }
+
+    // 最近一次挂起时声明的推进时间；结束后无意义
+    TimestampNs wake_ns() const noexcept { return handle_ ? handle_.promise().wake_ns : 0; }
+
+private:
+    explicit session_task(std::coroutine_handle<promise_type> handle) noexcept : handle_(handle) {}
+
+    std::coroutine_handle<promise_type> handle_;
+};
+
+// co_await session_wait{t}：挂起协程，声明 t 之前无需推进。引擎可能因回报、撤单或行情前进提前恢复，
+// 协程恢复后应重新检查等待条件
+struct session_wait {
+    TimestampNs wake_ns = 0;
+
+    bool await_ready() const noexcept { return false; }
+    void await_suspend(std::coroutine_handle<session_task::promise_type> handle) const noexcept {
+        handle.promise().wake_ns = wake_ns;
+    }
+    void await_resume() const noexcept {}
+};
+
+}  // namespace acct_service
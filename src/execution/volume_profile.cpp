@@ -0,0 +1,187 @@
+#include "execution/volume_profile.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+
+#include "common/error.hpp"
+#include "common/log.hpp"
+
+namespace acct_service {
+
+namespace {
+
+bool report_profile_error(ErrorCode code, std::string_view message, int sys_errno = 0) {
+    ErrorStatus status = ACCT_MAKE_ERROR(ErrorDomain::config, code, "volume_profile", message, sys_errno);
+    record_error(status);
+    ACCT_LOG_ERROR_STATUS(status);
+    return false;
+}
+
+// 证券表按固定宽度键比较，与 write_file 的排序口径一致。
+int compare_security_key(const volume_profile_security& entry, std::string_view key) noexcept {
+    const std::size_t entry_size = strnlen(entry.internal_security_id, kInternalSecurityIdSize);
+    return std::string_view(entry.internal_security_id, entry_size).compare(key);
+}
+
+}  // namespace
+
+volume_profile::~volume_profile() { close(); }
+
+bool volume_profile::open(const std::string& path) {
+    close();
+
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return report_profile_error(ErrorCode::InvalidConfig, "failed to open volume profile file", errno);
+    }
+
+    struct stat file_stat {};
+    if (::fstat(fd, &file_stat) != 0) {
+        const int err = errno;
+        ::close(fd);
+        return report_profile_error(ErrorCode::InvalidConfig, "failed to stat volume profile file", err);
+    }
+    const std::size_t file_size = static_cast<std::size_t>(file_stat.st_size);
+    if (file_size < sizeof(volume_profile_header)) {
+        ::close(fd);
+        return report_profile_error(ErrorCode::ConfigParseFailed, "volume profile file is truncated");
+    }
+
+    void* mapping = ::mmap(nullptr, file_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    const int map_err = errno;
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        return report_profile_error(ErrorCode::InvalidConfig, "failed to mmap volume profile file", map_err);
+    }
+
+    const auto* header = static_cast<const volume_profile_header*>(mapping);
+    const std::size_t table_size = static_cast<std::size_t>(header->security_count) * sizeof(volume_profile_security);
+    const std::size_t bins_size =
+        static_cast<std::size_t>(header->security_count) * header->bin_count * sizeof(uint16_t);
+    if (header->magic != volume_profile_header::kMagic || header->version != volume_profile_header::kVersion ||
+        header->bin_count == 0 || header->bin_width_ms == 0 ||
+        file_size != sizeof(volume_profile_header) + table_size + bins_size) {
+        ::munmap(mapping, file_size);
+        return report_profile_error(ErrorCode::ConfigParseFailed, "volume profile header is invalid");
+    }
+
+    mapping_ = mapping;
+    mapping_size_ = file_size;
+    header_ = header;
+    securities_ = reinterpret_cast<const volume_profile_security*>(static_cast<const char*>(mapping) +
+                                                                    sizeof(volume_profile_header));
+    bins_ = reinterpret_cast<const uint16_t*>(reinterpret_cast<const char*>(securities_) + table_size);
+    ACCT_LOG_INFO("volume_profile", "volume profile loaded");
+    return true;
+}
+
+void volume_profile::close() noexcept {
+    if (mapping_) {
+        ::munmap(mapping_, mapping_size_);
+    }
+    mapping_ = nullptr;
+    mapping_size_ = 0;
+    header_ = nullptr;
+    securities_ = nullptr;
+    bins_ = nullptr;
+}
+
+const uint16_t* volume_profile::find(std::string_view internal_security_id) const noexcept {
+    if (!header_) {
+        return nullptr;
+    }
+
+    std::size_t low = 0;
+    std::size_t high = header_->security_count;
+    while (low < high) {
+        const std::size_t mid = low + (high - low) / 2;
+        const int order = compare_security_key(securities_[mid], internal_security_id);
+        if (order == 0) {
+            return bins_ + mid * header_->bin_count;
+        }
+        if (order < 0) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return nullptr;
+}
+
+uint64_t volume_profile::window_weight(const uint16_t* bins, uint32_t begin_ms, uint32_t end_ms) const noexcept {
+    if (!header_ || !bins || end_ms <= begin_ms) {
+        return 0;
+    }
+
+    const uint64_t width = header_->bin_width_ms;
+    const uint64_t profile_begin = header_->bin_start_ms;
+    const uint64_t profile_end = profile_begin + width * header_->bin_count;
+    const uint64_t window_begin = std::max<uint64_t>(begin_ms, profile_begin);
+    const uint64_t window_end = std::min<uint64_t>(end_ms, profile_end);
+    if (window_end <= window_begin) {
+        return 0;
+    }
+
+    // 权重按“每 bin 权重 x 重叠毫秒”累加，保持整数运算；调用方只关心各窗口间的相对比例
+    uint64_t total = 0;
+    for (uint64_t bin = (window_begin - profile_begin) / width; bin < header_->bin_count; ++bin) {
+        const uint64_t bin_begin = profile_begin + bin * width;
+        if (bin_begin >= window_end) {
+            break;
+        }
+        const uint64_t overlap = std::min(window_end, bin_begin + width) - std::max(window_begin, bin_begin);
+        total += static_cast<uint64_t>(bins[bin]) * overlap;
+    }
+    return total;
+}
+
+bool volume_profile::write_file(const std::string& path, uint32_t bin_start_ms, uint32_t bin_width_ms,
+                                std::vector<std::pair<std::string, std::vector<uint16_t>>> securities) {
+    if (securities.empty() || bin_width_ms == 0) {
+        return false;
+    }
+    const std::size_t bin_count = securities.front().second.size();
+    for (const auto& [security_id, bins] : securities) {
+        if (security_id.empty() || security_id.size() >= kInternalSecurityIdSize || bins.size() != bin_count) {
+            return false;
+        }
+    }
+    if (bin_count == 0) {
+        return false;
+    }
+    std::sort(securities.begin(), securities.end(),
+              [](const auto& lhs, const auto& rhs) { return lhs.first < rhs.first; });
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        return false;
+    }
+
+    volume_profile_header header{};
+    header.security_count = static_cast<uint32_t>(securities.size());
+    header.bin_count = static_cast<uint32_t>(bin_count);
+    header.bin_start_ms = bin_start_ms;
+    header.bin_width_ms = bin_width_ms;
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    for (const auto& [security_id, bins] : securities) {
+        (void)bins;
+        volume_profile_security entry{};
+        std::memcpy(entry.internal_security_id, security_id.data(), security_id.size());
+        out.write(reinterpret_cast<const char*>(&entry), sizeof(entry));
+    }
+    for (const auto& [security_id, bins] : securities) {
+        (void)security_id;
+        out.write(reinterpret_cast<const char*>(bins.data()),
+                  static_cast<std::streamsize>(bins.size() * sizeof(uint16_t)));
+    }
+    return static_cast<bool>(out);
+}
+
+}  // namespace acct_service
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "common/constants.hpp"
+
+namespace acct_service {
+
+// 日内成交量分布文件：文件头 + 按证券键升序的证券表 + 每只证券 bin_count 个 uint16 权重（小端）。
+// bin 自 bin_start_ms（当日毫秒）起按 bin_width_ms 等宽划分，午休等无成交时段权重为 0。
+struct volume_profile_header {
+    static constexpr uint32_t kMagic = 0x46525056;  // "VPRF"
+    static constexpr uint32_t kVersion = 1;
+
+    uint32_t magic = kMagic;
+    uint32_t version = kVersion;
+    uint32_t security_count = 0;
+    uint32_t bin_count = 0;
+    uint32_t bin_start_ms = 0;
+    uint32_t bin_width_ms = 0;
+};
+
+struct volume_profile_security {
+    char internal_security_id[kInternalSecurityIdSize] = {};
+};
+
+// 启动时只读 mmap 的成交量分布表；加载后不再分配内存，查找为证券表二分。
+class volume_profile {
+public:
+    volume_profile() = default;
+    ~volume_profile();
+
+    volume_profile(const volume_profile&) = delete;
+    volume_profile& operator=(const volume_profile&) = delete;
+
+    // 映射并校验分布文件；失败时记录错误并保持未加载。
+    bool open(const std::string& path);
+
+    void close() noexcept;
+
+    bool is_loaded() const noexcept { return header_ != nullptr; }
+    std::size_t security_count() const noexcept { return header_ ? header_->security_count : 0; }
+    uint32_t bin_count() const noexcept { return header_ ? header_->bin_count : 0; }
+
+    // 返回证券的 bin 权重数组（长度 bin_count）；未收录返回 nullptr。
+    const uint16_t* find(std::string_view internal_security_id) const noexcept;
+
+    // 当日 [begin_ms, end_ms) 时间窗内的权重积分，跨 bin 按重叠时长线性折算。
+    uint64_t window_weight(const uint16_t* bins, uint32_t begin_ms, uint32_t end_ms) const noexcept;
+
+    // 生成分布文件，证券按键排序后写入；供离线工具与测试使用。
+    static bool write_file(const std::string& path, uint32_t bin_start_ms, uint32_t bin_width_ms,
+                           std::vector<std::pair<std::string, std::vector<uint16_t>>> securities);
+
+private:
+    void* mapping_ = nullptr;
+    std::size_t mapping_size_ = 0;
+    const volume_profile_header* header_ = nullptr;
+    const volume_profile_security* securities_ = nullptr;
+    const uint16_t* bins_ = nullptr;
+};
+
+}  // namespace acct_service
@@ -1,9 +1,13 @@
+#include <cerrno>
 #include <cstdio>
+#include <cstdlib>
 #include <cstring>
 #include <string>
+#include <vector>
 
 #include "common/error.hpp"
 #include "common/log.hpp"
+#include "core/account_host.hpp"
 #include "core/account_service.hpp"
 
 namespace {
@@ -16,15 +20,63 @@ enum class parse_result_t {
     Error,
 };
 
+// 命令行参数：单个配置为独立进程模式；多个配置或指定 --host-cores 时进入多账户托管模式
+struct cli_args {
+    std::vector<std::string> config_paths;
+    acct_service::account_host_options host_options;
+    bool host_mode = false;
+};
+
 void print_usage(const char* program) {
     std::fprintf(stderr,
-        "Usage: %s [--config <path>] [config_path]\n"
-        "  --config <path>   指定配置文件路径 (默认: config/default.yaml)\n"
-        "  -h, --help        显示帮助\n",
+        "Usage: %s [--config <path>]... [config_path]... [host options]\n"
+        "  --config <path>          指定配置文件路径 (默认: config/default.yaml)，可重复，多个配置时托管多账户\n"
+        "  --host-cores <list>      托管 worker 绑定的核列表，逗号分隔，-1 表示不绑核 (如 2,3,4)\n"
+        "  --rebalance-ms <n>       按忙时重排账户的周期 (默认: 1000)\n"
+        "  --dedicated-ratio <x>    忙时占比不低于该值的账户独占一个 worker (默认: 0.3)\n"
+        "  -h, --help               显示帮助\n",
         program ? program : "AccountService");
 }
 
-parse_result_t parse_args(int argc, char* argv[], std::string& config_path) {
+bool parse_core_list(const char* text, std::vector<int>& out_cores) {
+    out_cores.clear();
+    const char* cursor = text;
+    while (cursor != nullptr && *cursor != '\0') {
+        char* end = nullptr;
+        errno = 0;
+        const long core = std::strtol(cursor, &end, 10);
+        if (errno != 0 || end == cursor || core < -1 || core > 4095 || (*end != ',' && *end != '\0')) {
+            return false;
+        }
+        out_cores.push_back(static_cast<int>(core));
+        cursor = *end == ',' ? end + 1 : end;
+    }
+    return !out_cores.empty();
+}
+
+bool parse_u32(const char* text, uint32_t& out_value) {
+    char* end = nullptr;
+    errno = 0;
+    const unsigned long long parsed = std::strtoull(text, &end, 10);
+    if (errno != 0 || end == text || *end != '\0' || parsed > UINT32_MAX) {
+        return false;
+    }
+    out_value = static_cast<uint32_t>(parsed);
+    return true;
+}
+
+bool parse_ratio(const char* text, double& out_value) {
+    char* end = nullptr;
+    errno = 0;
+    const double parsed = std::strtod(text, &end);
+    if (errno != 0 || end == text || *end != '\0' || parsed < 0.0) {
+        return false;
+    }
+    out_value = parsed;
+    return true;
+}
+
+parse_result_t parse_args(int argc, char* argv[], cli_args& out_args) {
     for (int i = 1; i < argc; ++i) {
         const char* arg = argv[i];
         if (!arg) {
@@ -36,13 +88,32 @@ parse_result_t parse_args(int argc, char* argv[], std::string& config_path) {
             return parse_result_t::Help;
         }
 
-        if (std::strcmp(arg, "--config") == 0) {
+        const bool takes_value = std::strcmp(arg, "--config") == 0 || std::strcmp(arg, "--host-cores") == 0 ||
+                                 std::strcmp(arg, "--rebalance-ms") == 0 || std::strcmp(arg, "--dedicated-ratio") == 0;
+        if (takes_value) {
             if (i + 1 >= argc || argv[i + 1] == nullptr) {
-                std::fprintf(stderr, "missing value for --config\n");
+                std::fprintf(stderr, "missing value for %s\n", arg);
+                print_usage(argv[0]);
+                return parse_result_t::Error;
+            }
+            const char* value = argv[++i];
+            bool ok = true;
+            if (std::strcmp(arg, "--config") == 0) {
+                out_args.config_paths.emplace_back(value);
+            } else if (std::strcmp(arg, "--host-cores") == 0) {
+                ok = parse_core_list(value, out_args.host_options.worker_cores);
+                out_args.host_mode = true;
+            } else if (std::strcmp(arg, "--rebalance-ms") == 0) {
+                ok = parse_u32(value, out_args.host_options.rebalance_interval_ms) &&
+                     out_args.host_options.rebalance_interval_ms > 0;
+            } else {
+                ok = parse_ratio(value, out_args.host_options.dedicated_busy_ratio);
+            }
+            if (!ok) {
+                std::fprintf(stderr, "invalid value for %s: %s\n", arg, value);
                 print_usage(argv[0]);
                 return parse_result_t::Error;
             }
-            config_path = argv[++i];
             continue;
         }
 
@@ -52,58 +123,75 @@ parse_result_t parse_args(int argc, char* argv[], std::string& config_path) {
             return parse_result_t::Error;
         }
 
-        if (!config_path.empty()) {
-            std::fprintf(stderr, "duplicated config path: %s\n", arg);
-            print_usage(argv[0]);
-            return parse_result_t::Error;
-        }
-
-        config_path = arg;
+        out_args.config_paths.emplace_back(arg);
     }
 
+    if (out_args.config_paths.size() > 1) {
+        out_args.host_mode = true;
+    }
     return parse_result_t::Ok;
 }
 
+void print_error(const char* prefix, const std::string& config_path, const acct_service::ErrorStatus& status) {
+    std::fprintf(stderr, "%s '%s': severity=%s domain=%s code=%s msg=%s\n", prefix, config_path.c_str(),
+        acct_service::to_string(acct_service::classify(status.domain, status.code).severity),
+        acct_service::to_string(status.domain), acct_service::to_string(status.code), status.message.c_str());
+}
+
+int exit_code_after_run(int run_rc, const acct_service::ErrorStatus& status) {
+    const acct_service::ErrorSeverity reason = acct_service::shutdown_reason();
+    if (reason >= acct_service::ErrorSeverity::Critical) {
+        (void)acct_service::flush_logger(200);
+        std::fprintf(stderr,
+            "AccountService terminated by policy: severity=%s domain=%s code=%s msg=%s\n",
+            acct_service::to_string(acct_service::classify(status.domain, status.code).severity),
+            acct_service::to_string(status.domain), acct_service::to_string(status.code), status.message.c_str());
+        return 1;
+    }
+
+    return (run_rc == 0) ? 0 : 1;
+}
+
+int run_hosted(const cli_args& args) {
+    acct_service::AccountHost host;
+    if (!host.initialize(args.config_paths, args.host_options)) {
+        print_error("failed to initialize AccountHost with configs starting at", args.config_paths.front(),
+                    host.last_error());
+        return 1;
+    }
+
+    const int run_rc = host.run();
+    host.print_stats();
+    return exit_code_after_run(run_rc, host.last_error());
+}
+
 }  // namespace
 
 int main(int argc, char* argv[]) {
-    std::string config_path;
-    const parse_result_t args = parse_args(argc, argv, config_path);
-    if (args == parse_result_t::Help) {
+    cli_args args;
+    const parse_result_t parsed = parse_args(argc, argv, args);
+    if (parsed == parse_result_t::Help) {
         return 0;
     }
-    if (args == parse_result_t::Error) {
+    if (parsed == parse_result_t::Error) {
         return 2;
     }
 
-    if (config_path.empty()) {
-        config_path = kDefaultConfigPath;
+    if (args.config_paths.empty()) {
+        args.config_paths.emplace_back(kDefaultConfigPath);
+    }
+    if (args.host_mode) {
+        return run_hosted(args);
     }
 
+    const std::string& config_path = args.config_paths.front();
     acct_service::AccountService service;
     if (!service.initialize(config_path)) {
-        const acct_service::ErrorStatus& status = service.last_error();
-        std::fprintf(stderr,
-            "failed to initialize AccountService with config '%s': severity=%s domain=%s code=%s msg=%s\n",
-            config_path.c_str(),
-            acct_service::to_string(acct_service::classify(status.domain, status.code).severity),
-            acct_service::to_string(status.domain), acct_service::to_string(status.code), status.message.c_str());
+        print_error("failed to initialize AccountService with config", config_path, service.last_error());
         return 1;
     }
 
     const int run_rc = service.run();
     service.print_stats();
-
-    const acct_service::ErrorSeverity reason = acct_service::shutdown_reason();
-    if (reason >= acct_service::ErrorSeverity::Critical) {
-        (void)acct_service::flush_logger(200);
-        const acct_service::ErrorStatus& status = service.last_error();
-        std::fprintf(stderr,
-            "AccountService terminated by policy: severity=%s domain=%s code=%s msg=%s\n",
-            acct_service::to_string(acct_service::classify(status.domain, status.code).severity),
-            acct_service::to_string(status.domain), acct_service::to_string(status.code), status.message.c_str());
-        return 1;
-    }
-
-    return (run_rc == 0) ? 0 : 1;
+    return exit_code_after_run(run_rc, service.last_error());
 }
@@ -0,0 +1,221 @@
+#include "market_data/market_data_replay.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstring>
+
+#include "common/log.hpp"
+
+namespace acct_service {
+
+namespace {
+
+constexpr const char* kLogModule = "MarketDataReplay";
+
+// 文件头与文件尺寸一致才可回放，避免把其他版本或截断文件当作录制数据。
+bool is_valid_replay_file(const MarketDataReplayHeader& header, std::size_t file_size) noexcept {
+    return header.magic == MarketDataReplayHeader::kMagic && header.version == MarketDataReplayHeader::kVersion &&
+           header.record_size == sizeof(MarketDataReplayRecord) && header.symbol_count != 0 &&
+           header.symbol_count <= snapshot_shm::kSnapshotMaxSymbols &&
+           file_size >= sizeof(MarketDataReplayHeader) &&
+           (file_size - sizeof(MarketDataReplayHeader)) / sizeof(MarketDataReplayRecord) >= header.record_count;
+}
+
+}  // namespace
+
+MarketDataRecorder::~MarketDataRecorder() { (void)close(); }
+
+bool MarketDataRecorder::open(const std::string& path, uint32_t trading_day, const std::vector<std::string>& symbols) {
+    (void)close();
+    if (symbols.empty() || symbols.size() > snapshot_shm::kSnapshotMaxSymbols) {
+        ACCT_LOG_ERROR(kLogModule, "replay recorder symbol count out of range");
+        return false;
+    }
+
+    header_ = MarketDataReplayHeader{};
+    header_.record_size = static_cast<uint32_t>(sizeof(MarketDataReplayRecord));
+    header_.trading_day = trading_day;
+    header_.symbol_count = static_cast<uint32_t>(symbols.size());
+    for (std::size_t i = 0; i < symbols.size(); ++i) {
+        std::strncpy(header_.symbols[i].symbol, symbols[i].c_str(), snapshot_shm::kSnapshotSymbolBytes - 1);
+    }
+
+    file_ = std::fopen(path.c_str(), "wb");
+    if (file_ == nullptr) {
+        ACCT_LOG_ERROR(kLogModule, "failed to create replay file");
+        return false;
+    }
+    // 先写入 record_count=0 的文件头占位，close() 时再回填
+    if (std::fwrite(&header_, sizeof(header_), 1, file_) != 1) {
+        std::fclose(file_);
+        file_ = nullptr;
+        ACCT_LOG_ERROR(kLogModule, "failed to write replay file header");
+        return false;
+    }
+    return true;
+}
+
+bool MarketDataRecorder::append(const MarketDataReplayRecord& record) noexcept {
+    if (file_ == nullptr || record.symbol_index >= header_.symbol_count) {
+        return false;
+    }
+    if (header_.record_count != 0 && record.offset_ns < last_offset_ns_) {
+        return false;
+    }
+    if (std::fwrite(&record, sizeof(record), 1, file_) != 1) {
+        return false;
+    }
+    last_offset_ns_ = record.offset_ns;
+    ++header_.record_count;
+    return true;
+}
+
+bool MarketDataRecorder::close() noexcept {
+    if (file_ == nullptr) {
+        return true;
+    }
+    bool ok = std::fseek(file_, 0, SEEK_SET) == 0 && std::fwrite(&header_, sizeof(header_), 1, file_) == 1;
+    ok = std::fclose(file_) == 0 && ok;
+    file_ = nullptr;
+    if (!ok) {
+        ACCT_LOG_ERROR(kLogModule, "failed to finalize replay file header");
+    }
+    return ok;
+}
+
+MarketDataReplayFile::~MarketDataReplayFile() { close(); }
+
+bool MarketDataReplayFile::open(const std::string& path) {
+    close();
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        ACCT_LOG_ERROR(kLogModule, "failed to open replay file");
+        return false;
+    }
+    struct stat file_stat {};
+    if (::fstat(fd, &file_stat) != 0 || static_cast<std::size_t>(file_stat.st_size) < sizeof(MarketDataReplayHeader)) {
+        ::close(fd);
+        ACCT_LOG_ERROR(kLogModule, "replay file is truncated");
+        return false;
+    }
+    const std::size_t file_size = static_cast<std::size_t>(file_stat.st_size);
+    void* mapping = ::mmap(nullptr, file_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        ACCT_LOG_ERROR(kLogModule, "failed to mmap replay file");
+        return false;
+    }
+
+    const auto* header = static_cast<const MarketDataReplayHeader*>(mapping);
+    if (!is_valid_replay_file(*header, file_size)) {
+        ::munmap(mapping, file_size);
+        ACCT_LOG_ERROR(kLogModule, "replay file header is invalid");
+        return false;
+    }
+    // 回放按顺序扫描，提示内核积极预读
+    (void)::madvise(mapping, file_size, MADV_SEQUENTIAL);
+
+    mapping_ = mapping;
+    mapping_size_ = file_size;
+    header_ = header;
+    records_ = reinterpret_cast<const MarketDataReplayRecord*>(static_cast<const char*>(mapping) +
+                                                               sizeof(MarketDataReplayHeader));
+    return true;
+}
+
+void MarketDataReplayFile::close() noexcept {
+    if (mapping_ != nullptr) {
+        ::munmap(mapping_, mapping_size_);
+    }
+    mapping_ = nullptr;
+    mapping_size_ = 0;
+    header_ = nullptr;
+    records_ = nullptr;
+}
+
+uint64_t MarketDataReplayFile::duration_ns() const noexcept {
+    const std::size_t count = record_count();
+    return count == 0 ? 0 : records_[count - 1].offset_ns;
+}
+
+MarketDataReplayer::MarketDataReplayer(const MarketDataReplayFile& file) : file_(file) {}
+
+MarketDataReplayer::~MarketDataReplayer() { close_output(false); }
+
+bool MarketDataReplayer::open_output(const std::string& snapshot_shm_name) {
+    close_output(false);
+    if (!file_.is_open() || snapshot_shm_name.empty()) {
+        return false;
+    }
+    writer_ = snapshot_shm_writer_new();
+    if (writer_ == nullptr) {
+        return false;
+    }
+    const MarketDataReplayHeader& header = file_.header();
+    if (snapshot_shm_writer_init(writer_, snapshot_shm_name.c_str(), header.trading_day, header.symbols,
+                                 header.symbol_count) != 1) {
+        snapshot_shm_writer_delete(writer_);
+        writer_ = nullptr;
+        ACCT_LOG_ERROR(kLogModule, "failed to create replay snapshot shm");
+        return false;
+    }
+    output_name_ = snapshot_shm_name;
+    return true;
+}
+
+void MarketDataReplayer::close_output(bool unlink) noexcept {
+    if (writer_ != nullptr) {
+        snapshot_shm_writer_delete(writer_);
+        writer_ = nullptr;
+        if (unlink) {
+            (void)snapshot_shm_writer_unlink(output_name_.c_str());
+        }
+    }
+    output_name_.clear();
+}
+
+bool MarketDataReplayer::publish_record(const MarketDataReplayRecord& record) noexcept {
+    return snapshot_shm_writer_publish_with_state(writer_, record.symbol_index, &record.snapshot, record.signal,
+                                                  record.flags, record.prediction_state) == 1;
+}
+
+std::size_t MarketDataReplayer::publish_until(uint64_t offset_ns, std::size_t max_records) noexcept {
+    if (writer_ == nullptr) {
+        return 0;
+    }
+    const std::size_t count = file_.record_count();
+    std::size_t emitted = 0;
+    while (cursor_ < count && emitted < max_records) {
+        const MarketDataReplayRecord& record = file_.record(cursor_);
+        if (record.offset_ns > offset_ns) {
+            break;
+        }
+        ++cursor_;
+        if (publish_record(record)) {
+            ++emitted;
+        }
+    }
+    published_ += emitted;
+    return emitted;
+}
+
+std::size_t MarketDataReplayer::publish_next(std::size_t count) noexcept {
+    return publish_until(UINT64_MAX, count);
+}
+
+uint64_t MarketDataReplayer::next_offset_ns() const noexcept {
+    return done() ? UINT64_MAX : file_.record(cursor_).offset_ns;
+}
+
+uint64_t market_data_replay_offset(TimestampNs elapsed_ns, double speed) noexcept {
+    if (!(speed > 0.0)) {
+        return elapsed_ns;
+    }
+    const double offset = static_cast<double>(elapsed_ns) * speed;
+    return offset >= 1.8e19 ? UINT64_MAX : static_cast<uint64_t>(offset);
+}
+
+}  // namespace acct_service
@@ -0,0 +1,143 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "common/types.hpp"
+#include "snapshot_shm.hpp"
+
+namespace acct_service {
+
+// 行情回放文件：文件头 + 按录制时刻非递减排列的定长记录，每条记录是一次 snapshot slot 发布。
+// 文件头内嵌与 snapshot shm 相同的 symbol 表，回放时按 symbol_index 原样发布到同一槽位。
+struct MarketDataReplayHeader {
+    static constexpr uint32_t kMagic = 0x5044524D;  // "MRDP"
+    static constexpr uint32_t kVersion = 1;
+
+    uint32_t magic = kMagic;
+    uint32_t version = kVersion;
+    uint32_t record_size = 0;
+    uint32_t trading_day = 0;
+    uint32_t symbol_count = 0;
+    uint32_t reserved = 0;
+    uint64_t record_count = 0;  // 录制端 close() 时回填
+    snapshot_shm::SnapshotSymbolDef symbols[snapshot_shm::kSnapshotMaxSymbols]{};
+};
+
+static_assert(sizeof(MarketDataReplayHeader) == 2080, "MarketDataReplayHeader layout changed");
+static_assert(std::is_trivially_copyable_v<MarketDataReplayHeader>, "MarketDataReplayHeader must be trivially copyable");
+
+// 单条回放记录：盘口快照 + prediction 字段，offset_ns 为相对首条记录的录制时刻。
+struct MarketDataReplayRecord {
+    uint64_t offset_ns = 0;
+    uint32_t symbol_index = 0;
+    float signal = 0.0F;
+    uint32_t flags = 0;
+    uint8_t prediction_state = 0;  // snapshot_shm::SnapshotPredictionState
+    uint8_t reserved[3] = {};
+    snapshot_shm::LobSnapshot snapshot{};
+};
+
+static_assert(sizeof(MarketDataReplayRecord) == 240, "MarketDataReplayRecord layout changed");
+static_assert(std::is_trivially_copyable_v<MarketDataReplayRecord>, "MarketDataReplayRecord must be trivially copyable");
+
+// 录制端：顺序追加记录，close() 回填记录数；未 close 的文件 record_count 为 0，回放端视为空文件。
+class MarketDataRecorder {
+public:
+    MarketDataRecorder() = default;
+    ~MarketDataRecorder();
+
+    MarketDataRecorder(const MarketDataRecorder&) = delete;
+    MarketDataRecorder& operator=(const MarketDataRecorder&) = delete;
+
+    // 新建（覆盖）回放文件并写入 symbol 表；symbol 数量须在 [1, kSnapshotMaxSymbols]。
+    bool open(const std::string& path, uint32_t trading_day, const std::vector<std::string>& symbols);
+
+    // 追加一条记录；symbol_index 越界或 offset_ns 倒退时返回 false。
+    bool append(const MarketDataReplayRecord& record) noexcept;
+
+    // 回填文件头并关闭，返回是否成功落盘。
+    bool close() noexcept;
+
+    bool is_open() const noexcept { return file_ != nullptr; }
+    uint64_t record_count() const noexcept { return header_.record_count; }
+
+private:
+    std::FILE* file_ = nullptr;
+    MarketDataReplayHeader header_{};
+    uint64_t last_offset_ns_ = 0;
+};
+
+// 只读 mmap 一个回放文件，记录数组直接指向映射区，读取不拷贝。
+class MarketDataReplayFile {
+public:
+    MarketDataReplayFile() = default;
+    ~MarketDataReplayFile();
+
+    MarketDataReplayFile(const MarketDataReplayFile&) = delete;
+    MarketDataReplayFile& operator=(const MarketDataReplayFile&) = delete;
+
+    // 文件头不合法或尺寸与记录数不符时返回 false。
+    bool open(const std::string& path);
+    void close() noexcept;
+
+    bool is_open() const noexcept { return header_ != nullptr; }
+    const MarketDataReplayHeader& header() const noexcept { return *header_; }
+    std::size_t record_count() const noexcept { return header_ ? static_cast<std::size_t>(header_->record_count) : 0; }
+    const MarketDataReplayRecord& record(std::size_t index) const noexcept { return records_[index]; }
+    // 末条记录的录制时刻，即整段录制的时长。
+    uint64_t duration_ns() const noexcept;
+
+private:
+    void* mapping_ = nullptr;
+    std::size_t mapping_size_ = 0;
+    const MarketDataReplayHeader* header_ = nullptr;
+    const MarketDataReplayRecord* records_ = nullptr;
+};
+
+// 回放端：把回放文件按录制时刻（可加速）发布到一个测试用 snapshot shm，读端仍走 MarketDataService。
+class MarketDataReplayer {
+public:
+    explicit MarketDataReplayer(const MarketDataReplayFile& file);
+    ~MarketDataReplayer();
+
+    MarketDataReplayer(const MarketDataReplayer&) = delete;
+    MarketDataReplayer& operator=(const MarketDataReplayer&) = delete;
+
+    // 按回放文件的 trading_day 与 symbol 表创建 snapshot shm。
+    bool open_output(const std::string& snapshot_shm_name);
+    // 关闭写端；unlink=true 时同时删除 snapshot shm。
+    void close_output(bool unlink) noexcept;
+
+    // 发布录制时刻不晚于 offset_ns 的全部未发布记录，单次最多 max_records 条，返回本次发布条数。
+    std::size_t publish_until(uint64_t offset_ns, std::size_t max_records = SIZE_MAX) noexcept;
+    // 不看时刻，直接发布接下来的 count 条记录（尽快回放）。
+    std::size_t publish_next(std::size_t count) noexcept;
+
+    // 从第一条记录重新开始（循环回放），snapshot slot 序号继续递增。
+    void rewind() noexcept { cursor_ = 0; }
+
+    bool done() const noexcept { return cursor_ >= file_.record_count(); }
+    std::size_t cursor() const noexcept { return cursor_; }
+    // 下一条待发布记录的录制时刻，已发完时返回 UINT64_MAX。
+    uint64_t next_offset_ns() const noexcept;
+    uint64_t published() const noexcept { return published_; }
+
+private:
+    bool publish_record(const MarketDataReplayRecord& record) noexcept;
+
+    const MarketDataReplayFile& file_;
+    void* writer_ = nullptr;
+    std::string output_name_;
+    std::size_t cursor_ = 0;
+    uint64_t published_ = 0;
+};
+
+// 把回放开始后经过的单调时间按倍速换算成录制时刻；speed<=0 视为 1 倍速。
+uint64_t market_data_replay_offset(TimestampNs elapsed_ns, double speed) noexcept;
+
+}  // namespace acct_service
@@ -1,5 +1,7 @@
 #include "market_data/market_data_service.hpp"
 
+#include <algorithm>
+#include <iterator>
 #include <utility>
 
 #include "common/log.hpp"
@@ -11,12 +13,41 @@ bool PredictionView::has_prediction() const noexcept { return state != Predictio
 
 bool PredictionView::has_fresh_prediction() const noexcept { return state == PredictionState::Fresh; }
 
-MarketDataService::MarketDataService(const MarketDataConfig& config) : config_(config) {}
+MarketDataService::MarketDataService(const MarketDataConfig& config) : config_(config) {
+    add_reader(Market::NotSet, config_.snapshot_shm_name);
+    add_reader(Market::SZ, config_.sz_snapshot_shm_name);
+    add_reader(Market::SH, config_.sh_snapshot_shm_name);
+}
+
+// 默认源占下标 0；市场专属源为空时沿用默认源，与已登记源同名时复用同一个 reader。
+void MarketDataService::add_reader(Market market, const std::string& shm_name) {
+    if (market != Market::NotSet && shm_name.empty()) {
+        return;
+    }
+    const auto found = std::find(reader_names_.begin(), reader_names_.end(), shm_name);
+    const auto index = static_cast<uint8_t>(found - reader_names_.begin());
+    if (found == reader_names_.end()) {
+        reader_names_.push_back(shm_name);
+        readers_.push_back(std::make_unique<snapshot_reader>());
+    }
+    if (market != Market::NotSet) {
+        reader_by_market_[static_cast<std::size_t>(market)] = index;
+    }
+}
 
-// 打开 reader 并保持 ready 状态，未启用时显式走 no-op 路径。
+uint8_t MarketDataService::reader_for(const InternalSecurityId& security_id) const noexcept {
+    Market market = Market::NotSet;
+    std::string_view code;
+    if (!parse_internal_security_id(security_id.view(), market, code) ||
+        static_cast<std::size_t>(market) >= kMarketRouteCount) {
+        return 0;
+    }
+    return reader_by_market_[static_cast<std::size_t>(market)];
+}
+
+// 打开全部 reader 并保持 ready 状态，未启用时显式走 no-op 路径。
 bool MarketDataService::initialize() {
-    ready_ = false;
-    reader_.close();
+    close();
 
     if (!config_.enabled) {
         return true;
@@ -24,16 +55,21 @@ bool MarketDataService::initialize() {
     if (config_.snapshot_shm_name.empty()) {
         return false;
     }
-    if (!reader_.open(config_.snapshot_shm_name)) {
-        if (config_.allow_order_price_fallback) {
-            ACCT_LOG_WARN("MarketDataService",
-                          "market data reader open failed; managed execution will fall back to parent order price");
-            return true;
+    for (std::size_t i = 0; i < readers_.size(); ++i) {
+        if (!readers_[i]->open(reader_names_[i])) {
+            close();
+            if (config_.allow_order_price_fallback) {
+                ACCT_LOG_WARN("MarketDataService",
+                              "market data reader open failed; managed execution will fall back to parent order price");
+                return true;
+            }
+            return false;
         }
-        return false;
     }
 
-    ready_ = reader_.is_open() && reader_.header() != nullptr;
+    ready_ = std::all_of(readers_.begin(), readers_.end(), [](const std::unique_ptr<snapshot_reader>& reader) {
+        return reader->is_open() && reader->header() != nullptr;
+    });
     if (!ready_ && config_.allow_order_price_fallback) {
         ACCT_LOG_WARN("MarketDataService",
                       "market data reader is not ready; managed execution will fall back to parent order price");
@@ -44,7 +80,9 @@ bool MarketDataService::initialize() {
 
 // 停机时关闭映射，避免把第三方 reader 生命周期散落到调用方。
 void MarketDataService::close() noexcept {
-    reader_.close();
+    for (const std::unique_ptr<snapshot_reader>& reader : readers_) {
+        reader->close();
+    }
     ready_ = false;
 }
 
@@ -54,22 +92,18 @@ bool MarketDataService::is_ready() const noexcept { return ready_; }
 
 bool MarketDataService::allow_order_price_fallback() const noexcept { return config_.allow_order_price_fallback; }
 
-// 列出当前快照源中的全部 symbol，未 ready 时返回空集合。
+// 按源的顺序列出全部快照源中的 symbol，未 ready 时返回空集合。
 std::vector<std::string> MarketDataService::list_symbols() const {
     if (!ready_) {
         return {};
     }
-    return reader_.list_symbols();
-}
-
-// 统一把项目内部证券键转换为 snapshot_reader 的 symbol 形态。
-bool MarketDataService::normalize_symbol(std::string_view internal_security_id, std::string& out_symbol) {
-    InternalSecurityId normalized_security_id;
-    if (!normalize_internal_security_id(internal_security_id, normalized_security_id)) {
-        return false;
+    std::vector<std::string> symbols;
+    for (const std::unique_ptr<snapshot_reader>& reader : readers_) {
+        std::vector<std::string> venue_symbols = reader->list_symbols();
+        symbols.insert(symbols.end(), std::make_move_iterator(venue_symbols.begin()),
+                       std::make_move_iterator(venue_symbols.end()));
     }
-    out_symbol.assign(normalized_security_id.view());
-    return true;
+    return symbols;
 }
 
 // 统一 prediction_state 语义，避免上层直接依赖第三方协议枚举。
@@ -91,18 +125,168 @@ bool MarketDataService::read(std::string_view internal_security_id, MarketDataVi
         return false;
     }
 
-    std::string symbol;
-    if (!normalize_symbol(internal_security_id, symbol)) {
+    InternalSecurityId normalized_security_id;
+    if (!normalize_internal_security_id(internal_security_id, normalized_security_id)) {
         return false;
     }
 
     signal_engine::snapshot_reader::ReadResult result;
-    if (!reader_.read(symbol, result)) {
+    if (!readers_[reader_for(normalized_security_id)]->read(std::string(normalized_security_id.view()), result)) {
+        return false;
+    }
+    fill_view(result, out_view);
+    return true;
+}
+
+// 规范化只在首次 resolve 时发生，之后同一证券直接命中槽位。
+MarketDataHandle MarketDataService::resolve(std::string_view internal_security_id) {
+    InternalSecurityId normalized_security_id;
+    if (!normalize_internal_security_id(internal_security_id, normalized_security_id)) {
+        return MarketDataHandle{};
+    }
+
+    const auto [it, inserted] = resolved_slot_by_security_.try_emplace(
+        normalized_security_id, static_cast<uint32_t>(resolved_symbols_.size()));
+    if (inserted) {
+        resolved_symbol entry;
+        entry.symbol.assign(normalized_security_id.view());
+        entry.reader = reader_for(normalized_security_id);
+        entry.result.symbol.reserve(entry.symbol.size());
+        resolved_symbols_.push_back(std::move(entry));
+    }
+    return MarketDataHandle{it->second};
+}
+
+// 句柄读取复用槽位内的读结果缓冲，热路径不再构造临时 std::string。
+bool MarketDataService::read(MarketDataHandle handle, MarketDataView& out_view) const {
+    if (!ready_ || handle.slot >= resolved_symbols_.size()) {
         return false;
     }
 
-    out_view = MarketDataView{};
-    out_view.symbol = std::move(result.symbol);
+    const resolved_symbol& entry = resolved_symbols_[handle.slot];
+    ++snapshot_reads_;
+    if (!readers_[entry.reader]->read(entry.symbol, entry.result)) {
+        return false;
+    }
+    fill_view(entry.result, out_view);
+    return true;
+}
+
+std::size_t MarketDataService::read_many(std::span<const MarketDataHandle> handles,
+                                         std::span<MarketDataView*> out_views) const {
+    const std::size_t count = std::min(handles.size(), out_views.size());
+    std::size_t ok = 0;
+    for (std::size_t i = 0; i < count; ++i) {
+        if (out_views[i] == nullptr) {
+            continue;
+        }
+        if (read(handles[i], *out_views[i])) {
+            ++ok;
+        } else {
+            out_views[i] = nullptr;
+        }
+    }
+    return ok;
+}
+
+const MarketDataView* MarketDataTickCache::read(MarketDataHandle handle) {
+    entry* found = entry_for(handle);
+    if (!found) {
+        return nullptr;
+    }
+    if (found->epoch != epoch_) {
+        found->epoch = epoch_;
+        found->ok = service_->read(handle, found->view);
+    }
+    return found->ok ? &found->view : nullptr;
+}
+
+void MarketDataTickCache::prefetch(std::span<const MarketDataHandle> handles) {
+    pending_handles_.clear();
+    pending_views_.clear();
+    pending_entries_.clear();
+    for (MarketDataHandle handle : handles) {
+        entry* found = entry_for(handle);
+        if (!found || found->epoch == epoch_) {
+            continue;
+        }
+        // 先记纪元，同一批内重复的句柄只排一次
+        found->epoch = epoch_;
+        found->ok = false;
+        pending_handles_.push_back(handle);
+        pending_views_.push_back(&found->view);
+        pending_entries_.push_back(found);
+    }
+    if (pending_handles_.empty()) {
+        return;
+    }
+    (void)service_->read_many(pending_handles_, pending_views_);
+    for (std::size_t i = 0; i < pending_entries_.size(); ++i) {
+        pending_entries_[i]->ok = pending_views_[i] != nullptr;
+    }
+}
+
+MarketDataTickCache::entry* MarketDataTickCache::entry_for(MarketDataHandle handle) {
+    if (!service_ || !handle.is_valid()) {
+        return nullptr;
+    }
+    if (entries_.size() <= handle.slot) {
+        entries_.resize(handle.slot + 1);
+    }
+    std::unique_ptr<entry>& slot = entries_[handle.slot];
+    if (!slot) {
+        slot = std::make_unique<entry>();
+    }
+    return slot.get();
+}
+
+void MarketDataService::watch(MarketDataHandle handle) {
+    if (handle.slot >= resolved_symbols_.size()) {
+        return;
+    }
+    resolved_symbol& entry = resolved_symbols_[handle.slot];
+    if (entry.watch_count++ == 0) {
+        watched_slots_.push_back(handle.slot);
+    }
+}
+
+void MarketDataService::unwatch(MarketDataHandle handle) noexcept {
+    if (handle.slot >= resolved_symbols_.size()) {
+        return;
+    }
+    resolved_symbol& entry = resolved_symbols_[handle.slot];
+    if (entry.watch_count == 0 || --entry.watch_count > 0) {
+        return;
+    }
+    const auto it = std::find(watched_slots_.begin(), watched_slots_.end(), handle.slot);
+    if (it != watched_slots_.end()) {
+        *it = watched_slots_.back();
+        watched_slots_.pop_back();
+    }
+}
+
+// reader 只提供整条快照读取，这里按槽位所属 reader 复用读缓冲逐一比较序号；未发布或读失败的槽位视为未前进。
+std::size_t MarketDataService::poll_updates(std::vector<MarketDataHandle>& out_advanced) {
+    if (!ready_) {
+        return 0;
+    }
+
+    std::size_t advanced = 0;
+    for (uint32_t slot : watched_slots_) {
+        resolved_symbol& entry = resolved_symbols_[slot];
+        if (!readers_[entry.reader]->read(entry.symbol, entry.result) || entry.result.seq == entry.last_seen_seq) {
+            continue;
+        }
+        entry.last_seen_seq = entry.result.seq;
+        out_advanced.push_back(MarketDataHandle{slot});
+        ++advanced;
+    }
+    return advanced;
+}
+
+void MarketDataService::fill_view(const signal_engine::snapshot_reader::ReadResult& result,
+                                  MarketDataView& out_view) noexcept {
+    out_view.symbol.assign(result.symbol);
     out_view.seq = result.seq;
     out_view.snapshot = result.payload.snapshot;
     out_view.prediction.signal = result.payload.signal;
@@ -110,7 +294,6 @@ bool MarketDataService::read(std::string_view internal_security_id, MarketDataVi
     out_view.prediction.state = map_prediction_state(result.payload.prediction_state);
     out_view.prediction.publish_seq_no = result.payload.publish_seq_no;
     out_view.prediction.publish_mono_ns = result.payload.publish_mono_ns;
-    return true;
 }
 
 }  // namespace acct_service
@@ -1,10 +1,18 @@
 #pragma once
 
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <span>
 #include <string>
 #include <string_view>
+#include <unordered_map>
 #include <vector>
 
+#include "common/types.hpp"
 #include "core/config_manager.hpp"
+#include "order/order_request.hpp"
 #include "snapshot_reader.hpp"
 #include "snapshot_shm.hpp"
 
@@ -29,15 +37,26 @@ struct PredictionView {
     bool has_fresh_prediction() const noexcept;
 };
 
-// 对单标的行情与预测值的统一读视图。
+// 对单标的行情与预测值的统一读视图（POD，读取路径不分配内存）。
 struct MarketDataView {
-    std::string symbol;
+    InternalSecurityId symbol;
     uint64_t seq = 0;
     snapshot_shm::LobSnapshot snapshot{};
     PredictionView prediction{};
 };
 
+// resolve() 返回的证券句柄：缓存规范化后的 reader symbol 槽位，槽位内记录所属市场的 reader，热路径按槽位读取。
+struct MarketDataHandle {
+    static constexpr uint32_t kInvalidSlot = std::numeric_limits<uint32_t>::max();
+
+    uint32_t slot = kInvalidSlot;
+
+    bool is_valid() const noexcept { return slot != kInvalidSlot; }
+};
+
 // 统一封装 snapshot_reader 的打开、符号规范化和稳定快照读取。
+// 按市场汇聚多路快照源：snapshot_shm_name 为默认源，sz/sh_snapshot_shm_name 非空时对应市场改读独立的源，
+// 同名的源只打开一次；句柄在 resolve() 时绑定到所属市场的 reader，两个市场的读取成本相同。
 class MarketDataService {
 public:
     explicit MarketDataService(const MarketDataConfig& config);
@@ -46,7 +65,7 @@ public:
     MarketDataService(const MarketDataService&) = delete;
     MarketDataService& operator=(const MarketDataService&) = delete;
 
-    // 打开行情共享内存；未启用配置时返回 true 但保持 not-ready。
+    // 打开全部行情共享内存；未启用配置时返回 true 但保持 not-ready，任一源打开失败都视为 not-ready。
     bool initialize();
 
     // 关闭共享内存映射，供服务停机时显式回收。
@@ -55,28 +74,112 @@ public:
     // 是否显式启用了行情模块。
     bool is_enabled() const noexcept;
 
-    // 是否已经成功打开并校验 reader。
+    // 是否已经成功打开并校验全部 reader。
     bool is_ready() const noexcept;
 
     // 是否允许在行情不可用时回退到父单委托价做调试发单。
     bool allow_order_price_fallback() const noexcept;
 
-    // 返回当前 reader 暴露的全部 canonical symbol，供调试工具快速枚举可读合约。
+    // 按源的顺序返回全部 reader 暴露的 canonical symbol，供调试工具快速枚举可读合约。
     std::vector<std::string> list_symbols() const;
 
     // 按 canonical internal_security_id 读取一条稳定行情快照。
     bool read(std::string_view internal_security_id, MarketDataView& out_view) const;
 
+    // 规范化证券键并缓存为句柄，同一证券重复 resolve 返回同一槽位；非法证券键返回无效句柄。
+    // 句柄与 reader 是否 ready 无关，跨 initialize()/close() 保持有效。
+    MarketDataHandle resolve(std::string_view internal_security_id);
+
+    // 按 resolve() 句柄读取稳定行情快照，不做符号规范化，也不分配内存。
+    bool read(MarketDataHandle handle, MarketDataView& out_view) const;
+
+    // 批量按句柄读取，out_views 与 handles 按下标对应；读取失败的位置置空，返回成功条数。
+    std::size_t read_many(std::span<const MarketDataHandle> handles, std::span<MarketDataView*> out_views) const;
+
+    // 累计快照读取次数（单条与批量都计入），用于观测同一节拍的重复读取。
+    uint64_t snapshot_reads() const noexcept { return snapshot_reads_; }
+
+    // 登记/注销对句柄的序号观察（引用计数）；只有被观察的槽位参与 poll_updates()。
+    void watch(MarketDataHandle handle);
+    void unwatch(MarketDataHandle handle) noexcept;
+
+    // 实际打开的快照源数量（同名源合并后），供启动日志与测试核对市场路由。
+    std::size_t reader_count() const noexcept { return readers_.size(); }
+
+    // 批量检查全部被观察槽位，把快照序号较上次前进的句柄追加到 out_advanced，返回前进数量。
+    std::size_t poll_updates(std::vector<MarketDataHandle>& out_advanced);
+
 private:
-    // 将项目内部证券键规范化成 snapshot_reader 使用的 symbol。
-    static bool normalize_symbol(std::string_view internal_security_id, std::string& out_symbol);
+    using snapshot_reader = signal_engine::snapshot_reader::SnapshotReader;
+
+    // Market 枚举的有效取值（NotSet..HK）都落在路由表内，其余取值走默认源。
+    static constexpr std::size_t kMarketRouteCount = 5;
+
+    // 句柄槽位：规范化 symbol、所属 reader 下标与复用的读结果缓冲（symbol 字符串容量随之复用）。
+    struct resolved_symbol {
+        std::string symbol;
+        uint8_t reader = 0;
+        mutable signal_engine::snapshot_reader::ReadResult result;
+        uint32_t watch_count = 0;
+        uint64_t last_seen_seq = 0;  // poll_updates() 上次观察到的快照序号
+    };
+
+    // 按配置登记快照源并建立市场路由，构造时执行一次。
+    void add_reader(Market market, const std::string& shm_name);
+
+    // 规范化后的证券键按市场前缀选出 reader 下标。
+    uint8_t reader_for(const InternalSecurityId& security_id) const noexcept;
+
+    // 把 reader 读结果投影成统一视图。
+    static void fill_view(const signal_engine::snapshot_reader::ReadResult& result, MarketDataView& out_view) noexcept;
 
     // 把第三方预测状态投影成项目内部枚举，统一上层判断逻辑。
     static PredictionState map_prediction_state(snapshot_shm::SnapshotPredictionState state) noexcept;
 
     MarketDataConfig config_;
-    mutable signal_engine::snapshot_reader::SnapshotReader reader_;
+    std::vector<std::string> reader_names_;
+    std::vector<std::unique_ptr<snapshot_reader>> readers_;  // 下标 0 为默认源
+    std::array<uint8_t, kMarketRouteCount> reader_by_market_{};
     bool ready_ = false;
+    std::vector<resolved_symbol> resolved_symbols_;
+    std::unordered_map<InternalSecurityId, uint32_t> resolved_slot_by_security_;
+    std::vector<uint32_t> watched_slots_;  // watch_count > 0 的槽位，poll 只遍历这一列表
+    mutable uint64_t snapshot_reads_ = 0;
+};
+
+// 同一节拍内按证券槽位共享的行情视图：每个槽位在一个纪元内只读一次，多个会话按指针共享同一份视图。
+// begin_tick() 开启新纪元；返回的指针在下一纪元再次读取同一槽位前保持有效，失败结果同样缓存到纪元结束。
+class MarketDataTickCache {
+public:
+    explicit MarketDataTickCache(MarketDataService* service) noexcept : service_(service) {}
+
+    MarketDataTickCache(const MarketDataTickCache&) = delete;
+    MarketDataTickCache& operator=(const MarketDataTickCache&) = delete;
+
+    void begin_tick() noexcept { ++epoch_; }
+
+    // 返回本纪元内该句柄的视图，不可读时返回 nullptr。
+    const MarketDataView* read(MarketDataHandle handle);
+
+    // 把本纪元尚未读取的句柄去重后一次交给 read_many()，篮子启动时各腿首轮推进直接命中。
+    void prefetch(std::span<const MarketDataHandle> handles);
+
+private:
+    struct entry {
+        uint64_t epoch = 0;
+        bool ok = false;
+        MarketDataView view{};
+    };
+
+    // 槽位条目按需堆上构造一次，已发出的视图指针不随表扩容失效。
+    entry* entry_for(MarketDataHandle handle);
+
+    MarketDataService* service_ = nullptr;
+    uint64_t epoch_ = 1;
+    std::vector<std::unique_ptr<entry>> entries_;
+    std::vector<MarketDataHandle> pending_handles_;  // prefetch 复用缓冲
+    std::vector<MarketDataView*> pending_views_;
+    std::vector<entry*> pending_entries_;
 };
 
 }  // namespace acct_service
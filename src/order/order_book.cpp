@@ -1,17 +1,25 @@
 #include "order/order_book.hpp"
 
 #include <algorithm>
+#include <bit>
 #include <limits>
+#include <memory>
+#include <new>
+#include <string>
 #include <utility>
 
 #include "common/error.hpp"
 #include "common/log.hpp"
 #include "common/security_identity.hpp"
+#include "order/order_state_machine.hpp"
 
 namespace acct_service {
 
 namespace {
 
+constexpr std::size_t kMinIndexCapacity = 64;
+constexpr std::size_t kInitialParentAggregates = 1024;  // 父单聚合池初始预留，超出后按需增长  // 小容量订单簿的哈希索引下限，避免探测链过短即满
+
 InternalOrderId saturated_next_order_id(InternalOrderId order_id) noexcept {
     if (order_id == std::numeric_limits<InternalOrderId>::max()) {
         return order_id;
@@ -19,40 +27,23 @@ InternalOrderId saturated_next_order_id(InternalOrderId order_id) noexcept {
     return order_id + 1;
 }
 
-bool is_terminal_state(OrderState status) {
-    switch (status) {
-        case OrderState::RiskControllerRejected:
-        case OrderState::TraderRejected:
-        case OrderState::TraderError:
-        case OrderState::BrokerRejected:
-        case OrderState::MarketRejected:
-        case OrderState::Finished:
-        case OrderState::Unknown:
-            return true;
-        default:
-            return false;
-    }
-}
-
-int status_progress_rank(OrderState status) {
-    switch (status) {
-        case OrderState::MarketAccepted:
-            return 7;
-        case OrderState::BrokerAccepted:
-            return 6;
-        case OrderState::TraderSubmitted:
-            return 5;
-        case OrderState::TraderPending:
-            return 4;
-        case OrderState::RiskControllerAccepted:
-            return 3;
-        case OrderState::RiskControllerPending:
-            return 2;
-        case OrderState::UserSubmitted:
-            return 1;
-        default:
-            return 0;
-    }
+constexpr bool is_terminal_state(OrderState status) noexcept { return order_state_is_terminal(status); }
+
+constexpr int status_progress_rank(OrderState status) noexcept { return order_state_progress_rank(status); }
+
+// status_progress_rank 的反查：等级 1..7 各对应唯一状态
+OrderState progress_state_of_rank(int rank) {
+    static constexpr OrderState kStates[8] = {
+        OrderState::NotSet,
+        OrderState::UserSubmitted,
+        OrderState::RiskControllerPending,
+        OrderState::RiskControllerAccepted,
+        OrderState::TraderPending,
+        OrderState::TraderSubmitted,
+        OrderState::BrokerAccepted,
+        OrderState::MarketAccepted,
+    };
+    return kStates[rank];
 }
 
 uint64_t saturating_add(uint64_t lhs, uint64_t rhs) {
@@ -79,50 +70,74 @@ bool OrderEntry::is_terminal() const noexcept {
     return is_terminal_state(request.order_state.load(std::memory_order_acquire));
 }
 
-OrderBook::OrderBook() {
-    free_slots_.reserve(kMaxActiveOrders);
-    for (std::size_t i = 0; i < kMaxActiveOrders; ++i) {
-        free_slots_.push_back(kMaxActiveOrders - 1 - i);
-    }
+// 订单条目与平行数组都在惰性落页映射中，构造只建立映射，不写任何一页；
+// 启动耗时与常驻内存随实际在簿订单数增长，而非 capacity 规模
+OrderBook::OrderBook(order_book_threading threading, std::size_t capacity, bool huge_pages)
+    : concurrent_(threading == order_book_threading::Concurrent),
+      capacity_(std::clamp<std::size_t>(capacity, 1, kMaxOrderBookCapacity)),
+      id_index_mask_(std::bit_ceil(capacity_) * 2 - 1),
+      child_link_capacity_(capacity_ * 2),
+      order_storage_(sizeof(OrderEntry) * capacity_, huge_pages, "order_book.orders"),
+      orders_(static_cast<OrderEntry*>(order_storage_.data())),
+      slot_order_ids_(capacity_, huge_pages, "order_book.slot_order_ids"),
+      slot_order_types_(capacity_, huge_pages, "order_book.slot_order_types"),
+      active_slot_bits_((capacity_ + 63) / 64, huge_pages, "order_book.active_slot_bits"),
+      id_slots_(id_index_mask_ + 1, huge_pages, "order_book.id_slots"),
+      archived_(id_index_mask_ + 1, huge_pages, "order_book.archived"),
+      id_overflow_(std::max<std::size_t>(capacity_ / 16, kMinIndexCapacity)),
+      broker_id_map_(std::max<std::size_t>(capacity_ * 2, kMinIndexCapacity)),
+      broker_slots_(id_index_mask_ + 1, huge_pages, "order_book.broker_slots"),
+      slot_links_(capacity_, huge_pages, "order_book.slot_links"),
+      parent_to_children_(std::max<std::size_t>(capacity_, kMinIndexCapacity)),
+      child_links_(child_link_capacity_, huge_pages, "order_book.child_links"),
+      child_to_parent_(std::max<std::size_t>(capacity_ * 2, kMinIndexCapacity)),
+      managed_parent_ids_(std::max<std::size_t>(capacity_, kMinIndexCapacity)) {
+    free_slots_.reserve(capacity_);
+    child_aggregates_.reserve(std::min(capacity_, kInitialParentAggregates));
 }
 
+OrderBook::~OrderBook() { std::destroy_n(orders_, slot_high_water_); }
+
 bool OrderBook::add_order(const OrderEntry& entry) {
     const InternalOrderId order_id = entry.request.internal_order_id;
     if (order_id == 0) {
-        ErrorStatus status =
-            ACCT_MAKE_ERROR(ErrorDomain::order, ErrorCode::InvalidOrderId, "OrderBook", "order id is zero", 0);
-        record_error(status);
-        ACCT_LOG_ERROR_STATUS(status);
+        ACCT_REPORT_ERROR(ErrorDomain::order, ErrorCode::InvalidOrderId, "OrderBook", "order id is zero", 0);
         return false;
     }
 
-    order_change_callback_t callback;
+    order_change_hook hook;
     OrderEntry snapshot{};
     {
-        LockGuard<SpinLock> guard(lock_);
+        book_guard guard(*this);
 
-        if (id_to_index_.find(order_id) != id_to_index_.end()) {
-            ErrorStatus status =
-                ACCT_MAKE_ERROR(ErrorDomain::order, ErrorCode::DuplicateOrder, "OrderBook", "duplicate order id", 0);
-            record_error(status);
-            ACCT_LOG_ERROR_STATUS(status);
+        if (find_order_nolock(order_id) != nullptr) {
+            ACCT_REPORT_ERROR(ErrorDomain::order, ErrorCode::DuplicateOrder, "OrderBook", "duplicate order id", 0);
             return false;
         }
 
-        if (free_slots_.empty()) {
-            ErrorStatus status = ACCT_MAKE_ERROR(ErrorDomain::order, ErrorCode::OrderBookFull, "OrderBook",
-                                                 "order book free slots exhausted", 0);
-            record_error(status);
-            ACCT_LOG_ERROR_STATUS(status);
+        const bool fresh_slot = free_slots_.empty();
+        if (fresh_slot && slot_high_water_ >= capacity_) {
+            ACCT_REPORT_ERROR(ErrorDomain::order, ErrorCode::OrderBookFull, "OrderBook",
+                              "order book free slots exhausted", 0);
             return false;
         }
 
-        const std::size_t index = free_slots_.back();
-        free_slots_.pop_back();
+        const std::size_t index = fresh_slot ? slot_high_water_ : free_slots_.back();
+        if (!index_order_id_nolock(order_id, index)) {
+            ACCT_REPORT_ERROR(ErrorDomain::order, ErrorCode::OrderBookFull, "OrderBook",
+                              "order id overflow index exhausted", 0);
+            return false;
+        }
+        if (fresh_slot) {
+            ::new (static_cast<void*>(orders_ + index)) OrderEntry{};
+            ++slot_high_water_;
+        } else {
+            free_slots_.pop_back();
+        }
 
         OrderEntry stored = entry;
         if (stored.submit_time_ns == 0) {
-            stored.submit_time_ns = now_ns();
+            stored.submit_time_ns = clock_now_ns(clock_);
         }
         if (stored.last_update_ns == 0) {
             stored.last_update_ns = stored.submit_time_ns;
@@ -134,113 +149,165 @@ bool OrderBook::add_order(const OrderEntry& entry) {
         }
 
         orders_[index] = stored;
-        id_to_index_[order_id] = index;
+        slot_order_ids_[index] = order_id;
+        slot_order_types_[index] = stored.request.order_type;
+        active_slot_bits_[index / 64] |= uint64_t{1} << (index % 64);
         ensure_next_order_id_at_least(saturated_next_order_id(order_id));
 
         if (stored.request.broker_order_id.as_uint != 0) {
-            broker_id_map_[stored.request.broker_order_id.as_uint] = order_id;
+            // 入簿时已带编号的只有恢复/外部构造的订单，编号来源未知，按哈希登记
+            index_broker_id_nolock(stored.request.broker_order_id.as_uint, order_id, index, false);
         }
 
         if (!stored.request.internal_security_id.empty()) {
             InternalSecurityId security_id;
             if (normalize_order_security_key(stored.request.internal_security_id.view(), security_id)) {
                 stored.request.internal_security_id = security_id;
-                security_orders_[security_id].push_back(order_id);
+                link_security_nolock(security_id, index);
             }
         }
 
         if (stored.is_split_child && stored.parent_order_id != 0) {
-            parent_to_children_[stored.parent_order_id].push_back(order_id);
-            child_to_parent_[order_id] = stored.parent_order_id;
+            link_child_nolock(stored.parent_order_id, order_id);
+            if (!child_to_parent_.insert_or_assign(order_id, stored.parent_order_id)) {
+                report_index_full_nolock("child_to_parent");
+            }
+            if (stored.request.order_type == OrderType::New) {
+                const child_contribution added = contribution_of(orders_[index]);
+                apply_child_delta_nolock(stored.parent_order_id, nullptr, &added);
+            }
             if (!is_managed_parent_nolock(stored.parent_order_id)) {
-                refresh_parent_from_children_nolock(stored.parent_order_id);
+                refresh_parent_from_children_nolock(stored.parent_order_id, stored.last_update_ns);
             }
         }
 
         ++active_count_;
         snapshot = orders_[index];
-        callback = change_callback_;
+        hook = change_hook_;
     }
 
-    if (callback) {
-        callback(snapshot, order_book_event_t::Added);
+    if (hook) {
+        hook(snapshot, order_book_event_t::Added);
     }
     return true;
 }
 
 OrderEntry* OrderBook::find_order(InternalOrderId order_id) {
-    LockGuard<SpinLock> guard(lock_);
+    book_guard guard(*this);
     return find_order_nolock(order_id);
 }
 
 const OrderEntry* OrderBook::find_order(InternalOrderId order_id) const {
-    LockGuard<SpinLock> guard(lock_);
+    book_guard guard(*this);
     return find_order_nolock(order_id);
 }
 
+void OrderBook::prefetch_order(InternalOrderId order_id) const noexcept {
+    if (concurrent_) {
+        return;
+    }
+    const uint32_t slot = id_slots_[order_id & id_index_mask_];
+    if (slot == 0) {
+        return;
+    }
+    const char* base = reinterpret_cast<const char*>(&orders_[slot - 1]);
+    for (std::size_t offset = 0; offset < sizeof(OrderEntry); offset += 64) {
+        __builtin_prefetch(base + offset, 1, 3);
+    }
+}
+
 OrderEntry* OrderBook::find_by_broker_id(uint64_t broker_order_id) {
-    LockGuard<SpinLock> guard(lock_);
+    if (broker_order_id == 0) {
+        return nullptr;
+    }
+    book_guard guard(*this);
 
-    const auto id_it = broker_id_map_.find(broker_order_id);
-    if (id_it == broker_id_map_.end()) {
+    if (broker_id_base_ != 0) {
+        const broker_slot& slot = broker_slots_[(broker_order_id - broker_id_base_) & id_index_mask_];
+        if (slot.broker_order_id == broker_order_id) {
+            return orders_ + slot.index;
+        }
+    }
+    if (broker_id_map_.empty()) {
+        return nullptr;
+    }
+    const InternalOrderId* order_id = broker_id_map_.find(broker_order_id);
+    if (!order_id) {
         return nullptr;
     }
-    return find_order_nolock(id_it->second);
+    return find_order_nolock(*order_id);
+}
+
+bool OrderBook::bind_broker_order_id(InternalOrderId order_id, uint64_t broker_order_id, bool dense) {
+    if (broker_order_id == 0) {
+        return false;
+    }
+    book_guard guard(*this);
+
+    const uint32_t index = find_slot_nolock(order_id);
+    if (index == kNilLink) {
+        return false;
+    }
+    OrderEntry& entry = orders_[index];
+    if (entry.request.broker_order_id.as_uint != 0) {
+        return false;
+    }
+    entry.request.broker_order_id.as_uint = broker_order_id;
+    index_broker_id_nolock(broker_order_id, order_id, index, dense);
+    return true;
 }
 
 bool OrderBook::update_state(InternalOrderId order_id, OrderState new_state) {
-    order_change_callback_t callback;
+    order_change_hook hook;
     OrderEntry snapshot{};
     {
-        LockGuard<SpinLock> guard(lock_);
+        book_guard guard(*this);
 
         OrderEntry* entry = find_order_nolock(order_id);
         if (!entry) {
-            ErrorStatus status = ACCT_MAKE_ERROR(ErrorDomain::order, ErrorCode::OrderNotFound, "OrderBook",
-                                                 "update_state order not found", 0);
-            record_error(status);
-            ACCT_LOG_ERROR_STATUS(status);
+            ACCT_REPORT_ERROR(ErrorDomain::order, ErrorCode::OrderNotFound, "OrderBook",
+                              "update_state order not found", 0);
             return false;
         }
 
+        const child_contribution before = contribution_of(*entry);
         entry->request.order_state.store(new_state, std::memory_order_release);
-        entry->last_update_ns = now_ns();
+        entry->last_update_ns = clock_now_ns(clock_);
 
-        if (new_state == OrderState::TraderError && parent_to_children_.find(order_id) != parent_to_children_.end() &&
-            !is_managed_parent_nolock(order_id)) {
-            split_parent_error_latched_.insert(order_id);
+        if (new_state == OrderState::TraderError && !is_managed_parent_nolock(order_id)) {
+            if (child_aggregate* aggregate = aggregate_for_nolock(order_id)) {
+                aggregate->error_latched = true;
+            }
         }
 
-        const auto parent_it = child_to_parent_.find(order_id);
-        if (parent_it != child_to_parent_.end() && !is_managed_parent_nolock(parent_it->second)) {
-            refresh_parent_from_children_nolock(parent_it->second);
+        if (const InternalOrderId* parent_id = child_to_parent_.find(order_id)) {
+            on_child_changed_nolock(*parent_id, *entry, before);
         }
 
         snapshot = *entry;
-        callback = change_callback_;
+        hook = change_hook_;
     }
 
-    if (callback) {
-        callback(snapshot, order_book_event_t::StatusUpdated);
+    if (hook) {
+        hook(snapshot, order_book_event_t::StatusUpdated);
     }
     return true;
 }
 
 bool OrderBook::update_trade(InternalOrderId order_id, Volume vol, DPrice px, DValue val, DValue fee) {
-    order_change_callback_t callback;
+    order_change_hook hook;
     OrderEntry snapshot{};
     {
-        LockGuard<SpinLock> guard(lock_);
+        book_guard guard(*this);
 
         OrderEntry* entry = find_order_nolock(order_id);
         if (!entry) {
-            ErrorStatus status = ACCT_MAKE_ERROR(ErrorDomain::order, ErrorCode::OrderNotFound, "OrderBook",
-                                                 "update_trade order not found", 0);
-            record_error(status);
-            ACCT_LOG_ERROR_STATUS(status);
+            ACCT_REPORT_ERROR(ErrorDomain::order, ErrorCode::OrderNotFound, "OrderBook",
+                              "update_trade order not found", 0);
             return false;
         }
 
+        const child_contribution before = contribution_of(*entry);
         OrderRequest& request = entry->request;
         request.volume_traded = saturating_add(request.volume_traded, vol);
         if (request.volume_entrust > 0 && request.volume_traded > request.volume_entrust) {
@@ -271,58 +338,99 @@ bool OrderBook::update_trade(InternalOrderId order_id, Volume vol, DPrice px, DV
             }
         }
 
-        entry->last_update_ns = now_ns();
+        entry->last_update_ns = clock_now_ns(clock_);
 
-        const auto parent_it = child_to_parent_.find(order_id);
-        if (parent_it != child_to_parent_.end() && !is_managed_parent_nolock(parent_it->second)) {
-            refresh_parent_from_children_nolock(parent_it->second);
+        if (const InternalOrderId* parent_id = child_to_parent_.find(order_id)) {
+            on_child_changed_nolock(*parent_id, *entry, before);
         }
 
         snapshot = *entry;
-        callback = change_callback_;
+        hook = change_hook_;
     }
 
-    if (callback) {
-        callback(snapshot, order_book_event_t::TradeUpdated);
+    if (hook) {
+        hook(snapshot, order_book_event_t::TradeUpdated);
+    }
+    return true;
+}
+
+bool OrderBook::amend_order(InternalOrderId order_id, Volume volume_entrust, DPrice dprice_entrust) {
+    order_change_hook hook;
+    OrderEntry snapshot{};
+    {
+        book_guard guard(*this);
+
+        OrderEntry* entry = find_order_nolock(order_id);
+        if (!entry) {
+            ACCT_REPORT_ERROR(ErrorDomain::order, ErrorCode::OrderNotFound, "OrderBook",
+                              "amend_order order not found", 0);
+            return false;
+        }
+
+        OrderRequest& request = entry->request;
+        if (request.order_type != OrderType::New || entry->is_terminal() || dprice_entrust == 0 ||
+            volume_entrust <= request.volume_traded) {
+            ACCT_REPORT_ERROR(ErrorDomain::order, ErrorCode::InvalidParam, "OrderBook",
+                              "amend_order rejected for order state or volume", 0);
+            return false;
+        }
+
+        const child_contribution before = contribution_of(*entry);
+        request.volume_entrust = volume_entrust;
+        request.volume_remain = volume_entrust - request.volume_traded;
+        request.dprice_entrust = dprice_entrust;
+        entry->last_update_ns = clock_now_ns(clock_);
+
+        if (const InternalOrderId* parent_id = child_to_parent_.find(order_id)) {
+            on_child_changed_nolock(*parent_id, *entry, before);
+        }
+
+        snapshot = *entry;
+        hook = change_hook_;
+    }
+
+    if (hook) {
+        hook(snapshot, order_book_event_t::Amended);
     }
     return true;
 }
 
 // 标记执行引擎托管的父单，后续子单变更不再触发旧聚合刷新。
 bool OrderBook::mark_managed_parent(InternalOrderId parent_id) {
-    LockGuard<SpinLock> guard(lock_);
+    book_guard guard(*this);
 
     OrderEntry* parent = find_order_nolock(parent_id);
     if (!parent) {
-        ErrorStatus status = ACCT_MAKE_ERROR(ErrorDomain::order, ErrorCode::OrderNotFound, "OrderBook",
-                                             "mark_managed_parent parent not found", 0);
-        record_error(status);
-        ACCT_LOG_ERROR_STATUS(status);
+        ACCT_REPORT_ERROR(ErrorDomain::order, ErrorCode::OrderNotFound, "OrderBook",
+                          "mark_managed_parent parent not found", 0);
         return false;
     }
 
-    managed_parent_ids_.insert(parent_id);
+    if (!managed_parent_ids_.insert(parent_id)) {
+        report_index_full_nolock("managed_parent_ids");
+        return false;
+    }
     return true;
 }
 
 // 用执行引擎的派生视图覆盖受管父单镜像，避免被旧的 child volume_remain 语义污染。
 bool OrderBook::sync_managed_parent_view(InternalOrderId parent_id, const ManagedParentView& view,
                                          OrderState parent_state) {
-    order_change_callback_t callback;
+    order_change_hook hook;
     OrderEntry snapshot{};
     {
-        LockGuard<SpinLock> guard(lock_);
+        book_guard guard(*this);
 
         OrderEntry* parent = find_order_nolock(parent_id);
         if (!parent) {
-            ErrorStatus status = ACCT_MAKE_ERROR(ErrorDomain::order, ErrorCode::OrderNotFound, "OrderBook",
-                                                 "sync_managed_parent_view parent not found", 0);
-            record_error(status);
-            ACCT_LOG_ERROR_STATUS(status);
+            ACCT_REPORT_ERROR(ErrorDomain::order, ErrorCode::OrderNotFound, "OrderBook",
+                              "sync_managed_parent_view parent not found", 0);
             return false;
         }
 
-        managed_parent_ids_.insert(parent_id);
+        if (!managed_parent_ids_.insert(parent_id)) {
+            report_index_full_nolock("managed_parent_ids");
+        }
         const Volume next_volume_remain = (view.target_volume >= view.confirmed_traded_volume)
                                               ? (view.target_volume - view.confirmed_traded_volume)
                                               : 0;
@@ -357,129 +465,190 @@ bool OrderBook::sync_managed_parent_view(InternalOrderId parent_id, const Manage
         parent->request.dfee_executed = view.confirmed_fee;
         parent->request.dprice_traded = next_dprice_traded;
         parent->request.order_state.store(parent_state, std::memory_order_release);
-        parent->last_update_ns = now_ns();
+        parent->last_update_ns = clock_now_ns(clock_);
 
         snapshot = *parent;
-        callback = change_callback_;
+        hook = change_hook_;
     }
 
-    if (callback) {
-        callback(snapshot, order_book_event_t::ParentRefreshed);
+    if (hook) {
+        hook(snapshot, order_book_event_t::ParentRefreshed);
     }
     return true;
 }
 
 bool OrderBook::archive_order(InternalOrderId order_id) {
-    order_change_callback_t callback;
+    order_change_hook hook;
     OrderEntry snapshot{};
     {
-        LockGuard<SpinLock> guard(lock_);
-
-        const auto it = id_to_index_.find(order_id);
-        if (it == id_to_index_.end()) {
-            ErrorStatus status = ACCT_MAKE_ERROR(ErrorDomain::order, ErrorCode::OrderNotFound, "OrderBook",
-                                                 "archive_order order not found", 0);
-            record_error(status);
-            ACCT_LOG_ERROR_STATUS(status);
+        book_guard guard(*this);
+
+        const OrderEntry* found = find_order_nolock(order_id);
+        if (!found) {
+            ACCT_REPORT_ERROR(ErrorDomain::order, ErrorCode::OrderNotFound, "OrderBook",
+                              "archive_order order not found", 0);
             return false;
         }
 
-        const std::size_t index = it->second;
-        const OrderEntry& entry = orders_[index];
+        const std::size_t index = static_cast<std::size_t>(found - orders_);
+        const OrderEntry& entry = *found;
         snapshot = entry;
 
         if (entry.request.broker_order_id.as_uint != 0) {
-            const auto broker_it = broker_id_map_.find(entry.request.broker_order_id.as_uint);
-            if (broker_it != broker_id_map_.end() && broker_it->second == order_id) {
-                broker_id_map_.erase(broker_it);
-            }
+            unindex_broker_id_nolock(entry.request.broker_order_id.as_uint, order_id);
         }
 
         if (!entry.request.internal_security_id.empty()) {
             InternalSecurityId security_id;
-            const bool has_security_id =
-                normalize_order_security_key(entry.request.internal_security_id.view(), security_id);
-            auto sec_it = has_security_id ? security_orders_.find(security_id) : security_orders_.end();
-            if (sec_it != security_orders_.end()) {
-                auto& orders = sec_it->second;
-                orders.erase(std::remove(orders.begin(), orders.end(), order_id), orders.end());
-                if (orders.empty()) {
-                    security_orders_.erase(sec_it);
-                }
+            if (normalize_order_security_key(entry.request.internal_security_id.view(), security_id)) {
+                unlink_security_nolock(security_id, index);
             }
         }
 
-        id_to_index_.erase(it);
-        managed_parent_ids_.erase(order_id);
-        split_parent_error_latched_.erase(order_id);
+        const bool is_split_child = entry.is_split_child && entry.parent_order_id != 0;
+        const InternalOrderId parent_id = entry.parent_order_id;
+        if (is_split_child && entry.request.order_type == OrderType::New) {
+            const child_contribution removed = contribution_of(entry);
+            apply_child_delta_nolock(parent_id, &removed, nullptr);
+        }
+        unindex_order_id_nolock(order_id, index);
+        archived_[order_id & id_index_mask_] = archived_slot{order_id, entry.shm_order_index};
+        ++archived_count_;
+        (void)managed_parent_ids_.erase(order_id);
+        if (child_aggregate* aggregate = aggregate_for_nolock(order_id)) {
+            aggregate->error_latched = false;
+        }
         orders_[index] = OrderEntry{};
+        slot_order_ids_[index] = 0;
+        slot_order_types_[index] = OrderType::NotSet;
+        active_slot_bits_[index / 64] &= ~(uint64_t{1} << (index % 64));
         free_slots_.push_back(index);
 
+        if (is_split_child) {
+            if (child_list* siblings = parent_to_children_.find(parent_id); siblings && siblings->live_count > 0) {
+                --siblings->live_count;
+            }
+            release_child_list_if_idle_nolock(parent_id);
+        }
+        release_child_list_if_idle_nolock(order_id);
+
         if (active_count_ > 0) {
             --active_count_;
         }
 
-        callback = change_callback_;
+        hook = change_hook_;
     }
 
-    if (callback) {
-        callback(snapshot, order_book_event_t::Archived);
+    if (hook) {
+        hook(snapshot, order_book_event_t::Archived);
     }
     return true;
 }
 
 std::vector<InternalOrderId> OrderBook::get_active_order_ids() const {
-    LockGuard<SpinLock> guard(lock_);
+    book_guard guard(*this);
 
     std::vector<InternalOrderId> result;
-    result.reserve(id_to_index_.size());
-    for (const auto& kv : id_to_index_) {
-        result.push_back(kv.first);
-    }
+    result.reserve(active_count_);
+    auto collect = [&result](const OrderEntry& entry) { result.push_back(entry.request.internal_order_id); };
+    (void)visit_active_nolock(0, SIZE_MAX, collect);
     return result;
 }
 
 std::vector<InternalOrderId> OrderBook::get_orders_by_security(InternalSecurityId security_id) const {
-    LockGuard<SpinLock> guard(lock_);
+    book_guard guard(*this);
 
     InternalSecurityId normalized_security_id;
     if (!normalize_order_security_key(security_id.view(), normalized_security_id)) {
         return {};
     }
 
-    const auto it = security_orders_.find(normalized_security_id);
-    if (it == security_orders_.end()) {
-        return {};
+    std::vector<InternalOrderId> result;
+    const security_list* orders = security_orders_.find(normalized_security_id);
+    if (!orders) {
+        return result;
+    }
+    for (uint32_t index = orders->head; index != kNilLink; index = slot_links_[index].security_next) {
+        result.push_back(slot_order_ids_[index]);
     }
-    return it->second;
+    return result;
 }
 
 std::vector<InternalOrderId> OrderBook::get_children(InternalOrderId parent_id) const {
-    LockGuard<SpinLock> guard(lock_);
+    book_guard guard(*this);
 
-    const auto it = parent_to_children_.find(parent_id);
-    if (it == parent_to_children_.end()) {
-        return {};
+    std::vector<InternalOrderId> result;
+    const child_list* children = parent_to_children_.find(parent_id);
+    if (!children) {
+        return result;
     }
-    return it->second;
+    for (uint32_t link = children->head; link != kNilLink; link = child_links_[link].next) {
+        result.push_back(child_links_[link].child_id);
+    }
+    return result;
 }
 
 bool OrderBook::try_get_parent(InternalOrderId child_id, InternalOrderId& out_parent_id) const noexcept {
-    LockGuard<SpinLock> guard(lock_);
+    book_guard guard(*this);
+
+    const InternalOrderId* parent_id = child_to_parent_.find(child_id);
+    if (!parent_id) {
+        return false;
+    }
+    out_parent_id = *parent_id;
+    return true;
+}
 
-    const auto it = child_to_parent_.find(child_id);
-    if (it == child_to_parent_.end()) {
+bool OrderBook::find_archived(InternalOrderId order_id, OrderIndex& out_shm_order_index) const noexcept {
+    if (order_id == 0) {
+        return false;
+    }
+    book_guard guard(*this);
+    const archived_slot& slot = archived_[order_id & id_index_mask_];
+    if (slot.order_id != order_id || find_slot_nolock(order_id) != kNilLink) {
         return false;
     }
-    out_parent_id = it->second;
+    out_shm_order_index = slot.shm_order_index;
     return true;
 }
 
+uint64_t OrderBook::archived_count() const noexcept {
+    book_guard guard(*this);
+    return archived_count_;
+}
+
 std::size_t OrderBook::active_count() const noexcept {
-    LockGuard<SpinLock> guard(lock_);
+    book_guard guard(*this);
     return active_count_;
 }
 
+memory_usage OrderBook::storage_memory() const noexcept {
+    book_guard guard(*this);
+    memory_usage usage = element_memory(capacity_, slot_high_water_, sizeof(OrderEntry));
+    usage += slot_order_ids_.memory(slot_high_water_);
+    usage += slot_order_types_.memory(slot_high_water_);
+    usage += active_slot_bits_.memory((slot_high_water_ + 63) / 64);
+    usage += slot_links_.memory(slot_high_water_);
+    usage += element_memory(free_slots_.capacity(), free_slots_.size(), sizeof(std::size_t));
+    return usage;
+}
+
+memory_usage OrderBook::index_memory() const noexcept {
+    book_guard guard(*this);
+    memory_usage usage = id_slots_.memory(active_count_);
+    usage += archived_.memory(static_cast<std::size_t>(archived_count_));
+    usage += broker_slots_.memory(active_count_);
+    usage += id_overflow_.memory();
+    usage += broker_id_map_.memory();
+    usage += security_orders_.memory();
+    usage += parent_to_children_.memory();
+    usage += child_to_parent_.memory();
+    usage += managed_parent_ids_.memory();
+    usage += child_links_.memory(child_link_used_);
+    usage += element_memory(child_aggregates_.capacity(), child_aggregates_.size(), sizeof(child_aggregate));
+    return usage;
+}
+
 InternalOrderId OrderBook::next_order_id() noexcept { return next_order_id_.fetch_add(1, std::memory_order_relaxed); }
 
 void OrderBook::ensure_next_order_id_at_least(InternalOrderId next_id) noexcept {
@@ -493,149 +662,387 @@ void OrderBook::ensure_next_order_id_at_least(InternalOrderId next_id) noexcept
 }
 
 void OrderBook::clear() {
-    LockGuard<SpinLock> guard(lock_);
+    book_guard guard(*this);
 
-    id_to_index_.clear();
+    // 整段归还已落页，清空后的常驻内存回到零，下一轮按需重新落页
+    id_slots_.reset();
+    archived_.reset();
+    archived_count_ = 0;
+    id_overflow_.clear();
     broker_id_map_.clear();
+    broker_slots_.reset();
+    broker_id_base_ = 0;
     security_orders_.clear();
     parent_to_children_.clear();
+    child_link_free_ = kNilLink;
+    child_link_used_ = 0;
     child_to_parent_.clear();
     managed_parent_ids_.clear();
-    split_parent_error_latched_.clear();
+    child_aggregates_.clear();
+    child_aggregate_free_ = kNilLink;
 
     free_slots_.clear();
-    free_slots_.reserve(kMaxActiveOrders);
-
-    for (std::size_t i = 0; i < kMaxActiveOrders; ++i) {
-        orders_[i] = OrderEntry{};
-        free_slots_.push_back(kMaxActiveOrders - 1 - i);
-    }
+    slot_order_ids_.reset();
+    slot_order_types_.reset();
+    active_slot_bits_.reset();
+    std::destroy_n(orders_, slot_high_water_);
+    order_storage_.reset();
+    slot_high_water_ = 0;
 
     active_count_ = 0;
 }
 
+void OrderBook::prefault_slots(std::size_t count) noexcept {
+    book_guard guard(*this);
+
+    // 已构造区间必然驻留；未构造区间是裸存储，按页写零即可落页，不影响后续 construct_at
+    const std::size_t end = std::min(count, capacity_);
+    if (end <= slot_high_water_) {
+        return;
+    }
+    constexpr std::size_t kPageSize = 4096;
+    auto* begin = reinterpret_cast<volatile unsigned char*>(orders_ + slot_high_water_);
+    const std::size_t bytes = (end - slot_high_water_) * sizeof(OrderEntry);
+    for (std::size_t offset = 0; offset < bytes; offset += kPageSize) {
+        begin[offset] = 0;
+    }
+}
+
 void OrderBook::set_change_callback(order_change_callback_t callback) {
-    LockGuard<SpinLock> guard(lock_);
+    book_guard guard(*this);
     change_callback_ = std::move(callback);
+    if (change_callback_) {
+        change_hook_.fn = [](void* context, const OrderEntry& entry, order_book_event_t event) {
+            static_cast<OrderBook*>(context)->change_callback_(entry, event);
+        };
+        change_hook_.context = this;
+    } else {
+        change_hook_ = {};
+    }
+}
+
+void OrderBook::set_change_hook(order_change_hook hook) noexcept {
+    book_guard guard(*this);
+    change_callback_ = {};
+    change_hook_ = hook;
 }
 
 bool OrderBook::is_managed_parent_nolock(InternalOrderId parent_id) const noexcept {
-    return managed_parent_ids_.find(parent_id) != managed_parent_ids_.end();
+    return managed_parent_ids_.contains(parent_id);
 }
 
-OrderEntry* OrderBook::find_order_nolock(InternalOrderId order_id) {
-    const auto it = id_to_index_.find(order_id);
-    if (it == id_to_index_.end()) {
-        return nullptr;
+// 内部订单ID低位即订单池槽位下标，窗口不小于订单池容量，同一纪元内按窗口取模不会冲突；
+// 同窗口位置已被其他存活订单占用（外部发号、测试构造的订单号）时才使用溢出表。
+bool OrderBook::index_order_id_nolock(InternalOrderId order_id, std::size_t index) {
+    uint32_t& slot = id_slots_[order_id & id_index_mask_];
+    if (slot == 0) {
+        slot = static_cast<uint32_t>(index + 1);
+        return true;
     }
-    return &orders_[it->second];
+    return id_overflow_.insert_or_assign(order_id, static_cast<uint32_t>(index));
 }
 
-const OrderEntry* OrderBook::find_order_nolock(InternalOrderId order_id) const {
-    const auto it = id_to_index_.find(order_id);
-    if (it == id_to_index_.end()) {
-        return nullptr;
+void OrderBook::unindex_order_id_nolock(InternalOrderId order_id, std::size_t index) {
+    uint32_t& slot = id_slots_[order_id & id_index_mask_];
+    if (slot == index + 1) {
+        slot = 0;
+        return;
     }
-    return &orders_[it->second];
+    (void)id_overflow_.erase(order_id);
 }
 
-void OrderBook::refresh_parent_from_children_nolock(InternalOrderId parent_id) {
-    if (is_managed_parent_nolock(parent_id)) {
-        return;
+// 递增发号的柜台编号减去基址后与存活订单一一对应到窗口内，窗口不小于 2 倍容量，
+// 仅当存活订单的编号跨度超过窗口（极老的挂单未撤）时同址冲突，冲突项落哈希表
+void OrderBook::index_broker_id_nolock(uint64_t broker_order_id, InternalOrderId order_id, std::size_t index,
+                                       bool dense) {
+    if (dense) {
+        if (broker_id_base_ == 0) {
+            broker_id_base_ = broker_order_id;
+        }
+        broker_slot& slot = broker_slots_[(broker_order_id - broker_id_base_) & id_index_mask_];
+        if (slot.broker_order_id == 0 || slot.broker_order_id == broker_order_id) {
+            slot = broker_slot{broker_order_id, static_cast<uint32_t>(index)};
+            return;
+        }
+    }
+    if (!broker_id_map_.insert_or_assign(broker_order_id, order_id)) {
+        report_index_full_nolock("broker_id_map");
     }
+}
 
-    OrderEntry* parent = find_order_nolock(parent_id);
-    if (!parent) {
-        ErrorStatus status = ACCT_MAKE_ERROR(ErrorDomain::order, ErrorCode::OrderInvariantBroken, "OrderBook",
-                                             "parent missing while refreshing split state", 0);
-        record_error(status);
-        ACCT_LOG_ERROR_STATUS(status);
+void OrderBook::unindex_broker_id_nolock(uint64_t broker_order_id, InternalOrderId order_id) {
+    if (broker_id_base_ != 0) {
+        broker_slot& slot = broker_slots_[(broker_order_id - broker_id_base_) & id_index_mask_];
+        if (slot.broker_order_id == broker_order_id && slot_order_ids_[slot.index] == order_id) {
+            slot = broker_slot{};
+            return;
+        }
+    }
+    const InternalOrderId* mapped_id = broker_id_map_.find(broker_order_id);
+    if (mapped_id && *mapped_id == order_id) {
+        (void)broker_id_map_.erase(broker_order_id);
+    }
+}
+
+void OrderBook::report_index_full_nolock(const char* index_name) const {
+    ErrorStatus status = ACCT_MAKE_ERROR(ErrorDomain::order, ErrorCode::OrderBookFull, "OrderBook",
+                                         std::string(index_name) + " index capacity exhausted", 0);
+    record_error(status);
+    ACCT_LOG_ERROR_STATUS(status);
+}
+
+// 节点优先复用回收栈，其次从节点池未切出的部分顺序切出，避免构造时整段初始化
+void OrderBook::link_child_nolock(InternalOrderId parent_id, InternalOrderId child_id) {
+    child_list* children = parent_to_children_.try_emplace(parent_id);
+    if (!children) {
+        report_index_full_nolock("parent_to_children");
         return;
     }
+    if (children->aggregate == kNilLink) {
+        if (child_aggregate_free_ != kNilLink) {
+            children->aggregate = child_aggregate_free_;
+            child_aggregate_free_ = child_aggregates_[child_aggregate_free_].next_free;
+            child_aggregates_[children->aggregate] = child_aggregate{};
+        } else {
+            children->aggregate = static_cast<uint32_t>(child_aggregates_.size());
+            child_aggregates_.emplace_back();
+        }
+    }
 
-    const auto children_it = parent_to_children_.find(parent_id);
-    if (children_it == parent_to_children_.end()) {
+    uint32_t link = child_link_free_;
+    if (link != kNilLink) {
+        child_link_free_ = child_links_[link].next;
+    } else if (child_link_used_ < child_link_capacity_) {
+        link = child_link_used_++;
+    } else {
+        ++children->live_count;
+        report_index_full_nolock("child_links");
         return;
     }
 
-    Volume total_volume_traded = 0;
-    Volume total_volume_remain = 0;
-    DValue total_dvalue_traded = 0;
-    DValue total_fee = 0;
-    TimestampNs latest_update_ns = parent->last_update_ns;
+    child_links_[link] = child_link{child_id, kNilLink};
+    if (children->tail == kNilLink) {
+        children->head = link;
+    } else {
+        child_links_[children->tail].next = link;
+    }
+    children->tail = link;
+    ++children->live_count;
+}
 
-    bool all_terminal = true;
-    OrderState best_progress_status = OrderState::NotSet;
-    int best_progress_rank = -1;
-    std::size_t new_child_count = 0;
+void OrderBook::release_child_list_if_idle_nolock(InternalOrderId parent_id) {
+    const child_list* children = parent_to_children_.find(parent_id);
+    if (!children || children->live_count != 0 || find_order_nolock(parent_id) != nullptr) {
+        return;
+    }
 
-    for (InternalOrderId child_id : children_it->second) {
-        const OrderEntry* child = find_order_nolock(child_id);
-        if (!child) {
-            continue;
+    uint32_t link = children->head;
+    while (link != kNilLink) {
+        const uint32_t next = child_links_[link].next;
+        const InternalOrderId child_id = child_links_[link].child_id;
+        const InternalOrderId* mapped_parent = child_to_parent_.find(child_id);
+        if (mapped_parent && *mapped_parent == parent_id) {
+            (void)child_to_parent_.erase(child_id);
         }
+        child_links_[link].next = child_link_free_;
+        child_link_free_ = link;
+        link = next;
+    }
+    if (children->aggregate != kNilLink) {
+        child_aggregates_[children->aggregate].next_free = child_aggregate_free_;
+        child_aggregate_free_ = children->aggregate;
+    }
+    (void)parent_to_children_.erase(parent_id);
+}
 
-        if (child->request.order_type != OrderType::New) {
-            continue;
-        }
+void OrderBook::link_security_nolock(InternalSecurityId security_id, std::size_t index) {
+    security_list* orders = security_orders_.try_emplace(security_id);
+    if (!orders) {
+        report_index_full_nolock("security_orders");
+        return;
+    }
 
-        ++new_child_count;
+    const uint32_t slot = static_cast<uint32_t>(index);
+    slot_links_[slot] = slot_links{orders->tail, kNilLink};
+    if (orders->tail == kNilLink) {
+        orders->head = slot;
+    } else {
+        slot_links_[orders->tail].security_next = slot;
+    }
+    orders->tail = slot;
+}
 
-        total_volume_traded = saturating_add(total_volume_traded, child->request.volume_traded);
-        total_volume_remain = saturating_add(total_volume_remain, child->request.volume_remain);
-        total_dvalue_traded = saturating_add(total_dvalue_traded, child->request.dvalue_traded);
-        total_fee = saturating_add(total_fee, child->request.dfee_executed);
-        latest_update_ns = std::max(latest_update_ns, child->last_update_ns);
+void OrderBook::unlink_security_nolock(InternalSecurityId security_id, std::size_t index) {
+    security_list* orders = security_orders_.find(security_id);
+    if (!orders) {
+        return;
+    }
 
-        const OrderState child_status = child->request.order_state.load(std::memory_order_acquire);
-        if (!is_terminal_state(child_status)) {
-            all_terminal = false;
-        }
+    const uint32_t slot = static_cast<uint32_t>(index);
+    const slot_links links = slot_links_[slot];
+    if (links.security_prev == kNilLink && orders->head != slot) {
+        return;  // 登记时证券索引已满，槽位不在链表中
+    }
+    if (links.security_prev != kNilLink) {
+        slot_links_[links.security_prev].security_next = links.security_next;
+    } else {
+        orders->head = links.security_next;
+    }
+    if (links.security_next != kNilLink) {
+        slot_links_[links.security_next].security_prev = links.security_prev;
+    } else {
+        orders->tail = links.security_prev;
+    }
+    slot_links_[slot] = slot_links{};
+    if (orders->head == kNilLink) {
+        (void)security_orders_.erase(security_id);
+    }
+}
 
-        const int rank = status_progress_rank(child_status);
-        if (rank > best_progress_rank) {
-            best_progress_rank = rank;
-            best_progress_status = child_status;
-        }
+OrderEntry* OrderBook::find_order_nolock(InternalOrderId order_id) {
+    return const_cast<OrderEntry*>(static_cast<const OrderBook*>(this)->find_order_nolock(order_id));
+}
+
+const OrderEntry* OrderBook::find_order_nolock(InternalOrderId order_id) const {
+    const uint32_t index = find_slot_nolock(order_id);
+    return index == kNilLink ? nullptr : &orders_[index];
+}
+
+uint32_t OrderBook::find_slot_nolock(InternalOrderId order_id) const noexcept {
+    const uint32_t slot = id_slots_[order_id & id_index_mask_];
+    if (slot != 0 && slot_order_ids_[slot - 1] == order_id) {
+        return slot - 1;
+    }
+    if (id_overflow_.empty()) {
+        return kNilLink;
+    }
+    const uint32_t* index = id_overflow_.find(order_id);
+    return index ? *index : kNilLink;
+}
+
+OrderBook::child_contribution OrderBook::contribution_of(const OrderEntry& child) noexcept {
+    return child_contribution{child.request.volume_traded, child.request.volume_remain, child.request.dvalue_traded,
+                              child.request.dfee_executed, child.request.order_state.load(std::memory_order_acquire)};
+}
+
+OrderBook::child_aggregate* OrderBook::aggregate_for_nolock(InternalOrderId parent_id) noexcept {
+    const child_list* children = parent_to_children_.find(parent_id);
+    if (!children || children->aggregate == kNilLink) {
+        return nullptr;
+    }
+    return &child_aggregates_[children->aggregate];
+}
+
+// 聚合按无符号模运算增减：每个子单的贡献先加后减成对出现，总和不溢出时结果精确
+void OrderBook::apply_child_delta_nolock(InternalOrderId parent_id, const child_contribution* before,
+                                         const child_contribution* after) noexcept {
+    child_aggregate* aggregate = aggregate_for_nolock(parent_id);
+    if (!aggregate) {
+        return;
+    }
+    if (before) {
+        aggregate->volume_traded -= before->volume_traded;
+        aggregate->volume_remain -= before->volume_remain;
+        aggregate->dvalue_traded -= before->dvalue_traded;
+        aggregate->fee -= before->fee;
+        --aggregate->new_children;
+        aggregate->non_terminal -= is_terminal_state(before->state) ? 0U : 1U;
+        --aggregate->rank_counts[status_progress_rank(before->state)];
+    }
+    if (after) {
+        aggregate->volume_traded += after->volume_traded;
+        aggregate->volume_remain += after->volume_remain;
+        aggregate->dvalue_traded += after->dvalue_traded;
+        aggregate->fee += after->fee;
+        ++aggregate->new_children;
+        aggregate->non_terminal += is_terminal_state(after->state) ? 0U : 1U;
+        ++aggregate->rank_counts[status_progress_rank(after->state)];
+    }
+}
+
+void OrderBook::on_child_changed_nolock(InternalOrderId parent_id, const OrderEntry& child,
+                                        const child_contribution& before) {
+    if (child.request.order_type == OrderType::New) {
+        const child_contribution after = contribution_of(child);
+        apply_child_delta_nolock(parent_id, &before, &after);
+    }
+    if (!is_managed_parent_nolock(parent_id)) {
+        refresh_parent_from_children_nolock(parent_id, child.last_update_ns);
+    }
+}
+
+void OrderBook::refresh_parent_from_children_nolock(InternalOrderId parent_id, TimestampNs child_update_ns) {
+    if (is_managed_parent_nolock(parent_id)) {
+        return;
+    }
+
+    OrderEntry* parent = find_order_nolock(parent_id);
+    if (!parent) {
+        ACCT_REPORT_ERROR(ErrorDomain::order, ErrorCode::OrderInvariantBroken, "OrderBook",
+                          "parent missing while refreshing split state", 0);
+        return;
     }
 
-    if (new_child_count == 0) {
+    const child_list* children = parent_to_children_.find(parent_id);
+    if (!children || children->aggregate == kNilLink) {
+        return;
+    }
+    const child_aggregate& aggregate = child_aggregates_[children->aggregate];
+    if (aggregate.new_children == 0) {
         return;
     }
 
     auto notify_parent = [&]() {
-        if (change_callback_) {
-            change_callback_(*parent, order_book_event_t::ParentRefreshed);
+        if (change_hook_) {
+            change_hook_(*parent, order_book_event_t::ParentRefreshed);
         }
     };
 
-    parent->request.volume_traded = total_volume_traded;
-    parent->request.volume_remain = total_volume_remain;
-    parent->request.dvalue_traded = total_dvalue_traded;
-    parent->request.dfee_executed = total_fee;
+    parent->request.volume_traded = aggregate.volume_traded;
+    parent->request.volume_remain = aggregate.volume_remain;
+    parent->request.dvalue_traded = aggregate.dvalue_traded;
+    parent->request.dfee_executed = aggregate.fee;
 
-    if (total_volume_traded > 0) {
-        parent->request.dprice_traded = total_dvalue_traded / total_volume_traded;
+    if (aggregate.volume_traded > 0) {
+        parent->request.dprice_traded = aggregate.dvalue_traded / aggregate.volume_traded;
     }
 
     if (parent->request.volume_entrust > 0 && parent->request.volume_remain > parent->request.volume_entrust) {
         parent->request.volume_remain = parent->request.volume_entrust;
     }
 
-    parent->last_update_ns = latest_update_ns;
+    // 父单更新时间已覆盖此前各子单，只需与本次触发的子单取大
+    parent->last_update_ns = std::max(parent->last_update_ns, child_update_ns);
 
-    if (split_parent_error_latched_.find(parent_id) != split_parent_error_latched_.end()) {
+    if (aggregate.error_latched) {
         parent->request.order_state.store(OrderState::TraderError, std::memory_order_release);
         notify_parent();
         return;
     }
 
-    if (all_terminal) {
+    if (aggregate.non_terminal == 0) {
         parent->request.order_state.store(OrderState::Finished, std::memory_order_release);
         notify_parent();
         return;
     }
 
+    OrderState best_progress_status = OrderState::NotSet;
+    for (int rank = 7; rank > 0; --rank) {
+        if (aggregate.rank_counts[rank] != 0) {
+            best_progress_status = progress_state_of_rank(rank);
+            break;
+        }
+    }
+    // 罕见：在簿子单均无推进等级（终态混杂未置状态的子单），沿用链表中首个新单子单的状态
+    for (uint32_t link = children->head; best_progress_status == OrderState::NotSet && link != kNilLink;
+         link = child_links_[link].next) {
+        const uint32_t child_index = find_slot_nolock(child_links_[link].child_id);
+        if (child_index != kNilLink && slot_order_types_[child_index] == OrderType::New) {
+            best_progress_status = orders_[child_index].request.order_state.load(std::memory_order_acquire);
+            break;
+        }
+    }
+
     if (best_progress_status != OrderState::NotSet) {
         parent->request.order_state.store(best_progress_status, std::memory_order_release);
     }
@@ -1,14 +1,22 @@
 #pragma once
 
-#include <array>
 #include <atomic>
+#include <bit>
+#include <cstdint>
 #include <functional>
-#include <unordered_map>
-#include <unordered_set>
+#include <memory>
+#include <tuple>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 #include "common/constants.hpp"
+#include "common/flat_hash_map.hpp"
+#include "common/lazy_region.hpp"
+#include "common/memory_accounting.hpp"
+#include "common/security_identity.hpp"
 #include "common/spinlock.hpp"
+#include "common/time_utils.hpp"
 #include "common/types.hpp"
 #include "order/order_request.hpp"
 #include "shm/shm_layout.hpp"
@@ -32,16 +40,69 @@ struct OrderEntry {
     bool is_terminal() const noexcept;
 };
 
+static_assert(std::is_trivially_copyable_v<OrderEntry>, "order entry must be trivially copyable");
+
 enum class order_book_event_t : uint8_t {
     Added = 1,
     StatusUpdated = 2,
     TradeUpdated = 3,
     Archived = 4,
     ParentRefreshed = 5,
+    Amended = 6,
 };
 
 using order_change_callback_t = std::function<void(const OrderEntry&, order_book_event_t)>;
 
+// 订单变更钩子：函数指针 + 上下文，拷贝无分配；bind<T, &T::method>(obj) 在编译期绑定成员函数
+struct order_change_hook {
+    void (*fn)(void* context, const OrderEntry& entry, order_book_event_t event) = nullptr;
+    void* context = nullptr;
+
+    explicit operator bool() const noexcept { return fn != nullptr; }
+    void operator()(const OrderEntry& entry, order_book_event_t event) const { fn(context, entry, event); }
+
+    template <typename T, void (T::*Method)(const OrderEntry&, order_book_event_t)>
+    static order_change_hook bind(T* object) noexcept {
+        order_change_hook hook;
+        hook.fn = [](void* context, const OrderEntry& entry, order_book_event_t event) {
+            (static_cast<T*>(context)->*Method)(entry, event);
+        };
+        hook.context = object;
+        return hook;
+    }
+};
+
+// 静态观察者组合：按模板参数顺序依次调用各观察者的 on_order_change(entry, event)，
+// 组合整体经 hook() 绑定为一个钩子，订单簿每个事件只有一次函数指针调用，观察者之间无类型擦除、可内联。
+// 观察者按值保存，组合对象须比绑定它的订单簿活得久。
+template <typename... Observers>
+class order_change_observers {
+public:
+    explicit order_change_observers(Observers... observers) : observers_(std::move(observers)...) {}
+
+    void on_order_change(const OrderEntry& entry, order_book_event_t event) {
+        std::apply([&](Observers&... observers) { (observers.on_order_change(entry, event), ...); }, observers_);
+    }
+
+    order_change_hook hook() noexcept {
+        return order_change_hook::bind<order_change_observers, &order_change_observers::on_order_change>(this);
+    }
+
+    template <std::size_t Index>
+    auto& get() noexcept {
+        return std::get<Index>(observers_);
+    }
+
+private:
+    std::tuple<Observers...> observers_;
+};
+
+// 订单簿线程模型：SingleThreaded 时所有调用必须来自同一线程，内部不加锁
+enum class order_book_threading : uint8_t {
+    SingleThreaded = 0,
+    Concurrent = 1,
+};
+
 struct ManagedParentView {
     PassiveExecutionAlgo execution_algo{PassiveExecutionAlgo::None};
     ExecutionState execution_state{ExecutionState::None};
@@ -56,8 +117,11 @@ struct ManagedParentView {
 // 订单簿管理器
 class OrderBook {
 public:
-    OrderBook();
-    ~OrderBook() = default;
+    // capacity 为同时在簿订单槽位上限，取值 [1, kMaxOrderBookCapacity]，越界时收敛到边界；索引表规模随之缩放。
+    // 订单条目与按槽位的平行数组放在惰性落页映射中，huge_pages 为 true 时建议内核以透明大页承载
+    explicit OrderBook(order_book_threading threading = order_book_threading::Concurrent,
+                       std::size_t capacity = kMaxActiveOrders, bool huge_pages = false);
+    ~OrderBook();
 
     // 禁止拷贝·
     OrderBook(const OrderBook&) = delete;
@@ -69,16 +133,26 @@ public:
     // 根据内部订单ID查找订单
     OrderEntry* find_order(InternalOrderId order_id);
     const OrderEntry* find_order(InternalOrderId order_id) const;
+    // 预取订单条目（写意图）：只读直接索引窗口定位槽位，不查溢出表；Concurrent 模型下不加锁直接放弃
+    void prefetch_order(InternalOrderId order_id) const noexcept;
 
-    // 根据 broker_order_id 查找订单
+    // 根据 broker_order_id 查找订单：先查稠密直接数组，未命中再查哈希表
     OrderEntry* find_by_broker_id(uint64_t broker_order_id);
 
+    // 首个带柜台编号的回报到达时登记 broker_order_id（不触发变更钩子，镜像随同一回报的状态更新回写）。
+    // dense 为 true 表示柜台在会话内按递增数字发号：以首个编号为基址落入直接数组，同址被存活订单占用时仍落哈希表。
+    // 订单不存在或已登记返回 false
+    bool bind_broker_order_id(InternalOrderId order_id, uint64_t broker_order_id, bool dense);
+
     // 更新订单状态
     bool update_state(InternalOrderId order_id, OrderState new_state);
 
     // 更新订单成交信息
     bool update_trade(InternalOrderId order_id, Volume vol, DPrice px, DValue val, DValue fee);
 
+    // 柜台受理改单后就地修改委托数量与价格；订单不存在、已终态、非新单或改后数量不超过已成交量时返回 false
+    bool amend_order(InternalOrderId order_id, Volume volume_entrust, DPrice dprice_entrust);
+
     // 将父单标记为执行引擎托管，避免再被旧子单聚合逻辑覆盖。
     bool mark_managed_parent(InternalOrderId parent_id);
 
@@ -88,21 +162,59 @@ public:
     // 移除已完成订单（移到历史）
     bool archive_order(InternalOrderId order_id);
 
-    // 获取所有活跃订单ID
+    // 查询已归档订单的 orders_shm 槽位：归档索引与直接索引窗口同规模、按 id 低位定址，
+    // 被后归档的同址订单覆盖或订单已重新入簿时返回 false。用于把迟到回报与真正的未知订单区分开
+    bool find_archived(InternalOrderId order_id, OrderIndex& out_shm_order_index) const noexcept;
+
+    // 累计归档订单数（clear 清零）
+    uint64_t archived_count() const noexcept;
+
+    // 获取所有活跃订单ID（拷贝，供冷路径使用；热路径用 for_each_active）
     std::vector<InternalOrderId> get_active_order_ids() const;
 
+    // 分段遍历活跃订单的游标：按槽位顺序推进，可跨事件循环轮次保存。
+    // 遍历期间归档的订单不再访问；新入簿且落在已扫过槽位上的订单本轮不访问
+    struct active_cursor {
+        std::size_t next_slot = 0;
+    };
+
+    // 按槽位顺序遍历全部活跃订单：fn(const OrderEntry& entry)；约束同 for_each_child
+    template <typename Fn>
+    void for_each_active(Fn&& fn) const;
+
+    // 从游标处最多访问 max_orders 个活跃订单并推进游标；返回 false 表示已扫完
+    template <typename Fn>
+    bool for_each_active_chunk(active_cursor& cursor, std::size_t max_orders, Fn&& fn) const;
+
     // 获取证券的所有订单
     std::vector<InternalOrderId> get_orders_by_security(InternalSecurityId security_id) const;
 
     // 获取父单关联的所有子单（包含子撤单）
     std::vector<InternalOrderId> get_children(InternalOrderId parent_id) const;
 
+    // 按登记顺序遍历父单子单：fn(InternalOrderId child_id, const OrderEntry* child)，子单已归档时 child 为空。
+    // fn 在订单簿锁内执行，不得回调 OrderBook。
+    template <typename Fn>
+    void for_each_child(InternalOrderId parent_id, Fn&& fn) const;
+
+    // 按登记顺序遍历证券下的活跃订单：fn(const OrderEntry& entry)；约束同 for_each_child
+    template <typename Fn>
+    void for_each_security_order(InternalSecurityId security_id, Fn&& fn) const;
+
     // 反查子单对应父单
     bool try_get_parent(InternalOrderId child_id, InternalOrderId& out_parent_id) const noexcept;
 
     // 获取活跃订单数量
     std::size_t active_count() const noexcept;
 
+    // 订单槽位上限
+    std::size_t capacity() const noexcept { return capacity_; }
+
+    // 条目数组及按槽位平行的热数据列的内存占用，按已构造槽位计在用
+    memory_usage storage_memory() const noexcept;
+    // 直接索引窗口、各哈希表、父子单链表与聚合池的内存占用，按当前条目数计在用
+    memory_usage index_memory() const noexcept;
+
     // 生成新的内部订单ID
     InternalOrderId next_order_id() noexcept;
 
@@ -112,30 +224,240 @@ public:
     // 清空所有订单（仅用于初始化）
     void clear();
 
+    // 启动预热：预先触碰前 count 个尚未构造的订单槽位页面，避免开盘首批订单承担缺页
+    void prefault_slots(std::size_t count) noexcept;
+
     // 设置订单变更回调（用于镜像同步）
     void set_change_callback(order_change_callback_t callback);
 
+    // 设置订单变更钩子（热路径使用，替换已设置的回调）
+    void set_change_hook(order_change_hook hook) noexcept;
+
+    // 挂接事件循环的每轮时钟，订单更新时间取本轮缓存值；nullptr 时逐次取时
+    void set_clock(const loop_clock* clock) noexcept { clock_ = clock; }
+
 private:
+    static constexpr std::size_t kSecurityIndexCapacity = kMaxPositions * 2;  // 证券索引容量
+    static constexpr uint32_t kNilLink = UINT32_MAX;
+
+    // 子单链表节点：子单归档后节点保留，直到父单及其全部子单都已归档
+    struct child_link {
+        InternalOrderId child_id = 0;
+        uint32_t next = kNilLink;
+    };
+
+    // 父单子单链表头；live_count 为仍在订单簿中的子单数量
+    struct child_list {
+        uint32_t head = kNilLink;
+        uint32_t tail = kNilLink;
+        uint32_t live_count = 0;
+        uint32_t aggregate = kNilLink;  // child_aggregates_ 下标
+    };
+
+    // 父单的新单子单聚合：子单入簿、变更、归档时按前后差量累加，刷新父单不再遍历子单；
+    // error_latched 为拆单父单错误锁存位，父单自身报 TraderError 后不再被子单状态覆盖
+    struct child_aggregate {
+        Volume volume_traded = 0;
+        Volume volume_remain = 0;
+        DValue dvalue_traded = 0;
+        DValue fee = 0;
+        uint32_t new_children = 0;      // 仍在簿中的新单子单数
+        uint32_t non_terminal = 0;      // 其中尚未终态的数量
+        uint32_t rank_counts[8] = {};   // 按状态推进等级计数
+        uint32_t next_free = kNilLink;  // 空闲栈链接
+        bool error_latched = false;
+    };
+
+    // 单个新单子单对父单聚合的贡献，变更前后各取一次求差量
+    struct child_contribution {
+        Volume volume_traded = 0;
+        Volume volume_remain = 0;
+        DValue dvalue_traded = 0;
+        DValue fee = 0;
+        OrderState state = OrderState::NotSet;
+    };
+
+    // 证券订单链表头，节点即 orders_ 槽位
+    struct security_list {
+        uint32_t head = kNilLink;
+        uint32_t tail = kNilLink;
+    };
+
+    // 稠密柜台编号直接数组项：broker_order_id 为 0 表示空
+    struct broker_slot {
+        uint64_t broker_order_id = 0;
+        uint32_t index = 0;  // orders_ 下标
+    };
+
+    // 归档索引项：order_id 为 0 表示空
+    struct archived_slot {
+        InternalOrderId order_id = 0;
+        OrderIndex shm_order_index = kInvalidOrderIndex;
+    };
+
+    // 按 orders_ 下标平行存放的证券链表指针
+    struct slot_links {
+        uint32_t security_prev = kNilLink;
+        uint32_t security_next = kNilLink;
+    };
+
+    // 建立 order_id -> orders_ 下标映射；窗口冲突时落入溢出表，溢出表满返回 false
+    bool index_order_id_nolock(InternalOrderId order_id, std::size_t index);
+    // 移除 order_id 映射
+    void unindex_order_id_nolock(InternalOrderId order_id, std::size_t index);
+    // 建立/移除 broker_order_id 映射；dense 时优先落直接数组
+    void index_broker_id_nolock(uint64_t broker_order_id, InternalOrderId order_id, std::size_t index, bool dense);
+    void unindex_broker_id_nolock(uint64_t broker_order_id, InternalOrderId order_id);
+    // 索引表容量耗尽时记录错误（订单本身已入簿）
+    void report_index_full_nolock(const char* index_name) const;
+    // 把子单追加到父单链表尾部
+    void link_child_nolock(InternalOrderId parent_id, InternalOrderId child_id);
+    // 父单与全部子单都已离开订单簿时回收链表节点和反查映射
+    void release_child_list_if_idle_nolock(InternalOrderId parent_id);
+    // 把槽位挂到/摘出证券链表
+    void link_security_nolock(InternalSecurityId security_id, std::size_t index);
+    void unlink_security_nolock(InternalSecurityId security_id, std::size_t index);
+    // 按线程模型决定是否持锁的守卫；SingleThreaded 时不触碰 lock_
+    class book_guard {
+    public:
+        explicit book_guard(const OrderBook& book) noexcept : lock_(book.concurrent_ ? &book.lock_ : nullptr) {
+            if (lock_) {
+                lock_->lock();
+            }
+        }
+        ~book_guard() {
+            if (lock_) {
+                lock_->unlock();
+            }
+        }
+        book_guard(const book_guard&) = delete;
+        book_guard& operator=(const book_guard&) = delete;
+
+    private:
+        SpinLock* lock_;
+    };
+
+    // 查找订单所在 orders_ 下标，不存在返回 kNilLink；只读热数组，不触达订单条目
+    uint32_t find_slot_nolock(InternalOrderId order_id) const noexcept;
     OrderEntry* find_order_nolock(InternalOrderId order_id);
     const OrderEntry* find_order_nolock(InternalOrderId order_id) const;
     bool is_managed_parent_nolock(InternalOrderId parent_id) const noexcept;
-    void refresh_parent_from_children_nolock(InternalOrderId parent_id);
-
-    std::array<OrderEntry, kMaxActiveOrders> orders_;  // 固定容量订单存储区
-    std::unordered_map<InternalOrderId, std::size_t> id_to_index_;  // internal_order_id -> orders_ 下标
-    std::unordered_map<uint64_t, InternalOrderId> broker_id_map_;  // broker_order_id -> internal_order_id
-    std::unordered_map<InternalSecurityId, std::vector<InternalOrderId>>
-        security_orders_;  // 证券 -> 该证券下订单ID集合
-    std::unordered_map<InternalOrderId, std::vector<InternalOrderId>>
-        parent_to_children_;  // 父单 -> 子单（含子撤单）
-    std::unordered_map<InternalOrderId, InternalOrderId> child_to_parent_;  // 子单 -> 父单
-    std::unordered_set<InternalOrderId> managed_parent_ids_;  // 执行引擎托管父单集合
-    std::unordered_set<InternalOrderId> split_parent_error_latched_;  // 拆单父单错误锁存集合
-    std::vector<std::size_t> free_slots_;  // orders_ 空闲槽位栈
+    // 按聚合刷新父单成交与状态，child_update_ns 为触发本次刷新的子单更新时间
+    void refresh_parent_from_children_nolock(InternalOrderId parent_id, TimestampNs child_update_ns);
+    static child_contribution contribution_of(const OrderEntry& child) noexcept;
+    // 从 begin_slot 起按活跃位图访问至多 max_orders 个订单，返回下次续扫的槽位
+    template <typename Fn>
+    std::size_t visit_active_nolock(std::size_t begin_slot, std::size_t max_orders, Fn& fn) const;
+    child_aggregate* aggregate_for_nolock(InternalOrderId parent_id) noexcept;
+    // 把子单贡献的差量计入父单聚合；before/after 为空表示子单入簿/离簿
+    void apply_child_delta_nolock(InternalOrderId parent_id, const child_contribution* before,
+                                  const child_contribution* after) noexcept;
+    // 子单变更后的公共收尾：新单子单记差量，再刷新非托管父单
+    void on_child_changed_nolock(InternalOrderId parent_id, const OrderEntry& child, const child_contribution& before);
+
+    const bool concurrent_;  // Concurrent 线程模型下才使用 lock_
+    const std::size_t capacity_;             // 订单槽位上限
+    const std::size_t id_index_mask_;        // 订单ID直接索引窗口掩码（窗口为 2 的幂，不小于 2 倍容量）
+    const std::size_t child_link_capacity_;  // 父子单链表节点池容量
+    // 冷数据：完整订单条目。存储只映射不构造，槽位按水位线顺序切出时才构造；空闲栈只在归档后才有槽位，
+    // 低下标优先复用，常驻内存随活跃订单峰值增长而非 capacity_
+    lazy_region order_storage_;
+    OrderEntry* orders_ = nullptr;
+    std::size_t slot_high_water_ = 0;  // 已构造的槽位数量，[0, slot_high_water_) 均为有效对象
+    // 热数据（按槽位 SoA）：查找校验、子单聚合过滤和活跃遍历只读这两列；全零即空闲，无需逐项初始化
+    lazy_array<InternalOrderId> slot_order_ids_;  // 槽位订单ID（0 表示空闲）
+    lazy_array<OrderType> slot_order_types_;      // 槽位订单类型
+    lazy_array<uint64_t> active_slot_bits_;       // 活跃槽位位图，遍历按字跳过空闲槽位
+    lazy_array<uint32_t> id_slots_;  // (internal_order_id & 窗口掩码) -> orders_ 下标 + 1（0 表示空）
+    lazy_array<archived_slot> archived_;  // (internal_order_id & 窗口掩码) -> 最近归档的订单及其 orders_shm 槽位
+    uint64_t archived_count_ = 0;         // 累计归档订单数
+    flat_hash_map<InternalOrderId, uint32_t> id_overflow_;        // 直接索引冲突的 id -> 下标
+    flat_hash_map<uint64_t, InternalOrderId> broker_id_map_;      // broker_order_id -> internal_order_id（字符串哈希编号、冲突回落）
+    lazy_array<broker_slot> broker_slots_;  // ((broker_order_id - 基址) & 窗口掩码) -> 订单槽位（稠密数字编号）
+    uint64_t broker_id_base_ = 0;           // 首个稠密编号，0 表示尚未登记
+    flat_hash_map<InternalSecurityId, security_list> security_orders_{kSecurityIndexCapacity};  // 证券 -> 订单槽位链表
+    lazy_array<slot_links> slot_links_;  // orders_ 下标 -> 证券链表前后槽位（挂链时写入，不读未挂链槽位）
+    flat_hash_map<InternalOrderId, child_list> parent_to_children_;  // 父单 -> 子单链表（含子撤单）
+    lazy_array<child_link> child_links_;  // 子单链表节点池（节点切出时写入）
+    uint32_t child_link_free_ = kNilLink;        // 已回收节点栈顶
+    uint32_t child_link_used_ = 0;               // 节点池已切出的节点数
+    flat_hash_map<InternalOrderId, InternalOrderId> child_to_parent_;  // 子单 -> 父单
+    flat_hash_set<InternalOrderId> managed_parent_ids_;                // 执行引擎托管父单集合
+    std::vector<child_aggregate> child_aggregates_;  // 父单聚合池，随同时在簿的父单数增长，链表回收时复用
+    uint32_t child_aggregate_free_ = kNilLink;       // 已回收聚合栈顶
+    std::vector<std::size_t> free_slots_;  // 已构造且空闲的槽位栈
     std::size_t active_count_ = 0;  // 当前活跃订单数量
     std::atomic<InternalOrderId> next_order_id_{1};  // 递增内部订单ID生成器
-    mutable SpinLock lock_;  // 保护订单簿内部状态
-    order_change_callback_t change_callback_;
+    mutable SpinLock lock_;  // 保护订单簿内部状态（Concurrent）
+    order_change_callback_t change_callback_;  // set_change_callback 设置的回调（经 change_hook_ 调用）
+    order_change_hook change_hook_;            // 当前生效的变更钩子
+    const loop_clock* clock_ = nullptr;        // 事件循环每轮时钟，未挂接时逐次取时
 };
 
+template <typename Fn>
+void OrderBook::for_each_child(InternalOrderId parent_id, Fn&& fn) const {
+    book_guard guard(*this);
+
+    const child_list* children = parent_to_children_.find(parent_id);
+    if (!children) {
+        return;
+    }
+    for (uint32_t link = children->head; link != kNilLink; link = child_links_[link].next) {
+        const InternalOrderId child_id = child_links_[link].child_id;
+        fn(child_id, find_order_nolock(child_id));
+    }
+}
+
+template <typename Fn>
+std::size_t OrderBook::visit_active_nolock(std::size_t begin_slot, std::size_t max_orders, Fn& fn) const {
+    const std::size_t end_slot = slot_high_water_;
+    std::size_t visited = 0;
+    for (std::size_t word = begin_slot / 64; word * 64 < end_slot; ++word) {
+        uint64_t bits = active_slot_bits_[word];
+        if (word == begin_slot / 64) {
+            bits &= ~uint64_t{0} << (begin_slot % 64);
+        }
+        while (bits != 0) {
+            const std::size_t index = word * 64 + static_cast<std::size_t>(std::countr_zero(bits));
+            if (visited == max_orders) {
+                return index;
+            }
+            bits &= bits - 1;
+            fn(orders_[index]);
+            ++visited;
+        }
+    }
+    return end_slot;
+}
+
+template <typename Fn>
+void OrderBook::for_each_active(Fn&& fn) const {
+    book_guard guard(*this);
+    (void)visit_active_nolock(0, SIZE_MAX, fn);
+}
+
+template <typename Fn>
+bool OrderBook::for_each_active_chunk(active_cursor& cursor, std::size_t max_orders, Fn&& fn) const {
+    book_guard guard(*this);
+    cursor.next_slot = visit_active_nolock(cursor.next_slot, max_orders, fn);
+    return cursor.next_slot < slot_high_water_;
+}
+
+template <typename Fn>
+void OrderBook::for_each_security_order(InternalSecurityId security_id, Fn&& fn) const {
+    book_guard guard(*this);
+
+    InternalSecurityId normalized_security_id;
+    if (!normalize_internal_security_id(security_id.view(), normalized_security_id)) {
+        return;
+    }
+    const security_list* orders = security_orders_.find(normalized_security_id);
+    if (!orders) {
+        return;
+    }
+    for (uint32_t index = orders->head; index != kNilLink; index = slot_links_[index].security_next) {
+        fn(orders_[index]);
+    }
+}
+
 }  // namespace acct_service
@@ -0,0 +1,723 @@
+#include "order/order_event_codec.hpp"
+
+#include <string>
+
+#include "order/passive_execution.hpp"
+
+namespace acct_service {
+
+namespace {
+
+const char* to_string(order_event_stream_t stream) noexcept {
+    switch (stream) {
+        case order_event_stream_t::Business:
+            return "business";
+        case order_event_stream_t::Debug:
+            return "debug";
+    }
+    return "business";
+}
+
+// 统一把订单枚举渲染成稳定的文本值，便于文件检索和下游解析。
+const char* to_string(OrderEventKind kind) noexcept {
+    switch (kind) {
+        case OrderEventKind::OrderAdded:
+            return "order_added";
+        case OrderEventKind::OrderStatusUpdated:
+            return "order_status_updated";
+        case OrderEventKind::OrderTradeUpdated:
+            return "order_trade_updated";
+        case OrderEventKind::OrderArchived:
+            return "order_archived";
+        case OrderEventKind::ParentRefreshed:
+            return "parent_refreshed";
+        case OrderEventKind::SessionStarted:
+            return "session_started";
+        case OrderEventKind::SessionRejected:
+            return "session_rejected";
+        case OrderEventKind::ChildSubmitAttempt:
+            return "child_submit_attempt";
+        case OrderEventKind::ChildSubmitResult:
+            return "child_submit_result";
+        case OrderEventKind::ChildFinalized:
+            return "child_finalized";
+        case OrderEventKind::OrderAmended:
+            return "order_amended";
+    }
+    return "order_added";
+}
+
+// 统一渲染订单类型，避免业务日志混入数值枚举。
+const char* to_string(OrderType type) noexcept {
+    switch (type) {
+        case OrderType::New:
+            return "new";
+        case OrderType::Cancel:
+            return "cancel";
+        case OrderType::MassCancel:
+            return "mass_cancel";
+        case OrderType::Replace:
+            return "replace";
+        case OrderType::NotSet:
+            return "not_set";
+        case OrderType::Unknown:
+            return "unknown";
+    }
+    return "unknown";
+}
+
+// 统一渲染买卖方向。
+const char* to_string(TradeSide side) noexcept {
+    switch (side) {
+        case TradeSide::Buy:
+            return "buy";
+        case TradeSide::Sell:
+            return "sell";
+        case TradeSide::NotSet:
+        default:
+            return "not_set";
+    }
+}
+
+// 统一渲染市场枚举。
+const char* to_string(Market market) noexcept {
+    switch (market) {
+        case Market::SZ:
+            return "sz";
+        case Market::SH:
+            return "sh";
+        case Market::BJ:
+            return "bj";
+        case Market::HK:
+            return "hk";
+        case Market::NotSet:
+            return "not_set";
+        case Market::Unknown:
+        default:
+            return "unknown";
+    }
+}
+
+// 统一渲染订单状态。
+const char* to_string(OrderState state) noexcept {
+    switch (state) {
+        case OrderState::NotSet:
+            return "not_set";
+        case OrderState::UserSubmitted:
+            return "user_submitted";
+        case OrderState::RiskControllerPending:
+            return "risk_pending";
+        case OrderState::RiskControllerRejected:
+            return "risk_rejected";
+        case OrderState::RiskControllerAccepted:
+            return "risk_accepted";
+        case OrderState::TraderPending:
+            return "trader_pending";
+        case OrderState::TraderRejected:
+            return "trader_rejected";
+        case OrderState::TraderSubmitted:
+            return "trader_submitted";
+        case OrderState::TraderError:
+            return "trader_error";
+        case OrderState::BrokerRejected:
+            return "broker_rejected";
+        case OrderState::BrokerAccepted:
+            return "broker_accepted";
+        case OrderState::MarketRejected:
+            return "market_rejected";
+        case OrderState::MarketAccepted:
+            return "market_accepted";
+        case OrderState::Finished:
+            return "finished";
+        case OrderState::Unknown:
+        default:
+            return "unknown";
+    }
+}
+
+// 统一渲染执行状态。
+const char* to_string(ExecutionState state) noexcept {
+    switch (state) {
+        case ExecutionState::None:
+            return "none";
+        case ExecutionState::Running:
+            return "running";
+        case ExecutionState::Cancelling:
+            return "cancelling";
+        case ExecutionState::Finished:
+            return "finished";
+        case ExecutionState::Failed:
+            return "failed";
+    }
+    return "none";
+}
+
+// 对字符串字段做最小转义，保证日志仍然保持单行。
+std::string escape_field(std::string_view value) {
+    std::string out;
+    out.reserve(value.size() + 8);
+    for (char ch : value) {
+        switch (ch) {
+            case '\\':
+                out += "\\\\";
+                break;
+            case '"':
+                out += "\\\"";
+                break;
+            case '\n':
+                out += "\\n";
+                break;
+            case '\r':
+                out += "\\r";
+                break;
+            case '\t':
+                out += "\\t";
+                break;
+            default:
+                out.push_back(ch);
+                break;
+        }
+    }
+    return out;
+}
+
+bool should_render_success(OrderEventKind kind) noexcept { return kind == OrderEventKind::ChildSubmitResult; }
+
+bool should_render_cancel_requested(OrderEventKind kind) noexcept { return kind == OrderEventKind::ChildFinalized; }
+
+bool should_render_active_strategy_claimed(OrderEventKind kind) noexcept {
+    return kind == OrderEventKind::ChildSubmitAttempt || kind == OrderEventKind::ChildSubmitResult;
+}
+
+bool should_render_shm_order_index(const OrderEventRecord& record) noexcept {
+    return record.stream == order_event_stream_t::Business || record.shm_order_index != kInvalidOrderIndex;
+}
+
+bool should_render_order_state(const OrderEventRecord& record) noexcept {
+    return record.stream == order_event_stream_t::Business || record.order_state != OrderState::NotSet;
+}
+
+bool should_render_detail(const OrderEventRecord& record) noexcept { return !record.detail.empty(); }
+
+bool is_child_trace(OrderEventKind kind) noexcept {
+    return kind == OrderEventKind::ChildSubmitAttempt || kind == OrderEventKind::ChildSubmitResult ||
+           kind == OrderEventKind::ChildFinalized;
+}
+
+InternalOrderId debug_parent_order_id(const OrderEventRecord& record) noexcept {
+    return (record.parent_order_id != 0) ? record.parent_order_id : record.order_id;
+}
+
+const char* debug_detail_key(OrderEventKind kind) noexcept {
+    switch (kind) {
+        case OrderEventKind::SessionRejected:
+            return "reason";
+        case OrderEventKind::ChildSubmitResult:
+            return "result";
+        case OrderEventKind::ChildFinalized:
+            return "summary";
+        case OrderEventKind::OrderAdded:
+        case OrderEventKind::OrderStatusUpdated:
+        case OrderEventKind::OrderTradeUpdated:
+        case OrderEventKind::OrderArchived:
+        case OrderEventKind::ParentRefreshed:
+        case OrderEventKind::SessionStarted:
+        case OrderEventKind::ChildSubmitAttempt:
+        default:
+            return "detail";
+    }
+}
+void write_business_prefix(std::ostream& out, const OrderEventRecord& record, AccountId account_id,
+                           std::string_view trading_day) {
+    out << "ts_ns=" << record.ts_ns << " account_id=" << account_id << " trading_day=\"" << escape_field(trading_day)
+        << "\" stream=\"" << to_string(record.stream) << "\" event=\"" << to_string(record.kind) << "\""
+        << " order_id=" << record.order_id << " parent_order_id=" << record.parent_order_id
+        << " strategy_id=" << record.strategy_id;
+    if (should_render_shm_order_index(record)) {
+        out << " shm_order_index=" << record.shm_order_index;
+    }
+}
+
+// 业务事件日志只保留订单快照事实字段，避免混入调试默认值误导排查。
+void write_business_record(std::ostream& out, const OrderEventRecord& record, AccountId account_id,
+                           std::string_view trading_day) {
+    write_business_prefix(out, record, account_id, trading_day);
+    out << " is_split_child=" << (record.is_split_child ? "true" : "false") << " order_type=\""
+        << to_string(record.order_type) << "\" trade_side=\"" << to_string(record.trade_side) << "\" market=\""
+        << to_string(record.market) << "\" order_state=\"" << to_string(record.order_state)
+        << "\" passive_execution_algo=\"" << passive_execution_algo_name(record.passive_execution_algo)
+        << "\" execution_algo=\"" << passive_execution_algo_name(record.execution_algo) << "\" execution_state=\""
+        << to_string(record.execution_state) << "\" volume_entrust=" << record.volume_entrust
+        << " volume_traded=" << record.volume_traded << " volume_remain=" << record.volume_remain
+        << " target_volume=" << record.target_volume << " working_volume=" << record.working_volume
+        << " schedulable_volume=" << record.schedulable_volume << " dprice_entrust=" << record.dprice_entrust
+        << " dprice_traded=" << record.dprice_traded << " dvalue_traded=" << record.dvalue_traded
+        << " dfee_executed=" << record.dfee_executed << " security_id=\"" << escape_field(record.security_id.view())
+        << "\" internal_security_id=\"" << escape_field(record.internal_security_id.view()) << "\"";
+    if (should_render_detail(record)) {
+        out << " detail=\"" << escape_field(record.detail.view()) << "\"";
+    }
+    out << '\n';
+}
+
+void write_debug_prefix(std::ostream& out, const OrderEventRecord& record, AccountId account_id,
+                        std::string_view trading_day) {
+    out << "ts_ns=" << record.ts_ns << " account_id=" << account_id << " trading_day=\"" << escape_field(trading_day)
+        << "\" stream=\"" << to_string(record.stream) << "\" trace=\"" << to_string(record.kind) << "\""
+        << " parent_order_id=" << debug_parent_order_id(record) << " strategy_id=" << record.strategy_id;
+    if (is_child_trace(record.kind)) {
+        out << " child_order_id=" << record.order_id;
+    }
+    if (should_render_shm_order_index(record)) {
+        out << " shm_order_index=" << record.shm_order_index;
+    }
+}
+
+// 调试 trace 聚焦执行会话推进过程，只打印当前事件真正有语义的字段。
+void write_debug_record(std::ostream& out, const OrderEventRecord& record, AccountId account_id,
+                        std::string_view trading_day) {
+    write_debug_prefix(out, record, account_id, trading_day);
+    out << " order_type=\"" << to_string(record.order_type) << "\" trade_side=\"" << to_string(record.trade_side)
+        << "\" market=\"" << to_string(record.market) << "\"";
+    if (should_render_order_state(record)) {
+        out << " order_state=\"" << to_string(record.order_state) << "\"";
+    }
+    out << " passive_execution_algo=\"" << passive_execution_algo_name(record.passive_execution_algo)
+        << "\" execution_algo=\"" << passive_execution_algo_name(record.execution_algo) << "\" execution_state=\""
+        << to_string(record.execution_state) << "\" is_split_child=" << (record.is_split_child ? "true" : "false");
+    if (should_render_active_strategy_claimed(record.kind)) {
+        out << " active_strategy_claimed=" << (record.active_strategy_claimed ? "true" : "false");
+    }
+    if (should_render_success(record.kind)) {
+        out << " success=" << (record.success ? "true" : "false");
+    }
+    if (should_render_cancel_requested(record.kind)) {
+        out << " cancel_requested=" << (record.cancel_requested ? "true" : "false");
+    }
+    out << " volume_entrust=" << record.volume_entrust << " volume_traded=" << record.volume_traded
+        << " volume_remain=" << record.volume_remain << " target_volume=" << record.target_volume
+        << " working_volume=" << record.working_volume << " schedulable_volume=" << record.schedulable_volume
+        << " dprice_entrust=" << record.dprice_entrust << " dprice_traded=" << record.dprice_traded
+        << " dvalue_traded=" << record.dvalue_traded << " dfee_executed=" << record.dfee_executed
+        << " security_id=\"" << escape_field(record.security_id.view()) << "\" internal_security_id=\""
+        << escape_field(record.internal_security_id.view()) << "\"";
+    if (should_render_detail(record)) {
+        out << ' ' << debug_detail_key(record.kind) << "=\"" << escape_field(record.detail.view()) << "\"";
+    }
+    out << '\n';
+}
+
+// 事件帧字段位：整数字段写差值，枚举写原值，四个布尔打包成一个字节，字符串写长度 + 内容。
+enum delta_field : uint32_t {
+    kFieldParentOrderId = 1U << 0,
+    kFieldStrategyId = 1U << 1,
+    kFieldShmOrderIndex = 1U << 2,
+    kFieldVolumeEntrust = 1U << 3,
+    kFieldVolumeTraded = 1U << 4,
+    kFieldVolumeRemain = 1U << 5,
+    kFieldTargetVolume = 1U << 6,
+    kFieldWorkingVolume = 1U << 7,
+    kFieldSchedulableVolume = 1U << 8,
+    kFieldDpriceEntrust = 1U << 9,
+    kFieldDpriceTraded = 1U << 10,
+    kFieldDvalueTraded = 1U << 11,
+    kFieldDfeeExecuted = 1U << 12,
+    kFieldOrderType = 1U << 13,
+    kFieldOrderState = 1U << 14,
+    kFieldTradeSide = 1U << 15,
+    kFieldMarket = 1U << 16,
+    kFieldPassiveAlgo = 1U << 17,
+    kFieldExecutionAlgo = 1U << 18,
+    kFieldExecutionState = 1U << 19,
+    kFieldFlags = 1U << 20,
+    kFieldSecurityId = 1U << 21,
+    kFieldInternalSecurityId = 1U << 22,
+    kFieldDetail = 1U << 23,
+};
+
+constexpr uint8_t kEventKeyframe = 0x01;
+constexpr uint8_t kStreamBit = 0x80;
+constexpr uint8_t kFlagSplitChild = 0x01;
+constexpr uint8_t kFlagActiveClaimed = 0x02;
+constexpr uint8_t kFlagSuccess = 0x04;
+constexpr uint8_t kFlagCancelRequested = 0x08;
+
+uint8_t pack_flags(const OrderEventRecord& record) noexcept {
+    return static_cast<uint8_t>((record.is_split_child ? kFlagSplitChild : 0) |
+                                (record.active_strategy_claimed ? kFlagActiveClaimed : 0) |
+                                (record.success ? kFlagSuccess : 0) |
+                                (record.cancel_requested ? kFlagCancelRequested : 0));
+}
+
+void unpack_flags(OrderEventRecord& record, uint8_t flags) noexcept {
+    record.is_split_child = (flags & kFlagSplitChild) != 0;
+    record.active_strategy_claimed = (flags & kFlagActiveClaimed) != 0;
+    record.success = (flags & kFlagSuccess) != 0;
+    record.cancel_requested = (flags & kFlagCancelRequested) != 0;
+}
+
+// 订单最后一条事件之后不再需要同单基准。
+bool is_terminal_event(OrderEventKind kind) noexcept {
+    return kind == OrderEventKind::OrderArchived || kind == OrderEventKind::ChildFinalized;
+}
+
+void put_varint(std::string& out, uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<char>((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<char>(value));
+}
+
+// 无符号字段按 64 位回绕求差，再 zigzag 让小幅增减都落在一两个字节内。
+void put_delta(std::string& out, uint64_t value, uint64_t base) {
+    const int64_t delta = static_cast<int64_t>(value - base);
+    put_varint(out, (static_cast<uint64_t>(delta) << 1) ^ static_cast<uint64_t>(delta >> 63));
+}
+
+void put_text(std::string& out, std::string_view text) {
+    put_varint(out, text.size());
+    out.append(text);
+}
+
+template <typename T>
+void put_int_field(std::string& out, uint64_t mask, uint32_t bit, T value, T base) {
+    if ((mask & bit) != 0) {
+        put_delta(out, static_cast<uint64_t>(value), static_cast<uint64_t>(base));
+    }
+}
+
+template <typename T>
+void put_byte_field(std::string& out, uint64_t mask, uint32_t bit, T value) {
+    if ((mask & bit) != 0) {
+        out.push_back(static_cast<char>(value));
+    }
+}
+
+void put_text_field(std::string& out, uint64_t mask, uint32_t bit, std::string_view value) {
+    if ((mask & bit) != 0) {
+        put_text(out, value);
+    }
+}
+
+// 负载游标：越界读取一律置失败，调用方检查 ok 后丢弃整帧。
+struct payload_reader {
+    std::string_view data;
+    std::size_t pos = 0;
+    bool ok = true;
+
+    uint8_t byte() noexcept {
+        if (pos >= data.size()) {
+            ok = false;
+            return 0;
+        }
+        return static_cast<uint8_t>(data[pos++]);
+    }
+
+    uint64_t varint() noexcept {
+        uint64_t value = 0;
+        for (unsigned shift = 0; shift < 64; shift += 7) {
+            const uint8_t part = byte();
+            value |= static_cast<uint64_t>(part & 0x7F) << shift;
+            if ((part & 0x80) == 0) {
+                return value;
+            }
+        }
+        ok = false;
+        return 0;
+    }
+
+    uint64_t delta(uint64_t base) noexcept {
+        const uint64_t zigzag = varint();
+        const int64_t delta = static_cast<int64_t>(zigzag >> 1) ^ -static_cast<int64_t>(zigzag & 1);
+        return base + static_cast<uint64_t>(delta);
+    }
+
+    std::string_view text() noexcept {
+        const uint64_t size = varint();
+        if (!ok || size > data.size() - pos) {
+            ok = false;
+            return {};
+        }
+        const std::string_view value = data.substr(pos, size);
+        pos += size;
+        return value;
+    }
+};
+
+template <typename T>
+void read_int_field(payload_reader& in, uint64_t mask, uint32_t bit, T& field) noexcept {
+    if ((mask & bit) != 0) {
+        field = static_cast<T>(in.delta(static_cast<uint64_t>(field)));
+    }
+}
+
+template <typename T>
+void read_byte_field(payload_reader& in, uint64_t mask, uint32_t bit, T& field) noexcept {
+    if ((mask & bit) != 0) {
+        field = static_cast<T>(in.byte());
+    }
+}
+
+template <std::size_t N>
+void read_text_field(payload_reader& in, uint64_t mask, uint32_t bit, FixedString<N>& field) {
+    if ((mask & bit) != 0) {
+        field.assign(in.text());
+    }
+}
+
+// 头帧：类型、魔数（定长 4 字节，供损坏后重新对齐）、版本、账户、交易日。
+void put_header(std::string& out, AccountId account_id, std::string_view trading_day) {
+    std::string payload;
+    payload.push_back(static_cast<char>(kOrderEventFrameHeader));
+    for (unsigned shift = 0; shift < 32; shift += 8) {
+        payload.push_back(static_cast<char>((kOrderEventDeltaMagic >> shift) & 0xFF));
+    }
+    put_varint(payload, kOrderEventDeltaVersion);
+    put_varint(payload, account_id);
+    put_text(payload, trading_day.substr(0, 32));
+    put_varint(out, payload.size());
+    out.append(payload);
+}
+
+// data[pos] 起是否为一个头帧（长度前缀单字节，紧跟类型与魔数）。
+bool header_at(std::string_view data, std::size_t pos) noexcept {
+    if (data.size() - pos < 6 || data[pos + 1] != static_cast<char>(kOrderEventFrameHeader)) {
+        return false;
+    }
+    uint32_t magic = 0;
+    for (unsigned i = 0; i < 4; ++i) {
+        magic |= static_cast<uint32_t>(static_cast<uint8_t>(data[pos + 2 + i])) << (8 * i);
+    }
+    return magic == kOrderEventDeltaMagic;
+}
+
+}  // namespace
+
+void write_order_event_line(std::ostream& out, const OrderEventRecord& record, AccountId account_id,
+                            std::string_view trading_day) {
+    if (record.stream == order_event_stream_t::Business) {
+        write_business_record(out, record, account_id, trading_day);
+    } else {
+        write_debug_record(out, record, account_id, trading_day);
+    }
+}
+
+order_event_delta_encoder::order_event_delta_encoder(std::size_t base_capacity) : bases_(base_capacity) {}
+
+void order_event_delta_encoder::begin_stream(std::string& out, AccountId account_id, std::string_view trading_day) {
+    bases_.clear();
+    last_ts_ns_ = 0;
+    put_header(out, account_id, trading_day);
+}
+
+void order_event_delta_encoder::encode(const OrderEventRecord& record, std::string& out) {
+    static const OrderEventRecord kDefaultRecord{};
+    OrderEventRecord* stored = bases_.find(record.order_id);
+    const bool keyframe = stored == nullptr;
+    const OrderEventRecord& base = keyframe ? kDefaultRecord : *stored;
+
+    uint32_t mask = 0;
+    auto mark = [&mask](bool changed, uint32_t bit) { mask |= changed ? bit : 0; };
+    mark(record.parent_order_id != base.parent_order_id, kFieldParentOrderId);
+    mark(record.strategy_id != base.strategy_id, kFieldStrategyId);
+    mark(record.shm_order_index != base.shm_order_index, kFieldShmOrderIndex);
+    mark(record.volume_entrust != base.volume_entrust, kFieldVolumeEntrust);
+    mark(record.volume_traded != base.volume_traded, kFieldVolumeTraded);
+    mark(record.volume_remain != base.volume_remain, kFieldVolumeRemain);
+    mark(record.target_volume != base.target_volume, kFieldTargetVolume);
+    mark(record.working_volume != base.working_volume, kFieldWorkingVolume);
+    mark(record.schedulable_volume != base.schedulable_volume, kFieldSchedulableVolume);
+    mark(record.dprice_entrust != base.dprice_entrust, kFieldDpriceEntrust);
+    mark(record.dprice_traded != base.dprice_traded, kFieldDpriceTraded);
+    mark(record.dvalue_traded != base.dvalue_traded, kFieldDvalueTraded);
+    mark(record.dfee_executed != base.dfee_executed, kFieldDfeeExecuted);
+    mark(record.order_type != base.order_type, kFieldOrderType);
+    mark(record.order_state != base.order_state, kFieldOrderState);
+    mark(record.trade_side != base.trade_side, kFieldTradeSide);
+    mark(record.market != base.market, kFieldMarket);
+    mark(record.passive_execution_algo != base.passive_execution_algo, kFieldPassiveAlgo);
+    mark(record.execution_algo != base.execution_algo, kFieldExecutionAlgo);
+    mark(record.execution_state != base.execution_state, kFieldExecutionState);
+    mark(pack_flags(record) != pack_flags(base), kFieldFlags);
+    mark(!(record.security_id == base.security_id), kFieldSecurityId);
+    mark(!(record.internal_security_id == base.internal_security_id), kFieldInternalSecurityId);
+    mark(!(record.detail == base.detail), kFieldDetail);
+
+    std::string& payload = payload_;
+    payload.clear();
+    payload.push_back(static_cast<char>(kOrderEventFrameEvent));
+    payload.push_back(static_cast<char>(keyframe ? kEventKeyframe : 0));
+    put_varint(payload, record.order_id);
+    put_delta(payload, record.ts_ns, last_ts_ns_);
+    payload.push_back(static_cast<char>(static_cast<uint8_t>(record.kind) |
+                                        (record.stream == order_event_stream_t::Debug ? kStreamBit : 0)));
+    put_varint(payload, mask);
+    put_int_field(payload, mask, kFieldParentOrderId, record.parent_order_id, base.parent_order_id);
+    put_int_field(payload, mask, kFieldStrategyId, record.strategy_id, base.strategy_id);
+    put_int_field(payload, mask, kFieldShmOrderIndex, record.shm_order_index, base.shm_order_index);
+    put_int_field(payload, mask, kFieldVolumeEntrust, record.volume_entrust, base.volume_entrust);
+    put_int_field(payload, mask, kFieldVolumeTraded, record.volume_traded, base.volume_traded);
+    put_int_field(payload, mask, kFieldVolumeRemain, record.volume_remain, base.volume_remain);
+    put_int_field(payload, mask, kFieldTargetVolume, record.target_volume, base.target_volume);
+    put_int_field(payload, mask, kFieldWorkingVolume, record.working_volume, base.working_volume);
+    put_int_field(payload, mask, kFieldSchedulableVolume, record.schedulable_volume, base.schedulable_volume);
+    put_int_field(payload, mask, kFieldDpriceEntrust, record.dprice_entrust, base.dprice_entrust);
+    put_int_field(payload, mask, kFieldDpriceTraded, record.dprice_traded, base.dprice_traded);
+    put_int_field(payload, mask, kFieldDvalueTraded, record.dvalue_traded, base.dvalue_traded);
+    put_int_field(payload, mask, kFieldDfeeExecuted, record.dfee_executed, base.dfee_executed);
+    put_byte_field(payload, mask, kFieldOrderType, record.order_type);
+    put_byte_field(payload, mask, kFieldOrderState, record.order_state);
+    put_byte_field(payload, mask, kFieldTradeSide, record.trade_side);
+    put_byte_field(payload, mask, kFieldMarket, record.market);
+    put_byte_field(payload, mask, kFieldPassiveAlgo, record.passive_execution_algo);
+    put_byte_field(payload, mask, kFieldExecutionAlgo, record.execution_algo);
+    put_byte_field(payload, mask, kFieldExecutionState, record.execution_state);
+    put_byte_field(payload, mask, kFieldFlags, pack_flags(record));
+    put_text_field(payload, mask, kFieldSecurityId, record.security_id.view());
+    put_text_field(payload, mask, kFieldInternalSecurityId, record.internal_security_id.view());
+    put_text_field(payload, mask, kFieldDetail, record.detail.view());
+
+    put_varint(out, payload.size());
+    out.append(payload);
+
+    last_ts_ns_ = record.ts_ns;
+    if (is_terminal_event(record.kind)) {
+        (void)bases_.erase(record.order_id);
+    } else if (stored != nullptr) {
+        *stored = record;
+    } else {
+        // 基准表满时不登记，该订单后续事件继续写关键帧
+        (void)bases_.insert_or_assign(record.order_id, record);
+    }
+}
+
+bool order_event_delta_decoder::decode_event(std::string_view payload, OrderEventRecord& record) {
+    payload_reader in{payload, 1};
+    const uint8_t flags = in.byte();
+    const InternalOrderId order_id = static_cast<InternalOrderId>(in.varint());
+    const TimestampNs ts_ns = in.delta(last_ts_ns_);
+    const uint8_t kind = in.byte();
+    const uint64_t mask = in.varint();
+    if (!in.ok || (kind & ~kStreamBit) > static_cast<uint8_t>(OrderEventKind::OrderAmended)) {
+        return false;
+    }
+
+    record = OrderEventRecord{};
+    if ((flags & kEventKeyframe) == 0) {
+        const auto it = bases_.find(order_id);
+        if (it == bases_.end()) {
+            return false;
+        }
+        record = it->second;
+    }
+    record.order_id = order_id;
+    record.ts_ns = ts_ns;
+    record.kind = static_cast<OrderEventKind>(kind & ~kStreamBit);
+    record.stream = (kind & kStreamBit) ? order_event_stream_t::Debug : order_event_stream_t::Business;
+    read_int_field(in, mask, kFieldParentOrderId, record.parent_order_id);
+    read_int_field(in, mask, kFieldStrategyId, record.strategy_id);
+    read_int_field(in, mask, kFieldShmOrderIndex, record.shm_order_index);
+    read_int_field(in, mask, kFieldVolumeEntrust, record.volume_entrust);
+    read_int_field(in, mask, kFieldVolumeTraded, record.volume_traded);
+    read_int_field(in, mask, kFieldVolumeRemain, record.volume_remain);
+    read_int_field(in, mask, kFieldTargetVolume, record.target_volume);
+    read_int_field(in, mask, kFieldWorkingVolume, record.working_volume);
+    read_int_field(in, mask, kFieldSchedulableVolume, record.schedulable_volume);
+    read_int_field(in, mask, kFieldDpriceEntrust, record.dprice_entrust);
+    read_int_field(in, mask, kFieldDpriceTraded, record.dprice_traded);
+    read_int_field(in, mask, kFieldDvalueTraded, record.dvalue_traded);
+    read_int_field(in, mask, kFieldDfeeExecuted, record.dfee_executed);
+    read_byte_field(in, mask, kFieldOrderType, record.order_type);
+    read_byte_field(in, mask, kFieldOrderState, record.order_state);
+    read_byte_field(in, mask, kFieldTradeSide, record.trade_side);
+    read_byte_field(in, mask, kFieldMarket, record.market);
+    read_byte_field(in, mask, kFieldPassiveAlgo, record.passive_execution_algo);
+    read_byte_field(in, mask, kFieldExecutionAlgo, record.execution_algo);
+    read_byte_field(in, mask, kFieldExecutionState, record.execution_state);
+    if ((mask & kFieldFlags) != 0) {
+        unpack_flags(record, in.byte());
+    }
+    read_text_field(in, mask, kFieldSecurityId, record.security_id);
+    read_text_field(in, mask, kFieldInternalSecurityId, record.internal_security_id);
+    read_text_field(in, mask, kFieldDetail, record.detail);
+    if (!in.ok || in.pos != payload.size()) {
+        return false;
+    }
+
+    last_ts_ns_ = ts_ns;
+    if (is_terminal_event(record.kind)) {
+        bases_.erase(order_id);
+    } else {
+        bases_[order_id] = record;
+    }
+    return true;
+}
+
+void order_event_delta_decoder::decode(std::string_view data, const visitor& on_record, std::size_t* out_records,
+                                       std::size_t* out_corrupt) {
+    std::size_t records = 0;
+    std::size_t corrupt = 0;
+    std::size_t pos = 0;
+    bool synced = true;
+    OrderEventRecord record{};
+    while (pos < data.size()) {
+        if (!synced) {
+            // 损坏后逐字节找下一个头帧，头帧重置全部基准，之后的事件可完整还原
+            if (!header_at(data, pos)) {
+                ++pos;
+                ++corrupt;
+                continue;
+            }
+            synced = true;
+        }
+
+        payload_reader frame{data, pos};
+        const uint64_t size = frame.varint();
+        if (!frame.ok || size == 0 || size > data.size() - frame.pos) {
+            synced = false;
+            ++pos;
+            ++corrupt;
+            continue;
+        }
+        const std::string_view payload = data.substr(frame.pos, size);
+        const std::size_t frame_end = frame.pos + size;
+        bool ok = false;
+        if (payload[0] == static_cast<char>(kOrderEventFrameHeader) && header_at(data, pos)) {
+            payload_reader in{payload, 5};
+            const uint64_t version = in.varint();
+            const uint64_t account_id = in.varint();
+            const std::string_view trading_day = in.text();
+            ok = in.ok && version == kOrderEventDeltaVersion;
+            if (ok) {
+                bases_.clear();
+                last_ts_ns_ = 0;
+                account_id_ = static_cast<AccountId>(account_id);
+                trading_day_.assign(trading_day);
+            }
+        } else if (payload[0] == static_cast<char>(kOrderEventFrameEvent)) {
+            ok = decode_event(payload, record);
+            if (ok) {
+                ++records;
+                on_record(record, account_id_, trading_day_);
+            }
+        }
+        if (!ok) {
+            // 当前帧之后的增量都依赖已丢失的基准，等下一个头帧
+            synced = false;
+            ++pos;
+            ++corrupt;
+            continue;
+        }
+        pos = frame_end;
+    }
+
+    if (out_records != nullptr) {
+        *out_records = records;
+    }
+    if (out_corrupt != nullptr) {
+        *out_corrupt = corrupt;
+    }
+}
+
+}  // namespace acct_service
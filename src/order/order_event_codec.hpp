@@ -0,0 +1,123 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#include "common/fixed_string.hpp"
+#include "common/flat_hash_map.hpp"
+#include "common/types.hpp"
+#include "order/order_request.hpp"
+#include "shm/shm_layout.hpp"
+
+namespace acct_service {
+
+// 区分生产业务事件文件和调试细节文件。
+enum class order_event_stream_t : uint8_t {
+    Business = 0,
+    Debug = 1,
+};
+
+// 为订单事件定义稳定的落盘种类，避免运行时拼装自由文本。
+enum class OrderEventKind : uint8_t {
+    OrderAdded = 0,
+    OrderStatusUpdated = 1,
+    OrderTradeUpdated = 2,
+    OrderArchived = 3,
+    ParentRefreshed = 4,
+    SessionStarted = 5,
+    SessionRejected = 6,
+    ChildSubmitAttempt = 7,
+    ChildSubmitResult = 8,
+    ChildFinalized = 9,
+    OrderAmended = 10,
+};
+
+// 固定大小的队列条目，保证热路径无需动态分配即可投递事件。
+struct OrderEventRecord {
+    TimestampNs ts_ns = 0;
+    order_event_stream_t stream = order_event_stream_t::Business;
+    OrderEventKind kind = OrderEventKind::OrderAdded;
+    InternalOrderId order_id = 0;
+    InternalOrderId parent_order_id = 0;
+    StrategyId strategy_id = 0;
+    OrderIndex shm_order_index = kInvalidOrderIndex;
+    Volume volume_entrust = 0;
+    Volume volume_traded = 0;
+    Volume volume_remain = 0;
+    Volume target_volume = 0;
+    Volume working_volume = 0;
+    Volume schedulable_volume = 0;
+    DPrice dprice_entrust = 0;
+    DPrice dprice_traded = 0;
+    DValue dvalue_traded = 0;
+    DValue dfee_executed = 0;
+    OrderType order_type = OrderType::NotSet;
+    OrderState order_state = OrderState::NotSet;
+    TradeSide trade_side = TradeSide::NotSet;
+    Market market = Market::NotSet;
+    PassiveExecutionAlgo passive_execution_algo = PassiveExecutionAlgo::Default;
+    PassiveExecutionAlgo execution_algo = PassiveExecutionAlgo::None;
+    ExecutionState execution_state = ExecutionState::None;
+    bool is_split_child = false;
+    bool active_strategy_claimed = false;
+    bool success = false;
+    bool cancel_requested = false;
+    SecurityId security_id{};
+    InternalSecurityId internal_security_id{};
+    FixedString<160> detail{};
+};
+
+// 按记录所属流渲染一行 key=value 文本（含换行），与文本业务日志 / 调试 trace 逐字节一致。
+void write_order_event_line(std::ostream& out, const OrderEventRecord& record, AccountId account_id,
+                            std::string_view trading_day);
+
+// 增量记录文件（order_events_*.evd / order_debug_*.evd）：帧 = varint 负载长度 + 负载。
+// 负载首字节为帧类型：头帧携带账户与交易日并重置增量状态（进程重启续写时追加新头帧）；
+// 事件帧只写与同一订单上一条记录不同的字段，整数字段为差值 zigzag varint，时间戳相对上一帧。
+// 找不到同单基准（首条、已淘汰或基准表满）时写关键帧，以默认记录为基准。
+inline constexpr uint8_t kOrderEventFrameHeader = 'H';
+inline constexpr uint8_t kOrderEventFrameEvent = 'E';
+inline constexpr uint32_t kOrderEventDeltaMagic = 0x31445645;  // "EVD1"
+inline constexpr uint32_t kOrderEventDeltaVersion = 1;
+
+// 写端：基准表容量固定，订单归档 / 子单终结后淘汰；表满时新订单一律写关键帧。
+class order_event_delta_encoder {
+public:
+    explicit order_event_delta_encoder(std::size_t base_capacity = 16384);
+
+    // 追加头帧并清空增量状态，每次打开文件时调用一次。
+    void begin_stream(std::string& out, AccountId account_id, std::string_view trading_day);
+
+    // 追加一条事件帧。
+    void encode(const OrderEventRecord& record, std::string& out);
+
+private:
+    flat_hash_map<InternalOrderId, OrderEventRecord> bases_;
+    TimestampNs last_ts_ns_ = 0;
+    std::string payload_;  // 复用的单帧负载缓冲，写满一帧后再补长度前缀
+};
+
+// 读端：按帧还原完整记录；遇到损坏帧时向后逐字节寻找下一个头帧继续。
+class order_event_delta_decoder {
+public:
+    using visitor = std::function<void(const OrderEventRecord&, AccountId, std::string_view)>;
+
+    // 解码一段完整文件内容；out_records / out_corrupt 为还原的记录数与跳过的损坏字节数。
+    void decode(std::string_view data, const visitor& on_record, std::size_t* out_records = nullptr,
+                std::size_t* out_corrupt = nullptr);
+
+private:
+    bool decode_event(std::string_view payload, OrderEventRecord& record);
+
+    std::unordered_map<InternalOrderId, OrderEventRecord> bases_;
+    TimestampNs last_ts_ns_ = 0;
+    AccountId account_id_ = 0;
+    std::string trading_day_;
+};
+
+}  // namespace acct_service
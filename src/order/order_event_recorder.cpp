@@ -1,11 +1,12 @@
 #include "order/order_event_recorder.hpp"
 
 #include <algorithm>
+#include <cerrno>
 #include <chrono>
 #include <condition_variable>
 #include <filesystem>
-#include <fstream>
 #include <mutex>
+#include <sstream>
 #include <string>
 #include <thread>
 #include <utility>
@@ -13,234 +14,15 @@
 
 #include "common/fixed_string.hpp"
 #include "common/log.hpp"
-#include "order/passive_execution.hpp"
+#include "common/thread_setup.hpp"
+#include "order/order_event_codec.hpp"
+#include "order/order_journal.hpp"
+#include "utils/async_file_writer.hpp"
 
 namespace acct_service {
 
 namespace {
 
-// 区分生产业务事件文件和调试细节文件。
-enum class order_event_stream_t : uint8_t {
-    Business = 0,
-    Debug = 1,
-};
-
-const char* to_string(order_event_stream_t stream) noexcept {
-    switch (stream) {
-        case order_event_stream_t::Business:
-            return "business";
-        case order_event_stream_t::Debug:
-            return "debug";
-    }
-    return "business";
-}
-
-// 为订单事件定义稳定的落盘种类，避免运行时拼装自由文本。
-enum class OrderEventKind : uint8_t {
-    OrderAdded = 0,
-    OrderStatusUpdated = 1,
-    OrderTradeUpdated = 2,
-    OrderArchived = 3,
-    ParentRefreshed = 4,
-    SessionStarted = 5,
-    SessionRejected = 6,
-    ChildSubmitAttempt = 7,
-    ChildSubmitResult = 8,
-    ChildFinalized = 9,
-};
-
-// 固定大小的队列条目，保证热路径无需动态分配即可投递事件。
-struct OrderEventRecord {
-    TimestampNs ts_ns = 0;
-    order_event_stream_t stream = order_event_stream_t::Business;
-    OrderEventKind kind = OrderEventKind::OrderAdded;
-    InternalOrderId order_id = 0;
-    InternalOrderId parent_order_id = 0;
-    StrategyId strategy_id = 0;
-    OrderIndex shm_order_index = kInvalidOrderIndex;
-    Volume volume_entrust = 0;
-    Volume volume_traded = 0;
-    Volume volume_remain = 0;
-    Volume target_volume = 0;
-    Volume working_volume = 0;
-    Volume schedulable_volume = 0;
-    DPrice dprice_entrust = 0;
-    DPrice dprice_traded = 0;
-    DValue dvalue_traded = 0;
-    DValue dfee_executed = 0;
-    OrderType order_type = OrderType::NotSet;
-    OrderState order_state = OrderState::NotSet;
-    TradeSide trade_side = TradeSide::NotSet;
-    Market market = Market::NotSet;
-    PassiveExecutionAlgo passive_execution_algo = PassiveExecutionAlgo::Default;
-    PassiveExecutionAlgo execution_algo = PassiveExecutionAlgo::None;
-    ExecutionState execution_state = ExecutionState::None;
-    bool is_split_child = false;
-    bool active_strategy_claimed = false;
-    bool success = false;
-    bool cancel_requested = false;
-    SecurityId security_id{};
-    InternalSecurityId internal_security_id{};
-    FixedString<160> detail{};
-};
-
-// 统一把订单枚举渲染成稳定的文本值，便于文件检索和下游解析。
-const char* to_string(OrderEventKind kind) noexcept {
-    switch (kind) {
-        case OrderEventKind::OrderAdded:
-            return "order_added";
-        case OrderEventKind::OrderStatusUpdated:
-            return "order_status_updated";
-        case OrderEventKind::OrderTradeUpdated:
-            return "order_trade_updated";
-        case OrderEventKind::OrderArchived:
-            return "order_archived";
-        case OrderEventKind::ParentRefreshed:
-            return "parent_refreshed";
-        case OrderEventKind::SessionStarted:
-            return "session_started";
-        case OrderEventKind::SessionRejected:
-            return "session_rejected";
-        case OrderEventKind::ChildSubmitAttempt:
-            return "child_submit_attempt";
-        case OrderEventKind::ChildSubmitResult:
-            return "child_submit_result";
-        case OrderEventKind::ChildFinalized:
-            return "child_finalized";
-    }
-    return "order_added";
-}
-
-// 统一渲染订单类型，避免业务日志混入数值枚举。
-const char* to_string(OrderType type) noexcept {
-    switch (type) {
-        case OrderType::New:
-            return "new";
-        case OrderType::Cancel:
-            return "cancel";
-        case OrderType::NotSet:
-            return "not_set";
-        case OrderType::Unknown:
-            return "unknown";
-    }
-    return "unknown";
-}
-
-// 统一渲染买卖方向。
-const char* to_string(TradeSide side) noexcept {
-    switch (side) {
-        case TradeSide::Buy:
-            return "buy";
-        case TradeSide::Sell:
-            return "sell";
-        case TradeSide::NotSet:
-        default:
-            return "not_set";
-    }
-}
-
-// 统一渲染市场枚举。
-const char* to_string(Market market) noexcept {
-    switch (market) {
-        case Market::SZ:
-            return "sz";
-        case Market::SH:
-            return "sh";
-        case Market::BJ:
-            return "bj";
-        case Market::HK:
-            return "hk";
-        case Market::NotSet:
-            return "not_set";
-        case Market::Unknown:
-        default:
-            return "unknown";
-    }
-}
-
-// 统一渲染订单状态。
-const char* to_string(OrderState state) noexcept {
-    switch (state) {
-        case OrderState::NotSet:
-            return "not_set";
-        case OrderState::UserSubmitted:
-            return "user_submitted";
-        case OrderState::RiskControllerPending:
-            return "risk_pending";
-        case OrderState::RiskControllerRejected:
-            return "risk_rejected";
-        case OrderState::RiskControllerAccepted:
-            return "risk_accepted";
-        case OrderState::TraderPending:
-            return "trader_pending";
-        case OrderState::TraderRejected:
-            return "trader_rejected";
-        case OrderState::TraderSubmitted:
-            return "trader_submitted";
-        case OrderState::TraderError:
-            return "trader_error";
-        case OrderState::BrokerRejected:
-            return "broker_rejected";
-        case OrderState::BrokerAccepted:
-            return "broker_accepted";
-        case OrderState::MarketRejected:
-            return "market_rejected";
-        case OrderState::MarketAccepted:
-            return "market_accepted";
-        case OrderState::Finished:
-            return "finished";
-        case OrderState::Unknown:
-        default:
-            return "unknown";
-    }
-}
-
-// 统一渲染执行状态。
-const char* to_string(ExecutionState state) noexcept {
-    switch (state) {
-        case ExecutionState::None:
-            return "none";
-        case ExecutionState::Running:
-            return "running";
-        case ExecutionState::Cancelling:
-            return "cancelling";
-        case ExecutionState::Finished:
-            return "finished";
-        case ExecutionState::Failed:
-            return "failed";
-    }
-    return "none";
-}
-
-// 对字符串字段做最小转义，保证日志仍然保持单行。
-std::string escape_field(std::string_view value) {
-    std::string out;
-    out.reserve(value.size() + 8);
-    for (char ch : value) {
-        switch (ch) {
-            case '\\':
-                out += "\\\\";
-                break;
-            case '"':
-                out += "\\\"";
-                break;
-            case '\n':
-                out += "\\n";
-                break;
-            case '\r':
-                out += "\\r";
-                break;
-            case '\t':
-                out += "\\t";
-                break;
-            default:
-                out.push_back(ch);
-                break;
-        }
-    }
-    return out;
-}
-
 // 统一填充订单快照上的稳定业务字段，供生产日志和调试日志共享。
 void fill_from_order_entry(OrderEventRecord& record, const OrderEntry& entry) {
     const OrderRequest& request = entry.request;
@@ -271,53 +53,6 @@ void fill_from_order_entry(OrderEventRecord& record, const OrderEntry& entry) {
     record.internal_security_id = request.internal_security_id;
 }
 
-bool should_render_success(OrderEventKind kind) noexcept { return kind == OrderEventKind::ChildSubmitResult; }
-
-bool should_render_cancel_requested(OrderEventKind kind) noexcept { return kind == OrderEventKind::ChildFinalized; }
-
-bool should_render_active_strategy_claimed(OrderEventKind kind) noexcept {
-    return kind == OrderEventKind::ChildSubmitAttempt || kind == OrderEventKind::ChildSubmitResult;
-}
-
-bool should_render_shm_order_index(const OrderEventRecord& record) noexcept {
-    return record.stream == order_event_stream_t::Business || record.shm_order_index != kInvalidOrderIndex;
-}
-
-bool should_render_order_state(const OrderEventRecord& record) noexcept {
-    return record.stream == order_event_stream_t::Business || record.order_state != OrderState::NotSet;
-}
-
-bool should_render_detail(const OrderEventRecord& record) noexcept { return !record.detail.empty(); }
-
-bool is_child_trace(OrderEventKind kind) noexcept {
-    return kind == OrderEventKind::ChildSubmitAttempt || kind == OrderEventKind::ChildSubmitResult ||
-           kind == OrderEventKind::ChildFinalized;
-}
-
-InternalOrderId debug_parent_order_id(const OrderEventRecord& record) noexcept {
-    return (record.parent_order_id != 0) ? record.parent_order_id : record.order_id;
-}
-
-const char* debug_detail_key(OrderEventKind kind) noexcept {
-    switch (kind) {
-        case OrderEventKind::SessionRejected:
-            return "reason";
-        case OrderEventKind::ChildSubmitResult:
-            return "result";
-        case OrderEventKind::ChildFinalized:
-            return "summary";
-        case OrderEventKind::OrderAdded:
-        case OrderEventKind::OrderStatusUpdated:
-        case OrderEventKind::OrderTradeUpdated:
-        case OrderEventKind::OrderArchived:
-        case OrderEventKind::ParentRefreshed:
-        case OrderEventKind::SessionStarted:
-        case OrderEventKind::ChildSubmitAttempt:
-        default:
-            return "detail";
-    }
-}
-
 // 根据订单簿事件映射稳定的业务事件名。
 OrderEventKind map_order_event_kind(order_book_event_t event) noexcept {
     switch (event) {
@@ -329,6 +64,8 @@ OrderEventKind map_order_event_kind(order_book_event_t event) noexcept {
             return OrderEventKind::OrderTradeUpdated;
         case order_book_event_t::Archived:
             return OrderEventKind::OrderArchived;
+        case order_book_event_t::Amended:
+            return OrderEventKind::OrderAmended;
         case order_book_event_t::ParentRefreshed:
         default:
             return OrderEventKind::ParentRefreshed;
@@ -346,20 +83,34 @@ struct OrderEventRecorder::Impl {
     std::atomic<uint32_t> write_index_{0};
     std::atomic<uint32_t> read_index_{0};
     std::atomic<uint64_t> dropped_count_{0};
+    std::atomic<bool> pending_{false};  // 生产者置位、writer 清除；生产者不做任何唤醒
     std::mutex wait_mutex_{};
-    std::condition_variable wait_cv_{};
-    std::ofstream business_out_{};
+    std::condition_variable wait_cv_{};  // 仅用于 shutdown 打断 writer 的节拍等待
+    base_core::AsyncFileWriter business_out_{};  // 文本行拷入对齐大块缓冲，io_uring / pwritev 异步写出
+    order_journal_writer journal_{};
 #if defined(ACCT_ENABLE_DEBUG_ORDER_TRACE)
-    std::ofstream debug_out_{};
+    base_core::AsyncFileWriter debug_out_{};
+    order_event_delta_encoder debug_encoder_{};
 #endif
+    order_event_delta_encoder business_encoder_{};  // delta_records 模式下每个文件各一份同单基准
+    std::string encoded_{};
+    std::ostringstream formatter_{};
     std::jthread writer_thread_{};
 
+    ~Impl() {
+        business_out_.close();
+#if defined(ACCT_ENABLE_DEBUG_ORDER_TRACE)
+        debug_out_.close();
+#endif
+    }
+
     // 判断 ring 中是否还有未刷新的事件。
     bool has_pending_events() const noexcept {
         return read_index_.load(std::memory_order_acquire) != write_index_.load(std::memory_order_acquire);
     }
 
-    // 以无锁 SPSC 方式入队；队列满时直接丢弃，不阻塞交易线程。
+    // wait-free SPSC 入队：只置 pending 标志，不通知条件变量，交易线程上没有锁和系统调用；
+    // 队列满时直接丢弃，不阻塞交易线程。
     bool try_enqueue(const OrderEventRecord& record) noexcept {
         const uint32_t write_index = write_index_.load(std::memory_order_relaxed);
         const uint32_t next_index = (write_index + 1) % ring_size_;
@@ -371,8 +122,28 @@ struct OrderEventRecorder::Impl {
 
         ring_[write_index] = record;
         write_index_.store(next_index, std::memory_order_release);
-        if (write_index == read_index) {
-            wait_cv_.notify_one();
+        // 已置位时跳过写入，避免每条记录都让 writer 所在核的缓存行失效
+        if (!pending_.load(std::memory_order_relaxed)) {
+            pending_.store(true, std::memory_order_release);
+        }
+        return true;
+    }
+
+    base_core::AsyncFileWriterConfig output_config() const noexcept {
+        base_core::AsyncFileWriterConfig output;
+        output.sync_interval_ms = config_.sync_interval_ms;
+        return output;
+    }
+
+    // 增量模式每次打开（含重启续写）先写头帧，解码端据此重置同单基准。
+    bool open_output(base_core::AsyncFileWriter& out, order_event_delta_encoder& encoder, const std::string& name) {
+        if (!out.open(config_.output_dir + name, false, output_config())) {
+            return false;
+        }
+        if (config_.delta_records) {
+            encoded_.clear();
+            encoder.begin_stream(encoded_, account_id_, trading_day_);
+            (void)out.write(encoded_);
         }
         return true;
     }
@@ -386,14 +157,20 @@ struct OrderEventRecorder::Impl {
         }
 
         const std::string suffix = std::to_string(account_id_) + "_" + trading_day_;
-        business_out_.open(config_.output_dir + "/order_events_" + suffix + ".log", std::ios::out | std::ios::app);
-        if (!business_out_.is_open()) {
-            return false;
+        const char* extension = config_.delta_records ? ".evd" : ".log";
+        if (config_.binary_journal) {
+            if (!journal_.open(order_journal_location{config_.output_dir, account_id_, trading_day_},
+                               config_.journal_segment_records)) {
+                return false;
+            }
+        } else {
+            if (!open_output(business_out_, business_encoder_, "/order_events_" + suffix + extension)) {
+                return false;
+            }
         }
 
 #if defined(ACCT_ENABLE_DEBUG_ORDER_TRACE)
-        debug_out_.open(config_.output_dir + "/order_debug_" + suffix + ".log", std::ios::out | std::ios::app);
-        if (!debug_out_.is_open()) {
+        if (!open_output(debug_out_, debug_encoder_, "/order_debug_" + suffix + extension)) {
             return false;
         }
 #endif
@@ -401,140 +178,65 @@ struct OrderEventRecorder::Impl {
         return true;
     }
 
-    void write_business_prefix(std::ostream& out, const OrderEventRecord& record) {
-        out << "ts_ns=" << record.ts_ns << " account_id=" << account_id_ << " trading_day=\""
-            << escape_field(trading_day_) << "\" stream=\"" << to_string(record.stream) << "\" event=\""
-            << to_string(record.kind) << "\"" << " order_id=" << record.order_id
-            << " parent_order_id=" << record.parent_order_id << " strategy_id=" << record.strategy_id;
-        if (should_render_shm_order_index(record)) {
-            out << " shm_order_index=" << record.shm_order_index;
+    // 按输出模式编码一条记录：文本行，或相对同单上一条记录的增量帧。
+    void encode_record(const OrderEventRecord& record, order_event_delta_encoder& encoder,
+                       base_core::AsyncFileWriter& out) {
+        if (config_.delta_records) {
+            encoded_.clear();
+            encoder.encode(record, encoded_);
+            (void)out.write(encoded_);
+            return;
         }
+        formatter_.str(std::string());
+        write_order_event_line(formatter_, record, account_id_, trading_day_);
+        (void)out.write(formatter_.view());
     }
 
-    // 业务事件日志只保留订单快照事实字段，避免混入调试默认值误导排查。
-    void write_business_record(std::ostream& out, const OrderEventRecord& record) {
-        write_business_prefix(out, record);
-        out << " is_split_child=" << (record.is_split_child ? "true" : "false") << " order_type=\""
-            << to_string(record.order_type) << "\" trade_side=\"" << to_string(record.trade_side) << "\" market=\""
-            << to_string(record.market) << "\" order_state=\"" << to_string(record.order_state)
-            << "\" passive_execution_algo=\"" << passive_execution_algo_name(record.passive_execution_algo)
-            << "\" execution_algo=\"" << passive_execution_algo_name(record.execution_algo) << "\" execution_state=\""
-            << to_string(record.execution_state) << "\" volume_entrust=" << record.volume_entrust
-            << " volume_traded=" << record.volume_traded << " volume_remain=" << record.volume_remain
-            << " target_volume=" << record.target_volume << " working_volume=" << record.working_volume
-            << " schedulable_volume=" << record.schedulable_volume << " dprice_entrust=" << record.dprice_entrust
-            << " dprice_traded=" << record.dprice_traded << " dvalue_traded=" << record.dvalue_traded
-            << " dfee_executed=" << record.dfee_executed << " security_id=\"" << escape_field(record.security_id.view())
-            << "\" internal_security_id=\"" << escape_field(record.internal_security_id.view()) << "\"";
-        if (should_render_detail(record)) {
-            out << " detail=\"" << escape_field(record.detail.view()) << "\"";
+    // 编码单条记录并拷入对应文件的写出缓冲，缓冲写满时由写出器整块提交。
+    void stage_record(const OrderEventRecord& record) {
+        if (record.stream == order_event_stream_t::Business) {
+            encode_record(record, business_encoder_, business_out_);
         }
-        out << '\n';
-    }
-
-    void write_debug_prefix(std::ostream& out, const OrderEventRecord& record) {
-        out << "ts_ns=" << record.ts_ns << " account_id=" << account_id_ << " trading_day=\""
-            << escape_field(trading_day_) << "\" stream=\"" << to_string(record.stream) << "\" trace=\""
-            << to_string(record.kind) << "\"" << " parent_order_id=" << debug_parent_order_id(record)
-            << " strategy_id=" << record.strategy_id;
-        if (is_child_trace(record.kind)) {
-            out << " child_order_id=" << record.order_id;
-        }
-        if (should_render_shm_order_index(record)) {
-            out << " shm_order_index=" << record.shm_order_index;
+#if defined(ACCT_ENABLE_DEBUG_ORDER_TRACE)
+        else {
+            encode_record(record, debug_encoder_, debug_out_);
         }
+#endif
     }
 
-    // 调试 trace 聚焦执行会话推进过程，只打印当前事件真正有语义的字段。
-    void write_debug_record(std::ostream& out, const OrderEventRecord& record) {
-        write_debug_prefix(out, record);
-        out << " order_type=\"" << to_string(record.order_type) << "\" trade_side=\"" << to_string(record.trade_side)
-            << "\" market=\"" << to_string(record.market) << "\"";
-        if (should_render_order_state(record)) {
-            out << " order_state=\"" << to_string(record.order_state) << "\"";
-        }
-        out << " passive_execution_algo=\"" << passive_execution_algo_name(record.passive_execution_algo)
-            << "\" execution_algo=\"" << passive_execution_algo_name(record.execution_algo) << "\" execution_state=\""
-            << to_string(record.execution_state) << "\" is_split_child=" << (record.is_split_child ? "true" : "false");
-        if (should_render_active_strategy_claimed(record.kind)) {
-            out << " active_strategy_claimed=" << (record.active_strategy_claimed ? "true" : "false");
-        }
-        if (should_render_success(record.kind)) {
-            out << " success=" << (record.success ? "true" : "false");
-        }
-        if (should_render_cancel_requested(record.kind)) {
-            out << " cancel_requested=" << (record.cancel_requested ? "true" : "false");
-        }
-        out << " volume_entrust=" << record.volume_entrust << " volume_traded=" << record.volume_traded
-            << " volume_remain=" << record.volume_remain << " target_volume=" << record.target_volume
-            << " working_volume=" << record.working_volume << " schedulable_volume=" << record.schedulable_volume
-            << " dprice_entrust=" << record.dprice_entrust << " dprice_traded=" << record.dprice_traded
-            << " dvalue_traded=" << record.dvalue_traded << " dfee_executed=" << record.dfee_executed
-            << " security_id=\"" << escape_field(record.security_id.view()) << "\" internal_security_id=\""
-            << escape_field(record.internal_security_id.view()) << "\"";
-        if (should_render_detail(record)) {
-            out << ' ' << debug_detail_key(record.kind) << "=\"" << escape_field(record.detail.view()) << "\"";
+    // 排空 ring 中当前可见的全部记录，每个节拍把未满的缓冲提交一次（不等待落盘）。
+    void drain_ring() {
+        uint32_t read_index = read_index_.load(std::memory_order_relaxed);
+        uint32_t write_index = write_index_.load(std::memory_order_acquire);
+        while (read_index != write_index) {
+            stage_record(ring_[read_index]);
+            read_index = (read_index + 1) % ring_size_;
+            read_index_.store(read_index, std::memory_order_release);
+            write_index = write_index_.load(std::memory_order_acquire);
         }
-        out << '\n';
+        business_out_.flush();
+#if defined(ACCT_ENABLE_DEBUG_ORDER_TRACE)
+        debug_out_.flush();
+#endif
     }
 
-    // 后台线程持续消费 ring，避免热路径直接做文件 IO。
+    // 后台线程按 flush_interval_ms 节拍批量消费 ring，生产者从不唤醒它。
     void writer_loop(std::stop_token stop_token) {
         const auto flush_interval = std::chrono::milliseconds(config_.flush_interval_ms);
+        (void)apply_thread_realtime("order_event_recorder",
+                                    thread_realtime_config{config_.writer_cpu_core, config_.writer_priority});
 
         while (!stop_token.stop_requested()) {
-            bool drained = false;
-            uint32_t read_index = read_index_.load(std::memory_order_relaxed);
-            uint32_t write_index = write_index_.load(std::memory_order_acquire);
-            while (read_index != write_index) {
-                const OrderEventRecord& record = ring_[read_index];
-                if (record.stream == order_event_stream_t::Business) {
-                    write_business_record(business_out_, record);
-                }
-#if defined(ACCT_ENABLE_DEBUG_ORDER_TRACE)
-                else {
-                    write_debug_record(debug_out_, record);
-                }
-#endif
-                drained = true;
-                read_index = (read_index + 1) % ring_size_;
-                read_index_.store(read_index, std::memory_order_release);
-                write_index = write_index_.load(std::memory_order_acquire);
-            }
-
-            if (drained) {
-                business_out_.flush();
-#if defined(ACCT_ENABLE_DEBUG_ORDER_TRACE)
-                debug_out_.flush();
-#endif
+            // 清标志后再复查 ring：生产者在标志仍为 true 时跳过置位，不能只凭标志判断
+            if (pending_.exchange(false, std::memory_order_acquire) || has_pending_events()) {
+                drain_ring();
             }
 
             std::unique_lock<std::mutex> lock(wait_mutex_);
-            wait_cv_.wait_for(lock, flush_interval,
-                              [&]() { return stop_token.stop_requested() || has_pending_events(); });
-        }
-
-        uint32_t read_index = read_index_.load(std::memory_order_relaxed);
-        uint32_t write_index = write_index_.load(std::memory_order_acquire);
-        while (read_index != write_index) {
-            const OrderEventRecord& record = ring_[read_index];
-            if (record.stream == order_event_stream_t::Business) {
-                write_business_record(business_out_, record);
-            }
-#if defined(ACCT_ENABLE_DEBUG_ORDER_TRACE)
-            else {
-                write_debug_record(debug_out_, record);
-            }
-#endif
-            read_index = (read_index + 1) % ring_size_;
-            read_index_.store(read_index, std::memory_order_release);
-            write_index = write_index_.load(std::memory_order_acquire);
+            wait_cv_.wait_for(lock, flush_interval, [&]() { return stop_token.stop_requested(); });
         }
 
-        business_out_.flush();
-#if defined(ACCT_ENABLE_DEBUG_ORDER_TRACE)
-        debug_out_.flush();
-#endif
+        drain_ring();
     }
 };
 
@@ -556,7 +258,8 @@ bool OrderEventRecorder::init(const BusinessLogConfig& config, AccountId account
         return true;
     }
     if (config.queue_capacity < 2 || config.queue_capacity >= static_cast<std::size_t>(UINT32_MAX) ||
-        config.output_dir.empty() || config.flush_interval_ms == 0) {
+        config.output_dir.empty() || config.flush_interval_ms == 0 ||
+        (config.binary_journal && config.journal_segment_records == 0)) {
         return false;
     }
 
@@ -599,11 +302,31 @@ uint64_t OrderEventRecorder::dropped_count() const noexcept {
     return impl_->dropped_count_.load(std::memory_order_relaxed);
 }
 
+memory_usage OrderEventRecorder::memory() const noexcept {
+    if (!impl_) {
+        return {};
+    }
+    const uint32_t write_index = impl_->write_index_.load(std::memory_order_acquire);
+    const uint32_t read_index = impl_->read_index_.load(std::memory_order_acquire);
+    const uint32_t pending = (write_index + impl_->ring_size_ - read_index) % impl_->ring_size_;
+    return element_memory(impl_->ring_.capacity(), pending, sizeof(OrderEventRecord));
+}
+
 void OrderEventRecorder::record_order_event(const OrderEntry& entry, order_book_event_t event) noexcept {
     if (!impl_) {
         return;
     }
 
+    // 二进制日志模式下由交易线程直接定长拷贝进 mmap 段，不经过 ring 与后台格式化
+    if (impl_->journal_.is_open()) {
+        order_journal_record journal_record{};
+        fill_order_journal_record(journal_record, entry, event);
+        if (!impl_->journal_.append(journal_record)) {
+            impl_->dropped_count_.fetch_add(1, std::memory_order_relaxed);
+        }
+        return;
+    }
+
     OrderEventRecord record{};
     fill_from_order_entry(record, entry);
     record.ts_ns = (entry.last_update_ns != 0) ? entry.last_update_ns : entry.submit_time_ns;
@@ -5,6 +5,7 @@
 #include <string_view>
 
 #include "common/business_log_config.hpp"
+#include "common/memory_accounting.hpp"
 #include "common/types.hpp"
 #include "order/order_book.hpp"
 
@@ -34,6 +35,9 @@ public:
     // 返回因队列满被丢弃的事件数量。
     uint64_t dropped_count() const noexcept;
 
+    // 返回事件 ring 的内存占用：按 ring 长度预留，尚未被写线程取走的事件计在用；未启用时为零。
+    memory_usage memory() const noexcept;
+
     // 记录订单簿对外可见的稳定业务事件。
     void record_order_event(const OrderEntry& entry, order_book_event_t event) noexcept;
 
@@ -0,0 +1,292 @@
+#include "order/order_journal.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+#include <new>
+
+#include "common/error.hpp"
+#include "common/log.hpp"
+
+namespace acct_service {
+
+namespace {
+
+bool report_journal_error(ErrorCode code, std::string_view message, int sys_errno = 0) {
+    ErrorStatus status = ACCT_MAKE_ERROR(ErrorDomain::order, code, "order_journal", message, sys_errno);
+    record_error(status);
+    ACCT_LOG_ERROR_STATUS(status);
+    return false;
+}
+
+std::size_t segment_file_size(uint32_t capacity) noexcept {
+    return sizeof(order_journal_segment_header) + static_cast<std::size_t>(capacity) * sizeof(order_journal_record);
+}
+
+// 段头与文件尺寸一致才可读写，避免把其他版本或截断文件当作日志解析。
+bool is_valid_segment(const order_journal_segment_header& header, std::size_t file_size) noexcept {
+    return header.magic == order_journal_segment_header::kMagic &&
+           header.version == order_journal_segment_header::kVersion &&
+           header.record_size == sizeof(order_journal_record) && header.capacity != 0 &&
+           file_size == segment_file_size(header.capacity) &&
+           header.record_count.load(std::memory_order_acquire) <= header.capacity;
+}
+
+}  // namespace
+
+std::string order_journal_location::segment_path(uint32_t segment_index) const {
+    return output_dir + "/order_journal_" + std::to_string(account_id) + "_" + trading_day + "_" +
+           std::to_string(segment_index) + ".bin";
+}
+
+void fill_order_journal_record(order_journal_record& record, const OrderEntry& entry,
+                               order_book_event_t event) noexcept {
+    const OrderRequest& request = entry.request;
+    record.ts_ns = (entry.last_update_ns != 0) ? entry.last_update_ns : entry.submit_time_ns;
+    record.order_id = request.internal_order_id;
+    record.parent_order_id = entry.parent_order_id;
+    record.shm_order_index = entry.shm_order_index;
+    record.strategy_id = entry.strategy_id;
+    record.event = event;
+    record.order_type = request.order_type;
+    record.order_state = request.order_state.load(std::memory_order_acquire);
+    record.trade_side = request.trade_side;
+    record.market = request.market;
+    record.passive_execution_algo = request.passive_execution_algo;
+    record.execution_algo = request.execution_algo;
+    record.execution_state = request.execution_state;
+    record.flags = static_cast<uint8_t>((entry.is_split_child ? kOrderJournalSplitChild : 0) |
+                                        (request.active_strategy_claimed != 0 ? kOrderJournalActiveClaimed : 0));
+    record.volume_entrust = request.volume_entrust;
+    record.volume_traded = request.volume_traded;
+    record.volume_remain = request.volume_remain;
+    record.target_volume = request.target_volume;
+    record.working_volume = request.working_volume;
+    record.schedulable_volume = request.schedulable_volume;
+    record.dprice_entrust = request.dprice_entrust;
+    record.dprice_traded = request.dprice_traded;
+    record.dvalue_traded = request.dvalue_traded;
+    record.dfee_executed = request.dfee_executed;
+    record.security_id = request.security_id;
+    record.internal_security_id = request.internal_security_id;
+}
+
+const char* order_journal_event_name(order_book_event_t event) noexcept {
+    switch (event) {
+        case order_book_event_t::Added:
+            return "order_added";
+        case order_book_event_t::StatusUpdated:
+            return "order_status_updated";
+        case order_book_event_t::TradeUpdated:
+            return "order_trade_updated";
+        case order_book_event_t::Archived:
+            return "order_archived";
+        case order_book_event_t::ParentRefreshed:
+            return "parent_refreshed";
+        case order_book_event_t::Amended:
+            return "order_amended";
+    }
+    return "unknown";
+}
+
+order_journal_writer::~order_journal_writer() { close(); }
+
+bool order_journal_writer::open(const order_journal_location& location, uint32_t segment_records) {
+    close();
+    if (location.output_dir.empty() || segment_records == 0) {
+        return report_journal_error(ErrorCode::InvalidConfig, "order journal location or segment size is invalid");
+    }
+
+    std::error_code ec;
+    std::filesystem::create_directories(location.output_dir, ec);
+    if (ec) {
+        return report_journal_error(ErrorCode::LoggerInitFailed, "failed to create order journal directory");
+    }
+
+    location_ = location;
+    segment_records_ = segment_records;
+
+    // 重启后续写最后一段，保证同一交易日的段号连续，回放无需合并多套文件
+    uint32_t next_segment = 0;
+    while (std::filesystem::exists(location_.segment_path(next_segment), ec)) {
+        ++next_segment;
+    }
+    if (next_segment == 0) {
+        return map_segment(0, segment_records_);
+    }
+    if (!map_segment(next_segment - 1, 0)) {
+        return false;
+    }
+    if (header_->record_count.load(std::memory_order_relaxed) >= header_->capacity) {
+        return map_segment(next_segment, segment_records_);
+    }
+    return true;
+}
+
+void order_journal_writer::close() noexcept {
+    if (mapping_) {
+        ::munmap(mapping_, mapping_size_);
+    }
+    mapping_ = nullptr;
+    mapping_size_ = 0;
+    header_ = nullptr;
+    records_ = nullptr;
+}
+
+// capacity 为 0 表示打开已有段并沿用其段头容量，否则新建并初始化段头。
+bool order_journal_writer::map_segment(uint32_t segment_index, uint32_t capacity) {
+    close();
+    const std::string path = location_.segment_path(segment_index);
+    const bool create = capacity != 0;
+    const int fd = ::open(path.c_str(), O_RDWR | O_CLOEXEC | (create ? (O_CREAT | O_EXCL) : 0), 0644);
+    if (fd < 0) {
+        return report_journal_error(ErrorCode::LoggerInitFailed, "failed to open order journal segment", errno);
+    }
+
+    std::size_t file_size = 0;
+    if (create) {
+        file_size = segment_file_size(capacity);
+        if (::ftruncate(fd, static_cast<off_t>(file_size)) != 0) {
+            const int err = errno;
+            ::close(fd);
+            return report_journal_error(ErrorCode::LoggerInitFailed, "failed to size order journal segment", err);
+        }
+    } else {
+        struct stat file_stat {};
+        if (::fstat(fd, &file_stat) != 0) {
+            const int err = errno;
+            ::close(fd);
+            return report_journal_error(ErrorCode::LoggerInitFailed, "failed to stat order journal segment", err);
+        }
+        file_size = static_cast<std::size_t>(file_stat.st_size);
+        if (file_size < sizeof(order_journal_segment_header)) {
+            ::close(fd);
+            return report_journal_error(ErrorCode::LoggerInitFailed, "order journal segment is truncated");
+        }
+    }
+
+    void* mapping = ::mmap(nullptr, file_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    const int map_err = errno;
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        return report_journal_error(ErrorCode::LoggerInitFailed, "failed to mmap order journal segment", map_err);
+    }
+
+    auto* header = static_cast<order_journal_segment_header*>(mapping);
+    if (create) {
+        header = new (mapping) order_journal_segment_header{};
+        header->record_size = sizeof(order_journal_record);
+        header->capacity = capacity;
+        header->account_id = location_.account_id;
+        header->segment_index = segment_index;
+        std::strncpy(header->trading_day, location_.trading_day.c_str(), sizeof(header->trading_day) - 1);
+    } else if (!is_valid_segment(*header, file_size) || header->segment_index != segment_index) {
+        ::munmap(mapping, file_size);
+        return report_journal_error(ErrorCode::LoggerInitFailed, "order journal segment header is invalid");
+    }
+
+    mapping_ = mapping;
+    mapping_size_ = file_size;
+    header_ = header;
+    records_ = reinterpret_cast<order_journal_record*>(static_cast<char*>(mapping) +
+                                                       sizeof(order_journal_segment_header));
+    return true;
+}
+
+bool order_journal_writer::append(const order_journal_record& record) noexcept {
+    if (!header_) {
+        return false;
+    }
+
+    uint64_t count = header_->record_count.load(std::memory_order_relaxed);
+    if (count >= header_->capacity) {
+        if (!map_segment(header_->segment_index + 1, segment_records_)) {
+            return false;
+        }
+        count = 0;
+    }
+
+    // 先写记录再 release 发布计数，读端按计数截断即可跳过崩溃时写了一半的记录
+    records_[count] = record;
+    header_->record_count.store(count + 1, std::memory_order_release);
+    return true;
+}
+
+bool order_journal_read_segment(const std::string& path, const order_journal_visitor& visitor,
+                                std::size_t* out_records) {
+    if (out_records) {
+        *out_records = 0;
+    }
+
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return report_journal_error(ErrorCode::InvalidParam, "failed to open order journal segment", errno);
+    }
+    struct stat file_stat {};
+    if (::fstat(fd, &file_stat) != 0) {
+        const int err = errno;
+        ::close(fd);
+        return report_journal_error(ErrorCode::InvalidParam, "failed to stat order journal segment", err);
+    }
+    const std::size_t file_size = static_cast<std::size_t>(file_stat.st_size);
+    if (file_size < sizeof(order_journal_segment_header)) {
+        ::close(fd);
+        return report_journal_error(ErrorCode::InvalidParam, "order journal segment is truncated");
+    }
+
+    // MAP_SHARED 只读映射：与同进程写端共享页缓存，能看到尚未落盘的已提交记录
+    void* mapping = ::mmap(nullptr, file_size, PROT_READ, MAP_SHARED, fd, 0);
+    const int map_err = errno;
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        return report_journal_error(ErrorCode::InvalidParam, "failed to mmap order journal segment", map_err);
+    }
+
+    const auto* header = static_cast<const order_journal_segment_header*>(mapping);
+    if (!is_valid_segment(*header, file_size)) {
+        ::munmap(mapping, file_size);
+        return report_journal_error(ErrorCode::InvalidParam, "order journal segment header is invalid");
+    }
+
+    const uint64_t count = header->record_count.load(std::memory_order_acquire);
+    const auto* records = reinterpret_cast<const order_journal_record*>(static_cast<const char*>(mapping) +
+                                                                        sizeof(order_journal_segment_header));
+    for (uint64_t i = 0; i < count; ++i) {
+        visitor(records[i]);
+    }
+    ::munmap(mapping, file_size);
+    if (out_records) {
+        *out_records = static_cast<std::size_t>(count);
+    }
+    return true;
+}
+
+bool order_journal_replay(const order_journal_location& location, const order_journal_visitor& visitor,
+                          std::size_t* out_segments) {
+    std::size_t segments = 0;
+    std::error_code ec;
+    for (uint32_t segment = 0;; ++segment) {
+        const std::string path = location.segment_path(segment);
+        if (!std::filesystem::exists(path, ec)) {
+            break;
+        }
+        if (!order_journal_read_segment(path, visitor)) {
+            if (out_segments) {
+                *out_segments = segments;
+            }
+            return false;
+        }
+        ++segments;
+    }
+    if (out_segments) {
+        *out_segments = segments;
+    }
+    return true;
+}
+
+}  // namespace acct_service
@@ -0,0 +1,129 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+#include "common/types.hpp"
+#include "order/order_book.hpp"
+
+namespace acct_service {
+
+// 二进制订单日志：按段滚动的定长记录文件，段文件 = 64 字节段头 + capacity 条记录。
+// 段路径为 <output_dir>/order_journal_<account>_<trading_day>_<segment>.bin，段号从 0 连续递增。
+struct order_journal_segment_header {
+    static constexpr uint32_t kMagic = 0x4C4E524A;  // "JRNL"
+    static constexpr uint32_t kVersion = 1;
+
+    uint32_t magic = kMagic;
+    uint32_t version = kVersion;
+    uint32_t record_size = 0;
+    uint32_t capacity = 0;
+    AccountId account_id = 0;
+    uint32_t segment_index = 0;
+    std::atomic<uint64_t> record_count{0};  // 已提交记录数，写端 release 发布、读端 acquire 读取
+    char trading_day[16] = {};
+    uint8_t reserved[16] = {};
+};
+
+static_assert(sizeof(order_journal_segment_header) == 64, "order_journal_segment_header must be 64 bytes");
+
+inline constexpr uint8_t kOrderJournalSplitChild = 0x01;
+inline constexpr uint8_t kOrderJournalActiveClaimed = 0x02;
+
+// 单条订单事件：订单簿变更时的快照事实字段，写端只做定长拷贝不做格式化。
+struct order_journal_record {
+    TimestampNs ts_ns = 0;
+    InternalOrderId order_id = 0;
+    InternalOrderId parent_order_id = 0;
+    OrderIndex shm_order_index = kInvalidOrderIndex;
+    StrategyId strategy_id = 0;
+    order_book_event_t event = order_book_event_t::Added;
+    OrderType order_type = OrderType::NotSet;
+    OrderState order_state = OrderState::NotSet;
+    TradeSide trade_side = TradeSide::NotSet;
+    Market market = Market::NotSet;
+    PassiveExecutionAlgo passive_execution_algo = PassiveExecutionAlgo::Default;
+    PassiveExecutionAlgo execution_algo = PassiveExecutionAlgo::None;
+    ExecutionState execution_state = ExecutionState::None;
+    uint8_t flags = 0;  // kOrderJournalSplitChild / kOrderJournalActiveClaimed
+    uint8_t reserved = 0;
+    Volume volume_entrust = 0;
+    Volume volume_traded = 0;
+    Volume volume_remain = 0;
+    Volume target_volume = 0;
+    Volume working_volume = 0;
+    Volume schedulable_volume = 0;
+    DPrice dprice_entrust = 0;
+    DPrice dprice_traded = 0;
+    DValue dvalue_traded = 0;
+    DValue dfee_executed = 0;
+    SecurityId security_id{};
+    InternalSecurityId internal_security_id{};
+};
+
+static_assert(sizeof(order_journal_record) == 144, "order_journal_record layout changed");
+static_assert(std::is_trivially_copyable_v<order_journal_record>, "order_journal_record must be trivially copyable");
+
+// 定位一个账户交易日的全部日志段。
+struct order_journal_location {
+    std::string output_dir;
+    AccountId account_id = 0;
+    std::string trading_day;
+
+    std::string segment_path(uint32_t segment_index) const;
+};
+
+// 从订单簿条目填充日志记录。
+void fill_order_journal_record(order_journal_record& record, const OrderEntry& entry, order_book_event_t event) noexcept;
+
+// 订单簿事件的稳定文本名，与文本业务日志的 event 字段一致。
+const char* order_journal_event_name(order_book_event_t event) noexcept;
+
+// 单写者日志：事件循环线程直接 append 到 mmap 段，写满后滚动到下一段。
+class order_journal_writer {
+public:
+    order_journal_writer() = default;
+    ~order_journal_writer();
+
+    order_journal_writer(const order_journal_writer&) = delete;
+    order_journal_writer& operator=(const order_journal_writer&) = delete;
+
+    // 续写已有的最后一段，或新建 0 号段；segment_records 仅用于新建段。
+    bool open(const order_journal_location& location, uint32_t segment_records);
+
+    void close() noexcept;
+
+    bool is_open() const noexcept { return header_ != nullptr; }
+
+    // 追加一条记录；当前段写满时滚动，新段创建失败返回 false。
+    bool append(const order_journal_record& record) noexcept;
+
+    uint32_t segment_index() const noexcept { return header_ ? header_->segment_index : 0; }
+
+private:
+    bool map_segment(uint32_t segment_index, uint32_t capacity);
+
+    order_journal_location location_{};
+    uint32_t segment_records_ = 0;
+    void* mapping_ = nullptr;
+    std::size_t mapping_size_ = 0;
+    order_journal_segment_header* header_ = nullptr;
+    order_journal_record* records_ = nullptr;
+};
+
+using order_journal_visitor = std::function<void(const order_journal_record&)>;
+
+// 只读 mmap 单个段文件并按顺序回调已提交记录；段头不合法时返回 false。
+bool order_journal_read_segment(const std::string& path, const order_journal_visitor& visitor,
+                                std::size_t* out_records = nullptr);
+
+// 从 0 号段起依次回放直到遇到缺失段；out_segments 为实际读取的段数（无日志时为 0）。
+bool order_journal_replay(const order_journal_location& location, const order_journal_visitor& visitor,
+                          std::size_t* out_segments = nullptr);
+
+}  // namespace acct_service
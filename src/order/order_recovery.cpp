@@ -1,12 +1,18 @@
 #include "order/order_recovery.hpp"
 
+#include <algorithm>
 #include <chrono>
+#include <functional>
 #include <limits>
 #include <string>
+#include <string_view>
 #include <thread>
 #include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
 #include "common/log.hpp"
+#include "order/order_journal.hpp"
 #include "shm/orders_shm.hpp"
 
 namespace acct_service {
@@ -20,6 +26,9 @@ struct recovered_order_candidate {
 
 constexpr uint32_t kRecoverReadMaxAttempts = 5;
 constexpr uint32_t kRecoverReadBackoffUs = 50;
+constexpr std::size_t kRecoverJournalBatch = 256;
+constexpr OrderIndex kRecoverSlotsPerWorker = 16384;  // 每线程至少分到的槽位数，水位低时不值得起线程
+constexpr uint32_t kRecoverMaxWorkers = 8;
 
 // 仅恢复已经进入下游队列的订单阶段，避免把上游未发出的订单误恢复到本地簿。
 bool is_recoverable_stage(OrderSlotState stage) noexcept {
@@ -32,11 +41,167 @@ InternalOrderId saturated_next_order_id(InternalOrderId order_id) noexcept {
     return (order_id < kMaxOrderId) ? static_cast<InternalOrderId>(order_id + 1) : kMaxOrderId;
 }
 
+// 读取 slot 快照时做短重试，规避并发写入窗口导致的瞬时不可读。
+bool read_snapshot_with_retry(const orders_shm_layout* orders_shm, OrderIndex index, order_slot_snapshot& out) {
+    for (uint32_t attempt = 0; attempt < kRecoverReadMaxAttempts; ++attempt) {
+        if (orders_shm_read_snapshot(orders_shm, index, out)) {
+            return true;
+        }
+        if (attempt + 1 < kRecoverReadMaxAttempts && kRecoverReadBackoffUs > 0) {
+            std::this_thread::sleep_for(std::chrono::microseconds(kRecoverReadBackoffUs));
+        }
+    }
+    return false;
+}
+
+// 快照处于下游阶段且未终态才可恢复，shm 扫描与日志回放两条路径共用同一口径。
+bool is_recoverable_snapshot(const order_slot_snapshot& snapshot) noexcept {
+    if (!is_recoverable_stage(snapshot.stage) || snapshot.request.internal_order_id == 0) {
+        return false;
+    }
+    return !is_terminal_order_state(snapshot.request.order_state.load(std::memory_order_acquire));
+}
+
+// 按快照构造恢复条目：父子关系与策略归属无法从槽位得知，一律按独立订单恢复。
+OrderEntry make_recovered_entry(const recovered_order_candidate& candidate) {
+    const TimestampNs recovered_time =
+        (candidate.snapshot.last_update_ns != 0) ? candidate.snapshot.last_update_ns : now_ns();
+
+    OrderEntry entry{};
+    entry.request = candidate.snapshot.request;
+    // 持仓行句柄只在写入它的进程内有效，恢复后由成交结算按证券键重新解析
+    entry.request.security_handle = kInvalidSecurityHandle;
+    entry.submit_time_ns = recovered_time;
+    entry.last_update_ns = recovered_time;
+    entry.strategy_id = static_cast<StrategyId>(0);
+    entry.risk_result = RiskResult::Pass;
+    entry.retry_count = 0;
+    entry.is_split_child = false;
+    entry.parent_order_id = 0;
+    entry.shm_order_index = candidate.index;
+    return entry;
+}
+
+// 新单订单号由 next_index 之后的槽位编码，天然不与已恢复订单冲突；这里只抬升订单簿的后备发号器并输出恢复摘要。
+void finish_recovery(InternalOrderId max_recovered_order_id, const orders_shm_layout* orders_shm, OrderBook& book,
+                     order_recovery_stats& stats, std::string_view source) {
+    stats.next_order_seed = std::max<InternalOrderId>(1, saturated_next_order_id(max_recovered_order_id));
+    book.ensure_next_order_id_at_least(stats.next_order_seed);
+    stats.id_epoch = orders_shm->header.id_epoch.load(std::memory_order_acquire);
+
+    std::string summary = "recovered downstream orders source=" + std::string(source) +
+                          " scan_workers=" + std::to_string(stats.scan_workers) +
+                          " scanned=" + std::to_string(stats.scanned) +
+                          " eligible=" + std::to_string(stats.eligible) +
+                          " restored=" + std::to_string(stats.restored) +
+                          " unreadable=" + std::to_string(stats.unreadable) +
+                          " dedup_dropped=" + std::to_string(stats.dedup_dropped) +
+                          " add_failed=" + std::to_string(stats.add_failed) +
+                          " next_order_seed=" + std::to_string(static_cast<unsigned long long>(stats.next_order_seed)) +
+                          " id_epoch=" + std::to_string(stats.id_epoch) +
+                          " scan_ns=" + std::to_string(static_cast<unsigned long long>(stats.scan_ns)) +
+                          " merge_ns=" + std::to_string(static_cast<unsigned long long>(stats.merge_ns)) +
+                          " restore_ns=" + std::to_string(static_cast<unsigned long long>(stats.restore_ns));
+    ACCT_LOG_INFO("order_recovery", summary);
+
+    if (stats.unreadable > 0) {
+        std::string warning =
+            "unreadable orders_shm slots skipped during recovery count=" + std::to_string(static_cast<unsigned long long>(stats.unreadable));
+        ACCT_LOG_WARN("order_recovery", warning);
+    }
+}
+
+// 第二阶段：按槽位顺序写回 order_book，记录最大恢复订单ID。
+void restore_candidates(const std::unordered_map<InternalOrderId, recovered_order_candidate>& candidates,
+                        const orders_shm_layout* orders_shm, OrderBook& book, order_recovery_stats& stats,
+                        std::string_view source) {
+    const TimestampNs merge_start = now_monotonic_ns();
+    std::vector<const recovered_order_candidate*> ordered;
+    ordered.reserve(candidates.size());
+    for (const auto& item : candidates) {
+        ordered.push_back(&item.second);
+    }
+    std::sort(ordered.begin(), ordered.end(),
+              [](const recovered_order_candidate* lhs, const recovered_order_candidate* rhs) {
+                  return lhs->index < rhs->index;
+              });
+    const TimestampNs restore_start = now_monotonic_ns();
+    stats.merge_ns += restore_start - merge_start;
+
+    InternalOrderId max_recovered_order_id = 0;
+    for (const recovered_order_candidate* candidate : ordered) {
+        const InternalOrderId order_id = candidate->snapshot.request.internal_order_id;
+        if (!book.add_order(make_recovered_entry(*candidate))) {
+            ++stats.add_failed;
+            continue;
+        }
+
+        ++stats.restored;
+        if (order_id > max_recovered_order_id) {
+            max_recovered_order_id = order_id;
+        }
+    }
+    stats.restore_ns = now_monotonic_ns() - restore_start;
+    finish_recovery(max_recovered_order_id, orders_shm, book, stats, source);
+}
+
+// 单个扫描线程的结果：只保留可恢复槽位，计数在合并时累加。
+struct slot_scan_result {
+    std::vector<recovered_order_candidate> eligible;
+    std::size_t scanned = 0;
+    std::size_t unreadable = 0;
+};
+
+// 读取 [begin, end) 槽位并筛出可恢复快照；只读 orders_shm，可在多个线程上并行执行。
+void scan_slot_range(const orders_shm_layout* orders_shm, OrderIndex begin, OrderIndex end, slot_scan_result& out) {
+    for (OrderIndex index = begin; index < end; ++index) {
+        ++out.scanned;
+        order_slot_snapshot snapshot;
+        if (!read_snapshot_with_retry(orders_shm, index, snapshot)) {
+            ++out.unreadable;
+            continue;
+        }
+        if (is_recoverable_snapshot(snapshot)) {
+            out.eligible.push_back(recovered_order_candidate{index, snapshot});
+        }
+    }
+}
+
+// 溢出段 segment 已分配的全局下标区间 [out_begin, out_end)，段不可达时为空区间
+void overflow_slot_range(const orders_shm_layout* orders_shm, uint32_t segment, OrderIndex& out_begin,
+                         OrderIndex& out_end) noexcept {
+    out_begin = make_orders_index(segment, 0);
+    out_end = out_begin;
+    const orders_shm_layout* overflow = orders_shm_overflow(orders_shm, segment);
+    if (overflow) {
+        out_end += std::min(overflow->header.next_index.load(std::memory_order_acquire), overflow->header.capacity);
+    }
+}
+
+// 按 internal_order_id 去重：同一订单出现在多个槽位时保留最近更新的快照，同时间戳取更大槽位。
+void merge_candidate(std::unordered_map<InternalOrderId, recovered_order_candidate>& candidates,
+                     const recovered_order_candidate& candidate, order_recovery_stats& stats) {
+    ++stats.eligible;
+    auto [it, inserted] = candidates.try_emplace(candidate.snapshot.request.internal_order_id, candidate);
+    if (inserted) {
+        return;
+    }
+
+    ++stats.dedup_dropped;
+    const recovered_order_candidate& existing = it->second;
+    const bool should_replace =
+        (candidate.snapshot.last_update_ns > existing.snapshot.last_update_ns) ||
+        ((candidate.snapshot.last_update_ns == existing.snapshot.last_update_ns) && (candidate.index > existing.index));
+    if (should_replace) {
+        it->second = candidate;
+    }
+}
+
 }  // namespace
 
 // 扫描 orders_shm 并重建下游在途订单，保障重启后成交回报可继续命中 order_book。
 bool recover_downstream_active_orders_from_shm(
-    const orders_shm_layout* orders_shm, const upstream_shm_layout* upstream_shm, OrderBook& book) {
+    const orders_shm_layout* orders_shm, OrderBook& book) {
     if (!orders_shm) {
         return false;
     }
@@ -44,118 +209,285 @@ bool recover_downstream_active_orders_from_shm(
     const OrderIndex upper = orders_shm->header.next_index.load(std::memory_order_acquire);
     order_recovery_stats stats{};
 
-    std::unordered_map<InternalOrderId, recovered_order_candidate> candidates;
-    candidates.reserve(static_cast<std::size_t>(upper));
+    // 第一阶段：槽位区间按线程等分并行读取，各线程只写自己的结果，无需同步。
+    const TimestampNs scan_start = now_monotonic_ns();
+    const uint32_t hardware = std::max(1U, std::thread::hardware_concurrency());
+    const uint32_t workers = static_cast<uint32_t>(std::clamp<OrderIndex>(
+        upper / kRecoverSlotsPerWorker, 1, std::min(hardware, kRecoverMaxWorkers)));
+    std::vector<slot_scan_result> results(workers);
+    const OrderIndex stride = (upper + workers - 1) / workers;
+    if (workers == 1) {
+        scan_slot_range(orders_shm, 0, upper, results[0]);
+    } else {
+        std::vector<std::thread> threads;
+        threads.reserve(workers);
+        for (uint32_t worker = 0; worker < workers; ++worker) {
+            const OrderIndex begin = std::min<OrderIndex>(upper, worker * stride);
+            const OrderIndex end = std::min<OrderIndex>(upper, begin + stride);
+            threads.emplace_back(scan_slot_range, orders_shm, begin, end, std::ref(results[worker]));
+        }
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
+    }
+    // 溢出段只在重负载日出现，逐段串行补扫，结果排在主段之后以保持槽位顺序
+    const uint32_t overflow_segments = orders_shm->header.overflow_segments.load(std::memory_order_acquire);
+    for (uint32_t segment = 1; segment <= overflow_segments; ++segment) {
+        OrderIndex begin = 0;
+        OrderIndex end = 0;
+        overflow_slot_range(orders_shm, segment, begin, end);
+        results.emplace_back();
+        scan_slot_range(orders_shm, begin, end, results.back());
+    }
+    stats.scan_workers = workers;
+    stats.scan_ns = now_monotonic_ns() - scan_start;
 
-    // 读取 slot 快照时做短重试，规避并发写入窗口导致的瞬时不可读。
-    auto read_snapshot_with_retry = [&](OrderIndex index, order_slot_snapshot& out) -> bool {
-        for (uint32_t attempt = 0; attempt < kRecoverReadMaxAttempts; ++attempt) {
-            if (orders_shm_read_snapshot(orders_shm, index, out)) {
-                return true;
-            }
-            if (attempt + 1 < kRecoverReadMaxAttempts && kRecoverReadBackoffUs > 0) {
-                std::this_thread::sleep_for(std::chrono::microseconds(kRecoverReadBackoffUs));
-            }
+    // 第二阶段：按线程顺序（即槽位顺序）合并，按 internal_order_id 去重保留最新快照。
+    const TimestampNs merge_start = now_monotonic_ns();
+    std::size_t eligible_total = 0;
+    for (const slot_scan_result& result : results) {
+        eligible_total += result.eligible.size();
+    }
+    std::unordered_map<InternalOrderId, recovered_order_candidate> candidates;
+    candidates.reserve(eligible_total);
+    for (const slot_scan_result& result : results) {
+        stats.scanned += result.scanned;
+        stats.unreadable += result.unreadable;
+        for (const recovered_order_candidate& candidate : result.eligible) {
+            merge_candidate(candidates, candidate, stats);
         }
+    }
+    stats.merge_ns = now_monotonic_ns() - merge_start;
+
+    restore_candidates(candidates, orders_shm, book, stats, "orders_shm");
+    return true;
+}
+
+// 回放日志得到在途订单槽位集合，只读这些槽位即可重建，恢复耗时与在途单数而非订单池水位成正比。
+bool recover_downstream_active_orders_from_journal(const order_journal_location& journal,
+                                                   const orders_shm_layout* orders_shm, OrderBook& book,
+                                                   bool* out_replayed) {
+    if (out_replayed) {
+        *out_replayed = false;
+    }
+    if (!orders_shm) {
         return false;
-    };
+    }
 
-    // 第一阶段：筛选可恢复候选，并按 internal_order_id 去重保留最新快照。
-    for (OrderIndex index = 0; index < upper; ++index) {
-        ++stats.scanned;
+    // 第一阶段：回放日志，按订单保留最后一条记录；终态、已归档或未分配槽位的订单出局
+    const TimestampNs scan_start = now_monotonic_ns();
+    std::unordered_map<InternalOrderId, OrderIndex> live_orders;
+    std::size_t records = 0;
+    const bool replayed = order_journal_replay(journal, [&live_orders, &records](const order_journal_record& record) {
+        ++records;
+        if (record.order_id == 0) {
+            return;
+        }
+        if (record.event == order_book_event_t::Archived || is_terminal_order_state(record.order_state) ||
+            record.shm_order_index == kInvalidOrderIndex) {
+            live_orders.erase(record.order_id);
+            return;
+        }
+        live_orders[record.order_id] = record.shm_order_index;
+    });
+    // 空日志说明本交易日此前未开启日志模式，订单池里可能有日志之外的订单，交由全量扫描
+    if (!replayed || records == 0) {
+        return true;
+    }
 
+    // 第二阶段：按日志给出的槽位读取 orders_shm，以共享内存中的最新镜像为准
+    order_recovery_stats stats{};
+    std::unordered_map<InternalOrderId, recovered_order_candidate> candidates;
+    candidates.reserve(live_orders.size());
+    for (const auto& [order_id, index] : live_orders) {
+        ++stats.scanned;
         order_slot_snapshot snapshot;
-        if (!read_snapshot_with_retry(index, snapshot)) {
+        if (!read_snapshot_with_retry(orders_shm, index, snapshot)) {
             ++stats.unreadable;
             continue;
         }
-        if (!is_recoverable_stage(snapshot.stage)) {
+        if (!is_recoverable_snapshot(snapshot) || snapshot.request.internal_order_id != order_id) {
             continue;
         }
+        ++stats.eligible;
+        candidates.emplace(order_id, recovered_order_candidate{index, snapshot});
+    }
+    stats.scan_ns = now_monotonic_ns() - scan_start;
 
-        const InternalOrderId order_id = snapshot.request.internal_order_id;
-        if (order_id == 0) {
-            continue;
+    restore_candidates(candidates, orders_shm, book, stats, "journal");
+    if (out_replayed) {
+        *out_replayed = true;
+    }
+    return true;
+}
+
+// 以检查点基线为底、变更槽位为增量重建订单簿；父单先入簿并恢复托管标记，子单随后挂回父单。
+bool recover_downstream_active_orders_from_baseline(const order_recovery_baseline& baseline,
+                                                    const orders_shm_layout* orders_shm, OrderBook& book,
+                                                    bool* out_applied) {
+    if (out_applied) {
+        *out_applied = false;
+    }
+    if (!orders_shm) {
+        return false;
+    }
+
+    const uint64_t head = orders_shm->journal.write_cursor.load(std::memory_order_acquire);
+    const OrderIndex upper = orders_shm->header.next_index.load(std::memory_order_acquire);
+    if (head < baseline.journal_cursor || upper < baseline.next_index) {
+        ACCT_LOG_WARN("order_recovery", "restart checkpoint does not match current orders_shm, checkpoint ignored");
+        return true;
+    }
+
+    // 第一阶段：收集游标之后变更过的槽位；游标已被套圈时补扫全部已分配槽位
+    std::vector<OrderIndex> dirty;
+    bool lagged = false;
+    uint64_t cursor = baseline.journal_cursor;
+    OrderIndex indices[kRecoverJournalBatch];
+    uint64_t seqs[kRecoverJournalBatch];
+    while (cursor < head && !lagged) {
+        const std::size_t count =
+            orders_shm_journal_read(orders_shm, cursor, indices, seqs, kRecoverJournalBatch, lagged);
+        if (count == 0 && !lagged) {
+            break;
+        }
+        dirty.insert(dirty.end(), indices, indices + count);
+    }
+    if (lagged) {
+        dirty.resize(upper);
+        for (OrderIndex index = 0; index < upper; ++index) {
+            dirty[index] = index;
         }
+        const uint32_t overflow_segments = orders_shm->header.overflow_segments.load(std::memory_order_acquire);
+        for (uint32_t segment = 1; segment <= overflow_segments; ++segment) {
+            OrderIndex begin = 0;
+            OrderIndex end = 0;
+            overflow_slot_range(orders_shm, segment, begin, end);
+            for (OrderIndex index = begin; index < end; ++index) {
+                dirty.push_back(index);
+            }
+        }
+    } else {
+        std::sort(dirty.begin(), dirty.end());
+        dirty.erase(std::unique(dirty.begin(), dirty.end()), dirty.end());
+    }
 
-        const OrderState status = snapshot.request.order_state.load(std::memory_order_acquire);
-        if (is_terminal_order_state(status)) {
+    // 第二阶段：读取变更槽位的最新镜像
+    order_recovery_stats stats{};
+    std::unordered_map<OrderIndex, order_slot_snapshot> latest;
+    latest.reserve(dirty.size());
+    for (const OrderIndex index : dirty) {
+        if (!orders_shm_index_exists(orders_shm, index)) {
             continue;
         }
-
-        ++stats.eligible;
-        auto [it, inserted] = candidates.try_emplace(order_id, recovered_order_candidate{index, snapshot});
-        if (inserted) {
+        ++stats.scanned;
+        order_slot_snapshot snapshot;
+        if (!read_snapshot_with_retry(orders_shm, index, snapshot)) {
+            ++stats.unreadable;
             continue;
         }
-
-        ++stats.dedup_dropped;
-        const order_slot_snapshot& existing = it->second.snapshot;
-        const bool should_replace = (snapshot.last_update_ns > existing.last_update_ns) ||
-                                    ((snapshot.last_update_ns == existing.last_update_ns) && (index > it->second.index));
-        if (should_replace) {
-            it->second = recovered_order_candidate{index, snapshot};
+        if (snapshot.request.internal_order_id != 0) {
+            latest.emplace(index, snapshot);
         }
     }
 
-    // 第二阶段：写回 order_book，并记录最大恢复订单ID用于校正本地发号器。
+    // 第三阶段：基线条目叠加最新镜像；未变更的条目沿用检查点时的冻结资金，变更过的与全量扫描同口径清零
     InternalOrderId max_recovered_order_id = 0;
-    for (const auto& item : candidates) {
-        const InternalOrderId order_id = item.first;
-        const recovered_order_candidate& candidate = item.second;
-        const TimestampNs recovered_time =
-            (candidate.snapshot.last_update_ns != 0) ? candidate.snapshot.last_update_ns : now_ns();
-
-        OrderEntry entry{};
-        entry.request = candidate.snapshot.request;
-        entry.submit_time_ns = recovered_time;
-        entry.last_update_ns = recovered_time;
-        entry.strategy_id = static_cast<StrategyId>(0);
-        entry.risk_result = RiskResult::Pass;
-        entry.retry_count = 0;
-        entry.is_split_child = false;
-        entry.parent_order_id = 0;
-        entry.shm_order_index = candidate.index;
+    std::unordered_set<InternalOrderId> baseline_ids;
+    baseline_ids.reserve(baseline.orders.size());
+    for (const bool children_pass : {false, true}) {
+        for (const OrderEntry& base : baseline.orders) {
+            if (base.is_split_child != children_pass) {
+                continue;
+            }
+            const InternalOrderId order_id = base.request.internal_order_id;
+            baseline_ids.insert(order_id);
+            ++stats.eligible;
 
-        if (!book.add_order(entry)) {
-            ++stats.add_failed;
-            continue;
+            OrderEntry entry = base;
+            const auto latest_it = latest.find(base.shm_order_index);
+            if (latest_it != latest.end() && latest_it->second.request.internal_order_id == order_id) {
+                entry.request = latest_it->second.request;
+                if (latest_it->second.last_update_ns != 0) {
+                    entry.last_update_ns = latest_it->second.last_update_ns;
+                }
+                entry.fund_frozen = 0;
+            }
+            entry.request.security_handle = kInvalidSecurityHandle;
+            if (!book.add_order(entry)) {
+                ++stats.add_failed;
+                continue;
+            }
+            if (!entry.is_split_child && entry.request.execution_state != ExecutionState::None) {
+                (void)book.mark_managed_parent(order_id);
+            }
+            ++stats.restored;
+            max_recovered_order_id = std::max(max_recovered_order_id, order_id);
         }
+    }
 
-        ++stats.restored;
-        if (order_id > max_recovered_order_id) {
-            max_recovered_order_id = order_id;
+    // 第四阶段：检查点之后新进入下游的订单按 ID 顺序补入；账户内部生成的子单按证券与方向唯一匹配受管父单
+    std::vector<recovered_order_candidate> added;
+    for (const auto& [index, snapshot] : latest) {
+        if (baseline_ids.count(snapshot.request.internal_order_id) == 0 && is_recoverable_snapshot(snapshot)) {
+            ++stats.eligible;
+            added.push_back(recovered_order_candidate{index, snapshot});
         }
     }
+    std::sort(added.begin(), added.end(), [](const recovered_order_candidate& lhs, const recovered_order_candidate& rhs) {
+        return lhs.snapshot.request.internal_order_id < rhs.snapshot.request.internal_order_id;
+    });
 
-    // 合并 upstream 发号器与恢复结果，避免新单ID与已恢复订单冲突。
-    stats.next_order_seed = 1;
-    if (upstream_shm) {
-        stats.next_order_seed = upstream_shm->header.next_order_id.load(std::memory_order_acquire);
-    }
-    const InternalOrderId recovered_next = saturated_next_order_id(max_recovered_order_id);
-    if (recovered_next > stats.next_order_seed) {
-        stats.next_order_seed = recovered_next;
-    }
-    if (stats.next_order_seed > 0) {
-        book.ensure_next_order_id_at_least(stats.next_order_seed);
-    }
+    std::size_t unattributed = 0;
+    for (const recovered_order_candidate& candidate : added) {
+        const order_slot_snapshot& snapshot = candidate.snapshot;
+        const OrderRequest& request = snapshot.request;
+        OrderEntry entry = make_recovered_entry(candidate);
 
-    std::string summary = "recovered downstream orders scanned=" + std::to_string(stats.scanned) +
-                          " eligible=" + std::to_string(stats.eligible) +
-                          " restored=" + std::to_string(stats.restored) +
-                          " unreadable=" + std::to_string(stats.unreadable) +
-                          " dedup_dropped=" + std::to_string(stats.dedup_dropped) +
-                          " add_failed=" + std::to_string(stats.add_failed) +
-                          " next_order_seed=" + std::to_string(static_cast<unsigned long long>(stats.next_order_seed));
-    ACCT_LOG_INFO("order_recovery", summary);
+        if (snapshot.source == order_slot_source_t::AccountInternal) {
+            InternalOrderId parent_id = 0;
+            if (request.order_type == OrderType::Cancel) {
+                (void)book.try_get_parent(request.orig_internal_order_id, parent_id);
+            } else {
+                std::size_t matches = 0;
+                for (const OrderEntry& base : baseline.orders) {
+                    if (!base.is_split_child && base.request.execution_state == ExecutionState::Running &&
+                        base.request.trade_side == request.trade_side &&
+                        base.request.internal_security_id == request.internal_security_id) {
+                        parent_id = base.request.internal_order_id;
+                        ++matches;
+                    }
+                }
+                if (matches != 1) {
+                    parent_id = 0;
+                }
+            }
+            const OrderEntry* parent = (parent_id != 0) ? book.find_order(parent_id) : nullptr;
+            if (parent) {
+                entry.is_split_child = true;
+                entry.parent_order_id = parent_id;
+                entry.strategy_id = parent->strategy_id;
+            } else {
+                ++unattributed;
+            }
+        }
 
-    if (stats.unreadable > 0) {
-        std::string warning =
-            "unreadable orders_shm slots skipped during recovery count=" + std::to_string(static_cast<unsigned long long>(stats.unreadable));
-        ACCT_LOG_WARN("order_recovery", warning);
+        if (!book.add_order(entry)) {
+            ++stats.add_failed;
+            continue;
+        }
+        ++stats.restored;
+        max_recovered_order_id = std::max(max_recovered_order_id, request.internal_order_id);
     }
 
+    finish_recovery(max_recovered_order_id, orders_shm, book, stats, lagged ? "checkpoint_rescan" : "checkpoint");
+    if (unattributed > 0) {
+        ACCT_LOG_WARN("order_recovery", "account internal orders after checkpoint left without parent count=" +
+                                            std::to_string(static_cast<unsigned long long>(unattributed)));
+    }
+    if (out_applied) {
+        *out_applied = true;
+    }
     return true;
 }
 
@@ -1,8 +1,11 @@
 #pragma once
 
 #include <cstddef>
+#include <cstdint>
+#include <vector>
 
 #include "order/order_book.hpp"
+#include "order/order_journal.hpp"
 #include "shm/shm_layout.hpp"
 
 namespace acct_service {
@@ -15,11 +18,37 @@ struct order_recovery_stats {
     std::size_t unreadable = 0;
     std::size_t dedup_dropped = 0;
     std::size_t add_failed = 0;
-    InternalOrderId next_order_seed = 1;
+    InternalOrderId next_order_seed = 1;  // 订单簿后备发号器（无订单池时使用）的起点
+    uint32_t id_epoch = 0;                // 订单池订单号纪元
+    uint32_t scan_workers = 1;  // 槽位读取阶段的并行线程数
+    uint64_t scan_ns = 0;       // 槽位读取与筛选耗时（日志回放路径含回放）
+    uint64_t merge_ns = 0;      // 按订单去重与按槽位排序耗时
+    uint64_t restore_ns = 0;    // 写回订单簿与发号器校正耗时
+};
+
+// 检查点恢复基线：检查点时刻订单簿的全部条目，以及取快照前 orders_shm 变更日志的写游标与槽位水位。
+struct order_recovery_baseline {
+    std::vector<OrderEntry> orders;
+    uint64_t journal_cursor = 0;
+    OrderIndex next_index = 0;
 };
 
 // 从 orders_shm 恢复“已进入下游且未终态”的订单到 OrderBook。
+// 槽位区间按线程切分并行读取，各线程结果按槽位顺序合并后再单线程写回订单簿。
 bool recover_downstream_active_orders_from_shm(
-    const orders_shm_layout* orders_shm, const upstream_shm_layout* upstream_shm, OrderBook& book);
+    const orders_shm_layout* orders_shm, OrderBook& book);
+
+// 从二进制订单日志恢复同一批订单：只读取日志指向的 orders_shm 槽位，不再全量扫描。
+// 当日日志为空或日志段损坏时 out_replayed=false 且不恢复任何订单，调用方应回退到 orders_shm 扫描。
+bool recover_downstream_active_orders_from_journal(const order_journal_location& journal,
+                                                   const orders_shm_layout* orders_shm, OrderBook& book,
+                                                   bool* out_replayed);
+
+// 以检查点基线重建订单簿（保留父子关系、策略归属与受管父单标记），再只回放游标之后变更过的槽位。
+// 游标被变更日志套圈时改为补扫 [0, next_index) 与各溢出段已分配槽位；orders_shm 已重建（游标或水位回退）时 out_applied=false
+// 且不恢复任何订单，调用方应回退到日志或全量扫描。
+bool recover_downstream_active_orders_from_baseline(const order_recovery_baseline& baseline,
+                                                    const orders_shm_layout* orders_shm, OrderBook& book,
+                                                    bool* out_applied);
 
 }  // namespace acct_service
@@ -4,6 +4,7 @@
 #include <cstddef>
 #include <cstring>
 #include <string_view>
+#include <type_traits>
 
 #include "common/types.hpp"
 
@@ -13,9 +14,20 @@ enum class OrderType : uint8_t {
     NotSet = 0,
     New = 1,
     Cancel = 2,
+    MassCancel = 3,  // 批量撤单：账户服务按范围展开为逐笔撤单，不下发柜台
+    Replace = 4,     // 改单：就地修改原单委托数量/价格，仅柜台通告支持时下发
     Unknown = 0xFF,
 };
 
+// 批量撤单范围
+enum class MassCancelScope : uint8_t {
+    NotSet = 0,
+    Account = 1,   // 账户内全部在途订单
+    Strategy = 2,  // 指定策略（上游 lane）的在途订单
+    Security = 3,  // 指定证券的在途订单
+    Parent = 4,    // 指定父单及其子单
+};
+
 enum class TradeSide : uint8_t {
     NotSet = 0,
     Buy = 1,
@@ -57,6 +69,27 @@ enum class ExecutionState : uint8_t {
     Failed = 4,
 };
 
+// 订单状态字段：按普通字节存放使 OrderRequest 可平凡拷贝（整体按缓存行搬运），并发读写经 std::atomic_ref；
+// 整体拷贝不是原子的，跨线程共享的订单仍须在 seqlock 或订单簿锁内拷贝
+struct order_state_field {
+    OrderState value{OrderState::NotSet};
+
+    OrderState load(std::memory_order order = std::memory_order_seq_cst) const noexcept {
+        return std::atomic_ref<OrderState>(const_cast<OrderState&>(value)).load(order);
+    }
+
+    void store(OrderState state, std::memory_order order = std::memory_order_seq_cst) noexcept {
+        std::atomic_ref<OrderState>(value).store(state, order);
+    }
+};
+
+static_assert(std::atomic_ref<OrderState>::is_always_lock_free, "order_state must be lock-free");
+static_assert(alignof(OrderState) >= std::atomic_ref<OrderState>::required_alignment,
+              "order_state alignment must satisfy atomic_ref");
+
+// 篮子选项：任一腿入簿/风控失败或合并资金预留失败时整篮拒绝
+inline constexpr uint8_t kBasketAllOrNothing = 0x01;
+
 struct alignas(64) OrderRequest {
     // cache line 0
     InternalOrderId internal_order_id{0};                                        // 系统内部订单ID，唯一标识
@@ -71,7 +104,7 @@ struct alignas(64) OrderRequest {
     SecurityId security_id{};                   // 证券代码字符串（如 "000001"）
     uint8_t active_strategy_claimed{0};         // 1=当前订单由主动覆盖层管理/生成
     uint8_t reserved_exec_flags{0};
-    uint8_t padding0_1[2]{};
+    SecurityHandle security_handle{kInvalidSecurityHandle};  // 入簿时解析的持仓行句柄（进程内有效）
 
     // cache line 1
     union {
@@ -94,92 +127,23 @@ struct alignas(64) OrderRequest {
     MdTime md_time_market_response{0};                        // 交易所响应时间
     MdTime md_time_traded_first{0};                           // 首次成交时间
     MdTime md_time_traded_latest{0};                          // 最近成交时间
-    std::atomic<OrderState> order_state{OrderState::NotSet};  // 订单当前状态
+    order_state_field order_state{};                          // 订单当前状态
     uint8_t padding2[15]{};                                   // 填充以对齐缓存行
 
     // cache line 3
     PassiveExecutionAlgo execution_algo{PassiveExecutionAlgo::None};  // 受管父单执行算法镜像
     ExecutionState execution_state{ExecutionState::None};             // 受管父单执行态镜像
-    uint8_t padding3_0[6]{};
+    MassCancelScope mass_cancel_scope{MassCancelScope::NotSet};       // 批量撤单范围（仅 MassCancel 使用）
+    uint8_t padding3_0{0};
+    StrategyId mass_cancel_strategy_id{0};  // 批量撤单目标策略（Strategy 范围使用）
+    uint8_t padding3_1[2]{};
     Volume target_volume{0};       // 受管父单目标量
     Volume working_volume{0};      // 受管父单当前在途量
     Volume schedulable_volume{0};  // 受管父单当前可继续释放的预算
-    uint8_t padding3_1[32]{};
-
-    OrderRequest() = default;
-    OrderRequest(const OrderRequest& other) {
-        internal_order_id = other.internal_order_id;
-        passive_execution_algo = other.passive_execution_algo;
-        order_type = other.order_type;
-        trade_side = other.trade_side;
-        market = other.market;
-        volume_entrust = other.volume_entrust;
-        dprice_entrust = other.dprice_entrust;
-        md_time_driven = other.md_time_driven;
-        md_time_entrust = other.md_time_entrust;
-        orig_internal_order_id = other.orig_internal_order_id;
-        md_time_cancel_sent = other.md_time_cancel_sent;
-        md_time_cancel_done = other.md_time_cancel_done;
-        internal_security_id = other.internal_security_id;
-        security_id = other.security_id;
-        active_strategy_claimed = other.active_strategy_claimed;
-        reserved_exec_flags = other.reserved_exec_flags;
-        broker_order_id.as_uint = other.broker_order_id.as_uint;
-        volume_traded = other.volume_traded;
-        volume_remain = other.volume_remain;
-        dvalue_traded = other.dvalue_traded;
-        dprice_traded = other.dprice_traded;
-        dfee_estimate = other.dfee_estimate;
-        dfee_executed = other.dfee_executed;
-        md_time_broker_response = other.md_time_broker_response;
-        md_time_market_response = other.md_time_market_response;
-        md_time_traded_first = other.md_time_traded_first;
-        md_time_traded_latest = other.md_time_traded_latest;
-        execution_algo = other.execution_algo;
-        execution_state = other.execution_state;
-        target_volume = other.target_volume;
-        working_volume = other.working_volume;
-        schedulable_volume = other.schedulable_volume;
-        order_state.store(other.order_state.load(std::memory_order_relaxed), std::memory_order_relaxed);
-    }
-    OrderRequest& operator=(const OrderRequest& other) {
-        if (this != &other) {
-            internal_order_id = other.internal_order_id;
-            passive_execution_algo = other.passive_execution_algo;
-            order_type = other.order_type;
-            trade_side = other.trade_side;
-            market = other.market;
-            volume_entrust = other.volume_entrust;
-            dprice_entrust = other.dprice_entrust;
-            md_time_driven = other.md_time_driven;
-            md_time_entrust = other.md_time_entrust;
-            orig_internal_order_id = other.orig_internal_order_id;
-            md_time_cancel_sent = other.md_time_cancel_sent;
-            md_time_cancel_done = other.md_time_cancel_done;
-            internal_security_id = other.internal_security_id;
-            security_id = other.security_id;
-            active_strategy_claimed = other.active_strategy_claimed;
-            reserved_exec_flags = other.reserved_exec_flags;
-            broker_order_id.as_uint = other.broker_order_id.as_uint;
-            volume_traded = other.volume_traded;
-            volume_remain = other.volume_remain;
-            dvalue_traded = other.dvalue_traded;
-            dprice_traded = other.dprice_traded;
-            dfee_estimate = other.dfee_estimate;
-            dfee_executed = other.dfee_executed;
-            md_time_broker_response = other.md_time_broker_response;
-            md_time_market_response = other.md_time_market_response;
-            md_time_traded_first = other.md_time_traded_first;
-            md_time_traded_latest = other.md_time_traded_latest;
-            execution_algo = other.execution_algo;
-            execution_state = other.execution_state;
-            target_volume = other.target_volume;
-            working_volume = other.working_volume;
-            schedulable_volume = other.schedulable_volume;
-            order_state.store(other.order_state.load(std::memory_order_relaxed), std::memory_order_relaxed);
-        }
-        return *this;
-    }
+    InternalOrderId basket_id{0};  // 所属篮子首腿订单ID（0 表示非篮子订单，仅新单使用）
+    uint16_t basket_legs{0};       // 篮子条目数：各腿槽位与订单ID连续，且整段一次入队
+    uint8_t basket_flags{0};       // kBasketAllOrNothing 等篮子选项
+    uint8_t padding3_2[25]{};
 
     void init_new(std::string_view sec_id, InternalSecurityId internal_sec_id, InternalOrderId internal_id,
                   TradeSide side, Market mkt, Volume vol, DPrice dpx, MdTime md_time_driven_) {
@@ -209,6 +173,11 @@ struct alignas(64) OrderRequest {
         target_volume = 0;
         working_volume = 0;
         schedulable_volume = 0;
+        mass_cancel_scope = MassCancelScope::NotSet;
+        mass_cancel_strategy_id = 0;
+        basket_id = 0;
+        basket_legs = 0;
+        basket_flags = 0;
     }
 
     void init_cancel(InternalOrderId internal_id, MdTime md_time_driven_, InternalOrderId orig_internal_id) {
@@ -245,10 +214,39 @@ struct alignas(64) OrderRequest {
         target_volume = 0;
         working_volume = 0;
         schedulable_volume = 0;
+        mass_cancel_scope = MassCancelScope::NotSet;
+        mass_cancel_strategy_id = 0;
+        basket_id = 0;
+        basket_legs = 0;
+        basket_flags = 0;
+    }
+
+    // 改单请求：volume/dprice 为改单后的总委托数量与价格，证券与方向沿用原单，其余字段与撤单一致
+    void init_replace(InternalOrderId internal_id, MdTime md_time_driven_, InternalOrderId orig_internal_id,
+                      const OrderRequest& orig, Volume volume, DPrice dprice) {
+        init_cancel(internal_id, md_time_driven_, orig_internal_id);
+        order_type = OrderType::Replace;
+        trade_side = orig.trade_side;
+        market = orig.market;
+        security_id = orig.security_id;
+        internal_security_id = orig.internal_security_id;
+        volume_entrust = volume;
+        dprice_entrust = dprice;
+    }
+
+    // 批量撤单请求：security/parent 仅按 scope 取用，其余字段与撤单一致
+    void init_mass_cancel(InternalOrderId internal_id, MdTime md_time_driven_, MassCancelScope scope,
+                          StrategyId strategy_id, InternalSecurityId internal_sec_id, InternalOrderId parent_id) {
+        init_cancel(internal_id, md_time_driven_, parent_id);
+        order_type = OrderType::MassCancel;
+        internal_security_id = internal_sec_id;
+        mass_cancel_scope = scope;
+        mass_cancel_strategy_id = strategy_id;
     }
 };
 
 static_assert(sizeof(OrderRequest) == 256, "order_request must be 256 bytes (4 cache lines)");
+static_assert(std::is_trivially_copyable_v<OrderRequest>, "order_request must be trivially copyable");
 static_assert(alignof(OrderRequest) == 64, "order_request must be 64-byte aligned");
 static_assert(offsetof(OrderRequest, broker_order_id) == 64, "broker_order_id must start at cache line 1");
 static_assert(offsetof(OrderRequest, dfee_estimate) == 128, "dfee_estimate must start at cache line 2");
@@ -7,37 +7,55 @@
 
 namespace acct_service {
 
+namespace {
+
+// 原单已被柜台受理且未终态时，柜台一定先收到了原单，撤单可越过下游订单队列；
+// 原单仍在下游链路中时撤单必须排在其后，否则柜台会因找不到原单拒撤
+bool cancel_can_jump_queue(const OrderEntry* orig) noexcept {
+    if (!orig) {
+        return false;
+    }
+    const OrderState state = orig->request.order_state.load(std::memory_order_acquire);
+    return state == OrderState::BrokerAccepted || state == OrderState::MarketAccepted;
+}
+
+}  // namespace
+
 order_router::order_router(OrderBook& book, downstream_shm_layout* downstream_shm, orders_shm_layout* orders_shm,
                            upstream_shm_layout* upstream_shm)
-    : order_book_(book), downstream_shm_(downstream_shm), orders_shm_(orders_shm), upstream_shm_(upstream_shm) {}
+    : order_book_(book), downstream_shm_(downstream_shm), orders_shm_(orders_shm) {
+    // 账户服务先于策略接入，由路由器为当日订单池绑定订单号纪元
+    (void)orders_shm_bind_id_epoch(orders_shm_, upstream_shm);
+}
 
 bool order_router::route_order(OrderEntry& entry) {
+    if (entry.request.order_type == OrderType::MassCancel) {
+        std::vector<InternalOrderId> targets;
+        (void)route_mass_cancel(entry.request, targets);
+        return true;
+    }
     if (entry.request.order_type == OrderType::Cancel) {
         return route_cancel(entry.request.orig_internal_order_id, entry.request.internal_order_id,
                             entry.request.md_time_driven);
     }
 
     ++stats_.orders_received;
-    stats_.last_order_time = now_ns();
+    stats_.last_order_time = clock_now_ns(clock_);
 
     if (entry.shm_order_index == kInvalidOrderIndex) {
         ++stats_.orders_rejected;
         order_book_.update_state(entry.request.internal_order_id, OrderState::TraderError);
-        ErrorStatus status = ACCT_MAKE_ERROR(ErrorDomain::order, ErrorCode::OrderInvariantBroken, "order_router",
-                                             "missing order shm index", 0);
-        record_error(status);
-        ACCT_LOG_ERROR_STATUS(status);
+        ACCT_REPORT_ERROR(ErrorDomain::order, ErrorCode::OrderInvariantBroken, "order_router",
+                          "missing order shm index", 0);
         return false;
     }
 
-    if (!send_to_downstream(entry.shm_order_index)) {
+    if (!send_to_downstream(entry.request, entry.shm_order_index)) {
         ++stats_.orders_rejected;
         ++stats_.queue_full_count;
         order_book_.update_state(entry.request.internal_order_id, OrderState::TraderError);
-        ErrorStatus status = ACCT_MAKE_ERROR(ErrorDomain::order, ErrorCode::QueuePushFailed, "order_router",
-                                             "failed to push order to downstream", 0);
-        record_error(status);
-        ACCT_LOG_ERROR_STATUS(status);
+        ACCT_REPORT_ERROR(ErrorDomain::order, ErrorCode::QueuePushFailed, "order_router",
+                          "failed to push order to downstream", 0);
         return false;
     }
 
@@ -58,106 +76,35 @@ std::size_t order_router::route_orders(std::vector<OrderEntry*>& entries) {
 
 bool order_router::route_cancel(InternalOrderId orig_id, InternalOrderId cancel_id, MdTime time) {
     ++stats_.orders_received;
-    stats_.last_order_time = now_ns();
-
-    const std::vector<InternalOrderId> children = order_book_.get_children(orig_id);
-    if (!children.empty()) {
-        bool any_sent = false;
-        bool any_failed = false;
-        bool used_cancel_id = false;
-
-        for (InternalOrderId child_id : children) {
-            const OrderEntry* child = order_book_.find_order(child_id);
-            if (!child || child->request.order_type != OrderType::New || child->is_terminal()) {
-                continue;
-            }
-
-            InternalOrderId child_cancel_id = cancel_id;
-            if (used_cancel_id) {
-                child_cancel_id = allocate_internal_order_id();
-            }
-            used_cancel_id = true;
-
-            OrderRequest cancel_request;
-            cancel_request.init_cancel(child_cancel_id, time, child_id);
-            cancel_request.order_state.store(OrderState::TraderPending, std::memory_order_relaxed);
-
-            OrderIndex cancel_index = kInvalidOrderIndex;
-            if (!create_internal_order_slot(cancel_request, OrderSlotState::UpstreamDequeued, cancel_index,
-                                            order_slot_source_t::AccountInternal)) {
-                any_failed = true;
-                ++stats_.orders_rejected;
-                ErrorStatus status = ACCT_MAKE_ERROR(ErrorDomain::order, ErrorCode::OrderPoolFull, "order_router",
-                                                     "failed to allocate child cancel order slot", 0);
-                record_error(status);
-                ACCT_LOG_ERROR_STATUS(status);
-                continue;
-            }
+    stats_.last_order_time = clock_now_ns(clock_);
 
-            OrderEntry cancel_entry{};
-            cancel_entry.request = cancel_request;
-            cancel_entry.submit_time_ns = now_ns();
-            cancel_entry.last_update_ns = cancel_entry.submit_time_ns;
-            cancel_entry.strategy_id = child->strategy_id;
-            cancel_entry.risk_result = RiskResult::Pass;
-            cancel_entry.retry_count = 0;
-            cancel_entry.is_split_child = true;
-            cancel_entry.parent_order_id = orig_id;
-            cancel_entry.shm_order_index = cancel_index;
-
-            if (!order_book_.add_order(cancel_entry)) {
-                (void)orders_shm_update_stage(orders_shm_, cancel_index, OrderSlotState::QueuePushFailed, now_ns());
-                any_failed = true;
-                ++stats_.orders_rejected;
-                ErrorStatus status = ACCT_MAKE_ERROR(ErrorDomain::order, ErrorCode::OrderBookFull, "order_router",
-                                                     "failed to add child cancel order", 0);
-                record_error(status);
-                ACCT_LOG_ERROR_STATUS(status);
-                continue;
-            }
-
-            if (!send_to_downstream(cancel_index)) {
-                any_failed = true;
-                ++stats_.orders_rejected;
-                ++stats_.queue_full_count;
-                order_book_.update_state(child_cancel_id, OrderState::TraderError);
-                ErrorStatus status = ACCT_MAKE_ERROR(ErrorDomain::order, ErrorCode::QueuePushFailed, "order_router",
-                                                     "failed to send child cancel to downstream", 0);
-                record_error(status);
-                ACCT_LOG_ERROR_STATUS(status);
-                continue;
-            }
-
-            ++stats_.orders_sent;
-            any_sent = true;
-            order_book_.update_state(child_cancel_id, OrderState::TraderSubmitted);
-        }
-
-        if (any_failed) {
-            order_book_.update_state(orig_id, OrderState::TraderError);
-        }
-
-        return any_sent;
+    // 用户撤单经事件循环入簿后 cancel_id 已占用，直接复用其槽位下发，不再重复入簿
+    const OrderEntry* user_cancel = order_book_.find_order(cancel_id);
+    if (collect_child_cancel_targets(orig_id)) {
+        return route_child_cancels(orig_id, cancel_id, time, user_cancel != nullptr);
     }
 
+    const bool priority = cancel_can_jump_queue(order_book_.find_order(orig_id));
     OrderRequest cancel_request;
     cancel_request.init_cancel(cancel_id, time, orig_id);
     cancel_request.order_state.store(OrderState::TraderPending, std::memory_order_relaxed);
 
+    if (user_cancel && user_cancel->shm_order_index != kInvalidOrderIndex) {
+        return send_control_order(cancel_request, user_cancel->shm_order_index, priority);
+    }
+
     OrderIndex cancel_index = kInvalidOrderIndex;
     if (!create_internal_order_slot(cancel_request, OrderSlotState::UpstreamDequeued, cancel_index,
                                     order_slot_source_t::AccountInternal)) {
         ++stats_.orders_rejected;
-        ErrorStatus status = ACCT_MAKE_ERROR(ErrorDomain::order, ErrorCode::OrderPoolFull, "order_router",
-                                             "failed to allocate cancel order slot", 0);
-        record_error(status);
-        ACCT_LOG_ERROR_STATUS(status);
+        ACCT_REPORT_ERROR(ErrorDomain::order, ErrorCode::OrderPoolFull, "order_router",
+                          "failed to allocate cancel order slot", 0);
         return false;
     }
 
     OrderEntry cancel_entry{};
     cancel_entry.request = cancel_request;
-    cancel_entry.submit_time_ns = now_ns();
+    cancel_entry.submit_time_ns = clock_now_ns(clock_);
     cancel_entry.last_update_ns = cancel_entry.submit_time_ns;
     cancel_entry.risk_result = RiskResult::Pass;
     cancel_entry.retry_count = 0;
@@ -166,41 +113,269 @@ bool order_router::route_cancel(InternalOrderId orig_id, InternalOrderId cancel_
     cancel_entry.shm_order_index = cancel_index;
 
     if (!order_book_.add_order(cancel_entry)) {
-        (void)orders_shm_update_stage(orders_shm_, cancel_index, OrderSlotState::QueuePushFailed, now_ns());
+        (void)orders_shm_update_stage(orders_shm_, cancel_index, OrderSlotState::QueuePushFailed, clock_now_ns(clock_));
         ++stats_.orders_rejected;
-        ErrorStatus status = ACCT_MAKE_ERROR(ErrorDomain::order, ErrorCode::OrderBookFull, "order_router",
-                                             "failed to add cancel order", 0);
-        record_error(status);
-        ACCT_LOG_ERROR_STATUS(status);
+        ACCT_REPORT_ERROR(ErrorDomain::order, ErrorCode::OrderBookFull, "order_router",
+                          "failed to add cancel order", 0);
         return false;
     }
 
-    if (!send_to_downstream(cancel_index)) {
+    return send_control_order(cancel_request, cancel_index, priority);
+}
+
+bool order_router::route_child_cancels(InternalOrderId parent_id, InternalOrderId cancel_id, MdTime time,
+                                       bool user_cancel) {
+    if (child_cancel_targets_.empty()) {
+        return false;
+    }
+
+    const std::size_t reserved = reserve_child_cancel_slots(child_cancel_targets_.size());
+    const bool outer_batch = downstream_batching_;
+    if (!outer_batch) {
+        begin_downstream_batch();
+    }
+
+    const uint64_t sent_before = stats_.orders_sent;
+    const TimestampNs now = clock_now_ns(clock_);
+    // 用户撤单号只给第一笔子单撤单，其余由槽位编码
+    bool used_cancel_id = user_cancel;
+    bool any_failed = false;
+    for (std::size_t i = 0; i < child_cancel_targets_.size(); ++i) {
+        const child_cancel_target& target = child_cancel_targets_[i];
+        if (i >= reserved) {
+            any_failed = true;
+            ++stats_.orders_rejected;
+            ACCT_REPORT_ERROR(ErrorDomain::order, ErrorCode::OrderPoolFull, "order_router",
+                              "failed to allocate child cancel order slot", 0);
+            continue;
+        }
+
+        OrderRequest cancel_request;
+        cancel_request.init_cancel(used_cancel_id ? 0 : cancel_id, time, target.child_id);
+        cancel_request.order_state.store(OrderState::TraderPending, std::memory_order_relaxed);
+        used_cancel_id = true;
+
+        const OrderIndex cancel_index = child_cancel_slots_[i];
+        if (cancel_request.internal_order_id == 0) {
+            cancel_request.internal_order_id = orders_shm_order_id(orders_shm_, cancel_index);
+        }
+        (void)orders_shm_write_order(orders_shm_, cancel_index, cancel_request, OrderSlotState::UpstreamDequeued,
+                                     order_slot_source_t::AccountInternal, now);
+
+        OrderEntry cancel_entry{};
+        cancel_entry.request = cancel_request;
+        cancel_entry.submit_time_ns = now;
+        cancel_entry.last_update_ns = now;
+        cancel_entry.strategy_id = target.strategy_id;
+        cancel_entry.risk_result = RiskResult::Pass;
+        cancel_entry.retry_count = 0;
+        cancel_entry.is_split_child = true;
+        cancel_entry.parent_order_id = parent_id;
+        cancel_entry.shm_order_index = cancel_index;
+
+        if (!order_book_.add_order(cancel_entry)) {
+            (void)orders_shm_update_stage(orders_shm_, cancel_index, OrderSlotState::QueuePushFailed, now);
+            any_failed = true;
+            ++stats_.orders_rejected;
+            ACCT_REPORT_ERROR(ErrorDomain::order, ErrorCode::OrderBookFull, "order_router",
+                              "failed to add child cancel order", 0);
+            continue;
+        }
+
+        // 批量模式下只登记，入队失败由 flush 回退阶段并把撤单置为 TraderError
+        if (!send_to_downstream(cancel_request, cancel_index, target.priority)) {
+            any_failed = true;
+            ++stats_.orders_rejected;
+            order_book_.update_state(cancel_request.internal_order_id, OrderState::TraderError);
+            continue;
+        }
+        ++stats_.orders_sent;
+        order_book_.update_state(cancel_request.internal_order_id, OrderState::TraderSubmitted);
+    }
+
+    if (!outer_batch) {
+        any_failed = flush_downstream_batch() > 0 || any_failed;
+    }
+    if (any_failed) {
+        order_book_.update_state(parent_id, OrderState::TraderError);
+    }
+    // 外层批次尚未 flush 时按登记笔数计
+    return stats_.orders_sent > sent_before;
+}
+
+bool order_router::collect_child_cancel_targets(InternalOrderId parent_id) {
+    child_cancel_targets_.clear();
+    bool has_children = false;
+    order_book_.for_each_child(parent_id, [this, &has_children](InternalOrderId child_id, const OrderEntry* child) {
+        has_children = true;
+        if (child && child->request.order_type == OrderType::New && !child->is_terminal()) {
+            child_cancel_targets_.push_back(
+                child_cancel_target{child_id, child->strategy_id, cancel_can_jump_queue(child)});
+        }
+    });
+    return has_children;
+}
+
+std::size_t order_router::reserve_child_cancel_slots(std::size_t count) {
+    child_cancel_slots_.clear();
+    while (child_cancel_slots_.size() < count) {
+        OrderIndex begin = kInvalidOrderIndex;
+        const std::size_t granted = orders_shm_try_allocate_range(orders_shm_, count - child_cancel_slots_.size(),
+                                                                  begin);
+        if (granted == 0) {
+            break;
+        }
+        for (std::size_t i = 0; i < granted; ++i) {
+            child_cancel_slots_.push_back(begin + static_cast<OrderIndex>(i));
+        }
+    }
+    return child_cancel_slots_.size();
+}
+
+bool order_router::send_control_order(const OrderRequest& request, OrderIndex index, bool priority) {
+    const InternalOrderId order_id = request.internal_order_id;
+    if (!send_to_downstream(request, index, priority)) {
         ++stats_.orders_rejected;
         ++stats_.queue_full_count;
-        order_book_.update_state(cancel_id, OrderState::TraderError);
+        order_book_.update_state(order_id, OrderState::TraderError);
         ErrorStatus status = ACCT_MAKE_ERROR(ErrorDomain::order, ErrorCode::QueuePushFailed, "order_router",
-                                             "failed to send cancel request", 0);
+                                             request.order_type == OrderType::Replace ? "failed to send replace request"
+                                                                                      : "failed to send cancel request",
+                                             0);
         record_error(status);
         ACCT_LOG_ERROR_STATUS(status);
         return false;
     }
 
     ++stats_.orders_sent;
-    order_book_.update_state(cancel_id, OrderState::TraderSubmitted);
+    order_book_.update_state(order_id, OrderState::TraderSubmitted);
     return true;
 }
 
+bool order_router::route_replace(InternalOrderId orig_id, InternalOrderId replace_id, Volume volume, DPrice dprice,
+                                 MdTime time) {
+    ++stats_.orders_received;
+    stats_.last_order_time = clock_now_ns(clock_);
+
+    const OrderEntry* orig = order_book_.find_order(orig_id);
+    if (!replace_supported() || !orig || orig->request.order_type != OrderType::New || orig->is_terminal() ||
+        volume <= orig->request.volume_traded || dprice == 0) {
+        ++stats_.orders_rejected;
+        ACCT_REPORT_ERROR(ErrorDomain::order, ErrorCode::InvalidParam, "order_router",
+                          "replace unsupported by broker or original order not amendable", 0);
+        return false;
+    }
+
+    // 与撤单同口径：原单已被柜台受理时改单可越过积压新单
+    const bool priority = cancel_can_jump_queue(orig);
+    OrderRequest replace_request;
+    replace_request.init_replace(replace_id, time, orig_id, orig->request, volume, dprice);
+    replace_request.order_state.store(OrderState::TraderPending, std::memory_order_relaxed);
+
+    OrderIndex replace_index = kInvalidOrderIndex;
+    if (!create_internal_order_slot(replace_request, OrderSlotState::UpstreamDequeued, replace_index,
+                                    order_slot_source_t::AccountInternal)) {
+        ++stats_.orders_rejected;
+        ACCT_REPORT_ERROR(ErrorDomain::order, ErrorCode::OrderPoolFull, "order_router",
+                          "failed to allocate replace order slot", 0);
+        return false;
+    }
+
+    OrderEntry replace_entry{};
+    replace_entry.request = replace_request;
+    replace_entry.submit_time_ns = clock_now_ns(clock_);
+    replace_entry.last_update_ns = replace_entry.submit_time_ns;
+    replace_entry.strategy_id = orig->strategy_id;
+    replace_entry.risk_result = RiskResult::Pass;
+    replace_entry.retry_count = 0;
+    replace_entry.is_split_child = false;
+    replace_entry.parent_order_id = 0;
+    replace_entry.shm_order_index = replace_index;
+
+    if (!order_book_.add_order(replace_entry)) {
+        (void)orders_shm_update_stage(orders_shm_, replace_index, OrderSlotState::QueuePushFailed,
+                                      clock_now_ns(clock_));
+        ++stats_.orders_rejected;
+        ACCT_REPORT_ERROR(ErrorDomain::order, ErrorCode::OrderBookFull, "order_router",
+                          "failed to add replace order", 0);
+        return false;
+    }
+
+    return send_control_order(replace_request, replace_index, priority);
+}
+
+bool order_router::replace_supported() const noexcept {
+    return downstream_shm_ &&
+           (downstream_shm_->broker_capabilities.load(std::memory_order_acquire) & kBrokerCapReplace) != 0;
+}
+
+std::size_t order_router::route_mass_cancel(const OrderRequest& request, std::vector<InternalOrderId>& out_targets) {
+    out_targets.clear();
+    collect_mass_cancel_targets(request, out_targets);
+    if (out_targets.empty()) {
+        return 0;
+    }
+
+    const uint64_t sent_before = stats_.orders_sent;
+    begin_downstream_batch();
+    for (InternalOrderId target : out_targets) {
+        (void)route_cancel(target, 0, request.md_time_driven);
+    }
+    // flush 会把入队失败的撤单从 orders_sent 中扣回
+    (void)flush_downstream_batch();
+    return static_cast<std::size_t>(stats_.orders_sent - sent_before);
+}
+
+// 只收集顶层在途新单：拆单子单随父单经 route_cancel 展开，避免对同一子单重复撤单。
+void order_router::collect_mass_cancel_targets(const OrderRequest& request,
+                                               std::vector<InternalOrderId>& out_targets) const {
+    auto matches = [&](const OrderEntry& entry) {
+        if (entry.request.order_type != OrderType::New || entry.is_terminal() || entry.is_split_child) {
+            return false;
+        }
+        return request.mass_cancel_scope != MassCancelScope::Strategy ||
+               entry.strategy_id == request.mass_cancel_strategy_id;
+    };
+
+    switch (request.mass_cancel_scope) {
+        case MassCancelScope::Account:
+        case MassCancelScope::Strategy:
+            order_book_.for_each_active([&](const OrderEntry& entry) {
+                if (matches(entry)) {
+                    out_targets.push_back(entry.request.internal_order_id);
+                }
+            });
+            break;
+        case MassCancelScope::Security:
+            order_book_.for_each_security_order(request.internal_security_id, [&](const OrderEntry& entry) {
+                if (matches(entry)) {
+                    out_targets.push_back(entry.request.internal_order_id);
+                }
+            });
+            break;
+        case MassCancelScope::Parent: {
+            const OrderEntry* parent = order_book_.find_order(request.orig_internal_order_id);
+            if (parent && matches(*parent)) {
+                out_targets.push_back(parent->request.internal_order_id);
+            }
+            break;
+        }
+        case MassCancelScope::NotSet:
+            break;
+    }
+}
+
 // 把执行引擎生成的子单接入既有订单簿/订单池/下游队列，避免维护第二套发单链。
 bool order_router::submit_internal_order(OrderEntry& entry) {
     ++stats_.orders_received;
-    stats_.last_order_time = now_ns();
+    stats_.last_order_time = clock_now_ns(clock_);
 
-    if (entry.request.internal_order_id == 0) {
-        entry.request.internal_order_id = allocate_internal_order_id();
+    // 未分配槽位的子单在 create_internal_order_slot 中按槽位编码订单号
+    if (entry.request.internal_order_id == 0 && entry.shm_order_index != kInvalidOrderIndex) {
+        entry.request.internal_order_id = allocate_internal_order_id(entry.shm_order_index);
     }
     if (entry.submit_time_ns == 0) {
-        entry.submit_time_ns = now_ns();
+        entry.submit_time_ns = clock_now_ns(clock_);
     }
     if (entry.last_update_ns == 0) {
         entry.last_update_ns = entry.submit_time_ns;
@@ -211,31 +386,26 @@ bool order_router::submit_internal_order(OrderEntry& entry) {
         !create_internal_order_slot(entry.request, OrderSlotState::UpstreamDequeued, entry.shm_order_index,
                                     order_slot_source_t::AccountInternal)) {
         ++stats_.orders_rejected;
-        ErrorStatus status = ACCT_MAKE_ERROR(ErrorDomain::order, ErrorCode::OrderPoolFull, "order_router",
-                                             "failed to allocate internal child slot", 0);
-        record_error(status);
-        ACCT_LOG_ERROR_STATUS(status);
+        ACCT_REPORT_ERROR(ErrorDomain::order, ErrorCode::OrderPoolFull, "order_router",
+                          "failed to allocate internal child slot", 0);
         return false;
     }
 
     if (!order_book_.add_order(entry)) {
-        (void)orders_shm_update_stage(orders_shm_, entry.shm_order_index, OrderSlotState::QueuePushFailed, now_ns());
+        (void)orders_shm_update_stage(orders_shm_, entry.shm_order_index, OrderSlotState::QueuePushFailed,
+                                      clock_now_ns(clock_));
         ++stats_.orders_rejected;
-        ErrorStatus status = ACCT_MAKE_ERROR(ErrorDomain::order, ErrorCode::OrderBookFull, "order_router",
-                                             "failed to add internal child", 0);
-        record_error(status);
-        ACCT_LOG_ERROR_STATUS(status);
+        ACCT_REPORT_ERROR(ErrorDomain::order, ErrorCode::OrderBookFull, "order_router",
+                          "failed to add internal child", 0);
         return false;
     }
 
-    if (!send_to_downstream(entry.shm_order_index)) {
+    if (!send_to_downstream(entry.request, entry.shm_order_index)) {
         ++stats_.orders_rejected;
         ++stats_.queue_full_count;
         order_book_.update_state(entry.request.internal_order_id, OrderState::TraderError);
-        ErrorStatus status = ACCT_MAKE_ERROR(ErrorDomain::order, ErrorCode::QueuePushFailed, "order_router",
-                                             "failed to send internal child", 0);
-        record_error(status);
-        ACCT_LOG_ERROR_STATUS(status);
+        ACCT_REPORT_ERROR(ErrorDomain::order, ErrorCode::QueuePushFailed, "order_router",
+                          "failed to send internal child", 0);
         return false;
     }
 
@@ -244,49 +414,173 @@ bool order_router::submit_internal_order(OrderEntry& entry) {
     return true;
 }
 
-bool order_router::recover_downstream_active_orders(const upstream_shm_layout* upstream_shm) {
+bool order_router::recover_downstream_active_orders(const order_journal_location* journal,
+                                                    const order_recovery_baseline* baseline,
+                                                    bool* out_baseline_applied) {
+    if (out_baseline_applied) {
+        *out_baseline_applied = false;
+    }
     if (!orders_shm_) {
         return false;
     }
-    return recover_downstream_active_orders_from_shm(orders_shm_, upstream_shm, order_book_);
+    if (baseline) {
+        bool applied = false;
+        if (!recover_downstream_active_orders_from_baseline(*baseline, orders_shm_, order_book_, &applied)) {
+            return false;
+        }
+        if (applied) {
+            if (out_baseline_applied) {
+                *out_baseline_applied = true;
+            }
+            return true;
+        }
+    }
+    if (journal) {
+        bool replayed = false;
+        if (!recover_downstream_active_orders_from_journal(*journal, orders_shm_, order_book_, &replayed)) {
+            return false;
+        }
+        if (replayed) {
+            return true;
+        }
+    }
+    return recover_downstream_active_orders_from_shm(orders_shm_, order_book_);
 }
 
 const router_stats& order_router::stats() const noexcept { return stats_; }
 
 void order_router::reset_stats() noexcept { stats_ = router_stats{}; }
 
-InternalOrderId order_router::allocate_internal_order_id() noexcept {
-    if (upstream_shm_) {
-        return upstream_shm_->header.next_order_id.fetch_add(1, std::memory_order_relaxed);
+InternalOrderId order_router::allocate_internal_order_id(OrderIndex index) noexcept {
+    if (orders_shm_) {
+        return orders_shm_order_id(orders_shm_, index);
     }
     return order_book_.next_order_id();
 }
 
-bool order_router::send_to_downstream(OrderIndex index) {
+bool order_router::send_to_downstream(const OrderRequest& request, OrderIndex index, bool priority) {
     if (!downstream_shm_ || !orders_shm_) {
-        ErrorStatus status = ACCT_MAKE_ERROR(ErrorDomain::order, ErrorCode::ComponentUnavailable, "order_router",
-                                             "downstream/orders shm unavailable", 0);
-        record_error(status);
-        ACCT_LOG_ERROR_STATUS(status);
+        ACCT_REPORT_ERROR(ErrorDomain::order, ErrorCode::ComponentUnavailable, "order_router",
+                          "downstream/orders shm unavailable", 0);
         return false;
     }
 
-    const bool pushed = downstream_shm_->order_queue.try_push(index);
+    downstream_order_message message;
+    if (inline_downstream_ || priority) {
+        fill_downstream_order_message(request, index, message);
+    }
+    if (downstream_batching_) {
+        if (priority) {
+            ++stats_.priority_cancels;
+            pending_cancels_.push_back(message);
+            return true;
+        }
+        pending_downstream_.push_back(index);
+        if (inline_downstream_) {
+            pending_messages_.push_back(message);
+        }
+        return true;
+    }
+
+    const TimestampNs push_ns = tsc_clock::now_monotonic_ns();
+    bool pushed = false;
+    if (priority) {
+        pushed = downstream_shm_->cancel_queue.try_push(message);
+        stats_.priority_cancels += pushed ? 1 : 0;
+    } else {
+        pushed = inline_downstream_ ? downstream_shm_->order_payload_queue.try_push(message)
+                                    : downstream_shm_->order_queue.try_push(index);
+    }
     if (pushed) {
-        downstream_shm_->header.last_update = now_ns();
-        (void)orders_shm_update_stage(orders_shm_, index, OrderSlotState::DownstreamQueued, now_ns());
+        downstream_shm_->header.last_update = clock_now_ns(clock_);
+        orders_shm_mark_hop(orders_shm_, index, OrderLatencyHop::DownstreamQueued, push_ns);
+        (void)orders_shm_update_stage(orders_shm_, index, OrderSlotState::DownstreamQueued, clock_now_ns(clock_));
+        doorbell_ring(&orders_shm_->header.gateway_doorbell);
     } else {
-        (void)orders_shm_update_stage(orders_shm_, index, OrderSlotState::QueuePushFailed, now_ns());
+        (void)orders_shm_update_stage(orders_shm_, index, OrderSlotState::QueuePushFailed, clock_now_ns(clock_));
     }
     return pushed;
 }
 
-bool order_router::create_internal_order_slot(const OrderRequest& request, OrderSlotState stage, OrderIndex& out_index,
+void order_router::begin_downstream_batch() noexcept {
+    pending_downstream_.clear();
+    pending_messages_.clear();
+    pending_cancels_.clear();
+    downstream_batching_ = true;
+}
+
+// 一次批量推入登记的优先撤单与下标，返回入队失败的笔数；失败尾部回退阶段并把撤单置为 TraderError。
+std::size_t order_router::flush_downstream_batch() {
+    downstream_batching_ = false;
+    const std::size_t cancel_count = pending_cancels_.size();
+    const std::size_t count = pending_downstream_.size();
+    if (count == 0 && cancel_count == 0) {
+        return 0;
+    }
+
+    const TimestampNs push_ns = tsc_clock::now_monotonic_ns();
+    const std::size_t cancels_pushed =
+        cancel_count == 0 ? 0 : downstream_shm_->cancel_queue.try_push_bulk(pending_cancels_.data(), cancel_count);
+    std::size_t pushed = 0;
+    if (count > 0) {
+        pushed = inline_downstream_
+                     ? downstream_shm_->order_payload_queue.try_push_bulk(pending_messages_.data(), count)
+                     : downstream_shm_->order_queue.try_push_bulk(pending_downstream_.data(), count);
+    }
+    const TimestampNs update_ns = clock_now_ns(clock_);
+    for (std::size_t i = 0; i < cancels_pushed; ++i) {
+        orders_shm_mark_hop(orders_shm_, pending_cancels_[i].index, OrderLatencyHop::DownstreamQueued, push_ns);
+        (void)orders_shm_update_stage(orders_shm_, pending_cancels_[i].index, OrderSlotState::DownstreamQueued,
+                                      update_ns);
+    }
+    for (std::size_t i = 0; i < pushed; ++i) {
+        orders_shm_mark_hop(orders_shm_, pending_downstream_[i], OrderLatencyHop::DownstreamQueued, push_ns);
+        (void)orders_shm_update_stage(orders_shm_, pending_downstream_[i], OrderSlotState::DownstreamQueued, update_ns);
+    }
+    if (pushed + cancels_pushed > 0) {
+        downstream_shm_->header.last_update = update_ns;
+        doorbell_ring(&orders_shm_->header.gateway_doorbell);
+    }
+
+    for (std::size_t i = cancels_pushed; i < cancel_count; ++i) {
+        --stats_.priority_cancels;
+        fail_batched_downstream(pending_cancels_[i].index, pending_cancels_[i].internal_order_id, update_ns);
+    }
+    for (std::size_t i = pushed; i < count; ++i) {
+        const OrderIndex index = pending_downstream_[i];
+        InternalOrderId cancel_id = 0;
+        (void)orders_shm_read_slot(orders_shm_, index, [&](const OrderSlot& slot) {
+            cancel_id = slot.request.internal_order_id;
+        });
+        fail_batched_downstream(index, cancel_id, update_ns);
+    }
+    const std::size_t failed = (cancel_count - cancels_pushed) + (count - pushed);
+    if (failed > 0) {
+        ACCT_REPORT_ERROR(ErrorDomain::order, ErrorCode::QueuePushFailed, "order_router",
+                          "failed to push cancel batch to downstream", 0);
+    }
+    pending_downstream_.clear();
+    pending_messages_.clear();
+    pending_cancels_.clear();
+    return failed;
+}
+
+void order_router::fail_batched_downstream(OrderIndex index, InternalOrderId cancel_id, TimestampNs update_ns) {
+    (void)orders_shm_update_stage(orders_shm_, index, OrderSlotState::QueuePushFailed, update_ns);
+    if (cancel_id != 0) {
+        order_book_.update_state(cancel_id, OrderState::TraderError);
+    }
+    --stats_.orders_sent;
+    ++stats_.orders_rejected;
+    ++stats_.queue_full_count;
+}
+
+bool order_router::create_internal_order_slot(OrderRequest& request, OrderSlotState stage, OrderIndex& out_index,
                                               order_slot_source_t source) {
     if (!orders_shm_) {
         return false;
     }
-    return orders_shm_append(orders_shm_, request, stage, source, now_ns(), out_index);
+    return orders_shm_append_assign_id(orders_shm_, request, stage, source, clock_now_ns(clock_), out_index);
 }
 
 }  // namespace acct_service
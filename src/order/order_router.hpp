@@ -2,16 +2,21 @@
 
 #include <vector>
 
+#include "common/time_utils.hpp"
 #include "common/types.hpp"
 #include "order/order_book.hpp"
 #include "shm/shm_layout.hpp"
 
 namespace acct_service {
 
+struct order_journal_location;
+struct order_recovery_baseline;
+
 // 路由统计
 struct router_stats {
     uint64_t orders_received = 0;
     uint64_t orders_sent = 0;
+    uint64_t priority_cancels = 0;  // 经下游撤单优先队列发送的撤单/改单数
     uint64_t orders_rejected = 0;
     uint64_t queue_full_count = 0;
     TimestampNs last_order_time = 0;
@@ -20,6 +25,7 @@ struct router_stats {
 // 订单路由器
 class order_router {
 public:
+    // upstream_shm 非空时为订单池绑定订单号纪元（见 orders_shm_bind_id_epoch）
     order_router(OrderBook& book, downstream_shm_layout* downstream_shm, orders_shm_layout* orders_shm,
                  upstream_shm_layout* upstream_shm = nullptr);
     ~order_router() = default;
@@ -34,14 +40,39 @@ public:
     // 批量路由
     std::size_t route_orders(std::vector<OrderEntry*>& entries);
 
-    // 处理撤单请求
+    // 处理撤单请求；原单为拆单/执行父单时按批展开全部在途子单的撤单（见 route_child_cancels）
     bool route_cancel(InternalOrderId orig_id, InternalOrderId cancel_id, MdTime time);
 
+    // 改单：按原单生成改单请求下发，volume/dprice 为改后的总委托数量与价格；
+    // 柜台未通告改单能力、原单不可改或改后数量不超过已成交量时返回 false，调用方退回撤单再下新单
+    bool route_replace(InternalOrderId orig_id, InternalOrderId replace_id, Volume volume, DPrice dprice,
+                       MdTime time);
+
+    // 网关是否通告了改单能力
+    bool replace_supported() const noexcept;
+
+    // 换日切换后改写到新订单池（仅事件循环线程，下游批量为空时调用）
+    void set_orders_shm(orders_shm_layout* orders_shm) noexcept { orders_shm_ = orders_shm; }
+
+    // 批量撤单：按 request 的范围展开订单簿中的在途顶层订单，逐笔生成撤单后一次批量推入下游；
+    // out_targets 返回被撤的原订单ID，返回成功下发的撤单笔数
+    std::size_t route_mass_cancel(const OrderRequest& request, std::vector<InternalOrderId>& out_targets);
+
     // 提交执行引擎生成的内部子单，复用统一的下游发送与订单簿登记路径。
     bool submit_internal_order(OrderEntry& entry);
 
     // 启动恢复：从 orders_shm 重建“已下游但未终态”订单到 OrderBook。
-    bool recover_downstream_active_orders(const upstream_shm_layout* upstream_shm);
+    // 给出 baseline 时先按重启检查点重建（含父子关系）；否则或检查点不匹配时，
+    // 给出 journal 则回放二进制订单日志定位槽位，当日无日志再回退全量扫描；out_baseline_applied 标识实际走了哪条路径。
+    bool recover_downstream_active_orders(const order_journal_location* journal = nullptr,
+                                          const order_recovery_baseline* baseline = nullptr,
+                                          bool* out_baseline_applied = nullptr);
+
+    // 开启后改写下游内联订单消息队列，网关直接按消息报单，不再回读订单池槽位
+    void set_inline_downstream(bool enabled) noexcept { inline_downstream_ = enabled; }
+
+    // 挂接事件循环的每轮时钟，槽位与队列更新时间取本轮缓存值；nullptr 时逐次取时
+    void set_clock(const loop_clock* clock) noexcept { clock_ = clock; }
 
     // 获取统计信息
     const router_stats& stats() const noexcept;
@@ -50,16 +81,47 @@ public:
     void reset_stats() noexcept;
 
 private:
-    InternalOrderId allocate_internal_order_id() noexcept;
-    bool send_to_downstream(OrderIndex index);
-    bool create_internal_order_slot(const OrderRequest& request, OrderSlotState stage, OrderIndex& out_index,
+    // 已有槽位的订单号按槽位编码；无订单池时退回订单簿发号器
+    InternalOrderId allocate_internal_order_id(OrderIndex index) noexcept;
+    // priority 为 true 时写入下游撤单优先队列（仅用于原单已被柜台受理的撤单）
+    bool send_to_downstream(const OrderRequest& request, OrderIndex index, bool priority = false);
+    // 父单撤单展开：一次预留全部子单撤单的槽位，逐笔入簿后在一个下游批次里批量入队、只敲一次门铃；
+    // 已处在批量模式（批量撤单）时并入外层批次，由外层 flush
+    bool route_child_cancels(InternalOrderId parent_id, InternalOrderId cancel_id, MdTime time, bool user_cancel);
+    // 一次遍历父单子单，收集在途新单到 child_cancel_targets_；返回父单是否登记过子单
+    bool collect_child_cancel_targets(InternalOrderId parent_id);
+    // 预留 count 个订单池槽位写入 child_cancel_slots_，可跨段分多次预留，返回实际预留数
+    std::size_t reserve_child_cancel_slots(std::size_t count);
+    // 下发单笔非拆单撤单或改单并推进其状态
+    bool send_control_order(const OrderRequest& request, OrderIndex index, bool priority);
+    // 批量模式下 send_to_downstream 只登记下标，flush 时一次批量入队并只敲一次门铃
+    void begin_downstream_batch() noexcept;
+    std::size_t flush_downstream_batch();
+    // 批量入队失败的一笔：回退阶段、撤单置 TraderError 并扣回发送计数
+    void fail_batched_downstream(OrderIndex index, InternalOrderId cancel_id, TimestampNs update_ns);
+    void collect_mass_cancel_targets(const OrderRequest& request, std::vector<InternalOrderId>& out_targets) const;
+    // 未带订单号的请求按分到的槽位编码订单号并回填
+    bool create_internal_order_slot(OrderRequest& request, OrderSlotState stage, OrderIndex& out_index,
                                     order_slot_source_t source);
 
     OrderBook& order_book_;
     downstream_shm_layout* downstream_shm_;
     orders_shm_layout* orders_shm_;
-    upstream_shm_layout* upstream_shm_;
     router_stats stats_;
+    bool downstream_batching_ = false;
+    bool inline_downstream_ = false;
+    const loop_clock* clock_ = nullptr;
+    std::vector<OrderIndex> pending_downstream_;
+    std::vector<downstream_order_message> pending_messages_;  // 内联模式下与 pending_downstream_ 一一对应
+    std::vector<downstream_order_message> pending_cancels_;   // 批量模式下登记的优先撤单
+    // 父单撤单展开时的一笔在途子单
+    struct child_cancel_target {
+        InternalOrderId child_id = 0;
+        StrategyId strategy_id{};
+        bool priority = false;
+    };
+    std::vector<child_cancel_target> child_cancel_targets_;  // 父单撤单展开时的在途子单（复用容量）
+    std::vector<OrderIndex> child_cancel_slots_;              // 与 child_cancel_targets_ 对应的预留槽位
 };
 
 }  // namespace acct_service
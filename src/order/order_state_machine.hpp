@@ -0,0 +1,211 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "order/order_request.hpp"
+
+namespace acct_service {
+
+// 订单状态机：回报携带的目标状态经 (当前状态, 回报状态) 二维表查出落地状态与副作用，热路径只做两次查表。
+// 规则：终态吸收（Unknown 只可被确定的终态覆盖）；在途状态按推进等级单调，乱序到达的旧回报不回退；
+// NotSet 不是合法回报状态。
+
+// 推进等级：在途状态 1..7，越大越接近成交；终态与 NotSet 为 0
+constexpr int order_state_progress_rank(OrderState status) noexcept {
+    switch (status) {
+        case OrderState::MarketAccepted:
+            return 7;
+        case OrderState::BrokerAccepted:
+            return 6;
+        case OrderState::TraderSubmitted:
+            return 5;
+        case OrderState::TraderPending:
+            return 4;
+        case OrderState::RiskControllerAccepted:
+            return 3;
+        case OrderState::RiskControllerPending:
+            return 2;
+        case OrderState::UserSubmitted:
+            return 1;
+        default:
+            return 0;
+    }
+}
+
+constexpr bool order_state_is_terminal(OrderState status) noexcept {
+    switch (status) {
+        case OrderState::RiskControllerRejected:
+        case OrderState::TraderRejected:
+        case OrderState::TraderError:
+        case OrderState::BrokerRejected:
+        case OrderState::MarketRejected:
+        case OrderState::Finished:
+        case OrderState::Unknown:
+            return true;
+        default:
+            return false;
+    }
+}
+
+// 状态机覆盖的全部状态，下标即表内序号
+inline constexpr std::array<OrderState, 15> kOrderStates = {
+    OrderState::NotSet,
+    OrderState::UserSubmitted,
+    OrderState::RiskControllerPending,
+    OrderState::RiskControllerRejected,
+    OrderState::RiskControllerAccepted,
+    OrderState::TraderPending,
+    OrderState::TraderRejected,
+    OrderState::TraderSubmitted,
+    OrderState::TraderError,
+    OrderState::BrokerRejected,
+    OrderState::BrokerAccepted,
+    OrderState::MarketRejected,
+    OrderState::MarketAccepted,
+    OrderState::Finished,
+    OrderState::Unknown,
+};
+inline constexpr std::size_t kOrderStateCount = kOrderStates.size();
+inline constexpr uint8_t kInvalidOrderStateOrdinal = 0xFF;
+
+// 原始字节 -> 表内序号；未定义的编码映射到 kInvalidOrderStateOrdinal
+inline constexpr std::array<uint8_t, 256> kOrderStateOrdinals = [] {
+    std::array<uint8_t, 256> ordinals{};
+    for (uint8_t& ordinal : ordinals) {
+        ordinal = kInvalidOrderStateOrdinal;
+    }
+    for (std::size_t i = 0; i < kOrderStateCount; ++i) {
+        ordinals[static_cast<uint8_t>(kOrderStates[i])] = static_cast<uint8_t>(i);
+    }
+    return ordinals;
+}();
+
+// 副作用位
+inline constexpr uint8_t kOrderStepStore = 0x01;           // 落地状态与当前不同，需要写回订单簿
+inline constexpr uint8_t kOrderStepTerminal = 0x02;        // 落地状态为终态
+inline constexpr uint8_t kOrderStepBecameTerminal = 0x04;  // 本次由在途进入终态：释放冻结、登记归档
+inline constexpr uint8_t kOrderStepApplyReplace = 0x08;    // 在途订单收到柜台确认：改单在此生效
+inline constexpr uint8_t kOrderStepLatchError = 0x10;      // 进入 TraderError：父单聚合锁存错误
+inline constexpr uint8_t kOrderStepStale = 0x20;           // 乱序或终态后的迟到回报，状态保持不变
+
+struct order_transition {
+    OrderState next = OrderState::NotSet;
+    uint8_t effects = 0;
+};
+
+constexpr order_transition make_order_transition(OrderState current, OrderState incoming) noexcept {
+    const bool current_terminal = order_state_is_terminal(current);
+    const bool incoming_terminal = order_state_is_terminal(incoming);
+
+    bool accept = false;
+    if (incoming == OrderState::NotSet) {
+        accept = false;
+    } else if (current == OrderState::Unknown) {
+        accept = incoming_terminal && incoming != OrderState::Unknown;
+    } else if (current_terminal) {
+        accept = false;
+    } else if (incoming_terminal) {
+        accept = true;
+    } else {
+        accept = order_state_progress_rank(incoming) >= order_state_progress_rank(current);
+    }
+
+    order_transition step;
+    step.next = accept ? incoming : current;
+    if (step.next != current) {
+        step.effects |= kOrderStepStore;
+    }
+    if (!accept && incoming != current) {
+        step.effects |= kOrderStepStale;
+    }
+    if (order_state_is_terminal(step.next)) {
+        step.effects |= kOrderStepTerminal;
+        if (!current_terminal) {
+            step.effects |= kOrderStepBecameTerminal;
+        }
+    }
+    if (accept && !current_terminal && incoming == OrderState::BrokerAccepted) {
+        step.effects |= kOrderStepApplyReplace;
+    }
+    if (accept && incoming == OrderState::TraderError) {
+        step.effects |= kOrderStepLatchError;
+    }
+    return step;
+}
+
+using order_transition_table = std::array<std::array<order_transition, kOrderStateCount>, kOrderStateCount>;
+
+inline constexpr order_transition_table kOrderTransitions = [] {
+    order_transition_table table{};
+    for (std::size_t from = 0; from < kOrderStateCount; ++from) {
+        for (std::size_t to = 0; to < kOrderStateCount; ++to) {
+            table[from][to] = make_order_transition(kOrderStates[from], kOrderStates[to]);
+        }
+    }
+    return table;
+}();
+
+// 查表：未定义编码的当前状态按 Unknown 处理，未定义编码的回报状态视为迟到回报
+constexpr order_transition order_state_transition(OrderState current, OrderState incoming) noexcept {
+    uint8_t from = kOrderStateOrdinals[static_cast<uint8_t>(current)];
+    const uint8_t to = kOrderStateOrdinals[static_cast<uint8_t>(incoming)];
+    if (from == kInvalidOrderStateOrdinal) {
+        from = kOrderStateOrdinals[static_cast<uint8_t>(OrderState::Unknown)];
+    }
+    if (to == kInvalidOrderStateOrdinal) {
+        const order_transition& keep = kOrderTransitions[from][from];
+        return order_transition{keep.next, static_cast<uint8_t>(kOrderStepStale | (keep.effects & kOrderStepTerminal))};
+    }
+    return kOrderTransitions[from][to];
+}
+
+namespace order_state_machine_detail {
+
+// 编译期校验整张表：终态吸收、在途不回退、副作用位与落地状态一致
+constexpr bool table_is_valid() noexcept {
+    for (std::size_t from = 0; from < kOrderStateCount; ++from) {
+        const OrderState current = kOrderStates[from];
+        if (kOrderStateOrdinals[static_cast<uint8_t>(current)] != from) {
+            return false;
+        }
+        for (std::size_t to = 0; to < kOrderStateCount; ++to) {
+            const order_transition step = kOrderTransitions[from][to];
+            const bool terminal = order_state_is_terminal(step.next);
+            if (step.next != current && step.next != kOrderStates[to]) {
+                return false;
+            }
+            if (((step.effects & kOrderStepStore) != 0) != (step.next != current)) {
+                return false;
+            }
+            if (((step.effects & kOrderStepTerminal) != 0) != terminal) {
+                return false;
+            }
+            if (order_state_is_terminal(current) && current != OrderState::Unknown && step.next != current) {
+                return false;
+            }
+            if (!terminal && order_state_progress_rank(step.next) < order_state_progress_rank(current)) {
+                return false;
+            }
+            if ((step.effects & kOrderStepBecameTerminal) != 0 && order_state_is_terminal(current)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+}  // namespace order_state_machine_detail
+
+static_assert(order_state_machine_detail::table_is_valid(), "order transition table violates state machine rules");
+static_assert(order_state_transition(OrderState::MarketAccepted, OrderState::BrokerAccepted).next ==
+                  OrderState::MarketAccepted,
+              "late broker ack must not regress a market-accepted order");
+static_assert(order_state_transition(OrderState::Finished, OrderState::MarketAccepted).effects ==
+                  (kOrderStepStale | kOrderStepTerminal),
+              "terminal orders absorb late responses");
+static_assert(order_state_transition(OrderState::Unknown, OrderState::Finished).next == OrderState::Finished,
+              "unknown state resolves to a definite terminal state");
+
+}  // namespace acct_service
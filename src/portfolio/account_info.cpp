@@ -167,21 +167,6 @@ bool apply_key(account_info& info, const std::string& key, const std::string& ra
 
 }  // namespace
 
-DValue account_info::calculate_fee(TradeSide side, DValue traded_value) const {
-    const double traded = static_cast<double>(traded_value);
-
-    DValue commission = static_cast<DValue>(traded * commission_rate + 0.5);
-    if (commission < min_commission) {
-        commission = min_commission;
-    }
-
-    const DValue transfer_fee = static_cast<DValue>(traded * transfer_fee_rate + 0.5);
-    const DValue stamp_tax =
-        (side == TradeSide::Sell) ? static_cast<DValue>(traded * stamp_tax_rate + 0.5) : 0;
-
-    return commission + transfer_fee + stamp_tax;
-}
-
 bool account_info_manager::load_from_config(const std::string& config_path) {
     std::ifstream in(config_path);
     if (!in.is_open()) {
@@ -227,6 +212,7 @@ bool account_info_manager::load_from_config(const std::string& config_path) {
     }
 
     loaded.state = AccountState::Ready;
+    loaded.rebuild_fee_table();
     info_ = loaded;
     return true;
 }
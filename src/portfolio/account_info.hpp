@@ -1,5 +1,7 @@
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
 #include <string>
 
 #include "common/fixed_string.hpp"
@@ -8,6 +10,87 @@
 
 namespace acct_service {
 
+inline constexpr double kDefaultCommissionRate = 0.0003;
+inline constexpr double kDefaultStampTaxRate = 0.001;
+inline constexpr double kDefaultTransferFeeRate = 0.00002;
+inline constexpr DValue kDefaultMinCommission = 500;  // 5元 = 500分
+
+// 批量估费的一笔输入，篮子单逐腿填写后一次算完。
+struct fee_quote {
+    Market market = Market::NotSet;
+    TradeSide side = TradeSide::NotSet;
+    DValue traded_value = 0;
+};
+
+// 预计算的费率表：按 (市场, 买卖方向) 存放定点费率（×1e9），估费只做整数乘加与取整，无分支。
+// 费率按账户统一配置，证券没有类别属性，表不按类别拆分；卖方向条目带印花税，买方向为 0。
+class fee_table {
+public:
+    static constexpr std::size_t kMarketSlots = 5;  // NotSet/SZ/SH/BJ/HK，其余市场按 NotSet 计
+    static constexpr std::size_t kSideSlots = 2;    // 0=买（含未设置），1=卖
+    static constexpr uint64_t kRateScale = 1000000000ULL;
+
+    constexpr fee_table() = default;
+
+    static constexpr fee_table from_rates(double commission_rate, double stamp_tax_rate, double transfer_fee_rate,
+                                          DValue min_commission) noexcept {
+        fee_table table;
+        for (std::size_t market = 0; market < kMarketSlots; ++market) {
+            for (std::size_t side = 0; side < kSideSlots; ++side) {
+                entry& slot = table.entries_[market][side];
+                slot.commission_rate = to_fixed(commission_rate);
+                slot.transfer_fee_rate = to_fixed(transfer_fee_rate);
+                slot.stamp_tax_rate = side == 1 ? to_fixed(stamp_tax_rate) : 0;
+                slot.min_commission = min_commission;
+            }
+        }
+        return table;
+    }
+
+    // 佣金（不低于最低佣金）+ 过户费 + 卖方向印花税，各项分别四舍五入到分。
+    constexpr DValue calculate(Market market, TradeSide side, DValue traded_value) const noexcept {
+        const entry& slot = entries_[market_slot(market)][side_slot(side)];
+        const DValue commission = scaled(traded_value, slot.commission_rate);
+        const DValue floor = slot.min_commission;
+        return (commission > floor ? commission : floor) + scaled(traded_value, slot.transfer_fee_rate) +
+               scaled(traded_value, slot.stamp_tax_rate);
+    }
+
+    // 篮子单批量估费：逐腿查表，out 与 quotes 等长。
+    constexpr void calculate_batch(const fee_quote* quotes, std::size_t count, DValue* out) const noexcept {
+        for (std::size_t i = 0; i < count; ++i) {
+            out[i] = calculate(quotes[i].market, quotes[i].side, quotes[i].traded_value);
+        }
+    }
+
+private:
+    struct entry {
+        uint64_t commission_rate = 0;
+        uint64_t transfer_fee_rate = 0;
+        uint64_t stamp_tax_rate = 0;
+        DValue min_commission = 0;
+    };
+
+    static constexpr uint64_t to_fixed(double rate) noexcept {
+        return rate > 0.0 ? static_cast<uint64_t>(rate * static_cast<double>(kRateScale) + 0.5) : 0;
+    }
+    static constexpr DValue scaled(DValue value, uint64_t rate) noexcept {
+        const __uint128_t product = static_cast<__uint128_t>(value) * rate + kRateScale / 2;
+        return static_cast<DValue>(product / kRateScale);
+    }
+    // 越界市场落到 0 号槽，比较结果直接参与乘法，编译为无分支选择
+    static constexpr std::size_t market_slot(Market market) noexcept {
+        const std::size_t slot = static_cast<uint8_t>(market);
+        return slot * static_cast<std::size_t>(slot < kMarketSlots);
+    }
+    // Buy=1、NotSet=0 右移后为 0，Sell=2 为 1
+    static constexpr std::size_t side_slot(TradeSide side) noexcept {
+        return static_cast<std::size_t>((static_cast<uint8_t>(side) >> 1) & 1U);
+    }
+
+    entry entries_[kMarketSlots][kSideSlots]{};
+};
+
 // 账户信息
 struct account_info {
     AccountId account_id = 0;
@@ -23,18 +106,32 @@ struct account_info {
     bool can_short = false;
     bool can_margin = false;
 
-    // 费率配置
-    double commission_rate = 0.0003;
-    double stamp_tax_rate = 0.001;
-    double transfer_fee_rate = 0.00002;
-    DValue min_commission = 500;  // 5元 = 500分
+    // 费率配置；修改后需调用 rebuild_fee_table()，加载路径会自动重建
+    double commission_rate = kDefaultCommissionRate;
+    double stamp_tax_rate = kDefaultStampTaxRate;
+    double transfer_fee_rate = kDefaultTransferFeeRate;
+    DValue min_commission = kDefaultMinCommission;
+    fee_table fees = fee_table::from_rates(kDefaultCommissionRate, kDefaultStampTaxRate, kDefaultTransferFeeRate,
+                                           kDefaultMinCommission);
 
     // 风控参数
     DValue max_single_order = 0;
     DValue max_daily_amount = 0;
 
-    // 计算手续费
-    DValue calculate_fee(TradeSide side, DValue traded_value) const;
+    // 计算手续费（查预计算表）；未指定市场时按 NotSet 槽位计
+    DValue calculate_fee(TradeSide side, DValue traded_value) const noexcept {
+        return fees.calculate(Market::NotSet, side, traded_value);
+    }
+    DValue calculate_fee(Market market, TradeSide side, DValue traded_value) const noexcept {
+        return fees.calculate(market, side, traded_value);
+    }
+    void calculate_fees(const fee_quote* quotes, std::size_t count, DValue* out) const noexcept {
+        fees.calculate_batch(quotes, count, out);
+    }
+    // 按当前费率字段重建费率表
+    void rebuild_fee_table() noexcept {
+        fees = fee_table::from_rates(commission_rate, stamp_tax_rate, transfer_fee_rate, min_commission);
+    }
 };
 
 // 账户信息管理器
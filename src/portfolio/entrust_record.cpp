@@ -46,84 +46,114 @@ entrust_record entrust_record::from_order_request(const OrderRequest& req) {
     return record;
 }
 
+// 订单索引按 2 倍池容量开表，池满时探测长度仍短；证券数不超过持仓行数
+entrust_record_manager::entrust_record_manager(std::size_t capacity, bool huge_pages)
+    : capacity_(capacity < kNilLink ? capacity : kNilLink - 1),
+      slots_(capacity_, huge_pages, "entrust_records.slots"),
+      id_index_(capacity_ * 2),
+      security_index_(kMaxPositions) {}
+
 bool entrust_record_manager::load_today_entrusts(const std::string& db_path, AccountId account_id) {
     (void)db_path;
     (void)account_id;
-    entrusts_.clear();
+    size_ = 0;
     id_index_.clear();
     security_index_.clear();
+    active_ = entrust_chain{};
+    active_count_ = 0;
     return true;
 }
 
-void entrust_record_manager::add_or_update(const entrust_record& record) {
-    const auto it = id_index_.find(record.order_id);
-    if (it != id_index_.end()) {
-        entrusts_[it->second] = record;
-        return;
+bool entrust_record_manager::add_or_update(const entrust_record& record) {
+    const bool active = !is_terminal(record.status);
+
+    if (const uint32_t* existing = id_index_.find(record.order_id)) {
+        entrust_slot& slot = slots_[*existing];
+        const InternalSecurityId security_id = slot.record.security_id;
+        slot.record = record;
+        slot.record.security_id = security_id;
+        if (active && !slot.active) {
+            link_active(*existing);
+        } else if (!active && slot.active) {
+            unlink_active(*existing);
+        }
+        return true;
     }
 
-    const std::size_t index = entrusts_.size();
-    entrusts_.push_back(record);
-    id_index_[record.order_id] = index;
-    security_index_[record.security_id].push_back(index);
-}
-
-void entrust_record_manager::update_from_order(const OrderRequest& order) {
-    add_or_update(entrust_record::from_order_request(order));
-}
-
-const entrust_record* entrust_record_manager::find_entrust(InternalOrderId order_id) const {
-    const auto it = id_index_.find(order_id);
-    if (it == id_index_.end()) {
-        return nullptr;
+    // 订单索引容量不小于记录池，只需检查记录池与证券索引
+    if (size_ >= capacity_) {
+        return false;
+    }
+    if (!security_index_.contains(record.security_id) && security_index_.size() >= security_index_.capacity()) {
+        return false;
     }
-    return &entrusts_[it->second];
-}
 
-std::vector<const entrust_record*> entrust_record_manager::get_entrusts_by_security(
-    InternalSecurityId security_id) const {
-    std::vector<const entrust_record*> result;
-    const auto it = security_index_.find(security_id);
-    if (it == security_index_.end()) {
-        return result;
+    const uint32_t index = static_cast<uint32_t>(size_);
+    entrust_slot& slot = slots_[index];
+    slot.record = record;
+    slot.next_by_security = kNilLink;
+    slot.active_prev = kNilLink;
+    slot.active_next = kNilLink;
+    slot.active = false;
+    id_index_.insert_or_assign(record.order_id, index);
+
+    entrust_chain* by_security = security_index_.try_emplace(record.security_id);
+    if (by_security->tail == kNilLink) {
+        by_security->head = index;
+    } else {
+        slots_[by_security->tail].next_by_security = index;
     }
+    by_security->tail = index;
 
-    result.reserve(it->second.size());
-    for (std::size_t index : it->second) {
-        result.push_back(&entrusts_[index]);
+    if (active) {
+        link_active(index);
     }
-    return result;
+    ++size_;
+    return true;
 }
 
-std::vector<const entrust_record*> entrust_record_manager::get_active_entrusts() const {
-    std::vector<const entrust_record*> result;
-    for (const entrust_record& record : entrusts_) {
-        if (!is_terminal(record.status)) {
-            result.push_back(&record);
-        }
-    }
-    return result;
+bool entrust_record_manager::update_from_order(const OrderRequest& order) {
+    return add_or_update(entrust_record::from_order_request(order));
 }
 
-std::vector<const entrust_record*> entrust_record_manager::get_all_entrusts() const {
-    std::vector<const entrust_record*> result;
-    result.reserve(entrusts_.size());
-    for (const entrust_record& record : entrusts_) {
-        result.push_back(&record);
+const entrust_record* entrust_record_manager::find_entrust(InternalOrderId order_id) const {
+    const uint32_t* index = id_index_.find(order_id);
+    if (!index) {
+        return nullptr;
     }
-    return result;
+    return &slots_[*index].record;
 }
 
-std::size_t entrust_record_manager::entrust_count() const noexcept { return entrusts_.size(); }
+void entrust_record_manager::link_active(uint32_t index) noexcept {
+    entrust_slot& slot = slots_[index];
+    slot.active_prev = active_.tail;
+    slot.active_next = kNilLink;
+    if (active_.tail == kNilLink) {
+        active_.head = index;
+    } else {
+        slots_[active_.tail].active_next = index;
+    }
+    active_.tail = index;
+    slot.active = true;
+    ++active_count_;
+}
 
-std::size_t entrust_record_manager::active_count() const noexcept {
-    std::size_t count = 0;
-    for (const entrust_record& record : entrusts_) {
-        if (!is_terminal(record.status)) {
-            ++count;
-        }
+void entrust_record_manager::unlink_active(uint32_t index) noexcept {
+    entrust_slot& slot = slots_[index];
+    if (slot.active_prev == kNilLink) {
+        active_.head = slot.active_next;
+    } else {
+        slots_[slot.active_prev].active_next = slot.active_next;
     }
-    return count;
+    if (slot.active_next == kNilLink) {
+        active_.tail = slot.active_prev;
+    } else {
+        slots_[slot.active_next].active_prev = slot.active_prev;
+    }
+    slot.active_prev = kNilLink;
+    slot.active_next = kNilLink;
+    slot.active = false;
+    --active_count_;
 }
 
 bool entrust_record_manager::save_to_db(const std::string& db_path) const {
@@ -136,14 +166,14 @@ bool entrust_record_manager::save_to_db(const std::string& db_path) const {
         return false;
     }
 
-    for (const entrust_record& record : entrusts_) {
+    for_each_entrust([&out](const entrust_record& record) {
         out << record.order_id << ',' << record.security_id.view() << ',' << static_cast<int>(record.order_type) << ','
             << static_cast<int>(record.side) << ',' << static_cast<int>(record.market) << ','
             << static_cast<int>(record.status) << ',' << record.volume_entrust << ',' << record.volume_traded << ','
             << record.price_entrust << ',' << record.price_traded_avg << ',' << record.value_traded << ',' << record.fee
             << ',' << record.time_entrust << ',' << record.time_first_trade << ',' << record.time_last_update << ','
             << record.broker_order_id.c_str() << ',' << record.security_code.c_str() << '\n';
-    }
+    });
 
     return true;
 }
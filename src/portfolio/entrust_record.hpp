@@ -1,10 +1,14 @@
 #pragma once
 
+#include <cstdint>
+#include <memory>
 #include <string>
-#include <unordered_map>
-#include <vector>
 
+#include "common/constants.hpp"
 #include "common/fixed_string.hpp"
+#include "common/flat_hash_map.hpp"
+#include "common/lazy_region.hpp"
+#include "common/memory_accounting.hpp"
 #include "common/types.hpp"
 #include "order/order_request.hpp"
 
@@ -34,38 +38,106 @@ struct entrust_record {
     static entrust_record from_order_request(const OrderRequest& req);
 };
 
-// 委托记录管理器
+// 委托记录管理器：构造时按容量一次性映射记录池（惰性落页，huge_pages 时经 huge_page_arena 以大页承载），
+// 运行期不扩容，记录指针整日有效。
+// 未终结委托挂在双向活跃链表上，随状态迁移摘挂，活跃查询只走活跃委托。非线程安全。
 class entrust_record_manager {
 public:
-    entrust_record_manager() = default;
+    explicit entrust_record_manager(std::size_t capacity = kDailyEntrustCapacity, bool huge_pages = false);
     ~entrust_record_manager() = default;
 
+    entrust_record_manager(const entrust_record_manager&) = delete;
+    entrust_record_manager& operator=(const entrust_record_manager&) = delete;
+
     // 从数据库加载当日委托
     bool load_today_entrusts(const std::string& db_path, AccountId account_id);
 
-    // 添加/更新委托记录
-    void add_or_update(const entrust_record& record);
+    // 添加/更新委托记录；新委托遇记录池或证券索引已满时返回 false 且不改动状态。
+    // 更新不改变记录的证券归属，security_id 以首次添加时为准。
+    bool add_or_update(const entrust_record& record);
 
     // 从 order_request 更新
-    void update_from_order(const OrderRequest& order);
+    bool update_from_order(const OrderRequest& order);
 
     // 查询接口
     const entrust_record* find_entrust(InternalOrderId order_id) const;
-    std::vector<const entrust_record*> get_entrusts_by_security(InternalSecurityId security_id) const;
-    std::vector<const entrust_record*> get_active_entrusts() const;
-    std::vector<const entrust_record*> get_all_entrusts() const;
+
+    // 遍历：fn(const entrust_record& record)；回调内不得调用 add_or_update
+    // 证券下按添加顺序；活跃委托按最近一次变为活跃的先后
+    template <typename Fn>
+    void for_each_entrust_by_security(InternalSecurityId security_id, Fn&& fn) const;
+    template <typename Fn>
+    void for_each_active_entrust(Fn&& fn) const;
+    template <typename Fn>
+    void for_each_entrust(Fn&& fn) const;
 
     // 统计
-    std::size_t entrust_count() const noexcept;
-    std::size_t active_count() const noexcept;
+    std::size_t entrust_count() const noexcept { return size_; }
+    std::size_t active_count() const noexcept { return active_count_; }
+    std::size_t capacity() const noexcept { return capacity_; }
+    // 记录池与两个索引的内存占用，按已添加记录计在用
+    memory_usage memory() const noexcept {
+        memory_usage usage = slots_.memory(size_);
+        usage += id_index_.memory();
+        usage += security_index_.memory();
+        return usage;
+    }
 
     // 持久化
     bool save_to_db(const std::string& db_path) const;
 
 private:
-    std::vector<entrust_record> entrusts_;
-    std::unordered_map<InternalOrderId, std::size_t> id_index_;
-    std::unordered_map<InternalSecurityId, std::vector<std::size_t>> security_index_;
+    static constexpr uint32_t kNilLink = UINT32_MAX;
+
+    // 池内槽位：记录本体 + 同证券链表后继 + 活跃链表前后
+    struct entrust_slot {
+        entrust_record record;
+        uint32_t next_by_security = kNilLink;
+        uint32_t active_prev = kNilLink;
+        uint32_t active_next = kNilLink;
+        bool active = false;
+    };
+
+    struct entrust_chain {
+        uint32_t head = kNilLink;
+        uint32_t tail = kNilLink;
+    };
+
+    void link_active(uint32_t index) noexcept;
+    void unlink_active(uint32_t index) noexcept;
+
+    std::size_t capacity_ = 0;
+    std::size_t size_ = 0;
+    lazy_array<entrust_slot> slots_;                                // 委托记录池，构造后不再重新分配
+    flat_hash_map<InternalOrderId, uint32_t> id_index_;              // 订单 -> 槽位下标
+    flat_hash_map<InternalSecurityId, entrust_chain> security_index_;  // 证券 -> 委托槽位链表
+    entrust_chain active_;                                           // 未终结委托链表
+    std::size_t active_count_ = 0;
 };
 
+template <typename Fn>
+void entrust_record_manager::for_each_entrust_by_security(InternalSecurityId security_id, Fn&& fn) const {
+    const entrust_chain* chain = security_index_.find(security_id);
+    if (!chain) {
+        return;
+    }
+    for (uint32_t index = chain->head; index != kNilLink; index = slots_[index].next_by_security) {
+        fn(slots_[index].record);
+    }
+}
+
+template <typename Fn>
+void entrust_record_manager::for_each_active_entrust(Fn&& fn) const {
+    for (uint32_t index = active_.head; index != kNilLink; index = slots_[index].active_next) {
+        fn(slots_[index].record);
+    }
+}
+
+template <typename Fn>
+void entrust_record_manager::for_each_entrust(Fn&& fn) const {
+    for (std::size_t index = 0; index < size_; ++index) {
+        fn(slots_[index].record);
+    }
+}
+
 }  // namespace acct_service
@@ -0,0 +1,253 @@
+#include "portfolio/position_csv_parser.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <charconv>
+#include <cstring>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "common/log.hpp"
+#include "common/security_identity.hpp"
+
+namespace acct_service {
+
+namespace {
+
+constexpr const char* kLogModule = "position_csv";
+constexpr std::size_t kPositionColumns = 14;
+
+// 在 [begin, end) 中找第一个 ch，找不到返回 end；SSE2 下每次比较 16 字节
+const char* find_byte(const char* begin, const char* end, char ch) noexcept {
+#if defined(__SSE2__)
+    const __m128i needle = _mm_set1_epi8(ch);
+    for (; begin + 16 <= end; begin += 16) {
+        const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(begin));
+        const int mask = _mm_movemask_epi8(_mm_cmpeq_epi8(chunk, needle));
+        if (mask != 0) {
+            return begin + __builtin_ctz(static_cast<unsigned>(mask));
+        }
+    }
+#endif
+    const void* hit = std::memchr(begin, ch, static_cast<std::size_t>(end - begin));
+    return hit ? static_cast<const char*>(hit) : end;
+}
+
+// 统计 [begin, end) 中 ch 的个数，用于一次性预留 staging
+std::size_t count_byte(const char* begin, const char* end, char ch) noexcept {
+    std::size_t count = 0;
+#if defined(__SSE2__)
+    const __m128i needle = _mm_set1_epi8(ch);
+    for (; begin + 16 <= end; begin += 16) {
+        const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(begin));
+        count += static_cast<std::size_t>(
+            __builtin_popcount(static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, needle)))));
+    }
+#endif
+    for (; begin < end; ++begin) {
+        count += (*begin == ch) ? 1 : 0;
+    }
+    return count;
+}
+
+bool is_space(char ch) noexcept { return ch == ' ' || ch == '\t' || ch == '\r'; }
+
+std::string_view trim_view(std::string_view value) noexcept {
+    while (!value.empty() && is_space(value.front())) {
+        value.remove_prefix(1);
+    }
+    while (!value.empty() && is_space(value.back())) {
+        value.remove_suffix(1);
+    }
+    return value;
+}
+
+// ASCII 大小写无关比较，expected 须为小写
+bool equals_lower(std::string_view value, std::string_view expected) noexcept {
+    if (value.size() != expected.size()) {
+        return false;
+    }
+    for (std::size_t i = 0; i < value.size(); ++i) {
+        const char ch = (value[i] >= 'A' && value[i] <= 'Z') ? static_cast<char>(value[i] - 'A' + 'a') : value[i];
+        if (ch != expected[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool parse_u64(std::string_view text, uint64_t& out) noexcept {
+    if (text.empty()) {
+        return false;
+    }
+    const auto [end, ec] = std::from_chars(text.data(), text.data() + text.size(), out);
+    return ec == std::errc{} && end == text.data() + text.size();
+}
+
+// 按逗号切列，返回实际列数；超过 max_columns 的列忽略
+std::size_t split_columns(std::string_view line, std::string_view* columns, std::size_t max_columns) noexcept {
+    const char* cursor = line.data();
+    const char* const end = line.data() + line.size();
+    std::size_t count = 0;
+    while (count < max_columns) {
+        const char* comma = find_byte(cursor, end, ',');
+        columns[count++] = trim_view(std::string_view(cursor, static_cast<std::size_t>(comma - cursor)));
+        if (comma == end) {
+            break;
+        }
+        cursor = comma + 1;
+    }
+    return count;
+}
+
+bool parse_row(const std::string_view* columns, std::size_t count, position_seed_row& row) noexcept {
+    if (count < kPositionColumns) {
+        return false;
+    }
+    if (!normalize_internal_security_id(columns[1], row.security_id)) {
+        return false;
+    }
+    row.name.assign(columns[2]);
+    return parse_u64(columns[3], row.volume_available_t0) && parse_u64(columns[4], row.volume_available_t1) &&
+           parse_u64(columns[5], row.volume_buy) && parse_u64(columns[6], row.dvalue_buy) &&
+           parse_u64(columns[7], row.volume_buy_traded) && parse_u64(columns[8], row.dvalue_buy_traded) &&
+           parse_u64(columns[9], row.volume_sell) && parse_u64(columns[10], row.dvalue_sell) &&
+           parse_u64(columns[11], row.volume_sell_traded) && parse_u64(columns[12], row.dvalue_sell_traded) &&
+           parse_u64(columns[13], row.count_order);
+}
+
+// 只读映射 RAII：析构时 munmap
+class mapped_file {
+public:
+    mapped_file() = default;
+    ~mapped_file() {
+        if (data_ && size_ > 0) {
+            ::munmap(const_cast<char*>(data_), size_);
+        }
+    }
+    mapped_file(const mapped_file&) = delete;
+    mapped_file& operator=(const mapped_file&) = delete;
+
+    // 返回 -1 表示失败，0 表示文件不存在，1 表示已映射（空文件 size 为 0）
+    int open(const std::string& path) {
+        const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            return errno == ENOENT ? 0 : -1;
+        }
+        struct stat st{};
+        if (::fstat(fd, &st) != 0) {
+            ::close(fd);
+            return -1;
+        }
+        size_ = static_cast<std::size_t>(st.st_size);
+        if (size_ > 0) {
+            void* mapping = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE | MAP_POPULATE, fd, 0);
+            if (mapping == MAP_FAILED) {
+                ::close(fd);
+                size_ = 0;
+                return -1;
+            }
+            (void)::madvise(mapping, size_, MADV_SEQUENTIAL);
+            data_ = static_cast<const char*>(mapping);
+        }
+        ::close(fd);
+        return 1;
+    }
+
+    std::string_view view() const noexcept { return std::string_view(data_, size_); }
+
+private:
+    const char* data_ = nullptr;
+    std::size_t size_ = 0;
+};
+
+}  // namespace
+
+bool parse_position_csv(std::string_view text, std::vector<position_seed_row>& rows, std::size_t& error_line,
+                        position_csv_timings* timings) {
+    error_line = 0;
+    const char* cursor = text.data();
+    const char* const end = text.data() + text.size();
+
+    const TimestampNs scan_begin = now_monotonic_ns();
+    rows.reserve(rows.size() + count_byte(cursor, end, '\n') + 1);
+    const TimestampNs parse_begin = now_monotonic_ns();
+
+    std::string_view columns[kPositionColumns];
+    std::size_t line_number = 0;
+    const std::size_t rows_before = rows.size();
+    while (cursor < end) {
+        const char* newline = find_byte(cursor, end, '\n');
+        std::string_view line(cursor, static_cast<std::size_t>(newline - cursor));
+        cursor = newline == end ? end : newline + 1;
+        ++line_number;
+
+        const std::size_t comment_pos = line.find('#');
+        if (comment_pos != std::string_view::npos) {
+            line = line.substr(0, comment_pos);
+        }
+        line = trim_view(line);
+        if (line.empty()) {
+            continue;
+        }
+
+        const std::size_t count = split_columns(line, columns, kPositionColumns);
+        if (equals_lower(columns[0], "record_type")) {
+            continue;
+        }
+        position_seed_row& row = rows.emplace_back();
+        if (!equals_lower(columns[0], "position") || !parse_row(columns, count, row)) {
+            rows.pop_back();
+            error_line = line_number;
+            return false;
+        }
+    }
+
+    if (timings) {
+        const TimestampNs parse_end = now_monotonic_ns();
+        timings->scan_ns += parse_begin - scan_begin;
+        timings->parse_ns += parse_end - parse_begin;
+        timings->bytes += text.size();
+        timings->rows += rows.size() - rows_before;
+    }
+    return true;
+}
+
+bool load_position_csv(const std::string& path, std::vector<position_seed_row>& rows, bool& exists,
+                       position_csv_timings& timings) {
+    exists = false;
+    const TimestampNs map_begin = now_monotonic_ns();
+    mapped_file file;
+    const int opened = file.open(path);
+    timings.map_ns += now_monotonic_ns() - map_begin;
+    if (opened < 0) {
+        ACCT_LOG_ERROR(kLogModule, "failed to map position csv: " + path);
+        return false;
+    }
+    if (opened == 0) {
+        return true;
+    }
+    exists = true;
+
+    std::size_t error_line = 0;
+    if (!parse_position_csv(file.view(), rows, error_line, &timings)) {
+        ACCT_LOG_ERROR(kLogModule, "failed to parse position csv " + path + " at line " + std::to_string(error_line));
+        return false;
+    }
+    return true;
+}
+
+std::string format_position_csv_timings(const position_csv_timings& timings) {
+    return "bytes=" + std::to_string(timings.bytes) + " rows=" + std::to_string(timings.rows) +
+           " map_us=" + std::to_string(timings.map_ns / 1000) + " scan_us=" + std::to_string(timings.scan_ns / 1000) +
+           " parse_us=" + std::to_string(timings.parse_ns / 1000) +
+           " apply_us=" + std::to_string(timings.apply_ns / 1000);
+}
+
+}  // namespace acct_service
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "portfolio/position_manager.hpp"
+
+namespace acct_service {
+
+// 持仓快照 CSV 解析（position_loader 文件模式与盘后导入工具共用），结果为 position_seed_row。
+// 行格式：position,internal_security_id,name,volume_available_t0,volume_available_t1,volume_buy,dvalue_buy,
+// volume_buy_traded,dvalue_buy_traded,volume_sell,dvalue_sell,volume_sell_traded,dvalue_sell_traded,count_order
+
+// 分阶段耗时（单调时钟纳秒）；apply_ns 由调用方在写入目标后回填
+struct position_csv_timings {
+    uint64_t map_ns = 0;    // open + fstat + mmap
+    uint64_t scan_ns = 0;   // 向量化数行并预留 staging
+    uint64_t parse_ns = 0;  // 切列 + from_chars 写入 staging
+    uint64_t apply_ns = 0;  // 批量写入持仓行
+    uint64_t bytes = 0;
+    uint64_t rows = 0;
+};
+
+// 解析内存中的 CSV 文本，追加到 rows。空行、# 注释与 record_type 表头行跳过；
+// 任何一行格式错误返回 false，error_line 为出错的 1 起行号。
+bool parse_position_csv(std::string_view text, std::vector<position_seed_row>& rows, std::size_t& error_line,
+                        position_csv_timings* timings = nullptr);
+
+// 只读 mmap 整个文件后调用 parse_position_csv。文件不存在时 exists=false 并返回 true。
+bool load_position_csv(const std::string& path, std::vector<position_seed_row>& rows, bool& exists,
+                       position_csv_timings& timings);
+
+// 单行摘要日志：字节数、行数与各阶段微秒
+std::string format_position_csv_timings(const position_csv_timings& timings);
+
+}  // namespace acct_service
@@ -1,16 +1,29 @@
 #include "portfolio/position_loader.hpp"
 
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
 #include <algorithm>
 #include <cctype>
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <filesystem>
 #include <fstream>
 #include <memory>
+#include <string>
 #include <string_view>
 #include <utility>
 #include <vector>
 
 #include "common/log.hpp"
 #include "common/security_identity.hpp"
+#include "portfolio/position_csv_parser.hpp"
 #include "portfolio/position_manager.hpp"
+#include "shm/positions_shm.hpp"
+#include "shm/shm_layout.hpp"
 #include "third_party/sqlite3/sqlite3_shim.hpp"
 
 namespace acct_service {
@@ -29,24 +42,58 @@ constexpr std::string_view kPositionQuerySql =
     "volume_buy_traded, dvalue_buy_traded, volume_sell, dvalue_sell, "
     "volume_sell_traded, dvalue_sell_traded, "
     "count_order FROM positions ORDER BY ID ASC;";
+constexpr std::string_view kPositionCountSql = "SELECT COUNT(*) FROM positions;";
+constexpr std::string_view kPriceLimitTableSql =
+    "SELECT 1 FROM sqlite_master WHERE type = 'table' AND name = 'price_limits' LIMIT 1;";
+constexpr std::string_view kPriceLimitQuerySql =
+    "SELECT internal_security_id, limit_up, limit_down FROM price_limits;";
+
+// 二进制持仓镜像文件头（64 字节），其后紧跟 64 字节资金块与 row_count 条与 position 同布局的行（第 0 行为 FUND 标识行）；
+// 各段按缓存行对齐，映射后行区可直接按 position 访问。
+struct position_snapshot_header {
+    static constexpr uint32_t kMagic = 0x504E5350;  // "PSNP"
+    static constexpr uint32_t kVersion = 2;  // v2: 资金独立成块，不再复用第 0 行证券列
+
+    uint32_t magic = kMagic;
+    uint32_t version = kVersion;
+    uint32_t record_size = 0;
+    uint32_t row_count = 0;
+    AccountId account_id = 0;
+    uint32_t trading_day = 0;  // 导出时所属交易日 YYYYMMDD，0 表示未知（旧镜像该位为预留 0）
+    TimestampNs created_ns = 0;
+    uint64_t checksum = 0;  // 资金块 + 行区字节的 checksum
+    uint64_t reserved_tail[3] = {};
+};
 
-// DB 行字段映射，保持与 SQL 结果列一一对应。
-struct db_position_row {
-    std::string security_id;
-    std::string internal_security_id;
-    uint64_t volume_available_t0{0};
-    uint64_t volume_available_t1{0};
-    uint64_t volume_buy{0};
-    uint64_t dvalue_buy{0};
-    uint64_t volume_buy_traded{0};
-    uint64_t dvalue_buy_traded{0};
-    uint64_t volume_sell{0};
-    uint64_t dvalue_sell{0};
-    uint64_t volume_sell_traded{0};
-    uint64_t dvalue_sell_traded{0};
-    uint64_t count_order{0};
+struct position_snapshot_fund_block {
+    fund_info fund;
+    uint64_t reserved[4] = {};
 };
 
+static_assert(sizeof(position_snapshot_header) == 64, "position snapshot header must be 64 bytes");
+static_assert(sizeof(position_snapshot_fund_block) == 64, "position snapshot fund block must be 64 bytes");
+
+static_assert(offsetof(position, seq) == 0, "snapshot export clears the row seqlock at offset 0");
+
+constexpr uint32_t kSnapshotReadAttempts = 32;
+
+// 按 8 字节折叠的 FNV-1a：position 行长是 8 的倍数，逐字处理比逐字节快一个量级。
+uint64_t snapshot_checksum(const unsigned char* data, std::size_t bytes) noexcept {
+    constexpr uint64_t kOffsetBasis = 1469598103934665603ULL;
+    constexpr uint64_t kPrime = 1099511628211ULL;
+    uint64_t hash = kOffsetBasis;
+    std::size_t offset = 0;
+    for (; offset + sizeof(uint64_t) <= bytes; offset += sizeof(uint64_t)) {
+        uint64_t word = 0;
+        std::memcpy(&word, data + offset, sizeof(word));
+        hash = (hash ^ word) * kPrime;
+    }
+    for (; offset < bytes; ++offset) {
+        hash = (hash ^ data[offset]) * kPrime;
+    }
+    return hash;
+}
+
 // 去除首尾空白，统一 CSV 字段解析输入。
 std::string trim_copy(std::string value) {
     const auto not_space = [](unsigned char ch) { return !std::isspace(ch); };
@@ -88,153 +135,31 @@ bool parse_u64_field(std::string_view text, uint64_t& out) {
     }
 }
 
-// 将一行 position 快照写入持仓管理器（新增证券行并回填字段）。
-bool apply_position_seed_row(const std::vector<std::string>& columns, PositionManager& manager) {
-    if (columns.size() < 14) {
-        return false;
-    }
-
-    Market market = Market::NotSet;
-    std::string_view code;
-    if (!parse_internal_security_id(columns[1], market, code)) {
-        return false;
-    }
-
-    uint64_t volume_available_t0 = 0;
-    uint64_t volume_available_t1 = 0;
-    uint64_t volume_buy = 0;
-    uint64_t dvalue_buy = 0;
-    uint64_t volume_buy_traded = 0;
-    uint64_t dvalue_buy_traded = 0;
-    uint64_t volume_sell = 0;
-    uint64_t dvalue_sell = 0;
-    uint64_t volume_sell_traded = 0;
-    uint64_t dvalue_sell_traded = 0;
-    uint64_t count_order = 0;
-    if (!parse_u64_field(columns[3], volume_available_t0) || !parse_u64_field(columns[4], volume_available_t1) ||
-        !parse_u64_field(columns[5], volume_buy) || !parse_u64_field(columns[6], dvalue_buy) ||
-        !parse_u64_field(columns[7], volume_buy_traded) || !parse_u64_field(columns[8], dvalue_buy_traded) ||
-        !parse_u64_field(columns[9], volume_sell) || !parse_u64_field(columns[10], dvalue_sell) ||
-        !parse_u64_field(columns[11], volume_sell_traded) || !parse_u64_field(columns[12], dvalue_sell_traded) ||
-        !parse_u64_field(columns[13], count_order)) {
-        return false;
-    }
-
-    InternalSecurityId normalized_id;
-    if (!normalize_internal_security_id(columns[1], normalized_id)) {
-        return false;
-    }
-
-    const std::string_view position_name = columns[2].empty() ? normalized_id.view() : std::string_view(columns[2]);
-    const InternalSecurityId added = manager.add_security(code, position_name, market);
-    if (added.empty() || added != normalized_id.view()) {
-        return false;
-    }
-
-    position* pos = manager.get_position_mut(added);
-    if (!pos) {
-        return false;
-    }
-    position_lock guard(*pos);
-    pos->volume_available_t0 = volume_available_t0;
-    pos->volume_available_t1 = volume_available_t1;
-    pos->volume_buy = volume_buy;
-    pos->dvalue_buy = dvalue_buy;
-    pos->volume_buy_traded = volume_buy_traded;
-    pos->dvalue_buy_traded = dvalue_buy_traded;
-    pos->volume_sell = volume_sell;
-    pos->dvalue_sell = dvalue_sell;
-    pos->volume_sell_traded = volume_sell_traded;
-    pos->dvalue_sell_traded = dvalue_sell_traded;
-    pos->count_order = count_order;
-    return true;
-}
-
-// 将一行 DB 持仓快照写入持仓管理器；重复证券按后出现行覆盖。
-bool apply_position_db_row(const db_position_row& row, PositionManager& manager) {
-    Market market = Market::NotSet;
-    std::string_view code;
-    if (!parse_internal_security_id(row.internal_security_id, market, code)) {
-        return false;
-    }
-
-    InternalSecurityId normalized_id;
-    if (!normalize_internal_security_id(row.internal_security_id, normalized_id)) {
-        return false;
-    }
-
-    const InternalSecurityId added = manager.add_security(code, normalized_id.view(), market);
-    if (added.empty() || added != normalized_id.view()) {
-        return false;
-    }
-
-    position* pos = manager.get_position_mut(added);
-    if (!pos) {
-        return false;
-    }
-
-    position_lock guard(*pos);
-    pos->volume_available_t0 = row.volume_available_t0;
-    pos->volume_available_t1 = row.volume_available_t1;
-    pos->volume_buy = row.volume_buy;
-    pos->dvalue_buy = row.dvalue_buy;
-    pos->volume_buy_traded = row.volume_buy_traded;
-    pos->dvalue_buy_traded = row.dvalue_buy_traded;
-    pos->volume_sell = row.volume_sell;
-    pos->dvalue_sell = row.dvalue_sell;
-    pos->volume_sell_traded = row.volume_sell_traded;
-    pos->dvalue_sell_traded = row.dvalue_sell_traded;
-    pos->count_order = row.count_order;
-    return true;
-}
-
-// 读取可选 CSV 快照；文件不存在视作未加载，格式错误返回失败。
-bool load_positions_csv_if_exists(std::string_view path, PositionManager& manager, bool& loaded) {
+// 读取可选 CSV 快照：mmap 整体解析到 staging 后一次批量写入；文件不存在视作未加载，格式错误返回失败。
+bool load_positions_csv_if_exists(const std::string& path, PositionManager& manager, bool& loaded) {
     loaded = false;
     if (path.empty()) {
         return true;
     }
 
-    std::ifstream in{std::string(path)};
-    if (!in.is_open()) {
+    std::vector<position_seed_row> rows;
+    position_csv_timings timings;
+    if (!load_position_csv(path, rows, loaded, timings)) {
+        return false;
+    }
+    if (!loaded) {
         return true;
     }
-    loaded = true;
 
-    std::size_t loaded_rows = 0;
-    std::string line;
-    while (std::getline(in, line)) {
-        const std::size_t comment_pos = line.find('#');
-        if (comment_pos != std::string::npos) {
-            line = line.substr(0, comment_pos);
-        }
-        line = trim_copy(std::move(line));
-        if (line.empty()) {
-            continue;
-        }
-
-        const std::vector<std::string> columns = split_csv_columns(line);
-        if (columns.empty()) {
-            continue;
-        }
-
-        const std::string record_type = to_lower_copy(columns[0]);
-        if (record_type == "record_type") {
-            continue;
-        }
-        if (record_type != "position") {
-            ACCT_LOG_ERROR("position_loader", "invalid position bootstrap csv record type");
-            return false;
-        }
-        if (!apply_position_seed_row(columns, manager)) {
-            ACCT_LOG_ERROR("position_loader", "failed to parse/apply position bootstrap csv row");
-            return false;
-        }
-        ++loaded_rows;
+    const TimestampNs apply_begin = now_monotonic_ns();
+    if (!manager.load_security_rows(rows)) {
+        ACCT_LOG_ERROR("position_loader", "failed to apply position bootstrap csv rows");
+        return false;
     }
+    timings.apply_ns = now_monotonic_ns() - apply_begin;
 
-    if (loaded_rows > 0) {
-        ACCT_LOG_INFO("position_loader", "position bootstrap csv loaded");
+    if (!rows.empty()) {
+        ACCT_LOG_INFO("position_loader", "position bootstrap csv loaded: " + format_position_csv_timings(timings));
     }
     return true;
 }
@@ -347,14 +272,40 @@ bool load_fund_from_db(sqlite3* db, AccountId account_id, fund_info& fund) {
     return true;
 }
 
-// 从 positions 全表读取证券持仓并回写到持仓管理器。
-bool load_positions_from_db(sqlite3* db, PositionManager& manager) {
+// 执行不返回结果集的语句（事务控制），失败时记录 sqlite 错误信息。
+bool exec_statement(sqlite3* db, const char* sql) {
+    char* err_msg = nullptr;
+    const int rc = sqlite3_exec(db, sql, nullptr, nullptr, &err_msg);
+    if (err_msg != nullptr) {
+        sqlite3_free(err_msg);
+    }
+    if (rc != SQLITE_OK) {
+        ACCT_LOG_ERROR("position_loader", "failed to execute sqlite transaction statement");
+        return false;
+    }
+    return true;
+}
+
+// 先取行数预留暂存数组，再用单条预编译语句流式读出全部持仓行；证券键在此归一化。
+bool read_position_rows(sqlite3* db, std::vector<position_seed_row>& rows) {
+    sqlite_stmt_ptr count_stmt(nullptr, sqlite3_finalize);
+    if (!prepare_statement(db, kPositionCountSql, count_stmt)) {
+        return false;
+    }
+    uint64_t row_count = 0;
+    if (sqlite3_step(count_stmt.get()) != SQLITE_ROW || !read_required_u64(count_stmt.get(), 0, row_count)) {
+        ACCT_LOG_ERROR("position_loader", "failed to count positions rows");
+        return false;
+    }
+    rows.reserve(static_cast<std::size_t>(row_count));
+
     sqlite_stmt_ptr stmt(nullptr, sqlite3_finalize);
     if (!prepare_statement(db, kPositionQuerySql, stmt)) {
         return false;
     }
 
-    std::size_t loaded_rows = 0;
+    std::string security_id;
+    std::string internal_security_id;
     while (true) {
         const int rc = sqlite3_step(stmt.get());
         if (rc == SQLITE_DONE) {
@@ -365,9 +316,9 @@ bool load_positions_from_db(sqlite3* db, PositionManager& manager) {
             return false;
         }
 
-        db_position_row row;
-        if (!read_required_text(stmt.get(), 0, row.security_id) ||
-            !read_required_text(stmt.get(), 1, row.internal_security_id) ||
+        position_seed_row& row = rows.emplace_back();
+        if (!read_required_text(stmt.get(), 0, security_id) ||
+            !read_required_text(stmt.get(), 1, internal_security_id) ||
             !read_required_u64(stmt.get(), 2, row.volume_available_t0) ||
             !read_required_u64(stmt.get(), 3, row.volume_available_t1) ||
             !read_required_u64(stmt.get(), 4, row.volume_buy) || !read_required_u64(stmt.get(), 5, row.dvalue_buy) ||
@@ -380,16 +331,217 @@ bool load_positions_from_db(sqlite3* db, PositionManager& manager) {
             ACCT_LOG_ERROR("position_loader", "invalid positions column value");
             return false;
         }
+        if (!normalize_internal_security_id(internal_security_id, row.security_id)) {
+            ACCT_LOG_ERROR("position_loader", "invalid positions internal_security_id");
+            return false;
+        }
+    }
+    return true;
+}
+
+// 从 positions 全表读取证券持仓：读事务内暂存全部行，关闭事务后一次性写入持仓管理器并输出耗时。
+bool load_positions_from_db(sqlite3* db, PositionManager& manager) {
+    const TimestampNs start_ns = now_monotonic_ns();
+    if (!exec_statement(db, "BEGIN;")) {
+        return false;
+    }
+    std::vector<position_seed_row> rows;
+    const bool read_ok = read_position_rows(db, rows);
+    if (!exec_statement(db, read_ok ? "COMMIT;" : "ROLLBACK;") || !read_ok) {
+        return false;
+    }
+    const TimestampNs read_done_ns = now_monotonic_ns();
+
+    if (!manager.load_security_rows(rows)) {
+        ACCT_LOG_ERROR("position_loader", "failed to apply positions rows");
+        return false;
+    }
+
+    if (!rows.empty()) {
+        const TimestampNs done_ns = now_monotonic_ns();
+        const std::string summary =
+            "position bootstrap db loaded rows=" + std::to_string(rows.size()) +
+            " positions=" + std::to_string(manager.position_count()) +
+            " read_ns=" + std::to_string(static_cast<unsigned long long>(read_done_ns - start_ns)) +
+            " apply_ns=" + std::to_string(static_cast<unsigned long long>(done_ns - read_done_ns));
+        ACCT_LOG_INFO("position_loader", summary);
+    }
+    return true;
+}
 
-        if (!apply_position_db_row(row, manager)) {
-            ACCT_LOG_ERROR("position_loader", "failed to apply positions row");
+// 解析一行价格带 CSV：price_limit,internal_security_id,limit_up,limit_down
+bool parse_price_limit_row(const std::vector<std::string>& columns, price_limit_entry& out) {
+    if (columns.size() < 4) {
+        return false;
+    }
+    if (!normalize_internal_security_id(columns[1], out.internal_security_id)) {
+        return false;
+    }
+    return parse_u64_field(columns[2], out.limit_up) && parse_u64_field(columns[3], out.limit_down);
+}
+
+// 读取可选价格带 CSV；文件不存在视作空表，格式错误返回失败。
+bool load_price_limits_csv_if_exists(std::string_view path, std::vector<price_limit_entry>& out) {
+    std::ifstream in{std::string(path)};
+    if (!in.is_open()) {
+        return true;
+    }
+
+    std::string line;
+    while (std::getline(in, line)) {
+        const std::size_t comment_pos = line.find('#');
+        if (comment_pos != std::string::npos) {
+            line = line.substr(0, comment_pos);
+        }
+        line = trim_copy(std::move(line));
+        if (line.empty()) {
+            continue;
+        }
+
+        const std::vector<std::string> columns = split_csv_columns(line);
+        const std::string record_type = to_lower_copy(columns[0]);
+        if (record_type == "record_type") {
+            continue;
+        }
+        price_limit_entry entry;
+        if (record_type != "price_limit" || !parse_price_limit_row(columns, entry)) {
+            ACCT_LOG_ERROR("position_loader", "failed to parse price limit csv row");
+            return false;
+        }
+        out.push_back(entry);
+    }
+
+    if (!out.empty()) {
+        ACCT_LOG_INFO("position_loader", "price limit csv loaded");
+    }
+    return true;
+}
+
+// 从可选 price_limits 表读取价格带；表不存在视作空表。
+bool load_price_limits_from_db(sqlite3* db, std::vector<price_limit_entry>& out) {
+    sqlite_stmt_ptr probe(nullptr, sqlite3_finalize);
+    if (!prepare_statement(db, kPriceLimitTableSql, probe)) {
+        return false;
+    }
+    const int probe_rc = sqlite3_step(probe.get());
+    if (probe_rc == SQLITE_DONE) {
+        return true;
+    }
+    if (probe_rc != SQLITE_ROW) {
+        ACCT_LOG_ERROR("position_loader", "failed to probe price_limits table");
+        return false;
+    }
+
+    sqlite_stmt_ptr stmt(nullptr, sqlite3_finalize);
+    if (!prepare_statement(db, kPriceLimitQuerySql, stmt)) {
+        return false;
+    }
+
+    while (true) {
+        const int rc = sqlite3_step(stmt.get());
+        if (rc == SQLITE_DONE) {
+            break;
+        }
+        if (rc != SQLITE_ROW) {
+            ACCT_LOG_ERROR("position_loader", "failed while iterating price_limits rows");
+            return false;
+        }
+
+        std::string internal_security_id;
+        price_limit_entry entry;
+        if (!read_required_text(stmt.get(), 0, internal_security_id) ||
+            !normalize_internal_security_id(internal_security_id, entry.internal_security_id) ||
+            !read_required_u64(stmt.get(), 1, entry.limit_up) || !read_required_u64(stmt.get(), 2, entry.limit_down)) {
+            ACCT_LOG_ERROR("position_loader", "invalid price_limits column value");
             return false;
         }
-        ++loaded_rows;
+        out.push_back(entry);
     }
 
-    if (loaded_rows > 0) {
-        ACCT_LOG_INFO("position_loader", "position bootstrap db loaded");
+    if (!out.empty()) {
+        ACCT_LOG_INFO("position_loader", "price limit db loaded");
+    }
+    return true;
+}
+
+// 拆出镜像体中的资金块与行区交给持仓管理器。
+bool load_snapshot_body(const unsigned char* body, uint32_t row_count, bool roll_day, PositionManager& manager) {
+    position_snapshot_fund_block block;
+    std::memcpy(&block, body, sizeof(block));
+    return manager.load_position_image(
+        block.fund, reinterpret_cast<const position*>(body + sizeof(position_snapshot_fund_block)), row_count,
+        roll_day);
+}
+
+// 只读映射镜像文件，校验文件头与 checksum 后交给持仓管理器整段装载；镜像属于更早的交易日时装载同时日切。
+bool load_positions_from_snapshot(const std::string& path, AccountId account_id, uint32_t trading_day,
+                                  PositionManager& manager) {
+    const TimestampNs start_ns = now_monotonic_ns();
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        ACCT_LOG_ERROR("position_loader", "failed to open position snapshot");
+        return false;
+    }
+    struct stat file_stat {};
+    if (::fstat(fd, &file_stat) != 0 ||
+        static_cast<std::size_t>(file_stat.st_size) < sizeof(position_snapshot_header)) {
+        ::close(fd);
+        ACCT_LOG_ERROR("position_loader", "position snapshot is truncated");
+        return false;
+    }
+    const std::size_t file_size = static_cast<std::size_t>(file_stat.st_size);
+    void* mapping = ::mmap(nullptr, file_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        ACCT_LOG_ERROR("position_loader", "failed to mmap position snapshot");
+        return false;
+    }
+
+    const auto* bytes = static_cast<const unsigned char*>(mapping);
+    position_snapshot_header header;
+    std::memcpy(&header, bytes, sizeof(header));
+    const std::size_t body_bytes =
+        sizeof(position_snapshot_fund_block) + static_cast<std::size_t>(header.row_count) * sizeof(position);
+    const bool roll_day = header.trading_day != 0 && trading_day != 0 && header.trading_day < trading_day;
+    bool ok = header.magic == position_snapshot_header::kMagic &&
+              header.version == position_snapshot_header::kVersion && header.record_size == sizeof(position) &&
+              header.row_count >= 1 && header.row_count <= kMaxPositions &&
+              file_size == sizeof(header) + body_bytes;
+    if (!ok) {
+        ACCT_LOG_ERROR("position_loader", "position snapshot header is invalid");
+    } else if (header.account_id != account_id) {
+        ok = false;
+        ACCT_LOG_ERROR("position_loader", "position snapshot belongs to another account");
+    } else if (snapshot_checksum(bytes + sizeof(header), body_bytes) != header.checksum) {
+        ok = false;
+        ACCT_LOG_ERROR("position_loader", "position snapshot checksum mismatch");
+    } else if (!load_snapshot_body(bytes + sizeof(header), header.row_count, roll_day, manager)) {
+        ok = false;
+        ACCT_LOG_ERROR("position_loader", "failed to apply position snapshot rows");
+    }
+    ::munmap(mapping, file_size);
+
+    if (ok) {
+        const std::string summary =
+            "position bootstrap snapshot loaded rows=" + std::to_string(header.row_count) +
+            " day_roll=" + (roll_day ? "1" : "0") + " load_ns=" + std::to_string(static_cast<unsigned long long>(now_monotonic_ns() - start_ns));
+        ACCT_LOG_INFO("position_loader", summary);
+    }
+    return ok;
+}
+
+// 完整写出缓冲区，处理被信号打断与短写。
+bool write_all(int fd, const unsigned char* data, std::size_t size) {
+    while (size > 0) {
+        const ssize_t written = ::write(fd, data, size);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        data += written;
+        size -= static_cast<std::size_t>(written);
     }
     return true;
 }
@@ -406,15 +558,27 @@ position_loader::position_loader(db_source source)
 
 // 按已选模式加载快照，不做 DB/File 自动回退。
 bool position_loader::load(AccountId account_id, PositionManager& manager) {
+    bool ok = false;
     switch (source_type_) {
         case source_type::File:
-            return load_from_file(manager);
+            ok = load_from_file(manager);
+            break;
         case source_type::Db:
-            return load_from_db(account_id, manager);
+            ok = load_from_db(account_id, manager);
+            break;
+        case source_type::Snapshot:
+            ok = load_from_snapshot(account_id, manager);
+            break;
     }
-    return false;
+    // 种子行直接写入 positions，需重建成交额累计供当日成交额风控使用
+    manager.rebuild_turnover_totals();
+    return ok;
 }
 
+// 镜像模式构造：读取盘后导出的二进制持仓镜像。
+position_loader::position_loader(snapshot_source source)
+    : source_type_(source_type::Snapshot), source_path_(std::move(source.path)), trading_day_(source.trading_day) {}
+
 // 执行文件模式加载；CSV 缺失时保持默认空仓。
 bool position_loader::load_from_file(PositionManager& manager) const {
     if (source_path_.empty()) {
@@ -445,4 +609,98 @@ bool position_loader::load_from_db(AccountId account_id, PositionManager& manage
     return load_positions_from_db(db.get(), manager);
 }
 
+// 按已选模式加载价格带：文件模式读 config_file + ".price_limits.csv"，DB 模式读 price_limits 表。
+bool position_loader::load_price_limits(std::vector<price_limit_entry>& out) const {
+    out.clear();
+    if (source_type_ == source_type::Snapshot) {
+        return true;
+    }
+    if (source_type_ == source_type::File) {
+        if (source_path_.empty()) {
+            return true;
+        }
+        return load_price_limits_csv_if_exists(source_path_ + ".price_limits.csv", out);
+    }
+
+    sqlite_db_ptr db(nullptr, sqlite3_close);
+    if (!open_sqlite_readonly(source_path_, db)) {
+        return false;
+    }
+    return load_price_limits_from_db(db.get(), out);
+}
+
+// 镜像整段装载，FUND 行一并来自镜像；账户不符或校验失败时拒绝装载。
+bool position_loader::load_from_snapshot(AccountId account_id, PositionManager& manager) const {
+    return load_positions_from_snapshot(source_path_, account_id, trading_day_, manager);
+}
+
+bool write_position_snapshot(const std::string& path, AccountId account_id, const positions_shm_layout& shm,
+                             uint32_t trading_day) {
+    const std::size_t security_count =
+        std::min<std::size_t>(shm.position_count.load(std::memory_order_acquire),
+                              kMaxPositions - kFirstSecurityPositionIndex);
+    const std::size_t row_count = security_count + kFirstSecurityPositionIndex;
+
+    position_snapshot_header header;
+    header.record_size = sizeof(position);
+    header.row_count = static_cast<uint32_t>(row_count);
+    header.account_id = account_id;
+    header.trading_day = trading_day;
+    header.created_ns = now_ns();
+
+    position_snapshot_fund_block fund_block;
+    bool fund_stable = false;
+    for (uint32_t attempt = 0; attempt < kSnapshotReadAttempts && !fund_stable; ++attempt) {
+        fund_stable = positions_shm_try_read_fund(shm, fund_block.fund);
+    }
+    if (!fund_stable) {
+        ACCT_LOG_ERROR("position_loader", "fund block unstable while exporting snapshot");
+        return false;
+    }
+
+    const std::size_t body_bytes = sizeof(fund_block) + row_count * sizeof(position);
+    std::vector<unsigned char> buffer(sizeof(header) + body_bytes);
+    std::memcpy(buffer.data() + sizeof(header), &fund_block, sizeof(fund_block));
+    unsigned char* rows = buffer.data() + sizeof(header) + sizeof(fund_block);
+    for (std::size_t row_index = 0; row_index < row_count; ++row_index) {
+        unsigned char* record = rows + row_index * sizeof(position);
+        bool stable = false;
+        for (uint32_t attempt = 0; attempt < kSnapshotReadAttempts && !stable; ++attempt) {
+            stable = position_try_read(shm.positions[row_index], [record](const position& current) {
+                std::memcpy(record, static_cast<const void*>(&current), sizeof(position));
+            });
+        }
+        if (!stable) {
+            ACCT_LOG_ERROR("position_loader", "position row unstable while exporting snapshot");
+            return false;
+        }
+        // 镜像内的行锁一律置为稳定态，装载时无需再改写
+        std::memset(record, 0, sizeof(uint32_t));
+    }
+    header.checksum = snapshot_checksum(buffer.data() + sizeof(header), body_bytes);
+    std::memcpy(buffer.data(), &header, sizeof(header));
+
+    std::error_code ec;
+    const std::filesystem::path parent = std::filesystem::path(path).parent_path();
+    if (!parent.empty()) {
+        std::filesystem::create_directories(parent, ec);
+    }
+
+    // 先写临时文件再 rename，读端只会看到旧镜像或完整的新镜像
+    const std::string tmp_path = path + ".tmp";
+    const int fd = ::open(tmp_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        ACCT_LOG_ERROR("position_loader", "failed to open position snapshot for writing");
+        return false;
+    }
+    const bool written = write_all(fd, buffer.data(), buffer.size()) && ::fsync(fd) == 0;
+    ::close(fd);
+    if (!written || ::rename(tmp_path.c_str(), path.c_str()) != 0) {
+        ::unlink(tmp_path.c_str());
+        ACCT_LOG_ERROR("position_loader", "failed to write position snapshot");
+        return false;
+    }
+    return true;
+}
+
 }  // namespace acct_service
@@ -1,12 +1,21 @@
 #pragma once
 
 #include <string>
+#include <vector>
 
 #include "common/types.hpp"
 
 namespace acct_service {
 
 class PositionManager;
+struct positions_shm_layout;
+
+// 当日涨跌停价格带快照行，0 表示该侧不限
+struct price_limit_entry {
+    InternalSecurityId internal_security_id;
+    DPrice limit_up = 0;
+    DPrice limit_down = 0;
+};
 
 // 从外部快照（db/file）加载初始持仓，仅在 fresh SHM 初始化时生效。
 class position_loader {
@@ -19,23 +28,42 @@ public:
         std::string path;
     };
 
+    // 盘后生成的二进制持仓镜像：行布局与 position 一致，校验通过后整段拷入 positions_shm。
+    // trading_day 为当前交易日（YYYYMMDD）；镜像记录的交易日早于它时装载时做日切，任一方为 0 时原样装载。
+    struct snapshot_source {
+        std::string path;
+        uint32_t trading_day = 0;
+    };
+
     // 使用配置文件路径初始化文件模式 loader。
     explicit position_loader(file_source source);
     // 使用 sqlite 数据库路径初始化 DB 模式 loader。
     explicit position_loader(db_source source);
+    // 使用二进制持仓镜像路径初始化镜像模式 loader。
+    explicit position_loader(snapshot_source source);
     ~position_loader() = default;
 
     // 按构造时选择的模式加载持仓快照。
     bool load(AccountId account_id, PositionManager& manager);
 
+    // 加载当日涨跌停价格带；与持仓快照不同，每次启动都需加载。数据源缺失视为空表，镜像模式不含价格带。
+    bool load_price_limits(std::vector<price_limit_entry>& out) const;
+
 private:
-    enum class source_type { File, Db };
+    enum class source_type { File, Db, Snapshot };
 
     bool load_from_file(PositionManager& manager) const;
     bool load_from_db(AccountId account_id, PositionManager& manager) const;
+    bool load_from_snapshot(AccountId account_id, PositionManager& manager) const;
 
     source_type source_type_{source_type::File};
     std::string source_path_;
+    uint32_t trading_day_{0};
 };
 
+// 导出 FUND 行与全部已登记证券行为二进制持仓镜像（先写临时文件再 rename），供次日 fresh SHM 直接装载。
+// trading_day 记入镜像头（YYYYMMDD，0 表示未知），次日装载据此判断是否日切。
+bool write_position_snapshot(const std::string& path, AccountId account_id, const positions_shm_layout& shm,
+                             uint32_t trading_day = 0);
+
 }  // namespace acct_service
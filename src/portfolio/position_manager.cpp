@@ -1,5 +1,8 @@
 #include "portfolio/position_manager.hpp"
 
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
 #include <string>
 #include <utility>
 
@@ -9,6 +12,7 @@
 #include "common/security_identity.hpp"
 #include "common/types.hpp"
 #include "portfolio/position_loader.hpp"
+#include "shm/positions_shm.hpp"
 
 namespace acct_service {
 
@@ -34,7 +38,7 @@ bool header_compatible(const PositionsHeader& header) {
 }
 
 void clear_position(position& pos) {
-    pos.locked.store(0, std::memory_order_relaxed);
+    position_lock guard(pos);
     pos.available = 0;
     pos.volume_available_t0 = 0;
     pos.volume_available_t1 = 0;
@@ -47,6 +51,8 @@ void clear_position(position& pos) {
     pos.volume_sell_traded = 0;
     pos.dvalue_sell_traded = 0;
     pos.count_order = 0;
+    pos.count_cancel = 0;
+    pos.count_fill = 0;
     pos.id.clear();
     pos.name.clear();
 }
@@ -101,51 +107,82 @@ void ensure_fund_identity(position& fund_pos) {
     fund_pos.name.assign(kFundPositionId);
 }
 
-void set_default_fund(position& fund_pos) {
+// 持仓数量：可卖 + 当日买入 + 卖出冻结，成本按它分摊。
+uint64_t held_volume(const position& pos) noexcept {
+    return pos.volume_available_t0 + pos.volume_available_t1 + pos.volume_sell;
+}
+
+// value * part / whole，中间积按 128 位计算不溢出；调用方保证 part <= whole，结果不超过 value
+uint64_t scale_by_ratio(uint64_t value, uint64_t part, uint64_t whole) noexcept {
+    __extension__ typedef unsigned __int128 wide_uint;
+    return static_cast<uint64_t>(static_cast<wide_uint>(value) * part / whole);
+}
+
+// 成本未覆盖的持仓（装载的隔夜仓、旧进程写出的行）按首次观察到的价格补记成本；
+// 覆盖量超过持仓时按比例缩减，保持平均成本不变。
+void cover_cost(position& pos, uint64_t held, DPrice price) noexcept {
+    if (pos.cost_volume > held) {
+        pos.cost_basis = scale_by_ratio(pos.cost_basis, held, pos.cost_volume);
+        pos.cost_volume = held;
+        return;
+    }
+    if (pos.cost_volume == held || price == 0) {
+        return;
+    }
+    pos.cost_basis += (held - pos.cost_volume) * price;
+    pos.cost_volume = held;
+}
+
+// 已盯市的行在成交后立即按上次盯市价重算浮动盈亏，两次盯市之间行内字段保持自洽。
+void refresh_unrealized(position& pos) noexcept {
+    if (pos.mark_price != 0) {
+        pos.unrealized_pnl =
+            static_cast<int64_t>(held_volume(pos) * pos.mark_price) - static_cast<int64_t>(pos.cost_basis);
+    }
+}
+
+void set_default_fund(positions_shm_layout& shm) {
     fund_info defaults;
     defaults.total_asset = kDefaultInitialFund;
     defaults.available = kDefaultInitialFund;
     defaults.frozen = 0;
     defaults.market_value = 0;
-    store_fund_info(fund_pos, defaults);
+    shm.fund.working = defaults;
+    positions_shm_publish_fund(shm);
 }
 
 }  // namespace
 
 PositionManager::PositionManager(positions_shm_layout* shm, std::string config_file_path, std::string db_path,
-                                 bool db_enabled)
+                                 bool db_enabled, std::string snapshot_path, uint32_t trading_day)
     : shm_(shm),
       config_file_path_(std::move(config_file_path)),
       db_path_(std::move(db_path)),
-      db_enabled_(db_enabled) {}
+      db_enabled_(db_enabled),
+      snapshot_path_(std::move(snapshot_path)),
+      trading_day_(trading_day) {}
 
 bool PositionManager::initialize(AccountId account_id) {
     if (!shm_) {
-        ErrorStatus status = ACCT_MAKE_ERROR(ErrorDomain::portfolio, ErrorCode::ComponentUnavailable, "PositionManager",
-                                             "positions shm is null", 0);
-        record_error(status);
-        ACCT_LOG_ERROR_STATUS(status);
+        ACCT_REPORT_ERROR(ErrorDomain::portfolio, ErrorCode::ComponentUnavailable, "PositionManager",
+                          "positions shm is null", 0);
         return false;
     }
 
     security_to_row_.clear();
+    security_codes_.clear();
 
     if (!header_compatible(shm_->header)) {
-        ErrorStatus status = ACCT_MAKE_ERROR(ErrorDomain::portfolio, ErrorCode::ShmHeaderInvalid, "PositionManager",
-                                             "positions shm header incompatible", 0);
-        record_error(status);
-        ACCT_LOG_ERROR_STATUS(status);
+        ACCT_REPORT_ERROR(ErrorDomain::portfolio, ErrorCode::ShmHeaderInvalid, "PositionManager",
+                          "positions shm header incompatible", 0);
         return false;
     }
 
     if (shm_->header.init_state != 1) {
         const std::size_t existing = shm_->position_count.load(std::memory_order_relaxed);
         if (existing != 0) {
-            ErrorStatus status =
-                ACCT_MAKE_ERROR(ErrorDomain::portfolio, ErrorCode::ShmHeaderCorrupted, "PositionManager",
-                                "positions init_state is 0 while count is non-zero", 0);
-            record_error(status);
-            ACCT_LOG_ERROR_STATUS(status);
+            ACCT_REPORT_ERROR(ErrorDomain::portfolio, ErrorCode::ShmHeaderCorrupted, "PositionManager",
+                              "positions init_state is 0 while count is non-zero", 0);
             return false;
         }
 
@@ -162,19 +199,24 @@ bool PositionManager::initialize(AccountId account_id) {
         for (std::size_t i = 0; i < kMaxPositions; ++i) {
             clear_position(shm_->positions[i]);
         }
+        positions_shm_reset_changes(*shm_);
 
         position* fund_pos = fund_position(shm_);
         if (!fund_pos) {
-            ErrorStatus status = ACCT_MAKE_ERROR(ErrorDomain::portfolio, ErrorCode::ShmHeaderCorrupted,
-                                                 "PositionManager", "fund position row is unavailable", 0);
-            record_error(status);
-            ACCT_LOG_ERROR_STATUS(status);
+            ACCT_REPORT_ERROR(ErrorDomain::portfolio, ErrorCode::ShmHeaderCorrupted, "PositionManager",
+                              "fund position row is unavailable", 0);
             return false;
         }
         ensure_fund_identity(*fund_pos);
-        set_default_fund(*fund_pos);
+        set_default_fund(*shm_);
 
         const bool load_ok = [&]() {
+            // 镜像未生成时回到常规 loader；镜像存在但校验失败则拒绝启动，不静默退回其他数据源
+            std::error_code ec;
+            if (!snapshot_path_.empty() && std::filesystem::exists(snapshot_path_, ec)) {
+                position_loader loader(position_loader::snapshot_source{snapshot_path_, trading_day_});
+                return loader.load(account_id, *this);
+            }
             if (db_enabled_) {
                 position_loader loader(position_loader::db_source{db_path_});
                 return loader.load(account_id, *this);
@@ -184,10 +226,8 @@ bool PositionManager::initialize(AccountId account_id) {
             return loader.load(account_id, *this);
         }();
         if (!load_ok) {
-            ErrorStatus status = ACCT_MAKE_ERROR(ErrorDomain::portfolio, ErrorCode::PositionUpdateFailed,
-                                                 "PositionManager", "position init loader failed on fresh shm", 0);
-            record_error(status);
-            ACCT_LOG_ERROR_STATUS(status);
+            ACCT_REPORT_ERROR(ErrorDomain::portfolio, ErrorCode::PositionUpdateFailed, "PositionManager",
+                              "position init loader failed on fresh shm", 0);
             return false;
         }
 
@@ -195,15 +235,15 @@ bool PositionManager::initialize(AccountId account_id) {
         shm_->header.id.store(next_security_id(loaded_count), std::memory_order_relaxed);
         shm_->header.init_state = 1;
         shm_->header.last_update = now_ns();
+        rebuild_turnover_totals();
+        rebuild_security_code_table();
         return true;
     }
 
     position* fund_pos = fund_position(shm_);
     if (!fund_pos) {
-        ErrorStatus status = ACCT_MAKE_ERROR(ErrorDomain::portfolio, ErrorCode::ShmHeaderCorrupted, "PositionManager",
-                                             "fund position row is unavailable in initialized shm", 0);
-        record_error(status);
-        ACCT_LOG_ERROR_STATUS(status);
+        ACCT_REPORT_ERROR(ErrorDomain::portfolio, ErrorCode::ShmHeaderCorrupted, "PositionManager",
+                          "fund position row is unavailable in initialized shm", 0);
         return false;
     }
     ensure_fund_identity(*fund_pos);
@@ -226,10 +266,8 @@ bool PositionManager::initialize(AccountId account_id) {
         // MIC，避免继续向外传播旧值。
         InternalSecurityId security_id;
         if (!normalize_security_key(pos.id.view(), security_id)) {
-            ErrorStatus status = ACCT_MAKE_ERROR(ErrorDomain::portfolio, ErrorCode::InvalidParam, "PositionManager",
-                                                 "invalid internal_security_id found in initialized shm", 0);
-            record_error(status);
-            ACCT_LOG_ERROR_STATUS(status);
+            ACCT_REPORT_ERROR(ErrorDomain::portfolio, ErrorCode::InvalidParam, "PositionManager",
+                              "invalid internal_security_id found in initialized shm", 0);
             return false;
         }
 
@@ -239,16 +277,147 @@ bool PositionManager::initialize(AccountId account_id) {
 
     shm_->header.id.store(next_security_id(count), std::memory_order_relaxed);
     shm_->header.last_update = now_ns();
+    rebuild_turnover_totals();
+    rebuild_security_code_table();
     return true;
 }
 
+void PositionManager::rebuild_security_code_table() {
+    std::vector<std::pair<InternalSecurityId, SecurityHandle>> entries;
+    entries.reserve(security_to_row_.size());
+    for (const auto& [security_id, row_index] : security_to_row_) {
+        entries.emplace_back(security_id, static_cast<SecurityHandle>(row_index));
+    }
+    if (!security_codes_.build(entries)) {
+        ACCT_LOG_WARN("PositionManager", "security code table build failed, handle lookups use slow path");
+    }
+}
+
+void PositionManager::rebuild_turnover_totals() noexcept {
+    traded_buy_value_ = 0;
+    traded_sell_value_ = 0;
+    order_flow_totals_ = {};
+    if (!shm_) {
+        return;
+    }
+    const std::size_t count = clamp_security_count(shm_->position_count.load(std::memory_order_acquire));
+    for (std::size_t row_index = kFirstSecurityPositionIndex; row_index <= count && row_index < kMaxPositions;
+         ++row_index) {
+        const position& pos = shm_->positions[row_index];
+        if (pos.id.empty()) {
+            continue;
+        }
+        traded_buy_value_ += pos.dvalue_buy_traded;
+        traded_sell_value_ += pos.dvalue_sell_traded;
+        order_flow_totals_.orders += pos.count_order;
+        order_flow_totals_.cancels += pos.count_cancel;
+        order_flow_totals_.fills += pos.count_fill;
+    }
+}
+
+void PositionManager::record_order_flow(SecurityHandle handle, order_flow_event event, uint64_t count) {
+    position* pos = get_position_mut(handle);
+    uint64_t* row_counter = nullptr;
+    uint64_t* total = nullptr;
+    switch (event) {
+        case order_flow_event::NewOrder:
+            row_counter = pos ? &pos->count_order : nullptr;
+            total = &order_flow_totals_.orders;
+            break;
+        case order_flow_event::Cancel:
+            row_counter = pos ? &pos->count_cancel : nullptr;
+            total = &order_flow_totals_.cancels;
+            break;
+        case order_flow_event::Fill:
+            row_counter = pos ? &pos->count_fill : nullptr;
+            total = &order_flow_totals_.fills;
+            break;
+    }
+    if (!total) {
+        return;
+    }
+    *total += count;
+    if (row_counter) {
+        tracked_position_lock guard(*shm_, *pos);
+        *row_counter += count;
+    }
+}
+
+order_flow_counts PositionManager::order_flow(SecurityHandle handle) const noexcept {
+    const position* pos = get_position(handle);
+    if (!pos) {
+        return {};
+    }
+    return order_flow_counts{pos->count_order, pos->count_cancel, pos->count_fill};
+}
+
+std::size_t PositionManager::mark_to_market(std::span<const DPrice> marks) {
+    if (!shm_) {
+        return 0;
+    }
+    const std::size_t count = clamp_security_count(shm_->position_count.load(std::memory_order_acquire));
+    const std::size_t rows = std::min({count + 1, marks.size(), kMaxPositions});
+    if (rows <= kFirstSecurityPositionIndex) {
+        return 0;
+    }
+    mark_held_.resize(rows);
+    mark_cost_.resize(rows);
+    mark_cost_volume_.resize(rows);
+    mark_pnl_.resize(rows);
+
+    // 收集：行是 192 字节的 AoS，逐行只读数量与成本两条缓存行
+    for (std::size_t row = kFirstSecurityPositionIndex; row < rows; ++row) {
+        const position& pos = shm_->positions[row];
+        mark_held_[row] = held_volume(pos);
+        mark_cost_[row] = pos.cost_basis;
+        mark_cost_volume_[row] = pos.cost_volume;
+    }
+
+    // 计算：连续数组上的无分支循环，编译器可向量化；未覆盖成本的持仓按本次价格计入
+    const uint64_t* held = mark_held_.data();
+    const uint64_t* cost = mark_cost_.data();
+    const uint64_t* cost_volume = mark_cost_volume_.data();
+    const DPrice* price = marks.data();
+    int64_t* pnl = mark_pnl_.data();
+    for (std::size_t row = kFirstSecurityPositionIndex; row < rows; ++row) {
+        const uint64_t uncovered = held[row] > cost_volume[row] ? held[row] - cost_volume[row] : 0;
+        const uint64_t basis = cost[row] + uncovered * price[row];
+        pnl[row] = static_cast<int64_t>(held[row] * price[row]) - static_cast<int64_t>(basis);
+    }
+
+    // 回写：只有价格或结果变化的行进写区间并打变更戳，增量读者不会被无变化的盯市刷屏
+    std::size_t updated = 0;
+    for (std::size_t row = kFirstSecurityPositionIndex; row < rows; ++row) {
+        position& pos = shm_->positions[row];
+        if (price[row] == 0 || pos.id.empty() ||
+            (pos.mark_price == price[row] && pos.unrealized_pnl == pnl[row] && cost_volume[row] == held[row])) {
+            continue;
+        }
+        tracked_position_lock guard(*shm_, pos);
+        cover_cost(pos, held[row], price[row]);
+        pos.mark_price = price[row];
+        pos.unrealized_pnl = pnl[row];
+        ++updated;
+    }
+    if (updated > 0) {
+        shm_->header.last_update = now_ns();
+    }
+    return updated;
+}
+
 DValue PositionManager::get_available_fund() const noexcept {
     if (!shm_) {
         return 0;
     }
-    position& fund_pos = shm_->positions[kFundPositionIndex];
-    position_lock guard(fund_pos);
-    return static_cast<DValue>(fund_available_field(fund_pos));
+    // 账户线程是唯一写者，自身读取直接读工作副本
+    return static_cast<DValue>(shm_->fund.working.available);
+}
+
+DValue PositionManager::get_frozen_fund() const noexcept {
+    if (!shm_) {
+        return 0;
+    }
+    return static_cast<DValue>(shm_->fund.working.frozen);
 }
 
 bool PositionManager::freeze_fund(DValue amount, InternalOrderId order_id) {
@@ -257,11 +426,10 @@ bool PositionManager::freeze_fund(DValue amount, InternalOrderId order_id) {
         return false;
     }
 
-    position& fund_pos = shm_->positions[kFundPositionIndex];
-    position_lock guard(fund_pos);
+    fund_info& fund = shm_->fund.working;
 
-    const uint64_t available = fund_available_field(fund_pos);
-    const uint64_t frozen = fund_frozen_field(fund_pos);
+    const uint64_t available = fund.available;
+    const uint64_t frozen = fund.frozen;
     if (available < amount) {
         return false;
     }
@@ -270,8 +438,9 @@ bool PositionManager::freeze_fund(DValue amount, InternalOrderId order_id) {
         return false;
     }
 
-    fund_available_field(fund_pos) = available - amount;
-    fund_frozen_field(fund_pos) = new_frozen;
+    fund.available = available - amount;
+    fund.frozen = new_frozen;
+    positions_shm_publish_fund(*shm_);
     shm_->header.last_update = now_ns();
     return true;
 }
@@ -282,11 +451,10 @@ bool PositionManager::unfreeze_fund(DValue amount, InternalOrderId order_id) {
         return false;
     }
 
-    position& fund_pos = shm_->positions[kFundPositionIndex];
-    position_lock guard(fund_pos);
+    fund_info& fund = shm_->fund.working;
 
-    const uint64_t available = fund_available_field(fund_pos);
-    const uint64_t frozen = fund_frozen_field(fund_pos);
+    const uint64_t available = fund.available;
+    const uint64_t frozen = fund.frozen;
     if (frozen < amount) {
         return false;
     }
@@ -295,8 +463,9 @@ bool PositionManager::unfreeze_fund(DValue amount, InternalOrderId order_id) {
         return false;
     }
 
-    fund_frozen_field(fund_pos) = frozen - amount;
-    fund_available_field(fund_pos) = new_available;
+    fund.frozen = frozen - amount;
+    fund.available = new_available;
+    positions_shm_publish_fund(*shm_);
     shm_->header.last_update = now_ns();
     return true;
 }
@@ -312,26 +481,26 @@ bool PositionManager::deduct_fund(DValue amount, DValue fee, InternalOrderId ord
         return false;
     }
 
-    position& fund_pos = shm_->positions[kFundPositionIndex];
-    position_lock guard(fund_pos);
+    fund_info& fund = shm_->fund.working;
 
-    const uint64_t frozen = fund_frozen_field(fund_pos);
+    const uint64_t frozen = fund.frozen;
     if (frozen < total) {
         return false;
     }
 
-    const uint64_t market_value = fund_market_value_field(fund_pos);
+    const uint64_t market_value = fund.market_value;
     const uint64_t new_market_value = market_value + amount;
     if (new_market_value < market_value) {
         return false;
     }
 
-    const uint64_t total_asset = fund_total_asset_field(fund_pos);
+    const uint64_t total_asset = fund.total_asset;
     const uint64_t new_total_asset = total_asset < fee ? 0 : total_asset - fee;
 
-    fund_frozen_field(fund_pos) = frozen - total;
-    fund_total_asset_field(fund_pos) = new_total_asset;
-    fund_market_value_field(fund_pos) = new_market_value;
+    fund.frozen = frozen - total;
+    fund.total_asset = new_total_asset;
+    fund.market_value = new_market_value;
+    positions_shm_publish_fund(*shm_);
     shm_->header.last_update = now_ns();
     return true;
 }
@@ -342,11 +511,10 @@ bool PositionManager::add_fund(DValue amount, InternalOrderId order_id) {
         return false;
     }
 
-    position& fund_pos = shm_->positions[kFundPositionIndex];
-    position_lock guard(fund_pos);
+    fund_info& fund = shm_->fund.working;
 
-    const uint64_t available = fund_available_field(fund_pos);
-    const uint64_t total_asset = fund_total_asset_field(fund_pos);
+    const uint64_t available = fund.available;
+    const uint64_t total_asset = fund.total_asset;
     const uint64_t new_available = available + amount;
     if (new_available < available) {
         return false;
@@ -356,8 +524,9 @@ bool PositionManager::add_fund(DValue amount, InternalOrderId order_id) {
         return false;
     }
 
-    fund_available_field(fund_pos) = new_available;
-    fund_total_asset_field(fund_pos) = new_total_asset;
+    fund.available = new_available;
+    fund.total_asset = new_total_asset;
+    positions_shm_publish_fund(*shm_);
     shm_->header.last_update = now_ns();
     return true;
 }
@@ -374,26 +543,26 @@ bool PositionManager::apply_buy_trade_fund(DValue amount, DValue fee, InternalOr
         return false;
     }
 
-    position& fund_pos = shm_->positions[kFundPositionIndex];
-    position_lock guard(fund_pos);
+    fund_info& fund = shm_->fund.working;
 
-    const uint64_t available = fund_available_field(fund_pos);
+    const uint64_t available = fund.available;
     if (available < total) {
         return false;
     }
 
-    const uint64_t market_value = fund_market_value_field(fund_pos);
+    const uint64_t market_value = fund.market_value;
     const uint64_t new_market_value = market_value + amount;
     if (new_market_value < market_value) {
         return false;
     }
 
-    const uint64_t total_asset = fund_total_asset_field(fund_pos);
+    const uint64_t total_asset = fund.total_asset;
     const uint64_t new_total_asset = total_asset < fee ? 0 : total_asset - fee;
 
-    fund_available_field(fund_pos) = available - total;
-    fund_total_asset_field(fund_pos) = new_total_asset;
-    fund_market_value_field(fund_pos) = new_market_value;
+    fund.available = available - total;
+    fund.total_asset = new_total_asset;
+    fund.market_value = new_market_value;
+    positions_shm_publish_fund(*shm_);
     shm_->header.last_update = now_ns();
     return true;
 }
@@ -405,10 +574,9 @@ bool PositionManager::apply_sell_trade_fund(DValue amount, DValue fee, InternalO
         return false;
     }
 
-    position& fund_pos = shm_->positions[kFundPositionIndex];
-    position_lock guard(fund_pos);
+    fund_info& fund = shm_->fund.working;
 
-    const uint64_t available = fund_available_field(fund_pos);
+    const uint64_t available = fund.available;
     uint64_t new_available = available;
     if (amount >= fee) {
         const uint64_t cash_increase = amount - fee;
@@ -424,83 +592,128 @@ bool PositionManager::apply_sell_trade_fund(DValue amount, DValue fee, InternalO
         new_available = available - cash_decrease;
     }
 
-    const uint64_t market_value = fund_market_value_field(fund_pos);
+    const uint64_t market_value = fund.market_value;
     const uint64_t new_market_value = market_value < amount ? 0 : market_value - amount;
 
-    const uint64_t total_asset = fund_total_asset_field(fund_pos);
+    const uint64_t total_asset = fund.total_asset;
     const uint64_t new_total_asset = total_asset < fee ? 0 : total_asset - fee;
 
-    fund_available_field(fund_pos) = new_available;
-    fund_total_asset_field(fund_pos) = new_total_asset;
-    fund_market_value_field(fund_pos) = new_market_value;
+    fund.available = new_available;
+    fund.total_asset = new_total_asset;
+    fund.market_value = new_market_value;
+    positions_shm_publish_fund(*shm_);
     shm_->header.last_update = now_ns();
     return true;
 }
 
-const position* PositionManager::get_position(InternalSecurityId security_id) const {
+SecurityHandle PositionManager::resolve_security_handle(InternalSecurityId security_id) const {
+    // 表内只有 canonical 键，按原始字节命中即说明无需归一化
+    const SecurityHandle interned = security_codes_.find(security_id);
+    if (interned != kInvalidSecurityHandle) {
+        return interned;
+    }
+
     InternalSecurityId normalized_security_id;
     if (!normalize_security_key(security_id.view(), normalized_security_id)) {
-        return nullptr;
+        return kInvalidSecurityHandle;
     }
 
     const auto it = security_to_row_.find(normalized_security_id);
     if (it == security_to_row_.end()) {
-        return nullptr;
+        return kInvalidSecurityHandle;
     }
-    return security_position_by_row(shm_, it->second);
+    return static_cast<SecurityHandle>(it->second);
+}
+
+const position* PositionManager::get_position(InternalSecurityId security_id) const {
+    return get_position(resolve_security_handle(security_id));
 }
 
 position* PositionManager::get_position_mut(InternalSecurityId security_id) {
-    InternalSecurityId normalized_security_id;
-    if (!normalize_security_key(security_id.view(), normalized_security_id)) {
+    return get_position_mut(resolve_security_handle(security_id));
+}
+
+Volume PositionManager::get_sellable_volume(InternalSecurityId security_id) const {
+    return get_sellable_volume(resolve_security_handle(security_id));
+}
+
+bool PositionManager::freeze_position(InternalSecurityId security_id, Volume volume, InternalOrderId order_id) {
+    return freeze_position(resolve_security_handle(security_id), volume, order_id);
+}
+
+bool PositionManager::unfreeze_position(InternalSecurityId security_id, Volume volume, InternalOrderId order_id) {
+    return unfreeze_position(resolve_security_handle(security_id), volume, order_id);
+}
+
+bool PositionManager::deduct_position(InternalSecurityId security_id, Volume volume, DValue value,
+                                      InternalOrderId order_id, DValue fee) {
+    return deduct_position(resolve_security_handle(security_id), volume, value, order_id, fee);
+}
+
+bool PositionManager::add_position(InternalSecurityId security_id, Volume volume, DPrice price,
+                                   InternalOrderId order_id, DValue fee) {
+    return add_position(resolve_security_handle(security_id), volume, price, order_id, fee);
+}
+
+const position* PositionManager::get_position(SecurityHandle handle) const {
+    if (handle == kInvalidSecurityHandle) {
         return nullptr;
     }
+    return security_position_by_row(shm_, handle);
+}
 
-    const auto it = security_to_row_.find(normalized_security_id);
-    if (it == security_to_row_.end()) {
+void PositionManager::prefetch_position(SecurityHandle handle) const noexcept {
+    if (handle == kInvalidSecurityHandle || handle >= kMaxPositions || !shm_) {
+        return;
+    }
+    const char* row = reinterpret_cast<const char*>(&shm_->positions[handle]);
+    for (std::size_t offset = 0; offset < sizeof(position); offset += 64) {
+        __builtin_prefetch(row + offset, 1, 3);
+    }
+}
+
+position* PositionManager::get_position_mut(SecurityHandle handle) {
+    if (handle == kInvalidSecurityHandle) {
         return nullptr;
     }
-    return security_position_by_row(shm_, it->second);
+    return security_position_by_row(shm_, handle);
 }
 
-Volume PositionManager::get_sellable_volume(InternalSecurityId security_id) const {
-    const position* pos = get_position(security_id);
+Volume PositionManager::get_sellable_volume(SecurityHandle handle) const {
+    const position* pos = get_position(handle);
     if (!pos) {
         return 0;
     }
 
-    auto& mutable_pos = const_cast<position&>(*pos);
-    position_lock guard(mutable_pos);
-    return mutable_pos.volume_available_t0;
+    return pos->volume_available_t0;
 }
 
-bool PositionManager::freeze_position(InternalSecurityId security_id, Volume volume, InternalOrderId order_id) {
+bool PositionManager::freeze_position(SecurityHandle handle, Volume volume, InternalOrderId order_id) {
     (void)order_id;
-    position* pos = get_position_mut(security_id);
+    position* pos = get_position_mut(handle);
     if (!pos) {
         return false;
     }
 
-    position_lock guard(*pos);
+    tracked_position_lock guard(*shm_, *pos);
     if (pos->volume_available_t0 < volume) {
         return false;
     }
 
     pos->volume_available_t0 -= volume;
     pos->volume_sell += volume;
-    pos->count_order += 1;
     shm_->header.last_update = now_ns();
     return true;
 }
 
-bool PositionManager::unfreeze_position(InternalSecurityId security_id, Volume volume, InternalOrderId order_id) {
+bool PositionManager::unfreeze_position(SecurityHandle handle, Volume volume, InternalOrderId order_id) {
     (void)order_id;
-    position* pos = get_position_mut(security_id);
+    position* pos = get_position_mut(handle);
     if (!pos) {
         return false;
     }
 
-    position_lock guard(*pos);
+    tracked_position_lock guard(*shm_, *pos);
     if (pos->volume_sell < volume) {
         return false;
     }
@@ -510,15 +723,16 @@ bool PositionManager::unfreeze_position(InternalSecurityId security_id, Volume v
     return true;
 }
 
-bool PositionManager::deduct_position(InternalSecurityId security_id, Volume volume, DValue value,
-                                      InternalOrderId order_id) {
+bool PositionManager::deduct_position(SecurityHandle handle, Volume volume, DValue value, InternalOrderId order_id,
+                                      DValue fee) {
     (void)order_id;
-    position* pos = get_position_mut(security_id);
+    position* pos = get_position_mut(handle);
     if (!pos) {
         return false;
     }
 
-    position_lock guard(*pos);
+    tracked_position_lock guard(*shm_, *pos);
+    const uint64_t held = held_volume(*pos);
     if (pos->volume_sell >= volume) {
         // 常规路径：已冻结卖出数量，成交后只需释放冻结计数。
         pos->volume_sell -= volume;
@@ -538,25 +752,45 @@ bool PositionManager::deduct_position(InternalSecurityId security_id, Volume vol
 
     pos->volume_sell_traded += volume;
     pos->dvalue_sell_traded += value;
+    traded_sell_value_ += value;
+
+    // 卖出部分按平均成本结转：已实现 = 成交额 - 费用 - 结转成本
+    cover_cost(*pos, held, volume == 0 ? 0 : value / volume);
+    uint64_t released = pos->cost_basis;
+    if (volume < pos->cost_volume) {
+        released = scale_by_ratio(pos->cost_basis, volume, pos->cost_volume);
+        pos->cost_volume -= volume;
+    } else {
+        pos->cost_volume = 0;
+    }
+    pos->cost_basis -= released;
+    pos->realized_pnl += static_cast<int64_t>(value) - static_cast<int64_t>(fee) - static_cast<int64_t>(released);
+    refresh_unrealized(*pos);
     shm_->header.last_update = now_ns();
     return true;
 }
 
-bool PositionManager::add_position(InternalSecurityId security_id, Volume volume, DPrice price,
-                                   InternalOrderId order_id) {
+bool PositionManager::add_position(SecurityHandle handle, Volume volume, DPrice price, InternalOrderId order_id,
+                                   DValue fee) {
     (void)order_id;
-    position* pos = get_position_mut(security_id);
+    position* pos = get_position_mut(handle);
     if (!pos) {
         return false;
     }
 
-    position_lock guard(*pos);
+    tracked_position_lock guard(*shm_, *pos);
+    // 先按本笔价格补齐未覆盖的旧仓成本，再把成交额与费用计入成本
+    cover_cost(*pos, held_volume(*pos), price);
     const DValue value = (volume == 0 || price == 0) ? 0 : volume * price;
+    pos->cost_basis += value + fee;
+    pos->cost_volume += volume;
     pos->volume_buy += volume;
     pos->dvalue_buy += value;
     pos->volume_buy_traded += volume;
     pos->dvalue_buy_traded += value;
     pos->volume_available_t1 += volume;
+    traded_buy_value_ += value;
+    refresh_unrealized(*pos);
     shm_->header.last_update = now_ns();
     return true;
 }
@@ -586,9 +820,7 @@ fund_info PositionManager::get_fund_info() const {
         return fund;
     }
 
-    position& fund_pos = shm_->positions[kFundPositionIndex];
-    position_lock guard(fund_pos);
-    return load_fund_info(fund_pos);
+    return shm_->fund.working;
 }
 
 // 覆盖 FUND 行快照，供 fresh SHM 的外部加载流程使用。
@@ -602,9 +834,9 @@ bool PositionManager::overwrite_fund_info(const fund_info& fund) {
         return false;
     }
 
-    position_lock guard(*fund_pos);
     ensure_fund_identity(*fund_pos);
-    store_fund_info(*fund_pos, fund);
+    shm_->fund.working = fund;
+    positions_shm_publish_fund(*shm_);
     shm_->header.last_update = now_ns();
     return true;
 }
@@ -665,8 +897,11 @@ InternalSecurityId PositionManager::add_security(std::string_view code, std::str
 
     position& pos = shm_->positions[row_index];
     clear_position(pos);
-    pos.id.assign(security_id.view());
-    pos.name.assign(name);
+    {
+        tracked_position_lock guard(*shm_, pos);
+        pos.id.assign(security_id.view());
+        pos.name.assign(name);
+    }
 
     security_to_row_[security_id] = row_index;
 
@@ -677,4 +912,105 @@ InternalSecurityId PositionManager::add_security(std::string_view code, std::str
     return security_id;
 }
 
+bool PositionManager::load_security_rows(const std::vector<position_seed_row>& rows) {
+    if (!shm_) {
+        return false;
+    }
+
+    std::size_t count = clamp_security_count(shm_->position_count.load(std::memory_order_acquire));
+    security_to_row_.reserve(count + rows.size());
+
+    bool ok = true;
+    for (const position_seed_row& row : rows) {
+        if (row.security_id.empty()) {
+            ok = false;
+            break;
+        }
+
+        std::size_t row_index = 0;
+        auto it = security_to_row_.find(row.security_id);
+        if (it != security_to_row_.end()) {
+            row_index = it->second;
+        } else {
+            if (count >= kMaxSecurityPositions || count + kFirstSecurityPositionIndex >= kMaxPositions) {
+                ok = false;
+                break;
+            }
+            row_index = count + kFirstSecurityPositionIndex;
+            security_to_row_.emplace(row.security_id, row_index);
+            ++count;
+        }
+
+        position& pos = shm_->positions[row_index];
+        tracked_position_lock guard(*shm_, pos);
+        pos.id.assign(row.security_id.view());
+        pos.name.assign(row.name.empty() ? row.security_id.view() : row.name.view());
+        pos.available = 0;
+        pos.volume_available_t0 = row.volume_available_t0;
+        pos.volume_available_t1 = row.volume_available_t1;
+        pos.volume_buy = row.volume_buy;
+        pos.dvalue_buy = row.dvalue_buy;
+        pos.volume_buy_traded = row.volume_buy_traded;
+        pos.dvalue_buy_traded = row.dvalue_buy_traded;
+        pos.volume_sell = row.volume_sell;
+        pos.dvalue_sell = row.dvalue_sell;
+        pos.volume_sell_traded = row.volume_sell_traded;
+        pos.dvalue_sell_traded = row.dvalue_sell_traded;
+        pos.count_order = row.count_order;
+    }
+
+    // 行内容全部写完后再发布计数，读端不会看到半初始化的证券行
+    shm_->position_count.store(count, std::memory_order_release);
+    shm_->header.id.store(next_security_id(count), std::memory_order_relaxed);
+    shm_->header.last_update = now_ns();
+    return ok;
+}
+
+bool PositionManager::load_position_image(const fund_info& fund, const position* rows, std::size_t row_count,
+                                          bool roll_day) {
+    if (!shm_ || !rows || row_count < kFirstSecurityPositionIndex || row_count > kMaxPositions ||
+        rows[kFundPositionIndex].id.view() != kFundPositionId) {
+        return false;
+    }
+
+    // 先校验全部证券键再拷贝，失败时不改动 positions 行
+    std::unordered_map<InternalSecurityId, std::size_t> index;
+    index.reserve(row_count);
+    for (std::size_t row_index = kFirstSecurityPositionIndex; row_index < row_count; ++row_index) {
+        InternalSecurityId security_id;
+        if (!normalize_security_key(rows[row_index].id.view(), security_id) ||
+            security_id.view() != rows[row_index].id.view() || !index.emplace(security_id, row_index).second) {
+            return false;
+        }
+    }
+
+    // 镜像行与 position 同布局且行锁已是稳定态：逐行拷贝、按需日切并登记变更（供外部读者与持久化增量拉取），
+    // 每行只经过一次缓存
+    std::memcpy(static_cast<void*>(shm_->positions), rows, sizeof(position));
+    positions_shm_mark_changed(*shm_, shm_->positions[kFundPositionIndex]);
+    for (std::size_t row_index = kFirstSecurityPositionIndex; row_index < row_count; ++row_index) {
+        position& row = shm_->positions[row_index];
+        std::memcpy(static_cast<void*>(&row), &rows[row_index], sizeof(position));
+        if (roll_day) {
+            position_roll_day(row);
+        }
+        positions_shm_mark_changed(*shm_, row);
+    }
+    shm_->fund.working = fund;
+    if (roll_day) {
+        // 隔夜挂单不跨日，冻结资金随日切全部回到可用
+        shm_->fund.working.available += shm_->fund.working.frozen;
+        shm_->fund.working.frozen = 0;
+    }
+    positions_shm_publish_fund(*shm_);
+    security_to_row_ = std::move(index);
+    rebuild_security_code_table();
+
+    const std::size_t count = row_count - kFirstSecurityPositionIndex;
+    shm_->position_count.store(count, std::memory_order_release);
+    shm_->header.id.store(next_security_id(count), std::memory_order_relaxed);
+    shm_->header.last_update = now_ns();
+    return true;
+}
+
 }  // namespace acct_service
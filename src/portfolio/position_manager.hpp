@@ -1,11 +1,13 @@
 #pragma once
 
 #include <optional>
+#include <span>
 #include <string>
 #include <string_view>
 #include <unordered_map>
 #include <vector>
 
+#include "common/security_code_table.hpp"
 #include "common/types.hpp"
 #include "order/order_request.hpp"
 #include "portfolio/positions.h"
@@ -25,11 +27,42 @@ struct PositionChangeRecord {
     TimestampNs timestamp;
 };
 
+// 初始化加载的一行证券持仓快照，security_id 须已归一化；name 为空时行名沿用证券键。
+struct position_seed_row {
+    InternalSecurityId security_id;
+    FixedString<16> name{};
+    uint64_t volume_available_t0{0};
+    uint64_t volume_available_t1{0};
+    uint64_t volume_buy{0};
+    uint64_t dvalue_buy{0};
+    uint64_t volume_buy_traded{0};
+    uint64_t dvalue_buy_traded{0};
+    uint64_t volume_sell{0};
+    uint64_t dvalue_sell{0};
+    uint64_t volume_sell_traded{0};
+    uint64_t dvalue_sell_traded{0};
+    uint64_t count_order{0};
+};
+
+// 申报流量事件：新单、撤单、成交回报
+enum class order_flow_event : uint8_t { NewOrder, Cancel, Fill };
+
+// 申报流量计数：账户合计或单证券行
+struct order_flow_counts {
+    uint64_t orders = 0;
+    uint64_t cancels = 0;
+    uint64_t fills = 0;
+};
+
+static_assert(kMaxPositions - 1 <= UINT16_MAX, "SecurityHandle must be able to address every position row");
+
 // 持仓管理器
 class PositionManager {
 public:
-    explicit PositionManager(
-        positions_shm_layout* shm, std::string config_file_path = {}, std::string db_path = {}, bool db_enabled = false);
+    // snapshot_path 非空且文件存在时，fresh SHM 优先从二进制持仓镜像装载，否则按 db_enabled 走 DB/文件 loader。
+    // trading_day 为当前交易日（YYYYMMDD，0 表示未知）；镜像所属交易日早于它时装载同一趟内完成日切。
+    explicit PositionManager(positions_shm_layout* shm, std::string config_file_path = {}, std::string db_path = {},
+                             bool db_enabled = false, std::string snapshot_path = {}, uint32_t trading_day = 0);
     ~PositionManager() = default;
 
     // 禁止拷贝
@@ -42,6 +75,7 @@ public:
     // === 资金操作 ===
 
     DValue get_available_fund() const noexcept;
+    DValue get_frozen_fund() const noexcept;
     bool freeze_fund(DValue amount, InternalOrderId order_id);
     bool unfreeze_fund(DValue amount, InternalOrderId order_id);
     bool deduct_fund(DValue amount, DValue fee, InternalOrderId order_id);
@@ -53,15 +87,33 @@ public:
 
     // === 持仓操作 ===
 
+    // 把证券键解析为持仓行句柄；未登记返回 kInvalidSecurityHandle。启动时已登记的 canonical 键直接命中
+    // 完美哈希表，运行期新增证券或旧格式键回落到归一化 + 查表。
+    // 行一经分配不再移动，句柄在进程内长期有效，可缓存在订单上供后续调用直接下标访问。
+    SecurityHandle resolve_security_handle(InternalSecurityId security_id) const;
+
     const position* get_position(InternalSecurityId security_id) const;
     position* get_position_mut(InternalSecurityId security_id);
     Volume get_sellable_volume(InternalSecurityId security_id) const;
     bool freeze_position(InternalSecurityId security_id, Volume volume, InternalOrderId order_id);
     bool unfreeze_position(InternalSecurityId security_id, Volume volume, InternalOrderId order_id);
+    // 成交结算同时 O(1) 更新行内盈亏：买入把成交额与费用计入成本，卖出按平均成本结转已实现盈亏
     bool deduct_position(
-        InternalSecurityId security_id, Volume volume, DValue value, InternalOrderId order_id);
+        InternalSecurityId security_id, Volume volume, DValue value, InternalOrderId order_id, DValue fee = 0);
     bool add_position(
-        InternalSecurityId security_id, Volume volume, DPrice price, InternalOrderId order_id);
+        InternalSecurityId security_id, Volume volume, DPrice price, InternalOrderId order_id, DValue fee = 0);
+
+    // 句柄版本：直接下标访问 positions 行，不做字符串归一化和哈希查找
+    const position* get_position(SecurityHandle handle) const;
+    position* get_position_mut(SecurityHandle handle);
+    Volume get_sellable_volume(SecurityHandle handle) const;
+    bool freeze_position(SecurityHandle handle, Volume volume, InternalOrderId order_id);
+    bool unfreeze_position(SecurityHandle handle, Volume volume, InternalOrderId order_id);
+    bool deduct_position(SecurityHandle handle, Volume volume, DValue value, InternalOrderId order_id,
+                         DValue fee = 0);
+    bool add_position(SecurityHandle handle, Volume volume, DPrice price, InternalOrderId order_id, DValue fee = 0);
+    // 预取持仓行（写意图）：批量处理回报时提前发起，句柄无效时忽略；只算地址，不读行内容
+    void prefetch_position(SecurityHandle handle) const noexcept;
 
     // === 查询接口 ===
     std::vector<const position*> get_all_positions() const;
@@ -69,15 +121,50 @@ public:
     // 覆盖 FUND 行快照（仅用于初始化加载）。
     bool overwrite_fund_info(const fund_info& fund);
     std::size_t position_count() const noexcept;
+    // 当日买卖成交额合计：成交结算时增量累加，启动时从 positions 行一次性重建
+    DValue traded_turnover() const noexcept { return traded_buy_value_ + traded_sell_value_; }
+    // 扫描全部证券行重建当日成交额与申报流量累计（直接改写 positions 行的加载路径需显式调用）
+    void rebuild_turnover_totals() noexcept;
+    // 申报流量：按证券行累加 count_order / count_cancel / count_fill，账户合计同步增量维护，O(1)；
+    // 句柄无效时只计入账户合计
+    void record_order_flow(SecurityHandle handle, order_flow_event event, uint64_t count = 1);
+    const order_flow_counts& order_flow_totals() const noexcept { return order_flow_totals_; }
+    // 单证券申报流量，句柄无效时全 0
+    order_flow_counts order_flow(SecurityHandle handle) const noexcept;
+    // 盯市：marks 按物理行号给出价格（0 表示该行无价，保留上次结果），刷新各行 mark_price / unrealized_pnl。
+    // 先把持仓、成本抽成连续数组做无分支批量计算，再只回写结果有变化的行；返回回写行数
+    std::size_t mark_to_market(std::span<const DPrice> marks);
     std::optional<InternalSecurityId> find_security_id(std::string_view code) const;
     InternalSecurityId add_security(std::string_view code, std::string_view name, Market market);
+    // 批量写入初始化快照：一次预留索引、逐行填充后只发布一次 position_count；重复证券按后出现行覆盖。
+    // 行数超出持仓容量或证券键非法时返回 false，已写入的行保留（fresh SHM 初始化失败会整体放弃）。
+    bool load_security_rows(const std::vector<position_seed_row>& rows);
+    // 整段装载二进制镜像：资金块 + 行（第 0 行为 FUND 标识行），一次拷入 positions 后重建证券索引；
+    // 证券键非规范或重复时返回 false。roll_day 为 true 时拷贝的同一趟内对证券行做日切（position_roll_day），
+    // 资金冻结一并释放回可用。
+    bool load_position_image(const fund_info& fund, const position* rows, std::size_t row_count,
+                             bool roll_day = false);
 
 private:
+    // 以当前证券索引重建完美哈希表（启动装载完成、整段替换索引后调用）
+    void rebuild_security_code_table();
+
     positions_shm_layout* shm_;
     std::unordered_map<InternalSecurityId, std::size_t> security_to_row_;
+    security_code_table security_codes_;  // 启动期证券键 -> 句柄，只读
     std::string config_file_path_;
     std::string db_path_;
     bool db_enabled_{false};
+    std::string snapshot_path_;
+    uint32_t trading_day_{0};
+    DValue traded_buy_value_{0};
+    DValue traded_sell_value_{0};
+    order_flow_counts order_flow_totals_{};
+    // 盯市批量计算的列缓冲，按行号下标，首次盯市时按持仓行数分配
+    std::vector<uint64_t> mark_held_;
+    std::vector<uint64_t> mark_cost_;
+    std::vector<uint64_t> mark_cost_volume_;
+    std::vector<int64_t> mark_pnl_;
 };
 
 }  // namespace acct_service
@@ -0,0 +1,282 @@
+#include "portfolio/position_persister.hpp"
+
+#include <string_view>
+
+#include "common/error.hpp"
+#include "common/log.hpp"
+#include "common/security_identity.hpp"
+#include "portfolio/positions.h"
+#include "shm/positions_shm.hpp"
+#include "third_party/sqlite3/sqlite3_shim.hpp"
+
+namespace acct_service {
+
+namespace {
+
+constexpr uint32_t kSnapshotReadAttempts = 32;
+
+constexpr std::string_view kFundUpdateSql =
+    "UPDATE account_info SET total_assets = ?1, available_cash = ?2, frozen_cash = ?3, position_value = ?4, "
+    "updated_at = CURRENT_TIMESTAMP WHERE account_id = ?5;";
+constexpr std::string_view kPositionUpdateSql =
+    "UPDATE positions SET volume_available_t0 = ?3, volume_available_t1 = ?4, volume_buy = ?5, dvalue_buy = ?6, "
+    "volume_buy_traded = ?7, dvalue_buy_traded = ?8, volume_sell = ?9, dvalue_sell = ?10, "
+    "volume_sell_traded = ?11, dvalue_sell_traded = ?12, count_order = ?13, updated_at = CURRENT_TIMESTAMP "
+    "WHERE internal_security_id = ?2;";
+// 与 UPDATE 共用参数编号；库中尚无该证券行时才插入，旧格式证券键的行由加载时的“后出现行覆盖”收敛。
+constexpr std::string_view kPositionInsertSql =
+    "INSERT INTO positions(security_id, internal_security_id, volume_available_t0, volume_available_t1, "
+    "volume_buy, dvalue_buy, volume_buy_traded, dvalue_buy_traded, volume_sell, dvalue_sell, "
+    "volume_sell_traded, dvalue_sell_traded, count_order) "
+    "SELECT ?1, ?2, ?3, ?4, ?5, ?6, ?7, ?8, ?9, ?10, ?11, ?12, ?13 "
+    "WHERE NOT EXISTS (SELECT 1 FROM positions WHERE internal_security_id = ?2);";
+
+bool report_persister_error(std::string_view message) {
+    ErrorStatus status =
+        ACCT_MAKE_ERROR(ErrorDomain::portfolio, ErrorCode::ComponentUnavailable, "position_persister", message, 0);
+    record_error(status);
+    ACCT_LOG_ERROR_STATUS(status);
+    return false;
+}
+
+bool prepare(sqlite3* db, std::string_view sql, sqlite3_stmt*& out) {
+    out = nullptr;
+    if (sqlite3_prepare_v2(db, sql.data(), static_cast<int>(sql.size()), &out, nullptr) != SQLITE_OK || !out) {
+        if (out) {
+            sqlite3_finalize(out);
+            out = nullptr;
+        }
+        return false;
+    }
+    return true;
+}
+
+bool exec_statement(sqlite3* db, const char* sql) {
+    char* err_msg = nullptr;
+    const int rc = sqlite3_exec(db, sql, nullptr, nullptr, &err_msg);
+    if (err_msg != nullptr) {
+        sqlite3_free(err_msg);
+    }
+    return rc == SQLITE_OK;
+}
+
+bool bind_u64(sqlite3_stmt* stmt, int index, uint64_t value) {
+    return sqlite3_bind_int64(stmt, index, static_cast<sqlite3_int64>(value)) == SQLITE_OK;
+}
+
+// 执行一次预编译语句并复位，供同一事务内逐行复用。
+bool step_and_reset(sqlite3_stmt* stmt) {
+    const int rc = sqlite3_step(stmt);
+    sqlite3_reset(stmt);
+    return rc == SQLITE_DONE;
+}
+
+}  // namespace
+
+position_persister::~position_persister() { stop(); }
+
+bool position_persister::start(const std::string& db_path, AccountId account_id, const positions_shm_layout* shm,
+                               uint32_t sync_interval_ms) {
+    stop();
+    if (db_path.empty() || !shm || sync_interval_ms == 0) {
+        return report_persister_error("position persister requires db path, positions shm and sync interval");
+    }
+
+    // 只打开已有库：表结构由持仓快照加载同一份数据库提供，不在此建表
+    if (sqlite3_open_v2(db_path.c_str(), &db_, SQLITE_OPEN_READWRITE, nullptr) != SQLITE_OK || !db_) {
+        close_db();
+        return report_persister_error("failed to open sqlite db for position persistence");
+    }
+    if (!prepare(db_, kFundUpdateSql, fund_update_) || !prepare(db_, kPositionUpdateSql, position_update_) ||
+        !prepare(db_, kPositionInsertSql, position_insert_)) {
+        close_db();
+        return report_persister_error("failed to prepare position persistence statements");
+    }
+
+    account_id_ = account_id;
+    shm_ = shm;
+    interval_ = std::chrono::milliseconds(sync_interval_ms);
+    cursor_ = 0;
+    changed_rows_.assign(kMaxPositions, 0);
+    staged_.clear();
+    staged_.reserve(kMaxPositions);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_requested_ = false;
+    }
+    thread_ = std::thread([this]() { persister_loop(); });
+    return true;
+}
+
+void position_persister::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_requested_ = true;
+    }
+    cv_.notify_all();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+    close_db();
+}
+
+void position_persister::close_db() noexcept {
+    for (sqlite3_stmt** stmt : {&fund_update_, &position_update_, &position_insert_}) {
+        if (*stmt) {
+            sqlite3_finalize(*stmt);
+            *stmt = nullptr;
+        }
+    }
+    if (db_) {
+        sqlite3_close(db_);
+        db_ = nullptr;
+    }
+}
+
+// 等待间隔到期或停止请求；停止时仍做最后一轮同步再退出。
+void position_persister::persister_loop() {
+    for (;;) {
+        bool stopping = false;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            cv_.wait_for(lock, interval_, [this]() { return stop_requested_; });
+            stopping = stop_requested_;
+        }
+        if (!sync_once()) {
+            failed_.fetch_add(1, std::memory_order_relaxed);
+        }
+        if (stopping) {
+            return;
+        }
+    }
+}
+
+bool position_persister::sync_once() {
+    // version 回退说明持仓池已重建，从头收集
+    if (shm_->changes.version.load(std::memory_order_acquire) < cursor_) {
+        cursor_ = 0;
+    }
+    uint64_t next_cursor = cursor_;
+    const std::size_t count =
+        positions_shm_collect_changed(*shm_, cursor_, changed_rows_.data(), changed_rows_.size(), next_cursor);
+    if (count == 0) {
+        cursor_ = next_cursor;
+        return true;
+    }
+
+    // 同一行两次同步之间的多次变更只剩最后一个戳，这里读到的就是合并后的最新值
+    staged_.clear();
+    for (std::size_t i = 0; i < count; ++i) {
+        row_snapshot snapshot;
+        if (!snapshot_row(changed_rows_[i], snapshot)) {
+            ACCT_LOG_WARN("position_persister", "position row unstable during sync, retry next interval");
+            return false;
+        }
+        if (snapshot.row_index != kFundPositionIndex && snapshot.security_id.empty()) {
+            continue;
+        }
+        staged_.push_back(snapshot);
+    }
+
+    if (!write_rows()) {
+        ACCT_LOG_WARN("position_persister", "failed to write dirty position rows, retry next interval");
+        return false;
+    }
+    cursor_ = next_cursor;
+    syncs_.fetch_add(1, std::memory_order_relaxed);
+    synced_rows_.fetch_add(staged_.size(), std::memory_order_relaxed);
+    return true;
+}
+
+// 按行 seqlock 抓取稳定快照；账户线程在写区间内时短暂重试。
+bool position_persister::snapshot_row(uint32_t row_index, row_snapshot& out) const {
+    if (row_index >= kMaxPositions) {
+        return false;
+    }
+    row_snapshot snapshot;
+    snapshot.row_index = row_index;
+    if (row_index == kFundPositionIndex) {
+        // 资金在独立 fund_row 中发布，第 0 行的变更戳即资金变更
+        fund_info fund;
+        for (uint32_t attempt = 0; attempt < kSnapshotReadAttempts; ++attempt) {
+            if (positions_shm_try_read_fund(*shm_, fund)) {
+                snapshot.total_asset = fund.total_asset;
+                snapshot.available = fund.available;
+                snapshot.frozen = fund.frozen;
+                snapshot.market_value = fund.market_value;
+                out = snapshot;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    const position& row = shm_->positions[row_index];
+    for (uint32_t attempt = 0; attempt < kSnapshotReadAttempts; ++attempt) {
+        const bool stable = position_try_read(row, [&](const position& current) {
+            snapshot.security_id.assign(current.id.view());
+            snapshot.volume_available_t0 = current.volume_available_t0;
+            snapshot.volume_available_t1 = current.volume_available_t1;
+            snapshot.volume_buy = current.volume_buy;
+            snapshot.dvalue_buy = current.dvalue_buy;
+            snapshot.volume_buy_traded = current.volume_buy_traded;
+            snapshot.dvalue_buy_traded = current.dvalue_buy_traded;
+            snapshot.volume_sell = current.volume_sell;
+            snapshot.dvalue_sell = current.dvalue_sell;
+            snapshot.volume_sell_traded = current.volume_sell_traded;
+            snapshot.dvalue_sell_traded = current.dvalue_sell_traded;
+            snapshot.count_order = current.count_order;
+        });
+        if (stable) {
+            out = snapshot;
+            return true;
+        }
+    }
+    return false;
+}
+
+// 一批脏行写在同一事务里：任一行失败整体回滚，库中不会出现半轮同步的状态。
+bool position_persister::write_rows() {
+    if (!exec_statement(db_, "BEGIN IMMEDIATE;")) {
+        return false;
+    }
+
+    bool ok = true;
+    for (const row_snapshot& row : staged_) {
+        if (row.row_index == kFundPositionIndex) {
+            ok = bind_u64(fund_update_, 1, row.total_asset) && bind_u64(fund_update_, 2, row.available) &&
+                 bind_u64(fund_update_, 3, row.frozen) && bind_u64(fund_update_, 4, row.market_value) &&
+                 bind_u64(fund_update_, 5, account_id_) && step_and_reset(fund_update_);
+        } else {
+            Market market = Market::NotSet;
+            std::string_view code;
+            if (!parse_internal_security_id(row.security_id.view(), market, code)) {
+                continue;
+            }
+            for (sqlite3_stmt* stmt : {position_update_, position_insert_}) {
+                ok = ok &&
+                     sqlite3_bind_text(stmt, 1, code.data(), static_cast<int>(code.size()), SQLITE_TRANSIENT) ==
+                         SQLITE_OK &&
+                     sqlite3_bind_text(stmt, 2, row.security_id.c_str(), static_cast<int>(row.security_id.size()),
+                                       SQLITE_TRANSIENT) == SQLITE_OK &&
+                     bind_u64(stmt, 3, row.volume_available_t0) && bind_u64(stmt, 4, row.volume_available_t1) &&
+                     bind_u64(stmt, 5, row.volume_buy) && bind_u64(stmt, 6, row.dvalue_buy) &&
+                     bind_u64(stmt, 7, row.volume_buy_traded) && bind_u64(stmt, 8, row.dvalue_buy_traded) &&
+                     bind_u64(stmt, 9, row.volume_sell) && bind_u64(stmt, 10, row.dvalue_sell) &&
+                     bind_u64(stmt, 11, row.volume_sell_traded) && bind_u64(stmt, 12, row.dvalue_sell_traded) &&
+                     bind_u64(stmt, 13, row.count_order) && step_and_reset(stmt);
+            }
+        }
+        if (!ok) {
+            break;
+        }
+    }
+
+    if (!ok) {
+        exec_statement(db_, "ROLLBACK;");
+        return false;
+    }
+    return exec_statement(db_, "COMMIT;");
+}
+
+}  // namespace acct_service
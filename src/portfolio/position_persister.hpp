@@ -0,0 +1,92 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "common/types.hpp"
+#include "shm/shm_layout.hpp"
+
+struct sqlite3;
+struct sqlite3_stmt;
+
+namespace acct_service {
+
+// 持仓 write-behind 持久化：后台线程每 sync_interval_ms 按 positions_shm 变更戳收集脏行，
+// 合并成一个事务写回 SQLite（account_info 资金行 + positions 证券行）。
+// 事件循环侧只有持仓写区间里原有的打戳，不做任何额外工作。
+class position_persister {
+public:
+    position_persister() = default;
+    ~position_persister();
+
+    position_persister(const position_persister&) = delete;
+    position_persister& operator=(const position_persister&) = delete;
+
+    // 以读写方式打开已有数据库（表结构与 position_loader 读取的相同），预编译语句后启动后台线程。
+    bool start(const std::string& db_path, AccountId account_id, const positions_shm_layout* shm,
+               uint32_t sync_interval_ms);
+    // 停止前再同步一次，正常退出时不丢尾部变更。
+    void stop();
+
+    uint64_t sync_count() const noexcept { return syncs_.load(std::memory_order_relaxed); }
+    uint64_t synced_rows() const noexcept { return synced_rows_.load(std::memory_order_relaxed); }
+    uint64_t failed_count() const noexcept { return failed_.load(std::memory_order_relaxed); }
+
+private:
+    // 持仓行的稳定快照；row_index 为 0 时为资金行，只使用资金字段。
+    struct row_snapshot {
+        uint32_t row_index = 0;
+        InternalSecurityId security_id;
+        uint64_t total_asset = 0;
+        uint64_t available = 0;
+        uint64_t frozen = 0;
+        uint64_t market_value = 0;
+        uint64_t volume_available_t0 = 0;
+        uint64_t volume_available_t1 = 0;
+        uint64_t volume_buy = 0;
+        uint64_t dvalue_buy = 0;
+        uint64_t volume_buy_traded = 0;
+        uint64_t dvalue_buy_traded = 0;
+        uint64_t volume_sell = 0;
+        uint64_t dvalue_sell = 0;
+        uint64_t volume_sell_traded = 0;
+        uint64_t dvalue_sell_traded = 0;
+        uint64_t count_order = 0;
+    };
+
+    void persister_loop();
+    // 收集并写回自上次游标以来的脏行；失败时游标不动，下一轮整体重试。
+    bool sync_once();
+    bool snapshot_row(uint32_t row_index, row_snapshot& out) const;
+    bool write_rows();
+    void close_db() noexcept;
+
+    AccountId account_id_ = 0;
+    const positions_shm_layout* shm_ = nullptr;
+    std::chrono::milliseconds interval_{1000};
+    uint64_t cursor_ = 0;
+    std::vector<uint32_t> changed_rows_;
+    std::vector<row_snapshot> staged_;
+
+    sqlite3* db_ = nullptr;
+    sqlite3_stmt* fund_update_ = nullptr;
+    sqlite3_stmt* position_update_ = nullptr;
+    sqlite3_stmt* position_insert_ = nullptr;
+
+    std::atomic<uint64_t> syncs_{0};
+    std::atomic<uint64_t> synced_rows_{0};
+    std::atomic<uint64_t> failed_{0};
+
+    bool stop_requested_ = false;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::thread thread_;
+};
+
+}  // namespace acct_service
@@ -3,7 +3,7 @@
 #include <atomic>
 #include <cstddef>
 #include <cstdint>
-#include <thread>
+#include <cstring>
 
 #include "common/fixed_string.hpp"
 
@@ -12,24 +12,79 @@ inline constexpr std::size_t kFirstSecurityPositionIndex = 1;
 inline constexpr const char* kFundPositionId = "FUND";
 
 // 统一持仓结构：positions[0]=资金行，positions[1..position_count]=证券行
-struct position {
-    std::atomic<uint8_t> locked{0};  // 单行锁（股票行用）
+// v7 起每行按缓存行对齐：首行放行锁与下单热路径读写的数量字段，金额/计数次之，名称放在尾部冷区，
+// 相邻行不再共享缓存行，账户线程写第 N 行不会打断监控读第 N+1 行。
+struct alignas(64) position {
+    // 缓存行 0：行锁 + 热字段
+    std::atomic<uint32_t> seq{0};    // 行 seqlock：偶数=稳定，奇数=写入中（账户线程为唯一写者）
+    uint32_t reserved0{0};
     uint64_t available{0};           // 可用资金 (用于 positions[0])
     uint64_t volume_available_t0{0}; // t0交易可用数量
     uint64_t volume_available_t1{0}; // t1交易可用数量（当日成交买量，每日初始化时为0，当日重启初始为volume_buy）
     uint64_t volume_buy{0};          // 今日买量
-    uint64_t dvalue_buy{0};          // 今日买额
+    uint64_t volume_sell{0};         // 今日卖量
     uint64_t volume_buy_traded{0};   // 今日买成交量
+    uint64_t volume_sell_traded{0};  // 今日卖成交量
+    // 缓存行 1：金额与计数
+    uint64_t dvalue_buy{0};          // 今日买额
     uint64_t dvalue_buy_traded{0};   // 今日买成交额
-    uint64_t volume_sell{0};         // 今日卖量
     uint64_t dvalue_sell{0};         // 今日卖额
-    uint64_t volume_sell_traded{0};  // 今日卖成交量
     uint64_t dvalue_sell_traded{0};  // 今日卖成交额
     uint64_t count_order{0};         // 累计订单数量
+    // 盈亏（占用原预留位，布局与版本不变；旧进程写出的段读作 0）：成交结算时 O(1) 增量维护，移动加权平均成本
+    uint64_t cost_basis{0};          // 持仓成本（含买入费用），对应 cost_volume 股
+    uint64_t cost_volume{0};         // 已计入成本的持仓数量；不足持仓时差额按首次观察到的价格补记
+    int64_t realized_pnl{0};         // 已实现盈亏 = 卖出净额 - 卖出部分的平均成本
+    // 缓存行 2：冷区
     FixedString<16> id{};  // 资金:"FUND", 股票:"000001"等
     FixedString<16> name{}; // 名称：market.code
+    int64_t unrealized_pnl{0};       // 浮动盈亏 = 持仓 * mark_price - cost_basis，由周期盯市刷新
+    uint64_t mark_price{0};          // 最近一次盯市价格，0 表示尚未盯市
+    // 申报流量（占用原预留位）：与 count_order 一起由事件循环 O(1) 累加，重启沿用 SHM 中的值
+    uint64_t count_cancel{0};        // 累计撤单笔数
+    uint64_t count_fill{0};          // 累计成交回报笔数（含部分成交）
+};
+
+static_assert(sizeof(position) == 192, "position row must span exactly three cache lines");
+static_assert(offsetof(position, volume_sell_traded) + sizeof(uint64_t) <= 64, "hot fields must stay in line 0");
+static_assert(offsetof(position, id) == 128, "names must live in the cold tail");
+static_assert(offsetof(position, volume_sell_traded) - offsetof(position, volume_available_t1) == 4 * sizeof(uint64_t),
+              "line 0 daily fields must stay contiguous for the day roll");
+static_assert(offsetof(position, count_order) - offsetof(position, dvalue_buy) == 4 * sizeof(uint64_t),
+              "line 1 daily fields must stay contiguous for the day roll");
+
+// 证券行日切：未成交卖出冻结与昨日买入一并转入可卖，清零当日买卖量额与申报流量；成本、盈亏、盯市价与名称保留。
+// 两段当日字段各是行内连续的 5 个 u64，清零走定长 memset，行按缓存行对齐，编译器展开为整段向量存储；
+// 由 fresh SHM 装载在发布 position_count 前逐行调用，与镜像拷贝共用一趟遍历
+inline void position_roll_day(position &row) noexcept {
+    row.volume_available_t0 += row.volume_available_t1 + row.volume_sell;
+    std::memset(&row.volume_available_t1, 0, 5 * sizeof(uint64_t));
+    std::memset(&row.dvalue_buy, 0, 5 * sizeof(uint64_t));
+    row.count_cancel = 0;
+    row.count_fill = 0;
+}
+
+// v6 行布局（136 字节，无对齐）：仅供监控 API 读取旧版账户服务创建的共享内存，账户服务不再写出。
+struct position_v6 {
+    std::atomic<uint32_t> seq{0};
+    uint64_t available{0};
+    uint64_t volume_available_t0{0};
+    uint64_t volume_available_t1{0};
+    uint64_t volume_buy{0};
+    uint64_t dvalue_buy{0};
+    uint64_t volume_buy_traded{0};
+    uint64_t dvalue_buy_traded{0};
+    uint64_t volume_sell{0};
+    uint64_t dvalue_sell{0};
+    uint64_t volume_sell_traded{0};
+    uint64_t dvalue_sell_traded{0};
+    uint64_t count_order{0};
+    FixedString<16> id{};
+    FixedString<16> name{};
 };
 
+static_assert(sizeof(position_v6) == 136, "position_v6 layout is frozen");
+
 // 资金结构
 struct fund_info {
     uint64_t total_asset{0};   // 总资产 (分)
@@ -38,50 +93,61 @@ struct fund_info {
     uint64_t market_value{0};  // 持仓市值 (分)
 };
 
-inline uint64_t& fund_total_asset_field(position& fund_row) { return fund_row.volume_available_t0; }
-inline const uint64_t& fund_total_asset_field(const position& fund_row) { return fund_row.volume_available_t0; }
-
-inline uint64_t& fund_available_field(position& fund_row) { return fund_row.available; }
-inline const uint64_t& fund_available_field(const position& fund_row) { return fund_row.available; }
-
-inline uint64_t& fund_frozen_field(position& fund_row) { return fund_row.volume_available_t1; }
-inline const uint64_t& fund_frozen_field(const position& fund_row) { return fund_row.volume_available_t1; }
+// FUND 资金块：账户线程在工作副本上读改写，每次变更后经 seqlock 发布到独立缓存行上的读者快照。
+// 监控、持久化只读 published，写者热路径的读改写不会因读者访问而失效缓存行。
+struct alignas(64) fund_row {
+    // 缓存行 0：账户线程独占
+    fund_info working{};
+    uint64_t reserved0[4]{};
+    // 缓存行 1：读者快照（seqlock 保护）
+    std::atomic<uint32_t> seq{0};
+    uint32_t reserved1{0};
+    fund_info published{};
+    uint64_t reserved2[3]{};
+};
 
-inline uint64_t& fund_market_value_field(position& fund_row) { return fund_row.volume_buy; }
-inline const uint64_t& fund_market_value_field(const position& fund_row) { return fund_row.volume_buy; }
+static_assert(sizeof(fund_row) == 128, "fund_row must span exactly two cache lines");
+static_assert(offsetof(fund_row, seq) == 64, "fund_row reader snapshot must start on its own cache line");
 
-inline fund_info load_fund_info(const position& fund_row) {
+// v6/v7 布局中资金字段复用 FUND 行的证券列，仅供监控读取旧版共享内存
+template <typename Row>
+inline fund_info load_legacy_fund_info(const Row& fund_row) {
     fund_info fund;
-    fund.total_asset = fund_total_asset_field(fund_row);
-    fund.available = fund_available_field(fund_row);
-    fund.frozen = fund_frozen_field(fund_row);
-    fund.market_value = fund_market_value_field(fund_row);
+    fund.total_asset = fund_row.volume_available_t0;
+    fund.available = fund_row.available;
+    fund.frozen = fund_row.volume_available_t1;
+    fund.market_value = fund_row.volume_buy;
     return fund;
 }
 
-inline void store_fund_info(position& fund_row, const fund_info& fund) {
-    fund_total_asset_field(fund_row) = fund.total_asset;
-    fund_available_field(fund_row) = fund.available;
-    fund_frozen_field(fund_row) = fund.frozen;
-    fund_market_value_field(fund_row) = fund.market_value;
-}
-
-// 资金行 atomic 访问（用于 positions[0]）
-inline std::atomic<uint64_t> &fund_atomic(uint64_t &field) {
-    return *reinterpret_cast<std::atomic<uint64_t> *>(&field);
-}
-
-// 单行锁（实盘股票行用，RAII）
+// 单行写区间（RAII）：账户线程是持仓行唯一写者，写入前后推进 seq，外部读者按奇偶重试，写者从不等待。
+// 不可嵌套；进程异常退出残留的奇数 seq 在下一次写入时自动对齐。
 struct position_lock {
-    std::atomic<uint8_t> &f;
-    position_lock(position &p) : f(p.locked) {
-        while (f.exchange(1, std::memory_order_acquire)) std::this_thread::yield();
+    std::atomic<uint32_t> &seq;
+    uint32_t start;
+    position_lock(position &p) : position_lock(p.seq) {}
+    explicit position_lock(std::atomic<uint32_t> &row_seq)
+        : seq(row_seq), start(seq.load(std::memory_order_relaxed) | 1U) {
+        seq.store(start, std::memory_order_relaxed);  // odd: write in progress
+        std::atomic_thread_fence(std::memory_order_release);
     }
-    ~position_lock() { f.store(0, std::memory_order_release); }
+    ~position_lock() { seq.store(start + 1, std::memory_order_release); }  // even: publish
     position_lock(const position_lock &) = delete;
     position_lock &operator=(const position_lock &) = delete;
 };
 
+// 外部读者的稳定快照：seq 前后一致且为偶数时返回 true，否则调用方重试（position、position_v6 与 fund_row 通用）
+template <typename Row, typename Reader>
+inline bool position_try_read(const Row &p, Reader &&reader) {
+    const uint32_t seq0 = p.seq.load(std::memory_order_acquire);
+    if ((seq0 & 1U) != 0U) {
+        return false;
+    }
+    reader(p);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return p.seq.load(std::memory_order_relaxed) == seq0;
+}
+
 inline std::size_t positions_bytes(std::size_t capacity) { return capacity * sizeof(position); }
 
 inline std::size_t positions_capacity(std::size_t file_size) { return file_size / sizeof(position); }
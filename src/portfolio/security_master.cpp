@@ -0,0 +1,219 @@
+#include "portfolio/security_master.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <fstream>
+#include <string_view>
+#include <utility>
+
+#include "common/log.hpp"
+#include "common/security_code_table.hpp"
+#include "common/security_identity.hpp"
+#include "common/time_utils.hpp"
+
+namespace acct_service {
+
+namespace {
+
+constexpr const char* kLogModule = "security_master";
+constexpr std::size_t kSecurityMasterColumns = 7;
+
+std::string_view trim_view(std::string_view value) {
+    const auto not_space = [](unsigned char ch) { return ch != ' ' && ch != '\t' && ch != '\r' && ch != '\n'; };
+    while (!value.empty() && !not_space(static_cast<unsigned char>(value.front()))) {
+        value.remove_prefix(1);
+    }
+    while (!value.empty() && !not_space(static_cast<unsigned char>(value.back()))) {
+        value.remove_suffix(1);
+    }
+    return value;
+}
+
+template <typename T>
+bool parse_unsigned(std::string_view text, T& out) {
+    const std::string_view trimmed = trim_view(text);
+    if (trimmed.empty()) {
+        out = 0;
+        return true;
+    }
+    const auto [end, ec] = std::from_chars(trimmed.data(), trimmed.data() + trimmed.size(), out);
+    return ec == std::errc{} && end == trimmed.data() + trimmed.size();
+}
+
+// 按逗号切分，返回列数；超过 max_columns 的列被忽略
+std::size_t split_columns(std::string_view line, std::string_view* columns, std::size_t max_columns) {
+    std::size_t count = 0;
+    while (count < max_columns) {
+        const std::size_t comma = line.find(',');
+        columns[count++] = trim_view(line.substr(0, comma));
+        if (comma == std::string_view::npos) {
+            break;
+        }
+        line.remove_prefix(comma + 1);
+    }
+    return count;
+}
+
+bool parse_security_row(const std::string_view* columns, std::size_t count, security_master_record& out) {
+    if (count < kSecurityMasterColumns) {
+        return false;
+    }
+    if (!normalize_internal_security_id(columns[1], out.internal_security_id)) {
+        return false;
+    }
+    out.name.assign(columns[2]);
+    return parse_unsigned(columns[3], out.limit_up) && parse_unsigned(columns[4], out.limit_down) &&
+           parse_unsigned(columns[5], out.lot_size) && parse_unsigned(columns[6], out.fee_class);
+}
+
+bool same_key(const security_master_slot& slot, const security_code_table::packed_key& key) noexcept {
+    return slot.key_lo == key.lo && slot.key_hi == key.hi;
+}
+
+}  // namespace
+
+bool load_security_master_csv(const std::string& path, std::vector<security_master_record>& out) {
+    out.clear();
+    std::ifstream in(path);
+    if (!in.is_open()) {
+        ACCT_LOG_ERROR(kLogModule, "failed to open security master csv: " + path);
+        return false;
+    }
+
+    std::string line;
+    std::string_view columns[kSecurityMasterColumns];
+    while (std::getline(in, line)) {
+        std::string_view text(line);
+        const std::size_t comment_pos = text.find('#');
+        if (comment_pos != std::string_view::npos) {
+            text = text.substr(0, comment_pos);
+        }
+        text = trim_view(text);
+        if (text.empty()) {
+            continue;
+        }
+        const std::size_t count = split_columns(text, columns, kSecurityMasterColumns);
+        if (columns[0] == "record_type") {
+            continue;
+        }
+        security_master_record record;
+        if (columns[0] != "security" || !parse_security_row(columns, count, record)) {
+            ACCT_LOG_ERROR(kLogModule, "failed to parse security master csv row");
+            return false;
+        }
+        out.push_back(std::move(record));
+    }
+    return true;
+}
+
+bool publish_security_master(security_master_shm_layout& shm, const std::vector<security_master_record>& records,
+                             uint32_t trading_day) {
+    if (records.size() > kSecurityMasterCapacity) {
+        ACCT_LOG_ERROR(kLogModule, "security master exceeds capacity");
+        return false;
+    }
+
+    std::vector<std::pair<InternalSecurityId, SecurityHandle>> keys;
+    keys.reserve(records.size());
+    for (std::size_t i = 0; i < records.size(); ++i) {
+        keys.emplace_back(records[i].internal_security_id, static_cast<SecurityHandle>(i + 1));
+    }
+    security_code_table table;
+    const bool indexed = table.build(keys);
+    if (!indexed) {
+        // 重复键导致构造失败时拒绝发布；其余失败（位移搜索）只放弃索引
+        std::vector<InternalSecurityId> sorted;
+        sorted.reserve(records.size());
+        for (const security_master_record& record : records) {
+            sorted.push_back(record.internal_security_id);
+        }
+        std::sort(sorted.begin(), sorted.end());
+        if (std::adjacent_find(sorted.begin(), sorted.end()) != sorted.end()) {
+            ACCT_LOG_ERROR(kLogModule, "duplicate security in security master");
+            return false;
+        }
+        ACCT_LOG_WARN(kLogModule, "security master index build failed, readers fall back to linear scan");
+    }
+
+    shm.ready.store(0, std::memory_order_release);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    for (std::size_t i = 0; i < records.size(); ++i) {
+        const security_master_record& record = records[i];
+        security_master_entry& entry = shm.entries[i];
+        entry = security_master_entry{};
+        entry.internal_security_id = record.internal_security_id;
+        entry.name.assign(record.name.empty() ? record.internal_security_id.view() : std::string_view(record.name));
+        entry.limit_up = record.limit_up;
+        entry.limit_down = record.limit_down;
+        entry.lot_size = record.lot_size;
+        entry.fee_class = record.fee_class;
+        std::string_view code;
+        (void)parse_internal_security_id(record.internal_security_id.view(), entry.market, code);
+    }
+
+    std::memset(shm.displacements, 0, sizeof(shm.displacements));
+    std::memset(static_cast<void*>(shm.slots), 0, sizeof(shm.slots));
+    shm.slot_count = 0;
+    shm.bucket_count = 0;
+    if (indexed && table.slot_count() > 0) {
+        std::copy_n(table.displacements(), table.bucket_count(), shm.displacements);
+        const security_code_table::slot_entry* slots = table.slots();
+        for (std::size_t i = 0; i < table.slot_count(); ++i) {
+            shm.slots[i].key_lo = slots[i].lo;
+            shm.slots[i].key_hi = slots[i].hi;
+            shm.slots[i].entry_plus_one = slots[i].handle;
+        }
+        shm.slot_count = static_cast<uint32_t>(table.slot_count());
+        shm.bucket_count = static_cast<uint32_t>(table.bucket_count());
+    }
+
+    shm.entry_count = static_cast<uint32_t>(records.size());
+    shm.trading_day = trading_day;
+    shm.publish_ns = now_ns();
+    shm.ready.store(1, std::memory_order_release);
+    ACCT_LOG_INFO(kLogModule, "security master published: " + std::to_string(records.size()) + " securities");
+    return true;
+}
+
+bool security_master_ready(const security_master_shm_layout& shm, uint32_t trading_day) noexcept {
+    return shm.ready.load(std::memory_order_acquire) == 1 && shm.trading_day == trading_day;
+}
+
+const security_master_entry* security_master_find(const security_master_shm_layout& shm,
+                                                  const InternalSecurityId& security_id) noexcept {
+    const security_code_table::packed_key key = security_code_table::pack_key(security_id);
+    const std::size_t entry_count = std::min<std::size_t>(shm.entry_count, kSecurityMasterCapacity);
+    if (shm.slot_count == 0) {
+        for (std::size_t i = 0; i < entry_count; ++i) {
+            if (shm.entries[i].internal_security_id == security_id) {
+                return &shm.entries[i];
+            }
+        }
+        return nullptr;
+    }
+
+    const uint64_t hash = security_code_table::hash_key(key);
+    const uint32_t displacement = shm.displacements[hash & (shm.bucket_count - 1)];
+    const security_master_slot& slot =
+        shm.slots[security_code_table::slot_index(hash, displacement, shm.slot_count - 1)];
+    if (slot.entry_plus_one == 0 || slot.entry_plus_one > entry_count || !same_key(slot, key)) {
+        return nullptr;
+    }
+    return &shm.entries[slot.entry_plus_one - 1];
+}
+
+void security_master_price_limits(const security_master_shm_layout& shm, std::vector<price_limit_entry>& out) {
+    out.clear();
+    const std::size_t entry_count = std::min<std::size_t>(shm.entry_count, kSecurityMasterCapacity);
+    for (std::size_t i = 0; i < entry_count; ++i) {
+        const security_master_entry& entry = shm.entries[i];
+        if (entry.limit_up == 0 && entry.limit_down == 0) {
+            continue;
+        }
+        out.push_back(price_limit_entry{entry.internal_security_id, entry.limit_up, entry.limit_down});
+    }
+}
+
+}  // namespace acct_service
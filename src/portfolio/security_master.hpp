@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "common/types.hpp"
+#include "portfolio/position_loader.hpp"
+#include "shm/shm_layout.hpp"
+
+namespace acct_service {
+
+// 证券主数据行：发布进程从 CSV 读入后整表写进 security_master_shm
+struct security_master_record {
+    InternalSecurityId internal_security_id{};
+    std::string name;
+    DPrice limit_up = 0;
+    DPrice limit_down = 0;
+    uint32_t lot_size = 0;
+    uint16_t fee_class = 0;
+};
+
+// 读取主数据 CSV：`security,internal_security_id,name,limit_up,limit_down,lot_size,fee_class`，
+// 首列为 record_type 的表头行与 # 注释忽略；格式错误或证券键重复返回 false。
+bool load_security_master_csv(const std::string& path, std::vector<security_master_record>& out);
+
+// 整表发布：先撤下 ready，写条目与完美哈希索引后再 release 置 ready。条目数超过 kSecurityMasterCapacity
+// 或证券键重复返回 false；索引构造失败时仍发布条目，slot_count 置 0，读者退回线性查找
+bool publish_security_master(security_master_shm_layout& shm, const std::vector<security_master_record>& records,
+                             uint32_t trading_day);
+
+// 段已发布且属于 trading_day（YYYYMMDD）
+bool security_master_ready(const security_master_shm_layout& shm, uint32_t trading_day) noexcept;
+
+// 按证券键查条目，未收录返回 nullptr；调用前须确认 security_master_ready
+const security_master_entry* security_master_find(const security_master_shm_layout& shm,
+                                                  const InternalSecurityId& security_id) noexcept;
+
+// 导出全部条目的涨跌停价格带（两侧都为 0 的条目跳过），供风控整表装载
+void security_master_price_limits(const security_master_shm_layout& shm, std::vector<price_limit_entry>& out);
+
+}  // namespace acct_service
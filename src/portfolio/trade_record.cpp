@@ -1,99 +1,287 @@
 #include "portfolio/trade_record.hpp"
 
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
 #include <fstream>
-#include <utility>
+#include <new>
+
+#include "common/error.hpp"
+#include "common/log.hpp"
 
 namespace acct_service {
 
-bool trade_record_manager::load_today_trades(const std::string& db_path, AccountId account_id) {
-    (void)db_path;
-    (void)account_id;
-    trades_.clear();
-    id_index_.clear();
-    order_index_.clear();
-    security_index_.clear();
-    next_trade_id_ = 1;
-    return true;
+namespace {
+
+bool report_store_error(std::string_view message, int sys_errno = 0) {
+    ErrorStatus status = ACCT_MAKE_ERROR(ErrorDomain::portfolio, ErrorCode::ComponentUnavailable, "trade_store",
+                                         message, sys_errno);
+    record_error(status);
+    ACCT_LOG_ERROR_STATUS(status);
+    return false;
+}
+
+std::size_t store_file_size(std::size_t capacity) noexcept {
+    return sizeof(trade_store_header) + capacity * sizeof(trade_record);
+}
+
+// 文件头与文件尺寸一致才可读写，避免把其他版本或截断文件当作成交库解析
+bool is_valid_store(const trade_store_header& header, std::size_t file_size) noexcept {
+    return header.magic == trade_store_header::kMagic && header.version == trade_store_header::kVersion &&
+           header.record_size == sizeof(trade_record) && header.capacity != 0 &&
+           file_size == store_file_size(header.capacity) &&
+           header.record_count.load(std::memory_order_acquire) <= header.capacity;
 }
 
-void trade_record_manager::add_trade(const trade_record& record) {
-    trade_record stored = record;
+}  // namespace
 
-    if (stored.trade_id == 0 || id_index_.find(stored.trade_id) != id_index_.end()) {
-        stored.trade_id = next_trade_id_++;
-    } else if (stored.trade_id >= next_trade_id_) {
-        next_trade_id_ = stored.trade_id + 1;
+std::string trade_store_path(std::string_view dir, AccountId account_id, std::string_view trading_day) {
+    std::string path(dir);
+    path += "/trades_";
+    path += std::to_string(account_id);
+    path += '_';
+    path += trading_day;
+    path += ".bin";
+    return path;
+}
+
+bool trade_store_read(const std::string& path, const trade_store_visitor& visitor, std::size_t* out_records) {
+    if (out_records) {
+        *out_records = 0;
     }
 
-    const std::size_t index = trades_.size();
-    trades_.push_back(stored);
-    id_index_[stored.trade_id] = index;
-    order_index_[stored.order_id].push_back(index);
-    security_index_[stored.security_id].push_back(index);
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return report_store_error("failed to open trade store", errno);
+    }
+    struct stat file_stat {};
+    if (::fstat(fd, &file_stat) != 0) {
+        const int err = errno;
+        ::close(fd);
+        return report_store_error("failed to stat trade store", err);
+    }
+    const std::size_t file_size = static_cast<std::size_t>(file_stat.st_size);
+    if (file_size < sizeof(trade_store_header)) {
+        ::close(fd);
+        return report_store_error("trade store is truncated");
+    }
+
+    // MAP_SHARED 只读映射：与账户进程的写端共享页缓存，能看到尚未落盘的已提交记录
+    void* mapping = ::mmap(nullptr, file_size, PROT_READ, MAP_SHARED, fd, 0);
+    const int map_err = errno;
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        return report_store_error("failed to mmap trade store", map_err);
+    }
+
+    const auto* header = static_cast<const trade_store_header*>(mapping);
+    if (!is_valid_store(*header, file_size)) {
+        ::munmap(mapping, file_size);
+        return report_store_error("trade store header is invalid");
+    }
+
+    const uint64_t count = header->record_count.load(std::memory_order_acquire);
+    const auto* records =
+        reinterpret_cast<const trade_record*>(static_cast<const char*>(mapping) + sizeof(trade_store_header));
+    for (uint64_t i = 0; i < count; ++i) {
+        visitor(records[i]);
+    }
+    ::munmap(mapping, file_size);
+    if (out_records) {
+        *out_records = static_cast<std::size_t>(count);
+    }
+    return true;
 }
 
-const trade_record* trade_record_manager::find_trade(uint64_t trade_id) const {
-    const auto it = id_index_.find(trade_id);
-    if (it == id_index_.end()) {
-        return nullptr;
+// 成交 ID、订单索引按 2 倍池容量开表，池满时探测长度仍短；证券数不超过持仓行数
+trade_record_manager::trade_record_manager(std::size_t capacity, bool huge_pages)
+    : capacity_(capacity < kNilLink ? capacity : kNilLink - 1),
+      records_pool_(capacity_, huge_pages, "trade_records.slots"),
+      links_(capacity_, huge_pages, "trade_records.links"),
+      id_index_(capacity_ * 2),
+      order_index_(capacity_ * 2),
+      security_index_(kMaxPositions) {
+    records_ = records_pool_.data();
+}
+
+trade_record_manager::~trade_record_manager() { close_store(); }
+
+void trade_record_manager::close_store() noexcept {
+    if (store_mapping_) {
+        ::munmap(store_mapping_, store_mapping_size_);
     }
-    return &trades_[it->second];
+    store_mapping_ = nullptr;
+    store_mapping_size_ = 0;
+    store_header_ = nullptr;
 }
 
-std::vector<const trade_record*> trade_record_manager::get_trades_by_order(InternalOrderId order_id) const {
-    std::vector<const trade_record*> result;
-    const auto it = order_index_.find(order_id);
-    if (it == order_index_.end()) {
-        return result;
+bool trade_record_manager::open_store(const std::string& dir, AccountId account_id, std::string_view trading_day) {
+    if (store_header_ || size_ != 0) {
+        return report_store_error("trade store must be opened once before any trade is added");
+    }
+    if (dir.empty() || trading_day.empty() || trading_day.size() >= sizeof(trade_store_header::trading_day)) {
+        return report_store_error("trade store directory or trading day is invalid");
     }
 
-    result.reserve(it->second.size());
-    for (std::size_t index : it->second) {
-        result.push_back(&trades_[index]);
+    std::error_code ec;
+    std::filesystem::create_directories(dir, ec);
+    if (ec) {
+        return report_store_error("failed to create trade store directory", ec.value());
+    }
+
+    const std::string path = trade_store_path(dir, account_id, trading_day);
+    const int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        return report_store_error("failed to open trade store", errno);
+    }
+    struct stat file_stat {};
+    if (::fstat(fd, &file_stat) != 0) {
+        const int err = errno;
+        ::close(fd);
+        return report_store_error("failed to stat trade store", err);
+    }
+
+    // 新文件按容量一次性定长（稀疏文件，记录区随追加落页），已有文件沿用原尺寸并校验文件头
+    const bool create = file_stat.st_size == 0;
+    const std::size_t file_size = create ? store_file_size(capacity_) : static_cast<std::size_t>(file_stat.st_size);
+    if (create && ::ftruncate(fd, static_cast<off_t>(file_size)) != 0) {
+        const int err = errno;
+        ::close(fd);
+        return report_store_error("failed to size trade store", err);
+    }
+    if (!create && file_size < sizeof(trade_store_header)) {
+        ::close(fd);
+        return report_store_error("trade store is truncated");
     }
-    return result;
-}
 
-std::vector<const trade_record*> trade_record_manager::get_trades_by_security(
-    InternalSecurityId security_id) const {
-    std::vector<const trade_record*> result;
-    const auto it = security_index_.find(security_id);
-    if (it == security_index_.end()) {
-        return result;
+    void* mapping = ::mmap(nullptr, file_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    const int map_err = errno;
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        return report_store_error("failed to mmap trade store", map_err);
     }
 
-    result.reserve(it->second.size());
-    for (std::size_t index : it->second) {
-        result.push_back(&trades_[index]);
+    auto* header = static_cast<trade_store_header*>(mapping);
+    if (create) {
+        header = new (mapping) trade_store_header{};
+        header->record_size = sizeof(trade_record);
+        header->capacity = static_cast<uint32_t>(capacity_);
+        header->account_id = account_id;
+        std::memcpy(header->trading_day, trading_day.data(), trading_day.size());
+    } else if (!is_valid_store(*header, file_size) || header->capacity != capacity_ ||
+               header->account_id != account_id || std::string_view(header->trading_day) != trading_day) {
+        ::munmap(mapping, file_size);
+        return report_store_error("trade store header does not match this account, trading day or capacity");
+    }
+
+    store_mapping_ = mapping;
+    store_mapping_size_ = file_size;
+    store_header_ = header;
+    records_ = reinterpret_cast<trade_record*>(static_cast<char*>(mapping) + sizeof(trade_store_header));
+    records_pool_.reset();
+
+    // 顺序扫描已提交记录重建索引；trade_id 在写入时已去重，这里原样挂回
+    const uint64_t count = header->record_count.load(std::memory_order_acquire);
+    for (uint64_t index = 0; index < count; ++index) {
+        if (!index_record(static_cast<uint32_t>(index))) {
+            return report_store_error("trade store holds more securities than the index capacity");
+        }
     }
-    return result;
+    if (count != 0) {
+        ACCT_LOG_INFO("trade_store", "recovered " + std::to_string(count) + " trades from " + path);
+    }
+    return true;
 }
 
-std::vector<const trade_record*> trade_record_manager::get_all_trades() const {
-    std::vector<const trade_record*> result;
-    result.reserve(trades_.size());
-    for (const trade_record& record : trades_) {
-        result.push_back(&record);
+bool trade_record_manager::load_today_trades(const std::string& db_path, AccountId account_id) {
+    (void)db_path;
+    (void)account_id;
+    if (store_header_) {
+        return true;
     }
-    return result;
+    reset();
+    return true;
+}
+
+void trade_record_manager::reset() noexcept {
+    size_ = 0;
+    id_index_.clear();
+    order_index_.clear();
+    security_index_.clear();
+    next_trade_id_ = 1;
+    total_value_ = 0;
+    total_fee_ = 0;
 }
 
-std::size_t trade_record_manager::trade_count() const noexcept { return trades_.size(); }
+bool trade_record_manager::add_trade(const trade_record& record) {
+    if (size_ >= capacity_) {
+        return false;
+    }
 
-DValue trade_record_manager::total_traded_value() const noexcept {
-    DValue total = 0;
-    for (const trade_record& record : trades_) {
-        total += record.value;
+    // 成交与订单索引的容量不小于记录池，只有证券索引可能先满
+    if (!security_index_.contains(record.security_id) && security_index_.size() >= security_index_.capacity()) {
+        return false;
     }
-    return total;
+
+    const uint32_t index = static_cast<uint32_t>(size_);
+    trade_record& stored = records_[index];
+    stored = record;
+    if (stored.trade_id == 0 || id_index_.contains(stored.trade_id)) {
+        stored.trade_id = next_trade_id_;
+    }
+    (void)index_record(index);
+    // 先写记录再 release 发布计数，重启扫描与外部读者按计数截断即可跳过写了一半的记录
+    if (store_header_) {
+        store_header_->record_count.store(size_, std::memory_order_release);
+    }
+    return true;
 }
 
-DValue trade_record_manager::total_fee() const noexcept {
-    DValue total = 0;
-    for (const trade_record& record : trades_) {
-        total += record.fee;
+bool trade_record_manager::index_record(uint32_t index) {
+    const trade_record& record = records_[index];
+    if (!security_index_.contains(record.security_id) && security_index_.size() >= security_index_.capacity()) {
+        return false;
+    }
+
+    links_[index] = trade_links{};
+    if (record.trade_id >= next_trade_id_) {
+        next_trade_id_ = record.trade_id + 1;
     }
-    return total;
+    id_index_.insert_or_assign(record.trade_id, index);
+
+    trade_chain* by_order = order_index_.try_emplace(record.order_id);
+    if (by_order->tail == kNilLink) {
+        by_order->head = index;
+    } else {
+        links_[by_order->tail].next_by_order = index;
+    }
+    by_order->tail = index;
+
+    trade_chain* by_security = security_index_.try_emplace(record.security_id);
+    if (by_security->tail == kNilLink) {
+        by_security->head = index;
+    } else {
+        links_[by_security->tail].next_by_security = index;
+    }
+    by_security->tail = index;
+
+    total_value_ += record.value;
+    total_fee_ += record.fee;
+    ++size_;
+    return true;
+}
+
+const trade_record* trade_record_manager::find_trade(uint64_t trade_id) const {
+    const uint32_t* index = id_index_.find(trade_id);
+    if (!index) {
+        return nullptr;
+    }
+    return &records_[*index];
 }
 
 bool trade_record_manager::save_to_db(const std::string& db_path) const {
@@ -106,12 +294,12 @@ bool trade_record_manager::save_to_db(const std::string& db_path) const {
         return false;
     }
 
-    for (const trade_record& record : trades_) {
+    for_each_trade([&out](const trade_record& record) {
         out << record.trade_id << ',' << record.order_id << ',' << record.security_id.view() << ','
             << static_cast<int>(record.side) << ',' << record.volume << ',' << record.price << ',' << record.value << ','
             << record.fee << ',' << record.trade_time << ',' << record.local_time << ','
             << record.broker_trade_id.c_str() << '\n';
-    }
+    });
 
     return true;
 }
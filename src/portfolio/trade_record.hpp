@@ -1,10 +1,18 @@
 #pragma once
 
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
 #include <string>
-#include <unordered_map>
-#include <vector>
+#include <string_view>
+#include <type_traits>
 
+#include "common/constants.hpp"
 #include "common/fixed_string.hpp"
+#include "common/flat_hash_map.hpp"
+#include "common/lazy_region.hpp"
+#include "common/memory_accounting.hpp"
 #include "common/types.hpp"
 #include "order/order_request.hpp"
 
@@ -25,38 +33,149 @@ struct alignas(64) trade_record {
     FixedString<32> broker_trade_id;
 };
 
-// 成交记录管理器
+static_assert(std::is_trivially_copyable_v<trade_record>, "trade_record must be trivially copyable");
+
+// 当日成交库文件：64 字节文件头 + capacity 条定长 trade_record，只追加。
+// 路径为 <dir>/trades_<account>_<trading_day>.bin；外部工具可直接只读映射，按 record_count 截断读取
+struct trade_store_header {
+    static constexpr uint32_t kMagic = 0x53445254;  // "TRDS"
+    static constexpr uint32_t kVersion = 1;
+
+    uint32_t magic = kMagic;
+    uint32_t version = kVersion;
+    uint32_t record_size = 0;
+    uint32_t capacity = 0;
+    AccountId account_id = 0;
+    uint32_t reserved0 = 0;
+    std::atomic<uint64_t> record_count{0};  // 已提交记录数，写端 release 发布、读端 acquire 读取
+    char trading_day[16] = {};
+    uint8_t reserved[16] = {};
+};
+
+static_assert(sizeof(trade_store_header) == 64, "trade_store_header must be 64 bytes");
+
+std::string trade_store_path(std::string_view dir, AccountId account_id, std::string_view trading_day);
+
+using trade_store_visitor = std::function<void(const trade_record&)>;
+
+// 只读映射成交库文件并按顺序回调已提交记录；文件头不合法时返回 false
+bool trade_store_read(const std::string& path, const trade_store_visitor& visitor, std::size_t* out_records = nullptr);
+
+// 成交记录管理器：构造时按容量一次性映射记录池（惰性落页，huge_pages 时经 huge_page_arena 以大页承载），
+// 运行期只追加不扩容，已返回的记录指针整日有效。
+// 按订单、按证券的索引是挂在池内槽位上的单向链表，查询通过回调遍历，不分配内存。非线程安全。
+// open_store() 后记录改为直接写入当日成交库文件的共享映射，重启时顺序扫描已提交记录重建索引与合计
 class trade_record_manager {
 public:
-    trade_record_manager() = default;
-    ~trade_record_manager() = default;
+    explicit trade_record_manager(std::size_t capacity = kDailyTradeCapacity, bool huge_pages = false);
+    ~trade_record_manager();
+
+    trade_record_manager(const trade_record_manager&) = delete;
+    trade_record_manager& operator=(const trade_record_manager&) = delete;
 
-    // 从数据库加载当日成交
+    // 打开（不存在则新建）当日成交库文件，须在 add_trade 之前调用；已有记录按文件内顺序重新索引。
+    // 文件头与本进程记录布局、容量、账户或交易日不一致时返回 false，管理器保持进程内记录池
+    bool open_store(const std::string& dir, AccountId account_id, std::string_view trading_day);
+    bool store_open() const noexcept { return store_header_ != nullptr; }
+
+    // 从数据库加载当日成交；成交库已打开时以库内记录为准，不做任何改动
     bool load_today_trades(const std::string& db_path, AccountId account_id);
 
-    // 添加成交记录
-    void add_trade(const trade_record& record);
+    // 添加成交记录；trade_id 为 0 或重复时改用自增编号。记录池或索引已满时返回 false 且不改动状态。
+    bool add_trade(const trade_record& record);
 
     // 查询接口
     const trade_record* find_trade(uint64_t trade_id) const;
-    std::vector<const trade_record*> get_trades_by_order(InternalOrderId order_id) const;
-    std::vector<const trade_record*> get_trades_by_security(InternalSecurityId security_id) const;
-    std::vector<const trade_record*> get_all_trades() const;
+
+    // 按添加顺序遍历：fn(const trade_record& record)；回调内不得调用 add_trade
+    template <typename Fn>
+    void for_each_trade_by_order(InternalOrderId order_id, Fn&& fn) const;
+    template <typename Fn>
+    void for_each_trade_by_security(InternalSecurityId security_id, Fn&& fn) const;
+    template <typename Fn>
+    void for_each_trade(Fn&& fn) const;
 
     // 统计接口
-    std::size_t trade_count() const noexcept;
-    DValue total_traded_value() const noexcept;
-    DValue total_fee() const noexcept;
+    std::size_t trade_count() const noexcept { return size_; }
+    std::size_t capacity() const noexcept { return capacity_; }
+    DValue total_traded_value() const noexcept { return total_value_; }
+    DValue total_fee() const noexcept { return total_fee_; }
+    // 记录池（或成交库映射）、链接与三个索引的内存占用，按已添加记录计在用
+    memory_usage memory() const noexcept {
+        memory_usage usage = store_header_ ? element_memory(capacity_, size_, sizeof(trade_record))
+                                           : records_pool_.memory(size_);
+        usage += links_.memory(size_);
+        usage += id_index_.memory();
+        usage += order_index_.memory();
+        usage += security_index_.memory();
+        return usage;
+    }
 
     // 持久化
     bool save_to_db(const std::string& db_path) const;
 
 private:
-    std::vector<trade_record> trades_;
-    std::unordered_map<uint64_t, std::size_t> id_index_;
-    std::unordered_map<InternalOrderId, std::vector<std::size_t>> order_index_;
-    std::unordered_map<InternalSecurityId, std::vector<std::size_t>> security_index_;
+    static constexpr uint32_t kNilLink = UINT32_MAX;
+
+    // 与记录同下标的同订单、同证券链表后继；记录本体单独存放，成交库文件里只有记录
+    struct trade_links {
+        uint32_t next_by_order = kNilLink;
+        uint32_t next_by_security = kNilLink;
+    };
+
+    struct trade_chain {
+        uint32_t head = kNilLink;
+        uint32_t tail = kNilLink;
+    };
+
+    void reset() noexcept;
+    // 把 records_[index]（index == size_）挂入索引与合计并推进 size_；证券索引已满时返回 false
+    bool index_record(uint32_t index);
+    void close_store() noexcept;
+
+    std::size_t capacity_ = 0;
+    std::size_t size_ = 0;
+    lazy_array<trade_record> records_pool_;  // 进程内成交记录池，打开成交库后释放
+    lazy_array<trade_links> links_;
+    trade_record* records_ = nullptr;        // 指向记录池或成交库映射中的记录区
+    void* store_mapping_ = nullptr;
+    std::size_t store_mapping_size_ = 0;
+    trade_store_header* store_header_ = nullptr;
+    flat_hash_map<uint64_t, uint32_t> id_index_;              // trade_id -> 槽位下标
+    flat_hash_map<InternalOrderId, trade_chain> order_index_;  // 订单 -> 成交槽位链表
+    flat_hash_map<InternalSecurityId, trade_chain> security_index_;  // 证券 -> 成交槽位链表
     uint64_t next_trade_id_ = 1;
+    DValue total_value_ = 0;
+    DValue total_fee_ = 0;
 };
 
+template <typename Fn>
+void trade_record_manager::for_each_trade_by_order(InternalOrderId order_id, Fn&& fn) const {
+    const trade_chain* chain = order_index_.find(order_id);
+    if (!chain) {
+        return;
+    }
+    for (uint32_t index = chain->head; index != kNilLink; index = links_[index].next_by_order) {
+        fn(records_[index]);
+    }
+}
+
+template <typename Fn>
+void trade_record_manager::for_each_trade_by_security(InternalSecurityId security_id, Fn&& fn) const {
+    const trade_chain* chain = security_index_.find(security_id);
+    if (!chain) {
+        return;
+    }
+    for (uint32_t index = chain->head; index != kNilLink; index = links_[index].next_by_security) {
+        fn(records_[index]);
+    }
+}
+
+template <typename Fn>
+void trade_record_manager::for_each_trade(Fn&& fn) const {
+    for (std::size_t index = 0; index < size_; ++index) {
+        fn(records_[index]);
+    }
+}
+
 }  // namespace acct_service
@@ -0,0 +1,190 @@
+#include "risk/firm_risk_aggregator.hpp"
+
+#include <utility>
+
+#include "common/time_utils.hpp"
+#include "shm/firm_risk_shm.hpp"
+#include "shm/positions_shm.hpp"
+
+namespace acct_service {
+
+firm_risk_aggregator::firm_risk_aggregator(firm_risk_shm_layout* out) : out_(out), changed_rows_(kChangedRowBatch) {
+    accounts_.reserve(kMaxFirmRiskAccounts);
+}
+
+bool firm_risk_aggregator::add_account(AccountId account_id, const positions_shm_layout* positions) {
+    if (!out_ || !positions || accounts_.size() >= kMaxFirmRiskAccounts) {
+        return false;
+    }
+    for (const account_state& account : accounts_) {
+        if (account.account_id == account_id || account.positions == positions) {
+            return false;
+        }
+    }
+    account_state account;
+    account.account_id = account_id;
+    account.positions = positions;
+    account.rows.resize(kMaxPositions);
+    accounts_.push_back(std::move(account));
+    pending_.account_count = static_cast<uint32_t>(accounts_.size());
+    dirty_ = true;
+    return true;
+}
+
+std::size_t firm_risk_aggregator::poll() noexcept {
+    std::size_t rows_applied = 0;
+    for (account_state& account : accounts_) {
+        (void)poll_account(account, rows_applied);
+    }
+    if (dirty_) {
+        publish();
+    }
+    return rows_applied;
+}
+
+bool firm_risk_aggregator::poll_account(account_state& account, std::size_t& rows_applied) noexcept {
+    const positions_shm_layout& positions = *account.positions;
+    if (positions.changes.version.load(std::memory_order_acquire) < account.cursor) {
+        withdraw(account);
+    }
+
+    for (;;) {
+        uint64_t next_cursor = account.cursor;
+        const std::size_t count = positions_shm_collect_changed(positions, account.cursor, changed_rows_.data(),
+                                                                changed_rows_.size(), next_cursor);
+        if (count == 0) {
+            return true;
+        }
+        // 逐行重算贡献值：同一批重做时差值为 0，重复折算无副作用
+        for (std::size_t i = 0; i < count; ++i) {
+            const std::size_t row_index = changed_rows_[i];
+            row_contribution next;
+            FixedString<16> id;
+            if (!read_row(account, row_index, next, id)) {
+                return false;
+            }
+            apply(account.rows[row_index], next, id);
+            ++rows_applied;
+        }
+        account.cursor = next_cursor;
+        if (count < changed_rows_.size()) {
+            return true;
+        }
+    }
+}
+
+bool firm_risk_aggregator::read_row(const account_state& account, std::size_t row_index, row_contribution& out,
+                                    FixedString<16>& out_id) const noexcept {
+    const positions_shm_layout& positions = *account.positions;
+    for (uint32_t attempt = 0; attempt < kMaxReadRetries; ++attempt) {
+        if (row_index == kFundPositionIndex) {
+            fund_info fund;
+            if (positions_shm_try_read_fund(positions, fund)) {
+                out.frozen_value = fund.frozen;
+                return true;
+            }
+            continue;
+        }
+        const bool stable = position_try_read(positions.positions[row_index], [&out, &out_id](const position& row) {
+            out.holding_volume = row.volume_available_t0 + row.volume_available_t1 + row.volume_sell;
+            out.traded_buy_value = row.dvalue_buy_traded;
+            out.traded_sell_value = row.dvalue_sell_traded;
+            out_id = row.id;
+        });
+        if (stable) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void firm_risk_aggregator::apply(row_contribution& old, row_contribution next, const FixedString<16>& id) noexcept {
+    // id 为空（FUND 行或未用行）不计入证券合计；行被重建为其他证券时从旧槽位撤出，再计入新槽位
+    next.slot = UINT32_MAX;
+    if (!id.empty()) {
+        if (old.slot != UINT32_MAX && out_->securities[old.slot].id == id) {
+            next.slot = old.slot;
+        } else {
+            next.slot = resolve_slot(id);
+            if (next.slot == UINT32_MAX) {
+                ++unplaced_rows_;
+            }
+        }
+    }
+
+    if (old.slot != UINT32_MAX && old.slot != next.slot) {
+        firm_security_total& row = out_->securities[old.slot];
+        position_lock guard(row.seq);
+        row.holding_volume -= old.holding_volume;
+        row.traded_buy_value -= old.traded_buy_value;
+        row.traded_sell_value -= old.traded_sell_value;
+        row.account_count -= 1;
+    }
+    if (next.slot != UINT32_MAX) {
+        firm_security_total& row = out_->securities[next.slot];
+        const bool same_slot = old.slot == next.slot;
+        position_lock guard(row.seq);
+        row.holding_volume += next.holding_volume - (same_slot ? old.holding_volume : 0);
+        row.traded_buy_value += next.traded_buy_value - (same_slot ? old.traded_buy_value : 0);
+        row.traded_sell_value += next.traded_sell_value - (same_slot ? old.traded_sell_value : 0);
+        if (!same_slot) {
+            row.account_count += 1;
+        }
+    }
+
+    // 无符号回绕即有符号差值，合计始终等于各行当前贡献之和
+    pending_.holding_volume += next.holding_volume - old.holding_volume;
+    pending_.traded_buy_value += next.traded_buy_value - old.traded_buy_value;
+    pending_.traded_sell_value += next.traded_sell_value - old.traded_sell_value;
+    pending_.frozen_value += next.frozen_value - old.frozen_value;
+    old = next;
+    dirty_ = true;
+}
+
+void firm_risk_aggregator::withdraw(account_state& account) noexcept {
+    const FixedString<16> none;
+    for (row_contribution& row : account.rows) {
+        apply(row, row_contribution{}, none);
+    }
+    account.cursor = 0;
+}
+
+uint32_t firm_risk_aggregator::resolve_slot(const FixedString<16>& id) noexcept {
+    std::size_t slot = firm_risk_security_slot(id);
+    for (std::size_t probe = 0; probe < kFirmRiskSecurityCapacity; ++probe) {
+        firm_security_total& row = out_->securities[slot];
+        if (row.seq.load(std::memory_order_relaxed) == 0) {
+            // 登记：写区间内写入 id，seq 由 0 前进到 2，读者探测据此区分空槽
+            position_lock guard(row.seq);
+            row.id = id;
+            row.account_count = 0;
+            row.holding_volume = 0;
+            row.traded_buy_value = 0;
+            row.traded_sell_value = 0;
+            out_->security_count.fetch_add(1, std::memory_order_relaxed);
+            return static_cast<uint32_t>(slot);
+        }
+        if (row.id == id) {
+            return static_cast<uint32_t>(slot);
+        }
+        slot = (slot + 1) & (kFirmRiskSecurityCapacity - 1);
+    }
+    return UINT32_MAX;
+}
+
+void firm_risk_aggregator::publish() noexcept {
+    firm_risk_totals& totals = out_->totals;
+    {
+        position_lock guard(totals.seq);
+        totals.account_count = pending_.account_count;
+        totals.traded_buy_value = pending_.traded_buy_value;
+        totals.traded_sell_value = pending_.traded_sell_value;
+        totals.frozen_value = pending_.frozen_value;
+        totals.holding_volume = pending_.holding_volume;
+        totals.version += 1;
+        totals.publish_ns = now_ns();
+    }
+    dirty_ = false;
+}
+
+}  // namespace acct_service
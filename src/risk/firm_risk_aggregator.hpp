@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "common/types.hpp"
+#include "shm/shm_layout.hpp"
+
+namespace acct_service {
+
+// 跨账户风控聚合：持有全部账户 positions_shm 的只读映射，按各段变更戳游标拉取脏行，
+// 对每行只记住上次计入的贡献值，合计按"新值 - 旧值"增量修正，不重扫全表；每轮 poll 结束时
+// 一次 seqlock 写区间发布公司级合计。聚合进程是 firm_risk_shm 的唯一写者。
+class firm_risk_aggregator {
+public:
+    static constexpr std::size_t kChangedRowBatch = 1024;
+    static constexpr uint32_t kMaxReadRetries = 1024;  // 账户写区间的最大重试次数，超出则本轮跳过该账户
+
+    explicit firm_risk_aggregator(firm_risk_shm_layout* out);
+
+    firm_risk_aggregator(const firm_risk_aggregator&) = delete;
+    firm_risk_aggregator& operator=(const firm_risk_aggregator&) = delete;
+
+    // 接入一个账户的持仓段；账户重复、段为空或超过 kMaxFirmRiskAccounts 时返回 false
+    bool add_account(AccountId account_id, const positions_shm_layout* positions);
+
+    // 拉取各账户自上次游标以来的变更行并增量更新合计，有变化时发布；返回本轮折算的行数
+    std::size_t poll() noexcept;
+
+    std::size_t account_count() const noexcept { return accounts_.size(); }
+    // 按证券表写满而未能计入证券合计的行数（公司级合计仍计入）
+    uint64_t unplaced_rows() const noexcept { return unplaced_rows_; }
+
+private:
+    struct row_contribution {
+        uint64_t holding_volume = 0;
+        uint64_t traded_buy_value = 0;
+        uint64_t traded_sell_value = 0;
+        uint64_t frozen_value = 0;  // 仅 FUND 行
+        uint32_t slot = UINT32_MAX;  // 证券合计槽位，UINT32_MAX 表示未计入
+    };
+
+    struct account_state {
+        AccountId account_id = 0;
+        const positions_shm_layout* positions = nullptr;
+        uint64_t cursor = 0;
+        std::vector<row_contribution> rows;  // 按物理行号
+    };
+
+    // 折算账户的变更行；账户写区间持续占用时返回 false，游标不前进，下一轮重做
+    bool poll_account(account_state& account, std::size_t& rows_applied) noexcept;
+    bool read_row(const account_state& account, std::size_t row_index, row_contribution& out,
+                  FixedString<16>& out_id) const noexcept;
+    // 把行贡献从 old 替换为 next，并更新对应证券槽位
+    void apply(row_contribution& old, row_contribution next, const FixedString<16>& id) noexcept;
+    // 持仓段重建（变更版本回退）时撤回该账户的全部贡献
+    void withdraw(account_state& account) noexcept;
+    // 查找或登记证券槽位；表满返回 UINT32_MAX
+    uint32_t resolve_slot(const FixedString<16>& id) noexcept;
+    void publish() noexcept;
+
+    firm_risk_shm_layout* out_;
+    std::vector<account_state> accounts_;
+    firm_risk_totals pending_{};  // 工作副本，publish 时拷贝进共享段
+    std::vector<uint32_t> changed_rows_;
+    bool dirty_ = false;
+    uint64_t unplaced_rows_ = 0;
+};
+
+}  // namespace acct_service
@@ -1,9 +1,12 @@
 #include "risk/risk_checker.hpp"
 
-#include <string>
+#include <algorithm>
 #include <utility>
 
+#include "common/constants.hpp"
+#include "common/flat_hash_map.hpp"
 #include "common/security_identity.hpp"
+#include "shm/firm_risk_shm.hpp"
 
 namespace acct_service {
 
@@ -15,19 +18,55 @@ bool is_new_order(const OrderRequest& order) { return order.order_type == OrderT
 
 }  // namespace
 
-bool risk_check_result::passed() const noexcept { return code == RiskResult::Pass; }
-
-risk_check_result risk_check_result::pass() { return risk_check_result{RiskResult::Pass, "pass"}; }
-
-risk_check_result risk_check_result::reject(RiskResult code, std::string msg) {
-    return risk_check_result{code, std::move(msg)};
+void risk_batch_columns::load(const OrderRequest* orders, std::size_t n) noexcept {
+    count = n < kRiskBatchSize ? n : kRiskBatchSize;
+    new_mask = 0;
+    for (std::size_t i = 0; i < count; ++i) {
+        volume[i] = orders[i].volume_entrust;
+        price[i] = orders[i].dprice_entrust;
+        new_mask |= static_cast<uint64_t>(is_new_order(orders[i])) << i;
+    }
 }
 
-bool risk_rule::enabled() const noexcept { return enabled_; }
-
-void risk_rule::set_enabled(bool enabled) { enabled_ = enabled; }
-
-const char* fund_check_rule::name() const noexcept { return "fund_check"; }
+const char* to_string(risk_message_id id) noexcept {
+    switch (id) {
+        case risk_message_id::Pass:
+            return "pass";
+        case risk_message_id::InsufficientFund:
+            return "insufficient available fund";
+        case risk_message_id::InsufficientPosition:
+            return "insufficient sellable position";
+        case risk_message_id::ExceedMaxOrderValue:
+            return "order value exceeds limit";
+        case risk_message_id::ExceedMaxOrderVolume:
+            return "order volume exceeds limit";
+        case risk_message_id::ExceedDailyTurnover:
+            return "daily turnover exceeds limit";
+        case risk_message_id::PriceOutOfRange:
+            return "price is out of limit range";
+        case risk_message_id::DuplicateOrder:
+            return "duplicate order within time window";
+        case risk_message_id::RateLimitExceeded:
+            return "order rate exceeds limit";
+        case risk_message_id::StrategyRateLimitExceeded:
+            return "strategy order rate exceeds limit";
+        case risk_message_id::SecurityRateLimitExceeded:
+            return "security order rate exceeds limit";
+        case risk_message_id::SelfTrade:
+            return "order would cross own resting order";
+        case risk_message_id::FirmGrossExposureExceeded:
+            return "firm gross exposure exceeds limit";
+        case risk_message_id::FirmSecurityConcentrationExceeded:
+            return "firm security holding exceeds limit";
+        case risk_message_id::OrderToTradeRatioExceeded:
+            return "order-to-trade ratio exceeds limit";
+        case risk_message_id::CancelRatioExceeded:
+            return "cancel ratio exceeds limit";
+        case risk_message_id::StrategyPaused:
+            return "strategy paused by admin command";
+    }
+    return "unknown";
+}
 
 risk_check_result fund_check_rule::check(const OrderRequest& order, const PositionManager& positions) {
     if (!enabled_ || !is_new_order(order) || order.trade_side != TradeSide::Buy) {
@@ -43,22 +82,22 @@ risk_check_result fund_check_rule::check(const OrderRequest& order, const Positi
     }
     const __uint128_t required_total = required_value + static_cast<__uint128_t>(estimated_fee);
     if (required_total < required_value || required_total > static_cast<__uint128_t>(available)) {
-        return risk_check_result::reject(RiskResult::RejectInsufficientFund, "insufficient available fund");
+        return risk_check_result::reject(RiskResult::RejectInsufficientFund, risk_message_id::InsufficientFund);
     }
 
     return risk_check_result::pass();
 }
 
-const char* position_check_rule::name() const noexcept { return "position_check"; }
-
 risk_check_result position_check_rule::check(const OrderRequest& order, const PositionManager& positions) {
     if (!enabled_ || !is_new_order(order) || order.trade_side != TradeSide::Sell) {
         return risk_check_result::pass();
     }
 
-    const Volume sellable = positions.get_sellable_volume(order.internal_security_id);
+    const Volume sellable = order.security_handle != kInvalidSecurityHandle
+                                ? positions.get_sellable_volume(order.security_handle)
+                                : positions.get_sellable_volume(order.internal_security_id);
     if (sellable < order.volume_entrust) {
-        return risk_check_result::reject(RiskResult::RejectInsufficientPosition, "insufficient sellable position");
+        return risk_check_result::reject(RiskResult::RejectInsufficientPosition, risk_message_id::InsufficientPosition);
     }
 
     return risk_check_result::pass();
@@ -66,8 +105,6 @@ risk_check_result position_check_rule::check(const OrderRequest& order, const Po
 
 max_order_value_rule::max_order_value_rule(DValue max_value) : max_value_(max_value) {}
 
-const char* max_order_value_rule::name() const noexcept { return "max_order_value"; }
-
 risk_check_result max_order_value_rule::check(const OrderRequest& order, const PositionManager& positions) {
     (void)positions;
     if (!enabled_ || !is_new_order(order) || max_value_ == 0) {
@@ -77,18 +114,43 @@ risk_check_result max_order_value_rule::check(const OrderRequest& order, const P
     const __uint128_t value =
         static_cast<__uint128_t>(order.volume_entrust) * static_cast<__uint128_t>(order.dprice_entrust);
     if (value > static_cast<__uint128_t>(max_value_)) {
-        return risk_check_result::reject(RiskResult::RejectExceedMaxOrderValue, "order value exceeds limit");
+        return risk_check_result::reject(RiskResult::RejectExceedMaxOrderValue, risk_message_id::ExceedMaxOrderValue);
     }
 
     return risk_check_result::pass();
 }
 
+uint64_t max_order_value_rule::reject_mask(const risk_batch_columns& columns) const noexcept {
+    if (!enabled_ || max_value_ == 0) {
+        return 0;
+    }
+
+    // 数量与价格都小于 2^32 时 64 位乘积不溢出，走无分支快路径；否则该笔回落到 128 位标量判定
+    uint8_t over[kRiskBatchSize];
+    uint8_t wide[kRiskBatchSize];
+    for (std::size_t i = 0; i < kRiskBatchSize; ++i) {
+        const uint64_t volume = columns.volume[i];
+        const uint64_t price = columns.price[i];
+        wide[i] = static_cast<uint8_t>(((volume | price) >> 32) != 0);
+        over[i] = static_cast<uint8_t>(volume * price > max_value_);
+    }
+
+    uint64_t mask = 0;
+    for (std::size_t i = 0; i < columns.count; ++i) {
+        bool reject = over[i] != 0;
+        if (wide[i] != 0) {
+            reject = static_cast<__uint128_t>(columns.volume[i]) * static_cast<__uint128_t>(columns.price[i]) >
+                     static_cast<__uint128_t>(max_value_);
+        }
+        mask |= static_cast<uint64_t>(reject) << i;
+    }
+    return mask & columns.new_mask;
+}
+
 void max_order_value_rule::set_max_value(DValue max_value) { max_value_ = max_value; }
 
 max_order_volume_rule::max_order_volume_rule(Volume max_volume) : max_volume_(max_volume) {}
 
-const char* max_order_volume_rule::name() const noexcept { return "max_order_volume"; }
-
 risk_check_result max_order_volume_rule::check(const OrderRequest& order, const PositionManager& positions) {
     (void)positions;
     if (!enabled_ || !is_new_order(order) || max_volume_ == 0) {
@@ -96,52 +158,411 @@ risk_check_result max_order_volume_rule::check(const OrderRequest& order, const
     }
 
     if (order.volume_entrust > max_volume_) {
-        return risk_check_result::reject(RiskResult::RejectExceedMaxOrderVolume, "order volume exceeds limit");
+        return risk_check_result::reject(RiskResult::RejectExceedMaxOrderVolume, risk_message_id::ExceedMaxOrderVolume);
     }
 
     return risk_check_result::pass();
 }
 
+uint64_t max_order_volume_rule::reject_mask(const risk_batch_columns& columns) const noexcept {
+    if (!enabled_ || max_volume_ == 0) {
+        return 0;
+    }
+
+    uint8_t over[kRiskBatchSize];
+    for (std::size_t i = 0; i < kRiskBatchSize; ++i) {
+        over[i] = static_cast<uint8_t>(columns.volume[i] > max_volume_);
+    }
+
+    uint64_t mask = 0;
+    for (std::size_t i = 0; i < columns.count; ++i) {
+        mask |= static_cast<uint64_t>(over[i]) << i;
+    }
+    return mask & columns.new_mask;
+}
+
 void max_order_volume_rule::set_max_volume(Volume max_volume) { max_volume_ = max_volume; }
 
-const char* price_limit_rule::name() const noexcept { return "price_limit"; }
+max_daily_turnover_rule::max_daily_turnover_rule(DValue max_turnover) : max_turnover_(max_turnover) {}
 
-risk_check_result price_limit_rule::check(const OrderRequest& order, const PositionManager& positions) {
-    (void)positions;
+risk_check_result max_daily_turnover_rule::check(const OrderRequest& order, const PositionManager& positions) {
+    if (!enabled_ || !is_new_order(order) || max_turnover_ == 0) {
+        return risk_check_result::pass();
+    }
+
+    const __uint128_t committed = static_cast<__uint128_t>(positions.traded_turnover()) +
+                                  static_cast<__uint128_t>(positions.get_frozen_fund());
+    const __uint128_t value =
+        static_cast<__uint128_t>(order.volume_entrust) * static_cast<__uint128_t>(order.dprice_entrust);
+    if (committed + value > static_cast<__uint128_t>(max_turnover_)) {
+        return risk_check_result::reject(RiskResult::RejectExceedDailyLimit, risk_message_id::ExceedDailyTurnover);
+    }
+
+    return risk_check_result::pass();
+}
+
+void max_daily_turnover_rule::set_max_turnover(DValue max_turnover) { max_turnover_ = max_turnover; }
+
+risk_check_result order_ratio_rule::check(const OrderRequest& order, const PositionManager& positions) {
     if (!enabled_ || !is_new_order(order)) {
         return risk_check_result::pass();
     }
 
-    InternalSecurityId security_id;
-    if (!normalize_internal_security_id(order.internal_security_id.view(), security_id)) {
+    const risk_check_result account = check_counts(positions.order_flow_totals());
+    if (!account.passed() || order.security_handle == kInvalidSecurityHandle) {
+        return account;
+    }
+    return check_counts(positions.order_flow(order.security_handle));
+}
+
+risk_check_result order_ratio_rule::check_counts(const order_flow_counts& counts) const noexcept {
+    if (counts.orders < min_orders_) {
+        return risk_check_result::pass();
+    }
+    // 乘法比较，避免除法与取整；计数为当日笔数，乘以 32 位上限不会溢出
+    if (max_order_to_trade_ratio_ != 0 &&
+        counts.orders + 1 > std::max<uint64_t>(counts.fills, 1) * max_order_to_trade_ratio_) {
+        return risk_check_result::reject(RiskResult::RejectOrderRatio, risk_message_id::OrderToTradeRatioExceeded);
+    }
+    if (max_cancel_ratio_pct_ != 0 && counts.orders != 0 &&
+        counts.cancels * 100 > counts.orders * max_cancel_ratio_pct_) {
+        return risk_check_result::reject(RiskResult::RejectOrderRatio, risk_message_id::CancelRatioExceeded);
+    }
+    return risk_check_result::pass();
+}
+
+void order_ratio_rule::set_limits(uint32_t max_order_to_trade_ratio, uint32_t max_cancel_ratio_pct,
+                                  uint32_t min_orders) noexcept {
+    max_order_to_trade_ratio_ = max_order_to_trade_ratio;
+    max_cancel_ratio_pct_ = max_cancel_ratio_pct;
+    min_orders_ = min_orders;
+}
+
+firm_exposure_rule::firm_exposure_rule() : slot_by_handle_(std::make_unique<uint32_t[]>(kMaxPositions)) {
+    std::fill_n(slot_by_handle_.get(), kMaxPositions, kUnresolvedSlot);
+}
+
+risk_check_result firm_exposure_rule::check(const OrderRequest& order, const PositionManager& positions) {
+    (void)positions;
+    if (!enabled_ || !shm_ || !is_new_order(order)) {
         return risk_check_result::pass();
     }
 
-    const auto it = limits_.find(security_id);
-    if (it == limits_.end()) {
+    const __uint128_t order_value =
+        static_cast<__uint128_t>(order.volume_entrust) * static_cast<__uint128_t>(order.dprice_entrust);
+    if (max_gross_value_ != 0) {
+        firm_risk_totals totals;
+        bool stable = false;
+        for (uint32_t attempt = 0; attempt < kMaxReadRetries && !stable; ++attempt) {
+            stable = firm_risk_try_read_totals(*shm_, totals);
+        }
+        if (stable) {
+            const __uint128_t gross = static_cast<__uint128_t>(totals.traded_buy_value) + totals.traded_sell_value +
+                                      totals.frozen_value + order_value;
+            if (gross > static_cast<__uint128_t>(max_gross_value_)) {
+                return risk_check_result::reject(RiskResult::RejectFirmLimit,
+                                                 risk_message_id::FirmGrossExposureExceeded);
+            }
+        }
+    }
+
+    if (max_security_volume_ != 0 && order.trade_side == TradeSide::Buy) {
+        const uint32_t slot = resolve_slot(order);
+        if (slot != kUnresolvedSlot) {
+            firm_security_total security;
+            bool stable = false;
+            for (uint32_t attempt = 0; attempt < kMaxReadRetries && !stable; ++attempt) {
+                stable = firm_risk_try_read_security(*shm_, slot, security);
+            }
+            if (stable && static_cast<__uint128_t>(security.holding_volume) + order.volume_entrust >
+                              static_cast<__uint128_t>(max_security_volume_)) {
+                return risk_check_result::reject(RiskResult::RejectFirmLimit,
+                                                 risk_message_id::FirmSecurityConcentrationExceeded);
+            }
+        } else if (order.volume_entrust > max_security_volume_) {
+            // 聚合段尚无该证券：全公司持仓为 0，本单数量即集中度
+            return risk_check_result::reject(RiskResult::RejectFirmLimit,
+                                             risk_message_id::FirmSecurityConcentrationExceeded);
+        }
+    }
+
+    return risk_check_result::pass();
+}
+
+void firm_exposure_rule::attach(const firm_risk_shm_layout* shm) noexcept {
+    shm_ = shm;
+    std::fill_n(slot_by_handle_.get(), kMaxPositions, kUnresolvedSlot);
+}
+
+void firm_exposure_rule::set_limits(DValue max_gross_value, Volume max_security_volume) noexcept {
+    max_gross_value_ = max_gross_value;
+    max_security_volume_ = max_security_volume;
+}
+
+// 槽位一经登记不再迁移，命中后按句柄缓存；未登记的证券不缓存，聚合进程登记后即可被探测到
+uint32_t firm_exposure_rule::resolve_slot(const OrderRequest& order) noexcept {
+    const SecurityHandle handle = order.security_handle;
+    const bool cacheable = handle != kInvalidSecurityHandle && handle < kMaxPositions;
+    if (cacheable && slot_by_handle_[handle] != kUnresolvedSlot) {
+        return slot_by_handle_[handle];
+    }
+    const std::size_t slot = firm_risk_find_security(*shm_, order.internal_security_id);
+    if (slot == kInvalidFirmRiskSlot) {
+        return kUnresolvedSlot;
+    }
+    if (cacheable) {
+        slot_by_handle_[handle] = static_cast<uint32_t>(slot);
+    }
+    return static_cast<uint32_t>(slot);
+}
+
+price_limit_rule::price_limit_rule()
+    : bands_by_security_(kMaxPriceBands),
+      bands_by_handle_(std::make_unique<price_band[]>(kMaxPositions)),
+      handle_state_(std::make_unique<band_state[]>(kMaxPositions)) {}
+
+risk_check_result price_limit_rule::check(const OrderRequest& order, const PositionManager& positions) {
+    (void)positions;
+    if (!enabled_ || !is_new_order(order) || bands_by_security_.empty()) {
         return risk_check_result::pass();
     }
 
-    const DPrice limit_up = it->second.first;
-    const DPrice limit_down = it->second.second;
-    if ((limit_up != 0 && order.dprice_entrust > limit_up) || (limit_down != 0 && order.dprice_entrust < limit_down)) {
-        return risk_check_result::reject(RiskResult::RejectPriceOutOfRange, "price is out of limit range");
+    const price_band* band = find_band(order);
+    if (band && out_of_band(*band, order.dprice_entrust)) {
+        return risk_check_result::reject(RiskResult::RejectPriceOutOfRange, risk_message_id::PriceOutOfRange);
     }
 
     return risk_check_result::pass();
 }
 
-void price_limit_rule::set_price_limits(InternalSecurityId security_id, DPrice limit_up, DPrice limit_down) {
+uint64_t price_limit_rule::reject_mask(const OrderRequest* orders, const risk_batch_columns& columns) {
+    if (!enabled_ || bands_by_security_.empty()) {
+        return 0;
+    }
+
+    uint64_t mask = 0;
+    for (std::size_t i = 0; i < columns.count; ++i) {
+        if ((columns.new_mask >> i) & 1U) {
+            const price_band* band = find_band(orders[i]);
+            mask |= static_cast<uint64_t>(band != nullptr && out_of_band(*band, columns.price[i])) << i;
+        }
+    }
+    return mask;
+}
+
+bool price_limit_rule::set_price_limits(InternalSecurityId security_id, DPrice limit_up, DPrice limit_down) {
+    if (!insert_band(security_id, limit_up, limit_down)) {
+        return false;
+    }
+    reset_handle_cache();
+    return true;
+}
+
+std::size_t price_limit_rule::replace_price_limits(const std::vector<price_limit_entry>& entries) {
+    bands_by_security_.clear();
+    std::size_t applied = 0;
+    for (const price_limit_entry& entry : entries) {
+        applied += insert_band(entry.internal_security_id, entry.limit_up, entry.limit_down) ? 1 : 0;
+    }
+    reset_handle_cache();
+    return applied;
+}
+
+bool price_limit_rule::insert_band(InternalSecurityId security_id, DPrice limit_up, DPrice limit_down) {
     InternalSecurityId normalized_security_id;
     if (!normalize_internal_security_id(security_id.view(), normalized_security_id)) {
+        return false;
+    }
+    return bands_by_security_.insert_or_assign(normalized_security_id, price_band{limit_up, limit_down});
+}
+
+void price_limit_rule::clear_price_limits() {
+    bands_by_security_.clear();
+    reset_handle_cache();
+}
+
+const price_band* price_limit_rule::find_band(const OrderRequest& order) {
+    const SecurityHandle handle = order.security_handle;
+    const bool cacheable = handle != kInvalidSecurityHandle && handle < kMaxPositions;
+    if (cacheable) {
+        const band_state state = handle_state_[handle];
+        if (state == band_state::Set) {
+            return &bands_by_handle_[handle];
+        }
+        if (state == band_state::None) {
+            return nullptr;
+        }
+    }
+
+    // 慢路径：未建档证券每次查表，已建档证券只在首次命中时查表并回填句柄缓存
+    InternalSecurityId security_id;
+    const price_band* band = nullptr;
+    if (normalize_internal_security_id(order.internal_security_id.view(), security_id)) {
+        band = bands_by_security_.find(security_id);
+    }
+    if (!cacheable) {
+        return band;
+    }
+    if (!band) {
+        handle_state_[handle] = band_state::None;
+        return nullptr;
+    }
+    bands_by_handle_[handle] = *band;
+    handle_state_[handle] = band_state::Set;
+    return &bands_by_handle_[handle];
+}
+
+bool price_limit_rule::out_of_band(const price_band& band, DPrice price) noexcept {
+    return (band.limit_up != 0 && price > band.limit_up) || (band.limit_down != 0 && price < band.limit_down);
+}
+
+void price_limit_rule::reset_handle_cache() noexcept {
+    std::fill_n(handle_state_.get(), kMaxPositions, band_state::Unresolved);
+}
+
+risk_check_result self_trade_rule::check(const OrderRequest& order, const PositionManager& positions) {
+    (void)positions;
+    const SecurityHandle handle = order.security_handle;
+    if (!enabled_ || !quotes_ || !is_new_order(order) || handle == kInvalidSecurityHandle || handle >= kMaxPositions) {
+        return risk_check_result::pass();
+    }
+
+    const security_quote& quote = quotes_[handle];
+    const DPrice price = order.dprice_entrust;
+    bool crosses = false;
+    if (order.trade_side == TradeSide::Buy) {
+        crosses = quote.best_ask != 0 && (price == 0 || price >= quote.best_ask);
+    } else if (order.trade_side == TradeSide::Sell) {
+        crosses = quote.best_bid != 0 && (price == 0 || price <= quote.best_bid);
+    }
+    if (crosses) {
+        return risk_check_result::reject(RiskResult::RejectSelfTrade, risk_message_id::SelfTrade);
+    }
+    return risk_check_result::pass();
+}
+
+void self_trade_rule::reserve_resting_orders(std::size_t capacity) {
+    quotes_ = std::make_unique<security_quote[]>(kMaxPositions);
+    levels_ = std::make_unique<std::vector<price_level>[]>(kMaxPositions * 2);
+    resting_ = std::make_unique<flat_hash_map<InternalOrderId, resting_order>>(std::max<std::size_t>(capacity, 1) * 2);
+}
+
+// 状态推进而价位不变是常见路径，只做一次查表
+void self_trade_rule::on_order_update(const OrderRequest& order) {
+    if (!resting_) {
         return;
     }
-    limits_[normalized_security_id] = std::make_pair(limit_up, limit_down);
+
+    const bool rests = is_resting(order);
+    if (const resting_order* tracked = resting_->find(order.internal_order_id)) {
+        if (rests && tracked->price == order.dprice_entrust) {
+            return;
+        }
+        remove_level(*tracked);
+        (void)resting_->erase(order.internal_order_id);
+    }
+    if (!rests) {
+        return;
+    }
+
+    const resting_order entry{order.dprice_entrust, order.security_handle, order.trade_side};
+    if (resting_->insert_or_assign(order.internal_order_id, entry)) {
+        add_level(entry);
+    }
+}
+
+void self_trade_rule::on_order_removed(InternalOrderId order_id) {
+    if (!resting_) {
+        return;
+    }
+    if (const resting_order* tracked = resting_->find(order_id)) {
+        remove_level(*tracked);
+        (void)resting_->erase(order_id);
+    }
+}
+
+void self_trade_rule::clear_resting_orders() {
+    if (!resting_) {
+        return;
+    }
+    resting_->clear();
+    std::fill_n(quotes_.get(), kMaxPositions, security_quote{});
+    for (std::size_t index = 0; index < kMaxPositions * 2; ++index) {
+        levels_[index].clear();
+    }
+}
+
+DPrice self_trade_rule::best_bid(SecurityHandle handle) const noexcept {
+    return quotes_ && handle < kMaxPositions ? quotes_[handle].best_bid : 0;
+}
+
+DPrice self_trade_rule::best_ask(SecurityHandle handle) const noexcept {
+    return quotes_ && handle < kMaxPositions ? quotes_[handle].best_ask : 0;
+}
+
+bool self_trade_rule::is_resting(const OrderRequest& order) noexcept {
+    if (order.order_type != OrderType::New || order.dprice_entrust == 0 ||
+        order.security_handle == kInvalidSecurityHandle || order.security_handle >= kMaxPositions ||
+        (order.trade_side != TradeSide::Buy && order.trade_side != TradeSide::Sell) ||
+        order.volume_traded >= order.volume_entrust) {
+        return false;
+    }
+
+    switch (order.order_state.load(std::memory_order_acquire)) {
+        case OrderState::RiskControllerAccepted:
+        case OrderState::TraderPending:
+        case OrderState::TraderSubmitted:
+        case OrderState::BrokerAccepted:
+        case OrderState::MarketAccepted:
+            return true;
+        default:
+            return false;
+    }
+}
+
+std::vector<self_trade_rule::price_level>& self_trade_rule::levels_of(SecurityHandle handle, TradeSide side) noexcept {
+    return levels_[static_cast<std::size_t>(handle) * 2 + (side == TradeSide::Sell ? 1 : 0)];
+}
+
+void self_trade_rule::add_level(const resting_order& order) {
+    std::vector<price_level>& levels = levels_of(order.handle, order.side);
+    const bool buy = order.side == TradeSide::Buy;
+    auto it = levels.begin();
+    while (it != levels.end() && (buy ? it->price > order.price : it->price < order.price)) {
+        ++it;
+    }
+    if (it != levels.end() && it->price == order.price) {
+        ++it->count;
+    } else {
+        levels.insert(it, price_level{order.price, 1});
+    }
+    refresh_quote(order.handle, order.side);
 }
 
-void price_limit_rule::clear_price_limits() { limits_.clear(); }
+void self_trade_rule::remove_level(const resting_order& order) noexcept {
+    std::vector<price_level>& levels = levels_of(order.handle, order.side);
+    for (auto it = levels.begin(); it != levels.end(); ++it) {
+        if (it->price == order.price) {
+            if (--it->count == 0) {
+                levels.erase(it);
+            }
+            break;
+        }
+    }
+    refresh_quote(order.handle, order.side);
+}
 
-const char* duplicate_order_rule::name() const noexcept { return "duplicate_order"; }
+void self_trade_rule::refresh_quote(SecurityHandle handle, TradeSide side) noexcept {
+    const std::vector<price_level>& levels = levels_of(handle, side);
+    const DPrice best = levels.empty() ? 0 : levels.front().price;
+    if (side == TradeSide::Buy) {
+        quotes_[handle].best_bid = best;
+    } else {
+        quotes_[handle].best_ask = best;
+    }
+}
+
+duplicate_order_rule::duplicate_order_rule() : history_(std::make_unique<history_slot[]>(kHistoryCapacity)) {}
 
 risk_check_result duplicate_order_rule::check(const OrderRequest& order, const PositionManager& positions) {
     (void)positions;
@@ -149,58 +570,144 @@ risk_check_result duplicate_order_rule::check(const OrderRequest& order, const P
         return risk_check_result::pass();
     }
 
-    const TimestampNs now = now_monotonic_ns();
-    const uint64_t key = make_order_fingerprint(order);
-
-    const auto it = recent_orders_.find(key);
-    if (it != recent_orders_.end() && (now >= it->second) && (now - it->second) <= time_window_ns_) {
-        return risk_check_result::reject(RiskResult::RejectDuplicateOrder, "duplicate order within time window");
+    if (seen_or_insert(make_order_fingerprint(order), now_monotonic_ns())) {
+        return risk_check_result::reject(RiskResult::RejectDuplicateOrder, risk_message_id::DuplicateOrder);
     }
-
-    recent_orders_[key] = now;
     return risk_check_result::pass();
 }
 
 void duplicate_order_rule::record_order(const OrderRequest& order) {
-    recent_orders_[make_order_fingerprint(order)] = now_monotonic_ns();
+    (void)seen_or_insert(make_order_fingerprint(order), now_monotonic_ns());
 }
 
-void duplicate_order_rule::clear_history() { recent_orders_.clear(); }
+void duplicate_order_rule::clear_history() { std::fill_n(history_.get(), kHistoryCapacity, history_slot{}); }
 
 void duplicate_order_rule::set_time_window_ns(TimestampNs window_ns) { time_window_ns_ = window_ns; }
 
-rate_limit_rule::rate_limit_rule(uint32_t max_orders_per_second) : max_orders_per_second_(max_orders_per_second) {}
+bool duplicate_order_rule::is_live(const history_slot& slot, TimestampNs now) const noexcept {
+    return slot.seen_ns != 0 && now >= slot.seen_ns && (now - slot.seen_ns) <= time_window_ns_;
+}
+
+bool duplicate_order_rule::seen_or_insert(uint64_t fingerprint, TimestampNs now) noexcept {
+    static_assert((kHistoryCapacity & (kHistoryCapacity - 1)) == 0, "history capacity must be power of two");
+    constexpr std::size_t kMask = kHistoryCapacity - 1;
+
+    const std::size_t home = flat_hash<uint64_t>{}(fingerprint) & kMask;
+    history_slot* victim = nullptr;
+    for (std::size_t probe = 0; probe < kProbeWindow; ++probe) {
+        history_slot& slot = history_[(home + probe) & kMask];
+        const bool live = is_live(slot, now);
+        if (live && slot.fingerprint == fingerprint) {
+            return true;
+        }
+        if (!live) {
+            if (!victim || is_live(*victim, now)) {
+                victim = &slot;
+            }
+        } else if (!victim || (is_live(*victim, now) && slot.seen_ns < victim->seen_ns)) {
+            victim = &slot;
+        }
+    }
 
-const char* rate_limit_rule::name() const noexcept { return "rate_limit"; }
+    victim->fingerprint = fingerprint;
+    victim->seen_ns = now;
+    return false;
+}
+
+rate_limit_rule::rate_limit_rule(uint32_t max_orders_per_second)
+    : strategy_buckets_(kMaxStrategyBuckets), security_buckets_(std::make_unique<token_bucket[]>(kMaxPositions)) {
+    set_max_orders_per_second(max_orders_per_second);
+}
 
-risk_check_result rate_limit_rule::check(const OrderRequest& order, const PositionManager& positions) {
+risk_check_result rate_limit_rule::check(const OrderRequest& order, const PositionManager& positions,
+                                         StrategyId strategy_id) {
     (void)positions;
-    if (!enabled_ || !is_new_order(order) || max_orders_per_second_ == 0) {
+    if (!enabled_ || !is_new_order(order)) {
         return risk_check_result::pass();
     }
 
-    constexpr TimestampNs kSecondNs = 1000000000ULL;
     const TimestampNs now = now_monotonic_ns();
-    const TimestampNs window_start = current_second_start_.load(std::memory_order_relaxed);
+    token_bucket* account = account_spec_.enabled() ? &account_bucket_ : nullptr;
+    if (account && !refill(*account, account_spec_, now)) {
+        return risk_check_result::reject(RiskResult::RejectUnknown, risk_message_id::RateLimitExceeded);
+    }
 
-    if (window_start == 0 || now < window_start || (now - window_start) >= kSecondNs) {
-        current_second_start_.store(now, std::memory_order_relaxed);
-        current_second_count_.store(0, std::memory_order_relaxed);
+    // 策略桶表满时该策略只受账户级约束
+    token_bucket* strategy = strategy_spec_.enabled() ? strategy_buckets_.try_emplace(strategy_id) : nullptr;
+    if (strategy && !refill(*strategy, strategy_spec_, now)) {
+        return risk_check_result::reject(RiskResult::RejectUnknown, risk_message_id::StrategyRateLimitExceeded);
     }
 
-    const uint32_t count = current_second_count_.fetch_add(1, std::memory_order_relaxed) + 1;
-    if (count > max_orders_per_second_) {
-        return risk_check_result::reject(RiskResult::RejectUnknown, "order rate exceeds limit");
+    // 未解析持仓行句柄的订单不做证券级限速
+    token_bucket* security = (security_spec_.enabled() && order.security_handle != kInvalidSecurityHandle &&
+                              order.security_handle < kMaxPositions)
+                                 ? &security_buckets_[order.security_handle]
+                                 : nullptr;
+    if (security && !refill(*security, security_spec_, now)) {
+        return risk_check_result::reject(RiskResult::RejectUnknown, risk_message_id::SecurityRateLimitExceeded);
     }
 
+    for (token_bucket* bucket : {account, strategy, security}) {
+        if (bucket) {
+            bucket->tokens -= kTokenBucketUnit;
+        }
+    }
     return risk_check_result::pass();
 }
 
-void rate_limit_rule::set_max_orders_per_second(uint32_t max) { max_orders_per_second_ = max; }
+void rate_limit_rule::set_limits(uint32_t account_per_second, uint32_t strategy_per_second,
+                                 uint32_t security_per_second, uint32_t burst_ms) {
+    burst_ms_ = burst_ms == 0 ? kDefaultBurstMs : burst_ms;
+    account_spec_ = make_spec(account_per_second, burst_ms_);
+    strategy_spec_ = make_spec(strategy_per_second, burst_ms_);
+    security_spec_ = make_spec(security_per_second, burst_ms_);
+    reset_counter();
+}
+
+void rate_limit_rule::set_max_orders_per_second(uint32_t max) {
+    account_spec_ = make_spec(max, burst_ms_);
+    account_bucket_ = token_bucket{};
+}
+
+bool rate_limit_rule::has_limits() const noexcept {
+    return account_spec_.enabled() || strategy_spec_.enabled() || security_spec_.enabled();
+}
 
 void rate_limit_rule::reset_counter() {
-    current_second_count_.store(0, std::memory_order_relaxed);
-    current_second_start_.store(0, std::memory_order_relaxed);
+    account_bucket_ = token_bucket{};
+    strategy_buckets_.clear();
+    std::fill_n(security_buckets_.get(), kMaxPositions, token_bucket{});
+}
+
+token_bucket_spec rate_limit_rule::make_spec(uint32_t per_second, uint32_t burst_ms) noexcept {
+    token_bucket_spec spec;
+    if (per_second == 0) {
+        return spec;
+    }
+    spec.rate = per_second;
+    // 桶深 = rate * burst_ms / 1000 个令牌，至少 1 个；饱和到 UINT64_MAX / 2 防止补充时溢出
+    __uint128_t tokens = static_cast<__uint128_t>(per_second) * burst_ms / 1000;
+    if (tokens == 0) {
+        tokens = 1;
+    }
+    const __uint128_t capacity = tokens * kTokenBucketUnit;
+    spec.capacity = capacity > (UINT64_MAX / 2) ? (UINT64_MAX / 2) : static_cast<uint64_t>(capacity);
+    return spec;
+}
+
+bool rate_limit_rule::refill(token_bucket& bucket, const token_bucket_spec& spec, TimestampNs now) noexcept {
+    if (bucket.last_refill_ns == 0) {
+        bucket.tokens = spec.capacity;
+        bucket.last_refill_ns = now;
+    } else if (now > bucket.last_refill_ns) {
+        // 先把 elapsed 截断到装满所需时长，保证乘法不溢出
+        const uint64_t missing = spec.capacity - bucket.tokens;
+        const uint64_t fill_ns = missing / spec.rate + 1;
+        const uint64_t elapsed = std::min<uint64_t>(now - bucket.last_refill_ns, fill_ns);
+        bucket.tokens = std::min<uint64_t>(spec.capacity, bucket.tokens + elapsed * spec.rate);
+        bucket.last_refill_ns = now;
+    }
+    return bucket.tokens >= kTokenBucketUnit;
 }
 
 }  // namespace acct_service
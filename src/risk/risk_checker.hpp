@@ -1,115 +1,476 @@
 #pragma once
 
 #include <atomic>
-#include <string>
-#include <unordered_map>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <tuple>
+#include <vector>
 
+#include "common/flat_hash_map.hpp"
 #include "common/types.hpp"
 #include "order/order_request.hpp"
+#include "portfolio/position_loader.hpp"
 #include "portfolio/position_manager.hpp"
 
 namespace acct_service {
 
-// 风控检查结果
+struct firm_risk_shm_layout;
+
+// 风控拒绝原因的静态消息编号，文本由 to_string 查表，拒绝路径不构造字符串
+enum class risk_message_id : uint8_t {
+    Pass = 0,
+    InsufficientFund,
+    InsufficientPosition,
+    ExceedMaxOrderValue,
+    ExceedMaxOrderVolume,
+    ExceedDailyTurnover,
+    PriceOutOfRange,
+    DuplicateOrder,
+    RateLimitExceeded,
+    StrategyRateLimitExceeded,
+    SecurityRateLimitExceeded,
+    SelfTrade,
+    FirmGrossExposureExceeded,
+    FirmSecurityConcentrationExceeded,
+    OrderToTradeRatioExceeded,
+    CancelRatioExceeded,
+    StrategyPaused,
+};
+
+const char* to_string(risk_message_id id) noexcept;
+
+// 风控检查结果：拒绝码 + 静态消息编号，可平凡拷贝
 struct risk_check_result {
     RiskResult code = RiskResult::Pass;
-    std::string message;
+    risk_message_id message_id = risk_message_id::Pass;
+
+    constexpr bool passed() const noexcept { return code == RiskResult::Pass; }
+    const char* message() const noexcept { return to_string(message_id); }
+    static constexpr risk_check_result pass() noexcept { return risk_check_result{}; }
+    static constexpr risk_check_result reject(RiskResult code, risk_message_id id) noexcept {
+        return risk_check_result{code, id};
+    }
+};
+
+// 批量风控单批上限，与掩码位宽一致
+inline constexpr std::size_t kRiskBatchSize = 64;
+
+// 批量风控的候选订单列存：无状态规则在这些连续数组上做无分支比较，便于编译器向量化
+struct risk_batch_columns {
+    std::size_t count = 0;
+    uint64_t new_mask = 0;  // bit i = 第 i 笔为新单
+    Volume volume[kRiskBatchSize]{};
+    DPrice price[kRiskBatchSize]{};
 
-    bool passed() const noexcept;
-    static risk_check_result pass();
-    static risk_check_result reject(RiskResult code, std::string msg);
+    void load(const OrderRequest* orders, std::size_t n) noexcept;
 };
 
-// 风控规则基类
-class risk_rule {
+// 规则公共开关；具体规则不走虚函数，由 risk_rule_chain 按静态类型直接调用
+class risk_rule_base {
 public:
-    virtual ~risk_rule() = default;
-    virtual const char* name() const noexcept = 0;
-    virtual risk_check_result check(const OrderRequest& order, const PositionManager& positions) = 0;
-    virtual bool enabled() const noexcept;
-    virtual void set_enabled(bool enabled);
+    bool enabled() const noexcept { return enabled_; }
+    void set_enabled(bool enabled) noexcept { enabled_ = enabled; }
 
 protected:
     bool enabled_ = true;
 };
 
 // 资金检查
-class fund_check_rule : public risk_rule {
+class fund_check_rule : public risk_rule_base {
 public:
-    const char* name() const noexcept override;
-    risk_check_result check(const OrderRequest& order, const PositionManager& positions) override;
+    static constexpr const char* kName = "fund_check";
+    const char* name() const noexcept { return kName; }
+    risk_check_result check(const OrderRequest& order, const PositionManager& positions);
 };
 
 // 持仓检查
-class position_check_rule : public risk_rule {
+class position_check_rule : public risk_rule_base {
 public:
-    const char* name() const noexcept override;
-    risk_check_result check(const OrderRequest& order, const PositionManager& positions) override;
+    static constexpr const char* kName = "position_check";
+    const char* name() const noexcept { return kName; }
+    risk_check_result check(const OrderRequest& order, const PositionManager& positions);
 };
 
 // 单笔金额限制
-class max_order_value_rule : public risk_rule {
+class max_order_value_rule : public risk_rule_base {
 public:
-    explicit max_order_value_rule(DValue max_value);
-    const char* name() const noexcept override;
-    risk_check_result check(const OrderRequest& order, const PositionManager& positions) override;
+    explicit max_order_value_rule(DValue max_value = 0);
+    static constexpr const char* kName = "max_order_value";
+    const char* name() const noexcept { return kName; }
+    risk_check_result check(const OrderRequest& order, const PositionManager& positions);
+    // 批量判定，返回拒绝位掩码；规则关闭时恒为 0
+    uint64_t reject_mask(const risk_batch_columns& columns) const noexcept;
     void set_max_value(DValue max_value);
+    DValue max_value() const noexcept { return max_value_; }
 
 private:
     DValue max_value_;
 };
 
 // 单笔数量限制
-class max_order_volume_rule : public risk_rule {
+class max_order_volume_rule : public risk_rule_base {
 public:
-    explicit max_order_volume_rule(Volume max_volume);
-    const char* name() const noexcept override;
-    risk_check_result check(const OrderRequest& order, const PositionManager& positions) override;
+    explicit max_order_volume_rule(Volume max_volume = 0);
+    static constexpr const char* kName = "max_order_volume";
+    const char* name() const noexcept { return kName; }
+    risk_check_result check(const OrderRequest& order, const PositionManager& positions);
+    uint64_t reject_mask(const risk_batch_columns& columns) const noexcept;
     void set_max_volume(Volume max_volume);
+    Volume max_volume() const noexcept { return max_volume_; }
 
 private:
     Volume max_volume_;
 };
 
-// 涨跌停价格检查
-class price_limit_rule : public risk_rule {
+// 当日成交额上限：已成交买卖额（PositionManager 增量累计）+ 在途买单冻结资金 + 本单金额，O(1) 判定
+class max_daily_turnover_rule : public risk_rule_base {
+public:
+    explicit max_daily_turnover_rule(DValue max_turnover = 0);
+    static constexpr const char* kName = "max_daily_turnover";
+    const char* name() const noexcept { return kName; }
+    risk_check_result check(const OrderRequest& order, const PositionManager& positions);
+    void set_max_turnover(DValue max_turnover);
+
+private:
+    DValue max_turnover_;
+};
+
+// 申报比例限制：读 PositionManager 增量维护的申报流量（新单 / 撤单 / 成交回报笔数），账户合计与本单证券行
+// 任一超限即拒绝新单，O(1) 判定。委托成交比 = (新单数 + 本单) / max(成交回报数, 1)，撤单率 = 撤单数 / 新单数；
+// 新单数达到 min_orders 后才判定，避免开盘头几笔的比例失真。撤单不受限，成交或撤单回落后自动恢复放行
+class order_ratio_rule : public risk_rule_base {
+public:
+    static constexpr const char* kName = "order_ratio";
+
+    const char* name() const noexcept { return kName; }
+    risk_check_result check(const OrderRequest& order, const PositionManager& positions);
+    // 0 表示该项不限
+    void set_limits(uint32_t max_order_to_trade_ratio, uint32_t max_cancel_ratio_pct, uint32_t min_orders) noexcept;
+    bool has_limits() const noexcept { return max_order_to_trade_ratio_ != 0 || max_cancel_ratio_pct_ != 0; }
+
+private:
+    risk_check_result check_counts(const order_flow_counts& counts) const noexcept;
+
+    uint32_t max_order_to_trade_ratio_ = 0;
+    uint32_t max_cancel_ratio_pct_ = 0;
+    uint32_t min_orders_ = 0;
+};
+
+// 公司级敞口检查：读跨账户聚合进程发布的 firm_risk_shm。总敞口（全部账户已成交买卖额 + 在途冻结资金）
+// 加本单金额超限即拒绝，只做一次合计 seqlock 读；设置单证券持仓上限时，买单再读一次该证券合计，
+// 全部账户持仓加本单数量超限即拒绝，证券槽位按持仓行句柄缓存。合计由聚合进程异步刷新，
+// 不含本账户尚未被拉取的最新变更；未接入合计段或合计持续处于写区间时放行
+class firm_exposure_rule : public risk_rule_base {
 public:
-    const char* name() const noexcept override;
-    risk_check_result check(const OrderRequest& order, const PositionManager& positions) override;
-    void set_price_limits(InternalSecurityId security_id, DPrice limit_up, DPrice limit_down);
+    static constexpr const char* kName = "firm_exposure";
+    static constexpr uint32_t kMaxReadRetries = 64;
+
+    firm_exposure_rule();
+    const char* name() const noexcept { return kName; }
+    risk_check_result check(const OrderRequest& order, const PositionManager& positions);
+
+    // 接入聚合段（nullptr 解除）；切换段时清空证券槽位缓存
+    void attach(const firm_risk_shm_layout* shm) noexcept;
+    bool attached() const noexcept { return shm_ != nullptr; }
+    // 0 表示该项不限
+    void set_limits(DValue max_gross_value, Volume max_security_volume) noexcept;
+    bool has_limits() const noexcept { return max_gross_value_ != 0 || max_security_volume_ != 0; }
+
+private:
+    static constexpr uint32_t kUnresolvedSlot = UINT32_MAX;
+
+    // 订单对应的证券合计槽位；聚合段尚未登记该证券时返回 kUnresolvedSlot，下一笔重新探测
+    uint32_t resolve_slot(const OrderRequest& order) noexcept;
+
+    const firm_risk_shm_layout* shm_ = nullptr;
+    DValue max_gross_value_ = 0;
+    Volume max_security_volume_ = 0;
+    std::unique_ptr<uint32_t[]> slot_by_handle_;  // 按 SecurityHandle 下标
+};
+
+// 单只证券的涨跌停价格带，0 表示该侧不限
+struct price_band {
+    DPrice limit_up = 0;
+    DPrice limit_down = 0;
+};
+
+// 涨跌停价格检查：价格带按证券键存放，首次命中某持仓行句柄后缓存到按句柄下标的稠密表，
+// 之后每笔只做一次数组访问；无价格带的证券同样缓存"无"，不再重复查表
+class price_limit_rule : public risk_rule_base {
+public:
+    static constexpr const char* kName = "price_limit";
+    static constexpr std::size_t kMaxPriceBands = 16384;
+
+    price_limit_rule();
+    const char* name() const noexcept { return kName; }
+    risk_check_result check(const OrderRequest& order, const PositionManager& positions);
+    uint64_t reject_mask(const OrderRequest* orders, const risk_batch_columns& columns);
+    // 设置单只证券价格带；证券键非法或表满返回 false
+    bool set_price_limits(InternalSecurityId security_id, DPrice limit_up, DPrice limit_down);
     void clear_price_limits();
+    // 整表替换价格带，返回成功写入条数
+    std::size_t replace_price_limits(const std::vector<price_limit_entry>& entries);
+    std::size_t price_limit_count() const noexcept { return bands_by_security_.size(); }
+    // 只读遍历全部价格带：fn(const InternalSecurityId&, const price_band&)，键已归一化
+    template <typename Fn>
+    void for_each_band(Fn&& fn) const {
+        bands_by_security_.for_each(fn);
+    }
 
 private:
-    std::unordered_map<InternalSecurityId, std::pair<DPrice, DPrice>> limits_;
+    enum class band_state : uint8_t { Unresolved = 0, None = 1, Set = 2 };
+
+    bool insert_band(InternalSecurityId security_id, DPrice limit_up, DPrice limit_down);
+    // 查找订单对应的价格带，无价格带返回 nullptr
+    const price_band* find_band(const OrderRequest& order);
+    static bool out_of_band(const price_band& band, DPrice price) noexcept;
+    void reset_handle_cache() noexcept;
+
+    flat_hash_map<InternalSecurityId, price_band> bands_by_security_;
+    std::unique_ptr<price_band[]> bands_by_handle_;  // 按 SecurityHandle 下标
+    std::unique_ptr<band_state[]> handle_state_;
 };
 
-// 重复订单检查
-class duplicate_order_rule : public risk_rule {
+// 自成交检查：按持仓行句柄维护本账户在簿新单的最优买价与最优卖价，新买单价格不低于最优卖价、
+// 新卖单价格不高于最优买价即拒绝（市价单对手方有在簿单即拒绝），判定只读一个数组元素。
+// 在簿集合由订单簿变更事件增量维护：风控通过后至终态前、未全部成交且有委托价的新单计入；
+// 各证券每侧按价位计数，价位数通常个位数，增删线性查找。reserve_resting_orders 前规则不生效
+class self_trade_rule : public risk_rule_base {
 public:
-    const char* name() const noexcept override;
-    risk_check_result check(const OrderRequest& order, const PositionManager& positions) override;
+    static constexpr const char* kName = "self_trade";
+
+    const char* name() const noexcept { return kName; }
+    risk_check_result check(const OrderRequest& order, const PositionManager& positions);
+
+    // 按订单簿容量建跟踪表并清空在簿价位
+    void reserve_resting_orders(std::size_t capacity);
+    // 订单状态、成交或价格变更后调用，按最新状态计入、移出或调整价位
+    void on_order_update(const OrderRequest& order);
+    // 订单离开订单簿
+    void on_order_removed(InternalOrderId order_id);
+    void clear_resting_orders();
+
+    bool tracking() const noexcept { return resting_ != nullptr; }
+    std::size_t resting_count() const noexcept { return resting_ ? resting_->size() : 0; }
+    // 证券当前最优在簿买价/卖价，无在簿单为 0
+    DPrice best_bid(SecurityHandle handle) const noexcept;
+    DPrice best_ask(SecurityHandle handle) const noexcept;
+
+private:
+    struct security_quote {
+        DPrice best_bid = 0;
+        DPrice best_ask = 0;
+    };
+
+    struct price_level {
+        DPrice price = 0;
+        uint32_t count = 0;
+    };
+
+    struct resting_order {
+        DPrice price = 0;
+        SecurityHandle handle = kInvalidSecurityHandle;
+        TradeSide side = TradeSide::NotSet;
+    };
+
+    static bool is_resting(const OrderRequest& order) noexcept;
+    // 买方价位按价格降序、卖方升序，首项即最优价
+    std::vector<price_level>& levels_of(SecurityHandle handle, TradeSide side) noexcept;
+    void add_level(const resting_order& order);
+    void remove_level(const resting_order& order) noexcept;
+    void refresh_quote(SecurityHandle handle, TradeSide side) noexcept;
+
+    std::unique_ptr<security_quote[]> quotes_;                         // 按 SecurityHandle 下标
+    std::unique_ptr<std::vector<price_level>[]> levels_;               // 下标 handle * 2 + (卖方 ? 1 : 0)
+    std::unique_ptr<flat_hash_map<InternalOrderId, resting_order>> resting_;  // 已计入价位的在簿订单
+};
+
+// 重复订单检查：固定容量指纹表，按 hash 定位后在短探测窗口内查找，过期槽位视为空闲；
+// 内存与当日订单量无关，窗口内指纹超出容量时淘汰探测窗口内最旧的一条。
+class duplicate_order_rule : public risk_rule_base {
+public:
+    static constexpr const char* kName = "duplicate_order";
+    static constexpr bool kStateful = true;  // check 登记指纹，剖析重排时固定位置
+    static constexpr std::size_t kHistoryCapacity = 65536;  // 必须是 2 的幂
+    static constexpr std::size_t kProbeWindow = 8;
+
+    duplicate_order_rule();
+    const char* name() const noexcept { return kName; }
+    risk_check_result check(const OrderRequest& order, const PositionManager& positions);
     void record_order(const OrderRequest& order);
     void clear_history();
     void set_time_window_ns(TimestampNs window_ns);
 
 private:
-    std::unordered_map<uint64_t, TimestampNs> recent_orders_;
+    struct history_slot {
+        uint64_t fingerprint = 0;
+        TimestampNs seen_ns = 0;  // 0 表示空槽
+    };
+
+    bool is_live(const history_slot& slot, TimestampNs now) const noexcept;
+    // 窗口内已存在返回 true；否则写入（覆盖过期或最旧槽位）并返回 false
+    bool seen_or_insert(uint64_t fingerprint, TimestampNs now) noexcept;
+
+    std::unique_ptr<history_slot[]> history_;
     TimestampNs time_window_ns_ = 100'000'000;  // 100ms
 };
 
-// 流速限制
-class rate_limit_rule : public risk_rule {
+// 令牌桶：整数定点表示，1 个令牌 = kTokenBucketUnit 个单位，每纳秒补充 rate 个单位，亚秒级平滑补充
+inline constexpr uint64_t kTokenBucketUnit = 1'000'000'000ULL;
+
+struct token_bucket {
+    uint64_t tokens = 0;             // 当前余量（单位：令牌 * kTokenBucketUnit）
+    TimestampNs last_refill_ns = 0;  // 0 表示未启用，首次使用时装满
+};
+
+// 令牌桶参数：rate 为每秒补充令牌数，capacity 为桶容量（单位同 token_bucket::tokens）
+struct token_bucket_spec {
+    uint64_t rate = 0;
+    uint64_t capacity = 0;
+
+    bool enabled() const noexcept { return rate != 0; }
+};
+
+// 流速限制：账户 / 策略 / 证券三级令牌桶，三级都有余量才放行并同时扣减
+class rate_limit_rule : public risk_rule_base {
 public:
-    explicit rate_limit_rule(uint32_t max_orders_per_second);
-    const char* name() const noexcept override;
-    risk_check_result check(const OrderRequest& order, const PositionManager& positions) override;
+    static constexpr const char* kName = "rate_limit";
+    static constexpr bool kStateful = true;  // check 扣减令牌，剖析重排时固定位置
+    static constexpr std::size_t kMaxStrategyBuckets = 256;
+    static constexpr uint32_t kDefaultBurstMs = 1000;
+
+    explicit rate_limit_rule(uint32_t max_orders_per_second = 0);
+    const char* name() const noexcept { return kName; }
+    risk_check_result check(const OrderRequest& order, const PositionManager& positions) {
+        return check(order, positions, 0);
+    }
+    risk_check_result check(const OrderRequest& order, const PositionManager& positions, StrategyId strategy_id);
+
+    // 设置三级速率（笔/秒，0 表示该级不限）与桶深（毫秒，0 取 kDefaultBurstMs）
+    void set_limits(uint32_t account_per_second, uint32_t strategy_per_second, uint32_t security_per_second,
+                    uint32_t burst_ms);
     void set_max_orders_per_second(uint32_t max);
+    // 三级中至少一级启用
+    bool has_limits() const noexcept;
     void reset_counter();
 
 private:
-    uint32_t max_orders_per_second_;
-    std::atomic<uint32_t> current_second_count_{0};
-    std::atomic<TimestampNs> current_second_start_{0};
+    static token_bucket_spec make_spec(uint32_t per_second, uint32_t burst_ms) noexcept;
+    // 补充到 now 并返回是否至少有一个令牌
+    static bool refill(token_bucket& bucket, const token_bucket_spec& spec, TimestampNs now) noexcept;
+
+    uint32_t burst_ms_ = kDefaultBurstMs;
+    token_bucket_spec account_spec_;
+    token_bucket_spec strategy_spec_;
+    token_bucket_spec security_spec_;
+    token_bucket account_bucket_;
+    flat_hash_map<StrategyId, token_bucket> strategy_buckets_;
+    std::unique_ptr<token_bucket[]> security_buckets_;  // 按 SecurityHandle 下标
+};
+
+// 静态组合的规则链：规则按模板参数顺序短路执行，调用点可内联，无虚派发
+template <typename... Rules>
+class risk_rule_chain {
+public:
+    static constexpr std::size_t kRuleCount = sizeof...(Rules);
+
+    risk_check_result check(const OrderRequest& order, const PositionManager& positions, StrategyId strategy_id = 0) {
+        return check_from<0>(order, positions, strategy_id);
+    }
+
+    // 按链上下标执行单条规则，供按运行期顺序执行的剖析路径使用；规则关闭时放行且 evaluated 为 false
+    risk_check_result check_at(std::size_t index, const OrderRequest& order, const PositionManager& positions,
+                               StrategyId strategy_id, bool& evaluated) {
+        return check_at_from<0>(index, order, positions, strategy_id, evaluated);
+    }
+
+    static constexpr const char* name_at(std::size_t index) noexcept {
+        constexpr const char* kNames[] = {Rules::kName...};
+        return kNames[index];
+    }
+
+    // check 带副作用的规则（声明 kStateful = true），重排时不能移动
+    static constexpr bool stateful_at(std::size_t index) noexcept {
+        constexpr bool kStatefulRules[] = {stateful<Rules>()...};
+        return kStatefulRules[index];
+    }
+
+    template <typename Rule>
+    Rule& get() noexcept {
+        return std::get<Rule>(rules_);
+    }
+
+    template <typename Rule>
+    const Rule& get() const noexcept {
+        return std::get<Rule>(rules_);
+    }
+
+    // 按链上顺序遍历全部规则：fn(auto& rule)
+    template <typename Fn>
+    void for_each(Fn&& fn) {
+        std::apply([&fn](auto&... rule) { (fn(rule), ...); }, rules_);
+    }
+
+    template <typename Fn>
+    void for_each(Fn&& fn) const {
+        std::apply([&fn](const auto&... rule) { (fn(rule), ...); }, rules_);
+    }
+
+private:
+    template <typename Rule>
+    static constexpr bool stateful() noexcept {
+        if constexpr (requires { Rule::kStateful; }) {
+            return Rule::kStateful;
+        } else {
+            return false;
+        }
+    }
+
+    // 需要来源策略的规则提供三参数 check
+    template <typename Rule>
+    static risk_check_result run_rule(Rule& rule, const OrderRequest& order, const PositionManager& positions,
+                                      StrategyId strategy_id) {
+        if constexpr (requires { rule.check(order, positions, strategy_id); }) {
+            return rule.check(order, positions, strategy_id);
+        } else {
+            return rule.check(order, positions);
+        }
+    }
+
+    template <std::size_t Index>
+    risk_check_result check_from(const OrderRequest& order, const PositionManager& positions, StrategyId strategy_id) {
+        if constexpr (Index == sizeof...(Rules)) {
+            return risk_check_result::pass();
+        } else {
+            auto& rule = std::get<Index>(rules_);
+            if (rule.enabled()) {
+                const risk_check_result result = run_rule(rule, order, positions, strategy_id);
+                if (!result.passed()) {
+                    return result;
+                }
+            }
+            return check_from<Index + 1>(order, positions, strategy_id);
+        }
+    }
+
+    template <std::size_t Index>
+    risk_check_result check_at_from(std::size_t index, const OrderRequest& order, const PositionManager& positions,
+                                    StrategyId strategy_id, bool& evaluated) {
+        if constexpr (Index == sizeof...(Rules)) {
+            evaluated = false;
+            return risk_check_result::pass();
+        } else {
+            if (index != Index) {
+                return check_at_from<Index + 1>(index, order, positions, strategy_id, evaluated);
+            }
+            auto& rule = std::get<Index>(rules_);
+            evaluated = rule.enabled();
+            return evaluated ? run_rule(rule, order, positions, strategy_id) : risk_check_result::pass();
+        }
+    }
+
+    std::tuple<Rules...> rules_;
 };
 
 }  // namespace acct_service
@@ -1,8 +1,11 @@
 #include "risk/risk_manager.hpp"
 
-#include <memory>
+#include <algorithm>
+#include <string>
 #include <string_view>
-#include <utility>
+
+#include "common/time_utils.hpp"
+#include "shm/risk_params_shm.hpp"
 
 namespace acct_service {
 
@@ -15,222 +18,456 @@ void RiskState::reset() {
     rejected_price = 0;
     rejected_value = 0;
     rejected_volume = 0;
+    rejected_turnover = 0;
     rejected_duplicate = 0;
+    rejected_self_trade = 0;
+    rejected_firm_limit = 0;
+    rejected_order_ratio = 0;
     rejected_rate_limit = 0;
+    rejected_rate_limit_account = 0;
+    rejected_rate_limit_strategy = 0;
+    rejected_rate_limit_security = 0;
     last_check_time = 0;
 }
 
-RiskManager::RiskManager(PositionManager& positions, const RiskConfig& config) : positions_(positions), config_(config) {
-    initialize_default_rules();
+RiskManager::RiskManager(PositionManager& positions, const RiskConfig& config, risk_check_hook observer,
+                         risk_stat_counters* counters)
+    : positions_(positions), config_(config), observer_(observer), counters_(counters ? counters : &local_counters_) {
+    configure_rules();
 }
 
-risk_check_result RiskManager::check_order(const OrderRequest& order) {
-    risk_check_result result = risk_check_result::pass();
+risk_check_result RiskManager::check_order(const OrderRequest& order, StrategyId strategy_id) {
+    const risk_check_result result =
+        profiling_ ? check_profiled(order, strategy_id) : rules_.check(order, positions_, strategy_id);
+    finish_check(order, result);
+    return result;
+}
 
-    for (const auto& rule : rules_) {
-        if (!rule || !rule->enabled()) {
+risk_check_result RiskManager::check_profiled(const OrderRequest& order, StrategyId strategy_id) {
+    risk_check_result result = risk_check_result::pass();
+    for (const uint8_t index : rule_order_) {
+        bool evaluated = false;
+        const uint64_t start = tsc_clock::read_ticks();
+        result = rules_.check_at(index, order, positions_, strategy_id, evaluated);
+        if (!evaluated) {
             continue;
         }
-
-        result = rule->check(order, positions_);
+        risk_rule_profile& profile = rule_profiles_[index];
+        profile.ticks += tsc_clock::read_ticks() - start;
+        ++profile.checks;
         if (!result.passed()) {
+            ++profile.rejects;
             break;
         }
     }
 
-    update_stats(result);
-    if (post_check_callback_) {
-        post_check_callback_(order, result);
+    if (config_.rule_reorder_interval > 0 && ++window_checks_ >= config_.rule_reorder_interval) {
+        reorder_rules();
     }
     return result;
 }
 
-std::vector<risk_check_result> RiskManager::check_orders(const std::vector<OrderRequest>& orders) {
-    std::vector<risk_check_result> results;
-    results.reserve(orders.size());
+void RiskManager::reorder_rules() {
+    // 只动首个有副作用规则之前的前缀：前缀内规则集合不变，有副作用的规则仍只在前缀全部放行后执行，
+    // 放行/拒绝结果不变；一笔同时违反多条前缀规则时，报告的拒绝原因可能随顺序变化
+    std::size_t prefix = 0;
+    while (prefix < kRuleCount && !default_risk_rule_chain::stateful_at(rule_order_[prefix])) {
+        ++prefix;
+    }
 
-    for (const OrderRequest& order : orders) {
-        results.push_back(check_order(order));
+    // 单位拒绝耗时 = 本窗口耗时 / 拒绝次数，越小越该靠前；无拒绝的规则排在后面并按单笔耗时升序
+    struct rule_score {
+        uint64_t rejects;
+        uint64_t ticks;
+        uint64_t checks;
+    };
+    std::array<rule_score, kRuleCount> scores{};
+    for (std::size_t index = 0; index < kRuleCount; ++index) {
+        scores[index] = rule_score{rule_profiles_[index].rejects - window_base_[index].rejects,
+                                   rule_profiles_[index].ticks - window_base_[index].ticks,
+                                   rule_profiles_[index].checks - window_base_[index].checks};
     }
+    const auto before = [&scores](uint8_t lhs, uint8_t rhs) {
+        const rule_score& a = scores[lhs];
+        const rule_score& b = scores[rhs];
+        if ((a.rejects == 0) != (b.rejects == 0)) {
+            return a.rejects != 0;
+        }
+        if (a.rejects != 0) {
+            return static_cast<__uint128_t>(a.ticks) * b.rejects < static_cast<__uint128_t>(b.ticks) * a.rejects;
+        }
+        if (a.checks == 0 || b.checks == 0) {
+            return a.checks != 0;
+        }
+        return static_cast<__uint128_t>(a.ticks) * b.checks < static_cast<__uint128_t>(b.ticks) * a.checks;
+    };
+    std::stable_sort(rule_order_.begin(), rule_order_.begin() + static_cast<std::ptrdiff_t>(prefix), before);
 
-    return results;
+    window_base_ = rule_profiles_;
+    window_checks_ = 0;
+    ++rule_reorders_;
 }
 
-void RiskManager::set_post_check_callback(post_check_callback_t callback) { post_check_callback_ = std::move(callback); }
+void RiskManager::reset_rule_order() noexcept {
+    for (std::size_t index = 0; index < kRuleCount; ++index) {
+        rule_order_[index] = static_cast<uint8_t>(index);
+    }
+    window_base_ = rule_profiles_;
+    window_checks_ = 0;
+}
 
-void RiskManager::add_rule(std::unique_ptr<risk_rule> rule) {
-    if (!rule) {
-        return;
+risk_rule_profile RiskManager::rule_profile(const char* name) const noexcept {
+    if (!name) {
+        return {};
     }
+    const std::string_view target(name);
+    for (std::size_t index = 0; index < kRuleCount; ++index) {
+        if (target == default_risk_rule_chain::name_at(index)) {
+            return rule_profiles_[index];
+        }
+    }
+    return {};
+}
 
-    if (auto* as_price_limit = dynamic_cast<price_limit_rule*>(rule.get())) {
-        price_limit_rule_ = as_price_limit;
+std::vector<const char*> RiskManager::rule_order() const {
+    std::vector<const char*> names;
+    names.reserve(kRuleCount);
+    for (const uint8_t index : rule_order_) {
+        names.push_back(default_risk_rule_chain::name_at(index));
     }
-    if (auto* as_duplicate = dynamic_cast<duplicate_order_rule*>(rule.get())) {
-        duplicate_rule_ = as_duplicate;
+    return names;
+}
+
+void RiskManager::register_metrics(metrics_registry& registry) {
+    for (std::size_t index = 0; index < kRuleCount; ++index) {
+        const std::string prefix = std::string("risk.") + default_risk_rule_chain::name_at(index);
+        rule_metrics_[index].checks = registry.add(prefix + ".checks");
+        rule_metrics_[index].rejects = registry.add(prefix + ".rejects");
+        rule_metrics_[index].ticks = registry.add(prefix + ".ticks");
+    }
+    reorders_metric_ = registry.add("risk.rule_reorders");
+}
+
+void RiskManager::publish_rule_metrics() noexcept {
+    if (!profiling_) {
+        return;
+    }
+    for (std::size_t index = 0; index < kRuleCount; ++index) {
+        rule_metrics_[index].checks.set(rule_profiles_[index].checks);
+        rule_metrics_[index].rejects.set(rule_profiles_[index].rejects);
+        rule_metrics_[index].ticks.set(rule_profiles_[index].ticks);
     }
-    if (auto* as_rate_limit = dynamic_cast<rate_limit_rule*>(rule.get())) {
-        rate_limit_rule_ = as_rate_limit;
+    reorders_metric_.set(rule_reorders_);
+}
+
+std::vector<risk_check_result> RiskManager::check_orders(const std::vector<OrderRequest>& orders) {
+    std::vector<risk_check_result> results;
+    results.reserve(orders.size());
+
+    risk_batch_result batch;
+    for (std::size_t offset = 0; offset < orders.size();) {
+        const std::size_t processed = check_order_batch(orders.data() + offset, orders.size() - offset, batch);
+        results.insert(results.end(), batch.results, batch.results + processed);
+        offset += processed;
     }
 
-    rules_.push_back(std::move(rule));
+    return results;
 }
 
-bool RiskManager::remove_rule(const char* name) {
-    if (!name) {
-        return false;
+std::size_t RiskManager::check_order_batch(const OrderRequest* orders, std::size_t count, risk_batch_result& out,
+                                           StrategyId strategy_id) {
+    out.count = 0;
+    out.pass_mask = 0;
+    if (!orders || count == 0) {
+        return 0;
     }
 
-    const std::string_view target(name);
-    for (auto it = rules_.begin(); it != rules_.end(); ++it) {
-        if (*it && std::string_view((*it)->name()) == target) {
-            if (it->get() == price_limit_rule_) {
-                price_limit_rule_ = nullptr;
-            }
-            if (it->get() == duplicate_rule_) {
-                duplicate_rule_ = nullptr;
-            }
-            if (it->get() == rate_limit_rule_) {
-                rate_limit_rule_ = nullptr;
+    batch_columns_.load(orders, count);
+    const std::size_t batch_count = batch_columns_.count;
+    const uint64_t value_mask = rules_.get<max_order_value_rule>().reject_mask(batch_columns_);
+    const uint64_t volume_mask = rules_.get<max_order_volume_rule>().reject_mask(batch_columns_);
+    const uint64_t price_mask = rules_.get<price_limit_rule>().reject_mask(orders, batch_columns_);
+
+    fund_check_rule& fund_rule = rules_.get<fund_check_rule>();
+    position_check_rule& position_rule = rules_.get<position_check_rule>();
+    max_daily_turnover_rule& turnover_rule = rules_.get<max_daily_turnover_rule>();
+    order_ratio_rule& ratio_rule = rules_.get<order_ratio_rule>();
+    firm_exposure_rule& firm_rule = rules_.get<firm_exposure_rule>();
+    self_trade_rule& self_trade = rules_.get<self_trade_rule>();
+    duplicate_order_rule& duplicate_rule = rules_.get<duplicate_order_rule>();
+    rate_limit_rule& rate_rule = rules_.get<rate_limit_rule>();
+
+    for (std::size_t i = 0; i < batch_count; ++i) {
+        const OrderRequest& order = orders[i];
+        const uint64_t bit = uint64_t{1} << i;
+
+        // 按默认规则链顺序短路，保证首个拒绝原因与逐笔路径相同
+        risk_check_result result = risk_check_result::pass();
+        if (fund_rule.enabled()) {
+            result = fund_rule.check(order, positions_);
+        }
+        if (result.passed() && position_rule.enabled()) {
+            result = position_rule.check(order, positions_);
+        }
+        if (result.passed()) {
+            if (value_mask & bit) {
+                result = risk_check_result::reject(RiskResult::RejectExceedMaxOrderValue,
+                                                   risk_message_id::ExceedMaxOrderValue);
+            } else if (volume_mask & bit) {
+                result = risk_check_result::reject(RiskResult::RejectExceedMaxOrderVolume,
+                                                   risk_message_id::ExceedMaxOrderVolume);
             }
-            rules_.erase(it);
-            return true;
         }
+        // 当日成交额与申报比例依赖实时累计值，夹在列式规则之间逐笔执行
+        if (result.passed() && turnover_rule.enabled()) {
+            result = turnover_rule.check(order, positions_);
+        }
+        if (result.passed() && ratio_rule.enabled()) {
+            result = ratio_rule.check(order, positions_);
+        }
+        if (result.passed() && firm_rule.enabled()) {
+            result = firm_rule.check(order, positions_);
+        }
+        if (result.passed() && (price_mask & bit)) {
+            result = risk_check_result::reject(RiskResult::RejectPriceOutOfRange, risk_message_id::PriceOutOfRange);
+        }
+        if (result.passed() && self_trade.enabled()) {
+            result = self_trade.check(order, positions_);
+        }
+        if (result.passed() && duplicate_rule.enabled()) {
+            result = duplicate_rule.check(order, positions_);
+        }
+        if (result.passed() && rate_rule.enabled()) {
+            result = rate_rule.check(order, positions_, strategy_id);
+        }
+
+        out.results[i] = result;
+        if (result.passed()) {
+            out.pass_mask |= bit;
+        }
+        finish_check(order, result);
     }
 
-    return false;
+    out.count = batch_count;
+    return batch_count;
 }
 
 bool RiskManager::enable_rule(const char* name, bool enabled) {
-    risk_rule* rule = get_rule(name);
-    if (!rule) {
-        return false;
-    }
-    rule->set_enabled(enabled);
-    return true;
-}
-
-risk_rule* RiskManager::get_rule(const char* name) {
     if (!name) {
-        return nullptr;
+        return false;
     }
 
     const std::string_view target(name);
-    for (const auto& rule : rules_) {
-        if (rule && std::string_view(rule->name()) == target) {
-            return rule.get();
+    bool found = false;
+    rules_.for_each([&](auto& rule) {
+        if (!found && target == rule.name()) {
+            rule.set_enabled(enabled);
+            found = true;
         }
+    });
+    if (found) {
+        publish_risk_params();
     }
-
-    return nullptr;
+    return found;
 }
 
-const risk_rule* RiskManager::get_rule(const char* name) const {
+bool RiskManager::rule_enabled(const char* name) const {
     if (!name) {
-        return nullptr;
+        return false;
     }
 
     const std::string_view target(name);
-    for (const auto& rule : rules_) {
-        if (rule && std::string_view(rule->name()) == target) {
-            return rule.get();
+    bool enabled = false;
+    rules_.for_each([&](const auto& rule) {
+        if (target == rule.name()) {
+            enabled = rule.enabled();
         }
-    }
-
-    return nullptr;
+    });
+    return enabled;
 }
 
-void RiskManager::update_price_limits(InternalSecurityId security_id, DPrice limit_up, DPrice limit_down) {
-    if (price_limit_rule_) {
-        price_limit_rule_->set_price_limits(security_id, limit_up, limit_down);
+bool RiskManager::update_price_limits(InternalSecurityId security_id, DPrice limit_up, DPrice limit_down) {
+    if (!rules_.get<price_limit_rule>().set_price_limits(security_id, limit_up, limit_down)) {
+        return false;
     }
+    publish_risk_params();
+    return true;
 }
 
 void RiskManager::clear_price_limits() {
-    if (price_limit_rule_) {
-        price_limit_rule_->clear_price_limits();
+    rules_.get<price_limit_rule>().clear_price_limits();
+    publish_risk_params();
+}
+
+std::size_t RiskManager::load_price_limits(const std::vector<price_limit_entry>& entries) {
+    const std::size_t applied = rules_.get<price_limit_rule>().replace_price_limits(entries);
+    publish_risk_params();
+    return applied;
+}
+
+void RiskManager::attach_risk_params(risk_params_shm_layout* shm) {
+    risk_params_ = shm;
+    publish_risk_params();
+}
+
+void RiskManager::publish_risk_params() {
+    if (!risk_params_) {
+        return;
     }
+
+    // 规则关闭时按不限发布，与服务端判定保持一致
+    const max_order_value_rule& value_rule = rules_.get<max_order_value_rule>();
+    const max_order_volume_rule& volume_rule = rules_.get<max_order_volume_rule>();
+    const price_limit_rule& band_rule = rules_.get<price_limit_rule>();
+    risk_params_begin_publish(risk_params_);
+    risk_params_->max_order_value = value_rule.enabled() ? value_rule.max_value() : 0;
+    risk_params_->max_order_volume = volume_rule.enabled() ? volume_rule.max_volume() : 0;
+    risk_params_->flags = band_rule.enabled() ? kRiskParamsPriceLimit : 0;
+    if (band_rule.enabled()) {
+        band_rule.for_each_band([this](const InternalSecurityId& id, const price_band& band) {
+            (void)risk_params_put_band(risk_params_, id, band.limit_up, band.limit_down);
+        });
+    }
+    risk_params_end_publish(risk_params_);
+}
+
+void RiskManager::track_resting_orders(std::size_t capacity) {
+    rules_.get<self_trade_rule>().reserve_resting_orders(capacity);
 }
 
 void RiskManager::update_config(const RiskConfig& config) {
     config_ = config;
-    initialize_default_rules();
+    configure_rules();
+    publish_risk_params();
 }
 
 const RiskConfig& RiskManager::config() const noexcept { return config_; }
 
-const RiskState& RiskManager::stats() const noexcept { return stats_; }
+RiskState RiskManager::stats() const noexcept {
+    const risk_stat_counters& counters = *counters_;
+    RiskState state;
+    state.passed = counters.passed.load(std::memory_order_relaxed);
+    state.rejected_fund = counters.rejected_fund.load(std::memory_order_relaxed);
+    state.rejected_position = counters.rejected_position.load(std::memory_order_relaxed);
+    state.rejected_price = counters.rejected_price.load(std::memory_order_relaxed);
+    state.rejected_value = counters.rejected_value.load(std::memory_order_relaxed);
+    state.rejected_volume = counters.rejected_volume.load(std::memory_order_relaxed);
+    state.rejected_turnover = counters.rejected_turnover.load(std::memory_order_relaxed);
+    state.rejected_duplicate = counters.rejected_duplicate.load(std::memory_order_relaxed);
+    state.rejected_self_trade = counters.rejected_self_trade.load(std::memory_order_relaxed);
+    state.rejected_firm_limit = counters.rejected_firm_limit.load(std::memory_order_relaxed);
+    state.rejected_order_ratio = counters.rejected_order_ratio.load(std::memory_order_relaxed);
+    state.rejected_rate_limit_account = counters.rejected_rate_limit_account.load(std::memory_order_relaxed);
+    state.rejected_rate_limit_strategy = counters.rejected_rate_limit_strategy.load(std::memory_order_relaxed);
+    state.rejected_rate_limit_security = counters.rejected_rate_limit_security.load(std::memory_order_relaxed);
+    state.rejected_rate_limit = state.rejected_rate_limit_account + state.rejected_rate_limit_strategy +
+                                state.rejected_rate_limit_security +
+                                counters.rejected_rate_limit_other.load(std::memory_order_relaxed);
+    state.rejected = state.rejected_fund + state.rejected_position + state.rejected_price + state.rejected_value +
+                     state.rejected_volume + state.rejected_turnover + state.rejected_duplicate +
+                     state.rejected_self_trade + state.rejected_firm_limit + state.rejected_order_ratio +
+                     state.rejected_rate_limit;
+    state.total_checks = state.passed + state.rejected;
+    state.last_check_time = counters.last_check_time.load(std::memory_order_relaxed);
+    return state;
+}
 
-void RiskManager::reset_stats() noexcept { stats_.reset(); }
+void RiskManager::reset_stats() noexcept { counters_->reset(); }
 
-void RiskManager::initialize_default_rules() {
-    rules_.clear();
-    price_limit_rule_ = nullptr;
-    duplicate_rule_ = nullptr;
-    rate_limit_rule_ = nullptr;
+void RiskManager::configure_rules() {
+    // 配置变化后从链上顺序重新学习
+    profiling_ = config_.profile_rules || config_.rule_reorder_interval > 0;
+    reset_rule_order();
 
-    if (config_.enable_fund_check) {
-        add_rule(std::make_unique<fund_check_rule>());
-    }
+    rules_.get<fund_check_rule>().set_enabled(config_.enable_fund_check);
+    rules_.get<position_check_rule>().set_enabled(config_.enable_position_check);
 
-    if (config_.enable_position_check) {
-        add_rule(std::make_unique<position_check_rule>());
-    }
+    max_order_value_rule& value_rule = rules_.get<max_order_value_rule>();
+    value_rule.set_max_value(config_.max_order_value);
+    value_rule.set_enabled(config_.max_order_value > 0);
 
-    if (config_.max_order_value > 0) {
-        add_rule(std::make_unique<max_order_value_rule>(config_.max_order_value));
-    }
+    max_order_volume_rule& volume_rule = rules_.get<max_order_volume_rule>();
+    volume_rule.set_max_volume(config_.max_order_volume);
+    volume_rule.set_enabled(config_.max_order_volume > 0);
 
-    if (config_.max_order_volume > 0) {
-        add_rule(std::make_unique<max_order_volume_rule>(config_.max_order_volume));
-    }
+    max_daily_turnover_rule& turnover_rule = rules_.get<max_daily_turnover_rule>();
+    turnover_rule.set_max_turnover(config_.max_daily_turnover);
+    turnover_rule.set_enabled(config_.max_daily_turnover > 0);
 
-    if (config_.enable_price_limit_check) {
-        add_rule(std::make_unique<price_limit_rule>());
-    }
+    order_ratio_rule& ratio_rule = rules_.get<order_ratio_rule>();
+    ratio_rule.set_limits(config_.max_order_to_trade_ratio, config_.max_cancel_ratio_pct,
+                          config_.order_ratio_min_orders);
+    ratio_rule.set_enabled(ratio_rule.has_limits());
 
-    if (config_.enable_duplicate_check) {
-        auto duplicate = std::make_unique<duplicate_order_rule>();
-        duplicate->set_time_window_ns(config_.duplicate_window_ns);
-        add_rule(std::move(duplicate));
-    }
+    firm_exposure_rule& firm_rule = rules_.get<firm_exposure_rule>();
+    firm_rule.set_limits(config_.max_firm_gross_value, config_.max_firm_security_volume);
+    firm_rule.set_enabled(firm_rule.has_limits());
 
-    if (config_.max_orders_per_second > 0) {
-        add_rule(std::make_unique<rate_limit_rule>(config_.max_orders_per_second));
-    }
+    rules_.get<price_limit_rule>().set_enabled(config_.enable_price_limit_check);
+    rules_.get<self_trade_rule>().set_enabled(config_.enable_self_trade_check);
+
+    duplicate_order_rule& duplicate_rule = rules_.get<duplicate_order_rule>();
+    duplicate_rule.clear_history();
+    duplicate_rule.set_time_window_ns(config_.duplicate_window_ns);
+    duplicate_rule.set_enabled(config_.enable_duplicate_check);
+
+    rate_limit_rule& rate_rule = rules_.get<rate_limit_rule>();
+    rate_rule.set_limits(config_.max_orders_per_second, config_.max_orders_per_second_per_strategy,
+                         config_.max_orders_per_second_per_security, config_.rate_limit_burst_ms);
+    rate_rule.set_enabled(rate_rule.has_limits());
 }
 
+// 每笔只自增一个分原因计数
 void RiskManager::update_stats(const risk_check_result& result) {
-    ++stats_.total_checks;
-    stats_.last_check_time = now_ns();
+    risk_stat_counters& counters = *counters_;
+    counters.last_check_time.store(now_ns(), std::memory_order_relaxed);
 
     if (result.passed()) {
-        ++stats_.passed;
+        risk_stat_counters::bump(counters.passed);
         return;
     }
 
-    ++stats_.rejected;
     switch (result.code) {
         case RiskResult::RejectInsufficientFund:
-            ++stats_.rejected_fund;
+            risk_stat_counters::bump(counters.rejected_fund);
             break;
         case RiskResult::RejectInsufficientPosition:
-            ++stats_.rejected_position;
+            risk_stat_counters::bump(counters.rejected_position);
             break;
         case RiskResult::RejectPriceOutOfRange:
-            ++stats_.rejected_price;
+            risk_stat_counters::bump(counters.rejected_price);
             break;
         case RiskResult::RejectExceedMaxOrderValue:
-            ++stats_.rejected_value;
+            risk_stat_counters::bump(counters.rejected_value);
             break;
         case RiskResult::RejectExceedMaxOrderVolume:
-            ++stats_.rejected_volume;
+            risk_stat_counters::bump(counters.rejected_volume);
+            break;
+        case RiskResult::RejectExceedDailyLimit:
+            risk_stat_counters::bump(counters.rejected_turnover);
             break;
         case RiskResult::RejectDuplicateOrder:
-            ++stats_.rejected_duplicate;
+            risk_stat_counters::bump(counters.rejected_duplicate);
+            break;
+        case RiskResult::RejectSelfTrade:
+            risk_stat_counters::bump(counters.rejected_self_trade);
+            break;
+        case RiskResult::RejectFirmLimit:
+            risk_stat_counters::bump(counters.rejected_firm_limit);
+            break;
+        case RiskResult::RejectOrderRatio:
+            risk_stat_counters::bump(counters.rejected_order_ratio);
             break;
         default:
-            ++stats_.rejected_rate_limit;
+            if (result.message_id == risk_message_id::StrategyRateLimitExceeded) {
+                risk_stat_counters::bump(counters.rejected_rate_limit_strategy);
+            } else if (result.message_id == risk_message_id::SecurityRateLimitExceeded) {
+                risk_stat_counters::bump(counters.rejected_rate_limit_security);
+            } else if (result.message_id == risk_message_id::RateLimitExceeded) {
+                risk_stat_counters::bump(counters.rejected_rate_limit_account);
+            } else {
+                risk_stat_counters::bump(counters.rejected_rate_limit_other);
+            }
             break;
     }
 }
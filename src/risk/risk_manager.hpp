@@ -1,30 +1,44 @@
 #pragma once
 
-#include <functional>
-#include <memory>
+#include <array>
 #include <vector>
 
+#include "common/metrics_registry.hpp"
 #include "common/types.hpp"
 #include "order/order_request.hpp"
 #include "portfolio/position_manager.hpp"
 #include "risk/risk_checker.hpp"
+#include "risk/risk_stats.hpp"
 
 namespace acct_service {
 
+struct risk_params_shm_layout;
+
 // 风控配置
 struct RiskConfig {
     DValue max_order_value = 0;
     Volume max_order_volume = 0;
     DValue max_daily_turnover = 0;
-    uint32_t max_orders_per_second = 0;
+    uint32_t max_orders_per_second = 0;               // 账户级令牌桶速率，0 表示不限
+    uint32_t max_orders_per_second_per_strategy = 0;  // 单策略令牌桶速率，0 表示不限
+    uint32_t max_orders_per_second_per_security = 0;  // 单证券令牌桶速率，0 表示不限
+    uint32_t rate_limit_burst_ms = 0;                 // 令牌桶深度（毫秒速率），0 表示 1000ms
     bool enable_price_limit_check = true;
     bool enable_duplicate_check = true;
     bool enable_fund_check = true;
     bool enable_position_check = true;
+    bool enable_self_trade_check = false;  // 拒绝与本账户在簿反向单价格交叉的新单
+    DValue max_firm_gross_value = 0;       // 全部账户已成交买卖额 + 在途冻结资金上限，0 表示不限；需接入 firm_risk_shm
+    Volume max_firm_security_volume = 0;   // 全部账户单证券持仓数量上限（仅约束买单），0 表示不限
+    uint32_t max_order_to_trade_ratio = 0;  // 新单笔数 / 成交回报笔数上限（账户与单证券），0 表示不限
+    uint32_t max_cancel_ratio_pct = 0;      // 撤单笔数 / 新单笔数上限（百分比），0 表示不限
+    uint32_t order_ratio_min_orders = 100;  // 新单笔数达到该值后才判定上述比例
     TimestampNs duplicate_window_ns = 100'000'000;
+    bool profile_rules = false;          // 逐笔记录各规则 TSC 耗时与拒绝次数（check_order 路径）
+    uint32_t rule_reorder_interval = 0;  // 每剖析这么多笔按耗时/拒绝率重排无副作用规则，0 保持链上顺序；非 0 时隐含剖析
 };
 
-// 风控统计
+// 风控统计快照，由 risk_stat_counters 汇总得到
 struct RiskState {
     uint64_t total_checks = 0;
     uint64_t passed = 0;
@@ -34,62 +48,161 @@ struct RiskState {
     uint64_t rejected_price = 0;
     uint64_t rejected_value = 0;
     uint64_t rejected_volume = 0;
+    uint64_t rejected_turnover = 0;
     uint64_t rejected_duplicate = 0;
+    uint64_t rejected_self_trade = 0;
+    uint64_t rejected_firm_limit = 0;
+    uint64_t rejected_order_ratio = 0;
     uint64_t rejected_rate_limit = 0;
+    uint64_t rejected_rate_limit_account = 0;
+    uint64_t rejected_rate_limit_strategy = 0;
+    uint64_t rejected_rate_limit_security = 0;
     TimestampNs last_check_time = 0;
 
     void reset();
 };
 
+// 默认规则链，模板参数顺序即短路执行顺序；check_order_batch 按同一顺序展开，调整时需同步
+using default_risk_rule_chain =
+    risk_rule_chain<fund_check_rule, position_check_rule, max_order_value_rule, max_order_volume_rule,
+                    max_daily_turnover_rule, order_ratio_rule, firm_exposure_rule, price_limit_rule, self_trade_rule, duplicate_order_rule,
+                    rate_limit_rule>;
+
+// 批量风控结果：pass_mask 的 bit i 表示第 i 笔通过，results[i] 为逐笔结果
+struct risk_batch_result {
+    std::size_t count = 0;
+    uint64_t pass_mask = 0;
+    risk_check_result results[kRiskBatchSize]{};
+
+    bool passed(std::size_t index) const noexcept { return ((pass_mask >> index) & 1U) != 0; }
+};
+
+// 风控检查观察者：函数指针 + 上下文，构造时指定；bind<T, &T::method>(obj) 在编译期绑定成员函数
+struct risk_check_hook {
+    void (*fn)(void* context, const OrderRequest& order, const risk_check_result& result) = nullptr;
+    void* context = nullptr;
+
+    explicit operator bool() const noexcept { return fn != nullptr; }
+    void operator()(const OrderRequest& order, const risk_check_result& result) const { fn(context, order, result); }
+
+    template <typename T, void (T::*Method)(const OrderRequest&, const risk_check_result&)>
+    static risk_check_hook bind(T* object) noexcept {
+        risk_check_hook hook;
+        hook.fn = [](void* context, const OrderRequest& order, const risk_check_result& result) {
+            (static_cast<T*>(context)->*Method)(order, result);
+        };
+        hook.context = object;
+        return hook;
+    }
+};
+
 // 风控管理器
 class RiskManager {
 public:
-    RiskManager(PositionManager& positions, const RiskConfig& config);
+    // counters 非空时计数直接写入调用方持有的存储（如统计共享内存），否则使用内部计数
+    RiskManager(PositionManager& positions, const RiskConfig& config, risk_check_hook observer = {},
+                risk_stat_counters* counters = nullptr);
     ~RiskManager() = default;
 
     // 禁止拷贝
     RiskManager(const RiskManager&) = delete;
     RiskManager& operator=(const RiskManager&) = delete;
 
-    // 风控检查
-    risk_check_result check_order(const OrderRequest& order);
+    // 风控检查；strategy_id 为订单来源策略，用于策略级限速
+    risk_check_result check_order(const OrderRequest& order, StrategyId strategy_id = 0);
     std::vector<risk_check_result> check_orders(const std::vector<OrderRequest>& orders);
 
-    // 回调
-    using post_check_callback_t = std::function<void(const OrderRequest&, const risk_check_result&)>;
-    void set_post_check_callback(post_check_callback_t callback);
+    // 批量风控：单批最多 kRiskBatchSize 笔，返回本批处理数量。金额/数量/价格等无状态规则先在列存上
+    // 整批求拒绝掩码，资金、持仓、重复单、速率等有状态规则再逐笔执行；拒绝原因与逐笔 check_order 一致
+    std::size_t check_order_batch(const OrderRequest* orders, std::size_t count, risk_batch_result& out,
+                                  StrategyId strategy_id = 0);
 
-    // 规则管理
-    void add_rule(std::unique_ptr<risk_rule> rule);
-    bool remove_rule(const char* name);
+    // 规则管理：规则集合在编译期固定，运行期只切换开关与参数
     bool enable_rule(const char* name, bool enabled);
-    risk_rule* get_rule(const char* name);
-    const risk_rule* get_rule(const char* name) const;
+    bool rule_enabled(const char* name) const;
+
+    template <typename Rule>
+    Rule& rule() noexcept {
+        return rules_.get<Rule>();
+    }
 
-    // 涨跌停价格
-    void update_price_limits(InternalSecurityId security_id, DPrice limit_up, DPrice limit_down);
+    // 涨跌停价格：价格带属于当日数据而非配置，update_config 不会清空
+    bool update_price_limits(InternalSecurityId security_id, DPrice limit_up, DPrice limit_down);
     void clear_price_limits();
+    // 整表替换价格带，返回成功写入条数；可在运行期重复调用以刷新
+    std::size_t load_price_limits(const std::vector<price_limit_entry>& entries);
+
+    // 自成交检查的在簿价位：按订单簿容量建表后由订单簿变更事件驱动，未建表时自成交规则不生效
+    void track_resting_orders(std::size_t capacity);
+    bool tracking_resting_orders() const noexcept { return rules_.get<self_trade_rule>().tracking(); }
+    void on_order_update(const OrderRequest& order) { rules_.get<self_trade_rule>().on_order_update(order); }
+    void on_order_removed(InternalOrderId order_id) { rules_.get<self_trade_rule>().on_order_removed(order_id); }
+
+    // 跨账户合计段：由账户服务在打开 firm_risk_shm 后接入，update_config 不会解除
+    void attach_firm_risk(const firm_risk_shm_layout* shm) noexcept { rules_.get<firm_exposure_rule>().attach(shm); }
+
+    // 无状态风控参数段：接入时立即发布，此后改配置、切换规则开关、变更价格带时整段重发布（nullptr 解除）
+    void attach_risk_params(risk_params_shm_layout* shm);
 
     // 配置
     void update_config(const RiskConfig& config);
     const RiskConfig& config() const noexcept;
 
-    // 统计
-    const RiskState& stats() const noexcept;
+    // 规则剖析（check_order 路径）：按规则名查累计计数；rule_order() 为当前执行顺序的规则名
+    risk_rule_profile rule_profile(const char* name) const noexcept;
+    std::vector<const char*> rule_order() const;
+    uint64_t rule_reorders() const noexcept { return rule_reorders_; }
+    // 在指标表登记 risk.<rule>.checks / rejects / ticks 与 risk.rule_reorders；publish_rule_metrics 写入当前值
+    void register_metrics(metrics_registry& registry);
+    void publish_rule_metrics() noexcept;
+
+    // 统计：按计数现场汇总
+    RiskState stats() const noexcept;
+    const risk_stat_counters& counters() const noexcept { return *counters_; }
     void reset_stats() noexcept;
 
 private:
-    void initialize_default_rules();
+    // 按 RiskConfig 设置各规则开关与参数
+    void configure_rules();
+    // 把单笔金额/数量上限与价格带写入风控参数段，供下单 API 预检
+    void publish_risk_params();
     void update_stats(const risk_check_result& result);
+    // 按 rule_order_ 逐条执行并累计剖析计数，到达重排周期时重排
+    risk_check_result check_profiled(const OrderRequest& order, StrategyId strategy_id);
+    // 按本窗口单位拒绝耗时（耗时 / 拒绝次数）升序重排首个有副作用规则之前的规则
+    void reorder_rules();
+    void reset_rule_order() noexcept;
+    // 记录单笔结果：统计 + 观察者
+    void finish_check(const OrderRequest& order, const risk_check_result& result) {
+        update_stats(result);
+        if (observer_) {
+            observer_(order, result);
+        }
+    }
 
     PositionManager& positions_;
     RiskConfig config_;
-    std::vector<std::unique_ptr<risk_rule>> rules_;
-    RiskState stats_;
-    post_check_callback_t post_check_callback_;
-    price_limit_rule* price_limit_rule_ = nullptr;
-    duplicate_order_rule* duplicate_rule_ = nullptr;
-    rate_limit_rule* rate_limit_rule_ = nullptr;
+    default_risk_rule_chain rules_;
+    risk_batch_columns batch_columns_;  // 批量风控列存，复用避免每批清零
+    risk_check_hook observer_;
+    risk_params_shm_layout* risk_params_ = nullptr;
+
+    static constexpr std::size_t kRuleCount = default_risk_rule_chain::kRuleCount;
+    struct rule_metrics {
+        metric_counter checks;
+        metric_counter rejects;
+        metric_counter ticks;
+    };
+    bool profiling_ = false;
+    std::array<uint8_t, kRuleCount> rule_order_{};                // 剖析路径的执行顺序（链上下标）
+    std::array<risk_rule_profile, kRuleCount> rule_profiles_{};  // 按链上下标的累计计数
+    std::array<risk_rule_profile, kRuleCount> window_base_{};    // 上次重排时的累计计数
+    uint64_t window_checks_ = 0;                                  // 本重排窗口已剖析笔数
+    uint64_t rule_reorders_ = 0;
+    std::array<rule_metrics, kRuleCount> rule_metrics_{};
+    metric_counter reorders_metric_;
+    risk_stat_counters local_counters_;
+    risk_stat_counters* counters_;
 };
 
 }  // namespace acct_service
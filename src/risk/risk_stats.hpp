@@ -0,0 +1,56 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <initializer_list>
+
+#include "common/types.hpp"
+
+namespace acct_service {
+
+// 风控分原因计数：风控线程单写，relaxed 读改写不带 lock 前缀；可放进统计共享内存供监控只读。
+// 每笔检查只自增一个计数，total_checks / rejected 由读端汇总
+struct alignas(64) risk_stat_counters {
+    std::atomic<uint64_t> passed{0};
+    std::atomic<uint64_t> rejected_fund{0};
+    std::atomic<uint64_t> rejected_position{0};
+    std::atomic<uint64_t> rejected_price{0};
+    std::atomic<uint64_t> rejected_value{0};
+    std::atomic<uint64_t> rejected_volume{0};
+    std::atomic<uint64_t> rejected_turnover{0};
+    std::atomic<uint64_t> rejected_duplicate{0};
+    std::atomic<uint64_t> rejected_self_trade{0};
+    std::atomic<uint64_t> rejected_rate_limit_account{0};
+    std::atomic<uint64_t> rejected_rate_limit_strategy{0};
+    std::atomic<uint64_t> rejected_rate_limit_security{0};
+    std::atomic<uint64_t> rejected_rate_limit_other{0};
+    std::atomic<TimestampNs> last_check_time{0};
+    std::atomic<uint64_t> rejected_firm_limit{0};  // 追加在末尾，既有字段偏移不变
+    std::atomic<uint64_t> rejected_order_ratio{0};
+
+    // 单写者自增
+    static void bump(std::atomic<uint64_t>& counter) noexcept {
+        counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    // 清空计数（仅允许写者调用）
+    void reset() noexcept {
+        for (std::atomic<uint64_t>* counter :
+             {&passed, &rejected_fund, &rejected_position, &rejected_price, &rejected_value, &rejected_volume,
+              &rejected_turnover, &rejected_duplicate, &rejected_self_trade, &rejected_rate_limit_account,
+              &rejected_rate_limit_strategy, &rejected_rate_limit_security, &rejected_rate_limit_other,
+              &rejected_firm_limit, &rejected_order_ratio}) {
+            counter->store(0, std::memory_order_relaxed);
+        }
+        last_check_time.store(0, std::memory_order_relaxed);
+    }
+};
+
+// 单条风控规则的剖析计数（风控线程单写，profile_rules 或 rule_reorder_interval 开启时累计）
+struct risk_rule_profile {
+    uint64_t checks = 0;   // 规则实际执行次数（开启且前序规则均放行）
+    uint64_t rejects = 0;  // 其中拒绝次数
+    uint64_t ticks = 0;    // 累计耗时（TSC 周期）
+};
+
+}  // namespace acct_service
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <cerrno>
+#include <string>
+#include <string_view>
+
+#include <signal.h>
+
+#include "common/types.hpp"
+#include "shm/shm_layout.hpp"
+
+namespace acct_service {
+
+// 运维指令段名跟随上游段（运维工具只需知道账户的上游段名）：/upstream_order_shm -> /upstream_order_shm_admin
+inline std::string make_admin_shm_name(std::string_view upstream_name) {
+    std::string name(upstream_name);
+    name += "_admin";
+    return name;
+}
+
+// 判断运维工具进程是否已退出（仅 ESRCH 视为退出）
+inline bool admin_writer_dead(uint32_t pid) noexcept {
+    if (pid == 0) {
+        return true;
+    }
+    return ::kill(static_cast<pid_t>(pid), 0) != 0 && errno == ESRCH;
+}
+
+// 运维工具侧：认领指令环与完成环的唯一使用权，持有者已退出时回收；已被其他存活进程持有时返回 false 并带回其 pid
+inline bool admin_claim_writer(admin_shm_layout* shm, uint32_t pid, uint32_t* holder = nullptr) noexcept {
+    if (!shm || pid == 0) {
+        return false;
+    }
+    uint32_t current = shm->writer_pid.load(std::memory_order_acquire);
+    while (current != pid) {
+        if (current != 0 && !admin_writer_dead(current)) {
+            if (holder) {
+                *holder = current;
+            }
+            return false;
+        }
+        if (shm->writer_pid.compare_exchange_weak(current, pid, std::memory_order_acq_rel,
+                                                  std::memory_order_acquire)) {
+            break;
+        }
+    }
+    return true;
+}
+
+// 释放使用权；仅当前持有者可释放
+inline void admin_release_writer(admin_shm_layout* shm, uint32_t pid) noexcept {
+    if (!shm) {
+        return;
+    }
+    uint32_t expected = pid;
+    (void)shm->writer_pid.compare_exchange_strong(expected, 0, std::memory_order_acq_rel, std::memory_order_relaxed);
+}
+
+// 运维工具侧：投递一条指令，指令环满返回 false。调用方须先以 admin_claim_writer 认领
+inline bool admin_submit(admin_shm_layout* shm, admin_command_type type, uint64_t command_id,
+                         StrategyId strategy_id = 0) noexcept {
+    admin_command command{};
+    command.command_id = command_id;
+    command.submit_ns = now_ns();
+    command.type = type;
+    command.strategy_id = strategy_id;
+    return shm->commands.try_push(command);
+}
+
+// 运维工具侧：取一条完成结果，完成环空返回 false。调用方须先以 admin_claim_writer 认领
+inline bool admin_poll_response(admin_shm_layout* shm, admin_response& out) noexcept {
+    return shm->responses.try_pop(out);
+}
+
+inline constexpr const char* admin_command_name(admin_command_type type) noexcept {
+    switch (type) {
+        case admin_command_type::ReloadConfig:
+            return "reload";
+        case admin_command_type::CancelAll:
+            return "cancel-all";
+        case admin_command_type::CancelStrategy:
+            return "cancel-strategy";
+        case admin_command_type::PauseStrategy:
+            return "pause";
+        case admin_command_type::ResumeStrategy:
+            return "resume";
+        case admin_command_type::DumpState:
+            return "dump";
+        case admin_command_type::Checkpoint:
+            return "checkpoint";
+        case admin_command_type::None:
+            break;
+    }
+    return "unknown";
+}
+
+inline constexpr const char* admin_status_name(admin_command_status status) noexcept {
+    switch (status) {
+        case admin_command_status::Done:
+            return "done";
+        case admin_command_status::Accepted:
+            return "accepted";
+        case admin_command_status::Rejected:
+            return "rejected";
+        case admin_command_status::Unsupported:
+            return "unsupported";
+    }
+    return "unknown";
+}
+
+}  // namespace acct_service
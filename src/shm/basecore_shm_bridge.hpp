@@ -1,5 +1,11 @@
 #pragma once
 
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
 #include <cstdlib>
 #include <string>
 #include <string_view>
@@ -18,8 +24,27 @@ inline bool create_region(std::string_view name, std::size_t size) {
     return shm::create_only(std::string(name), size);
 }
 
-inline bool open_writer(shm::ShmGenericWriter& writer, std::string_view name, std::size_t size) {
-    return writer.open(std::string(name), size) != nullptr;
+inline bool open_writer(shm::ShmGenericWriter& writer, std::string_view name, std::size_t size,
+                        const shm::ShmMapOptions& options = {}) {
+    return writer.open(std::string(name), size, options) != nullptr;
+}
+
+// 查询已存在共享内存段的大小，用于按实际容量映射运行期定长的段；段不存在时返回 false
+inline bool segment_size(std::string_view name, std::size_t& out_size) noexcept {
+    const int fd = ::shm_open(std::string(name).c_str(), O_RDONLY | O_CLOEXEC, 0);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat shm_stat {};
+    const bool ok = ::fstat(fd, &shm_stat) == 0;
+    const int saved_errno = errno;
+    ::close(fd);
+    errno = saved_errno;
+    if (!ok) {
+        return false;
+    }
+    out_size = static_cast<std::size_t>(shm_stat.st_size);
+    return true;
 }
 
 inline bool open_reader(shm::ShmGenericReader& reader, std::string_view name, std::size_t size) {
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <atomic>
+#include <cerrno>
+#include <climits>
+#include <cstdint>
+#include <ctime>
+
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace acct_service {
+
+// 跨进程门铃：消费者空闲时在 futex 上等待，生产者入队后仅在存在等待者时唤醒
+struct shm_doorbell {
+    std::atomic<uint32_t> seq{0};      // 每次唤醒递增，作为 futex 字
+    std::atomic<uint32_t> waiters{0};  // 当前等待中的消费者数
+};
+
+static_assert(sizeof(shm_doorbell) == 8, "shm_doorbell must be 8 bytes");
+static_assert(std::atomic<uint32_t>::is_always_lock_free, "futex word must be lock-free");
+
+namespace doorbell_detail {
+
+inline long futex(std::atomic<uint32_t>* word, int op, uint32_t value, const timespec* timeout) noexcept {
+    // 共享内存跨进程使用，不能带 FUTEX_PRIVATE_FLAG
+    return ::syscall(SYS_futex, reinterpret_cast<uint32_t*>(word), op, value, timeout, nullptr, 0);
+}
+
+}  // namespace doorbell_detail
+
+// 生产者入队后调用；无等待者时只有一次 fence 与一次 load
+inline void doorbell_ring(shm_doorbell* bell) noexcept {
+    if (!bell) {
+        return;
+    }
+    // 保证队列发布先于读取等待者计数，与 doorbell_wait 的注册顺序配对
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (bell->waiters.load(std::memory_order_relaxed) == 0) {
+        return;
+    }
+    bell->seq.fetch_add(1, std::memory_order_release);
+    (void)doorbell_detail::futex(&bell->seq, FUTEX_WAKE, INT_MAX, nullptr);
+}
+
+// 消费者空闲时调用：先登记等待者再复查队列，避免丢失唤醒；最多等待 timeout_us
+template <typename HasWork>
+inline void doorbell_wait(shm_doorbell* bell, uint32_t timeout_us, HasWork&& has_work) noexcept {
+    if (!bell) {
+        return;
+    }
+
+    const uint32_t observed = bell->seq.load(std::memory_order_acquire);
+    bell->waiters.fetch_add(1, std::memory_order_seq_cst);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (!has_work()) {
+        timespec timeout{};
+        timeout.tv_sec = static_cast<time_t>(timeout_us / 1000000U);
+        timeout.tv_nsec = static_cast<long>(timeout_us % 1000000U) * 1000L;
+        (void)doorbell_detail::futex(&bell->seq, FUTEX_WAIT, observed, &timeout);
+    }
+    bell->waiters.fetch_sub(1, std::memory_order_release);
+}
+
+}  // namespace acct_service
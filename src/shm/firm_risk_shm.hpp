@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "portfolio/positions.h"
+#include "shm/shm_layout.hpp"
+
+namespace acct_service {
+
+inline constexpr std::size_t kInvalidFirmRiskSlot = SIZE_MAX;
+
+// 读取公司级合计快照；聚合进程写区间内返回 false，调用方重试。
+inline bool firm_risk_try_read_totals(const firm_risk_shm_layout& shm, firm_risk_totals& out) noexcept {
+    return position_try_read(shm.totals, [&out](const firm_risk_totals& row) {
+        out.account_count = row.account_count;
+        out.traded_buy_value = row.traded_buy_value;
+        out.traded_sell_value = row.traded_sell_value;
+        out.frozen_value = row.frozen_value;
+        out.holding_volume = row.holding_volume;
+        out.version = row.version;
+        out.publish_ns = row.publish_ns;
+    });
+}
+
+// 读取单个证券合计快照（不含 id）；写区间内返回 false。
+inline bool firm_risk_try_read_security(const firm_risk_shm_layout& shm, std::size_t slot,
+                                        firm_security_total& out) noexcept {
+    return position_try_read(shm.securities[slot], [&out](const firm_security_total& row) {
+        out.account_count = row.account_count;
+        out.holding_volume = row.holding_volume;
+        out.traded_buy_value = row.traded_buy_value;
+        out.traded_sell_value = row.traded_sell_value;
+    });
+}
+
+// 按证券键线性探测已登记槽位，未登记返回 kInvalidFirmRiskSlot。槽位 id 写入后不再改变，
+// 读者只需在 id 发布（seq 前进）后看到它；探测遇到空槽即止。
+inline std::size_t firm_risk_find_security(const firm_risk_shm_layout& shm, const FixedString<16>& id) noexcept {
+    if (id.empty()) {
+        return kInvalidFirmRiskSlot;
+    }
+    std::size_t slot = firm_risk_security_slot(id);
+    for (std::size_t probe = 0; probe < kFirmRiskSecurityCapacity; ++probe) {
+        const firm_security_total& row = shm.securities[slot];
+        if (row.seq.load(std::memory_order_acquire) == 0) {
+            return kInvalidFirmRiskSlot;
+        }
+        if (row.id == id) {
+            return slot;
+        }
+        slot = (slot + 1) & (kFirmRiskSecurityCapacity - 1);
+    }
+    return kInvalidFirmRiskSlot;
+}
+
+}  // namespace acct_service
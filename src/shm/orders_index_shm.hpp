@@ -0,0 +1,172 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+
+#include "common/types.hpp"
+#include "shm/orders_shm.hpp"
+#include "shm/shm_layout.hpp"
+
+namespace acct_service {
+
+static_assert(kDailyOrderPoolCapacity == (std::size_t{1} << kOrderIndexSegmentShift),
+              "orders index nodes are global order indices");
+
+inline constexpr std::size_t kInvalidOrdersIndexBucket = SIZE_MAX;
+
+// 索引段名不带交易日（段内 trading_day 标明当前所属交易日）：/orders_shm -> /orders_shm_idx
+inline std::string make_orders_index_shm_name(std::string_view orders_base_name) {
+    std::string name(orders_base_name);
+    name += "_idx";
+    return name;
+}
+
+inline bool orders_index_node_valid(OrderIndex index) noexcept { return index < kOrdersIndexNodeCount; }
+
+inline bool orders_index_test_bit(const std::atomic<uint64_t>* bits, uint32_t node) noexcept {
+    return (bits[node >> 6].load(std::memory_order_acquire) >> (node & 63U)) & 1ULL;
+}
+
+// ============ 写端（仅账户线程） ============
+
+// 换日或首次绑定：清空桶、策略链头与位图并写入新交易日；链节点数组不清，节点入链时总是先写 next 再发布链头
+inline void orders_index_reset(orders_index_shm_layout* shm, uint32_t trading_day) noexcept {
+    if (!shm) {
+        return;
+    }
+    const uint64_t generation = shm->generation.load(std::memory_order_relaxed);
+    shm->generation.store(generation | 1ULL, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    for (orders_index_security_bucket& bucket : shm->securities) {
+        bucket.head.store(kOrdersIndexNil, std::memory_order_relaxed);
+        bucket.count.store(0, std::memory_order_relaxed);
+        bucket.id = FixedString<16>{};
+    }
+    for (orders_index_strategy_head& strategy : shm->strategies) {
+        strategy.head.store(kOrdersIndexNil, std::memory_order_relaxed);
+        strategy.count.store(0, std::memory_order_relaxed);
+    }
+    std::memset(static_cast<void*>(shm->live_bits), 0, sizeof(shm->live_bits));
+    std::memset(static_cast<void*>(shm->indexed_bits), 0, sizeof(shm->indexed_bits));
+    shm->security_count.store(0, std::memory_order_relaxed);
+    shm->indexed_orders.store(0, std::memory_order_relaxed);
+    shm->unplaced_orders.store(0, std::memory_order_relaxed);
+    shm->trading_day.store(trading_day, std::memory_order_relaxed);
+
+    shm->generation.store((generation | 1ULL) + 1, std::memory_order_release);
+}
+
+// 首次见到证券键时登记桶，桶满返回 kInvalidOrdersIndexBucket
+inline std::size_t orders_index_claim_security(orders_index_shm_layout* shm, const InternalSecurityId& id) noexcept {
+    std::size_t bucket = static_cast<std::size_t>(shm_security_key_hash(id)) & (kOrdersIndexSecurityBuckets - 1);
+    for (std::size_t probe = 0; probe < kOrdersIndexSecurityBuckets; ++probe) {
+        orders_index_security_bucket& entry = shm->securities[bucket];
+        if (entry.id.empty()) {
+            entry.id = id;
+            shm->security_count.fetch_add(1, std::memory_order_relaxed);
+            return bucket;
+        }
+        if (entry.id == id) {
+            return bucket;
+        }
+        bucket = (bucket + 1) & (kOrdersIndexSecurityBuckets - 1);
+    }
+    return kInvalidOrdersIndexBucket;
+}
+
+inline void orders_index_set_live(orders_index_shm_layout* shm, OrderIndex index, bool live) noexcept {
+    if (!shm || !orders_index_node_valid(index)) {
+        return;
+    }
+    std::atomic<uint64_t>& word = shm->live_bits[index >> 6];
+    const uint64_t mask = 1ULL << (index & 63U);
+    const uint64_t current = word.load(std::memory_order_relaxed);
+    const uint64_t updated = live ? (current | mask) : (current & ~mask);
+    if (updated != current) {
+        word.store(updated, std::memory_order_release);
+    }
+}
+
+// 订单入簿：头插到证券链与策略链并置在途位。同一槽位重复入簿（重启恢复）只刷新在途位，返回是否新入链
+inline bool orders_index_add(orders_index_shm_layout* shm, OrderIndex index, const InternalSecurityId& security_id,
+                             StrategyId strategy_id, bool live) noexcept {
+    if (!shm || !orders_index_node_valid(index)) {
+        return false;
+    }
+    std::atomic<uint64_t>& indexed = shm->indexed_bits[index >> 6];
+    const uint64_t mask = 1ULL << (index & 63U);
+    const uint64_t indexed_word = indexed.load(std::memory_order_relaxed);
+    if ((indexed_word & mask) == 0) {
+        // 先置已入链位：进程在入链中途退出时该订单至多缺席链上，重启后不会重复头插成环
+        indexed.store(indexed_word | mask, std::memory_order_relaxed);
+        shm->node_strategy[index].store(strategy_id, std::memory_order_relaxed);
+
+        orders_index_strategy_head& strategy = shm->strategies[strategy_id];
+        shm->next_by_strategy[index].store(strategy.head.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        strategy.count.fetch_add(1, std::memory_order_relaxed);
+        strategy.head.store(index, std::memory_order_release);
+
+        const std::size_t bucket = security_id.empty() ? kInvalidOrdersIndexBucket
+                                                       : orders_index_claim_security(shm, security_id);
+        if (bucket != kInvalidOrdersIndexBucket) {
+            orders_index_security_bucket& entry = shm->securities[bucket];
+            shm->next_by_security[index].store(entry.head.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            entry.count.fetch_add(1, std::memory_order_relaxed);
+            entry.head.store(index, std::memory_order_release);
+        } else {
+            shm->unplaced_orders.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        shm->indexed_orders.fetch_add(1, std::memory_order_relaxed);
+    }
+    orders_index_set_live(shm, index, live);
+    return (indexed_word & mask) == 0;
+}
+
+// ============ 读端（监控） ============
+
+// 按证券键探测已登记的桶，未登记返回 kInvalidOrdersIndexBucket；探测遇到空桶即止
+inline std::size_t orders_index_find_security(const orders_index_shm_layout& shm,
+                                              const InternalSecurityId& id) noexcept {
+    if (id.empty()) {
+        return kInvalidOrdersIndexBucket;
+    }
+    std::size_t bucket = static_cast<std::size_t>(shm_security_key_hash(id)) & (kOrdersIndexSecurityBuckets - 1);
+    for (std::size_t probe = 0; probe < kOrdersIndexSecurityBuckets; ++probe) {
+        const orders_index_security_bucket& entry = shm.securities[bucket];
+        if (entry.head.load(std::memory_order_acquire) == kOrdersIndexNil) {
+            // 桶 id 先于链头写入：链头未发布时可能已有 id，但尚无可见节点，按未登记处理
+            if (entry.id.empty()) {
+                return kInvalidOrdersIndexBucket;
+            }
+        } else if (entry.id == id) {
+            return bucket;
+        }
+        bucket = (bucket + 1) & (kOrdersIndexSecurityBuckets - 1);
+    }
+    return kInvalidOrdersIndexBucket;
+}
+
+// 自 from（含）起的下一个在途节点，没有则返回 kOrdersIndexNil
+inline uint32_t orders_index_next_live(const orders_index_shm_layout& shm, uint32_t from) noexcept {
+    if (from >= kOrdersIndexNodeCount) {
+        return kOrdersIndexNil;
+    }
+    std::size_t word_index = from >> 6;
+    uint64_t word = shm.live_bits[word_index].load(std::memory_order_acquire) & (~0ULL << (from & 63U));
+    while (true) {
+        if (word != 0) {
+            return static_cast<uint32_t>((word_index << 6) + static_cast<std::size_t>(__builtin_ctzll(word)));
+        }
+        if (++word_index >= kOrdersIndexNodeCount / 64) {
+            return kOrdersIndexNil;
+        }
+        word = shm.live_bits[word_index].load(std::memory_order_acquire);
+    }
+}
+
+}  // namespace acct_service
@@ -1,19 +1,30 @@
 #pragma once
 
 #include <algorithm>
+#include <atomic>
+#include <bit>
 #include <cctype>
+#include <climits>
 #include <cstdint>
+#include <cstdio>
 #include <cstring>
 #include <string>
 #include <string_view>
 #include <type_traits>
 
 #include "common/log.hpp"
+#include "common/time_utils.hpp"
 #include "common/types.hpp"
+#include "order/order_state_machine.hpp"
 #include "shm/shm_layout.hpp"
 
 namespace acct_service {
 
+struct order_slot_latency {
+    TimestampNs submit_ns{0};                        // API 提交时间（CLOCK_MONOTONIC），0=未打点
+    uint32_t hop_delta_ns[kOrderLatencyHopCount]{};  // 各跳相对 submit_ns 的增量，0=未到达
+};
+
 struct order_slot_snapshot {
     OrderRequest request{};
     OrderSlotState stage{OrderSlotState::Empty};
@@ -37,6 +48,24 @@ inline std::string make_orders_shm_name(std::string_view base_name, std::string_
     return name;
 }
 
+// 交易日字符串与头部数值（YYYYMMDD）互转，非法交易日记为 0
+inline uint32_t trading_day_number(std::string_view trading_day) noexcept {
+    if (!is_valid_trading_day(trading_day)) {
+        return 0;
+    }
+    uint32_t value = 0;
+    for (const char ch : trading_day) {
+        value = value * 10 + static_cast<uint32_t>(ch - '0');
+    }
+    return value;
+}
+
+inline std::string trading_day_string(uint32_t day) {
+    char buffer[16];
+    std::snprintf(buffer, sizeof(buffer), "%08u", static_cast<unsigned>(day));
+    return std::string(buffer);
+}
+
 inline bool extract_trading_day_from_name(std::string_view shm_name, char out_trading_day[9]) noexcept {
     if (!out_trading_day) {
         return false;
@@ -56,47 +85,210 @@ inline bool extract_trading_day_from_name(std::string_view shm_name, char out_tr
     return true;
 }
 
-inline bool is_terminal_order_state(OrderState status) noexcept {
-    switch (status) {
-        case OrderState::RiskControllerRejected:
-        case OrderState::TraderRejected:
-        case OrderState::TraderError:
-        case OrderState::BrokerRejected:
-        case OrderState::MarketRejected:
-        case OrderState::Finished:
-        case OrderState::Unknown:
-            return true;
-        default:
-            return false;
+inline bool is_terminal_order_state(OrderState status) noexcept { return order_state_is_terminal(status); }
+
+// 订单号编码：高 12 位为订单池纪元（>=1），低 20 位为当日槽位下标。
+// 订单号与槽位一一对应，订单号 -> 槽位只需位运算；订单池重建时换纪元，避免与上一池的订单号重复
+inline constexpr uint32_t kOrderIdIndexBits = 20;
+inline constexpr uint32_t kOrderIdIndexMask = (1U << kOrderIdIndexBits) - 1;
+inline constexpr uint32_t kMaxOrderIdEpoch = (1U << (32 - kOrderIdIndexBits)) - 1;
+
+static_assert(kDailyOrderPoolCapacity <= (std::size_t{1} << kOrderIdIndexBits),
+              "order id index bits must cover the daily order pool");
+
+inline constexpr InternalOrderId make_order_id(uint32_t epoch, OrderIndex index) noexcept {
+    return static_cast<InternalOrderId>((epoch << kOrderIdIndexBits) | (index & kOrderIdIndexMask));
+}
+
+inline constexpr OrderIndex order_id_slot_index(InternalOrderId order_id) noexcept {
+    return static_cast<OrderIndex>(order_id & kOrderIdIndexMask);
+}
+
+inline constexpr uint32_t order_id_epoch(InternalOrderId order_id) noexcept {
+    return static_cast<uint32_t>(order_id >> kOrderIdIndexBits);
+}
+
+// 溢出段链：主段写满前，账户服务后台按水位链上同容量的溢出段（见 extend_orders_overflow）。
+// 全局 OrderIndex 高位为段号、低 20 位为段内下标，段号 0 即主段本身；各段有独立纪元，订单号仍是纪元+段内下标。
+// 调用方始终持有主段指针，槽位访问按段号解析，主段槽位不经过注册表
+inline constexpr uint32_t kOrderIndexSegmentShift = kOrderIdIndexBits;
+
+static_assert(((kMaxOrdersOverflowSegments + 1) << kOrderIndexSegmentShift) - 1 < kInvalidOrderIndex,
+              "order index segment bits must not reach kInvalidOrderIndex");
+static_assert(((kMaxOrdersOverflowSegments + 1) << kOrderIndexSegmentShift) - 1 < kUpstreamInlineIndexFlag,
+              "order index segment bits must not reach kUpstreamInlineIndexFlag");
+
+inline constexpr uint32_t orders_index_segment(OrderIndex index) noexcept {
+    return static_cast<uint32_t>(index >> kOrderIndexSegmentShift);
+}
+
+inline constexpr OrderIndex orders_index_local(OrderIndex index) noexcept {
+    return static_cast<OrderIndex>(index & kOrderIdIndexMask);
+}
+
+inline constexpr OrderIndex make_orders_index(uint32_t segment, OrderIndex local) noexcept {
+    return static_cast<OrderIndex>((segment << kOrderIndexSegmentShift) | (local & kOrderIdIndexMask));
+}
+
+// 溢出段名在交易日后缀前插入 _ovf<段号>，如 /orders_shm_20260301 -> /orders_shm_ovf1_20260301
+inline std::string make_orders_overflow_shm_name(std::string_view primary_name, uint32_t segment) {
+    const std::size_t pos = primary_name.find_last_of('_');
+    const std::size_t split = pos == std::string_view::npos ? primary_name.size() : pos;
+    std::string name(primary_name.substr(0, split));
+    name += "_ovf";
+    name += std::to_string(segment);
+    name.append(primary_name.substr(split));
+    return name;
+}
+
+inline bool is_orders_overflow_shm_name(std::string_view name) noexcept {
+    const std::size_t day_pos = name.find_last_of('_');
+    if (day_pos == std::string_view::npos || day_pos == 0) {
+        return false;
+    }
+    const std::size_t tag_pos = name.find_last_of('_', day_pos - 1);
+    if (tag_pos == std::string_view::npos) {
+        return false;
+    }
+    const std::string_view tag = name.substr(tag_pos + 1, day_pos - tag_pos - 1);
+    return tag.size() > 3 && tag.substr(0, 3) == "ovf" &&
+           std::all_of(tag.begin() + 3, tag.end(), [](unsigned char ch) { return std::isdigit(ch) != 0; });
+}
+
+// 本进程中主段的第 segment 个溢出段（shm_manager.cpp）：首次访问时按主段名打开并缓存映射；
+// 段尚未发布、主段不是经 SHMManager::open_orders 打开（如测试用的堆上布局）或打开失败时返回 nullptr
+orders_shm_layout* orders_shm_overflow(const orders_shm_layout* shm, uint32_t segment) noexcept;
+
+// 本进程存活的窗口化订单池映射数（orders_window_map.cpp）；为 0 时槽位访问不查窗口表
+extern std::atomic<uint32_t> g_orders_window_maps;
+
+// 段经 orders_window_map 窗口化映射时，按需映射覆盖段内 [local_begin, local_end) 槽位及其进度字的窗口，失败返回 false；
+// 整段映射的段直接返回 true（orders_window_map.cpp）
+bool orders_shm_map_window_slots(const orders_shm_layout* segment, OrderIndex local_begin,
+                                 OrderIndex local_end) noexcept;
+
+// 段内槽位区间在本进程可访问；直接按 slots[] 寻址的代码须先经此确认
+inline bool orders_shm_slots_mapped(const orders_shm_layout* segment, OrderIndex local_begin,
+                                    OrderIndex local_end) noexcept {
+    return g_orders_window_maps.load(std::memory_order_relaxed) == 0 ||
+           orders_shm_map_window_slots(segment, local_begin, local_end);
+}
+
+// 全局下标所在的段（主段或溢出段）与段内下标；段不可达时返回 nullptr
+inline orders_shm_layout* orders_shm_segment_of(const orders_shm_layout* shm, OrderIndex index,
+                                                OrderIndex& out_local) noexcept {
+    out_local = orders_index_local(index);
+    const uint32_t segment = orders_index_segment(index);
+    if (segment == 0) {
+        return const_cast<orders_shm_layout*>(shm);
+    }
+    if (!shm || segment > kMaxOrdersOverflowSegments) {
+        return nullptr;
+    }
+    return orders_shm_overflow(shm, segment);
+}
+
+// 已分配槽位的地址，下标未分配或所在段不可达时返回 nullptr
+inline OrderSlot* orders_shm_find_slot(const orders_shm_layout* shm, OrderIndex index) noexcept {
+    OrderIndex local = 0;
+    orders_shm_layout* segment = orders_shm_segment_of(shm, index, local);
+    if (!segment) {
+        return nullptr;
     }
+    const OrderIndex upper = segment->header.next_index.load(std::memory_order_acquire);
+    if (local >= upper || local >= segment->header.capacity || !orders_shm_slots_mapped(segment, local, local + 1)) {
+        return nullptr;
+    }
+    return &segment->slots[local];
 }
 
 inline bool orders_shm_index_exists(const orders_shm_layout* shm, OrderIndex index) noexcept {
-    if (!shm || index == kInvalidOrderIndex) {
-        return false;
+    return orders_shm_find_slot(shm, index) != nullptr;
+}
+
+// 首个接入方从上游段的纪元计数器取号并 CAS 写入，之后各方沿用；返回本池纪元。
+// 计数器回绕时在 [1, kMaxOrderIdEpoch] 内循环
+inline uint32_t orders_shm_bind_id_epoch(orders_shm_layout* shm, upstream_shm_layout* upstream) noexcept {
+    if (!shm) {
+        return 0;
     }
-    const OrderIndex upper = shm->header.next_index.load(std::memory_order_acquire);
-    return index < upper && index < shm->header.capacity;
+    uint32_t epoch = shm->header.id_epoch.load(std::memory_order_acquire);
+    if (epoch != 0 || !upstream) {
+        return epoch;
+    }
+    const uint32_t ticket = upstream->header.next_id_epoch.fetch_add(1, std::memory_order_relaxed);
+    const uint32_t candidate = (ticket - 1) % kMaxOrderIdEpoch + 1;
+    if (shm->header.id_epoch.compare_exchange_strong(epoch, candidate, std::memory_order_acq_rel,
+                                                     std::memory_order_acquire)) {
+        return candidate;
+    }
+    return epoch;
 }
 
-inline bool orders_shm_try_allocate(orders_shm_layout* shm, OrderIndex& out_index) noexcept {
+// 槽位对应的订单号，按所在段的纪元编码；未绑定纪元的订单池（测试、预热用的临时池）按纪元 1 编码
+inline InternalOrderId orders_shm_order_id(const orders_shm_layout* shm, OrderIndex index) noexcept {
+    OrderIndex local = 0;
+    const orders_shm_layout* segment = orders_shm_segment_of(shm, index, local);
+    const uint32_t epoch = segment ? segment->header.id_epoch.load(std::memory_order_relaxed) : 0;
+    return make_order_id(epoch != 0 ? epoch : 1, local);
+}
+
+// 订单号 -> 全局槽位下标：按纪元找到所在段，纪元不属于本池及其溢出段时返回 kInvalidOrderIndex
+inline OrderIndex orders_shm_index_for_order_id(const orders_shm_layout* shm, InternalOrderId order_id) noexcept {
     if (!shm) {
-        return false;
+        return kInvalidOrderIndex;
+    }
+    const uint32_t epoch = order_id_epoch(order_id);
+    const uint32_t primary_epoch = shm->header.id_epoch.load(std::memory_order_relaxed);
+    if (epoch == (primary_epoch != 0 ? primary_epoch : 1)) {
+        return order_id_slot_index(order_id);
     }
+    const uint32_t published = shm->header.overflow_segments.load(std::memory_order_acquire);
+    for (uint32_t segment = 1; segment <= published; ++segment) {
+        const orders_shm_layout* overflow = orders_shm_overflow(shm, segment);
+        if (overflow && overflow->header.id_epoch.load(std::memory_order_relaxed) == epoch) {
+            return make_orders_index(segment, order_id_slot_index(order_id));
+        }
+    }
+    return kInvalidOrderIndex;
+}
 
-    OrderIndex current = shm->header.next_index.load(std::memory_order_acquire);
+// 换日标记：生产者切到新订单池后先向自己的队列推入一次，其后的下标都属于新池。
+// 上游 lane 由策略侧推入，下游三条队列由账户服务在切换时推入
+inline constexpr OrderIndex kOrdersRolloverMarker = kInvalidOrderIndex;
+
+// 账户服务已换日到的新交易日，0=本池仍在用；接入方每次入队前读一次（与门铃同一缓存行）
+inline uint32_t orders_shm_successor_day(const orders_shm_layout* shm) noexcept {
+    return shm ? shm->header.successor_day.load(std::memory_order_acquire) : 0;
+}
+
+// 换日发布：先在新池记下上一交易日，再在旧池写入后继交易日。之后才打开新池的接入方据
+// predecessor_day 得知自己需要推入换日标记，仍挂在旧池上的接入方据 successor_day 跟随切换
+inline void orders_shm_link_successor(orders_shm_layout* previous, orders_shm_layout* next) noexcept {
+    if (!previous || !next) {
+        return;
+    }
+    next->header.predecessor_day.store(trading_day_number(std::string_view(previous->header.trading_day, 8)),
+                                       std::memory_order_relaxed);
+    previous->header.successor_day.store(trading_day_number(std::string_view(next->header.trading_day, 8)),
+                                         std::memory_order_seq_cst);
+}
+
+// 单段内分配一个槽位，段满时返回 false 且不计拒单
+inline bool orders_shm_try_allocate_local(orders_shm_layout* segment, OrderIndex& out_local) noexcept {
+    OrderIndex current = segment->header.next_index.load(std::memory_order_acquire);
     while (true) {
-        if (current >= shm->header.capacity) {
-            shm->header.full_reject_count.fetch_add(1, std::memory_order_relaxed);
+        if (current >= segment->header.capacity) {
             return false;
         }
 
         const OrderIndex next = current + 1;
-        if (shm->header.next_index.compare_exchange_weak(
+        if (segment->header.next_index.compare_exchange_weak(
                 current, next, std::memory_order_acq_rel, std::memory_order_acquire)) {
-            out_index = current;
-            const OrderIndex warn80 = static_cast<OrderIndex>((static_cast<uint64_t>(shm->header.capacity) * 80ULL) / 100ULL);
-            const OrderIndex warn95 = static_cast<OrderIndex>((static_cast<uint64_t>(shm->header.capacity) * 95ULL) / 100ULL);
+            out_local = current;
+            const uint64_t capacity = segment->header.capacity;
+            const OrderIndex warn80 = static_cast<OrderIndex>((capacity * 80ULL) / 100ULL);
+            const OrderIndex warn95 = static_cast<OrderIndex>((capacity * 95ULL) / 100ULL);
             if (next == warn80) {
                 ACCT_LOG_WARN("orders_shm", "orders pool usage reached 80%");
             } else if (next == warn95) {
@@ -107,15 +299,201 @@ inline bool orders_shm_try_allocate(orders_shm_layout* shm, OrderIndex& out_inde
     }
 }
 
+// 主段写满后依次落到已发布的溢出段，全部写满才计入主段 full_reject_count；out_index 为全局下标
+inline bool orders_shm_try_allocate(orders_shm_layout* shm, OrderIndex& out_index) noexcept {
+    if (!shm) {
+        return false;
+    }
+
+    OrderIndex local = 0;
+    if (orders_shm_try_allocate_local(shm, local)) {
+        out_index = local;
+        return true;
+    }
+    const uint32_t published = shm->header.overflow_segments.load(std::memory_order_acquire);
+    for (uint32_t segment = 1; segment <= published; ++segment) {
+        orders_shm_layout* overflow = orders_shm_overflow(shm, segment);
+        if (overflow && orders_shm_try_allocate_local(overflow, local)) {
+            out_index = make_orders_index(segment, local);
+            return true;
+        }
+    }
+    shm->header.full_reject_count.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
+// 单段内一次 CAS 预留至多 count 个连续槽位，返回实际预留数（段满为 0）
+inline std::size_t orders_shm_try_allocate_range_local(
+    orders_shm_layout* segment, std::size_t count, OrderIndex& out_begin) noexcept {
+    OrderIndex current = segment->header.next_index.load(std::memory_order_acquire);
+    while (true) {
+        const OrderIndex capacity = segment->header.capacity;
+        const std::size_t available = current < capacity ? static_cast<std::size_t>(capacity - current) : 0;
+        const std::size_t granted = count < available ? count : available;
+        if (granted == 0) {
+            return 0;
+        }
+
+        const OrderIndex next = current + static_cast<OrderIndex>(granted);
+        if (segment->header.next_index.compare_exchange_weak(
+                current, next, std::memory_order_acq_rel, std::memory_order_acquire)) {
+            out_begin = current;
+            const OrderIndex warn80 = static_cast<OrderIndex>((static_cast<uint64_t>(capacity) * 80ULL) / 100ULL);
+            const OrderIndex warn95 = static_cast<OrderIndex>((static_cast<uint64_t>(capacity) * 95ULL) / 100ULL);
+            if (current < warn95 && next >= warn95) {
+                ACCT_LOG_WARN("orders_shm", "orders pool usage reached 95%");
+            } else if (current < warn80 && next >= warn80) {
+                ACCT_LOG_WARN("orders_shm", "orders pool usage reached 80%");
+            }
+            return granted;
+        }
+    }
+}
+
+// 一次 CAS 预留连续槽位 [out_begin, out_begin + 返回值)，区间总在同一段内；当前段剩余不足时只预留可用部分，
+// 主段用尽后落到已发布的溢出段。已无后续段可用时，未能预留的条数计入主段 full_reject_count
+inline std::size_t orders_shm_try_allocate_range(
+    orders_shm_layout* shm, std::size_t count, OrderIndex& out_begin) noexcept {
+    if (!shm || count == 0) {
+        return 0;
+    }
+
+    const uint32_t published = shm->header.overflow_segments.load(std::memory_order_acquire);
+    for (uint32_t segment = 0; segment <= published; ++segment) {
+        orders_shm_layout* target = segment == 0 ? shm : orders_shm_overflow(shm, segment);
+        if (!target) {
+            continue;
+        }
+        OrderIndex local = 0;
+        const std::size_t granted = orders_shm_try_allocate_range_local(target, count, local);
+        if (granted == 0) {
+            continue;
+        }
+        out_begin = make_orders_index(segment, local);
+        if (granted < count && segment == published) {
+            shm->header.full_reject_count.fetch_add(count - granted, std::memory_order_relaxed);
+        }
+        return granted;
+    }
+    shm->header.full_reject_count.fetch_add(count, std::memory_order_relaxed);
+    return 0;
+}
+
+// 归还预留区间中未使用的尾部 [begin, end)（同一段内的全局下标）：仅当其后无人再分配时才能回退该段 next_index，
+// 否则保持 Empty 槽位（监控按 Empty 跳过），返回是否成功回退
+inline bool orders_shm_release_range(orders_shm_layout* shm, OrderIndex begin, OrderIndex end) noexcept {
+    if (!shm || begin >= end || orders_index_segment(begin) != orders_index_segment(end - 1)) {
+        return false;
+    }
+    OrderIndex local_begin = 0;
+    orders_shm_layout* segment = orders_shm_segment_of(shm, begin, local_begin);
+    if (!segment) {
+        return false;
+    }
+    OrderIndex expected = local_begin + (end - begin);
+    return segment->header.next_index.compare_exchange_strong(
+        expected, local_begin, std::memory_order_acq_rel, std::memory_order_acquire);
+}
+
+// 热备重放：把主段 next_index 抬到至少 end（不超过容量），使备机此后的内部分配与主机落在同一批下标上；
+// 已超过 end 时不回退。返回抬升后的 next_index
+inline OrderIndex orders_shm_reserve_through(orders_shm_layout* shm, OrderIndex end) noexcept {
+    if (!shm) {
+        return 0;
+    }
+    const OrderIndex target = end < shm->header.capacity ? end : shm->header.capacity;
+    OrderIndex current = shm->header.next_index.load(std::memory_order_acquire);
+    while (current < target && !shm->header.next_index.compare_exchange_weak(
+                                   current, target, std::memory_order_acq_rel, std::memory_order_acquire)) {
+    }
+    return current < target ? target : current;
+}
+
+// 追加一条变更记录：先把 position 清零标记写入中，写 value 后再以 position 发布
+inline void orders_shm_journal_append(orders_shm_layout* shm, OrderIndex index, uint64_t seq) noexcept {
+    order_change_journal& journal = shm->journal;
+    const uint64_t position = journal.write_cursor.fetch_add(1, std::memory_order_relaxed);
+    order_journal_entry& entry = journal.entries[position & (kOrderJournalCapacity - 1)];
+    entry.position.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    entry.value.store((static_cast<uint64_t>(index) << 32) | (seq & 0xFFFFFFFFULL), std::memory_order_relaxed);
+    entry.position.store(position + 1, std::memory_order_release);
+}
+
+// 从 cursor 起读取已发布的变更，遇到写入中条目即停止；返回读取条数。
+// cursor 落后超过环容量（或条目已被下一圈覆盖）时置 out_lagged，cursor 跳到仍保留的最早位置
+inline std::size_t orders_shm_journal_read(const orders_shm_layout* shm, uint64_t& cursor, OrderIndex* out_index,
+    uint64_t* out_seq, std::size_t max_count, bool& out_lagged) noexcept {
+    const order_change_journal& journal = shm->journal;
+    out_lagged = false;
+    const uint64_t head = journal.write_cursor.load(std::memory_order_acquire);
+    if (cursor > head) {
+        cursor = head;
+    }
+    if (head - cursor > kOrderJournalCapacity) {
+        cursor = head - kOrderJournalCapacity;
+        out_lagged = true;
+    }
+
+    std::size_t count = 0;
+    while (count < max_count && cursor < head) {
+        const order_journal_entry& entry = journal.entries[cursor & (kOrderJournalCapacity - 1)];
+        const uint64_t position0 = entry.position.load(std::memory_order_acquire);
+        const uint64_t value = entry.value.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        const uint64_t position1 = entry.position.load(std::memory_order_relaxed);
+        if (position0 != position1 || position0 != cursor + 1) {
+            if (position0 > cursor + 1 || position1 > cursor + 1) {
+                // 读者被套圈：本条已被覆盖，跳过并提示调用方全量补扫
+                out_lagged = true;
+                ++cursor;
+                continue;
+            }
+            break;
+        }
+        out_index[count] = static_cast<OrderIndex>(value >> 32);
+        out_seq[count] = value & 0xFFFFFFFFULL;
+        ++count;
+        ++cursor;
+    }
+    return count;
+}
+
+// 批量出队时预取后续槽位的全部缓存行（写意图，消费时会改写 seq/stage），索引越界时忽略；仅为提示
+inline void orders_shm_prefetch_slot(const orders_shm_layout* shm, OrderIndex index) noexcept {
+    const OrderSlot* slot = orders_shm_find_slot(shm, index);
+    if (!slot) {
+        return;
+    }
+    const char* base = reinterpret_cast<const char*>(slot);
+    for (std::size_t offset = 0; offset < sizeof(OrderSlot); offset += 64) {
+        __builtin_prefetch(base + offset, 1, 3);
+    }
+}
+
+// update_ns 同时写入头部 last_update，调用方传入本轮缓存时间，写槽位本身不取时钟
+namespace orders_shm_detail {
+
+static_assert(std::endian::native == std::endian::little, "slot futex word assumes little-endian seq");
+
+// seq 的低 32 位作 futex 字：与 seq 同址，每次进入/退出写区间都会改变
+inline std::atomic<uint32_t>* slot_futex_word(const OrderSlot& slot) noexcept {
+    return reinterpret_cast<std::atomic<uint32_t>*>(const_cast<std::atomic<uint64_t>*>(&slot.seq));
+}
+
+}  // namespace orders_shm_detail
+
 template <typename Mutator>
-inline bool orders_shm_mutate_slot(orders_shm_layout* shm, OrderIndex index, Mutator&& mutator) noexcept {
+inline bool orders_shm_mutate_slot(orders_shm_layout* shm, OrderIndex index, TimestampNs update_ns,
+    Mutator&& mutator) noexcept {
     static_assert(std::is_invocable_v<Mutator, OrderSlot&>, "mutator must be callable with OrderSlot&");
 
-    if (!orders_shm_index_exists(shm, index)) {
+    OrderSlot* found = orders_shm_find_slot(shm, index);
+    if (!found) {
         return false;
     }
 
-    OrderSlot& slot = shm->slots[index];
+    OrderSlot& slot = *found;
     uint64_t seq = slot.seq.load(std::memory_order_relaxed);
     if ((seq & 1ULL) != 0U) {
         ++seq;
@@ -127,13 +505,18 @@ inline bool orders_shm_mutate_slot(orders_shm_layout* shm, OrderIndex index, Mut
     mutator(slot);
 
     slot.seq.store(seq + 2, std::memory_order_release);  // even: publish
-    shm->header.last_update = now_ns();
+    shm->header.last_update = update_ns;
+    orders_shm_journal_append(shm, index, seq + 2);
+    // 仅在有等待者时唤醒；无人等待时只多一次同缓存行的 relaxed load，不加 fence（竞态由等待方的分段超时兜底）
+    if (slot.waiters.load(std::memory_order_relaxed) != 0) {
+        (void)doorbell_detail::futex(orders_shm_detail::slot_futex_word(slot), FUTEX_WAKE, INT_MAX, nullptr);
+    }
     return true;
 }
 
 inline bool orders_shm_write_order(orders_shm_layout* shm, OrderIndex index, const OrderRequest& request,
     OrderSlotState stage, order_slot_source_t source, TimestampNs update_ns) noexcept {
-    return orders_shm_mutate_slot(shm, index, [&](OrderSlot& slot) {
+    return orders_shm_mutate_slot(shm, index, update_ns, [&](OrderSlot& slot) {
         slot.request = request;
         slot.stage = stage;
         slot.source = source;
@@ -143,7 +526,7 @@ inline bool orders_shm_write_order(orders_shm_layout* shm, OrderIndex index, con
 
 inline bool orders_shm_sync_order(orders_shm_layout* shm, OrderIndex index, const OrderRequest& request,
     TimestampNs update_ns) noexcept {
-    return orders_shm_mutate_slot(shm, index, [&](OrderSlot& slot) {
+    return orders_shm_mutate_slot(shm, index, update_ns, [&](OrderSlot& slot) {
         slot.request = request;
         slot.last_update_ns = update_ns;
     });
@@ -151,12 +534,160 @@ inline bool orders_shm_sync_order(orders_shm_layout* shm, OrderIndex index, cons
 
 inline bool orders_shm_update_stage(
     orders_shm_layout* shm, OrderIndex index, OrderSlotState stage, TimestampNs update_ns) noexcept {
-    return orders_shm_mutate_slot(shm, index, [&](OrderSlot& slot) {
+    return orders_shm_mutate_slot(shm, index, update_ns, [&](OrderSlot& slot) {
         slot.stage = stage;
         slot.last_update_ns = update_ns;
     });
 }
 
+// 仅覆写与槽位内容不同的缓存行，返回实际写入的行数（调用方需处于 seqlock 写区间内）
+inline std::size_t orders_shm_copy_changed_lines(OrderRequest& dst, const OrderRequest& src) noexcept {
+    static_assert(sizeof(OrderRequest) % kCacheLineSize == 0, "OrderRequest must be cache-line sized");
+
+    auto* dst_bytes = reinterpret_cast<unsigned char*>(&dst);
+    const auto* src_bytes = reinterpret_cast<const unsigned char*>(&src);
+    std::size_t written = 0;
+    for (std::size_t offset = 0; offset < sizeof(OrderRequest); offset += kCacheLineSize) {
+        if (std::memcmp(dst_bytes + offset, src_bytes + offset, kCacheLineSize) != 0) {
+            std::memcpy(dst_bytes + offset, src_bytes + offset, kCacheLineSize);
+            ++written;
+        }
+    }
+    return written;
+}
+
+// 增量回写订单镜像：单个 seqlock 区间内只触碰变化的缓存行
+inline bool orders_shm_sync_order_delta(orders_shm_layout* shm, OrderIndex index, const OrderRequest& request,
+    TimestampNs update_ns) noexcept {
+    return orders_shm_mutate_slot(shm, index, update_ns, [&](OrderSlot& slot) {
+        (void)orders_shm_copy_changed_lines(slot.request, request);
+        slot.last_update_ns = update_ns;
+    });
+}
+
+// 增量回写订单镜像并同时切换阶段，合并为一次 seqlock 区间
+inline bool orders_shm_write_order_delta(orders_shm_layout* shm, OrderIndex index, const OrderRequest& request,
+    OrderSlotState stage, order_slot_source_t source, TimestampNs update_ns) noexcept {
+    return orders_shm_mutate_slot(shm, index, update_ns, [&](OrderSlot& slot) {
+        (void)orders_shm_copy_changed_lines(slot.request, request);
+        slot.stage = stage;
+        slot.source = source;
+        slot.last_update_ns = update_ns;
+    });
+}
+
+// 账户服务出队后独占写入该槽位：在同一 seqlock 区间内取出请求并切换阶段，
+// 省去读侧重试循环与额外的阶段写区间
+inline bool orders_shm_consume_order(orders_shm_layout* shm, OrderIndex index, OrderSlotState stage,
+    TimestampNs update_ns, OrderRequest& out_request) noexcept {
+    return orders_shm_mutate_slot(shm, index, update_ns, [&](OrderSlot& slot) {
+        out_request = slot.request;
+        slot.stage = stage;
+        slot.last_update_ns = update_ns;
+    });
+}
+
+// 记录 API 提交时间，需在索引推入上游队列前调用
+inline void orders_shm_mark_submit(orders_shm_layout* shm, OrderIndex index, TimestampNs mono_ns) noexcept {
+    OrderSlot* slot = orders_shm_find_slot(shm, index);
+    if (!slot) {
+        return;
+    }
+    slot->submit_ns.store(mono_ns, std::memory_order_relaxed);
+}
+
+// 记录某一跳到达时间；仅首次到达生效，未打点 submit 的槽位（如内部拆单子单）忽略
+inline void orders_shm_mark_hop(orders_shm_layout* shm, OrderIndex index, OrderLatencyHop hop,
+    TimestampNs mono_ns) noexcept {
+    OrderSlot* found = orders_shm_find_slot(shm, index);
+    if (!found) {
+        return;
+    }
+    OrderSlot& slot = *found;
+    const TimestampNs submit_ns = slot.submit_ns.load(std::memory_order_relaxed);
+    if (submit_ns == 0) {
+        return;
+    }
+    std::atomic<uint32_t>& delta = slot.hop_delta_ns[static_cast<std::size_t>(hop)];
+    if (delta.load(std::memory_order_relaxed) != 0) {
+        return;
+    }
+    const TimestampNs elapsed = mono_ns > submit_ns ? mono_ns - submit_ns : 1;
+    const uint32_t saturated = elapsed > UINT32_MAX ? UINT32_MAX : static_cast<uint32_t>(elapsed);
+    delta.store(saturated, std::memory_order_relaxed);
+}
+
+// 段内进度字区起点（按段头容量定位），访问前须确认对应槽位已映射
+inline std::atomic<uint64_t>* orders_shm_downstream_progress(orders_shm_layout* segment) noexcept {
+    return reinterpret_cast<std::atomic<uint64_t>*>(reinterpret_cast<char*>(segment) +
+                                                    orders_shm_progress_offset(segment->header.capacity));
+}
+
+inline const std::atomic<uint64_t>* orders_shm_downstream_progress(const orders_shm_layout* segment) noexcept {
+    return reinterpret_cast<const std::atomic<uint64_t>*>(reinterpret_cast<const char*>(segment) +
+                                                          orders_shm_progress_offset(segment->header.capacity));
+}
+
+// 网关下游进度字：高 8 位为阶段，低 56 位为相对段 create_time 的纳秒偏移（约 2.28 年），0 表示网关尚未写入
+inline constexpr uint32_t kDownstreamProgressStageShift = 56;
+inline constexpr uint64_t kDownstreamProgressOffsetMask = (uint64_t{1} << kDownstreamProgressStageShift) - 1;
+
+// 网关侧：记录下游进度（出队），只写本下标的进度字；下标未分配或所在段不可达时返回 false
+inline bool orders_shm_mark_downstream(orders_shm_layout* shm, OrderIndex index, OrderSlotState stage,
+    TimestampNs update_ns) noexcept {
+    OrderIndex local = 0;
+    orders_shm_layout* segment = orders_shm_segment_of(shm, index, local);
+    if (!segment || local >= segment->header.next_index.load(std::memory_order_acquire) ||
+        local >= segment->header.capacity || !orders_shm_slots_mapped(segment, local, local + 1)) {
+        return false;
+    }
+    const TimestampNs base_ns = segment->header.create_time;
+    const uint64_t offset =
+        update_ns > base_ns ? std::min<uint64_t>(update_ns - base_ns, kDownstreamProgressOffsetMask) : 0;
+    orders_shm_downstream_progress(segment)[local].store(
+        (static_cast<uint64_t>(stage) << kDownstreamProgressStageShift) | offset, std::memory_order_release);
+    return true;
+}
+
+// 读端：把段内下标的网关进度合并进槽位读出的阶段与更新时间。网关只推进 DownstreamQueued 之后的一步，
+// 账户服务已写入更后的阶段（终态、推送失败等）时以槽位为准，因此合并结果不会倒退
+inline void orders_shm_merge_downstream(const orders_shm_layout* segment, OrderIndex local, OrderSlotState& stage,
+    TimestampNs& last_update_ns) noexcept {
+    if (stage != OrderSlotState::DownstreamQueued) {
+        return;
+    }
+    const uint64_t word = orders_shm_downstream_progress(segment)[local].load(std::memory_order_acquire);
+    if (word == 0) {
+        return;
+    }
+    stage = static_cast<OrderSlotState>(word >> kDownstreamProgressStageShift);
+    last_update_ns = std::max<TimestampNs>(last_update_ns,
+                                           segment->header.create_time + (word & kDownstreamProgressOffsetMask));
+}
+
+// 同上，按全局下标定位所在段；段不可达时保持原值
+inline void orders_shm_merge_downstream_at(const orders_shm_layout* shm, OrderIndex index, OrderSlotState& stage,
+    TimestampNs& last_update_ns) noexcept {
+    OrderIndex local = 0;
+    const orders_shm_layout* segment = orders_shm_segment_of(shm, index, local);
+    if (segment && local < segment->header.capacity) {
+        orders_shm_merge_downstream(segment, local, stage, last_update_ns);
+    }
+}
+
+inline bool orders_shm_read_latency(const orders_shm_layout* shm, OrderIndex index, order_slot_latency& out) noexcept {
+    const OrderSlot* found = orders_shm_find_slot(shm, index);
+    if (!found) {
+        return false;
+    }
+    const OrderSlot& slot = *found;
+    out.submit_ns = slot.submit_ns.load(std::memory_order_relaxed);
+    for (std::size_t i = 0; i < kOrderLatencyHopCount; ++i) {
+        out.hop_delta_ns[i] = slot.hop_delta_ns[i].load(std::memory_order_relaxed);
+    }
+    return true;
+}
+
 inline bool orders_shm_append(orders_shm_layout* shm, const OrderRequest& request, OrderSlotState stage,
     order_slot_source_t source, TimestampNs update_ns, OrderIndex& out_index) noexcept {
     if (!orders_shm_try_allocate(shm, out_index)) {
@@ -165,12 +696,53 @@ inline bool orders_shm_append(orders_shm_layout* shm, const OrderRequest& reques
     return orders_shm_write_order(shm, out_index, request, stage, source, update_ns);
 }
 
+// 同 orders_shm_append，request 未带订单号时按分到的槽位编码并回填
+inline bool orders_shm_append_assign_id(orders_shm_layout* shm, OrderRequest& request, OrderSlotState stage,
+    order_slot_source_t source, TimestampNs update_ns, OrderIndex& out_index) noexcept {
+    if (!orders_shm_try_allocate(shm, out_index)) {
+        return false;
+    }
+    if (request.internal_order_id == 0) {
+        request.internal_order_id = orders_shm_order_id(shm, out_index);
+    }
+    return orders_shm_write_order(shm, out_index, request, stage, source, update_ns);
+}
+
+// 在 seqlock 稳定区间内直接从槽位读取所需字段，省去整份快照拷贝；
+// reader 在重试时可能被调用多次，只有返回 true 时最后一次读取的结果有效
+template <typename Reader>
+inline bool orders_shm_read_slot(const orders_shm_layout* shm, OrderIndex index, Reader&& reader) noexcept {
+    const OrderSlot* found = orders_shm_find_slot(shm, index);
+    if (!found) {
+        return false;
+    }
+
+    const OrderSlot& slot = *found;
+    for (uint32_t attempt = 0; attempt < 32; ++attempt) {
+        const uint64_t seq0 = slot.seq.load(std::memory_order_acquire);
+        if ((seq0 & 1ULL) != 0U) {
+            continue;
+        }
+
+        reader(slot);
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        const uint64_t seq1 = slot.seq.load(std::memory_order_acquire);
+        if (seq0 == seq1) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
 inline bool orders_shm_read_snapshot(const orders_shm_layout* shm, OrderIndex index, order_slot_snapshot& out) noexcept {
-    if (!orders_shm_index_exists(shm, index)) {
+    const OrderSlot* found = orders_shm_find_slot(shm, index);
+    if (!found) {
         return false;
     }
 
-    const OrderSlot& slot = shm->slots[index];
+    const OrderSlot& slot = *found;
     for (uint32_t attempt = 0; attempt < 32; ++attempt) {
         const uint64_t seq0 = slot.seq.load(std::memory_order_acquire);
         if ((seq0 & 1ULL) != 0U) {
@@ -186,6 +758,7 @@ inline bool orders_shm_read_snapshot(const orders_shm_layout* shm, OrderIndex in
         std::atomic_thread_fence(std::memory_order_acquire);
         const uint64_t seq1 = slot.seq.load(std::memory_order_acquire);
         if (seq0 == seq1 && (seq1 & 1ULL) == 0U) {
+            orders_shm_merge_downstream_at(shm, index, snapshot.stage, snapshot.last_update_ns);
             out = snapshot;
             return true;
         }
@@ -194,4 +767,51 @@ inline bool orders_shm_read_snapshot(const orders_shm_layout* shm, OrderIndex in
     return false;
 }
 
+enum class orders_slot_wait_result : uint8_t {
+    Matched = 0,
+    Timeout = 1,
+    NotFound = 2,
+};
+
+// 单次 futex 休眠上限：写者发布时不加 fence，登记与发布交错的极小窗口可能漏掉唤醒，最多多睡一个分段
+inline constexpr TimestampNs kSlotWaitSliceNs = 1'000'000;
+
+// 在槽位 seq 上等待直到 done(snapshot) 为真或超时；每次 seq 变化都会唤醒并复查，out 为最后一次读到的稳定快照。
+// timeout_ns 为 0 时只判断一次
+template <typename Done>
+inline orders_slot_wait_result orders_shm_wait_slot(const orders_shm_layout* shm, OrderIndex index,
+                                                    TimestampNs timeout_ns, Done&& done,
+                                                    order_slot_snapshot& out) noexcept {
+    OrderSlot* found = orders_shm_find_slot(shm, index);
+    if (!found) {
+        return orders_slot_wait_result::NotFound;
+    }
+    OrderSlot& slot = *found;
+    std::atomic<uint32_t>* word = orders_shm_detail::slot_futex_word(slot);
+    const TimestampNs start_ns = now_monotonic_ns();
+    const TimestampNs deadline_ns = timeout_ns > UINT64_MAX - start_ns ? UINT64_MAX : start_ns + timeout_ns;
+
+    for (;;) {
+        const uint32_t observed = static_cast<uint32_t>(slot.seq.load(std::memory_order_acquire));
+        if (orders_shm_read_snapshot(shm, index, out) && done(static_cast<const order_slot_snapshot&>(out))) {
+            return orders_slot_wait_result::Matched;
+        }
+        const TimestampNs now = now_monotonic_ns();
+        if (now >= deadline_ns) {
+            return orders_slot_wait_result::Timeout;
+        }
+
+        // 先登记再复查 seq：登记之后的发布必然看到等待者并唤醒
+        slot.waiters.fetch_add(1, std::memory_order_seq_cst);
+        if (static_cast<uint32_t>(slot.seq.load(std::memory_order_seq_cst)) == observed) {
+            const TimestampNs sleep_ns = std::min(deadline_ns - now, kSlotWaitSliceNs);
+            timespec timeout{};
+            timeout.tv_sec = static_cast<time_t>(sleep_ns / 1'000'000'000ULL);
+            timeout.tv_nsec = static_cast<long>(sleep_ns % 1'000'000'000ULL);
+            (void)doorbell_detail::futex(word, FUTEX_WAIT, observed, &timeout);
+        }
+        slot.waiters.fetch_sub(1, std::memory_order_release);
+    }
+}
+
 }  // namespace acct_service
@@ -0,0 +1,236 @@
+#include "shm/orders_window_map.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdlib>
+
+#include "shm/orders_shm.hpp"
+
+namespace acct_service {
+
+std::atomic<uint32_t> g_orders_window_maps{0};
+
+namespace {
+
+constexpr std::size_t kMaxWindowMaps = 16;  // 单进程内可同时登记的窗口化主段映射数
+
+// 进程内窗口表：段基址 -> 窗口映射。查找只读原子量不加锁，登记与注销持锁；有意不析构
+struct window_map_entry {
+    std::atomic<const orders_shm_layout*> layout{nullptr};
+    std::atomic<orders_window_map*> map{nullptr};
+};
+
+struct window_map_registry {
+    std::mutex mutex;
+    window_map_entry entries[kMaxWindowMaps];
+};
+
+window_map_registry& registry() {
+    static window_map_registry* instance = new window_map_registry();
+    return *instance;
+}
+
+bool register_window_map(const orders_shm_layout* layout, orders_window_map* map) noexcept {
+    window_map_registry& table = registry();
+    std::lock_guard<std::mutex> lock(table.mutex);
+    for (window_map_entry& entry : table.entries) {
+        if (entry.layout.load(std::memory_order_relaxed) != nullptr) {
+            continue;
+        }
+        entry.map.store(map, std::memory_order_relaxed);
+        entry.layout.store(layout, std::memory_order_release);
+        g_orders_window_maps.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+    return false;
+}
+
+void unregister_window_map(const orders_shm_layout* layout) noexcept {
+    window_map_registry& table = registry();
+    std::lock_guard<std::mutex> lock(table.mutex);
+    for (window_map_entry& entry : table.entries) {
+        if (entry.layout.load(std::memory_order_relaxed) == layout) {
+            entry.layout.store(nullptr, std::memory_order_release);
+            entry.map.store(nullptr, std::memory_order_relaxed);
+            g_orders_window_maps.fetch_sub(1, std::memory_order_relaxed);
+            return;
+        }
+    }
+}
+
+std::size_t round_up(std::size_t value, std::size_t unit) noexcept { return (value + unit - 1) / unit * unit; }
+
+}  // namespace
+
+orders_window_map::~orders_window_map() noexcept { close(); }
+
+orders_shm_layout* orders_window_map::open(std::string_view name, std::size_t size, std::size_t window_bytes,
+                                           bool writable, bool huge_pages) {
+    close();
+    const std::size_t page = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+    if (size == 0 || window_bytes == 0) {
+        errno = EINVAL;
+        return nullptr;
+    }
+    const std::string path(name);
+    fd_ = ::shm_open(path.c_str(), (writable ? O_RDWR : O_RDONLY) | O_CLOEXEC, 0);
+    if (fd_ < 0) {
+        return nullptr;
+    }
+
+    window_bytes_ = round_up(window_bytes, page);
+    const std::size_t align = window_bytes_ % kHugePageBytes == 0 ? kHugePageBytes : page;
+    reservation_size_ = round_up(size, page) + align;
+    reservation_ = ::mmap(nullptr, reservation_size_, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (reservation_ == MAP_FAILED) {
+        const int err = errno;
+        reservation_ = nullptr;
+        close();
+        errno = err;
+        return nullptr;
+    }
+    const auto start = reinterpret_cast<std::uintptr_t>(reservation_);
+    base_ = reinterpret_cast<void*>(round_up(start, align));
+
+    size_ = size;
+    window_count_ = (size + window_bytes_ - 1) / window_bytes_;
+    mapped_bits_ = std::make_unique<std::atomic<uint64_t>[]>((window_count_ + 63) / 64);
+    writable_ = writable;
+    huge_pages_ = huge_pages;
+    name_.assign(name);
+
+    // 头部与变更日志随打开一并映射，之后的访问只可能落在槽位区
+    if (!ensure(0, offsetof(orders_shm_layout, slots))) {
+        const int err = errno;
+        close();
+        errno = err;
+        return nullptr;
+    }
+    registered_ = register_window_map(layout(), this);
+    if (!registered_ && !ensure(0, size_)) {
+        // 窗口表已满：退化为整段映射，访问器无需补映射
+        const int err = errno;
+        close();
+        errno = err;
+        return nullptr;
+    }
+    return layout();
+}
+
+void orders_window_map::close() noexcept {
+    if (registered_) {
+        unregister_window_map(layout());
+        registered_ = false;
+    }
+    if (reservation_) {
+        (void)::munmap(reservation_, reservation_size_);
+        reservation_ = nullptr;
+    }
+    if (fd_ >= 0) {
+        (void)::close(fd_);
+        fd_ = -1;
+    }
+    base_ = nullptr;
+    reservation_size_ = 0;
+    size_ = 0;
+    window_bytes_ = 0;
+    window_count_ = 0;
+    mapped_bits_.reset();
+    mapped_windows_.store(0, std::memory_order_relaxed);
+    name_.clear();
+}
+
+bool orders_window_map::ensure(std::size_t offset, std::size_t length) noexcept {
+    if (!base_ || offset >= size_ || length > size_ - offset) {
+        return false;
+    }
+    if (length == 0) {
+        return true;
+    }
+    const std::size_t first = offset / window_bytes_;
+    const std::size_t last = (offset + length - 1) / window_bytes_;
+    for (std::size_t window = first; window <= last; ++window) {
+        const uint64_t bit = uint64_t{1} << (window % 64);
+        if ((mapped_bits_[window / 64].load(std::memory_order_acquire) & bit) == 0 && !map_window(window)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool orders_window_map::map_window(std::size_t window) noexcept {
+    std::lock_guard<std::mutex> lock(map_mutex_);
+    std::atomic<uint64_t>& word = mapped_bits_[window / 64];
+    const uint64_t bit = uint64_t{1} << (window % 64);
+    if ((word.load(std::memory_order_relaxed) & bit) != 0) {
+        return true;
+    }
+    const std::size_t offset = window * window_bytes_;
+    const std::size_t length = std::min(window_bytes_, size_ - offset);
+    void* target = static_cast<char*>(base_) + offset;
+    const int prot = writable_ ? (PROT_READ | PROT_WRITE) : PROT_READ;
+    if (::mmap(target, length, prot, MAP_SHARED | MAP_FIXED, fd_, static_cast<off_t>(offset)) == MAP_FAILED) {
+        return false;
+    }
+#if defined(MADV_HUGEPAGE)
+    if (huge_pages_) {
+        (void)::madvise(target, length, MADV_HUGEPAGE);
+    }
+#endif
+    word.fetch_or(bit, std::memory_order_release);
+    mapped_windows_.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+std::size_t orders_window_map::mapped_bytes() const noexcept {
+    if (!base_) {
+        return 0;
+    }
+    std::size_t bytes = 0;
+    for (std::size_t window = 0; window < window_count_; ++window) {
+        if ((mapped_bits_[window / 64].load(std::memory_order_relaxed) & (uint64_t{1} << (window % 64))) != 0) {
+            bytes += std::min(window_bytes_, size_ - window * window_bytes_);
+        }
+    }
+    return bytes;
+}
+
+bool orders_shm_map_window_slots(const orders_shm_layout* segment, OrderIndex local_begin,
+                                 OrderIndex local_end) noexcept {
+    if (!segment || local_end <= local_begin) {
+        return true;
+    }
+    for (window_map_entry& entry : registry().entries) {
+        if (entry.layout.load(std::memory_order_acquire) != segment) {
+            continue;
+        }
+        orders_window_map* map = entry.map.load(std::memory_order_relaxed);
+        const std::size_t offset = offsetof(orders_shm_layout, slots) + std::size_t{local_begin} * sizeof(OrderSlot);
+        const std::size_t count = std::size_t{local_end - local_begin};
+        const std::size_t progress = orders_shm_progress_offset(segment->header.capacity) +
+                                     std::size_t{local_begin} * sizeof(std::atomic<uint64_t>);
+        return map && map->ensure(offset, count * sizeof(OrderSlot)) &&
+               map->ensure(progress, count * sizeof(std::atomic<uint64_t>));
+    }
+    return true;
+}
+
+std::size_t orders_window_bytes_from_env() noexcept {
+    const char* value = std::getenv("ACCT_ORDERS_MAP_WINDOW_KB");
+    if (value == nullptr || value[0] == '\0') {
+        return orders_window_map::kDefaultWindowBytes;
+    }
+    char* end = nullptr;
+    const unsigned long long kib = std::strtoull(value, &end, 10);
+    if (end == value || *end != '\0') {
+        return orders_window_map::kDefaultWindowBytes;
+    }
+    return static_cast<std::size_t>(kib) * 1024;
+}
+
+}  // namespace acct_service
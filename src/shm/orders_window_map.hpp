@@ -0,0 +1,73 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+
+#include "shm/shm_layout.hpp"
+
+namespace acct_service {
+
+// 订单池段的窗口化映射（策略、工具等短生命周期接入方）：整段只保留地址空间（PROT_NONE，不占页表），
+// 打开时映射头部与变更日志，槽位按固定大小的窗口在首次访问时以 MAP_FIXED 映射到原偏移。
+// 段内地址与全量映射一致，槽位访问器经 orders_shm_slots_mapped() 透明补映射；窗口一经映射不再解除。
+// 窗口为 2 MiB 整倍数时保留区按 2 MiB 对齐，huge_pages 开启时逐窗口 madvise(MADV_HUGEPAGE)。
+class orders_window_map {
+public:
+    static constexpr std::size_t kDefaultWindowBytes = std::size_t{2} << 20;
+    static constexpr std::size_t kHugePageBytes = std::size_t{2} << 20;
+
+    orders_window_map() = default;
+    ~orders_window_map() noexcept;
+
+    orders_window_map(const orders_window_map&) = delete;
+    orders_window_map& operator=(const orders_window_map&) = delete;
+
+    // 打开已存在的段（不创建）：size 为段大小，window_bytes 向上取整到页大小；
+    // 返回段基址（头部与变更日志已映射），失败时返回 nullptr 且 errno 保留系统错误
+    orders_shm_layout* open(std::string_view name, std::size_t size, std::size_t window_bytes, bool writable,
+                            bool huge_pages);
+
+    // 解除全部映射并从进程内窗口表注销
+    void close() noexcept;
+
+    // 确保段内字节区间 [offset, offset + length) 所在窗口均已映射；越界或映射失败返回 false
+    bool ensure(std::size_t offset, std::size_t length) noexcept;
+
+    bool is_open() const noexcept { return base_ != nullptr; }
+    orders_shm_layout* layout() const noexcept { return static_cast<orders_shm_layout*>(base_); }
+    const std::string& name() const noexcept { return name_; }
+    std::size_t size() const noexcept { return size_; }
+    std::size_t window_bytes() const noexcept { return window_bytes_; }
+    std::size_t window_count() const noexcept { return window_count_; }
+    // 已映射窗口数与字节数（观测本进程实际建立的映射规模）
+    std::size_t mapped_windows() const noexcept { return mapped_windows_.load(std::memory_order_relaxed); }
+    std::size_t mapped_bytes() const noexcept;
+
+private:
+    bool map_window(std::size_t window) noexcept;
+
+    void* base_ = nullptr;              // 段基址（保留区内，按窗口对齐）
+    void* reservation_ = nullptr;       // 保留区起点与长度（含对齐余量）
+    std::size_t reservation_size_ = 0;
+    std::size_t size_ = 0;
+    std::size_t window_bytes_ = 0;
+    std::size_t window_count_ = 0;
+    int fd_ = -1;
+    bool writable_ = false;
+    bool huge_pages_ = false;
+    bool registered_ = false;
+    std::string name_;
+    std::unique_ptr<std::atomic<uint64_t>[]> mapped_bits_;  // 每窗口一位，置位前映射已完成
+    std::atomic<std::size_t> mapped_windows_{0};
+    std::mutex map_mutex_;  // 串行化窗口映射，已映射窗口的检查不加锁
+};
+
+// 接入方窗口大小：环境变量 ACCT_ORDERS_MAP_WINDOW_KB 覆盖（0 表示整段一次映射），未设置时取默认 2 MiB
+std::size_t orders_window_bytes_from_env() noexcept;
+
+}  // namespace acct_service
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "portfolio/positions.h"
+#include "shm/shm_layout.hpp"
+
+namespace acct_service {
+
+// 登记一次持仓行变更：先写行戳与分组戳，再 release 发布全局 version。
+// 读者 acquire 读到 version=V 后，所有戳 <= V 的变更都已可见，游标推进到 V 不会漏行。
+inline void positions_shm_mark_row_changed(positions_shm_layout& shm, std::size_t row_index) noexcept {
+    if (row_index >= kMaxPositions) {
+        return;
+    }
+    position_change_index& changes = shm.changes;
+    const uint64_t next = changes.version.load(std::memory_order_relaxed) + 1;
+    changes.row_versions[row_index].store(next, std::memory_order_relaxed);
+    changes.group_versions[row_index / kPositionChangeGroupRows].store(next, std::memory_order_relaxed);
+    changes.version.store(next, std::memory_order_release);
+}
+
+inline void positions_shm_mark_changed(positions_shm_layout& shm, const position& row) noexcept {
+    positions_shm_mark_row_changed(shm, static_cast<std::size_t>(&row - shm.positions));
+}
+
+// 新建持仓池时清空变更戳；读者据 version 回退识别重建并从头拉取。
+inline void positions_shm_reset_changes(positions_shm_layout& shm) noexcept {
+    position_change_index& changes = shm.changes;
+    for (auto& group_version : changes.group_versions) {
+        group_version.store(0, std::memory_order_relaxed);
+    }
+    for (auto& row_version : changes.row_versions) {
+        row_version.store(0, std::memory_order_relaxed);
+    }
+    changes.version.store(0, std::memory_order_release);
+}
+
+// 持仓行写区间并登记变更：seqlock 进入写态后再打戳，读者按戳拉取该行时必然等到本次写入完成。
+struct tracked_position_lock {
+    position_lock lock;
+    tracked_position_lock(positions_shm_layout& shm, position& row) : lock(row) {
+        positions_shm_mark_changed(shm, row);
+    }
+};
+
+// 发布 FUND 工作副本：写区间内拷贝到读者快照，资金变更沿用第 0 行的变更戳，增量读者无需区分资金与证券行。
+inline void positions_shm_publish_fund(positions_shm_layout& shm) noexcept {
+    position_lock guard(shm.fund.seq);
+    positions_shm_mark_row_changed(shm, kFundPositionIndex);
+    shm.fund.published = shm.fund.working;
+}
+
+// 读取 FUND 读者快照；写区间内返回 false，调用方重试。
+inline bool positions_shm_try_read_fund(const positions_shm_layout& shm, fund_info& out_fund) noexcept {
+    return position_try_read(shm.fund, [&out_fund](const fund_row& row) { out_fund = row.published; });
+}
+
+// 扫描戳落在 (cursor, limit] 的行，按物理行号升序写入 out_rows（最多 max_rows 个），返回命中总数。
+// 分组戳 <= cursor 的 64 行整组跳过；返回值大于 max_rows 表示输出被截断。只读变更戳，v6/v7 布局通用。
+template <typename Layout>
+inline std::size_t positions_shm_scan_changed(const Layout& shm, uint64_t cursor, uint64_t limit,
+                                              uint32_t* out_rows, std::size_t max_rows) noexcept {
+    const position_change_index& changes = shm.changes;
+    std::size_t hits = 0;
+    for (std::size_t group = 0; group < kPositionChangeGroupCount; ++group) {
+        if (changes.group_versions[group].load(std::memory_order_relaxed) <= cursor) {
+            continue;
+        }
+        const std::size_t begin = group * kPositionChangeGroupRows;
+        const std::size_t end =
+            begin + kPositionChangeGroupRows < kMaxPositions ? begin + kPositionChangeGroupRows : kMaxPositions;
+        for (std::size_t row = begin; row < end; ++row) {
+            const uint64_t row_version = changes.row_versions[row].load(std::memory_order_relaxed);
+            if (row_version <= cursor || row_version > limit) {
+                continue;
+            }
+            if (hits < max_rows) {
+                out_rows[hits] = static_cast<uint32_t>(row);
+            }
+            ++hits;
+        }
+    }
+    return hits;
+}
+
+// 收集自 cursor 以来变更过的物理行号（升序），返回写入数量；out_version 为调用方下一次的游标。
+// 每行只保留最近一次戳，不同行的戳互不相同；输出放不下时二分出能装满的最大版本上界，
+// 只返回戳不超过该上界的行，保证游标单调前进且不漏行。
+template <typename Layout>
+inline std::size_t positions_shm_collect_changed(const Layout& shm, uint64_t cursor,
+                                                 uint32_t* out_rows, std::size_t max_rows,
+                                                 uint64_t& out_version) noexcept {
+    const uint64_t version = shm.changes.version.load(std::memory_order_acquire);
+    out_version = cursor;
+    if (version <= cursor || max_rows == 0) {
+        return 0;
+    }
+
+    const std::size_t hits = positions_shm_scan_changed(shm, cursor, version, out_rows, max_rows);
+    if (hits <= max_rows) {
+        out_version = version;
+        return hits;
+    }
+
+    uint64_t low = cursor + 1;  // (cursor, cursor+1] 至多一行，必然装得下
+    uint64_t high = version;
+    while (low < high) {
+        const uint64_t mid = low + (high - low + 1) / 2;
+        if (positions_shm_scan_changed(shm, cursor, mid, out_rows, 0) <= max_rows) {
+            low = mid;
+        } else {
+            high = mid - 1;
+        }
+    }
+    out_version = low;
+    const std::size_t count = positions_shm_scan_changed(shm, cursor, low, out_rows, max_rows);
+    return count < max_rows ? count : max_rows;
+}
+
+}  // namespace acct_service
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include "common/types.hpp"
+#include "shm/shm_layout.hpp"
+
+namespace acct_service {
+
+// 连续读到写区间时放弃预检的重试次数
+inline constexpr uint32_t kRiskParamsReadRetries = 64;
+
+// 风控参数段名跟随上游段（下单 API 只知道上游段名）：/upstream_order_shm -> /upstream_order_shm_risk
+inline std::string make_risk_params_shm_name(std::string_view upstream_name) {
+    std::string name(upstream_name);
+    name += "_risk";
+    return name;
+}
+
+// 单写者发布区间：begin 后清空价格带、写参数与价格带，end 时发布。写者只有账户线程。
+inline void risk_params_begin_publish(risk_params_shm_layout* shm) noexcept {
+    const uint32_t seq = shm->seq.load(std::memory_order_relaxed);
+    shm->seq.store(seq | 1U, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    if (shm->band_count != 0) {
+        for (risk_params_band& band : shm->bands) {
+            band = risk_params_band{};
+        }
+        shm->band_count = 0;
+    }
+}
+
+inline void risk_params_end_publish(risk_params_shm_layout* shm) noexcept {
+    shm->publish_ns = now_ns();
+    const uint32_t seq = shm->seq.load(std::memory_order_relaxed);
+    shm->seq.store((seq | 1U) + 1U, std::memory_order_release);
+}
+
+// 写入一条价格带（发布区间内调用）；id 须已归一化，重复键覆盖，表满返回 false
+inline bool risk_params_put_band(risk_params_shm_layout* shm, const InternalSecurityId& id, DPrice limit_up,
+                                 DPrice limit_down) noexcept {
+    std::size_t slot = static_cast<std::size_t>(shm_security_key_hash(id)) & (kRiskParamsBandCapacity - 1);
+    for (std::size_t probe = 0; probe < kRiskParamsBandCapacity; ++probe) {
+        risk_params_band& band = shm->bands[slot];
+        if (band.id.empty() || band.id == id) {
+            if (band.id.empty()) {
+                band.id = id;
+                ++shm->band_count;
+            }
+            band.limit_up = limit_up;
+            band.limit_down = limit_down;
+            return true;
+        }
+        slot = (slot + 1) & (kRiskParamsBandCapacity - 1);
+    }
+    return false;
+}
+
+inline const risk_params_band* risk_params_find_band(const risk_params_shm_layout& shm,
+                                                     const InternalSecurityId& id) noexcept {
+    std::size_t slot = static_cast<std::size_t>(shm_security_key_hash(id)) & (kRiskParamsBandCapacity - 1);
+    for (std::size_t probe = 0; probe < kRiskParamsBandCapacity; ++probe) {
+        const risk_params_band& band = shm.bands[slot];
+        if (band.id.empty()) {
+            return nullptr;
+        }
+        if (band.id == id) {
+            return &band;
+        }
+        slot = (slot + 1) & (kRiskParamsBandCapacity - 1);
+    }
+    return nullptr;
+}
+
+// 新单的无状态预检，判定与服务端 max_order_value / max_order_volume / price_limit 规则一致。
+// 参数尚未发布或持续处于发布区间时放行（服务端仍会复检）；id 须已归一化
+inline RiskResult risk_params_precheck(const risk_params_shm_layout& shm, const InternalSecurityId& id, Volume volume,
+                                       DPrice price) noexcept {
+    for (uint32_t attempt = 0; attempt < kRiskParamsReadRetries; ++attempt) {
+        const uint32_t seq0 = shm.seq.load(std::memory_order_acquire);
+        if (seq0 == 0) {
+            return RiskResult::Pass;
+        }
+        if ((seq0 & 1U) != 0) {
+            continue;
+        }
+
+        RiskResult result = RiskResult::Pass;
+        const __uint128_t value = static_cast<__uint128_t>(volume) * static_cast<__uint128_t>(price);
+        if (shm.max_order_value != 0 && value > static_cast<__uint128_t>(shm.max_order_value)) {
+            result = RiskResult::RejectExceedMaxOrderValue;
+        } else if (shm.max_order_volume != 0 && volume > shm.max_order_volume) {
+            result = RiskResult::RejectExceedMaxOrderVolume;
+        } else if ((shm.flags & kRiskParamsPriceLimit) != 0 && shm.band_count != 0) {
+            const risk_params_band* band = risk_params_find_band(shm, id);
+            if (band && ((band->limit_up != 0 && price > band->limit_up) ||
+                         (band->limit_down != 0 && price < band->limit_down))) {
+                result = RiskResult::RejectPriceOutOfRange;
+            }
+        }
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (shm.seq.load(std::memory_order_relaxed) == seq0) {
+            return result;
+        }
+    }
+    return RiskResult::Pass;
+}
+
+}  // namespace acct_service
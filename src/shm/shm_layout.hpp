@@ -1,13 +1,21 @@
 #pragma once
 
 #include <atomic>
+#include <cstddef>
 #include <cstdint>
+#include <cstring>
 #include <limits>
 
 #include "common/constants.hpp"
+#include "common/latency_histogram.hpp"
+#include "common/metrics_registry.hpp"
+#include "common/queue_depth_histogram.hpp"
+#include "common/security_identity.hpp"
 #include "common/types.hpp"
 #include "order/order_request.hpp"
 #include "portfolio/positions.h"
+#include "risk/risk_stats.hpp"
+#include "shm/doorbell.hpp"
 #include "shm/spsc_queue.hpp"
 
 namespace acct_service {
@@ -18,11 +26,13 @@ struct alignas(64) SHMHeader {
     uint32_t version;                        // 版本号
     TimestampNs create_time;              // 创建时间
     TimestampNs last_update;              // 最后更新时间
-    std::atomic<uint32_t> next_order_id{1};  // 订单ID计数器（跨进程持久化）
+    std::atomic<uint32_t> next_id_epoch{1};  // 订单号纪元计数器，每个新订单池取一个（跨进程持久化）
     uint64_t reserved[4];                    // 预留字段
 
     static constexpr uint32_t kMagic = 0x41435354;
-    static constexpr uint32_t kVersion = 4;
+    // v15: 运维指令段新增写者 pid；v14: 统计段新增队列深度直方图；v13: 每条上游 lane 的内联订单消息环；v12: 统计段新增柜台往返延迟直方图；v11: 每条上游 lane 的本方订单回报环；v10: 成交回报队列改为 64 字节紧凑消息；v9: 订单号改由订单池槽位编码，计数器改为纪元；v8: 下游柜台能力位；
+    // v7: 撤单优先队列
+    static constexpr uint32_t kVersion = 15;
 };
 
 static_assert(sizeof(SHMHeader) == 64, "SHMHeader must be 64 bytes");
@@ -41,7 +51,9 @@ struct alignas(64) PositionsHeader {
     uint32_t reserved[3];        // 预留/对齐
 
     static constexpr uint32_t kMagic = 0x41435354;
-    static constexpr uint32_t kVersion = 4;
+    static constexpr uint32_t kVersion = 8;  // v8: FUND 资金独立为 fund_row，不再复用第 0 行证券列
+    static constexpr uint32_t kVersionV7 = 7;  // v7: 持仓行按 64 字节对齐并按冷热分段（监控仍可只读）
+    static constexpr uint32_t kVersionV6 = 6;  // v6: 新增行变更戳索引 position_change_index（监控仍可只读）
 };
 
 static_assert(sizeof(PositionsHeader) == 64, "PositionsHeader must be 64 bytes");
@@ -65,6 +77,88 @@ struct alignas(64) TradeResponse {
 
 static_assert(sizeof(TradeResponse) == 128, "TradeResponse must be 128 bytes");
 
+// 成交回报队列元素：TradeResponse 的 64 字节紧凑编码，一条回报一条缓存行。
+// 带成交（kFill）时只带数量、金额与费用，证券由账户服务按订单号回查；受理、拒单与无成交的完成
+// 不带成交字段，改带证券键。进程内仍使用 TradeResponse，只在写入/取出 trades_shm 时编解码
+struct alignas(64) trade_response_message {
+    static constexpr uint8_t kFill = 0x01;
+
+    // 成交回报：数量、撤销数量、价格、金额与费用
+    struct fill_fields {
+        Volume volume_traded;
+        Volume cancelled_volume;
+        DPrice dprice_traded;
+        DValue dvalue_traded;
+        DValue dfee;
+    };
+    // 无成交回报：证券键与撤销数量（完成回报的权威撤销量）
+    struct status_fields {
+        char internal_security_id[kInternalSecurityIdSize];
+        Volume cancelled_volume;
+    };
+
+    InternalOrderId internal_order_id;
+    InternalOrderId broker_order_id;
+    OrderState new_state;
+    TradeSide trade_side;
+    uint8_t flags;
+    uint8_t reserved0;
+    MdTime md_time_traded;
+    TimestampNs recv_time_ns;
+    union {
+        fill_fields fill;
+        status_fields status;
+    };
+};
+
+static_assert(sizeof(trade_response_message) == 64, "trade_response_message must be 64 bytes");
+
+// 编码为紧凑消息：数量、价格、金额、费用任一非零即按成交编码，成交回报不再携带证券键
+inline void pack_trade_response_message(const TradeResponse& response, trade_response_message& out) noexcept {
+    out.internal_order_id = response.internal_order_id;
+    out.broker_order_id = response.broker_order_id;
+    out.new_state = response.new_state;
+    out.trade_side = response.trade_side;
+    out.reserved0 = 0;
+    out.md_time_traded = response.md_time_traded;
+    out.recv_time_ns = response.recv_time_ns;
+    if (response.volume_traded != 0 || response.dprice_traded != 0 || response.dvalue_traded != 0 ||
+        response.dfee != 0) {
+        out.flags = trade_response_message::kFill;
+        out.fill.volume_traded = response.volume_traded;
+        out.fill.cancelled_volume = response.cancelled_volume;
+        out.fill.dprice_traded = response.dprice_traded;
+        out.fill.dvalue_traded = response.dvalue_traded;
+        out.fill.dfee = response.dfee;
+        return;
+    }
+    out.flags = 0;
+    std::memcpy(out.status.internal_security_id, response.internal_security_id.data, kInternalSecurityIdSize);
+    out.status.cancelled_volume = response.cancelled_volume;
+}
+
+// 解码为 TradeResponse：成交消息的证券键留空，账户服务按订单自身证券处理
+inline void unpack_trade_response_message(const trade_response_message& message, TradeResponse& out) noexcept {
+    out = TradeResponse{};
+    out.internal_order_id = message.internal_order_id;
+    out.broker_order_id = message.broker_order_id;
+    out.new_state = message.new_state;
+    out.trade_side = message.trade_side;
+    out.md_time_traded = message.md_time_traded;
+    out.recv_time_ns = message.recv_time_ns;
+    if ((message.flags & trade_response_message::kFill) != 0) {
+        out.volume_traded = message.fill.volume_traded;
+        out.cancelled_volume = message.fill.cancelled_volume;
+        out.dprice_traded = message.fill.dprice_traded;
+        out.dvalue_traded = message.fill.dvalue_traded;
+        out.dfee = message.fill.dfee;
+        return;
+    }
+    std::memcpy(out.internal_security_id.data, message.status.internal_security_id, kInternalSecurityIdSize);
+    out.internal_security_id.data[kInternalSecurityIdSize - 1] = '\0';
+    out.cancelled_volume = message.status.cancelled_volume;
+}
+
 using OrderIndex = uint32_t;
 inline constexpr OrderIndex kInvalidOrderIndex = std::numeric_limits<OrderIndex>::max();
 
@@ -86,6 +180,18 @@ enum class order_slot_source_t : uint8_t {
     AccountInternal = 2,
 };
 
+// 订单全链路打点（submit 之后的各跳，记录为相对 submit_ns 的增量）
+enum class OrderLatencyHop : uint8_t {
+    UpstreamDequeued = 0,  // 账户服务上游出队
+    RiskAccepted = 1,      // 风控通过
+    DownstreamQueued = 2,  // 推入下游队列
+    GatewayDequeued = 3,   // gateway 出队
+    AdapterSubmitted = 4,  // 适配器 submit 返回
+    FirstResponse = 5,     // 账户服务处理首个回报
+};
+
+inline constexpr std::size_t kOrderLatencyHopCount = 6;
+
 // 订单池共享内存头部（订单镜像+索引队列协议）
 struct alignas(64) OrdersHeader {
     uint32_t magic;
@@ -99,11 +205,18 @@ struct alignas(64) OrdersHeader {
     std::atomic<OrderIndex> next_index{0};  // 当日已发布槽位上界（不复用）
     std::atomic<uint64_t> full_reject_count{0};
     char trading_day[9]{};
-    uint8_t reserved0[7]{};
-    uint64_t reserved[3]{};
+    uint8_t reserved0[3]{};
+    std::atomic<uint32_t> predecessor_day{0};  // 换日切入本池时的上一交易日（YYYYMMDD 数值），0=非换日切入
+    shm_doorbell account_doorbell;  // 策略/gateway 入队后唤醒账户服务
+    shm_doorbell gateway_doorbell;  // 账户服务下发订单后唤醒 gateway
+    std::atomic<uint32_t> id_epoch{0};  // 订单号纪元，0=尚未绑定（见 orders_shm_bind_id_epoch）
+    std::atomic<uint32_t> successor_day{0};  // 账户服务已换日到的新交易日（YYYYMMDD 数值），0=本池仍在用
+    std::atomic<uint32_t> overflow_segments{0};  // 本池已链上并发布的溢出段数（仅主段有效）
+    uint32_t overflow_index{0};                  // 本段在溢出链中的段号，0=主段
 
     static constexpr uint32_t kMagic = 0x4143534F;  // "ACSO"
-    static constexpr uint32_t kVersion = 2;
+    // v8: 进度字区移到槽位之后、按 capacity 定长；v7: 网关下游进度数组；v6: 溢出段链；v5: 换日前后继交易日；v4: 订单号按纪元+槽位下标编码
+    static constexpr uint32_t kVersion = 8;
 };
 
 static_assert(alignof(OrdersHeader) == 64, "OrdersHeader must be 64-byte aligned");
@@ -116,52 +229,572 @@ struct alignas(64) OrderSlot {
     OrderSlotState stage{OrderSlotState::Empty};
     order_slot_source_t source{order_slot_source_t::Unknown};
     uint16_t reserved0{0};
-    uint32_t reserved1{0};
+    std::atomic<uint32_t> waiters{0};  // orders_shm_wait_slot 等待者数，非 0 时写者发布后唤醒 seq 低 32 位上的 futex
+    // 全链路打点（CLOCK_MONOTONIC，同机跨进程可比）；各跳单写者，不受 seqlock 保护
+    std::atomic<uint64_t> submit_ns{0};                           // API 提交时间，0=未打点
+    std::atomic<uint32_t> hop_delta_ns[kOrderLatencyHopCount]{};  // 各跳相对 submit_ns 的增量，0=未到达
     OrderRequest request{};
 };
 
 static_assert(alignof(OrderSlot) == 64, "OrderSlot must be 64-byte aligned");
 static_assert(sizeof(OrderSlot) % 64 == 0, "OrderSlot must be cache-line aligned");
+static_assert(offsetof(OrderSlot, request) == 64, "OrderSlot latency fields must fit in the first cache line");
 
 // 成交回报共享内存（交易进程→账户服务）
 struct trades_shm_layout {
     SHMHeader header;
-    spsc_queue<TradeResponse, kResponseQueueCapacity> response_queue;
+    spsc_queue<trade_response_message, kResponseQueueCapacity> response_queue;
 
     static constexpr std::size_t total_size() { return sizeof(trades_shm_layout); }
 };
 
+// 上游 lane 注册表：每个策略进程独占一条 SPSC lane，账户服务轮询全部启用 lane
+struct alignas(64) UpstreamLaneTable {
+    std::atomic<uint32_t> lane_count{1};                     // 启用 lane 数（由账户服务写入，1=单生产者模式）
+    std::atomic<uint32_t> flags{0};                          // kUpstreamInlineOrders 等模式位（由账户服务写入）
+    std::atomic<uint32_t> owner_pids[kMaxUpstreamLanes]{};  // lane 持有者 pid，0=空闲
+    // 账户服务从上游 lane 取走订单后按需唤醒，供队列满的策略进程等待额度（占用原尾部填充，布局大小不变）
+    shm_doorbell credit_doorbell;
+};
+
+static_assert(sizeof(UpstreamLaneTable) == 64, "UpstreamLaneTable must be 64 bytes");
+
+// 本方订单回报：账户服务在订单簿变更时写入来源 lane 的回报环，策略进程一次 SPSC 出队即可得知确认/成交，
+// 无需另开订单池监控上下文扫描槽位
+struct alignas(64) order_update_message {
+    InternalOrderId internal_order_id;
+    InternalOrderId orig_internal_order_id;  // 撤单对应的原单
+    OrderIndex index;                        // 订单池槽位
+    OrderState order_state;
+    uint8_t event;  // order_book_event_t
+    OrderType order_type;
+    uint8_t reserved0;
+    Volume volume_traded;
+    Volume volume_remain;
+    DValue dvalue_traded;
+    DPrice dprice_traded;
+    DValue dfee_executed;
+    TimestampNs update_ns;
+};
+
+static_assert(sizeof(order_update_message) == 64, "order_update_message must be 64 bytes");
+
+// 单条 lane 的回报环：账户服务单写、lane 持有者单读；环满时丢弃新回报并计数，策略可据此改用订单池补读
+struct order_update_lane {
+    spsc_queue<order_update_message, kOrderUpdateQueueCapacity> queue;
+    alignas(64) std::atomic<uint64_t> dropped{0};
+};
+
+// 上游 lane 模式位：生产者为可内联的订单额外推送 upstream_order_message，账户服务顺序读消息环而非订单池槽位
+inline constexpr uint32_t kUpstreamInlineOrders = 0x1;
+
+// 订单队列中带此位的下标表示消息环里有对应的内联消息；订单池下标远小于 2^31，换日标记（全 1）须先于此位判断
+inline constexpr OrderIndex kUpstreamInlineIndexFlag = 0x80000000U;
+
+// 内联上游订单消息：携带账户服务入簿所需的全部字段，internal_security_id 由 market + security_id 重建。
+// 订单池槽位照常写入供监控读取，账户服务出队后只回写阶段，不再随机读 256 字节请求
+struct alignas(64) upstream_order_message {
+    static constexpr std::size_t kSecurityIdSize = 12;
+
+    OrderIndex index;
+    InternalOrderId internal_order_id;
+    InternalOrderId orig_internal_order_id;
+    OrderType order_type;
+    TradeSide trade_side;
+    Market market;
+    PassiveExecutionAlgo passive_execution_algo;
+    Volume volume;
+    DPrice dprice;
+    MdTime md_time_driven;
+    char security_id[kSecurityIdSize];
+};
+
+static_assert(sizeof(upstream_order_message) == 64, "upstream_order_message must be 64 bytes");
+
+// 仅普通新单（非篮子）与撤单可内联；其余类型或证券代码放不下时返回 false，生产者只推下标
+inline bool fill_upstream_order_message(
+    const OrderRequest& request, OrderIndex index, upstream_order_message& out) noexcept {
+    const bool plain_new = request.order_type == OrderType::New && request.basket_legs == 0;
+    if (!plain_new && request.order_type != OrderType::Cancel) {
+        return false;
+    }
+    if (request.security_id.size() >= upstream_order_message::kSecurityIdSize) {
+        return false;
+    }
+    out.index = index;
+    out.internal_order_id = request.internal_order_id;
+    out.orig_internal_order_id = request.orig_internal_order_id;
+    out.order_type = request.order_type;
+    out.trade_side = request.trade_side;
+    out.market = request.market;
+    out.passive_execution_algo = request.passive_execution_algo;
+    out.volume = request.volume_entrust;
+    out.dprice = request.dprice_entrust;
+    out.md_time_driven = request.md_time_driven;
+    std::memcpy(out.security_id, request.security_id.data, upstream_order_message::kSecurityIdSize);
+    return true;
+}
+
+// 按内联消息还原请求，与生产者写入槽位的请求在账户服务读取的字段上一致
+inline bool read_upstream_order_message(const upstream_order_message& message, OrderRequest& out) noexcept {
+    if (message.order_type == OrderType::Cancel) {
+        out.init_cancel(message.internal_order_id, message.md_time_driven, message.orig_internal_order_id);
+        out.passive_execution_algo = message.passive_execution_algo;
+        return true;
+    }
+    const std::string_view security_id(
+        message.security_id, ::strnlen(message.security_id, upstream_order_message::kSecurityIdSize));
+    InternalSecurityId internal_security_id;
+    if (!build_internal_security_id(message.market, security_id, internal_security_id)) {
+        return false;
+    }
+    out.init_new(security_id, internal_security_id, message.internal_order_id, message.trade_side, message.market,
+                 message.volume, message.dprice, message.md_time_driven);
+    out.passive_execution_algo = message.passive_execution_algo;
+    return true;
+}
+
 // 上游共享内存（策略→账户服务）
 struct upstream_shm_layout {
+    using lane_queue = spsc_queue<OrderIndex, kUpstreamOrderQueueCapacity>;
+    using cancel_queue = spsc_queue<OrderIndex, kUpstreamCancelQueueCapacity>;
+    using payload_queue = spsc_queue<upstream_order_message, kUpstreamPayloadQueueCapacity>;
+
     SHMHeader header;
-    spsc_queue<OrderIndex, kUpstreamOrderQueueCapacity> upstream_order_queue;
+    lane_queue upstream_order_queue;  // lane 0，兼容单生产者写入方
+    UpstreamLaneTable lane_table;
+    lane_queue extra_lanes[kMaxUpstreamLanes - 1];  // lane 1..kMaxUpstreamLanes-1
+    cancel_queue cancel_lanes[kMaxUpstreamLanes];   // 每条 lane 的单笔撤单优先队列，账户服务先于订单队列排空
+    order_update_lane order_update_lanes[kMaxUpstreamLanes];  // 每条 lane 的本方订单回报环（账户服务→lane 持有者）
+    payload_queue payload_lanes[kMaxUpstreamLanes];  // 每条 lane 的内联订单消息环，与订单队列中带标记的下标一一对应
+
+    // 按 lane 编号取队列，调用方保证 lane_id < kMaxUpstreamLanes
+    lane_queue& lane(uint32_t lane_id) noexcept {
+        return lane_id == 0 ? upstream_order_queue : extra_lanes[lane_id - 1];
+    }
+    const lane_queue& lane(uint32_t lane_id) const noexcept {
+        return lane_id == 0 ? upstream_order_queue : extra_lanes[lane_id - 1];
+    }
+    cancel_queue& cancel_lane(uint32_t lane_id) noexcept { return cancel_lanes[lane_id]; }
+    const cancel_queue& cancel_lane(uint32_t lane_id) const noexcept { return cancel_lanes[lane_id]; }
+    order_update_lane& order_updates(uint32_t lane_id) noexcept { return order_update_lanes[lane_id]; }
+    const order_update_lane& order_updates(uint32_t lane_id) const noexcept { return order_update_lanes[lane_id]; }
+    payload_queue& payload_lane(uint32_t lane_id) noexcept { return payload_lanes[lane_id]; }
+    const payload_queue& payload_lane(uint32_t lane_id) const noexcept { return payload_lanes[lane_id]; }
 
     static constexpr std::size_t total_size() { return sizeof(upstream_shm_layout); }
 };
 
-// 下游共享内存（账户服务→交易进程）
+// 内联下游订单消息：携带网关报单所需的全部字段，网关顺序读取队列即可提交，不再随机访问订单池槽位。
+// index 仍指向订单池槽位，供网关提交后回写阶段/打点；证券代码超出内联宽度时置 kReadSlot，网关回落读槽位。
+struct alignas(64) downstream_order_message {
+    static constexpr uint8_t kReadSlot = 0x01;
+    static constexpr std::size_t kSecurityIdSize = 12;
+
+    OrderIndex index;
+    InternalOrderId internal_order_id;
+    InternalOrderId orig_internal_order_id;
+    OrderType order_type;
+    TradeSide trade_side;
+    Market market;
+    uint8_t flags;
+    Volume volume;
+    DPrice dprice;
+    MdTime md_time;  // 已按 md_time_entrust 优先、缺失回退 md_time_driven 解析
+    InternalSecurityId internal_security_id;
+    char security_id[kSecurityIdSize];
+};
+
+static_assert(sizeof(downstream_order_message) == 64, "downstream_order_message must be 64 bytes");
+
+// 由订单请求填充内联消息；证券代码放不下时只带下标，由网关读槽位
+inline void fill_downstream_order_message(
+    const OrderRequest& request, OrderIndex index, downstream_order_message& out) noexcept {
+    out.index = index;
+    out.internal_order_id = request.internal_order_id;
+    out.orig_internal_order_id = request.orig_internal_order_id;
+    out.order_type = request.order_type;
+    out.trade_side = request.trade_side;
+    out.market = request.market;
+    out.flags = 0;
+    out.volume = request.volume_entrust;
+    out.dprice = request.dprice_entrust;
+    out.md_time = request.md_time_entrust != 0 ? request.md_time_entrust : request.md_time_driven;
+    out.internal_security_id = request.internal_security_id;
+    const std::size_t security_size = request.security_id.size();
+    if (security_size >= downstream_order_message::kSecurityIdSize) {
+        out.flags |= downstream_order_message::kReadSlot;
+        out.security_id[0] = '\0';
+        return;
+    }
+    std::memcpy(out.security_id, request.security_id.data, downstream_order_message::kSecurityIdSize);
+}
+
+// 下游共享内存（账户服务→交易进程）：账户服务按 shm.downstream_inline_orders 二选一写入，网关两路都消费；
+// 原单已在柜台的撤单另走 cancel_queue，网关每轮先于两路订单队列消费
+// broker_capabilities 由网关启动时按全部适配器分片的能力写入，账户服务只读
+inline constexpr uint32_t kBrokerCapReplace = 0x1;         // 柜台支持改单
+inline constexpr uint32_t kBrokerCapDenseBrokerIds = 0x2;  // broker_order_id 为会话内递增数字编号
+
 struct downstream_shm_layout {
     SHMHeader header;
+    alignas(64) std::atomic<uint32_t> broker_capabilities{0};
     spsc_queue<OrderIndex, kDownstreamQueueCapacity> order_queue;
+    spsc_queue<downstream_order_message, kDownstreamPayloadQueueCapacity> order_payload_queue;
+    spsc_queue<downstream_order_message, kDownstreamCancelQueueCapacity> cancel_queue;
 
     static constexpr std::size_t total_size() { return sizeof(downstream_shm_layout); }
 };
 
+// 变更日志条目：position 为写入位置 + 1（0 表示写入中），value 高 32 位为槽位下标、低 32 位为发布后 seq 低位
+struct order_journal_entry {
+    std::atomic<uint64_t> position{0};
+    std::atomic<uint64_t> value{0};
+};
+
+// 订单池变更日志（多写者）：每次槽位发布追加一条，监控按游标只读变更过的槽位，无需全量扫描
+struct alignas(64) order_change_journal {
+    std::atomic<uint64_t> write_cursor{0};  // 已分配的写入位置总数（单调递增，不回绕）
+    uint8_t reserved[56]{};
+    order_journal_entry entries[kOrderJournalCapacity];
+};
+
+static_assert((kOrderJournalCapacity & (kOrderJournalCapacity - 1)) == 0, "journal capacity must be power of 2");
+
 // 订单池共享内存（可被外部监控读取）
+// slots 按 kDailyOrderPoolCapacity 声明上限，实际映射只覆盖 header.capacity 个槽位，段大小见 orders_shm_size()。
+// 网关下游进度字区紧随 header.capacity 个槽位之后，每个段内下标一个 8 字节进度字，由网关单写（见
+// orders_shm_mark_downstream），网关不再写槽位 seqlock、头部 last_update 与变更日志，槽位缓存行只有账户服务一个写者；
+// 读端按下标合并。progress_area 只为满容量布局（如堆上测试布局）占位，段内实际位置见 orders_shm_progress_offset()
 struct orders_shm_layout {
     OrdersHeader header;
+    order_change_journal journal;
     alignas(64) OrderSlot slots[kDailyOrderPoolCapacity];
+    alignas(64) std::atomic<uint64_t> progress_area[kDailyOrderPoolCapacity];
 
     static constexpr std::size_t total_size() { return sizeof(orders_shm_layout); }
 };
 
+// 容量为 capacity 的段内进度字区偏移（槽位区之后，槽位按缓存行定长，无需额外对齐）
+constexpr std::size_t orders_shm_progress_offset(std::size_t capacity) noexcept {
+    return offsetof(orders_shm_layout, slots) + capacity * sizeof(OrderSlot);
+}
+
+// 容量为 capacity 的订单池段大小（头部 + 变更日志 + capacity 个槽位 + capacity 个进度字）
+constexpr std::size_t orders_shm_size(std::size_t capacity) noexcept {
+    return orders_shm_progress_offset(capacity) + capacity * sizeof(std::atomic<uint64_t>);
+}
+
+// 按段大小反推订单池容量；大小不是合法布局时返回 0
+constexpr std::size_t orders_shm_capacity_for_size(std::size_t size) noexcept {
+    if (size <= offsetof(orders_shm_layout, slots) || size > sizeof(orders_shm_layout)) {
+        return 0;
+    }
+    const std::size_t per_slot_bytes = sizeof(OrderSlot) + sizeof(std::atomic<uint64_t>);
+    const std::size_t slot_bytes = size - offsetof(orders_shm_layout, slots);
+    return slot_bytes % per_slot_bytes == 0 ? slot_bytes / per_slot_bytes : 0;
+}
+
+static_assert(orders_shm_progress_offset(kDailyOrderPoolCapacity) == offsetof(orders_shm_layout, progress_area),
+              "orders progress area offset mismatch");
+static_assert(orders_shm_size(kDailyOrderPoolCapacity) == sizeof(orders_shm_layout), "orders shm size mismatch");
+
+// 事件循环统计共享内存（账户服务单写，监控进程只读）；
+// brokers 与 queues 的下游部分由网关主循环单写（进程内网关写宿主统计段）
+struct stats_shm_layout {
+    SHMHeader header;
+    stage_latency_stats stages;
+    risk_stat_counters risk;
+    metrics_table metrics;  // 各组件登记的命名计数器与瞬时值
+    broker_latency_stats brokers;
+    queue_depth_stats queues;  // 各 SHM 队列的采样深度直方图与高水位
+
+    static constexpr std::size_t total_size() { return sizeof(stats_shm_layout); }
+};
+
 // 持仓共享内存（可被外部监控读取）
+inline constexpr std::size_t kPositionChangeGroupRows = 64;
+inline constexpr std::size_t kPositionChangeGroupCount =
+    (kMaxPositions + kPositionChangeGroupRows - 1) / kPositionChangeGroupRows;
+
+// 持仓行变更戳：version 为全局单调版本；row_versions[i] 为第 i 行最近一次变更时的 version；
+// group_versions[g] 为每 64 行的最大戳，充当多读者可共享的脏位图摘要，读者按游标跳过未变更分组。
+struct alignas(64) position_change_index {
+    std::atomic<uint64_t> version{0};
+    uint64_t reserved[7];
+    std::atomic<uint64_t> group_versions[kPositionChangeGroupCount];
+    std::atomic<uint64_t> row_versions[kMaxPositions];
+};
+
 struct positions_shm_layout {
     PositionsHeader header;  // 使用专门的持仓头部
     alignas(64) std::atomic<std::size_t> position_count{0};
+    position_change_index changes;  // 行变更戳（账户线程唯一写者）
+    fund_row fund;                  // 资金块；positions[0] 只保留 FUND 标识，变更仍按第 0 行打戳
     alignas(64) position positions[kMaxPositions];
 
     static constexpr std::size_t total_size() { return sizeof(positions_shm_layout); }
 };
 
+// v7 持仓共享内存：资金复用 positions[0] 证券列，仅供监控 API 兼容读取旧进程
+struct positions_shm_layout_v7 {
+    PositionsHeader header;
+    alignas(64) std::atomic<std::size_t> position_count{0};
+    position_change_index changes;
+    alignas(64) position positions[kMaxPositions];
+
+    static constexpr std::size_t total_size() { return sizeof(positions_shm_layout_v7); }
+};
+
+// v6 持仓共享内存：行布局为 position_v6，其余同 v7
+struct positions_shm_layout_v6 {
+    PositionsHeader header;
+    alignas(64) std::atomic<std::size_t> position_count{0};
+    position_change_index changes;
+    alignas(64) position_v6 positions[kMaxPositions];
+
+    static constexpr std::size_t total_size() { return sizeof(positions_shm_layout_v6); }
+};
+
+static_assert(offsetof(positions_shm_layout_v7, positions) == offsetof(positions_shm_layout_v6, positions),
+              "v6/v7 positions layouts must share the header region");
+
+// 跨账户风控合计共享内存（聚合进程单写，各账户风控只读）：聚合进程映射全部账户的 positions_shm，
+// 按变更戳把脏行增量折算进公司级合计与按证券合计；合计与每个证券行各自由 seqlock 保护，读者一次稳定读即可。
+inline constexpr std::size_t kFirmRiskSecurityCapacity = 16384;  // 必须是 2 的幂，按证券键开放寻址
+inline constexpr std::size_t kMaxFirmRiskAccounts = 64;
+
+static_assert((kFirmRiskSecurityCapacity & (kFirmRiskSecurityCapacity - 1)) == 0,
+              "kFirmRiskSecurityCapacity must be a power of two");
+
+// 公司级合计：金额单位与持仓行一致（分）
+struct alignas(64) firm_risk_totals {
+    std::atomic<uint32_t> seq{0};          // 偶数=稳定，奇数=聚合进程写入中
+    uint32_t account_count{0};             // 已接入的账户数
+    uint64_t traded_buy_value{0};          // 全部账户证券行 dvalue_buy_traded 之和
+    uint64_t traded_sell_value{0};         // 全部账户证券行 dvalue_sell_traded 之和
+    uint64_t frozen_value{0};              // 全部账户 FUND 冻结资金之和（在途买单）
+    uint64_t holding_volume{0};            // 全部账户证券持仓数量之和（含卖出冻结）
+    uint64_t version{0};                   // 每次发布递增
+    TimestampNs publish_ns{0};             // 最近一次发布时间
+    uint64_t reserved{0};
+};
+
+static_assert(sizeof(firm_risk_totals) == 64, "firm_risk_totals must fit one cache line");
+
+// 按证券合计：首次出现该证券的账户行时按键登记，槽位此后不再迁移
+struct alignas(64) firm_security_total {
+    std::atomic<uint32_t> seq{0};
+    uint32_t account_count{0};             // 持仓行非空的账户数
+    uint64_t holding_volume{0};            // 各账户 t0 + t1 可用与卖出冻结之和
+    uint64_t traded_buy_value{0};
+    uint64_t traded_sell_value{0};
+    FixedString<16> id{};                  // 内部证券 ID，空表示槽位未用
+    uint64_t reserved{0};
+};
+
+static_assert(sizeof(firm_security_total) == 64, "firm_security_total must fit one cache line");
+
+struct firm_risk_shm_layout {
+    SHMHeader header;
+    firm_risk_totals totals;
+    alignas(64) std::atomic<uint32_t> security_count{0};
+    alignas(64) firm_security_total securities[kFirmRiskSecurityCapacity];
+
+    static constexpr std::size_t total_size() { return sizeof(firm_risk_shm_layout); }
+};
+
+// 跨进程共享的证券键散列：FNV-1a，与编译选项无关，写端与各读端进程算出相同的值
+inline uint64_t shm_security_key_hash(const FixedString<16>& id) noexcept {
+    uint64_t hash = 1469598103934665603ULL;
+    for (std::size_t i = 0; i < sizeof(id.data) && id.data[i] != '\0'; ++i) {
+        hash = (hash ^ static_cast<unsigned char>(id.data[i])) * 1099511628211ULL;
+    }
+    return hash;
+}
+
+// 证券键的起始探测槽位
+inline std::size_t firm_risk_security_slot(const FixedString<16>& id) noexcept {
+    return static_cast<std::size_t>(shm_security_key_hash(id)) & (kFirmRiskSecurityCapacity - 1);
+}
+
+// 主机级证券主数据共享内存（发布进程每个交易日建一次，各账户服务只读）：证券静态属性与当日涨跌停价，
+// 附带启动期构造的完美哈希索引（hash-and-displace，算法同 security_code_table），证券键到条目下标
+// 固定一次桶读 + 一次槽读。ready 置 1 前读者不得使用；同一交易日内应在账户服务启动前发布完毕。
+inline constexpr std::size_t kSecurityMasterCapacity = 16384;
+inline constexpr std::size_t kSecurityMasterSlotCount = kSecurityMasterCapacity * 2;
+inline constexpr std::size_t kSecurityMasterBucketCount = kSecurityMasterCapacity / 4;
+
+struct alignas(64) security_master_entry {
+    InternalSecurityId internal_security_id{};
+    FixedString<16> name{};
+    DPrice limit_up = 0;     // 0 表示不限
+    DPrice limit_down = 0;   // 0 表示不限
+    uint32_t lot_size = 0;   // 每手数量，0 表示未知
+    uint16_t fee_class = 0;  // 费率档位，由费用模块解释
+    Market market = Market::NotSet;
+    uint8_t reserved = 0;
+};
+
+static_assert(sizeof(security_master_entry) == 64, "security_master_entry must fit one cache line");
+
+struct security_master_slot {
+    uint64_t key_lo = 0;
+    uint64_t key_hi = 0;
+    uint32_t entry_plus_one = 0;  // 0 表示空槽
+    uint32_t reserved = 0;
+};
+
+struct security_master_shm_layout {
+    SHMHeader header;
+    alignas(64) std::atomic<uint32_t> ready{0};  // 1=已发布，发布中为 0
+    uint32_t trading_day = 0;                    // YYYYMMDD
+    uint32_t entry_count = 0;
+    uint32_t slot_count = 0;    // 2 的幂，0 表示索引不可用（读者退回线性查找）
+    uint32_t bucket_count = 0;  // 2 的幂
+    uint32_t reserved = 0;
+    TimestampNs publish_ns = 0;
+    alignas(64) uint32_t displacements[kSecurityMasterBucketCount];
+    alignas(64) security_master_slot slots[kSecurityMasterSlotCount];
+    alignas(64) security_master_entry entries[kSecurityMasterCapacity];
+
+    static constexpr std::size_t total_size() { return sizeof(security_master_shm_layout); }
+};
+
+// 无状态风控参数共享内存（账户服务单写，下单 API 只读）：单笔金额/数量上限与当日涨跌停价格带。
+// 下单 API 在占用订单池槽位前按与 RiskManager 相同的无状态规则预检，明显违规的新单就地返回；服务端照常复检。
+// 参数与价格带整段由一个 seqlock 保护（重发布只在启动、改配置、刷新价格带时发生），seq 为 0 表示尚未发布。
+inline constexpr std::size_t kRiskParamsBandCapacity = 32768;  // 价格带开放寻址槽位数，必须是 2 的幂
+inline constexpr uint32_t kRiskParamsPriceLimit = 0x1;         // 价格带检查启用
+
+static_assert((kRiskParamsBandCapacity & (kRiskParamsBandCapacity - 1)) == 0,
+              "kRiskParamsBandCapacity must be a power of two");
+
+struct risk_params_band {
+    InternalSecurityId id{};  // 归一化证券键，空表示槽位未用
+    DPrice limit_up = 0;      // 0 表示不限
+    DPrice limit_down = 0;    // 0 表示不限
+};
+
+static_assert(sizeof(risk_params_band) == 32, "risk_params_band must be 32 bytes");
+
+struct risk_params_shm_layout {
+    SHMHeader header;
+    alignas(64) std::atomic<uint32_t> seq{0};  // 偶数=稳定，奇数=发布中
+    uint32_t flags = 0;                        // kRiskParams* 位
+    DValue max_order_value = 0;                // 0 表示不限
+    Volume max_order_volume = 0;               // 0 表示不限
+    uint32_t band_count = 0;
+    uint32_t reserved = 0;
+    TimestampNs publish_ns = 0;
+    alignas(64) risk_params_band bands[kRiskParamsBandCapacity];
+
+    static constexpr std::size_t total_size() { return sizeof(risk_params_shm_layout); }
+};
+
+// 运维指令共享内存（运维工具单写指令环、账户服务单写完成环）：事件循环每 admin_poll_iterations 轮取一次指令，
+// 单次最多执行 kAdminCommandsPerPoll 条，结果按指令编号写回完成环，免去为运维操作重启进程。
+// 完成环由运维工具自行排空，环满时结果丢弃并计入 dropped_responses。
+// 两个环都是 SPSC：运维工具先以 pid CAS 认领 writer_pid 才可投递与排空，第二个实例认领失败即退出
+inline constexpr std::size_t kAdminQueueCapacity = 64;
+inline constexpr std::size_t kAdminCommandsPerPoll = 4;
+
+enum class admin_command_type : uint8_t {
+    None = 0,
+    ReloadConfig = 1,    // 请求本账户的配置热更新线程重载配置文件（风控限额等）
+    CancelAll = 2,       // 撤销账户内全部在途新单，拆单子单随父单展开
+    CancelStrategy = 3,  // 撤销 strategy_id 来源的全部在途新单
+    PauseStrategy = 4,   // 拒绝 strategy_id 来源的新单（撤单照常），进程重启后失效
+    ResumeStrategy = 5,  // 恢复 strategy_id 来源的新单
+    DumpState = 6,       // 把循环统计、在途订单与执行会话数写入日志
+    Checkpoint = 7,      // 立即采集一份重启检查点（需开启 checkpoint_interval_ms）
+};
+
+enum class admin_command_status : uint8_t {
+    Done = 0,         // 已在事件循环内执行完毕
+    Accepted = 1,     // 已转交后台线程异步执行（ReloadConfig）
+    Rejected = 2,     // 当前状态下不可执行（影子模式撤单、未开启检查点等）
+    Unsupported = 3,  // 未知指令类型
+};
+
+struct alignas(32) admin_command {
+    uint64_t command_id = 0;  // 运维工具分配，完成环原样带回
+    TimestampNs submit_ns = 0;
+    admin_command_type type = admin_command_type::None;
+    uint8_t reserved0 = 0;
+    StrategyId strategy_id = 0;  // CancelStrategy / PauseStrategy / ResumeStrategy 的目标
+    uint32_t reserved1 = 0;
+    uint64_t reserved2 = 0;
+};
+
+static_assert(sizeof(admin_command) == 32, "admin_command must be 32 bytes");
+
+struct alignas(32) admin_response {
+    uint64_t command_id = 0;
+    TimestampNs done_ns = 0;
+    admin_command_type type = admin_command_type::None;
+    admin_command_status status = admin_command_status::Done;
+    StrategyId strategy_id = 0;
+    uint32_t affected = 0;  // 撤单为成功路由的目标数，其余为 0
+    uint64_t reserved = 0;
+};
+
+static_assert(sizeof(admin_response) == 32, "admin_response must be 32 bytes");
+
+struct admin_shm_layout {
+    SHMHeader header;
+    spsc_queue<admin_command, kAdminQueueCapacity> commands;    // 运维工具 -> 事件循环
+    spsc_queue<admin_response, kAdminQueueCapacity> responses;  // 事件循环 -> 运维工具
+    alignas(64) std::atomic<uint64_t> executed{0};              // 已执行的指令数（含拒绝）
+    std::atomic<uint64_t> dropped_responses{0};                 // 完成环满而丢弃的结果数
+    alignas(64) std::atomic<uint32_t> writer_pid{0};            // 当前运维工具进程，0 表示空闲
+
+    static constexpr std::size_t total_size() { return sizeof(admin_shm_layout); }
+};
+
+// 订单池二级索引共享内存（账户线程单写，监控只读）：订单入簿时按证券、按来源策略头插到槽位链，
+// 并维护在途位图，监控按单个证券/策略/在途订单查询时只走链或位图，不必逐槽扫描。
+// 节点号即全局槽位下标（段号 << 20 | 段内下标），覆盖主段与全部溢出段；各数组只在用到的页上落物理内存。
+// 换日时由账户线程就地重置：generation 先置奇数、清桶与位图、写新交易日后再置偶数，读者据此判定链失效。
+inline constexpr std::size_t kOrdersIndexNodeCount = (kMaxOrdersOverflowSegments + 1) * kDailyOrderPoolCapacity;
+inline constexpr std::size_t kOrdersIndexSecurityBuckets = 16384;  // 必须是 2 的幂，按证券键开放寻址
+inline constexpr std::size_t kOrdersIndexStrategyCount = std::size_t{1} << (sizeof(StrategyId) * 8);
+inline constexpr uint32_t kOrdersIndexNil = 0xFFFFFFFFU;
+
+static_assert((kOrdersIndexSecurityBuckets & (kOrdersIndexSecurityBuckets - 1)) == 0,
+              "kOrdersIndexSecurityBuckets must be a power of two");
+
+// 证券桶：id 在 head 首次发布前写入，此后不变；head 为最近入簿订单的节点号
+struct alignas(32) orders_index_security_bucket {
+    FixedString<16> id{};
+    std::atomic<uint32_t> head{kOrdersIndexNil};
+    std::atomic<uint32_t> count{0};
+    uint64_t reserved{0};
+};
+
+static_assert(sizeof(orders_index_security_bucket) == 32, "orders_index_security_bucket must be 32 bytes");
+
+struct orders_index_strategy_head {
+    std::atomic<uint32_t> head{kOrdersIndexNil};
+    std::atomic<uint32_t> count{0};
+};
+
+struct orders_index_shm_layout {
+    SHMHeader header;
+    alignas(64) std::atomic<uint64_t> generation{0};  // 偶数=稳定，奇数=重置中
+    std::atomic<uint32_t> trading_day{0};             // YYYYMMDD，0 表示未绑定
+    std::atomic<uint32_t> security_count{0};          // 已占用的证券桶数
+    std::atomic<uint64_t> indexed_orders{0};          // 本交易日入链的订单数
+    std::atomic<uint64_t> unplaced_orders{0};         // 证券桶已满未能入证券链的订单数（仍入策略链）
+    alignas(64) orders_index_security_bucket securities[kOrdersIndexSecurityBuckets];
+    alignas(64) orders_index_strategy_head strategies[kOrdersIndexStrategyCount];
+    alignas(64) std::atomic<uint64_t> live_bits[kOrdersIndexNodeCount / 64];     // 1=在途（非终态）
+    alignas(64) std::atomic<uint64_t> indexed_bits[kOrdersIndexNodeCount / 64];  // 1=已入链，重复入簿时跳过
+    alignas(64) std::atomic<uint32_t> next_by_security[kOrdersIndexNodeCount];
+    alignas(64) std::atomic<uint32_t> next_by_strategy[kOrdersIndexNodeCount];
+    alignas(64) std::atomic<StrategyId> node_strategy[kOrdersIndexNodeCount];
+
+    static constexpr std::size_t total_size() { return sizeof(orders_index_shm_layout); }
+};
+
 }  // namespace acct_service
@@ -2,8 +2,12 @@
 
 #include <sys/mman.h>
 
+#include <algorithm>
 #include <cerrno>
 #include <cstring>
+#include <memory>
+#include <mutex>
+#include <utility>
 
 #include "common/error.hpp"
 #include "common/log.hpp"
@@ -48,28 +52,210 @@ void cleanup_new_region(std::string_view name) noexcept {
     (void)shm::ShmGenericWriter::unlink(name);
 }
 
-bool open_existing_region(
-    shm::ShmGenericWriter& writer, std::string_view name, std::size_t size, std::string_view detail) {
+bool open_existing_region(shm::ShmGenericWriter& writer, std::string_view name, std::size_t size,
+                          const shm::ShmMapOptions& options, std::string_view detail) {
     errno = 0;
-    if (!basecore_shm_bridge::open_writer(writer, name, size)) {
+    if (!basecore_shm_bridge::open_writer(writer, name, size, options)) {
         return report_open_failure(name, detail);
     }
     return true;
 }
 
+constexpr std::size_t kMaxOrdersChains = 16;          // 单进程内可同时挂接溢出链的主段映射数
+constexpr uint64_t kOrdersOverflowWatermarkPercent = 80;  // 链尾段用量达到该比例时预建下一段
+
+// 进程内溢出段注册表：主段映射地址 -> 主段名与本进程已打开的溢出段。
+// 条目地址固定，查找只读原子量不加锁；打开、安装与注销持锁，打开本身在锁外进行。
+// 注册表有意不析构，进程退出时不与静态 SHMManager 的析构次序互相依赖
+struct orders_chain_entry {
+    std::atomic<const orders_shm_layout*> primary{nullptr};
+    std::string name;
+    std::atomic<orders_shm_layout*> segments[kMaxOrdersOverflowSegments]{};
+    std::unique_ptr<SHMManager> managers[kMaxOrdersOverflowSegments];
+};
+
+struct orders_chain_registry {
+    std::mutex mutex;
+    orders_chain_entry entries[kMaxOrdersChains];
+};
+
+orders_chain_registry& chain_registry() {
+    static orders_chain_registry* registry = new orders_chain_registry();
+    return *registry;
+}
+
+orders_chain_entry* find_chain(const void* primary) noexcept {
+    if (!primary) {
+        return nullptr;
+    }
+    for (orders_chain_entry& entry : chain_registry().entries) {
+        if (entry.primary.load(std::memory_order_acquire) == primary) {
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+bool register_orders_chain(const orders_shm_layout* primary, std::string_view name) {
+    orders_chain_registry& registry = chain_registry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    for (orders_chain_entry& entry : registry.entries) {
+        if (entry.primary.load(std::memory_order_relaxed) != nullptr) {
+            continue;
+        }
+        entry.name.assign(name);
+        for (auto& segment : entry.segments) {
+            segment.store(nullptr, std::memory_order_relaxed);
+        }
+        entry.primary.store(primary, std::memory_order_release);
+        return true;
+    }
+    ACCT_LOG_WARN("shm_manager", "orders overflow registry full, overflow segments unreachable for " +
+                                     std::string(name));
+    return false;
+}
+
+// 溢出段映射在锁外析构：其 SHMManager::close 不会回到注册表
+void unregister_orders_chain(const void* primary) noexcept {
+    std::unique_ptr<SHMManager> released[kMaxOrdersOverflowSegments];
+    {
+        orders_chain_registry& registry = chain_registry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        orders_chain_entry* entry = find_chain(primary);
+        if (!entry) {
+            return;
+        }
+        entry->primary.store(nullptr, std::memory_order_release);
+        for (std::size_t i = 0; i < kMaxOrdersOverflowSegments; ++i) {
+            entry->segments[i].store(nullptr, std::memory_order_relaxed);
+            released[i] = std::move(entry->managers[i]);
+        }
+        entry->name.clear();
+    }
+}
+
+// 打开（Open，跟随方）或建立（OpenOrCreate，账户服务）第 segment 个溢出段并安装到条目；并发打开时先安装者胜出
+orders_shm_layout* map_overflow_segment(orders_chain_entry& entry, const orders_shm_layout* primary,
+                                        uint32_t segment, shm_mode mode, const shm::ShmMapOptions& options) {
+    orders_chain_registry& registry = chain_registry();
+    std::string name;
+    {
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        if (entry.primary.load(std::memory_order_relaxed) != primary) {
+            return nullptr;
+        }
+        if (orders_shm_layout* mapped = entry.segments[segment - 1].load(std::memory_order_relaxed)) {
+            return mapped;
+        }
+        name = make_orders_overflow_shm_name(entry.name, segment);
+    }
+
+    auto manager = std::make_unique<SHMManager>();
+    manager->set_map_options(options);
+    const std::size_t capacity = mode == shm_mode::Open ? 0 : primary->header.capacity;
+    orders_shm_layout* layout = manager->open_orders(name, mode, 0, capacity);
+    if (!layout) {
+        return nullptr;
+    }
+    if (mode == shm_mode::Open && layout->header.overflow_index != segment) {
+        (void)report_shm_error(ErrorCode::ShmHeaderInvalid, name, "orders overflow segment index mismatch");
+        return nullptr;
+    }
+
+    std::unique_ptr<SHMManager> loser;
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    if (entry.primary.load(std::memory_order_relaxed) != primary) {
+        loser = std::move(manager);
+        return nullptr;
+    }
+    if (orders_shm_layout* mapped = entry.segments[segment - 1].load(std::memory_order_relaxed)) {
+        loser = std::move(manager);
+        return mapped;
+    }
+    entry.managers[segment - 1] = std::move(manager);
+    entry.segments[segment - 1].store(layout, std::memory_order_release);
+    return layout;
+}
+
 }  // namespace
 
+orders_shm_layout* orders_shm_overflow(const orders_shm_layout* shm, uint32_t segment) noexcept {
+    if (!shm || segment == 0 || segment > kMaxOrdersOverflowSegments ||
+        segment > shm->header.overflow_segments.load(std::memory_order_acquire)) {
+        return nullptr;
+    }
+    orders_chain_entry* entry = find_chain(shm);
+    if (!entry) {
+        return nullptr;
+    }
+    if (orders_shm_layout* mapped = entry->segments[segment - 1].load(std::memory_order_acquire)) {
+        return mapped;
+    }
+    return map_overflow_segment(*entry, shm, segment, shm_mode::Open, shm::ShmMapOptions{});
+}
+
+uint32_t extend_orders_overflow(orders_shm_layout* primary, uint32_t max_segments, const shm::ShmMapOptions& options,
+                                upstream_shm_layout* upstream) {
+    if (!primary) {
+        return 0;
+    }
+    const uint32_t limit = std::min<uint32_t>(max_segments, kMaxOrdersOverflowSegments);
+    const uint32_t published = primary->header.overflow_segments.load(std::memory_order_acquire);
+    if (published >= limit) {
+        return 0;
+    }
+    const orders_shm_layout* tail = published == 0 ? primary : orders_shm_overflow(primary, published);
+    if (!tail) {
+        return 0;
+    }
+    const uint64_t used = tail->header.next_index.load(std::memory_order_acquire);
+    if (used * 100 < static_cast<uint64_t>(tail->header.capacity) * kOrdersOverflowWatermarkPercent) {
+        return 0;
+    }
+    orders_chain_entry* entry = find_chain(primary);
+    if (!entry) {
+        return 0;
+    }
+
+    const uint32_t segment = published + 1;
+    orders_shm_layout* layout = map_overflow_segment(*entry, primary, segment, shm_mode::OpenOrCreate, options);
+    if (!layout) {
+        return 0;
+    }
+    // 段号与纪元须在发布前写好：跟随方按发布计数打开并校验段号，按纪元反查订单号
+    layout->header.overflow_index = segment;
+    if (orders_shm_bind_id_epoch(layout, upstream) == 0) {
+        const uint32_t primary_epoch = primary->header.id_epoch.load(std::memory_order_relaxed);
+        const uint32_t base = primary_epoch != 0 ? primary_epoch : 1;
+        layout->header.id_epoch.store((base - 1 + segment) % kMaxOrderIdEpoch + 1, std::memory_order_relaxed);
+    }
+    primary->header.overflow_segments.store(segment, std::memory_order_release);
+    ACCT_LOG_INFO("shm_manager", "chained orders overflow segment " + std::to_string(segment) + " to " + entry->name);
+    return segment;
+}
+
 // 构造函数
 SHMManager::SHMManager() = default;
 
-// 析构函数
-SHMManager::~SHMManager() noexcept = default;
+// 析构函数：主段映射须先从溢出段注册表注销
+SHMManager::~SHMManager() noexcept { close(); }
 
 // 移动构造函数
 SHMManager::SHMManager(SHMManager&& other) noexcept = default;
 
-// 移动赋值运算符
-SHMManager& SHMManager::operator=(SHMManager&& other) noexcept = default;
+// 移动赋值运算符：注册表按映射地址登记，搬移不改变地址，只需先关闭自身原有映射
+SHMManager& SHMManager::operator=(SHMManager&& other) noexcept {
+    if (this != &other) {
+        close();
+        writer_ = std::move(other.writer_);
+        map_options_ = other.map_options_;
+        last_open_is_new_ = std::exchange(other.last_open_is_new_, false);
+        orders_chain_ = std::exchange(other.orders_chain_, false);
+        orders_window_bytes_ = other.orders_window_bytes_;
+        orders_windows_ = std::move(other.orders_windows_);
+    }
+    return *this;
+}
 
 // 内部实现：打开或创建共享内存
 void* SHMManager::open_impl(std::string_view name, std::size_t size, shm_mode mode) {
@@ -93,7 +279,7 @@ void* SHMManager::open_impl(std::string_view name, std::size_t size, shm_mode mo
                 (void)report_create_failure(name, "create shm failed");
                 return nullptr;
             }
-            if (!open_existing_region(writer_, name, size, "open created shm failed")) {
+            if (!open_existing_region(writer_, name, size, map_options_, "open created shm failed")) {
                 cleanup_new_region(name);
                 return nullptr;
             }
@@ -101,7 +287,7 @@ void* SHMManager::open_impl(std::string_view name, std::size_t size, shm_mode mo
             break;
         }
         case shm_mode::Open:
-            if (!open_existing_region(writer_, name, size, "open existing shm failed")) {
+            if (!open_existing_region(writer_, name, size, map_options_, "open existing shm failed")) {
                 return nullptr;
             }
             is_new = false;
@@ -109,7 +295,7 @@ void* SHMManager::open_impl(std::string_view name, std::size_t size, shm_mode mo
         case shm_mode::OpenOrCreate: {
             errno = 0;
             if (basecore_shm_bridge::create_region(name, size)) {
-                if (!open_existing_region(writer_, name, size, "open newly created shm failed")) {
+                if (!open_existing_region(writer_, name, size, map_options_, "open newly created shm failed")) {
                     cleanup_new_region(name);
                     return nullptr;
                 }
@@ -119,7 +305,7 @@ void* SHMManager::open_impl(std::string_view name, std::size_t size, shm_mode mo
 
             const int create_err = errno;
             errno = 0;
-            if (!basecore_shm_bridge::open_writer(writer_, name, size)) {
+            if (!basecore_shm_bridge::open_writer(writer_, name, size, map_options_)) {
                 if (create_err != EEXIST && create_err != 0) {
                     (void)report_shm_error(
                         ErrorCode::ShmOpenFailed, name, "create shm for open_or_create failed", create_err);
@@ -144,7 +330,7 @@ void SHMManager::init_header(SHMHeader *header, AccountId account_id) {
     header->version = SHMHeader::kVersion;
     header->create_time = now_ns();
     header->last_update = now_ns();
-    header->next_order_id.store(1, std::memory_order_relaxed);
+    header->next_id_epoch.store(1, std::memory_order_relaxed);
 }
 
 // 验证共享内存头部
@@ -227,75 +413,131 @@ trades_shm_layout *SHMManager::open_trades(std::string_view name, shm_mode mode,
 }
 
 // 创建/打开订单池共享内存
-orders_shm_layout* SHMManager::open_orders(std::string_view name, shm_mode mode, AccountId account_id) {
+orders_shm_layout* SHMManager::open_orders(std::string_view name, shm_mode mode, AccountId account_id,
+                                           std::size_t capacity) {
     (void)account_id;
-    constexpr std::size_t size = sizeof(orders_shm_layout);
-    void* ptr = open_impl(name, size, mode);
-    if (!ptr) {
+    if (capacity > kDailyOrderPoolCapacity) {
+        (void)report_shm_error(ErrorCode::InvalidParam, name, "orders shm capacity exceeds kDailyOrderPoolCapacity");
         return nullptr;
     }
-
-    auto* layout = static_cast<orders_shm_layout*>(ptr);
-
+    // 已存在段按实际大小判断容量：调用方未指定时沿用，指定了但不一致时按头部不兼容处理，便于上层重建
+    std::size_t existing_size = 0;
+    if (mode != shm_mode::Create && basecore_shm_bridge::segment_size(name, existing_size)) {
+        const std::size_t existing_capacity = orders_shm_capacity_for_size(existing_size);
+        if (existing_capacity == 0 || (capacity != 0 && existing_capacity != capacity)) {
+            (void)report_shm_error(ErrorCode::ShmHeaderInvalid, name, "orders shm capacity mismatch");
+            return nullptr;
+        }
+        capacity = existing_capacity;
+    }
+    if (capacity == 0) {
+        capacity = kDailyOrderPoolCapacity;
+    }
+    const std::size_t size = orders_shm_size(capacity);
     char expected_trading_day[9] = "00000000";
     if (!extract_trading_day_from_name(name, expected_trading_day)) {
         std::memcpy(expected_trading_day, "00000000", 9);
     }
 
+    // 接入方打开已存在的主段：只映射头部与变更日志，槽位按窗口首次访问时映射
+    if (orders_window_bytes_ > 0 && existing_size == size && !is_orders_overflow_shm_name(name) &&
+        !basecore_shm_bridge::is_file_backend_requested()) {
+        if (is_open()) {
+            close();
+        }
+        auto windows = std::make_unique<orders_window_map>();
+        errno = 0;
+        orders_shm_layout* layout =
+            windows->open(name, size, orders_window_bytes_, true, map_options_.huge_pages);
+        if (!layout) {
+            (void)report_open_failure(name, "open orders shm windows failed");
+            return nullptr;
+        }
+        orders_windows_ = std::move(windows);
+        if (!validate_orders_header(layout, name, size, capacity, expected_trading_day)) {
+            return nullptr;
+        }
+        orders_chain_ = register_orders_chain(layout, name);
+        return layout;
+    }
+
+    void* ptr = open_impl(name, size, mode);
+    if (!ptr) {
+        return nullptr;
+    }
+
+    auto* layout = static_cast<orders_shm_layout*>(ptr);
+
     if (last_open_is_new_) {
         layout->header.magic = OrdersHeader::kMagic;
         layout->header.version = OrdersHeader::kVersion;
         layout->header.header_size = static_cast<uint32_t>(sizeof(OrdersHeader));
-        layout->header.total_size = static_cast<uint32_t>(sizeof(orders_shm_layout));
-        layout->header.capacity = static_cast<uint32_t>(kDailyOrderPoolCapacity);
+        layout->header.total_size = static_cast<uint32_t>(size);
+        layout->header.capacity = static_cast<uint32_t>(capacity);
         layout->header.init_state = 0;
         layout->header.create_time = now_ns();
         layout->header.last_update = layout->header.create_time;
         layout->header.next_index.store(0, std::memory_order_relaxed);
         layout->header.full_reject_count.store(0, std::memory_order_relaxed);
+        layout->header.id_epoch.store(0, std::memory_order_relaxed);
+        layout->header.predecessor_day.store(0, std::memory_order_relaxed);
+        layout->header.successor_day.store(0, std::memory_order_relaxed);
+        layout->header.overflow_segments.store(0, std::memory_order_relaxed);
+        layout->header.overflow_index = 0;
         std::memcpy(layout->header.trading_day, expected_trading_day, 9);
         layout->header.init_state = 1;
-    } else {
-        if (layout->header.magic != OrdersHeader::kMagic) {
-            (void)report_shm_error(ErrorCode::ShmHeaderInvalid, name, "invalid orders shm magic");
-            close();
-            return nullptr;
-        }
-        if (layout->header.version != OrdersHeader::kVersion) {
-            (void)report_shm_error(ErrorCode::ShmHeaderInvalid, name, "invalid orders shm version");
-            close();
-            return nullptr;
-        }
-        if (layout->header.header_size != static_cast<uint32_t>(sizeof(OrdersHeader))) {
-            (void)report_shm_error(ErrorCode::ShmHeaderInvalid, name, "invalid orders shm header size");
-            close();
-            return nullptr;
-        }
-        if (layout->header.total_size != static_cast<uint32_t>(sizeof(orders_shm_layout))) {
-            (void)report_shm_error(ErrorCode::ShmHeaderInvalid, name, "invalid orders shm total size");
-            close();
-            return nullptr;
-        }
-        if (layout->header.capacity != static_cast<uint32_t>(kDailyOrderPoolCapacity)) {
-            (void)report_shm_error(ErrorCode::ShmHeaderInvalid, name, "invalid orders shm capacity");
-            close();
-            return nullptr;
-        }
-        if (layout->header.init_state != 1) {
-            (void)report_shm_error(ErrorCode::ShmHeaderInvalid, name, "orders shm not initialized");
-            close();
-            return nullptr;
-        }
-        if (std::memcmp(layout->header.trading_day, expected_trading_day, 8) != 0) {
-            (void)report_shm_error(ErrorCode::ShmHeaderInvalid, name, "orders shm trading day mismatch");
-            close();
-            return nullptr;
-        }
+    } else if (!validate_orders_header(layout, name, size, capacity, expected_trading_day)) {
+        return nullptr;
     }
 
+    // 主段登记到进程内溢出段注册表，槽位访问据此解析溢出段下标
+    if (!is_orders_overflow_shm_name(name)) {
+        orders_chain_ = register_orders_chain(layout, name);
+    }
     return layout;
 }
 
+// 校验已存在订单池段的头部（整段映射与窗口化映射共用），失败时关闭映射
+bool SHMManager::validate_orders_header(const orders_shm_layout* layout, std::string_view name, std::size_t size,
+                                        std::size_t capacity, const char* expected_trading_day) {
+    if (layout->header.magic != OrdersHeader::kMagic) {
+        (void)report_shm_error(ErrorCode::ShmHeaderInvalid, name, "invalid orders shm magic");
+        close();
+        return false;
+    }
+    if (layout->header.version != OrdersHeader::kVersion) {
+        (void)report_shm_error(ErrorCode::ShmHeaderInvalid, name, "invalid orders shm version");
+        close();
+        return false;
+    }
+    if (layout->header.header_size != static_cast<uint32_t>(sizeof(OrdersHeader))) {
+        (void)report_shm_error(ErrorCode::ShmHeaderInvalid, name, "invalid orders shm header size");
+        close();
+        return false;
+    }
+    if (layout->header.total_size != static_cast<uint32_t>(size)) {
+        (void)report_shm_error(ErrorCode::ShmHeaderInvalid, name, "invalid orders shm total size");
+        close();
+        return false;
+    }
+    if (layout->header.capacity != static_cast<uint32_t>(capacity)) {
+        (void)report_shm_error(ErrorCode::ShmHeaderInvalid, name, "invalid orders shm capacity");
+        close();
+        return false;
+    }
+    if (layout->header.init_state != 1) {
+        (void)report_shm_error(ErrorCode::ShmHeaderInvalid, name, "orders shm not initialized");
+        close();
+        return false;
+    }
+    if (std::memcmp(layout->header.trading_day, expected_trading_day, 8) != 0) {
+        (void)report_shm_error(ErrorCode::ShmHeaderInvalid, name, "orders shm trading day mismatch");
+        close();
+        return false;
+    }
+    return true;
+}
+
 // 创建/打开持仓共享内存
 positions_shm_layout *SHMManager::open_positions(std::string_view name, shm_mode mode, AccountId account_id) {
     (void)account_id;
@@ -353,12 +595,157 @@ positions_shm_layout *SHMManager::open_positions(std::string_view name, shm_mode
     return layout;
 }
 
+// 创建/打开事件循环统计共享内存
+stats_shm_layout *SHMManager::open_stats(std::string_view name, shm_mode mode, AccountId account_id) {
+    constexpr std::size_t size = sizeof(stats_shm_layout);
+    void *ptr = open_impl(name, size, mode);
+    if (!ptr) {
+        return nullptr;
+    }
+
+    auto *layout = static_cast<stats_shm_layout *>(ptr);
+
+    if (last_open_is_new_) {
+        init_header(&layout->header, account_id);
+    } else {
+        if (!validate_header(&layout->header)) {
+            close();
+            return nullptr;
+        }
+    }
+
+    return layout;
+}
+
+firm_risk_shm_layout *SHMManager::open_firm_risk(std::string_view name, shm_mode mode, AccountId account_id) {
+    constexpr std::size_t size = sizeof(firm_risk_shm_layout);
+    void *ptr = open_impl(name, size, mode);
+    if (!ptr) {
+        return nullptr;
+    }
+
+    auto *layout = static_cast<firm_risk_shm_layout *>(ptr);
+
+    if (last_open_is_new_) {
+        init_header(&layout->header, account_id);
+    } else {
+        if (!validate_header(&layout->header)) {
+            close();
+            return nullptr;
+        }
+    }
+
+    return layout;
+}
+
+security_master_shm_layout *SHMManager::open_security_master(std::string_view name, shm_mode mode) {
+    constexpr std::size_t size = sizeof(security_master_shm_layout);
+    void *ptr = open_impl(name, size, mode);
+    if (!ptr) {
+        return nullptr;
+    }
+
+    auto *layout = static_cast<security_master_shm_layout *>(ptr);
+
+    if (last_open_is_new_) {
+        init_header(&layout->header, 0);
+    } else {
+        if (!validate_header(&layout->header)) {
+            close();
+            return nullptr;
+        }
+    }
+
+    return layout;
+}
+
+orders_index_shm_layout *SHMManager::open_orders_index(std::string_view name, shm_mode mode, AccountId account_id) {
+    constexpr std::size_t size = sizeof(orders_index_shm_layout);
+    void *ptr = open_impl(name, size, mode);
+    if (!ptr) {
+        return nullptr;
+    }
+
+    auto *layout = static_cast<orders_index_shm_layout *>(ptr);
+
+    if (last_open_is_new_) {
+        init_header(&layout->header, account_id);
+    } else {
+        if (!validate_header(&layout->header)) {
+            close();
+            return nullptr;
+        }
+    }
+
+    return layout;
+}
+
+risk_params_shm_layout *SHMManager::open_risk_params(std::string_view name, shm_mode mode, AccountId account_id) {
+    constexpr std::size_t size = sizeof(risk_params_shm_layout);
+    void *ptr = open_impl(name, size, mode);
+    if (!ptr) {
+        return nullptr;
+    }
+
+    auto *layout = static_cast<risk_params_shm_layout *>(ptr);
+
+    if (last_open_is_new_) {
+        init_header(&layout->header, account_id);
+    } else {
+        if (!validate_header(&layout->header)) {
+            close();
+            return nullptr;
+        }
+    }
+
+    return layout;
+}
+
+admin_shm_layout *SHMManager::open_admin(std::string_view name, shm_mode mode, AccountId account_id) {
+    constexpr std::size_t size = sizeof(admin_shm_layout);
+    void *ptr = open_impl(name, size, mode);
+    if (!ptr) {
+        return nullptr;
+    }
+
+    auto *layout = static_cast<admin_shm_layout *>(ptr);
+
+    if (last_open_is_new_) {
+        init_header(&layout->header, account_id);
+    } else {
+        if (!validate_header(&layout->header)) {
+            close();
+            return nullptr;
+        }
+    }
+
+    return layout;
+}
+
 // 关闭并解除映射
 void SHMManager::close() noexcept {
+    if (orders_chain_) {
+        unregister_orders_chain(orders_windows_ ? static_cast<const void*>(orders_windows_->layout()) : writer_.data());
+        orders_chain_ = false;
+    }
     writer_.close();
+    orders_windows_.reset();
     last_open_is_new_ = false;
 }
 
+// 订单池等大映射随机访问槽位，大页可显著减少 TLB miss；tmpfs 需开启 shmem_enabled=advise 才生效
+bool SHMManager::advise_huge_pages() noexcept {
+#if defined(MADV_HUGEPAGE)
+    // 窗口化映射在各窗口映射时按 map_options_.huge_pages 自行建议
+    if (!writer_.is_open()) {
+        return false;
+    }
+    return ::madvise(writer_.data(), writer_.size(), MADV_HUGEPAGE) == 0;
+#else
+    return false;
+#endif
+}
+
 // 删除共享内存对象
 bool SHMManager::unlink(std::string_view name) {
     if (basecore_shm_bridge::is_file_backend_requested()) {
@@ -375,9 +762,11 @@ bool SHMManager::unlink(std::string_view name) {
 }
 
 // 检查是否已打开
-bool SHMManager::is_open() const noexcept { return writer_.is_open(); }
+bool SHMManager::is_open() const noexcept { return writer_.is_open() || orders_windows_ != nullptr; }
 
 // 获取共享内存名称
-const std::string& SHMManager::name() const noexcept { return writer_.name(); }
+const std::string& SHMManager::name() const noexcept {
+    return orders_windows_ ? orders_windows_->name() : writer_.name();
+}
 
 }  // namespace acct_service
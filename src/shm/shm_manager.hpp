@@ -1,10 +1,12 @@
 #pragma once
 
+#include <memory>
 #include <string>
 #include <string_view>
 
 #include "common/types.hpp"
 #include "shm/shm_generic.hpp"
+#include "shm/orders_window_map.hpp"
 #include "shm/shm_layout.hpp"
 
 namespace acct_service {
@@ -39,15 +41,48 @@ public:
     // 创建/打开成交回报共享内存
     trades_shm_layout* open_trades(std::string_view name, shm_mode mode, AccountId account_id);
 
-    // 创建/打开订单池共享内存
-    orders_shm_layout* open_orders(std::string_view name, shm_mode mode, AccountId account_id);
+    // 创建/打开订单池共享内存；capacity 为槽位数（不超过 kDailyOrderPoolCapacity），段只映射这么多槽位。
+    // capacity=0 表示沿用已存在段的容量（段不存在时按 kDailyOrderPoolCapacity 创建），供策略侧接入方使用
+    orders_shm_layout* open_orders(std::string_view name, shm_mode mode, AccountId account_id,
+                                   std::size_t capacity = kDailyOrderPoolCapacity);
 
     // 创建/打开持仓共享内存
     positions_shm_layout* open_positions(std::string_view name, shm_mode mode, AccountId account_id);
 
-    // 关闭并解除映射
+    // 创建/打开事件循环统计共享内存
+    stats_shm_layout* open_stats(std::string_view name, shm_mode mode, AccountId account_id);
+
+    // 创建/打开跨账户风控合计共享内存（聚合进程创建，各账户只读）
+    firm_risk_shm_layout* open_firm_risk(std::string_view name, shm_mode mode, AccountId account_id);
+
+    // 创建/打开主机级证券主数据共享内存（发布进程创建，各账户只读）
+    security_master_shm_layout* open_security_master(std::string_view name, shm_mode mode);
+
+    // 创建/打开订单池二级索引共享内存（账户线程单写，监控只读）；新建段的链头尚未置空，须先 orders_index_reset
+    orders_index_shm_layout* open_orders_index(std::string_view name, shm_mode mode, AccountId account_id);
+
+    // 创建/打开无状态风控参数共享内存（账户服务单写，下单 API 只读）
+    risk_params_shm_layout* open_risk_params(std::string_view name, shm_mode mode, AccountId account_id);
+
+    // 创建/打开运维指令共享内存（运维工具写指令环，账户服务写完成环）
+    admin_shm_layout* open_admin(std::string_view name, shm_mode mode, AccountId account_id);
+
+    // 关闭并解除映射；订单池主段同时注销并解除本进程打开的溢出段
     void close() noexcept;
 
+    // 设置后续 open_* 的映射选项（大页 / 预取 / NUMA 绑定），对已打开的映射不生效
+    void set_map_options(const shm::ShmMapOptions& options) noexcept { map_options_ = options; }
+
+    // 设置后续 open_orders 打开已存在主段时的窗口大小：>0 时经 orders_window_map 只映射头部，
+    // 槽位按窗口首次访问时映射（接入方使用）；0（默认）整段映射。新建段与溢出段始终整段映射
+    void set_orders_window_bytes(std::size_t window_bytes) noexcept { orders_window_bytes_ = window_bytes; }
+
+    // 当前订单池映射为窗口化映射时返回它，否则返回 nullptr
+    const orders_window_map* orders_windows() const noexcept { return orders_windows_.get(); }
+
+    // 建议内核以透明大页承载当前映射（尽力而为，不支持时返回 false，映射照常可用）
+    bool advise_huge_pages() noexcept;
+
     // 删除共享内存对象
     static bool unlink(std::string_view name);
 
@@ -57,6 +92,9 @@ public:
     // 获取共享内存名称
     const std::string& name() const noexcept;
 
+    // 当前整段映射的字节数；未打开或订单池为窗口化映射时返回 0
+    std::size_t mapped_bytes() const noexcept { return writer_.size(); }
+
 private:
     // 内部实现：打开或创建共享内存
     void* open_impl(std::string_view name, std::size_t size, shm_mode mode);
@@ -67,10 +105,24 @@ private:
     // 验证共享内存头部
     bool validate_header(const SHMHeader* header);
 
+    // 校验已存在订单池段的头部；失败时已上报错误
+    bool validate_orders_header(const orders_shm_layout* layout, std::string_view name, std::size_t size,
+                                std::size_t capacity, const char* expected_trading_day);
+
     shm::ShmGenericWriter writer_;
+    shm::ShmMapOptions map_options_;
     bool last_open_is_new_ = false;
+    bool orders_chain_ = false;  // 当前映射是已登记到溢出段注册表的订单池主段
+    std::size_t orders_window_bytes_ = 0;
+    std::unique_ptr<orders_window_map> orders_windows_;  // 窗口化打开的订单池主段（此时 writer_ 未打开）
 };
 
+// 订单池溢出段扩展（账户服务后台线程）：链尾段用量达到 80% 且已发布段数小于 max_segments 时，
+// 按主段容量建下一溢出段（OpenOrCreate，按 options 预取），绑定独立纪元后发布到主段头部。
+// primary 须经 SHMManager::open_orders 打开；返回新发布的段号，无需扩展或失败时返回 0
+uint32_t extend_orders_overflow(orders_shm_layout* primary, uint32_t max_segments, const shm::ShmMapOptions& options,
+                                upstream_shm_layout* upstream);
+
 // 便捷函数：生成共享内存名称
 inline std::string make_shm_name(std::string_view prefix, AccountId account_id) {
     return std::string("/") + std::string(prefix) + "_" + std::to_string(account_id);
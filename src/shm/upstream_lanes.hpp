@@ -0,0 +1,122 @@
+#pragma once
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+
+#include <signal.h>
+
+#include "common/constants.hpp"
+#include "shm/shm_layout.hpp"
+
+namespace acct_service {
+
+// 读取启用 lane 数，越界值收敛到 [1, kMaxUpstreamLanes]
+inline uint32_t upstream_lane_count(const upstream_shm_layout* layout) noexcept {
+    if (!layout) {
+        return 0;
+    }
+    const uint32_t count = layout->lane_table.lane_count.load(std::memory_order_acquire);
+    if (count == 0) {
+        return 1;
+    }
+    return count > kMaxUpstreamLanes ? static_cast<uint32_t>(kMaxUpstreamLanes) : count;
+}
+
+// 由账户服务写入启用 lane 数（应在策略进程接入前完成）
+inline void upstream_set_lane_count(upstream_shm_layout* layout, uint32_t count) noexcept {
+    if (!layout) {
+        return;
+    }
+    if (count == 0) {
+        count = 1;
+    }
+    if (count > kMaxUpstreamLanes) {
+        count = static_cast<uint32_t>(kMaxUpstreamLanes);
+    }
+    layout->lane_table.lane_count.store(count, std::memory_order_release);
+}
+
+// 由账户服务写入内联订单模式（应在策略进程接入前完成）
+inline void upstream_set_inline_orders(upstream_shm_layout* layout, bool enabled) noexcept {
+    if (!layout) {
+        return;
+    }
+    layout->lane_table.flags.store(enabled ? kUpstreamInlineOrders : 0U, std::memory_order_release);
+}
+
+inline bool upstream_inline_orders(const upstream_shm_layout* layout) noexcept {
+    return layout && (layout->lane_table.flags.load(std::memory_order_acquire) & kUpstreamInlineOrders) != 0;
+}
+
+// 判断 lane 持有者进程是否已退出（仅 ESRCH 视为退出）
+inline bool upstream_lane_owner_dead(uint32_t pid) noexcept {
+    if (pid == 0) {
+        return true;
+    }
+    return ::kill(static_cast<pid_t>(pid), 0) != 0 && errno == ESRCH;
+}
+
+// 为生产者进程认领一条空闲 lane；持有者已退出的 lane 可被回收。
+// reuse_owned=false 时跳过本进程已持有的 lane，供同一进程内的多个线程上下文各占一条
+inline bool upstream_claim_lane(upstream_shm_layout* layout, uint32_t pid, uint32_t& out_lane,
+                                bool reuse_owned = true) noexcept {
+    if (!layout || pid == 0) {
+        return false;
+    }
+
+    const uint32_t count = upstream_lane_count(layout);
+    for (uint32_t lane = 0; lane < count; ++lane) {
+        std::atomic<uint32_t>& owner = layout->lane_table.owner_pids[lane];
+        uint32_t current = owner.load(std::memory_order_acquire);
+        if (current == pid && !reuse_owned) {
+            continue;
+        }
+        if (current == pid) {
+            out_lane = lane;
+            return true;
+        }
+        if (current != 0 && !upstream_lane_owner_dead(current)) {
+            continue;
+        }
+        if (owner.compare_exchange_strong(current, pid, std::memory_order_acq_rel, std::memory_order_acquire)) {
+            out_lane = lane;
+            return true;
+        }
+    }
+    return false;
+}
+
+// 释放 lane；仅当前持有者可释放
+inline void upstream_release_lane(upstream_shm_layout* layout, uint32_t lane, uint32_t pid) noexcept {
+    if (!layout || lane >= kMaxUpstreamLanes) {
+        return;
+    }
+    uint32_t expected = pid;
+    (void)layout->lane_table.owner_pids[lane].compare_exchange_strong(expected, 0, std::memory_order_acq_rel,
+                                                                      std::memory_order_relaxed);
+}
+
+// 账户服务向 lane 的回报环写入一条本方订单回报；环满（持有者未及时读取或该 lane 无人读取）时丢弃并计数。
+// 单写者，计数不需要原子读改写
+inline bool upstream_publish_order_update(upstream_shm_layout* layout, uint32_t lane,
+                                          const order_update_message& message) noexcept {
+    order_update_lane& updates = layout->order_updates(lane);
+    if (updates.queue.try_push(message)) {
+        return true;
+    }
+    updates.dropped.store(updates.dropped.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    return false;
+}
+
+// 汇总全部启用 lane 的待处理订单数（含撤单优先队列）
+inline std::size_t upstream_pending_size(const upstream_shm_layout* layout) noexcept {
+    const uint32_t count = upstream_lane_count(layout);
+    std::size_t total = 0;
+    for (uint32_t lane = 0; lane < count; ++lane) {
+        total += layout->lane(lane).size() + layout->cancel_lane(lane).size();
+    }
+    return total;
+}
+
+}  // namespace acct_service
@@ -1,7 +1,10 @@
 #include "strategy/active_strategy.hpp"
 
+#include <dlfcn.h>
+
 #include <cmath>
 #include <memory>
+#include <sstream>
 #include <string_view>
 
 namespace acct_service {
@@ -42,10 +45,108 @@ private:
     double signal_threshold_ = 0.0;
 };
 
+// 插件策略包装：持有动态库句柄与插件内实例，析构时先经插件销毁实例再卸载动态库。
+class PluginActiveStrategy final : public ActiveStrategy {
+public:
+    PluginActiveStrategy(void* handle, ActiveStrategy* strategy, strategy_plugin_destroy_fn_t destroy_fn) noexcept
+        : handle_(handle), strategy_(strategy), destroy_fn_(destroy_fn) {}
+
+    ~PluginActiveStrategy() override {
+        destroy_fn_(strategy_);
+        dlclose(handle_);
+    }
+
+    const char* name() const noexcept override { return strategy_->name(); }
+
+    ActiveDecision evaluate(const ActiveStrategyContext& context) override { return strategy_->evaluate(context); }
+
+    void evaluate_many(std::span<const ActiveStrategyContext> contexts,
+                       std::span<ActiveDecision> out_decisions) override {
+        strategy_->evaluate_many(contexts, out_decisions);
+    }
+
+private:
+    void* handle_ = nullptr;
+    ActiveStrategy* strategy_ = nullptr;
+    strategy_plugin_destroy_fn_t destroy_fn_ = nullptr;
+};
+
+std::string dlerror_message(const char* prefix) {
+    std::ostringstream os;
+    os << prefix;
+    const char* err = dlerror();
+    if (err && *err != '\0') {
+        os << ": " << err;
+    }
+    return os.str();
+}
+
+template <typename Fn>
+Fn lookup_symbol(void* handle, const char* symbol_name, std::string& error_message) {
+    dlerror();
+    void* symbol = dlsym(handle, symbol_name);
+    if (!symbol) {
+        error_message = dlerror_message("dlsym failed");
+        return nullptr;
+    }
+    return reinterpret_cast<Fn>(symbol);
+}
+
+// 与 gateway 券商插件同一套加载流程：dlopen、查全部导出符号、校验 ABI，再创建实例。
+std::unique_ptr<ActiveStrategy> load_strategy_plugin(const ActiveStrategyConfig& config, std::string& error_message) {
+    void* handle = dlopen(config.plugin_path.c_str(), RTLD_NOW | RTLD_LOCAL);
+    if (!handle) {
+        error_message = dlerror_message("dlopen failed");
+        return nullptr;
+    }
+
+    const auto abi_fn = lookup_symbol<strategy_plugin_abi_fn_t>(handle, kStrategyPluginAbiSymbol, error_message);
+    const auto create_fn =
+        abi_fn ? lookup_symbol<strategy_plugin_create_fn_t>(handle, kStrategyPluginCreateSymbol, error_message)
+               : nullptr;
+    const auto destroy_fn =
+        create_fn ? lookup_symbol<strategy_plugin_destroy_fn_t>(handle, kStrategyPluginDestroySymbol, error_message)
+                  : nullptr;
+    if (!destroy_fn) {
+        dlclose(handle);
+        return nullptr;
+    }
+
+    const uint32_t plugin_abi = abi_fn();
+    if (plugin_abi != kActiveStrategyAbiVersion) {
+        std::ostringstream os;
+        os << "strategy plugin abi mismatch: expected=" << kActiveStrategyAbiVersion << " got=" << plugin_abi;
+        error_message = os.str();
+        dlclose(handle);
+        return nullptr;
+    }
+
+    ActiveStrategy* strategy = create_fn(&config);
+    if (!strategy) {
+        error_message = "strategy plugin create returned null strategy";
+        dlclose(handle);
+        return nullptr;
+    }
+    if (config.name != strategy->name()) {
+        error_message = "strategy plugin name mismatch: configured=" + config.name + " plugin=" + strategy->name();
+        destroy_fn(strategy);
+        dlclose(handle);
+        return nullptr;
+    }
+    return std::make_unique<PluginActiveStrategy>(handle, strategy, destroy_fn);
+}
+
 }  // namespace
 
-// 根据服务级配置创建主动策略；unknown 名称显式返回空，避免静默选错实现。
 std::unique_ptr<ActiveStrategy> StrategyRegistry::create(const ActiveStrategyConfig& config) {
+    std::string error_message;
+    return create(config, error_message);
+}
+
+// 根据服务级配置创建主动策略；unknown 名称显式返回空，避免静默选错实现。
+std::unique_ptr<ActiveStrategy> StrategyRegistry::create(const ActiveStrategyConfig& config,
+                                                         std::string& error_message) {
+    error_message.clear();
     if (!config.enabled) {
         return nullptr;
     }
@@ -54,9 +155,13 @@ std::unique_ptr<ActiveStrategy> StrategyRegistry::create(const ActiveStrategyCon
     if (name.empty() || name == "none") {
         return nullptr;
     }
+    if (!config.plugin_path.empty()) {
+        return load_strategy_plugin(config, error_message);
+    }
     if (name == "prediction_signal") {
         return std::make_unique<PredictionSignalStrategy>(std::fabs(config.signal_threshold));
     }
+    error_message = "unknown active strategy name";
     return nullptr;
 }
 
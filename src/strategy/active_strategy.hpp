@@ -1,10 +1,16 @@
 #pragma once
 
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
 #include <memory>
+#include <span>
+#include <string>
 
 #include "core/config_manager.hpp"
 #include "market_data/market_data_service.hpp"
 #include "order/order_request.hpp"
+#include "strategy/feature_store.hpp"
 
 namespace acct_service {
 
@@ -15,11 +21,12 @@ struct ActiveDecision {
     DPrice price = 0;
 };
 
-// 主动策略评估时拿到的最小上下文：父单、行情/预测和当前片预算。
+// 主动策略评估时拿到的最小上下文：父单、行情/预测、当前片预算和该证券的增量特征。
 struct ActiveStrategyContext {
     const OrderRequest& parent_request;
     const MarketDataView& market_data;
     Volume budget_volume = 0;
+    const SymbolFeatures* features = nullptr;  // 引擎按 publish_seq_no 增量维护；尚无发布时为 nullptr
 };
 
 // 主动策略抽象：在每个 TWAP 时间片内决定是否直接给出子单。
@@ -36,15 +43,42 @@ public:
     // 基于当前行情/预测和片预算做一次评估。
     virtual ActiveDecision evaluate(const ActiveStrategyContext& context) = 0;
 
+    // 一次评估本轮全部候选父单，out_decisions 与 contexts 等长且按下标对应；
+    // 默认逐个调用 evaluate()，向量化模型可覆盖为单次批量打分。
+    // 保持内联，插件只依赖本头文件即可编译，不必链接 acct_strategy。
+    virtual void evaluate_many(std::span<const ActiveStrategyContext> contexts,
+                               std::span<ActiveDecision> out_decisions) {
+        const std::size_t count = std::min(contexts.size(), out_decisions.size());
+        for (std::size_t i = 0; i < count; ++i) {
+            out_decisions[i] = evaluate(contexts[i]);
+        }
+    }
+
 protected:
     ActiveStrategy() = default;
 };
 
-// 内建主动策略工厂：首版按名字创建编译进仓库的实现。
+// 插件 ABI 版本：ActiveStrategy / ActiveStrategyContext / ActiveDecision / ActiveStrategyConfig 布局变化时递增。
+inline constexpr uint32_t kActiveStrategyAbiVersion = 2;
+
+// 插件导出符号约定（用于 dlsym 查找）。
+inline constexpr const char* kStrategyPluginAbiSymbol = "acct_active_strategy_abi_version";
+inline constexpr const char* kStrategyPluginCreateSymbol = "acct_create_active_strategy";
+inline constexpr const char* kStrategyPluginDestroySymbol = "acct_destroy_active_strategy";
+
+// 插件函数签名类型定义。
+using strategy_plugin_abi_fn_t = uint32_t (*)();
+using strategy_plugin_create_fn_t = ActiveStrategy* (*)(const ActiveStrategyConfig*);
+using strategy_plugin_destroy_fn_t = void (*)(ActiveStrategy*);
+
+// 主动策略工厂：plugin_path 非空时从 .so 插件加载，否则按名字创建编译进仓库的实现。
 class StrategyRegistry {
 public:
     // 根据配置创建服务级主动策略；未启用或显式 none 时返回空指针。
     static std::unique_ptr<ActiveStrategy> create(const ActiveStrategyConfig& config);
+
+    // 同上，启用但创建失败时通过 error_message 说明原因（未知名称、插件加载失败、ABI 或名字不匹配）。
+    static std::unique_ptr<ActiveStrategy> create(const ActiveStrategyConfig& config, std::string& error_message);
 };
 
 }  // namespace acct_service
@@ -0,0 +1,70 @@
+#include "strategy/feature_store.hpp"
+
+#include <algorithm>
+
+namespace acct_service {
+
+SymbolFeatureStore::SymbolFeatureStore(uint32_t ema_span) noexcept
+    : ema_alpha_(2.0F / (static_cast<float>(std::max<uint32_t>(ema_span, 1)) + 1.0F)) {}
+
+const SymbolFeatures* SymbolFeatureStore::update(MarketDataHandle handle, const MarketDataView& view) {
+    if (!handle.is_valid()) {
+        return nullptr;
+    }
+    if (features_.size() <= handle.slot) {
+        features_.resize(handle.slot + 1);
+    }
+    std::unique_ptr<SymbolFeatures>& slot = features_[handle.slot];
+    if (!slot) {
+        slot = std::make_unique<SymbolFeatures>();
+    }
+    SymbolFeatures& features = *slot;
+    const uint64_t publish_seq_no = view.prediction.publish_seq_no;
+    if (publish_seq_no == 0 || (features.updates > 0 && publish_seq_no <= features.publish_seq_no)) {
+        return features.updates > 0 ? &features : nullptr;
+    }
+
+    const snapshot_shm::LobSnapshot& snapshot = view.snapshot;
+    const bool has_bid = snapshot.total_bid_levels > 0 && snapshot.bids[0].price > 0;
+    const bool has_ask = snapshot.total_ask_levels > 0 && snapshot.asks[0].price > 0;
+    features.spread = has_bid && has_ask && snapshot.asks[0].price >= snapshot.bids[0].price
+                          ? static_cast<DPrice>(snapshot.asks[0].price - snapshot.bids[0].price)
+                          : 0;
+    const double bid_volume = has_bid ? static_cast<double>(snapshot.bids[0].volume) : 0.0;
+    const double ask_volume = has_ask ? static_cast<double>(snapshot.asks[0].volume) : 0.0;
+    const double depth = bid_volume + ask_volume;
+    features.queue_imbalance = depth > 0.0 ? static_cast<float>((bid_volume - ask_volume) / depth) : 0.0F;
+
+    features.signal = view.prediction.signal;
+    features.signal_ema = features.updates == 0
+                              ? features.signal
+                              : features.signal_ema + ema_alpha_ * (features.signal - features.signal_ema);
+
+    SymbolFeatureHistory& history = features.history;
+    const std::size_t window = std::min<std::size_t>(SymbolFeatures::kShortVolumeWindow, history.count);
+    const Volume base_volume = window > 0 ? history.trade_volume_at(window - 1) : snapshot.trade_volume;
+    features.short_volume = snapshot.trade_volume >= base_volume ? snapshot.trade_volume - base_volume : 0;
+
+    const std::size_t at = history.head;
+    history.signal[at] = features.signal;
+    history.signal_ema[at] = features.signal_ema;
+    history.queue_imbalance[at] = features.queue_imbalance;
+    history.spread[at] = features.spread;
+    history.trade_volume[at] = snapshot.trade_volume;
+    history.head = static_cast<uint32_t>((at + 1) & SymbolFeatureHistory::kMask);
+    history.count = std::min<uint32_t>(history.count + 1, SymbolFeatureHistory::kCapacity);
+
+    features.publish_seq_no = publish_seq_no;
+    ++features.updates;
+    return &features;
+}
+
+const SymbolFeatures* SymbolFeatureStore::find(MarketDataHandle handle) const noexcept {
+    if (!handle.is_valid() || handle.slot >= features_.size() || !features_[handle.slot]) {
+        return nullptr;
+    }
+    const SymbolFeatures& features = *features_[handle.slot];
+    return features.updates > 0 ? &features : nullptr;
+}
+
+}  // namespace acct_service
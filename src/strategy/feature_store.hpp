@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "common/types.hpp"
+#include "market_data/market_data_service.hpp"
+
+namespace acct_service {
+
+// 单证券滚动特征的定长环形历史（SoA）：每列独立连续，按列扫描只触达所需字段。
+// 下标 0 为最近一次更新，越界访问返回 0。
+struct SymbolFeatureHistory {
+    static constexpr std::size_t kCapacity = 64;
+    static constexpr std::size_t kMask = kCapacity - 1;
+    static_assert((kCapacity & kMask) == 0, "history capacity must be a power of two");
+
+    float signal[kCapacity]{};
+    float signal_ema[kCapacity]{};
+    float queue_imbalance[kCapacity]{};
+    DPrice spread[kCapacity]{};
+    Volume trade_volume[kCapacity]{};  // 快照累计成交量
+    uint32_t head = 0;                 // 下一次写入位置
+    uint32_t count = 0;                // 有效条数，不超过 kCapacity
+
+    std::size_t size() const noexcept { return count; }
+    std::size_t index(std::size_t ago) const noexcept { return (head + kCapacity - 1 - ago) & kMask; }
+    float signal_at(std::size_t ago) const noexcept { return ago < count ? signal[index(ago)] : 0.0F; }
+    float signal_ema_at(std::size_t ago) const noexcept { return ago < count ? signal_ema[index(ago)] : 0.0F; }
+    float queue_imbalance_at(std::size_t ago) const noexcept {
+        return ago < count ? queue_imbalance[index(ago)] : 0.0F;
+    }
+    DPrice spread_at(std::size_t ago) const noexcept { return ago < count ? spread[index(ago)] : 0; }
+    Volume trade_volume_at(std::size_t ago) const noexcept { return ago < count ? trade_volume[index(ago)] : 0; }
+};
+
+// 单证券的当前特征与历史；只在 prediction.publish_seq_no 前进时更新一次，同证券的全部父单共享。
+struct SymbolFeatures {
+    uint64_t publish_seq_no = 0;  // 最近一次纳入的发布序号
+    uint64_t updates = 0;         // 累计纳入的发布次数
+    float signal = 0.0F;
+    float signal_ema = 0.0F;      // 信号指数滑动平均（首个样本直接取值）
+    float queue_imbalance = 0.0F; // 顶档 (买量 - 卖量) / (买量 + 卖量)，[-1, 1]
+    DPrice spread = 0;            // 顶档卖一 - 买一，任一侧缺失时为 0
+    Volume short_volume = 0;      // 近 kShortVolumeWindow 次发布间的成交量
+    SymbolFeatureHistory history{};
+
+    static constexpr std::size_t kShortVolumeWindow = 8;
+};
+
+// 按 MarketDataHandle 槽位组织的特征表：执行引擎在行情前进时更新，评估时只读，O(1) 取得。
+// 单线程使用（事件循环线程）；条目按槽位堆上构造一次，已发出的指针稳定。
+class SymbolFeatureStore {
+public:
+    // ema_span 为信号平滑跨度，alpha = 2 / (span + 1)
+    explicit SymbolFeatureStore(uint32_t ema_span = 16) noexcept;
+
+    SymbolFeatureStore(const SymbolFeatureStore&) = delete;
+    SymbolFeatureStore& operator=(const SymbolFeatureStore&) = delete;
+
+    // 把视图纳入该证券特征：publish_seq_no 未前进时不改动，直接返回现有特征。句柄无效返回 nullptr
+    const SymbolFeatures* update(MarketDataHandle handle, const MarketDataView& view);
+
+    // 只读取特征，尚未纳入过任何发布时返回 nullptr
+    const SymbolFeatures* find(MarketDataHandle handle) const noexcept;
+
+private:
+    float ema_alpha_ = 0.0F;
+    std::vector<std::unique_ptr<SymbolFeatures>> features_;
+};
+
+}  // namespace acct_service
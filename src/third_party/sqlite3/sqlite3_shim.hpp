@@ -19,7 +19,9 @@ int sqlite3_prepare_v2(
     sqlite3* db, const char* z_sql, int n_byte, sqlite3_stmt** pp_stmt, const char** pz_tail);
 int sqlite3_finalize(sqlite3_stmt* p_stmt);
 int sqlite3_bind_int64(sqlite3_stmt* p_stmt, int i, sqlite3_int64 value);
+int sqlite3_bind_text(sqlite3_stmt* p_stmt, int i, const char* value, int n_byte, void (*destructor)(void*));
 int sqlite3_step(sqlite3_stmt* p_stmt);
+int sqlite3_reset(sqlite3_stmt* p_stmt);
 
 int sqlite3_column_type(sqlite3_stmt* p_stmt, int i_col);
 sqlite3_int64 sqlite3_column_int64(sqlite3_stmt* p_stmt, int i_col);
@@ -58,4 +60,8 @@ void sqlite3_free(void* p);
 #define SQLITE_OPEN_CREATE 0x00000004
 #endif
 
+#ifndef SQLITE_TRANSIENT
+#define SQLITE_TRANSIENT ((void (*)(void*))-1)
+#endif
+
 #endif  // __has_include(<sqlite3.h>)
@@ -0,0 +1,291 @@
+#!/usr/bin/env bash
+set -euo pipefail
+
+# 单机多账户干扰基准：按 ACCOUNT_COUNTS 逐档拉起 N 组 account_service + sim gateway，
+# 每个账户配一个 order_load_gen 同时压测，汇总每账户延迟分位数与合计吞吐，观察 N 增大时的互相干扰。
+SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+SOURCE_DIR="$(cd "${SCRIPT_DIR}/.." && pwd)"
+BUILD_DIR="${1:-${SOURCE_DIR}/build}"
+if [[ ! -d "${BUILD_DIR}" ]]; then
+  echo "[bench] build dir not found: ${BUILD_DIR}" >&2
+  exit 1
+fi
+BUILD_DIR="$(cd "${BUILD_DIR}" && pwd)"
+
+RUN_ID="$(date +%Y%m%d_%H%M%S)_$$"
+# 本次运行所有 SHM 名都带该标记，清理时按标记整体删除，不影响同机其他实例。
+SHM_TAG="mab$$"
+TRADING_DAY="${TRADING_DAY:-19700101}"
+ACCOUNT_COUNTS="${ACCOUNT_COUNTS:-1,2,4,8}"
+RATE="${RATE:-2000}"
+DURATION_MS="${DURATION_MS:-10000}"
+BURST="${BURST:-4}"
+CANCEL_RATIO="${CANCEL_RATIO:-0}"
+SECURITIES="${SECURITIES:-000001,300750}"
+MARKET="${MARKET:-sz}"
+PRICE="${PRICE:-10.5}"
+SEED="${SEED:-7}"
+# PIN_CPUS=1 时账户 i 的事件循环绑 2i 号核、网关主循环绑 2i+1 号核（按核数取模），用于区分核共享与缓存干扰。
+PIN_CPUS="${PIN_CPUS:-0}"
+# 行情快照段由外部行情进程发布；未部署时保持默认 0，生成的账户配置关闭 market_data，否则账户服务初始化失败。
+MARKET_DATA="${MARKET_DATA:-0}"
+STARTUP_TIMEOUT_SEC="${STARTUP_TIMEOUT_SEC:-30}"
+SAMPLE_DB_PATH="${SAMPLE_DB_PATH:-${SOURCE_DIR}/data/account_service.db}"
+
+SERVICE_BIN="${BUILD_DIR}/src/acct_service_main"
+GATEWAY_BIN="${BUILD_DIR}/gateway/acct_broker_gateway_main"
+LOAD_BIN="${BUILD_DIR}/tools/full_chain_e2e/order_load_gen"
+
+SERVICE_CFG="${SERVICE_CFG:-${SOURCE_DIR}/config/default.yaml}"
+GATEWAY_CFG="${GATEWAY_CFG:-${SOURCE_DIR}/config/gateway.yaml}"
+
+RUN_DIR="${BUILD_DIR}/bench_artifacts/multi_account_${RUN_ID}"
+mkdir -p "${RUN_DIR}"
+RUN_DIR="$(cd "${RUN_DIR}" && pwd)"
+SUMMARY_CSV="${RUN_DIR}/summary.csv"
+
+PIDS=()
+
+# 终止当前档位的全部进程并删除本次运行的 SHM。
+stop_accounts() {
+  local pid
+  for pid in "${PIDS[@]}"; do
+    kill "${pid}" 2>/dev/null || true
+  done
+  for pid in "${PIDS[@]}"; do
+    wait "${pid}" 2>/dev/null || true
+  done
+  PIDS=()
+  rm -f /dev/shm/*"${SHM_TAG}"_* || true
+}
+
+cleanup() {
+  local exit_code="$1"
+  stop_accounts
+  if [[ "${exit_code}" -ne 0 ]]; then
+    echo "[bench] failed, artifacts: ${RUN_DIR}" >&2
+  fi
+}
+trap 'cleanup $?' EXIT
+
+# 轮询路径存在性，适配 /dev/shm 对象就绪检测。
+wait_for_path() {
+  local path="$1"
+  local timeout_sec="$2"
+  local deadline=$((SECONDS + timeout_sec))
+  while (( SECONDS < deadline )); do
+    if [[ -e "${path}" ]]; then
+      return 0
+    fi
+    sleep 0.2
+  done
+  return 1
+}
+
+# 账户服务配置：shm 段下非空的段名按账户序号改写；公司级合计段与证券主数据段为跨账户共享，保持原值。
+# account_id 沿用样本 DB 中的账户，各实例使用独立 DB 副本与独立段名，互不可见。
+write_service_config() {
+  local slot="$1"
+  local cpu_core="$2"
+  awk -v suffix="_${SHM_TAG}_${slot}" -v cpu_core="${cpu_core}" \
+      -v market_data="${MARKET_DATA}" '
+    /^[^[:space:]#]/ {
+      section = $1
+    }
+    section == "shm:" && /_shm_name[[:space:]]*:[[:space:]]*"[^"]+"/ &&
+        $1 != "firm_risk_shm_name:" && $1 != "security_master_shm_name:" {
+      sub(/"[[:space:]]*$/, suffix "\"")
+      print
+      next
+    }
+    section == "market_data:" && market_data == 0 && $1 == "enabled:" {
+      print "  enabled: false"
+      next
+    }
+    section == "event_loop:" && cpu_core >= 0 && $1 == "pin_cpu:" {
+      print "  pin_cpu: true"
+      next
+    }
+    section == "event_loop:" && cpu_core >= 0 && $1 == "cpu_core:" {
+      print "  cpu_core: " cpu_core
+      next
+    }
+    {
+      print
+    }
+  ' "${SERVICE_CFG}"
+}
+
+# 网关配置：三个必需段名按账户序号改写，可选的 stats_shm 非空时同样改写。
+write_gateway_config() {
+  local slot="$1"
+  local cpu_core="$2"
+  awk -v suffix="_${SHM_TAG}_${slot}" -v cpu_core="${cpu_core}" '
+    /^(downstream_shm|trades_shm|orders_shm|stats_shm)[[:space:]]*:[[:space:]]*"[^"]+"/ {
+      match($0, /"[^"]+"/)
+      print substr($0, 1, RSTART + RLENGTH - 2) suffix substr($0, RSTART + RLENGTH - 1)
+      next
+    }
+    cpu_core >= 0 && /^main_cpu_core[[:space:]]*:/ {
+      print "main_cpu_core: " cpu_core
+      next
+    }
+    {
+      print
+    }
+  ' "${GATEWAY_CFG}"
+}
+
+for bin in "${SERVICE_BIN}" "${GATEWAY_BIN}" "${LOAD_BIN}"; do
+  if [[ ! -x "${bin}" ]]; then
+    echo "[bench] missing binary: ${bin}" >&2
+    exit 1
+  fi
+done
+for cfg in "${SERVICE_CFG}" "${GATEWAY_CFG}" "${SAMPLE_DB_PATH}"; do
+  if [[ ! -f "${cfg}" ]]; then
+    echo "[bench] missing file: ${cfg}" >&2
+    exit 1
+  fi
+done
+if ! [[ "${ACCOUNT_COUNTS}" =~ ^[1-9][0-9]*(,[1-9][0-9]*)*$ ]]; then
+  echo "[bench] invalid ACCOUNT_COUNTS: ${ACCOUNT_COUNTS}" >&2
+  exit 1
+fi
+if ! [[ "${PIN_CPUS}" =~ ^[01]$ ]]; then
+  echo "[bench] invalid PIN_CPUS: ${PIN_CPUS}" >&2
+  exit 1
+fi
+if ! [[ "${MARKET_DATA}" =~ ^[01]$ ]]; then
+  echo "[bench] invalid MARKET_DATA: ${MARKET_DATA}" >&2
+  exit 1
+fi
+CPU_COUNT="$(nproc)"
+
+echo "accounts,account,submitted,unanswered,throughput_ops,p50_ns,p90_ns,p99_ns,p999_ns,max_ns" > "${SUMMARY_CSV}"
+
+IFS=',' read -r -a COUNTS <<< "${ACCOUNT_COUNTS}"
+for count in "${COUNTS[@]}"; do
+  TIER_DIR="${RUN_DIR}/n${count}"
+  mkdir -p "${TIER_DIR}"
+
+  # 1) 每个账户独立工作目录：日志、DB 副本、checkpoint 等相对路径互不干扰。
+  for ((i = 0; i < count; ++i)); do
+    slot=$((i + 1))
+    account_dir="${TIER_DIR}/acct_${slot}"
+    mkdir -p "${account_dir}/data" "${account_dir}/logs"
+    cp "${SAMPLE_DB_PATH}" "${account_dir}/data/account_service.db"
+    service_core=-1
+    gateway_core=-1
+    if [[ "${PIN_CPUS}" -eq 1 ]]; then
+      service_core=$(((2 * i) % CPU_COUNT))
+      gateway_core=$(((2 * i + 1) % CPU_COUNT))
+    fi
+    write_service_config "${slot}" "${service_core}" > "${account_dir}/service.yaml"
+    write_gateway_config "${slot}" "${gateway_core}" > "${account_dir}/gateway.yaml"
+
+    (
+      cd "${account_dir}"
+      exec "${SERVICE_BIN}" --config "${account_dir}/service.yaml" >"${account_dir}/account_service.stdout.log" 2>&1
+    ) &
+    PIDS+=("$!")
+    (
+      cd "${account_dir}"
+      exec "${GATEWAY_BIN}" --config "${account_dir}/gateway.yaml" >"${account_dir}/gateway.stdout.log" 2>&1
+    ) &
+    PIDS+=("$!")
+  done
+
+  # 2) 全部账户的订单池与上游段就绪后再统一开压，保证各档位的并发度一致。
+  for ((i = 0; i < count; ++i)); do
+    slot=$((i + 1))
+    orders_path="/dev/shm/orders_shm_${SHM_TAG}_${slot}_${TRADING_DAY}"
+    upstream_path="/dev/shm/upstream_order_shm_${SHM_TAG}_${slot}"
+    wait_for_path "${orders_path}" "${STARTUP_TIMEOUT_SEC}" ||
+      { echo "[bench] orders shm not ready: ${orders_path}" >&2; exit 1; }
+    wait_for_path "${upstream_path}" "${STARTUP_TIMEOUT_SEC}" ||
+      { echo "[bench] upstream shm not ready: ${upstream_path}" >&2; exit 1; }
+  done
+  sleep 0.5
+  # 段文件先于初始化完成创建，开压前确认进程仍存活，避免对已退出的账户空跑。
+  for pid in "${PIDS[@]}"; do
+    if ! kill -0 "${pid}" 2>/dev/null; then
+      echo "[bench] account process exited during startup (n=${count}), see ${TIER_DIR}" >&2
+      exit 1
+    fi
+  done
+
+  LOAD_PIDS=()
+  for ((i = 0; i < count; ++i)); do
+    slot=$((i + 1))
+    account_dir="${TIER_DIR}/acct_${slot}"
+    "${LOAD_BIN}" --security "${SECURITIES}" --market "${MARKET}" --price "${PRICE}" \
+      --rate "${RATE}" --duration-ms "${DURATION_MS}" --burst "${BURST}" --cancel-ratio "${CANCEL_RATIO}" \
+      --seed $((SEED + i)) --trading-day "${TRADING_DAY}" \
+      --upstream-shm "/upstream_order_shm_${SHM_TAG}_${slot}" \
+      --orders-shm "/orders_shm_${SHM_TAG}_${slot}" \
+      >"${account_dir}/load.stdout.log" 2>"${account_dir}/load.stderr.log" &
+    LOAD_PIDS+=("$!")
+  done
+  for pid in "${LOAD_PIDS[@]}"; do
+    wait "${pid}" || { echo "[bench] order_load_gen failed (n=${count}), see ${TIER_DIR}" >&2; exit 1; }
+  done
+  stop_accounts
+
+  # 3) 解析各账户的 [load] 报告：submit_to_first_response 分位数 + 实际吞吐。
+  for ((i = 0; i < count; ++i)); do
+    slot=$((i + 1))
+    awk -v accounts="${count}" -v slot="${slot}" '
+      function field(name,    i, kv) {
+        for (i = 1; i <= NF; ++i) {
+          split($i, kv, "=")
+          if (kv[1] == name) {
+            return kv[2]
+          }
+        }
+        return 0
+      }
+      /^\[load\] seed=/ {
+        submitted = field("submitted")
+        unanswered = field("unanswered")
+        throughput = field("throughput_ops")
+      }
+      /^\[load\] latency=submit_to_first_response / {
+        p50 = field("p50_ns"); p90 = field("p90_ns"); p99 = field("p99_ns")
+        p999 = field("p999_ns"); max = field("max_ns")
+      }
+      END {
+        printf "%d,%d,%d,%d,%.1f,%d,%d,%d,%d,%d\n", accounts, slot, submitted, unanswered, throughput,
+               p50, p90, p99, p999, max
+      }
+    ' "${TIER_DIR}/acct_${slot}/load.stdout.log" >> "${SUMMARY_CSV}"
+  done
+
+  awk -F',' -v accounts="${count}" '
+    $1 == accounts {
+      printf "[bench] accounts=%d account=%d throughput_ops=%.1f p50_ns=%d p99_ns=%d p999_ns=%d unanswered=%d\n",
+             $1, $2, $5, $6, $8, $9, $4
+      total += $5
+      unanswered += $4
+      if ($8 > worst_p99) {
+        worst_p99 = $8
+      }
+      p99[++rows] = $8
+    }
+    END {
+      # 账户 p99 的中位数（最近秩），与最差账户一起反映干扰的整体与尾部
+      for (i = 1; i <= rows; ++i) {
+        for (j = i + 1; j <= rows; ++j) {
+          if (p99[j] < p99[i]) {
+            tmp = p99[i]; p99[i] = p99[j]; p99[j] = tmp
+          }
+        }
+      }
+      median = rows > 0 ? p99[int((rows + 1) / 2)] : 0
+      printf "[bench] accounts=%d aggregate_throughput_ops=%.1f median_p99_ns=%d worst_p99_ns=%d unanswered=%d\n",
+             accounts, total, median, worst_p99, unanswered
+    }
+  ' "${SUMMARY_CSV}"
+done
+
+echo "[bench] summary: ${SUMMARY_CSV}"
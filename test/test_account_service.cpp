@@ -11,7 +11,9 @@
 #include <memory>
 #include <string>
 #include <thread>
+#include <vector>
 
+#include "core/account_host.hpp"
 #include "core/account_service.hpp"
 #include "order/order_request.hpp"
 #include "shm/orders_shm.hpp"
@@ -31,6 +33,13 @@ namespace {
 using namespace acct_service;
 using sqlite_db_ptr = std::unique_ptr<sqlite3, decltype(&sqlite3_close)>;
 
+// 按 trades_shm 队列的紧凑编码写入一条回报。
+bool push_trade_response(trades_shm_layout& trades, const TradeResponse& response) {
+    trade_response_message message;
+    pack_trade_response_message(response, message);
+    return trades.response_queue.try_push(message);
+}
+
 // 定位并创建测试临时目录，避免写入仓库 data 初始化目录。
 const std::string& test_data_dir() {
     namespace fs = std::filesystem;
@@ -100,6 +109,7 @@ bool write_config_file(const std::string& path, const Config& cfg) {
     out << "  trades_shm_name: \"" << cfg.shm.trades_shm_name << "\"\n";
     out << "  orders_shm_name: \"" << cfg.shm.orders_shm_name << "\"\n";
     out << "  positions_shm_name: \"" << cfg.shm.positions_shm_name << "\"\n";
+    out << "  stats_shm_name: \"" << cfg.shm.stats_shm_name << "\"\n";
     out << "  create_if_not_exist: " << (cfg.shm.create_if_not_exist ? "true" : "false") << "\n";
     out << "EventLoop:\n";
     out << "  busy_polling: " << (cfg.EventLoop.busy_polling ? "true" : "false") << "\n";
@@ -110,6 +120,13 @@ bool write_config_file(const std::string& path, const Config& cfg) {
     out << "  terminal_archive_delay_ms: " << cfg.EventLoop.terminal_archive_delay_ms << "\n";
     out << "  pin_cpu: " << (cfg.EventLoop.pin_cpu ? "true" : "false") << "\n";
     out << "  cpu_core: " << cfg.EventLoop.cpu_core << "\n";
+    out << "  warmup_orders: " << cfg.EventLoop.warmup_orders << "\n";
+    out << "  checkpoint_interval_ms: " << cfg.EventLoop.checkpoint_interval_ms << "\n";
+    out << "  checkpoint_dir: \"" << cfg.EventLoop.checkpoint_dir << "\"\n";
+    out << "  mark_to_market_interval_ms: " << cfg.EventLoop.mark_to_market_interval_ms << "\n";
+    out << "  adaptive_batching: " << (cfg.EventLoop.adaptive_batching ? "true" : "false") << "\n";
+    out << "  iteration_budget_us: " << cfg.EventLoop.iteration_budget_us << "\n";
+    out << "  response_share_pct: " << cfg.EventLoop.response_share_pct << "\n";
     out << "market_data:\n";
     out << "  enabled: " << (cfg.market_data.enabled ? "true" : "false") << "\n";
     out << "  snapshot_shm_name: \"" << cfg.market_data.snapshot_shm_name << "\"\n";
@@ -118,11 +135,15 @@ bool write_config_file(const std::string& path, const Config& cfg) {
     out << "  enabled: " << (cfg.active_strategy.enabled ? "true" : "false") << "\n";
     out << "  name: \"" << cfg.active_strategy.name << "\"\n";
     out << "  signal_threshold: " << cfg.active_strategy.signal_threshold << "\n";
+    out << "  plugin_path: \"" << cfg.active_strategy.plugin_path << "\"\n";
     out << "risk:\n";
     out << "  max_order_value: " << cfg.risk.max_order_value << "\n";
     out << "  max_order_volume: " << cfg.risk.max_order_volume << "\n";
     out << "  max_daily_turnover: " << cfg.risk.max_daily_turnover << "\n";
     out << "  max_orders_per_second: " << cfg.risk.max_orders_per_second << "\n";
+    out << "  max_orders_per_second_per_strategy: " << cfg.risk.max_orders_per_second_per_strategy << "\n";
+    out << "  max_orders_per_second_per_security: " << cfg.risk.max_orders_per_second_per_security << "\n";
+    out << "  rate_limit_burst_ms: " << cfg.risk.rate_limit_burst_ms << "\n";
     out << "  enable_price_limit_check: " << (cfg.risk.enable_price_limit_check ? "true" : "false") << "\n";
     out << "  enable_duplicate_check: " << (cfg.risk.enable_duplicate_check ? "true" : "false") << "\n";
     out << "  enable_fund_check: " << (cfg.risk.enable_fund_check ? "true" : "false") << "\n";
@@ -135,6 +156,7 @@ bool write_config_file(const std::string& path, const Config& cfg) {
     out << "  max_child_count: " << cfg.split.max_child_count << "\n";
     out << "  interval_ms: " << cfg.split.interval_ms << "\n";
     out << "  randomize_factor: " << cfg.split.randomize_factor << "\n";
+    out << "  vwap_profile_path: \"" << cfg.split.vwap_profile_path << "\"\n";
     out << "log:\n";
     out << "  log_dir: \"" << cfg.log.log_dir << "\"\n";
     out << "  log_level: \"" << cfg.log.log_level << "\"\n";
@@ -145,10 +167,19 @@ bool write_config_file(const std::string& path, const Config& cfg) {
     out << "  output_dir: \"" << cfg.business_log.output_dir << "\"\n";
     out << "  queue_capacity: " << cfg.business_log.queue_capacity << "\n";
     out << "  flush_interval_ms: " << cfg.business_log.flush_interval_ms << "\n";
+    out << "  binary_journal: " << (cfg.business_log.binary_journal ? "true" : "false") << "\n";
+    out << "  journal_segment_records: " << cfg.business_log.journal_segment_records << "\n";
+    out << "  delta_records: " << (cfg.business_log.delta_records ? "true" : "false") << "\n";
     out << "db:\n";
     out << "  db_path: \"" << cfg.db.db_path << "\"\n";
     out << "  enable_persistence: " << (cfg.db.enable_persistence ? "true" : "false") << "\n";
     out << "  sync_interval_ms: " << cfg.db.sync_interval_ms << "\n";
+    out << "  position_snapshot_path: \"" << cfg.db.position_snapshot_path << "\"\n";
+    out << "  trade_store_dir: \"" << cfg.db.trade_store_dir << "\"\n";
+    out << "gateway:\n";
+    out << "  in_process: " << (cfg.gateway.in_process ? "true" : "false") << "\n";
+    out << "  config_file: \"" << cfg.gateway.config_file << "\"\n";
+    out << "  inline_poll: " << (cfg.gateway.inline_poll ? "true" : "false") << "\n";
 
     return true;
 }
@@ -316,6 +347,7 @@ TEST(initialize_and_run_processes_orders) {
     cfg.shm.trades_shm_name = unique_shm_name("acct_trades");
     cfg.shm.orders_shm_name = unique_shm_name("acct_orders");
     cfg.shm.positions_shm_name = unique_shm_name("acct_positions");
+    cfg.shm.stats_shm_name = unique_shm_name("acct_stats");
     cfg.shm.create_if_not_exist = true;
     cfg.trading_day = "20260225";
 
@@ -343,6 +375,33 @@ TEST(initialize_and_run_processes_orders) {
     assert(service.initialize(config_path));
     assert(service.state() == ServiceState::Ready);
 
+    // 启动报告覆盖串行阶段、并发组及其中的各共享内存段
+    const startup_report& report = service.last_startup_report();
+    assert(report.ok());
+    assert(report.total_ns() > 0);
+    const std::vector<startup_phase_timing> phases = report.phases();
+    auto find_phase = [&](const char* name) -> const startup_phase_timing* {
+        for (const startup_phase_timing& phase : phases) {
+            if (phase.name == name) {
+                return &phase;
+            }
+        }
+        return nullptr;
+    };
+    for (const char* name : {"config", "shared_memory", "order_event_recorder", "market_data", "portfolio",
+                             "order_recovery", "event_loop", "shm.orders", "shm.positions"}) {
+        const startup_phase_timing* phase = find_phase(name);
+        assert(phase != nullptr && phase->ok);
+        assert(phase->start_ns + phase->duration_ns <= report.total_ns());
+    }
+    assert(find_phase("market_data")->group == "attach");
+    assert(find_phase("order_recovery")->group == "recover");
+    assert(find_phase("shm.orders")->group == "shared_memory");
+    assert(find_phase("config")->group.empty());
+    // 恢复组在接入组全部结束后才开始
+    assert(find_phase("portfolio")->start_ns >=
+           find_phase("shared_memory")->start_ns + find_phase("shared_memory")->duration_ns);
+
     SHMManager upstream_manager;
     SHMManager downstream_manager;
     SHMManager trades_manager;
@@ -395,7 +454,7 @@ TEST(initialize_and_run_processes_orders) {
     rsp.md_time_traded = 93100000;
     rsp.recv_time_ns = now_ns();
 
-    assert(trades->response_queue.try_push(rsp));
+    assert(push_trade_response(*trades, rsp));
 
     assert(wait_until([&service]() {
         const OrderEntry* order = service.orders().find_order(static_cast<InternalOrderId>(5001));
@@ -432,10 +491,63 @@ TEST(initialize_and_run_processes_orders) {
     (void)SHMManager::unlink(cfg.shm.trades_shm_name);
     (void)SHMManager::unlink(dated_orders_name);
     (void)SHMManager::unlink(cfg.shm.positions_shm_name);
+    (void)SHMManager::unlink(cfg.shm.stats_shm_name);
     std::remove(config_path.c_str());
     std::remove(order_log_path.c_str());
 }
 
+TEST(startup_warmup_leaves_live_state_untouched) {
+    Config cfg;
+    cfg.account_id = 108;
+    cfg.shm.upstream_shm_name = unique_shm_name("acct_warm_upstream");
+    cfg.shm.downstream_shm_name = unique_shm_name("acct_warm_downstream");
+    cfg.shm.trades_shm_name = unique_shm_name("acct_warm_trades");
+    cfg.shm.orders_shm_name = unique_shm_name("acct_warm_orders");
+    cfg.shm.positions_shm_name = unique_shm_name("acct_warm_positions");
+    cfg.shm.stats_shm_name = "";
+    cfg.shm.create_if_not_exist = true;
+    cfg.trading_day = "20260225";
+    cfg.EventLoop.stats_interval_ms = 0;
+    cfg.EventLoop.warmup_orders = 512;
+    cfg.split.strategy = SplitStrategy::None;
+    cfg.log.log_dir = test_data_dir();
+    cfg.business_log.output_dir = test_data_dir();
+    cfg.db.enable_persistence = false;
+    cfg.db.db_path.clear();
+
+    const std::string config_path = unique_config_path("acct_service_warmup_cfg");
+    assert(write_config_file(config_path, cfg));
+
+    AccountService service;
+    assert(service.initialize(config_path));
+    assert(service.state() == ServiceState::Ready);
+    assert(service.config().EventLoop().warmup_orders == 512);
+
+    // 合成订单只落在暂存组件上：真实订单簿、风控统计、下游队列与订单池均保持空
+    assert(service.orders().active_count() == 0);
+    assert(service.risk().stats().total_checks == 0);
+
+    SHMManager downstream_manager;
+    SHMManager orders_manager;
+    downstream_shm_layout* downstream =
+        downstream_manager.open_downstream(cfg.shm.downstream_shm_name, shm_mode::Open, cfg.account_id);
+    const std::string dated_orders_name = make_orders_shm_name(cfg.shm.orders_shm_name, cfg.trading_day);
+    orders_shm_layout* orders = orders_manager.open_orders(dated_orders_name, shm_mode::Open, cfg.account_id);
+    assert(downstream != nullptr);
+    assert(orders != nullptr);
+    assert(downstream->order_queue.size() == 0);
+    assert(orders->header.next_index.load(std::memory_order_acquire) == 0);
+
+    downstream_manager.close();
+    orders_manager.close();
+    (void)SHMManager::unlink(cfg.shm.upstream_shm_name);
+    (void)SHMManager::unlink(cfg.shm.downstream_shm_name);
+    (void)SHMManager::unlink(cfg.shm.trades_shm_name);
+    (void)SHMManager::unlink(dated_orders_name);
+    (void)SHMManager::unlink(cfg.shm.positions_shm_name);
+    std::remove(config_path.c_str());
+}
+
 TEST(restart_recovers_downstream_active_orders) {
     Config cfg;
     cfg.account_id = 104;
@@ -444,6 +556,7 @@ TEST(restart_recovers_downstream_active_orders) {
     cfg.shm.trades_shm_name = unique_shm_name("acct_trades_recover");
     cfg.shm.orders_shm_name = unique_shm_name("acct_orders_recover");
     cfg.shm.positions_shm_name = unique_shm_name("acct_positions_recover");
+    cfg.shm.stats_shm_name = unique_shm_name("acct_stats_recover");
     cfg.shm.create_if_not_exist = true;
     cfg.trading_day = "20260225";
 
@@ -531,7 +644,7 @@ TEST(restart_recovers_downstream_active_orders) {
     response.trade_side = TradeSide::Buy;
     response.new_state = OrderState::BrokerAccepted;
     response.recv_time_ns = now_ns();
-    assert(trades->response_queue.try_push(response));
+    assert(push_trade_response(*trades, response));
 
     assert(wait_until([&second_start]() {
         const OrderEntry* order = second_start.orders().find_order(static_cast<InternalOrderId>(7001));
@@ -552,6 +665,7 @@ TEST(restart_recovers_downstream_active_orders) {
     (void)SHMManager::unlink(cfg.shm.trades_shm_name);
     (void)SHMManager::unlink(dated_orders_name);
     (void)SHMManager::unlink(cfg.shm.positions_shm_name);
+    (void)SHMManager::unlink(cfg.shm.stats_shm_name);
     std::remove(config_path.c_str());
 }
 
@@ -567,6 +681,7 @@ TEST(initialize_rejects_invalid_config) {
 
     AccountService service;
     assert(!service.initialize(config_path));
+    assert(!service.last_startup_report().ok());
     std::remove(config_path.c_str());
 }
 
@@ -578,6 +693,7 @@ TEST(initialize_prints_loaded_config_to_stderr) {
     cfg.shm.trades_shm_name = unique_shm_name("acct_trades_print_cfg");
     cfg.shm.orders_shm_name = unique_shm_name("acct_orders_print_cfg");
     cfg.shm.positions_shm_name = unique_shm_name("acct_positions_print_cfg");
+    cfg.shm.stats_shm_name = unique_shm_name("acct_stats_print_cfg");
     cfg.shm.create_if_not_exist = true;
     cfg.trading_day = "20260225";
 
@@ -638,6 +754,7 @@ TEST(initialize_prints_loaded_config_to_stderr) {
     (void)SHMManager::unlink(cfg.shm.trades_shm_name);
     (void)SHMManager::unlink(dated_orders_name);
     (void)SHMManager::unlink(cfg.shm.positions_shm_name);
+    (void)SHMManager::unlink(cfg.shm.stats_shm_name);
     std::remove(config_path.c_str());
     std::remove(log_path.c_str());
 }
@@ -652,6 +769,7 @@ TEST(position_loader_file_mode_only_on_fresh_shm) {
     cfg.shm.trades_shm_name = unique_shm_name("acct_trades_pos_boot");
     cfg.shm.orders_shm_name = unique_shm_name("acct_orders_pos_boot");
     cfg.shm.positions_shm_name = unique_shm_name("acct_positions_pos_boot");
+    cfg.shm.stats_shm_name = unique_shm_name("acct_stats_pos_boot");
     cfg.shm.create_if_not_exist = true;
     cfg.trading_day = "20260225";
 
@@ -723,6 +841,7 @@ TEST(position_loader_file_mode_only_on_fresh_shm) {
     (void)SHMManager::unlink(cfg.shm.trades_shm_name);
     (void)SHMManager::unlink(dated_orders_name);
     (void)SHMManager::unlink(cfg.shm.positions_shm_name);
+    (void)SHMManager::unlink(cfg.shm.stats_shm_name);
     std::remove(config_path.c_str());
     std::remove(bootstrap_file.c_str());
 }
@@ -737,6 +856,7 @@ TEST(position_loader_db_mode_only_on_fresh_shm) {
     cfg.shm.trades_shm_name = unique_shm_name("acct_trades_pos_boot_db");
     cfg.shm.orders_shm_name = unique_shm_name("acct_orders_pos_boot_db");
     cfg.shm.positions_shm_name = unique_shm_name("acct_positions_pos_boot_db");
+    cfg.shm.stats_shm_name = unique_shm_name("acct_stats_pos_boot_db");
     cfg.shm.create_if_not_exist = true;
     cfg.trading_day = "20260225";
 
@@ -815,19 +935,234 @@ TEST(position_loader_db_mode_only_on_fresh_shm) {
     (void)SHMManager::unlink(cfg.shm.trades_shm_name);
     (void)SHMManager::unlink(dated_orders_name);
     (void)SHMManager::unlink(cfg.shm.positions_shm_name);
+    (void)SHMManager::unlink(cfg.shm.stats_shm_name);
     std::remove(config_path.c_str());
     std::remove(cfg.db.db_path.c_str());
 }
 
+// 进程内网关：sim 适配器直接消费本服务的下游队列并回写回报队列，无需外部网关进程即可成交
+TEST(in_process_gateway_fills_orders_without_external_gateway) {
+    for (const bool inline_poll : {true, false}) {
+        Config cfg;
+        cfg.account_id = static_cast<AccountId>(inline_poll ? 131 : 132);
+        cfg.shm.upstream_shm_name = unique_shm_name("colo_upstream");
+        cfg.shm.downstream_shm_name = unique_shm_name("colo_downstream");
+        cfg.shm.trades_shm_name = unique_shm_name("colo_trades");
+        cfg.shm.orders_shm_name = unique_shm_name("colo_orders");
+        cfg.shm.positions_shm_name = unique_shm_name("colo_positions");
+        cfg.shm.stats_shm_name = unique_shm_name("colo_stats");
+        cfg.shm.create_if_not_exist = true;
+        cfg.trading_day = "20260225";
+        cfg.EventLoop.stats_interval_ms = 0;
+        cfg.risk.enable_position_check = false;
+        cfg.risk.enable_duplicate_check = false;
+        cfg.risk.enable_price_limit_check = false;
+        cfg.split.strategy = SplitStrategy::None;
+        cfg.log.log_dir = test_data_dir();
+        cfg.business_log.output_dir = test_data_dir();
+        cfg.business_log.flush_interval_ms = 10;
+        cfg.db.enable_persistence = false;
+        cfg.db.db_path.clear();
+
+        // 网关配置里的 account_id / shm 名会被宿主账户覆盖，这里故意写成不同的值
+        const std::string gateway_config_path = unique_config_path("colo_gateway_cfg");
+        {
+            std::ofstream out(gateway_config_path);
+            assert(out.is_open());
+            out << "account_id: 9999\n";
+            out << "downstream_shm: \"/colo_unused_downstream\"\n";
+            out << "trades_shm: \"/colo_unused_trades\"\n";
+            out << "orders_shm: \"/colo_unused_orders\"\n";
+            out << "broker_type: \"sim\"\n";
+            out << "stats_interval_ms: 0\n";
+            out << "idle_sleep_us: 10\n";
+        }
+        cfg.gateway.in_process = true;
+        cfg.gateway.config_file = gateway_config_path;
+        cfg.gateway.inline_poll = inline_poll;
+
+        const std::string config_path = unique_config_path("colo_acct_cfg");
+        assert(write_config_file(config_path, cfg));
+
+        AccountService service;
+        assert(service.initialize(config_path));
+
+        SHMManager upstream_manager;
+        SHMManager orders_manager;
+        upstream_shm_layout* upstream =
+            upstream_manager.open_upstream(cfg.shm.upstream_shm_name, shm_mode::Open, cfg.account_id);
+        const std::string dated_orders_name = make_orders_shm_name(cfg.shm.orders_shm_name, cfg.trading_day);
+        orders_shm_layout* orders = orders_manager.open_orders(dated_orders_name, shm_mode::Open, cfg.account_id);
+        assert(upstream != nullptr && orders != nullptr);
+
+        int run_rc = -1;
+        std::thread worker([&service, &run_rc]() { run_rc = service.run(); });
+
+        const InternalOrderId order_id = static_cast<InternalOrderId>(inline_poll ? 8101 : 8102);
+        OrderRequest req;
+        req.init_new("000001", InternalSecurityId("XSHE_000001"), order_id, TradeSide::Buy, Market::SZ,
+                     static_cast<Volume>(100), static_cast<DPrice>(1000), 93000000);
+        req.order_state.store(OrderState::UserSubmitted, std::memory_order_relaxed);
+        OrderIndex upstream_index = kInvalidOrderIndex;
+        assert(orders_shm_append(orders, req, OrderSlotState::UpstreamQueued, order_slot_source_t::User, now_ns(),
+                                 upstream_index));
+        assert(upstream->upstream_order_queue.try_push(upstream_index));
+
+        assert(wait_until([&service, order_id]() {
+            const OrderEntry* order = service.orders().find_order(order_id);
+            return order != nullptr && order->request.volume_traded == static_cast<Volume>(100);
+        }));
+
+        service.stop();
+        worker.join();
+        assert(run_rc == 0);
+        assert(service.state() == ServiceState::Stopped);
+
+        upstream_manager.close();
+        orders_manager.close();
+        (void)SHMManager::unlink(cfg.shm.upstream_shm_name);
+        (void)SHMManager::unlink(cfg.shm.downstream_shm_name);
+        (void)SHMManager::unlink(cfg.shm.trades_shm_name);
+        (void)SHMManager::unlink(dated_orders_name);
+        (void)SHMManager::unlink(cfg.shm.positions_shm_name);
+        (void)SHMManager::unlink(cfg.shm.stats_shm_name);
+        std::remove(config_path.c_str());
+        std::remove(gateway_config_path.c_str());
+        std::remove(business_log_path(cfg).c_str());
+    }
+}
+
+TEST(plan_account_placement_dedicates_busy_accounts) {
+    // 两个忙账户各占一个 worker，其余空闲账户按数量均摊到剩下的共享 worker
+    const account_placement placement = plan_account_placement({0.0, 0.9, 0.0, 0.5, 0.0, 0.0}, 4, 0.3);
+    assert(placement.dedicated_workers == 2);
+    assert(placement.worker_of[1] == 0);
+    assert(placement.worker_of[3] == 1);
+    std::size_t shared_counts[4] = {};
+    for (const std::size_t index : {0, 2, 4, 5}) {
+        assert(placement.worker_of[index] >= 2);
+        ++shared_counts[placement.worker_of[index]];
+    }
+    assert(shared_counts[2] == 2 && shared_counts[3] == 2);
+
+    // worker 不够时至少留一个共享 worker，多出的忙账户退回共享
+    const account_placement crowded = plan_account_placement({0.9, 0.8, 0.7, 0.0}, 2, 0.3);
+    assert(crowded.dedicated_workers == 1);
+    assert(crowded.worker_of[0] == 0);
+    assert(crowded.worker_of[1] == 1 && crowded.worker_of[2] == 1 && crowded.worker_of[3] == 1);
+
+    // 全部账户都忙且 worker 足够时全部独占；单 worker 时不独占
+    const account_placement all_busy = plan_account_placement({0.6, 0.7}, 2, 0.3);
+    assert(all_busy.dedicated_workers == 2);
+    assert(all_busy.worker_of[0] == 1 && all_busy.worker_of[1] == 0);
+    const account_placement single = plan_account_placement({0.9, 0.1}, 1, 0.3);
+    assert(single.dedicated_workers == 0);
+    assert(single.worker_of[0] == 0 && single.worker_of[1] == 0);
+}
+
+TEST(account_host_runs_accounts_on_shared_worker) {
+    constexpr std::size_t kAccounts = 2;
+    std::vector<Config> configs(kAccounts);
+    std::vector<std::string> config_paths;
+    for (std::size_t i = 0; i < kAccounts; ++i) {
+        Config& cfg = configs[i];
+        cfg.account_id = static_cast<AccountId>(121 + i);
+        cfg.shm.upstream_shm_name = unique_shm_name("host_upstream");
+        cfg.shm.downstream_shm_name = unique_shm_name("host_downstream");
+        cfg.shm.trades_shm_name = unique_shm_name("host_trades");
+        cfg.shm.orders_shm_name = unique_shm_name("host_orders");
+        cfg.shm.positions_shm_name = unique_shm_name("host_positions");
+        cfg.shm.stats_shm_name = unique_shm_name("host_stats");
+        cfg.shm.create_if_not_exist = true;
+        cfg.trading_day = "20260225";
+        cfg.EventLoop.stats_interval_ms = 0;
+        cfg.risk.enable_position_check = false;
+        cfg.risk.enable_duplicate_check = false;
+        cfg.risk.enable_price_limit_check = false;
+        cfg.split.strategy = SplitStrategy::None;
+        cfg.log.log_dir = test_data_dir();
+        cfg.business_log.output_dir = test_data_dir();
+        cfg.business_log.flush_interval_ms = 10;
+        cfg.db.enable_persistence = false;
+        cfg.db.db_path.clear();
+        config_paths.push_back(unique_config_path("acct_host_cfg"));
+        assert(write_config_file(config_paths.back(), cfg));
+    }
+
+    account_host_options options;
+    options.worker_cores = {-1};
+    options.rebalance_interval_ms = 20;
+
+    AccountHost host;
+    assert(host.initialize(config_paths, options));
+    assert(host.account_count() == kAccounts);
+    assert(host.worker_of(0) == 0 && host.worker_of(1) == 0);
+
+    int run_rc = -1;
+    std::thread runner([&host, &run_rc]() { run_rc = host.run(); });
+
+    // 每个账户各自的上游/下游互不串扰，订单只出现在本账户的下游队列
+    for (std::size_t i = 0; i < kAccounts; ++i) {
+        const Config& cfg = configs[i];
+        SHMManager upstream_manager;
+        SHMManager downstream_manager;
+        SHMManager orders_manager;
+        upstream_shm_layout* upstream =
+            upstream_manager.open_upstream(cfg.shm.upstream_shm_name, shm_mode::Open, cfg.account_id);
+        downstream_shm_layout* downstream =
+            downstream_manager.open_downstream(cfg.shm.downstream_shm_name, shm_mode::Open, cfg.account_id);
+        orders_shm_layout* orders = orders_manager.open_orders(
+            make_orders_shm_name(cfg.shm.orders_shm_name, cfg.trading_day), shm_mode::Open, cfg.account_id, 0);
+        assert(upstream != nullptr && downstream != nullptr && orders != nullptr);
+
+        const InternalOrderId order_id = static_cast<InternalOrderId>(7001 + i);
+        OrderRequest req;
+        req.init_new("000001", InternalSecurityId("XSHE_000001"), order_id, TradeSide::Buy, Market::SZ,
+                     static_cast<Volume>(100), static_cast<DPrice>(1000), 93000000);
+        req.order_state.store(OrderState::UserSubmitted, std::memory_order_relaxed);
+        OrderIndex upstream_index = kInvalidOrderIndex;
+        assert(orders_shm_append(orders, req, OrderSlotState::UpstreamQueued, order_slot_source_t::User, now_ns(),
+                                 upstream_index));
+        assert(upstream->upstream_order_queue.try_push(upstream_index));
+
+        assert(wait_until([downstream]() { return downstream->order_queue.size() > 0; }));
+        assert(wait_until([&host, i, order_id]() { return host.account(i).orders().find_order(order_id) != nullptr; }));
+        assert(host.account(1 - i).orders().find_order(order_id) == nullptr);
+    }
+
+    host.stop();
+    runner.join();
+    assert(run_rc == 0);
+    for (std::size_t i = 0; i < kAccounts; ++i) {
+        assert(host.account(i).state() == ServiceState::Stopped);
+    }
+
+    for (std::size_t i = 0; i < kAccounts; ++i) {
+        const Config& cfg = configs[i];
+        (void)SHMManager::unlink(cfg.shm.upstream_shm_name);
+        (void)SHMManager::unlink(cfg.shm.downstream_shm_name);
+        (void)SHMManager::unlink(cfg.shm.trades_shm_name);
+        (void)SHMManager::unlink(make_orders_shm_name(cfg.shm.orders_shm_name, cfg.trading_day));
+        (void)SHMManager::unlink(cfg.shm.positions_shm_name);
+        (void)SHMManager::unlink(cfg.shm.stats_shm_name);
+        std::remove(config_paths[i].c_str());
+        std::remove(business_log_path(cfg).c_str());
+    }
+}
+
 int main() {
     printf("=== Account Service Test Suite ===\n\n");
 
     RUN_TEST(initialize_and_run_processes_orders);
+    RUN_TEST(startup_warmup_leaves_live_state_untouched);
     RUN_TEST(restart_recovers_downstream_active_orders);
     RUN_TEST(initialize_rejects_invalid_config);
     RUN_TEST(initialize_prints_loaded_config_to_stderr);
     RUN_TEST(position_loader_file_mode_only_on_fresh_shm);
     RUN_TEST(position_loader_db_mode_only_on_fresh_shm);
+    RUN_TEST(in_process_gateway_fills_orders_without_external_gateway);
+    RUN_TEST(plan_account_placement_dedicates_busy_accounts);
+    RUN_TEST(account_host_runs_accounts_on_shared_worker);
 
     printf("\n=== All tests passed! ===\n");
     return 0;
@@ -0,0 +1,46 @@
+#include <cstdint>
+
+#include "strategy/active_strategy.hpp"
+
+namespace {
+
+using namespace acct_service;
+
+// 测试用插件策略：信号达阈值时给出半片预算，名字固定为 half_budget 供加载时校验。
+class HalfBudgetStrategy final : public ActiveStrategy {
+public:
+    explicit HalfBudgetStrategy(double signal_threshold) : signal_threshold_(signal_threshold) {}
+
+    const char* name() const noexcept override { return "half_budget"; }
+
+    ActiveDecision evaluate(const ActiveStrategyContext& context) override {
+        ActiveDecision decision{};
+        if (context.market_data.prediction.signal < static_cast<float>(signal_threshold_)) {
+            return decision;
+        }
+        decision.should_submit = context.budget_volume > 1;
+        decision.volume = context.budget_volume / 2;
+        decision.price = context.parent_request.dprice_entrust;
+        return decision;
+    }
+
+    void evaluate_many(std::span<const ActiveStrategyContext> contexts,
+                       std::span<ActiveDecision> out_decisions) override {
+        for (std::size_t i = 0; i < contexts.size() && i < out_decisions.size(); ++i) {
+            out_decisions[i] = evaluate(contexts[i]);
+        }
+    }
+
+private:
+    double signal_threshold_ = 0.0;
+};
+
+}  // namespace
+
+extern "C" uint32_t acct_active_strategy_abi_version() noexcept { return kActiveStrategyAbiVersion; }
+
+extern "C" ActiveStrategy* acct_create_active_strategy(const ActiveStrategyConfig* config) noexcept {
+    return new HalfBudgetStrategy(config ? config->signal_threshold : 0.0);
+}
+
+extern "C" void acct_destroy_active_strategy(ActiveStrategy* strategy) noexcept { delete strategy; }
@@ -76,6 +76,8 @@ TEST(load_and_export_roundtrip) {
         out << "event_loop:\n";
         out << "  poll_batch_size: 32\n";
         out << "  idle_sleep_us: 10\n";
+        out << "  adaptive_idle: true\n";
+        out << "  idle_park_timeout_us: 250\n";
         out << "market_data:\n";
         out << "  enabled: true\n";
         out << "  snapshot_shm_name: \"/mdsnap_test\"\n";
@@ -83,6 +85,15 @@ TEST(load_and_export_roundtrip) {
         out << "split:\n";
         out << "  strategy: \"fixed_size\"\n";
         out << "  max_child_volume: 500\n";
+        out << "gateway:\n";
+        out << "  in_process: true\n";
+        out << "  config_file: \"config/gateway.dev.yaml\"\n";
+        out << "  inline_poll: true\n";
+        out << "replication:\n";
+        out << "  role: \"primary\"\n";
+        out << "  peer_host: \"10.0.0.2\"\n";
+        out << "  port: 9100\n";
+        out << "  batch_records: 32\n";
     }
 
     ConfigManager manager;
@@ -107,6 +118,16 @@ TEST(load_and_export_roundtrip) {
     assert(reloaded.shm().downstream_shm_name == "/d_test");
     assert(reloaded.shm().trades_shm_name == "/t_test");
     assert(reloaded.EventLoop().idle_sleep_us == 10);
+    assert(reloaded.EventLoop().adaptive_idle);
+    assert(reloaded.EventLoop().idle_park_timeout_us == 250);
+    assert(reloaded.gateway().in_process);
+    assert(reloaded.gateway().config_file == "config/gateway.dev.yaml");
+    assert(reloaded.gateway().inline_poll);
+    assert(reloaded.replication().role == ReplicationRole::Primary);
+    assert(reloaded.replication().peer_host == "10.0.0.2");
+    assert(reloaded.replication().port == 9100);
+    assert(reloaded.replication().batch_records == 32);
+    assert(reloaded.replication().bind_address == "0.0.0.0");
 
     std::remove(in_path.c_str());
     std::remove(out_path.c_str());
@@ -189,33 +210,69 @@ TEST(to_log_string_includes_all_sections) {
         out << "  orders_shm_name: \"/yaml_orders\"\n";
         out << "  positions_shm_name: \"/yaml_positions\"\n";
         out << "  create_if_not_exist: false\n";
+        out << "  huge_pages: true\n";
+        out << "  prefault: true\n";
+        out << "  hugetlb_arena: true\n";
+        out << "  numa_node: 1\n";
+        out << "  orders_capacity: 4096\n";
+        out << "  orders_overflow_segments: 2\n";
+        out << "  risk_params: true\n";
+        out << "  admin_channel: true\n";
+        out << "  downstream_inline_orders: true\n";
+        out << "  upstream_inline_orders: true\n";
+        out << "  next_trading_day: \"20260302\"\n";
         out << "event_loop:\n";
         out << "  busy_polling: false\n";
         out << "  poll_batch_size: 11\n";
         out << "  idle_sleep_us: 7\n";
         out << "  stats_interval_ms: 99\n";
+        out << "  response_preempt_batch: 8\n";
         out << "  archive_terminal_orders: true\n";
         out << "  terminal_archive_delay_ms: 1234\n";
         out << "  pin_cpu: true\n";
         out << "  cpu_core: 2\n";
+        out << "  fifo_priority: 40\n";
+        out << "  lock_memory: true\n";
+        out << "  warmup_orders: 256\n";
+        out << "  checkpoint_interval_ms: 500\n";
+        out << "  checkpoint_dir: \"/tmp/checkpoints\"\n";
+        out << "  flight_recorder_threshold_us: 50\n";
+        out << "  flight_recorder_context: 8\n";
+        out << "  mark_to_market_interval_ms: 250\n";
+        out << "  adaptive_batching: true\n";
+        out << "  iteration_budget_us: 40\n";
+        out << "  response_share_pct: 30\n";
+        out << "  queue_depth_sample_iterations: 16\n";
+        out << "  admin_poll_iterations: 32\n";
         out << "market_data:\n";
         out << "  enabled: true\n";
         out << "  snapshot_shm_name: \"/yaml_snapshot\"\n";
+        out << "  sz_snapshot_shm_name: \"/yaml_snapshot_sz\"\n";
         out << "  allow_order_price_fallback: true\n";
         out << "active_strategy:\n";
         out << "  enabled: true\n";
         out << "  name: \"mean_revert\"\n";
         out << "  signal_threshold: 1.25\n";
+        out << "  plugin_path: \"/opt/strategies/mean_revert.so\"\n";
         out << "risk:\n";
         out << "  max_order_value: 1001\n";
         out << "  max_order_volume: 1002\n";
         out << "  max_daily_turnover: 1003\n";
         out << "  max_orders_per_second: 1004\n";
+        out << "  max_orders_per_second_per_strategy: 1006\n";
+        out << "  max_orders_per_second_per_security: 1007\n";
+        out << "  rate_limit_burst_ms: 1008\n";
         out << "  enable_price_limit_check: false\n";
         out << "  enable_duplicate_check: false\n";
         out << "  enable_fund_check: false\n";
         out << "  enable_position_check: false\n";
+        out << "  enable_self_trade_check: true\n";
+        out << "  max_order_to_trade_ratio: 20\n";
+        out << "  max_cancel_ratio_pct: 60\n";
+        out << "  order_ratio_min_orders: 500\n";
         out << "  duplicate_window_ns: 1005\n";
+        out << "  profile_rules: true\n";
+        out << "  rule_reorder_interval: 4096\n";
         out << "split:\n";
         out << "  strategy: \"twap\"\n";
         out << "  max_child_volume: 2001\n";
@@ -223,6 +280,13 @@ TEST(to_log_string_includes_all_sections) {
         out << "  max_child_count: 2\n";
         out << "  interval_ms: 2003\n";
         out << "  randomize_factor: 0.5\n";
+        out << "  max_sessions: 2004\n";
+        out << "  eval_workers: 2\n";
+        out << "  child_risk_check: true\n";
+        out << "  child_max_order_volume: 2005\n";
+        out << "  child_max_order_value: 2006\n";
+        out << "  coroutine_sessions: true\n";
+        out << "  vwap_profile_path: \"/tmp/vwap.profile\"\n";
         out << "log:\n";
         out << "  log_dir: \"/tmp/config_mgr_logs\"\n";
         out << "  log_level: \"debug\"\n";
@@ -233,10 +297,17 @@ TEST(to_log_string_includes_all_sections) {
         out << "  output_dir: \"/tmp/business_logs\"\n";
         out << "  queue_capacity: 1024\n";
         out << "  flush_interval_ms: 25\n";
+        out << "  binary_journal: true\n";
+        out << "  journal_segment_records: 4096\n";
+        out << "  delta_records: true\n";
+        out << "  writer_cpu_core: 5\n";
+        out << "  writer_priority: 10\n";
         out << "db:\n";
         out << "  db_path: \"/tmp/config_mgr.sqlite\"\n";
         out << "  enable_persistence: false\n";
         out << "  sync_interval_ms: 600\n";
+        out << "  position_snapshot_path: \"/tmp/positions.snap\"\n";
+        out << "  trade_store_dir: \"/tmp/trade_store\"\n";
     }
 
     ConfigManager manager;
@@ -247,15 +318,59 @@ TEST(to_log_string_includes_all_sections) {
     assert(log_text.find("[config] [root] account_id=19") != std::string::npos);
     assert(log_text.find("[config] [root] trading_day=20260301") != std::string::npos);
     assert(log_text.find("[config] [shm] upstream_shm_name=/yaml_upstream") != std::string::npos);
+    assert(log_text.find("[config] [shm] huge_pages=true") != std::string::npos);
+    assert(log_text.find("[config] [shm] hugetlb_arena=true") != std::string::npos);
+    assert(log_text.find("[config] [shm] numa_node=1") != std::string::npos);
+    assert(log_text.find("[config] [shm] orders_capacity=4096") != std::string::npos);
+    assert(log_text.find("[config] [shm] orders_overflow_segments=2") != std::string::npos);
+    assert(log_text.find("[config] [shm] risk_params=true") != std::string::npos);
+    assert(log_text.find("[config] [shm] admin_channel=true") != std::string::npos);
+    assert(log_text.find("[config] [shm] downstream_inline_orders=true") != std::string::npos);
+    assert(log_text.find("[config] [shm] upstream_inline_orders=true") != std::string::npos);
+    assert(log_text.find("[config] [shm] next_trading_day=20260302") != std::string::npos);
     assert(log_text.find("[config] [event_loop] archive_terminal_orders=true") != std::string::npos);
+    assert(log_text.find("[config] [event_loop] warmup_orders=256") != std::string::npos);
+    assert(log_text.find("[config] [event_loop] checkpoint_interval_ms=500") != std::string::npos);
+    assert(log_text.find("[config] [event_loop] mark_to_market_interval_ms=250") != std::string::npos);
+    assert(log_text.find("[config] [event_loop] adaptive_batching=true") != std::string::npos);
+    assert(log_text.find("[config] [event_loop] iteration_budget_us=40") != std::string::npos);
+    assert(log_text.find("[config] [event_loop] response_share_pct=30") != std::string::npos);
+    assert(log_text.find("[config] [event_loop] queue_depth_sample_iterations=16") != std::string::npos);
+    assert(log_text.find("[config] [event_loop] admin_poll_iterations=32") != std::string::npos);
+    assert(log_text.find("[config] [event_loop] checkpoint_dir=/tmp/checkpoints") != std::string::npos);
+    assert(log_text.find("[config] [event_loop] flight_recorder_threshold_us=50") != std::string::npos);
+    assert(log_text.find("[config] [event_loop] flight_recorder_context=8") != std::string::npos);
     assert(log_text.find("[config] [market_data] snapshot_shm_name=/yaml_snapshot") != std::string::npos);
+    assert(log_text.find("[config] [market_data] sz_snapshot_shm_name=/yaml_snapshot_sz") != std::string::npos);
     assert(log_text.find("[config] [market_data] allow_order_price_fallback=true") != std::string::npos);
     assert(log_text.find("[config] [active_strategy] name=mean_revert") != std::string::npos);
+    assert(log_text.find("[config] [active_strategy] plugin_path=/opt/strategies/mean_revert.so") != std::string::npos);
     assert(log_text.find("[config] [risk] duplicate_window_ns=1005") != std::string::npos);
+    assert(log_text.find("[config] [risk] max_orders_per_second_per_strategy=1006") != std::string::npos);
+    assert(log_text.find("[config] [risk] rate_limit_burst_ms=1008") != std::string::npos);
+    assert(log_text.find("[config] [risk] profile_rules=true") != std::string::npos);
+    assert(log_text.find("[config] [risk] rule_reorder_interval=4096") != std::string::npos);
+    assert(log_text.find("[config] [risk] max_order_to_trade_ratio=20") != std::string::npos);
+    assert(log_text.find("[config] [risk] max_cancel_ratio_pct=60") != std::string::npos);
+    assert(log_text.find("[config] [risk] order_ratio_min_orders=500") != std::string::npos);
     assert(log_text.find("[config] [split] strategy=twap") != std::string::npos);
+    assert(log_text.find("[config] [split] vwap_profile_path=/tmp/vwap.profile") != std::string::npos);
+    assert(log_text.find("[config] [split] child_risk_check=true") != std::string::npos);
+    assert(log_text.find("[config] [split] child_max_order_volume=2005") != std::string::npos);
+    assert(log_text.find("[config] [split] child_max_order_value=2006") != std::string::npos);
+    assert(log_text.find("[config] [split] coroutine_sessions=true") != std::string::npos);
     assert(log_text.find("[config] [log] log_level=debug") != std::string::npos);
     assert(log_text.find("[config] [business_log] output_dir=/tmp/business_logs") != std::string::npos);
+    assert(log_text.find("[config] [business_log] journal_segment_records=4096") != std::string::npos);
+    assert(log_text.find("[config] [business_log] delta_records=true") != std::string::npos);
+    assert(log_text.find("[config] [business_log] writer_cpu_core=5") != std::string::npos);
+    assert(log_text.find("[config] [business_log] writer_priority=10") != std::string::npos);
+    assert(log_text.find("[config] [event_loop] fifo_priority=40") != std::string::npos);
+    assert(log_text.find("[config] [event_loop] response_preempt_batch=8") != std::string::npos);
+    assert(log_text.find("[config] [event_loop] lock_memory=true") != std::string::npos);
     assert(log_text.find("[config] [db] db_path=/tmp/config_mgr.sqlite") != std::string::npos);
+    assert(log_text.find("[config] [db] position_snapshot_path=/tmp/positions.snap") != std::string::npos);
+    assert(log_text.find("[config] [db] trade_store_dir=/tmp/trade_store") != std::string::npos);
 
     std::remove(in_path.c_str());
 }
@@ -270,22 +385,46 @@ TEST(bundled_account_configs_cover_all_keys) {
 
         const YAML::Node event_loop = root["event_loop"] ? root["event_loop"] : root["EventLoop"];
         assert_yaml_map_has_keys(root["shm"], {"upstream_shm_name", "downstream_shm_name", "trades_shm_name",
-                                               "orders_shm_name", "positions_shm_name", "create_if_not_exist"});
+                                               "orders_shm_name", "positions_shm_name", "stats_shm_name",
+                                               "create_if_not_exist", "upstream_lane_count", "huge_pages",
+                                               "prefault", "hugetlb_arena", "numa_node", "orders_capacity",
+                                               "orders_overflow_segments", "risk_params", "admin_channel",
+                                               "downstream_inline_orders", "upstream_inline_orders",
+                                               "next_trading_day"});
         assert_yaml_map_has_keys(event_loop,
-                                 {"busy_polling", "poll_batch_size", "idle_sleep_us", "stats_interval_ms",
-                                  "archive_terminal_orders", "terminal_archive_delay_ms", "pin_cpu", "cpu_core"});
-        assert_yaml_map_has_keys(root["market_data"], {"enabled", "snapshot_shm_name", "allow_order_price_fallback"});
-        assert_yaml_map_has_keys(root["active_strategy"], {"enabled", "name", "signal_threshold"});
+                                 {"busy_polling", "poll_batch_size", "idle_sleep_us", "adaptive_idle",
+                                  "idle_spin_iterations", "idle_yield_iterations", "idle_park_timeout_us",
+                                  "stats_interval_ms", "response_preempt_batch", "archive_terminal_orders",
+                                  "terminal_archive_delay_ms",
+                                  "pin_cpu", "cpu_core", "fifo_priority", "lock_memory", "warmup_orders",
+                                  "checkpoint_interval_ms",
+                                  "checkpoint_dir", "flight_recorder_threshold_us", "flight_recorder_context",
+                                  "mark_to_market_interval_ms", "adaptive_batching", "iteration_budget_us",
+                                  "response_share_pct", "queue_depth_sample_iterations", "admin_poll_iterations"});
+        assert_yaml_map_has_keys(root["market_data"], {"enabled", "snapshot_shm_name", "sz_snapshot_shm_name",
+                                                       "sh_snapshot_shm_name", "allow_order_price_fallback"});
+        assert_yaml_map_has_keys(root["active_strategy"], {"enabled", "name", "signal_threshold", "plugin_path"});
         assert_yaml_map_has_keys(root["risk"],
                                  {"max_order_value", "max_order_volume", "max_daily_turnover", "max_orders_per_second",
-                                  "enable_price_limit_check", "enable_duplicate_check", "enable_fund_check",
-                                  "enable_position_check", "duplicate_window_ns"});
+                                  "max_orders_per_second_per_strategy", "max_orders_per_second_per_security",
+                                  "rate_limit_burst_ms", "enable_price_limit_check", "enable_duplicate_check",
+                                  "enable_fund_check", "enable_position_check", "enable_self_trade_check",
+                                  "max_order_to_trade_ratio", "max_cancel_ratio_pct", "order_ratio_min_orders",
+                                  "duplicate_window_ns", "profile_rules", "rule_reorder_interval"});
         assert_yaml_map_has_keys(root["split"], {"strategy", "max_child_volume", "min_child_volume", "max_child_count",
-                                                 "interval_ms", "randomize_factor"});
+                                                 "interval_ms", "randomize_factor", "max_sessions", "eval_workers",
+                                                 "child_risk_check", "child_max_order_volume",
+                                                 "child_max_order_value", "coroutine_sessions",
+                                                 "vwap_profile_path"});
         assert_yaml_map_has_keys(root["log"], {"log_dir", "log_level", "async_logging", "async_queue_size"});
         assert_yaml_map_has_keys(root["business_log"],
-                                 {"enabled", "output_dir", "queue_capacity", "flush_interval_ms"});
-        assert_yaml_map_has_keys(root["db"], {"db_path", "enable_persistence", "sync_interval_ms"});
+                                 {"enabled", "output_dir", "queue_capacity", "flush_interval_ms", "binary_journal",
+                                  "journal_segment_records", "delta_records", "writer_cpu_core", "writer_priority"});
+        assert_yaml_map_has_keys(root["db"], {"db_path", "enable_persistence", "sync_interval_ms",
+                                              "position_snapshot_path", "trade_store_dir"});
+        assert_yaml_map_has_keys(root["gateway"], {"in_process", "config_file", "inline_poll"});
+        assert_yaml_map_has_keys(root["replication"],
+                                 {"role", "peer_host", "bind_address", "port", "batch_records", "cpu_core"});
     }
 }
 
@@ -317,6 +456,27 @@ TEST(parse_command_line_and_validate) {
     assert(manager.get().trading_day == "20260225");
     assert(manager.validate());
 
+    manager.get().EventLoop.fifo_priority = 100;
+    assert(!manager.validate());
+    manager.get().EventLoop.fifo_priority = 0;
+    manager.get().business_log.writer_priority = -1;
+    assert(!manager.validate());
+    manager.get().business_log.writer_priority = 0;
+    assert(manager.validate());
+
+    manager.get().replication.role = ReplicationRole::Primary;
+    assert(!manager.validate());
+    manager.get().replication.port = 9100;
+    assert(!manager.validate());
+    manager.get().replication.peer_host = "standby-host";
+    assert(manager.validate());
+    manager.get().replication.role = ReplicationRole::Standby;
+    manager.get().gateway.in_process = true;
+    assert(!manager.validate());
+    manager.get().gateway.in_process = false;
+    assert(manager.validate());
+    manager.get().replication.role = ReplicationRole::None;
+
     manager.get().account_id = 0;
     assert(!manager.validate());
 }
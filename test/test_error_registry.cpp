@@ -53,11 +53,77 @@ TEST(concurrent_recording) {
     assert(!global_error_registry().recent_errors().empty());
 }
 
+TEST(compact_event_path) {
+    global_error_registry().reset();
+    clear_last_error();
+
+    uint32_t site_id = 0;
+    for (int i = 0; i < 3; ++i) {
+        const error_event event = ACCT_RECORD_ERROR_EVENT(
+            ErrorDomain::order, ErrorCode::OrderNotFound, "test", "stale trade response", 7);
+        // 同一调用点只登记一次站点
+        assert(site_id == 0 || event.site_id == site_id);
+        site_id = event.site_id;
+    }
+    assert(site_id != 0);
+    const error_site* site = find_error_site(site_id);
+    assert(site != nullptr && site->message == "stale trade response" && site->module == "test");
+
+    assert(global_error_registry().count(ErrorCode::OrderNotFound) == 3);
+    assert(last_error().code == ErrorCode::OrderNotFound);
+    assert(last_error().message.view() == "stale trade response");
+    assert(last_error().sys_errno == 7);
+    assert(latest_error().message.view() == "stale trade response");
+
+    const std::vector<error_event> events = global_error_registry().recent_events();
+    assert(events.size() == 3);
+    assert(events.back().site_id == site_id && events.back().domain == ErrorDomain::order);
+
+    // 动态消息仍走完整状态，最新错误随之切换
+    record_error(ACCT_MAKE_ERROR(ErrorDomain::core, ErrorCode::RouteFailed, "test", std::string_view("dynamic"), 0));
+    assert(latest_error().code == ErrorCode::RouteFailed);
+    assert(latest_error().message.view() == "dynamic");
+    assert(last_error().message.view() == "dynamic");
+
+    global_error_registry().reset();
+    assert(global_error_registry().count(ErrorCode::OrderNotFound) == 0);
+    assert(global_error_registry().recent_events().empty());
+}
+
+TEST(concurrent_event_counters) {
+    global_error_registry().reset();
+
+    constexpr int kThreads = 4;
+    constexpr int kPerThread = 10000;
+    std::vector<std::thread> workers;
+    workers.reserve(kThreads);
+    for (int i = 0; i < kThreads; ++i) {
+        workers.emplace_back([]() {
+            for (int j = 0; j < kPerThread; ++j) {
+                (void)ACCT_RECORD_ERROR_EVENT(ErrorDomain::order, ErrorCode::QueueFull, "test", "queue full", 0);
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    // 每线程计数读时汇总；环只保留最近 kHistoryCapacity 条
+    assert(global_error_registry().count(ErrorCode::QueueFull) == static_cast<uint64_t>(kThreads * kPerThread));
+    const std::vector<error_event> events = global_error_registry().recent_events();
+    assert(!events.empty() && events.size() <= ErrorRegistry::kHistoryCapacity);
+    for (const error_event& event : events) {
+        assert(event.code == ErrorCode::QueueFull);
+    }
+}
+
 int main() {
     printf("=== Error Registry Test Suite ===\n\n");
 
     RUN_TEST(record_and_count);
     RUN_TEST(concurrent_recording);
+    RUN_TEST(compact_event_path);
+    RUN_TEST(concurrent_event_counters);
 
     printf("\n=== All tests passed! ===\n");
     return 0;
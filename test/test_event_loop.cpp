@@ -1,18 +1,28 @@
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
 #include <cassert>
 #include <chrono>
 #include <cstdio>
 #include <cstring>
 #include <functional>
 #include <memory>
+#include <string>
 #include <thread>
+#include <vector>
 
+#include "common/alloc_guard.hpp"
 #include "common/constants.hpp"
 #include "core/event_loop.hpp"
 #include "order/order_router.hpp"
 #include "portfolio/account_info.hpp"
 #include "portfolio/position_manager.hpp"
 #include "risk/risk_manager.hpp"
+#include "shm/admin_shm.hpp"
 #include "shm/orders_shm.hpp"
+#include "shm/upstream_lanes.hpp"
 
 #define TEST(name) static void test_##name()
 #define RUN_TEST(name)                   \
@@ -26,12 +36,19 @@ namespace {
 
 using namespace acct_service;
 
+// 按 trades_shm 队列的紧凑编码写入一条回报。
+bool push_trade_response(trades_shm_layout& trades, const TradeResponse& response) {
+    trade_response_message message;
+    pack_trade_response_message(response, message);
+    return trades.response_queue.try_push(message);
+}
+
 void init_header(SHMHeader& header) {
     header.magic = SHMHeader::kMagic;
     header.version = SHMHeader::kVersion;
     header.create_time = now_ns();
     header.last_update = header.create_time;
-    header.next_order_id.store(1, std::memory_order_relaxed);
+    header.next_id_epoch.store(1, std::memory_order_relaxed);
 }
 
 std::unique_ptr<upstream_shm_layout> make_upstream_shm() {
@@ -105,6 +122,17 @@ OrderRequest make_order(InternalOrderId order_id, Volume volume) {
     return req;
 }
 
+uint64_t metric_value(const metrics_table& table, const char* name) {
+    const uint32_t count = table.slot_count.load(std::memory_order_acquire);
+    for (uint32_t i = 0; i < count; ++i) {
+        if (std::strcmp(table.slots[i].name, name) == 0) {
+            return table.slots[i].value.load(std::memory_order_relaxed);
+        }
+    }
+    assert(false && "metric not registered");
+    return 0;
+}
+
 }  // namespace
 
 TEST(process_order_and_trade_response) {
@@ -147,10 +175,21 @@ TEST(process_order_and_trade_response) {
     OrderIndex order_index = kInvalidOrderIndex;
     assert(orders_shm_append(orders_shm.get(), req, OrderSlotState::UpstreamQueued, order_slot_source_t::User,
                              now_ns(), order_index));
+    orders_shm_mark_submit(orders_shm.get(), order_index, now_monotonic_ns());
     assert(upstream->upstream_order_queue.try_push(order_index));
 
     assert(wait_until([&downstream]() { return downstream->order_queue.size() > 0; }));
 
+    order_slot_latency latency;
+    assert(orders_shm_read_latency(orders_shm.get(), order_index, latency));
+    const auto hop_delta = [&latency](OrderLatencyHop hop) {
+        return latency.hop_delta_ns[static_cast<std::size_t>(hop)];
+    };
+    assert(hop_delta(OrderLatencyHop::UpstreamDequeued) != 0);
+    assert(hop_delta(OrderLatencyHop::RiskAccepted) >= hop_delta(OrderLatencyHop::UpstreamDequeued));
+    assert(hop_delta(OrderLatencyHop::DownstreamQueued) >= hop_delta(OrderLatencyHop::RiskAccepted));
+    assert(hop_delta(OrderLatencyHop::GatewayDequeued) == 0);
+
     OrderIndex downstream_index = kInvalidOrderIndex;
     assert(downstream->order_queue.try_pop(downstream_index));
     order_slot_snapshot sent_snapshot;
@@ -170,7 +209,7 @@ TEST(process_order_and_trade_response) {
     rsp.md_time_traded = 93100000;
     rsp.recv_time_ns = now_ns();
 
-    assert(trades->response_queue.try_push(rsp));
+    assert(push_trade_response(*trades, rsp));
 
     assert(wait_until([&book, order_id]() {
         const OrderEntry* order = book->find_order(order_id);
@@ -196,11 +235,26 @@ TEST(process_order_and_trade_response) {
 
     assert(wait_until([&loop]() { return loop.stats().responses_processed >= 1; }));
 
+    // 乱序到达的柜台确认不回退已报交易所的状态
+    TradeResponse late_ack{};
+    late_ack.internal_order_id = order_id;
+    late_ack.new_state = OrderState::BrokerAccepted;
+    late_ack.recv_time_ns = now_ns();
+    assert(push_trade_response(*trades, late_ack));
+    assert(wait_until([&loop]() { return loop.stats().stale_responses >= 1; }));
+    assert(book->find_order(order_id)->request.order_state.load(std::memory_order_acquire) ==
+           OrderState::MarketAccepted);
+
     loop.stop();
     worker.join();
 
     assert(loop.stats().orders_processed >= 1);
     assert(loop.stats().responses_processed >= 1);
+
+    const stage_latency_stats& stages = loop.stage_latency();
+    assert(stages.upstream_to_risk.count.load() >= 1);
+    assert(stages.risk_to_downstream.count.load() >= 1);
+    assert(stages.response_to_settle.count.load() >= 1);
 }
 
 TEST(delay_archive_allows_late_terminal_trade) {
@@ -257,7 +311,7 @@ TEST(delay_archive_allows_late_terminal_trade) {
     first_terminal.trade_side = TradeSide::Buy;
     first_terminal.new_state = OrderState::Finished;
     first_terminal.recv_time_ns = now_ns();
-    assert(trades->response_queue.try_push(first_terminal));
+    assert(push_trade_response(*trades, first_terminal));
 
     assert(wait_until([&book, order_id]() {
         const OrderEntry* order = book->find_order(order_id);
@@ -277,7 +331,7 @@ TEST(delay_archive_allows_late_terminal_trade) {
     late_trade.dfee = 8;
     late_trade.md_time_traded = 93100000;
     late_trade.recv_time_ns = now_ns();
-    assert(trades->response_queue.try_push(late_trade));
+    assert(push_trade_response(*trades, late_trade));
 
     assert(wait_until([&book, order_id]() {
         const OrderEntry* order = book->find_order(order_id);
@@ -285,11 +339,36 @@ TEST(delay_archive_allows_late_terminal_trade) {
     }));
 
     assert(wait_until([&book, order_id]() { return book->find_order(order_id) == nullptr; }, 1500));
+    OrderIndex archived_index = kInvalidOrderIndex;
+    assert(book->find_archived(order_id, archived_index));
+    assert(archived_index == order_index);
+
+    // 归档后的迟到回报经归档索引分流：状态回报只计数，成交只累计到 orders_shm 镜像，均不计入错误
+    const uint64_t not_found_before = global_error_registry().count(ErrorCode::OrderNotFound);
+    TradeResponse archived_status{};
+    archived_status.internal_order_id = order_id;
+    archived_status.new_state = OrderState::Finished;
+    archived_status.recv_time_ns = now_ns();
+    assert(push_trade_response(*trades, archived_status));
+    TradeResponse archived_fill = late_trade;
+    archived_fill.volume_traded = 10;
+    archived_fill.dvalue_traded = 10000;
+    archived_fill.dfee = 2;
+    assert(push_trade_response(*trades, archived_fill));
+    assert(wait_until([&loop]() { return loop.stats().archived_responses >= 2; }));
 
     loop.stop();
     worker.join();
 
-    assert(loop.stats().responses_processed >= 2);
+    assert(loop.stats().responses_processed >= 4);
+    assert(loop.stats().archived_trades == 1);
+    assert(global_error_registry().count(ErrorCode::OrderNotFound) == not_found_before);
+    assert(book->find_order(order_id) == nullptr);
+    const OrderSlot* slot = orders_shm_find_slot(orders_shm.get(), order_index);
+    assert(slot != nullptr);
+    assert(slot->request.volume_traded == 50);
+    assert(slot->request.dvalue_traded == 50000);
+    assert(slot->request.dfee_executed == 10);
 }
 
 TEST(reject_second_buy_after_fund_reservation) {
@@ -369,12 +448,1865 @@ TEST(reject_second_buy_after_fund_reservation) {
     worker.join();
 }
 
+TEST(publish_config_hot_reloads_risk_limits) {
+    auto upstream = make_upstream_shm();
+    auto downstream = make_downstream_shm();
+    auto trades = make_trades_shm();
+    auto orders_shm = make_orders_shm();
+    auto positions_shm = make_positions_shm();
+
+    PositionManager positions(positions_shm.get());
+    assert(positions.initialize(1));
+
+    RiskConfig risk_cfg;
+    risk_cfg.enable_position_check = false;
+    risk_cfg.enable_price_limit_check = false;
+    risk_cfg.enable_duplicate_check = false;
+    risk_cfg.max_order_volume = 0;
+    risk_cfg.max_order_value = 0;
+    risk_cfg.max_orders_per_second = 0;
+    RiskManager risk(positions, risk_cfg);
+
+    auto book = std::make_unique<OrderBook>();
+    order_router router(*book, downstream.get(), orders_shm.get(), upstream.get());
+
+    EventLoopConfig loop_cfg;
+    loop_cfg.busy_polling = false;
+    loop_cfg.idle_sleep_us = 50;
+    loop_cfg.poll_batch_size = 32;
+    loop_cfg.stats_interval_ms = 0;
+    EventLoop loop(loop_cfg, upstream.get(), downstream.get(), trades.get(), orders_shm.get(), *book, router, positions,
+                   risk, nullptr, nullptr, nullptr);
+
+    std::thread worker([&loop]() { loop.run(); });
+
+    OrderRequest before = make_order(900, 50);
+    OrderIndex before_index = kInvalidOrderIndex;
+    assert(orders_shm_append(orders_shm.get(), before, OrderSlotState::UpstreamQueued, order_slot_source_t::User,
+                             now_ns(), before_index));
+    assert(upstream->upstream_order_queue.try_push(before_index));
+    assert(wait_until([&book]() {
+        const OrderEntry* entry = book->find_order(900);
+        return entry != nullptr &&
+               entry->request.order_state.load(std::memory_order_acquire) == OrderState::TraderSubmitted;
+    }));
+
+    // 收紧单笔数量上限后热更新，循环线程下一轮生效
+    RiskConfig tightened = risk_cfg;
+    tightened.max_order_volume = 10;
+    assert(loop.publish_config(loop_cfg, tightened));
+    assert(wait_until([&loop]() { return loop.stats().config_reloads == 1; }));
+
+    OrderRequest after = make_order(901, 50);
+    OrderIndex after_index = kInvalidOrderIndex;
+    assert(orders_shm_append(orders_shm.get(), after, OrderSlotState::UpstreamQueued, order_slot_source_t::User,
+                             now_ns(), after_index));
+    assert(upstream->upstream_order_queue.try_push(after_index));
+    assert(wait_until([&book]() {
+        const OrderEntry* entry = book->find_order(901);
+        return entry != nullptr &&
+               entry->request.order_state.load(std::memory_order_acquire) == OrderState::RiskControllerRejected;
+    }));
+    assert(risk.config().max_order_volume == 10);
+
+    loop.stop();
+    worker.join();
+}
+
+TEST(metrics_table_exports_loop_counters) {
+    // 同名复用槽位，表满返回未绑定句柄
+    auto table = std::make_unique<metrics_table>();
+    metrics_registry registry(table.get());
+    metric_counter first = registry.add("test.counter");
+    metric_counter again = registry.add("test.counter");
+    first.add();
+    again.add(2);
+    assert(table->slot_count.load() == 1);
+    assert(metric_value(*table, "test.counter") == 3);
+    for (std::size_t i = 1; i < kMetricSlotCount; ++i) {
+        assert(registry.add("test.fill_" + std::to_string(i)));
+    }
+    metric_counter overflow = registry.add("test.overflow");
+    assert(!overflow);
+    overflow.add();
+
+    auto upstream = make_upstream_shm();
+    auto downstream = make_downstream_shm();
+    auto trades = make_trades_shm();
+    auto orders_shm = make_orders_shm();
+    auto positions_shm = make_positions_shm();
+    auto stats_shm = std::make_unique<stats_shm_layout>();
+    init_header(stats_shm->header);
+
+    PositionManager positions(positions_shm.get());
+    assert(positions.initialize(1));
+
+    RiskConfig risk_cfg;
+    risk_cfg.enable_position_check = false;
+    risk_cfg.enable_price_limit_check = false;
+    risk_cfg.enable_duplicate_check = false;
+    risk_cfg.max_order_volume = 0;
+    risk_cfg.max_order_value = 0;
+    risk_cfg.max_orders_per_second = 0;
+    RiskManager risk(positions, risk_cfg, risk_check_hook{}, &stats_shm->risk);
+
+    auto book = std::make_unique<OrderBook>();
+    order_router router(*book, downstream.get(), orders_shm.get(), upstream.get());
+
+    EventLoopConfig loop_cfg;
+    loop_cfg.poll_batch_size = 8;
+    loop_cfg.stats_interval_ms = 0;
+    loop_cfg.queue_depth_sample_iterations = 1;
+    EventLoop loop(loop_cfg, upstream.get(), downstream.get(), trades.get(), orders_shm.get(), *book, router, positions,
+                   risk, nullptr, nullptr, nullptr, stats_shm.get());
+    assert(stats_shm->metrics.slot_count.load() > 0);
+
+    OrderRequest req = make_order(960, 1);
+    OrderIndex index = kInvalidOrderIndex;
+    assert(orders_shm_append(orders_shm.get(), req, OrderSlotState::UpstreamQueued, order_slot_source_t::User, 1,
+                             index));
+    assert(upstream->lane(0).try_push(index));
+
+    assert(loop.start());
+    assert(loop.run_once() == 1);
+
+    // 下游无人消费，路由出去的订单停在队列里
+    const metrics_table& metrics = stats_shm->metrics;
+    assert(metric_value(metrics, "loop.orders_processed") == 1);
+    assert(metric_value(metrics, "router.orders_sent") == 1);
+    assert(metric_value(metrics, "queue.upstream_depth") == 0);
+    assert(metric_value(metrics, "queue.downstream_depth") == 1);
+    assert(metric_value(metrics, "order_book.active_orders") == 1);
+    assert(stats_shm->risk.passed.load() == 1);
+
+    // 出队前采样：上游看到 1 笔积压，回报队列为空；下游由网关采样，事件循环不写
+    const queue_depth_stats& depths = stats_shm->queues;
+    assert(depths[shm_queue_id::UpstreamOrders].samples.load() == 1);
+    assert(depths[shm_queue_id::UpstreamOrders].high_watermark.load() == 1);
+    assert(depths[shm_queue_id::UpstreamOrders].capacity.load() == kUpstreamOrderQueueCapacity);
+    assert(depths[shm_queue_id::Responses].samples.load() == 1);
+    assert(depths[shm_queue_id::Responses].buckets[0].load() == 1);
+    assert(depths[shm_queue_id::DownstreamOrders].samples.load() == 0);
+    (void)loop.run_once();
+    assert(depths[shm_queue_id::UpstreamOrders].samples.load() == 2);
+    assert(depths[shm_queue_id::UpstreamOrders].last_depth.load() == 0);
+    assert(depths[shm_queue_id::UpstreamOrders].high_watermark.load() == 1);
+    loop.finish();
+}
+
+TEST(flight_recorder_dumps_window_around_outlier) {
+    const std::string path = "/tmp/acct_flight_recorder_test_" + std::to_string(::getpid()) + ".log";
+    std::remove(path.c_str());
+
+    // 直接驱动记录仪：第 5 轮超阈值，转储第 3..7 轮；窗口收集期间的第 6 轮不再单独触发
+    {
+        iteration_flight_recorder recorder;
+        assert(recorder.start(path, 1000, 2));
+        for (uint64_t i = 0; i < 10; ++i) {
+            iteration_record& record = recorder.begin();
+            record.orders = static_cast<uint32_t>(i);
+            record.work_ns = (i == 5 || i == 6) ? 5000 : 10;
+            record.phase_ns[static_cast<std::size_t>(iteration_phase::Archives)] = (i == 5) ? 4000 : 0;
+            recorder.commit();
+        }
+        assert(recorder.outlier_count() == 1);
+        assert(wait_until([&recorder]() { return recorder.dumped_count() == 1; }));
+        recorder.stop();
+    }
+
+    std::FILE* file = std::fopen(path.c_str(), "r");
+    assert(file != nullptr);
+    std::vector<std::string> lines;
+    char buffer[1024];
+    while (std::fgets(buffer, sizeof(buffer), file) != nullptr) {
+        lines.emplace_back(buffer);
+    }
+    std::fclose(file);
+    assert(lines.size() == 6);
+    assert(lines[0].find("dump trigger_iteration=5 threshold_ns=1000 iterations=5") == 0);
+    assert(lines[1].find("iteration=3 outlier=0") == 0);
+    assert(lines[3].find("iteration=5 outlier=1") == 0);
+    assert(lines[3].find("archives_ns=4000") != std::string::npos);
+    assert(lines[5].find("iteration=7 outlier=0") == 0);
+    std::remove(path.c_str());
+
+    // 挂到事件循环上：每轮都超阈值，记录分阶段工作量
+    auto upstream = make_upstream_shm();
+    auto downstream = make_downstream_shm();
+    auto trades = make_trades_shm();
+    auto orders_shm = make_orders_shm();
+    auto positions_shm = make_positions_shm();
+
+    PositionManager positions(positions_shm.get());
+    assert(positions.initialize(1));
+
+    RiskConfig risk_cfg;
+    risk_cfg.enable_position_check = false;
+    risk_cfg.enable_price_limit_check = false;
+    risk_cfg.enable_duplicate_check = false;
+    risk_cfg.max_order_volume = 0;
+    risk_cfg.max_order_value = 0;
+    risk_cfg.max_orders_per_second = 0;
+    RiskManager risk(positions, risk_cfg);
+
+    auto book = std::make_unique<OrderBook>();
+    order_router router(*book, downstream.get(), orders_shm.get(), upstream.get());
+
+    EventLoopConfig loop_cfg;
+    loop_cfg.poll_batch_size = 8;
+    loop_cfg.stats_interval_ms = 0;
+    EventLoop loop(loop_cfg, upstream.get(), downstream.get(), trades.get(), orders_shm.get(), *book, router, positions,
+                   risk, nullptr, nullptr, nullptr);
+    iteration_flight_recorder recorder;
+    assert(recorder.start(path, 1, 0));
+    loop.set_flight_recorder(&recorder);
+
+    OrderRequest req = make_order(970, 1);
+    OrderIndex index = kInvalidOrderIndex;
+    assert(orders_shm_append(orders_shm.get(), req, OrderSlotState::UpstreamQueued, order_slot_source_t::User, 1,
+                             index));
+    assert(upstream->lane(0).try_push(index));
+    assert(loop.start());
+    assert(loop.run_once() == 1);
+    assert(recorder.outlier_count() == 1);
+    assert(wait_until([&recorder]() { return recorder.dumped_count() == 1; }));
+    loop.finish();
+    recorder.stop();
+
+    file = std::fopen(path.c_str(), "r");
+    assert(file != nullptr);
+    assert(std::fgets(buffer, sizeof(buffer), file) != nullptr);
+    assert(std::fgets(buffer, sizeof(buffer), file) != nullptr);
+    std::fclose(file);
+    assert(std::string(buffer).find("iteration=0 outlier=1") == 0);
+    assert(std::string(buffer).find(" orders=1 ") != std::string::npos);
+    std::remove(path.c_str());
+}
+
+TEST(steady_state_order_cycle_does_not_allocate) {
+    auto upstream = make_upstream_shm();
+    auto downstream = make_downstream_shm();
+    auto trades = make_trades_shm();
+    auto orders_shm = make_orders_shm();
+    auto positions_shm = make_positions_shm();
+
+    PositionManager positions(positions_shm.get());
+    assert(positions.initialize(1));
+    assert(positions.add_security("000001", "PingAn", Market::SZ) == std::string_view("XSHE_000001"));
+
+    RiskConfig risk_cfg;
+    risk_cfg.enable_position_check = false;
+    risk_cfg.enable_price_limit_check = false;
+    risk_cfg.enable_duplicate_check = false;
+    risk_cfg.max_order_volume = 0;
+    risk_cfg.max_order_value = 0;
+    risk_cfg.max_orders_per_second = 0;
+    RiskManager risk(positions, risk_cfg);
+
+    auto book = std::make_unique<OrderBook>();
+    order_router router(*book, downstream.get(), orders_shm.get(), upstream.get());
+
+    EventLoopConfig loop_cfg;
+    loop_cfg.poll_batch_size = 8;
+    loop_cfg.stats_interval_ms = 0;
+    loop_cfg.archive_terminal_orders = true;
+    loop_cfg.terminal_archive_delay_ms = 0;
+    EventLoop loop(loop_cfg, upstream.get(), downstream.get(), trades.get(), orders_shm.get(), *book, router, positions,
+                   risk, nullptr, nullptr, nullptr);
+    assert(loop.start());
+
+    // 单线程驱动 run_once：新单 -> 风控 -> 下游；报单确认；全部成交 -> 终态归档
+    const auto push_response = [&trades](InternalOrderId order_id, OrderState state, Volume volume) {
+        TradeResponse rsp{};
+        rsp.internal_order_id = order_id;
+        rsp.internal_security_id = InternalSecurityId("XSHE_000001");
+        rsp.trade_side = TradeSide::Buy;
+        rsp.new_state = state;
+        rsp.volume_traded = volume;
+        rsp.dprice_traded = volume == 0 ? 0 : 1000;
+        rsp.dvalue_traded = volume * 1000;
+        rsp.md_time_traded = 93100000;
+        rsp.recv_time_ns = now_ns();
+        assert(push_trade_response(*trades, rsp));
+    };
+    const auto run_cycle = [&](InternalOrderId order_id) {
+        OrderRequest req = make_order(order_id, 100);
+        OrderIndex order_index = kInvalidOrderIndex;
+        assert(orders_shm_append(orders_shm.get(), req, OrderSlotState::UpstreamQueued, order_slot_source_t::User,
+                                 now_ns(), order_index));
+        assert(upstream->upstream_order_queue.try_push(order_index));
+        (void)loop.run_once();
+        OrderIndex downstream_index = kInvalidOrderIndex;
+        assert(downstream->order_queue.try_pop(downstream_index));
+
+        push_response(order_id, OrderState::MarketAccepted, 0);
+        (void)loop.run_once();
+        push_response(order_id, OrderState::Finished, 100);
+        (void)loop.run_once();
+        (void)loop.run_once();
+        assert(book->find_order(order_id) == nullptr);
+    };
+
+    // 预热：持仓记录、订单簿索引与各级缓冲在首轮完成扩容
+    InternalOrderId next_id = 2000;
+    for (int i = 0; i < 16; ++i) {
+        run_cycle(next_id++);
+    }
+
+    const allocation_scope scope;
+    for (int i = 0; i < 256; ++i) {
+        run_cycle(next_id++);
+    }
+    const uint64_t steady_allocations = scope.allocations();
+#if ACCT_ALLOC_GUARD
+    {
+        // 守卫自检：本线程的一次分配必须被计入
+        const allocation_scope probe;
+        auto value = std::make_unique<int>(1);
+        assert(value && probe.allocations() == 1);
+    }
+    if (steady_allocations != 0) {
+        printf("steady-state cycles allocated %llu times ", static_cast<unsigned long long>(steady_allocations));
+    }
+    assert(steady_allocations == 0);
+#else
+    (void)steady_allocations;
+#endif
+    loop.finish();
+}
+
+TEST(response_drain_yields_to_pending_orders) {
+    auto upstream = make_upstream_shm();
+    auto downstream = make_downstream_shm();
+    auto trades = make_trades_shm();
+    auto orders_shm = make_orders_shm();
+    auto positions_shm = make_positions_shm();
+
+    PositionManager positions(positions_shm.get());
+    assert(positions.initialize(1));
+    assert(positions.add_security("000001", "PingAn", Market::SZ) == std::string_view("XSHE_000001"));
+
+    RiskConfig risk_cfg;
+    risk_cfg.enable_position_check = false;
+    risk_cfg.enable_price_limit_check = false;
+    risk_cfg.enable_duplicate_check = false;
+    risk_cfg.max_order_volume = 0;
+    risk_cfg.max_order_value = 0;
+    risk_cfg.max_orders_per_second = 0;
+    RiskManager risk(positions, risk_cfg);
+
+    auto book = std::make_unique<OrderBook>();
+    order_router router(*book, downstream.get(), orders_shm.get(), upstream.get());
+
+    EventLoopConfig loop_cfg;
+    loop_cfg.poll_batch_size = 4;
+    loop_cfg.stats_interval_ms = 0;
+    loop_cfg.response_preempt_batch = 1;
+    EventLoop loop(loop_cfg, upstream.get(), downstream.get(), trades.get(), orders_shm.get(), *book, router, positions,
+                   risk, nullptr, nullptr, nullptr);
+
+    // 10 笔新单超过单次上游预算 4，16 笔无主回报模拟成交风暴
+    for (int i = 0; i < 10; ++i) {
+        OrderRequest req = make_order(static_cast<InternalOrderId>(3000 + i), 100);
+        OrderIndex order_index = kInvalidOrderIndex;
+        assert(orders_shm_append(orders_shm.get(), req, OrderSlotState::UpstreamQueued, order_slot_source_t::User,
+                                 now_ns(), order_index));
+        assert(upstream->upstream_order_queue.try_push(order_index));
+    }
+    for (int i = 0; i < 16; ++i) {
+        TradeResponse rsp{};
+        rsp.new_state = OrderState::MarketAccepted;
+        assert(push_trade_response(*trades, rsp));
+    }
+
+    // 回报逐笔分块：块间两次让位（4 + 2 笔），本轮 10 笔新单全部下发，回报仍只处理 4 笔预算
+    assert(loop.start());
+    assert(loop.run_once() == 14);
+    assert(loop.stats().ingress_preemptions == 2);
+    assert(loop.stats().orders_processed == 10);
+    assert(loop.stats().responses_processed == 4);
+    assert(downstream->order_queue.size() == 10);
+    assert(trades->response_queue.size() == 12);
+
+    // 关闭后回报整批排空，不再让位
+    EventLoopConfig reload_cfg = loop_cfg;
+    reload_cfg.response_preempt_batch = 0;
+    assert(loop.publish_config(reload_cfg, risk_cfg));
+    assert(loop.run_once() == 4);
+    assert(loop.stats().ingress_preemptions == 2);
+    loop.finish();
+}
+
+TEST(adaptive_batch_scheduler_splits_budget) {
+    batch_budget_policy policy;
+    policy.iteration_budget_ns = 10000;
+    policy.guaranteed_share_pct = 20;
+    policy.min_batch = 2;
+    policy.max_batch = 100;
+    adaptive_batch_scheduler scheduler(policy);
+
+    // 初始单笔估计 1us：回报拿到 20% 保底，其余给新单，空队列不分配
+    batch_plan plan = scheduler.plan(50, 0, 50);
+    assert(plan.responses == 2);
+    assert(plan.orders == 8);
+    assert(plan.cancels == 0);
+
+    // 单笔耗时收敛到约 100ns 后新单额度随之放大，受 max_batch 约束
+    for (int i = 0; i < 64; ++i) {
+        scheduler.record_orders(10, 1000);
+    }
+    assert(scheduler.order_cost_ns() < 110);
+    plan = scheduler.plan(1000, 0, 0);
+    assert(plan.orders > 90 && plan.orders <= 100);
+
+    // 维护耗时膨胀时最多占去一半预算，回报与撤单仍有保底额度
+    for (int i = 0; i < 64; ++i) {
+        scheduler.record_maintenance(1000000);
+    }
+    plan = scheduler.plan(1000, 10, 10);
+    assert(plan.cancels >= 2);
+    assert(plan.responses >= 2);
+    assert(plan.orders >= 2 && plan.orders < 50);
+}
+
+TEST(adaptive_batching_drains_orders_and_responses) {
+    auto upstream = make_upstream_shm();
+    auto downstream = make_downstream_shm();
+    auto trades = make_trades_shm();
+    auto orders_shm = make_orders_shm();
+    auto positions_shm = make_positions_shm();
+
+    PositionManager positions(positions_shm.get());
+    assert(positions.initialize(1));
+    assert(positions.add_security("000001", "PingAn", Market::SZ) == std::string_view("XSHE_000001"));
+
+    RiskConfig risk_cfg;
+    risk_cfg.enable_position_check = false;
+    risk_cfg.enable_price_limit_check = false;
+    risk_cfg.enable_duplicate_check = false;
+    risk_cfg.max_order_volume = 0;
+    risk_cfg.max_order_value = 0;
+    risk_cfg.max_orders_per_second = 0;
+    RiskManager risk(positions, risk_cfg);
+
+    auto book = std::make_unique<OrderBook>();
+    order_router router(*book, downstream.get(), orders_shm.get(), upstream.get());
+
+    EventLoopConfig loop_cfg;
+    loop_cfg.poll_batch_size = 32;
+    loop_cfg.stats_interval_ms = 0;
+    loop_cfg.adaptive_batching = true;
+    loop_cfg.iteration_budget_us = 20;
+    loop_cfg.response_share_pct = 25;
+    EventLoop loop(loop_cfg, upstream.get(), downstream.get(), trades.get(), orders_shm.get(), *book, router, positions,
+                   risk, nullptr, nullptr, nullptr);
+
+    for (int i = 0; i < 100; ++i) {
+        OrderRequest req = make_order(static_cast<InternalOrderId>(4000 + i), 100);
+        OrderIndex order_index = kInvalidOrderIndex;
+        assert(orders_shm_append(orders_shm.get(), req, OrderSlotState::UpstreamQueued, order_slot_source_t::User,
+                                 now_ns(), order_index));
+        assert(upstream->upstream_order_queue.try_push(order_index));
+    }
+    for (int i = 0; i < 40; ++i) {
+        TradeResponse rsp{};
+        rsp.new_state = OrderState::MarketAccepted;
+        assert(push_trade_response(*trades, rsp));
+    }
+
+    // 新单积压时回报仍有保底额度；每类单轮不超过 poll_batch_size
+    assert(loop.start());
+    (void)loop.run_once();
+    assert(loop.stats().responses_processed >= 8);
+    assert(loop.stats().orders_processed >= 8);
+    assert(loop.stats().orders_processed <= 32);
+    assert(loop.stats().responses_processed <= 32);
+
+    for (int i = 0; i < 100 && (upstream->upstream_order_queue.size() > 0 || trades->response_queue.size() > 0); ++i) {
+        (void)loop.run_once();
+    }
+    assert(loop.stats().orders_processed == 100);
+    assert(loop.stats().responses_processed == 40);
+    assert(downstream->order_queue.size() == 100);
+    loop.finish();
+}
+
+namespace {
+std::size_t noop_stage(void*) { return 0; }
+}  // namespace
+
+TEST(loop_shape_follows_attached_features) {
+    auto upstream = make_upstream_shm();
+    auto downstream = make_downstream_shm();
+    auto trades = make_trades_shm();
+    auto orders_shm = make_orders_shm();
+    auto positions_shm = make_positions_shm();
+
+    PositionManager positions(positions_shm.get());
+    assert(positions.initialize(1));
+    RiskConfig risk_cfg;
+    RiskManager risk(positions, risk_cfg);
+    auto book = std::make_unique<OrderBook>();
+    order_router router(*book, downstream.get(), orders_shm.get(), upstream.get());
+
+    EventLoopConfig loop_cfg;
+    loop_cfg.stats_interval_ms = 0;
+    EventLoop loop(loop_cfg, upstream.get(), downstream.get(), trades.get(), orders_shm.get(), *book, router, positions,
+                   risk, nullptr, nullptr, nullptr);
+    assert(loop.required_loop_features() == 0);
+    assert(loop.start());
+    (void)loop.run_once();
+    assert(loop.active_loop_shape() == kLoopShapeMinimal);
+
+    // 热更新打开周期统计后换到直连实例
+    EventLoopConfig reload_cfg = loop_cfg;
+    reload_cfg.stats_interval_ms = 1000;
+    assert(loop.publish_config(reload_cfg, risk_cfg));
+    (void)loop.run_once();
+    (void)loop.run_once();
+    assert(loop.required_loop_features() == kLoopFeaturePeriodic);
+    assert(loop.active_loop_shape() == kLoopShapeDirect);
+
+    // 挂接内联阶段后没有预置形态覆盖，回落到通用实例
+    loop_stage_hook hook;
+    hook.fn = &noop_stage;
+    loop.set_inline_stage(hook);
+    (void)loop.run_once();
+    assert(loop.active_loop_shape() == kLoopFeaturesAll);
+    loop.finish();
+
+    EventLoopConfig archive_cfg;
+    archive_cfg.archive_terminal_orders = true;
+    EventLoop archiving(archive_cfg, upstream.get(), downstream.get(), trades.get(), orders_shm.get(), *book, router,
+                        positions, risk, nullptr, nullptr, nullptr);
+    assert(archiving.start());
+    (void)archiving.run_once();
+    assert(archiving.active_loop_shape() == kLoopShapeArchiving);
+    archiving.finish();
+}
+
+TEST(latency_histogram_percentiles) {
+    latency_histogram histogram;
+    assert(histogram.percentile(0.99) == 0);
+
+    for (uint64_t value = 1; value <= 1000; ++value) {
+        histogram.record(value);
+    }
+    histogram.record(1000000);
+
+    assert(histogram.count.load() == 1001);
+    assert(histogram.max_ns.load() == 1000000);
+    assert(histogram.percentile(1.0) == 1000000);
+
+    // 对数分桶相对误差不超过 12.5%，且估计值取桶上界
+    const uint64_t p50 = histogram.percentile(0.50);
+    assert(p50 >= 500 && p50 <= 500 + 500 / 8);
+    const uint64_t p99 = histogram.percentile(0.99);
+    assert(p99 >= 990 && p99 <= 990 + 990 / 8);
+
+    for (uint64_t value : {uint64_t{0}, uint64_t{7}, uint64_t{8}, uint64_t{123456789}, UINT64_MAX}) {
+        const std::size_t index = latency_histogram::bucket_index(value);
+        assert(index < latency_histogram::kBucketCount);
+        assert(latency_histogram::bucket_upper_bound(index) >= value);
+    }
+
+    histogram.reset();
+    assert(histogram.count.load() == 0);
+    assert(histogram.percentile(0.5) == 0);
+}
+
+TEST(queue_depth_histogram_tracks_watermark_and_alerts) {
+    queue_depth_histogram histogram;
+    histogram.reset(1024);
+    assert(histogram.alert_threshold() == 768);
+    assert(histogram.percentile(0.5) == 0);
+
+    for (uint64_t depth = 0; depth < 100; ++depth) {
+        assert(!histogram.record(depth % 10));
+    }
+    assert(histogram.samples.load() == 100);
+    assert(histogram.high_watermark.load() == 9);
+    assert(histogram.buckets[0].load() == 10);
+    // 2 的幂分桶：p50 落在 [4, 8) 桶，取桶上界
+    assert(histogram.percentile(0.5) == 7);
+    assert(histogram.percentile(1.0) == 9);
+
+    // 越过告警线只在自下而上时计一次，回落后再次越过重新计数
+    assert(histogram.record(800));
+    assert(!histogram.record(900));
+    assert(!histogram.record(10));
+    assert(histogram.record(768));
+    assert(histogram.alerts.load() == 2);
+    assert(histogram.high_watermark.load() == 900);
+
+    for (uint64_t depth : {uint64_t{1}, uint64_t{262144}, UINT64_MAX}) {
+        const std::size_t index = queue_depth_histogram::bucket_index(depth);
+        assert(index < queue_depth_histogram::kBucketCount);
+        assert(index == queue_depth_histogram::kBucketCount - 1 ||
+               queue_depth_histogram::bucket_upper_bound(index) >= depth);
+    }
+
+    histogram.reset(0);
+    assert(histogram.samples.load() == 0);
+    assert(!histogram.record(UINT64_MAX));
+}
+
+TEST(timer_wheel_fires_in_deadline_order) {
+    // 1ms 精度：覆盖同槽、跨层级联、超出最高层范围与取消。
+    timer_wheel<uint32_t> wheel(1000000ULL, 4);
+    const TimestampNs base = 5000000000ULL;
+    const TimestampNs deadlines_ms[] = {3, 0, 70, 4100, 300000, 20000000};
+    std::vector<uint32_t> fired;
+    for (uint32_t i = 0; i < 6; ++i) {
+        (void)wheel.schedule(base, base + deadlines_ms[i] * 1000000ULL + 1, i);
+    }
+    const timer_id cancelled = wheel.schedule(base, base + 50 * 1000000ULL, 99);
+    assert(wheel.size() == 7);
+    assert(wheel.cancel(cancelled));
+    assert(!wheel.cancel(cancelled));
+
+    auto collect = [&fired](uint32_t id) { fired.push_back(id); };
+    wheel.advance(base, collect);
+    assert(fired.empty());
+    wheel.advance(base + 1000000ULL, collect);
+    assert((fired == std::vector<uint32_t>{1}));
+    wheel.advance(base + 4000000ULL - 1, collect);  // 向上取整：到期时间 3ms+1ns 不会在 4ms 前触发
+    assert((fired == std::vector<uint32_t>{1}));
+    wheel.advance(base + 4000000ULL, collect);
+    assert((fired == std::vector<uint32_t>{1, 0}));
+
+    // 回调内登记已到期定时器顺延到下一 tick，不在本轮重复触发。
+    wheel.advance(base + 71 * 1000000ULL, [&](uint32_t id) {
+        fired.push_back(id);
+        (void)wheel.schedule(base, base, 7);
+    });
+    assert((fired == std::vector<uint32_t>{1, 0, 2}));
+    for (TimestampNs ms : {72ULL, 4102ULL, 300002ULL, 20000002ULL}) {
+        wheel.advance(base + ms * 1000000ULL, collect);
+    }
+    assert((fired == std::vector<uint32_t>{1, 0, 2, 7, 3, 4, 5}));
+    assert(wheel.empty());
+}
+
+TEST(loop_clock_stamps_one_iteration_once) {
+    // TSC 换算与系统时钟一致，且同线程单调读数不回退
+    const bool tsc_enabled = tsc_clock::calibrate();
+    assert(tsc_enabled == tsc_clock::enabled());
+    const TimestampNs sys_before = now_ns();
+    const TimestampNs tsc_now = tsc_clock::now_realtime_ns();
+    const TimestampNs sys_after = now_ns();
+    assert(tsc_now + 2000000ULL >= sys_before && tsc_now <= sys_after + 2000000ULL);
+    TimestampNs last_mono = tsc_clock::now_monotonic_ns();
+    for (int i = 0; i < 1000; ++i) {
+        const TimestampNs mono = tsc_clock::now_monotonic_ns();
+        assert(mono >= last_mono);
+        last_mono = mono;
+    }
+
+    auto upstream = make_upstream_shm();
+    auto downstream = make_downstream_shm();
+    auto trades = make_trades_shm();
+    auto orders_shm = make_orders_shm();
+    auto positions_shm = make_positions_shm();
+
+    PositionManager positions(positions_shm.get());
+    assert(positions.initialize(1));
+
+    RiskConfig risk_cfg;
+    risk_cfg.enable_position_check = false;
+    risk_cfg.enable_price_limit_check = false;
+    risk_cfg.enable_duplicate_check = false;
+    risk_cfg.max_order_volume = 0;
+    risk_cfg.max_order_value = 0;
+    risk_cfg.max_orders_per_second = 0;
+    RiskManager risk(positions, risk_cfg);
+
+    auto book = std::make_unique<OrderBook>();
+    order_router router(*book, downstream.get(), orders_shm.get(), upstream.get());
+
+    EventLoopConfig loop_cfg;
+    loop_cfg.poll_batch_size = 8;
+    loop_cfg.stats_interval_ms = 0;
+    EventLoop loop(loop_cfg, upstream.get(), downstream.get(), trades.get(), orders_shm.get(), *book, router, positions,
+                   risk, nullptr, nullptr, nullptr);
+
+    OrderIndex indices[2] = {kInvalidOrderIndex, kInvalidOrderIndex};
+    for (int i = 0; i < 2; ++i) {
+        OrderRequest req = make_order(static_cast<InternalOrderId>(950 + i), 1);
+        assert(orders_shm_append(orders_shm.get(), req, OrderSlotState::UpstreamQueued, order_slot_source_t::User, 1,
+                                 indices[i]));
+        assert(upstream->lane(0).try_push(indices[i]));
+    }
+
+    assert(loop.start());
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    assert(loop.run_once() == 2);
+
+    // 同一轮内的订单状态迁移共用一次取时：订单簿、订单池槽位与头部时间戳一致
+    const OrderEntry* first = book->find_order(950);
+    const OrderEntry* second = book->find_order(951);
+    assert(first != nullptr && second != nullptr);
+    const TimestampNs stamp = first->submit_time_ns;
+    assert(stamp > loop.stats().start_time);
+    assert(second->submit_time_ns == stamp);
+    assert(first->last_update_ns == stamp && second->last_update_ns == stamp);
+    assert(orders_shm->slots[indices[0]].last_update_ns == stamp);
+    assert(orders_shm->slots[indices[1]].last_update_ns == stamp);
+    assert(orders_shm->header.last_update == stamp);
+    loop.finish();
+}
+
+TEST(sim_clock_drives_loop_time_and_archive_deadlines) {
+    auto upstream = make_upstream_shm();
+    auto downstream = make_downstream_shm();
+    auto trades = make_trades_shm();
+    auto orders_shm = make_orders_shm();
+    auto positions_shm = make_positions_shm();
+
+    PositionManager positions(positions_shm.get());
+    assert(positions.initialize(1));
+
+    RiskConfig risk_cfg;
+    risk_cfg.enable_position_check = false;
+    risk_cfg.enable_price_limit_check = false;
+    risk_cfg.enable_duplicate_check = false;
+    risk_cfg.max_order_volume = 0;
+    risk_cfg.max_order_value = 0;
+    risk_cfg.max_orders_per_second = 0;
+    RiskManager risk(positions, risk_cfg);
+
+    auto book = std::make_unique<OrderBook>();
+    order_router router(*book, downstream.get(), orders_shm.get(), upstream.get());
+
+    // 终态订单 30 分钟后归档：按模拟时钟推进，不必真实等待
+    EventLoopConfig loop_cfg;
+    loop_cfg.stats_interval_ms = 0;
+    loop_cfg.archive_terminal_orders = true;
+    loop_cfg.terminal_archive_delay_ms = 30 * 60 * 1000;
+    EventLoop loop(loop_cfg, upstream.get(), downstream.get(), trades.get(), orders_shm.get(), *book, router, positions,
+                   risk, nullptr, nullptr, nullptr);
+    constexpr TimestampNs kStartNs = 1'700'000'000'000'000'000ULL;
+    sim_clock clock(kStartNs);
+    loop.set_sim_clock(&clock);
+    assert((loop.required_loop_features() & kLoopFeatureDiagnostics) != 0);
+
+    const InternalOrderId order_id = 960;
+    OrderRequest req = make_order(order_id, 100);
+    OrderIndex order_index = kInvalidOrderIndex;
+    assert(orders_shm_append(orders_shm.get(), req, OrderSlotState::UpstreamQueued, order_slot_source_t::User, 1,
+                             order_index));
+    assert(upstream->lane(0).try_push(order_index));
+
+    assert(loop.start());
+    assert(loop.stats().start_time == kStartNs);
+    assert(loop.run_once() == 1);
+    assert(loop.active_loop_shape() == kLoopFeaturesAll);
+    const OrderEntry* entry = book->find_order(order_id);
+    assert(entry != nullptr && entry->submit_time_ns == kStartNs);
+
+    clock.advance(1'000'000ULL);
+    TradeResponse terminal{};
+    terminal.internal_order_id = order_id;
+    terminal.internal_security_id = InternalSecurityId("XSHE_000001");
+    terminal.trade_side = TradeSide::Buy;
+    terminal.new_state = OrderState::Finished;
+    terminal.recv_time_ns = clock.now_ns();
+    assert(push_trade_response(*trades, terminal));
+    assert(loop.run_once() == 1);
+    entry = book->find_order(order_id);
+    assert(entry != nullptr && entry->last_update_ns == kStartNs + 1'000'000ULL);
+
+    // 差 1ms 不到期，越过归档线后的下一轮即归档
+    clock.advance(30ULL * 60 * 1'000'000'000ULL - 1'000'000ULL);
+    (void)loop.run_once();
+    assert(book->find_order(order_id) != nullptr);
+    clock.advance(2'000'000ULL);
+    (void)loop.run_once();
+    assert(book->find_order(order_id) == nullptr);
+    OrderIndex archived_index = kInvalidOrderIndex;
+    assert(book->find_archived(order_id, archived_index) && archived_index == order_index);
+    loop.finish();
+}
+
+TEST(round_robin_drains_all_upstream_lanes) {
+    auto upstream = make_upstream_shm();
+    auto downstream = make_downstream_shm();
+    auto trades = make_trades_shm();
+    auto orders_shm = make_orders_shm();
+    auto positions_shm = make_positions_shm();
+    upstream_set_lane_count(upstream.get(), 3);
+
+    PositionManager positions(positions_shm.get());
+    assert(positions.initialize(1));
+
+    RiskConfig risk_cfg;
+    risk_cfg.enable_position_check = false;
+    risk_cfg.enable_price_limit_check = false;
+    risk_cfg.enable_duplicate_check = false;
+    risk_cfg.max_order_volume = 0;
+    risk_cfg.max_order_value = 0;
+    risk_cfg.max_orders_per_second = 0;
+    RiskManager risk(positions, risk_cfg);
+
+    auto book = std::make_unique<OrderBook>();
+    order_router router(*book, downstream.get(), orders_shm.get(), upstream.get());
+
+    EventLoopConfig loop_cfg;
+    loop_cfg.busy_polling = false;
+    loop_cfg.idle_sleep_us = 50;
+    loop_cfg.poll_batch_size = 1;
+    loop_cfg.stats_interval_ms = 0;
+    EventLoop loop(loop_cfg, upstream.get(), downstream.get(), trades.get(), orders_shm.get(), *book, router, positions,
+                   risk, nullptr, nullptr, nullptr);
+
+    // lane 0 积压多笔时，poll_batch_size=1 仍应轮转到 lane 2。
+    const InternalOrderId lane0_ids[3] = {900, 901, 902};
+    for (InternalOrderId order_id : lane0_ids) {
+        OrderRequest req = make_order(order_id, 1);
+        OrderIndex index = kInvalidOrderIndex;
+        assert(orders_shm_append(orders_shm.get(), req, OrderSlotState::UpstreamQueued, order_slot_source_t::User,
+                                 now_ns(), index));
+        assert(upstream->lane(0).try_push(index));
+    }
+    OrderRequest lane2_req = make_order(910, 1);
+    OrderIndex lane2_index = kInvalidOrderIndex;
+    assert(orders_shm_append(orders_shm.get(), lane2_req, OrderSlotState::UpstreamQueued, order_slot_source_t::User,
+                             now_ns(), lane2_index));
+    assert(upstream->lane(2).try_push(lane2_index));
+
+    std::thread worker([&loop]() { loop.run(); });
+
+    assert(wait_until([&upstream]() { return upstream_pending_size(upstream.get()) == 0; }));
+    assert(wait_until([&loop]() { return loop.stats().orders_processed >= 4; }));
+    loop.stop();
+    worker.join();
+
+    assert(book->find_order(910) != nullptr);
+    assert(downstream->order_queue.size() == 4);
+
+    // lane 2 的订单应在 lane 0 排空前被处理。
+    OrderIndex sent_index = kInvalidOrderIndex;
+    bool lane2_before_last_lane0 = false;
+    for (int i = 0; i < 3; ++i) {
+        assert(downstream->order_queue.try_pop(sent_index));
+        if (sent_index == lane2_index) {
+            lane2_before_last_lane0 = true;
+        }
+    }
+    assert(lane2_before_last_lane0);
+}
+
+TEST(inline_upstream_orders_skip_slot_reads) {
+    auto upstream = make_upstream_shm();
+    auto downstream = make_downstream_shm();
+    auto trades = make_trades_shm();
+    auto orders_shm = make_orders_shm();
+    auto positions_shm = make_positions_shm();
+    upstream_set_inline_orders(upstream.get(), true);
+    assert(upstream_inline_orders(upstream.get()));
+
+    PositionManager positions(positions_shm.get());
+    assert(positions.initialize(1));
+
+    RiskConfig risk_cfg;
+    risk_cfg.enable_position_check = false;
+    risk_cfg.enable_price_limit_check = false;
+    risk_cfg.enable_duplicate_check = false;
+    risk_cfg.max_order_volume = 0;
+    risk_cfg.max_order_value = 0;
+    risk_cfg.max_orders_per_second = 0;
+    RiskManager risk(positions, risk_cfg);
+
+    auto book = std::make_unique<OrderBook>();
+    order_router router(*book, downstream.get(), orders_shm.get(), upstream.get());
+
+    EventLoopConfig loop_cfg;
+    loop_cfg.busy_polling = false;
+    loop_cfg.idle_sleep_us = 50;
+    loop_cfg.stats_interval_ms = 0;
+    EventLoop loop(loop_cfg, upstream.get(), downstream.get(), trades.get(), orders_shm.get(), *book, router, positions,
+                   risk, nullptr, nullptr, nullptr);
+
+    // 槽位与消息故意写不同数量：内联下标应按消息入簿，普通下标仍读槽位
+    auto push_order = [&](InternalOrderId order_id, Volume message_volume, bool orphan_before) {
+        OrderRequest req = make_order(order_id, 100);
+        OrderIndex index = kInvalidOrderIndex;
+        assert(orders_shm_append(orders_shm.get(), req, OrderSlotState::UpstreamQueued, order_slot_source_t::User,
+                                 now_ns(), index));
+        if (message_volume == 0) {
+            assert(upstream->lane(0).try_push(index));
+            return;
+        }
+        upstream_order_message message;
+        if (orphan_before) {
+            assert(fill_upstream_order_message(req, index + 1000, message));
+            assert(upstream->payload_lane(0).try_push(message));
+        }
+        req.volume_entrust = message_volume;
+        assert(fill_upstream_order_message(req, index, message));
+        assert(upstream->payload_lane(0).try_push(message));
+        assert(upstream->lane(0).try_push(index | kUpstreamInlineIndexFlag));
+    };
+    push_order(920, 300, false);
+    push_order(921, 400, true);
+    push_order(922, 0, false);
+
+    // 篮子腿不可内联，生产者只推下标
+    OrderRequest basket_leg = make_order(930, 100);
+    basket_leg.basket_legs = 2;
+    upstream_order_message unused;
+    assert(!fill_upstream_order_message(basket_leg, 0, unused));
+
+    std::thread worker([&loop]() { loop.run(); });
+    assert(wait_until([&loop]() { return loop.stats().orders_processed >= 3; }));
+    loop.stop();
+    worker.join();
+
+    assert(loop.stats().inline_orders == 2);
+    assert(loop.stats().inline_skipped == 1);
+    assert(upstream->payload_lane(0).empty());
+    const OrderEntry* first = book->find_order(920);
+    const OrderEntry* second = book->find_order(921);
+    const OrderEntry* plain = book->find_order(922);
+    assert(first && first->request.volume_entrust == 300);
+    assert(first->request.internal_security_id.view() == "XSHE_000001");
+    assert(second && second->request.volume_entrust == 400);
+    assert(plain && plain->request.volume_entrust == 100);
+    assert(downstream->order_queue.size() == 3);
+}
+
+TEST(order_updates_follow_source_lane) {
+    auto upstream = make_upstream_shm();
+    auto downstream = make_downstream_shm();
+    auto trades = make_trades_shm();
+    auto orders_shm = make_orders_shm();
+    auto positions_shm = make_positions_shm();
+    upstream_set_lane_count(upstream.get(), 3);
+
+    PositionManager positions(positions_shm.get());
+    assert(positions.initialize(1));
+    assert(positions.add_security("000001", "PingAn", Market::SZ) == std::string_view("XSHE_000001"));
+
+    RiskConfig risk_cfg;
+    risk_cfg.enable_position_check = false;
+    risk_cfg.enable_price_limit_check = false;
+    risk_cfg.enable_duplicate_check = false;
+    risk_cfg.max_order_volume = 0;
+    risk_cfg.max_order_value = 0;
+    risk_cfg.max_orders_per_second = 0;
+    RiskManager risk(positions, risk_cfg);
+
+    auto book = std::make_unique<OrderBook>();
+    order_router router(*book, downstream.get(), orders_shm.get(), upstream.get());
+
+    EventLoopConfig loop_cfg;
+    loop_cfg.busy_polling = false;
+    loop_cfg.idle_sleep_us = 50;
+    loop_cfg.poll_batch_size = 32;
+    loop_cfg.stats_interval_ms = 0;
+    EventLoop loop(loop_cfg, upstream.get(), downstream.get(), trades.get(), orders_shm.get(), *book, router, positions,
+                   risk, nullptr, nullptr, nullptr);
+
+    const InternalOrderId order_id = 920;
+    OrderRequest req = make_order(order_id, 100);
+    OrderIndex order_index = kInvalidOrderIndex;
+    assert(orders_shm_append(orders_shm.get(), req, OrderSlotState::UpstreamQueued, order_slot_source_t::User,
+                             now_ns(), order_index));
+    assert(upstream->lane(2).try_push(order_index));
+
+    std::thread worker([&loop]() { loop.run(); });
+    assert(wait_until([&downstream]() { return downstream->order_queue.size() > 0; }));
+
+    TradeResponse rsp{};
+    rsp.internal_order_id = order_id;
+    rsp.internal_security_id = InternalSecurityId("XSHE_000001");
+    rsp.trade_side = TradeSide::Buy;
+    rsp.new_state = OrderState::MarketAccepted;
+    rsp.volume_traded = 40;
+    rsp.dprice_traded = 1000;
+    rsp.dvalue_traded = 40000;
+    rsp.dfee = 5;
+    rsp.recv_time_ns = now_ns();
+    assert(push_trade_response(*trades, rsp));
+    assert(wait_until([&loop]() { return loop.stats().responses_processed >= 1; }));
+    loop.stop();
+    worker.join();
+
+    // 回报只进入来源 lane 的回报环：先是入簿，最后一条带上成交
+    auto& updates = upstream->order_updates(2).queue;
+    assert(upstream->order_updates(0).queue.empty());
+    assert(upstream->order_updates(1).queue.empty());
+    order_update_message message{};
+    assert(updates.try_pop(message));
+    assert(message.internal_order_id == order_id && message.index == order_index);
+    assert(message.event == static_cast<uint8_t>(order_book_event_t::Added));
+    order_update_message last = message;
+    while (updates.try_pop(message)) {
+        assert(message.internal_order_id == order_id);
+        last = message;
+    }
+    assert(last.volume_traded == 40 && last.dvalue_traded == 40000 && last.dfee_executed == 5);
+    assert(last.order_state == OrderState::MarketAccepted);
+    assert(upstream->order_updates(2).dropped.load() == 0);
+}
+
+TEST(mass_cancel_expands_by_strategy_and_security) {
+    auto upstream = make_upstream_shm();
+    auto downstream = make_downstream_shm();
+    auto trades = make_trades_shm();
+    auto orders_shm = make_orders_shm();
+    auto positions_shm = make_positions_shm();
+    upstream_set_lane_count(upstream.get(), 2);
+
+    PositionManager positions(positions_shm.get());
+    assert(positions.initialize(1));
+    assert(!positions.add_security("000001", "PingAn", Market::SZ).empty());
+    assert(!positions.add_security("000002", "Vanke", Market::SZ).empty());
+
+    RiskConfig risk_cfg;
+    risk_cfg.enable_position_check = false;
+    risk_cfg.enable_price_limit_check = false;
+    risk_cfg.enable_duplicate_check = false;
+    risk_cfg.max_order_volume = 0;
+    risk_cfg.max_order_value = 0;
+    risk_cfg.max_orders_per_second = 0;
+    RiskManager risk(positions, risk_cfg);
+
+    auto book = std::make_unique<OrderBook>();
+    order_router router(*book, downstream.get(), orders_shm.get(), upstream.get());
+
+    EventLoopConfig loop_cfg;
+    loop_cfg.busy_polling = false;
+    loop_cfg.idle_sleep_us = 50;
+    loop_cfg.poll_batch_size = 32;
+    loop_cfg.stats_interval_ms = 0;
+    EventLoop loop(loop_cfg, upstream.get(), downstream.get(), trades.get(), orders_shm.get(), *book, router, positions,
+                   risk, nullptr, nullptr, nullptr);
+    std::thread worker([&loop]() { loop.run(); });
+
+    auto submit = [&](uint32_t lane, const OrderRequest& req) {
+        OrderIndex index = kInvalidOrderIndex;
+        assert(orders_shm_append(orders_shm.get(), req, OrderSlotState::UpstreamQueued, order_slot_source_t::User,
+                                 now_ns(), index));
+        assert(upstream->lane(lane).try_push(index));
+    };
+    auto drain_downstream = [&](std::size_t expected, std::vector<OrderRequest>& out) {
+        assert(wait_until([&]() { return downstream->order_queue.size() >= expected; }));
+        OrderIndex index = kInvalidOrderIndex;
+        while (downstream->order_queue.try_pop(index)) {
+            order_slot_snapshot snapshot;
+            assert(orders_shm_read_snapshot(orders_shm.get(), index, snapshot));
+            out.push_back(snapshot.request);
+        }
+    };
+
+    // lane 0 两笔 000001，lane 1 一笔 000002
+    submit(0, make_order(1000, 100));
+    submit(0, make_order(1001, 100));
+    OrderRequest other = make_order(1002, 100);
+    other.init_new("000002", InternalSecurityId("XSHE_000002"), 1002, TradeSide::Buy, Market::SZ, 100, 1000,
+                   93000000);
+    other.order_state.store(OrderState::UserSubmitted, std::memory_order_relaxed);
+    submit(1, other);
+    std::vector<OrderRequest> sent;
+    drain_downstream(3, sent);
+    assert(sent.size() == 3);
+
+    // 按策略撤单：只展开 lane 0 的两笔，请求本身不下发且随即终结
+    OrderRequest by_strategy;
+    by_strategy.init_mass_cancel(2000, 93000000, MassCancelScope::Strategy, 0, {}, 0);
+    by_strategy.order_state.store(OrderState::UserSubmitted, std::memory_order_relaxed);
+    submit(1, by_strategy);
+    std::vector<OrderRequest> cancels;
+    drain_downstream(2, cancels);
+    assert(cancels.size() == 2);
+    for (const OrderRequest& cancel : cancels) {
+        assert(cancel.order_type == OrderType::Cancel);
+        assert(cancel.orig_internal_order_id == 1000 || cancel.orig_internal_order_id == 1001);
+    }
+    assert(cancels[0].orig_internal_order_id != cancels[1].orig_internal_order_id);
+    assert(wait_until([&book]() {
+        const OrderEntry* request = book->find_order(2000);
+        return !request || request->request.order_state.load() == OrderState::Finished;
+    }));
+
+    // 按证券撤单：只命中 000002
+    OrderRequest by_security;
+    by_security.init_mass_cancel(2001, 93000000, MassCancelScope::Security, 0, InternalSecurityId("XSHE_000002"), 0);
+    by_security.order_state.store(OrderState::UserSubmitted, std::memory_order_relaxed);
+    submit(0, by_security);
+    cancels.clear();
+    drain_downstream(1, cancels);
+    assert(cancels.size() == 1);
+    assert(cancels[0].orig_internal_order_id == 1002);
+
+    loop.stop();
+    worker.join();
+}
+
+// 运维指令：按轮询周期取指令、单次条数有上限，暂停只拦新单，撤单按来源策略展开，结果按编号写回完成环
+TEST(admin_commands_run_inside_loop) {
+    auto upstream = make_upstream_shm();
+    auto downstream = make_downstream_shm();
+    auto trades = make_trades_shm();
+    auto orders_shm = make_orders_shm();
+    auto positions_shm = make_positions_shm();
+    auto admin = std::make_unique<admin_shm_layout>();
+    init_header(admin->header);
+    upstream_set_lane_count(upstream.get(), 2);
+
+    PositionManager positions(positions_shm.get());
+    assert(positions.initialize(1));
+    assert(!positions.add_security("000001", "PingAn", Market::SZ).empty());
+
+    RiskConfig risk_cfg;
+    risk_cfg.enable_position_check = false;
+    risk_cfg.enable_price_limit_check = false;
+    risk_cfg.enable_duplicate_check = false;
+    risk_cfg.max_order_volume = 0;
+    risk_cfg.max_order_value = 0;
+    risk_cfg.max_orders_per_second = 0;
+    RiskManager risk(positions, risk_cfg);
+
+    auto book = std::make_unique<OrderBook>();
+    order_router router(*book, downstream.get(), orders_shm.get(), upstream.get());
+
+    EventLoopConfig loop_cfg;
+    loop_cfg.stats_interval_ms = 0;
+    loop_cfg.admin_poll_iterations = 2;
+    EventLoop loop(loop_cfg, upstream.get(), downstream.get(), trades.get(), orders_shm.get(), *book, router, positions,
+                   risk, nullptr, nullptr, nullptr);
+    loop.set_admin_channel(admin.get());
+    assert(loop.required_loop_features() == kLoopFeaturePeriodic);
+    int reloads = 0;
+    loop.set_reload_requester([](void* context) { ++*static_cast<int*>(context); }, &reloads);
+    assert(loop.start());
+
+    auto submit = [&](uint32_t lane, InternalOrderId order_id) {
+        const OrderRequest req = make_order(order_id, 100);
+        OrderIndex index = kInvalidOrderIndex;
+        assert(orders_shm_append(orders_shm.get(), req, OrderSlotState::UpstreamQueued, order_slot_source_t::User,
+                                 now_ns(), index));
+        assert(upstream->lane(lane).try_push(index));
+    };
+    auto next_response = [&]() {
+        admin_response response{};
+        assert(admin_poll_response(admin.get(), response));
+        return response;
+    };
+
+    submit(0, 1000);
+    submit(1, 1001);
+    (void)loop.run_once();
+    assert(downstream->order_queue.size() == 2);
+
+    // 每两轮取一次；一次最多执行 kAdminCommandsPerPoll 条，其余留到下一次
+    assert(admin_submit(admin.get(), admin_command_type::PauseStrategy, 1, 1));
+    assert(admin_submit(admin.get(), admin_command_type::DumpState, 2));
+    assert(admin_submit(admin.get(), admin_command_type::Checkpoint, 3));
+    assert(admin_submit(admin.get(), admin_command_type::ReloadConfig, 4));
+    assert(admin_submit(admin.get(), admin_command_type::None, 5));
+    (void)loop.run_once();
+    assert(admin->executed.load() == kAdminCommandsPerPoll);
+    assert(loop.strategy_paused(1));
+    assert(next_response().status == admin_command_status::Done);
+    assert(next_response().status == admin_command_status::Done);
+    assert(next_response().status == admin_command_status::Rejected);  // 未挂接检查点写线程
+    const admin_response reload = next_response();
+    assert(reload.command_id == 4 && reload.status == admin_command_status::Accepted);
+    assert(reloads == 1);
+    (void)loop.run_once();
+    (void)loop.run_once();
+    const admin_response unknown = next_response();
+    assert(unknown.command_id == 5 && unknown.status == admin_command_status::Unsupported);
+
+    // 暂停的策略新单在风控之前拒绝，其他策略照常下发
+    submit(1, 1002);
+    submit(0, 1003);
+    (void)loop.run_once();
+    const OrderEntry* paused = book->find_order(1002);
+    assert(paused && paused->risk_result == RiskResult::RejectStrategyPaused);
+    assert(paused->request.order_state.load() == OrderState::RiskControllerRejected);
+    assert(loop.stats().paused_rejects == 1);
+    assert(downstream->order_queue.size() == 3);
+
+    // 撤销策略 1 的在途新单：只命中 1001
+    assert(admin_submit(admin.get(), admin_command_type::ResumeStrategy, 6, 1));
+    assert(admin_submit(admin.get(), admin_command_type::CancelStrategy, 7, 1));
+    (void)loop.run_once();
+    assert(!loop.strategy_paused(1));
+    assert(next_response().command_id == 6);
+    const admin_response cancel = next_response();
+    assert(cancel.command_id == 7 && cancel.status == admin_command_status::Done && cancel.affected == 1);
+    assert(loop.stats().admin_commands == 7);
+    loop.finish();
+}
+
+// 运维指令段同一时刻只有一个运维工具：存活持有者排他，已退出的持有者可被回收，非持有者释放无效
+TEST(admin_writer_claim_is_exclusive) {
+    auto admin = std::make_unique<admin_shm_layout>();
+    init_header(admin->header);
+    const uint32_t self = static_cast<uint32_t>(::getpid());
+    const uint32_t parent = static_cast<uint32_t>(::getppid());
+
+    assert(admin_claim_writer(admin.get(), self));
+    assert(admin_claim_writer(admin.get(), self));  // 重复认领幂等
+    uint32_t holder = 0;
+    assert(!admin_claim_writer(admin.get(), parent, &holder));
+    assert(holder == self);
+    admin_release_writer(admin.get(), parent);
+    assert(admin->writer_pid.load() == self);
+    admin_release_writer(admin.get(), self);
+    assert(admin->writer_pid.load() == 0);
+
+    // 超出 pid 上限的持有者必然不存在，视为已退出
+    admin->writer_pid.store(0x7FFFFFF0U);
+    assert(admin_claim_writer(admin.get(), self));
+    assert(admin->writer_pid.load() == self);
+}
+
+TEST(cancel_lane_jumps_queued_orders) {
+    auto upstream = make_upstream_shm();
+    auto downstream = make_downstream_shm();
+    auto trades = make_trades_shm();
+    auto orders_shm = make_orders_shm();
+    auto positions_shm = make_positions_shm();
+
+    PositionManager positions(positions_shm.get());
+    assert(positions.initialize(1));
+    assert(!positions.add_security("000001", "PingAn", Market::SZ).empty());
+
+    RiskConfig risk_cfg;
+    risk_cfg.enable_position_check = false;
+    risk_cfg.enable_price_limit_check = false;
+    risk_cfg.enable_duplicate_check = false;
+    risk_cfg.max_order_volume = 0;
+    risk_cfg.max_order_value = 0;
+    risk_cfg.max_orders_per_second = 0;
+    RiskManager risk(positions, risk_cfg);
+
+    auto book = std::make_unique<OrderBook>();
+    order_router router(*book, downstream.get(), orders_shm.get(), upstream.get());
+
+    EventLoopConfig loop_cfg;
+    loop_cfg.busy_polling = false;
+    loop_cfg.poll_batch_size = 1;
+    loop_cfg.stats_interval_ms = 0;
+    EventLoop loop(loop_cfg, upstream.get(), downstream.get(), trades.get(), orders_shm.get(), *book, router, positions,
+                   risk, nullptr, nullptr, nullptr);
+    assert(loop.start());
+
+    auto append = [&](const OrderRequest& req) {
+        OrderIndex index = kInvalidOrderIndex;
+        assert(orders_shm_append(orders_shm.get(), req, OrderSlotState::UpstreamQueued, order_slot_source_t::User,
+                                 now_ns(), index));
+        return index;
+    };
+    auto make_cancel = [](InternalOrderId cancel_id, InternalOrderId orig_id) {
+        OrderRequest req;
+        req.init_cancel(cancel_id, 93000000, orig_id);
+        req.order_state.store(OrderState::UserSubmitted, std::memory_order_relaxed);
+        return req;
+    };
+    auto pop_sent = [&]() {
+        OrderIndex index = kInvalidOrderIndex;
+        assert(downstream->order_queue.try_pop(index));
+        order_slot_snapshot snapshot;
+        assert(orders_shm_read_snapshot(orders_shm.get(), index, snapshot));
+        return snapshot.request;
+    };
+
+    assert(upstream->lane(0).try_push(append(make_order(1200, 100))));
+    assert(loop.run_once() == 1);
+    assert(pop_sent().internal_order_id == 1200);
+
+    // 普通队列积压两笔新单时，撤单队列里的撤单先被处理
+    assert(upstream->lane(0).try_push(append(make_order(1201, 100))));
+    assert(upstream->lane(0).try_push(append(make_order(1202, 100))));
+    assert(upstream->cancel_lane(0).try_push(append(make_cancel(1300, 1200))));
+    assert(loop.run_once() == 1);
+    assert(loop.stats().priority_cancels == 1);
+    OrderRequest sent = pop_sent();
+    assert(sent.order_type == OrderType::Cancel);
+    assert(sent.orig_internal_order_id == 1200);
+
+    // 原单仍在普通队列中的撤单挂起，原单入簿后再下发
+    assert(upstream->lane(0).try_push(append(make_order(1203, 100))));
+    assert(upstream->cancel_lane(0).try_push(append(make_cancel(1301, 1203))));
+    assert(loop.run_once() == 1);
+    assert(loop.stats().deferred_cancels == 1);
+    assert(downstream->order_queue.empty());
+    while (upstream_pending_size(upstream.get()) > 0) {
+        (void)loop.run_once();
+    }
+    assert(pop_sent().internal_order_id == 1201);
+    assert(pop_sent().internal_order_id == 1202);
+    assert(pop_sent().internal_order_id == 1203);
+    sent = pop_sent();
+    assert(sent.order_type == OrderType::Cancel);
+    assert(sent.orig_internal_order_id == 1203);
+    assert(downstream->order_queue.empty());
+
+    loop.finish();
+}
+
+TEST(orders_rollover_waits_for_quiescence_and_switches_pools) {
+    auto upstream = make_upstream_shm();
+    auto downstream = make_downstream_shm();
+    auto trades = make_trades_shm();
+    auto orders_shm = make_orders_shm();
+    auto next_orders_shm = make_orders_shm();
+    std::memcpy(next_orders_shm->header.trading_day, "19700102", 9);
+    auto positions_shm = make_positions_shm();
+
+    PositionManager positions(positions_shm.get());
+    assert(positions.initialize(1));
+    assert(!positions.add_security("000001", "PingAn", Market::SZ).empty());
+
+    RiskConfig risk_cfg;
+    risk_cfg.enable_position_check = false;
+    risk_cfg.enable_price_limit_check = false;
+    risk_cfg.enable_duplicate_check = false;
+    risk_cfg.max_order_volume = 0;
+    risk_cfg.max_order_value = 0;
+    risk_cfg.max_orders_per_second = 0;
+    RiskManager risk(positions, risk_cfg);
+
+    auto book = std::make_unique<OrderBook>();
+    order_router router(*book, downstream.get(), orders_shm.get(), upstream.get());
+
+    EventLoopConfig loop_cfg;
+    loop_cfg.busy_polling = false;
+    loop_cfg.poll_batch_size = 8;
+    loop_cfg.stats_interval_ms = 0;
+    EventLoop loop(loop_cfg, upstream.get(), downstream.get(), trades.get(), orders_shm.get(), *book, router, positions,
+                   risk, nullptr, nullptr, nullptr);
+    assert(loop.start());
+
+    auto submit = [&](orders_shm_layout* pool, InternalOrderId order_id) {
+        OrderIndex index = kInvalidOrderIndex;
+        assert(orders_shm_append(pool, make_order(order_id, 100), OrderSlotState::UpstreamQueued,
+                                 order_slot_source_t::User, now_ns(), index));
+        assert(upstream->lane(0).try_push(index));
+        return index;
+    };
+
+    (void)submit(orders_shm.get(), 1200);
+    assert(loop.run_once() == 1);
+    OrderIndex sent = kInvalidOrderIndex;
+    assert(downstream->order_queue.try_pop(sent));
+
+    // 在途订单未终态前不切换，且同一时刻只接受一个换日请求
+    assert(loop.request_orders_rollover(next_orders_shm.get()));
+    assert(!loop.request_orders_rollover(next_orders_shm.get()));
+    (void)loop.run_once();
+    assert(loop.orders_rollover_pending());
+    assert(loop.orders_shm() == orders_shm.get());
+
+    TradeResponse rsp{};
+    rsp.internal_order_id = 1200;
+    rsp.internal_security_id = InternalSecurityId("XSHE_000001");
+    rsp.trade_side = TradeSide::Buy;
+    rsp.new_state = OrderState::BrokerRejected;
+    rsp.recv_time_ns = now_ns();
+    assert(push_trade_response(*trades, rsp));
+    (void)loop.run_once();
+    (void)loop.run_once();
+    assert(!loop.orders_rollover_pending());
+    assert(loop.orders_shm() == next_orders_shm.get());
+    assert(loop.stats().orders_rollovers == 1);
+    assert(orders_shm_successor_day(orders_shm.get()) == 19700102);
+    assert(next_orders_shm->header.predecessor_day.load() == 19700101);
+
+    // 下游三条队列各一个换日标记，网关据此切池
+    OrderIndex marker = kInvalidOrderIndex;
+    assert(downstream->order_queue.try_pop(marker) && marker == kOrdersRolloverMarker);
+    downstream_order_message message{};
+    assert(downstream->order_payload_queue.try_pop(message) && message.index == kOrdersRolloverMarker);
+    assert(downstream->cancel_queue.try_pop(message) && message.index == kOrdersRolloverMarker);
+
+    // 接入方推入标记前的下标仍属旧池：就地拒绝，不入簿也不下发
+    const OrderIndex stale = submit(orders_shm.get(), 1201);
+    (void)loop.run_once();
+    assert(loop.stats().stale_orders_rejected == 1);
+    assert(downstream->order_queue.empty());
+    order_slot_snapshot snapshot;
+    assert(orders_shm_read_snapshot(orders_shm.get(), stale, snapshot));
+    assert(snapshot.stage == OrderSlotState::RiskRejected);
+
+    // 读到标记后按新池处理
+    assert(upstream->lane(0).try_push(kOrdersRolloverMarker));
+    const OrderIndex fresh = submit(next_orders_shm.get(), 1202);
+    (void)loop.run_once();
+    assert(downstream->order_queue.try_pop(sent));
+    assert(sent == fresh);
+    assert(orders_shm_read_snapshot(next_orders_shm.get(), sent, snapshot));
+    assert(snapshot.request.internal_order_id == 1202);
+    assert(book->find_order(1202) != nullptr);
+
+    loop.finish();
+}
+
+TEST(accepted_replace_amends_order_and_frozen_fund) {
+    auto upstream = make_upstream_shm();
+    auto downstream = make_downstream_shm();
+    auto trades = make_trades_shm();
+    auto orders_shm = make_orders_shm();
+    auto positions_shm = make_positions_shm();
+
+    PositionManager positions(positions_shm.get());
+    assert(positions.initialize(1));
+    fund_info fund_cfg;
+    fund_cfg.total_asset = 1000000;
+    fund_cfg.available = 1000000;
+    assert(positions.overwrite_fund_info(fund_cfg));
+
+    RiskConfig risk_cfg;
+    risk_cfg.enable_position_check = false;
+    risk_cfg.enable_price_limit_check = false;
+    risk_cfg.enable_duplicate_check = false;
+    risk_cfg.max_order_volume = 0;
+    risk_cfg.max_order_value = 0;
+    risk_cfg.max_orders_per_second = 0;
+    RiskManager risk(positions, risk_cfg);
+
+    auto book = std::make_unique<OrderBook>();
+    order_router router(*book, downstream.get(), orders_shm.get(), upstream.get());
+
+    EventLoopConfig loop_cfg;
+    loop_cfg.busy_polling = false;
+    loop_cfg.stats_interval_ms = 0;
+    EventLoop loop(loop_cfg, upstream.get(), downstream.get(), trades.get(), orders_shm.get(), *book, router, positions,
+                   risk, nullptr, nullptr, nullptr);
+    assert(loop.start());
+
+    OrderRequest req = make_order(1500, 100);
+    OrderIndex index = kInvalidOrderIndex;
+    assert(orders_shm_append(orders_shm.get(), req, OrderSlotState::UpstreamQueued, order_slot_source_t::User, now_ns(),
+                             index));
+    assert(upstream->lane(0).try_push(index));
+    assert(loop.run_once() == 1);
+    const DValue fee = book->find_order(1500)->request.dfee_estimate;
+    assert(positions.get_fund_info().frozen == 100 * 1000 + fee);
+
+    // 网关未通告改单能力时拒绝改单
+    assert(!router.route_replace(1500, 1501, 200, 1100, 93100000));
+    downstream->broker_capabilities.store(kBrokerCapReplace);
+    assert(router.route_replace(1500, 1501, 200, 1100, 93100000));
+    const OrderEntry* replace = book->find_order(1501);
+    assert(replace != nullptr && replace->request.order_type == OrderType::Replace);
+    assert(replace->request.volume_entrust == 200 && replace->request.dprice_entrust == 1100);
+
+    TradeResponse rsp{};
+    rsp.internal_order_id = 1501;
+    rsp.new_state = OrderState::BrokerAccepted;
+    rsp.recv_time_ns = now_ns();
+    assert(push_trade_response(*trades, rsp));
+    (void)loop.run_once();
+
+    const OrderEntry* order = book->find_order(1500);
+    assert(order->request.volume_entrust == 200);
+    assert(order->request.dprice_entrust == 1100);
+    assert(order->fund_frozen == 200 * 1100 + fee);
+    assert(positions.get_fund_info().frozen == 200 * 1100 + fee);
+    order_slot_snapshot snapshot;
+    assert(orders_shm_read_snapshot(orders_shm.get(), order->shm_order_index, snapshot));
+    assert(snapshot.request.volume_entrust == 200);
+
+    loop.finish();
+}
+
+// 篮子各腿合并冻结一次资金；原子篮子单腿可过风控但合计超出可用资金时整篮拒绝
+TEST(basket_reserves_fund_once_and_all_or_nothing) {
+    auto upstream = make_upstream_shm();
+    auto downstream = make_downstream_shm();
+    auto trades = make_trades_shm();
+    auto orders_shm = make_orders_shm();
+    auto positions_shm = make_positions_shm();
+
+    PositionManager positions(positions_shm.get());
+    assert(positions.initialize(1));
+    fund_info fund_cfg;
+    fund_cfg.total_asset = 100000;
+    fund_cfg.available = 100000;
+    assert(positions.overwrite_fund_info(fund_cfg));
+
+    RiskConfig risk_cfg;
+    risk_cfg.enable_position_check = false;
+    risk_cfg.enable_price_limit_check = false;
+    risk_cfg.enable_duplicate_check = false;
+    risk_cfg.max_order_volume = 0;
+    risk_cfg.max_order_value = 0;
+    risk_cfg.max_orders_per_second = 0;
+    RiskManager risk(positions, risk_cfg);
+
+    auto book = std::make_unique<OrderBook>();
+    order_router router(*book, downstream.get(), orders_shm.get(), upstream.get());
+
+    EventLoopConfig loop_cfg;
+    loop_cfg.busy_polling = false;
+    loop_cfg.stats_interval_ms = 0;
+    EventLoop loop(loop_cfg, upstream.get(), downstream.get(), trades.get(), orders_shm.get(), *book, router, positions,
+                   risk, nullptr, nullptr, nullptr);
+    assert(loop.start());
+
+    const auto push_basket = [&](InternalOrderId first_id, uint8_t flags) {
+        OrderIndex indices[2];
+        for (uint32_t leg = 0; leg < 2; ++leg) {
+            OrderRequest req = make_order(first_id + leg, 30);
+            req.basket_id = first_id;
+            req.basket_legs = 2;
+            req.basket_flags = flags;
+            assert(orders_shm_append(orders_shm.get(), req, OrderSlotState::UpstreamQueued, order_slot_source_t::User,
+                                     now_ns(), indices[leg]));
+        }
+        assert(upstream->lane(0).try_push_bulk(indices, 2) == 2);
+    };
+
+    push_basket(900, 0);
+    assert(loop.run_once() == 2);
+    const OrderEntry* first = book->find_order(900);
+    const OrderEntry* second = book->find_order(901);
+    assert(first && second);
+    assert(first->request.order_state.load() == OrderState::TraderSubmitted);
+    assert(second->request.order_state.load() == OrderState::TraderSubmitted);
+    const DValue leg_total = 30 * 1000 + first->request.dfee_estimate;
+    assert(first->fund_frozen == leg_total && second->fund_frozen == leg_total);
+    assert(positions.get_fund_info().frozen == 2 * leg_total);
+
+    // 剩余资金够任一腿，不够两腿合计
+    push_basket(910, kBasketAllOrNothing);
+    assert(loop.run_once() == 2);
+    for (InternalOrderId id = 910; id <= 911; ++id) {
+        const OrderEntry* leg = book->find_order(id);
+        assert(leg && leg->request.order_state.load() == OrderState::RiskControllerRejected);
+        assert(leg->fund_frozen == 0);
+    }
+    assert(positions.get_fund_info().frozen == 2 * leg_total);
+    assert(positions.get_fund_info().available == 100000 - 2 * leg_total);
+
+    loop.finish();
+}
+
+TEST(standby_shadow_replays_primary_and_promotes) {
+    RiskConfig risk_cfg;
+    risk_cfg.enable_position_check = false;
+    risk_cfg.enable_price_limit_check = false;
+    risk_cfg.enable_duplicate_check = false;
+    risk_cfg.max_order_volume = 0;
+    risk_cfg.max_order_value = 0;
+    risk_cfg.max_orders_per_second = 0;
+    EventLoopConfig loop_cfg;
+    loop_cfg.busy_polling = false;
+    loop_cfg.stats_interval_ms = 0;
+
+    // 主备各一套独立的共享内存与组件；备机订单池纪元与主机不同，重放后须改用主机纪元
+    struct node {
+        std::unique_ptr<upstream_shm_layout> upstream = make_upstream_shm();
+        std::unique_ptr<downstream_shm_layout> downstream = make_downstream_shm();
+        std::unique_ptr<trades_shm_layout> trades = make_trades_shm();
+        std::unique_ptr<orders_shm_layout> orders = make_orders_shm();
+        std::unique_ptr<positions_shm_layout> positions_shm = make_positions_shm();
+        std::unique_ptr<PositionManager> positions;
+        std::unique_ptr<RiskManager> risk;
+        std::unique_ptr<OrderBook> book = std::make_unique<OrderBook>();
+        std::unique_ptr<order_router> router;
+        std::unique_ptr<EventLoop> loop;
+
+        node(const RiskConfig& risk_cfg, const EventLoopConfig& loop_cfg, uint32_t epoch_ticket) {
+            upstream->header.next_id_epoch.store(epoch_ticket, std::memory_order_relaxed);
+            positions = std::make_unique<PositionManager>(positions_shm.get());
+            assert(positions->initialize(1));
+            assert(positions->add_security("000001", "PingAn", Market::SZ) == std::string_view("XSHE_000001"));
+            risk = std::make_unique<RiskManager>(*positions, risk_cfg);
+            router = std::make_unique<order_router>(*book, downstream.get(), orders.get(), upstream.get());
+            loop = std::make_unique<EventLoop>(loop_cfg, upstream.get(), downstream.get(), trades.get(), orders.get(),
+                                               *book, *router, *positions, *risk, nullptr, nullptr, nullptr);
+        }
+    };
+    node primary(risk_cfg, loop_cfg, 1);
+    node standby(risk_cfg, loop_cfg, 5);
+    assert(standby.orders->header.id_epoch.load() != primary.orders->header.id_epoch.load());
+
+    ReplicationConfig repl_cfg;
+    repl_cfg.bind_address = "127.0.0.1";
+    repl_cfg.peer_host = "127.0.0.1";
+    repl_cfg.port = 30000 + static_cast<uint32_t>(getpid() % 20000);
+    replication_receiver receiver;
+    assert(receiver.start(repl_cfg, 1, 19700101));
+    replication_sender sender;
+    assert(sender.start(repl_cfg, 1, primary.orders->header.id_epoch.load(), 19700101));
+    assert(wait_until([&]() { return sender.connected() && receiver.connected(); }, 3000));
+
+    primary.loop->set_replication_sink(&sender);
+    standby.loop->set_replication_source(&receiver);
+    assert(primary.loop->start());
+    assert(standby.loop->start());
+
+    // 主机：新单（订单号由槽位编码）入簿路由，随后一笔部分成交
+    OrderRequest req = make_order(0, 100);
+    OrderIndex order_index = kInvalidOrderIndex;
+    assert(orders_shm_append(primary.orders.get(), req, OrderSlotState::UpstreamQueued, order_slot_source_t::User,
+                             now_ns(), order_index));
+    assert(primary.upstream->lane(0).try_push(order_index));
+    assert(primary.loop->run_once() == 1);
+    const InternalOrderId order_id = orders_shm_order_id(primary.orders.get(), order_index);
+    assert(primary.book->find_order(order_id) != nullptr);
+
+    TradeResponse rsp{};
+    rsp.internal_order_id = order_id;
+    rsp.internal_security_id = InternalSecurityId("XSHE_000001");
+    rsp.trade_side = TradeSide::Buy;
+    rsp.new_state = OrderState::MarketAccepted;
+    rsp.volume_traded = 50;
+    rsp.dprice_traded = 1000;
+    rsp.dvalue_traded = 50000;
+    rsp.dfee = 10;
+    assert(push_trade_response(*primary.trades, rsp));
+    assert(primary.loop->run_once() >= 1);
+
+    // 备机：影子重放后订单与资金与主机一致，路由出的下游消息被丢弃
+    assert(wait_until([&]() {
+        (void)standby.loop->run_once();
+        return standby.loop->stats().replicated_records >= 2;
+    }, 3000));
+    assert(standby.loop->shadowing());
+    assert(standby.orders->header.id_epoch.load() == primary.orders->header.id_epoch.load());
+    const OrderEntry* shadow = standby.book->find_order(order_id);
+    assert(shadow != nullptr);
+    assert(shadow->shm_order_index == order_index);
+    assert(shadow->request.volume_traded == 50);
+    assert(shadow->request.order_state.load() == OrderState::MarketAccepted);
+    const fund_info primary_fund = primary.positions->get_fund_info();
+    const fund_info standby_fund = standby.positions->get_fund_info();
+    assert(standby_fund.available == primary_fund.available);
+    assert(standby_fund.frozen == primary_fund.frozen);
+    assert(standby.downstream->order_queue.empty());
+    assert(sender.dropped_count() == 0);
+    assert(!receiver.out_of_sync() && receiver.gap_count() == 0);
+
+    // 备机提升后按正常路径处理本机上游订单
+    receiver.stop();
+    standby.loop->request_promotion();
+    (void)standby.loop->run_once();
+    assert(!standby.loop->shadowing());
+    OrderRequest next = make_order(0, 10);
+    OrderIndex next_index = kInvalidOrderIndex;
+    assert(orders_shm_append(standby.orders.get(), next, OrderSlotState::UpstreamQueued, order_slot_source_t::User,
+                             now_ns(), next_index));
+    assert(next_index > order_index);
+    assert(standby.upstream->lane(0).try_push(next_index));
+    assert(standby.loop->run_once() == 1);
+    assert(standby.downstream->order_queue.size() == 1);
+
+    sender.stop();
+    primary.loop->finish();
+    standby.loop->finish();
+}
+
+// 验证流量录制与回放：主循环出队的订单、撤单与回报按处理顺序落盘，回放进全新事件循环后订单与资金与录制时一致。
+TEST(traffic_capture_replays_into_fresh_loop) {
+    RiskConfig risk_cfg;
+    risk_cfg.enable_position_check = false;
+    risk_cfg.enable_price_limit_check = false;
+    risk_cfg.enable_duplicate_check = false;
+    risk_cfg.max_order_volume = 0;
+    risk_cfg.max_order_value = 0;
+    risk_cfg.max_orders_per_second = 0;
+    EventLoopConfig loop_cfg;
+    loop_cfg.busy_polling = false;
+    loop_cfg.stats_interval_ms = 0;
+
+    struct node {
+        std::unique_ptr<upstream_shm_layout> upstream = make_upstream_shm();
+        std::unique_ptr<downstream_shm_layout> downstream = make_downstream_shm();
+        std::unique_ptr<trades_shm_layout> trades = make_trades_shm();
+        std::unique_ptr<orders_shm_layout> orders = make_orders_shm();
+        std::unique_ptr<positions_shm_layout> positions_shm = make_positions_shm();
+        std::unique_ptr<PositionManager> positions;
+        std::unique_ptr<RiskManager> risk;
+        std::unique_ptr<OrderBook> book = std::make_unique<OrderBook>();
+        std::unique_ptr<order_router> router;
+        std::unique_ptr<EventLoop> loop;
+
+        node(const RiskConfig& risk_cfg, const EventLoopConfig& loop_cfg, uint32_t epoch_ticket) {
+            upstream->header.next_id_epoch.store(epoch_ticket, std::memory_order_relaxed);
+            positions = std::make_unique<PositionManager>(positions_shm.get());
+            assert(positions->initialize(1));
+            assert(positions->add_security("000001", "PingAn", Market::SZ) == std::string_view("XSHE_000001"));
+            assert(positions->add_fund(10'000'000, 0));
+            risk = std::make_unique<RiskManager>(*positions, risk_cfg);
+            router = std::make_unique<order_router>(*book, downstream.get(), orders.get(), upstream.get());
+            loop = std::make_unique<EventLoop>(loop_cfg, upstream.get(), downstream.get(), trades.get(), orders.get(),
+                                               *book, *router, *positions, *risk, nullptr, nullptr, nullptr);
+        }
+    };
+
+    const std::string path = "/tmp/acct_traffic_capture_" + std::to_string(getpid()) + ".bin";
+    node recorded(risk_cfg, loop_cfg, 3);
+    traffic_capture capture;
+    assert(capture.open(path, 3, 1, orders_shm_bind_id_epoch(recorded.orders.get(), recorded.upstream.get()),
+                        19700101));
+    recorded.loop->set_traffic_capture(&capture);
+    assert(recorded.loop->start());
+
+    // 两笔新单、一笔成交回报、一笔撤单优先队列撤单；第 5 条超出容量，只计丢弃
+    OrderIndex first = kInvalidOrderIndex;
+    OrderIndex second = kInvalidOrderIndex;
+    OrderRequest req = make_order(0, 100);
+    assert(orders_shm_append(recorded.orders.get(), req, OrderSlotState::UpstreamQueued, order_slot_source_t::User,
+                             now_ns(), first));
+    assert(orders_shm_append(recorded.orders.get(), req, OrderSlotState::UpstreamQueued, order_slot_source_t::User,
+                             now_ns(), second));
+    assert(recorded.upstream->lane(0).try_push(first));
+    assert(recorded.upstream->lane(0).try_push(second));
+    assert(recorded.loop->run_once() == 2);
+    const InternalOrderId first_id = orders_shm_order_id(recorded.orders.get(), first);
+    const InternalOrderId second_id = orders_shm_order_id(recorded.orders.get(), second);
+    assert(capture.record_count() == 2);
+
+    TradeResponse rsp{};
+    rsp.internal_order_id = first_id;
+    rsp.internal_security_id = InternalSecurityId("XSHE_000001");
+    rsp.trade_side = TradeSide::Buy;
+    rsp.new_state = OrderState::Finished;
+    rsp.volume_traded = 100;
+    rsp.dprice_traded = 1000;
+    rsp.dvalue_traded = 100000;
+    rsp.dfee = 5;
+    assert(push_trade_response(*recorded.trades, rsp));
+    assert(recorded.loop->run_once() >= 1);
+    assert(capture.record_count() == 3);
+
+    OrderRequest cancel;
+    cancel.init_cancel(0, 93000100, second_id);
+    OrderIndex cancel_index = kInvalidOrderIndex;
+    assert(orders_shm_append(recorded.orders.get(), cancel, OrderSlotState::UpstreamQueued, order_slot_source_t::User,
+                             now_ns(), cancel_index));
+    assert(recorded.upstream->cancel_lane(0).try_push(cancel_index));
+    assert(recorded.loop->run_once() >= 1);
+    assert(capture.record_count() == 3 && capture.dropped_count() == 1);
+    recorded.loop->finish();
+    assert(capture.close());
+
+    traffic_capture_file file;
+    assert(file.open(path));
+    assert(file.record_count() == 3);
+    assert(file.record(0).kind == traffic_capture_kind::Order && file.record(0).index == first);
+    assert(file.record(2).kind == traffic_capture_kind::Response);
+    assert(file.offset_ns(2) >= file.offset_ns(1));
+
+    // 回放端纪元不同，prepare 后沿用录制纪元，回报中的订单号对上同一槽位
+    node replay(risk_cfg, loop_cfg, 9);
+    traffic_replayer replayer(file, replay.upstream.get(), replay.trades.get(), replay.orders.get());
+    replayer.prepare();
+    assert(replay.loop->start());
+    while (!replayer.done()) {
+        (void)replayer.publish_next(1);
+        (void)replay.loop->run_once();
+    }
+    assert(replayer.orders_published() == 2 && replayer.responses_published() == 1);
+    const OrderEntry* replayed_first = replay.book->find_order(first_id);
+    const OrderEntry* replayed_second = replay.book->find_order(second_id);
+    assert(replayed_first != nullptr && replayed_second != nullptr);
+    assert(replayed_first->request.order_state.load() == OrderState::Finished);
+    assert(replayed_first->request.volume_traded == 100);
+    const fund_info recorded_fund = recorded.positions->get_fund_info();
+    const fund_info replayed_fund = replay.positions->get_fund_info();
+    assert(replayed_fund.available == recorded_fund.available);
+    assert(replayed_fund.frozen == recorded_fund.frozen);
+    replay.loop->finish();
+    file.close();
+    std::remove(path.c_str());
+}
+
+TEST(replication_receiver_flags_sequence_gap) {
+    ReplicationConfig repl_cfg;
+    repl_cfg.bind_address = "127.0.0.1";
+    repl_cfg.port = 30000 + static_cast<uint32_t>((getpid() + 7) % 20000);
+    replication_receiver receiver;
+    assert(receiver.start(repl_cfg, 3, 20260301));
+
+    const auto connect_client = [&repl_cfg]() {
+        const int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(static_cast<uint16_t>(repl_cfg.port));
+        (void)::inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+        assert(::connect(fd, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) == 0);
+        return fd;
+    };
+    const auto send_header = [](int fd, replication_frame_type type, AccountId account, uint32_t count) {
+        replication_frame_header header;
+        header.type = static_cast<uint16_t>(type);
+        header.account_id = account;
+        header.record_count = count;
+        header.id_epoch = 9;
+        header.trading_day = 20260301;
+        assert(::send(fd, &header, sizeof(header), MSG_NOSIGNAL) == static_cast<ssize_t>(sizeof(header)));
+    };
+
+    // 账户不符的 Hello 被拒绝，纪元不更新
+    int fd = connect_client();
+    send_header(fd, replication_frame_type::Hello, 4, 0);
+    char byte = 0;
+    assert(::recv(fd, &byte, 1, 0) == 0);
+    ::close(fd);
+    assert(receiver.primary_id_epoch() == 0);
+
+    // 序号 1、3：缺 2，记录照常进入收件环且置失步
+    fd = connect_client();
+    send_header(fd, replication_frame_type::Hello, 3, 0);
+    replication_record records[2];
+    records[0].seq = 1;
+    records[0].kind = replication_record_kind::Response;
+    records[1].seq = 3;
+    records[1].kind = replication_record_kind::Response;
+    send_header(fd, replication_frame_type::Records, 3, 2);
+    assert(::send(fd, records, sizeof(records), MSG_NOSIGNAL) == static_cast<ssize_t>(sizeof(records)));
+    assert(wait_until([&receiver]() { return receiver.received_count() == 2; }));
+    assert(receiver.primary_id_epoch() == 9);
+    assert(receiver.out_of_sync());
+    assert(receiver.gap_count() == 1);
+    replication_record popped[4];
+    assert(receiver.try_pop_bulk(popped, 4) == 2);
+    assert(popped[0].seq == 1 && popped[1].seq == 3);
+    ::close(fd);
+    receiver.stop();
+}
+
 int main() {
     printf("=== Event Loop Test Suite ===\n\n");
 
     RUN_TEST(process_order_and_trade_response);
     RUN_TEST(delay_archive_allows_late_terminal_trade);
     RUN_TEST(reject_second_buy_after_fund_reservation);
+    RUN_TEST(publish_config_hot_reloads_risk_limits);
+    RUN_TEST(steady_state_order_cycle_does_not_allocate);
+    RUN_TEST(response_drain_yields_to_pending_orders);
+    RUN_TEST(latency_histogram_percentiles);
+    RUN_TEST(queue_depth_histogram_tracks_watermark_and_alerts);
+    RUN_TEST(metrics_table_exports_loop_counters);
+    RUN_TEST(flight_recorder_dumps_window_around_outlier);
+    RUN_TEST(timer_wheel_fires_in_deadline_order);
+    RUN_TEST(loop_clock_stamps_one_iteration_once);
+    RUN_TEST(sim_clock_drives_loop_time_and_archive_deadlines);
+    RUN_TEST(round_robin_drains_all_upstream_lanes);
+    RUN_TEST(inline_upstream_orders_skip_slot_reads);
+    RUN_TEST(order_updates_follow_source_lane);
+    RUN_TEST(mass_cancel_expands_by_strategy_and_security);
+    RUN_TEST(admin_commands_run_inside_loop);
+    RUN_TEST(admin_writer_claim_is_exclusive);
+    RUN_TEST(cancel_lane_jumps_queued_orders);
+    RUN_TEST(orders_rollover_waits_for_quiescence_and_switches_pools);
+    RUN_TEST(accepted_replace_amends_order_and_frozen_fund);
+    RUN_TEST(basket_reserves_fund_once_and_all_or_nothing);
+    RUN_TEST(standby_shadow_replays_primary_and_promotes);
+    RUN_TEST(replication_receiver_flags_sequence_gap);
+    RUN_TEST(traffic_capture_replays_into_fresh_loop);
+    RUN_TEST(adaptive_batch_scheduler_splits_budget);
+    RUN_TEST(adaptive_batching_drains_orders_and_responses);
+    RUN_TEST(loop_shape_follows_attached_features);
 
     printf("\n=== All tests passed! ===\n");
     return 0;
@@ -1,16 +1,21 @@
 #include <unistd.h>
 
+#include <atomic>
 #include <cassert>
 #include <chrono>
 #include <cstdio>
 #include <cstring>
+#include <fstream>
 #include <functional>
 #include <memory>
+#include <span>
 #include <string>
 #include <thread>
 
 #include "common/error.hpp"
 #include "core/event_loop.hpp"
+#include "core/restart_checkpoint.hpp"
+#include "execution/active_eval_pool.hpp"
 #include "execution/execution_engine.hpp"
 #include "market_data/market_data_service.hpp"
 #include "order/order_router.hpp"
@@ -32,6 +37,13 @@ namespace {
 
 using namespace acct_service;
 
+// 按 trades_shm 队列的紧凑编码写入一条回报。
+bool push_trade_response(trades_shm_layout& trades, const TradeResponse& response) {
+    trade_response_message message;
+    pack_trade_response_message(response, message);
+    return trades.response_queue.try_push(message);
+}
+
 // 为 snapshot_reader 文件后端测试提供作用域内环境变量控制。
 class ScopedEnvOverride {
 public:
@@ -65,7 +77,7 @@ void init_header(SHMHeader& header) {
     header.version = SHMHeader::kVersion;
     header.create_time = now_ns();
     header.last_update = header.create_time;
-    header.next_order_id.store(1, std::memory_order_relaxed);
+    header.next_id_epoch.store(1, std::memory_order_relaxed);
 }
 
 // 构造上游 SHM 夹具。
@@ -135,6 +147,18 @@ bool wait_until(const std::function<bool()>& predicate, int timeout_ms = 1000) {
     return false;
 }
 
+// 在测试线程上逐轮驱动事件循环，每轮把模拟时钟推进 1ms；只看轮数不看墙钟，并行跑测试时结果不变
+bool drive_until(EventLoop& loop, sim_clock& clock, const std::function<bool()>& predicate, int max_rounds = 1000) {
+    for (int round = 0; round < max_rounds; ++round) {
+        (void)loop.run_once();
+        if (predicate()) {
+            return true;
+        }
+        clock.advance(1'000'000ULL);
+    }
+    return false;
+}
+
 // 生成带执行算法声明的父单请求，供执行引擎接管。
 OrderRequest make_managed_order(InternalOrderId order_id, Volume volume, PassiveExecutionAlgo algo,
                                 TradeSide trade_side = TradeSide::Buy, DPrice price = 1000) {
@@ -260,6 +284,34 @@ private:
 
 }  // namespace
 
+// 记录批量调用次数与批大小；逐个 evaluate() 只在会话创建时的首轮推进中出现。
+class CountingBatchStrategy final : public ActiveStrategy {
+public:
+    const char* name() const noexcept override { return "counting_batch"; }
+
+    ActiveDecision evaluate(const ActiveStrategyContext& context) override {
+        ++single_calls;
+        return ActiveDecision{true, context.budget_volume / 2, context.parent_request.dprice_entrust};
+    }
+
+    void evaluate_many(std::span<const ActiveStrategyContext> contexts,
+                       std::span<ActiveDecision> out_decisions) override {
+        ++batch_calls;
+        last_batch_size = contexts.size();
+        last_batch_features = contexts.empty() ? nullptr : contexts[0].features;
+        for (std::size_t i = 0; i < contexts.size(); ++i) {
+            batch_features_shared = batch_features_shared && contexts[i].features == last_batch_features;
+            out_decisions[i] = ActiveDecision{true, contexts[i].budget_volume / 2, 0};
+        }
+    }
+
+    int single_calls = 0;
+    int batch_calls = 0;
+    std::size_t last_batch_size = 0;
+    const SymbolFeatures* last_batch_features = nullptr;
+    bool batch_features_shared = true;
+};
+
 TEST(twap_falls_back_without_active_strategy) {
     ManagedMarketDataFixture market_data_fixture("acct_exec_engine_no_active", 0.0F, 0,
                                                  snapshot_shm::SnapshotPredictionState::kNone);
@@ -422,11 +474,12 @@ TEST(managed_child_advances_shared_upstream_order_id_sequence) {
 
     std::thread worker([&loop]() { loop.run(); });
 
-    const InternalOrderId first_parent_id = upstream->header.next_order_id.fetch_add(1, std::memory_order_relaxed);
-    OrderRequest first_request = make_managed_order(first_parent_id, 100, PassiveExecutionAlgo::TWAP);
+    OrderRequest first_request = make_managed_order(0, 100, PassiveExecutionAlgo::TWAP);
     OrderIndex first_parent_index = kInvalidOrderIndex;
-    assert(orders_shm_append(orders_shm.get(), first_request, OrderSlotState::UpstreamQueued,
-                             order_slot_source_t::User, now_ns(), first_parent_index));
+    assert(orders_shm_append_assign_id(orders_shm.get(), first_request, OrderSlotState::UpstreamQueued,
+                                       order_slot_source_t::User, now_ns(), first_parent_index));
+    const InternalOrderId first_parent_id = first_request.internal_order_id;
+    assert(order_id_slot_index(first_parent_id) == first_parent_index);
     assert(upstream->upstream_order_queue.try_push(first_parent_index));
 
     assert(wait_until([&downstream]() { return downstream->order_queue.size() > 0; }, 1500));
@@ -438,13 +491,14 @@ TEST(managed_child_advances_shared_upstream_order_id_sequence) {
     assert(orders_shm_read_snapshot(orders_shm.get(), child_index, child_snapshot));
     assert(child_snapshot.request.internal_order_id != first_parent_id);
 
-    const InternalOrderId second_parent_id = upstream->header.next_order_id.fetch_add(1, std::memory_order_relaxed);
-    assert(second_parent_id > child_snapshot.request.internal_order_id);
+    assert(order_id_slot_index(child_snapshot.request.internal_order_id) == child_index);
 
-    OrderRequest second_request = make_managed_order(second_parent_id, 100, PassiveExecutionAlgo::TWAP);
+    OrderRequest second_request = make_managed_order(0, 100, PassiveExecutionAlgo::TWAP);
     OrderIndex second_parent_index = kInvalidOrderIndex;
-    assert(orders_shm_append(orders_shm.get(), second_request, OrderSlotState::UpstreamQueued,
-                             order_slot_source_t::User, now_ns(), second_parent_index));
+    assert(orders_shm_append_assign_id(orders_shm.get(), second_request, OrderSlotState::UpstreamQueued,
+                                       order_slot_source_t::User, now_ns(), second_parent_index));
+    const InternalOrderId second_parent_id = second_request.internal_order_id;
+    assert(second_parent_id > child_snapshot.request.internal_order_id);
     assert(upstream->upstream_order_queue.try_push(second_parent_index));
 
     assert(wait_until(
@@ -650,7 +704,7 @@ TEST(cancelled_parent_stops_future_twap_slices) {
     finished_response.trade_side = TradeSide::Buy;
     finished_response.new_state = OrderState::Finished;
     finished_response.recv_time_ns = now_ns();
-    assert(trades->response_queue.try_push(finished_response));
+    assert(push_trade_response(*trades, finished_response));
 
     assert(wait_until([&book, first_child_id]() {
         const OrderEntry* child = book->find_order(first_child_id);
@@ -742,7 +796,7 @@ TEST(twap_refreshes_child_price_when_market_data_changes_between_slices) {
     first_finished.dvalue_traded =
         static_cast<DValue>(first_finished.volume_traded) * static_cast<DValue>(first_finished.dprice_traded);
     first_finished.recv_time_ns = now_ns();
-    assert(trades->response_queue.try_push(first_finished));
+    assert(push_trade_response(*trades, first_finished));
 
     assert(wait_until([&downstream]() { return downstream->order_queue.size() > 0; }, 1500));
 
@@ -828,7 +882,7 @@ TEST(fixed_size_managed_parent_releases_next_clip) {
     first_finished.dprice_traded = 1000;
     first_finished.dvalue_traded = 40000;
     first_finished.recv_time_ns = now_ns();
-    assert(trades->response_queue.try_push(first_finished));
+    assert(push_trade_response(*trades, first_finished));
 
     assert(wait_until([&downstream]() { return downstream->order_queue.size() > 0; }, 1500));
 
@@ -1119,6 +1173,1009 @@ TEST(twap_falls_back_to_order_price_when_market_levels_invalid_and_fallback_enab
     worker.join();
 }
 
+// 会话只在回报、撤单或片时点到来时推进：在途等待期间多轮 tick 不触达会话
+TEST(twap_sessions_are_event_driven_between_slices) {
+    ManagedMarketDataFixture market_data_fixture("acct_exec_engine_event_driven", 0.0F, 0,
+                                                 snapshot_shm::SnapshotPredictionState::kNone);
+    auto downstream = make_downstream_shm();
+    auto orders_shm = make_orders_shm();
+    auto book = std::make_unique<OrderBook>();
+
+    split_config split_config{};
+    split_config.strategy = SplitStrategy::None;
+    split_config.max_child_volume = 40;
+    split_config.min_child_volume = 1;
+    split_config.max_child_count = 4;
+    split_config.interval_ms = 50;
+    order_router router(*book, downstream.get(), orders_shm.get());
+    ExecutionEngine execution_engine(split_config, *book, router, market_data_fixture.service(), nullptr, nullptr);
+
+    const TimestampNs start_ns = now_ns();
+    // 子单编号沿订单簿序号递增，父单编号拉开间隔避免冲突
+    for (InternalOrderId parent_id = 1000; parent_id <= 3000; parent_id += 1000) {
+        OrderRequest request = make_managed_order(parent_id, 100, PassiveExecutionAlgo::TWAP);
+        OrderEntry entry{};
+        entry.request = request;
+        entry.submit_time_ns = start_ns;
+        entry.last_update_ns = start_ns;
+        entry.shm_order_index = kInvalidOrderIndex;
+        assert(book->add_order(entry));
+        assert(execution_engine.start_session(kInvalidOrderIndex, request, 0, start_ns) ==
+               ExecutionEngine::SessionStartResult::Started);
+    }
+    assert(execution_engine.session_count() == 3);
+    assert(downstream->order_queue.size() == 3);
+
+    // 首片子单在途：会话既不在就绪队列也不占定时器
+    assert(execution_engine.ready_session_count() == 0);
+    for (int i = 0; i < 100; ++i) {
+        execution_engine.tick(start_ns + 1000);
+    }
+    assert(execution_engine.ready_session_count() == 0);
+    assert(downstream->order_queue.size() == 3);
+
+    OrderIndex child_index = kInvalidOrderIndex;
+    assert(downstream->order_queue.try_pop(child_index));
+    order_slot_snapshot child_snapshot{};
+    assert(orders_shm_read_snapshot(orders_shm.get(), child_index, child_snapshot));
+
+    TradeResponse finished_response{};
+    finished_response.internal_order_id = child_snapshot.request.internal_order_id;
+    finished_response.internal_security_id = InternalSecurityId("XSHE_000001");
+    finished_response.trade_side = TradeSide::Buy;
+    finished_response.new_state = OrderState::Finished;
+    finished_response.volume_traded = child_snapshot.request.volume_entrust;
+    finished_response.dvalue_traded = child_snapshot.request.volume_entrust * child_snapshot.request.dprice_entrust;
+    finished_response.recv_time_ns = start_ns + 2000;
+    execution_engine.on_trade_response(finished_response);
+    assert(execution_engine.ready_session_count() == 1);
+
+    // 回报唤醒后推进到下一片，未到片时点时停靠时间轮
+    execution_engine.tick(start_ns + 3000);
+    assert(execution_engine.ready_session_count() == 0);
+    assert(downstream->order_queue.size() == 2);
+
+    execution_engine.tick(start_ns + 50'000'000ULL + 1'000'000ULL);
+    assert(downstream->order_queue.size() == 3);
+    assert(execution_engine.ready_session_count() == 0);
+    assert(execution_engine.session_count() == 3);
+}
+
+// 会话池占满后新父单以 PoolExhausted 拒绝；终态会话回收后槽位可被新父单复用
+TEST(session_pool_rejects_when_full_and_reuses_released_slots) {
+    ManagedMarketDataFixture market_data_fixture("acct_exec_engine_session_pool", 0.0F, 0,
+                                                 snapshot_shm::SnapshotPredictionState::kNone);
+    auto downstream = make_downstream_shm();
+    auto orders_shm = make_orders_shm();
+    auto book = std::make_unique<OrderBook>();
+
+    split_config split_config{};
+    split_config.strategy = SplitStrategy::None;
+    split_config.max_child_volume = 100;
+    split_config.min_child_volume = 1;
+    split_config.max_child_count = 4;
+    split_config.max_sessions = 2;
+    order_router router(*book, downstream.get(), orders_shm.get());
+    ExecutionEngine execution_engine(split_config, *book, router, market_data_fixture.service(), nullptr, nullptr);
+    assert(execution_engine.session_capacity() == 2);
+
+    const TimestampNs start_ns = now_ns();
+    auto start_parent = [&](InternalOrderId parent_id) {
+        OrderRequest request = make_managed_order(parent_id, 100, PassiveExecutionAlgo::FixedSize);
+        OrderEntry entry{};
+        entry.request = request;
+        entry.submit_time_ns = start_ns;
+        entry.last_update_ns = start_ns;
+        entry.shm_order_index = kInvalidOrderIndex;
+        assert(book->add_order(entry));
+        return execution_engine.start_session(kInvalidOrderIndex, request, 0, start_ns);
+    };
+    assert(start_parent(1000) == ExecutionEngine::SessionStartResult::Started);
+    assert(start_parent(2000) == ExecutionEngine::SessionStartResult::Started);
+    assert(start_parent(3000) == ExecutionEngine::SessionStartResult::PoolExhausted);
+    assert(execution_engine.session_count() == 2);
+    assert(downstream->order_queue.size() == 2);
+
+    OrderIndex child_index = kInvalidOrderIndex;
+    assert(downstream->order_queue.try_pop(child_index));
+    order_slot_snapshot child_snapshot{};
+    assert(orders_shm_read_snapshot(orders_shm.get(), child_index, child_snapshot));
+
+    TradeResponse finished_response{};
+    finished_response.internal_order_id = child_snapshot.request.internal_order_id;
+    finished_response.internal_security_id = InternalSecurityId("XSHE_000001");
+    finished_response.trade_side = TradeSide::Buy;
+    finished_response.new_state = OrderState::Finished;
+    finished_response.volume_traded = child_snapshot.request.volume_entrust;
+    finished_response.dvalue_traded = child_snapshot.request.volume_entrust * child_snapshot.request.dprice_entrust;
+    finished_response.recv_time_ns = start_ns + 1000;
+    execution_engine.on_trade_response(finished_response);
+    execution_engine.tick(start_ns + 2000);
+    assert(execution_engine.session_count() == 1);
+
+    // 回收的槽位带着清空后的账本交给新会话，新父单照常发出首笔子单
+    assert(start_parent(4000) == ExecutionEngine::SessionStartResult::Started);
+    assert(execution_engine.session_count() == 2);
+    assert(downstream->order_queue.size() == 2);
+    assert(start_parent(5000) == ExecutionEngine::SessionStartResult::PoolExhausted);
+}
+
+// 收盘集中终态：tick 只归还 kRetiredReclaimPerTick 个会话，其余留在待回收列表分到后续各轮；池满时先当场回收再判断
+TEST(finished_sessions_are_reclaimed_in_bounded_steps) {
+    ManagedMarketDataFixture market_data_fixture("acct_exec_engine_session_retire", 0.0F, 0,
+                                                 snapshot_shm::SnapshotPredictionState::kNone);
+    auto downstream = make_downstream_shm();
+    auto orders_shm = make_orders_shm();
+    auto book = std::make_unique<OrderBook>();
+
+    constexpr std::size_t kSessions = ExecutionEngine::kRetiredReclaimPerTick + 8;
+    split_config split_config{};
+    split_config.strategy = SplitStrategy::None;
+    split_config.max_child_volume = 100;
+    split_config.min_child_volume = 1;
+    split_config.max_child_count = 4;
+    split_config.max_sessions = static_cast<uint32_t>(kSessions);
+    order_router router(*book, downstream.get(), orders_shm.get());
+    ExecutionEngine execution_engine(split_config, *book, router, market_data_fixture.service(), nullptr, nullptr);
+
+    const TimestampNs start_ns = now_ns();
+    auto start_parent = [&](InternalOrderId parent_id) {
+        OrderRequest request = make_managed_order(parent_id, 100, PassiveExecutionAlgo::FixedSize);
+        OrderEntry entry{};
+        entry.request = request;
+        entry.submit_time_ns = start_ns;
+        entry.last_update_ns = start_ns;
+        entry.shm_order_index = kInvalidOrderIndex;
+        assert(book->add_order(entry));
+        return execution_engine.start_session(kInvalidOrderIndex, request, 0, start_ns);
+    };
+    // 把下游队列里的子单全部成交，所属会话在下一轮 tick 终态
+    auto fill_children = [&]() {
+        OrderIndex child_index = kInvalidOrderIndex;
+        while (downstream->order_queue.try_pop(child_index)) {
+            order_slot_snapshot child_snapshot{};
+            assert(orders_shm_read_snapshot(orders_shm.get(), child_index, child_snapshot));
+            TradeResponse response{};
+            response.internal_order_id = child_snapshot.request.internal_order_id;
+            response.internal_security_id = InternalSecurityId("XSHE_000001");
+            response.trade_side = TradeSide::Buy;
+            response.new_state = OrderState::Finished;
+            response.volume_traded = child_snapshot.request.volume_entrust;
+            response.dvalue_traded = child_snapshot.request.volume_entrust * child_snapshot.request.dprice_entrust;
+            response.recv_time_ns = start_ns + 1000;
+            execution_engine.on_trade_response(response);
+        }
+    };
+
+    for (std::size_t i = 0; i < kSessions; ++i) {
+        assert(start_parent(static_cast<InternalOrderId>(1000 + i)) == ExecutionEngine::SessionStartResult::Started);
+    }
+    fill_children();
+    assert(execution_engine.tick(start_ns + 2000) == kSessions);
+    assert(execution_engine.session_count() == 0);
+    assert(execution_engine.retired_session_count() == kSessions - ExecutionEngine::kRetiredReclaimPerTick);
+
+    // 归还的槽位先被新父单取走；池满后再启动时当场回收一个待回收会话
+    for (std::size_t i = 0; i < ExecutionEngine::kRetiredReclaimPerTick; ++i) {
+        assert(start_parent(static_cast<InternalOrderId>(5000 + i)) == ExecutionEngine::SessionStartResult::Started);
+    }
+    assert(start_parent(9000) == ExecutionEngine::SessionStartResult::Started);
+    assert(execution_engine.retired_session_count() == kSessions - ExecutionEngine::kRetiredReclaimPerTick - 1);
+    assert(execution_engine.session_count() == ExecutionEngine::kRetiredReclaimPerTick + 1);
+
+    // 空闲轮次继续分批归还，直到列表清空
+    assert(execution_engine.tick(start_ns + 3000) == 0);
+    assert(execution_engine.retired_session_count() == 0);
+}
+
+// 篮子批量启动：结果与请求按下标对应，各腿首片立即发出，后续片按预算好的绝对时点停靠时间轮
+TEST(start_sessions_starts_basket_legs_in_one_call) {
+    ManagedMarketDataFixture market_data_fixture("acct_exec_engine_batch_start", 0.0F, 0,
+                                                 snapshot_shm::SnapshotPredictionState::kNone);
+    auto downstream = make_downstream_shm();
+    auto orders_shm = make_orders_shm();
+    auto book = std::make_unique<OrderBook>();
+
+    split_config split_config{};
+    split_config.strategy = SplitStrategy::None;
+    split_config.max_child_volume = 50;
+    split_config.min_child_volume = 1;
+    split_config.max_child_count = 4;
+    split_config.interval_ms = 50;
+    order_router router(*book, downstream.get(), orders_shm.get());
+    ExecutionEngine execution_engine(split_config, *book, router, market_data_fixture.service(), nullptr, nullptr);
+
+    const TimestampNs start_ns = now_ns();
+    std::vector<OrderRequest> parents;
+    for (InternalOrderId parent_id : {InternalOrderId{8100}, InternalOrderId{8200}, InternalOrderId{8300}}) {
+        parents.push_back(make_managed_order(parent_id, 100, PassiveExecutionAlgo::TWAP));
+        OrderEntry entry{};
+        entry.request = parents.back();
+        entry.submit_time_ns = start_ns;
+        entry.last_update_ns = start_ns;
+        entry.shm_order_index = kInvalidOrderIndex;
+        assert(book->add_order(entry));
+    }
+
+    std::vector<session_start_request> requests;
+    for (const OrderRequest& parent : parents) {
+        requests.push_back(session_start_request{kInvalidOrderIndex, &parent, 0, start_ns});
+    }
+    // 同一父单重复出现在篮子中时只有首次成功
+    requests.push_back(session_start_request{kInvalidOrderIndex, &parents[1], 0, start_ns});
+    std::vector<ExecutionEngine::SessionStartResult> results(requests.size());
+    // 三条腿同一证券：首轮推进共享一次快照读取
+    const uint64_t reads_before_start = market_data_fixture.service()->snapshot_reads();
+    assert(execution_engine.start_sessions(requests, results) == 3);
+    assert(market_data_fixture.service()->snapshot_reads() == reads_before_start + 1);
+    assert(results[0] == ExecutionEngine::SessionStartResult::Started);
+    assert(results[2] == ExecutionEngine::SessionStartResult::Started);
+    assert(results[3] == ExecutionEngine::SessionStartResult::Duplicate);
+    assert(execution_engine.session_count() == 3);
+    assert(downstream->order_queue.size() == 3);
+
+    for (int i = 0; i < 3; ++i) {
+        OrderIndex child_index = kInvalidOrderIndex;
+        assert(downstream->order_queue.try_pop(child_index));
+        order_slot_snapshot child_snapshot{};
+        assert(orders_shm_read_snapshot(orders_shm.get(), child_index, child_snapshot));
+        assert(child_snapshot.request.volume_entrust == 50);
+
+        TradeResponse finished_response{};
+        finished_response.internal_order_id = child_snapshot.request.internal_order_id;
+        finished_response.internal_security_id = InternalSecurityId("XSHE_000001");
+        finished_response.trade_side = TradeSide::Buy;
+        finished_response.new_state = OrderState::Finished;
+        finished_response.volume_traded = child_snapshot.request.volume_entrust;
+        finished_response.dvalue_traded = child_snapshot.request.volume_entrust * child_snapshot.request.dprice_entrust;
+        finished_response.recv_time_ns = start_ns + 1000;
+        execution_engine.on_trade_response(finished_response);
+    }
+    execution_engine.tick(start_ns + 2000);
+    assert(downstream->order_queue.size() == 0);
+
+    // 第二片时点为 start_ns + interval，早 1ns 不发，到点全部发出
+    execution_engine.tick(start_ns + 50'000'000ULL - 1);
+    assert(downstream->order_queue.size() == 0);
+    const uint64_t reads_before_slice = market_data_fixture.service()->snapshot_reads();
+    execution_engine.tick(start_ns + 50'000'000ULL + 1'000'000ULL);
+    assert(downstream->order_queue.size() == 3);
+    assert(market_data_fixture.service()->snapshot_reads() == reads_before_slice + 1);
+}
+
+// 冰山当前 clip 成交终态后，replenish_clips() 当场发出下一笔，不经过 tick
+TEST(iceberg_replenishes_clip_on_fill_without_tick) {
+    ManagedMarketDataFixture market_data_fixture("acct_exec_engine_iceberg_refill", 0.0F, 0,
+                                                 snapshot_shm::SnapshotPredictionState::kNone);
+    auto downstream = make_downstream_shm();
+    auto orders_shm = make_orders_shm();
+    auto book = std::make_unique<OrderBook>();
+
+    split_config split_config{};
+    split_config.strategy = SplitStrategy::None;
+    split_config.max_child_volume = 30;
+    split_config.min_child_volume = 1;
+    split_config.max_child_count = 8;
+    order_router router(*book, downstream.get(), orders_shm.get());
+    ExecutionEngine execution_engine(split_config, *book, router, market_data_fixture.service(), nullptr, nullptr);
+
+    const TimestampNs start_ns = now_ns();
+    const OrderRequest parent = make_managed_order(8400, 90, PassiveExecutionAlgo::Iceberg);
+    OrderEntry entry{};
+    entry.request = parent;
+    entry.submit_time_ns = start_ns;
+    entry.last_update_ns = start_ns;
+    entry.shm_order_index = kInvalidOrderIndex;
+    assert(book->add_order(entry));
+    assert(execution_engine.start_session(kInvalidOrderIndex, parent, 0, start_ns) ==
+           ExecutionEngine::SessionStartResult::Started);
+
+    for (int clip = 0; clip < 3; ++clip) {
+        OrderIndex child_index = kInvalidOrderIndex;
+        assert(downstream->order_queue.try_pop(child_index));
+        order_slot_snapshot child_snapshot{};
+        assert(orders_shm_read_snapshot(orders_shm.get(), child_index, child_snapshot));
+        assert(child_snapshot.request.volume_entrust == 30);
+
+        // 部分成交不补单
+        TradeResponse partial_response{};
+        partial_response.internal_order_id = child_snapshot.request.internal_order_id;
+        partial_response.internal_security_id = InternalSecurityId("XSHE_000001");
+        partial_response.trade_side = TradeSide::Buy;
+        partial_response.new_state = OrderState::MarketAccepted;
+        partial_response.volume_traded = 10;
+        partial_response.dvalue_traded = 10 * child_snapshot.request.dprice_entrust;
+        execution_engine.on_trade_response(partial_response);
+        execution_engine.replenish_clips(start_ns);
+        assert(downstream->order_queue.size() == 0);
+
+        TradeResponse finished_response = partial_response;
+        finished_response.new_state = OrderState::Finished;
+        finished_response.volume_traded = 20;
+        finished_response.dvalue_traded = 20 * child_snapshot.request.dprice_entrust;
+        execution_engine.on_trade_response(finished_response);
+        execution_engine.replenish_clips(start_ns);
+        assert(downstream->order_queue.size() == (clip < 2 ? 1U : 0U));
+    }
+
+    // 末笔 clip 成交后父单在补单推进中完成，会话当场收尾
+    assert(execution_engine.session_count() == 0);
+    execution_engine.tick(start_ns);
+    assert(downstream->order_queue.size() == 0);
+    const OrderEntry* parent_entry = book->find_order(8400);
+    assert(parent_entry != nullptr);
+    assert(parent_entry->request.volume_traded == 90);
+}
+
+// 父单镜像的 working/traded/fee 与最佳进度状态随子单回报按差量累计
+TEST(managed_parent_view_tracks_incremental_child_totals) {
+    ManagedMarketDataFixture market_data_fixture("acct_exec_engine_ledger_totals", 0.0F, 0,
+                                                 snapshot_shm::SnapshotPredictionState::kNone);
+    auto downstream = make_downstream_shm();
+    auto orders_shm = make_orders_shm();
+    auto book = std::make_unique<OrderBook>();
+
+    split_config split_config{};
+    split_config.strategy = SplitStrategy::None;
+    split_config.max_child_volume = 40;
+    split_config.min_child_volume = 1;
+    split_config.max_child_count = 4;
+    split_config.interval_ms = 1;
+    order_router router(*book, downstream.get(), orders_shm.get());
+    ExecutionEngine execution_engine(split_config, *book, router, market_data_fixture.service(), nullptr, nullptr);
+
+    const TimestampNs start_ns = now_ns();
+    OrderRequest request = make_managed_order(5000, 100, PassiveExecutionAlgo::FixedSize);
+    OrderEntry entry{};
+    entry.request = request;
+    entry.submit_time_ns = start_ns;
+    entry.last_update_ns = start_ns;
+    entry.shm_order_index = kInvalidOrderIndex;
+    assert(book->add_order(entry));
+    assert(execution_engine.start_session(kInvalidOrderIndex, request, 0, start_ns) ==
+           ExecutionEngine::SessionStartResult::Started);
+
+    auto pop_child_id = [&]() {
+        OrderIndex child_index = kInvalidOrderIndex;
+        assert(downstream->order_queue.try_pop(child_index));
+        order_slot_snapshot snapshot{};
+        assert(orders_shm_read_snapshot(orders_shm.get(), child_index, snapshot));
+        return snapshot.request.internal_order_id;
+    };
+    auto respond = [&](InternalOrderId child_id, OrderState state, Volume traded, Volume cancelled) {
+        TradeResponse response{};
+        response.internal_order_id = child_id;
+        response.internal_security_id = InternalSecurityId("XSHE_000001");
+        response.trade_side = TradeSide::Buy;
+        response.new_state = state;
+        response.volume_traded = traded;
+        response.dvalue_traded = traded * 999;
+        response.dfee = traded > 0 ? 1 : 0;
+        response.cancelled_volume = cancelled;
+        response.recv_time_ns = now_ns();
+        execution_engine.on_trade_response(response);
+        execution_engine.tick(now_ns());
+    };
+    const OrderEntry* parent = book->find_order(5000);
+    assert(parent != nullptr);
+
+    const InternalOrderId first_child = pop_child_id();
+    assert(parent->request.working_volume == 40);
+    respond(first_child, OrderState::MarketAccepted, 10, 0);
+    assert(parent->request.working_volume == 30);
+    assert(parent->request.volume_traded == 10);
+    assert(parent->request.dvalue_traded == 9990);
+    assert(parent->request.dfee_executed == 1);
+    assert(parent->request.order_state.load(std::memory_order_acquire) == OrderState::MarketAccepted);
+
+    respond(first_child, OrderState::Finished, 30, 0);
+    const InternalOrderId second_child = pop_child_id();
+    assert(parent->request.volume_traded == 40);
+    assert(parent->request.dfee_executed == 2);
+    assert(parent->request.working_volume == 40);
+    assert(parent->request.schedulable_volume == 20);
+    assert(parent->request.order_state.load(std::memory_order_acquire) == OrderState::TraderSubmitted);
+
+    // 撤销量释放预算但不计成交
+    respond(second_child, OrderState::Finished, 0, 40);
+    (void)pop_child_id();
+    assert(parent->request.volume_traded == 40);
+    assert(parent->request.working_volume == 40);
+    assert(parent->request.schedulable_volume == 20);
+}
+
+TEST(active_twap_session_wakes_only_on_market_data_advance) {
+    ManagedMarketDataFixture market_data_fixture("acct_exec_engine_md_watch", 0.0F, 0,
+                                                 snapshot_shm::SnapshotPredictionState::kNone);
+    auto downstream = make_downstream_shm();
+    auto orders_shm = make_orders_shm();
+    auto book = std::make_unique<OrderBook>();
+
+    split_config split_config{};
+    split_config.strategy = SplitStrategy::None;
+    split_config.max_child_volume = 40;
+    split_config.min_child_volume = 1;
+    split_config.max_child_count = 4;
+    split_config.interval_ms = 60'000;
+    order_router router(*book, downstream.get(), orders_shm.get());
+    ExecutionEngine execution_engine(split_config, *book, router, market_data_fixture.service(), nullptr,
+                                     std::make_unique<FixedDecisionStrategy>(17, 998));
+
+    const TimestampNs start_ns = now_ns();
+    OrderRequest request = make_managed_order(7000, 100, PassiveExecutionAlgo::TWAP);
+    OrderEntry entry{};
+    entry.request = request;
+    entry.submit_time_ns = start_ns;
+    entry.last_update_ns = start_ns;
+    entry.shm_order_index = kInvalidOrderIndex;
+    assert(book->add_order(entry));
+    assert(execution_engine.start_session(kInvalidOrderIndex, request, 0, start_ns) ==
+           ExecutionEngine::SessionStartResult::Started);
+
+    auto pop_child = [&]() {
+        OrderIndex child_index = kInvalidOrderIndex;
+        assert(downstream->order_queue.try_pop(child_index));
+        order_slot_snapshot snapshot{};
+        assert(orders_shm_read_snapshot(orders_shm.get(), child_index, snapshot));
+        return snapshot.request;
+    };
+
+    // 首片无 fresh prediction，片时点已到走被动片额
+    const OrderRequest first_child = pop_child();
+    assert(first_child.volume_entrust == 34);
+
+    TradeResponse response{};
+    response.internal_order_id = first_child.internal_order_id;
+    response.internal_security_id = InternalSecurityId("XSHE_000001");
+    response.trade_side = TradeSide::Buy;
+    response.new_state = OrderState::Finished;
+    response.volume_traded = 34;
+    response.dvalue_traded = 34 * 999;
+    response.recv_time_ns = now_ns();
+    execution_engine.on_trade_response(response);
+
+    // 第二片距片时点尚远：行情未前进时会话停靠，不参与逐轮评估
+    execution_engine.tick(now_ns());
+    for (int i = 0; i < 5; ++i) {
+        execution_engine.tick(now_ns());
+        assert(execution_engine.ready_session_count() == 0);
+    }
+    assert(downstream->order_queue.size() == 0);
+
+    market_data_fixture.publish_snapshot(
+        make_snapshot(), 1.0F, snapshot_shm::kSnapshotSlotFlagHasSignal | snapshot_shm::kSnapshotSlotFlagSignalFresh,
+        snapshot_shm::SnapshotPredictionState::kFresh);
+    execution_engine.tick(now_ns());
+    const OrderRequest active_child = pop_child();
+    assert(active_child.volume_entrust == 17);
+    assert(active_child.dprice_entrust == 999);
+}
+
+TEST(active_candidates_are_scored_in_one_batch) {
+    ManagedMarketDataFixture market_data_fixture("acct_exec_engine_batch_eval", 0.0F, 0,
+                                                 snapshot_shm::SnapshotPredictionState::kNone);
+    auto downstream = make_downstream_shm();
+    auto orders_shm = make_orders_shm();
+    auto book = std::make_unique<OrderBook>();
+
+    split_config split_config{};
+    split_config.strategy = SplitStrategy::None;
+    split_config.max_child_volume = 40;
+    split_config.min_child_volume = 1;
+    split_config.max_child_count = 4;
+    split_config.interval_ms = 60'000;
+    order_router router(*book, downstream.get(), orders_shm.get());
+    auto strategy = std::make_unique<CountingBatchStrategy>();
+    CountingBatchStrategy* counting = strategy.get();
+    ExecutionEngine execution_engine(split_config, *book, router, market_data_fixture.service(), nullptr,
+                                     std::move(strategy));
+
+    auto pop_child = [&]() {
+        OrderIndex child_index = kInvalidOrderIndex;
+        assert(downstream->order_queue.try_pop(child_index));
+        order_slot_snapshot snapshot{};
+        assert(orders_shm_read_snapshot(orders_shm.get(), child_index, snapshot));
+        return snapshot.request;
+    };
+
+    const TimestampNs start_ns = now_ns();
+    std::vector<OrderRequest> first_children;
+    for (InternalOrderId parent_id : {InternalOrderId{7100}, InternalOrderId{7200}}) {
+        OrderRequest request = make_managed_order(parent_id, 100, PassiveExecutionAlgo::TWAP);
+        OrderEntry entry{};
+        entry.request = request;
+        entry.submit_time_ns = start_ns;
+        entry.last_update_ns = start_ns;
+        entry.shm_order_index = kInvalidOrderIndex;
+        assert(book->add_order(entry));
+        assert(execution_engine.start_session(kInvalidOrderIndex, request, 0, start_ns) ==
+               ExecutionEngine::SessionStartResult::Started);
+        first_children.push_back(pop_child());
+    }
+
+    for (const OrderRequest& child : first_children) {
+        TradeResponse response{};
+        response.internal_order_id = child.internal_order_id;
+        response.internal_security_id = InternalSecurityId("XSHE_000001");
+        response.trade_side = TradeSide::Buy;
+        response.new_state = OrderState::Finished;
+        response.volume_traded = child.volume_entrust;
+        response.dvalue_traded = child.volume_entrust * 999;
+        response.recv_time_ns = now_ns();
+        execution_engine.on_trade_response(response);
+    }
+    execution_engine.tick(now_ns());
+    assert(counting->batch_calls == 0);
+
+    // 行情前进后两个父单在同一轮一次批量打分，不再逐会话调用 evaluate()
+    const int single_calls_before = counting->single_calls;
+    market_data_fixture.publish_snapshot(
+        make_snapshot(), 1.0F, snapshot_shm::kSnapshotSlotFlagHasSignal | snapshot_shm::kSnapshotSlotFlagSignalFresh,
+        snapshot_shm::SnapshotPredictionState::kFresh);
+    execution_engine.tick(now_ns());
+    assert(counting->batch_calls == 1);
+    assert(counting->last_batch_size == 2);
+    assert(counting->single_calls == single_calls_before);
+    // 同证券两个父单拿到同一份特征，本次发布只纳入一次
+    assert(counting->last_batch_features != nullptr);
+    assert(counting->batch_features_shared);
+    assert(counting->last_batch_features->signal == 1.0F);
+    assert(counting->last_batch_features->history.size() == counting->last_batch_features->updates);
+    assert(execution_engine.feature_store().find(market_data_fixture.service()->resolve(
+               "XSHE_000001")) == counting->last_batch_features);
+    assert(pop_child().volume_entrust == 16);
+    assert(pop_child().volume_entrust == 16);
+}
+
+// 可重入策略：决策只由上下文决定，批量调用次数用原子计数
+class ReentrantBatchStrategy final : public ActiveStrategy {
+public:
+    const char* name() const noexcept override { return "reentrant_batch"; }
+
+    ActiveDecision evaluate(const ActiveStrategyContext& context) override {
+        return ActiveDecision{true, context.budget_volume / 2, context.parent_request.dprice_entrust};
+    }
+
+    void evaluate_many(std::span<const ActiveStrategyContext> contexts,
+                       std::span<ActiveDecision> out_decisions) override {
+        batch_calls.fetch_add(1, std::memory_order_relaxed);
+        for (std::size_t i = 0; i < contexts.size(); ++i) {
+            out_decisions[i] = evaluate(contexts[i]);
+        }
+    }
+
+    std::atomic<int> batch_calls{0};
+};
+
+// 并行评估按块分给 worker，结果按下标与串行评估一致；小批量留在调用线程内一次评估
+TEST(active_eval_pool_matches_serial_decisions) {
+    ReentrantBatchStrategy strategy;
+    active_eval_pool pool(strategy, 3);
+    assert(pool.worker_count() == 3);
+
+    const MarketDataView view{};
+    std::vector<OrderRequest> parents(200);
+    std::vector<ActiveStrategyContext> contexts;
+    contexts.reserve(parents.size());
+    for (std::size_t i = 0; i < parents.size(); ++i) {
+        parents[i] = make_managed_order(static_cast<InternalOrderId>(9000 + i), 100, PassiveExecutionAlgo::TWAP);
+        parents[i].dprice_entrust = static_cast<DPrice>(1000 + i);
+        contexts.push_back(ActiveStrategyContext{parents[i], view, static_cast<Volume>(2 * i + 2)});
+    }
+
+    std::vector<ActiveDecision> decisions(3);
+    pool.evaluate(std::span<const ActiveStrategyContext>(contexts.data(), 3), decisions);
+    assert(strategy.batch_calls.load() == 1);
+    assert(decisions[2].volume == 3);
+
+    // 多轮不同批量复用同一组 worker，每轮都须覆盖全部下标
+    for (std::size_t round = 0; round < 50; ++round) {
+        const std::size_t count = 17 + (round * 37) % (contexts.size() - 17);
+        decisions.assign(count, ActiveDecision{});
+        strategy.batch_calls.store(0);
+        pool.evaluate(std::span<const ActiveStrategyContext>(contexts.data(), count), decisions);
+        assert(strategy.batch_calls.load() > 1);
+        for (std::size_t i = 0; i < count; ++i) {
+            assert(decisions[i].should_submit);
+            assert(decisions[i].volume == static_cast<Volume>(i + 1));
+            assert(decisions[i].price == static_cast<DPrice>(1000 + i));
+        }
+    }
+}
+
+TEST(vwap_slices_follow_volume_profile_weights) {
+    ManagedMarketDataFixture market_data_fixture("acct_exec_engine_vwap_profile", 0.0F, 0,
+                                                 snapshot_shm::SnapshotPredictionState::kNone);
+    auto downstream = make_downstream_shm();
+    auto orders_shm = make_orders_shm();
+    auto book = std::make_unique<OrderBook>();
+
+    // 09:30 起两个 1ms bin，前重后轻；第二只证券仅用于校验二分查找
+    const std::string profile_path = unique_snapshot_path("acct_exec_engine_vwap_profile");
+    assert(volume_profile::write_file(profile_path, 34'200'000U, 1U,
+                                      {{"XSHG_600000", {1, 1}}, {"XSHE_000001", {3, 1}}}));
+    volume_profile profile;
+    assert(profile.open(profile_path));
+    assert(profile.security_count() == 2);
+    assert(profile.find("XSHE_000001") != nullptr);
+    assert(profile.find("XSHE_000002") == nullptr);
+    assert(profile.window_weight(profile.find("XSHE_000001"), 34'200'000U, 34'200'002U) == 4);
+
+    split_config split_config{};
+    split_config.strategy = SplitStrategy::None;
+    split_config.max_child_volume = 50;
+    split_config.min_child_volume = 1;
+    split_config.max_child_count = 4;
+    split_config.interval_ms = 1;
+    order_router router(*book, downstream.get(), orders_shm.get());
+    ExecutionEngine execution_engine(split_config, *book, router, market_data_fixture.service(), nullptr, nullptr,
+                                     &profile);
+
+    const TimestampNs start_ns = now_ns();
+    OrderRequest request = make_managed_order(6000, 100, PassiveExecutionAlgo::VWAP);
+    OrderEntry entry{};
+    entry.request = request;
+    entry.submit_time_ns = start_ns;
+    entry.last_update_ns = start_ns;
+    entry.shm_order_index = kInvalidOrderIndex;
+    assert(book->add_order(entry));
+    assert(execution_engine.start_session(kInvalidOrderIndex, request, 0, start_ns) ==
+           ExecutionEngine::SessionStartResult::Started);
+
+    auto pop_child = [&]() {
+        OrderIndex child_index = kInvalidOrderIndex;
+        assert(wait_until([&]() {
+            execution_engine.tick(now_ns());
+            return downstream->order_queue.try_pop(child_index);
+        }));
+        order_slot_snapshot snapshot{};
+        assert(orders_shm_read_snapshot(orders_shm.get(), child_index, snapshot));
+        return snapshot.request;
+    };
+
+    const OrderRequest first_child = pop_child();
+    assert(first_child.volume_entrust == 75);
+
+    TradeResponse response{};
+    response.internal_order_id = first_child.internal_order_id;
+    response.internal_security_id = InternalSecurityId("XSHE_000001");
+    response.trade_side = TradeSide::Buy;
+    response.new_state = OrderState::Finished;
+    response.volume_traded = 75;
+    response.dvalue_traded = 75 * 1000;
+    response.recv_time_ns = now_ns();
+    execution_engine.on_trade_response(response);
+
+    const OrderRequest second_child = pop_child();
+    assert(second_child.volume_entrust == 25);
+
+    // 分布表未收录的证券不能回退等分
+    OrderRequest missing;
+    missing.init_new("000002", InternalSecurityId("XSHE_000002"), 6100, TradeSide::Buy, Market::SZ, 100, 1000,
+                     93000000);
+    missing.passive_execution_algo = PassiveExecutionAlgo::VWAP;
+    assert(execution_engine.start_session(kInvalidOrderIndex, missing, 0, start_ns) ==
+           ExecutionEngine::SessionStartResult::VolumeProfileUnavailable);
+
+    profile.close();
+    std::remove(profile_path.c_str());
+}
+
+TEST(volume_profile_rejects_invalid_file) {
+    const std::string profile_path = unique_snapshot_path("acct_exec_engine_bad_profile");
+    {
+        std::ofstream out(profile_path, std::ios::binary | std::ios::trunc);
+        const uint32_t garbage[6] = {1, 1, 1, 1, 0, 1};
+        out.write(reinterpret_cast<const char*>(garbage), sizeof(garbage));
+    }
+    volume_profile profile;
+    assert(!profile.open(profile_path));
+    assert(!profile.is_loaded());
+    assert(profile.find("XSHE_000001") == nullptr);
+    std::remove(profile_path.c_str());
+}
+
+TEST(restart_checkpoint_restores_sessions_and_replays_later_slots) {
+    ManagedMarketDataFixture market_data_fixture("acct_exec_engine_checkpoint", 0.0F, 0,
+                                                 snapshot_shm::SnapshotPredictionState::kNone);
+    auto upstream = make_upstream_shm();
+    auto downstream = make_downstream_shm();
+    auto trades = make_trades_shm();
+    auto orders_shm = make_orders_shm();
+    auto positions_shm = make_positions_shm();
+
+    PositionManager positions(positions_shm.get());
+    assert(positions.initialize(1));
+
+    RiskConfig risk_config;
+    risk_config.enable_position_check = false;
+    risk_config.enable_price_limit_check = false;
+    risk_config.enable_duplicate_check = false;
+    RiskManager risk(positions, risk_config);
+
+    split_config split_config{};
+    split_config.strategy = SplitStrategy::None;
+    split_config.max_child_volume = 40;
+    split_config.min_child_volume = 1;
+    split_config.max_child_count = 4;
+    split_config.interval_ms = 1;
+
+    EventLoopConfig loop_config{};
+    loop_config.busy_polling = false;
+    loop_config.idle_sleep_us = 50;
+    loop_config.poll_batch_size = 32;
+    loop_config.stats_interval_ms = 0;
+
+    const std::string checkpoint_path = unique_snapshot_path("acct_exec_engine_restart") + ".bin";
+    InternalOrderId first_child_id = 0;
+    InternalOrderId second_child_id = 0;
+    {
+        OrderBook book;
+        order_router router(book, downstream.get(), orders_shm.get(), upstream.get());
+        ExecutionEngine execution_engine(split_config, book, router, market_data_fixture.service(), nullptr, nullptr);
+        EventLoop loop(loop_config, upstream.get(), downstream.get(), trades.get(), orders_shm.get(), book, router,
+                       positions, risk, nullptr, &execution_engine);
+        sim_clock clock(now_ns());
+        loop.set_sim_clock(&clock);
+        assert(loop.start());
+
+        OrderRequest request = make_managed_order(905, 100, PassiveExecutionAlgo::FixedSize);
+        OrderIndex parent_index = kInvalidOrderIndex;
+        assert(orders_shm_append(orders_shm.get(), request, OrderSlotState::UpstreamQueued,
+                                 order_slot_source_t::User, now_ns(), parent_index));
+        assert(upstream->upstream_order_queue.try_push(parent_index));
+
+        assert(drive_until(loop, clock, [&downstream]() { return downstream->order_queue.size() > 0; }));
+        OrderIndex first_child_index = kInvalidOrderIndex;
+        assert(downstream->order_queue.try_pop(first_child_index));
+        order_slot_snapshot first_child{};
+        assert(orders_shm_read_snapshot(orders_shm.get(), first_child_index, first_child));
+        first_child_id = first_child.request.internal_order_id;
+
+        // 检查点只看到第一笔子单在途；之后的成交与第二笔子单只落在 orders_shm
+        loop.finish();
+        restart_checkpoint checkpoint;
+        checkpoint.account_id = 1;
+        checkpoint.trading_day = "19700101";
+        capture_restart_checkpoint(book, orders_shm.get(), &execution_engine, checkpoint);
+        assert(checkpoint.sessions.size() == 1);
+        assert(checkpoint.children.size() == 1);
+        assert(write_restart_checkpoint(checkpoint_path, checkpoint));
+
+        assert(loop.start());
+        TradeResponse finished{};
+        finished.internal_order_id = first_child_id;
+        finished.internal_security_id = InternalSecurityId("XSHE_000001");
+        finished.trade_side = TradeSide::Buy;
+        finished.new_state = OrderState::Finished;
+        finished.volume_traded = 40;
+        finished.dprice_traded = 1000;
+        finished.dvalue_traded = 40000;
+        finished.recv_time_ns = clock.now_ns();
+        assert(push_trade_response(*trades, finished));
+
+        assert(drive_until(loop, clock, [&downstream]() { return downstream->order_queue.size() > 0; }));
+        OrderIndex second_child_index = kInvalidOrderIndex;
+        assert(downstream->order_queue.try_pop(second_child_index));
+        order_slot_snapshot second_child{};
+        assert(orders_shm_read_snapshot(orders_shm.get(), second_child_index, second_child));
+        second_child_id = second_child.request.internal_order_id;
+        loop.finish();
+    }
+
+    restart_checkpoint loaded;
+    assert(read_restart_checkpoint(checkpoint_path, loaded));
+    assert(loaded.account_id == 1);
+    assert(loaded.trading_day == "19700101");
+
+    OrderBook book;
+    order_router router(book, downstream.get(), orders_shm.get(), upstream.get());
+    bool applied = false;
+    assert(router.recover_downstream_active_orders(nullptr, &loaded.orders, &applied));
+    assert(applied);
+
+    InternalOrderId parent_id = 0;
+    assert(book.try_get_parent(first_child_id, parent_id) && parent_id == 905);
+    assert(book.try_get_parent(second_child_id, parent_id) && parent_id == 905);
+    const OrderEntry* first_child = book.find_order(first_child_id);
+    assert(first_child != nullptr);
+    assert(first_child->request.volume_traded == 40);
+    assert(first_child->request.order_state.load() == OrderState::Finished);
+
+    ExecutionEngine execution_engine(split_config, book, router, market_data_fixture.service(), nullptr, nullptr);
+    assert(execution_engine.restore_checkpoint(loaded.sessions, loaded.children) == 1);
+    execution_engine.tick(now_ns());
+
+    // 对账后父单镜像与停机前一致，且不会因漏记第二笔子单而重复下单
+    const OrderEntry* parent = book.find_order(905);
+    assert(parent != nullptr);
+    assert(parent->request.execution_state == ExecutionState::Running);
+    assert(parent->request.volume_traded == 40);
+    assert(parent->request.working_volume == 40);
+    assert(parent->request.schedulable_volume == 20);
+    assert(downstream->order_queue.size() == 0);
+
+    std::remove(checkpoint_path.c_str());
+}
+
+TEST(child_risk_guard_checks_parent_budget) {
+    split_config config{};
+    child_risk_guard disabled(config);
+    child_budget budget;
+    budget.side = TradeSide::Buy;
+    budget.parent_price = 1000;
+    budget.schedulable_volume = 60;
+    budget.parent_value = 100 * 1000;
+    budget.committed_value = 40 * 1000;
+    assert(disabled.check(budget, 1000, 5000) == RiskResult::Pass);
+    assert(disabled.checks() == 0);
+
+    config.child_risk_check = true;
+    config.child_max_order_volume = 50;
+    config.child_max_order_value = 45000;
+    child_risk_guard guard(config);
+    assert(guard.check(budget, 40, 1000) == RiskResult::Pass);
+    assert(guard.check(budget, 61, 1000) == RiskResult::RejectParentBudget);
+    assert(guard.check(budget, 40, 1001) == RiskResult::RejectPriceOutOfRange);
+    budget.committed_value = 70 * 1000;
+    assert(guard.check(budget, 40, 1000) == RiskResult::RejectParentBudget);
+    budget.committed_value = 0;
+    assert(guard.check(budget, 55, 1000) == RiskResult::RejectExceedMaxOrderVolume);
+    assert(guard.check(budget, 50, 1000) == RiskResult::RejectExceedMaxOrderValue);
+    // 市价父单不做限价与金额预算校验，只看剩余量与单笔上限
+    budget.parent_price = 0;
+    budget.parent_value = 0;
+    assert(guard.check(budget, 40, 1100) == RiskResult::Pass);
+    // 卖方父单限价为下界
+    budget.side = TradeSide::Sell;
+    budget.parent_price = 1000;
+    budget.parent_value = 100 * 1000;
+    assert(guard.check(budget, 40, 999) == RiskResult::RejectPriceOutOfRange);
+    assert(guard.check(budget, 40, 1000) == RiskResult::Pass);
+    assert(guard.checks() == 9);
+    assert(guard.rejects() == 6);
+}
+
+TEST(child_risk_holds_children_outside_parent_limit) {
+    ManagedMarketDataFixture market_data_fixture("acct_exec_engine_child_risk", 0.0F, 0,
+                                                 snapshot_shm::SnapshotPredictionState::kNone);
+    auto upstream = make_upstream_shm();
+    auto downstream = make_downstream_shm();
+    auto trades = make_trades_shm();
+    auto orders_shm = make_orders_shm();
+    auto positions_shm = make_positions_shm();
+
+    PositionManager positions(positions_shm.get());
+    assert(positions.initialize(1));
+
+    RiskConfig risk_config;
+    risk_config.enable_position_check = false;
+    risk_config.enable_price_limit_check = false;
+    risk_config.enable_duplicate_check = false;
+    RiskManager risk(positions, risk_config);
+
+    auto book = std::make_unique<OrderBook>();
+    split_config split_config{};
+    split_config.max_child_volume = 40;
+    split_config.min_child_volume = 1;
+    split_config.max_child_count = 4;
+    split_config.interval_ms = 1;
+    split_config.child_risk_check = true;
+    order_router router(*book, downstream.get(), orders_shm.get(), upstream.get());
+    ExecutionEngine execution_engine(split_config, *book, router, market_data_fixture.service(), nullptr, nullptr);
+
+    EventLoopConfig loop_config{};
+    loop_config.busy_polling = false;
+    loop_config.idle_sleep_us = 50;
+    loop_config.poll_batch_size = 32;
+    loop_config.stats_interval_ms = 0;
+    EventLoop loop(loop_config, upstream.get(), downstream.get(), trades.get(), orders_shm.get(), *book, router,
+                   positions, risk, nullptr, &execution_engine);
+    sim_clock clock(now_ns());
+    loop.set_sim_clock(&clock);
+    assert(loop.start());
+
+    // 卖一 999 高于父单限价 990：子单被拦下，父单保持在管不失败
+    OrderRequest request = make_managed_order(905, 100, PassiveExecutionAlgo::FixedSize, TradeSide::Buy, 990);
+    OrderIndex parent_index = kInvalidOrderIndex;
+    assert(orders_shm_append(orders_shm.get(), request, OrderSlotState::UpstreamQueued, order_slot_source_t::User,
+                             now_ns(), parent_index));
+    assert(upstream->upstream_order_queue.try_push(parent_index));
+
+    assert(drive_until(loop, clock, [&execution_engine]() { return execution_engine.child_risk().rejects() > 0; }));
+    // 再推进 20 个拆单周期，子单仍被拦在下游之外
+    assert(!drive_until(loop, clock, [&downstream]() { return downstream->order_queue.size() > 0; }, 20));
+    loop.finish();
+
+    assert(execution_engine.session_count() == 1);
+    const OrderEntry* parent = book->find_order(905);
+    assert(parent != nullptr);
+    assert(parent->request.working_volume == 0);
+    assert(parent->request.schedulable_volume == 100);
+}
+
+// split.coroutine_sessions：TWAP 由协程会话推进，帧取自帧池；片间只等回报与片时点，终态后帧归还
+TEST(coroutine_twap_sessions_run_from_pooled_frames) {
+    ManagedMarketDataFixture market_data_fixture("acct_exec_engine_coroutine", 0.0F, 0,
+                                                 snapshot_shm::SnapshotPredictionState::kNone);
+    auto downstream = make_downstream_shm();
+    auto orders_shm = make_orders_shm();
+    auto book = std::make_unique<OrderBook>();
+
+    split_config split_config{};
+    split_config.strategy = SplitStrategy::None;
+    split_config.max_child_volume = 40;
+    split_config.min_child_volume = 1;
+    split_config.max_child_count = 4;
+    split_config.interval_ms = 50;
+    split_config.max_sessions = 4;
+    split_config.coroutine_sessions = true;
+    order_router router(*book, downstream.get(), orders_shm.get());
+    ExecutionEngine execution_engine(split_config, *book, router, market_data_fixture.service(), nullptr, nullptr);
+
+    const TimestampNs start_ns = now_ns();
+    for (InternalOrderId parent_id = 1000; parent_id <= 2000; parent_id += 1000) {
+        OrderRequest request = make_managed_order(parent_id, 100, PassiveExecutionAlgo::TWAP);
+        OrderEntry entry{};
+        entry.request = request;
+        entry.submit_time_ns = start_ns;
+        entry.last_update_ns = start_ns;
+        entry.shm_order_index = kInvalidOrderIndex;
+        assert(book->add_order(entry));
+        assert(execution_engine.start_session(kInvalidOrderIndex, request, 0, start_ns) ==
+               ExecutionEngine::SessionStartResult::Started);
+    }
+    assert(execution_engine.session_count() == 2);
+    assert(execution_engine.coroutine_frames_in_use() == 2);
+    assert(execution_engine.coroutine_frame_fallbacks() == 0);
+    assert(downstream->order_queue.size() == 2);
+    assert(execution_engine.ready_session_count() == 0);
+
+    // 逐片成交父单 1000 的子单：回报唤醒协程后停到下一片时点，到点发出下一片
+    auto fill_next_child = [&](TimestampNs recv_ns) {
+        OrderIndex child_index = kInvalidOrderIndex;
+        assert(downstream->order_queue.try_pop(child_index));
+        order_slot_snapshot child_snapshot{};
+        assert(orders_shm_read_snapshot(orders_shm.get(), child_index, child_snapshot));
+        TradeResponse response{};
+        response.internal_order_id = child_snapshot.request.internal_order_id;
+        response.internal_security_id = InternalSecurityId("XSHE_000001");
+        response.trade_side = TradeSide::Buy;
+        response.new_state = OrderState::Finished;
+        response.volume_traded = child_snapshot.request.volume_entrust;
+        response.dvalue_traded = child_snapshot.request.volume_entrust * child_snapshot.request.dprice_entrust;
+        response.recv_time_ns = recv_ns;
+        execution_engine.on_trade_response(response);
+        return child_snapshot.request.volume_entrust;
+    };
+
+    Volume filled = fill_next_child(start_ns + 1000);
+    assert(execution_engine.ready_session_count() == 1);
+    execution_engine.tick(start_ns + 2000);
+    assert(execution_engine.ready_session_count() == 0);
+    assert(downstream->order_queue.size() == 1);
+
+    for (TimestampNs slice = 1; slice <= 2; ++slice) {
+        const TimestampNs slice_ns = start_ns + slice * 50'000'000ULL + 1'000'000ULL;
+        execution_engine.tick(slice_ns);
+        // 父单 2000 的首片仍在途，只有父单 1000 发出下一片
+        assert(downstream->order_queue.size() == 2);
+        OrderIndex pending_index = kInvalidOrderIndex;
+        assert(downstream->order_queue.try_pop(pending_index));
+        assert(downstream->order_queue.size() == 1);
+        filled += fill_next_child(slice_ns + 1000);
+        assert(downstream->order_queue.try_push(pending_index));
+        execution_engine.tick(slice_ns + 2000);
+    }
+    assert(filled == 100);
+
+    const OrderEntry* parent = book->find_order(1000);
+    assert(parent != nullptr);
+    assert(parent->request.volume_traded == 100);
+    assert(execution_engine.session_count() == 1);
+    assert(execution_engine.coroutine_frames_in_use() == 1);
+}
+
 int main() {
     printf("=== Execution Engine Test Suite ===\n\n");
 
@@ -1135,6 +2192,21 @@ int main() {
     RUN_TEST(invalid_runtime_split_config_is_reported_as_unsplittable);
     RUN_TEST(unsplittable_runtime_config_logs_not_splittable_message);
     RUN_TEST(twap_falls_back_to_order_price_when_market_levels_invalid_and_fallback_enabled);
+    RUN_TEST(twap_sessions_are_event_driven_between_slices);
+    RUN_TEST(coroutine_twap_sessions_run_from_pooled_frames);
+    RUN_TEST(session_pool_rejects_when_full_and_reuses_released_slots);
+    RUN_TEST(finished_sessions_are_reclaimed_in_bounded_steps);
+    RUN_TEST(start_sessions_starts_basket_legs_in_one_call);
+    RUN_TEST(iceberg_replenishes_clip_on_fill_without_tick);
+    RUN_TEST(managed_parent_view_tracks_incremental_child_totals);
+    RUN_TEST(active_twap_session_wakes_only_on_market_data_advance);
+    RUN_TEST(active_candidates_are_scored_in_one_batch);
+    RUN_TEST(active_eval_pool_matches_serial_decisions);
+    RUN_TEST(vwap_slices_follow_volume_profile_weights);
+    RUN_TEST(volume_profile_rejects_invalid_file);
+    RUN_TEST(restart_checkpoint_restores_sessions_and_replays_later_slots);
+    RUN_TEST(child_risk_guard_checks_parent_budget);
+    RUN_TEST(child_risk_holds_children_outside_parent_limit);
 
     printf("\n=== All tests passed! ===\n");
     return 0;
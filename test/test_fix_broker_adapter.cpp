@@ -0,0 +1,368 @@
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "fix_broker_adapter.hpp"
+#include "fix_codec.hpp"
+
+#define TEST(name) static void test_##name()
+#define RUN_TEST(name)                                                                                                 \
+    do {                                                                                                               \
+        printf("Running %s... ", #name);                                                                               \
+        test_##name();                                                                                                 \
+        printf("PASSED\n");                                                                                            \
+    } while (0)
+
+namespace {
+
+using namespace acct_service;
+using namespace acct_service::gateway;
+
+// 测试侧拼帧：'|' 换成 SOH 并补 8= / 9= / 10=
+std::string make_fix_frame(std::string_view body) {
+    std::string text(body);
+    for (char& c : text) {
+        if (c == '|') {
+            c = fix::kSoh;
+        }
+    }
+    std::string frame = "8=FIX.4.4";
+    frame += fix::kSoh;
+    frame += "9=" + std::to_string(text.size());
+    frame += fix::kSoh;
+    frame += text;
+    char trailer[8];
+    std::snprintf(trailer, sizeof(trailer), "10=%03u", fix::fix_checksum(frame.data(), frame.size()));
+    frame += trailer;
+    frame += fix::kSoh;
+    return frame;
+}
+
+std::string field_of(const fix::fix_message_view& message, uint32_t tag) {
+    std::string_view value;
+    return message.get(tag, value) ? std::string(value) : std::string();
+}
+
+// 回环柜台：登录应答；新单 qty=200 整单成交，其余只成交 40 股等待撤单；撤单按累计成交回报完成；改单直接生效
+class loopback_broker {
+public:
+    loopback_broker() {
+        listen_fd_ = ::socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        addr.sin_port = 0;
+        assert(::bind(listen_fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0);
+        assert(::listen(listen_fd_, 1) == 0);
+        socklen_t len = sizeof(addr);
+        assert(::getsockname(listen_fd_, reinterpret_cast<sockaddr*>(&addr), &len) == 0);
+        port_ = ntohs(addr.sin_port);
+        thread_ = std::thread([this]() { run(); });
+    }
+
+    ~loopback_broker() {
+        join();
+        ::close(listen_fd_);
+    }
+
+    // 等券商线程处理完连接（对端断开或收到 Logout）后退出，之后才能读取收到的消息记录
+    void join() {
+        if (thread_.joinable()) {
+            thread_.join();
+        }
+    }
+
+    uint16_t port() const { return port_; }
+    bool saw_logout() const { return saw_logout_.load(); }
+    const std::vector<std::string>& received_types() const { return received_types_; }
+
+private:
+    void send_frame(int fd, std::string_view body) {
+        const std::string frame = make_fix_frame(body);
+        assert(::send(fd, frame.data(), frame.size(), MSG_NOSIGNAL) == static_cast<ssize_t>(frame.size()));
+    }
+
+    void run() {
+        const int fd = ::accept(listen_fd_, nullptr, nullptr);
+        assert(fd >= 0);
+        std::string buffer;
+        char chunk[4096];
+        bool done = false;
+        while (!done) {
+            const ssize_t n = ::recv(fd, chunk, sizeof(chunk), 0);
+            if (n <= 0) {
+                break;
+            }
+            buffer.append(chunk, static_cast<std::size_t>(n));
+            std::size_t offset = 0;
+            fix::fix_message_view message;
+            std::size_t consumed = 0;
+            while (fix::fix_parse(buffer.data() + offset, buffer.size() - offset, message, consumed) ==
+                   fix::fix_parse_status::Ok) {
+                offset += consumed;
+                done = handle(fd, message) || done;
+            }
+            buffer.erase(0, offset);
+        }
+        ::close(fd);
+    }
+
+    // 返回 true 表示收到 Logout
+    bool handle(int fd, const fix::fix_message_view& message) {
+        const std::string type(message.msg_type());
+        received_types_.push_back(type);
+        const std::string cl_ord_id = field_of(message, fix::tag::ClOrdID);
+        if (type == "A") {
+            assert(field_of(message, fix::tag::SenderCompID) == "ACCT_T");
+            assert(field_of(message, fix::tag::MsgSeqNum) == "1");
+            send_frame(fd, "35=A|49=BRK|56=ACCT_T|34=1|52=20260101-09:30:00.000|98=0|108=30|");
+        } else if (type == "D") {
+            assert(field_of(message, fix::tag::Symbol) == "000001");
+            assert(field_of(message, fix::tag::Price) == "12.34");
+            assert(field_of(message, fix::tag::Account) == "FUND1");
+            const std::string qty = field_of(message, fix::tag::OrderQty);
+            send_frame(fd, "35=8|37=70" + cl_ord_id + "|11=" + cl_ord_id + "|150=0|39=0|14=0|");
+            if (qty == "200") {
+                send_frame(fd, "35=8|37=70" + cl_ord_id + "|11=" + cl_ord_id +
+                                   "|150=F|39=2|32=200|31=12.34|14=200|12=1.25|");
+            } else {
+                send_frame(fd, "35=8|37=70" + cl_ord_id + "|11=" + cl_ord_id + "|150=F|39=1|32=40|31=12.3|14=40|");
+            }
+        } else if (type == "F") {
+            const std::string orig = field_of(message, fix::tag::OrigClOrdID);
+            send_frame(fd, "35=8|37=70" + orig + "|11=" + cl_ord_id + "|41=" + orig + "|150=6|39=6|");
+            send_frame(fd, "35=8|37=70" + orig + "|11=" + cl_ord_id + "|41=" + orig + "|150=4|39=4|14=40|");
+        } else if (type == "G") {
+            const std::string orig = field_of(message, fix::tag::OrigClOrdID);
+            send_frame(fd, "35=8|37=70" + orig + "|11=" + cl_ord_id + "|41=" + orig + "|150=5|39=1|38=" +
+                               field_of(message, fix::tag::OrderQty) + "|");
+        } else if (type == "5") {
+            saw_logout_.store(true);
+            return true;
+        }
+        return false;
+    }
+
+    int listen_fd_ = -1;
+    uint16_t port_ = 0;
+    std::thread thread_;
+    std::atomic<bool> saw_logout_{false};
+    std::vector<std::string> received_types_;
+};
+
+broker_api::broker_order_request make_new(uint32_t id, uint64_t volume) {
+    broker_api::broker_order_request request;
+    request.internal_order_id = id;
+    request.type = broker_api::request_type::New;
+    request.trade_side = broker_api::side::Buy;
+    request.order_market = broker_api::market::SZ;
+    request.volume = volume;
+    request.price = 1234;
+    request.md_time = 93000000;
+    std::memcpy(request.security_id, "000001", 7);
+    std::memcpy(request.internal_security_id, "XSHE_000001", 12);
+    return request;
+}
+
+std::vector<broker_api::broker_event> poll_until(fix_broker_adapter& adapter, std::size_t count) {
+    std::vector<broker_api::broker_event> events;
+    broker_api::broker_event batch[16];
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (events.size() < count && std::chrono::steady_clock::now() < deadline) {
+        const std::size_t n = adapter.poll_events(batch, 16);
+        events.insert(events.end(), batch, batch + n);
+        if (n == 0) {
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+    }
+    return events;
+}
+
+TEST(template_render_round_trips_through_parser) {
+    fix::fix_template templ;
+    assert(templ.compile("FIX.4.4", "35=D|49=S|56=T|34=$seq|52=$time|11=$clordid|55=$symbol|54=$side|38=$qty|"
+                                    "44=$price|60=$time|"));
+    assert(!fix::fix_template().compile("FIX.4.4", "35=D|11=$unknown|"));
+
+    char time_text[fix::kSendingTimeSize];
+    fix::format_sending_time(1767260100123000000ULL, time_text);
+    assert(std::string_view(time_text, sizeof(time_text)) == "20260101-09:35:00.123");
+
+    fix::fix_slot_values values;
+    values.seq_num = 42;
+    values.sending_time = time_text;
+    values.cl_ord_id = 1001;
+    values.symbol = "600000";
+    values.side = '2';
+    values.order_qty = 300;
+    values.price_cents = 1205;
+    char out[512];
+    assert(templ.render(out, 16, values) == 0);
+    const std::size_t size = templ.render(out, sizeof(out), values);
+    assert(size != 0 && size <= templ.max_size());
+
+    fix::fix_message_view message;
+    std::size_t consumed = 0;
+    assert(fix::fix_parse(out, size, message, consumed) == fix::fix_parse_status::Ok);
+    assert(consumed == size);
+    assert(message.msg_type() == "D");
+    uint64_t value = 0;
+    assert(message.get_uint(fix::tag::MsgSeqNum, value) && value == 42);
+    assert(message.get_uint(fix::tag::ClOrdID, value) && value == 1001);
+    assert(message.get_cents(fix::tag::Price, value) && value == 1205);
+    assert(field_of(message, fix::tag::Price) == "12.05");
+    assert(field_of(message, fix::tag::SendingTime) == "20260101-09:35:00.123");
+    assert(field_of(message, fix::tag::Symbol) == "600000");
+    char side = 0;
+    assert(message.get_char(fix::tag::Side, side) && side == '2');
+
+    const std::string expected = make_fix_frame(
+        "35=D|49=S|56=T|34=42|52=20260101-09:35:00.123|11=1001|55=600000|54=2|38=300|44=12.05|60=20260101-09:35:00.123|");
+    assert(std::string_view(out, size) == expected);
+}
+
+TEST(parser_reports_partial_corrupt_and_desync) {
+    const std::string frame = make_fix_frame("35=8|11=7|150=F|32=10|31=9.876|12=3|");
+    fix::fix_message_view message;
+    std::size_t consumed = 0;
+    for (std::size_t cut = 0; cut < frame.size(); ++cut) {
+        assert(fix::fix_parse(frame.data(), cut, message, consumed) == fix::fix_parse_status::Incomplete ||
+               cut < 2);
+    }
+    assert(fix::fix_parse(frame.data(), frame.size(), message, consumed) == fix::fix_parse_status::Ok);
+    uint64_t cents = 0;
+    assert(message.get_cents(fix::tag::LastPx, cents) && cents == 988);
+    assert(message.get_cents(fix::tag::Commission, cents) && cents == 300);
+
+    std::string corrupt = frame;
+    corrupt[frame.find("32=10") + 3] = '2';
+    assert(fix::fix_parse(corrupt.data(), corrupt.size(), message, consumed) == fix::fix_parse_status::BadChecksum);
+    assert(consumed == corrupt.size());
+
+    const std::string garbage = "xx=1" + frame;
+    assert(fix::fix_parse(garbage.data(), garbage.size(), message, consumed) == fix::fix_parse_status::Malformed);
+}
+
+TEST(adapter_maps_execution_reports_to_broker_events) {
+    loopback_broker broker;
+    fix_session_config config;
+    config.port = broker.port();
+    config.sender_comp_id = "ACCT_T";
+    config.target_comp_id = "BRK";
+    config.account = "FUND1";
+    config.max_active_orders = 64;
+    {
+        fix_broker_adapter adapter(config);
+        assert(adapter.submit(make_new(1, 200)).error_code == -100);
+        broker_api::broker_runtime_config runtime;
+        assert(adapter.initialize(runtime));
+        assert(adapter.logged_on());
+
+        // 整单成交：受理 + 成交 + 完成
+        assert(adapter.submit(make_new(1, 200)).accepted);
+        std::vector<broker_api::broker_event> events = poll_until(adapter, 3);
+        assert(events.size() == 3);
+        assert(events[0].kind == broker_api::event_kind::BrokerAccepted && events[0].internal_order_id == 1);
+        assert(events[0].broker_order_id == 701);
+        assert(std::string(events[0].internal_security_id) == "XSHE_000001");
+        assert(events[1].kind == broker_api::event_kind::Trade && events[1].volume_traded == 200);
+        assert(events[1].price_traded == 1234 && events[1].value_traded == 200 * 1234 && events[1].fee == 125);
+        assert(events[2].kind == broker_api::event_kind::Finished && events[2].cancelled_volume == 0);
+
+        // 部分成交后撤单：撤单受理 + 原单完成带剩余撤销量
+        broker_api::broker_order_request requests[2] = {make_new(2, 100), make_new(4, 100)};
+        broker_api::send_result results[2];
+        adapter.submit_batch(requests, 2, results);
+        assert(results[0].accepted && results[1].accepted);
+        events = poll_until(adapter, 4);
+        assert(events.size() == 4);
+        assert(events[1].kind == broker_api::event_kind::Trade && events[1].price_traded == 1230);
+
+        broker_api::broker_order_request cancel;
+        cancel.internal_order_id = 3;
+        cancel.orig_internal_order_id = 2;
+        cancel.type = broker_api::request_type::Cancel;
+        assert(adapter.submit(cancel).accepted);
+        events = poll_until(adapter, 2);
+        assert(events.size() == 2);
+        assert(events[0].kind == broker_api::event_kind::BrokerAccepted && events[0].internal_order_id == 3);
+        assert(events[1].kind == broker_api::event_kind::Finished && events[1].internal_order_id == 2);
+        assert(events[1].cancelled_volume == 60 && events[1].broker_order_id == 702);
+
+        // 改单生效后，以改单编号为 ClOrdID 的回报仍归属原单
+        broker_api::broker_order_request replace = make_new(5, 150);
+        replace.type = broker_api::request_type::Replace;
+        replace.orig_internal_order_id = 4;
+        assert(adapter.submit(replace).accepted);
+        events = poll_until(adapter, 2);
+        assert(events.size() == 2);
+        assert(events[0].kind == broker_api::event_kind::BrokerAccepted && events[0].internal_order_id == 5);
+        assert(events[1].kind == broker_api::event_kind::Finished && events[1].internal_order_id == 5);
+
+        const std::string fill = make_fix_frame("35=8|37=704|11=5|41=4|150=F|39=1|32=10|31=12.34|14=50|");
+        assert(adapter.ingest(fill.data(), fill.size()) == fill.size());
+        const std::string cancelled = make_fix_frame("35=8|37=704|11=5|150=4|39=4|14=50|");
+        assert(adapter.ingest(cancelled.data(), cancelled.size()) == cancelled.size());
+        events = poll_until(adapter, 2);
+        assert(events.size() == 2);
+        assert(events[0].kind == broker_api::event_kind::Trade && events[0].internal_order_id == 4);
+        assert(events[1].kind == broker_api::event_kind::Finished && events[1].internal_order_id == 4);
+        assert(events[1].cancelled_volume == 100);
+
+        // 已完成订单的迟到回报不产生事件
+        assert(adapter.ingest(fill.data(), fill.size()) == fill.size());
+        assert(adapter.unmatched_reports() == 1);
+        assert(adapter.bad_frames() == 0);
+        adapter.shutdown();
+    }
+    broker.join();
+    assert(broker.saw_logout());
+    const std::vector<std::string>& types = broker.received_types();
+    assert(types.front() == "A" && types.back() == "5");
+}
+
+TEST(adapter_initialize_fails_without_counterparty) {
+    // 先占一个端口再关掉，保证无人监听
+    const int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    assert(::bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0);
+    socklen_t len = sizeof(addr);
+    assert(::getsockname(fd, reinterpret_cast<sockaddr*>(&addr), &len) == 0);
+    ::close(fd);
+
+    fix_session_config config;
+    config.port = ntohs(addr.sin_port);
+    config.logon_timeout_ms = 200;
+    fix_broker_adapter adapter(config);
+    broker_api::broker_runtime_config runtime;
+    assert(!adapter.initialize(runtime));
+    assert(!adapter.logged_on());
+    assert(adapter.submit(make_new(1, 100)).error_code == -100);
+}
+
+}  // namespace
+
+int main() {
+    printf("=== FIX Broker Adapter Test Suite ===\n\n");
+
+    RUN_TEST(template_render_round_trips_through_parser);
+    RUN_TEST(parser_reports_partial_corrupt_and_desync);
+    RUN_TEST(adapter_maps_execution_reports_to_broker_events);
+    RUN_TEST(adapter_initialize_fails_without_counterparty);
+
+    printf("\n=== All tests passed! ===\n");
+    return 0;
+}
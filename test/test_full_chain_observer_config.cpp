@@ -78,7 +78,9 @@ TEST(load_from_config_flag) {
         "positions_shm_name: \"/positions_test\"\n"
         "output_dir: \"/tmp/observer_out\"\n"
         "poll_interval_ms: 123\n"
-        "timeout_ms: 456\n");
+        "timeout_ms: 456\n"
+        "output_format: \"binary\"\n"
+        "print_events: false\n");
 
     full_chain_observer_config config;
     std::string error;
@@ -94,6 +96,8 @@ TEST(load_from_config_flag) {
     assert(config.output_dir == "/tmp/observer_out");
     assert(config.poll_interval_ms == 123);
     assert(config.timeout_ms == 456);
+    assert(config.output_format == observer_output_format::Binary);
+    assert(!config.print_events);
 
     std::filesystem::remove(config_path);
 }
@@ -117,6 +121,8 @@ TEST(load_from_positional_path) {
     assert(config.trading_day == "20260227");
     assert(config.positions_shm_name == "/positions_pos");
     assert(config.output_dir == "/tmp/observer_pos");
+    assert(config.output_format == observer_output_format::Csv);
+    assert(config.print_events);
 
     std::filesystem::remove(config_path);
 }
@@ -181,6 +187,26 @@ TEST(reject_unknown_yaml_key) {
     std::filesystem::remove(config_path);
 }
 
+TEST(reject_invalid_output_format) {
+    const std::filesystem::path config_path = unique_path("observer_cfg_bad_format");
+    write_file(config_path,
+        "orders_shm_name: \"/orders_test\"\n"
+        "trading_day: \"20260226\"\n"
+        "positions_shm_name: \"/positions_test\"\n"
+        "output_dir: \"/tmp/observer_out\"\n"
+        "output_format: \"parquet\"\n");
+
+    full_chain_observer_config config;
+    std::string error;
+    const observer_parse_result result =
+        parse_observer_args({"observer", "--config", config_path.string()}, &config, &error);
+    (void)result;
+    assert(result == observer_parse_result::Error);
+    assert(error.find("output_format") != std::string::npos);
+
+    std::filesystem::remove(config_path);
+}
+
 TEST(reject_invalid_trading_day) {
     const std::filesystem::path config_path = unique_path("observer_cfg_bad_day");
     write_file(config_path,
@@ -227,6 +253,7 @@ int main() {
     RUN_TEST(load_from_default_config_path);
     RUN_TEST(reject_legacy_command_line_options);
     RUN_TEST(reject_unknown_yaml_key);
+    RUN_TEST(reject_invalid_output_format);
     RUN_TEST(reject_invalid_trading_day);
     RUN_TEST(reject_empty_shm_name);
 
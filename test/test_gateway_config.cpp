@@ -47,15 +47,41 @@ TEST(load_from_yaml_file) {
         out << "downstream_shm: \"/downstream_test\"\n";
         out << "trades_shm: \"/trades_test\"\n";
         out << "orders_shm: \"/orders_test\"\n";
+        out << "stats_shm: \"/gateway_stats_test\"\n";
         out << "trading_day: \"20260226\"\n";
         out << "broker_type: \"plugin\"\n";
         out << "adapter_so: \"/tmp/adapter.so\"\n";
         out << "create_if_not_exist: true\n";
         out << "poll_batch_size: 32\n";
         out << "idle_sleep_us: 10\n";
+        out << "adaptive_idle: true\n";
+        out << "idle_spin_iterations: 16\n";
+        out << "idle_yield_iterations: 4\n";
+        out << "idle_park_timeout_us: 300\n";
         out << "stats_interval_ms: 200\n";
+        out << "queue_depth_sample_iterations: 8\n";
         out << "max_retries: 8\n";
         out << "retry_interval_us: 900\n";
+        out << "adapter_poll_thread: true\n";
+        out << "direct_responses: false\n";
+        out << "coalesce_fills: true\n";
+        out << "main_cpu_core: 2\n";
+        out << "adapter_poll_cpu_core: -1\n";
+        out << "main_priority: 50\n";
+        out << "adapter_poll_priority: 20\n";
+        out << "lock_memory: true\n";
+        out << "warm_restart: true\n";
+        out << "adapter_shards: 4\n";
+        out << "broker_rate_limit: \"500, 500,300,0\"\n";
+        out << "broker_rate_burst_ms: 20\n";
+        out << "broker_cancel_reserve_pct: 25\n";
+        out << "sim_fill_latency_us: 50\n";
+        out << "sim_fill_jitter_us: 10\n";
+        out << "sim_partial_fill_pct: 30\n";
+        out << "sim_partial_fill_slices: 3\n";
+        out << "sim_reject_pct: 5\n";
+        out << "sim_seed: 42\n";
+        out << "sim_max_active_orders: 1024\n";
     }
 
     gateway::gateway_config config;
@@ -68,15 +94,41 @@ TEST(load_from_yaml_file) {
     assert(config.downstream_shm_name == "/downstream_test");
     assert(config.trades_shm_name == "/trades_test");
     assert(config.orders_shm_name == "/orders_test");
+    assert(config.stats_shm_name == "/gateway_stats_test");
     assert(config.trading_day == "20260226");
     assert(config.broker_type == "plugin");
     assert(config.adapter_plugin_so == "/tmp/adapter.so");
     assert(config.create_if_not_exist);
     assert(config.poll_batch_size == 32);
     assert(config.idle_sleep_us == 10);
+    assert(config.adaptive_idle);
+    assert(config.idle_spin_iterations == 16);
+    assert(config.idle_yield_iterations == 4);
+    assert(config.idle_park_timeout_us == 300);
     assert(config.stats_interval_ms == 200);
+    assert(config.queue_depth_sample_iterations == 8);
     assert(config.max_retry_attempts == 8);
     assert(config.retry_interval_us == 900);
+    assert(config.adapter_poll_thread);
+    assert(!config.direct_responses);
+    assert(config.coalesce_fills);
+    assert(config.main_cpu_core == 2);
+    assert(config.adapter_poll_cpu_core == -1);
+    assert(config.main_priority == 50);
+    assert(config.adapter_poll_priority == 20);
+    assert(config.lock_memory);
+    assert(config.warm_restart);
+    assert(config.adapter_shards == 4);
+    assert((config.broker_rate_limits == std::vector<uint32_t>{500, 500, 300, 0}));
+    assert(config.broker_rate_burst_ms == 20);
+    assert(config.broker_cancel_reserve_pct == 25);
+    assert(config.sim_fill_latency_us == 50);
+    assert(config.sim_fill_jitter_us == 10);
+    assert(config.sim_partial_fill_pct == 30);
+    assert(config.sim_partial_fill_slices == 3);
+    assert(config.sim_reject_pct == 5);
+    assert(config.sim_seed == 42);
+    assert(config.sim_max_active_orders == 1024);
 
     std::remove(path.c_str());
 }
@@ -194,6 +246,60 @@ TEST(reject_invalid_u32_value) {
     std::remove(path.c_str());
 }
 
+TEST(reject_out_of_range_sim_fill_model) {
+    const std::string path = unique_path("gateway_cfg_sim_range", ".yaml");
+    {
+        std::ofstream out(path);
+        assert(out.is_open());
+        out << "sim_reject_pct: 101\n";
+    }
+
+    gateway::gateway_config config;
+    std::string error;
+    gateway::parse_result_t result = parse_gateway_args({"test_gateway", "--config", path}, config, error);
+    assert(result == gateway::parse_result_t::Error);
+    assert(error.find("invalid value for sim_reject_pct") != std::string::npos);
+
+    {
+        std::ofstream out(path, std::ios::trunc);
+        assert(out.is_open());
+        out << "sim_partial_fill_slices: 1\n";
+    }
+    result = parse_gateway_args({"test_gateway", "--config", path}, config, error);
+    assert(result == gateway::parse_result_t::Error);
+    assert(error.find("numeric value out of range") != std::string::npos);
+
+    std::remove(path.c_str());
+}
+
+TEST(reject_mismatched_broker_rate_limits) {
+    const std::string path = unique_path("gateway_cfg_rate_limit", ".yaml");
+    {
+        std::ofstream out(path);
+        assert(out.is_open());
+        out << "adapter_shards: 2\n";
+        out << "broker_rate_limit: \"500,400,300\"\n";
+    }
+
+    gateway::gateway_config config;
+    std::string error;
+    gateway::parse_result_t result = parse_gateway_args({"test_gateway", "--config", path}, config, error);
+    assert(result == gateway::parse_result_t::Error);
+    assert(error.find("broker_rate_limit") != std::string::npos);
+
+    {
+        std::ofstream out(path, std::ios::trunc);
+        assert(out.is_open());
+        out << "broker_rate_limit: \"500,x\"\n";
+    }
+    config = gateway::gateway_config{};
+    result = parse_gateway_args({"test_gateway", "--config", path}, config, error);
+    assert(result == gateway::parse_result_t::Error);
+    assert(error.find("invalid value for broker_rate_limit") != std::string::npos);
+
+    std::remove(path.c_str());
+}
+
 TEST(reject_invalid_trading_day_value) {
     const std::string path = unique_path("gateway_cfg_invalid_trading_day", ".yaml");
     {
@@ -212,6 +318,61 @@ TEST(reject_invalid_trading_day_value) {
     std::remove(path.c_str());
 }
 
+TEST(load_multi_account_bindings) {
+    const std::string path = unique_path("gateway_cfg_accounts", ".yaml");
+    {
+        std::ofstream out(path);
+        assert(out.is_open());
+        out << "account_id: 9\n";
+        out << "accounts:\n";
+        out << "  - {account_id: 11, downstream_shm: /ds_11, trades_shm: /tr_11, orders_shm: /or_11}\n";
+        out << "  - {account_id: 12, downstream_shm: /ds_12, trades_shm: /tr_12, orders_shm: /or_12}\n";
+    }
+
+    gateway::gateway_config config;
+    std::string error;
+    gateway::parse_result_t result = parse_gateway_args({"test_gateway", "--config", path}, config, error);
+    assert(result == gateway::parse_result_t::Ok);
+    const std::vector<gateway::gateway_account_binding> bindings = gateway::resolve_gateway_accounts(config);
+    assert(bindings.size() == 2);
+    assert(bindings[0].account_id == 11 && bindings[0].downstream_shm_name == "/ds_11");
+    assert(bindings[1].account_id == 12 && bindings[1].trades_shm_name == "/tr_12");
+    assert(bindings[1].orders_shm_name == "/or_12");
+    assert(config.account_id == 9);
+
+    // 未配置 accounts 时由单账户字段合成
+    gateway::gateway_config single;
+    single.account_id = 3;
+    const std::vector<gateway::gateway_account_binding> single_bindings = gateway::resolve_gateway_accounts(single);
+    assert(single_bindings.size() == 1);
+    assert(single_bindings[0].account_id == 3 && single_bindings[0].downstream_shm_name == single.downstream_shm_name);
+
+    {
+        std::ofstream out(path, std::ios::trunc);
+        assert(out.is_open());
+        out << "accounts:\n";
+        out << "  - {account_id: 11, downstream_shm: /ds_11, trades_shm: /tr_11, orders_shm: /or_11}\n";
+        out << "  - {account_id: 12, downstream_shm: /ds_11, trades_shm: /tr_12, orders_shm: /or_12}\n";
+    }
+    gateway::gateway_config duplicated;
+    result = parse_gateway_args({"test_gateway", "--config", path}, duplicated, error);
+    assert(result == gateway::parse_result_t::Error);
+    assert(error.find("distinct") != std::string::npos);
+
+    {
+        std::ofstream out(path, std::ios::trunc);
+        assert(out.is_open());
+        out << "accounts:\n";
+        out << "  - {account_id: 11, downstream_shm: /ds_11}\n";
+    }
+    gateway::gateway_config incomplete;
+    result = parse_gateway_args({"test_gateway", "--config", path}, incomplete, error);
+    assert(result == gateway::parse_result_t::Error);
+    assert(error.find("requires account_id") != std::string::npos);
+
+    std::remove(path.c_str());
+}
+
 int main() {
     printf("=== Gateway Config Test Suite ===\n\n");
 
@@ -222,6 +383,9 @@ int main() {
     RUN_TEST(reject_invalid_bool_value);
     RUN_TEST(reject_invalid_u32_value);
     RUN_TEST(reject_invalid_trading_day_value);
+    RUN_TEST(reject_out_of_range_sim_fill_model);
+    RUN_TEST(reject_mismatched_broker_rate_limits);
+    RUN_TEST(load_multi_account_bindings);
 
     printf("\n=== All tests passed! ===\n");
     return 0;
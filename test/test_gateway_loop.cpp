@@ -1,10 +1,15 @@
+#include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <chrono>
 #include <cstdio>
 #include <cstring>
 #include <functional>
 #include <memory>
+#include <string>
 #include <thread>
+#include <tuple>
+#include <utility>
 #include <vector>
 
 #include "gateway_config.hpp"
@@ -26,13 +31,23 @@ namespace {
 
 using namespace acct_service;
 
+// 取出一条 trades_shm 回报并解码为 TradeResponse。
+bool pop_trade_response(trades_shm_layout& trades, TradeResponse& out) {
+    trade_response_message message;
+    if (!trades.response_queue.try_pop(message)) {
+        return false;
+    }
+    unpack_trade_response_message(message, out);
+    return true;
+}
+
 // 初始化共享内存头，模拟可用队列环境。
 void init_header(SHMHeader& header) {
     header.magic = SHMHeader::kMagic;
     header.version = SHMHeader::kVersion;
     header.create_time = now_ns();
     header.last_update = header.create_time;
-    header.next_order_id.store(1, std::memory_order_relaxed);
+    header.next_id_epoch.store(1, std::memory_order_relaxed);
 }
 
 // 构造仅包含订单队列的下游共享内存。
@@ -86,7 +101,7 @@ std::vector<OrderState> collect_statuses_for_order(
     const bool done = wait_until(
         [&statuses, trades, order_id, expected_count]() {
             TradeResponse response;
-            while (trades->response_queue.try_pop(response)) {
+            while (pop_trade_response(*trades, response)) {
                 if (response.internal_order_id == order_id) {
                     statuses.push_back(response.new_state);
                 }
@@ -115,7 +130,7 @@ std::vector<TradeResponse> collect_responses_for_order(
     const bool done = wait_until(
         [&responses, trades, order_id, expected_count]() {
             TradeResponse response;
-            while (trades->response_queue.try_pop(response)) {
+            while (pop_trade_response(*trades, response)) {
                 if (response.internal_order_id == order_id) {
                     responses.push_back(response);
                 }
@@ -133,7 +148,7 @@ std::vector<TradeResponse> collect_response_batch(trades_shm_layout* trades, std
     const bool done = wait_until(
         [&responses, trades, expected_count]() {
             TradeResponse response;
-            while (trades->response_queue.try_pop(response)) {
+            while (pop_trade_response(*trades, response)) {
                 responses.push_back(response);
             }
             return responses.size() >= expected_count;
@@ -154,8 +169,658 @@ gateway::gateway_config make_config() {
     return config;
 }
 
+// 统计 submit_batch 调用次数与批大小、证券令牌协商次数，其余行为委托给模拟柜台。
+class batch_counting_adapter final : public broker_api::IBrokerAdapter {
+public:
+    bool initialize(const broker_api::broker_runtime_config& config) override { return inner_.initialize(config); }
+    broker_api::send_result submit(const broker_api::broker_order_request& request) override {
+        return inner_.submit(request);
+    }
+    void submit_batch(const broker_api::broker_order_request* requests, std::size_t count,
+        broker_api::send_result* out_results) override {
+        ++batch_calls;
+        max_batch_size = std::max(max_batch_size, count);
+        submitted.insert(submitted.end(), requests, requests + count);
+        inner_.submit_batch(requests, count, out_results);
+    }
+    std::size_t poll_events(broker_api::broker_event* out_events, std::size_t max_events) override {
+        return inner_.poll_events(out_events, max_events);
+    }
+    uint64_t resolve_security(const broker_api::broker_order_request& request) noexcept override {
+        (void)request;
+        return kTokenBase + ++resolve_calls;
+    }
+    void shutdown() noexcept override { inner_.shutdown(); }
+
+    static constexpr uint64_t kTokenBase = 0x5EC0000;
+    std::atomic<std::size_t> batch_calls{0};
+    std::size_t resolve_calls = 0;  // 仅在主循环停止后读取
+    std::size_t max_batch_size = 0;
+    std::vector<broker_api::broker_order_request> submitted{};  // 仅在主循环停止后读取
+
+private:
+    gateway::sim_broker_adapter inner_;
+};
+
+// 前 reject_count 次单笔提交返回可重试失败，之后委托给模拟柜台。
+class flaky_submit_adapter final : public broker_api::IBrokerAdapter {
+public:
+    explicit flaky_submit_adapter(std::size_t reject_count) : remaining_rejects_(reject_count) {}
+
+    bool initialize(const broker_api::broker_runtime_config& config) override { return inner_.initialize(config); }
+    broker_api::send_result submit(const broker_api::broker_order_request& request) override {
+        if (remaining_rejects_ > 0) {
+            --remaining_rejects_;
+            return broker_api::send_result::retryable_error(1);
+        }
+        return inner_.submit(request);
+    }
+    std::size_t poll_events(broker_api::broker_event* out_events, std::size_t max_events) override {
+        return inner_.poll_events(out_events, max_events);
+    }
+    void shutdown() noexcept override { inner_.shutdown(); }
+
+private:
+    std::size_t remaining_rejects_ = 0;
+    gateway::sim_broker_adapter inner_;
+};
+
+// 直写回报适配器：首次 poll_responses 分两段写出脚本记录，并统计两条回报路径各被调用几次。
+class scripted_direct_adapter final : public broker_api::IBrokerAdapter {
+public:
+    bool initialize(const broker_api::broker_runtime_config& config) override {
+        (void)config;
+        return true;
+    }
+    broker_api::send_result submit(const broker_api::broker_order_request& request) override {
+        (void)request;
+        return broker_api::send_result::ok();
+    }
+    std::size_t poll_events(broker_api::broker_event* out_events, std::size_t max_events) override {
+        (void)out_events;
+        (void)max_events;
+        ++poll_events_calls;
+        return 0;
+    }
+    bool supports_response_writer() const noexcept override { return true; }
+    std::size_t poll_responses(const broker_api::response_writer& writer, std::size_t max_responses) override {
+        ++poll_responses_calls;
+        std::size_t written = 0;
+        for (std::size_t begin = 0; begin < script.size() && written < max_responses;) {
+            broker_api::trade_response_record* slots = nullptr;
+            const std::size_t claimed = writer.claim(writer.context, std::min<std::size_t>(2, script.size() - begin),
+                                                     &slots);
+            assert(claimed > 0 && slots != nullptr);
+            for (std::size_t i = 0; i < claimed; ++i) {
+                slots[i] = script[begin + i];
+            }
+            writer.publish(writer.context, claimed);
+            begin += claimed;
+            written += claimed;
+        }
+        script.clear();
+        return written;
+    }
+    void shutdown() noexcept override {}
+
+    std::vector<broker_api::trade_response_record> script;
+    std::size_t poll_events_calls = 0;
+    std::size_t poll_responses_calls = 0;
+};
+
+// 按脚本顺序吐出事件的适配器，统计实际被取走的事件数。
+class scripted_event_adapter final : public broker_api::IBrokerAdapter {
+public:
+    bool initialize(const broker_api::broker_runtime_config& config) override {
+        (void)config;
+        return true;
+    }
+    broker_api::send_result submit(const broker_api::broker_order_request& request) override {
+        (void)request;
+        return broker_api::send_result::ok();
+    }
+    std::size_t poll_events(broker_api::broker_event* out_events, std::size_t max_events) override {
+        const std::size_t count = std::min(max_events, script.size() - polled);
+        std::copy_n(script.begin() + static_cast<std::ptrdiff_t>(polled), count, out_events);
+        polled += count;
+        return count;
+    }
+    void shutdown() noexcept override {}
+
+    std::vector<broker_api::broker_event> script;
+    std::size_t polled = 0;
+};
+
+broker_api::trade_response_record make_direct_record(uint32_t order_id, const char* security_id,
+                                                     broker_api::response_state state) {
+    broker_api::trade_response_record record;
+    record.internal_order_id = order_id;
+    std::strncpy(record.internal_security_id, security_id, sizeof(record.internal_security_id) - 1);
+    record.trade_side = broker_api::side::Buy;
+    record.new_state = state;
+    record.volume_traded = 100;
+    record.price_traded = 1000;
+    return record;
+}
+
 } // namespace
 
+// 验证直写回报经分片回报环编码写入 trades_shm：非法记录被压实丢弃，旧格式证券键被规整，成交回报不再携带证券键；
+// 关闭开关时回落 poll_events。
+TEST(direct_response_writer_fills_trades_queue) {
+    for (const bool direct_enabled : {true, false}) {
+        auto downstream = make_downstream_shm();
+        auto trades = make_trades_shm();
+        auto orders = make_orders_shm();
+
+        scripted_direct_adapter adapter;
+        adapter.script = {
+            make_direct_record(9501, "SZ.000001", broker_api::response_state::BrokerAccepted),
+            make_direct_record(0, "XSHE_000001", broker_api::response_state::BrokerAccepted),
+            make_direct_record(9502, "XSHE_000002", broker_api::response_state::None),
+            make_direct_record(9503, "SZ.000003", broker_api::response_state::MarketAccepted),
+            make_direct_record(9504, "XSHE_000004", broker_api::response_state::Finished),
+        };
+        adapter.script[0].volume_traded = 0;
+        adapter.script[0].price_traded = 0;
+
+        gateway::gateway_config config = make_config();
+        config.direct_responses = direct_enabled;
+        gateway::gateway_loop loop(config, downstream.get(), trades.get(), orders.get(), adapter);
+        assert(loop.start());
+        assert(loop.run_once() == direct_enabled);
+        loop.finish();
+
+        if (!direct_enabled) {
+            assert(adapter.poll_responses_calls == 0);
+            assert(adapter.poll_events_calls == 1);
+            assert(trades->response_queue.empty());
+            continue;
+        }
+
+        assert(adapter.poll_events_calls == 0);
+        std::vector<TradeResponse> responses;
+        TradeResponse response;
+        while (pop_trade_response(*trades, response)) {
+            responses.push_back(response);
+        }
+        assert(responses.size() == 3);
+        assert(responses[0].internal_order_id == 9501 && responses[0].new_state == OrderState::BrokerAccepted);
+        assert(responses[0].internal_security_id.view() == "XSHE_000001");
+        assert(responses[1].internal_order_id == 9503 && responses[1].new_state == OrderState::MarketAccepted);
+        assert(responses[1].internal_security_id.empty());
+        assert(responses[1].volume_traded == 100 && responses[1].dprice_traded == 1000);
+        assert(responses[1].recv_time_ns != 0);
+        assert(responses[2].internal_order_id == 9504 && responses[2].new_state == OrderState::Finished);
+        assert(loop.stats().direct_responses == 5);
+        assert(loop.stats().responses_dropped == 2);
+        assert(loop.stats().responses_pushed == 3);
+    }
+}
+
+// 验证回报队列写满时回报进入溢出环而非丢弃：积压越过高水位后暂停拉取事件，队列腾出空间后按原顺序补写。
+TEST(full_response_queue_spills_and_backpressures) {
+    auto downstream = make_downstream_shm();
+    auto trades = make_trades_shm();
+    auto orders = make_orders_shm();
+
+    TradeResponse filler{};
+    filler.internal_order_id = 1;
+    trade_response_message filler_message;
+    pack_trade_response_message(filler, filler_message);
+    while (trades->response_queue.try_push(filler_message)) {
+    }
+
+    constexpr std::size_t kEventCount = 14000;
+    scripted_event_adapter adapter;
+    adapter.script.resize(kEventCount);
+    for (std::size_t i = 0; i < kEventCount; ++i) {
+        broker_api::broker_event& event = adapter.script[i];
+        event.kind = broker_api::event_kind::Trade;
+        event.internal_order_id = 10000 + static_cast<uint32_t>(i / 4);
+        std::strncpy(event.internal_security_id, "XSHE_000001", sizeof(event.internal_security_id) - 1);
+        event.trade_side = broker_api::side::Buy;
+        event.volume_traded = i + 1;
+        event.price_traded = 1000;
+    }
+
+    gateway::gateway_config config = make_config();
+    gateway::gateway_loop loop(config, downstream.get(), trades.get(), orders.get(), adapter);
+    assert(loop.start());
+    for (int i = 0; i < 1000; ++i) {
+        (void)loop.run_once();
+    }
+    // 账户服务停顿期间：全部暂存，且到达高水位后不再从适配器取事件
+    assert(adapter.polled < kEventCount);
+    assert(loop.stats().responses_spilled == adapter.polled);
+    assert(loop.stats().spill_backpressure > 0);
+    assert(loop.stats().responses_dropped == 0);
+    assert(loop.stats().responses_pushed == 0);
+
+    std::vector<TradeResponse> received;
+    TradeResponse response;
+    for (int i = 0; i < 10000 && received.size() < kEventCount; ++i) {
+        while (pop_trade_response(*trades, response)) {
+            if (response.internal_order_id != filler.internal_order_id) {
+                received.push_back(response);
+            }
+        }
+        (void)loop.run_once();
+    }
+    loop.finish();
+
+    assert(received.size() == kEventCount);
+    for (std::size_t i = 0; i < kEventCount; ++i) {
+        assert(received[i].internal_order_id == 10000 + i / 4);
+        assert(received[i].volume_traded == i + 1);
+    }
+    assert(loop.stats().responses_pushed == kEventCount);
+    assert(loop.stats().responses_dropped == 0);
+    assert(loop.stats().spill_depth == 0);
+}
+
+// 验证同一批内同一订单的相邻成交合并为一条汇总回报，其它订单或终态回报打断合并；关闭开关时逐笔发布。
+TEST(consecutive_fills_coalesce_within_batch) {
+    const auto make_event = [](broker_api::event_kind kind, uint32_t order_id, uint64_t volume, uint64_t price) {
+        broker_api::broker_event event;
+        event.kind = kind;
+        event.internal_order_id = order_id;
+        event.broker_order_id = order_id + 100000;
+        std::strncpy(event.internal_security_id, "XSHE_000001", sizeof(event.internal_security_id) - 1);
+        event.trade_side = broker_api::side::Buy;
+        event.volume_traded = volume;
+        event.price_traded = price;
+        event.value_traded = volume * price;
+        event.fee = volume;
+        return event;
+    };
+
+    for (const bool coalesce : {true, false}) {
+        auto downstream = make_downstream_shm();
+        auto trades = make_trades_shm();
+        auto orders = make_orders_shm();
+
+        scripted_event_adapter adapter;
+        adapter.script = {
+            make_event(broker_api::event_kind::Trade, 9701, 100, 1000),
+            make_event(broker_api::event_kind::Trade, 9701, 200, 1010),
+            make_event(broker_api::event_kind::Trade, 9701, 300, 1020),
+            make_event(broker_api::event_kind::Trade, 9702, 100, 2000),
+            make_event(broker_api::event_kind::Trade, 9701, 400, 1030),
+            make_event(broker_api::event_kind::Finished, 9701, 0, 0),
+        };
+
+        gateway::gateway_config config = make_config();
+        config.coalesce_fills = coalesce;
+        gateway::gateway_loop loop(config, downstream.get(), trades.get(), orders.get(), adapter);
+        assert(loop.start());
+        assert(loop.run_once());
+        loop.finish();
+
+        std::vector<TradeResponse> responses;
+        TradeResponse response;
+        while (pop_trade_response(*trades, response)) {
+            responses.push_back(response);
+        }
+        if (!coalesce) {
+            assert(responses.size() == 6);
+            assert(loop.stats().fills_coalesced == 0);
+            continue;
+        }
+
+        assert(responses.size() == 4);
+        assert(responses[0].internal_order_id == 9701 && responses[0].new_state == OrderState::MarketAccepted);
+        assert(responses[0].volume_traded == 600);
+        assert(responses[0].dvalue_traded == 100 * 1000 + 200 * 1010 + 300 * 1020);
+        assert(responses[0].dfee == 600);
+        assert(responses[0].dprice_traded == 1020);
+        assert(responses[1].internal_order_id == 9702 && responses[1].volume_traded == 100);
+        assert(responses[2].internal_order_id == 9701 && responses[2].volume_traded == 400);
+        assert(responses[3].internal_order_id == 9701 && responses[3].new_state == OrderState::Finished);
+        assert(loop.stats().events_received == 6);
+        assert(loop.stats().fills_coalesced == 2);
+        assert(loop.stats().responses_pushed == 4);
+    }
+}
+
+// 验证可重试失败经时间轮到期后重新提交，积压清空后不残留重试项。
+TEST(retryable_submits_are_resubmitted_when_due) {
+    auto downstream = make_downstream_shm();
+    auto trades = make_trades_shm();
+    auto orders = make_orders_shm();
+
+    constexpr std::size_t kOrderCount = 3;
+    // 首批三笔全部失败，第一轮重试中第一笔再失败一次
+    flaky_submit_adapter adapter(kOrderCount + 1);
+    broker_api::broker_runtime_config runtime_config;
+    runtime_config.account_id = 1;
+    runtime_config.auto_fill = false;
+    assert(adapter.initialize(runtime_config));
+
+    for (std::size_t i = 0; i < kOrderCount; ++i) {
+        OrderRequest request;
+        request.init_new("000001", InternalSecurityId("XSHE_000001"), static_cast<InternalOrderId>(9401 + i),
+                         TradeSide::Buy, Market::SZ, static_cast<Volume>(100), static_cast<DPrice>(1000), 93000000);
+        request.order_state.store(OrderState::TraderSubmitted, std::memory_order_relaxed);
+        OrderIndex index = kInvalidOrderIndex;
+        assert(orders_shm_append(orders.get(), request, OrderSlotState::DownstreamQueued,
+                                 order_slot_source_t::AccountInternal, now_ns(), index));
+        assert(downstream->order_queue.try_push(index));
+    }
+
+    gateway::gateway_loop loop(make_config(), downstream.get(), trades.get(), orders.get(), adapter);
+    std::thread worker([&loop]() { (void)loop.run(); });
+
+    const std::vector<TradeResponse> responses = collect_response_batch(trades.get(), kOrderCount);
+
+    loop.stop();
+    worker.join();
+    adapter.shutdown();
+
+    for (const TradeResponse& response : responses) {
+        assert(response.new_state == OrderState::BrokerAccepted);
+    }
+    assert(loop.stats().retries_scheduled == kOrderCount + 1);
+    assert(loop.stats().retries_exhausted == 0);
+    assert(loop.stats().orders_submitted == kOrderCount);
+    assert(loop.stats().retry_queue_size == 0);
+}
+
+// 验证同一轮积压的新单通过一次 submit_batch 提交，且逐笔得到受理回报。
+TEST(pending_orders_submit_in_one_batch) {
+    auto downstream = make_downstream_shm();
+    auto trades = make_trades_shm();
+    auto orders = make_orders_shm();
+
+    batch_counting_adapter adapter;
+    broker_api::broker_runtime_config runtime_config;
+    runtime_config.account_id = 1;
+    runtime_config.auto_fill = false;
+    assert(adapter.initialize(runtime_config));
+
+    constexpr std::size_t kOrderCount = 5;
+    for (std::size_t i = 0; i < kOrderCount; ++i) {
+        OrderRequest request;
+        request.init_new("000001", InternalSecurityId("XSHE_000001"), static_cast<InternalOrderId>(9301 + i),
+                         TradeSide::Buy, Market::SZ, static_cast<Volume>(100), static_cast<DPrice>(1000), 93000000);
+        request.order_state.store(OrderState::TraderSubmitted, std::memory_order_relaxed);
+        OrderIndex index = kInvalidOrderIndex;
+        assert(orders_shm_append(orders.get(), request, OrderSlotState::DownstreamQueued,
+                                 order_slot_source_t::AccountInternal, now_ns(), index));
+        assert(downstream->order_queue.try_push(index));
+    }
+
+    gateway::gateway_loop loop(make_config(), downstream.get(), trades.get(), orders.get(), adapter);
+    std::thread worker([&loop]() { (void)loop.run(); });
+
+    const std::vector<TradeResponse> responses = collect_response_batch(trades.get(), kOrderCount);
+
+    loop.stop();
+    worker.join();
+    adapter.shutdown();
+
+    std::size_t accepted = 0;
+    for (const TradeResponse& response : responses) {
+        if (response.new_state == OrderState::BrokerAccepted) {
+            ++accepted;
+        }
+    }
+    assert(accepted == kOrderCount);
+    assert(adapter.batch_calls.load() == 1);
+    assert(adapter.max_batch_size == kOrderCount);
+    assert(loop.stats().submit_batches == 1);
+    assert(loop.stats().orders_submitted == kOrderCount);
+
+    // 同一证券只协商一次令牌，其后各笔经转换缓存命中并携带同一令牌
+    assert(adapter.resolve_calls == 1);
+    assert(adapter.submitted.size() == kOrderCount);
+    for (const broker_api::broker_order_request& request : adapter.submitted) {
+        assert(request.security_token == batch_counting_adapter::kTokenBase + 1);
+        assert(std::string(request.internal_security_id) == "XSHE_000001");
+    }
+    assert(loop.stats().security_cache_misses == 1);
+    assert(loop.stats().security_cache_hits == kOrderCount - 1);
+}
+
+// 验证内联订单消息直接按消息字段报单，不回读槽位；证券代码超出内联宽度时回落读槽位，提交后槽位阶段照常推进。
+TEST(inline_order_messages_submit_without_slot_reads) {
+    auto downstream = make_downstream_shm();
+    auto trades = make_trades_shm();
+    auto orders = make_orders_shm();
+
+    batch_counting_adapter adapter;
+    broker_api::broker_runtime_config runtime_config;
+    runtime_config.account_id = 1;
+    runtime_config.auto_fill = false;
+    assert(adapter.initialize(runtime_config));
+
+    const char* security_ids[] = {"000001", "600000", "12345678901234"};
+    std::vector<OrderIndex> indices;
+    for (std::size_t i = 0; i < 3; ++i) {
+        OrderRequest request;
+        request.init_new(security_ids[i], InternalSecurityId("XSHE_000001"), static_cast<InternalOrderId>(9601 + i),
+                         TradeSide::Buy, Market::SZ, static_cast<Volume>(100), static_cast<DPrice>(1000), 93000000);
+        request.md_time_entrust = 93000500;
+        // 槽位里放不同价格：内联消息被采用时报单价格来自消息而非槽位
+        OrderRequest slot_request = request;
+        slot_request.dprice_entrust = 2000;
+        OrderIndex index = kInvalidOrderIndex;
+        assert(orders_shm_append(orders.get(), slot_request, OrderSlotState::DownstreamQueued,
+                                 order_slot_source_t::AccountInternal, now_ns(), index));
+        downstream_order_message message{};
+        fill_downstream_order_message(request, index, message);
+        assert(((message.flags & downstream_order_message::kReadSlot) != 0) == (i == 2));
+        assert(downstream->order_payload_queue.try_push(message));
+        indices.push_back(index);
+    }
+
+    gateway::gateway_loop loop(make_config(), downstream.get(), trades.get(), orders.get(), adapter);
+    std::thread worker([&loop]() { (void)loop.run(); });
+    const std::vector<TradeResponse> responses = collect_response_batch(trades.get(), 3);
+    loop.stop();
+    worker.join();
+    adapter.shutdown();
+
+    assert(std::all_of(responses.begin(), responses.end(),
+                       [](const TradeResponse& response) { return response.new_state == OrderState::BrokerAccepted; }));
+    assert(adapter.submitted.size() == 3);
+    assert(std::strcmp(adapter.submitted[0].security_id, "000001") == 0);
+    assert(std::strcmp(adapter.submitted[1].security_id, "600000") == 0);
+    assert(adapter.submitted[0].price == 1000 && adapter.submitted[1].price == 1000);
+    assert(adapter.submitted[0].md_time == 93000500);
+    // 回落路径按槽位内容报单
+    assert(std::strcmp(adapter.submitted[2].security_id, "12345678901234") == 0);
+    assert(adapter.submitted[2].price == 2000);
+    assert(loop.stats().orders_received == 3);
+    assert(loop.stats().orders_inline == 2);
+    assert(loop.stats().orders_submitted == 3);
+    // 出队阶段只写网关进度字：槽位 seqlock 与头部时间戳不被网关改写，读端合并后看到 DownstreamDequeued
+    for (const OrderIndex index : indices) {
+        const OrderSlot* slot = orders_shm_find_slot(orders.get(), index);
+        assert(slot != nullptr && slot->stage == OrderSlotState::DownstreamQueued);
+        assert(slot->seq.load(std::memory_order_relaxed) == 2);
+        assert(orders_shm_downstream_progress(orders.get())[index].load(std::memory_order_relaxed) != 0);
+        order_slot_snapshot snapshot;
+        assert(orders_shm_read_snapshot(orders.get(), index, snapshot));
+        assert(snapshot.stage == OrderSlotState::DownstreamDequeued);
+        assert(snapshot.last_update_ns >= slot->last_update_ns);
+    }
+}
+
+// 验证撤单优先队列先于普通订单队列提交。
+TEST(priority_cancels_submit_before_queued_orders) {
+    auto downstream = make_downstream_shm();
+    auto trades = make_trades_shm();
+    auto orders = make_orders_shm();
+
+    batch_counting_adapter adapter;
+    broker_api::broker_runtime_config runtime_config;
+    runtime_config.account_id = 1;
+    runtime_config.auto_fill = false;
+    assert(adapter.initialize(runtime_config));
+
+    OrderRequest new_request;
+    new_request.init_new("000001", InternalSecurityId("XSHE_000001"), static_cast<InternalOrderId>(9701),
+                         TradeSide::Buy, Market::SZ, static_cast<Volume>(100), static_cast<DPrice>(1000), 93000000);
+    OrderIndex new_index = kInvalidOrderIndex;
+    assert(orders_shm_append(orders.get(), new_request, OrderSlotState::DownstreamQueued,
+                             order_slot_source_t::AccountInternal, now_ns(), new_index));
+    assert(downstream->order_queue.try_push(new_index));
+
+    OrderRequest cancel_request;
+    cancel_request.init_cancel(static_cast<InternalOrderId>(9702), 93100000, static_cast<InternalOrderId>(9700));
+    OrderIndex cancel_index = kInvalidOrderIndex;
+    assert(orders_shm_append(orders.get(), cancel_request, OrderSlotState::DownstreamQueued,
+                             order_slot_source_t::AccountInternal, now_ns(), cancel_index));
+    downstream_order_message message{};
+    fill_downstream_order_message(cancel_request, cancel_index, message);
+    assert(downstream->cancel_queue.try_push(message));
+
+    gateway::gateway_loop loop(make_config(), downstream.get(), trades.get(), orders.get(), adapter);
+    std::thread worker([&loop]() { (void)loop.run(); });
+    assert(wait_until([&trades]() {
+        TradeResponse response{};
+        while (pop_trade_response(*trades, response)) {
+            if (response.internal_order_id == 9701) {
+                return true;
+            }
+        }
+        return false;
+    }));
+    loop.stop();
+    worker.join();
+    adapter.shutdown();
+
+    assert(adapter.submitted.size() == 2);
+    assert(adapter.submitted[0].type == broker_api::request_type::Cancel);
+    assert(adapter.submitted[0].orig_internal_order_id == 9700);
+    assert(adapter.submitted[1].type == broker_api::request_type::New);
+    assert(loop.stats().priority_cancels == 1);
+    assert(loop.stats().orders_received == 2);
+}
+
+// 验证会话节流：令牌不足的新单在网关内按到达顺序排队放行，撤单使用预留份额不排队。
+TEST(broker_rate_limit_paces_new_orders_in_fifo_order) {
+    auto downstream = make_downstream_shm();
+    auto trades = make_trades_shm();
+    auto orders = make_orders_shm();
+
+    batch_counting_adapter adapter;
+    broker_api::broker_runtime_config runtime_config;
+    runtime_config.account_id = 1;
+    runtime_config.auto_fill = false;
+    assert(adapter.initialize(runtime_config));
+
+    constexpr std::size_t kOrderCount = 6;
+    for (std::size_t i = 0; i < kOrderCount; ++i) {
+        OrderRequest request;
+        request.init_new("000001", InternalSecurityId("XSHE_000001"), static_cast<InternalOrderId>(9801 + i),
+                         TradeSide::Buy, Market::SZ, static_cast<Volume>(100), static_cast<DPrice>(1000), 93000000);
+        request.order_state.store(OrderState::TraderSubmitted, std::memory_order_relaxed);
+        OrderIndex index = kInvalidOrderIndex;
+        assert(orders_shm_append(orders.get(), request, OrderSlotState::DownstreamQueued,
+                                 order_slot_source_t::AccountInternal, now_ns(), index));
+        assert(downstream->order_queue.try_push(index));
+    }
+    OrderRequest cancel_request;
+    cancel_request.init_cancel(static_cast<InternalOrderId>(9810), 93100000, static_cast<InternalOrderId>(9700));
+    OrderIndex cancel_index = kInvalidOrderIndex;
+    assert(orders_shm_append(orders.get(), cancel_request, OrderSlotState::DownstreamQueued,
+                             order_slot_source_t::AccountInternal, now_ns(), cancel_index));
+    downstream_order_message message{};
+    fill_downstream_order_message(cancel_request, cancel_index, message);
+    assert(downstream->cancel_queue.try_push(message));
+
+    // 1000 笔/秒、桶深 4 个令牌、一半留给撤单：首轮撤单与最多 2 笔新单放行，其余排队
+    gateway::gateway_config config = make_config();
+    config.broker_rate_limits = {1000};
+    config.broker_rate_burst_ms = 4;
+    config.broker_cancel_reserve_pct = 50;
+    gateway::gateway_loop loop(config, downstream.get(), trades.get(), orders.get(), adapter);
+    assert(loop.start());
+    (void)loop.run_once();
+    assert(!adapter.submitted.empty());
+    assert(adapter.submitted[0].type == broker_api::request_type::Cancel);
+    assert(adapter.submitted.size() <= 3);
+    assert(loop.stats().paced_depth == kOrderCount + 1 - adapter.submitted.size());
+
+    // 令牌按单调时钟补充，放行本身需要真实时间（约 8ms）；在测试线程上逐轮驱动，
+    // 上限放宽到 10s，只防卡死，不随并行跑测试时的调度抖动失败
+    std::size_t accepted = 0;
+    assert(wait_until([&loop, &trades, &accepted]() {
+        (void)loop.run_once();
+        TradeResponse response{};
+        while (pop_trade_response(*trades, response)) {
+            if (response.new_state == OrderState::BrokerAccepted) {
+                ++accepted;
+            }
+        }
+        return accepted == kOrderCount;
+    }, 10000));
+    loop.finish();
+    adapter.shutdown();
+
+    // 排队的新单按到达顺序提交，节流环清空
+    assert(adapter.submitted.size() == kOrderCount + 1);
+    for (std::size_t i = 1; i < adapter.submitted.size(); ++i) {
+        assert(adapter.submitted[i].type == broker_api::request_type::New);
+        assert(adapter.submitted[i].internal_order_id == 9800 + i);
+    }
+    assert(loop.stats().paced_orders >= kOrderCount - 2);
+    assert(loop.stats().paced_depth == 0);
+    assert(loop.stats().orders_submitted == kOrderCount + 1);
+}
+
+// 验证网关通告改单能力，模拟柜台就地改量后撤单返回改后的剩余量。
+TEST(replace_amends_working_order) {
+    auto downstream = make_downstream_shm();
+    auto trades = make_trades_shm();
+    auto orders = make_orders_shm();
+
+    gateway::sim_broker_adapter adapter;
+    broker_api::broker_runtime_config runtime_config;
+    runtime_config.account_id = 1;
+    runtime_config.auto_fill = false;
+    assert(adapter.initialize(runtime_config));
+
+    auto push_order = [&](const OrderRequest& request) {
+        OrderIndex index = kInvalidOrderIndex;
+        assert(orders_shm_append(orders.get(), request, OrderSlotState::DownstreamQueued,
+                                 order_slot_source_t::AccountInternal, now_ns(), index));
+        assert(downstream->order_queue.try_push(index));
+    };
+    OrderRequest new_request;
+    new_request.init_new("000001", InternalSecurityId("XSHE_000001"), static_cast<InternalOrderId>(9901),
+                         TradeSide::Buy, Market::SZ, static_cast<Volume>(300), static_cast<DPrice>(1000), 93000000);
+    push_order(new_request);
+
+    gateway::gateway_loop loop(make_config(), downstream.get(), trades.get(), orders.get(), adapter);
+    std::thread worker([&loop]() { (void)loop.run(); });
+    assert(collect_response_batch(trades.get(), 1).front().new_state == OrderState::BrokerAccepted);
+    assert(downstream->broker_capabilities.load() == (kBrokerCapReplace | kBrokerCapDenseBrokerIds));
+
+    OrderRequest replace_request;
+    replace_request.init_replace(static_cast<InternalOrderId>(9902), 93100000, static_cast<InternalOrderId>(9901),
+                                 new_request, static_cast<Volume>(200), static_cast<DPrice>(990));
+    push_order(replace_request);
+    const std::vector<TradeResponse> replace_responses = collect_response_batch(trades.get(), 2);
+    assert(replace_responses[0].internal_order_id == 9902);
+    assert(replace_responses[0].new_state == OrderState::BrokerAccepted);
+    assert(replace_responses[1].new_state == OrderState::Finished);
+
+    OrderRequest cancel_request;
+    cancel_request.init_cancel(static_cast<InternalOrderId>(9903), 93200000, static_cast<InternalOrderId>(9901));
+    push_order(cancel_request);
+    const std::vector<TradeResponse> cancel_responses = collect_response_batch(trades.get(), 2);
+    loop.stop();
+    worker.join();
+    adapter.shutdown();
+
+    assert(cancel_responses[1].internal_order_id == 9901);
+    assert(cancel_responses[1].new_state == OrderState::Finished);
+    assert(cancel_responses[1].cancelled_volume == 200);
+}
+
 // 验证新单在 gateway 中可完成“受理->成交->完成”闭环。
 TEST(process_new_order_end_to_end) {
     auto downstream = make_downstream_shm();
@@ -168,7 +833,11 @@ TEST(process_new_order_end_to_end) {
     runtime_config.auto_fill = true;
     assert(adapter.initialize(runtime_config));
 
-    gateway::gateway_loop loop(make_config(), downstream.get(), trades.get(), orders.get(), adapter);
+    auto stats_shm = std::make_unique<stats_shm_layout>();
+    gateway::gateway_config config = make_config();
+    config.queue_depth_sample_iterations = 1;
+    gateway::gateway_loop loop(config, downstream.get(), trades.get(), orders.get(), adapter);
+    loop.attach_stats(stats_shm.get());
     std::thread worker([&loop]() { (void)loop.run(); });
 
     OrderRequest request;
@@ -202,6 +871,220 @@ TEST(process_new_order_end_to_end) {
     assert(has_status(statuses, OrderState::Finished));
     assert(loop.stats().orders_received >= 1);
     assert(loop.stats().responses_pushed >= 3);
+    // 内置 sim 适配器走直写回报路径
+    assert(loop.stats().direct_responses >= 3);
+
+    // 往返延迟写进统计段：一次提交调用、一次受理、一次首笔成交，终态后不再跟踪
+    const broker_session_latency& latency = stats_shm->brokers.sessions[0];
+    assert(&loop.broker_latency() == &stats_shm->brokers);
+    assert(latency.submit_call.count.load() == 1);
+    assert(latency.submit_to_accept.count.load() == 1);
+    assert(latency.accept_to_first_trade.count.load() == 1);
+    assert(stats_shm->brokers.sessions[1].submit_call.count.load() == 0);
+    assert(loop.stats().rtt_tracked == 0);
+    bool saw_submitted_metric = false;
+    bool saw_direct_metric = false;
+    bool saw_loop_metric = false;
+    for (uint32_t i = 0; i < stats_shm->metrics.slot_count.load(); ++i) {
+        const std::string name(stats_shm->metrics.slots[i].name);
+        const uint64_t value = stats_shm->metrics.slots[i].value.load();
+        if (name == "gateway.orders_submitted") {
+            saw_submitted_metric = value == 1;
+        } else if (name == "gateway.direct_responses") {
+            saw_direct_metric = value == loop.stats().direct_responses;
+        } else if (name == "gateway.loop_iterations") {
+            saw_loop_metric = value == loop.stats().loop_iterations;
+        }
+    }
+    assert(saw_submitted_metric);
+    // 停机收尾时整块统计再发布一次，统计段与进程内计数一致
+    assert(saw_direct_metric);
+    assert(saw_loop_metric);
+
+    // 网关只采样下游三个队列；上游与回报归账户服务事件循环
+    const queue_depth_stats& depths = stats_shm->queues;
+    assert(depths[shm_queue_id::DownstreamOrders].samples.load() > 0);
+    assert(depths[shm_queue_id::DownstreamOrders].capacity.load() == kDownstreamQueueCapacity);
+    assert(depths[shm_queue_id::DownstreamOrders].high_watermark.load() <= 1);
+    assert(depths[shm_queue_id::DownstreamCancels].samples.load() > 0);
+    assert(depths[shm_queue_id::UpstreamOrders].samples.load() == 0);
+}
+
+// 验证拆分适配器轮询线程后，事件经事件环交回主循环，新单闭环不变。
+TEST(split_adapter_poll_thread_end_to_end) {
+    auto downstream = make_downstream_shm();
+    auto trades = make_trades_shm();
+    auto orders = make_orders_shm();
+
+    gateway::sim_broker_adapter adapter;
+    broker_api::broker_runtime_config runtime_config;
+    runtime_config.account_id = 1;
+    runtime_config.auto_fill = true;
+    assert(adapter.initialize(runtime_config));
+
+    gateway::gateway_config config = make_config();
+    config.adapter_poll_thread = true;
+    config.adaptive_idle = true;
+    gateway::gateway_loop loop(config, downstream.get(), trades.get(), orders.get(), adapter);
+    std::thread worker([&loop]() { (void)loop.run(); });
+
+    OrderRequest request;
+    request.init_new("000001", InternalSecurityId("XSHE_000001"), static_cast<InternalOrderId>(9501), TradeSide::Buy,
+                     Market::SZ, static_cast<Volume>(100), static_cast<DPrice>(1000), 93000000);
+    request.order_state.store(OrderState::TraderSubmitted, std::memory_order_relaxed);
+
+    OrderIndex request_index = kInvalidOrderIndex;
+    assert(orders_shm_append(orders.get(), request, OrderSlotState::DownstreamQueued,
+                             order_slot_source_t::AccountInternal, now_ns(), request_index));
+    assert(downstream->order_queue.try_push(request_index));
+
+    const std::vector<OrderState> statuses = collect_statuses_for_order(trades.get(), 9501, 3);
+
+    loop.stop();
+    worker.join();
+    adapter.shutdown();
+
+    assert(has_status(statuses, OrderState::BrokerAccepted));
+    assert(has_status(statuses, OrderState::MarketAccepted));
+    assert(has_status(statuses, OrderState::Finished));
+    assert(loop.stats().events_received >= 3);
+    assert(loop.stats().responses_pushed >= 3);
+    // 轮询线程经分片回报环交给主循环
+    assert(loop.stats().direct_responses >= 3);
+}
+
+// 验证多会话分片：新单按证券分到不同适配器，未带证券的撤单仍跟随原单会话，回报汇入同一队列。
+TEST(sharded_adapters_keep_cancel_affinity) {
+    auto downstream = make_downstream_shm();
+    auto trades = make_trades_shm();
+    auto orders = make_orders_shm();
+
+    gateway::sim_broker_adapter first;
+    gateway::sim_broker_adapter second;
+    broker_api::broker_runtime_config runtime_config;
+    runtime_config.account_id = 1;
+    runtime_config.auto_fill = false;
+    assert(first.initialize(runtime_config));
+    runtime_config.session_index = 1;
+    assert(second.initialize(runtime_config));
+
+    gateway::gateway_loop loop(make_config(), downstream.get(), trades.get(), orders.get(), {&first, &second});
+    std::thread worker([&loop]() { (void)loop.run(); });
+
+    // 两只证券在 FNV-1a 取模 2 下分别落在分片 1 和分片 0
+    const auto push_new = [&](InternalOrderId order_id, const char* security_id, const char* internal_security_id) {
+        OrderRequest request;
+        request.init_new(security_id, InternalSecurityId(internal_security_id), order_id, TradeSide::Buy, Market::SZ,
+                         static_cast<Volume>(100), static_cast<DPrice>(1000), 93000000);
+        request.order_state.store(OrderState::TraderSubmitted, std::memory_order_relaxed);
+        OrderIndex index = kInvalidOrderIndex;
+        assert(orders_shm_append(orders.get(), request, OrderSlotState::DownstreamQueued,
+                                 order_slot_source_t::AccountInternal, now_ns(), index));
+        assert(downstream->order_queue.try_push(index));
+    };
+    push_new(9601, "000001", "XSHE_000001");
+    push_new(9602, "000002", "XSHE_000002");
+    const std::vector<TradeResponse> accepted = collect_response_batch(trades.get(), 2);
+    assert(accepted.size() == 2);
+
+    OrderRequest cancel_request;
+    cancel_request.init_cancel(static_cast<InternalOrderId>(9603), 93100000, static_cast<InternalOrderId>(9601));
+    cancel_request.order_state.store(OrderState::TraderSubmitted, std::memory_order_relaxed);
+    OrderIndex cancel_index = kInvalidOrderIndex;
+    assert(orders_shm_append(orders.get(), cancel_request, OrderSlotState::DownstreamQueued,
+                             order_slot_source_t::AccountInternal, now_ns(), cancel_index));
+    assert(downstream->order_queue.try_push(cancel_index));
+    const std::vector<TradeResponse> cancel_batch = collect_response_batch(trades.get(), 2);
+
+    loop.stop();
+    worker.join();
+    first.shutdown();
+    second.shutdown();
+
+    // 撤单若被路由到错误会话，该会话不认识原单，cancelled_volume 会是 0
+    bool saw_original_cancelled = false;
+    for (const TradeResponse& response : cancel_batch) {
+        if (response.internal_order_id == 9601 && response.new_state == OrderState::Finished &&
+            response.cancelled_volume == 100) {
+            saw_original_cancelled = true;
+        }
+    }
+    assert(saw_original_cancelled);
+
+    const gateway::gateway_stats& stats = loop.stats();
+    assert(stats.shard_count == 2);
+    assert(stats.shards[0].orders_routed == 1);
+    assert(stats.shards[1].orders_routed == 2);
+    assert(stats.shards[0].orders_submitted == 1);
+    assert(stats.shards[1].orders_submitted == 2);
+    assert(stats.shards[0].events_received + stats.shards[1].events_received == stats.events_received);
+}
+
+// 验证多账户共用一个柜台会话：两账户同号订单互不冲突，回报与撤单各自回到所属账户的回报队列。
+TEST(multi_account_lanes_share_one_session) {
+    auto downstream_a = make_downstream_shm();
+    auto trades_a = make_trades_shm();
+    auto orders_a = make_orders_shm();
+    auto downstream_b = make_downstream_shm();
+    auto trades_b = make_trades_shm();
+    auto orders_b = make_orders_shm();
+
+    gateway::sim_broker_adapter adapter;
+    broker_api::broker_runtime_config runtime_config;
+    runtime_config.account_id = 1;
+    runtime_config.auto_fill = false;
+    assert(adapter.initialize(runtime_config));
+
+    std::vector<gateway::gateway_account_lane> lanes{
+        gateway::gateway_account_lane{101, downstream_a.get(), trades_a.get(), orders_a.get(), {}},
+        gateway::gateway_account_lane{102, downstream_b.get(), trades_b.get(), orders_b.get(), {}}};
+    gateway::gateway_loop loop(make_config(), lanes, {&adapter});
+    std::thread worker([&loop]() { (void)loop.run(); });
+
+    const auto push_request = [](downstream_shm_layout* downstream, orders_shm_layout* orders,
+                                 const OrderRequest& request) {
+        OrderIndex index = kInvalidOrderIndex;
+        assert(orders_shm_append(orders, request, OrderSlotState::DownstreamQueued,
+                                 order_slot_source_t::AccountInternal, now_ns(), index));
+        assert(downstream->order_queue.try_push(index));
+    };
+    // 两个账户各自从同一订单号起步
+    for (auto [downstream, orders, volume] : {std::tuple{downstream_a.get(), orders_a.get(), 100},
+                                              std::tuple{downstream_b.get(), orders_b.get(), 200}}) {
+        OrderRequest request;
+        request.init_new("000001", InternalSecurityId("XSHE_000001"), static_cast<InternalOrderId>(9801),
+                         TradeSide::Buy, Market::SZ, static_cast<Volume>(volume), static_cast<DPrice>(1000), 93000000);
+        request.order_state.store(OrderState::TraderSubmitted, std::memory_order_relaxed);
+        push_request(downstream, orders, request);
+    }
+    const std::vector<OrderState> accepted_a = collect_statuses_for_order(trades_a.get(), 9801, 1);
+    const std::vector<OrderState> accepted_b = collect_statuses_for_order(trades_b.get(), 9801, 1);
+    assert(has_status(accepted_a, OrderState::BrokerAccepted));
+    assert(has_status(accepted_b, OrderState::BrokerAccepted));
+
+    // 只撤账户 B 的 9801：柜台按编码后的订单号找到 B 的原单，A 的同号订单不受影响
+    OrderRequest cancel_request;
+    cancel_request.init_cancel(static_cast<InternalOrderId>(9802), 93100000, static_cast<InternalOrderId>(9801));
+    cancel_request.order_state.store(OrderState::TraderSubmitted, std::memory_order_relaxed);
+    push_request(downstream_b.get(), orders_b.get(), cancel_request);
+    const std::vector<TradeResponse> cancel_b = collect_responses_for_order(trades_b.get(), 9801, 1);
+
+    loop.stop();
+    worker.join();
+    adapter.shutdown();
+
+    assert(cancel_b.size() == 1);
+    assert(cancel_b[0].new_state == OrderState::Finished);
+    assert(cancel_b[0].cancelled_volume == 200);
+    TradeResponse stray;
+    assert(!pop_trade_response(*trades_a, stray));
+
+    const gateway::gateway_stats& stats = loop.stats();
+    assert(stats.account_count == 2);
+    assert(stats.accounts[0].orders_received == 1);
+    assert(stats.accounts[1].orders_received == 2);
+    assert(stats.accounts[0].responses_pushed == 1);
+    assert(stats.accounts[1].responses_pushed >= 3);
 }
 
 // 验证撤单在 gateway 中可完成“受理->完成”闭环。
@@ -303,12 +1186,223 @@ TEST(cancel_finish_reports_authoritative_cancelled_volume) {
     assert(saw_original_finished);
 }
 
+// 验证热重启：订单池中已出队未终态的新单交给适配器接管，重启后的撤单按快照成交量返回剩余撤销量；
+// 仍在下游队列与已终态的订单不被恢复。
+TEST(warm_restart_recovers_in_flight_orders) {
+    auto downstream = make_downstream_shm();
+    auto trades = make_trades_shm();
+    auto orders = make_orders_shm();
+
+    const auto append_new = [&orders](InternalOrderId order_id, OrderSlotState stage, OrderState state) {
+        OrderRequest request;
+        request.init_new("000001", InternalSecurityId("XSHE_000001"), order_id, TradeSide::Buy, Market::SZ,
+                         static_cast<Volume>(100), static_cast<DPrice>(1000), 93000000);
+        request.order_state.store(state, std::memory_order_relaxed);
+        request.volume_traded = 30;
+        request.broker_order_id.as_uint = 7;
+        OrderIndex index = kInvalidOrderIndex;
+        assert(orders_shm_append(orders.get(), request, stage, order_slot_source_t::AccountInternal, now_ns(),
+                                 index));
+    };
+    append_new(9301, OrderSlotState::DownstreamDequeued, OrderState::MarketAccepted);
+    append_new(9302, OrderSlotState::Terminal, OrderState::Finished);
+    append_new(9303, OrderSlotState::DownstreamQueued, OrderState::TraderSubmitted);
+
+    gateway::sim_broker_adapter adapter;
+    broker_api::broker_runtime_config runtime_config;
+    runtime_config.account_id = 1;
+    runtime_config.auto_fill = false;
+    assert(adapter.initialize(runtime_config));
+
+    gateway::gateway_config config = make_config();
+    config.warm_restart = true;
+    gateway::gateway_loop loop(config, downstream.get(), trades.get(), orders.get(), adapter);
+    std::thread worker([&loop]() { (void)loop.run(); });
+
+    OrderRequest cancel_request;
+    cancel_request.init_cancel(static_cast<InternalOrderId>(9304), 93100000, static_cast<InternalOrderId>(9301));
+    cancel_request.internal_security_id = InternalSecurityId("XSHE_000001");
+    cancel_request.order_state.store(OrderState::TraderSubmitted, std::memory_order_relaxed);
+    OrderIndex cancel_index = kInvalidOrderIndex;
+    assert(orders_shm_append(orders.get(), cancel_request, OrderSlotState::DownstreamQueued,
+                             order_slot_source_t::AccountInternal, now_ns(), cancel_index));
+    assert(downstream->order_queue.try_push(cancel_index));
+
+    std::vector<TradeResponse> responses = collect_responses_for_order(trades.get(), 9301, 1);
+
+    loop.stop();
+    worker.join();
+    adapter.shutdown();
+
+    assert(loop.stats().orders_recovered == 1);
+    assert(responses.size() == 1);
+    assert(responses.front().new_state == OrderState::Finished);
+    assert(responses.front().cancelled_volume == 70);
+    assert(responses.front().broker_order_id == 7);
+}
+
+// 构造 sim 适配器直接使用的新单请求。
+broker_api::broker_order_request make_sim_new_request(uint32_t internal_order_id, uint64_t volume) {
+    broker_api::broker_order_request request;
+    request.internal_order_id = internal_order_id;
+    request.type = broker_api::request_type::New;
+    request.trade_side = broker_api::side::Buy;
+    request.order_market = broker_api::market::SZ;
+    request.volume = volume;
+    request.price = 1000;
+    request.md_time = 93000000;
+    std::memcpy(request.security_id, "000001", 7);
+    std::memcpy(request.internal_security_id, "XSHE_000001", 12);
+    return request;
+}
+
+// 轮询 sim 适配器直到收到 expected 条回报或超时。
+std::vector<broker_api::broker_event> drain_sim_events(gateway::sim_broker_adapter& adapter, std::size_t expected) {
+    std::vector<broker_api::broker_event> events;
+    broker_api::broker_event batch[64];
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    while (events.size() < expected && std::chrono::steady_clock::now() < deadline) {
+        const std::size_t count = adapter.poll_events(batch, 64);
+        events.insert(events.end(), batch, batch + count);
+        if (count == 0) {
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+    }
+    return events;
+}
+
+// 验证延迟成交模型：受理即时返回，成交按延迟分片到达，末片补足余量并紧跟完成。
+TEST(sim_fill_model_delays_and_slices_fills) {
+    gateway::sim_fill_model model;
+    model.fill_latency_us = 2000;
+    model.partial_fill_pct = 100;
+    model.partial_fill_slices = 3;
+    gateway::sim_broker_adapter adapter(model);
+    broker_api::broker_runtime_config runtime_config;
+    runtime_config.auto_fill = true;
+    assert(adapter.initialize(runtime_config));
+
+    assert(adapter.submit(make_sim_new_request(7001, 100)).accepted);
+    broker_api::broker_event batch[8];
+    assert(adapter.poll_events(batch, 8) == 1);
+    assert(batch[0].kind == broker_api::event_kind::BrokerAccepted);
+    assert(adapter.poll_events(batch, 8) == 0);
+
+    const std::vector<broker_api::broker_event> events = drain_sim_events(adapter, 4);
+    assert(events.size() == 4);
+    assert(events[0].kind == broker_api::event_kind::Trade && events[0].volume_traded == 33);
+    assert(events[1].kind == broker_api::event_kind::Trade && events[1].volume_traded == 33);
+    assert(events[2].kind == broker_api::event_kind::Trade && events[2].volume_traded == 34);
+    assert(events[3].kind == broker_api::event_kind::Finished && events[3].cancelled_volume == 0);
+    assert(events[3].internal_order_id == 7001);
+    adapter.shutdown();
+}
+
+// 验证撤单会取消未到期的成交片，并回报权威剩余撤销量。
+TEST(sim_cancel_stops_pending_fill_slices) {
+    gateway::sim_fill_model model;
+    model.fill_latency_us = 1000;
+    model.partial_fill_pct = 100;
+    model.partial_fill_slices = 2;
+    gateway::sim_broker_adapter adapter(model);
+    broker_api::broker_runtime_config runtime_config;
+    runtime_config.auto_fill = true;
+    assert(adapter.initialize(runtime_config));
+
+    assert(adapter.submit(make_sim_new_request(7101, 100)).accepted);
+    std::vector<broker_api::broker_event> events = drain_sim_events(adapter, 2);
+    assert(events.size() == 2);
+    assert(events[1].kind == broker_api::event_kind::Trade && events[1].volume_traded == 50);
+
+    broker_api::broker_order_request cancel = make_sim_new_request(7102, 0);
+    cancel.type = broker_api::request_type::Cancel;
+    cancel.orig_internal_order_id = 7101;
+    assert(adapter.submit(cancel).accepted);
+    events = drain_sim_events(adapter, 2);
+    assert(events.size() == 2);
+    assert(events[1].internal_order_id == 7101);
+    assert(events[1].kind == broker_api::event_kind::Finished && events[1].cancelled_volume == 50);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    broker_api::broker_event batch[8];
+    assert(adapter.poll_events(batch, 8) == 0);
+    adapter.shutdown();
+}
+
+// 验证同一种子与请求序列产生相同的回报序列，且在途池满时返回可重试错误。
+TEST(sim_fill_model_is_deterministic_and_bounded) {
+    gateway::sim_fill_model model;
+    model.reject_pct = 30;
+    model.partial_fill_pct = 50;
+    model.partial_fill_slices = 4;
+    model.seed = 99;
+    broker_api::broker_runtime_config runtime_config;
+    runtime_config.auto_fill = true;
+
+    // 不同订单的成交片按墙钟到期交错，确定性只针对逐单回报序列：按订单号稳定排序后比较。
+    std::vector<std::pair<uint32_t, broker_api::event_kind>> runs[2];
+    for (std::vector<std::pair<uint32_t, broker_api::event_kind>>& run : runs) {
+        gateway::sim_broker_adapter adapter(model);
+        assert(adapter.initialize(runtime_config));
+        for (uint32_t i = 0; i < 200; ++i) {
+            assert(adapter.submit(make_sim_new_request(8000 + i, 100)).accepted);
+        }
+        // 零延迟分片在下一次 poll 时全部到期，轮询几轮即可取完。
+        broker_api::broker_event batch[64];
+        for (int round = 0; round < 20; ++round) {
+            std::size_t count = 0;
+            while ((count = adapter.poll_events(batch, 64)) != 0) {
+                for (std::size_t i = 0; i < count; ++i) {
+                    run.emplace_back(batch[i].internal_order_id, batch[i].kind);
+                }
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        adapter.shutdown();
+        std::stable_sort(run.begin(), run.end(),
+                         [](const auto& lhs, const auto& rhs) { return lhs.first < rhs.first; });
+    }
+    assert(runs[0] == runs[1]);
+    const auto count_kind = [&](broker_api::event_kind kind) {
+        return std::count_if(runs[0].begin(), runs[0].end(), [kind](const auto& item) { return item.second == kind; });
+    };
+    assert(count_kind(broker_api::event_kind::BrokerRejected) > 0);
+    assert(count_kind(broker_api::event_kind::Trade) > 200 - 60);
+
+    gateway::sim_fill_model small;
+    small.max_active_orders = 2;
+    gateway::sim_broker_adapter bounded(small);
+    runtime_config.auto_fill = false;
+    assert(bounded.initialize(runtime_config));
+    assert(bounded.submit(make_sim_new_request(9001, 100)).accepted);
+    assert(bounded.submit(make_sim_new_request(9002, 100)).accepted);
+    const broker_api::send_result full = bounded.submit(make_sim_new_request(9003, 100));
+    assert(!full.accepted && full.retryable);
+    bounded.shutdown();
+}
+
 int main() {
     printf("=== Gateway Loop Test Suite ===\n\n");
 
     RUN_TEST(process_new_order_end_to_end);
     RUN_TEST(process_cancel_order_end_to_end);
     RUN_TEST(cancel_finish_reports_authoritative_cancelled_volume);
+    RUN_TEST(warm_restart_recovers_in_flight_orders);
+    RUN_TEST(pending_orders_submit_in_one_batch);
+    RUN_TEST(inline_order_messages_submit_without_slot_reads);
+    RUN_TEST(priority_cancels_submit_before_queued_orders);
+    RUN_TEST(broker_rate_limit_paces_new_orders_in_fifo_order);
+    RUN_TEST(replace_amends_working_order);
+    RUN_TEST(retryable_submits_are_resubmitted_when_due);
+    RUN_TEST(full_response_queue_spills_and_backpressures);
+    RUN_TEST(consecutive_fills_coalesce_within_batch);
+    RUN_TEST(split_adapter_poll_thread_end_to_end);
+    RUN_TEST(direct_response_writer_fills_trades_queue);
+    RUN_TEST(sharded_adapters_keep_cancel_affinity);
+    RUN_TEST(multi_account_lanes_share_one_session);
+    RUN_TEST(sim_fill_model_delays_and_slices_fills);
+    RUN_TEST(sim_cancel_stops_pending_fill_slices);
+    RUN_TEST(sim_fill_model_is_deterministic_and_bounded);
 
     printf("\n=== All tests passed! ===\n");
     return 0;
@@ -46,6 +46,18 @@ TEST(map_new_order_request) {
     assert(std::string(mapped.security_id) == "600000");
 }
 
+// 验证非 canonical 的旧格式证券键不走整块拷贝快路径，仍规范化为 MIC 键。
+TEST(map_legacy_internal_security_id_is_normalized) {
+    OrderRequest request;
+    request.init_new("000001", InternalSecurityId("SZ.000001"), static_cast<InternalOrderId>(1002), TradeSide::Sell,
+                     Market::SZ, static_cast<Volume>(100), static_cast<DPrice>(1000), 93000000);
+
+    broker_api::broker_order_request mapped;
+    assert(gateway::map_order_request_to_broker(request, mapped));
+    assert(std::string(mapped.internal_security_id) == "XSHE_000001");
+    assert(std::string(mapped.security_id) == "000001");
+}
+
 // 验证撤单映射保留原订单关联关系。
 TEST(map_cancel_order_request) {
     OrderRequest request;
@@ -59,6 +71,85 @@ TEST(map_cancel_order_request) {
     assert(mapped.type == broker_api::request_type::Cancel);
 }
 
+// 验证改单映射携带原单、改后数量价格与证券代码，缺少价格时映射失败。
+TEST(map_replace_order_request) {
+    OrderRequest orig;
+    orig.init_new("600000", InternalSecurityId("XSHG_600000"), static_cast<InternalOrderId>(1001), TradeSide::Sell,
+                  Market::SH, static_cast<Volume>(300), static_cast<DPrice>(1234), 93000000);
+    OrderRequest request;
+    request.init_replace(static_cast<InternalOrderId>(3001), 93200000, static_cast<InternalOrderId>(1001), orig,
+                         static_cast<Volume>(200), static_cast<DPrice>(1250));
+
+    broker_api::broker_order_request mapped;
+    assert(gateway::map_order_request_to_broker(request, mapped));
+    assert(mapped.type == broker_api::request_type::Replace);
+    assert(mapped.internal_order_id == static_cast<uint32_t>(3001));
+    assert(mapped.orig_internal_order_id == static_cast<uint32_t>(1001));
+    assert(mapped.trade_side == broker_api::side::Sell);
+    assert(mapped.order_market == broker_api::market::SH);
+    assert(mapped.volume == 200 && mapped.price == 1250);
+    assert(std::string(mapped.security_id) == "600000");
+
+    downstream_order_message message{};
+    fill_downstream_order_message(request, 7, message);
+    broker_api::broker_order_request inline_mapped;
+    assert(gateway::map_downstream_message_to_broker(message, inline_mapped));
+    assert(inline_mapped.type == broker_api::request_type::Replace);
+    assert(inline_mapped.volume == 200 && inline_mapped.price == 1250);
+    assert(std::string(inline_mapped.security_id) == "600000");
+
+    request.dprice_entrust = 0;
+    assert(!gateway::map_order_request_to_broker(request, mapped));
+}
+
+// 令牌协商回调：记录调用次数并按次序分配令牌。
+uint64_t counting_resolver(void* context, const broker_api::broker_order_request& request) noexcept {
+    (void)request;
+    return 100 + ++*static_cast<std::size_t*>(context);
+}
+
+// 验证证券转换缓存：首个新单登记并协商令牌，同证券后续新单、内联消息和撤单命中缓存；登记满后新证券逐笔转换。
+TEST(security_conversion_cache_reuses_conversion) {
+    std::size_t resolve_calls = 0;
+    gateway::security_conversion_cache cache(1, &counting_resolver, &resolve_calls);
+
+    OrderRequest request;
+    request.init_new("000001", InternalSecurityId("SZ.000001"), static_cast<InternalOrderId>(1101), TradeSide::Buy,
+                     Market::SZ, static_cast<Volume>(100), static_cast<DPrice>(1000), 93000000);
+    broker_api::broker_order_request mapped;
+    assert(gateway::map_order_request_to_broker(request, mapped, &cache));
+    assert(resolve_calls == 1 && mapped.security_token == 101);
+    assert(std::string(mapped.internal_security_id) == "XSHE_000001");
+    assert(cache.size() == 1 && cache.misses() == 1 && cache.hits() == 0);
+
+    request.internal_order_id = 1102;
+    assert(gateway::map_order_request_to_broker(request, mapped, &cache));
+    assert(resolve_calls == 1 && mapped.security_token == 101);
+    assert(std::string(mapped.internal_security_id) == "XSHE_000001");
+    assert(mapped.order_market == broker_api::market::SZ);
+    assert(std::string(mapped.security_id) == "000001");
+    assert(cache.hits() == 1);
+
+    downstream_order_message message{};
+    fill_downstream_order_message(request, 3, message);
+    broker_api::broker_order_request inline_mapped;
+    assert(gateway::map_downstream_message_to_broker(message, inline_mapped, &cache));
+    assert(inline_mapped.security_token == 101 && cache.hits() == 2);
+
+    // 不带证券的撤单未命中也不登记
+    OrderRequest cancel_request;
+    cancel_request.init_cancel(static_cast<InternalOrderId>(1103), 93100000, static_cast<InternalOrderId>(1101));
+    assert(gateway::map_order_request_to_broker(cancel_request, mapped, &cache));
+    assert(mapped.security_token == 0 && cache.size() == 1);
+
+    OrderRequest other;
+    other.init_new("600000", InternalSecurityId("XSHG_600000"), static_cast<InternalOrderId>(1104), TradeSide::Sell,
+                   Market::SH, static_cast<Volume>(100), static_cast<DPrice>(1000), 93000000);
+    assert(gateway::map_order_request_to_broker(other, mapped, &cache));
+    assert(std::string(mapped.internal_security_id) == "XSHG_600000");
+    assert(mapped.security_token == 0 && resolve_calls == 1 && cache.size() == 1);
+}
+
 // 验证成交事件映射到 trade_response 的状态与数值字段。
 TEST(map_trade_event_response) {
     broker_api::broker_event event;
@@ -110,15 +201,64 @@ TEST(map_cancel_finished_response) {
     assert(response.cancelled_volume == 37);
 }
 
+// 验证 trades_shm 紧凑回报消息：成交回报保留全部数值字段但不带证券键，无成交回报保留证券键与撤销数量。
+TEST(trade_response_message_round_trip) {
+    broker_api::broker_event event;
+    event.kind = broker_api::event_kind::Trade;
+    event.internal_order_id = 3001;
+    event.broker_order_id = 7001;
+    std::strcpy(event.internal_security_id, "XSHE_000009");
+    event.trade_side = broker_api::side::Sell;
+    event.volume_traded = 88;
+    event.price_traded = 3210;
+    event.value_traded = 282480;
+    event.fee = 30;
+    event.md_time_traded = 100001000;
+    event.recv_time_ns = 123456789;
+
+    TradeResponse fill;
+    assert(gateway::map_broker_event_to_trade_response(event, fill));
+    trade_response_message message;
+    pack_trade_response_message(fill, message);
+    assert((message.flags & trade_response_message::kFill) != 0);
+    TradeResponse decoded;
+    unpack_trade_response_message(message, decoded);
+    assert(decoded.internal_order_id == 3001 && decoded.broker_order_id == 7001);
+    assert(decoded.trade_side == TradeSide::Sell && decoded.new_state == OrderState::MarketAccepted);
+    assert(decoded.volume_traded == 88 && decoded.dprice_traded == 3210);
+    assert(decoded.dvalue_traded == 282480 && decoded.dfee == 30);
+    assert(decoded.md_time_traded == 100001000 && decoded.recv_time_ns == 123456789);
+    assert(decoded.internal_security_id.empty());
+
+    event = broker_api::broker_event{};
+    event.kind = broker_api::event_kind::Finished;
+    event.internal_order_id = 4001;
+    std::strcpy(event.internal_security_id, "XSHE_000009");
+    event.trade_side = broker_api::side::Buy;
+    event.cancelled_volume = 37;
+    TradeResponse finished;
+    assert(gateway::map_broker_event_to_trade_response(event, finished));
+    pack_trade_response_message(finished, message);
+    assert(message.flags == 0);
+    unpack_trade_response_message(message, decoded);
+    assert(decoded.internal_order_id == 4001 && decoded.new_state == OrderState::Finished);
+    assert(decoded.internal_security_id == std::string_view("XSHE_000009"));
+    assert(decoded.cancelled_volume == 37 && decoded.volume_traded == 0 && decoded.dvalue_traded == 0);
+}
+
 } // namespace
 
 int main() {
     printf("=== Gateway Mapper Test Suite ===\n\n");
 
     RUN_TEST(map_new_order_request);
+    RUN_TEST(map_legacy_internal_security_id_is_normalized);
     RUN_TEST(map_cancel_order_request);
+    RUN_TEST(map_replace_order_request);
+    RUN_TEST(security_conversion_cache_reuses_conversion);
     RUN_TEST(map_trade_event_response);
     RUN_TEST(map_cancel_finished_response);
+    RUN_TEST(trade_response_message_round_trip);
 
     printf("\n=== All tests passed! ===\n");
     return 0;
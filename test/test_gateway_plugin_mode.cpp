@@ -26,6 +26,16 @@ namespace {
 
 using namespace acct_service;
 
+// 取出一条 trades_shm 回报并解码为 TradeResponse。
+bool pop_trade_response(trades_shm_layout& trades, TradeResponse& out) {
+    trade_response_message message;
+    if (!trades.response_queue.try_pop(message)) {
+        return false;
+    }
+    unpack_trade_response_message(message, out);
+    return true;
+}
+
 #ifndef TEST_ADAPTER_PLUGIN_PATH
 #error "TEST_ADAPTER_PLUGIN_PATH is not defined"
 #endif
@@ -35,7 +45,7 @@ void init_header(SHMHeader& header) {
     header.version = SHMHeader::kVersion;
     header.create_time = now_ns();
     header.last_update = header.create_time;
-    header.next_order_id.store(1, std::memory_order_relaxed);
+    header.next_id_epoch.store(1, std::memory_order_relaxed);
 }
 
 std::unique_ptr<downstream_shm_layout> make_downstream_shm() {
@@ -146,7 +156,7 @@ TEST(process_new_order_with_plugin_adapter) {
     std::vector<OrderState> statuses;
     const bool got_all = wait_until([&]() {
         TradeResponse response;
-        while (trades->response_queue.try_pop(response)) {
+        while (pop_trade_response(*trades, response)) {
             if (response.internal_order_id == static_cast<InternalOrderId>(9301)) {
                 statuses.push_back(response.new_state);
             }
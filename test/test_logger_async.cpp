@@ -2,11 +2,20 @@
 #include <cstdio>
 #include <filesystem>
 #include <fstream>
+#include <iterator>
 #include <string>
+#include <vector>
+
+#include <unistd.h>
 
 #include "common/error.hpp"
 #include "common/log.hpp"
 #include "core/config_manager.hpp"
+#include "logging/log.hpp"
+#include "logging/log_batch_decoder.hpp"
+#include "logging/log_fmt_macros.hpp"
+#include "shm/shm_generic.hpp"
+#include "utils/async_file_writer.hpp"
 
 #define TEST(name) static void test_##name()
 #define RUN_TEST(name)                   \
@@ -65,11 +74,425 @@ TEST(queue_full_drop_counter) {
     assert(dropped > 0);
 }
 
+TEST(compact_records_decode_in_reader) {
+    LogConfig cfg;
+    cfg.log_dir = "./build/test_logs";
+    cfg.log_level = "info";
+    cfg.async_logging = true;
+    const std::string output_path = cfg.log_dir + "/compact_1001.log";
+    std::error_code ec;
+    std::filesystem::remove(output_path, ec);
+
+    AsyncLogger logger;
+    assert(logger.init(cfg, 1001, "compact"));
+    assert(!logger.enabled(LogLevel::debug));
+    assert(logger.enabled(LogLevel::warn));
+
+    // 短文件名 + 短消息落进固定槽；长消息进变长区并保留 255 字节上限
+    LogView short_view;
+    short_view.level = LogLevel::warn;
+    short_view.module = "orders_shm";
+    short_view.file = "/src/shm/a.cpp";
+    short_view.line = 7;
+    short_view.message = "full";
+    short_view.domain = ErrorDomain::shm;
+    short_view.code = ErrorCode::OrderPoolFull;
+    assert(logger.log(short_view));
+
+    const std::string long_message(400, 'x');
+    LogView long_view = short_view;
+    long_view.level = LogLevel::info;
+    long_view.message = long_message;
+    long_view.sys_errno = 12;
+    assert(logger.log(long_view));
+
+    LogView filtered = short_view;
+    filtered.level = LogLevel::debug;
+    filtered.message = "filtered";
+    assert(logger.log(filtered));
+
+    assert(logger.flush(500));
+    logger.shutdown();
+
+    std::ifstream in(output_path);
+    assert(in.is_open());
+    std::string first;
+    std::string second;
+    std::string extra;
+    std::getline(in, first);
+    std::getline(in, second);
+    assert(!std::getline(in, extra));
+    assert(first.find("[WARN][orders_shm] [a.cpp:7] severity=Recoverable") != std::string::npos);
+    assert(first.find("code=OrderPoolFull domain=shm errno=0 msg=full") != std::string::npos);
+    assert(second.find("errno=12 msg=xxxx") != std::string::npos);
+    assert(second.find(std::string(256, 'x')) == std::string::npos);
+}
+
+// 直接驱动 BaseCore 写端：DropNew 满时丢新并计数，读端消费后补写 Overrun 标记；OverwriteOld 由读端报告落后。
+TEST(basecore_writer_overflow_policies_account_losses) {
+    const std::string shm_name = "/acct_test_log_policy_" + std::to_string(::getpid());
+    const std::string output_path = "./build/test_logs/policy_" + std::to_string(::getpid()) + ".log";
+    std::error_code ec;
+    std::filesystem::create_directories("./build/test_logs", ec);
+    std::filesystem::remove(output_path, ec);
+    (void)shm::ShmGenericWriter::unlink(shm_name);
+
+    base_core_log::ShmLogConfig config;
+    config.shm_name = shm_name;
+    config.per_thread = false;
+    config.output_path = output_path;
+    config.overflow_policy = base_core_log::LogOverflowPolicy::DropNew;
+    base_core_log::ShmLogger logger;
+    assert(base_core_log::init_shm_logger(config, logger));
+    base_core_log::LogBufferWriter* writer = logger.writer();
+    base_core_log::LogShmStats* stats = logger.stats();
+    assert(writer && stats);
+
+    constexpr uint8_t kModule = 14;
+    constexpr std::size_t kCapacity = base_core_log::ShmLogger::kBufferCapacity;
+    for (std::size_t i = 0; i < kCapacity + 10; ++i) {
+        assert(base_core_log::log_write_str(*writer, base_core_log::LogLevel::info, 1, kModule, "x", 1));
+    }
+    assert(stats->total_dropped.load() == 10);
+    assert(stats->lost_by_module[kModule].load() == 10);
+    assert(stats->fixed_written.load() == kCapacity);
+
+    base_core_log::LogReader reader(shm_name, output_path);
+    assert(reader.init());
+    assert(reader.read_new() == static_cast<int>(kCapacity));
+    assert(base_core_log::log_write_str(*writer, base_core_log::LogLevel::info, 1, kModule, "y", 1));
+    assert(reader.read_new() == 2);
+
+    // 审计模块单独走 BoundedSpin：读端不推进时自旋上限后丢弃，丢失数同样可见
+    writer->set_overflow_policy(base_core_log::LogOverflowPolicy::DropNew, 64);
+    writer->set_module_policy(kModule + 1, base_core_log::LogOverflowPolicy::BoundedSpin);
+    for (std::size_t i = 0; i < kCapacity; ++i) {
+        assert(base_core_log::log_write_str(*writer, base_core_log::LogLevel::info, 1, kModule, "z", 1));
+    }
+    assert(base_core_log::log_write_str(*writer, base_core_log::LogLevel::info, 1, kModule + 1, "audit", 5));
+    assert(stats->lost_by_module[kModule + 1].load() == 1);
+
+    // 覆盖模式不等待读端，只累计被覆盖的未读条目
+    writer->set_overflow_policy(base_core_log::LogOverflowPolicy::OverwriteOld, 0);
+    for (std::size_t i = 0; i < 5; ++i) {
+        assert(base_core_log::log_write_str(*writer, base_core_log::LogLevel::info, 1, kModule, "w", 1));
+    }
+    assert(stats->overwritten.load() >= 5);
+    assert(reader.read_new() > 0);
+    reader.close();
+    logger.close();
+    (void)shm::ShmGenericWriter::unlink(shm_name);
+
+    std::ifstream in(output_path);
+    std::string line;
+    bool saw_marker = false;
+    bool saw_lag = false;
+    while (std::getline(in, line)) {
+        saw_marker = saw_marker || line.find("overrun: 10 entries dropped by writer") != std::string::npos;
+        saw_lag = saw_lag || line.find("overrun: reader lagged") != std::string::npos;
+    }
+    assert(saw_marker);
+    assert(saw_lag);
+}
+
+// 两个 per_thread 环交错写入（含变长区条目），合并读取按 ts_tsc 输出；超出水位的条目留到 finish()。
+TEST(merge_reader_orders_per_thread_rings_by_tsc) {
+    const std::string base_name = "/acct_test_log_merge_" + std::to_string(::getpid());
+    const std::string output_path = "./build/test_logs/merge_" + std::to_string(::getpid()) + ".log";
+    std::error_code ec;
+    std::filesystem::create_directories("./build/test_logs", ec);
+    std::filesystem::remove(output_path, ec);
+
+    base_core_log::ShmLogConfig config;
+    config.shm_name = base_name;
+    config.per_thread = true;
+    base_core_log::ShmLogger ring_a;
+    base_core_log::ShmLogger ring_b;
+    assert(base_core_log::init_shm_logger(config, ring_a));
+    assert(base_core_log::init_shm_logger(config, ring_b));
+    assert(ring_a.thread_id() != ring_b.thread_id());
+    const std::vector<std::string> names = {base_name + "_" + std::to_string(ring_a.thread_id()),
+                                            base_name + "_" + std::to_string(ring_b.thread_id())};
+
+    const auto write = [](base_core_log::ShmLogger& logger, uint64_t ts, const std::string& text) {
+        assert(base_core_log::log_write_str(*logger.writer(), base_core_log::LogLevel::info, ts, 1, text.data(),
+                                            text.size()));
+    };
+    const std::string padding = " padded past the fixed slot payload";
+    write(ring_a, 100, "m1");
+    write(ring_a, 300, "m3");
+    write(ring_a, 400, "m5" + padding);
+    write(ring_a, 500, "m6");
+    write(ring_b, 200, "m2");
+    write(ring_b, 350, "m4" + padding);
+    write(ring_b, 600, "m7");
+
+    base_core_log::LogMergeReader reader(names, output_path);
+    assert(reader.init());
+    assert(reader.read_new() == 7);
+
+    // 远超当前 TSC 的条目高于水位，跟随模式不输出
+    write(ring_b, 700, "m8");
+    write(ring_a, base_core_log::rdtsc() + (uint64_t{1} << 50), "m9");
+    assert(reader.read_new() == 1);
+    assert(reader.finish() == 1);
+    reader.close();
+    ring_a.close();
+    ring_b.close();
+    for (const std::string& name : names) {
+        (void)shm::ShmGenericWriter::unlink(name);
+    }
+
+    std::ifstream in(output_path);
+    std::string line;
+    int expected = 1;
+    while (std::getline(in, line)) {
+        const std::string tag = "m" + std::to_string(expected);
+        assert(line.find(tag) != std::string::npos);
+        ++expected;
+    }
+    assert(expected == 10);
+}
+
+namespace base_core_log {
+
+// 测试用格式：一个落固定槽，一个超过 32 字节走变长区
+struct TestLogFormats {
+    static std::string pair(int32_t a, uint64_t b) { return "pair " + std::to_string(a) + " " + std::to_string(b); }
+    LogFmt(pair, int32_t, uint64_t)
+
+    static std::string wide(uint64_t a, uint64_t b, uint64_t c, uint64_t d, uint64_t e) {
+        return "wide " + std::to_string(a + b + c + d + e);
+    }
+    LogFmt(wide, uint64_t, uint64_t, uint64_t, uint64_t, uint64_t)
+};
+
+}  // namespace base_core_log
+
+// LogFmt 的 id 与 payload 长度在编译期确定；LOG_FMT 按声明类型打包，实参拓宽后仍能按声明解码。
+TEST(checked_log_fmt_uses_static_ids_and_sizes) {
+    using base_core_log::TestLogFormats;
+    static_assert(TestLogFormats::pair_id == base_core_log::log_fmt_id("pair"));
+    static_assert(TestLogFormats::pair_payload_size == sizeof(int32_t) + sizeof(uint64_t));
+    static_assert(TestLogFormats::wide_payload_size == 5 * sizeof(uint64_t));
+    assert(base_core_log::LogFormatRegistry::register_func(TestLogFormats::pair_id, TestLogFormats::pair_decode,
+                                                           TestLogFormats::pair_payload_size));
+    assert(base_core_log::LogFormatRegistry::register_func(TestLogFormats::wide_id, TestLogFormats::wide_decode,
+                                                           TestLogFormats::wide_payload_size));
+    // 同一 id 换成别的格式时拒绝，避免静默错解
+    assert(!base_core_log::LogFormatRegistry::register_func(TestLogFormats::pair_id, TestLogFormats::wide_decode,
+                                                            TestLogFormats::wide_payload_size));
+
+    const std::string shm_name = "/acct_test_log_fmt_" + std::to_string(::getpid());
+    const std::string output_path = "./build/test_logs/fmt_" + std::to_string(::getpid()) + ".log";
+    std::error_code ec;
+    std::filesystem::create_directories("./build/test_logs", ec);
+    std::filesystem::remove(output_path, ec);
+    (void)shm::ShmGenericWriter::unlink(shm_name);
+
+    base_core_log::ShmLogConfig config;
+    config.shm_name = shm_name;
+    config.per_thread = false;
+    base_core_log::ShmLogger logger;
+    assert(base_core_log::init_shm_logger(config, logger));
+    base_core_log::LogBufferWriter& writer = *logger.writer();
+    const int16_t small = -7;
+    const uint32_t value = 9;
+    assert(LOG_FMT(writer, base_core_log::LogLevel::info, 1, TestLogFormats::pair, small, value));
+    assert(LOG_FMT(writer, base_core_log::LogLevel::info, 1, TestLogFormats::wide, 1u, 2u, 3u, 4u, uint64_t{5}));
+
+    base_core_log::LogReader reader(shm_name, output_path);
+    assert(reader.init());
+    assert(reader.read_new() == 2);
+    reader.close();
+    logger.close();
+    (void)shm::ShmGenericWriter::unlink(shm_name);
+
+    std::ifstream in(output_path);
+    const std::string text((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    assert(text.find("pair -7 9") != std::string::npos);
+    assert(text.find("wide 15") != std::string::npos);
+}
+
+// 归档环批量解码：分块并行解码后按时间归并；模块、级别、时间过滤在格式化前生效，格式函数走注册表快照。
+TEST(batch_decoder_merges_archived_rings_with_filters) {
+    using base_core_log::LogLevel;
+    using base_core_log::TestLogFormats;
+    const std::string base_name = "/acct_test_log_batch_" + std::to_string(::getpid());
+    const std::string archive_dir = "./build/test_logs/batch_" + std::to_string(::getpid());
+    std::error_code ec;
+    std::filesystem::create_directories(archive_dir, ec);
+
+    base_core_log::ShmLogConfig config;
+    config.shm_name = base_name;
+    config.per_thread = true;
+    base_core_log::ShmLogger ring_a;
+    base_core_log::ShmLogger ring_b;
+    assert(base_core_log::init_shm_logger(config, ring_a));
+    assert(base_core_log::init_shm_logger(config, ring_b));
+
+    // 真实 TSC 附近取时间戳，条目间隔远大于两个环各自校准带来的换算误差
+    const uint64_t base = base_core_log::rdtsc();
+    constexpr uint64_t kStep = 200'000'000;
+    const auto write = [base](base_core_log::ShmLogger& logger, uint64_t step, LogLevel level, uint8_t module,
+                              const std::string& text) {
+        assert(base_core_log::log_write_str(*logger.writer(), level, base + step * kStep, module, text.data(),
+                                            text.size()));
+    };
+    const std::string padding = " padded past the fixed slot payload";
+    write(ring_a, 1, LogLevel::info, 1, "m1");
+    write(ring_a, 3, LogLevel::warn, 1, "m3" + padding);
+    write(ring_a, 4, LogLevel::debug, 1, "d4");
+    write(ring_a, 6, LogLevel::info, 2, "o6");
+    write(ring_b, 2, LogLevel::info, 1, "m2");
+    write(ring_b, 5, LogLevel::error, 1, "m5" + padding);
+    write(ring_b, 7, LogLevel::info, 1, "m7");
+    const int16_t small = -3;
+    const uint64_t value = 11;
+    assert(base_core_log::log_write_fmt_checked<TestLogFormats::pair_args>(
+        *ring_b.writer(), LogLevel::info, base + 8 * kStep, 1, TestLogFormats::pair_id, small, value));
+
+    const uint64_t end_ns = base_core_log::log_tsc_to_ns(base + 7 * kStep, ring_b.header());
+
+    // 归档：把两个环的共享内存文件原样拷走，另加一个不是日志环的文件
+    const std::vector<std::string> names = {base_name + "_" + std::to_string(ring_a.thread_id()),
+                                            base_name + "_" + std::to_string(ring_b.thread_id())};
+    std::vector<std::string> captures;
+    for (const std::string& name : names) {
+        captures.push_back(archive_dir + name);
+        std::filesystem::copy_file("/dev/shm" + name, captures.back(),
+                                   std::filesystem::copy_options::overwrite_existing);
+    }
+    ring_a.close();
+    ring_b.close();
+    for (const std::string& name : names) {
+        (void)shm::ShmGenericWriter::unlink(name);
+    }
+
+    const auto read_lines = [](const std::string& path) {
+        std::ifstream in(path);
+        std::vector<std::string> lines;
+        for (std::string line; std::getline(in, line);) {
+            lines.push_back(line);
+        }
+        return lines;
+    };
+
+    base_core_log::LogBatchDecodeOptions all;
+    all.threads = 4;
+    all.chunk_records = 1;
+    const std::string all_path = archive_dir + "/all.log";
+    base_core_log::LogBatchDecoder all_decoder(captures, all_path, all);
+    assert(all_decoder.run() == 0);
+    assert(all_decoder.stats().files == 2 && all_decoder.stats().records == 8 && all_decoder.stats().chunks == 8);
+    const std::vector<std::string> all_lines = read_lines(all_path);
+    const std::vector<std::string> expected = {"m1", "m2", "m3", "d4", "m5", "o6", "m7", "pair -3 11"};
+    assert(all_lines.size() == expected.size());
+    for (std::size_t i = 0; i < expected.size(); ++i) {
+        assert(all_lines[i].find(expected[i]) != std::string::npos);
+    }
+
+    // 模块 1、info 及以上、截到第 7 步之前；再混入一个无效文件，其余文件照常输出但返回失败
+    base_core_log::LogBatchDecodeOptions filtered;
+    filtered.threads = 2;
+    filtered.filter.allow_module(1);
+    filtered.filter.min_level = LogLevel::info;
+    filtered.filter.end_ns = end_ns;
+    const std::string bogus = archive_dir + "/bogus.bin";
+    std::ofstream(bogus) << "not a log ring";
+    std::vector<std::string> with_bogus = captures;
+    with_bogus.push_back(bogus);
+    const std::string filtered_path = archive_dir + "/filtered.log";
+    base_core_log::LogBatchDecoder filtered_decoder(with_bogus, filtered_path, filtered);
+    assert(filtered_decoder.run() == 1);
+    assert(filtered_decoder.stats().rejected_files == 1 && filtered_decoder.stats().emitted == 4);
+    const std::vector<std::string> filtered_lines = read_lines(filtered_path);
+    const std::vector<std::string> expected_filtered = {"m1", "m2", "m3", "m5"};
+    assert(filtered_lines.size() == expected_filtered.size());
+    for (std::size_t i = 0; i < expected_filtered.size(); ++i) {
+        assert(filtered_lines[i].find(expected_filtered[i]) != std::string::npos);
+    }
+
+    std::filesystem::remove_all(archive_dir, ec);
+}
+
+std::string read_file(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+// 两个后端：跨缓冲块追加、缓冲耗尽时等待、reopen 续写与 rewrite 截断都保持字节顺序
+TEST(async_file_writer_backends_preserve_order) {
+    std::filesystem::create_directories("./build/test_logs");
+    for (const bool use_io_uring : {false, true}) {
+        const std::string path = std::string("./build/test_logs/async_file_writer_") +
+                                 (use_io_uring ? "uring" : "pwritev") + ".log";
+        base_core::AsyncFileWriterConfig config;
+        config.buffer_bytes = 4096;
+        config.buffer_count = 2;
+        config.sync_bytes = 64 * 1024;
+        config.use_io_uring = use_io_uring;
+
+        std::string expected;
+        {
+            base_core::AsyncFileWriter writer;
+            assert(writer.open(path, true, config));
+            assert(writer.backend() != base_core::AsyncFileWriter::Backend::None);
+            if (!use_io_uring) {
+                assert(writer.backend() == base_core::AsyncFileWriter::Backend::Pwritev);
+            }
+            for (int i = 0; i < 20000; ++i) {
+                const std::string line = "line=" + std::to_string(i) + " payload=" + std::string(i % 97, 'p') + "\n";
+                assert(writer.write(line));
+                expected += line;
+                if (i % 1000 == 0) {
+                    writer.flush();
+                }
+            }
+            assert(writer.drain());
+            assert(read_file(path) == expected);
+            assert(writer.sync());
+            const base_core::AsyncFileWriterStats stats = writer.stats();
+            assert(stats.errors == 0);
+            assert(stats.bytes_written == expected.size());
+            assert(stats.syncs >= expected.size() / config.sync_bytes);
+            writer.close();
+        }
+
+        {
+            base_core::AsyncFileWriter writer;
+            assert(writer.open(path, false, config));
+            assert(writer.write(std::string_view("tail\n")));
+            writer.close();
+            expected += "tail\n";
+            assert(read_file(path) == expected);
+        }
+
+        {
+            base_core::AsyncFileWriter writer;
+            assert(writer.open(path, false, config));
+            assert(writer.write(std::string_view("discarded")));
+            assert(writer.rewrite(std::string_view("snapshot v1 with more bytes\n")));
+            assert(writer.rewrite(std::string_view("snapshot v2\n")));
+            assert(writer.drain());
+            assert(read_file(path) == "snapshot v2\n");
+            writer.close();
+        }
+        std::filesystem::remove(path);
+    }
+}
+
 int main() {
     printf("=== Async Logger Test Suite ===\n\n");
 
     RUN_TEST(async_logger_write_and_flush);
     RUN_TEST(queue_full_drop_counter);
+    RUN_TEST(compact_records_decode_in_reader);
+    RUN_TEST(basecore_writer_overflow_policies_account_losses);
+    RUN_TEST(merge_reader_orders_per_thread_rings_by_tsc);
+    RUN_TEST(checked_log_fmt_uses_static_ids_and_sizes);
+    RUN_TEST(batch_decoder_merges_archived_rings_with_filters);
+    RUN_TEST(async_file_writer_backends_preserve_order);
 
     printf("\n=== All tests passed! ===\n");
     return 0;
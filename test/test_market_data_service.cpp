@@ -7,6 +7,7 @@
 #include <memory>
 #include <string>
 
+#include "market_data/market_data_replay.hpp"
 #include "market_data/market_data_service.hpp"
 #include "snapshot_shm.hpp"
 
@@ -57,12 +58,12 @@ std::string unique_snapshot_path(const char* prefix) {
 using snapshot_writer_ptr = std::unique_ptr<void, void (*)(void*)>;
 
 // 初始化一个只有单标的 snapshot 文件，供读端测试复用。
-snapshot_writer_ptr make_writer(const std::string& snapshot_path) {
+snapshot_writer_ptr make_writer(const std::string& snapshot_path, const char* symbol_name = "XSHE_000001") {
     snapshot_writer_ptr writer(snapshot_shm_writer_new(), snapshot_shm_writer_delete);
     assert(writer != nullptr);
 
     snapshot_shm::SnapshotSymbolDef symbol{};
-    std::strncpy(symbol.symbol, "XSHE_000001", snapshot_shm::kSnapshotSymbolBytes - 1);
+    std::strncpy(symbol.symbol, symbol_name, snapshot_shm::kSnapshotSymbolBytes - 1);
     assert(snapshot_shm_writer_init(writer.get(), snapshot_path.c_str(), 20260225, &symbol, 1) == 1);
     return writer;
 }
@@ -143,6 +144,141 @@ TEST(reads_carried_prediction_without_fresh_flag) {
     assert(snapshot_shm_writer_unlink(snapshot_path.c_str()) == 1);
 }
 
+TEST(resolved_handle_reads_without_renormalizing_symbol) {
+    ScopedEnvOverride env_override("SHM_USE_FILE", "1");
+    const std::string snapshot_path = unique_snapshot_path("acct_market_data_handle");
+    snapshot_writer_ptr writer = make_writer(snapshot_path);
+
+    const snapshot_shm::LobSnapshot snapshot = make_snapshot();
+    assert(snapshot_shm_writer_publish_with_state(
+               writer.get(), 0, &snapshot, 0.75F, snapshot_shm::kSnapshotSlotFlagHasSignal,
+               static_cast<uint8_t>(snapshot_shm::SnapshotPredictionState::kCarried)) == 1);
+
+    acct_service::MarketDataConfig config{};
+    config.enabled = true;
+    config.snapshot_shm_name = snapshot_path;
+
+    acct_service::MarketDataService service(config);
+    // 句柄可在 reader 打开前解析，别名证券键归到同一槽位
+    const acct_service::MarketDataHandle handle = service.resolve("XSHE_000001");
+    assert(handle.is_valid());
+    assert(service.resolve("SZ.000001").slot == handle.slot);
+    assert(!service.resolve("not_a_security").is_valid());
+
+    acct_service::MarketDataView view{};
+    assert(!service.read(handle, view));
+    assert(service.initialize());
+    for (int i = 0; i < 3; ++i) {
+        assert(service.read(handle, view));
+        assert(view.symbol == "XSHE_000001");
+        assert(view.snapshot.bids[0].price == 1000);
+        assert(view.prediction.signal == 0.75F);
+    }
+    assert(!service.read(acct_service::MarketDataHandle{}, view));
+
+    // 批量读取：无效句柄位置置空；节拍缓存同一纪元内每个槽位只读一次
+    acct_service::MarketDataView batch_views[2]{};
+    const acct_service::MarketDataHandle batch_handles[2] = {handle, acct_service::MarketDataHandle{}};
+    acct_service::MarketDataView* batch_out[2] = {&batch_views[0], &batch_views[1]};
+    assert(service.read_many(batch_handles, batch_out) == 1);
+    assert(batch_out[0] == &batch_views[0] && batch_out[1] == nullptr);
+    assert(batch_views[0].snapshot.asks[0].price == 1001);
+
+    acct_service::MarketDataTickCache cache(&service);
+    const uint64_t reads_before = service.snapshot_reads();
+    cache.prefetch(batch_handles);
+    const acct_service::MarketDataView* shared = cache.read(handle);
+    assert(shared != nullptr && shared == cache.read(handle));
+    assert(cache.read(acct_service::MarketDataHandle{}) == nullptr);
+    assert(service.snapshot_reads() == reads_before + 1);
+    cache.begin_tick();
+    assert(cache.read(handle) == shared);
+    assert(service.snapshot_reads() == reads_before + 2);
+
+    // 只有被观察且序号前进的槽位出现在批量结果中
+    std::vector<acct_service::MarketDataHandle> advanced;
+    assert(service.poll_updates(advanced) == 0);
+    service.watch(handle);
+    assert(service.poll_updates(advanced) == 1);
+    assert(advanced.front().slot == handle.slot);
+    advanced.clear();
+    assert(service.poll_updates(advanced) == 0);
+    assert(snapshot_shm_writer_publish_with_state(
+               writer.get(), 0, &snapshot, 0.75F, snapshot_shm::kSnapshotSlotFlagHasSignal,
+               static_cast<uint8_t>(snapshot_shm::SnapshotPredictionState::kCarried)) == 1);
+    assert(service.poll_updates(advanced) == 1);
+    service.unwatch(handle);
+    assert(snapshot_shm_writer_publish_with_state(
+               writer.get(), 0, &snapshot, 0.75F, snapshot_shm::kSnapshotSlotFlagHasSignal,
+               static_cast<uint8_t>(snapshot_shm::SnapshotPredictionState::kCarried)) == 1);
+    advanced.clear();
+    assert(service.poll_updates(advanced) == 0);
+
+    service.close();
+    assert(snapshot_shm_writer_unlink(snapshot_path.c_str()) == 1);
+}
+
+TEST(routes_handles_to_venue_readers) {
+    ScopedEnvOverride env_override("SHM_USE_FILE", "1");
+    const std::string sh_path = unique_snapshot_path("acct_market_data_venue_sh");
+    const std::string sz_path = unique_snapshot_path("acct_market_data_venue_sz");
+    snapshot_writer_ptr sh_writer = make_writer(sh_path, "XSHG_600000");
+    snapshot_writer_ptr sz_writer = make_writer(sz_path, "XSHE_000001");
+
+    snapshot_shm::LobSnapshot sh_snapshot = make_snapshot();
+    sh_snapshot.bids[0].price = 2000;
+    assert(snapshot_shm_writer_publish_with_state(
+               sh_writer.get(), 0, &sh_snapshot, 0.5F, snapshot_shm::kSnapshotSlotFlagHasSignal,
+               static_cast<uint8_t>(snapshot_shm::SnapshotPredictionState::kCarried)) == 1);
+    const snapshot_shm::LobSnapshot sz_snapshot = make_snapshot();
+    assert(snapshot_shm_writer_publish_with_state(
+               sz_writer.get(), 0, &sz_snapshot, 0.25F, snapshot_shm::kSnapshotSlotFlagHasSignal,
+               static_cast<uint8_t>(snapshot_shm::SnapshotPredictionState::kCarried)) == 1);
+
+    // 沪市显式指向默认源，与默认源同名只打开一次
+    acct_service::MarketDataConfig config{};
+    config.enabled = true;
+    config.snapshot_shm_name = sh_path;
+    config.sz_snapshot_shm_name = sz_path;
+    config.sh_snapshot_shm_name = sh_path;
+
+    acct_service::MarketDataService service(config);
+    assert(service.reader_count() == 2);
+    const acct_service::MarketDataHandle sh_handle = service.resolve("SH.600000");
+    const acct_service::MarketDataHandle sz_handle = service.resolve("XSHE_000001");
+    assert(sh_handle.is_valid() && sz_handle.is_valid() && sh_handle.slot != sz_handle.slot);
+    assert(service.initialize());
+
+    acct_service::MarketDataView view{};
+    assert(service.read(sh_handle, view));
+    assert(view.symbol == "XSHG_600000");
+    assert(view.snapshot.bids[0].price == 2000);
+    assert(service.read(sz_handle, view));
+    assert(view.symbol == "XSHE_000001");
+    assert(view.snapshot.bids[0].price == 1000);
+    assert(service.read("XSHE_000001", view) && view.prediction.signal == 0.25F);
+    assert(service.read("XSHG_600000", view) && view.prediction.signal == 0.5F);
+    // 默认源之外的市场回落到默认源，本例中默认源没有北交所合约
+    assert(!service.read("BJ.430047", view));
+    assert(service.list_symbols().size() == 2);
+
+    // 只有所属市场的源发布新快照时，对应句柄才前进
+    std::vector<acct_service::MarketDataHandle> advanced;
+    service.watch(sh_handle);
+    service.watch(sz_handle);
+    assert(service.poll_updates(advanced) == 2);
+    advanced.clear();
+    assert(snapshot_shm_writer_publish_with_state(
+               sz_writer.get(), 0, &sz_snapshot, 0.25F, snapshot_shm::kSnapshotSlotFlagHasSignal,
+               static_cast<uint8_t>(snapshot_shm::SnapshotPredictionState::kCarried)) == 1);
+    assert(service.poll_updates(advanced) == 1);
+    assert(advanced.front().slot == sz_handle.slot);
+
+    service.close();
+    assert(snapshot_shm_writer_unlink(sh_path.c_str()) == 1);
+    assert(snapshot_shm_writer_unlink(sz_path.c_str()) == 1);
+}
+
 TEST(lists_symbols_from_snapshot_source) {
     ScopedEnvOverride env_override("SHM_USE_FILE", "1");
     const std::string snapshot_path = unique_snapshot_path("acct_market_data_symbols");
@@ -179,13 +315,123 @@ TEST(initialization_succeeds_with_missing_snapshot_when_order_price_fallback_ena
     assert(service.list_symbols().empty());
 }
 
+TEST(replays_recorded_stream_into_snapshot_shm) {
+    const std::string replay_path = unique_snapshot_path("acct_market_data_replay") + ".bin";
+    const std::string snapshot_path = unique_snapshot_path("acct_market_data_replay_out");
+
+    // 两个标的交替录制 6 条，第 2 个标的只带 carried prediction
+    acct_service::MarketDataRecorder recorder;
+    assert(recorder.open(replay_path, 20260225, {"XSHE_000001", "XSHG_600000"}));
+    for (uint32_t i = 0; i < 6; ++i) {
+        acct_service::MarketDataReplayRecord record{};
+        record.offset_ns = static_cast<uint64_t>(i) * 1'000'000ULL;
+        record.symbol_index = i % 2;
+        record.signal = static_cast<float>(i);
+        record.flags = snapshot_shm::kSnapshotSlotFlagHasSignal;
+        record.prediction_state = static_cast<uint8_t>(i % 2 == 0 ? snapshot_shm::SnapshotPredictionState::kFresh
+                                                                   : snapshot_shm::SnapshotPredictionState::kCarried);
+        record.snapshot = make_snapshot();
+        record.snapshot.bids[0].price = 1000 + i;
+        assert(recorder.append(record));
+    }
+    acct_service::MarketDataReplayRecord stale{};
+    stale.offset_ns = 0;
+    assert(!recorder.append(stale));
+    stale.offset_ns = 10'000'000ULL;
+    stale.symbol_index = 2;
+    assert(!recorder.append(stale));
+    assert(recorder.close());
+
+    acct_service::MarketDataReplayFile file;
+    assert(file.open(replay_path));
+    assert(file.record_count() == 6);
+    assert(file.header().trading_day == 20260225);
+    assert(file.duration_ns() == 5'000'000ULL);
+
+    acct_service::MarketDataReplayer replayer(file);
+    assert(replayer.open_output(snapshot_path));
+
+    acct_service::MarketDataConfig config{};
+    config.enabled = true;
+    config.snapshot_shm_name = snapshot_path;
+    acct_service::MarketDataService service(config);
+    assert(service.initialize());
+    assert(service.list_symbols().size() == 2);
+    const acct_service::MarketDataHandle handle = service.resolve("XSHG_600000");
+    acct_service::MarketDataView view{};
+    assert(!service.read(handle, view));
+
+    // 只发布录制时刻不晚于目标时刻的记录；100 倍速下墙钟 25us 对应录制时刻 2.5ms
+    assert(acct_service::market_data_replay_offset(25'000, 100.0) == 2'500'000ULL);
+    assert(replayer.publish_until(acct_service::market_data_replay_offset(25'000, 100.0)) == 3);
+    assert(replayer.next_offset_ns() == 3'000'000ULL);
+    assert(service.read(handle, view));
+    assert(view.snapshot.bids[0].price == 1001);
+    assert(!view.prediction.has_fresh_prediction());
+    assert(service.read("XSHE_000001", view));
+    assert(view.snapshot.bids[0].price == 1002);
+    assert(view.prediction.has_fresh_prediction());
+    assert(view.prediction.signal == 2.0F);
+
+    assert(replayer.publish_next(2) == 2);
+    assert(replayer.publish_until(UINT64_MAX) == 1);
+    assert(replayer.done());
+    assert(replayer.published() == 6);
+    assert(service.read(handle, view));
+    assert(view.snapshot.bids[0].price == 1005);
+
+    // 循环回放从头开始，slot 序号继续前进
+    const uint64_t seq_before_rewind = view.seq;
+    replayer.rewind();
+    assert(replayer.publish_next(2) == 2);
+    assert(service.read(handle, view));
+    assert(view.snapshot.bids[0].price == 1001);
+    assert(view.seq > seq_before_rewind);
+
+    service.close();
+    replayer.close_output(true);
+    file.close();
+    (void)::unlink(replay_path.c_str());
+}
+
+TEST(rejects_unfinished_or_foreign_replay_file) {
+    const std::string replay_path = unique_snapshot_path("acct_market_data_replay_bad") + ".bin";
+    acct_service::MarketDataReplayFile file;
+    assert(!file.open(replay_path));
+
+    // 非回放格式的文件（这里用 snapshot 文件）被拒绝
+    snapshot_writer_ptr writer = make_writer(replay_path);
+    assert(!file.open(replay_path));
+    writer.reset();
+
+    // 录制端未 close 时记录数仍为 0，回放端视为空文件
+    acct_service::MarketDataRecorder recorder;
+    assert(recorder.open(replay_path, 20260225, {"XSHE_000001"}));
+    acct_service::MarketDataReplayRecord record{};
+    assert(recorder.append(record));
+    std::fflush(nullptr);
+    assert(file.open(replay_path));
+    assert(file.record_count() == 0);
+    file.close();
+    assert(recorder.close());
+    assert(file.open(replay_path));
+    assert(file.record_count() == 1);
+    file.close();
+    assert(!recorder.open(replay_path, 20260225, {}));
+    (void)::unlink(replay_path.c_str());
+}
+
 int main() {
     printf("=== Market Data Service Test Suite ===\n\n");
 
     RUN_TEST(reads_fresh_prediction);
     RUN_TEST(reads_carried_prediction_without_fresh_flag);
+    RUN_TEST(resolved_handle_reads_without_renormalizing_symbol);
+    RUN_TEST(routes_handles_to_venue_readers);
     RUN_TEST(lists_symbols_from_snapshot_source);
     RUN_TEST(initialization_succeeds_with_missing_snapshot_when_order_price_fallback_enabled);
+    RUN_TEST(replays_recorded_stream_into_snapshot_shm);
+    RUN_TEST(rejects_unfinished_or_foreign_replay_file);
 
     printf("\n=== All tests passed! ===\n");
     return 0;
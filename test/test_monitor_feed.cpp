@@ -0,0 +1,310 @@
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cassert>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <string>
+
+#include "api/order_api.h"
+#include "monitor_feed.hpp"
+#include "portfolio/position_manager.hpp"
+#include "shm/shm_manager.hpp"
+
+#define TEST(name) static void test_##name()
+#define RUN_TEST(name)                   \
+    do {                                 \
+        printf("Running %s... ", #name); \
+        test_##name();                   \
+        printf("PASSED\n");              \
+    } while (0)
+
+namespace {
+
+using namespace acct_service;
+
+constexpr const char* kTradingDay = "20260225";
+
+std::string unique_name(const char* prefix) {
+    const auto now_ns =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+            .count();
+    return std::string("/") + prefix + "_" + std::to_string(static_cast<unsigned long long>(now_ns));
+}
+
+void cleanup_shm_name(const std::string& name) {
+    if (::shm_unlink(name.c_str()) < 0 && errno != ENOENT) {
+        std::perror("shm_unlink");
+    }
+}
+
+// 订单池、持仓池与发布端：发布端组播到本机抓包口，测试决定哪些帧转给镜像，以此模拟丢帧
+class feed_fixture {
+public:
+    explicit feed_fixture(uint32_t retain_frames) {
+        upstream_name_ = unique_name("acct_monitor_feed_upstream");
+        orders_base_name_ = unique_name("acct_monitor_feed_orders");
+        positions_name_ = unique_name("acct_monitor_feed_positions");
+
+        acct_init_options_t init_options{};
+        init_options.upstream_shm_name = upstream_name_.c_str();
+        init_options.orders_shm_name = orders_base_name_.c_str();
+        init_options.trading_day = kTradingDay;
+        init_options.create_if_not_exist = 1;
+        assert(acct_init_ex(&init_options, &order_ctx_) == ACCT_OK);
+
+        positions_shm_layout* positions_shm = writer_manager_.open_positions(positions_name_, shm_mode::Create, 1001);
+        assert(positions_shm != nullptr);
+        positions_ = std::make_unique<PositionManager>(positions_shm);
+        assert(positions_->initialize(1001));
+        security_ = positions_->add_security("000001", "PingAn", Market::SZ);
+        assert(!security_.empty());
+
+        acct_orders_mon_options_t orders_options{};
+        orders_options.orders_shm_name = orders_base_name_.c_str();
+        orders_options.trading_day = kTradingDay;
+        assert(acct_orders_mon_open(&orders_options, &orders_mon_) == ACCT_MON_OK);
+        acct_positions_mon_options_t positions_options{};
+        positions_options.positions_shm_name = positions_name_.c_str();
+        assert(acct_positions_mon_open(&positions_options, &positions_mon_) == ACCT_POS_MON_OK);
+
+        capture_fd_ = ::socket(AF_INET, SOCK_DGRAM, 0);
+        assert(capture_fd_ >= 0);
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        socklen_t addr_len = sizeof(addr);
+        assert(::bind(capture_fd_, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) == 0);
+        assert(::getsockname(capture_fd_, reinterpret_cast<sockaddr*>(&addr), &addr_len) == 0);
+
+        monitor_feed_publisher_options options;
+        options.group = "127.0.0.1";
+        options.port = ntohs(addr.sin_port);
+        options.fill_bind_address = "127.0.0.1";
+        options.fill_port = 0;
+        options.retain_frames = retain_frames;
+        options.heartbeat_ms = 20;
+        options.poll_interval_us = 100;
+        std::string error;
+        assert(publisher_.start(orders_mon_, positions_mon_, options, &error));
+    }
+
+    ~feed_fixture() {
+        publisher_.stop();
+        ::close(capture_fd_);
+        assert(acct_positions_mon_close(positions_mon_) == ACCT_POS_MON_OK);
+        assert(acct_orders_mon_close(orders_mon_) == ACCT_MON_OK);
+        assert(acct_destroy(order_ctx_) == ACCT_OK);
+        positions_.reset();
+        writer_manager_.close();
+        (void)SHMManager::unlink(positions_name_);
+        cleanup_shm_name(upstream_name_);
+        cleanup_shm_name(orders_base_name_ + "_" + kTradingDay);
+    }
+
+    // 镜像只经 apply_datagram 喂帧，自身组播口不收数据
+    monitor_feed_mirror_options mirror_options() const {
+        monitor_feed_mirror_options options;
+        options.group = "127.0.0.1";
+        options.port = 0;
+        options.publisher_host = "127.0.0.1";
+        options.fill_port = publisher_.fill_port();
+        return options;
+    }
+
+    void submit(uint32_t volume) {
+        uint32_t order_id = 0;
+        assert(acct_submit_order(order_ctx_, "000001", ACCT_SIDE_BUY, ACCT_MARKET_SZ, volume, 10.5, 0, &order_id) ==
+               ACCT_OK);
+    }
+
+    void add_position(uint64_t volume) { assert(positions_->add_position(security_, volume, 1000, 1)); }
+
+    // 收取抓包口的帧直到 done() 成立或超时；drop 返回 true 的帧不转给镜像
+    bool pump(monitor_feed_mirror& mirror, const std::function<bool()>& done,
+              const std::function<bool(const monitor_feed_frame_header&)>& drop = nullptr) {
+        unsigned char datagram[kMonitorFeedMaxFrameBytes];
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(3);
+        while (!done()) {
+            if (std::chrono::steady_clock::now() > deadline) {
+                return false;
+            }
+            pollfd pfd{capture_fd_, POLLIN, 0};
+            if (::poll(&pfd, 1, 10) <= 0) {
+                continue;
+            }
+            const ssize_t received = ::recv(capture_fd_, datagram, sizeof(datagram), 0);
+            assert(received >= static_cast<ssize_t>(sizeof(monitor_feed_frame_header)));
+            monitor_feed_frame_header header;
+            std::memcpy(&header, datagram, sizeof(header));
+            if (drop && drop(header)) {
+                continue;
+            }
+            std::string error;
+            assert(mirror.apply_datagram(datagram, static_cast<std::size_t>(received), &error));
+        }
+        return true;
+    }
+
+    // 从发布端订单池逐条核对镜像；预留未用的 Empty 槽位不发布
+    bool mirror_matches(const monitor_feed_mirror& mirror) const {
+        acct_orders_mon_info_t info{};
+        assert(acct_orders_mon_info(orders_mon_, &info) == ACCT_MON_OK);
+        std::size_t published = 0;
+        for (uint32_t index = 0; index < info.next_index; ++index) {
+            acct_orders_mon_snapshot_t expected{};
+            acct_orders_mon_snapshot_t mirrored{};
+            if (acct_orders_mon_read(orders_mon_, index, &expected) != ACCT_MON_OK) {
+                return false;
+            }
+            if (expected.stage == ACCT_MON_STAGE_EMPTY) {
+                continue;
+            }
+            ++published;
+            if (!mirror.read_order(index, &mirrored) || mirrored.seq != expected.seq ||
+                mirrored.volume_entrust != expected.volume_entrust || mirrored.stage != expected.stage ||
+                std::strncmp(mirrored.security_id, expected.security_id, ACCT_MON_SECURITY_ID_LEN) != 0) {
+                return false;
+            }
+        }
+        return published == mirror.order_count();
+    }
+
+    const monitor_feed_publisher& publisher() const { return publisher_; }
+
+private:
+    std::string upstream_name_;
+    std::string orders_base_name_;
+    std::string positions_name_;
+    acct_ctx_t order_ctx_ = nullptr;
+    SHMManager writer_manager_;
+    std::unique_ptr<PositionManager> positions_;
+    InternalSecurityId security_;
+    acct_orders_mon_ctx_t orders_mon_ = nullptr;
+    acct_positions_mon_ctx_t positions_mon_ = nullptr;
+    int capture_fd_ = -1;
+    monitor_feed_publisher publisher_;
+};
+
+bool is_delta(const monitor_feed_frame_header& header) {
+    return header.type == static_cast<uint16_t>(monitor_feed_frame_type::Delta);
+}
+
+}  // namespace
+
+TEST(mirror_snapshot_then_deltas) {
+    feed_fixture fixture(1024);
+    for (uint32_t i = 0; i < 5; ++i) {
+        fixture.submit(100 * (i + 1));
+    }
+    fixture.add_position(300);
+
+    // 启动即经补发拿全量快照
+    monitor_feed_mirror mirror;
+    std::string error;
+    assert(mirror.start(fixture.mirror_options(), &error));
+    assert(mirror.stats().snapshots == 1);
+    assert(mirror.trading_day() == 20260225);
+    assert(mirror.order_count() == 5);
+    assert(fixture.mirror_matches(mirror));
+    acct_positions_mon_fund_snapshot_t fund{};
+    assert(mirror.read_fund(&fund));
+    assert(std::strncmp(fund.id, "FUND", 4) == 0);
+    acct_positions_mon_position_snapshot_t position{};
+    assert(mirror.read_position(0, &position));
+    assert(position.volume_buy_traded == 300);
+
+    // 之后只靠组播增量：新订单与持仓变化都能追上
+    for (uint32_t i = 0; i < 20; ++i) {
+        fixture.submit(1000 + i);
+    }
+    fixture.add_position(200);
+    assert(fixture.pump(mirror, [&]() {
+        acct_positions_mon_position_snapshot_t latest{};
+        return fixture.mirror_matches(mirror) && mirror.read_position(0, &latest) && latest.volume_buy_traded == 500;
+    }));
+    assert(mirror.order_count() == 25);
+    assert(mirror.stats().frames > 0);
+    assert(mirror.stats().gaps == 0);
+    assert(mirror.stats().fills == 0);
+    assert(mirror.applied_seq() > 0);
+
+    // 非本协议的帧只计数
+    const char garbage[64] = "not a monitor feed frame";
+    assert(mirror.apply_datagram(garbage, sizeof(garbage), &error));
+    assert(mirror.stats().malformed == 1);
+    assert(fixture.publisher().stats().snapshots_served == 1);
+}
+
+TEST(mirror_fills_dropped_frames) {
+    feed_fixture fixture(1024);
+    monitor_feed_mirror mirror;
+    std::string error;
+    assert(mirror.start(fixture.mirror_options(), &error));
+    assert(mirror.order_count() == 0);
+
+    // 丢掉第一帧增量，后续帧或心跳暴露缺口后按序号补发
+    fixture.submit(100);
+    bool dropped = false;
+    assert(fixture.pump(
+        mirror, [&]() { return dropped; },
+        [&](const monitor_feed_frame_header& header) {
+            if (!dropped && is_delta(header)) {
+                dropped = true;
+                return true;
+            }
+            return false;
+        }));
+    assert(mirror.order_count() == 0);
+    fixture.submit(200);
+    assert(fixture.pump(mirror, [&]() { return fixture.mirror_matches(mirror) && mirror.order_count() == 2; }));
+    assert(mirror.stats().gaps >= 1);
+    assert(mirror.stats().fills >= 1);
+    assert(mirror.stats().snapshots == 1);
+    assert(fixture.publisher().stats().fills_served >= 1);
+}
+
+TEST(mirror_falls_back_to_snapshot_when_retention_overrun) {
+    // 补发环只留 1 帧：丢 2 帧后序号补发已不可能，改发全量快照
+    feed_fixture fixture(1);
+    monitor_feed_mirror mirror;
+    std::string error;
+    assert(mirror.start(fixture.mirror_options(), &error));
+
+    // 丢够 2 帧增量之前心跳也不转发，避免提前补发
+    uint32_t dropped = 0;
+    const auto drop_two = [&](const monitor_feed_frame_header& header) {
+        if (dropped >= 2) {
+            return false;
+        }
+        dropped += is_delta(header) ? 1 : 0;
+        return true;
+    };
+    fixture.submit(100);
+    assert(fixture.pump(mirror, [&]() { return dropped >= 1; }, drop_two));
+    fixture.submit(200);
+    assert(fixture.pump(mirror, [&]() { return dropped >= 2; }, drop_two));
+    fixture.submit(300);
+    assert(fixture.pump(mirror, [&]() { return fixture.mirror_matches(mirror) && mirror.order_count() == 3; }));
+    assert(mirror.stats().snapshots == 2);
+    assert(fixture.publisher().stats().snapshots_served == 2);
+}
+
+int main() {
+    printf("=== Monitor Feed Test Suite ===\n\n");
+
+    RUN_TEST(mirror_snapshot_then_deltas);
+    RUN_TEST(mirror_fills_dropped_frames);
+    RUN_TEST(mirror_falls_back_to_snapshot_when_retention_overrun);
+
+    printf("\n=== All tests passed! ===\n");
+    return 0;
+}
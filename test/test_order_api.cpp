@@ -1,17 +1,21 @@
 #include <cassert>
 #include <cerrno>
+#include <chrono>
 #include <cstdio>
 #include <cstring>
 #include <string>
 #include <string_view>
-#include <string>
-#include <string_view>
+#include <thread>
 
 #include <sys/mman.h>
 
 #include "api/order_api.h"
 #include "common/constants.hpp"
+#include "common/security_identity.hpp"
 #include "shm/orders_shm.hpp"
+#include "shm/risk_params_shm.hpp"
+#include "shm/shm_manager.hpp"
+#include "shm/upstream_lanes.hpp"
 
 #define TEST(name) static void test_##name()
 #define RUN_TEST(name)                   \
@@ -52,6 +56,7 @@ TEST(strerror) {
     assert(strcmp(acct_strerror(ACCT_ERR_ORDER_NOT_FOUND), "Order not found") == 0);
     assert(strcmp(acct_strerror(ACCT_ERR_CACHE_FULL), "Order cache is full") == 0);
     assert(strcmp(acct_strerror(ACCT_ERR_ORDER_POOL_FULL), "Order pool is full") == 0);
+    assert(strcmp(acct_strerror(ACCT_ERR_RISK_REJECTED), "Rejected by local pre-trade check") == 0);
     assert(strcmp(acct_strerror(ACCT_ERR_INTERNAL), "Internal error") == 0);
 }
 
@@ -76,6 +81,8 @@ TEST(null_ctx_operations) {
     size_t queue_size = 0;
     err = acct_queue_size(nullptr, &queue_size);
     assert(err == ACCT_ERR_INVALID_PARAM);
+    assert(acct_available_credits(nullptr, &queue_size) == ACCT_ERR_INVALID_PARAM);
+    assert(acct_wait_credits(nullptr, 1, 0, nullptr) == ACCT_ERR_INVALID_PARAM);
 
     // destroy NULL 应该返回错误码
     err = acct_destroy(nullptr);
@@ -119,6 +126,465 @@ TEST(init_ex_with_custom_options) {
     cleanup_order_api_shm("20260225");
 }
 
+TEST(submit_orders_reports_per_element) {
+    cleanup_order_api_shm("20260302");
+
+    acct_ctx_t ctx = nullptr;
+    acct_init_options_t opts{};
+    opts.trading_day = "20260302";
+    opts.create_if_not_exist = 1;
+    assert(acct_init_ex(&opts, &ctx) == ACCT_OK);
+
+    // 第 2 条数量为 0：单条失败不影响其余条目，合法条目获得连续订单ID并一次入队
+    acct_order_spec_t specs[4]{};
+    const char* codes[4] = {"000001", "000002", "600000", "600036"};
+    for (int i = 0; i < 4; ++i) {
+        specs[i].security_id = codes[i];
+        specs[i].volume = 100;
+        specs[i].price = 10.5;
+        specs[i].side = ACCT_SIDE_BUY;
+        specs[i].market = i < 2 ? ACCT_MARKET_SZ : ACCT_MARKET_SH;
+    }
+    specs[1].volume = 0;
+
+    uint32_t ids[4] = {};
+    acct_error_t results[4] = {};
+    assert(acct_submit_orders(ctx, specs, 4, ids, results) == ACCT_ERR_INVALID_PARAM);
+    assert(results[0] == ACCT_OK && results[2] == ACCT_OK && results[3] == ACCT_OK);
+    assert(results[1] == ACCT_ERR_INVALID_PARAM);
+    assert(ids[1] == 0);
+    assert(ids[0] != 0 && ids[2] == ids[0] + 1 && ids[3] == ids[0] + 2);
+
+    size_t queue_size = 0;
+    assert(acct_queue_size(ctx, &queue_size) == ACCT_OK);
+    assert(queue_size == 3);
+
+    // 全部合法时返回 ACCT_OK；空篮子直接成功
+    specs[1].volume = 200;
+    assert(acct_submit_orders(ctx, specs, 4, ids, results) == ACCT_OK);
+    assert(acct_queue_size(ctx, &queue_size) == ACCT_OK);
+    assert(queue_size == 7);
+    assert(acct_submit_orders(ctx, nullptr, 0, nullptr, nullptr) == ACCT_OK);
+    assert(acct_submit_orders(ctx, specs, 4, ids, nullptr) == ACCT_ERR_INVALID_PARAM);
+
+    assert(acct_destroy(ctx) == ACCT_OK);
+    cleanup_order_api_shm("20260302");
+}
+
+TEST(submit_basket_all_or_nothing) {
+    cleanup_order_api_shm("20260303");
+
+    acct_ctx_t ctx = nullptr;
+    acct_init_options_t opts{};
+    opts.trading_day = "20260303";
+    opts.create_if_not_exist = 1;
+    assert(acct_init_ex(&opts, &ctx) == ACCT_OK);
+
+    acct_order_spec_t specs[4]{};
+    for (int i = 0; i < 4; ++i) {
+        specs[i].security_id = "000001";
+        specs[i].volume = 100;
+        specs[i].price = 10.5;
+        specs[i].side = ACCT_SIDE_BUY;
+        specs[i].market = ACCT_MARKET_SZ;
+    }
+    specs[2].volume = 0;
+
+    // 任一条目非法时整篮不提交，其余合法条目记 BASKET_ABORTED
+    uint32_t ids[4] = {};
+    acct_error_t results[4] = {};
+    assert(acct_submit_basket(ctx, specs, 4, ACCT_BASKET_ALL_OR_NOTHING, ids, results) == ACCT_ERR_INVALID_PARAM);
+    assert(results[2] == ACCT_ERR_INVALID_PARAM);
+    assert(results[0] == ACCT_ERR_BASKET_ABORTED && results[1] == ACCT_ERR_BASKET_ABORTED &&
+           results[3] == ACCT_ERR_BASKET_ABORTED);
+    size_t queue_size = 0;
+    assert(acct_queue_size(ctx, &queue_size) == ACCT_OK);
+    assert(queue_size == 0);
+
+    specs[2].volume = 100;
+    assert(acct_submit_basket(ctx, specs, 4, ACCT_BASKET_ALL_OR_NOTHING, ids, results) == ACCT_OK);
+    assert(ids[1] == ids[0] + 1 && ids[3] == ids[0] + 3);
+    assert(acct_queue_size(ctx, &queue_size) == ACCT_OK);
+    assert(queue_size == 4);
+    assert(acct_submit_basket(ctx, specs, 4, 0x80, ids, results) == ACCT_ERR_INVALID_PARAM);
+
+    assert(acct_destroy(ctx) == ACCT_OK);
+    cleanup_order_api_shm("20260303");
+}
+
+TEST(follows_orders_rollover_to_successor_pool) {
+    cleanup_order_api_shm("20260303");
+    cleanup_order_api_shm("20260304");
+
+    acct_ctx_t ctx = nullptr;
+    acct_init_options_t opts{};
+    opts.trading_day = "20260303";
+    opts.create_if_not_exist = 1;
+    assert(acct_init_ex(&opts, &ctx) == ACCT_OK);
+
+    uint32_t cached_id = 0;
+    assert(acct_new_order(ctx, "000001", ACCT_SIDE_BUY, ACCT_MARKET_SZ, 100, 10.5, 93000000, &cached_id) == ACCT_OK);
+
+    // 模拟账户服务换日：后继池已建好，旧池发布后继交易日
+    acct_service::SHMManager upstream_manager;
+    acct_service::SHMManager old_manager;
+    acct_service::SHMManager next_manager;
+    acct_service::upstream_shm_layout* upstream =
+        upstream_manager.open_upstream(acct_service::kUpstreamOrderShmName, acct_service::shm_mode::Open, 0);
+    acct_service::orders_shm_layout* old_pool = old_manager.open_orders(
+        acct_service::make_orders_shm_name(acct_service::kOrdersShmName, "20260303"), acct_service::shm_mode::Open, 0,
+        0);
+    acct_service::orders_shm_layout* next_pool = next_manager.open_orders(
+        acct_service::make_orders_shm_name(acct_service::kOrdersShmName, "20260304"),
+        acct_service::shm_mode::OpenOrCreate, 0, 1024);
+    assert(upstream && old_pool && next_pool);
+    acct_service::orders_shm_link_successor(old_pool, next_pool);
+
+    // 上一交易日缓存的订单随旧池丢弃
+    assert(acct_send_order(ctx, cached_id) == ACCT_ERR_ORDER_NOT_FOUND);
+
+    // 两条队列各先推一个换日标记，新单写入后继池
+    uint32_t order_id = 0;
+    assert(acct_submit_order(ctx, "000001", ACCT_SIDE_BUY, ACCT_MARKET_SZ, 100, 10.5, 93000000, &order_id) ==
+           ACCT_OK);
+    acct_service::OrderIndex index = acct_service::kInvalidOrderIndex;
+    assert(upstream->lane(0).try_pop(index) && index == acct_service::kOrdersRolloverMarker);
+    assert(upstream->lane(0).try_pop(index) && index == acct_service::order_id_slot_index(order_id));
+    assert(upstream->cancel_lane(0).try_pop(index) && index == acct_service::kOrdersRolloverMarker);
+    acct_service::order_slot_snapshot snapshot;
+    assert(acct_service::orders_shm_read_snapshot(next_pool, acct_service::order_id_slot_index(order_id), snapshot));
+    assert(snapshot.request.internal_order_id == order_id);
+
+    // 跟随只发生一次，之后不再推标记
+    assert(acct_submit_order(ctx, "000001", ACCT_SIDE_BUY, ACCT_MARKET_SZ, 100, 10.5, 93000000, &order_id) ==
+           ACCT_OK);
+    assert(upstream->lane(0).try_pop(index) && index == acct_service::order_id_slot_index(order_id));
+    assert(upstream->cancel_lane(0).empty());
+
+    assert(acct_destroy(ctx) == ACCT_OK);
+    cleanup_order_api_shm("20260303");
+    cleanup_order_api_shm("20260304");
+}
+
+TEST(credits_gate_submission_and_wake_waiter) {
+    cleanup_order_api_shm("20260305");
+
+    acct_ctx_t ctx = nullptr;
+    acct_init_options_t opts{};
+    opts.trading_day = "20260305";
+    opts.create_if_not_exist = 1;
+    assert(acct_init_ex(&opts, &ctx) == ACCT_OK);
+
+    acct_service::SHMManager upstream_manager;
+    acct_service::upstream_shm_layout* upstream =
+        upstream_manager.open_upstream(acct_service::kUpstreamOrderShmName, acct_service::shm_mode::Open, 0);
+    assert(upstream);
+    auto& queue = upstream->lane(0);
+
+    size_t credits = 0;
+    assert(acct_available_credits(ctx, &credits) == ACCT_OK);
+    assert(credits == queue.capacity());
+    uint32_t first_id = 0;
+    assert(acct_submit_order(ctx, "000001", ACCT_SIDE_BUY, ACCT_MARKET_SZ, 100, 10.5, 0, &first_id) == ACCT_OK);
+    assert(acct_available_credits(ctx, &credits) == ACCT_OK);
+    assert(credits == queue.capacity() - 1);
+
+    // 填满队列：额度为 0 时下单直接失败，不占槽位
+    while (queue.try_push(0)) {
+    }
+    assert(acct_available_credits(ctx, &credits) == ACCT_OK);
+    assert(credits == 0);
+    uint32_t order_id = 0;
+    assert(acct_submit_order(ctx, "000001", ACCT_SIDE_BUY, ACCT_MARKET_SZ, 100, 10.5, 0, &order_id) ==
+           ACCT_ERR_QUEUE_FULL);
+    assert(order_id == 0);
+    assert(acct_wait_credits(ctx, 1, 0, &credits) == ACCT_ERR_QUEUE_FULL);
+    assert(credits == 0);
+    assert(acct_wait_credits(ctx, 0, 0, nullptr) == ACCT_ERR_INVALID_PARAM);
+    assert(acct_wait_credits(ctx, queue.capacity() + 1, 0, nullptr) == ACCT_ERR_INVALID_PARAM);
+
+    // 模拟账户服务消费后敲额度门铃：等待方在超时前被唤醒
+    std::thread consumer([&]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        acct_service::OrderIndex index = 0;
+        for (int i = 0; i < 10; ++i) {
+            assert(queue.try_pop(index));
+        }
+        acct_service::doorbell_ring(&upstream->lane_table.credit_doorbell);
+    });
+    const auto started = std::chrono::steady_clock::now();
+    assert(acct_wait_credits(ctx, 10, 5'000'000, &credits) == ACCT_OK);
+    assert(credits >= 10);
+    assert(std::chrono::steady_clock::now() - started < std::chrono::seconds(2));
+    consumer.join();
+
+    // 失败的那次下单没有消耗槽位：下一笔紧接首笔的槽位
+    assert(acct_submit_order(ctx, "000001", ACCT_SIDE_BUY, ACCT_MARKET_SZ, 100, 10.5, 0, &order_id) == ACCT_OK);
+    assert(acct_service::order_id_slot_index(order_id) == acct_service::order_id_slot_index(first_id) + 1);
+
+    assert(acct_destroy(ctx) == ACCT_OK);
+    cleanup_order_api_shm("20260305");
+}
+
+TEST(thread_contexts_own_lanes_and_index_blocks) {
+    cleanup_order_api_shm("20260306");
+
+    // 账户服务先建段并启用多 lane
+    acct_service::SHMManager upstream_manager;
+    acct_service::upstream_shm_layout* upstream =
+        upstream_manager.open_upstream(acct_service::kUpstreamOrderShmName, acct_service::shm_mode::OpenOrCreate, 0);
+    assert(upstream);
+    acct_service::upstream_set_lane_count(upstream, 4);
+
+    acct_ctx_t ctx = nullptr;
+    acct_init_options_t opts{};
+    opts.trading_day = "20260306";
+    opts.create_if_not_exist = 1;
+    assert(acct_init_ex(&opts, &ctx) == ACCT_OK);
+    uint32_t parent_lane = 0;
+    assert(acct_upstream_lane(ctx, &parent_lane) == ACCT_OK);
+
+    constexpr int kThreads = 3;
+    constexpr int kOrdersPerThread = 50;
+    acct_ctx_t thread_ctxs[kThreads] = {};
+    uint32_t lanes[kThreads] = {};
+    uint32_t first_ids[kThreads] = {};
+    std::thread workers[kThreads];
+    for (int t = 0; t < kThreads; ++t) {
+        workers[t] = std::thread([&, t]() {
+            assert(acct_ctx_thread_attach(ctx, &thread_ctxs[t]) == ACCT_OK);
+            assert(acct_upstream_lane(thread_ctxs[t], &lanes[t]) == ACCT_OK);
+            for (int i = 0; i < kOrdersPerThread; ++i) {
+                uint32_t order_id = 0;
+                assert(acct_submit_order(thread_ctxs[t], "000001", ACCT_SIDE_BUY, ACCT_MARKET_SZ, 100, 10.5, 0,
+                                         &order_id) == ACCT_OK);
+                if (i == 0) {
+                    first_ids[t] = order_id;
+                }
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    // 每个线程独占一条 lane，且与进程上下文的 lane 不同；下单按各自的下标块连续分配
+    for (int t = 0; t < kThreads; ++t) {
+        assert(lanes[t] != parent_lane);
+        for (int u = t + 1; u < kThreads; ++u) {
+            assert(lanes[t] != lanes[u]);
+        }
+        assert(upstream->lane(lanes[t]).size() == kOrdersPerThread);
+        acct_service::OrderIndex index = acct_service::kInvalidOrderIndex;
+        assert(upstream->lane(lanes[t]).try_pop(index));
+        assert(index == acct_service::order_id_slot_index(first_ids[t]));
+    }
+
+    // lane 用尽、单 lane 派生与嵌套派生都被拒绝；线程上下文未销毁时进程上下文不能销毁
+    acct_ctx_t extra = nullptr;
+    assert(acct_ctx_thread_attach(ctx, &extra) == ACCT_ERR_NO_FREE_LANE);
+    assert(extra == nullptr);
+    assert(acct_ctx_thread_attach(thread_ctxs[0], &extra) == ACCT_ERR_INVALID_PARAM);
+    assert(acct_ctx_thread_attach(ctx, nullptr) == ACCT_ERR_INVALID_PARAM);
+    assert(acct_destroy(ctx) == ACCT_ERR_INVALID_PARAM);
+
+    // 销毁线程上下文归还 lane，之后可再次派生
+    assert(acct_destroy(thread_ctxs[0]) == ACCT_OK);
+    assert(acct_ctx_thread_attach(ctx, &extra) == ACCT_OK);
+    uint32_t extra_lane = 0;
+    assert(acct_upstream_lane(extra, &extra_lane) == ACCT_OK);
+    assert(extra_lane == lanes[0]);
+    assert(acct_destroy(extra) == ACCT_OK);
+    for (int t = 1; t < kThreads; ++t) {
+        assert(acct_destroy(thread_ctxs[t]) == ACCT_OK);
+    }
+    assert(acct_destroy(ctx) == ACCT_OK);
+
+    acct_service::upstream_set_lane_count(upstream, 1);
+    upstream_manager.close();
+    cleanup_order_api_shm("20260306");
+}
+
+TEST(poll_order_updates_reads_own_lane) {
+    cleanup_order_api_shm("20260307");
+
+    acct_service::SHMManager upstream_manager;
+    acct_service::upstream_shm_layout* upstream =
+        upstream_manager.open_upstream(acct_service::kUpstreamOrderShmName, acct_service::shm_mode::OpenOrCreate, 0);
+    assert(upstream);
+    // 前一持有者遗留的回报在接入时丢弃
+    acct_service::order_update_message stale{};
+    stale.internal_order_id = 1;
+    assert(acct_service::upstream_publish_order_update(upstream, 0, stale));
+
+    acct_ctx_t ctx = nullptr;
+    acct_init_options_t opts{};
+    opts.trading_day = "20260307";
+    opts.create_if_not_exist = 1;
+    assert(acct_init_ex(&opts, &ctx) == ACCT_OK);
+
+    acct_order_update_t updates[4];
+    size_t count = 99;
+    assert(acct_poll_order_updates(ctx, updates, 4, &count) == ACCT_OK);
+    assert(count == 0);
+
+    // 模拟账户服务写入回报
+    for (uint32_t i = 0; i < 6; ++i) {
+        acct_service::order_update_message message{};
+        message.internal_order_id = 100 + i;
+        message.order_state = acct_service::OrderState::MarketAccepted;
+        message.event = 3;
+        message.order_type = acct_service::OrderType::New;
+        message.volume_traded = 10 * i;
+        message.dvalue_traded = 1000 * i;
+        assert(acct_service::upstream_publish_order_update(upstream, 0, message));
+    }
+    assert(acct_poll_order_updates(ctx, updates, 4, &count) == ACCT_OK);
+    assert(count == 4);
+    assert(updates[0].order_id == 100 && updates[3].order_id == 103);
+    assert(updates[3].volume_traded == 30 && updates[3].dvalue_traded == 3000);
+    assert(updates[0].order_status == 0x52 && updates[0].event == 3 && updates[0].order_type == 1);
+    assert(acct_poll_order_updates(ctx, updates, 4, &count) == ACCT_OK);
+    assert(count == 2 && updates[1].order_id == 105);
+
+    // 环满时新回报被丢弃并计数
+    uint64_t dropped = 1;
+    assert(acct_order_updates_dropped(ctx, &dropped) == ACCT_OK);
+    assert(dropped == 0);
+    acct_service::order_update_message filler{};
+    while (acct_service::upstream_publish_order_update(upstream, 0, filler)) {
+    }
+    assert(acct_order_updates_dropped(ctx, &dropped) == ACCT_OK);
+    assert(dropped == 1);
+
+    assert(acct_poll_order_updates(ctx, nullptr, 1, &count) == ACCT_ERR_INVALID_PARAM);
+    assert(acct_poll_order_updates(ctx, updates, 0, &count) == ACCT_OK && count == 0);
+    assert(acct_poll_order_updates(nullptr, updates, 1, &count) == ACCT_ERR_INVALID_PARAM);
+
+    assert(acct_destroy(ctx) == ACCT_OK);
+    upstream_manager.close();
+    cleanup_order_api_shm("20260307");
+}
+
+TEST(wait_order_wakes_on_slot_update) {
+    cleanup_order_api_shm("20260308");
+
+    acct_ctx_t ctx = nullptr;
+    acct_init_options_t opts{};
+    opts.trading_day = "20260308";
+    opts.create_if_not_exist = 1;
+    assert(acct_init_ex(&opts, &ctx) == ACCT_OK);
+
+    uint32_t order_id = 0;
+    assert(acct_submit_order(ctx, "000001", ACCT_SIDE_BUY, ACCT_MARKET_SZ, 100, 10.5, 0, &order_id) == ACCT_OK);
+
+    // 尚未被取走：只判断一次或短超时都返回 TIMEOUT
+    assert(acct_wait_order(ctx, order_id, ACCT_WAIT_DEQUEUED, 0) == ACCT_ERR_TIMEOUT);
+    assert(acct_wait_order(ctx, order_id, ACCT_WAIT_TERMINAL, 2'000'000) == ACCT_ERR_TIMEOUT);
+
+    acct_service::SHMManager orders_manager;
+    acct_service::orders_shm_layout* orders = orders_manager.open_orders(
+        acct_service::make_orders_shm_name(acct_service::kOrdersShmName, "20260308"), acct_service::shm_mode::Open, 0,
+        0);
+    assert(orders);
+    const acct_service::OrderIndex index = acct_service::order_id_slot_index(order_id);
+
+    // 模拟账户服务出队并最终拒绝：等待方随槽位写入被唤醒
+    std::thread writer([&]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        assert(acct_service::orders_shm_update_stage(orders, index, acct_service::OrderSlotState::UpstreamDequeued,
+                                                     acct_service::now_ns()));
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        assert(acct_service::orders_shm_update_stage(orders, index, acct_service::OrderSlotState::RiskRejected,
+                                                     acct_service::now_ns()));
+    });
+    const auto started = std::chrono::steady_clock::now();
+    assert(acct_wait_order(ctx, order_id, ACCT_WAIT_DEQUEUED, 5'000'000'000ULL) == ACCT_OK);
+    assert(acct_wait_order(ctx, order_id, ACCT_WAIT_REJECTED | ACCT_WAIT_TERMINAL, 5'000'000'000ULL) == ACCT_OK);
+    assert(std::chrono::steady_clock::now() - started < std::chrono::seconds(2));
+    writer.join();
+    assert(acct_service::orders_shm_find_slot(orders, index)->waiters.load() == 0);
+    assert(acct_wait_order(ctx, order_id, ACCT_WAIT_ACCEPTED | ACCT_WAIT_TRADED, 0) == ACCT_ERR_TIMEOUT);
+
+    // 槽位不属于该订单号、非法掩码
+    assert(acct_wait_order(ctx, order_id + 1, ACCT_WAIT_DEQUEUED, 0) == ACCT_ERR_ORDER_NOT_FOUND);
+    assert(acct_wait_order(ctx, order_id, 0, 0) == ACCT_ERR_INVALID_PARAM);
+    assert(acct_wait_order(ctx, order_id, 0x100, 0) == ACCT_ERR_INVALID_PARAM);
+    assert(std::string_view(acct_strerror(ACCT_ERR_TIMEOUT)) == "Wait timed out");
+
+    orders_manager.close();
+    assert(acct_destroy(ctx) == ACCT_OK);
+    cleanup_order_api_shm("20260308");
+}
+
+// 账户服务发布的风控参数段：明显违规的新单在 API 侧拒绝，不占订单池槽位也不入队
+TEST(precheck_rejects_with_published_risk_params) {
+    using namespace acct_service;
+    cleanup_order_api_shm("20260304");
+    const std::string risk_name = make_risk_params_shm_name(kUpstreamOrderShmName);
+    (void)SHMManager::unlink(risk_name);
+
+    SHMManager risk_manager;
+    risk_params_shm_layout* params = risk_manager.open_risk_params(risk_name, shm_mode::Create, 1);
+    assert(params != nullptr);
+    risk_params_begin_publish(params);
+    params->max_order_value = 100'000'00;
+    params->max_order_volume = 5000;
+    params->flags = kRiskParamsPriceLimit;
+    InternalSecurityId id;
+    assert(build_internal_security_id(Market::SZ, "000001", id));
+    assert(risk_params_put_band(params, id, 1100, 900));
+    risk_params_end_publish(params);
+
+    acct_ctx_t ctx = nullptr;
+    acct_init_options_t opts{};
+    opts.trading_day = "20260304";
+    opts.create_if_not_exist = 1;
+    assert(acct_init_ex(&opts, &ctx) == ACCT_OK);
+
+    uint32_t order_id = 0;
+    assert(acct_new_order(ctx, "000001", ACCT_SIDE_BUY, ACCT_MARKET_SZ, 6000, 10.0, 0, &order_id) ==
+           ACCT_ERR_RISK_REJECTED);
+    assert(order_id == 0);
+    assert(acct_submit_order(ctx, "000001", ACCT_SIDE_BUY, ACCT_MARKET_SZ, 100, 11.5, 0, &order_id) ==
+           ACCT_ERR_RISK_REJECTED);
+    assert(acct_submit_order(ctx, "600000", ACCT_SIDE_BUY, ACCT_MARKET_SH, 5000, 25.0, 0, &order_id) ==
+           ACCT_ERR_RISK_REJECTED);
+    size_t queue_size = 0;
+    assert(acct_queue_size(ctx, &queue_size) == ACCT_OK);
+    assert(queue_size == 0);
+
+    // 价格带内、未设价格带的证券照常提交
+    assert(acct_submit_order(ctx, "000001", ACCT_SIDE_BUY, ACCT_MARKET_SZ, 100, 10.5, 0, &order_id) == ACCT_OK);
+    assert(acct_submit_order(ctx, "600000", ACCT_SIDE_SELL, ACCT_MARKET_SH, 100, 99.0, 0, &order_id) == ACCT_OK);
+
+    acct_order_spec_t specs[2]{};
+    specs[0].security_id = "000001";
+    specs[0].volume = 100;
+    specs[0].price = 8.0;
+    specs[0].side = ACCT_SIDE_SELL;
+    specs[0].market = ACCT_MARKET_SZ;
+    specs[1] = specs[0];
+    specs[1].price = 9.5;
+    uint32_t ids[2] = {};
+    acct_error_t results[2] = {};
+    assert(acct_submit_orders(ctx, specs, 2, ids, results) == ACCT_ERR_RISK_REJECTED);
+    assert(results[0] == ACCT_ERR_RISK_REJECTED && ids[0] == 0);
+    assert(results[1] == ACCT_OK && ids[1] != 0);
+    assert(acct_queue_size(ctx, &queue_size) == ACCT_OK);
+    assert(queue_size == 3);
+
+    // 发布区间内读不到稳定参数时放行，交给账户服务复检
+    risk_params_begin_publish(params);
+    assert(acct_submit_order(ctx, "000001", ACCT_SIDE_BUY, ACCT_MARKET_SZ, 6000, 10.0, 0, &order_id) == ACCT_OK);
+    risk_params_end_publish(params);
+
+    assert(acct_destroy(ctx) == ACCT_OK);
+    risk_manager.close();
+    (void)SHMManager::unlink(risk_name);
+    cleanup_order_api_shm("20260304");
+}
+
 TEST(invalid_params) {
     // 注意: ctx 为 nullptr 时会返回 INVALID_PARAM
     // 实际参数验证（如 side、market、volume）需要有效的 ctx
@@ -132,6 +598,14 @@ int main() {
     RUN_TEST(null_ctx_operations);
     RUN_TEST(init_with_auto_create);
     RUN_TEST(init_ex_with_custom_options);
+    RUN_TEST(submit_orders_reports_per_element);
+    RUN_TEST(submit_basket_all_or_nothing);
+    RUN_TEST(follows_orders_rollover_to_successor_pool);
+    RUN_TEST(credits_gate_submission_and_wake_waiter);
+    RUN_TEST(thread_contexts_own_lanes_and_index_blocks);
+    RUN_TEST(poll_order_updates_reads_own_lane);
+    RUN_TEST(wait_order_wakes_on_slot_update);
+    RUN_TEST(precheck_rejects_with_published_risk_params);
     RUN_TEST(invalid_params);
 
     printf("\n=== All tests passed! ===\n");
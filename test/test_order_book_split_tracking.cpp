@@ -1,9 +1,17 @@
+#include <unistd.h>
+
 #include <algorithm>
 #include <cassert>
 #include <cstdio>
+#include <cstring>
 #include <memory>
+#include <string_view>
+#include <utility>
 #include <vector>
 
+#include "common/flat_hash_map.hpp"
+#include "common/huge_page_arena.hpp"
+#include "common/memory_accounting.hpp"
 #include "order/order_book.hpp"
 
 #define TEST(name) static void test_##name()
@@ -34,10 +42,26 @@ OrderEntry make_new_entry(InternalOrderId order_id, Volume volume, bool is_split
     return entry;
 }
 
+// 恒等哈希，让测试键按预期落在同一探测链上
+struct identity_hash {
+    std::size_t operator()(uint64_t key) const noexcept { return static_cast<std::size_t>(key); }
+};
+
 bool contains(const std::vector<InternalOrderId>& ids, InternalOrderId id) {
     return std::find(ids.begin(), ids.end(), id) != ids.end();
 }
 
+// 当前进程常驻内存（/proc/self/statm 第二列）
+std::size_t resident_bytes() {
+    std::FILE* file = std::fopen("/proc/self/statm", "r");
+    assert(file != nullptr);
+    unsigned long total_pages = 0;
+    unsigned long resident_pages = 0;
+    assert(std::fscanf(file, "%lu %lu", &total_pages, &resident_pages) == 2);
+    std::fclose(file);
+    return static_cast<std::size_t>(resident_pages) * static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+}
+
 }  // namespace
 
 TEST(split_mapping_and_aggregation) {
@@ -107,6 +131,66 @@ TEST(parent_error_latch) {
     assert(parent->request.order_state.load(std::memory_order_acquire) == OrderState::TraderError);
 }
 
+TEST(incremental_parent_aggregate_tracks_updates_and_archive) {
+    auto book = std::make_unique<OrderBook>();
+
+    constexpr int kChildren = 64;
+    const InternalOrderId parent_id = book->next_order_id();
+    assert(book->add_order(make_new_entry(parent_id, 100 * kChildren)));
+    std::vector<InternalOrderId> child_ids;
+    for (int i = 0; i < kChildren; ++i) {
+        child_ids.push_back(book->next_order_id());
+        assert(book->add_order(make_new_entry(child_ids.back(), 100, true, parent_id)));
+    }
+
+    const OrderEntry* parent = book->find_order(parent_id);
+    assert(parent != nullptr);
+    assert(parent->request.volume_remain == 100 * kChildren);
+
+    // 单个子单推进到最高等级即决定父单状态；成交按差量累加
+    assert(book->update_state(child_ids[5], OrderState::MarketAccepted));
+    assert(book->update_trade(child_ids[5], 40, 1000, 40000, 4));
+    assert(book->update_trade(child_ids[5], 20, 1000, 20000, 2));
+    assert(parent->request.order_state.load(std::memory_order_acquire) == OrderState::MarketAccepted);
+    assert(parent->request.volume_traded == 60);
+    assert(parent->request.volume_remain == 100 * kChildren - 60);
+    assert(parent->request.dvalue_traded == 60000);
+    assert(parent->request.dfee_executed == 6);
+
+    // 归档的子单不再计入，下次刷新时父单回落到剩余子单的聚合
+    assert(book->update_state(child_ids[5], OrderState::Finished));
+    assert(book->archive_order(child_ids[5]));
+    assert(book->update_state(child_ids[0], OrderState::TraderSubmitted));
+    assert(parent->request.volume_traded == 0);
+    assert(parent->request.volume_remain == 100 * (kChildren - 1));
+    assert(parent->request.order_state.load(std::memory_order_acquire) == OrderState::TraderSubmitted);
+
+    for (const InternalOrderId child_id : child_ids) {
+        if (child_id != child_ids[5]) {
+            assert(book->update_state(child_id, OrderState::Finished));
+        }
+    }
+    assert(parent->request.order_state.load(std::memory_order_acquire) == OrderState::Finished);
+
+    // 父单与子单全部归档后聚合回收，新父单复用时不带旧的错误锁存
+    assert(book->update_state(parent_id, OrderState::TraderError));
+    for (const InternalOrderId child_id : child_ids) {
+        if (child_id != child_ids[5]) {
+            assert(book->archive_order(child_id));
+        }
+    }
+    assert(book->archive_order(parent_id));
+
+    const InternalOrderId next_parent = book->next_order_id();
+    const InternalOrderId next_child = book->next_order_id();
+    assert(book->add_order(make_new_entry(next_parent, 100)));
+    assert(book->add_order(make_new_entry(next_child, 100, true, next_parent)));
+    assert(book->update_state(next_child, OrderState::Finished));
+    const OrderEntry* reused = book->find_order(next_parent);
+    assert(reused != nullptr);
+    assert(reused->request.order_state.load(std::memory_order_acquire) == OrderState::Finished);
+}
+
 TEST(managed_parent_view_skips_legacy_child_aggregation) {
     auto book = std::make_unique<OrderBook>();
 
@@ -201,15 +285,452 @@ TEST(explicit_order_id_advances_internal_id_generator) {
     assert(next == static_cast<InternalOrderId>(14));
 }
 
+TEST(flat_hash_map_backward_shift_erase) {
+    flat_hash_map<uint64_t, uint32_t, identity_hash> map(8);
+    assert(map.capacity() == 8);
+
+    // 1、9、17 同落在槽 1，2 被挤到槽 4；删除链首后其余键必须仍可查到
+    assert(map.insert_or_assign(1, 10));
+    assert(map.insert_or_assign(9, 90));
+    assert(map.insert_or_assign(17, 170));
+    assert(map.insert_or_assign(2, 20));
+    assert(map.size() == 4);
+
+    assert(map.erase(1));
+    assert(!map.contains(1));
+    assert(map.find(9) && *map.find(9) == 90);
+    assert(map.find(17) && *map.find(17) == 170);
+    assert(map.find(2) && *map.find(2) == 20);
+
+    assert(map.erase(17));
+    assert(map.find(2) && *map.find(2) == 20);
+    assert(!map.erase(17));
+    assert(map.size() == 2);
+
+    // 填满后插入新键失败，已有键仍可覆盖
+    for (uint64_t key = 100; map.size() < map.capacity(); ++key) {
+        assert(map.insert_or_assign(key, 0));
+    }
+    assert(!map.insert_or_assign(1000, 0));
+    assert(map.insert_or_assign(9, 91));
+    assert(*map.find(9) == 91);
+
+    map.clear();
+    assert(map.empty());
+    assert(!map.contains(9));
+}
+
+TEST(order_id_window_collision_uses_overflow) {
+    auto book = std::make_unique<OrderBook>();
+
+    // 两个 ID 相差 2 * kMaxActiveOrders，落在直接索引窗口的同一位置
+    const InternalOrderId first = static_cast<InternalOrderId>(7);
+    const InternalOrderId second = static_cast<InternalOrderId>(7 + kMaxActiveOrders * 2);
+    assert(book->add_order(make_new_entry(first, 100)));
+    assert(book->add_order(make_new_entry(second, 200)));
+    assert(!book->add_order(make_new_entry(second, 200)));
+
+    assert(book->find_order(first) && book->find_order(first)->request.volume_entrust == 100);
+    assert(book->find_order(second) && book->find_order(second)->request.volume_entrust == 200);
+
+    assert(book->archive_order(first));
+    assert(!book->find_order(first));
+    assert(book->find_order(second) && book->find_order(second)->request.volume_entrust == 200);
+
+    assert(book->add_order(make_new_entry(first, 300)));
+    assert(book->find_order(first)->request.volume_entrust == 300);
+    assert(book->archive_order(second));
+    assert(!book->find_order(second));
+    assert(book->find_order(first)->request.volume_entrust == 300);
+    assert(book->active_count() == 1);
+}
+
+TEST(dense_broker_ids_use_direct_window_with_hash_fallback) {
+    constexpr std::size_t kCapacity = 48;  // 窗口 128
+    auto book = std::make_unique<OrderBook>(order_book_threading::SingleThreaded, kCapacity);
+    for (InternalOrderId id = 1; id <= 4; ++id) {
+        assert(book->add_order(make_new_entry(id, 100)));
+    }
+
+    // 首个稠密编号定基址；同址被存活订单占用（编号跨度超过窗口）时落哈希表
+    assert(book->bind_broker_order_id(1, 5000, true));
+    assert(book->bind_broker_order_id(2, 5001, true));
+    assert(book->bind_broker_order_id(3, 5000 + 128, true));
+    assert(book->bind_broker_order_id(4, 0x5354524947ULL, false));
+    assert(!book->bind_broker_order_id(1, 5002, true));
+    assert(!book->bind_broker_order_id(99, 5003, true));
+
+    assert(book->find_by_broker_id(5000) && book->find_by_broker_id(5000)->request.internal_order_id == 1);
+    assert(book->find_by_broker_id(5001) && book->find_by_broker_id(5001)->request.internal_order_id == 2);
+    assert(book->find_by_broker_id(5128) && book->find_by_broker_id(5128)->request.internal_order_id == 3);
+    assert(book->find_by_broker_id(0x5354524947ULL)->request.internal_order_id == 4);
+    assert(book->find_by_broker_id(5002) == nullptr);
+    assert(book->find_order(2)->request.broker_order_id.as_uint == 5001);
+
+    // 归档释放直接数组项，冲突项随后可重新落回窗口
+    assert(book->archive_order(1));
+    assert(book->find_by_broker_id(5000) == nullptr);
+    assert(book->find_by_broker_id(5128)->request.internal_order_id == 3);
+    assert(book->archive_order(3));
+    assert(book->find_by_broker_id(5128) == nullptr);
+    assert(book->add_order(make_new_entry(5, 100)));
+    assert(book->bind_broker_order_id(5, 4999, true));  // 低于基址按模回绕
+    assert(book->find_by_broker_id(4999)->request.internal_order_id == 5);
+
+    book->clear();
+    assert(book->find_by_broker_id(5001) == nullptr);
+    assert(book->find_by_broker_id(4999) == nullptr);
+}
+
+TEST(runtime_capacity_bounds_slots_and_window) {
+    constexpr std::size_t kCapacity = 48;
+    auto book = std::make_unique<OrderBook>(order_book_threading::SingleThreaded, kCapacity);
+    assert(book->capacity() == kCapacity);
+
+    // 窗口按 bit_ceil(48) * 2 = 128 取模：相差 128 的两个 ID 冲突后走溢出表
+    assert(book->add_order(make_new_entry(static_cast<InternalOrderId>(5), 100)));
+    assert(book->add_order(make_new_entry(static_cast<InternalOrderId>(5 + 128), 200)));
+    assert(book->find_order(static_cast<InternalOrderId>(5))->request.volume_entrust == 100);
+    assert(book->find_order(static_cast<InternalOrderId>(5 + 128))->request.volume_entrust == 200);
+
+    for (std::size_t i = 2; i < kCapacity; ++i) {
+        assert(book->add_order(make_new_entry(static_cast<InternalOrderId>(1000 + i), 100)));
+    }
+    assert(book->active_count() == kCapacity);
+    assert(!book->add_order(make_new_entry(static_cast<InternalOrderId>(5000), 100)));
+
+    // 归档释放的槽位可复用，上限仍为构造容量
+    assert(book->archive_order(static_cast<InternalOrderId>(5)));
+    assert(book->add_order(make_new_entry(static_cast<InternalOrderId>(5000), 100)));
+    assert(!book->add_order(make_new_entry(static_cast<InternalOrderId>(5001), 100)));
+
+    assert(OrderBook(order_book_threading::SingleThreaded, 0).capacity() == 1);
+}
+
+TEST(child_and_security_lists_visit_without_copy) {
+    auto book = std::make_unique<OrderBook>();
+
+    const InternalOrderId parent_id = book->next_order_id();
+    const InternalOrderId child1_id = book->next_order_id();
+    const InternalOrderId child2_id = book->next_order_id();
+    const InternalOrderId child3_id = book->next_order_id();
+    assert(book->add_order(make_new_entry(parent_id, 900)));
+    assert(book->add_order(make_new_entry(child1_id, 300, true, parent_id)));
+    assert(book->add_order(make_new_entry(child2_id, 300, true, parent_id)));
+    assert(book->add_order(make_new_entry(child3_id, 300, true, parent_id)));
+
+    // 中间节点移出证券链表后，其余订单保持登记顺序
+    assert(book->archive_order(child2_id));
+    std::vector<InternalOrderId> security_ids;
+    book->for_each_security_order(InternalSecurityId("XSHE_000001"), [&](const OrderEntry& entry) {
+        security_ids.push_back(entry.request.internal_order_id);
+    });
+    assert((security_ids == std::vector<InternalOrderId>{parent_id, child1_id, child3_id}));
+    assert(book->get_orders_by_security(InternalSecurityId("XSHE_000001")) == security_ids);
+
+    // 已归档子单仍留在父单链表中，只是条目为空
+    std::vector<InternalOrderId> visited;
+    std::size_t live_children = 0;
+    book->for_each_child(parent_id, [&](InternalOrderId child_id, const OrderEntry* child) {
+        visited.push_back(child_id);
+        if (child) {
+            ++live_children;
+        }
+    });
+    assert((visited == std::vector<InternalOrderId>{child1_id, child2_id, child3_id}));
+    assert(live_children == 2);
+
+    // 父单和全部子单都归档后回收链表与反查映射
+    assert(book->archive_order(parent_id));
+    assert(book->get_children(parent_id).size() == 3);
+    assert(book->archive_order(child1_id));
+    assert(book->archive_order(child3_id));
+    InternalOrderId reverse_parent = 0;
+    assert(book->get_children(parent_id).empty());
+    assert(!book->try_get_parent(child1_id, reverse_parent));
+    assert(book->get_orders_by_security(InternalSecurityId("XSHE_000001")).empty());
+}
+
+TEST(lazy_slots_reuse_and_clear) {
+    auto book = std::make_unique<OrderBook>();
+
+    assert(book->add_order(make_new_entry(101, 100)));
+    assert(book->add_order(make_new_entry(102, 200)));
+    assert(book->add_order(make_new_entry(103, 300)));
+    assert(book->archive_order(102));
+
+    // 归档释放的槽位被新订单复用，活跃遍历只看到存活订单
+    assert(book->add_order(make_new_entry(104, 400)));
+    std::vector<InternalOrderId> active = book->get_active_order_ids();
+    std::sort(active.begin(), active.end());
+    assert((active == std::vector<InternalOrderId>{101, 103, 104}));
+    assert(!book->find_order(102));
+    assert(book->find_order(104)->request.volume_entrust == 400);
+
+    book->clear();
+    assert(book->active_count() == 0);
+    assert(book->get_active_order_ids().empty());
+    assert(!book->find_order(101));
+    assert(book->add_order(make_new_entry(101, 500)));
+    assert(book->find_order(101)->request.volume_entrust == 500);
+}
+
+TEST(full_capacity_book_faults_storage_on_demand) {
+    // 满容量订单簿的条目、平行数组与大索引表都按需落页，构造后常驻内存只随写入的槽位增长
+    const std::size_t before = resident_bytes();
+    auto book = std::make_unique<OrderBook>(order_book_threading::SingleThreaded, kMaxActiveOrders);
+    const std::size_t constructed = resident_bytes();
+    assert(constructed - std::min(constructed, before) < (std::size_t{16} << 20));
+
+    for (InternalOrderId order_id = 1; order_id <= 1000; ++order_id) {
+        assert(book->add_order(make_new_entry(order_id, 100)));
+    }
+    assert(book->find_order(1000)->request.volume_entrust == 100);
+    const std::size_t used = resident_bytes();
+    assert(used - std::min(used, before) < (std::size_t{32} << 20));
+
+    // clear 归还已落页，之后仍可从零水位线重新切出槽位
+    book->clear();
+    assert(!book->find_order(1));
+    assert(book->add_order(make_new_entry(7, 700)));
+    assert(book->find_order(7)->request.volume_entrust == 700);
+    assert(book->active_count() == 1);
+}
+
+TEST(huge_page_arena_reports_book_regions) {
+    huge_page_arena& arena = huge_page_arena::instance();
+    const arena_footprint before = arena.footprint();
+
+    // 满容量订单簿的条目数组远大于 2 MiB：开大页时按大页对齐映射并登记为透明大页；hugetlb 预留池为空时回落
+    arena.set_explicit_huge_pages(true);
+    auto book = std::make_unique<OrderBook>(order_book_threading::SingleThreaded, kMaxActiveOrders, true);
+    arena.set_explicit_huge_pages(false);
+    assert(book->add_order(make_new_entry(1, 100)));
+
+    const arena_footprint with_book = arena.footprint();
+    assert(with_book.regions > before.regions);
+    assert(with_book.reserved_bytes > before.reserved_bytes + sizeof(OrderEntry) * kMaxActiveOrders);
+    assert(with_book.explicit_bytes + with_book.transparent_bytes > before.explicit_bytes + before.transparent_bytes);
+
+    bool found = false;
+    arena.for_each_region([&found](const arena_region_info& region) {
+        if (std::string_view(region.tag) != "order_book.orders") {
+            return;
+        }
+        found = true;
+        assert(region.backing == arena_backing::Transparent || region.backing == arena_backing::Explicit);
+        // 只写了一个条目：已落页量远小于预留量
+        assert(region.resident_bytes > 0);
+        assert(region.resident_bytes < region.bytes / 4);
+    });
+    assert(found);
+
+    // 组件析构时区块归还，合计回到构造前
+    book.reset();
+    const arena_footprint after = arena.footprint();
+    assert(after.regions == before.regions);
+    assert(after.reserved_bytes == before.reserved_bytes);
+}
+
+TEST(active_visitor_and_chunked_cursor) {
+    auto book = std::make_unique<OrderBook>(order_book_threading::SingleThreaded, 256);
+
+    // 跨越多个位图字，并在中间归档一部分制造空洞
+    for (InternalOrderId id = 1; id <= 200; ++id) {
+        assert(book->add_order(make_new_entry(id, 100)));
+    }
+    for (InternalOrderId id = 2; id <= 200; id += 3) {
+        assert(book->archive_order(id));
+    }
+
+    std::vector<InternalOrderId> visited;
+    book->for_each_active([&](const OrderEntry& entry) { visited.push_back(entry.request.internal_order_id); });
+    assert(visited.size() == book->active_count());
+    assert(visited == book->get_active_order_ids());
+
+    // 分段扫描中途归档尚未扫到的订单，该订单不再被访问
+    std::vector<InternalOrderId> chunked;
+    OrderBook::active_cursor cursor;
+    bool more = book->for_each_active_chunk(
+        cursor, 50, [&](const OrderEntry& entry) { chunked.push_back(entry.request.internal_order_id); });
+    assert(more);
+    assert(chunked.size() == 50);
+    assert(book->archive_order(199));
+    while (more) {
+        more = book->for_each_active_chunk(
+            cursor, 50, [&](const OrderEntry& entry) { chunked.push_back(entry.request.internal_order_id); });
+    }
+    assert(chunked.size() == visited.size() - 1);
+    assert(!contains(chunked, 199));
+    assert(!book->for_each_active_chunk(cursor, 50, [](const OrderEntry&) { assert(false); }));
+}
+
+struct change_counter {
+    std::size_t added = 0;
+    std::size_t archived = 0;
+
+    void on_change(const OrderEntry& entry, order_book_event_t event) {
+        (void)entry;
+        if (event == order_book_event_t::Added) {
+            ++added;
+        } else if (event == order_book_event_t::Archived) {
+            ++archived;
+        }
+    }
+};
+
+TEST(single_threaded_book_with_static_hook) {
+    auto book = std::make_unique<OrderBook>(order_book_threading::SingleThreaded);
+    change_counter counter;
+    book->set_change_hook(order_change_hook::bind<change_counter, &change_counter::on_change>(&counter));
+
+    assert(book->add_order(make_new_entry(11, 100)));
+    assert(book->add_order(make_new_entry(12, 100)));
+    assert(book->archive_order(11));
+    assert(counter.added == 2);
+    assert(counter.archived == 1);
+
+    // 设置 std::function 回调会替换钩子
+    std::size_t callback_events = 0;
+    book->set_change_callback([&](const OrderEntry&, order_book_event_t) { ++callback_events; });
+    assert(book->update_state(12, OrderState::TraderSubmitted));
+    assert(callback_events == 1);
+    assert(counter.added == 2);
+
+    book->set_change_hook({});
+    assert(book->archive_order(12));
+    assert(callback_events == 1);
+    assert(counter.archived == 1);
+}
+
+TEST(amend_order_updates_entrust_in_place) {
+    auto book = std::make_unique<OrderBook>(order_book_threading::SingleThreaded);
+    std::vector<order_book_event_t> events;
+    book->set_change_callback([&](const OrderEntry&, order_book_event_t event) { events.push_back(event); });
+
+    assert(book->add_order(make_new_entry(21, 300)));
+    assert(book->update_trade(21, 100, 1000, 100000, 5));
+    assert(book->amend_order(21, 200, 1010));
+    assert(events.back() == order_book_event_t::Amended);
+    const OrderEntry* entry = book->find_order(21);
+    assert(entry != nullptr);
+    assert(entry->request.volume_entrust == 200);
+    assert(entry->request.volume_remain == 100);
+    assert(entry->request.dprice_entrust == 1010);
+    assert(entry->request.volume_traded == 100);
+
+    // 改后数量不得不超过已成交量；终态订单不可改
+    assert(!book->amend_order(21, 100, 1010));
+    assert(!book->amend_order(99, 200, 1010));
+    assert(book->update_state(21, OrderState::Finished));
+    assert(!book->amend_order(21, 250, 1010));
+    assert(book->find_order(21)->request.volume_entrust == 200);
+}
+
+// 事件序列观察者：把 (tag, 事件) 追加到共享日志，用于校验静态组合的分发顺序
+struct event_trace_observer {
+    int tag;
+    std::vector<std::pair<int, order_book_event_t>>* trace;
+
+    void on_order_change(const OrderEntry& entry, order_book_event_t event) {
+        (void)entry;
+        trace->emplace_back(tag, event);
+    }
+};
+
+TEST(static_observer_list_dispatches_in_declaration_order) {
+    auto book = std::make_unique<OrderBook>(order_book_threading::SingleThreaded);
+    std::vector<std::pair<int, order_book_event_t>> trace;
+    order_change_observers<event_trace_observer, event_trace_observer> observers{event_trace_observer{1, &trace},
+                                                                                 event_trace_observer{2, &trace}};
+    book->set_change_hook(observers.hook());
+
+    assert(book->add_order(make_new_entry(21, 100)));
+    assert(book->archive_order(21));
+    assert(trace.size() == 4);
+    assert(trace[0] == std::make_pair(1, order_book_event_t::Added));
+    assert(trace[1] == std::make_pair(2, order_book_event_t::Added));
+    assert(trace[2] == std::make_pair(1, order_book_event_t::Archived));
+    assert(trace[3] == std::make_pair(2, order_book_event_t::Archived));
+    assert(observers.get<1>().tag == 2);
+
+    book->set_change_hook({});
+}
+
+uint64_t gauge_value(const metrics_table& table, const char* name) {
+    const std::size_t count = table.slot_count.load(std::memory_order_acquire);
+    for (std::size_t i = 0; i < count; ++i) {
+        if (std::strcmp(table.slots[i].name, name) == 0) {
+            return table.slots[i].value.load(std::memory_order_relaxed);
+        }
+    }
+    assert(false && "metric not found");
+    return 0;
+}
+
+TEST(memory_accounting_tracks_book_growth) {
+    auto book = std::make_unique<OrderBook>();
+    const memory_usage empty_orders = book->storage_memory();
+    const memory_usage empty_index = book->index_memory();
+    assert(empty_orders.reserved_bytes > 0);
+    assert(empty_orders.used_bytes == 0);
+    assert(empty_index.reserved_bytes > 0);
+
+    memory_accounting accounting;
+    accounting.add(
+        "order_book.orders",
+        [](const void* context) noexcept { return static_cast<const OrderBook*>(context)->storage_memory(); },
+        book.get());
+    accounting.add(
+        "order_book.index",
+        [](const void* context) noexcept { return static_cast<const OrderBook*>(context)->index_memory(); },
+        book.get());
+    assert(accounting.size() == 2);
+
+    auto table = std::make_unique<metrics_table>();
+    metrics_registry registry(table.get());
+    accounting.bind_metrics(registry);
+    assert(table->slot_count.load() == 4);
+
+    for (InternalOrderId id = 31; id < 41; ++id) {
+        assert(book->add_order(make_new_entry(id, 100)));
+    }
+    const memory_usage orders = book->storage_memory();
+    assert(orders.reserved_bytes == empty_orders.reserved_bytes);
+    assert(orders.used_bytes > 0 && orders.used_bytes <= orders.reserved_bytes);
+    assert(book->index_memory().used_bytes > empty_index.used_bytes);
+
+    accounting.publish();
+    assert(gauge_value(*table, "mem.order_book.orders.reserved") == orders.reserved_bytes);
+    assert(gauge_value(*table, "mem.order_book.orders.used") == orders.used_bytes);
+    const memory_usage total = accounting.total();
+    assert(total.used_bytes == gauge_value(*table, "mem.order_book.orders.used") +
+                                   gauge_value(*table, "mem.order_book.index.used"));
+}
+
 int main() {
     printf("=== Order Book Split Tracking Test Suite ===\n\n");
 
     RUN_TEST(split_mapping_and_aggregation);
     RUN_TEST(parent_error_latch);
+    RUN_TEST(incremental_parent_aggregate_tracks_updates_and_archive);
     RUN_TEST(managed_parent_view_skips_legacy_child_aggregation);
     RUN_TEST(managed_parent_view_deduplicates_identical_refresh);
     RUN_TEST(ensure_next_order_id_at_least);
     RUN_TEST(explicit_order_id_advances_internal_id_generator);
+    RUN_TEST(flat_hash_map_backward_shift_erase);
+    RUN_TEST(order_id_window_collision_uses_overflow);
+    RUN_TEST(dense_broker_ids_use_direct_window_with_hash_fallback);
+    RUN_TEST(runtime_capacity_bounds_slots_and_window);
+    RUN_TEST(child_and_security_lists_visit_without_copy);
+    RUN_TEST(lazy_slots_reuse_and_clear);
+    RUN_TEST(full_capacity_book_faults_storage_on_demand);
+    RUN_TEST(huge_page_arena_reports_book_regions);
+    RUN_TEST(active_visitor_and_chunked_cursor);
+    RUN_TEST(single_threaded_book_with_static_hook);
+    RUN_TEST(amend_order_updates_entrust_in_place);
+    RUN_TEST(static_observer_list_dispatches_in_declaration_order);
+    RUN_TEST(memory_accounting_tracks_book_growth);
 
     printf("\n=== All tests passed! ===\n");
     return 0;
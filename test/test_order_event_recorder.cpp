@@ -1,5 +1,6 @@
 #include <unistd.h>
 
+#include <algorithm>
 #include <cassert>
 #include <chrono>
 #include <cstdio>
@@ -7,11 +8,17 @@
 #include <fstream>
 #include <functional>
 #include <iterator>
+#include <memory>
 #include <sstream>
 #include <string>
 #include <thread>
+#include <vector>
 
+#include "order/order_event_codec.hpp"
 #include "order/order_event_recorder.hpp"
+#include "order/order_journal.hpp"
+#include "order/order_recovery.hpp"
+#include "shm/orders_shm.hpp"
 
 #define TEST(name) static void test_##name()
 #define RUN_TEST(name)                   \
@@ -64,8 +71,261 @@ std::string find_line_containing(const std::string& content, std::string_view ne
     return {};
 }
 
+// 构造一笔已下游的订单条目，供二进制日志与恢复用例复用。
+OrderEntry make_downstream_entry(InternalOrderId order_id, OrderIndex shm_order_index, OrderState state) {
+    OrderEntry entry{};
+    entry.request.init_new("000001", InternalSecurityId("XSHE_000001"), order_id, TradeSide::Buy, Market::SZ,
+                           static_cast<Volume>(100), static_cast<DPrice>(1000), 93000000);
+    entry.request.order_state.store(state, std::memory_order_relaxed);
+    entry.submit_time_ns = now_ns();
+    entry.last_update_ns = entry.submit_time_ns;
+    entry.strategy_id = static_cast<StrategyId>(3);
+    entry.shm_order_index = shm_order_index;
+    return entry;
+}
+
 }  // namespace
 
+TEST(batched_writer_flushes_bursts_across_writev_batches) {
+    const std::filesystem::path output_dir = unique_dir("order_event_batch");
+    std::filesystem::create_directories(output_dir);
+
+    BusinessLogConfig config;
+    config.enabled = true;
+    config.output_dir = output_dir.string();
+    config.queue_capacity = 4096;
+    config.flush_interval_ms = 10;
+
+    OrderEventRecorder recorder;
+    assert(recorder.init(config, 80, "20260227"));
+
+    // 超过单批 writev 行数的突发写入，需全部按序落盘且不丢事件
+    constexpr int kEvents = 1500;
+    for (int i = 0; i < kEvents; ++i) {
+        OrderEntry entry = make_downstream_entry(static_cast<InternalOrderId>(9000 + i), static_cast<OrderIndex>(i),
+                                                 OrderState::TraderSubmitted);
+        recorder.record_order_event(entry, order_book_event_t::Added);
+    }
+
+    const std::filesystem::path business_path = output_dir / "order_events_80_20260227.log";
+    assert(wait_until([&business_path]() {
+        const std::string content = read_text_file(business_path);
+        return static_cast<int>(std::count(content.begin(), content.end(), '\n')) == kEvents;
+    }));
+    const std::string content = read_text_file(business_path);
+    assert(content.find("order_id=9000 ") < content.find("order_id=10499 "));
+    assert(recorder.dropped_count() == 0);
+
+    recorder.shutdown();
+    std::filesystem::remove_all(output_dir);
+}
+
+// 同一订单流分别写文本与增量文件：还原后逐字节等于文本日志，续写追加的头帧与损坏帧都能越过。
+TEST(delta_records_decode_to_text_lines) {
+    const std::filesystem::path text_dir = unique_dir("order_event_text");
+    const std::filesystem::path delta_dir = unique_dir("order_event_delta");
+
+    BusinessLogConfig config;
+    config.enabled = true;
+    config.queue_capacity = 4096;
+    config.flush_interval_ms = 10;
+
+    // 每笔订单：新增 -> 受理 -> 两次成交 -> 归档，相邻事件只有状态与成交字段变化
+    const auto record_orders = [](OrderEventRecorder& recorder, InternalOrderId first, int count) {
+        for (int i = 0; i < count; ++i) {
+            OrderEntry entry = make_downstream_entry(first + static_cast<InternalOrderId>(i),
+                                                     static_cast<OrderIndex>(i), OrderState::TraderSubmitted);
+            entry.last_update_ns = 1'000'000'000ULL + static_cast<TimestampNs>(i) * 1000;
+            recorder.record_order_event(entry, order_book_event_t::Added);
+            entry.request.order_state.store(OrderState::MarketAccepted, std::memory_order_relaxed);
+            entry.last_update_ns += 50;
+            recorder.record_order_event(entry, order_book_event_t::StatusUpdated);
+            for (Volume traded : {static_cast<Volume>(40), static_cast<Volume>(100)}) {
+                entry.request.volume_traded = traded;
+                entry.request.volume_remain = 100 - traded;
+                entry.request.dvalue_traded = traded * 1000;
+                entry.request.dprice_traded = 1000;
+                entry.last_update_ns += 120;
+                recorder.record_order_event(entry, order_book_event_t::TradeUpdated);
+            }
+            entry.request.order_state.store(OrderState::Finished, std::memory_order_relaxed);
+            entry.last_update_ns += 10;
+            recorder.record_order_event(entry, order_book_event_t::Archived);
+        }
+    };
+
+    OrderEventRecorder text_recorder;
+    config.output_dir = text_dir.string();
+    assert(text_recorder.init(config, 81, "20260227"));
+    record_orders(text_recorder, 7000, 200);
+    record_orders(text_recorder, 8000, 20);
+    text_recorder.shutdown();
+
+    // 增量模式分两次启动，模拟重启后续写同一文件
+    config.output_dir = delta_dir.string();
+    config.delta_records = true;
+    {
+        OrderEventRecorder recorder;
+        assert(recorder.init(config, 81, "20260227"));
+        record_orders(recorder, 7000, 200);
+        assert(recorder.dropped_count() == 0);
+    }
+    {
+        OrderEventRecorder recorder;
+        assert(recorder.init(config, 81, "20260227"));
+        record_orders(recorder, 8000, 20);
+    }
+
+    const std::string text = read_text_file(text_dir / "order_events_81_20260227.log");
+    std::ifstream delta_in(delta_dir / "order_events_81_20260227.evd", std::ios::binary);
+    const std::string delta((std::istreambuf_iterator<char>(delta_in)), std::istreambuf_iterator<char>());
+    assert(!std::filesystem::exists(delta_dir / "order_events_81_20260227.log"));
+    assert(std::count(text.begin(), text.end(), '\n') == 220 * 5);
+    assert(delta.size() * 4 < text.size());
+
+    const auto decode_lines = [](std::string_view data, std::size_t& records, std::size_t& corrupt) {
+        std::ostringstream lines;
+        order_event_delta_decoder decoder;
+        decoder.decode(
+            data,
+            [&lines](const OrderEventRecord& record, AccountId account_id, std::string_view trading_day) {
+                write_order_event_line(lines, record, account_id, trading_day);
+            },
+            &records, &corrupt);
+        return lines.str();
+    };
+    std::size_t records = 0;
+    std::size_t corrupt = 0;
+    assert(decode_lines(delta, records, corrupt) == text);
+    assert(records == 220 * 5);
+    assert(corrupt == 0);
+
+    // 第一段中部损坏：其后直到续写头帧的增量无法还原，续写部分仍完整
+    std::string damaged = delta;
+    damaged[damaged.size() / 4] = static_cast<char>(0xFF);
+    const std::string recovered = decode_lines(damaged, records, corrupt);
+    assert(corrupt > 0);
+    assert(records < 220 * 5);
+    assert(recovered.find("order_id=8019 ") != std::string::npos);
+    assert(recovered.find("order_id=7000 ") != std::string::npos);
+
+    std::filesystem::remove_all(text_dir);
+    std::filesystem::remove_all(delta_dir);
+}
+
+TEST(binary_journal_rolls_segments_and_drives_recovery) {
+    const std::filesystem::path output_dir = unique_dir("order_journal");
+    std::filesystem::create_directories(output_dir);
+
+    BusinessLogConfig config;
+    config.enabled = true;
+    config.output_dir = output_dir.string();
+    config.queue_capacity = 16;
+    config.flush_interval_ms = 10;
+    config.binary_journal = true;
+    config.journal_segment_records = 2;
+
+    OrderEntry live_a = make_downstream_entry(8001, 0, OrderState::TraderSubmitted);
+    OrderEntry done = make_downstream_entry(8002, 1, OrderState::TraderSubmitted);
+    OrderEntry live_b = make_downstream_entry(8003, 2, OrderState::BrokerAccepted);
+    OrderEntry unjournaled = make_downstream_entry(8004, 3, OrderState::TraderSubmitted);
+
+    OrderEventRecorder recorder;
+    assert(recorder.init(config, 78, "20260226"));
+    recorder.record_order_event(live_a, order_book_event_t::Added);
+    recorder.record_order_event(done, order_book_event_t::Added);
+    recorder.record_order_event(live_b, order_book_event_t::Added);
+    done.request.order_state.store(OrderState::Finished, std::memory_order_relaxed);
+    recorder.record_order_event(done, order_book_event_t::StatusUpdated);
+    recorder.shutdown();
+
+    // 记录同步写入 mmap 段，无需等待后台线程；文本业务日志不再生成
+    const order_journal_location location{output_dir.string(), 78, "20260226"};
+    assert(std::filesystem::exists(location.segment_path(0)));
+    assert(std::filesystem::exists(location.segment_path(1)));
+    assert(!std::filesystem::exists(location.segment_path(2)));
+    assert(!std::filesystem::exists(output_dir / "order_events_78_20260226.log"));
+
+    std::vector<order_journal_record> records;
+    std::size_t segments = 0;
+    assert(order_journal_replay(
+        location, [&records](const order_journal_record& record) { records.push_back(record); }, &segments));
+    assert(segments == 2);
+    assert(records.size() == 4);
+    assert(records[0].order_id == 8001 && records[0].event == order_book_event_t::Added);
+    assert(records[0].strategy_id == 3 && records[0].shm_order_index == 0);
+    assert(records[0].internal_security_id == std::string_view("XSHE_000001"));
+    assert(records[3].order_id == 8002 && records[3].order_state == OrderState::Finished);
+
+    // 重启续写最后一段：已满的 1 号段之后滚动出 2 号段
+    assert(recorder.init(config, 78, "20260226"));
+    recorder.record_order_event(live_b, order_book_event_t::TradeUpdated);
+    recorder.shutdown();
+    assert(std::filesystem::exists(location.segment_path(2)));
+
+    auto orders_shm = std::make_unique<orders_shm_layout>();
+    orders_shm->header.capacity = static_cast<uint32_t>(kDailyOrderPoolCapacity);
+    orders_shm->header.next_index.store(4, std::memory_order_relaxed);
+    for (const OrderEntry* entry : {&live_a, &done, &live_b, &unjournaled}) {
+        assert(orders_shm_write_order(orders_shm.get(), entry->shm_order_index, entry->request,
+                                      OrderSlotState::DownstreamQueued, order_slot_source_t::User, now_ns()));
+    }
+
+    // 日志回放只读取日志中的在途槽位：8002 已终态出局，未入日志的 8004 不会被扫描到
+    OrderBook book;
+    bool replayed = false;
+    assert(recover_downstream_active_orders_from_journal(location, orders_shm.get(), book, &replayed));
+    assert(replayed);
+    assert(book.find_order(8001) != nullptr);
+    assert(book.find_order(8003) != nullptr);
+    assert(book.find_order(8002) == nullptr);
+    assert(book.find_order(8004) == nullptr);
+
+    // 当日没有日志时不恢复任何订单，交由调用方回退 orders_shm 扫描
+    OrderBook empty_book;
+    const order_journal_location missing{output_dir.string(), 79, "20260226"};
+    assert(recover_downstream_active_orders_from_journal(missing, orders_shm.get(), empty_book, &replayed));
+    assert(!replayed);
+    assert(empty_book.find_order(8001) == nullptr);
+
+    std::filesystem::remove_all(output_dir);
+}
+
+TEST(parallel_shm_scan_merges_worker_ranges_in_slot_order) {
+    // 水位跨越多个线程分段：分段边界两侧各放一笔，同一订单重复出现在两段时保留较新的快照
+    constexpr OrderIndex kUpper = 4 * 16384 + 7;
+    auto orders_shm = std::make_unique<orders_shm_layout>();
+    orders_shm->header.capacity = static_cast<uint32_t>(kDailyOrderPoolCapacity);
+    orders_shm->header.next_index.store(kUpper, std::memory_order_relaxed);
+
+    const OrderEntry first = make_downstream_entry(9001, 0, OrderState::TraderSubmitted);
+    const OrderEntry boundary_low = make_downstream_entry(9002, 16383, OrderState::TraderSubmitted);
+    const OrderEntry boundary_high = make_downstream_entry(9003, 16384, OrderState::BrokerAccepted);
+    const OrderEntry finished = make_downstream_entry(9004, 30000, OrderState::Finished);
+    const OrderEntry last = make_downstream_entry(9005, kUpper - 1, OrderState::TraderSubmitted);
+    const OrderEntry stale_copy = make_downstream_entry(9003, 50000, OrderState::TraderSubmitted);
+    for (const OrderEntry* entry : {&first, &boundary_low, &boundary_high, &finished, &last}) {
+        assert(orders_shm_write_order(orders_shm.get(), entry->shm_order_index, entry->request,
+                                      OrderSlotState::DownstreamQueued, order_slot_source_t::User, 2000));
+    }
+    assert(orders_shm_write_order(orders_shm.get(), stale_copy.shm_order_index, stale_copy.request,
+                                  OrderSlotState::DownstreamQueued, order_slot_source_t::User, 1000));
+
+    OrderBook book;
+    assert(recover_downstream_active_orders_from_shm(orders_shm.get(), book));
+    for (const OrderEntry* entry : {&first, &boundary_low, &last}) {
+        const OrderEntry* recovered = book.find_order(entry->request.internal_order_id);
+        assert(recovered != nullptr);
+        assert(recovered->shm_order_index == entry->shm_order_index);
+    }
+    const OrderEntry* deduped = book.find_order(9003);
+    assert(deduped != nullptr);
+    assert(deduped->shm_order_index == 16384);
+    assert(deduped->request.order_state.load(std::memory_order_relaxed) == OrderState::BrokerAccepted);
+    assert(book.find_order(9004) == nullptr);
+    assert(book.next_order_id() >= 9006);
+}
+
 TEST(records_business_events_and_debug_trace) {
     const std::filesystem::path output_dir = unique_dir("order_event_recorder");
     std::filesystem::create_directories(output_dir);
@@ -170,6 +430,10 @@ int main() {
     printf("=== Order Event Recorder Test Suite ===\n\n");
 
     RUN_TEST(records_business_events_and_debug_trace);
+    RUN_TEST(batched_writer_flushes_bursts_across_writev_batches);
+    RUN_TEST(delta_records_decode_to_text_lines);
+    RUN_TEST(binary_journal_rolls_segments_and_drives_recovery);
+    RUN_TEST(parallel_shm_scan_merges_worker_ranges_in_slot_order);
 
     printf("\n=== All tests passed! ===\n");
     return 0;
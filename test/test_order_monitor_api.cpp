@@ -1,4 +1,6 @@
+#include <fcntl.h>
 #include <sys/mman.h>
+#include <unistd.h>
 
 #include <cassert>
 #include <cerrno>
@@ -10,6 +12,10 @@
 
 #include "api/order_api.h"
 #include "api/order_monitor_api.h"
+#include "shm/orders_index_shm.hpp"
+#include "shm/orders_shm.hpp"
+#include "shm/shm_layout.hpp"
+#include "shm/shm_manager.hpp"
 
 #define TEST(name) static void test_##name()
 #define RUN_TEST(name)                   \
@@ -132,12 +138,244 @@ TEST(open_read_close) {
     assert(snapshot.schedulable_volume == 0);
     assert(std::strncmp(snapshot.security_id, "000001", 6) == 0);
 
+    // 提交即打点 submit_ns，账户服务尚未消费时各跳均未到达
+    acct_orders_mon_latency_t latency{};
+    assert(acct_orders_mon_read_latency(mon_ctx, 0, &latency) == ACCT_MON_OK);
+    assert(latency.index == 0);
+    assert(latency.submit_ns != 0);
+    for (uint32_t hop = 0; hop < ACCT_MON_LATENCY_HOP_COUNT; ++hop) {
+        assert(latency.hop_delta_ns[hop] == 0);
+    }
+    assert(acct_orders_mon_read_latency(mon_ctx, info.next_index, &latency) == ACCT_MON_ERR_NOT_FOUND);
+    assert(acct_orders_mon_read_latency(mon_ctx, 0, nullptr) == ACCT_MON_ERR_INVALID_PARAM);
+
     assert(acct_orders_mon_close(mon_ctx) == ACCT_MON_OK);
     assert(acct_destroy(order_ctx) == ACCT_OK);
     cleanup_shm_name(upstream_name);
     cleanup_shm_name(dated_orders_name);
 }
 
+TEST(poll_changes_returns_only_new_slots) {
+    constexpr const char* kTradingDay = "20260225";
+    const std::string upstream_name = unique_shm_name("acct_orders_mon_chg_upstream");
+    const std::string orders_base_name = unique_shm_name("acct_orders_mon_chg_orders");
+    const std::string dated_orders_name = make_orders_name(orders_base_name, kTradingDay);
+    cleanup_shm_name(upstream_name);
+    cleanup_shm_name(dated_orders_name);
+
+    acct_init_options_t init_options{};
+    init_options.upstream_shm_name = upstream_name.c_str();
+    init_options.orders_shm_name = orders_base_name.c_str();
+    init_options.trading_day = kTradingDay;
+    init_options.create_if_not_exist = 1;
+
+    acct_ctx_t order_ctx = nullptr;
+    assert(acct_init_ex(&init_options, &order_ctx) == ACCT_OK);
+
+    uint32_t first_id = 0;
+    assert(acct_submit_order(order_ctx, "000001", ACCT_SIDE_BUY, ACCT_MARKET_SZ, 100, 10.5, 0, &first_id) ==
+           ACCT_OK);
+
+    acct_orders_mon_options_t mon_options{};
+    mon_options.orders_shm_name = orders_base_name.c_str();
+    mon_options.trading_day = kTradingDay;
+    acct_orders_mon_ctx_t mon_ctx = nullptr;
+    assert(acct_orders_mon_open(&mon_options, &mon_ctx) == ACCT_MON_OK);
+
+    // 从当日起点读取能看到首笔；从 journal_cursor 起读取只看到之后的变更
+    acct_orders_mon_change_t changes[8]{};
+    std::size_t count = 0;
+    uint64_t from_start = 0;
+    assert(acct_orders_mon_poll_changes(mon_ctx, &from_start, changes, 8, &count) == ACCT_MON_OK);
+    assert(count >= 1);
+    assert(changes[count - 1].index == 0);
+
+    acct_orders_mon_info_t info{};
+    assert(acct_orders_mon_info(mon_ctx, &info) == ACCT_MON_OK);
+    assert(info.journal_cursor == from_start);
+    uint64_t cursor = info.journal_cursor;
+    assert(acct_orders_mon_poll_changes(mon_ctx, &cursor, changes, 8, &count) == ACCT_MON_OK);
+    assert(count == 0);
+
+    uint32_t second_id = 0;
+    assert(acct_submit_order(order_ctx, "000002", ACCT_SIDE_SELL, ACCT_MARKET_SZ, 200, 9.5, 0, &second_id) ==
+           ACCT_OK);
+    assert(acct_orders_mon_poll_changes(mon_ctx, &cursor, changes, 8, &count) == ACCT_MON_OK);
+    assert(count >= 1);
+    for (std::size_t i = 0; i < count; ++i) {
+        assert(changes[i].index == 1);
+    }
+
+    acct_orders_mon_snapshot_t snapshot{};
+    assert(acct_orders_mon_read(mon_ctx, changes[count - 1].index, &snapshot) == ACCT_MON_OK);
+    assert(snapshot.internal_order_id == second_id);
+    assert(static_cast<uint32_t>(snapshot.seq) == changes[count - 1].seq);
+    assert(acct_orders_mon_poll_changes(mon_ctx, nullptr, changes, 8, &count) == ACCT_MON_ERR_INVALID_PARAM);
+
+    assert(acct_orders_mon_close(mon_ctx) == ACCT_MON_OK);
+    assert(acct_destroy(order_ctx) == ACCT_OK);
+    cleanup_shm_name(upstream_name);
+    cleanup_shm_name(dated_orders_name);
+}
+
+TEST(read_range_returns_contiguous_snapshots) {
+    constexpr const char* kTradingDay = "20260225";
+    const std::string upstream_name = unique_shm_name("acct_orders_mon_range_upstream");
+    const std::string orders_base_name = unique_shm_name("acct_orders_mon_range_orders");
+    const std::string dated_orders_name = make_orders_name(orders_base_name, kTradingDay);
+    cleanup_shm_name(upstream_name);
+    cleanup_shm_name(dated_orders_name);
+
+    acct_init_options_t init_options{};
+    init_options.upstream_shm_name = upstream_name.c_str();
+    init_options.orders_shm_name = orders_base_name.c_str();
+    init_options.trading_day = kTradingDay;
+    init_options.create_if_not_exist = 1;
+
+    acct_ctx_t order_ctx = nullptr;
+    assert(acct_init_ex(&init_options, &order_ctx) == ACCT_OK);
+
+    uint32_t order_ids[3] = {};
+    for (uint32_t i = 0; i < 3; ++i) {
+        assert(acct_submit_order(order_ctx, "000001", ACCT_SIDE_BUY, ACCT_MARKET_SZ, 100 * (i + 1), 10.5, 0,
+                                 &order_ids[i]) == ACCT_OK);
+    }
+
+    acct_orders_mon_options_t mon_options{};
+    mon_options.orders_shm_name = orders_base_name.c_str();
+    mon_options.trading_day = kTradingDay;
+    acct_orders_mon_ctx_t mon_ctx = nullptr;
+    assert(acct_orders_mon_open(&mon_options, &mon_ctx) == ACCT_MON_OK);
+
+    // 稳定快照按索引升序紧凑输出；上下文预留块中尚未使用的槽位保持 Empty
+    acct_orders_mon_snapshot_t snapshots[8]{};
+    uint32_t unstable[8]{};
+    std::size_t count = 0;
+    std::size_t unstable_count = 0;
+    assert(acct_orders_mon_read_range(mon_ctx, 0, 8, snapshots, &count, unstable, &unstable_count) == ACCT_MON_OK);
+    assert(count == 8);
+    assert(unstable_count == 0);
+    for (uint32_t i = 0; i < 3; ++i) {
+        assert(snapshots[i].index == i);
+        assert(snapshots[i].internal_order_id == order_ids[i]);
+        assert(snapshots[i].volume_entrust == 100 * (i + 1));
+    }
+    for (uint32_t i = 3; i < 8; ++i) {
+        assert(snapshots[i].stage == ACCT_MON_STAGE_EMPTY);
+    }
+
+    // 销毁上下文归还未用尾部后，end 超过 next_index 时截断
+    assert(acct_destroy(order_ctx) == ACCT_OK);
+    order_ctx = nullptr;
+    assert(acct_orders_mon_read_range(mon_ctx, 0, 8, snapshots, &count, unstable, &unstable_count) == ACCT_MON_OK);
+    assert(count == 3);
+
+    assert(acct_orders_mon_read_range(mon_ctx, 1, 2, snapshots, &count, nullptr, nullptr) == ACCT_MON_OK);
+    assert(count == 1);
+    assert(snapshots[0].index == 1);
+    assert(acct_orders_mon_read_range(mon_ctx, 2, 1, snapshots, &count, nullptr, nullptr) ==
+           ACCT_MON_ERR_INVALID_PARAM);
+
+    assert(acct_orders_mon_close(mon_ctx) == ACCT_MON_OK);
+    cleanup_shm_name(upstream_name);
+    cleanup_shm_name(dated_orders_name);
+}
+
+TEST(query_walks_secondary_indices) {
+    constexpr const char* kTradingDay = "20260225";
+    const std::string upstream_name = unique_shm_name("acct_orders_mon_query_upstream");
+    const std::string orders_base_name = unique_shm_name("acct_orders_mon_query_orders");
+    const std::string dated_orders_name = make_orders_name(orders_base_name, kTradingDay);
+    const std::string index_name = acct_service::make_orders_index_shm_name(orders_base_name);
+    cleanup_shm_name(upstream_name);
+    cleanup_shm_name(dated_orders_name);
+    cleanup_shm_name(index_name);
+
+    acct_init_options_t init_options{};
+    init_options.upstream_shm_name = upstream_name.c_str();
+    init_options.orders_shm_name = orders_base_name.c_str();
+    init_options.trading_day = kTradingDay;
+    init_options.create_if_not_exist = 1;
+    acct_ctx_t order_ctx = nullptr;
+    assert(acct_init_ex(&init_options, &order_ctx) == ACCT_OK);
+    uint32_t order_ids[3] = {};
+    for (uint32_t i = 0; i < 3; ++i) {
+        assert(acct_submit_order(order_ctx, "000001", ACCT_SIDE_BUY, ACCT_MARKET_SZ, 100 * (i + 1), 10.5, 0,
+                                 &order_ids[i]) == ACCT_OK);
+    }
+
+    acct_orders_mon_options_t mon_options{};
+    mon_options.orders_shm_name = orders_base_name.c_str();
+    mon_options.trading_day = kTradingDay;
+    acct_orders_mon_ctx_t mon_ctx = nullptr;
+    assert(acct_orders_mon_open(&mon_options, &mon_ctx) == ACCT_MON_OK);
+
+    acct_orders_mon_query_t query{};
+    query.filters = ACCT_MON_QUERY_LIVE;
+    acct_orders_mon_snapshot_t snapshots[4]{};
+    std::size_t count = 0;
+    uint64_t cursor = 0;
+    assert(acct_orders_mon_query(mon_ctx, &query, &cursor, snapshots, 4, &count) == ACCT_MON_ERR_UNAVAILABLE);
+
+    // 账户服务侧的写端：0、1 属于 SZ.000001，2 属于 SH.600000；1 已终态
+    acct_service::SHMManager index_manager;
+    acct_service::orders_index_shm_layout* index =
+        index_manager.open_orders_index(index_name, acct_service::shm_mode::Create, 1);
+    assert(index != nullptr);
+    acct_service::orders_index_reset(index, 20260224);
+    assert(acct_orders_mon_query(mon_ctx, &query, &cursor, snapshots, 4, &count) == ACCT_MON_ERR_UNAVAILABLE);
+    acct_service::orders_index_reset(index, 20260225);
+    assert(acct_service::orders_index_add(index, 0, acct_service::InternalSecurityId("SZ.000001"), 1, true));
+    assert(acct_service::orders_index_add(index, 1, acct_service::InternalSecurityId("SZ.000001"), 2, false));
+    assert(acct_service::orders_index_add(index, 2, acct_service::InternalSecurityId("SH.600000"), 1, true));
+    assert(!acct_service::orders_index_add(index, 2, acct_service::InternalSecurityId("SH.600000"), 1, true));
+
+    // 仅在途：按索引升序，分页游标续读
+    assert(acct_orders_mon_query(mon_ctx, &query, &cursor, snapshots, 1, &count) == ACCT_MON_OK);
+    assert(count == 1 && snapshots[0].index == 0 && snapshots[0].internal_order_id == order_ids[0]);
+    assert(cursor != 0);
+    assert(acct_orders_mon_query(mon_ctx, &query, &cursor, snapshots, 4, &count) == ACCT_MON_OK);
+    assert(count == 1 && snapshots[0].index == 2);
+    assert(cursor == 0);
+
+    // 按证券：新单在前；叠加策略条件后只剩 0
+    query.filters = ACCT_MON_QUERY_SECURITY;
+    std::snprintf(query.internal_security_id, sizeof(query.internal_security_id), "%s", "SZ.000001");
+    assert(acct_orders_mon_query(mon_ctx, &query, &cursor, snapshots, 4, &count) == ACCT_MON_OK);
+    assert(count == 2 && snapshots[0].index == 1 && snapshots[1].index == 0);
+    query.filters = ACCT_MON_QUERY_SECURITY | ACCT_MON_QUERY_STRATEGY;
+    query.strategy_id = 1;
+    assert(acct_orders_mon_query(mon_ctx, &query, &cursor, snapshots, 4, &count) == ACCT_MON_OK);
+    assert(count == 1 && snapshots[0].index == 0);
+
+    // 按策略 + 在途
+    query.filters = ACCT_MON_QUERY_STRATEGY | ACCT_MON_QUERY_LIVE;
+    assert(acct_orders_mon_query(mon_ctx, &query, &cursor, snapshots, 4, &count) == ACCT_MON_OK);
+    assert(count == 2 && snapshots[0].index == 2 && snapshots[1].index == 0);
+
+    // 未登记证券为空结果；游标跨越重建返回 LAGGED
+    query.filters = ACCT_MON_QUERY_SECURITY;
+    std::snprintf(query.internal_security_id, sizeof(query.internal_security_id), "%s", "SH.600001");
+    assert(acct_orders_mon_query(mon_ctx, &query, &cursor, snapshots, 4, &count) == ACCT_MON_OK);
+    assert(count == 0 && cursor == 0);
+    query.filters = ACCT_MON_QUERY_STRATEGY;
+    assert(acct_orders_mon_query(mon_ctx, &query, &cursor, snapshots, 1, &count) == ACCT_MON_OK);
+    assert(cursor != 0);
+    acct_service::orders_index_reset(index, 20260225);
+    assert(acct_orders_mon_query(mon_ctx, &query, &cursor, snapshots, 1, &count) == ACCT_MON_ERR_LAGGED);
+    assert(cursor == 0);
+
+    query.filters = 0;
+    assert(acct_orders_mon_query(mon_ctx, &query, &cursor, snapshots, 4, &count) == ACCT_MON_ERR_INVALID_PARAM);
+
+    assert(acct_orders_mon_close(mon_ctx) == ACCT_MON_OK);
+    assert(acct_destroy(order_ctx) == ACCT_OK);
+    index_manager.close();
+    cleanup_shm_name(upstream_name);
+    cleanup_shm_name(dated_orders_name);
+    cleanup_shm_name(index_name);
+}
+
 TEST(read_not_found) {
     constexpr const char* kTradingDay = "20260225";
     const std::string upstream_name = unique_shm_name("acct_orders_mon_nf_upstream");
@@ -172,6 +410,71 @@ TEST(read_not_found) {
     cleanup_shm_name(dated_orders_name);
 }
 
+// 写端长期持有奇数 seq 时，读取在有界自旋 + 让出后返回 RETRY，不会无限等待
+TEST(read_retry_is_bounded) {
+    constexpr const char* kTradingDay = "20260225";
+    const std::string upstream_name = unique_shm_name("acct_orders_mon_rt_upstream");
+    const std::string orders_base_name = unique_shm_name("acct_orders_mon_rt_orders");
+    const std::string dated_orders_name = make_orders_name(orders_base_name, kTradingDay);
+    cleanup_shm_name(upstream_name);
+    cleanup_shm_name(dated_orders_name);
+
+    acct_init_options_t init_options{};
+    init_options.upstream_shm_name = upstream_name.c_str();
+    init_options.orders_shm_name = orders_base_name.c_str();
+    init_options.trading_day = kTradingDay;
+    init_options.create_if_not_exist = 1;
+
+    acct_ctx_t order_ctx = nullptr;
+    assert(acct_init_ex(&init_options, &order_ctx) == ACCT_OK);
+    uint32_t order_id = 0;
+    assert(acct_submit_order(order_ctx, "000001", ACCT_SIDE_BUY, ACCT_MARKET_SZ, 100, 10.5, 0, &order_id) == ACCT_OK);
+
+    const int fd = ::shm_open(dated_orders_name.c_str(), O_RDWR, 0);
+    assert(fd >= 0);
+    void* mapping = ::mmap(nullptr, acct_service::orders_shm_layout::total_size(), PROT_READ | PROT_WRITE,
+                           MAP_SHARED, fd, 0);
+    ::close(fd);
+    assert(mapping != MAP_FAILED);
+    auto* orders = static_cast<acct_service::orders_shm_layout*>(mapping);
+
+    acct_orders_mon_options_t mon_options{};
+    mon_options.orders_shm_name = orders_base_name.c_str();
+    mon_options.trading_day = kTradingDay;
+    mon_options.read_spin_count = 8;
+    mon_options.read_yield_count = 2;
+
+    acct_orders_mon_ctx_t mon_ctx = nullptr;
+    assert(acct_orders_mon_open(&mon_options, &mon_ctx) == ACCT_MON_OK);
+
+    acct_orders_mon_snapshot_t snapshot{};
+    orders->slots[0].seq.fetch_add(1, std::memory_order_acq_rel);
+    assert(acct_orders_mon_read(mon_ctx, 0, &snapshot) == ACCT_MON_ERR_RETRY);
+    orders->slots[0].seq.fetch_add(1, std::memory_order_acq_rel);
+    assert(acct_orders_mon_read(mon_ctx, 0, &snapshot) == ACCT_MON_OK);
+    assert(snapshot.internal_order_id == order_id);
+
+    // 网关出队只写进度字，读端合并；账户服务写入更后的阶段后以槽位为准
+    const acct_service::TimestampNs queued_ns = orders->header.create_time + 1000;
+    assert(acct_service::orders_shm_update_stage(orders, 0, acct_service::OrderSlotState::DownstreamQueued,
+                                                 queued_ns));
+    assert(acct_service::orders_shm_mark_downstream(orders, 0, acct_service::OrderSlotState::DownstreamDequeued,
+                                                    queued_ns + 500));
+    assert(acct_orders_mon_read(mon_ctx, 0, &snapshot) == ACCT_MON_OK);
+    assert(snapshot.stage == ACCT_MON_STAGE_DOWNSTREAM_DEQUEUED);
+    assert(snapshot.last_update_ns == queued_ns + 500);
+    assert(acct_service::orders_shm_update_stage(orders, 0, acct_service::OrderSlotState::Terminal, queued_ns + 900));
+    assert(acct_orders_mon_read(mon_ctx, 0, &snapshot) == ACCT_MON_OK);
+    assert(snapshot.stage == ACCT_MON_STAGE_TERMINAL);
+    assert(snapshot.last_update_ns == queued_ns + 900);
+
+    assert(acct_orders_mon_close(mon_ctx) == ACCT_MON_OK);
+    ::munmap(mapping, acct_service::orders_shm_layout::total_size());
+    assert(acct_destroy(order_ctx) == ACCT_OK);
+    cleanup_shm_name(upstream_name);
+    cleanup_shm_name(dated_orders_name);
+}
+
 TEST(rejects_file_backend_env) {
     ScopedEnvOverride env_override("SHM_USE_FILE", "1");
 
@@ -185,7 +488,11 @@ int main() {
 
     RUN_TEST(strerror);
     RUN_TEST(open_read_close);
+    RUN_TEST(poll_changes_returns_only_new_slots);
+    RUN_TEST(read_range_returns_contiguous_snapshots);
+    RUN_TEST(query_walks_secondary_indices);
     RUN_TEST(read_not_found);
+    RUN_TEST(read_retry_is_bounded);
     RUN_TEST(rejects_file_backend_env);
 
     printf("\n=== All tests passed! ===\n");
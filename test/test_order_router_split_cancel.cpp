@@ -41,7 +41,7 @@ std::unique_ptr<downstream_shm_layout> make_downstream() {
     downstream->header.version = SHMHeader::kVersion;
     downstream->header.create_time = now_ns();
     downstream->header.last_update = downstream->header.create_time;
-    downstream->header.next_order_id.store(1, std::memory_order_relaxed);
+    downstream->header.next_id_epoch.store(1, std::memory_order_relaxed);
     downstream->order_queue.init();
     return downstream;
 }
@@ -139,6 +139,64 @@ TEST(internal_child_cancel_fanout_tracks_parent) {
     }
 }
 
+// 数百笔在途子单的父单撤单：槽位一次连续预留，撤单整批入队、门铃只敲一次
+TEST(parent_cancel_fans_out_children_as_one_batch) {
+    auto book = std::make_unique<OrderBook>();
+    auto downstream = make_downstream();
+    auto orders = make_orders();
+    order_router router(*book, downstream.get(), orders.get());
+
+    const InternalOrderId parent_id = book->next_order_id();
+    OrderEntry parent = make_parent_entry(parent_id, 30000);
+    OrderIndex parent_index = kInvalidOrderIndex;
+    assert(orders_shm_append(orders.get(),
+        parent.request,
+        OrderSlotState::UpstreamDequeued,
+        order_slot_source_t::AccountInternal,
+        now_ns(),
+        parent_index));
+    parent.shm_order_index = parent_index;
+    assert(book->add_order(parent));
+
+    constexpr std::size_t kChildren = 300;
+    std::set<InternalOrderId> child_ids;
+    for (std::size_t i = 0; i < kChildren; ++i) {
+        OrderEntry child = make_child_entry(0, parent_id, 100);
+        assert(router.submit_internal_order(child));
+        child_ids.insert(child.request.internal_order_id);
+    }
+    OrderIndex drained = kInvalidOrderIndex;
+    while (downstream->order_queue.try_pop(drained)) {
+    }
+
+    // 人为登记一个等待者，使每次敲门铃都推进 seq
+    orders->header.gateway_doorbell.waiters.store(1, std::memory_order_relaxed);
+    const uint32_t bell_before = orders->header.gateway_doorbell.seq.load();
+    const OrderIndex next_before = orders->header.next_index.load();
+    const uint64_t sent_before = router.stats().orders_sent;
+    assert(router.route_cancel(parent_id, 0, 93100000));
+    assert(orders->header.gateway_doorbell.seq.load() == bell_before + 1);
+    assert(orders->header.next_index.load() == next_before + kChildren);
+    assert(router.stats().orders_sent == sent_before + kChildren);
+
+    std::vector<OrderIndex> indices(kChildren + 1);
+    assert(downstream->order_queue.try_pop_bulk(indices.data(), indices.size()) == kChildren);
+    for (std::size_t i = 0; i < kChildren; ++i) {
+        assert(indices[i] == next_before + static_cast<OrderIndex>(i));
+        order_slot_snapshot snapshot;
+        assert(orders_shm_read_snapshot(orders.get(), indices[i], snapshot));
+        assert(snapshot.stage == OrderSlotState::DownstreamQueued);
+        assert(snapshot.request.order_type == OrderType::Cancel);
+        assert(child_ids.erase(snapshot.request.orig_internal_order_id) == 1);
+        const OrderEntry* cancel = book->find_order(snapshot.request.internal_order_id);
+        assert(cancel != nullptr && cancel->parent_order_id == parent_id);
+        assert(cancel->request.order_state.load() == OrderState::TraderSubmitted);
+    }
+    assert(child_ids.empty());
+    const OrderEntry* parent_after = book->find_order(parent_id);
+    assert(parent_after->request.order_state.load() != OrderState::TraderError);
+}
+
 TEST(cancel_send_failure_latches_parent_error) {
     auto book = std::make_unique<OrderBook>();
     auto downstream = make_downstream();
@@ -210,11 +268,114 @@ TEST(cancel_send_failure_latches_parent_error) {
     assert(error_children >= 1);
 }
 
+// 内联模式：新单与撤单扇出都写入内联消息队列，消息字段与槽位一致，下标队列保持为空
+TEST(inline_downstream_mode_carries_order_payload) {
+    auto book = std::make_unique<OrderBook>();
+    auto downstream = make_downstream();
+    auto orders = make_orders();
+    order_router router(*book, downstream.get(), orders.get());
+    router.set_inline_downstream(true);
+
+    const InternalOrderId parent_id = book->next_order_id();
+    OrderEntry parent = make_parent_entry(parent_id, 180);
+    OrderIndex parent_index = kInvalidOrderIndex;
+    assert(orders_shm_append(orders.get(), parent.request, OrderSlotState::UpstreamDequeued,
+                             order_slot_source_t::AccountInternal, now_ns(), parent_index));
+    parent.shm_order_index = parent_index;
+    assert(book->add_order(parent));
+
+    const InternalOrderId child1_id = book->next_order_id();
+    const InternalOrderId child2_id = book->next_order_id();
+    OrderEntry child1 = make_child_entry(child1_id, parent_id, 100);
+    OrderEntry child2 = make_child_entry(child2_id, parent_id, 80);
+    assert(router.submit_internal_order(child1));
+    assert(router.submit_internal_order(child2));
+    assert(router.route_cancel(parent_id, book->next_order_id(), 93100000));
+    assert(downstream->order_queue.empty());
+
+    std::vector<downstream_order_message> messages;
+    downstream_order_message message{};
+    while (downstream->order_payload_queue.try_pop(message)) {
+        messages.push_back(message);
+    }
+    assert(messages.size() == 4);
+    for (std::size_t i = 0; i < 2; ++i) {
+        assert(messages[i].order_type == OrderType::New);
+        assert(messages[i].flags == 0);
+        assert(std::strcmp(messages[i].security_id, "000001") == 0);
+        assert(messages[i].internal_security_id.view() == "XSHE_000001");
+        assert(messages[i].market == Market::SZ && messages[i].dprice == 1000);
+        order_slot_snapshot snapshot;
+        assert(orders_shm_read_snapshot(orders.get(), messages[i].index, snapshot));
+        assert(snapshot.request.internal_order_id == messages[i].internal_order_id);
+        assert(snapshot.stage == OrderSlotState::DownstreamQueued);
+    }
+    assert(messages[0].internal_order_id == child1_id && messages[0].volume == 100);
+    assert(messages[1].internal_order_id == child2_id && messages[1].volume == 80);
+
+    std::set<InternalOrderId> cancelled;
+    for (std::size_t i = 2; i < messages.size(); ++i) {
+        assert(messages[i].order_type == OrderType::Cancel);
+        assert(messages[i].md_time == 93100000);
+        cancelled.insert(messages[i].orig_internal_order_id);
+    }
+    assert(cancelled == (std::set<InternalOrderId>{child1_id, child2_id}));
+}
+
+TEST(broker_accepted_child_cancel_uses_priority_queue) {
+    auto book = std::make_unique<OrderBook>();
+    auto downstream = make_downstream();
+    auto orders = make_orders();
+    order_router router(*book, downstream.get(), orders.get());
+
+    const InternalOrderId parent_id = book->next_order_id();
+    OrderEntry parent = make_parent_entry(parent_id, 180);
+    OrderIndex parent_index = kInvalidOrderIndex;
+    assert(orders_shm_append(orders.get(), parent.request, OrderSlotState::UpstreamDequeued,
+                             order_slot_source_t::AccountInternal, now_ns(), parent_index));
+    parent.shm_order_index = parent_index;
+    assert(book->add_order(parent));
+
+    const InternalOrderId child1_id = book->next_order_id();
+    const InternalOrderId child2_id = book->next_order_id();
+    OrderEntry child1 = make_child_entry(child1_id, parent_id, 100);
+    OrderEntry child2 = make_child_entry(child2_id, parent_id, 80);
+    assert(router.submit_internal_order(child1));
+    assert(router.submit_internal_order(child2));
+    OrderIndex sent_index = kInvalidOrderIndex;
+    assert(downstream->order_queue.try_pop(sent_index));
+    assert(downstream->order_queue.try_pop(sent_index));
+
+    // child1 已被柜台受理，撤单走优先队列；child2 仍在下游链路中，撤单排在普通队列
+    book->update_state(child1_id, OrderState::BrokerAccepted);
+    assert(router.route_cancel(parent_id, book->next_order_id(), 93100000));
+    assert(router.stats().priority_cancels == 1);
+
+    downstream_order_message message{};
+    assert(downstream->cancel_queue.try_pop(message));
+    assert(message.order_type == OrderType::Cancel);
+    assert(message.orig_internal_order_id == child1_id);
+    order_slot_snapshot snapshot;
+    assert(orders_shm_read_snapshot(orders.get(), message.index, snapshot));
+    assert(snapshot.request.internal_order_id == message.internal_order_id);
+    assert(snapshot.stage == OrderSlotState::DownstreamQueued);
+    assert(downstream->cancel_queue.empty());
+
+    assert(downstream->order_queue.try_pop(sent_index));
+    assert(orders_shm_read_snapshot(orders.get(), sent_index, snapshot));
+    assert(snapshot.request.order_type == OrderType::Cancel);
+    assert(snapshot.request.orig_internal_order_id == child2_id);
+    assert(downstream->order_queue.empty());
+}
+
 int main() {
     printf("=== Order Router Split Cancel Test Suite ===\n\n");
 
     RUN_TEST(internal_child_cancel_fanout_tracks_parent);
+    RUN_TEST(parent_cancel_fans_out_children_as_one_batch);
     RUN_TEST(cancel_send_failure_latches_parent_error);
+    RUN_TEST(inline_downstream_mode_carries_order_payload);
+    RUN_TEST(broker_accepted_child_cancel_uses_priority_queue);
 
     printf("\n=== All tests passed! ===\n");
     return 0;
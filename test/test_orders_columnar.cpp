@@ -0,0 +1,256 @@
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <cassert>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "api/order_api.h"
+#include "orders_columnar.hpp"
+
+#define TEST(name) static void test_##name()
+#define RUN_TEST(name)                   \
+    do {                                 \
+        printf("Running %s... ", #name); \
+        test_##name();                   \
+        printf("PASSED\n");              \
+    } while (0)
+
+namespace {
+
+using namespace acct_service;
+
+std::string unique_name(const char* prefix) {
+    const auto now_ns =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+            .count();
+    return std::string(prefix) + "_" + std::to_string(static_cast<unsigned long long>(now_ns));
+}
+
+std::string temp_file(const char* prefix) {
+    return (std::filesystem::temp_directory_path() / (unique_name(prefix) + ".ocol")).string();
+}
+
+void cleanup_shm_name(const std::string& name) {
+    if (::shm_unlink(name.c_str()) < 0 && errno != ENOENT) {
+        std::perror("shm_unlink");
+    }
+}
+
+void copy_text(char* out, std::size_t size, const std::string& text) {
+    std::memset(out, 0, size);
+    std::memcpy(out, text.data(), std::min(size, text.size()));
+}
+
+// 逐字段比较，避免比较结构体填充字节
+bool same_row(const acct_orders_mon_snapshot_t& lhs, const acct_orders_mon_snapshot_t& rhs) {
+    return lhs.index == rhs.index && lhs.seq == rhs.seq && lhs.last_update_ns == rhs.last_update_ns &&
+           lhs.stage == rhs.stage && lhs.source == rhs.source && lhs.order_type == rhs.order_type &&
+           lhs.passive_exec_algo == rhs.passive_exec_algo && lhs.trade_side == rhs.trade_side &&
+           lhs.market == rhs.market && lhs.order_status == rhs.order_status &&
+           lhs.active_strategy_claimed == rhs.active_strategy_claimed && lhs.execution_algo == rhs.execution_algo &&
+           lhs.execution_state == rhs.execution_state &&
+           std::memcmp(lhs.internal_security_id, rhs.internal_security_id, ACCT_MON_INTERNAL_SECURITY_ID_LEN) == 0 &&
+           lhs.internal_order_id == rhs.internal_order_id &&
+           lhs.orig_internal_order_id == rhs.orig_internal_order_id && lhs.md_time_driven == rhs.md_time_driven &&
+           lhs.md_time_entrust == rhs.md_time_entrust && lhs.md_time_cancel_sent == rhs.md_time_cancel_sent &&
+           lhs.md_time_cancel_done == rhs.md_time_cancel_done &&
+           lhs.md_time_broker_response == rhs.md_time_broker_response &&
+           lhs.md_time_market_response == rhs.md_time_market_response &&
+           lhs.md_time_traded_first == rhs.md_time_traded_first &&
+           lhs.md_time_traded_latest == rhs.md_time_traded_latest && lhs.volume_entrust == rhs.volume_entrust &&
+           lhs.volume_traded == rhs.volume_traded && lhs.volume_remain == rhs.volume_remain &&
+           lhs.target_volume == rhs.target_volume && lhs.working_volume == rhs.working_volume &&
+           lhs.schedulable_volume == rhs.schedulable_volume && lhs.dprice_entrust == rhs.dprice_entrust &&
+           lhs.dprice_traded == rhs.dprice_traded && lhs.dvalue_traded == rhs.dvalue_traded &&
+           lhs.dfee_estimate == rhs.dfee_estimate && lhs.dfee_executed == rhs.dfee_executed &&
+           lhs.broker_order_id_u64 == rhs.broker_order_id_u64 &&
+           std::memcmp(lhs.security_id, rhs.security_id, ACCT_MON_SECURITY_ID_LEN) == 0 &&
+           std::memcmp(lhs.broker_order_id, rhs.broker_order_id, ACCT_MON_BROKER_ORDER_ID_LEN) == 0;
+}
+
+std::vector<acct_orders_mon_snapshot_t> read_back(const std::string& path, orders_columnar_file_header* header) {
+    std::vector<acct_orders_mon_snapshot_t> rows;
+    std::string error;
+    assert(orders_columnar_read_file(
+        path, [&](const acct_orders_mon_snapshot_t& row) { rows.push_back(row); }, header, &error));
+    return rows;
+}
+
+}  // namespace
+
+TEST(round_trip_across_blocks) {
+    std::vector<acct_orders_mon_snapshot_t> rows;
+    for (uint32_t i = 0; i < 300; ++i) {
+        acct_orders_mon_snapshot_t row{};
+        row.index = i < 200 ? i * 2 : (1U << ACCT_MON_INDEX_SEGMENT_SHIFT) + i;  // 含跨段跳变
+        row.seq = 2 * (i % 7);
+        row.last_update_ns = 1'700'000'000'000'000'000ULL + (i % 5 == 0 ? 0 : i * 1000);
+        row.stage = static_cast<uint8_t>(i % 9);
+        row.source = static_cast<uint8_t>(1 + i % 2);
+        row.order_type = i % 50 == 49 ? 255 : 1;
+        row.trade_side = static_cast<uint8_t>(1 + i % 2);
+        row.market = static_cast<uint8_t>(1 + i % 4);
+        row.order_status = static_cast<uint8_t>(i * 37);
+        row.internal_order_id = (7U << 20) | row.index;
+        row.orig_internal_order_id = i % 10 == 9 ? row.internal_order_id - 3 : 0;
+        // 占满 16 字节、不带结尾 '\0' 的证券与内部证券 ID
+        copy_text(row.security_id, ACCT_MON_SECURITY_ID_LEN,
+                  i % 3 == 0 ? "600000" : (i % 3 == 1 ? "000001" : "0123456789ABCDEF"));
+        copy_text(row.internal_security_id, ACCT_MON_INTERNAL_SECURITY_ID_LEN,
+                  i % 3 == 0 ? "XSHG_600000" : (i % 3 == 1 ? "XSHE_000001" : "XSHE_0123456789A"));
+        row.md_time_entrust = 93000000 + i;
+        row.volume_entrust = 100ULL * (i + 1);
+        row.volume_traded = i % 4 == 0 ? row.volume_entrust : 0;
+        row.volume_remain = row.volume_entrust - row.volume_traded;
+        row.dprice_entrust = 1000 + i;
+        row.dvalue_traded = UINT64_MAX - i;
+        row.broker_order_id_u64 = i % 2 == 0 ? 880000000ULL + i : 0;
+        copy_text(row.broker_order_id, ACCT_MON_BROKER_ORDER_ID_LEN,
+                  i % 2 == 0 ? std::to_string(row.broker_order_id_u64) : "");
+        rows.push_back(row);
+    }
+
+    acct_orders_mon_info_t info{};
+    info.capacity = 1024;
+    std::memcpy(info.trading_day, "20260225", 9);
+    for (const orders_columnar_codec codec : {orders_columnar_codec::None, orders_columnar_codec::Zlib}) {
+        if (!orders_columnar_codec_available(codec)) {
+            continue;
+        }
+        const std::string path = temp_file("orders_columnar_round_trip");
+        orders_columnar_options options;
+        options.block_rows = 64;
+        options.codec = codec;
+        orders_columnar_writer writer;
+        std::string error;
+        assert(writer.open(path, info, options, &error));
+        for (const acct_orders_mon_snapshot_t& row : rows) {
+            assert(writer.append(row, &error));
+        }
+        assert(writer.close(&error));
+        assert(writer.stats().rows == rows.size());
+        assert(writer.stats().blocks == 5);
+        assert(writer.stats().stored_bytes == std::filesystem::file_size(path));
+        // 列编码本身已明显小于定长快照
+        assert(writer.stats().raw_bytes < rows.size() * sizeof(acct_orders_mon_snapshot_t) / 4);
+
+        orders_columnar_file_header header{};
+        const std::vector<acct_orders_mon_snapshot_t> decoded = read_back(path, &header);
+        assert(header.row_count == rows.size());
+        assert(header.block_count == 5);
+        assert(header.capacity == 1024);
+        assert(std::strcmp(header.trading_day, "20260225") == 0);
+        assert(decoded.size() == rows.size());
+        for (std::size_t i = 0; i < rows.size(); ++i) {
+            assert(same_row(decoded[i], rows[i]));
+        }
+        std::filesystem::remove(path);
+    }
+}
+
+TEST(rejects_corrupt_block) {
+    acct_orders_mon_info_t info{};
+    const std::string path = temp_file("orders_columnar_corrupt");
+    orders_columnar_options options;
+    options.codec = orders_columnar_codec::None;
+    orders_columnar_writer writer;
+    std::string error;
+    assert(writer.open(path, info, options, &error));
+    acct_orders_mon_snapshot_t row{};
+    row.stage = ACCT_MON_STAGE_TERMINAL;
+    row.volume_entrust = 100;
+    assert(writer.append(row, &error));
+    assert(writer.close(&error));
+
+    // 截掉最后一个字节：块长度与块头不符
+    std::filesystem::resize_file(path, std::filesystem::file_size(path) - 1);
+    std::size_t visited = 0;
+    assert(!orders_columnar_read_file(path, [&](const acct_orders_mon_snapshot_t&) { ++visited; }, nullptr, &error));
+    assert(visited == 0);
+    assert(!error.empty());
+    std::filesystem::remove(path);
+
+    orders_columnar_options invalid;
+    invalid.block_rows = 0;
+    assert(!writer.open(path, info, invalid, &error));
+}
+
+TEST(export_reads_live_pool_through_monitor_api) {
+    constexpr const char* kTradingDay = "20260225";
+    const std::string upstream_name = "/" + unique_name("acct_orders_export_upstream");
+    const std::string orders_base_name = "/" + unique_name("acct_orders_export_orders");
+    const std::string dated_orders_name = orders_base_name + "_" + kTradingDay;
+    cleanup_shm_name(upstream_name);
+    cleanup_shm_name(dated_orders_name);
+
+    acct_init_options_t init_options{};
+    init_options.upstream_shm_name = upstream_name.c_str();
+    init_options.orders_shm_name = orders_base_name.c_str();
+    init_options.trading_day = kTradingDay;
+    init_options.create_if_not_exist = 1;
+    acct_ctx_t order_ctx = nullptr;
+    assert(acct_init_ex(&init_options, &order_ctx) == ACCT_OK);
+    const char* securities[] = {"000001", "000002", "600000"};
+    constexpr uint32_t kOrders = 40;
+    for (uint32_t i = 0; i < kOrders; ++i) {
+        uint32_t order_id = 0;
+        assert(acct_submit_order(order_ctx, securities[i % 3], i % 2 == 0 ? ACCT_SIDE_BUY : ACCT_SIDE_SELL,
+                                 i % 3 == 2 ? ACCT_MARKET_SH : ACCT_MARKET_SZ, 100 * (i + 1), 10.5, 0,
+                                 &order_id) == ACCT_OK);
+    }
+
+    acct_orders_mon_options_t mon_options{};
+    mon_options.orders_shm_name = orders_base_name.c_str();
+    mon_options.trading_day = kTradingDay;
+    acct_orders_mon_ctx_t mon_ctx = nullptr;
+    assert(acct_orders_mon_open(&mon_options, &mon_ctx) == ACCT_MON_OK);
+
+    // 小批量、小块：覆盖多次批量读与多块写出；预留未用的 Empty 槽位不导出
+    const std::string path = temp_file("orders_columnar_export");
+    orders_columnar_export_options options;
+    options.read_batch = 7;
+    options.columnar.block_rows = 16;
+    orders_columnar_export_stats stats{};
+    std::string error;
+    assert(orders_columnar_export(mon_ctx, path, options, &stats, &error));
+    assert(stats.columnar.rows == kOrders);
+    assert(stats.columnar.blocks == 3);
+    assert(stats.slots_scanned >= kOrders);
+    assert(stats.unstable_lost == 0);
+
+    orders_columnar_file_header header{};
+    const std::vector<acct_orders_mon_snapshot_t> rows = read_back(path, &header);
+    assert(rows.size() == kOrders);
+    assert(std::strcmp(header.trading_day, kTradingDay) == 0);
+    for (uint32_t i = 0; i < kOrders; ++i) {
+        acct_orders_mon_snapshot_t expected{};
+        assert(acct_orders_mon_read(mon_ctx, rows[i].index, &expected) == ACCT_MON_OK);
+        assert(same_row(rows[i], expected));
+        assert(i == 0 || rows[i].index > rows[i - 1].index);
+        assert(std::strncmp(rows[i].security_id, securities[i % 3], 6) == 0);
+        assert(rows[i].volume_entrust == 100 * (i + 1));
+    }
+
+    std::filesystem::remove(path);
+    assert(acct_orders_mon_close(mon_ctx) == ACCT_MON_OK);
+    assert(acct_destroy(order_ctx) == ACCT_OK);
+    cleanup_shm_name(upstream_name);
+    cleanup_shm_name(dated_orders_name);
+}
+
+int main() {
+    printf("=== Orders Columnar Export Test Suite ===\n\n");
+
+    RUN_TEST(round_trip_across_blocks);
+    RUN_TEST(rejects_corrupt_block);
+    RUN_TEST(export_reads_live_pool_through_monitor_api);
+
+    printf("\n=== All tests passed! ===\n");
+    return 0;
+}
@@ -6,11 +6,21 @@
 #include <memory>
 #include <string>
 #include <string_view>
+#include <vector>
 
 #include <unistd.h>
 
 #include "common/constants.hpp"
+#include "common/security_code_table.hpp"
+#include "common/security_identity.hpp"
+#include "portfolio/account_info.hpp"
+#include "portfolio/position_csv_parser.hpp"
+#include "portfolio/position_loader.hpp"
 #include "portfolio/position_manager.hpp"
+#include "portfolio/security_master.hpp"
+#include "portfolio/entrust_record.hpp"
+#include "portfolio/position_persister.hpp"
+#include "portfolio/trade_record.hpp"
 
 #define TEST(name) static void test_##name()
 #define RUN_TEST(name)                                                                                                 \
@@ -74,11 +84,20 @@ std::unique_ptr<acct_service::positions_shm_layout> make_shm(uint32_t init_state
     return shm;
 }
 
-void assert_fund_row_fields(const position& fund_row, const fund_info& fund) {
-    assert(fund_total_asset_field(fund_row) == fund.total_asset);
-    assert(fund_available_field(fund_row) == fund.available);
-    assert(fund_frozen_field(fund_row) == fund.frozen);
-    assert(fund_market_value_field(fund_row) == fund.market_value);
+// 资金只存于 fund_row：工作副本与读者快照一致，第 0 行证券列不再承载资金。
+void assert_fund_block(const acct_service::positions_shm_layout& shm, const fund_info& fund) {
+    for (const fund_info* copy : {&shm.fund.working, &shm.fund.published}) {
+        assert(copy->total_asset == fund.total_asset);
+        assert(copy->available == fund.available);
+        assert(copy->frozen == fund.frozen);
+        assert(copy->market_value == fund.market_value);
+    }
+    assert((shm.fund.seq.load(std::memory_order_relaxed) & 1U) == 0U);
+    const position& fund_row = shm.positions[kFundPositionIndex];
+    assert(fund_row.available == 0);
+    assert(fund_row.volume_available_t0 == 0);
+    assert(fund_row.volume_available_t1 == 0);
+    assert(fund_row.volume_buy == 0);
 }
 
 // 生成临时持仓快照文件路径，避免并发测试互相覆盖。
@@ -190,7 +209,7 @@ TEST(initialize_sets_fund_row) {
     assert(fund.available == kExpectedInitialFund);
     assert(fund.frozen == 0);
     assert(fund.market_value == 0);
-    assert_fund_row_fields(fund_row, fund);
+    assert_fund_block(*shm, fund);
 }
 
 TEST(add_security_uses_internal_key_and_excludes_fund_row) {
@@ -238,8 +257,7 @@ TEST(fund_ops_write_into_fund_row) {
     assert(fund.frozen == 0);
     assert(fund.market_value == 50);
 
-    const position& fund_row = shm->positions[kFundPositionIndex];
-    assert_fund_row_fields(fund_row, fund);
+    assert_fund_block(*shm, fund);
 }
 
 TEST(add_position_requires_registered_security) {
@@ -321,6 +339,44 @@ TEST(sellable_volume_uses_t0_only) {
     }
 }
 
+// 句柄直接对应持仓行下标，字符串键与句柄两条路径必须落到同一行。
+TEST(security_handle_indexes_position_row) {
+    using namespace acct_service;
+
+    auto shm = make_shm(0);
+    PositionManager manager(shm.get());
+    assert(manager.initialize(1));
+
+    assert(manager.resolve_security_handle(InternalSecurityId("XSHE_000001")) == kInvalidSecurityHandle);
+    assert(manager.get_position(kInvalidSecurityHandle) == nullptr);
+    assert(!manager.add_position(kInvalidSecurityHandle, 100, 123, 1));
+
+    const InternalSecurityId first = manager.add_security("000001", "PingAn", Market::SZ);
+    const InternalSecurityId second = manager.add_security("600000", "PuFa", Market::SH);
+    const SecurityHandle first_handle = manager.resolve_security_handle(first);
+    const SecurityHandle second_handle = manager.resolve_security_handle(second);
+    assert(first_handle == kFirstSecurityPositionIndex);
+    assert(second_handle == kFirstSecurityPositionIndex + 1);
+    assert(manager.get_position(first_handle) == manager.get_position(first));
+    assert(manager.get_position(second_handle) == &shm->positions[second_handle]);
+
+    // 超出已分配行数的句柄视为无效
+    assert(manager.get_position(static_cast<SecurityHandle>(second_handle + 1)) == nullptr);
+
+    assert(manager.add_position(first_handle, 100, 123, 2));
+    assert(manager.get_position(first)->volume_buy == 100);
+    {
+        position* pos = manager.get_position_mut(first_handle);
+        position_lock guard(*pos);
+        pos->volume_available_t0 = 100;
+    }
+    assert(manager.get_sellable_volume(first_handle) == 100);
+    assert(manager.freeze_position(first_handle, 60, 3));
+    assert(manager.get_sellable_volume(first) == 40);
+    assert(manager.deduct_position(first_handle, 60, 6000, 4));
+    assert(manager.get_position(first)->volume_sell_traded == 60);
+}
+
 TEST(initialize_rebuilds_code_map_from_existing_rows) {
     using namespace acct_service;
 
@@ -344,6 +400,179 @@ TEST(initialize_rebuilds_code_map_from_existing_rows) {
     assert(manager.find_security_id("XSHG_600000").value_or(InternalSecurityId()) == std::string_view("XSHG_600000"));
 }
 
+TEST(security_code_table_interns_startup_codes) {
+    using namespace acct_service;
+
+    assert(is_six_digit_code("000001"));
+    assert(is_six_digit_code("600000"));
+    assert(!is_six_digit_code("00700"));
+    assert(!is_six_digit_code("00000:"));
+    assert(!is_six_digit_code("0000/1"));
+    assert(!is_six_digit_code("A00001"));
+
+    InternalSecurityId built;
+    assert(build_internal_security_id(Market::SH, "600000", built));
+    assert(built == std::string_view("XSHG_600000"));
+    assert(build_internal_security_id(Market::HK, "00700", built));
+    assert(built == std::string_view("XHKG_00700"));
+
+    std::vector<std::pair<InternalSecurityId, SecurityHandle>> entries;
+    for (uint32_t code = 0; code < 4000; ++code) {
+        char text[8];
+        std::snprintf(text, sizeof(text), "%06u", code * 7);
+        InternalSecurityId security_id;
+        assert(build_internal_security_id(code % 2 == 0 ? Market::SZ : Market::SH, text, security_id));
+        entries.emplace_back(security_id, static_cast<SecurityHandle>(code + 1));
+    }
+    security_code_table table;
+    assert(table.build(entries));
+    assert(table.size() == entries.size());
+    for (const auto& [security_id, handle] : entries) {
+        assert(table.find(security_id) == handle);
+    }
+    assert(table.find(InternalSecurityId("XSHE_999999")) == kInvalidSecurityHandle);
+
+    // 终止符之后的残留字节不影响命中
+    InternalSecurityId reused("XSHG_600000_LEGACY");
+    reused.assign(entries[1].first.view());
+    assert(table.find(reused) == entries[1].second);
+
+    // 重复键无法构造，表置空后全部回落慢路径
+    entries.push_back(entries.front());
+    assert(!table.build(entries));
+    assert(table.find(entries.front().first) == kInvalidSecurityHandle);
+
+    // 启动装载后的键走表，运行期新增证券走慢路径，句柄一致
+    auto shm = make_shm(1);
+    shm->position_count.store(1, std::memory_order_relaxed);
+    shm->positions[1].id.assign("SZ.000001");
+    PositionManager manager(shm.get());
+    assert(manager.initialize(1));
+    assert(manager.resolve_security_handle(InternalSecurityId("XSHE_000001")) == kFirstSecurityPositionIndex);
+    assert(manager.resolve_security_handle(InternalSecurityId("SZ.000001")) == kFirstSecurityPositionIndex);
+    const InternalSecurityId added = manager.add_security("600000", "PuFa", Market::SH);
+    assert(manager.resolve_security_handle(added) == kFirstSecurityPositionIndex + 1);
+}
+
+TEST(traded_turnover_is_incremental_and_rebuilt_on_attach) {
+    using namespace acct_service;
+
+    auto shm = make_shm(0);
+    {
+        PositionManager manager(shm.get());
+        assert(manager.initialize(1));
+        assert(manager.traded_turnover() == 0);
+        const InternalSecurityId security = manager.add_security("000001", "PingAn", Market::SZ);
+        const SecurityHandle handle = manager.resolve_security_handle(security);
+        assert(manager.add_position(handle, 100, 123, 1));
+        assert(manager.traded_turnover() == 12300);
+        {
+            position* pos = manager.get_position_mut(handle);
+            position_lock guard(*pos);
+            pos->volume_available_t0 = 100;
+        }
+        assert(manager.deduct_position(handle, 40, 5000, 2));
+        assert(manager.traded_turnover() == 17300);
+    }
+
+    // 复用已初始化的共享内存：从 positions 行扫描重建，而非从零开始
+    PositionManager reattached(shm.get());
+    assert(reattached.initialize(1));
+    assert(reattached.traded_turnover() == 17300);
+}
+
+// 成交时增量维护平均成本与已实现盈亏；盯市只回写有变化的行，成交后按上次盯市价即时刷新浮动盈亏。
+TEST(pnl_tracks_average_cost_and_mark_to_market) {
+    using namespace acct_service;
+
+    auto shm = make_shm(0);
+    PositionManager manager(shm.get());
+    assert(manager.initialize(1));
+    const InternalSecurityId security = manager.add_security("000001", "PingAn", Market::SZ);
+    const SecurityHandle handle = manager.resolve_security_handle(security);
+    position* pos = manager.get_position_mut(handle);
+    {
+        // 装载的隔夜仓没有成本，由首笔成交价补记
+        position_lock guard(*pos);
+        pos->volume_available_t0 = 1000;
+    }
+
+    assert(manager.add_position(handle, 100, 50, 1, 10));
+    assert(pos->cost_basis == 1000 * 50 + 100 * 50 + 10);
+    assert(pos->cost_volume == 1100);
+    assert(pos->realized_pnl == 0);
+    assert(pos->mark_price == 0 && pos->unrealized_pnl == 0);
+
+    // 卖出按平均成本结转：55010 * 200 / 1100 = 10001
+    assert(manager.freeze_position(handle, 200, 2));
+    assert(manager.deduct_position(handle, 200, 12000, 2, 12));
+    assert(pos->cost_basis == 55010 - 10001);
+    assert(pos->cost_volume == 900);
+    assert(pos->realized_pnl == 12000 - 12 - 10001);
+
+    std::vector<DPrice> marks(manager.position_count() + kFirstSecurityPositionIndex, 0);
+    marks[handle] = 70;
+    assert(manager.mark_to_market(marks) == 1);
+    assert(pos->mark_price == 70);
+    assert(pos->unrealized_pnl == 900 * 70 - 45009);
+    assert(manager.mark_to_market(marks) == 0);
+
+    assert(manager.add_position(handle, 100, 70, 3));
+    assert(pos->cost_basis == 45009 + 7000);
+    assert(pos->unrealized_pnl == 1000 * 70 - 52009);
+
+    // 价格为 0 的行保留上次盯市结果
+    marks[handle] = 0;
+    assert(manager.mark_to_market(marks) == 0);
+    assert(pos->mark_price == 70);
+
+    // 卖出全部 t0 后成本只剩当日买入的 t1：52009 * 800 / 1000 = 41607
+    assert(manager.freeze_position(handle, 800, 4));
+    assert(manager.deduct_position(handle, 800, 800 * 65, 4));
+    assert(pos->cost_volume == 200);
+    assert(pos->cost_basis == 52009 - 41607);
+    assert(pos->realized_pnl == 1987 + 800 * 65 - 41607);
+    assert(pos->unrealized_pnl == 200 * 70 - 10402);
+}
+
+TEST(position_csv_parser_reports_rows_and_error_line) {
+    using namespace acct_service;
+
+    // 行长跨越多个 16 字节块，覆盖向量化扫描与尾部标量路径
+    const std::string text =
+        "RECORD_TYPE,internal_security_id,name,t0,t1,vb,db,vbt,dbt,vs,ds,vst,dst,count_order\r\n"
+        "# comment line\n"
+        "\n"
+        "Position, SZ.000001 ,PAYH,100,0,0,0,0,0,0,0,0,0,1\n"
+        "position,XSHG_600000,,12345678901234,2,3,4,5,6,7,8,9,10,11";
+    std::vector<position_seed_row> rows;
+    std::size_t error_line = 0;
+    position_csv_timings timings;
+    assert(parse_position_csv(text, rows, error_line, &timings));
+    assert(rows.size() == 2);
+    assert(rows[0].security_id == std::string_view("XSHE_000001"));
+    assert(rows[0].name.view() == "PAYH");
+    assert(rows[0].count_order == 1);
+    assert(rows[1].name.empty());
+    assert(rows[1].volume_available_t0 == 12345678901234ULL);
+    assert(rows[1].count_order == 11);
+    assert(timings.rows == 2);
+    assert(timings.bytes == text.size());
+
+    rows.clear();
+    assert(!parse_position_csv("position,SZ.000001,,1,0,0,0,0,0,0,0,0,0,0\nposition,SZ.000002,,x,0,0,0,0,0,0,0,0,0,0\n",
+                               rows, error_line));
+    assert(error_line == 2);
+    assert(rows.size() == 1);
+    assert(!parse_position_csv("position,SZ.000003,,1,0,0\n", rows, error_line));
+    assert(error_line == 1);
+    assert(!parse_position_csv("fund,1,2,3\n", rows, error_line));
+
+    bool exists = true;
+    assert(load_position_csv(unique_seed_path("acct_missing_csv") + ".positions.csv", rows, exists, timings));
+    assert(!exists);
+}
+
 TEST(initialize_uses_loader_only_for_uninitialized_shm) {
     using namespace acct_service;
 
@@ -455,6 +684,500 @@ TEST(initialize_loads_from_sqlite_when_db_enabled) {
     std::remove(db_path.c_str());
 }
 
+// 数千行持仓走批量路径：读事务内暂存后一次性写入，行顺序与证券索引保持一致。
+TEST(initialize_bulk_loads_large_sqlite_snapshot) {
+    using namespace acct_service;
+
+    constexpr int kRows = 5000;
+    const std::string db_path = unique_db_path("acct_pos_bulk_db");
+    sqlite_db_ptr db(nullptr, sqlite3_close);
+    assert(open_sqlite_rw(db_path, db));
+    assert(init_position_loader_schema(db.get()));
+    assert(exec_sql(db.get(),
+        "INSERT INTO account_info(account_id,total_assets,available_cash,frozen_cash,position_value) "
+        "VALUES (1,200000000,150000000,0,50000000);"));
+    assert(exec_sql(db.get(), "BEGIN;"));
+    for (int i = 0; i < kRows; ++i) {
+        const std::string code = std::to_string(600000 + i);
+        assert(exec_sql(db.get(),
+            "INSERT INTO positions(security_id,internal_security_id,volume_available_t0,count_order) VALUES ('" +
+                code + "','SH." + code + "'," + std::to_string(i + 1) + ",1);"));
+    }
+    assert(exec_sql(db.get(), "COMMIT;"));
+    db.reset();
+
+    auto shm = make_shm(0);
+    PositionManager manager(shm.get(), "", db_path, true);
+    assert(manager.initialize(1));
+    assert(manager.position_count() == static_cast<std::size_t>(kRows));
+
+    const position* first = manager.get_position(InternalSecurityId("XSHG_600000"));
+    assert(first != nullptr);
+    assert(first->volume_available_t0 == 1);
+    assert(first == &shm->positions[kFirstSecurityPositionIndex]);
+    const position* last = manager.get_position(InternalSecurityId("XSHG_604999"));
+    assert(last != nullptr);
+    assert(last->volume_available_t0 == static_cast<uint64_t>(kRows));
+    assert(last == &shm->positions[kFirstSecurityPositionIndex + kRows - 1]);
+    assert(last->name.view() == std::string_view("XSHG_604999"));
+
+    std::remove(db_path.c_str());
+}
+
+// 费率表按账户费率预计算：整数定点 + 各项四舍五入，卖方向加印花税，批量与逐笔结果一致。
+TEST(fee_table_precomputes_account_rates) {
+    using namespace acct_service;
+
+    constexpr fee_table kDefaults = fee_table::from_rates(0.0003, 0.001, 0.00002, 500);
+    static_assert(kDefaults.calculate(Market::SZ, TradeSide::Buy, 100000) == 500 + 2);
+    static_assert(kDefaults.calculate(Market::SH, TradeSide::Sell, 10000000) == 3000 + 200 + 10000);
+
+    const account_info defaults;
+    assert(defaults.calculate_fee(TradeSide::Buy, 100000) == 502);
+    assert(defaults.calculate_fee(Market::Unknown, TradeSide::Sell, 10000000) == 13200);
+    assert(defaults.calculate_fee(TradeSide::NotSet, 0) == 500);
+
+    const fee_quote quotes[] = {
+        {Market::SZ, TradeSide::Buy, 2000000}, {Market::SH, TradeSide::Sell, 2000000}, {Market::BJ, TradeSide::Sell, 1}};
+    DValue fees[3] = {};
+    defaults.calculate_fees(quotes, 3, fees);
+    for (std::size_t i = 0; i < 3; ++i) {
+        assert(fees[i] == defaults.calculate_fee(quotes[i].market, quotes[i].side, quotes[i].traded_value));
+    }
+    assert(fees[1] == fees[0] + 2000);
+
+    const std::string config_path = unique_seed_path("account_fee") + ".ini";
+    {
+        std::ofstream out(config_path);
+        out << "[account]\ncommission_rate = 0.0001\nmin_commission = 100\nstamp_tax_rate = 0.0005\n";
+    }
+    account_info_manager manager;
+    assert(manager.load_from_config(config_path));
+    assert(manager.info().calculate_fee(TradeSide::Buy, 100000) == 100 + 2);
+    assert(manager.info().calculate_fee(TradeSide::Sell, 10000000) == 1000 + 200 + 5000);
+    std::remove(config_path.c_str());
+}
+
+// 成交记录池：指针整日稳定，按订单/证券链表按添加顺序遍历，重复 trade_id 改用自增号，池满拒绝追加。
+TEST(trade_records_use_fixed_arena_and_intrusive_chains) {
+    using namespace acct_service;
+
+    trade_record_manager manager(4);
+    assert(manager.capacity() == 4);
+
+    auto make_trade = [](uint64_t trade_id, InternalOrderId order_id, const char* security_id, DValue value) {
+        trade_record record{};
+        record.trade_id = trade_id;
+        record.order_id = order_id;
+        record.security_id = InternalSecurityId(security_id);
+        record.side = TradeSide::Buy;
+        record.value = value;
+        record.fee = value / 100;
+        return record;
+    };
+
+    assert(manager.add_trade(make_trade(10, 1, "XSHE_000001", 1000)));
+    const trade_record* first = manager.find_trade(10);
+    assert(first != nullptr);
+    assert(manager.add_trade(make_trade(10, 2, "XSHG_600000", 2000)));
+    assert(manager.add_trade(make_trade(0, 1, "XSHG_600000", 3000)));
+    assert(manager.add_trade(make_trade(20, 1, "XSHE_000001", 4000)));
+    assert(!manager.add_trade(make_trade(30, 3, "XSHE_000001", 5000)));
+    assert(manager.find_trade(10) == first);
+    assert(manager.find_trade(11) != nullptr && manager.find_trade(11)->order_id == 2);
+    assert(manager.find_trade(12) != nullptr && manager.find_trade(12)->value == 3000);
+    assert(manager.find_trade(30) == nullptr);
+
+    std::vector<uint64_t> ids;
+    manager.for_each_trade_by_order(1, [&ids](const trade_record& record) { ids.push_back(record.trade_id); });
+    assert((ids == std::vector<uint64_t>{10, 12, 20}));
+    ids.clear();
+    manager.for_each_trade_by_security(InternalSecurityId("XSHG_600000"),
+                                       [&ids](const trade_record& record) { ids.push_back(record.trade_id); });
+    assert((ids == std::vector<uint64_t>{11, 12}));
+    ids.clear();
+    manager.for_each_trade_by_order(99, [&ids](const trade_record& record) { ids.push_back(record.trade_id); });
+    assert(ids.empty());
+
+    assert(manager.trade_count() == 4);
+    assert(manager.total_traded_value() == 10000);
+    assert(manager.total_fee() == 100);
+
+    assert(manager.load_today_trades("", 1));
+    assert(manager.trade_count() == 0 && manager.total_traded_value() == 0);
+    assert(manager.find_trade(10) == nullptr);
+    assert(manager.add_trade(make_trade(0, 5, "XSHE_000001", 1)));
+    assert(manager.find_trade(1) != nullptr);
+}
+
+// 成交库：记录直接写入文件映射，重建管理器后顺序扫描恢复索引、合计与自增编号；账户或交易日不符时拒绝打开。
+TEST(trade_store_survives_manager_restart) {
+    using namespace acct_service;
+
+    const std::string dir = unique_seed_path("trade_store");
+    auto make_trade = [](uint64_t trade_id, InternalOrderId order_id, const char* security_id, DValue value) {
+        trade_record record{};
+        record.trade_id = trade_id;
+        record.order_id = order_id;
+        record.security_id = InternalSecurityId(security_id);
+        record.side = TradeSide::Sell;
+        record.value = value;
+        record.fee = 1;
+        return record;
+    };
+
+    {
+        trade_record_manager manager(8);
+        assert(manager.open_store(dir, 7, "20260105"));
+        assert(manager.store_open());
+        assert(manager.add_trade(make_trade(5, 1, "XSHE_000001", 100)));
+        assert(manager.add_trade(make_trade(5, 2, "XSHG_600000", 200)));
+        assert(manager.add_trade(make_trade(0, 1, "XSHG_600000", 300)));
+        assert(manager.memory().reserved_bytes >= 8 * sizeof(trade_record));
+    }
+
+    const std::string path = trade_store_path(dir, 7, "20260105");
+    std::vector<uint64_t> ids;
+    std::size_t records = 0;
+    assert(trade_store_read(path, [&ids](const trade_record& record) { ids.push_back(record.trade_id); }, &records));
+    assert(records == 3);
+    assert((ids == std::vector<uint64_t>{5, 6, 7}));
+
+    trade_record_manager restarted(8);
+    assert(restarted.open_store(dir, 7, "20260105"));
+    assert(restarted.load_today_trades("", 7));
+    assert(restarted.trade_count() == 3);
+    assert(restarted.total_traded_value() == 600 && restarted.total_fee() == 3);
+    assert(restarted.find_trade(6) != nullptr && restarted.find_trade(6)->order_id == 2);
+    ids.clear();
+    restarted.for_each_trade_by_order(1, [&ids](const trade_record& record) { ids.push_back(record.trade_id); });
+    assert((ids == std::vector<uint64_t>{5, 7}));
+    assert(restarted.add_trade(make_trade(0, 3, "XSHE_000001", 400)));
+    assert(restarted.find_trade(8) != nullptr);
+    ids.clear();
+    restarted.for_each_trade_by_security(InternalSecurityId("XSHE_000001"),
+                                         [&ids](const trade_record& record) { ids.push_back(record.trade_id); });
+    assert((ids == std::vector<uint64_t>{5, 8}));
+    assert(trade_store_read(path, [](const trade_record&) {}, &records) && records == 4);
+
+    trade_record_manager other_account(8);
+    std::filesystem::copy_file(path, trade_store_path(dir, 8, "20260105"));
+    assert(!other_account.open_store(dir, 8, "20260105"));
+    assert(!other_account.store_open());
+    assert(other_account.add_trade(make_trade(0, 1, "XSHE_000001", 1)));
+
+    std::error_code ec;
+    std::filesystem::remove_all(dir, ec);
+}
+
+// 委托活跃链表：状态迁移时摘挂，终结后再变回活跃会重新挂到链尾；池满时新委托被拒绝，已有委托仍可更新。
+TEST(entrust_records_track_active_set_on_state_transitions) {
+    using namespace acct_service;
+
+    entrust_record_manager manager(3);
+
+    auto make_entrust = [](InternalOrderId order_id, const char* security_id, OrderState status) {
+        entrust_record record{};
+        record.order_id = order_id;
+        record.security_id = InternalSecurityId(security_id);
+        record.status = status;
+        return record;
+    };
+    auto active_ids = [&manager]() {
+        std::vector<InternalOrderId> ids;
+        manager.for_each_active_entrust([&ids](const entrust_record& record) { ids.push_back(record.order_id); });
+        return ids;
+    };
+
+    assert(manager.add_or_update(make_entrust(1, "XSHE_000001", OrderState::TraderSubmitted)));
+    assert(manager.add_or_update(make_entrust(2, "XSHG_600000", OrderState::BrokerAccepted)));
+    assert(manager.add_or_update(make_entrust(3, "XSHE_000001", OrderState::TraderRejected)));
+    assert(!manager.add_or_update(make_entrust(4, "XSHE_000001", OrderState::TraderSubmitted)));
+    const entrust_record* first = manager.find_entrust(1);
+    assert(manager.entrust_count() == 3 && manager.active_count() == 2);
+    assert((active_ids() == std::vector<InternalOrderId>{1, 2}));
+
+    assert(manager.add_or_update(make_entrust(1, "XSHE_000001", OrderState::Finished)));
+    assert(manager.find_entrust(1) == first && first->status == OrderState::Finished);
+    assert(manager.active_count() == 1);
+    assert((active_ids() == std::vector<InternalOrderId>{2}));
+
+    assert(manager.add_or_update(make_entrust(1, "XSHE_000001", OrderState::MarketAccepted)));
+    assert(manager.add_or_update(make_entrust(2, "XSHG_600000", OrderState::MarketAccepted)));
+    assert((active_ids() == std::vector<InternalOrderId>{2, 1}));
+
+    std::vector<InternalOrderId> by_security;
+    manager.for_each_entrust_by_security(InternalSecurityId("XSHE_000001"), [&by_security](const entrust_record& record) {
+        by_security.push_back(record.order_id);
+    });
+    assert((by_security == std::vector<InternalOrderId>{1, 3}));
+
+    assert(manager.load_today_entrusts("", 1));
+    assert(manager.entrust_count() == 0 && manager.active_count() == 0);
+    assert(active_ids().empty());
+    assert(manager.find_entrust(2) == nullptr);
+}
+
+// 二进制持仓镜像：整池导出后 fresh SHM 一次装载，checksum 或账户不符时拒绝启动，镜像缺失回到常规 loader。
+TEST(initialize_loads_binary_position_snapshot) {
+    using namespace acct_service;
+
+    auto source_shm = make_shm(0);
+    PositionManager source(source_shm.get());
+    assert(source.initialize(7));
+    constexpr std::size_t kRows = kMaxPositions - kFirstSecurityPositionIndex;
+    for (std::size_t i = 0; i < kRows; ++i) {
+        const InternalSecurityId added = source.add_security(std::to_string(600000 + i), "", Market::SH);
+        assert(!added.empty());
+        position* pos = source.get_position_mut(added);
+        assert(pos != nullptr);
+        pos->volume_available_t0 = i + 1;
+    }
+    assert(source.freeze_fund(5000, 1));
+
+    const std::string snapshot_path = unique_seed_path("position_snapshot") + ".bin";
+    assert(write_position_snapshot(snapshot_path, 7, *source_shm));
+
+    auto shm = make_shm(0);
+    PositionManager manager(shm.get(), "", "", false, snapshot_path);
+    assert(manager.initialize(7));
+    assert(manager.position_count() == kRows);
+    assert(manager.get_fund_info().frozen == 5000);
+    const position* last = manager.get_position(InternalSecurityId("XSHG_608190"));
+    assert(last != nullptr);
+    assert(last->volume_available_t0 == kRows);
+    assert(manager.resolve_security_handle(InternalSecurityId("XSHG_600000")) == kFirstSecurityPositionIndex);
+    assert(shm->changes.version.load(std::memory_order_relaxed) != 0);
+
+    auto other_account_shm = make_shm(0);
+    PositionManager other_account(other_account_shm.get(), "", "", false, snapshot_path);
+    assert(!other_account.initialize(8));
+
+    // 篡改行区任一字节都会被 checksum 拦下
+    {
+        std::fstream file(snapshot_path, std::ios::in | std::ios::out | std::ios::binary);
+        file.seekp(-1, std::ios::end);
+        file.put('\x7f');
+    }
+    auto corrupt_shm = make_shm(0);
+    PositionManager corrupt(corrupt_shm.get(), "", "", false, snapshot_path);
+    assert(!corrupt.initialize(7));
+
+    std::remove(snapshot_path.c_str());
+    auto fallback_shm = make_shm(0);
+    PositionManager fallback(fallback_shm.get(), "", "", false, snapshot_path);
+    assert(fallback.initialize(7));
+    assert(fallback.position_count() == 0);
+    assert(fallback.get_fund_info().available == kExpectedInitialFund);
+}
+
+// 镜像属于更早的交易日时装载即日切：卖出冻结与昨日买入转为可卖，当日量额与申报流量清零，成本保留，资金冻结释放；
+// 同日镜像原样装载。
+TEST(snapshot_from_previous_day_rolls_positions_on_load) {
+    using namespace acct_service;
+
+    auto source_shm = make_shm(0);
+    PositionManager source(source_shm.get());
+    assert(source.initialize(7));
+    const InternalSecurityId added = source.add_security("600000", "", Market::SH);
+    assert(!added.empty());
+    position* pos = source.get_position_mut(added);
+    assert(pos != nullptr);
+    pos->volume_available_t0 = 1000;
+    assert(source.add_position(added, 300, 1000, 1));
+    assert(source.freeze_position(added, 200, 2));
+    pos->count_order = 3;
+    pos->count_cancel = 1;
+    pos->count_fill = 2;
+    const uint64_t cost_basis = pos->cost_basis;
+    const uint64_t cost_volume = pos->cost_volume;
+    assert(cost_basis != 0);
+    const fund_info source_fund = source.get_fund_info();
+    assert(source.freeze_fund(5000, 3));
+
+    const std::string snapshot_path = unique_seed_path("position_snapshot_roll") + ".bin";
+    assert(write_position_snapshot(snapshot_path, 7, *source_shm, 20240102));
+
+    auto same_day_shm = make_shm(0);
+    PositionManager same_day(same_day_shm.get(), "", "", false, snapshot_path, 20240102);
+    assert(same_day.initialize(7));
+    const position* kept = same_day.get_position(InternalSecurityId("XSHG_600000"));
+    assert(kept != nullptr);
+    assert(kept->volume_available_t0 == 800 && kept->volume_available_t1 == 300 && kept->volume_sell == 200);
+    assert(same_day.get_fund_info().frozen == 5000);
+
+    auto next_day_shm = make_shm(0);
+    PositionManager next_day(next_day_shm.get(), "", "", false, snapshot_path, 20240103);
+    assert(next_day.initialize(7));
+    const position* rolled = next_day.get_position(InternalSecurityId("XSHG_600000"));
+    assert(rolled != nullptr);
+    assert(rolled->volume_available_t0 == 1300);
+    assert(rolled->volume_available_t1 == 0 && rolled->volume_sell == 0);
+    assert(rolled->volume_buy == 0 && rolled->volume_buy_traded == 0 && rolled->volume_sell_traded == 0);
+    assert(rolled->dvalue_buy == 0 && rolled->dvalue_buy_traded == 0);
+    assert(rolled->count_order == 0 && rolled->count_cancel == 0 && rolled->count_fill == 0);
+    assert(rolled->cost_basis == cost_basis && rolled->cost_volume == cost_volume);
+    assert(next_day.get_sellable_volume(InternalSecurityId("XSHG_600000")) == 1300);
+    const fund_info rolled_fund = next_day.get_fund_info();
+    assert(rolled_fund.frozen == 0 && rolled_fund.available == source_fund.available);
+
+    std::remove(snapshot_path.c_str());
+}
+
+// write-behind：运行期资金与持仓变更由后台线程合并写回数据库，重新加载后与内存一致。
+TEST(persister_writes_dirty_rows_back_to_sqlite) {
+    using namespace acct_service;
+
+    const std::string db_path = unique_db_path("acct_pos_persist_db");
+    sqlite_db_ptr db(nullptr, sqlite3_close);
+    assert(open_sqlite_rw(db_path, db));
+    assert(init_position_loader_schema(db.get()));
+    assert(exec_sql(db.get(),
+        "INSERT INTO account_info(account_id,total_assets,available_cash,frozen_cash,position_value) "
+        "VALUES (1,200000000,150000000,0,50000000);"));
+    assert(exec_sql(db.get(),
+        "INSERT INTO positions(security_id,internal_security_id,volume_available_t0) VALUES ('000001','SZ.000001',500);"));
+    db.reset();
+
+    auto shm = make_shm(0);
+    PositionManager manager(shm.get(), "", db_path, true);
+    assert(manager.initialize(1));
+
+    position_persister persister;
+    assert(persister.start(db_path, 1, shm.get(), 5));
+    assert(manager.freeze_fund(1000000, 11));
+    assert(manager.freeze_position(InternalSecurityId("XSHE_000001"), 200, 12));
+    const InternalSecurityId added = manager.add_security("600000", "XSHG_600000", Market::SH);
+    assert(!added.empty());
+    assert(manager.add_position(added, 300, 1000, 13));
+    persister.stop();
+    assert(persister.failed_count() == 0);
+    assert(persister.sync_count() >= 1);
+
+    auto reloaded_shm = make_shm(0);
+    PositionManager reloaded(reloaded_shm.get(), "", db_path, true);
+    assert(reloaded.initialize(1));
+    assert(reloaded.position_count() == 2);
+    const fund_info fund = reloaded.get_fund_info();
+    assert(fund.available == 149000000);
+    assert(fund.frozen == 1000000);
+
+    const position* sz_pos = reloaded.get_position(InternalSecurityId("XSHE_000001"));
+    const position* origin_sz = manager.get_position(InternalSecurityId("XSHE_000001"));
+    assert(sz_pos != nullptr && origin_sz != nullptr);
+    assert(sz_pos->volume_available_t0 == origin_sz->volume_available_t0);
+    assert(sz_pos->volume_sell == origin_sz->volume_sell);
+    const position* sh_pos = reloaded.get_position(InternalSecurityId("XSHG_600000"));
+    assert(sh_pos != nullptr);
+    assert(sh_pos->volume_buy == 300);
+    assert(sh_pos->volume_available_t1 == 300);
+
+    std::remove(db_path.c_str());
+}
+
+// 价格带与持仓快照同源：文件模式读 .price_limits.csv，DB 模式读可选 price_limits 表，缺失均视为空表。
+TEST(loader_reads_price_limits_from_csv_and_db) {
+    using namespace acct_service;
+
+    const std::string seed_base_path = unique_seed_path("acct_price_limit_seed");
+    const std::string limit_csv_path = seed_base_path + ".price_limits.csv";
+    std::vector<price_limit_entry> entries;
+
+    position_loader missing_loader(position_loader::file_source{seed_base_path});
+    assert(missing_loader.load_price_limits(entries));
+    assert(entries.empty());
+
+    assert(write_seed_csv(limit_csv_path,
+                          "record_type,internal_security_id,limit_up,limit_down\nprice_limit,SZ.000001,1100,900"));
+    position_loader file_loader(position_loader::file_source{seed_base_path});
+    assert(file_loader.load_price_limits(entries));
+    assert(entries.size() == 1);
+    assert(entries[0].internal_security_id == std::string_view("XSHE_000001"));
+    assert(entries[0].limit_up == 1100);
+    assert(entries[0].limit_down == 900);
+
+    assert(write_seed_csv(limit_csv_path, "price_limit,bad,1100,900"));
+    assert(!file_loader.load_price_limits(entries));
+    std::remove(limit_csv_path.c_str());
+
+    const std::string db_path = unique_db_path("acct_price_limit_db");
+    sqlite_db_ptr db(nullptr, sqlite3_close);
+    assert(open_sqlite_rw(db_path, db));
+    assert(init_position_loader_schema(db.get()));
+    position_loader db_loader(position_loader::db_source{db_path});
+    assert(db_loader.load_price_limits(entries));
+    assert(entries.empty());
+
+    assert(exec_sql(db.get(),
+        "CREATE TABLE price_limits(internal_security_id TEXT, limit_up INTEGER, limit_down INTEGER);"));
+    assert(exec_sql(db.get(), "INSERT INTO price_limits VALUES ('SH.600000', 2200, 1800);"));
+    db.reset();
+    assert(db_loader.load_price_limits(entries));
+    assert(entries.size() == 1);
+    assert(entries[0].internal_security_id == std::string_view("XSHG_600000"));
+    assert(entries[0].limit_up == 2200);
+
+    std::remove(db_path.c_str());
+}
+
+TEST(security_master_publishes_indexed_entries) {
+    using namespace acct_service;
+
+    const std::string csv_path = unique_seed_path("acct_security_master") + ".csv";
+    assert(write_seed_csv(csv_path,
+                          "record_type,internal_security_id,name,limit_up,limit_down,lot_size,fee_class\n"
+                          "security,SZ.000001,PAYH,1100,900,100,1\n"
+                          "# 无价格带的条目\n"
+                          "security,SH.600000,,0,0,100,2"));
+    std::vector<security_master_record> records;
+    assert(load_security_master_csv(csv_path, records));
+    assert(records.size() == 2);
+    assert(records[0].internal_security_id == std::string_view("XSHE_000001"));
+    assert(records[0].name == "PAYH");
+    assert(records[1].fee_class == 2);
+    assert(write_seed_csv(csv_path, "security,bad,x,1,1,100,1"));
+    assert(!load_security_master_csv(csv_path, records));
+    std::remove(csv_path.c_str());
+
+    for (uint32_t i = 0; i < 512; ++i) {
+        security_master_record record;
+        char code[16];
+        std::snprintf(code, sizeof(code), "XSHG_%06u", 601000 + i);
+        record.internal_security_id.assign(code);
+        record.limit_up = 2000 + i;
+        record.limit_down = 1000 + i;
+        record.lot_size = 100;
+        records.push_back(record);
+    }
+    records.insert(records.begin(), security_master_record{});
+    records.front().internal_security_id.assign("XSHE_000001");
+    records.front().limit_up = 1100;
+    records.front().limit_down = 900;
+
+    auto shm = std::make_unique<security_master_shm_layout>();
+    assert(publish_security_master(*shm, records, 20260105));
+    assert(security_master_ready(*shm, 20260105));
+    assert(!security_master_ready(*shm, 20260106));
+    assert(shm->slot_count > 0);
+
+    const security_master_entry* entry = security_master_find(*shm, InternalSecurityId("XSHG_601007"));
+    assert(entry != nullptr);
+    assert(entry->limit_up == 2007);
+    assert(entry->market == Market::SH);
+    assert(entry->name.view() == "XSHG_601007");
+    assert(security_master_find(*shm, InternalSecurityId("XSHG_609999")) == nullptr);
+
+    std::vector<price_limit_entry> limits;
+    security_master_price_limits(*shm, limits);
+    assert(limits.size() == records.size());
+    assert(limits[0].internal_security_id == std::string_view("XSHE_000001"));
+
+    // 发布失败不动已有段
+    records.push_back(records.front());
+    assert(!publish_security_master(*shm, records, 20260106));
+    assert(security_master_ready(*shm, 20260105));
+}
+
 TEST(initialize_fails_when_account_row_missing_in_db) {
     using namespace acct_service;
 
@@ -514,10 +1237,25 @@ int main() {
     RUN_TEST(fund_ops_write_into_fund_row);
     RUN_TEST(add_position_requires_registered_security);
     RUN_TEST(sellable_volume_uses_t0_only);
+    RUN_TEST(security_handle_indexes_position_row);
     RUN_TEST(initialize_rebuilds_code_map_from_existing_rows);
+    RUN_TEST(security_code_table_interns_startup_codes);
+    RUN_TEST(traded_turnover_is_incremental_and_rebuilt_on_attach);
+    RUN_TEST(pnl_tracks_average_cost_and_mark_to_market);
+    RUN_TEST(position_csv_parser_reports_rows_and_error_line);
     RUN_TEST(initialize_uses_loader_only_for_uninitialized_shm);
     RUN_TEST(initialize_fails_when_loader_fails_on_uninitialized_shm);
     RUN_TEST(initialize_loads_from_sqlite_when_db_enabled);
+    RUN_TEST(initialize_bulk_loads_large_sqlite_snapshot);
+    RUN_TEST(persister_writes_dirty_rows_back_to_sqlite);
+    RUN_TEST(initialize_loads_binary_position_snapshot);
+    RUN_TEST(snapshot_from_previous_day_rolls_positions_on_load);
+    RUN_TEST(fee_table_precomputes_account_rates);
+    RUN_TEST(trade_records_use_fixed_arena_and_intrusive_chains);
+    RUN_TEST(trade_store_survives_manager_restart);
+    RUN_TEST(entrust_records_track_active_set_on_state_transitions);
+    RUN_TEST(loader_reads_price_limits_from_csv_and_db);
+    RUN_TEST(security_master_publishes_indexed_entries);
     RUN_TEST(initialize_fails_when_account_row_missing_in_db);
     RUN_TEST(initialize_fails_when_internal_security_id_invalid_in_db);
 
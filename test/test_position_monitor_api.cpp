@@ -1,3 +1,7 @@
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
 #include <cassert>
 #include <chrono>
 #include <cstdio>
@@ -7,6 +11,7 @@
 
 #include "api/position_monitor_api.h"
 #include "portfolio/position_manager.hpp"
+#include "shm/positions_shm.hpp"
 #include "shm/shm_manager.hpp"
 
 #define TEST(name) static void test_##name()
@@ -153,6 +158,247 @@ TEST(read_not_found) {
     (void)SHMManager::unlink(shm_name);
 }
 
+TEST(seqlock_write_in_progress_returns_retry) {
+    // 写区间内 seq 为奇数，读者不得返回半写快照；写完后 seq 前进 2 且可读。
+    const std::string shm_name = unique_shm_name("acct_positions_mon_seq");
+    SHMManager writer_manager;
+    positions_shm_layout* positions_shm = writer_manager.open_positions(shm_name, shm_mode::Create, 1003);
+    assert(positions_shm != nullptr);
+
+    PositionManager positions(positions_shm);
+    assert(positions.initialize(1003));
+    const InternalSecurityId sec_id = positions.add_security("000001", "PingAn", Market::SZ);
+    position* pos = positions.get_position_mut(sec_id);
+    assert(pos != nullptr);
+
+    acct_positions_mon_options_t options{};
+    options.positions_shm_name = shm_name.c_str();
+    acct_positions_mon_ctx_t mon_ctx = nullptr;
+    assert(acct_positions_mon_open(&options, &mon_ctx) == ACCT_POS_MON_OK);
+
+    const uint32_t seq_before = pos->seq.load(std::memory_order_relaxed);
+    assert((seq_before & 1U) == 0);
+    acct_positions_mon_position_snapshot_t snapshot{};
+    {
+        position_lock guard(*pos);
+        pos->volume_available_t0 = 500;
+        assert((pos->seq.load(std::memory_order_relaxed) & 1U) == 1U);
+        assert(acct_positions_mon_read_position(mon_ctx, 0, &snapshot) == ACCT_POS_MON_ERR_RETRY);
+    }
+    assert(pos->seq.load(std::memory_order_relaxed) == seq_before + 2);
+    assert(acct_positions_mon_read_position(mon_ctx, 0, &snapshot) == ACCT_POS_MON_OK);
+    assert(snapshot.volume_available_t0 == 500);
+
+    // 异常退出残留的奇数 seq 在下一次写入时对齐为偶数
+    pos->seq.store(seq_before + 3, std::memory_order_relaxed);
+    assert(acct_positions_mon_read_position(mon_ctx, 0, &snapshot) == ACCT_POS_MON_ERR_RETRY);
+    assert(positions.add_position(sec_id, 100, 1000, 1));
+    assert(pos->seq.load(std::memory_order_relaxed) == seq_before + 4);
+    assert(acct_positions_mon_read_position(mon_ctx, 0, &snapshot) == ACCT_POS_MON_OK);
+
+    assert(acct_positions_mon_close(mon_ctx) == ACCT_POS_MON_OK);
+    writer_manager.close();
+    (void)SHMManager::unlink(shm_name);
+}
+
+TEST(poll_dirty_returns_only_changed_rows) {
+    // 首次 cursor=0 取全部已写入行；之后只返回变更行，输出不足时按版本分批返回且不漏行。
+    const std::string shm_name = unique_shm_name("acct_positions_mon_dirty");
+    SHMManager writer_manager;
+    positions_shm_layout* positions_shm = writer_manager.open_positions(shm_name, shm_mode::Create, 1004);
+    assert(positions_shm != nullptr);
+
+    PositionManager positions(positions_shm);
+    assert(positions.initialize(1004));
+    const InternalSecurityId first = positions.add_security("000001", "PingAn", Market::SZ);
+    const InternalSecurityId second = positions.add_security("000002", "Vanke", Market::SZ);
+    const InternalSecurityId third = positions.add_security("600000", "PFBank", Market::SH);
+    assert(!first.empty() && !second.empty() && !third.empty());
+
+    acct_positions_mon_options_t options{};
+    options.positions_shm_name = shm_name.c_str();
+    acct_positions_mon_ctx_t mon_ctx = nullptr;
+    assert(acct_positions_mon_open(&options, &mon_ctx) == ACCT_POS_MON_OK);
+
+    uint64_t cursor = 0;
+    uint32_t rows[8] = {};
+    std::size_t count = 0;
+    assert(acct_positions_mon_poll_dirty(mon_ctx, &cursor, rows, 8, &count) == ACCT_POS_MON_OK);
+    assert(count == 4);
+    for (uint32_t i = 0; i < 4; ++i) {
+        assert(rows[i] == i);
+    }
+    acct_positions_mon_info_t info{};
+    assert(acct_positions_mon_info(mon_ctx, &info) == ACCT_POS_MON_OK);
+    assert(cursor == info.change_version);
+
+    assert(acct_positions_mon_poll_dirty(mon_ctx, &cursor, rows, 8, &count) == ACCT_POS_MON_OK);
+    assert(count == 0);
+
+    assert(positions.add_position(second, 100, 1000, 1));
+    assert(acct_positions_mon_poll_dirty(mon_ctx, &cursor, rows, 8, &count) == ACCT_POS_MON_OK);
+    assert(count == 1);
+    assert(rows[0] == 2);
+
+    // 先改第三行再改第一行：容量为 1 时按变更先后分两次返回
+    assert(positions.add_position(third, 100, 1000, 2));
+    assert(positions.add_position(first, 100, 1000, 3));
+    assert(acct_positions_mon_poll_dirty(mon_ctx, &cursor, rows, 1, &count) == ACCT_POS_MON_OK);
+    assert(count == 1);
+    assert(rows[0] == 3);
+    assert(acct_positions_mon_poll_dirty(mon_ctx, &cursor, rows, 1, &count) == ACCT_POS_MON_OK);
+    assert(count == 1);
+    assert(rows[0] == 1);
+    assert(acct_positions_mon_poll_dirty(mon_ctx, &cursor, rows, 1, &count) == ACCT_POS_MON_OK);
+    assert(count == 0);
+
+    // 游标超过当前版本（持仓池重建）时从头拉取
+    uint64_t stale_cursor = cursor + 100;
+    assert(acct_positions_mon_poll_dirty(mon_ctx, &stale_cursor, rows, 8, &count) == ACCT_POS_MON_OK);
+    assert(count == 4);
+    assert(stale_cursor == cursor);
+
+    assert(acct_positions_mon_close(mon_ctx) == ACCT_POS_MON_OK);
+    writer_manager.close();
+    (void)SHMManager::unlink(shm_name);
+}
+
+TEST(read_all_reports_consistent_generation) {
+    // 无并发写时整表视图一致；残留写区间的行置空并返回 RETRY，按 generation 增量补读
+    const std::string shm_name = unique_shm_name("acct_positions_mon_all");
+    SHMManager writer_manager;
+    positions_shm_layout* positions_shm = writer_manager.open_positions(shm_name, shm_mode::Create, 1005);
+    assert(positions_shm != nullptr);
+
+    PositionManager positions(positions_shm);
+    assert(positions.initialize(1005));
+    const InternalSecurityId first = positions.add_security("000001", "PingAn", Market::SZ);
+    const InternalSecurityId second = positions.add_security("000002", "Vanke", Market::SZ);
+    assert(!first.empty() && !second.empty());
+    assert(positions.add_position(second, 200, 1000, 1));
+
+    acct_positions_mon_options_t options{};
+    options.positions_shm_name = shm_name.c_str();
+    acct_positions_mon_ctx_t mon_ctx = nullptr;
+    assert(acct_positions_mon_open(&options, &mon_ctx) == ACCT_POS_MON_OK);
+
+    acct_positions_mon_fund_snapshot_t fund{};
+    acct_positions_mon_position_snapshot_t rows[4]{};
+    std::size_t count = 0;
+    uint64_t generation = 0;
+    assert(acct_positions_mon_read_all(mon_ctx, &fund, rows, 4, &count, &generation) == ACCT_POS_MON_OK);
+    assert(count == 2);
+    assert(std::strcmp(fund.id, "FUND") == 0);
+    assert(std::strcmp(rows[0].id, first.c_str()) == 0 && rows[0].row_index == 1);
+    assert(std::strcmp(rows[1].id, second.c_str()) == 0 && rows[1].volume_buy_traded == 200);
+    acct_positions_mon_info_t info{};
+    assert(acct_positions_mon_info(mon_ctx, &info) == ACCT_POS_MON_OK);
+    assert(generation == info.change_version);
+
+    assert(acct_positions_mon_read_all(mon_ctx, &fund, rows, 1, &count, &generation) == ACCT_POS_MON_OK);
+    assert(count == 1);
+
+    position* pos = positions.get_position_mut(first);
+    assert(pos != nullptr);
+    const uint32_t seq_before = pos->seq.load(std::memory_order_relaxed);
+    pos->seq.store(seq_before | 1U, std::memory_order_relaxed);
+    assert(acct_positions_mon_read_all(mon_ctx, &fund, rows, 4, &count, &generation) == ACCT_POS_MON_ERR_RETRY);
+    assert(count == 2);
+    assert(rows[0].id[0] == '\0' && rows[0].index == 0);
+    assert(std::strcmp(rows[1].id, second.c_str()) == 0);
+
+    // 写者对齐后，以 generation 为游标只拉到被改写的行
+    assert(positions.add_position(first, 100, 1000, 2));
+    uint64_t cursor = generation;
+    uint32_t dirty[4] = {};
+    assert(acct_positions_mon_poll_dirty(mon_ctx, &cursor, dirty, 4, &count) == ACCT_POS_MON_OK);
+    assert(count >= 1 && dirty[count - 1] == 1);
+
+    assert(acct_positions_mon_read_all(mon_ctx, nullptr, rows, 4, &count, &generation) ==
+           ACCT_POS_MON_ERR_INVALID_PARAM);
+    assert(acct_positions_mon_close(mon_ctx) == ACCT_POS_MON_OK);
+    writer_manager.close();
+    (void)SHMManager::unlink(shm_name);
+}
+
+namespace {
+
+// 手工构造旧版持仓段（资金复用第 0 行证券列），模拟未升级的账户服务进程
+template <typename Layout>
+void check_legacy_layout(uint32_t version, const char* prefix) {
+    const std::string shm_name = unique_shm_name(prefix);
+    const int fd = ::shm_open(shm_name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+    assert(fd >= 0);
+    assert(::ftruncate(fd, sizeof(Layout)) == 0);
+    void* mapping = ::mmap(nullptr, sizeof(Layout), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    assert(mapping != MAP_FAILED);
+    auto* legacy = static_cast<Layout*>(mapping);
+
+    legacy->header.magic = PositionsHeader::kMagic;
+    legacy->header.version = version;
+    legacy->header.header_size = sizeof(PositionsHeader);
+    legacy->header.total_size = sizeof(Layout);
+    legacy->header.capacity = kMaxPositions;
+    legacy->header.init_state = 1;
+    legacy->position_count.store(1, std::memory_order_relaxed);
+    legacy->positions[kFundPositionIndex].id.assign(kFundPositionId);
+    legacy->positions[kFundPositionIndex].volume_available_t0 = 123456;  // total_asset
+    legacy->positions[kFundPositionIndex].available = 100000;
+    legacy->positions[1].id.assign("XSHE_000001");
+    legacy->positions[1].volume_buy_traded = 300;
+    legacy->positions[1].dvalue_sell = 77;
+    legacy->changes.row_versions[1].store(1, std::memory_order_relaxed);
+    legacy->changes.group_versions[0].store(1, std::memory_order_relaxed);
+    legacy->changes.version.store(1, std::memory_order_release);
+
+    acct_positions_mon_options_t options{};
+    options.positions_shm_name = shm_name.c_str();
+    acct_positions_mon_ctx_t mon_ctx = nullptr;
+    assert(acct_positions_mon_open(&options, &mon_ctx) == ACCT_POS_MON_OK);
+
+    acct_positions_mon_info_t info{};
+    assert(acct_positions_mon_info(mon_ctx, &info) == ACCT_POS_MON_OK);
+    assert(info.version == version);
+    assert(info.position_count == 1);
+    assert(info.change_version == 1);
+
+    acct_positions_mon_fund_snapshot_t fund{};
+    assert(read_fund_with_retry(mon_ctx, &fund) == ACCT_POS_MON_OK);
+    assert(std::strncmp(fund.id, "FUND", 4) == 0);
+    assert(fund.total_asset == 123456);
+    assert(fund.available == 100000);
+
+    acct_positions_mon_position_snapshot_t snapshot{};
+    assert(read_position_with_retry(mon_ctx, 0, &snapshot) == ACCT_POS_MON_OK);
+    assert(std::strncmp(snapshot.id, "XSHE_000001", 11) == 0);
+    assert(snapshot.volume_buy_traded == 300);
+    assert(snapshot.dvalue_sell == 77);
+
+    uint64_t cursor = 0;
+    uint32_t rows[4] = {};
+    std::size_t count = 0;
+    assert(acct_positions_mon_poll_dirty(mon_ctx, &cursor, rows, 4, &count) == ACCT_POS_MON_OK);
+    assert(count == 1);
+    assert(rows[0] == 1);
+
+    // 版本号与段大小不一致的段拒绝打开
+    legacy->header.version = PositionsHeader::kVersion;
+    acct_positions_mon_ctx_t bad_ctx = nullptr;
+    assert(acct_positions_mon_open(&options, &bad_ctx) == ACCT_POS_MON_ERR_SHM_FAILED);
+
+    assert(acct_positions_mon_close(mon_ctx) == ACCT_POS_MON_OK);
+    ::munmap(mapping, sizeof(Layout));
+    (void)::shm_unlink(shm_name.c_str());
+}
+
+} // namespace
+
+TEST(reads_legacy_layouts) {
+    check_legacy_layout<positions_shm_layout_v6>(PositionsHeader::kVersionV6, "acct_positions_mon_v6");
+    check_legacy_layout<positions_shm_layout_v7>(PositionsHeader::kVersionV7, "acct_positions_mon_v7");
+}
+
 TEST(rejects_file_backend_env) {
     ScopedEnvOverride env_override("SHM_USE_FILE", "1");
 
@@ -167,6 +413,10 @@ int main() {
     RUN_TEST(strerror);
     RUN_TEST(open_info_read_close);
     RUN_TEST(read_not_found);
+    RUN_TEST(seqlock_write_in_progress_returns_retry);
+    RUN_TEST(poll_dirty_returns_only_changed_rows);
+    RUN_TEST(read_all_reports_consistent_generation);
+    RUN_TEST(reads_legacy_layouts);
     RUN_TEST(rejects_file_backend_env);
 
     printf("\n=== All tests passed! ===\n");
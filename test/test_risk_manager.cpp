@@ -1,10 +1,19 @@
 #include <cassert>
+#include <chrono>
 #include <cstdio>
+#include <cstring>
 #include <memory>
+#include <thread>
+#include <type_traits>
+#include <vector>
 
 #include "common/constants.hpp"
 #include "portfolio/position_manager.hpp"
+#include "risk/firm_risk_aggregator.hpp"
 #include "risk/risk_manager.hpp"
+#include "shm/firm_risk_shm.hpp"
+#include "shm/positions_shm.hpp"
+#include "shm/risk_params_shm.hpp"
 
 #define TEST(name) static void test_##name()
 #define RUN_TEST(name)                                                                                                 \
@@ -119,11 +128,679 @@ TEST(fund_rule_reserves_fee_buffer) {
     assert(explicit_fee_over_result.code == RiskResult::RejectInsufficientFund);
 }
 
+// 静态规则链：拒绝结果只携带码与消息编号，规则按名称切换开关。
+TEST(static_rule_chain_message_ids_and_toggle) {
+    static_assert(std::is_trivially_copyable_v<risk_check_result>);
+
+    auto shm = make_positions_shm();
+    PositionManager positions(shm.get());
+    assert(positions.initialize(1));
+
+    RiskConfig cfg;
+    cfg.max_orders_per_second = 2;
+    cfg.enable_fund_check = false;
+    cfg.enable_position_check = false;
+    cfg.enable_price_limit_check = false;
+    cfg.enable_duplicate_check = false;
+
+    RiskManager manager(positions, cfg);
+    assert(!manager.rule_enabled(fund_check_rule::kName));
+    assert(manager.rule_enabled(rate_limit_rule::kName));
+    assert(!manager.enable_rule("no_such_rule", true));
+
+    assert(manager.check_order(make_buy_order(20, 100)).passed());
+    assert(manager.check_order(make_buy_order(21, 100)).passed());
+    const risk_check_result flooded = manager.check_order(make_buy_order(22, 100));
+    assert(!flooded.passed());
+    assert(flooded.message_id == risk_message_id::RateLimitExceeded);
+    assert(std::strcmp(flooded.message(), "order rate exceeds limit") == 0);
+    assert(manager.stats().rejected_rate_limit == 1);
+
+    assert(manager.enable_rule(rate_limit_rule::kName, false));
+    assert(manager.check_order(make_buy_order(23, 100)).passed());
+
+    // 资金规则排在速率规则之前，重新开启后先命中资金拒绝
+    assert(manager.enable_rule(rate_limit_rule::kName, true));
+    assert(manager.enable_rule(fund_check_rule::kName, true));
+    const risk_check_result no_fund = manager.check_order(make_buy_order(24, 200000));
+    assert(no_fund.code == RiskResult::RejectInsufficientFund);
+    assert(no_fund.message_id == risk_message_id::InsufficientFund);
+}
+
+// 重复单指纹表容量固定：大量不同订单写入后仍能拦截窗口内重复，过期后放行。
+TEST(duplicate_history_is_bounded_and_expires) {
+    auto shm = make_positions_shm();
+    PositionManager positions(shm.get());
+    assert(positions.initialize(1));
+
+    duplicate_order_rule rule;
+    rule.set_time_window_ns(60ULL * 1000000000ULL);
+    for (InternalOrderId id = 1; id <= 4 * duplicate_order_rule::kHistoryCapacity; ++id) {
+        assert(rule.check(make_buy_order(id, 100), positions).passed());
+    }
+    const InternalOrderId last = 4 * duplicate_order_rule::kHistoryCapacity;
+    const risk_check_result again = rule.check(make_buy_order(last, 100), positions);
+    assert(again.code == RiskResult::RejectDuplicateOrder);
+
+    rule.clear_history();
+    assert(rule.check(make_buy_order(last, 100), positions).passed());
+
+    rule.set_time_window_ns(100000);
+    assert(rule.check(make_buy_order(7, 100), positions).passed());
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    assert(rule.check(make_buy_order(7, 100), positions).passed());
+}
+
+// 三级令牌桶：单策略超限不影响其他策略，证券级按持仓行句柄独立计数，拒绝按级别计入统计。
+TEST(hierarchical_token_bucket_rate_limit) {
+    auto shm = make_positions_shm();
+    PositionManager positions(shm.get());
+    assert(positions.initialize(1));
+    const InternalSecurityId first = positions.add_security("000001", "PingAn", Market::SZ);
+    const InternalSecurityId second = positions.add_security("000002", "Vanke", Market::SZ);
+
+    RiskConfig cfg;
+    cfg.enable_fund_check = false;
+    cfg.enable_position_check = false;
+    cfg.enable_price_limit_check = false;
+    cfg.enable_duplicate_check = false;
+    cfg.max_orders_per_second = 100;
+    cfg.max_orders_per_second_per_strategy = 3;
+    cfg.max_orders_per_second_per_security = 4;
+    cfg.rate_limit_burst_ms = 1000;
+    RiskManager manager(positions, cfg);
+
+    InternalOrderId next_id = 100;
+    auto order_on = [&](const InternalSecurityId& security) {
+        OrderRequest req = make_buy_order(next_id++, 100);
+        req.internal_security_id = security;
+        req.security_handle = positions.resolve_security_handle(security);
+        return req;
+    };
+
+    // 策略 1 用满 3 个令牌后被拒，策略 2 不受影响
+    for (int i = 0; i < 3; ++i) {
+        assert(manager.check_order(order_on(first), 1).passed());
+    }
+    const risk_check_result strategy_reject = manager.check_order(order_on(first), 1);
+    assert(strategy_reject.message_id == risk_message_id::StrategyRateLimitExceeded);
+    assert(manager.check_order(order_on(first), 2).passed());
+
+    // 证券 first 已消耗 4 个令牌，换证券仍可下单
+    const risk_check_result security_reject = manager.check_order(order_on(first), 3);
+    assert(security_reject.message_id == risk_message_id::SecurityRateLimitExceeded);
+    assert(manager.check_order(order_on(second), 3).passed());
+
+    const RiskState& stats = manager.stats();
+    assert(stats.rejected_rate_limit == 2);
+    assert(stats.rejected_rate_limit_strategy == 1);
+    assert(stats.rejected_rate_limit_security == 1);
+    assert(stats.rejected_rate_limit_account == 0);
+
+    // 亚秒级补充：策略级 3 笔/秒，约 340ms 后补回 1 个令牌
+    std::this_thread::sleep_for(std::chrono::milliseconds(340));
+    assert(manager.check_order(order_on(second), 1).passed());
+    assert(manager.check_order(order_on(second), 1).message_id == risk_message_id::StrategyRateLimitExceeded);
+}
+
+// 批量风控与逐笔风控给出相同结果：掩码位与逐笔拒绝码一致，超过单批上限时分批处理。
+TEST(batch_check_matches_scalar_chain) {
+    auto shm = make_positions_shm();
+    PositionManager positions(shm.get());
+    assert(positions.initialize(1));
+    assert(positions.add_security("000001", "PingAn", Market::SZ) == std::string_view("XSHE_000001"));
+
+    RiskConfig cfg;
+    cfg.max_order_value = 5000000;
+    cfg.max_order_volume = 3000;
+    cfg.enable_fund_check = true;
+    cfg.enable_position_check = false;
+    cfg.enable_price_limit_check = true;
+    cfg.enable_duplicate_check = false;
+    RiskManager scalar(positions, cfg);
+    RiskManager batch(positions, cfg);
+    scalar.update_price_limits(InternalSecurityId("XSHE_000001"), 1500, 800);
+    batch.update_price_limits(InternalSecurityId("XSHE_000001"), 1500, 800);
+
+    std::vector<OrderRequest> orders;
+    for (InternalOrderId id = 1; id <= 100; ++id) {
+        OrderRequest req = make_buy_order(id, 100 * (id % 40));
+        req.dprice_entrust = 700 + (id % 9) * 100;
+        if (id % 17 == 0) {
+            req.volume_entrust = UINT64_MAX / 2;  // 宽乘积走 128 位回落路径
+        }
+        orders.push_back(req);
+    }
+
+    const std::vector<risk_check_result> batch_results = batch.check_orders(orders);
+    assert(batch_results.size() == orders.size());
+    bool saw_reject = false;
+    for (std::size_t i = 0; i < orders.size(); ++i) {
+        const risk_check_result expected = scalar.check_order(orders[i]);
+        assert(batch_results[i].code == expected.code);
+        assert(batch_results[i].message_id == expected.message_id);
+        saw_reject = saw_reject || !expected.passed();
+    }
+    assert(saw_reject);
+    assert(batch.stats().total_checks == scalar.stats().total_checks);
+    assert(batch.stats().rejected_value == scalar.stats().rejected_value);
+    assert(batch.stats().rejected_price == scalar.stats().rejected_price);
+
+    risk_batch_result out;
+    assert(batch.check_order_batch(orders.data(), orders.size(), out) == kRiskBatchSize);
+    for (std::size_t i = 0; i < out.count; ++i) {
+        assert(out.passed(i) == out.results[i].passed());
+    }
+}
+
+// 价格带按句柄缓存：已建档证券首次查表后走稠密表，整表替换后缓存失效；未建档证券按证券键查表。
+TEST(price_limit_table_caches_by_security_handle) {
+    auto shm = make_positions_shm();
+    PositionManager positions(shm.get());
+    assert(positions.initialize(1));
+    const InternalSecurityId booked = positions.add_security("000001", "PingAn", Market::SZ);
+
+    RiskConfig cfg;
+    cfg.enable_fund_check = false;
+    cfg.enable_position_check = false;
+    cfg.enable_duplicate_check = false;
+    cfg.enable_price_limit_check = true;
+    RiskManager manager(positions, cfg);
+
+    OrderRequest booked_order = make_buy_order(1, 100);
+    booked_order.security_handle = positions.resolve_security_handle(booked);
+    booked_order.dprice_entrust = 1200;
+    assert(manager.check_order(booked_order).passed());  // 无价格带，缓存为"无"
+
+    std::vector<price_limit_entry> entries(2);
+    entries[0].internal_security_id = InternalSecurityId("SZ.000001");
+    entries[0].limit_up = 1100;
+    entries[0].limit_down = 900;
+    entries[1].internal_security_id = InternalSecurityId("XSHG_600000");
+    entries[1].limit_up = 2200;
+    entries[1].limit_down = 0;
+    assert(manager.load_price_limits(entries) == 2);
+    assert(manager.rule<price_limit_rule>().price_limit_count() == 2);
+    assert(manager.check_order(booked_order).code == RiskResult::RejectPriceOutOfRange);
+    booked_order.dprice_entrust = 1000;
+    assert(manager.check_order(booked_order).passed());
+
+    OrderRequest unbooked = make_buy_order(2, 100);
+    unbooked.internal_security_id = InternalSecurityId("XSHG_600000");
+    unbooked.market = Market::SH;
+    unbooked.dprice_entrust = 2300;
+    assert(manager.check_order(unbooked).code == RiskResult::RejectPriceOutOfRange);
+    unbooked.dprice_entrust = 10;
+    assert(manager.check_order(unbooked).passed());
+
+    // 配置更新不清空当日价格带
+    manager.update_config(cfg);
+    booked_order.dprice_entrust = 1200;
+    assert(manager.check_order(booked_order).code == RiskResult::RejectPriceOutOfRange);
+
+    manager.clear_price_limits();
+    assert(manager.check_order(booked_order).passed());
+}
+
+// 风控参数段：接入即发布，改配置、开关规则、刷新价格带后重发布，预检结论与服务端规则一致
+TEST(risk_params_segment_mirrors_stateless_rules) {
+    auto shm = make_positions_shm();
+    PositionManager positions(shm.get());
+    assert(positions.initialize(1));
+
+    RiskConfig cfg;
+    cfg.enable_fund_check = false;
+    cfg.max_order_volume = 1000;
+    RiskManager manager(positions, cfg);
+    auto params = std::make_unique<risk_params_shm_layout>();
+    manager.attach_risk_params(params.get());
+    const uint32_t first_seq = params->seq.load();
+    assert(first_seq != 0 && (first_seq & 1U) == 0);
+    assert(params->max_order_volume == 1000 && params->max_order_value == 0);
+
+    const InternalSecurityId id("XSHE_000001");
+    assert(risk_params_precheck(*params, id, 1001, 1000) == RiskResult::RejectExceedMaxOrderVolume);
+    assert(risk_params_precheck(*params, id, 1000, 1000) == RiskResult::Pass);
+
+    std::vector<price_limit_entry> entries(1);
+    entries[0].internal_security_id = InternalSecurityId("SZ.000001");
+    entries[0].limit_up = 1100;
+    entries[0].limit_down = 900;
+    assert(manager.load_price_limits(entries) == 1);
+    assert(params->band_count == 1);
+    assert(risk_params_precheck(*params, id, 100, 1200) == RiskResult::RejectPriceOutOfRange);
+
+    OrderRequest order = make_buy_order(1, 100);
+    order.dprice_entrust = 1200;
+    assert(manager.check_order(order).code == RiskResult::RejectPriceOutOfRange);
+
+    // 关闭价格带检查后按不限发布
+    assert(manager.enable_rule("price_limit", false));
+    assert(risk_params_precheck(*params, id, 100, 1200) == RiskResult::Pass);
+    assert(manager.enable_rule("price_limit", true));
+
+    cfg.max_order_volume = 0;
+    cfg.max_order_value = 50'000;
+    manager.update_config(cfg);
+    assert(params->seq.load() > first_seq);
+    assert(risk_params_precheck(*params, id, 100, 1000) == RiskResult::RejectExceedMaxOrderValue);
+    assert(risk_params_precheck(*params, id, 50, 1000) == RiskResult::Pass);
+
+    manager.clear_price_limits();
+    assert(params->band_count == 0);
+    assert(risk_params_find_band(*params, id) == nullptr);
+}
+
+// 当日成交额：已成交买卖额 + 冻结资金 + 本单金额超过上限即拒绝，逐笔与批量路径一致
+TEST(daily_turnover_counts_trades_and_frozen_fund) {
+    auto shm = make_positions_shm();
+    PositionManager positions(shm.get());
+    assert(positions.initialize(1));
+    assert(positions.add_security("000001", "PingAn", Market::SZ) == std::string_view("XSHE_000001"));
+    const SecurityHandle handle = positions.resolve_security_handle(InternalSecurityId("XSHE_000001"));
+
+    RiskConfig cfg;
+    cfg.max_order_value = 0;
+    cfg.max_order_volume = 0;
+    cfg.max_daily_turnover = 300000;
+    cfg.enable_fund_check = false;
+    cfg.enable_position_check = false;
+    cfg.enable_price_limit_check = false;
+    cfg.enable_duplicate_check = false;
+    RiskManager risk(positions, cfg);
+    assert(risk.rule_enabled(max_daily_turnover_rule::kName));
+
+    assert(risk.check_order(make_buy_order(1, 100)).passed());
+    assert(positions.freeze_fund(150000, 1));
+    assert(risk.check_order(make_buy_order(2, 150)).passed());
+
+    assert(positions.add_position(handle, 100, 1000, 1));
+    assert(positions.traded_turnover() == 100000);
+    const risk_check_result rejected = risk.check_order(make_buy_order(3, 100));
+    assert(rejected.code == RiskResult::RejectExceedDailyLimit);
+    assert(rejected.message_id == risk_message_id::ExceedDailyTurnover);
+    assert(std::string_view(rejected.message()) == "daily turnover exceeds limit");
+    assert(risk.stats().rejected_turnover == 1);
+    assert(risk.stats().rejected_rate_limit == 0);
+
+    std::vector<OrderRequest> orders{make_buy_order(4, 50), make_buy_order(5, 51)};
+    const std::vector<risk_check_result> results = risk.check_orders(orders);
+    assert(results[0].passed());
+    assert(results[1].code == RiskResult::RejectExceedDailyLimit);
+
+    RiskConfig disabled = cfg;
+    disabled.max_daily_turnover = 0;
+    risk.update_config(disabled);
+    assert(!risk.rule_enabled(max_daily_turnover_rule::kName));
+    assert(risk.check_order(make_buy_order(6, 1000)).passed());
+}
+
+// 公司级敞口：聚合器按变更戳增量折算多个账户的持仓段，规则读发布的合计判定总敞口与单证券集中度
+TEST(firm_exposure_rule_reads_aggregated_totals) {
+    auto shm_a = make_positions_shm();
+    auto shm_b = make_positions_shm();
+    PositionManager positions_a(shm_a.get());
+    PositionManager positions_b(shm_b.get());
+    assert(positions_a.initialize(1));
+    assert(positions_b.initialize(2));
+    assert(positions_a.add_security("000001", "PingAn", Market::SZ) == std::string_view("XSHE_000001"));
+    assert(positions_b.add_security("000002", "Vanke", Market::SZ) == std::string_view("XSHE_000002"));
+    assert(positions_b.add_security("000001", "PingAn", Market::SZ) == std::string_view("XSHE_000001"));
+    const SecurityHandle handle_a = positions_a.resolve_security_handle(InternalSecurityId("XSHE_000001"));
+    const SecurityHandle handle_b = positions_b.resolve_security_handle(InternalSecurityId("XSHE_000001"));
+    assert(positions_a.add_position(handle_a, 100, 1000, 1));
+    assert(positions_b.add_position(handle_b, 200, 1000, 1));
+    assert(positions_b.freeze_fund(50000, 2));
+
+    auto firm = std::make_unique<firm_risk_shm_layout>();
+    firm_risk_aggregator aggregator(firm.get());
+    assert(aggregator.add_account(1, shm_a.get()));
+    assert(aggregator.add_account(2, shm_b.get()));
+    assert(!aggregator.add_account(1, shm_b.get()));
+    assert(aggregator.poll() > 0);
+
+    firm_risk_totals totals;
+    assert(firm_risk_try_read_totals(*firm, totals));
+    assert(totals.account_count == 2);
+    assert(totals.holding_volume == 300);
+    assert(totals.traded_buy_value == 300000);
+    assert(totals.frozen_value == 50000);
+    const std::size_t slot = firm_risk_find_security(*firm, InternalSecurityId("XSHE_000001"));
+    assert(slot != kInvalidFirmRiskSlot);
+    firm_security_total security;
+    assert(firm_risk_try_read_security(*firm, slot, security));
+    assert(security.holding_volume == 300);
+    assert(security.account_count == 2);
+    assert(firm_risk_find_security(*firm, InternalSecurityId("XSHE_000003")) == kInvalidFirmRiskSlot);
+
+    // 无变更时不再发布
+    const uint64_t version = totals.version;
+    assert(aggregator.poll() == 0);
+    assert(firm_risk_try_read_totals(*firm, totals) && totals.version == version);
+
+    RiskConfig cfg;
+    cfg.enable_fund_check = false;
+    cfg.enable_position_check = false;
+    cfg.enable_price_limit_check = false;
+    cfg.enable_duplicate_check = false;
+    cfg.max_firm_gross_value = 400000;
+    RiskManager risk(positions_a, cfg);
+    assert(risk.rule_enabled(firm_exposure_rule::kName));
+    // 未接入合计段时放行
+    assert(risk.check_order(make_buy_order(1, 1000)).passed());
+    risk.attach_firm_risk(firm.get());
+
+    assert(risk.check_order(make_buy_order(2, 50)).passed());
+    const risk_check_result gross = risk.check_order(make_buy_order(3, 51));
+    assert(gross.code == RiskResult::RejectFirmLimit);
+    assert(gross.message_id == risk_message_id::FirmGrossExposureExceeded);
+
+    cfg.max_firm_gross_value = 0;
+    cfg.max_firm_security_volume = 350;
+    risk.update_config(cfg);
+    OrderRequest at_limit = make_buy_order(4, 50);
+    at_limit.security_handle = handle_a;
+    assert(risk.check_order(at_limit).passed());
+    OrderRequest over = make_buy_order(5, 51);
+    over.security_handle = handle_a;
+    const risk_check_result concentration = risk.check_order(over);
+    assert(concentration.code == RiskResult::RejectFirmLimit);
+    assert(concentration.message_id == risk_message_id::FirmSecurityConcentrationExceeded);
+
+    // 其他账户加仓后经聚合器刷新，缓存的槽位读到新合计；批量路径与逐笔一致
+    assert(positions_b.add_position(handle_b, 50, 1000, 2));
+    assert(aggregator.poll() == 1);
+    std::vector<OrderRequest> orders{make_buy_order(6, 1), make_buy_order(7, 0)};
+    orders[0].security_handle = handle_a;
+    const std::vector<risk_check_result> results = risk.check_orders(orders);
+    assert(results[0].code == RiskResult::RejectFirmLimit);
+    assert(results[1].passed());
+    assert(risk.stats().rejected_firm_limit == 3);
+
+    // 持仓段重建（变更版本回退）时撤回该账户贡献
+    positions_shm_reset_changes(*shm_b);
+    (void)aggregator.poll();
+    assert(firm_risk_try_read_totals(*firm, totals));
+    assert(totals.holding_volume == 100);
+    assert(totals.frozen_value == 0);
+    assert(firm_risk_try_read_security(*firm, slot, security));
+    assert(security.holding_volume == 100 && security.account_count == 1);
+}
+
+// 自成交：在簿价位随订单状态增量维护，新单价格与本账户反向最优价交叉即拒绝，逐笔与批量路径一致
+TEST(self_trade_rule_rejects_crossing_orders) {
+    auto shm = make_positions_shm();
+    PositionManager positions(shm.get());
+    assert(positions.initialize(1));
+    assert(positions.add_security("000001", "PingAn", Market::SZ) == std::string_view("XSHE_000001"));
+    const SecurityHandle handle = positions.resolve_security_handle(InternalSecurityId("XSHE_000001"));
+
+    RiskConfig cfg;
+    cfg.enable_fund_check = false;
+    cfg.enable_position_check = false;
+    cfg.enable_price_limit_check = false;
+    cfg.enable_duplicate_check = false;
+    cfg.enable_self_trade_check = true;
+    RiskManager risk(positions, cfg);
+    assert(risk.rule_enabled(self_trade_rule::kName));
+    assert(!risk.tracking_resting_orders());
+
+    auto make_order = [handle](InternalOrderId order_id, TradeSide side, DPrice price, OrderState state) {
+        OrderRequest req = make_buy_order(order_id, 100);
+        req.trade_side = side;
+        req.dprice_entrust = price;
+        req.security_handle = handle;
+        req.order_state.store(state, std::memory_order_relaxed);
+        return req;
+    };
+
+    // 未建表时不拦截
+    assert(risk.check_order(make_order(1, TradeSide::Sell, 1000, OrderState::UserSubmitted)).passed());
+    risk.track_resting_orders(16);
+    assert(risk.tracking_resting_orders());
+
+    // 风控待定的订单不计入，通过后计入
+    OrderRequest bid_high = make_order(10, TradeSide::Buy, 1000, OrderState::RiskControllerPending);
+    risk.on_order_update(bid_high);
+    assert(risk.rule<self_trade_rule>().resting_count() == 0);
+    bid_high.order_state.store(OrderState::MarketAccepted, std::memory_order_relaxed);
+    risk.on_order_update(bid_high);
+    risk.on_order_update(make_order(11, TradeSide::Buy, 990, OrderState::BrokerAccepted));
+    risk.on_order_update(make_order(12, TradeSide::Buy, 1000, OrderState::TraderSubmitted));
+    risk.on_order_update(make_order(13, TradeSide::Sell, 1050, OrderState::TraderPending));
+    assert(risk.rule<self_trade_rule>().resting_count() == 4);
+    assert(risk.rule<self_trade_rule>().best_bid(handle) == 1000);
+    assert(risk.rule<self_trade_rule>().best_ask(handle) == 1050);
+
+    const risk_check_result crossed = risk.check_order(make_order(2, TradeSide::Sell, 1000, OrderState::UserSubmitted));
+    assert(crossed.code == RiskResult::RejectSelfTrade);
+    assert(crossed.message_id == risk_message_id::SelfTrade);
+    assert(risk.stats().rejected_self_trade == 1);
+    assert(risk.check_order(make_order(3, TradeSide::Sell, 1001, OrderState::UserSubmitted)).passed());
+    assert(risk.check_order(make_order(4, TradeSide::Buy, 1049, OrderState::UserSubmitted)).passed());
+    assert(risk.check_order(make_order(5, TradeSide::Buy, 0, OrderState::UserSubmitted)).code ==
+           RiskResult::RejectSelfTrade);
+
+    // 同价位仍有一笔在簿，最优价不变；全部离开后回落到下一价位
+    bid_high.order_state.store(OrderState::Finished, std::memory_order_relaxed);
+    risk.on_order_update(bid_high);
+    assert(risk.rule<self_trade_rule>().best_bid(handle) == 1000);
+    risk.on_order_removed(12);
+    risk.on_order_removed(12);
+    assert(risk.rule<self_trade_rule>().best_bid(handle) == 990);
+    assert(risk.check_order(make_order(6, TradeSide::Sell, 1000, OrderState::UserSubmitted)).passed());
+
+    // 改价后按新价位计入
+    OrderRequest ask = make_order(13, TradeSide::Sell, 980, OrderState::MarketAccepted);
+    risk.on_order_update(ask);
+    assert(risk.rule<self_trade_rule>().best_ask(handle) == 980);
+    std::vector<OrderRequest> batch{make_order(7, TradeSide::Buy, 980, OrderState::UserSubmitted),
+                                    make_order(8, TradeSide::Buy, 979, OrderState::UserSubmitted)};
+    const std::vector<risk_check_result> results = risk.check_orders(batch);
+    assert(results[0].code == RiskResult::RejectSelfTrade);
+    assert(results[1].passed());
+
+    // 全部成交的订单不再在簿
+    ask.volume_traded = ask.volume_entrust;
+    risk.on_order_update(ask);
+    assert(risk.rule<self_trade_rule>().best_ask(handle) == 0);
+    assert(risk.rule<self_trade_rule>().resting_count() == 1);
+}
+
+TEST(observer_and_shared_counters) {
+    auto shm = make_positions_shm();
+    PositionManager positions(shm.get());
+    assert(positions.initialize(1));
+
+    RiskConfig cfg;
+    cfg.max_order_value = 0;
+    cfg.max_order_volume = 100;
+    cfg.max_orders_per_second = 0;
+    cfg.enable_fund_check = false;
+    cfg.enable_position_check = false;
+    cfg.enable_price_limit_check = false;
+    cfg.enable_duplicate_check = false;
+
+    struct recording_observer {
+        std::size_t calls = 0;
+        std::size_t rejects = 0;
+
+        void on_check(const OrderRequest& order, const risk_check_result& result) {
+            (void)order;
+            ++calls;
+            rejects += result.passed() ? 0 : 1;
+        }
+    };
+
+    recording_observer observer;
+    risk_stat_counters counters;
+    const risk_check_hook hook = risk_check_hook::bind<recording_observer, &recording_observer::on_check>(&observer);
+    RiskManager manager(positions, cfg, hook, &counters);
+
+    assert(manager.check_order(make_buy_order(1, 100)).passed());
+    assert(manager.check_order(make_buy_order(2, 200)).code == RiskResult::RejectExceedMaxOrderVolume);
+    std::vector<OrderRequest> batch{make_buy_order(3, 50), make_buy_order(4, 500)};
+    (void)manager.check_orders(batch);
+
+    // 计数落在调用方存储，快照由分原因计数汇总
+    assert(observer.calls == 4);
+    assert(observer.rejects == 2);
+    assert(counters.passed.load(std::memory_order_relaxed) == 2);
+    assert(counters.rejected_volume.load(std::memory_order_relaxed) == 2);
+    const RiskState stats = manager.stats();
+    assert(stats.total_checks == 4);
+    assert(stats.rejected == 2);
+    assert(stats.rejected_volume == 2);
+    assert(stats.last_check_time != 0);
+
+    manager.reset_stats();
+    assert(counters.rejected_volume.load(std::memory_order_relaxed) == 0);
+    assert(manager.stats().total_checks == 0);
+}
+
+TEST(rule_profiling_reorders_rejecting_rules_first) {
+    auto shm = make_positions_shm();
+    PositionManager positions(shm.get());
+    assert(positions.initialize(1));
+    assert(positions.add_security("000001", "PingAn", Market::SZ) == std::string_view("XSHE_000001"));
+
+    RiskConfig cfg;
+    cfg.enable_fund_check = false;
+    cfg.enable_position_check = false;
+    cfg.enable_duplicate_check = false;
+    cfg.max_order_value = 1'000'000'000;
+    cfg.rule_reorder_interval = 16;
+    RiskManager manager(positions, cfg);
+    std::vector<price_limit_entry> entries(1);
+    entries[0].internal_security_id = InternalSecurityId("SZ.000001");
+    entries[0].limit_up = 1100;
+    entries[0].limit_down = 900;
+    assert(manager.load_price_limits(entries) == 1);
+
+    // 拒单风暴全部落在链上靠后的价格带规则：结果始终不变，一个窗口后它被排到最前
+    for (InternalOrderId id = 1; id <= 32; ++id) {
+        OrderRequest order = make_buy_order(id, 100);
+        order.dprice_entrust = 1200;
+        assert(manager.check_order(order).code == RiskResult::RejectPriceOutOfRange);
+    }
+    assert(manager.rule_reorders() == 2);
+    const std::vector<const char*> order = manager.rule_order();
+    assert(std::string_view(order.front()) == "price_limit");
+    // 有副作用的规则保持在链尾
+    assert(std::string_view(order[order.size() - 2]) == "duplicate_order");
+    assert(std::string_view(order.back()) == "rate_limit");
+
+    assert(manager.rule_profile("price_limit").rejects == 32);
+    assert(manager.rule_profile("max_order_value").checks == 16);
+    assert(manager.rule_profile("max_order_value").rejects == 0);
+    assert(manager.rule_profile("fund_check").checks == 0);
+
+    // 放行的订单仍走完全部开启的规则
+    OrderRequest ok = make_buy_order(100, 100);
+    assert(manager.check_order(ok).passed());
+    assert(manager.rule_profile("max_order_value").checks == 17);
+
+    auto table = std::make_unique<metrics_table>();
+    metrics_registry registry(table.get());
+    manager.register_metrics(registry);
+    manager.publish_rule_metrics();
+    bool found = false;
+    for (uint32_t i = 0; i < table->slot_count.load(); ++i) {
+        if (std::string_view(table->slots[i].name) == "risk.price_limit.rejects") {
+            assert(table->slots[i].value.load() == 32);
+            found = true;
+        }
+    }
+    assert(found);
+
+    // 配置变化后回到链上顺序
+    manager.update_config(cfg);
+    assert(std::string_view(manager.rule_order().front()) == "fund_check");
+}
+
+TEST(order_ratio_rule_reads_incremental_flow_counters) {
+    auto shm = make_positions_shm();
+    PositionManager positions(shm.get());
+    assert(positions.initialize(1));
+    assert(positions.add_security("000001", "PingAn", Market::SZ) == std::string_view("XSHE_000001"));
+    assert(positions.add_security("600000", "PuFa", Market::SH) == std::string_view("XSHG_600000"));
+    const SecurityHandle pingan = positions.resolve_security_handle(InternalSecurityId("XSHE_000001"));
+    const SecurityHandle pufa = positions.resolve_security_handle(InternalSecurityId("XSHG_600000"));
+
+    RiskConfig cfg;
+    cfg.enable_fund_check = false;
+    cfg.enable_position_check = false;
+    cfg.enable_duplicate_check = false;
+    cfg.enable_price_limit_check = false;
+    cfg.max_order_to_trade_ratio = 3;
+    cfg.max_cancel_ratio_pct = 50;
+    cfg.order_ratio_min_orders = 4;
+    RiskManager manager(positions, cfg);
+    assert(manager.rule_enabled("order_ratio"));
+
+    OrderRequest order = make_buy_order(1, 100);
+    order.security_handle = pingan;
+
+    // 不足 min_orders 时不判定
+    positions.record_order_flow(pingan, order_flow_event::NewOrder, 3);
+    assert(manager.check_order(order).passed());
+
+    // 4 笔新单 0 成交：第 5 笔超过 3 倍
+    positions.record_order_flow(pufa, order_flow_event::NewOrder);
+    risk_check_result result = manager.check_order(order);
+    assert(result.code == RiskResult::RejectOrderRatio);
+    assert(result.message_id == risk_message_id::OrderToTradeRatioExceeded);
+
+    // 成交回报拉低比例后恢复放行；账户合计通过后再看本单证券行
+    positions.record_order_flow(pufa, order_flow_event::Fill, 3);
+    assert(manager.check_order(order).passed());
+    positions.record_order_flow(pingan, order_flow_event::NewOrder, 2);
+    assert(manager.check_order(order).code == RiskResult::RejectOrderRatio);
+    positions.record_order_flow(pingan, order_flow_event::Fill, 2);
+    assert(manager.check_order(order).passed());
+
+    // 撤单率：6 笔新单中撤 4 笔超过 50%
+    positions.record_order_flow(pingan, order_flow_event::Cancel, 4);
+    result = manager.check_order(order);
+    assert(result.code == RiskResult::RejectOrderRatio);
+    assert(result.message_id == risk_message_id::CancelRatioExceeded);
+    // 撤单本身不受限
+    OrderRequest cancel;
+    cancel.init_cancel(2, 93000000, 1);
+    assert(manager.check_order(cancel).passed());
+
+    const order_flow_counts totals = positions.order_flow_totals();
+    assert(totals.orders == 6 && totals.cancels == 4 && totals.fills == 5);
+    const position* row = positions.get_position(pingan);
+    assert(row->count_order == 5 && row->count_cancel == 4 && row->count_fill == 2);
+    assert(manager.stats().rejected_order_ratio == 3);
+
+    // 重启：同一段上的新实例从行内计数重建账户合计
+    PositionManager restarted(shm.get());
+    assert(restarted.initialize(1));
+    const order_flow_counts restored = restarted.order_flow_totals();
+    assert(restored.orders == 6 && restored.cancels == 4 && restored.fills == 5);
+    RiskManager restarted_manager(restarted, cfg);
+    assert(restarted_manager.check_order(order).code == RiskResult::RejectOrderRatio);
+}
+
 int main() {
     printf("=== Risk Manager Test Suite ===\n\n");
 
     RUN_TEST(fund_and_duplicate_rules);
     RUN_TEST(fund_rule_reserves_fee_buffer);
+    RUN_TEST(static_rule_chain_message_ids_and_toggle);
+    RUN_TEST(duplicate_history_is_bounded_and_expires);
+    RUN_TEST(hierarchical_token_bucket_rate_limit);
+    RUN_TEST(batch_check_matches_scalar_chain);
+    RUN_TEST(price_limit_table_caches_by_security_handle);
+    RUN_TEST(daily_turnover_counts_trades_and_frozen_fund);
+    RUN_TEST(order_ratio_rule_reads_incremental_flow_counters);
+    RUN_TEST(firm_exposure_rule_reads_aggregated_totals);
+    RUN_TEST(self_trade_rule_rejects_crossing_orders);
+    RUN_TEST(observer_and_shared_counters);
+    RUN_TEST(risk_params_segment_mirrors_stateless_rules);
+    RUN_TEST(rule_profiling_reorders_rejecting_rules_first);
 
     printf("\n=== All tests passed! ===\n");
     return 0;
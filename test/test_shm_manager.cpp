@@ -1,17 +1,29 @@
 #include <fcntl.h>
 #include <sys/mman.h>
 #include <sys/stat.h>
+#include <sys/wait.h>
 #include <unistd.h>
 
 #include <atomic>
 #include <cassert>
 #include <cerrno>
+#include <cstddef>
 #include <chrono>
 #include <cstdlib>
 #include <cstdio>
+#include <cstring>
+#include <memory>
+#include <new>
 #include <string>
+#include <thread>
+#include <vector>
 
+#include "common/idle_strategy.hpp"
+#include "common/spinlock.hpp"
+#include "shm/doorbell.hpp"
+#include "shm/orders_shm.hpp"
 #include "shm/shm_manager.hpp"
+#include "shm/upstream_lanes.hpp"
 #include "common/error.hpp"
 
 #define TEST(name) static void test_##name()
@@ -86,12 +98,12 @@ TEST(create_and_open) {
     SHMManager creator;
     auto* layout_create = creator.open_upstream(name, shm_mode::Create, 1);
     assert(layout_create != nullptr);
-    layout_create->header.next_order_id.store(123, std::memory_order_relaxed);
+    layout_create->header.next_id_epoch.store(123, std::memory_order_relaxed);
 
     SHMManager opener;
     auto* layout_open = opener.open_upstream(name, shm_mode::Open, 1);
     assert(layout_open != nullptr);
-    const uint32_t val = layout_open->header.next_order_id.load(std::memory_order_relaxed);
+    const uint32_t val = layout_open->header.next_id_epoch.load(std::memory_order_relaxed);
     assert(val == 123);
 
     creator.close();
@@ -108,12 +120,12 @@ TEST(open_or_create_no_reinit) {
     SHMManager first;
     auto* layout_first = first.open_upstream(name, shm_mode::OpenOrCreate, 1);
     assert(layout_first != nullptr);
-    layout_first->header.next_order_id.store(77, std::memory_order_relaxed);
+    layout_first->header.next_id_epoch.store(77, std::memory_order_relaxed);
 
     SHMManager second;
     auto* layout_second = second.open_upstream(name, shm_mode::OpenOrCreate, 1);
     assert(layout_second != nullptr);
-    const uint32_t val = layout_second->header.next_order_id.load(std::memory_order_relaxed);
+    const uint32_t val = layout_second->header.next_id_epoch.load(std::memory_order_relaxed);
     assert(val == 77);
 
     first.close();
@@ -121,6 +133,43 @@ TEST(open_or_create_no_reinit) {
     cleanup_shm(name);
 }
 
+TEST(map_options_prefault_whole_region) {
+    using namespace acct_service;
+
+    const std::string name = unique_shm_name("shm_mgr_map_options");
+    cleanup_shm(name);
+
+    shm::ShmMapOptions options;
+    options.huge_pages = true;
+    options.prefault = true;
+    options.numa_node = shm::numa_node_of_cpu(0);
+
+    SHMManager manager;
+    manager.set_map_options(options);
+    auto* layout = manager.open_trades(name, shm_mode::Create, 1);
+    assert(layout != nullptr);
+    assert(layout->header.magic == SHMHeader::kMagic);
+
+    // 预取后整段页面应已驻留，热路径不再触发首次缺页
+    const std::size_t page = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+    const std::size_t pages = (sizeof(trades_shm_layout) + page - 1) / page;
+    std::vector<unsigned char> residency(pages, 0);
+    assert(::mincore(layout, sizeof(trades_shm_layout), residency.data()) == 0);
+    for (unsigned char flag : residency) {
+        assert((flag & 1) != 0);
+    }
+
+    shm::ShmGenericReader reader;
+    const auto* mirror =
+        static_cast<const trades_shm_layout*>(reader.open(name, sizeof(trades_shm_layout), options));
+    assert(mirror != nullptr);
+    assert(mirror->header.magic == SHMHeader::kMagic);
+
+    reader.close();
+    manager.close();
+    cleanup_shm(name);
+}
+
 TEST(open_orders_with_dated_name) {
     using namespace acct_service;
 
@@ -143,6 +192,121 @@ TEST(open_orders_with_dated_name) {
     cleanup_shm(name);
 }
 
+TEST(open_orders_runtime_capacity) {
+    using namespace acct_service;
+
+    const std::string name = unique_shm_name("shm_mgr_orders_small") + "_20260225";
+    cleanup_shm(name);
+
+    constexpr std::size_t kCapacity = 256;
+    SHMManager creator;
+    auto* orders = creator.open_orders(name, shm_mode::Create, 1, kCapacity);
+    assert(orders != nullptr);
+    assert(orders->header.capacity == kCapacity);
+    assert(orders->header.total_size == orders_shm_size(kCapacity));
+
+    // 段大小只覆盖配置容量，不再按 kDailyOrderPoolCapacity 映射
+    const int fd = ::shm_open(name.c_str(), O_RDONLY, 0);
+    assert(fd >= 0);
+    struct stat shm_stat {};
+    assert(::fstat(fd, &shm_stat) == 0);
+    ::close(fd);
+    assert(static_cast<std::size_t>(shm_stat.st_size) == orders_shm_size(kCapacity));
+
+    OrderIndex index = 0;
+    OrderIndex last = 0;
+    for (std::size_t i = 0; i < kCapacity; ++i) {
+        assert(orders_shm_try_allocate(orders, index));
+        last = index;
+    }
+    assert(!orders_shm_try_allocate(orders, index));
+
+    // 进度字区按容量定长、紧随槽位区：末个下标的进度字恰好落在段尾
+    assert(orders_shm_size(kCapacity) - orders_shm_progress_offset(kCapacity) == kCapacity * sizeof(uint64_t));
+    assert(orders_shm_mark_downstream(orders, last, OrderSlotState::DownstreamDequeued,
+                                      orders->header.create_time + 5));
+
+    // capacity=0 沿用已存在段的容量；显式容量不一致时按头部不兼容拒绝
+    SHMManager adopter;
+    auto* adopted = adopter.open_orders(name, shm_mode::Open, 1, 0);
+    assert(adopted != nullptr);
+    assert(adopted->header.capacity == kCapacity);
+    assert(orders_shm_downstream_progress(adopted)[last].load() ==
+           ((static_cast<uint64_t>(OrderSlotState::DownstreamDequeued) << kDownstreamProgressStageShift) | 5));
+
+    SHMManager mismatched;
+    assert(mismatched.open_orders(name, shm_mode::OpenOrCreate, 1, kCapacity * 2) == nullptr);
+    assert(latest_error().code == ErrorCode::ShmHeaderInvalid);
+
+    creator.close();
+    adopter.close();
+    cleanup_shm(name);
+}
+
+TEST(open_orders_windowed_maps_slots_on_demand) {
+    using namespace acct_service;
+
+    const std::string name = unique_shm_name("shm_mgr_orders_windowed") + "_20260225";
+    cleanup_shm(name);
+
+    constexpr std::size_t kCapacity = 8192;
+    constexpr std::size_t kWindowBytes = 64 * 1024;
+    SHMManager creator;
+    auto* orders = creator.open_orders(name, shm_mode::Create, 1, kCapacity);
+    assert(orders != nullptr);
+    assert(creator.orders_windows() == nullptr);
+
+    OrderRequest request;
+    request.init_new("600000", InternalSecurityId("XSHG_600000"), static_cast<InternalOrderId>(11), TradeSide::Buy,
+                     Market::SH, static_cast<Volume>(100), static_cast<DPrice>(1500), 93000000);
+    OrderIndex first = kInvalidOrderIndex;
+    assert(orders_shm_append(orders, request, OrderSlotState::DownstreamQueued, order_slot_source_t::AccountInternal,
+                             now_ns(), first));
+    assert(orders_shm_reserve_through(orders, static_cast<OrderIndex>(kCapacity - 1)) == kCapacity - 1);
+    OrderIndex last = kInvalidOrderIndex;
+    request.internal_order_id = 12;
+    assert(orders_shm_append(orders, request, OrderSlotState::DownstreamQueued, order_slot_source_t::AccountInternal,
+                             now_ns(), last));
+    assert(last == kCapacity - 1);
+
+    // 接入方只映射头部与变更日志，读写槽位时才映射所在窗口
+    SHMManager adopter;
+    adopter.set_orders_window_bytes(kWindowBytes);
+    auto* adopted = adopter.open_orders(name, shm_mode::Open, 1, 0);
+    assert(adopted != nullptr);
+    const orders_window_map* windows = adopter.orders_windows();
+    assert(windows != nullptr);
+    assert(adopter.is_open() && adopter.name() == name);
+    const std::size_t head_windows = windows->mapped_windows();
+    assert(head_windows == (offsetof(orders_shm_layout, slots) + kWindowBytes - 1) / kWindowBytes);
+    assert(windows->window_count() > head_windows + 2);
+
+    order_slot_snapshot snapshot{};
+    assert(orders_shm_read_snapshot(adopted, last, snapshot));
+    assert(snapshot.request.internal_order_id == 12);
+    // 槽位跨窗口边界时两个窗口一并映射，另加该下标进度字所在窗口
+    const std::size_t after_last = windows->mapped_windows();
+    assert(after_last > head_windows && after_last <= head_windows + 3);
+    // 首个槽位紧随变更日志，落在打开时已映射的窗口内；其进度字在进度字区开头，至多再映射一个窗口
+    assert(orders_shm_read_snapshot(adopted, first, snapshot));
+    assert(snapshot.request.internal_order_id == 11);
+    assert(windows->mapped_windows() <= after_last + 1);
+    assert(windows->mapped_bytes() < windows->size());
+
+    // 经窗口写入的槽位对整段映射方可见
+    request.volume_entrust = 300;
+    assert(orders_shm_sync_order(adopted, last, request, now_ns()));
+    assert(orders_shm_read_snapshot(orders, last, snapshot));
+    assert(snapshot.request.volume_entrust == 300);
+
+    adopter.close();
+    assert(adopter.orders_windows() == nullptr);
+    // 整段映射的段不受窗口表影响
+    assert(orders_shm_find_slot(orders, first) != nullptr);
+    creator.close();
+    cleanup_shm(name);
+}
+
 TEST(size_mismatch) {
     using namespace acct_service;
 
@@ -212,15 +376,556 @@ TEST(rejects_file_backend_env) {
     cleanup_shm(name);
 }
 
+TEST(spsc_bulk_push_pop_wraps_ring) {
+    using namespace acct_service;
+
+    auto queue = std::make_unique<spsc_queue<uint32_t, 8>>();
+    queue->init();
+
+    // 先推进 5 个元素再取走，使后续批量写入跨越环尾回绕。
+    const uint32_t warmup[5] = {1, 2, 3, 4, 5};
+    assert(queue->try_push_bulk(warmup, 5) == 5);
+    uint32_t drained[8] = {};
+    assert(queue->try_pop_bulk(drained, 8) == 5);
+    assert(drained[0] == 1 && drained[4] == 5);
+    assert(queue->empty());
+
+    const uint32_t items[10] = {10, 11, 12, 13, 14, 15, 16, 17, 18, 19};
+    assert(queue->try_push_bulk(items, 10) == queue->capacity());
+    assert(queue->size() == queue->capacity());
+    assert(!queue->try_push(99));
+
+    uint32_t out[8] = {};
+    assert(queue->try_pop_bulk(out, 3) == 3);
+    assert(out[0] == 10 && out[1] == 11 && out[2] == 12);
+
+    uint32_t single = 0;
+    assert(queue->try_pop(single));
+    assert(single == 13);
+    assert(queue->try_push(20));
+
+    assert(queue->try_pop_bulk(out, 8) == 4);
+    assert(out[0] == 14 && out[1] == 15 && out[2] == 16 && out[3] == 20);
+    assert(queue->try_pop_bulk(out, 8) == 0);
+    assert(queue->try_push_bulk(nullptr, 4) == 0);
+}
+
+TEST(spsc_claim_commit_writes_in_place) {
+    using namespace acct_service;
+
+    auto queue = std::make_unique<spsc_queue<uint32_t, 8>>();
+    queue->init();
+
+    // 头部推进到 6，申请时在环尾截断为连续段
+    const uint32_t warmup[6] = {1, 2, 3, 4, 5, 6};
+    assert(queue->try_push_bulk(warmup, 6) == 6);
+    uint32_t drained[8] = {};
+    assert(queue->try_pop_bulk(drained, 8) == 6);
+
+    uint32_t* slots = nullptr;
+    assert(queue->try_claim(0, 5, slots) == 2);
+    slots[0] = 30;
+    slots[1] = 31;
+    // 未提交前消费者不可见，跳过已申请部分后从环头继续申请
+    assert(queue->empty());
+    assert(queue->try_claim(2, 8, slots) == 5);
+    slots[0] = 32;
+    queue->commit(3);
+    assert(queue->size() == 3);
+
+    uint32_t out[8] = {};
+    assert(queue->try_pop_bulk(out, 8) == 3);
+    assert(out[0] == 30 && out[1] == 31 && out[2] == 32);
+
+    // 申请量受剩余空间限制，满时返回 0
+    assert(queue->try_claim(0, 16, slots) == queue->capacity());
+    queue->commit(queue->capacity());
+    assert(queue->try_claim(0, 1, slots) == 0 && slots == nullptr);
+}
+
+TEST(spsc_byte_ring_variable_records_wrap) {
+    using namespace acct_service;
+
+    using ring_type = spsc_byte_ring<256>;
+    auto ring = std::make_unique<ring_type>();
+    ring->init();
+    assert(ring_type::record_bytes(1) == 16 && ring_type::record_bytes(8) == 16);
+    assert(ring->try_claim(1, ring_type::kMaxRecordSize + 1) == nullptr);
+
+    // 连续申请两条，提交前不可见，一次 commit 一并发布
+    auto* first = static_cast<char*>(ring->try_claim(1, 5));
+    assert(first != nullptr);
+    std::memcpy(first, "hello", 5);
+    auto* second = static_cast<uint64_t*>(ring->try_claim(2, sizeof(uint64_t)));
+    assert(second != nullptr);
+    *second = 42;
+    assert(ring->empty());
+    ring->commit();
+    assert(ring->size_bytes() == 32);
+
+    std::vector<uint32_t> types;
+    std::size_t read = ring->read_batch([&](const spsc_byte_record_view& view) {
+        types.push_back(view.type);
+        if (view.type == 1) {
+            assert(view.size == 5 && std::memcmp(view.data, "hello", 5) == 0);
+        } else {
+            assert(view.size == sizeof(uint64_t) && *static_cast<const uint64_t*>(view.data) == 42);
+        }
+    });
+    assert(read == 2 && types.size() == 2 && types[0] == 1 && types[1] == 2);
+    assert(ring->empty());
+
+    // 写位置停在 32：A 占 [32, 144)，B 占 [144, 232)；取走 A 后 C 放不下环尾 24 字节，填充后写到环头
+    std::vector<unsigned char> big(ring_type::kMaxRecordSize, 0xAB);
+    assert(ring->try_write(3, big.data(), 100));
+    assert(ring->try_write(4, big.data(), 80));
+    assert(ring->read_batch([](const spsc_byte_record_view& v) { assert(v.type == 3 && v.size == 100); }, 1) == 1);
+    const unsigned char small[40] = {7};
+    assert(ring->try_write(5, small, sizeof(small)));
+    assert(ring->size_bytes() == 88 + 24 + 48);
+    // 已用 160 字节，剩余空间放不下一条上限长度的记录
+    assert(!ring->try_write(6, big.data(), ring_type::kMaxRecordSize));
+
+    spsc_byte_record_view view;
+    assert(ring->try_peek(view) && view.type == 4 && view.size == 80);
+    ring->pop_front();
+    assert(ring->try_peek(view) && view.type == 5 && view.size == 40);
+    assert(static_cast<const unsigned char*>(view.data)[0] == 7);
+    ring->pop_front();
+    assert(!ring->try_peek(view));
+    assert(ring->empty());
+
+    // 放弃未提交的申请：消费者看不到，空间可重新申请
+    assert(ring->try_claim(6, 16) != nullptr);
+    ring->abort_claims();
+    assert(ring->read_batch([](const spsc_byte_record_view&) { assert(false); }) == 0);
+    assert(ring->free_bytes() == ring_type::capacity());
+
+    // 批量读取受 max_records 限制，余下的记录留给下一批
+    for (uint32_t i = 0; i < 4; ++i) {
+        assert(ring->try_write(10 + i, &i, sizeof(i)));
+    }
+    uint32_t seen = 0;
+    assert(ring->read_batch([&](const spsc_byte_record_view& v) { seen += v.type; }, 3) == 3);
+    assert(seen == 10 + 11 + 12);
+    assert(ring->read_batch([&](const spsc_byte_record_view& v) { seen += v.type; }) == 1);
+    assert(seen == 10 + 11 + 12 + 13);
+}
+
+TEST(spsc_byte_ring_cross_thread_order) {
+    using namespace acct_service;
+
+    auto ring = std::make_unique<spsc_byte_ring<4096>>();
+    ring->init();
+    constexpr uint32_t kRecords = 200000;
+
+    std::thread producer([&]() {
+        unsigned char payload[256];
+        for (uint32_t seq = 0; seq < kRecords;) {
+            const std::size_t size = sizeof(seq) + (seq * 37U) % (sizeof(payload) - sizeof(seq));
+            void* slot = ring->try_claim(seq, size);
+            if (slot == nullptr) {
+                ring->commit();
+                continue;
+            }
+            std::memset(payload, static_cast<int>(seq & 0xFF), size);
+            std::memcpy(payload, &seq, sizeof(seq));
+            std::memcpy(slot, payload, size);
+            // 每 8 条提交一次，验证批量发布
+            if ((++seq & 7U) == 0) {
+                ring->commit();
+            }
+        }
+        ring->commit();
+    });
+
+    uint32_t expected = 0;
+    while (expected < kRecords) {
+        (void)ring->read_batch([&](const spsc_byte_record_view& view) {
+            uint32_t seq = 0;
+            std::memcpy(&seq, view.data, sizeof(seq));
+            assert(seq == expected && view.type == expected);
+            assert(view.size == sizeof(seq) + (seq * 37U) % (256 - sizeof(seq)));
+            const auto* bytes = static_cast<const unsigned char*>(view.data);
+            assert(bytes[view.size - 1] == static_cast<unsigned char>(seq & 0xFF) || view.size == sizeof(seq));
+            ++expected;
+        }, 64);
+    }
+    producer.join();
+    assert(ring->empty());
+}
+
+TEST(upstream_lane_claim_and_reclaim) {
+    using namespace acct_service;
+
+    auto upstream = std::make_unique<upstream_shm_layout>();
+    assert(upstream_lane_count(upstream.get()) == 1);
+    upstream_set_lane_count(upstream.get(), 2);
+    assert(upstream_lane_count(upstream.get()) == 2);
+
+    // 先用一个已退出的子进程占住 lane 0，验证可被回收。
+    const pid_t child = ::fork();
+    assert(child >= 0);
+    if (child == 0) {
+        ::_exit(0);
+    }
+    int status = 0;
+    assert(::waitpid(child, &status, 0) == child);
+    upstream->lane_table.owner_pids[0].store(static_cast<uint32_t>(child), std::memory_order_relaxed);
+
+    const uint32_t self = static_cast<uint32_t>(::getpid());
+    uint32_t lane = kMaxUpstreamLanes;
+    assert(upstream_claim_lane(upstream.get(), self, lane));
+    assert(lane == 0);
+
+    // 存活进程持有的 lane 不可抢占，同 pid 重复认领返回原 lane。
+    const uint32_t parent = static_cast<uint32_t>(::getppid());
+    uint32_t other_lane = kMaxUpstreamLanes;
+    assert(upstream_claim_lane(upstream.get(), parent, other_lane));
+    assert(other_lane == 1);
+    uint32_t third_lane = kMaxUpstreamLanes;
+    assert(!upstream_claim_lane(upstream.get(), 1, third_lane));
+    assert(upstream_claim_lane(upstream.get(), self, lane));
+    assert(lane == 0);
+
+    assert(upstream->lane(1).try_push(7));
+    assert(upstream_pending_size(upstream.get()) == 1);
+
+    upstream_release_lane(upstream.get(), 1, self);
+    assert(upstream->lane_table.owner_pids[1].load() == parent);
+    upstream_release_lane(upstream.get(), 1, parent);
+    assert(upstream->lane_table.owner_pids[1].load() == 0);
+}
+
+// 放在共享映射里的自旋锁：持有者进程退出后，SpinLock::lock() 自动接管，票号锁经 recover_if_owner_dead() 放行下一号。
+TEST(spinlocks_recover_from_dead_owner_process) {
+    using namespace acct_service;
+
+    struct shared_locks {
+        SpinLock spin;
+        TicketSpinLock ticket;
+    };
+    void* mapping = ::mmap(nullptr, sizeof(shared_locks), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    assert(mapping != MAP_FAILED);
+    auto* locks = new (mapping) shared_locks{};
+
+    const uint32_t self = static_cast<uint32_t>(::getpid());
+    locks->spin.lock();
+    assert(locks->spin.owner_pid() == self);
+    assert(!locks->spin.try_lock());
+    assert(!locks->spin.recover_if_owner_dead());
+    locks->spin.unlock();
+    assert(!locks->spin.is_locked());
+
+    const pid_t child = ::fork();
+    assert(child >= 0);
+    if (child == 0) {
+        locks->spin.lock();
+        locks->ticket.lock();
+        ::_exit(0);
+    }
+    int status = 0;
+    assert(::waitpid(child, &status, 0) == child);
+    assert(locks->spin.owner_pid() == static_cast<uint32_t>(child));
+    assert(locks->ticket.owner_pid() == static_cast<uint32_t>(child));
+
+    const uint64_t recoveries = spinlock_dead_owner_recoveries();
+    locks->spin.lock();
+    assert(locks->spin.owner_pid() == self);
+    assert(spinlock_dead_owner_recoveries() == recoveries + 1);
+    locks->spin.unlock();
+
+    assert(locks->ticket.is_locked() && !locks->ticket.try_lock());
+    assert(locks->ticket.recover_if_owner_dead());
+    assert(!locks->ticket.is_locked());
+    assert(locks->ticket.try_lock());
+    assert(locks->ticket.owner_pid() == self);
+    assert(!locks->ticket.recover_if_owner_dead());
+    locks->ticket.unlock();
+
+    // 同进程多线程下票号锁仍互斥
+    uint64_t counter = 0;
+    std::vector<std::thread> workers;
+    for (int t = 0; t < 2; ++t) {
+        workers.emplace_back([locks, &counter]() {
+            for (int i = 0; i < 2000; ++i) {
+                LockGuard<TicketSpinLock> guard(locks->ticket);
+                ++counter;
+            }
+        });
+    }
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+    assert(counter == 4000);
+    assert(!locks->ticket.is_locked());
+
+    locks->~shared_locks();
+    ::munmap(mapping, sizeof(shared_locks));
+}
+
+TEST(orders_copy_changed_lines_only_touches_dirty_lines) {
+    using namespace acct_service;
+
+    OrderRequest slot_request;
+    slot_request.init_new("000001", InternalSecurityId("XSHE_000001"), 42, TradeSide::Buy, Market::SZ, 100, 1000,
+                          93000000);
+    OrderRequest updated = slot_request;
+    assert(orders_shm_copy_changed_lines(slot_request, updated) == 0);
+
+    // 成交回写只改变成交相关字段，不应重写首个缓存行（订单标识与证券代码）。
+    updated.volume_traded = 50;
+    updated.order_state.store(OrderState::MarketAccepted, std::memory_order_relaxed);
+    const std::size_t written = orders_shm_copy_changed_lines(slot_request, updated);
+    assert(written >= 1 && written < sizeof(OrderRequest) / kCacheLineSize);
+    assert(slot_request.volume_traded == 50);
+    assert(slot_request.order_state.load(std::memory_order_relaxed) == OrderState::MarketAccepted);
+    assert(slot_request.internal_order_id == 42);
+    assert(orders_shm_copy_changed_lines(slot_request, updated) == 0);
+}
+
+// 验证槽位直读：在 seqlock 稳定区间内读到已发布的字段，越界索引返回 false。
+TEST(orders_read_slot_reads_published_fields) {
+    using namespace acct_service;
+
+    auto orders = std::make_unique<orders_shm_layout>();
+    orders->header.capacity = static_cast<uint32_t>(kDailyOrderPoolCapacity);
+    orders->header.next_index.store(0, std::memory_order_relaxed);
+
+    OrderRequest request;
+    request.init_new("600000", InternalSecurityId("XSHG_600000"), static_cast<InternalOrderId>(77), TradeSide::Buy,
+                     Market::SH, static_cast<Volume>(200), static_cast<DPrice>(1500), 93000000);
+    OrderIndex index = kInvalidOrderIndex;
+    assert(orders_shm_append(orders.get(), request, OrderSlotState::DownstreamQueued,
+                             order_slot_source_t::AccountInternal, now_ns(), index));
+
+    InternalOrderId order_id = 0;
+    Volume volume = 0;
+    const auto read_fields = [&](const OrderSlot& slot) {
+        order_id = slot.request.internal_order_id;
+        volume = slot.request.volume_entrust;
+    };
+    const bool read_ok = orders_shm_read_slot(orders.get(), index, read_fields);
+    assert(read_ok);
+    assert(order_id == 77);
+    assert(volume == 200);
+    const bool out_of_range = orders_shm_read_slot(orders.get(), index + 1, read_fields);
+    assert(!out_of_range);
+}
+
+TEST(order_id_encodes_epoch_and_slot_index) {
+    using namespace acct_service;
+
+    const std::string upstream_name = unique_shm_name("shm_mgr_epoch_up");
+    const std::string orders_name = unique_shm_name("shm_mgr_epoch_orders") + "_20260225";
+    cleanup_shm(upstream_name);
+    cleanup_shm(orders_name);
+
+    SHMManager upstream_manager;
+    auto* upstream = upstream_manager.open_upstream(upstream_name, shm_mode::Create, 1);
+    assert(upstream != nullptr);
+    SHMManager orders_manager;
+    auto* orders = orders_manager.open_orders(orders_name, shm_mode::Create, 1, 256);
+    assert(orders != nullptr);
+    assert(orders->header.id_epoch.load() == 0);
+
+    // 首个接入方取号绑定，后续接入方沿用同一纪元
+    const uint32_t epoch = orders_shm_bind_id_epoch(orders, upstream);
+    assert(epoch == 1);
+    assert(orders_shm_bind_id_epoch(orders, upstream) == epoch);
+    assert(upstream->header.next_id_epoch.load() == 2);
+
+    OrderRequest request;
+    request.init_new("600000", InternalSecurityId("XSHG_600000"), 0, TradeSide::Buy, Market::SH,
+                     static_cast<Volume>(100), static_cast<DPrice>(1000), 93000000);
+    OrderIndex first = kInvalidOrderIndex;
+    assert(orders_shm_append_assign_id(orders, request, OrderSlotState::UpstreamQueued, order_slot_source_t::User,
+                                       now_ns(), first));
+    const InternalOrderId first_id = request.internal_order_id;
+    assert(first_id == make_order_id(epoch, first));
+    assert(order_id_slot_index(first_id) == first);
+    assert(order_id_epoch(first_id) == epoch);
+
+    // 已带订单号的请求保持原号
+    request.internal_order_id = 42;
+    OrderIndex second = kInvalidOrderIndex;
+    assert(orders_shm_append_assign_id(orders, request, OrderSlotState::UpstreamQueued, order_slot_source_t::User,
+                                       now_ns(), second));
+    assert(request.internal_order_id == 42);
+
+    // 重建的订单池换新纪元，同一槽位编出不同订单号
+    orders_manager.close();
+    cleanup_shm(orders_name);
+    auto* rebuilt = orders_manager.open_orders(orders_name, shm_mode::Create, 1, 256);
+    assert(rebuilt != nullptr);
+    assert(orders_shm_bind_id_epoch(rebuilt, upstream) == epoch + 1);
+    assert(orders_shm_order_id(rebuilt, first) != first_id);
+    assert(order_id_slot_index(orders_shm_order_id(rebuilt, first)) == first);
+
+    // 纪元计数器回绕时仍落在 [1, kMaxOrderIdEpoch]
+    auto scratch = std::make_unique<orders_shm_layout>();
+    upstream->header.next_id_epoch.store(kMaxOrderIdEpoch + 1, std::memory_order_relaxed);
+    assert(orders_shm_bind_id_epoch(scratch.get(), upstream) == 1);
+
+    upstream_manager.close();
+    orders_manager.close();
+    cleanup_shm(upstream_name);
+    cleanup_shm(orders_name);
+}
+
+TEST(orders_overflow_chain_extends_and_resolves) {
+    using namespace acct_service;
+
+    const std::string upstream_name = unique_shm_name("shm_mgr_ovf_up");
+    const std::string orders_name = unique_shm_name("shm_mgr_ovf_orders") + "_20260225";
+    const std::string overflow_name = make_orders_overflow_shm_name(orders_name, 1);
+    assert(is_orders_overflow_shm_name(overflow_name));
+    assert(!is_orders_overflow_shm_name(orders_name));
+    cleanup_shm(upstream_name);
+    cleanup_shm(orders_name);
+    cleanup_shm(overflow_name);
+
+    SHMManager upstream_manager;
+    auto* upstream = upstream_manager.open_upstream(upstream_name, shm_mode::Create, 1);
+    assert(upstream != nullptr);
+    constexpr std::size_t kCapacity = 10;
+    SHMManager orders_manager;
+    auto* orders = orders_manager.open_orders(orders_name, shm_mode::Create, 1, kCapacity);
+    assert(orders != nullptr);
+    const uint32_t primary_epoch = orders_shm_bind_id_epoch(orders, upstream);
+
+    // 未到 80% 水位不建溢出段
+    OrderIndex index = kInvalidOrderIndex;
+    for (std::size_t i = 0; i < 7; ++i) {
+        assert(orders_shm_try_allocate(orders, index));
+    }
+    assert(extend_orders_overflow(orders, 1, shm::ShmMapOptions{}, upstream) == 0);
+    assert(orders_shm_try_allocate(orders, index));
+    assert(extend_orders_overflow(orders, 1, shm::ShmMapOptions{}, upstream) == 1);
+    assert(orders->header.overflow_segments.load() == 1);
+    assert(extend_orders_overflow(orders, 1, shm::ShmMapOptions{}, upstream) == 0);
+
+    // 主段写满后落到溢出段，下标高位为段号，订单号按溢出段纪元编码并可反查
+    assert(orders_shm_try_allocate(orders, index));
+    assert(orders_shm_try_allocate(orders, index));
+    assert(index == kCapacity - 1);
+    OrderRequest request;
+    request.init_new("600000", InternalSecurityId("XSHG_600000"), 0, TradeSide::Buy, Market::SH,
+                     static_cast<Volume>(100), static_cast<DPrice>(1000), 93000000);
+    OrderIndex overflow_index = kInvalidOrderIndex;
+    assert(orders_shm_append_assign_id(orders, request, OrderSlotState::UpstreamQueued, order_slot_source_t::User,
+                                       now_ns(), overflow_index));
+    assert(overflow_index == make_orders_index(1, 0));
+    assert(orders->header.full_reject_count.load() == 0);
+    assert(order_id_epoch(request.internal_order_id) != primary_epoch);
+    assert(orders_shm_index_for_order_id(orders, request.internal_order_id) == overflow_index);
+    assert(orders_shm_index_for_order_id(orders, orders_shm_order_id(orders, 3)) == 3);
+
+    // 变更日志记在主段，下标为全局下标
+    uint64_t cursor = 0;
+    OrderIndex changed[4];
+    uint64_t seqs[4];
+    bool lagged = false;
+    assert(orders_shm_journal_read(orders, cursor, changed, seqs, 4, lagged) == 1);
+    assert(changed[0] == overflow_index);
+
+    // 另一映射（模拟其他进程）首次访问时按主段名打开溢出段
+    SHMManager follower_manager;
+    auto* follower = follower_manager.open_orders(orders_name, shm_mode::Open, 1, 0);
+    assert(follower != nullptr && follower != orders);
+    order_slot_snapshot snapshot;
+    assert(orders_shm_read_snapshot(follower, overflow_index, snapshot));
+    assert(snapshot.request.internal_order_id == request.internal_order_id);
+
+    // 区间预留不跨段；链上全部段写满才计拒单
+    OrderIndex begin = kInvalidOrderIndex;
+    assert(orders_shm_try_allocate_range(follower, 4, begin) == 4);
+    assert(begin == make_orders_index(1, 1));
+    assert(orders_shm_release_range(follower, begin + 2, begin + 4));
+    assert(orders_shm_try_allocate_range(follower, 16, begin) == 7);
+    assert(begin == make_orders_index(1, 3));
+    assert(orders->header.full_reject_count.load() == 9);
+    assert(!orders_shm_try_allocate(orders, index));
+    assert(orders->header.full_reject_count.load() == 10);
+
+    // 主段关闭即注销，溢出下标不再可达
+    follower_manager.close();
+    orders_manager.close();
+    upstream_manager.close();
+    cleanup_shm(upstream_name);
+    cleanup_shm(orders_name);
+    cleanup_shm(overflow_name);
+}
+
+TEST(doorbell_wakes_parked_consumer) {
+    using namespace acct_service;
+
+    // 无等待者时敲门铃不递增序号，生产者只付出一次 fence。
+    shm_doorbell bell;
+    doorbell_ring(&bell);
+    assert(bell.seq.load() == 0);
+
+    // 队列已有数据时登记后复查即返回，不进入 futex。
+    const auto fast_start = std::chrono::steady_clock::now();
+    doorbell_wait(&bell, 2000000, []() { return true; });
+    assert(std::chrono::steady_clock::now() - fast_start < std::chrono::seconds(1));
+    assert(bell.waiters.load() == 0);
+
+    std::atomic<bool> produced{false};
+    const auto start = std::chrono::steady_clock::now();
+    std::thread consumer([&]() {
+        while (!produced.load(std::memory_order_acquire)) {
+            doorbell_wait(&bell, 2000000, [&]() { return produced.load(std::memory_order_acquire); });
+        }
+    });
+    while (bell.waiters.load() == 0) {
+        std::this_thread::yield();
+    }
+    produced.store(true, std::memory_order_release);
+    doorbell_ring(&bell);
+    consumer.join();
+    assert(std::chrono::steady_clock::now() - start < std::chrono::seconds(1));
+    assert(bell.seq.load() == 1);
+    assert(bell.waiters.load() == 0);
+
+    // 分级退避：自旋与 yield 轮数耗尽后才进入挂起级，reset 回到自旋级。
+    idle_backoff backoff(idle_policy{2, 1, 10});
+    uint32_t parks = 0;
+    for (int i = 0; i < 5; ++i) {
+        backoff.idle([&](uint32_t timeout_us) {
+            assert(timeout_us == 10);
+            ++parks;
+        });
+    }
+    assert(parks == 2);
+    assert(backoff.parked());
+    backoff.reset();
+    assert(!backoff.parked());
+}
+
 int main() {
     printf("=== Shm Manager Test Suite ===\n\n");
 
     RUN_TEST(create_and_open);
     RUN_TEST(open_or_create_no_reinit);
+    RUN_TEST(map_options_prefault_whole_region);
     RUN_TEST(open_orders_with_dated_name);
+    RUN_TEST(open_orders_runtime_capacity);
+    RUN_TEST(open_orders_windowed_maps_slots_on_demand);
     RUN_TEST(size_mismatch);
     RUN_TEST(create_mode_is_0777_and_ignores_umask);
     RUN_TEST(rejects_file_backend_env);
+    RUN_TEST(spsc_bulk_push_pop_wraps_ring);
+    RUN_TEST(spsc_claim_commit_writes_in_place);
+    RUN_TEST(spsc_byte_ring_variable_records_wrap);
+    RUN_TEST(spsc_byte_ring_cross_thread_order);
+    RUN_TEST(upstream_lane_claim_and_reclaim);
+    RUN_TEST(spinlocks_recover_from_dead_owner_process);
+    RUN_TEST(orders_copy_changed_lines_only_touches_dirty_lines);
+    RUN_TEST(orders_read_slot_reads_published_fields);
+    RUN_TEST(order_id_encodes_epoch_and_slot_index);
+    RUN_TEST(orders_overflow_chain_extends_and_resolves);
+    RUN_TEST(doorbell_wakes_parked_consumer);
 
     printf("\n=== All tests passed! ===\n");
     return 0;
@@ -0,0 +1,159 @@
+#include <cassert>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "strategy/active_strategy.hpp"
+
+#define TEST(name) static void test_##name()
+#define RUN_TEST(name)                   \
+    do {                                 \
+        printf("Running %s... ", #name); \
+        test_##name();                   \
+        printf("PASSED\n");              \
+    } while (0)
+
+namespace {
+
+using namespace acct_service;
+
+#ifndef TEST_STRATEGY_PLUGIN_PATH
+#error "TEST_STRATEGY_PLUGIN_PATH is not defined"
+#endif
+
+ActiveStrategyConfig make_config(const char* name, const std::string& plugin_path = {}) {
+    ActiveStrategyConfig config{};
+    config.enabled = true;
+    config.name = name;
+    config.signal_threshold = 0.5;
+    config.plugin_path = plugin_path;
+    return config;
+}
+
+OrderRequest make_parent() {
+    OrderRequest request;
+    request.init_new("000001", InternalSecurityId("XSHE_000001"), 1, TradeSide::Buy, Market::SZ, 100, 1000, 93000000);
+    return request;
+}
+
+TEST(builtin_strategy_and_unknown_name) {
+    std::string error_message;
+    std::unique_ptr<ActiveStrategy> strategy = StrategyRegistry::create(make_config("prediction_signal"), error_message);
+    assert(strategy != nullptr);
+    assert(error_message.empty());
+
+    assert(StrategyRegistry::create(make_config("none"), error_message) == nullptr);
+    assert(error_message.empty());
+    assert(StrategyRegistry::create(make_config("missing"), error_message) == nullptr);
+    assert(error_message == "unknown active strategy name");
+}
+
+TEST(loads_plugin_and_evaluates_batch) {
+    std::string error_message;
+    std::unique_ptr<ActiveStrategy> strategy =
+        StrategyRegistry::create(make_config("half_budget", TEST_STRATEGY_PLUGIN_PATH), error_message);
+    assert(strategy != nullptr);
+    assert(error_message.empty());
+    assert(std::string(strategy->name()) == "half_budget");
+
+    const OrderRequest parent = make_parent();
+    MarketDataView hit{};
+    hit.prediction.signal = 1.0F;
+    MarketDataView miss{};
+    miss.prediction.signal = 0.1F;
+    const std::vector<ActiveStrategyContext> contexts = {
+        ActiveStrategyContext{parent, hit, 40},
+        ActiveStrategyContext{parent, miss, 40},
+    };
+    std::vector<ActiveDecision> decisions(contexts.size());
+    strategy->evaluate_many(contexts, decisions);
+    assert(decisions[0].should_submit);
+    assert(decisions[0].volume == 20);
+    assert(!decisions[1].should_submit);
+}
+
+MarketDataView make_feature_view(uint64_t publish_seq_no, float signal, uint32_t bid, uint32_t bid_volume,
+                                 uint32_t ask, uint32_t ask_volume, uint64_t trade_volume) {
+    MarketDataView view{};
+    view.prediction.signal = signal;
+    view.prediction.publish_seq_no = publish_seq_no;
+    view.snapshot.total_bid_levels = 1;
+    view.snapshot.total_ask_levels = 1;
+    view.snapshot.bids[0] = snapshot_shm::SnapshotLevel{bid, bid_volume};
+    view.snapshot.asks[0] = snapshot_shm::SnapshotLevel{ask, ask_volume};
+    view.snapshot.trade_volume = trade_volume;
+    return view;
+}
+
+TEST(feature_store_updates_once_per_publish) {
+    SymbolFeatureStore store(3);  // alpha = 0.5
+    const MarketDataHandle handle{2};
+    assert(store.find(handle) == nullptr);
+    assert(store.update(MarketDataHandle{}, make_feature_view(1, 1.0F, 100, 30, 101, 10, 0)) == nullptr);
+    // 未发布过预测（publish_seq_no == 0）时不建立特征
+    assert(store.update(handle, make_feature_view(0, 1.0F, 100, 30, 101, 10, 0)) == nullptr);
+
+    const SymbolFeatures* features = store.update(handle, make_feature_view(1, 1.0F, 100, 30, 102, 10, 1000));
+    assert(features != nullptr);
+    assert(features->updates == 1);
+    assert(features->signal_ema == 1.0F);
+    assert(features->spread == 2);
+    assert(features->queue_imbalance == 0.5F);
+    assert(features->short_volume == 0);
+
+    // 同一发布序号重复纳入不改动特征
+    assert(store.update(handle, make_feature_view(1, 9.0F, 100, 10, 101, 30, 5000)) == features);
+    assert(features->updates == 1);
+    assert(features->signal == 1.0F);
+
+    assert(store.update(handle, make_feature_view(2, 0.0F, 100, 10, 101, 30, 1600)) == features);
+    assert(features->updates == 2);
+    assert(features->signal_ema == 0.5F);
+    assert(features->spread == 1);
+    assert(features->queue_imbalance == -0.5F);
+    assert(features->short_volume == 600);
+    assert(features->history.size() == 2);
+    assert(features->history.signal_at(0) == 0.0F);
+    assert(features->history.signal_at(1) == 1.0F);
+    assert(features->history.spread_at(1) == 2);
+    assert(features->history.signal_at(2) == 0.0F);
+
+    // 短窗成交量只回看 kShortVolumeWindow 次发布，环形历史写满后覆盖最旧条目
+    for (uint64_t seq = 3; seq <= SymbolFeatureHistory::kCapacity + 10; ++seq) {
+        (void)store.update(handle, make_feature_view(seq, 0.0F, 100, 10, 101, 10, 1600 + (seq - 2) * 100));
+    }
+    assert(features->history.size() == SymbolFeatureHistory::kCapacity);
+    assert(features->short_volume == SymbolFeatures::kShortVolumeWindow * 100);
+    assert(features->queue_imbalance == 0.0F);
+    assert(features->history.trade_volume_at(0) == 1600 + (SymbolFeatureHistory::kCapacity + 8) * 100);
+    assert(store.find(handle) == features);
+    assert(store.find(MarketDataHandle{0}) == nullptr);
+}
+
+TEST(plugin_name_mismatch_is_rejected) {
+    std::string error_message;
+    assert(StrategyRegistry::create(make_config("other_name", TEST_STRATEGY_PLUGIN_PATH), error_message) == nullptr);
+    assert(error_message.find("name mismatch") != std::string::npos);
+}
+
+TEST(missing_plugin_file_is_rejected) {
+    std::string error_message;
+    assert(StrategyRegistry::create(make_config("half_budget", "/tmp/not_exists_strategy.so"), error_message) ==
+           nullptr);
+    assert(error_message.find("dlopen failed") != std::string::npos);
+}
+
+}  // namespace
+
+int main() {
+    printf("=== Strategy Registry Test Suite ===\n\n");
+
+    RUN_TEST(builtin_strategy_and_unknown_name);
+    RUN_TEST(loads_plugin_and_evaluates_batch);
+    RUN_TEST(feature_store_updates_once_per_publish);
+    RUN_TEST(plugin_name_mismatch_is_rejected);
+    RUN_TEST(missing_plugin_file_is_rejected);
+
+    printf("\n=== All tests passed! ===\n");
+    return 0;
+}
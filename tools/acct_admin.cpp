@@ -0,0 +1,134 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string_view>
+#include <thread>
+
+#include <unistd.h>
+
+#include "shm/admin_shm.hpp"
+#include "shm/shm_manager.hpp"
+
+namespace acct_service {
+namespace {
+
+constexpr std::chrono::milliseconds kResponsePollInterval{1};
+
+// 打印命令行帮助：向账户服务的运维指令段（<upstream_shm_name>_admin，需开启 shm.admin_channel）投递一条指令，
+// 等待事件循环写回结果；同一段同时只允许一个运维工具实例
+void print_usage(const char* program_name) {
+    std::fprintf(stderr,
+                 "Usage: %s ADMIN_SHM_NAME COMMAND [STRATEGY_ID] [--timeout-ms N]\n"
+                 "  COMMAND: reload | cancel-all | cancel-strategy ID | pause ID | resume ID | dump | checkpoint\n",
+                 program_name);
+}
+
+bool parse_command(std::string_view text, admin_command_type& out) {
+    constexpr admin_command_type kTypes[] = {
+        admin_command_type::ReloadConfig,  admin_command_type::CancelAll,      admin_command_type::CancelStrategy,
+        admin_command_type::PauseStrategy, admin_command_type::ResumeStrategy, admin_command_type::DumpState,
+        admin_command_type::Checkpoint};
+    for (const admin_command_type type : kTypes) {
+        if (text == admin_command_name(type)) {
+            out = type;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool needs_strategy(admin_command_type type) noexcept {
+    return type == admin_command_type::CancelStrategy || type == admin_command_type::PauseStrategy ||
+           type == admin_command_type::ResumeStrategy;
+}
+
+// 退出时交还指令段使用权，覆盖全部返回路径
+class writer_guard {
+public:
+    writer_guard(admin_shm_layout* shm, uint32_t pid) noexcept : shm_(shm), pid_(pid) {}
+    ~writer_guard() { admin_release_writer(shm_, pid_); }
+    writer_guard(const writer_guard&) = delete;
+    writer_guard& operator=(const writer_guard&) = delete;
+
+private:
+    admin_shm_layout* shm_;
+    uint32_t pid_;
+};
+
+}  // namespace
+}  // namespace acct_service
+
+int main(int argc, char** argv) {
+    using namespace acct_service;
+
+    admin_command_type type = admin_command_type::None;
+    if (argc < 3 || !parse_command(argv[2], type)) {
+        print_usage(argv[0]);
+        return 1;
+    }
+    int next = 3;
+    StrategyId strategy_id = 0;
+    if (needs_strategy(type)) {
+        if (argc <= next) {
+            print_usage(argv[0]);
+            return 1;
+        }
+        strategy_id = static_cast<StrategyId>(std::strtoul(argv[next++], nullptr, 10));
+    }
+    unsigned long timeout_ms = 5000;
+    if (argc == next + 2 && std::strcmp(argv[next], "--timeout-ms") == 0) {
+        timeout_ms = std::strtoul(argv[next + 1], nullptr, 10);
+        next += 2;
+    }
+    if (argc != next) {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    SHMManager manager;
+    admin_shm_layout* admin = manager.open_admin(argv[1], shm_mode::Open, 0);
+    if (!admin) {
+        std::fprintf(stderr, "failed to open admin shm %s\n", argv[1]);
+        return 1;
+    }
+
+    // 两个环都是单生产者单消费者，同一时刻只允许一个运维工具实例投递与排空
+    const uint32_t pid = static_cast<uint32_t>(::getpid());
+    uint32_t holder = 0;
+    if (!admin_claim_writer(admin, pid, &holder)) {
+        std::fprintf(stderr, "admin shm %s is in use by another acct_admin (pid %u)\n", argv[1],
+                     static_cast<unsigned>(holder));
+        return 1;
+    }
+    writer_guard guard(admin, pid);
+
+    // 认领后再丢弃上一次运行遗留的结果，按本次指令编号匹配
+    admin_response response{};
+    while (admin_poll_response(admin, response)) {
+    }
+    const uint64_t command_id = now_ns();
+    if (!admin_submit(admin, type, command_id, strategy_id)) {
+        std::fprintf(stderr, "admin command ring is full\n");
+        return 1;
+    }
+
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+    while (std::chrono::steady_clock::now() < deadline) {
+        if (!admin_poll_response(admin, response)) {
+            std::this_thread::sleep_for(kResponsePollInterval);
+            continue;
+        }
+        if (response.command_id != command_id) {
+            continue;
+        }
+        std::printf("command=%s strategy=%u status=%s affected=%u\n", admin_command_name(response.type),
+                    static_cast<unsigned>(response.strategy_id), admin_status_name(response.status),
+                    response.affected);
+        return response.status == admin_command_status::Done || response.status == admin_command_status::Accepted
+                   ? 0
+                   : 2;
+    }
+    std::fprintf(stderr, "timed out waiting for admin response (is the event loop running?)\n");
+    return 1;
+}
@@ -0,0 +1,133 @@
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+#include "shm/shm_layout.hpp"
+#include "shm/shm_manager.hpp"
+
+namespace acct_service {
+namespace {
+
+// 打印命令行帮助：只读打开账户服务的统计段（shm.stats_shm_name）或独立网关的统计段（stats_shm），
+// 输出指标表、风控计数、分阶段延迟、柜台往返延迟与队列深度直方图。
+void print_usage(const char* program_name) {
+    std::fprintf(stderr, "Usage: %s STATS_SHM_NAME [--prometheus]\n", program_name);
+}
+
+// Prometheus 文本格式的指标名只允许 [a-zA-Z0-9_:]
+std::string prometheus_name(const char* name) {
+    std::string out = "acct_";
+    for (const char* cursor = name; *cursor != '\0'; ++cursor) {
+        const char ch = *cursor;
+        const bool valid = (ch >= 'a' && ch <= 'z') || (ch >= 'A' && ch <= 'Z') || (ch >= '0' && ch <= '9');
+        out.push_back(valid ? ch : '_');
+    }
+    return out;
+}
+
+void print_value(bool prometheus, const char* name, const char* type, uint64_t value) {
+    if (prometheus) {
+        const std::string metric = prometheus_name(name);
+        std::printf("# TYPE %s %s\n%s %" PRIu64 "\n", metric.c_str(), type, metric.c_str(), value);
+        return;
+    }
+    std::printf("%s=%" PRIu64 "\n", name, value);
+}
+
+// 所有字段按 relaxed/acquire 读，不与写端同步；各值是读取时刻的近似快照
+void dump(const stats_shm_layout& stats, bool prometheus) {
+    const uint32_t count = std::min<uint32_t>(stats.metrics.slot_count.load(std::memory_order_acquire),
+                                              static_cast<uint32_t>(kMetricSlotCount));
+    for (uint32_t i = 0; i < count; ++i) {
+        const metric_slot& slot = stats.metrics.slots[i];
+        print_value(prometheus, slot.name, slot.kind == metric_kind::Gauge ? "gauge" : "counter",
+                    slot.value.load(std::memory_order_relaxed));
+    }
+
+    const risk_stat_counters& risk = stats.risk;
+    const auto print_risk = [&](const char* name, const std::atomic<uint64_t>& counter) {
+        print_value(prometheus, name, "counter", counter.load(std::memory_order_relaxed));
+    };
+    print_risk("risk.passed", risk.passed);
+    print_risk("risk.rejected_fund", risk.rejected_fund);
+    print_risk("risk.rejected_position", risk.rejected_position);
+    print_risk("risk.rejected_price", risk.rejected_price);
+    print_risk("risk.rejected_value", risk.rejected_value);
+    print_risk("risk.rejected_volume", risk.rejected_volume);
+    print_risk("risk.rejected_turnover", risk.rejected_turnover);
+    print_risk("risk.rejected_duplicate", risk.rejected_duplicate);
+    print_risk("risk.rejected_self_trade", risk.rejected_self_trade);
+    print_risk("risk.rejected_firm_limit", risk.rejected_firm_limit);
+    print_risk("risk.rejected_order_ratio", risk.rejected_order_ratio);
+    print_risk("risk.rejected_rate_limit_account", risk.rejected_rate_limit_account);
+    print_risk("risk.rejected_rate_limit_strategy", risk.rejected_rate_limit_strategy);
+    print_risk("risk.rejected_rate_limit_security", risk.rejected_rate_limit_security);
+    print_risk("risk.rejected_rate_limit_other", risk.rejected_rate_limit_other);
+
+    const auto print_histogram = [&](const std::string& base, const latency_histogram& histogram) {
+        print_value(prometheus, (base + ".count").c_str(), "counter",
+                    histogram.count.load(std::memory_order_acquire));
+        print_value(prometheus, (base + ".p50_ns").c_str(), "gauge", histogram.percentile(0.50));
+        print_value(prometheus, (base + ".p99_ns").c_str(), "gauge", histogram.percentile(0.99));
+        print_value(prometheus, (base + ".p999_ns").c_str(), "gauge", histogram.percentile(0.999));
+        print_value(prometheus, (base + ".max_ns").c_str(), "gauge",
+                    histogram.max_ns.load(std::memory_order_relaxed));
+    };
+    const auto print_stage = [&](const char* stage, const latency_histogram& histogram) {
+        print_histogram(std::string("stage.") + stage, histogram);
+    };
+    print_stage("upstream_to_risk", stats.stages.upstream_to_risk);
+    print_stage("risk_to_downstream", stats.stages.risk_to_downstream);
+    print_stage("response_to_settle", stats.stages.response_to_settle);
+    print_stage("execution_tick", stats.stages.execution_tick);
+
+    // 只输出提交过订单的柜台会话
+    for (std::size_t session = 0; session < kMaxBrokerSessions; ++session) {
+        const broker_session_latency& latency = stats.brokers.sessions[session];
+        if (latency.submit_call.count.load(std::memory_order_acquire) == 0) {
+            continue;
+        }
+        const std::string base = "broker." + std::to_string(session) + ".";
+        print_histogram(base + "submit_call", latency.submit_call);
+        print_histogram(base + "submit_to_accept", latency.submit_to_accept);
+        print_histogram(base + "accept_to_first_trade", latency.accept_to_first_trade);
+    }
+
+    // 只输出有过采样的队列；高水位对照容量即可判断队列容量是否留有余量
+    for (std::size_t queue = 0; queue < kShmQueueCount; ++queue) {
+        const queue_depth_histogram& depth = stats.queues.queues[queue];
+        const uint64_t samples = depth.samples.load(std::memory_order_acquire);
+        if (samples == 0) {
+            continue;
+        }
+        const std::string base = std::string("queue_depth.") + shm_queue_name(static_cast<shm_queue_id>(queue)) + ".";
+        print_value(prometheus, (base + "samples").c_str(), "counter", samples);
+        print_value(prometheus, (base + "p50").c_str(), "gauge", depth.percentile(0.50));
+        print_value(prometheus, (base + "p99").c_str(), "gauge", depth.percentile(0.99));
+        print_value(prometheus, (base + "high_watermark").c_str(), "gauge",
+                    depth.high_watermark.load(std::memory_order_relaxed));
+        print_value(prometheus, (base + "capacity").c_str(), "gauge", depth.capacity.load(std::memory_order_relaxed));
+        print_value(prometheus, (base + "alerts").c_str(), "counter", depth.alerts.load(std::memory_order_relaxed));
+    }
+}
+
+}  // namespace
+}  // namespace acct_service
+
+int main(int argc, char** argv) {
+    if (argc < 2 || argc > 3 || (argc == 3 && std::strcmp(argv[2], "--prometheus") != 0)) {
+        acct_service::print_usage(argv[0]);
+        return 1;
+    }
+
+    acct_service::SHMManager manager;
+    const acct_service::stats_shm_layout* stats = manager.open_stats(argv[1], acct_service::shm_mode::Open, 0);
+    if (!stats) {
+        std::fprintf(stderr, "failed to open stats shm %s\n", argv[1]);
+        return 1;
+    }
+    acct_service::dump(*stats, argc == 3);
+    return 0;
+}
@@ -0,0 +1,141 @@
+#include <atomic>
+#include <chrono>
+#include <cinttypes>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "risk/firm_risk_aggregator.hpp"
+#include "shm/firm_risk_shm.hpp"
+#include "shm/shm_manager.hpp"
+
+namespace acct_service {
+namespace {
+
+std::atomic<bool> g_stop{false};
+
+void handle_signal(int) { g_stop.store(true, std::memory_order_relaxed); }
+
+// 打印命令行帮助：以 ACCOUNT_ID:POSITIONS_SHM_NAME 逐个接入账户持仓段，合计发布到 --output 指定的段。
+void print_usage(const char* program_name) {
+    std::fprintf(stderr,
+                 "Usage: %s --output FIRM_RISK_SHM_NAME --account ID:POSITIONS_SHM_NAME [--account ...]\n"
+                 "          [--interval-us N] [--report-interval-s N] [--once]\n",
+                 program_name);
+}
+
+struct options {
+    std::string output = "/firm_risk_shm";
+    std::vector<std::pair<AccountId, std::string>> accounts;
+    uint32_t interval_us = 100;
+    uint32_t report_interval_s = 10;
+    bool once = false;
+};
+
+bool parse_account(const char* text, std::pair<AccountId, std::string>& out) {
+    const char* colon = std::strchr(text, ':');
+    if (!colon || colon == text || colon[1] == '\0') {
+        return false;
+    }
+    char* end = nullptr;
+    const unsigned long id = std::strtoul(text, &end, 10);
+    if (end != colon) {
+        return false;
+    }
+    out.first = static_cast<AccountId>(id);
+    out.second = colon + 1;
+    return true;
+}
+
+bool parse_options(int argc, char** argv, options& out) {
+    for (int i = 1; i < argc; ++i) {
+        const bool has_value = i + 1 < argc;
+        if (std::strcmp(argv[i], "--output") == 0 && has_value) {
+            out.output = argv[++i];
+        } else if (std::strcmp(argv[i], "--account") == 0 && has_value) {
+            std::pair<AccountId, std::string> account;
+            if (!parse_account(argv[++i], account)) {
+                return false;
+            }
+            out.accounts.push_back(std::move(account));
+        } else if (std::strcmp(argv[i], "--interval-us") == 0 && has_value) {
+            out.interval_us = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (std::strcmp(argv[i], "--report-interval-s") == 0 && has_value) {
+            out.report_interval_s = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (std::strcmp(argv[i], "--once") == 0) {
+            out.once = true;
+        } else {
+            return false;
+        }
+    }
+    return !out.accounts.empty() && !out.output.empty();
+}
+
+void print_totals(const firm_risk_shm_layout& shm) {
+    firm_risk_totals totals;
+    while (!firm_risk_try_read_totals(shm, totals)) {
+    }
+    std::printf("accounts=%u securities=%u holding_volume=%" PRIu64 " traded_buy_value=%" PRIu64
+                " traded_sell_value=%" PRIu64 " frozen_value=%" PRIu64 " version=%" PRIu64 "\n",
+                totals.account_count, shm.security_count.load(std::memory_order_relaxed), totals.holding_volume,
+                totals.traded_buy_value, totals.traded_sell_value, totals.frozen_value, totals.version);
+}
+
+}  // namespace
+}  // namespace acct_service
+
+int main(int argc, char** argv) {
+    using namespace acct_service;
+
+    options opts;
+    if (!parse_options(argc, argv, opts)) {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    // 每个进程重新建段：合计只由本进程维护，残留段的旧值不可信
+    SHMManager output_manager;
+    (void)SHMManager::unlink(opts.output);
+    firm_risk_shm_layout* output = output_manager.open_firm_risk(opts.output, shm_mode::Create, 0);
+    if (!output) {
+        std::fprintf(stderr, "failed to create firm risk shm %s\n", opts.output.c_str());
+        return 1;
+    }
+
+    std::vector<std::unique_ptr<SHMManager>> managers;
+    firm_risk_aggregator aggregator(output);
+    for (const auto& [account_id, name] : opts.accounts) {
+        auto manager = std::make_unique<SHMManager>();
+        const positions_shm_layout* positions = manager->open_positions(name, shm_mode::Open, account_id);
+        if (!positions || !aggregator.add_account(account_id, positions)) {
+            std::fprintf(stderr, "failed to attach account %u positions shm %s\n", account_id, name.c_str());
+            return 1;
+        }
+        managers.push_back(std::move(manager));
+    }
+
+    std::signal(SIGINT, handle_signal);
+    std::signal(SIGTERM, handle_signal);
+
+    auto next_report = std::chrono::steady_clock::now() + std::chrono::seconds(opts.report_interval_s);
+    do {
+        if (aggregator.poll() == 0 && opts.interval_us > 0) {
+            std::this_thread::sleep_for(std::chrono::microseconds(opts.interval_us));
+        }
+        if (opts.report_interval_s > 0 && std::chrono::steady_clock::now() >= next_report) {
+            print_totals(*output);
+            next_report += std::chrono::seconds(opts.report_interval_s);
+        }
+    } while (!opts.once && !g_stop.load(std::memory_order_relaxed));
+
+    print_totals(*output);
+    if (aggregator.unplaced_rows() > 0) {
+        std::fprintf(stderr, "security table full, %" PRIu64 " rows not placed\n", aggregator.unplaced_rows());
+    }
+    return 0;
+}
@@ -1,9 +1,12 @@
+#include <algorithm>
+#include <array>
 #include <chrono>
 #include <cstdio>
 #include <string>
 #include <thread>
 #include <vector>
 
+#include "full_chain_observer_binary_sink.hpp"
 #include "full_chain_observer_config.hpp"
 #include "full_chain_observer_csv_sink.hpp"
 #include "full_chain_observer_order_watch.hpp"
@@ -76,6 +79,72 @@ void print_position_event(const full_chain_observer_position_event& event) {
     }
 }
 
+// 计算已排序样本的近似分位数（最近秩）。
+uint64_t sorted_percentile(const std::vector<uint64_t>& sorted, double quantile) {
+    if (sorted.empty()) {
+        return 0;
+    }
+    const std::size_t rank = static_cast<std::size_t>(quantile * static_cast<double>(sorted.size() - 1) + 0.5);
+    return sorted[std::min(rank, sorted.size() - 1)];
+}
+
+// 输出单项延迟分位数。
+void print_latency_line(const char* hop, std::vector<uint64_t>& samples) {
+    if (samples.empty()) {
+        std::printf("[latency] hop=%s samples=0\n", hop);
+        return;
+    }
+    std::sort(samples.begin(), samples.end());
+    std::printf(
+        "[latency] hop=%s samples=%zu p50_ns=%llu p99_ns=%llu p999_ns=%llu max_ns=%llu\n",
+        hop,
+        samples.size(),
+        static_cast<unsigned long long>(sorted_percentile(samples, 0.50)),
+        static_cast<unsigned long long>(sorted_percentile(samples, 0.99)),
+        static_cast<unsigned long long>(sorted_percentile(samples, 0.999)),
+        static_cast<unsigned long long>(samples.back()));
+}
+
+// 汇总订单全链路打点：逐跳增量（相对上一已到达跳）以及 submit -> 首个回报总耗时。
+void print_latency_summary(const std::vector<acct_orders_mon_latency_t>& latencies) {
+    static constexpr std::array<const char*, ACCT_MON_LATENCY_HOP_COUNT> kHopNames = {
+        "submit_to_upstream_dequeued",
+        "upstream_dequeued_to_risk_accepted",
+        "risk_accepted_to_downstream_queued",
+        "downstream_queued_to_gateway_dequeued",
+        "gateway_dequeued_to_adapter_submitted",
+        "adapter_submitted_to_first_response",
+    };
+
+    std::array<std::vector<uint64_t>, ACCT_MON_LATENCY_HOP_COUNT> hop_samples{};
+    std::vector<uint64_t> tick_to_trade_samples;
+    for (const acct_orders_mon_latency_t& latency : latencies) {
+        uint32_t previous = 0;
+        bool chain_intact = true;
+        for (std::size_t hop = 0; hop < ACCT_MON_LATENCY_HOP_COUNT; ++hop) {
+            const uint32_t delta = latency.hop_delta_ns[hop];
+            if (delta == 0) {
+                chain_intact = false;
+                continue;
+            }
+            if (chain_intact && delta >= previous) {
+                hop_samples[hop].push_back(delta - previous);
+            }
+            previous = delta;
+        }
+        const uint32_t first_response = latency.hop_delta_ns[ACCT_MON_HOP_FIRST_RESPONSE];
+        if (first_response != 0) {
+            tick_to_trade_samples.push_back(first_response);
+        }
+    }
+
+    std::printf("[latency] orders=%zu\n", latencies.size());
+    for (std::size_t hop = 0; hop < ACCT_MON_LATENCY_HOP_COUNT; ++hop) {
+        print_latency_line(kHopNames[hop], hop_samples[hop]);
+    }
+    print_latency_line("submit_to_first_response", tick_to_trade_samples);
+}
+
 }  // namespace
 }  // namespace acct_service
 
@@ -117,45 +186,65 @@ int main(int argc, char** argv) {
         return 1;
     }
 
-    // 4) 打开 CSV 汇总通道（仅维护最新快照，不记录事件流）。
+    // 4) 按输出格式打开 CSV 汇总通道（仅维护最新快照）和/或二进制事件流通道（后台线程落盘）。
+    const bool csv_enabled = observer_config.output_format != observer_output_format::Binary;
+    const bool binary_enabled = observer_config.output_format != observer_output_format::Csv;
     full_chain_observer_csv_sink csv_sink{};
-    if (!csv_sink.open(observer_config.output_dir, &error_message)) {
+    if (csv_enabled && !csv_sink.open(observer_config.output_dir, &error_message)) {
         std::fprintf(stderr, "open csv sink failed: %s\n", error_message.c_str());
         return 1;
     }
+    full_chain_observer_binary_sink binary_sink{};
+    if (binary_enabled && !binary_sink.open(observer_config.output_dir, &error_message)) {
+        std::fprintf(stderr, "open binary sink failed: %s\n", error_message.c_str());
+        return 1;
+    }
 
     const auto start_time = std::chrono::steady_clock::now();
     const auto poll_interval = std::chrono::milliseconds(observer_config.poll_interval_ms);
 
-    // 5) 轮询并输出订单/持仓日志，同时刷新最终快照 CSV。
+    // 5) 轮询并输出订单/持仓日志，同时刷新最终快照 CSV 并把事件交给二进制通道。
+    std::vector<full_chain_observer_order_event> order_events;
+    std::vector<full_chain_observer_position_event> position_events;
     for (;;) {
-        std::vector<full_chain_observer_order_event> order_events;
+        order_events.clear();
         if (!order_watch.poll(&order_events, &error_message)) {
             std::fprintf(stderr, "poll order watch failed: %s\n", error_message.c_str());
             return 1;
         }
         for (const full_chain_observer_order_event& event : order_events) {
-            print_order_event(event);
-            if (!csv_sink.append_order_event(event, &error_message)) {
+            if (observer_config.print_events) {
+                print_order_event(event);
+            }
+            if ((csv_enabled && !csv_sink.append_order_event(event, &error_message)) ||
+                (binary_enabled && !binary_sink.append_order_event(event, &error_message))) {
                 std::fprintf(stderr, "append order event failed: %s\n", error_message.c_str());
                 return 1;
             }
         }
 
-        std::vector<full_chain_observer_position_event> position_events;
+        position_events.clear();
         if (!position_watch.poll(&position_events, &error_message)) {
             std::fprintf(stderr, "poll position watch failed: %s\n", error_message.c_str());
             return 1;
         }
         for (const full_chain_observer_position_event& event : position_events) {
-            print_position_event(event);
-            if (!csv_sink.append_position_event(event, &error_message)) {
+            if (observer_config.print_events) {
+                print_position_event(event);
+            }
+            if ((csv_enabled && !csv_sink.append_position_event(event, &error_message)) ||
+                (binary_enabled && !binary_sink.append_position_event(event, &error_message))) {
                 std::fprintf(stderr, "append position event failed: %s\n", error_message.c_str());
                 return 1;
             }
         }
 
-        csv_sink.flush();
+        if (csv_enabled) {
+            csv_sink.flush();
+        }
+        if (binary_enabled) {
+            binary_sink.flush();
+        }
 
         if (observer_config.timeout_ms > 0) {
             const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
@@ -168,5 +257,20 @@ int main(int argc, char** argv) {
         std::this_thread::sleep_for(poll_interval);
     }
 
+    // 6) 退出前输出全链路逐跳延迟分位数。
+    std::vector<acct_orders_mon_latency_t> latencies;
+    if (!order_watch.collect_latency(&latencies, &error_message)) {
+        std::fprintf(stderr, "collect order latency failed: %s\n", error_message.c_str());
+        return 1;
+    }
+    print_latency_summary(latencies);
+
+    if (binary_enabled) {
+        binary_sink.close();
+        std::printf("[binary] order_records=%llu position_records=%llu\n",
+                    static_cast<unsigned long long>(binary_sink.written_order_records()),
+                    static_cast<unsigned long long>(binary_sink.written_position_records()));
+    }
+
     return 0;
 }
@@ -0,0 +1,210 @@
+#include "full_chain_observer_binary_sink.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <system_error>
+
+namespace acct_service {
+namespace {
+
+// 单路缓冲预留容量：覆盖一次轮询的常见事件量，避免稳态下扩容。
+constexpr std::size_t kReservedRecords = 4096;
+// 后台线程的兜底落盘间隔，轮询线程不 flush 时也能按时写出。
+constexpr auto kWriterIdleInterval = std::chrono::milliseconds(100);
+
+void set_error(std::string* out_error, const std::string& message) {
+    if (out_error != nullptr) {
+        *out_error = message;
+    }
+}
+
+uint64_t unix_time_ns() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                     std::chrono::system_clock::now().time_since_epoch())
+                                     .count());
+}
+
+// 新建事件文件并写入文件头。
+std::FILE* open_record_file(const std::filesystem::path& path, uint16_t record_type, uint32_t record_size) {
+    std::FILE* file = std::fopen(path.c_str(), "wb");
+    if (file == nullptr) {
+        return nullptr;
+    }
+    full_chain_observer_binary_header header{};
+    header.record_type = record_type;
+    header.record_size = record_size;
+    header.create_time_ns = unix_time_ns();
+    if (std::fwrite(&header, sizeof(header), 1, file) != 1 || std::fflush(file) != 0) {
+        std::fclose(file);
+        return nullptr;
+    }
+    return file;
+}
+
+template <typename Record>
+bool write_records(std::FILE* file, const std::vector<Record>& records) {
+    if (records.empty()) {
+        return true;
+    }
+    return std::fwrite(records.data(), sizeof(Record), records.size(), file) == records.size() &&
+           std::fflush(file) == 0;
+}
+
+}  // namespace
+
+full_chain_observer_binary_sink::~full_chain_observer_binary_sink() { close(); }
+
+bool full_chain_observer_binary_sink::open(const std::filesystem::path& output_dir, std::string* out_error) {
+    close();
+
+    std::error_code ec;
+    std::filesystem::create_directories(output_dir, ec);
+    if (ec) {
+        set_error(out_error, std::string("create_directories failed: ") + ec.message());
+        return false;
+    }
+
+    orders_file_ = open_record_file(output_dir / "orders_events.bin", full_chain_observer_binary_header::kOrderRecords,
+                                    static_cast<uint32_t>(sizeof(full_chain_observer_order_record)));
+    positions_file_ =
+        open_record_file(output_dir / "positions_events.bin", full_chain_observer_binary_header::kPositionRecords,
+                         static_cast<uint32_t>(sizeof(full_chain_observer_position_record)));
+    if (orders_file_ == nullptr || positions_file_ == nullptr) {
+        set_error(out_error, std::string("open binary event files failed: ") + std::strerror(errno));
+        close();
+        return false;
+    }
+
+    pending_orders_.reserve(kReservedRecords);
+    pending_positions_.reserve(kReservedRecords);
+    writing_orders_.reserve(kReservedRecords);
+    writing_positions_.reserve(kReservedRecords);
+    stop_ = false;
+    flush_requested_ = false;
+    write_failed_ = false;
+    written_orders_ = 0;
+    written_positions_ = 0;
+    writer_thread_ = std::thread([this] { writer_main(); });
+    return true;
+}
+
+void full_chain_observer_binary_sink::close() noexcept {
+    if (writer_thread_.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        wake_.notify_one();
+        writer_thread_.join();
+    }
+    if (orders_file_ != nullptr) {
+        std::fclose(orders_file_);
+        orders_file_ = nullptr;
+    }
+    if (positions_file_ != nullptr) {
+        std::fclose(positions_file_);
+        positions_file_ = nullptr;
+    }
+    pending_orders_.clear();
+    pending_positions_.clear();
+    writing_orders_.clear();
+    writing_positions_.clear();
+}
+
+bool full_chain_observer_binary_sink::append_order_event(
+    const full_chain_observer_order_event& event, std::string* out_error) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (orders_file_ == nullptr || write_failed_) {
+        set_error(out_error, write_failed_ ? "binary sink write failed" : "binary sink is not opened");
+        return false;
+    }
+    if (event.snapshot.internal_order_id == 0) {
+        return true;
+    }
+    full_chain_observer_order_record& record = pending_orders_.emplace_back();
+    record.observed_time_ns = event.observed_time_ns;
+    record.snapshot = event.snapshot;
+    return true;
+}
+
+bool full_chain_observer_binary_sink::append_position_event(
+    const full_chain_observer_position_event& event, std::string* out_error) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (positions_file_ == nullptr || write_failed_) {
+        set_error(out_error, write_failed_ ? "binary sink write failed" : "binary sink is not opened");
+        return false;
+    }
+    full_chain_observer_position_record& record = pending_positions_.emplace_back();
+    record = full_chain_observer_position_record{};
+    record.observed_time_ns = event.observed_time_ns;
+    record.kind = static_cast<uint8_t>(event.kind);
+    std::memcpy(record.row_key, event.row_key.data(), std::min(event.row_key.size(), kObserverRowKeySize - 1));
+    switch (event.kind) {
+        case full_chain_observer_position_event_kind::Header:
+            record.info = event.info;
+            break;
+        case full_chain_observer_position_event_kind::Fund:
+            record.fund = event.fund;
+            break;
+        case full_chain_observer_position_event_kind::Position:
+        case full_chain_observer_position_event_kind::PositionRemoved:
+            record.position = event.position;
+            break;
+        default:
+            break;
+    }
+    return true;
+}
+
+void full_chain_observer_binary_sink::flush() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        flush_requested_ = true;
+    }
+    wake_.notify_one();
+}
+
+uint64_t full_chain_observer_binary_sink::written_order_records() const noexcept {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return written_orders_;
+}
+
+uint64_t full_chain_observer_binary_sink::written_position_records() const noexcept {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return written_positions_;
+}
+
+// 持锁交换前后台缓冲，锁外写文件，轮询线程追加只与交换互斥。
+bool full_chain_observer_binary_sink::drain_once(std::unique_lock<std::mutex>& lock) {
+    pending_orders_.swap(writing_orders_);
+    pending_positions_.swap(writing_positions_);
+    lock.unlock();
+    const bool ok = write_records(orders_file_, writing_orders_) && write_records(positions_file_, writing_positions_);
+    lock.lock();
+    if (ok) {
+        written_orders_ += writing_orders_.size();
+        written_positions_ += writing_positions_.size();
+    }
+    writing_orders_.clear();
+    writing_positions_.clear();
+    return ok;
+}
+
+void full_chain_observer_binary_sink::writer_main() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (;;) {
+        wake_.wait_for(lock, kWriterIdleInterval, [this] { return stop_ || flush_requested_; });
+        flush_requested_ = false;
+        const bool stopping = stop_;
+        if (!write_failed_ && !drain_once(lock)) {
+            write_failed_ = true;
+        }
+        if (stopping) {
+            return;
+        }
+    }
+}
+
+}  // namespace acct_service
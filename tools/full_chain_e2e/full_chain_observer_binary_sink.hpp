@@ -0,0 +1,104 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "full_chain_observer_order_watch.hpp"
+#include "full_chain_observer_position_watch.hpp"
+
+namespace acct_service {
+
+// 二进制事件文件头（64 字节）：之后紧跟 record_size 定宽记录，可直接按 numpy 结构化 dtype 以 offset=64 整体载入。
+struct full_chain_observer_binary_header {
+    static constexpr uint32_t kMagic = 0x424F4346;  // "FCOB"
+    static constexpr uint16_t kVersion = 1;
+    static constexpr uint16_t kOrderRecords = 1;
+    static constexpr uint16_t kPositionRecords = 2;
+
+    uint32_t magic = kMagic;
+    uint16_t version = kVersion;
+    uint16_t record_type = 0;
+    uint32_t record_size = 0;
+    uint32_t reserved0 = 0;
+    uint64_t create_time_ns = 0;
+    uint8_t reserved[40] = {};
+};
+
+static_assert(sizeof(full_chain_observer_binary_header) == 64, "full_chain_observer_binary_header must be 64 bytes");
+
+// 订单事件记录：观测时刻 + 订单监控 API 的原始快照。
+struct full_chain_observer_order_record {
+    uint64_t observed_time_ns = 0;
+    acct_orders_mon_snapshot_t snapshot{};
+};
+
+static constexpr std::size_t kObserverRowKeySize = 32;
+
+// 持仓事件记录：kind 决定 info/fund/position 中哪一段有效，其余段为零。
+struct full_chain_observer_position_record {
+    uint64_t observed_time_ns = 0;
+    uint8_t kind = 0;  // full_chain_observer_position_event_kind
+    uint8_t reserved[7] = {};
+    char row_key[kObserverRowKeySize] = {};
+    acct_positions_mon_info_t info{};
+    acct_positions_mon_fund_snapshot_t fund{};
+    acct_positions_mon_position_snapshot_t position{};
+};
+
+static_assert(std::is_trivially_copyable_v<full_chain_observer_order_record>, "order record must be trivially copyable");
+static_assert(std::is_trivially_copyable_v<full_chain_observer_position_record>,
+              "position record must be trivially copyable");
+
+// 二进制事件流输出：轮询线程只把快照拷进当前缓冲，后台线程交换缓冲后批量 fwrite，不做任何格式化。
+// 产物为 orders_events.bin / positions_events.bin，记录按观测顺序追加（事件流，而非最终态）。
+class full_chain_observer_binary_sink {
+public:
+    full_chain_observer_binary_sink() = default;
+    ~full_chain_observer_binary_sink();
+
+    full_chain_observer_binary_sink(const full_chain_observer_binary_sink&) = delete;
+    full_chain_observer_binary_sink& operator=(const full_chain_observer_binary_sink&) = delete;
+
+    bool open(const std::filesystem::path& output_dir, std::string* out_error);
+    // 停止后台线程，写完剩余记录后关闭文件。
+    void close() noexcept;
+
+    bool append_order_event(const full_chain_observer_order_event& event, std::string* out_error);
+    bool append_position_event(const full_chain_observer_position_event& event, std::string* out_error);
+    // 唤醒后台线程落盘当前缓冲，不等待写完。
+    void flush();
+
+    uint64_t written_order_records() const noexcept;
+    uint64_t written_position_records() const noexcept;
+
+private:
+    void writer_main();
+    // 交换并写出两路缓冲；返回 false 表示写文件失败。
+    bool drain_once(std::unique_lock<std::mutex>& lock);
+
+    std::FILE* orders_file_{nullptr};
+    std::FILE* positions_file_{nullptr};
+    std::thread writer_thread_{};
+
+    mutable std::mutex mutex_{};
+    std::condition_variable wake_{};
+    bool stop_{false};
+    bool flush_requested_{false};
+    bool write_failed_{false};
+    // 前台缓冲由轮询线程追加，后台缓冲只由写线程在锁外写出
+    std::vector<full_chain_observer_order_record> pending_orders_{};
+    std::vector<full_chain_observer_position_record> pending_positions_{};
+    std::vector<full_chain_observer_order_record> writing_orders_{};
+    std::vector<full_chain_observer_position_record> writing_positions_{};
+    uint64_t written_orders_{0};
+    uint64_t written_positions_{0};
+};
+
+}  // namespace acct_service
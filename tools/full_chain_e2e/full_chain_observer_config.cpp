@@ -41,6 +41,42 @@ bool parse_uint32(const std::string& text, uint32_t* out_value) {
     }
 }
 
+// 解析布尔配置项，仅接受 true/false。
+bool parse_bool(const std::string& text, bool* out_value) {
+    if (out_value == nullptr) {
+        return false;
+    }
+    if (text == "true") {
+        *out_value = true;
+        return true;
+    }
+    if (text == "false") {
+        *out_value = false;
+        return true;
+    }
+    return false;
+}
+
+// 解析输出格式：csv / binary / both。
+bool parse_output_format(const std::string& text, observer_output_format* out_format) {
+    if (out_format == nullptr) {
+        return false;
+    }
+    if (text == "csv") {
+        *out_format = observer_output_format::Csv;
+        return true;
+    }
+    if (text == "binary") {
+        *out_format = observer_output_format::Binary;
+        return true;
+    }
+    if (text == "both") {
+        *out_format = observer_output_format::Both;
+        return true;
+    }
+    return false;
+}
+
 // 校验交易日格式：固定 8 位数字。
 bool is_valid_trading_day(std::string_view trading_day) {
     if (trading_day.size() != 8) {
@@ -117,6 +153,20 @@ bool apply_config_value(
         out_config->timeout_ms = parsed_value;
         return true;
     }
+    if (key == "output_format") {
+        if (!parse_output_format(value, &out_config->output_format)) {
+            *out_error = "invalid value for output_format (expected csv, binary or both)";
+            return false;
+        }
+        return true;
+    }
+    if (key == "print_events") {
+        if (!parse_bool(value, &out_config->print_events)) {
+            *out_error = "invalid value for print_events";
+            return false;
+        }
+        return true;
+    }
 
     *out_error = std::string("unknown observer config key: ") + std::string(key);
     return false;
@@ -152,6 +202,8 @@ bool load_config_yaml(const std::string& config_path, full_chain_observer_config
         "output_dir",
         "poll_interval_ms",
         "timeout_ms",
+        "output_format",
+        "print_events",
     };
 
     // 先在副本上应用，确保失败路径不会污染调用方状态。
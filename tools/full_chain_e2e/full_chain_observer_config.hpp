@@ -5,6 +5,13 @@
 
 namespace acct_service {
 
+// 输出格式：csv 为最终态快照（每轮覆盖写），binary 为定宽二进制事件流（后台线程落盘），both 两者同时输出。
+enum class observer_output_format : uint8_t {
+    Csv,
+    Binary,
+    Both,
+};
+
 // 观测器运行时配置（来自配置文件）。
 struct full_chain_observer_config {
     std::string config_file{};
@@ -14,6 +21,8 @@ struct full_chain_observer_config {
     std::string output_dir{"."};
     uint32_t poll_interval_ms{200};
     uint32_t timeout_ms{30000};
+    observer_output_format output_format{observer_output_format::Csv};
+    bool print_events{true};  // 逐事件打印到终端；高负载下关闭，轮询线程只做快照拷贝
 };
 
 // 参数解析结果。
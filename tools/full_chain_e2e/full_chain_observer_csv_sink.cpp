@@ -2,7 +2,7 @@
 
 #include <cerrno>
 #include <cstring>
-#include <fstream>
+#include <sstream>
 #include <system_error>
 
 #include "full_chain_observer_time.hpp"
@@ -90,6 +90,16 @@ bool full_chain_observer_csv_sink::open(const std::filesystem::path& output_dir,
 
     orders_csv_path_ = output_dir / "orders_final.csv";
     positions_csv_path_ = output_dir / "positions_final.csv";
+    // 快照文件整份重写，单块缓冲即可
+    base_core::AsyncFileWriterConfig out_config;
+    out_config.buffer_bytes = 256 * 1024;
+    out_config.buffer_count = 2;
+    if (!orders_out_.open(orders_csv_path_.string(), true, out_config) ||
+        !positions_out_.open(positions_csv_path_.string(), true, out_config)) {
+        set_error(out_error, std::string("open csv output failed: ") + std::strerror(errno));
+        orders_out_.close();
+        return false;
+    }
     orders_snapshot_.clear();
     positions_snapshot_.clear();
     info_snapshot_ = acct_positions_mon_info_t{};
@@ -104,6 +114,8 @@ bool full_chain_observer_csv_sink::open(const std::filesystem::path& output_dir,
 // 关闭输出并清理缓存快照。
 void full_chain_observer_csv_sink::close() noexcept {
     opened_ = false;
+    orders_out_.close();
+    positions_out_.close();
     orders_csv_path_.clear();
     positions_csv_path_.clear();
     orders_snapshot_.clear();
@@ -166,33 +178,29 @@ void full_chain_observer_csv_sink::flush() {
     }
 
     {
-        std::ofstream orders_stream(orders_csv_path_, std::ios::out | std::ios::trunc);
-        if (orders_stream.is_open()) {
-            orders_stream << "last_update_time,last_update_ns,index,seq,internal_order_id,security_id,internal_security_id,"
-                             "stage,status,volume_entrust,volume_traded,volume_remain,side,dprice_entrust,dprice_traded,"
-                             "price_entrust,price_traded\n";
-            for (const auto& [order_id, snapshot] : orders_snapshot_) {
-                (void)order_id;
-                orders_stream << csv_escape(observer_time::format_unix_time_ns(snapshot.last_update_ns)) << ','
-                              << snapshot.last_update_ns << ',' << snapshot.index << ',' << snapshot.seq << ','
-                              << snapshot.internal_order_id << ','
-                              << csv_escape(make_fixed_string(snapshot.security_id, sizeof(snapshot.security_id))) << ','
-                              << csv_escape(make_fixed_string(snapshot.internal_security_id, sizeof(snapshot.internal_security_id)))
-                              << ',' << static_cast<unsigned>(snapshot.stage) << ','
-                              << static_cast<unsigned>(snapshot.order_status) << ',' << snapshot.volume_entrust << ','
-                              << snapshot.volume_traded << ',' << snapshot.volume_remain << ','
-                              << csv_escape(trade_side_name(snapshot.trade_side)) << ',' << snapshot.dprice_entrust << ','
-                              << snapshot.dprice_traded << ',' << csv_escape(format_decimal_price(snapshot.dprice_entrust))
-                              << ',' << csv_escape(format_decimal_price(snapshot.dprice_traded)) << '\n';
-            }
+        std::ostringstream orders_stream;
+        orders_stream << "last_update_time,last_update_ns,index,seq,internal_order_id,security_id,internal_security_id,"
+                         "stage,status,volume_entrust,volume_traded,volume_remain,side,dprice_entrust,dprice_traded,"
+                         "price_entrust,price_traded\n";
+        for (const auto& [order_id, snapshot] : orders_snapshot_) {
+            (void)order_id;
+            orders_stream << csv_escape(observer_time::format_unix_time_ns(snapshot.last_update_ns)) << ','
+                          << snapshot.last_update_ns << ',' << snapshot.index << ',' << snapshot.seq << ','
+                          << snapshot.internal_order_id << ','
+                          << csv_escape(make_fixed_string(snapshot.security_id, sizeof(snapshot.security_id))) << ','
+                          << csv_escape(make_fixed_string(snapshot.internal_security_id, sizeof(snapshot.internal_security_id)))
+                          << ',' << static_cast<unsigned>(snapshot.stage) << ','
+                          << static_cast<unsigned>(snapshot.order_status) << ',' << snapshot.volume_entrust << ','
+                          << snapshot.volume_traded << ',' << snapshot.volume_remain << ','
+                          << csv_escape(trade_side_name(snapshot.trade_side)) << ',' << snapshot.dprice_entrust << ','
+                          << snapshot.dprice_traded << ',' << csv_escape(format_decimal_price(snapshot.dprice_entrust))
+                          << ',' << csv_escape(format_decimal_price(snapshot.dprice_traded)) << '\n';
         }
+        (void)orders_out_.rewrite(orders_stream.view());
     }
 
     {
-        std::ofstream positions_stream(positions_csv_path_, std::ios::out | std::ios::trunc);
-        if (!positions_stream.is_open()) {
-            return;
-        }
+        std::ostringstream positions_stream;
         positions_stream << "last_update_time,last_update_ns,event_kind,row_key,"
                             "header_position_count,header_last_update_time,header_last_update_ns,"
                             "fund_total_asset,fund_available,fund_frozen,fund_market_value,"
@@ -248,6 +256,7 @@ void full_chain_observer_csv_sink::flush() {
                              << snapshot.volume_sell_traded << ','
                              << '0' << '\n';
         }
+        (void)positions_out_.rewrite(positions_stream.view());
     }
 }
 
@@ -6,10 +6,11 @@
 
 #include "full_chain_observer_order_watch.hpp"
 #include "full_chain_observer_position_watch.hpp"
+#include "utils/async_file_writer.hpp"
 
 namespace acct_service {
 
-// CSV 输出封装：维护 orders/positions 最新快照并覆盖写最终结果。
+// CSV 输出封装：维护 orders/positions 最新快照，flush 时整份渲染后经 AsyncFileWriter 覆盖写，轮询线程不等待磁盘。
 class full_chain_observer_csv_sink {
 public:
     full_chain_observer_csv_sink() = default;
@@ -29,6 +30,8 @@ private:
     bool opened_{false};
     std::filesystem::path orders_csv_path_{};
     std::filesystem::path positions_csv_path_{};
+    base_core::AsyncFileWriter orders_out_{};
+    base_core::AsyncFileWriter positions_out_{};
     std::map<uint32_t, acct_orders_mon_snapshot_t> orders_snapshot_{};
     std::map<std::string, acct_positions_mon_position_snapshot_t> positions_snapshot_{};
     acct_positions_mon_info_t info_snapshot_{};
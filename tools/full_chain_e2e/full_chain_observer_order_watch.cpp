@@ -1,7 +1,7 @@
 #include "full_chain_observer_order_watch.hpp"
 
+#include <algorithm>
 #include <chrono>
-#include <thread>
 
 namespace acct_service {
 namespace {
@@ -20,22 +20,6 @@ void set_error(std::string* out_error, const std::string& message) {
     }
 }
 
-// 在并发写场景下重试读取单个订单槽位，屏蔽短暂 seqlock 冲突。
-acct_mon_error_t read_snapshot_with_retry(
-    acct_orders_mon_ctx_t monitor_ctx, uint32_t index, acct_orders_mon_snapshot_t* out_snapshot) {
-    for (int retry = 0; retry < 16; ++retry) {
-        const acct_mon_error_t rc = acct_orders_mon_read(monitor_ctx, index, out_snapshot);
-        if (rc == ACCT_MON_OK || rc == ACCT_MON_ERR_NOT_FOUND) {
-            return rc;
-        }
-        if (rc != ACCT_MON_ERR_RETRY) {
-            return rc;
-        }
-        std::this_thread::sleep_for(std::chrono::milliseconds(1));
-    }
-    return ACCT_MON_ERR_RETRY;
-}
-
 }  // namespace
 
 // 析构时兜底关闭监控句柄，确保资源释放路径确定。
@@ -66,6 +50,15 @@ bool full_chain_observer_order_watch::open(
     }
 
     last_seq_by_index_.assign(info.capacity, 0);
+    retry_pending_.assign(info.capacity, 0);
+    retry_indices_.clear();
+    retry_indices_.reserve(1024);
+    retry_scratch_.reserve(1024);
+    change_buffer_.resize(1024);
+    range_buffer_.resize(4096);
+    unstable_buffer_.resize(4096);
+    journal_cursor_ = 0;
+    needs_full_scan_ = true;
     return true;
 }
 
@@ -76,9 +69,12 @@ void full_chain_observer_order_watch::close() noexcept {
         monitor_ctx_ = nullptr;
     }
     last_seq_by_index_.clear();
+    retry_pending_.clear();
+    retry_indices_.clear();
+    needs_full_scan_ = true;
 }
 
-// 轮询当前可见订单并输出序号变化事件。
+// 轮询增量事件：首次或游标落后时全量扫描，之后只读变更日志中出现过的槽位；末尾补读延后的冲突槽位。
 bool full_chain_observer_order_watch::poll(
     std::vector<full_chain_observer_order_event>* out_events, std::string* out_error) {
     if (out_events == nullptr) {
@@ -92,6 +88,39 @@ bool full_chain_observer_order_watch::poll(
         return false;
     }
 
+    const bool ok = needs_full_scan_ ? full_scan(out_events, out_error) : poll_journal(out_events, out_error);
+    return ok && drain_retry(out_events, out_error);
+}
+
+// 按变更日志读取变更过的槽位，日志落后时退回全量扫描。
+bool full_chain_observer_order_watch::poll_journal(
+    std::vector<full_chain_observer_order_event>* out_events, std::string* out_error) {
+    while (true) {
+        std::size_t count = 0;
+        const acct_mon_error_t poll_rc = acct_orders_mon_poll_changes(
+            monitor_ctx_, &journal_cursor_, change_buffer_.data(), change_buffer_.size(), &count);
+        if (poll_rc == ACCT_MON_ERR_LAGGED) {
+            return full_scan(out_events, out_error);
+        }
+        if (poll_rc != ACCT_MON_OK) {
+            set_error(out_error,
+                      std::string("acct_orders_mon_poll_changes failed: ") + acct_orders_mon_strerror(poll_rc));
+            return false;
+        }
+        for (std::size_t i = 0; i < count; ++i) {
+            if (!emit_if_changed(change_buffer_[i].index, out_events, out_error)) {
+                return false;
+            }
+        }
+        if (count < change_buffer_.size()) {
+            return true;
+        }
+    }
+}
+
+// 全量扫描当前可见槽位，并把变更游标对齐到扫描起点。
+bool full_chain_observer_order_watch::full_scan(
+    std::vector<full_chain_observer_order_event>* out_events, std::string* out_error) {
     acct_orders_mon_info_t info{};
     const acct_mon_error_t info_rc = acct_orders_mon_info(monitor_ctx_, &info);
     if (info_rc != ACCT_MON_OK) {
@@ -99,34 +128,137 @@ bool full_chain_observer_order_watch::poll(
         return false;
     }
 
+    // 先记下游标再扫描，扫描期间的变更会在下一轮经日志补读，不会遗漏
+    journal_cursor_ = info.journal_cursor;
     if (last_seq_by_index_.size() < info.next_index) {
         last_seq_by_index_.resize(info.next_index, 0);
     }
+    // 分块批量读取，读取时处于写入中的槽位登记到延后重读列表
+    for (uint32_t begin = 0; begin < info.next_index;) {
+        const uint32_t end = std::min<uint32_t>(info.next_index, begin + static_cast<uint32_t>(range_buffer_.size()));
+        std::size_t count = 0;
+        std::size_t unstable = 0;
+        const acct_mon_error_t range_rc = acct_orders_mon_read_range(
+            monitor_ctx_, begin, end, range_buffer_.data(), &count, unstable_buffer_.data(), &unstable);
+        if (range_rc != ACCT_MON_OK && range_rc != ACCT_MON_ERR_RETRY) {
+            set_error(out_error,
+                      std::string("acct_orders_mon_read_range failed: ") + acct_orders_mon_strerror(range_rc));
+            return false;
+        }
+        for (std::size_t i = 0; i < count; ++i) {
+            emit_snapshot(range_buffer_[i], out_events);
+        }
+        for (std::size_t i = 0; i < unstable; ++i) {
+            defer_retry(unstable_buffer_[i]);
+        }
+        begin = end;
+    }
+    needs_full_scan_ = false;
+    return true;
+}
+
+// 读取单个槽位稳定快照，seq 变化才输出事件；API 内有界自旋后仍冲突的槽位延后重读，不阻塞本轮扫描。
+bool full_chain_observer_order_watch::emit_if_changed(
+    uint32_t index, std::vector<full_chain_observer_order_event>* out_events, std::string* out_error) {
+    acct_orders_mon_snapshot_t snapshot{};
+    const acct_mon_error_t read_rc = acct_orders_mon_read(monitor_ctx_, index, &snapshot);
+    if (read_rc == ACCT_MON_ERR_NOT_FOUND) {
+        return true;
+    }
+    if (read_rc == ACCT_MON_ERR_RETRY) {
+        defer_retry(index);
+        return true;
+    }
+    if (read_rc != ACCT_MON_OK) {
+        set_error(out_error, std::string("acct_orders_mon_read failed: ") + acct_orders_mon_strerror(read_rc));
+        return false;
+    }
+    emit_snapshot(snapshot, out_events);
+    return true;
+}
+
+// 同一槽位只登记一次，列表长度不超过容量。
+void full_chain_observer_order_watch::defer_retry(uint32_t index) {
+    if (index >= retry_pending_.size()) {
+        retry_pending_.resize(index + 1, 0);
+    }
+    if (retry_pending_[index] != 0) {
+        return;
+    }
+    retry_pending_[index] = 1;
+    retry_indices_.push_back(index);
+}
+
+// 每轮只补读一遍：仍在写入中的槽位重新登记，留到下一轮。
+bool full_chain_observer_order_watch::drain_retry(
+    std::vector<full_chain_observer_order_event>* out_events, std::string* out_error) {
+    retry_scratch_.swap(retry_indices_);
+    retry_indices_.clear();
+    for (const uint32_t index : retry_scratch_) {
+        retry_pending_[index] = 0;
+    }
+    for (const uint32_t index : retry_scratch_) {
+        if (!emit_if_changed(index, out_events, out_error)) {
+            return false;
+        }
+    }
+    retry_scratch_.clear();
+    return true;
+}
+
+// 按槽位记录最近输出的 seq，相同版本不重复输出。
+void full_chain_observer_order_watch::emit_snapshot(
+    const acct_orders_mon_snapshot_t& snapshot, std::vector<full_chain_observer_order_event>* out_events) {
+    const uint32_t index = snapshot.index;
+    if (index >= last_seq_by_index_.size()) {
+        last_seq_by_index_.resize(index + 1, 0);
+    }
+    if (snapshot.seq == last_seq_by_index_[index]) {
+        return;
+    }
+
+    last_seq_by_index_[index] = snapshot.seq;
+    full_chain_observer_order_event event{};
+    event.observed_time_ns = now_unix_ns();
+    event.snapshot = snapshot;
+    out_events->push_back(event);
+}
+
+// 读取全链路打点：各跳由不同进程单独写入，无需 seqlock 重试。
+bool full_chain_observer_order_watch::collect_latency(
+    std::vector<acct_orders_mon_latency_t>* out_latency, std::string* out_error) {
+    if (out_latency == nullptr) {
+        set_error(out_error, "collect_latency out_latency is null");
+        return false;
+    }
+    out_latency->clear();
+
+    if (monitor_ctx_ == nullptr) {
+        set_error(out_error, "order watch is not opened");
+        return false;
+    }
+
+    acct_orders_mon_info_t info{};
+    const acct_mon_error_t info_rc = acct_orders_mon_info(monitor_ctx_, &info);
+    if (info_rc != ACCT_MON_OK) {
+        set_error(out_error, std::string("acct_orders_mon_info failed: ") + acct_orders_mon_strerror(info_rc));
+        return false;
+    }
 
     for (uint32_t index = 0; index < info.next_index; ++index) {
-        acct_orders_mon_snapshot_t snapshot{};
-        const acct_mon_error_t read_rc = read_snapshot_with_retry(monitor_ctx_, index, &snapshot);
+        acct_orders_mon_latency_t latency{};
+        const acct_mon_error_t read_rc = acct_orders_mon_read_latency(monitor_ctx_, index, &latency);
         if (read_rc == ACCT_MON_ERR_NOT_FOUND) {
             continue;
         }
         if (read_rc != ACCT_MON_OK) {
-            set_error(out_error, std::string("acct_orders_mon_read failed: ") + acct_orders_mon_strerror(read_rc));
+            set_error(
+                out_error, std::string("acct_orders_mon_read_latency failed: ") + acct_orders_mon_strerror(read_rc));
             return false;
         }
-
-        if (index >= last_seq_by_index_.size()) {
-            last_seq_by_index_.resize(index + 1, 0);
-        }
-
-        if (snapshot.seq == last_seq_by_index_[index]) {
-            continue;
+        if (latency.submit_ns != 0) {
+            out_latency->push_back(latency);
         }
-
-        last_seq_by_index_[index] = snapshot.seq;
-        full_chain_observer_order_event event{};
-        event.observed_time_ns = now_unix_ns();
-        event.snapshot = snapshot;
-        out_events->push_back(event);
     }
 
     return true;
@@ -32,10 +32,34 @@ public:
     bool open(const full_chain_observer_order_watch_options& options, std::string* out_error);
     void close() noexcept;
     bool poll(std::vector<full_chain_observer_order_event>* out_events, std::string* out_error);
+    // 读取当前全部可见槽位的全链路打点（仅返回已打点 submit 的订单）。
+    bool collect_latency(std::vector<acct_orders_mon_latency_t>* out_latency, std::string* out_error);
 
 private:
+    // 读取单个槽位，seq 变化时追加事件；NOT_FOUND 视为跳过
+    bool emit_if_changed(uint32_t index, std::vector<full_chain_observer_order_event>* out_events,
+                         std::string* out_error);
+    // 稳定快照 seq 变化时追加事件
+    void emit_snapshot(const acct_orders_mon_snapshot_t& snapshot,
+                       std::vector<full_chain_observer_order_event>* out_events);
+    // 全量扫描 [0, next_index)：首次轮询或变更游标落后时使用
+    bool full_scan(std::vector<full_chain_observer_order_event>* out_events, std::string* out_error);
+    // 按变更日志增量读取
+    bool poll_journal(std::vector<full_chain_observer_order_event>* out_events, std::string* out_error);
+    // 登记写入冲突的槽位，本轮末尾再补读
+    void defer_retry(uint32_t index);
+    bool drain_retry(std::vector<full_chain_observer_order_event>* out_events, std::string* out_error);
+
     acct_orders_mon_ctx_t monitor_ctx_{nullptr};
     std::vector<uint64_t> last_seq_by_index_{};
+    std::vector<acct_orders_mon_change_t> change_buffer_{};
+    std::vector<acct_orders_mon_snapshot_t> range_buffer_{};
+    std::vector<uint32_t> unstable_buffer_{};
+    std::vector<uint32_t> retry_indices_{};  // 延后重读的槽位，按登记顺序
+    std::vector<uint32_t> retry_scratch_{};
+    std::vector<uint8_t> retry_pending_{};   // 按槽位标记是否已在 retry_indices_ 中
+    uint64_t journal_cursor_{0};
+    bool needs_full_scan_{true};
 };
 
 }  // namespace acct_service
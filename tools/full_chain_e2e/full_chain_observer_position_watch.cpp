@@ -1,8 +1,10 @@
 #include "full_chain_observer_position_watch.hpp"
 
+#include <algorithm>
 #include <chrono>
 #include <cstring>
 #include <thread>
+#include <type_traits>
 
 namespace acct_service {
 namespace {
@@ -50,25 +52,12 @@ bool is_same_fund(const acct_positions_mon_fund_snapshot_t& lhs, const acct_posi
            lhs.count_order == rhs.count_order;
 }
 
-// 比较证券行快照是否有变化。
+// 比较证券行快照是否有变化：快照为无填充的定长结构，按整行比较（memcmp 以 64 字节向量块比较），
+// 不再逐字段展开。
 bool is_same_position(const acct_positions_mon_position_snapshot_t& lhs, const acct_positions_mon_position_snapshot_t& rhs) {
-    return lhs.index == rhs.index &&
-           lhs.row_index == rhs.row_index &&
-           lhs.last_update_ns == rhs.last_update_ns &&
-           std::memcmp(lhs.id, rhs.id, sizeof(lhs.id)) == 0 &&
-           std::memcmp(lhs.name, rhs.name, sizeof(lhs.name)) == 0 &&
-           lhs.available == rhs.available &&
-           lhs.volume_available_t0 == rhs.volume_available_t0 &&
-           lhs.volume_available_t1 == rhs.volume_available_t1 &&
-           lhs.volume_buy == rhs.volume_buy &&
-           lhs.dvalue_buy == rhs.dvalue_buy &&
-           lhs.volume_buy_traded == rhs.volume_buy_traded &&
-           lhs.dvalue_buy_traded == rhs.dvalue_buy_traded &&
-           lhs.volume_sell == rhs.volume_sell &&
-           lhs.dvalue_sell == rhs.dvalue_sell &&
-           lhs.volume_sell_traded == rhs.volume_sell_traded &&
-           lhs.dvalue_sell_traded == rhs.dvalue_sell_traded &&
-           lhs.count_order == rhs.count_order;
+    static_assert(std::has_unique_object_representations_v<acct_positions_mon_position_snapshot_t>,
+                  "position snapshot must not contain padding");
+    return std::memcmp(&lhs, &rhs, sizeof(lhs)) == 0;
 }
 
 // 从证券快照中提取稳定行键，用于终端与 CSV 定位。
@@ -195,6 +184,10 @@ bool full_chain_observer_position_watch::open(
     has_last_fund_ = false;
     last_positions_.assign(info.position_count, acct_positions_mon_position_snapshot_t{});
     has_last_positions_.assign(info.position_count, 0U);
+    // 一次 poll_dirty 即可取回全部行（含资金行），游标从 0 开始先拉取全部已写入行
+    dirty_rows_.assign(static_cast<std::size_t>(info.capacity) + 1, 0U);
+    dirty_cursor_ = 0;
+    visible_count_ = 0;
 
     return true;
 }
@@ -210,10 +203,45 @@ void full_chain_observer_position_watch::close() noexcept {
     last_fund_ = acct_positions_mon_fund_snapshot_t{};
     last_positions_.clear();
     has_last_positions_.clear();
+    dirty_rows_.clear();
+    dirty_cursor_ = 0;
+    visible_count_ = 0;
     has_last_info_ = false;
     has_last_fund_ = false;
 }
 
+bool full_chain_observer_position_watch::refresh_position(
+    uint32_t index, std::vector<full_chain_observer_position_event>* out_events, std::string* out_error) {
+    acct_positions_mon_position_snapshot_t snapshot{};
+    const acct_pos_mon_error_t position_rc = read_position_with_retry(monitor_ctx_, index, &snapshot);
+    if (position_rc == ACCT_POS_MON_ERR_NOT_FOUND) {
+        return true;
+    }
+    if (position_rc != ACCT_POS_MON_OK) {
+        set_error(out_error,
+                  std::string("acct_positions_mon_read_position failed: ") + acct_positions_mon_strerror(position_rc));
+        return false;
+    }
+
+    const std::size_t idx = static_cast<std::size_t>(index);
+    if (has_last_positions_[idx] == 0U || !is_same_position(last_positions_[idx], snapshot)) {
+        append_position_event(snapshot, out_events);
+        last_positions_[idx] = snapshot;
+        has_last_positions_[idx] = 1U;
+    }
+    return true;
+}
+
+bool full_chain_observer_position_watch::scan_positions(
+    uint32_t begin, uint32_t end, std::vector<full_chain_observer_position_event>* out_events, std::string* out_error) {
+    for (uint32_t index = begin; index < end; ++index) {
+        if (!refresh_position(index, out_events, out_error)) {
+            return false;
+        }
+    }
+    return true;
+}
+
 // 轮询持仓变化并输出 header/fund/position 增量事件。
 bool full_chain_observer_position_watch::poll(
     std::vector<full_chain_observer_position_event>* out_events, std::string* out_error) {
@@ -261,25 +289,36 @@ bool full_chain_observer_position_watch::poll(
         has_last_positions_.resize(visible_count, 0U);
     }
 
-    for (uint32_t index = 0; index < info.position_count; ++index) {
-        acct_positions_mon_position_snapshot_t snapshot{};
-        const acct_pos_mon_error_t position_rc = read_position_with_retry(monitor_ctx_, index, &snapshot);
-        if (position_rc == ACCT_POS_MON_ERR_NOT_FOUND) {
-            continue;
+    // 已可见的行只重读游标以来变更过的；新可见的行可能在可见之前就被游标越过，整段补读一次
+    const uint32_t known_count = std::min(visible_count_, info.position_count);
+    bool full_scan = dirty_rows_.empty();
+    while (!full_scan) {
+        std::size_t dirty_count = 0;
+        const acct_pos_mon_error_t dirty_rc = acct_positions_mon_poll_dirty(
+            monitor_ctx_, &dirty_cursor_, dirty_rows_.data(), dirty_rows_.size(), &dirty_count);
+        if (dirty_rc != ACCT_POS_MON_OK) {
+            full_scan = true;
+            break;
         }
-        if (position_rc != ACCT_POS_MON_OK) {
-            set_error(out_error, std::string("acct_positions_mon_read_position failed: ") +
-                                     acct_positions_mon_strerror(position_rc));
-            return false;
+        for (std::size_t i = 0; i < dirty_count; ++i) {
+            const uint32_t row = dirty_rows_[i];
+            if (row == 0 || row > known_count) {
+                continue;
+            }
+            if (!refresh_position(row - 1, out_events, out_error)) {
+                visible_count_ = 0;  // 游标已越过这些行，下一轮整段重读
+                return false;
+            }
         }
-
-        const std::size_t idx = static_cast<std::size_t>(index);
-        if (has_last_positions_[idx] == 0U || !is_same_position(last_positions_[idx], snapshot)) {
-            append_position_event(snapshot, out_events);
-            last_positions_[idx] = snapshot;
-            has_last_positions_[idx] = 1U;
+        if (dirty_count < dirty_rows_.size()) {
+            break;
         }
     }
+    if (!scan_positions(full_scan ? 0 : known_count, info.position_count, out_events, out_error)) {
+        visible_count_ = 0;
+        return false;
+    }
+    visible_count_ = info.position_count;
 
     for (std::size_t idx = visible_count; idx < has_last_positions_.size(); ++idx) {
         if (has_last_positions_[idx] != 0U) {
@@ -32,6 +32,8 @@ struct full_chain_observer_position_watch_options {
 };
 
 // 持仓监控封装：负责对接 position_monitor_api 并输出增量事件。
+// 证券行按 poll_dirty 的行变更游标只重读变更过的行，再与连续存放的上一轮快照整行比较；
+// 游标不可用时回落为逐行全量扫描。
 class full_chain_observer_position_watch {
 public:
     full_chain_observer_position_watch() = default;
@@ -45,12 +47,22 @@ public:
     bool poll(std::vector<full_chain_observer_position_event>* out_events, std::string* out_error);
 
 private:
+    // 读取并比较一行证券快照，有变化时输出事件；返回 false 表示读取失败。
+    bool refresh_position(uint32_t index, std::vector<full_chain_observer_position_event>* out_events,
+                          std::string* out_error);
+    // 逐行扫描 [begin, end)：新可见的行与游标不可用时使用。
+    bool scan_positions(uint32_t begin, uint32_t end, std::vector<full_chain_observer_position_event>* out_events,
+                        std::string* out_error);
+
     acct_positions_mon_ctx_t monitor_ctx_{nullptr};
 
     acct_positions_mon_info_t last_info_{};
     acct_positions_mon_fund_snapshot_t last_fund_{};
     std::vector<acct_positions_mon_position_snapshot_t> last_positions_{};
     std::vector<uint8_t> has_last_positions_{};
+    std::vector<uint32_t> dirty_rows_{};  // poll_dirty 输出缓冲，打开时预留
+    uint64_t dirty_cursor_{0};
+    uint32_t visible_count_{0};  // 上一轮已覆盖的可见行数
 
     bool has_last_info_{false};
     bool has_last_fund_{false};
@@ -0,0 +1,528 @@
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+#include "api/order_api.h"
+#include "api/order_monitor_api.h"
+
+namespace acct_service {
+namespace {
+
+// 单个篮子的条数上限，篮子缓冲按此大小放在栈上。
+constexpr std::size_t kMaxBasketSize = 256;
+// 门限未通过的退出码：与参数/初始化失败（1）区分开，便于发布流水线判断是否为性能回退。
+constexpr int kGateFailedExitCode = 2;
+
+// 压测命令行参数集合；同一组参数与种子生成完全相同的发单序列。
+struct order_load_gen_options {
+    std::string upstream_shm_name{"/upstream_order_shm"};
+    std::string orders_shm_name{"/orders_shm"};
+    std::string trading_day{"19700101"};
+    std::vector<std::string> securities{};
+    uint8_t market{0};
+    uint64_t volume{100};
+    double price{0.0};
+    uint8_t passive_exec_algo{ACCT_PASSIVE_EXEC_DEFAULT};
+    uint64_t rate{1000};
+    uint64_t duration_ms{10000};
+    uint64_t burst{1};
+    uint64_t basket{1};
+    double cancel_ratio{0.0};
+    double buy_ratio{0.5};
+    uint64_t seed{1};
+    uint64_t drain_ms{2000};
+    uint64_t max_p99_us{0};
+    double min_throughput{0.0};
+};
+
+// 发单阶段的调用侧统计：API 返回即计时结束，不含账户服务处理。
+struct load_counters {
+    uint64_t submitted{0};
+    uint64_t submit_failed{0};
+    uint64_t queue_full{0};
+    uint64_t cancels_sent{0};
+    uint64_t cancel_failed{0};
+    uint64_t late_ticks{0};
+    std::vector<uint64_t> api_call_ns{};
+};
+
+// 用 RAII 托管 acct_ctx_t，确保退出路径都能释放上下文。
+class acct_context_guard {
+public:
+    acct_context_guard() = default;
+    ~acct_context_guard() {
+        if (ctx_ != nullptr) {
+            (void)acct_destroy(ctx_);
+        }
+    }
+
+    acct_context_guard(const acct_context_guard&) = delete;
+    acct_context_guard& operator=(const acct_context_guard&) = delete;
+
+    acct_ctx_t* out_ctx() { return &ctx_; }
+    acct_ctx_t get() const noexcept { return ctx_; }
+
+private:
+    acct_ctx_t ctx_{nullptr};
+};
+
+// 用 RAII 托管订单池监控句柄。
+class monitor_context_guard {
+public:
+    monitor_context_guard() = default;
+    ~monitor_context_guard() {
+        if (ctx_ != nullptr) {
+            (void)acct_orders_mon_close(ctx_);
+        }
+    }
+
+    monitor_context_guard(const monitor_context_guard&) = delete;
+    monitor_context_guard& operator=(const monitor_context_guard&) = delete;
+
+    acct_orders_mon_ctx_t* out_ctx() { return &ctx_; }
+    acct_orders_mon_ctx_t get() const noexcept { return ctx_; }
+
+private:
+    acct_orders_mon_ctx_t ctx_{nullptr};
+};
+
+// 打印命令行帮助，说明负载形态与门限参数。
+void print_usage(const char* program_name) {
+    std::fprintf(stderr,
+                 "Usage: %s --security CODE[,CODE...] --market sz|sh|bj|hk --price P\n"
+                 "          [--volume N] [--rate ORDERS_PER_SEC] [--duration-ms N] [--burst N] [--basket N]\n"
+                 "          [--cancel-ratio R] [--buy-ratio R] [--seed N] [--drain-ms N]\n"
+                 "          [--passive-exec-algo default|none|fixed|twap|vwap|iceberg]\n"
+                 "          [--upstream-shm NAME] [--orders-shm NAME] [--trading-day YYYYMMDD]\n"
+                 "          [--max-p99-us N] [--min-throughput ORDERS_PER_SEC]\n",
+                 program_name);
+}
+
+// 解析 uint64 参数，失败时返回 false。
+bool parse_uint64(const char* text, uint64_t* out_value) {
+    if (text == nullptr || out_value == nullptr) {
+        return false;
+    }
+    char* end = nullptr;
+    errno = 0;
+    const unsigned long long parsed = std::strtoull(text, &end, 10);
+    if (errno != 0 || end == text || *end != '\0') {
+        return false;
+    }
+    *out_value = static_cast<uint64_t>(parsed);
+    return true;
+}
+
+// 解析 double 参数，失败时返回 false。
+bool parse_double(const char* text, double* out_value) {
+    if (text == nullptr || out_value == nullptr) {
+        return false;
+    }
+    char* end = nullptr;
+    errno = 0;
+    const double parsed = std::strtod(text, &end);
+    if (errno != 0 || end == text || *end != '\0') {
+        return false;
+    }
+    *out_value = parsed;
+    return true;
+}
+
+// 解析市场文本到 C API 枚举值。
+bool parse_market(std::string_view text, uint8_t* out_market) {
+    if (text == "sz" || text == "1") {
+        *out_market = ACCT_MARKET_SZ;
+    } else if (text == "sh" || text == "2") {
+        *out_market = ACCT_MARKET_SH;
+    } else if (text == "bj" || text == "3") {
+        *out_market = ACCT_MARKET_BJ;
+    } else if (text == "hk" || text == "4") {
+        *out_market = ACCT_MARKET_HK;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+// 解析逐单被动执行算法文本到 C API 枚举值。
+bool parse_passive_exec_algo(std::string_view text, uint8_t* out_algo) {
+    if (text == "default") {
+        *out_algo = ACCT_PASSIVE_EXEC_DEFAULT;
+    } else if (text == "none") {
+        *out_algo = ACCT_PASSIVE_EXEC_NONE;
+    } else if (text == "fixed" || text == "fixed_size") {
+        *out_algo = ACCT_PASSIVE_EXEC_FIXED_SIZE;
+    } else if (text == "twap") {
+        *out_algo = ACCT_PASSIVE_EXEC_TWAP;
+    } else if (text == "vwap") {
+        *out_algo = ACCT_PASSIVE_EXEC_VWAP;
+    } else if (text == "iceberg") {
+        *out_algo = ACCT_PASSIVE_EXEC_ICEBERG;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+// 按逗号切分证券列表，忽略空项。
+std::vector<std::string> split_securities(std::string_view text) {
+    std::vector<std::string> result;
+    while (!text.empty()) {
+        const std::size_t comma = text.find(',');
+        const std::string_view item = text.substr(0, comma);
+        if (!item.empty()) {
+            result.emplace_back(item);
+        }
+        if (comma == std::string_view::npos) {
+            break;
+        }
+        text.remove_prefix(comma + 1);
+    }
+    return result;
+}
+
+// 解析命令行参数并校验负载形态的取值范围。
+bool parse_cli_args(int argc, char** argv, order_load_gen_options* out_options) {
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (i + 1 >= argc) {
+            std::fprintf(stderr, "missing value for %s\n", arg.c_str());
+            return false;
+        }
+        const char* value = argv[++i];
+        bool ok = true;
+        if (arg == "--upstream-shm") {
+            out_options->upstream_shm_name = value;
+        } else if (arg == "--orders-shm") {
+            out_options->orders_shm_name = value;
+        } else if (arg == "--trading-day") {
+            out_options->trading_day = value;
+        } else if (arg == "--security") {
+            out_options->securities = split_securities(value);
+        } else if (arg == "--market") {
+            ok = parse_market(value, &out_options->market);
+        } else if (arg == "--volume") {
+            ok = parse_uint64(value, &out_options->volume);
+        } else if (arg == "--price") {
+            ok = parse_double(value, &out_options->price);
+        } else if (arg == "--passive-exec-algo") {
+            ok = parse_passive_exec_algo(value, &out_options->passive_exec_algo);
+        } else if (arg == "--rate") {
+            ok = parse_uint64(value, &out_options->rate);
+        } else if (arg == "--duration-ms") {
+            ok = parse_uint64(value, &out_options->duration_ms);
+        } else if (arg == "--burst") {
+            ok = parse_uint64(value, &out_options->burst);
+        } else if (arg == "--basket") {
+            ok = parse_uint64(value, &out_options->basket);
+        } else if (arg == "--cancel-ratio") {
+            ok = parse_double(value, &out_options->cancel_ratio);
+        } else if (arg == "--buy-ratio") {
+            ok = parse_double(value, &out_options->buy_ratio);
+        } else if (arg == "--seed") {
+            ok = parse_uint64(value, &out_options->seed);
+        } else if (arg == "--drain-ms") {
+            ok = parse_uint64(value, &out_options->drain_ms);
+        } else if (arg == "--max-p99-us") {
+            ok = parse_uint64(value, &out_options->max_p99_us);
+        } else if (arg == "--min-throughput") {
+            ok = parse_double(value, &out_options->min_throughput);
+        } else {
+            std::fprintf(stderr, "unknown argument: %s\n", arg.c_str());
+            return false;
+        }
+        if (!ok) {
+            std::fprintf(stderr, "invalid %s value: %s\n", arg.c_str(), value);
+            return false;
+        }
+    }
+
+    if (out_options->securities.empty() || out_options->market == 0 || out_options->price <= 0.0 ||
+        out_options->volume == 0) {
+        std::fprintf(stderr, "missing required arguments\n");
+        return false;
+    }
+    if (out_options->rate == 0 || out_options->duration_ms == 0 || out_options->burst == 0 ||
+        out_options->basket == 0 || out_options->basket > kMaxBasketSize) {
+        std::fprintf(stderr, "rate/duration/burst must be positive and basket in [1, %zu]\n", kMaxBasketSize);
+        return false;
+    }
+    if (out_options->cancel_ratio < 0.0 || out_options->cancel_ratio > 1.0 || out_options->buy_ratio < 0.0 ||
+        out_options->buy_ratio > 1.0) {
+        std::fprintf(stderr, "cancel-ratio and buy-ratio must be in [0, 1]\n");
+        return false;
+    }
+    return true;
+}
+
+// 判断是否仅请求帮助信息。
+bool wants_help(int argc, char** argv) {
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg = argv[i];
+        if (arg == "--help" || arg == "-h") {
+            return true;
+        }
+    }
+    return false;
+}
+
+// 计算已排序样本的近似分位数（最近秩），与 full_chain_observer 的汇总口径一致。
+uint64_t sorted_percentile(const std::vector<uint64_t>& sorted, double quantile) {
+    if (sorted.empty()) {
+        return 0;
+    }
+    const std::size_t rank = static_cast<std::size_t>(quantile * static_cast<double>(sorted.size() - 1) + 0.5);
+    return sorted[std::min(rank, sorted.size() - 1)];
+}
+
+// 输出单项延迟分位数，返回 p99 供门限判断。
+uint64_t print_latency_line(const char* name, std::vector<uint64_t>& samples) {
+    if (samples.empty()) {
+        std::printf("[load] latency=%s samples=0\n", name);
+        return 0;
+    }
+    std::sort(samples.begin(), samples.end());
+    const uint64_t p99 = sorted_percentile(samples, 0.99);
+    std::printf("[load] latency=%s samples=%zu p50_ns=%llu p90_ns=%llu p99_ns=%llu p999_ns=%llu max_ns=%llu\n", name,
+                samples.size(), static_cast<unsigned long long>(sorted_percentile(samples, 0.50)),
+                static_cast<unsigned long long>(sorted_percentile(samples, 0.90)), static_cast<unsigned long long>(p99),
+                static_cast<unsigned long long>(sorted_percentile(samples, 0.999)),
+                static_cast<unsigned long long>(samples.back()));
+    return p99;
+}
+
+// 按固定节拍发单：每拍发 burst 个单元（单笔或篮子），撤单挑选上一拍成功的订单，节拍落后时不补发只计数。
+double run_load(const order_load_gen_options& options, acct_ctx_t ctx, load_counters& counters,
+                std::vector<uint32_t>& order_ids) {
+    std::mt19937_64 rng(options.seed);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    std::uniform_int_distribution<std::size_t> pick_security(0, options.securities.size() - 1);
+
+    const uint64_t orders_per_tick = options.burst * options.basket;
+    const uint64_t total_ticks = std::max<uint64_t>(1, options.rate * options.duration_ms / 1000 / orders_per_tick);
+    const auto tick_interval =
+        std::chrono::nanoseconds(static_cast<int64_t>(1'000'000'000ULL * orders_per_tick / options.rate));
+
+    std::array<acct_order_spec_t, kMaxBasketSize> specs{};
+    std::array<uint32_t, kMaxBasketSize> ids{};
+    std::array<acct_error_t, kMaxBasketSize> results{};
+    std::vector<uint32_t> cancel_candidates;
+    order_ids.reserve(total_ticks * orders_per_tick);
+    counters.api_call_ns.reserve(total_ticks * options.burst);
+
+    const auto started = std::chrono::steady_clock::now();
+    auto next_tick = started;
+    for (uint64_t tick = 0; tick < total_ticks; ++tick) {
+        auto now = std::chrono::steady_clock::now();
+        if (now < next_tick) {
+            std::this_thread::sleep_until(next_tick);
+        } else if (now - next_tick > tick_interval) {
+            ++counters.late_ticks;
+        }
+        next_tick += tick_interval;
+
+        // 撤单在本拍新单之前发出，保证被撤单已在上游队列中先于撤单请求。
+        for (uint32_t orig_id : cancel_candidates) {
+            uint32_t cancel_id = 0;
+            if (acct_cancel_order(ctx, orig_id, 0, &cancel_id) == ACCT_OK) {
+                ++counters.cancels_sent;
+            } else {
+                ++counters.cancel_failed;
+            }
+        }
+        cancel_candidates.clear();
+
+        for (uint64_t unit_index = 0; unit_index < options.burst; ++unit_index) {
+            for (uint64_t i = 0; i < options.basket; ++i) {
+                acct_order_spec_t& spec = specs[i];
+                spec = acct_order_spec_t{};
+                spec.security_id = options.securities[pick_security(rng)].c_str();
+                spec.volume = options.volume;
+                spec.price = options.price;
+                spec.side = unit(rng) < options.buy_ratio ? ACCT_SIDE_BUY : ACCT_SIDE_SELL;
+                spec.market = options.market;
+                spec.passive_exec_algo = options.passive_exec_algo;
+            }
+
+            const auto call_begin = std::chrono::steady_clock::now();
+            if (options.basket == 1) {
+                acct_order_exec_options_t exec_options{};
+                exec_options.passive_exec_algo = specs[0].passive_exec_algo;
+                results[0] = acct_submit_order_ex(ctx, specs[0].security_id, specs[0].side, specs[0].market,
+                                                  specs[0].volume, specs[0].price, 0, &exec_options, &ids[0]);
+            } else {
+                (void)acct_submit_orders(ctx, specs.data(), options.basket, ids.data(), results.data());
+            }
+            counters.api_call_ns.push_back(static_cast<uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - call_begin)
+                    .count()));
+
+            for (uint64_t i = 0; i < options.basket; ++i) {
+                if (results[i] != ACCT_OK) {
+                    ++counters.submit_failed;
+                    if (results[i] == ACCT_ERR_QUEUE_FULL) {
+                        ++counters.queue_full;
+                    }
+                    continue;
+                }
+                ++counters.submitted;
+                order_ids.push_back(ids[i]);
+                // 每笔成功订单都消耗一次随机数，撤单比例变化不影响方向与证券序列。
+                if (unit(rng) < options.cancel_ratio) {
+                    cancel_candidates.push_back(ids[i]);
+                }
+            }
+        }
+    }
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+}
+
+// 发单结束后读取本次订单的全链路打点；pool_begin 之前的槽位属于其他进程或更早的运行，不计入报告。
+bool collect_chain_latency(acct_orders_mon_ctx_t monitor, uint32_t pool_begin, const std::vector<uint32_t>& order_ids,
+                           std::vector<uint64_t>& upstream_samples, std::vector<uint64_t>& first_response_samples,
+                           uint64_t& risk_rejected, uint64_t& unanswered) {
+    acct_orders_mon_info_t info{};
+    if (acct_orders_mon_info(monitor, &info) != ACCT_MON_OK) {
+        std::fprintf(stderr, "acct_orders_mon_info failed\n");
+        return false;
+    }
+
+    const std::unordered_set<uint32_t> ours(order_ids.begin(), order_ids.end());
+    for (uint32_t index = pool_begin; index < info.next_index; ++index) {
+        acct_orders_mon_snapshot_t snapshot{};
+        acct_mon_error_t rc = ACCT_MON_ERR_RETRY;
+        for (int retry = 0; retry < 16 && rc == ACCT_MON_ERR_RETRY; ++retry) {
+            rc = acct_orders_mon_read(monitor, index, &snapshot);
+        }
+        // 账户服务回写槽位后 source 不再是 USER，这里只按新单类型与本次返回的订单 ID 匹配。
+        if (rc != ACCT_MON_OK || snapshot.order_type != 1 || ours.find(snapshot.internal_order_id) == ours.end()) {
+            continue;
+        }
+        acct_orders_mon_latency_t latency{};
+        if (acct_orders_mon_read_latency(monitor, index, &latency) != ACCT_MON_OK || latency.submit_ns == 0) {
+            continue;
+        }
+        const uint32_t upstream = latency.hop_delta_ns[ACCT_MON_HOP_UPSTREAM_DEQUEUED];
+        const uint32_t first_response = latency.hop_delta_ns[ACCT_MON_HOP_FIRST_RESPONSE];
+        if (upstream != 0) {
+            upstream_samples.push_back(upstream);
+        }
+        if (first_response != 0) {
+            first_response_samples.push_back(first_response);
+        } else if (snapshot.stage == ACCT_MON_STAGE_RISK_REJECTED) {
+            // 风控拒单不会下发柜台，单独计数，不算作链路丢单。
+            ++risk_rejected;
+        } else {
+            ++unanswered;
+        }
+    }
+    return true;
+}
+
+}  // namespace
+}  // namespace acct_service
+
+int main(int argc, char** argv) {
+    using namespace acct_service;
+
+    // 1) 解析参数。
+    if (wants_help(argc, argv)) {
+        print_usage(argv[0]);
+        return 0;
+    }
+    order_load_gen_options options{};
+    if (!parse_cli_args(argc, argv, &options)) {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    // 2) 打开下单上下文与订单池监控；监控只读，需要账户服务已建好 orders_shm。
+    acct_init_options_t init_options{};
+    init_options.upstream_shm_name = options.upstream_shm_name.c_str();
+    init_options.orders_shm_name = options.orders_shm_name.c_str();
+    init_options.trading_day = options.trading_day.c_str();
+    init_options.create_if_not_exist = 0;
+    acct_context_guard ctx_guard{};
+    const acct_error_t init_rc = acct_init_ex(&init_options, ctx_guard.out_ctx());
+    if (init_rc != ACCT_OK) {
+        std::fprintf(stderr, "acct_init_ex failed: %s\n", acct_strerror(init_rc));
+        return 1;
+    }
+
+    acct_orders_mon_options_t monitor_options{};
+    monitor_options.orders_shm_name = options.orders_shm_name.c_str();
+    monitor_options.trading_day = options.trading_day.c_str();
+    monitor_context_guard monitor_guard{};
+    const acct_mon_error_t open_rc = acct_orders_mon_open(&monitor_options, monitor_guard.out_ctx());
+    if (open_rc != ACCT_MON_OK) {
+        std::fprintf(stderr, "acct_orders_mon_open failed: %s\n", acct_orders_mon_strerror(open_rc));
+        return 1;
+    }
+    acct_orders_mon_info_t start_info{};
+    if (acct_orders_mon_info(monitor_guard.get(), &start_info) != ACCT_MON_OK) {
+        std::fprintf(stderr, "acct_orders_mon_info failed\n");
+        return 1;
+    }
+
+    // 3) 按节拍发单，再等待链路排空后统计。
+    load_counters counters{};
+    std::vector<uint32_t> order_ids;
+    const double elapsed_sec = run_load(options, ctx_guard.get(), counters, order_ids);
+    std::this_thread::sleep_for(std::chrono::milliseconds(options.drain_ms));
+
+    std::vector<uint64_t> upstream_samples;
+    std::vector<uint64_t> first_response_samples;
+    uint64_t risk_rejected = 0;
+    uint64_t unanswered = 0;
+    if (!collect_chain_latency(monitor_guard.get(), start_info.next_index, order_ids, upstream_samples,
+                               first_response_samples, risk_rejected, unanswered)) {
+        return 1;
+    }
+
+    // 4) 输出报告：一行汇总 + 每项延迟分位数，格式与 observer 的 [latency] 行同为 key=value。
+    const double throughput = elapsed_sec > 0.0 ? static_cast<double>(counters.submitted) / elapsed_sec : 0.0;
+    std::printf("[load] seed=%llu rate=%llu burst=%llu basket=%llu cancel_ratio=%.3f elapsed_sec=%.3f "
+                "submitted=%llu submit_failed=%llu queue_full=%llu cancels_sent=%llu cancel_failed=%llu "
+                "late_ticks=%llu risk_rejected=%llu unanswered=%llu throughput_ops=%.1f\n",
+                static_cast<unsigned long long>(options.seed), static_cast<unsigned long long>(options.rate),
+                static_cast<unsigned long long>(options.burst), static_cast<unsigned long long>(options.basket),
+                options.cancel_ratio, elapsed_sec, static_cast<unsigned long long>(counters.submitted),
+                static_cast<unsigned long long>(counters.submit_failed),
+                static_cast<unsigned long long>(counters.queue_full),
+                static_cast<unsigned long long>(counters.cancels_sent),
+                static_cast<unsigned long long>(counters.cancel_failed),
+                static_cast<unsigned long long>(counters.late_ticks), static_cast<unsigned long long>(risk_rejected),
+                static_cast<unsigned long long>(unanswered), throughput);
+    (void)print_latency_line("api_call", counters.api_call_ns);
+    (void)print_latency_line("submit_to_upstream_dequeued", upstream_samples);
+    const uint64_t p99_ns = print_latency_line("submit_to_first_response", first_response_samples);
+
+    // 5) 发布门限：未收到回报的订单也算失败，否则丢单会让 p99 看起来更好。
+    bool gate_ok = true;
+    if (options.max_p99_us != 0 && (first_response_samples.empty() || unanswered != 0 ||
+                                    p99_ns > options.max_p99_us * 1000ULL)) {
+        std::printf("[load] gate=failed reason=p99 p99_ns=%llu max_p99_us=%llu unanswered=%llu\n",
+                    static_cast<unsigned long long>(p99_ns), static_cast<unsigned long long>(options.max_p99_us),
+                    static_cast<unsigned long long>(unanswered));
+        gate_ok = false;
+    }
+    if (options.min_throughput > 0.0 && throughput < options.min_throughput) {
+        std::printf("[load] gate=failed reason=throughput throughput_ops=%.1f min_throughput=%.1f\n", throughput,
+                    options.min_throughput);
+        gate_ok = false;
+    }
+    if (!gate_ok) {
+        return kGateFailedExitCode;
+    }
+    std::printf("[load] gate=passed\n");
+    return 0;
+}
@@ -26,6 +26,8 @@ struct order_submit_cli_options {
     double price{0.0};
     uint32_t valid_sec{0};
     uint8_t passive_exec_algo{ACCT_PASSIVE_EXEC_DEFAULT};
+    uint32_t wait_mask{0};  // acct_wait_mask_t 位组合，0 表示提交后不等待
+    uint64_t wait_timeout_ms{5000};
 };
 
 // 用 RAII 托管 acct_ctx_t，确保退出路径都能释放上下文。
@@ -59,6 +61,7 @@ void print_usage(const char* program_name) {
                  "          [--upstream-shm NAME] [--orders-shm NAME] [--trading-day YYYYMMDD]\n"
                  "          [--valid-sec N]\n"
                  "          [--passive-exec-algo default|none|fixed|fixed_size|twap|vwap|iceberg]\n"
+                 "          [--wait dequeued|accepted|traded|rejected|terminal[,...]] [--wait-timeout-ms N]\n"
                  "          [--cleanup-shm-on-exit]\n",
                  program_name);
 }
@@ -231,6 +234,37 @@ bool parse_passive_exec_algo(std::string_view text, uint8_t* out_algo) {
     return false;
 }
 
+// 解析逗号分隔的等待条件到 acct_wait_mask_t 位组合，任一条件满足即结束等待。
+bool parse_wait_mask(std::string_view text, uint32_t* out_mask) {
+    if (out_mask == nullptr) {
+        return false;
+    }
+    uint32_t mask = 0;
+    while (!text.empty()) {
+        const std::size_t comma = text.find(',');
+        const std::string normalized = normalize_cli_value(text.substr(0, comma));
+        if (normalized == "dequeued") {
+            mask |= ACCT_WAIT_DEQUEUED;
+        } else if (normalized == "accepted") {
+            mask |= ACCT_WAIT_ACCEPTED;
+        } else if (normalized == "traded") {
+            mask |= ACCT_WAIT_TRADED;
+        } else if (normalized == "rejected") {
+            mask |= ACCT_WAIT_REJECTED;
+        } else if (normalized == "terminal") {
+            mask |= ACCT_WAIT_TERMINAL;
+        } else {
+            return false;
+        }
+        text = comma == std::string_view::npos ? std::string_view{} : text.substr(comma + 1);
+    }
+    if (mask == 0) {
+        return false;
+    }
+    *out_mask = mask;
+    return true;
+}
+
 // 解析命令行参数并验证必填项完整性。
 bool parse_cli_args(int argc, char** argv, order_submit_cli_options* out_options) {
     if (out_options == nullptr) {
@@ -295,6 +329,16 @@ bool parse_cli_args(int argc, char** argv, order_submit_cli_options* out_options
                 std::fprintf(stderr, "invalid --passive-exec-algo value: %s\n", value);
                 return false;
             }
+        } else if (arg == "--wait") {
+            if (!parse_wait_mask(value, &out_options->wait_mask)) {
+                std::fprintf(stderr, "invalid --wait value: %s\n", value);
+                return false;
+            }
+        } else if (arg == "--wait-timeout-ms") {
+            if (!parse_uint64(value, &out_options->wait_timeout_ms)) {
+                std::fprintf(stderr, "invalid --wait-timeout-ms value: %s\n", value);
+                return false;
+            }
         } else {
             std::fprintf(stderr, "unknown argument: %s\n", arg.c_str());
             return false;
@@ -368,11 +412,23 @@ int main(int argc, char** argv) {
         return 1;
     }
 
-    // 4) 可选清理：先关闭上下文，再删除测试共享内存名称。
+    // 4) 可选等待：在订单槽位上阻塞到任一等待条件满足或超时，替代脚本侧的轮询与 sleep。
+    int exit_code = 0;
+    if (options.wait_mask != 0) {
+        const acct_error_t wait_rc = acct_wait_order(ctx_guard.get(), order_id, options.wait_mask,
+                                                     options.wait_timeout_ms * 1000000ULL);
+        if (wait_rc != ACCT_OK) {
+            std::fprintf(stderr, "acct_wait_order failed: order_id=%u %s\n", order_id, acct_strerror(wait_rc));
+            exit_code = 2;
+        }
+    }
+
+    // 5) 可选清理：先关闭上下文，再删除测试共享内存名称。
     if (options.cleanup_shm_on_exit && !finalize_context_and_cleanup_shm(&ctx_guard, options)) {
         return 1;
     }
 
+    // 订单已提交时总是输出 order_id；等待未满足以退出码 2 区分
     std::printf("%u\n", order_id);
-    return 0;
+    return exit_code;
 }
@@ -0,0 +1,139 @@
+#include <cctype>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "common/basecore_log_format.hpp"
+#include "common/basecore_log_modules.hpp"
+#include "logging/log_batch_decoder.hpp"
+
+namespace acct_service {
+namespace {
+
+using basecore_log_adapter::ProjectLogModule;
+
+// 打印命令行帮助：并行解码归档的日志环映像（共享内存文件拷贝），按时间归并输出为文本。
+void print_usage(const char* program_name) {
+    std::fprintf(stderr,
+                 "Usage: %s --output PATH [--threads N] [--chunk N] [--module NAME[,NAME...]] [--level LEVEL]\n"
+                 "          [--from TIME] [--to TIME] CAPTURE [CAPTURE ...]\n"
+                 "  LEVEL: debug|info|warn|error|fatal (keeps LEVEL and above)\n"
+                 "  TIME:  Unix epoch nanoseconds or local \"YYYY-MM-DD HH:MM:SS\" (T separator also accepted)\n",
+                 program_name);
+}
+
+bool parse_level(std::string_view text, base_core_log::LogLevel& out) {
+    constexpr base_core_log::LogLevel kLevels[] = {base_core_log::LogLevel::debug, base_core_log::LogLevel::info,
+                                                   base_core_log::LogLevel::warn, base_core_log::LogLevel::error,
+                                                   base_core_log::LogLevel::fatal};
+    for (const base_core_log::LogLevel level : kLevels) {
+        std::string name = base_core_log::to_string(level);
+        for (char& ch : name) {
+            ch = static_cast<char>(std::tolower(static_cast<unsigned char>(ch)));
+        }
+        if (text == name) {
+            out = level;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool parse_time_ns(const std::string& text, uint64_t& out) {
+    char* end = nullptr;
+    const unsigned long long value = std::strtoull(text.c_str(), &end, 10);
+    if (end != text.c_str() && *end == '\0') {
+        out = value;
+        return true;
+    }
+    std::tm tm{};
+    const char* rest = ::strptime(text.c_str(), "%Y-%m-%d %H:%M:%S", &tm);
+    if (!rest) {
+        rest = ::strptime(text.c_str(), "%Y-%m-%dT%H:%M:%S", &tm);
+    }
+    if (!rest || *rest != '\0') {
+        return false;
+    }
+    tm.tm_isdst = -1;
+    const std::time_t seconds = std::mktime(&tm);
+    if (seconds < 0) {
+        return false;
+    }
+    out = static_cast<uint64_t>(seconds) * 1'000'000'000ULL;
+    return true;
+}
+
+// 逗号分隔的模块名按业务日志使用的名字解析；未知名字报错，避免过滤条件静默落空。
+bool parse_modules(std::string_view text, base_core_log::LogDecodeFilter& filter) {
+    while (!text.empty()) {
+        const std::size_t comma = text.find(',');
+        const std::string_view name = text.substr(0, comma);
+        const ProjectLogModule module = basecore_log_adapter::project_log_module_from_name(name);
+        if (module == ProjectLogModule::Unknown) {
+            std::fprintf(stderr, "unknown log module %.*s\n", static_cast<int>(name.size()), name.data());
+            return false;
+        }
+        filter.allow_module(static_cast<uint8_t>(module));
+        text = comma == std::string_view::npos ? std::string_view{} : text.substr(comma + 1);
+    }
+    return true;
+}
+
+}  // namespace
+}  // namespace acct_service
+
+int main(int argc, char** argv) {
+    using namespace acct_service;
+
+    base_core_log::LogBatchDecodeOptions options;
+    options.module_mapper = &basecore_log_adapter::project_log_module_mapper;
+    std::string output_path;
+    std::vector<std::string> captures;
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg = argv[i];
+        const bool has_value = i + 1 < argc;
+        bool ok = true;
+        if (arg == "--output" && has_value) {
+            output_path = argv[++i];
+        } else if (arg == "--threads" && has_value) {
+            options.threads = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--chunk" && has_value) {
+            options.chunk_records = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--module" && has_value) {
+            ok = parse_modules(argv[++i], options.filter);
+        } else if (arg == "--level" && has_value) {
+            ok = parse_level(argv[++i], options.filter.min_level);
+        } else if (arg == "--from" && has_value) {
+            ok = parse_time_ns(argv[++i], options.filter.begin_ns);
+        } else if (arg == "--to" && has_value) {
+            ok = parse_time_ns(argv[++i], options.filter.end_ns);
+        } else if (arg.starts_with("--")) {
+            ok = false;
+        } else {
+            captures.emplace_back(arg);
+        }
+        if (!ok) {
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+    if (output_path.empty() || captures.empty()) {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    // 项目格式函数在解码器取注册表快照之前注册
+    (void)basecore_log_adapter::ProjectLogFormat::register_formats();
+    base_core_log::LogBatchDecoder decoder(std::move(captures), output_path, options);
+    const int exit_code = decoder.run();
+    const base_core_log::LogBatchDecodeStats& stats = decoder.stats();
+    std::fprintf(stderr, "files=%zu rejected=%zu chunks=%zu records=%llu emitted=%llu\n", stats.files,
+                 stats.rejected_files, stats.chunks, static_cast<unsigned long long>(stats.records),
+                 static_cast<unsigned long long>(stats.emitted));
+    return exit_code;
+}
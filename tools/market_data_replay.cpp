@@ -0,0 +1,240 @@
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "common/types.hpp"
+#include "market_data/market_data_replay.hpp"
+#include "snapshot_reader.hpp"
+
+namespace acct_service {
+namespace {
+
+// 录制/回放 CLI 参数集合：record 从实盘 snapshot shm 采样写文件，replay 把文件按倍速发布到测试 shm。
+struct market_data_replay_options {
+    std::string mode{};
+    std::string file_path{};
+    std::string snapshot_shm_name{};
+    uint64_t duration_ms = 0;    // record：录制时长（必填）
+    uint64_t poll_us = 100;      // record：轮询 slot 序号的间隔
+    double speed = 1.0;          // replay：回放倍速，0 表示不按时刻尽快发布
+    uint64_t loops = 1;          // replay：整段回放次数
+    bool keep_output = false;    // replay：结束后保留 snapshot shm，便于读端继续检查
+};
+
+void print_usage(const char* program_name) {
+    std::fprintf(stderr,
+                 "Usage: %s record --snapshot-shm NAME --file PATH --duration-ms N [--poll-us N]\n"
+                 "       %s replay --file PATH --snapshot-shm NAME [--speed X] [--loops N] [--keep-output]\n"
+                 "  --speed 100 replays a recorded session at 100x wall-clock, --speed 0 publishes as fast as possible\n",
+                 program_name, program_name);
+}
+
+bool parse_u64(const char* text, uint64_t& out_value) {
+    if (text == nullptr) {
+        return false;
+    }
+    char* end = nullptr;
+    errno = 0;
+    const unsigned long long parsed = std::strtoull(text, &end, 10);
+    if (errno != 0 || end == text || *end != '\0') {
+        return false;
+    }
+    out_value = static_cast<uint64_t>(parsed);
+    return true;
+}
+
+bool parse_double(const char* text, double& out_value) {
+    if (text == nullptr) {
+        return false;
+    }
+    char* end = nullptr;
+    errno = 0;
+    const double parsed = std::strtod(text, &end);
+    if (errno != 0 || end == text || *end != '\0' || parsed < 0.0) {
+        return false;
+    }
+    out_value = parsed;
+    return true;
+}
+
+bool parse_cli_args(int argc, char** argv, market_data_replay_options& out_options) {
+    if (argc < 2) {
+        print_usage(argv[0]);
+        return false;
+    }
+    out_options.mode = argv[1];
+    if (out_options.mode != "record" && out_options.mode != "replay") {
+        print_usage(argv[0]);
+        return false;
+    }
+    for (int i = 2; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--keep-output") {
+            out_options.keep_output = true;
+            continue;
+        }
+        if (i + 1 >= argc) {
+            std::fprintf(stderr, "missing value for %s\n", arg.c_str());
+            return false;
+        }
+        const char* value = argv[++i];
+        bool ok = true;
+        if (arg == "--file") {
+            out_options.file_path = value;
+        } else if (arg == "--snapshot-shm") {
+            out_options.snapshot_shm_name = value;
+        } else if (arg == "--duration-ms") {
+            ok = parse_u64(value, out_options.duration_ms) && out_options.duration_ms > 0;
+        } else if (arg == "--poll-us") {
+            ok = parse_u64(value, out_options.poll_us);
+        } else if (arg == "--speed") {
+            ok = parse_double(value, out_options.speed);
+        } else if (arg == "--loops") {
+            ok = parse_u64(value, out_options.loops) && out_options.loops > 0;
+        } else {
+            std::fprintf(stderr, "unknown argument: %s\n", arg.c_str());
+            return false;
+        }
+        if (!ok) {
+            std::fprintf(stderr, "invalid %s value: %s\n", arg.c_str(), value);
+            return false;
+        }
+    }
+    if (out_options.file_path.empty() || out_options.snapshot_shm_name.empty()) {
+        std::fprintf(stderr, "--file and --snapshot-shm are required\n");
+        return false;
+    }
+    if (out_options.mode == "record" && out_options.duration_ms == 0) {
+        std::fprintf(stderr, "record requires --duration-ms\n");
+        return false;
+    }
+    return true;
+}
+
+// 轮询实盘 snapshot shm，把每个 slot 序号前进的快照按采样时刻写入回放文件。
+int run_record(const market_data_replay_options& options) {
+    signal_engine::snapshot_reader::SnapshotReader reader;
+    if (!reader.open(options.snapshot_shm_name) || reader.header() == nullptr) {
+        std::fprintf(stderr, "failed to open snapshot shm: %s\n", options.snapshot_shm_name.c_str());
+        return 1;
+    }
+    const std::vector<std::string> symbols = reader.list_symbols();
+    MarketDataRecorder recorder;
+    if (!recorder.open(options.file_path, reader.header()->trading_day, symbols)) {
+        std::fprintf(stderr, "failed to create replay file: %s\n", options.file_path.c_str());
+        return 1;
+    }
+
+    std::vector<uint64_t> last_seq(symbols.size(), 0);
+    std::vector<signal_engine::snapshot_reader::ReadResult> results(symbols.size());
+    const TimestampNs start_ns = now_monotonic_ns();
+    const TimestampNs end_ns = start_ns + options.duration_ms * 1'000'000ULL;
+    for (TimestampNs now = start_ns; now < end_ns; now = now_monotonic_ns()) {
+        for (std::size_t i = 0; i < symbols.size(); ++i) {
+            signal_engine::snapshot_reader::ReadResult& result = results[i];
+            if (!reader.read(symbols[i], result) || result.seq == last_seq[i]) {
+                continue;
+            }
+            last_seq[i] = result.seq;
+            MarketDataReplayRecord record{};
+            record.offset_ns = now - start_ns;
+            record.symbol_index = static_cast<uint32_t>(i);
+            record.signal = result.payload.signal;
+            record.flags = result.payload.flags;
+            record.prediction_state = static_cast<uint8_t>(result.payload.prediction_state);
+            record.snapshot = result.payload.snapshot;
+            if (!recorder.append(record)) {
+                std::fprintf(stderr, "failed to append replay record\n");
+                return 1;
+            }
+        }
+        if (options.poll_us != 0) {
+            std::this_thread::sleep_for(std::chrono::microseconds(options.poll_us));
+        }
+    }
+
+    const uint64_t records = recorder.record_count();
+    if (!recorder.close()) {
+        std::fprintf(stderr, "failed to finalize replay file: %s\n", options.file_path.c_str());
+        return 1;
+    }
+    std::printf("[record] symbols=%zu records=%llu duration_ms=%llu file=%s\n", symbols.size(),
+                static_cast<unsigned long long>(records), static_cast<unsigned long long>(options.duration_ms),
+                options.file_path.c_str());
+    return 0;
+}
+
+// 按倍速把录制时刻映射到单调时钟：到期记录整批发布，空闲时睡到下一条记录；speed=0 时不等待。
+int run_replay(const market_data_replay_options& options) {
+    MarketDataReplayFile file;
+    if (!file.open(options.file_path)) {
+        std::fprintf(stderr, "failed to open replay file: %s\n", options.file_path.c_str());
+        return 1;
+    }
+    MarketDataReplayer replayer(file);
+    if (!replayer.open_output(options.snapshot_shm_name)) {
+        std::fprintf(stderr, "failed to create snapshot shm: %s\n", options.snapshot_shm_name.c_str());
+        return 1;
+    }
+
+    constexpr std::size_t kMaxBurstRecords = 4096;
+    const bool as_fast_as_possible = options.speed == 0.0;
+    uint64_t max_lag_ns = 0;
+    const TimestampNs replay_start_ns = now_monotonic_ns();
+    for (uint64_t loop = 0; loop < options.loops; ++loop) {
+        replayer.rewind();
+        const TimestampNs loop_start_ns = now_monotonic_ns();
+        while (!replayer.done()) {
+            if (as_fast_as_possible) {
+                (void)replayer.publish_next(kMaxBurstRecords);
+                continue;
+            }
+            const uint64_t next_offset = replayer.next_offset_ns();
+            const uint64_t offset = market_data_replay_offset(now_monotonic_ns() - loop_start_ns, options.speed);
+            if (next_offset > offset) {
+                const double wait_ns = static_cast<double>(next_offset - offset) / options.speed;
+                if (wait_ns > 50'000.0) {
+                    std::this_thread::sleep_for(std::chrono::nanoseconds(static_cast<int64_t>(wait_ns) - 20'000));
+                }
+                continue;
+            }
+            // 以录制时刻衡量发布滞后，换算回墙钟时间
+            const uint64_t lag_ns = static_cast<uint64_t>(static_cast<double>(offset - next_offset) / options.speed);
+            if (lag_ns > max_lag_ns) {
+                max_lag_ns = lag_ns;
+            }
+            (void)replayer.publish_until(offset, kMaxBurstRecords);
+        }
+    }
+    const TimestampNs elapsed_ns = now_monotonic_ns() - replay_start_ns;
+
+    const double elapsed_s = static_cast<double>(elapsed_ns) / 1e9;
+    const double recorded_s = static_cast<double>(file.duration_ns()) * static_cast<double>(options.loops) / 1e9;
+    std::printf("[replay] symbols=%u records=%llu loops=%llu elapsed_ms=%.1f effective_speed=%.1fx "
+                "records_per_s=%.0f max_lag_us=%.1f\n",
+                file.header().symbol_count, static_cast<unsigned long long>(replayer.published()),
+                static_cast<unsigned long long>(options.loops), elapsed_s * 1e3,
+                elapsed_s > 0.0 ? recorded_s / elapsed_s : 0.0,
+                elapsed_s > 0.0 ? static_cast<double>(replayer.published()) / elapsed_s : 0.0,
+                static_cast<double>(max_lag_ns) / 1e3);
+    replayer.close_output(!options.keep_output);
+    return 0;
+}
+
+}  // namespace
+}  // namespace acct_service
+
+int main(int argc, char** argv) {
+    using namespace acct_service;
+
+    market_data_replay_options options{};
+    if (!parse_cli_args(argc, argv, options)) {
+        return 1;
+    }
+    return options.mode == "record" ? run_record(options) : run_replay(options);
+}
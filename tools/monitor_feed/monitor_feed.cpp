@@ -0,0 +1,808 @@
+#include "monitor_feed.hpp"
+
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sched.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+
+namespace acct_service {
+
+namespace {
+
+constexpr std::size_t kChangeBatch = 1024;
+constexpr uint32_t kRangeBatch = 1024;
+constexpr int kSnapshotReadRetries = 64;
+constexpr std::chrono::microseconds kSnapshotRetryBackoff{50};
+
+static_assert(sizeof(monitor_feed_frame_header) + sizeof(monitor_feed_record_header) +
+                      sizeof(acct_orders_mon_snapshot_t) <=
+                  kMonitorFeedMaxFrameBytes,
+              "order snapshot must fit one monitor feed frame");
+static_assert(sizeof(monitor_feed_frame_header) + sizeof(monitor_feed_record_header) +
+                      sizeof(acct_positions_mon_position_snapshot_t) <=
+                  kMonitorFeedMaxFrameBytes,
+              "position snapshot must fit one monitor feed frame");
+
+uint64_t now_ns() {
+    return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch())
+            .count());
+}
+
+bool fail(std::string* out_error, const std::string& message, int sys_errno = 0) {
+    if (out_error) {
+        *out_error = sys_errno != 0 ? message + ": " + std::strerror(sys_errno) : message;
+    }
+    return false;
+}
+
+void close_fd(int& fd) noexcept {
+    if (fd >= 0) {
+        ::close(fd);
+        fd = -1;
+    }
+}
+
+void set_socket_timeouts(int fd, uint32_t timeout_ms) noexcept {
+    timeval tv{};
+    tv.tv_sec = static_cast<time_t>(timeout_ms / 1000);
+    tv.tv_usec = static_cast<suseconds_t>((timeout_ms % 1000) * 1000);
+    (void)::setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    (void)::setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+    const int one = 1;
+    (void)::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+}
+
+// 补发连接上收发整块数据；超时即放弃，避免慢客户端长时间卡住发布线程
+bool send_all(int fd, const void* data, std::size_t size) {
+    const auto* bytes = static_cast<const unsigned char*>(data);
+    while (size > 0) {
+        const ssize_t written = ::send(fd, bytes, size, MSG_NOSIGNAL);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        bytes += written;
+        size -= static_cast<std::size_t>(written);
+    }
+    return true;
+}
+
+bool recv_all(int fd, void* data, std::size_t size) {
+    auto* bytes = static_cast<unsigned char*>(data);
+    while (size > 0) {
+        const ssize_t received = ::recv(fd, bytes, size, 0);
+        if (received < 0 && errno == EINTR) {
+            continue;
+        }
+        if (received <= 0) {
+            return false;
+        }
+        bytes += received;
+        size -= static_cast<std::size_t>(received);
+    }
+    return true;
+}
+
+bool parse_ipv4(const std::string& text, in_addr* out) { return ::inet_pton(AF_INET, text.c_str(), out) == 1; }
+
+bool is_multicast(in_addr addr) noexcept { return IN_MULTICAST(ntohl(addr.s_addr)); }
+
+// "YYYYMMDD" 转数值，格式不符时为 0
+uint32_t parse_trading_day(const char* text) {
+    uint32_t value = 0;
+    for (int i = 0; i < ACCT_MON_TRADING_DAY_LEN; ++i) {
+        if (text[i] < '0' || text[i] > '9') {
+            return 0;
+        }
+        value = value * 10 + static_cast<uint32_t>(text[i] - '0');
+    }
+    return value;
+}
+
+bool valid_header(const monitor_feed_frame_header& header) noexcept {
+    return header.magic == monitor_feed_frame_header::kMagic && header.version == monitor_feed_frame_header::kVersion &&
+           header.body_bytes <= kMonitorFeedMaxFrameBytes - sizeof(monitor_feed_frame_header);
+}
+
+}  // namespace
+
+// ============ 发布端 ============
+
+monitor_feed_publisher::~monitor_feed_publisher() { stop(); }
+
+bool monitor_feed_publisher::start(acct_orders_mon_ctx_t orders, acct_positions_mon_ctx_t positions,
+                                   const monitor_feed_publisher_options& options, std::string* out_error) {
+    stop();
+    if (!orders) {
+        return fail(out_error, "orders monitor context is required");
+    }
+    if (options.port == 0 || options.retain_frames == 0 || options.heartbeat_ms == 0 || options.fill_timeout_ms == 0) {
+        return fail(out_error, "invalid monitor feed publisher options");
+    }
+    acct_orders_mon_info_t orders_info{};
+    const acct_mon_error_t orders_rc = acct_orders_mon_info(orders, &orders_info);
+    if (orders_rc != ACCT_MON_OK) {
+        return fail(out_error, std::string("acct_orders_mon_info failed: ") + acct_orders_mon_strerror(orders_rc));
+    }
+    acct_positions_mon_info_t positions_info{};
+    if (positions) {
+        const acct_pos_mon_error_t positions_rc = acct_positions_mon_info(positions, &positions_info);
+        if (positions_rc != ACCT_POS_MON_OK) {
+            return fail(out_error,
+                        std::string("acct_positions_mon_info failed: ") + acct_positions_mon_strerror(positions_rc));
+        }
+    }
+
+    sockaddr_in destination{};
+    destination.sin_family = AF_INET;
+    destination.sin_port = htons(options.port);
+    if (!parse_ipv4(options.group, &destination.sin_addr)) {
+        return fail(out_error, "invalid monitor feed group address " + options.group);
+    }
+    udp_fd_ = ::socket(AF_INET, SOCK_DGRAM, 0);
+    if (udp_fd_ < 0) {
+        return fail(out_error, "failed to create monitor feed udp socket", errno);
+    }
+    if (is_multicast(destination.sin_addr)) {
+        const int ttl = options.ttl;
+        const int loop = 1;  // 同机镜像也能收到
+        (void)::setsockopt(udp_fd_, IPPROTO_IP, IP_MULTICAST_TTL, &ttl, sizeof(ttl));
+        (void)::setsockopt(udp_fd_, IPPROTO_IP, IP_MULTICAST_LOOP, &loop, sizeof(loop));
+        if (!options.interface_address.empty()) {
+            in_addr interface_addr{};
+            if (!parse_ipv4(options.interface_address, &interface_addr) ||
+                ::setsockopt(udp_fd_, IPPROTO_IP, IP_MULTICAST_IF, &interface_addr, sizeof(interface_addr)) != 0) {
+                const int if_errno = errno;
+                close_fd(udp_fd_);
+                return fail(out_error, "invalid monitor feed interface " + options.interface_address, if_errno);
+            }
+        }
+    }
+
+    sockaddr_in fill_addr{};
+    fill_addr.sin_family = AF_INET;
+    fill_addr.sin_port = htons(options.fill_port);
+    if (!parse_ipv4(options.fill_bind_address, &fill_addr.sin_addr)) {
+        close_fd(udp_fd_);
+        return fail(out_error, "invalid monitor feed fill bind address " + options.fill_bind_address);
+    }
+    listen_fd_ = ::socket(AF_INET, SOCK_STREAM, 0);
+    const int one = 1;
+    socklen_t fill_addr_len = sizeof(fill_addr);
+    if (listen_fd_ < 0 || ::setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one)) != 0 ||
+        ::bind(listen_fd_, reinterpret_cast<const sockaddr*>(&fill_addr), sizeof(fill_addr)) != 0 ||
+        ::listen(listen_fd_, 8) != 0 ||
+        ::getsockname(listen_fd_, reinterpret_cast<sockaddr*>(&fill_addr), &fill_addr_len) != 0) {
+        const int listen_errno = errno;
+        close_fd(listen_fd_);
+        close_fd(udp_fd_);
+        return fail(out_error, "failed to listen for monitor feed fill requests", listen_errno);
+    }
+    bound_fill_port_ = ntohs(fill_addr.sin_port);
+
+    orders_ = orders;
+    positions_ = positions;
+    options_ = options;
+    trading_day_ = parse_trading_day(orders_info.trading_day);
+    session_id_ = now_ns();
+    destination_.assign(reinterpret_cast<const unsigned char*>(&destination),
+                        reinterpret_cast<const unsigned char*>(&destination) + sizeof(destination));
+    // 新客户端先经补发拿全量快照，发布端只需从当前位置跟踪
+    journal_cursor_ = orders_info.journal_cursor;
+    position_cursor_ = positions_info.change_version;
+    last_seq_ = 0;
+    last_send_ns_ = 0;
+    changes_.resize(kChangeBatch);
+    dirty_rows_.resize(kChangeBatch);
+    range_rows_.resize(kRangeBatch);
+    range_unstable_.resize(kRangeBatch);
+    order_pending_.clear();
+    order_deferred_.clear();
+    position_pending_.clear();
+    position_deferred_.clear();
+    retained_.assign(static_cast<std::size_t>(options_.retain_frames) * kMonitorFeedMaxFrameBytes, 0);
+    retained_bytes_.assign(options_.retain_frames, 0);
+    live_ = frame_buffer{};
+    fill_ = frame_buffer{};
+    frames_.store(0, std::memory_order_relaxed);
+    records_.store(0, std::memory_order_relaxed);
+    send_failures_.store(0, std::memory_order_relaxed);
+    order_rescans_.store(0, std::memory_order_relaxed);
+    fills_served_.store(0, std::memory_order_relaxed);
+    snapshots_served_.store(0, std::memory_order_relaxed);
+    stop_requested_.store(false, std::memory_order_release);
+    thread_ = std::thread([this]() { publisher_loop(); });
+    return true;
+}
+
+void monitor_feed_publisher::stop() {
+    stop_requested_.store(true, std::memory_order_release);
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+    close_fd(fill_fd_);
+    close_fd(listen_fd_);
+    close_fd(udp_fd_);
+    orders_ = nullptr;
+    positions_ = nullptr;
+}
+
+monitor_feed_publisher_stats monitor_feed_publisher::stats() const noexcept {
+    monitor_feed_publisher_stats stats;
+    stats.frames = frames_.load(std::memory_order_relaxed);
+    stats.records = records_.load(std::memory_order_relaxed);
+    stats.send_failures = send_failures_.load(std::memory_order_relaxed);
+    stats.order_rescans = order_rescans_.load(std::memory_order_relaxed);
+    stats.fills_served = fills_served_.load(std::memory_order_relaxed);
+    stats.snapshots_served = snapshots_served_.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void monitor_feed_publisher::publisher_loop() {
+    if (options_.cpu >= 0) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(options_.cpu, &set);
+        (void)::sched_setaffinity(0, sizeof(set), &set);
+    }
+    const uint64_t heartbeat_ns = static_cast<uint64_t>(options_.heartbeat_ms) * 1'000'000ULL;
+    while (!stop_requested_.load(std::memory_order_acquire)) {
+        const bool orders_busy = poll_orders();
+        const bool positions_busy = poll_positions();
+        // 每轮末尾把未满的帧也发出去：延迟优先于帧填充率
+        finish(live_, monitor_feed_frame_type::Delta);
+        serve_fill();
+        if (now_ns() - last_send_ns_ >= heartbeat_ns) {
+            send_heartbeat();
+        }
+        if (!orders_busy && !positions_busy) {
+            std::this_thread::sleep_for(std::chrono::microseconds(options_.poll_interval_us));
+        }
+    }
+}
+
+bool monitor_feed_publisher::poll_orders() {
+    order_pending_.swap(order_deferred_);
+    order_deferred_.clear();
+    std::size_t count = 0;
+    const acct_mon_error_t rc =
+        acct_orders_mon_poll_changes(orders_, &journal_cursor_, changes_.data(), changes_.size(), &count);
+    if (rc == ACCT_MON_ERR_LAGGED) {
+        // 变更已被日志环覆盖：全量重扫一次，之前延后的槽位也在其中
+        order_rescans_.fetch_add(1, std::memory_order_relaxed);
+        order_pending_.clear();
+        rescan_orders(live_, monitor_feed_frame_type::Delta);
+        return true;
+    }
+    if (rc != ACCT_MON_OK) {
+        count = 0;
+    }
+    for (std::size_t i = 0; i < count; ++i) {
+        order_pending_.push_back(changes_[i].index);
+    }
+    // 同一槽位多次变更只发最新快照
+    std::sort(order_pending_.begin(), order_pending_.end());
+    order_pending_.erase(std::unique(order_pending_.begin(), order_pending_.end()), order_pending_.end());
+    for (const uint32_t index : order_pending_) {
+        (void)emit_order(live_, monitor_feed_frame_type::Delta, index);
+    }
+    order_pending_.clear();
+    return count > 0;
+}
+
+bool monitor_feed_publisher::poll_positions() {
+    if (!positions_) {
+        return false;
+    }
+    position_pending_.swap(position_deferred_);
+    position_deferred_.clear();
+    std::size_t count = 0;
+    if (acct_positions_mon_poll_dirty(positions_, &position_cursor_, dirty_rows_.data(), dirty_rows_.size(),
+                                      &count) != ACCT_POS_MON_OK) {
+        count = 0;
+    }
+    position_pending_.insert(position_pending_.end(), dirty_rows_.begin(),
+                             dirty_rows_.begin() + static_cast<std::ptrdiff_t>(count));
+    for (const uint32_t row : position_pending_) {
+        (void)emit_position_row(live_, monitor_feed_frame_type::Delta, row);
+    }
+    position_pending_.clear();
+    return count > 0;
+}
+
+void monitor_feed_publisher::rescan_orders(frame_buffer& buffer, monitor_feed_frame_type type) {
+    acct_orders_mon_info_t info{};
+    if (acct_orders_mon_info(orders_, &info) != ACCT_MON_OK) {
+        return;
+    }
+    uint32_t segment_begin[1 + ACCT_MON_MAX_OVERFLOW_SEGMENTS] = {0};
+    uint32_t segment_end[1 + ACCT_MON_MAX_OVERFLOW_SEGMENTS] = {info.next_index};
+    const uint32_t segments = 1 + std::min<uint32_t>(info.overflow_segments, ACCT_MON_MAX_OVERFLOW_SEGMENTS);
+    for (uint32_t k = 1; k < segments; ++k) {
+        segment_begin[k] = k << ACCT_MON_INDEX_SEGMENT_SHIFT;
+        segment_end[k] = info.overflow_next_index[k - 1];
+    }
+    for (uint32_t segment = 0; segment < segments; ++segment) {
+        for (uint32_t begin = segment_begin[segment]; begin < segment_end[segment]; begin += kRangeBatch) {
+            const uint32_t end = std::min(segment_end[segment], begin + kRangeBatch);
+            std::size_t count = 0;
+            std::size_t unstable_count = 0;
+            const acct_mon_error_t rc = acct_orders_mon_read_range(orders_, begin, end, range_rows_.data(), &count,
+                                                                  range_unstable_.data(), &unstable_count);
+            if (rc != ACCT_MON_OK && rc != ACCT_MON_ERR_RETRY) {
+                break;
+            }
+            for (std::size_t i = 0; i < count; ++i) {
+                if (range_rows_[i].stage != ACCT_MON_STAGE_EMPTY) {
+                    append(buffer, type, monitor_feed_record_kind::Order, range_rows_[i].index, &range_rows_[i],
+                           sizeof(acct_orders_mon_snapshot_t));
+                }
+            }
+            for (std::size_t i = 0; i < unstable_count; ++i) {
+                (void)emit_order(buffer, type, range_unstable_[i]);
+            }
+        }
+    }
+}
+
+void monitor_feed_publisher::snapshot_positions(frame_buffer& buffer) {
+    acct_positions_mon_info_t info{};
+    if (!positions_ || acct_positions_mon_info(positions_, &info) != ACCT_POS_MON_OK || info.init_state == 0) {
+        return;
+    }
+    // 物理行 0 为资金行，证券行为逻辑索引 + 1
+    for (uint32_t row = 0; row <= info.position_count; ++row) {
+        (void)emit_position_row(buffer, monitor_feed_frame_type::Snapshot, row);
+    }
+}
+
+bool monitor_feed_publisher::emit_order(frame_buffer& buffer, monitor_feed_frame_type type, uint32_t index) {
+    acct_orders_mon_snapshot_t snapshot{};
+    for (int attempt = 0;; ++attempt) {
+        const acct_mon_error_t rc = acct_orders_mon_read(orders_, index, &snapshot);
+        if (rc == ACCT_MON_OK) {
+            break;
+        }
+        if (rc != ACCT_MON_ERR_RETRY) {
+            return false;
+        }
+        // 组播路径不在此等待，留到下一轮；全量快照必须读到才能保证补发内容完整
+        if (type == monitor_feed_frame_type::Delta) {
+            order_deferred_.push_back(index);
+            return false;
+        }
+        if (attempt >= kSnapshotReadRetries) {
+            return false;
+        }
+        std::this_thread::sleep_for(kSnapshotRetryBackoff);
+    }
+    if (snapshot.stage == ACCT_MON_STAGE_EMPTY) {
+        return false;
+    }
+    append(buffer, type, monitor_feed_record_kind::Order, index, &snapshot, sizeof(snapshot));
+    return true;
+}
+
+bool monitor_feed_publisher::emit_position_row(frame_buffer& buffer, monitor_feed_frame_type type, uint32_t row) {
+    for (int attempt = 0;; ++attempt) {
+        acct_pos_mon_error_t rc = ACCT_POS_MON_OK;
+        if (row == 0) {
+            acct_positions_mon_fund_snapshot_t fund{};
+            rc = acct_positions_mon_read_fund(positions_, &fund);
+            if (rc == ACCT_POS_MON_OK) {
+                append(buffer, type, monitor_feed_record_kind::Fund, 0, &fund, sizeof(fund));
+                return true;
+            }
+        } else {
+            acct_positions_mon_position_snapshot_t position{};
+            rc = acct_positions_mon_read_position(positions_, row - 1, &position);
+            if (rc == ACCT_POS_MON_OK) {
+                append(buffer, type, monitor_feed_record_kind::Position, row - 1, &position, sizeof(position));
+                return true;
+            }
+        }
+        if (rc != ACCT_POS_MON_ERR_RETRY) {
+            return false;
+        }
+        if (type == monitor_feed_frame_type::Delta) {
+            position_deferred_.push_back(row);
+            return false;
+        }
+        if (attempt >= kSnapshotReadRetries) {
+            return false;
+        }
+        std::this_thread::sleep_for(kSnapshotRetryBackoff);
+    }
+}
+
+void monitor_feed_publisher::append(frame_buffer& buffer, monitor_feed_frame_type type, monitor_feed_record_kind kind,
+                                    uint32_t key, const void* payload, std::size_t size) {
+    const std::size_t needed = sizeof(monitor_feed_record_header) + size;
+    if (buffer.bytes + needed > kMonitorFeedMaxFrameBytes) {
+        finish(buffer, type);
+    }
+    monitor_feed_record_header record;
+    record.kind = static_cast<uint8_t>(kind);
+    record.size = static_cast<uint16_t>(size);
+    record.key = key;
+    std::memcpy(buffer.data + buffer.bytes, &record, sizeof(record));
+    std::memcpy(buffer.data + buffer.bytes + sizeof(record), payload, size);
+    buffer.bytes += needed;
+    ++buffer.records;
+}
+
+void monitor_feed_publisher::finish(frame_buffer& buffer, monitor_feed_frame_type type) {
+    if (buffer.records == 0) {
+        return;
+    }
+    monitor_feed_frame_header header;
+    header.type = static_cast<uint16_t>(type);
+    header.trading_day = trading_day_;
+    header.record_count = buffer.records;
+    header.body_bytes = static_cast<uint16_t>(buffer.bytes - sizeof(header));
+    header.publish_ns = now_ns();
+    header.session_id = session_id_;
+    if (type == monitor_feed_frame_type::Delta) {
+        header.seq = ++last_seq_;
+        std::memcpy(buffer.data, &header, sizeof(header));
+        // 发送失败的帧照样占序号并进补发环，客户端发现缺口后补回
+        if (::sendto(udp_fd_, buffer.data, buffer.bytes, 0, reinterpret_cast<const sockaddr*>(destination_.data()),
+                     static_cast<socklen_t>(destination_.size())) < 0) {
+            send_failures_.fetch_add(1, std::memory_order_relaxed);
+        }
+        const std::size_t slot = static_cast<std::size_t>((header.seq - 1) % options_.retain_frames);
+        std::memcpy(retained_.data() + slot * kMonitorFeedMaxFrameBytes, buffer.data, buffer.bytes);
+        retained_bytes_[slot] = static_cast<uint16_t>(buffer.bytes);
+        frames_.fetch_add(1, std::memory_order_relaxed);
+        records_.fetch_add(buffer.records, std::memory_order_relaxed);
+        last_send_ns_ = header.publish_ns;
+    } else {
+        std::memcpy(buffer.data, &header, sizeof(header));
+        send_fill_frame(buffer.data, buffer.bytes);
+    }
+    buffer.bytes = sizeof(monitor_feed_frame_header);
+    buffer.records = 0;
+}
+
+void monitor_feed_publisher::send_heartbeat() {
+    monitor_feed_frame_header header;
+    header.type = static_cast<uint16_t>(monitor_feed_frame_type::Heartbeat);
+    header.trading_day = trading_day_;
+    header.seq = last_seq_;
+    header.publish_ns = now_ns();
+    header.session_id = session_id_;
+    (void)::sendto(udp_fd_, &header, sizeof(header), 0, reinterpret_cast<const sockaddr*>(destination_.data()),
+                   static_cast<socklen_t>(destination_.size()));
+    last_send_ns_ = header.publish_ns;
+}
+
+void monitor_feed_publisher::serve_fill() {
+    pollfd pfd{listen_fd_, POLLIN, 0};
+    if (::poll(&pfd, 1, 0) <= 0 || (pfd.revents & POLLIN) == 0) {
+        return;
+    }
+    fill_fd_ = ::accept(listen_fd_, nullptr, nullptr);
+    if (fill_fd_ < 0) {
+        return;
+    }
+    set_socket_timeouts(fill_fd_, options_.fill_timeout_ms);
+    monitor_feed_fill_request request;
+    fill_ok_ = recv_all(fill_fd_, &request, sizeof(request)) &&
+               request.magic == monitor_feed_fill_request::kMagic &&
+               request.version == monitor_feed_frame_header::kVersion;
+    if (fill_ok_) {
+        // 在发布线程内同步补发：快照与已发布序号一致，补发期间组播暂停，积压的变更随后照常发出
+        const uint64_t oldest = last_seq_ >= options_.retain_frames ? last_seq_ - options_.retain_frames + 1 : 1;
+        if (request.from_seq != 0 && request.from_seq >= oldest && request.from_seq <= last_seq_ + 1) {
+            for (uint64_t seq = request.from_seq; seq <= last_seq_ && fill_ok_; ++seq) {
+                const std::size_t slot = static_cast<std::size_t>((seq - 1) % options_.retain_frames);
+                send_fill_frame(retained_.data() + slot * kMonitorFeedMaxFrameBytes, retained_bytes_[slot]);
+            }
+            fills_served_.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            rescan_orders(fill_, monitor_feed_frame_type::Snapshot);
+            snapshot_positions(fill_);
+            finish(fill_, monitor_feed_frame_type::Snapshot);
+            snapshots_served_.fetch_add(1, std::memory_order_relaxed);
+        }
+        monitor_feed_frame_header end;
+        end.type = static_cast<uint16_t>(monitor_feed_frame_type::FillEnd);
+        end.trading_day = trading_day_;
+        end.seq = last_seq_;
+        end.publish_ns = now_ns();
+        end.session_id = session_id_;
+        send_fill_frame(&end, sizeof(end));
+    }
+    close_fd(fill_fd_);
+}
+
+void monitor_feed_publisher::send_fill_frame(const void* data, std::size_t size) {
+    if (fill_ok_ && !send_all(fill_fd_, data, size)) {
+        fill_ok_ = false;
+    }
+}
+
+// ============ 客户端镜像 ============
+
+monitor_feed_mirror::~monitor_feed_mirror() { stop(); }
+
+bool monitor_feed_mirror::start(const monitor_feed_mirror_options& options, std::string* out_error) {
+    stop();
+    if (options.publisher_host.empty() || options.fill_port == 0 || options.fill_timeout_ms == 0) {
+        return fail(out_error, "invalid monitor feed mirror options");
+    }
+    in_addr group{};
+    if (!parse_ipv4(options.group, &group)) {
+        return fail(out_error, "invalid monitor feed group address " + options.group);
+    }
+    udp_fd_ = ::socket(AF_INET, SOCK_DGRAM, 0);
+    if (udp_fd_ < 0) {
+        return fail(out_error, "failed to create monitor feed udp socket", errno);
+    }
+    const int one = 1;
+    (void)::setsockopt(udp_fd_, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    if (options.receive_buffer_bytes > 0) {
+        (void)::setsockopt(udp_fd_, SOL_SOCKET, SO_RCVBUF, &options.receive_buffer_bytes,
+                           sizeof(options.receive_buffer_bytes));
+    }
+    // 组播时绑定组地址，只收本组的帧；单播调试时收本机任意地址
+    sockaddr_in local{};
+    local.sin_family = AF_INET;
+    local.sin_port = htons(options.port);
+    local.sin_addr.s_addr = is_multicast(group) ? group.s_addr : htonl(INADDR_ANY);
+    socklen_t local_len = sizeof(local);
+    if (::bind(udp_fd_, reinterpret_cast<const sockaddr*>(&local), sizeof(local)) != 0 ||
+        ::getsockname(udp_fd_, reinterpret_cast<sockaddr*>(&local), &local_len) != 0) {
+        const int bind_errno = errno;
+        close_fd(udp_fd_);
+        return fail(out_error, "failed to bind monitor feed udp port", bind_errno);
+    }
+    local_port_ = ntohs(local.sin_port);
+    if (is_multicast(group)) {
+        ip_mreq membership{};
+        membership.imr_multiaddr = group;
+        membership.imr_interface.s_addr = htonl(INADDR_ANY);
+        if ((!options.interface_address.empty() &&
+             !parse_ipv4(options.interface_address, &membership.imr_interface)) ||
+            ::setsockopt(udp_fd_, IPPROTO_IP, IP_ADD_MEMBERSHIP, &membership, sizeof(membership)) != 0) {
+            const int join_errno = errno;
+            close_fd(udp_fd_);
+            return fail(out_error, "failed to join monitor feed group " + options.group, join_errno);
+        }
+    }
+
+    options_ = options;
+    datagram_.resize(kMonitorFeedMaxFrameBytes);
+    frame_.resize(kMonitorFeedMaxFrameBytes);
+    stats_ = monitor_feed_mirror_stats{};
+    if (!resync(out_error)) {
+        stop();
+        return false;
+    }
+    return true;
+}
+
+void monitor_feed_mirror::stop() {
+    close_fd(udp_fd_);
+    expected_seq_ = 0;
+}
+
+bool monitor_feed_mirror::poll(std::size_t max_datagrams, std::size_t* out_applied, std::string* out_error) {
+    std::size_t applied = 0;
+    bool ok = true;
+    while (udp_fd_ >= 0 && applied < max_datagrams) {
+        const ssize_t received = ::recv(udp_fd_, datagram_.data(), datagram_.size(), MSG_DONTWAIT);
+        if (received < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            break;
+        }
+        ++applied;
+        if (!apply_datagram(datagram_.data(), static_cast<std::size_t>(received), out_error)) {
+            ok = false;
+            break;
+        }
+    }
+    if (out_applied) {
+        *out_applied = applied;
+    }
+    return ok;
+}
+
+bool monitor_feed_mirror::apply_datagram(const void* data, std::size_t size, std::string* out_error) {
+    if (expected_seq_ == 0) {
+        return fail(out_error, "monitor feed mirror is not started");
+    }
+    monitor_feed_frame_header header;
+    if (size < sizeof(header)) {
+        ++stats_.malformed;
+        return true;
+    }
+    std::memcpy(&header, data, sizeof(header));
+    if (!valid_header(header) || sizeof(header) + header.body_bytes != size) {
+        ++stats_.malformed;
+        return true;
+    }
+    const auto type = static_cast<monitor_feed_frame_type>(header.type);
+    if (type != monitor_feed_frame_type::Delta && type != monitor_feed_frame_type::Heartbeat) {
+        ++stats_.malformed;
+        return true;
+    }
+    if (header.session_id != session_id_) {
+        return resync(out_error);
+    }
+    if (type == monitor_feed_frame_type::Heartbeat) {
+        // 心跳序号已超过本地进度：尾部帧丢失
+        if (header.seq >= expected_seq_) {
+            ++stats_.gaps;
+            return fill(expected_seq_, out_error);
+        }
+        return true;
+    }
+    if (header.seq > expected_seq_) {
+        ++stats_.gaps;
+        // 补发覆盖到发布端当前序号，本帧必然已在其中
+        return fill(expected_seq_, out_error);
+    }
+    if (header.seq < expected_seq_) {
+        ++stats_.duplicates;
+        return true;
+    }
+    apply_records(static_cast<const unsigned char*>(data) + sizeof(header), header.body_bytes, header.record_count);
+    expected_seq_ = header.seq + 1;
+    ++stats_.frames;
+    return true;
+}
+
+bool monitor_feed_mirror::resync(std::string* out_error) {
+    orders_.clear();
+    positions_.clear();
+    position_valid_.clear();
+    has_fund_ = false;
+    return fill(0, out_error);
+}
+
+bool monitor_feed_mirror::fill(uint64_t from_seq, std::string* out_error) {
+    addrinfo hints{};
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo* result = nullptr;
+    const std::string port = std::to_string(options_.fill_port);
+    if (::getaddrinfo(options_.publisher_host.c_str(), port.c_str(), &hints, &result) != 0 || !result) {
+        return fail(out_error, "failed to resolve monitor feed publisher " + options_.publisher_host);
+    }
+    int fd = ::socket(result->ai_family, result->ai_socktype, result->ai_protocol);
+    if (fd >= 0) {
+        set_socket_timeouts(fd, options_.fill_timeout_ms);
+    }
+    const bool connected = fd >= 0 && ::connect(fd, result->ai_addr, result->ai_addrlen) == 0;
+    const int connect_errno = errno;
+    ::freeaddrinfo(result);
+    if (!connected) {
+        close_fd(fd);
+        return fail(out_error, "failed to connect monitor feed publisher", connect_errno);
+    }
+
+    monitor_feed_fill_request request;
+    request.from_seq = from_seq;
+    if (!send_all(fd, &request, sizeof(request))) {
+        close_fd(fd);
+        return fail(out_error, "failed to send monitor feed fill request", errno);
+    }
+    bool snapshot = false;
+    while (true) {
+        monitor_feed_frame_header header;
+        if (!recv_all(fd, &header, sizeof(header)) || !valid_header(header) ||
+            !recv_all(fd, frame_.data(), header.body_bytes)) {
+            close_fd(fd);
+            return fail(out_error, "monitor feed fill connection broken");
+        }
+        const auto type = static_cast<monitor_feed_frame_type>(header.type);
+        if (type == monitor_feed_frame_type::Snapshot) {
+            snapshot = true;
+        } else if (type == monitor_feed_frame_type::FillEnd) {
+            close_fd(fd);
+            session_id_ = header.session_id;
+            trading_day_ = header.trading_day;
+            expected_seq_ = header.seq + 1;
+            if (snapshot || from_seq == 0) {
+                ++stats_.snapshots;
+            } else {
+                ++stats_.fills;
+            }
+            return true;
+        } else if (type != monitor_feed_frame_type::Delta) {
+            close_fd(fd);
+            return fail(out_error, "unexpected monitor feed fill frame");
+        }
+        apply_records(frame_.data(), header.body_bytes, header.record_count);
+    }
+}
+
+void monitor_feed_mirror::apply_records(const unsigned char* body, std::size_t bytes, uint16_t record_count) {
+    std::size_t offset = 0;
+    for (uint16_t i = 0; i < record_count; ++i) {
+        monitor_feed_record_header record;
+        if (offset + sizeof(record) > bytes) {
+            ++stats_.malformed;
+            return;
+        }
+        std::memcpy(&record, body + offset, sizeof(record));
+        offset += sizeof(record);
+        if (offset + record.size > bytes) {
+            ++stats_.malformed;
+            return;
+        }
+        const unsigned char* payload = body + offset;
+        offset += record.size;
+        const auto kind = static_cast<monitor_feed_record_kind>(record.kind);
+        if (kind == monitor_feed_record_kind::Order && record.size == sizeof(acct_orders_mon_snapshot_t)) {
+            acct_orders_mon_snapshot_t snapshot;
+            std::memcpy(&snapshot, payload, sizeof(snapshot));
+            // seqlock 序号单调：补发与组播交错时不让旧快照覆盖新快照
+            auto [it, inserted] = orders_.try_emplace(record.key, snapshot);
+            if (!inserted && snapshot.seq >= it->second.seq) {
+                it->second = snapshot;
+            }
+        } else if (kind == monitor_feed_record_kind::Fund && record.size == sizeof(fund_)) {
+            std::memcpy(&fund_, payload, sizeof(fund_));
+            has_fund_ = true;
+        } else if (kind == monitor_feed_record_kind::Position &&
+                   record.size == sizeof(acct_positions_mon_position_snapshot_t)) {
+            if (record.key >= positions_.size()) {
+                positions_.resize(static_cast<std::size_t>(record.key) + 1);
+                position_valid_.resize(positions_.size(), false);
+            }
+            std::memcpy(&positions_[record.key], payload, sizeof(acct_positions_mon_position_snapshot_t));
+            position_valid_[record.key] = true;
+        } else {
+            ++stats_.malformed;
+        }
+    }
+}
+
+bool monitor_feed_mirror::read_order(uint32_t index, acct_orders_mon_snapshot_t* out_snapshot) const {
+    const auto it = orders_.find(index);
+    if (it == orders_.end() || !out_snapshot) {
+        return false;
+    }
+    *out_snapshot = it->second;
+    return true;
+}
+
+void monitor_feed_mirror::for_each_order(const monitor_feed_order_visitor& visitor) const {
+    for (const auto& entry : orders_) {
+        visitor(entry.second);
+    }
+}
+
+bool monitor_feed_mirror::read_fund(acct_positions_mon_fund_snapshot_t* out_snapshot) const {
+    if (!has_fund_ || !out_snapshot) {
+        return false;
+    }
+    *out_snapshot = fund_;
+    return true;
+}
+
+bool monitor_feed_mirror::read_position(uint32_t index, acct_positions_mon_position_snapshot_t* out_snapshot) const {
+    if (index >= positions_.size() || !position_valid_[index] || !out_snapshot) {
+        return false;
+    }
+    *out_snapshot = positions_[index];
+    return true;
+}
+
+}  // namespace acct_service
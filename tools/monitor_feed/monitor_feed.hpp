@@ -0,0 +1,252 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "api/order_monitor_api.h"
+#include "api/position_monitor_api.h"
+
+namespace acct_service {
+
+// 远程监控镜像：交易主机上的发布端经只读监控 API 跟踪订单池变更日志与持仓脏行，
+// 把变更行的稳定快照打包成带序号的 UDP 组播帧；丢帧由客户端经 TCP 向发布端补发（补发环已覆盖时改发全量快照）。
+// 远程风控只读本地镜像，不再经 ssh 隧道直读交易主机共享内存。
+// 帧内快照为 C ABI 快照结构的原始字节，要求两端为同构平台（小端、相同对齐）。
+
+enum class monitor_feed_frame_type : uint16_t {
+    Delta = 1,      // 组播增量帧，seq 从 1 连续
+    Heartbeat = 2,  // 组播心跳，seq 为已发布的最大增量序号，客户端据此发现尾部丢帧
+    Snapshot = 3,   // TCP 补发：全量快照帧，seq 为 0
+    FillEnd = 4,    // TCP 补发结束，seq 为补发内容覆盖到的增量序号
+};
+
+enum class monitor_feed_record_kind : uint8_t {
+    Order = 1,     // acct_orders_mon_snapshot_t，key 为槽位索引
+    Fund = 2,      // acct_positions_mon_fund_snapshot_t，key 为 0
+    Position = 3,  // acct_positions_mon_position_snapshot_t，key 为证券逻辑索引
+};
+
+struct monitor_feed_frame_header {
+    static constexpr uint32_t kMagic = 0x44464D41;  // "AMFD"
+    static constexpr uint16_t kVersion = 1;
+
+    uint32_t magic = kMagic;
+    uint16_t version = kVersion;
+    uint16_t type = 0;         // monitor_feed_frame_type
+    uint32_t trading_day = 0;  // YYYYMMDD 数值
+    uint16_t record_count = 0;
+    uint16_t body_bytes = 0;  // 紧随帧头的记录字节数
+    uint64_t seq = 0;
+    uint64_t publish_ns = 0;  // 发布端组帧时间（Unix Epoch ns）
+    uint64_t session_id = 0;  // 发布端启动时间，变化说明发布端重启或换日，序号从 1 重新开始
+};
+
+static_assert(sizeof(monitor_feed_frame_header) == 40, "monitor_feed_frame_header must be 40 bytes");
+
+// 帧内每条记录：8 字节记录头 + size 字节快照
+struct monitor_feed_record_header {
+    uint8_t kind = 0;  // monitor_feed_record_kind
+    uint8_t reserved = 0;
+    uint16_t size = 0;
+    uint32_t key = 0;
+};
+
+static_assert(sizeof(monitor_feed_record_header) == 8, "monitor_feed_record_header must be 8 bytes");
+
+// 客户端建 TCP 连接后发送一次，发布端回补 [from_seq, 当前序号] 的增量帧后以 FillEnd 结束并断开
+struct monitor_feed_fill_request {
+    static constexpr uint32_t kMagic = 0x51464D41;  // "AMFQ"
+
+    uint32_t magic = kMagic;
+    uint16_t version = monitor_feed_frame_header::kVersion;
+    uint16_t reserved = 0;
+    uint64_t from_seq = 0;  // 0 表示直接要全量快照
+};
+
+static_assert(sizeof(monitor_feed_fill_request) == 16, "monitor_feed_fill_request must be 16 bytes");
+
+// 单帧上限，按以太网 MTU 留余量，避免 IP 分片
+inline constexpr std::size_t kMonitorFeedMaxFrameBytes = 1400;
+
+struct monitor_feed_publisher_options {
+    std::string group = "239.10.0.1";  // 组播组；也可填单播地址做点对点调试
+    uint16_t port = 31000;
+    std::string interface_address;  // 组播出接口 IPv4 地址，空取路由默认
+    uint8_t ttl = 1;
+    std::string fill_bind_address = "0.0.0.0";
+    uint16_t fill_port = 31001;       // 0 由系统分配，见 fill_port()
+    uint32_t retain_frames = 8192;    // 补发环保留的增量帧数
+    uint32_t heartbeat_ms = 200;
+    uint32_t poll_interval_us = 200;  // 无变更时的轮询间隔
+    uint32_t fill_timeout_ms = 1000;  // 补发连接收发超时
+    int cpu = -1;                     // 发布线程绑核，-1 不绑
+};
+
+struct monitor_feed_publisher_stats {
+    uint64_t frames = 0;            // 已组播的增量帧
+    uint64_t records = 0;           // 增量帧内的记录
+    uint64_t send_failures = 0;     // sendto 失败的帧（仍占序号，客户端按丢帧补发）
+    uint64_t order_rescans = 0;     // 变更日志落后被覆盖后的全量重扫
+    uint64_t fills_served = 0;      // 按序号补发
+    uint64_t snapshots_served = 0;  // 补发环已覆盖或新客户端的全量快照
+};
+
+// 发布端：start 后由发布线程独占两个监控上下文（调用方负责打开与关闭，持仓上下文可为空）
+class monitor_feed_publisher {
+public:
+    monitor_feed_publisher() = default;
+    ~monitor_feed_publisher();
+
+    monitor_feed_publisher(const monitor_feed_publisher&) = delete;
+    monitor_feed_publisher& operator=(const monitor_feed_publisher&) = delete;
+
+    bool start(acct_orders_mon_ctx_t orders, acct_positions_mon_ctx_t positions,
+               const monitor_feed_publisher_options& options, std::string* out_error);
+    void stop();
+
+    uint16_t fill_port() const noexcept { return bound_fill_port_; }
+    monitor_feed_publisher_stats stats() const noexcept;
+
+private:
+    // 待组帧缓冲：Delta 帧写满即组播，Snapshot 帧写满即写入补发连接
+    struct frame_buffer {
+        unsigned char data[kMonitorFeedMaxFrameBytes] = {};
+        std::size_t bytes = sizeof(monitor_feed_frame_header);
+        uint16_t records = 0;
+    };
+
+    void publisher_loop();
+    bool poll_orders();
+    bool poll_positions();
+    void rescan_orders(frame_buffer& buffer, monitor_feed_frame_type type);
+    void snapshot_positions(frame_buffer& buffer);
+    bool emit_order(frame_buffer& buffer, monitor_feed_frame_type type, uint32_t index);
+    bool emit_position_row(frame_buffer& buffer, monitor_feed_frame_type type, uint32_t row);
+    void append(frame_buffer& buffer, monitor_feed_frame_type type, monitor_feed_record_kind kind, uint32_t key,
+                const void* payload, std::size_t size);
+    void finish(frame_buffer& buffer, monitor_feed_frame_type type);
+    void send_heartbeat();
+    void serve_fill();
+    void send_fill_frame(const void* data, std::size_t size);
+
+    acct_orders_mon_ctx_t orders_ = nullptr;
+    acct_positions_mon_ctx_t positions_ = nullptr;
+    monitor_feed_publisher_options options_;
+    uint32_t trading_day_ = 0;
+    uint64_t session_id_ = 0;
+    int udp_fd_ = -1;
+    int listen_fd_ = -1;
+    int fill_fd_ = -1;  // 正在服务的补发连接，仅发布线程
+    bool fill_ok_ = false;
+    uint16_t bound_fill_port_ = 0;
+    std::vector<unsigned char> destination_;  // sockaddr_in 原始字节
+
+    uint64_t journal_cursor_ = 0;
+    uint64_t position_cursor_ = 0;
+    uint64_t last_seq_ = 0;
+    uint64_t last_send_ns_ = 0;
+    std::vector<acct_orders_mon_change_t> changes_;
+    std::vector<uint32_t> order_pending_;   // 本轮待读槽位（去重后）
+    std::vector<uint32_t> order_deferred_;  // 读取时写入中，下一轮重读
+    std::vector<uint32_t> position_pending_;
+    std::vector<uint32_t> position_deferred_;
+    std::vector<uint32_t> dirty_rows_;
+    std::vector<acct_orders_mon_snapshot_t> range_rows_;
+    std::vector<uint32_t> range_unstable_;
+    std::vector<unsigned char> retained_;  // 补发环：retain_frames 个定长槽位
+    std::vector<uint16_t> retained_bytes_;
+    frame_buffer live_;
+    frame_buffer fill_;
+
+    std::atomic<bool> stop_requested_{false};
+    std::atomic<uint64_t> frames_{0};
+    std::atomic<uint64_t> records_{0};
+    std::atomic<uint64_t> send_failures_{0};
+    std::atomic<uint64_t> order_rescans_{0};
+    std::atomic<uint64_t> fills_served_{0};
+    std::atomic<uint64_t> snapshots_served_{0};
+    std::thread thread_;
+};
+
+struct monitor_feed_mirror_options {
+    std::string group = "239.10.0.1";
+    uint16_t port = 31000;          // 0 由系统分配，见 local_port()（只用 apply_datagram 喂帧时）
+    std::string interface_address;  // 加入组播的本地接口 IPv4 地址，空取系统默认
+    std::string publisher_host;     // 补发服务地址
+    uint16_t fill_port = 31001;
+    uint32_t fill_timeout_ms = 1000;
+    int receive_buffer_bytes = 4 << 20;
+};
+
+struct monitor_feed_mirror_stats {
+    uint64_t frames = 0;      // 已应用的增量帧
+    uint64_t duplicates = 0;  // 序号已覆盖而丢弃的帧
+    uint64_t malformed = 0;   // 校验失败的帧
+    uint64_t gaps = 0;        // 发现的丢帧次数
+    uint64_t fills = 0;       // 按序号补发成功
+    uint64_t snapshots = 0;   // 全量快照（含启动时的首次同步与发布端重启后的重新同步）
+};
+
+using monitor_feed_order_visitor = std::function<void(const acct_orders_mon_snapshot_t&)>;
+
+// 客户端镜像：单线程使用，poll/apply_datagram 与各读取接口须在同一线程调用。
+// 丢帧时同步向发布端补发，补发期间 poll 阻塞，最长约 fill_timeout_ms
+class monitor_feed_mirror {
+public:
+    monitor_feed_mirror() = default;
+    ~monitor_feed_mirror();
+
+    monitor_feed_mirror(const monitor_feed_mirror&) = delete;
+    monitor_feed_mirror& operator=(const monitor_feed_mirror&) = delete;
+
+    // 加入组播并拉一次全量快照；失败时镜像不可用
+    bool start(const monitor_feed_mirror_options& options, std::string* out_error);
+    void stop();
+
+    // 非阻塞收取至多 max_datagrams 个组播帧并应用；补发失败时返回 false
+    bool poll(std::size_t max_datagrams, std::size_t* out_applied, std::string* out_error);
+    // 应用一个帧（poll 内部同样走这里）；校验失败只计数，补发失败时返回 false
+    bool apply_datagram(const void* data, std::size_t size, std::string* out_error);
+
+    bool read_order(uint32_t index, acct_orders_mon_snapshot_t* out_snapshot) const;
+    void for_each_order(const monitor_feed_order_visitor& visitor) const;
+    std::size_t order_count() const noexcept { return orders_.size(); }
+    bool read_fund(acct_positions_mon_fund_snapshot_t* out_snapshot) const;
+    bool read_position(uint32_t index, acct_positions_mon_position_snapshot_t* out_snapshot) const;
+    std::size_t position_count() const noexcept { return positions_.size(); }
+
+    uint16_t local_port() const noexcept { return local_port_; }
+    uint32_t trading_day() const noexcept { return trading_day_; }
+    // 已应用到的增量序号
+    uint64_t applied_seq() const noexcept { return expected_seq_ == 0 ? 0 : expected_seq_ - 1; }
+    const monitor_feed_mirror_stats& stats() const noexcept { return stats_; }
+
+private:
+    bool fill(uint64_t from_seq, std::string* out_error);
+    // 发布端重启或换日：清空镜像后重新全量同步
+    bool resync(std::string* out_error);
+    void apply_records(const unsigned char* body, std::size_t bytes, uint16_t record_count);
+
+    monitor_feed_mirror_options options_;
+    int udp_fd_ = -1;
+    uint16_t local_port_ = 0;
+    uint32_t trading_day_ = 0;
+    uint64_t session_id_ = 0;
+    uint64_t expected_seq_ = 0;  // 下一个待应用的增量序号，0 表示尚未同步
+    std::unordered_map<uint32_t, acct_orders_mon_snapshot_t> orders_;
+    std::vector<acct_positions_mon_position_snapshot_t> positions_;
+    std::vector<bool> position_valid_;
+    acct_positions_mon_fund_snapshot_t fund_{};
+    bool has_fund_ = false;
+    std::vector<unsigned char> datagram_;  // poll 收取的组播帧
+    std::vector<unsigned char> frame_;     // 补发连接上的帧
+    monitor_feed_mirror_stats stats_{};
+};
+
+}  // namespace acct_service
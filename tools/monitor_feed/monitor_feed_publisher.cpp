@@ -0,0 +1,166 @@
+#include <sched.h>
+#include <sys/resource.h>
+
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cinttypes>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+
+#include "monitor_feed.hpp"
+
+namespace acct_service {
+namespace {
+
+std::atomic<bool> g_stop{false};
+
+void handle_stop(int) { g_stop.store(true, std::memory_order_relaxed); }
+
+// 打印命令行帮助：只读打开订单池（可选持仓池），把变更组播给远程镜像，并在 fill 端口提供 TCP 补发。
+void print_usage(const char* program_name) {
+    std::fprintf(stderr,
+                 "Usage: %s --trading-day YYYYMMDD [--orders-shm NAME] [--positions-shm NAME]\n"
+                 "          [--group ADDR] [--port N] [--interface ADDR] [--ttl N] [--fill-bind ADDR] [--fill-port N]\n"
+                 "          [--retain-frames N] [--heartbeat-ms N] [--cpu N] [--nice N]\n",
+                 program_name);
+}
+
+bool parse_u32(const char* text, uint32_t& out) {
+    char* end = nullptr;
+    errno = 0;
+    const unsigned long value = std::strtoul(text, &end, 10);
+    if (errno != 0 || end == text || *end != '\0' || value > UINT32_MAX) {
+        return false;
+    }
+    out = static_cast<uint32_t>(value);
+    return true;
+}
+
+bool parse_port(const char* text, uint16_t& out) {
+    uint32_t value = 0;
+    if (!parse_u32(text, value) || value == 0 || value > 65535) {
+        return false;
+    }
+    out = static_cast<uint16_t>(value);
+    return true;
+}
+
+}  // namespace
+}  // namespace acct_service
+
+int main(int argc, char** argv) {
+    using namespace acct_service;
+
+    std::string orders_shm_name = "/orders_shm";
+    std::string positions_shm_name;
+    std::string trading_day;
+    monitor_feed_publisher_options options;
+    uint32_t nice_value = 10;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        const bool has_value = i + 1 < argc;
+        bool ok = true;
+        uint32_t value = 0;
+        if (arg == "--orders-shm" && has_value) {
+            orders_shm_name = argv[++i];
+        } else if (arg == "--positions-shm" && has_value) {
+            positions_shm_name = argv[++i];
+        } else if (arg == "--trading-day" && has_value) {
+            trading_day = argv[++i];
+        } else if (arg == "--group" && has_value) {
+            options.group = argv[++i];
+        } else if (arg == "--port" && has_value) {
+            ok = parse_port(argv[++i], options.port);
+        } else if (arg == "--interface" && has_value) {
+            options.interface_address = argv[++i];
+        } else if (arg == "--ttl" && has_value) {
+            ok = parse_u32(argv[++i], value) && value <= 255;
+            options.ttl = static_cast<uint8_t>(value);
+        } else if (arg == "--fill-bind" && has_value) {
+            options.fill_bind_address = argv[++i];
+        } else if (arg == "--fill-port" && has_value) {
+            ok = parse_port(argv[++i], options.fill_port);
+        } else if (arg == "--retain-frames" && has_value) {
+            ok = parse_u32(argv[++i], options.retain_frames) && options.retain_frames > 0;
+        } else if (arg == "--heartbeat-ms" && has_value) {
+            ok = parse_u32(argv[++i], options.heartbeat_ms) && options.heartbeat_ms > 0;
+        } else if (arg == "--cpu" && has_value) {
+            ok = parse_u32(argv[++i], value) && value < CPU_SETSIZE;
+            options.cpu = static_cast<int>(value);
+        } else if (arg == "--nice" && has_value) {
+            ok = parse_u32(argv[++i], nice_value) && nice_value <= 19;
+        } else {
+            ok = false;
+        }
+        if (!ok) {
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+    if (trading_day.empty()) {
+        print_usage(argv[0]);
+        return 1;
+    }
+    // 与日终导出相同：默认降到 nice 10，可用 --cpu 绑到非隔离核
+    if (::setpriority(PRIO_PROCESS, 0, static_cast<int>(nice_value)) != 0) {
+        std::fprintf(stderr, "failed to set publisher nice %u: %s\n", nice_value, std::strerror(errno));
+    }
+
+    acct_orders_mon_options_t orders_options{};
+    orders_options.orders_shm_name = orders_shm_name.c_str();
+    orders_options.trading_day = trading_day.c_str();
+    acct_orders_mon_ctx_t orders = nullptr;
+    const acct_mon_error_t orders_rc = acct_orders_mon_open(&orders_options, &orders);
+    if (orders_rc != ACCT_MON_OK) {
+        std::fprintf(stderr, "acct_orders_mon_open failed: %s\n", acct_orders_mon_strerror(orders_rc));
+        return 1;
+    }
+    acct_positions_mon_ctx_t positions = nullptr;
+    if (!positions_shm_name.empty()) {
+        acct_positions_mon_options_t positions_options{};
+        positions_options.positions_shm_name = positions_shm_name.c_str();
+        const acct_pos_mon_error_t positions_rc = acct_positions_mon_open(&positions_options, &positions);
+        if (positions_rc != ACCT_POS_MON_OK) {
+            std::fprintf(stderr, "acct_positions_mon_open failed: %s\n", acct_positions_mon_strerror(positions_rc));
+            (void)acct_orders_mon_close(orders);
+            return 1;
+        }
+    }
+
+    std::signal(SIGINT, handle_stop);
+    std::signal(SIGTERM, handle_stop);
+    monitor_feed_publisher publisher;
+    std::string error;
+    if (!publisher.start(orders, positions, options, &error)) {
+        std::fprintf(stderr, "publisher start failed: %s\n", error.c_str());
+        if (positions) {
+            (void)acct_positions_mon_close(positions);
+        }
+        (void)acct_orders_mon_close(orders);
+        return 1;
+    }
+    std::fprintf(stderr, "publishing %s to %s:%u, fill port %u\n", trading_day.c_str(), options.group.c_str(),
+                 static_cast<unsigned>(options.port), static_cast<unsigned>(publisher.fill_port()));
+    while (!g_stop.load(std::memory_order_relaxed)) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+    publisher.stop();
+
+    const monitor_feed_publisher_stats stats = publisher.stats();
+    std::fprintf(stderr,
+                 "frames=%" PRIu64 " records=%" PRIu64 " send_failures=%" PRIu64 " order_rescans=%" PRIu64
+                 " fills_served=%" PRIu64 " snapshots_served=%" PRIu64 "\n",
+                 stats.frames, stats.records, stats.send_failures, stats.order_rescans, stats.fills_served,
+                 stats.snapshots_served);
+    if (positions) {
+        (void)acct_positions_mon_close(positions);
+    }
+    (void)acct_orders_mon_close(orders);
+    return 0;
+}
@@ -0,0 +1,92 @@
+#include <cinttypes>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <string_view>
+
+#include "order/order_event_codec.hpp"
+#include "order/order_journal.hpp"
+#include "order/passive_execution.hpp"
+
+namespace acct_service {
+namespace {
+
+// 打印命令行帮助：逐个解码给定段文件或增量记录文件，输出与文本业务日志同名的 key=value 字段。
+void print_usage(const char* program_name) {
+    std::fprintf(stderr, "Usage: %s SEGMENT.bin|EVENTS.evd [SEGMENT.bin|EVENTS.evd ...]\n", program_name);
+}
+
+// 每条记录一行；枚举按数值输出，执行算法沿用业务日志的算法名。
+void print_record(const order_journal_record& record) {
+    std::printf("ts_ns=%" PRIu64 " event=\"%s\" order_id=%" PRIu32 " parent_order_id=%" PRIu32
+                " strategy_id=%u shm_order_index=%" PRIu32 " is_split_child=%s order_type=%u trade_side=%u"
+                " market=%u order_state=0x%02x passive_execution_algo=\"%s\" execution_algo=\"%s\""
+                " execution_state=%u volume_entrust=%" PRIu64 " volume_traded=%" PRIu64 " volume_remain=%" PRIu64
+                " target_volume=%" PRIu64 " working_volume=%" PRIu64 " schedulable_volume=%" PRIu64
+                " dprice_entrust=%" PRIu64 " dprice_traded=%" PRIu64 " dvalue_traded=%" PRIu64
+                " dfee_executed=%" PRIu64 " security_id=\"%s\" internal_security_id=\"%s\"\n",
+                record.ts_ns, order_journal_event_name(record.event), record.order_id, record.parent_order_id,
+                static_cast<unsigned>(record.strategy_id), record.shm_order_index,
+                (record.flags & kOrderJournalSplitChild) ? "true" : "false",
+                static_cast<unsigned>(record.order_type), static_cast<unsigned>(record.trade_side),
+                static_cast<unsigned>(record.market), static_cast<unsigned>(record.order_state),
+                passive_execution_algo_name(record.passive_execution_algo),
+                passive_execution_algo_name(record.execution_algo), static_cast<unsigned>(record.execution_state),
+                record.volume_entrust, record.volume_traded, record.volume_remain, record.target_volume,
+                record.working_volume, record.schedulable_volume, record.dprice_entrust, record.dprice_traded,
+                record.dvalue_traded, record.dfee_executed, record.security_id.c_str(),
+                record.internal_security_id.c_str());
+}
+
+// 增量记录文件还原为完整记录，逐行输出与文本模式相同的日志行。
+bool dump_delta_file(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        std::fprintf(stderr, "failed to open order event file %s\n", path.c_str());
+        return false;
+    }
+    const std::string data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+
+    order_event_delta_decoder decoder;
+    std::size_t records = 0;
+    std::size_t corrupt = 0;
+    decoder.decode(
+        data,
+        [](const OrderEventRecord& record, AccountId account_id, std::string_view trading_day) {
+            write_order_event_line(std::cout, record, account_id, trading_day);
+        },
+        &records, &corrupt);
+    std::cout.flush();
+    std::fprintf(stderr, "%s: %zu records, %zu corrupt bytes skipped\n", path.c_str(), records, corrupt);
+    return corrupt == 0;
+}
+
+bool is_delta_file(std::string_view path) { return path.ends_with(".evd"); }
+
+}  // namespace
+}  // namespace acct_service
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        acct_service::print_usage(argv[0]);
+        return 1;
+    }
+
+    int exit_code = 0;
+    for (int i = 1; i < argc; ++i) {
+        if (acct_service::is_delta_file(argv[i])) {
+            exit_code = acct_service::dump_delta_file(argv[i]) ? exit_code : 1;
+            continue;
+        }
+        std::size_t records = 0;
+        if (!acct_service::order_journal_read_segment(argv[i], acct_service::print_record, &records)) {
+            std::fprintf(stderr, "failed to decode order journal segment %s\n", argv[i]);
+            exit_code = 1;
+            continue;
+        }
+        std::fprintf(stderr, "%s: %zu records\n", argv[i], records);
+    }
+    return exit_code;
+}
@@ -0,0 +1,620 @@
+#include "orders_columnar.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <thread>
+#include <unordered_map>
+
+#if defined(ACCT_HAS_ZLIB)
+#include <zlib.h>
+#endif
+
+namespace acct_service {
+namespace {
+
+// 单块行数上限：保证列数据解压后字节数落在 uint32_t 内
+constexpr uint32_t kMaxBlockRows = 1U << 20;
+constexpr auto kRereadBackoff = std::chrono::microseconds(50);
+
+using snapshot = acct_orders_mon_snapshot_t;
+
+// 小枚举列：按块内最大值的位宽打包
+constexpr uint8_t snapshot::* kPackedColumns[] = {
+    &snapshot::stage,        &snapshot::source,
+    &snapshot::order_type,   &snapshot::passive_exec_algo,
+    &snapshot::trade_side,   &snapshot::market,
+    &snapshot::order_status, &snapshot::active_strategy_claimed,
+    &snapshot::execution_algo, &snapshot::execution_state,
+};
+
+constexpr uint32_t snapshot::* kTimeColumns[] = {
+    &snapshot::md_time_driven,          &snapshot::md_time_entrust,
+    &snapshot::md_time_cancel_sent,     &snapshot::md_time_cancel_done,
+    &snapshot::md_time_broker_response, &snapshot::md_time_market_response,
+    &snapshot::md_time_traded_first,    &snapshot::md_time_traded_latest,
+};
+
+constexpr uint64_t snapshot::* kValueColumns[] = {
+    &snapshot::volume_entrust, &snapshot::volume_traded,      &snapshot::volume_remain,
+    &snapshot::target_volume,  &snapshot::working_volume,     &snapshot::schedulable_volume,
+    &snapshot::dprice_entrust, &snapshot::dprice_traded,      &snapshot::dvalue_traded,
+    &snapshot::dfee_estimate,  &snapshot::dfee_executed,      &snapshot::broker_order_id_u64,
+};
+
+void set_error(std::string* out_error, const std::string& message) {
+    if (out_error != nullptr) {
+        *out_error = message;
+    }
+}
+
+uint64_t unix_time_ns() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                     std::chrono::system_clock::now().time_since_epoch())
+                                     .count());
+}
+
+uint64_t zigzag(int64_t value) noexcept {
+    return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+}
+
+int64_t unzigzag(uint64_t value) noexcept {
+    return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
+
+void put_varint(std::vector<uint8_t>& out, uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(value));
+}
+
+// 差分按模 2^64 计算，解码时同样按模还原
+void put_delta(std::vector<uint8_t>& out, uint64_t& previous, uint64_t value) {
+    put_varint(out, zigzag(static_cast<int64_t>(value - previous)));
+    previous = value;
+}
+
+void put_string(std::vector<uint8_t>& out, const char* data, std::size_t max_len) {
+    const std::size_t len = ::strnlen(data, max_len);
+    put_varint(out, len);
+    out.insert(out.end(), data, data + len);
+}
+
+// 1 字节位宽 + 按位宽从低位起连续打包的值；位宽为 0 时全列为 0，不占数据字节
+template <typename Get>
+void put_packed(std::vector<uint8_t>& out, std::size_t count, Get get) {
+    uint32_t max_value = 0;
+    for (std::size_t i = 0; i < count; ++i) {
+        max_value = std::max(max_value, get(i));
+    }
+    const uint32_t width = static_cast<uint32_t>(std::bit_width(max_value));
+    out.push_back(static_cast<uint8_t>(width));
+    uint64_t buffer = 0;
+    uint32_t buffered = 0;
+    for (std::size_t i = 0; i < count && width > 0; ++i) {
+        buffer |= static_cast<uint64_t>(get(i)) << buffered;
+        buffered += width;
+        while (buffered >= 8) {
+            out.push_back(static_cast<uint8_t>(buffer));
+            buffer >>= 8;
+            buffered -= 8;
+        }
+    }
+    if (buffered > 0) {
+        out.push_back(static_cast<uint8_t>(buffer));
+    }
+}
+
+class byte_reader {
+public:
+    byte_reader(const uint8_t* data, std::size_t size) noexcept : cursor_(data), end_(data + size) {}
+
+    bool ok() const noexcept { return ok_; }
+    bool at_end() const noexcept { return cursor_ == end_; }
+
+    uint64_t varint() noexcept {
+        uint64_t value = 0;
+        for (uint32_t shift = 0; shift < 64; shift += 7) {
+            if (cursor_ == end_) {
+                break;
+            }
+            const uint8_t byte = *cursor_++;
+            value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0) {
+                return value;
+            }
+        }
+        ok_ = false;
+        return 0;
+    }
+
+    uint64_t delta(uint64_t& previous) noexcept {
+        previous += static_cast<uint64_t>(unzigzag(varint()));
+        return previous;
+    }
+
+    void string(char* out, std::size_t max_len) noexcept {
+        const uint64_t len = varint();
+        if (len > max_len || static_cast<uint64_t>(end_ - cursor_) < len) {
+            ok_ = false;
+            return;
+        }
+        std::memcpy(out, cursor_, len);
+        cursor_ += len;
+    }
+
+    template <typename Set>
+    void packed(std::size_t count, Set set) noexcept {
+        if (cursor_ == end_) {
+            ok_ = false;
+            return;
+        }
+        const uint32_t width = *cursor_++;
+        if (width > 32) {
+            ok_ = false;
+            return;
+        }
+        const std::size_t bytes = (count * width + 7) / 8;
+        if (static_cast<std::size_t>(end_ - cursor_) < bytes) {
+            ok_ = false;
+            return;
+        }
+        const uint64_t mask = (uint64_t{1} << width) - 1;
+        uint64_t buffer = 0;
+        uint32_t buffered = 0;
+        for (std::size_t i = 0; i < count && width > 0; ++i) {
+            while (buffered < width) {
+                buffer |= static_cast<uint64_t>(*cursor_++) << buffered;
+                buffered += 8;
+            }
+            set(i, static_cast<uint32_t>(buffer & mask));
+            buffer >>= width;
+            buffered -= width;
+        }
+        if (width == 0) {
+            for (std::size_t i = 0; i < count; ++i) {
+                set(i, 0);
+            }
+        }
+    }
+
+private:
+    const uint8_t* cursor_;
+    const uint8_t* end_;
+    bool ok_ = true;
+};
+
+// 块内证券字典的键：内部证券 ID 与证券代码两段定长拼接
+std::string security_key(const snapshot& row) {
+    std::string key(row.internal_security_id, ::strnlen(row.internal_security_id, ACCT_MON_INTERNAL_SECURITY_ID_LEN));
+    key.push_back('\0');
+    key.append(row.security_id, ::strnlen(row.security_id, ACCT_MON_SECURITY_ID_LEN));
+    return key;
+}
+
+uint32_t encode_block(const std::vector<snapshot>& rows, std::vector<uint8_t>& out) {
+    const std::size_t count = rows.size();
+    out.clear();
+
+    uint64_t previous = rows.front().index;
+    for (const snapshot& row : rows) {
+        put_delta(out, previous, row.index);
+    }
+    for (const snapshot& row : rows) {
+        put_varint(out, row.seq);
+    }
+    previous = 0;
+    for (const snapshot& row : rows) {
+        put_delta(out, previous, row.last_update_ns);
+    }
+    previous = 0;
+    for (const snapshot& row : rows) {
+        put_delta(out, previous, row.internal_order_id);
+    }
+    previous = 0;
+    for (const snapshot& row : rows) {
+        put_delta(out, previous, row.orig_internal_order_id);
+    }
+    for (const auto column : kPackedColumns) {
+        put_packed(out, count, [&](std::size_t i) { return static_cast<uint32_t>(rows[i].*column); });
+    }
+
+    // 字典按首次出现顺序编号
+    std::unordered_map<std::string, uint32_t> dictionary;
+    std::vector<uint32_t> codes(count);
+    std::vector<std::size_t> entries;
+    for (std::size_t i = 0; i < count; ++i) {
+        const auto [it, inserted] = dictionary.try_emplace(security_key(rows[i]), static_cast<uint32_t>(entries.size()));
+        if (inserted) {
+            entries.push_back(i);
+        }
+        codes[i] = it->second;
+    }
+    put_varint(out, entries.size());
+    for (const std::size_t i : entries) {
+        put_string(out, rows[i].internal_security_id, ACCT_MON_INTERNAL_SECURITY_ID_LEN);
+        put_string(out, rows[i].security_id, ACCT_MON_SECURITY_ID_LEN);
+    }
+    put_packed(out, count, [&](std::size_t i) { return codes[i]; });
+
+    for (const auto column : kTimeColumns) {
+        for (const snapshot& row : rows) {
+            put_varint(out, row.*column);
+        }
+    }
+    for (const auto column : kValueColumns) {
+        for (const snapshot& row : rows) {
+            put_varint(out, row.*column);
+        }
+    }
+    for (const snapshot& row : rows) {
+        put_string(out, row.broker_order_id, ACCT_MON_BROKER_ORDER_ID_LEN);
+    }
+    return static_cast<uint32_t>(entries.size());
+}
+
+bool decode_block(const uint8_t* data, std::size_t size, const orders_columnar_block_header& header,
+                  std::vector<snapshot>& rows) {
+    const std::size_t count = header.row_count;
+    rows.assign(count, snapshot{});
+    byte_reader reader(data, size);
+
+    uint64_t previous = header.first_index;
+    for (snapshot& row : rows) {
+        row.index = static_cast<uint32_t>(reader.delta(previous));
+    }
+    for (snapshot& row : rows) {
+        row.seq = reader.varint();
+    }
+    previous = 0;
+    for (snapshot& row : rows) {
+        row.last_update_ns = reader.delta(previous);
+    }
+    previous = 0;
+    for (snapshot& row : rows) {
+        row.internal_order_id = static_cast<uint32_t>(reader.delta(previous));
+    }
+    previous = 0;
+    for (snapshot& row : rows) {
+        row.orig_internal_order_id = static_cast<uint32_t>(reader.delta(previous));
+    }
+    for (const auto column : kPackedColumns) {
+        reader.packed(count, [&](std::size_t i, uint32_t value) { rows[i].*column = static_cast<uint8_t>(value); });
+    }
+
+    const uint64_t dictionary_size = reader.varint();
+    if (dictionary_size != header.dictionary_size || dictionary_size > count) {
+        return false;
+    }
+    std::vector<snapshot> entries(dictionary_size);
+    for (snapshot& entry : entries) {
+        reader.string(entry.internal_security_id, ACCT_MON_INTERNAL_SECURITY_ID_LEN);
+        reader.string(entry.security_id, ACCT_MON_SECURITY_ID_LEN);
+    }
+    bool codes_valid = true;
+    reader.packed(count, [&](std::size_t i, uint32_t code) {
+        if (code >= entries.size()) {
+            codes_valid = false;
+            return;
+        }
+        std::memcpy(rows[i].internal_security_id, entries[code].internal_security_id, ACCT_MON_INTERNAL_SECURITY_ID_LEN);
+        std::memcpy(rows[i].security_id, entries[code].security_id, ACCT_MON_SECURITY_ID_LEN);
+    });
+
+    for (const auto column : kTimeColumns) {
+        for (snapshot& row : rows) {
+            row.*column = static_cast<uint32_t>(reader.varint());
+        }
+    }
+    for (const auto column : kValueColumns) {
+        for (snapshot& row : rows) {
+            row.*column = reader.varint();
+        }
+    }
+    for (snapshot& row : rows) {
+        reader.string(row.broker_order_id, ACCT_MON_BROKER_ORDER_ID_LEN);
+    }
+    return codes_valid && reader.ok() && reader.at_end();
+}
+
+bool compress_block(orders_columnar_codec codec, int level, const std::vector<uint8_t>& raw,
+                    std::vector<uint8_t>& out) {
+    switch (codec) {
+        case orders_columnar_codec::None:
+            out = raw;
+            return true;
+#if defined(ACCT_HAS_ZLIB)
+        case orders_columnar_codec::Zlib: {
+            uLongf stored = compressBound(static_cast<uLong>(raw.size()));
+            out.resize(stored);
+            if (compress2(out.data(), &stored, raw.data(), static_cast<uLong>(raw.size()), level) != Z_OK) {
+                return false;
+            }
+            out.resize(stored);
+            return true;
+        }
+#endif
+        default:
+            (void)level;
+            return false;
+    }
+}
+
+bool decompress_block(orders_columnar_codec codec, const std::vector<uint8_t>& stored, uint32_t raw_bytes,
+                      std::vector<uint8_t>& out) {
+    switch (codec) {
+        case orders_columnar_codec::None:
+            out = stored;
+            return out.size() == raw_bytes;
+#if defined(ACCT_HAS_ZLIB)
+        case orders_columnar_codec::Zlib: {
+            out.resize(raw_bytes);
+            uLongf size = raw_bytes;
+            return uncompress(out.data(), &size, stored.data(), static_cast<uLong>(stored.size())) == Z_OK &&
+                   size == raw_bytes;
+        }
+#endif
+        default:
+            return false;
+    }
+}
+
+}  // namespace
+
+bool orders_columnar_codec_available(orders_columnar_codec codec) noexcept {
+    switch (codec) {
+        case orders_columnar_codec::None:
+            return true;
+        case orders_columnar_codec::Zlib:
+#if defined(ACCT_HAS_ZLIB)
+            return true;
+#else
+            return false;
+#endif
+        default:
+            return false;
+    }
+}
+
+orders_columnar_writer::~orders_columnar_writer() {
+    if (file_ != nullptr) {
+        std::fclose(file_);
+    }
+}
+
+bool orders_columnar_writer::open(const std::string& path, const acct_orders_mon_info_t& info,
+                                  const orders_columnar_options& options, std::string* out_error) {
+    if (file_ != nullptr) {
+        set_error(out_error, "columnar writer is already open");
+        return false;
+    }
+    if (options.block_rows == 0 || options.block_rows > kMaxBlockRows) {
+        set_error(out_error, "block_rows must be in [1, " + std::to_string(kMaxBlockRows) + "]");
+        return false;
+    }
+    if (!orders_columnar_codec_available(options.codec)) {
+        set_error(out_error, "compression codec is not available in this build");
+        return false;
+    }
+
+    file_ = std::fopen(path.c_str(), "wb");
+    if (file_ == nullptr) {
+        set_error(out_error, "failed to create " + path + ": " + std::strerror(errno));
+        return false;
+    }
+    options_ = options;
+    header_ = orders_columnar_file_header{};
+    header_.codec = static_cast<uint16_t>(options.codec);
+    header_.block_rows = options.block_rows;
+    header_.capacity = info.capacity;
+    header_.create_time_ns = unix_time_ns();
+    std::memcpy(header_.trading_day, info.trading_day, ACCT_MON_TRADING_DAY_LEN);
+    stats_ = orders_columnar_stats{};
+    stats_.stored_bytes = sizeof(header_);
+    rows_.clear();
+    rows_.reserve(options.block_rows);
+    // 文件头先占位，close() 时回填行数与块数
+    if (std::fwrite(&header_, sizeof(header_), 1, file_) != 1) {
+        set_error(out_error, "failed to write columnar file header to " + path);
+        return false;
+    }
+    return true;
+}
+
+bool orders_columnar_writer::append(const acct_orders_mon_snapshot_t& snapshot, std::string* out_error) {
+    if (file_ == nullptr) {
+        set_error(out_error, "columnar writer is not open");
+        return false;
+    }
+    rows_.push_back(snapshot);
+    return rows_.size() < options_.block_rows || flush_block(out_error);
+}
+
+bool orders_columnar_writer::flush_block(std::string* out_error) {
+    if (rows_.empty()) {
+        return true;
+    }
+    orders_columnar_block_header block{};
+    block.row_count = static_cast<uint32_t>(rows_.size());
+    block.first_index = rows_.front().index;
+    block.dictionary_size = encode_block(rows_, encoded_);
+    block.raw_bytes = static_cast<uint32_t>(encoded_.size());
+    if (!compress_block(options_.codec, options_.compression_level, encoded_, compressed_)) {
+        set_error(out_error, "failed to compress columnar block");
+        return false;
+    }
+    block.stored_bytes = static_cast<uint32_t>(compressed_.size());
+    if (std::fwrite(&block, sizeof(block), 1, file_) != 1 ||
+        std::fwrite(compressed_.data(), 1, compressed_.size(), file_) != compressed_.size()) {
+        set_error(out_error, "failed to write columnar block");
+        return false;
+    }
+
+    stats_.rows += block.row_count;
+    ++stats_.blocks;
+    stats_.raw_bytes += block.raw_bytes;
+    stats_.stored_bytes += sizeof(block) + block.stored_bytes;
+    rows_.clear();
+    return true;
+}
+
+bool orders_columnar_writer::close(std::string* out_error) {
+    if (file_ == nullptr) {
+        return true;
+    }
+    bool ok = flush_block(out_error);
+    header_.row_count = stats_.rows;
+    header_.block_count = stats_.blocks;
+    if (ok && (std::fseek(file_, 0, SEEK_SET) != 0 || std::fwrite(&header_, sizeof(header_), 1, file_) != 1)) {
+        set_error(out_error, "failed to finalize columnar file header");
+        ok = false;
+    }
+    if (std::fclose(file_) != 0 && ok) {
+        set_error(out_error, "failed to close columnar file");
+        ok = false;
+    }
+    file_ = nullptr;
+    return ok;
+}
+
+bool orders_columnar_read_file(const std::string& path, const orders_columnar_visitor& visitor,
+                               orders_columnar_file_header* out_header, std::string* out_error) {
+    std::FILE* file = std::fopen(path.c_str(), "rb");
+    if (file == nullptr) {
+        set_error(out_error, "failed to open " + path + ": " + std::strerror(errno));
+        return false;
+    }
+    const auto fail = [&](const std::string& message) {
+        std::fclose(file);
+        set_error(out_error, message);
+        return false;
+    };
+
+    orders_columnar_file_header header{};
+    if (std::fread(&header, sizeof(header), 1, file) != 1 || header.magic != orders_columnar_file_header::kMagic ||
+        header.version != orders_columnar_file_header::kVersion) {
+        return fail("invalid columnar file header in " + path);
+    }
+    const auto codec = static_cast<orders_columnar_codec>(header.codec);
+    if (!orders_columnar_codec_available(codec)) {
+        return fail("columnar file codec is not available in this build");
+    }
+
+    std::vector<uint8_t> stored;
+    std::vector<uint8_t> raw;
+    std::vector<snapshot> rows;
+    for (uint64_t block_index = 0; block_index < header.block_count; ++block_index) {
+        orders_columnar_block_header block{};
+        if (std::fread(&block, sizeof(block), 1, file) != 1 || block.magic != orders_columnar_block_header::kMagic ||
+            block.row_count == 0 || block.row_count > header.block_rows) {
+            return fail("invalid columnar block header at block " + std::to_string(block_index));
+        }
+        stored.resize(block.stored_bytes);
+        if (std::fread(stored.data(), 1, stored.size(), file) != stored.size() ||
+            !decompress_block(codec, stored, block.raw_bytes, raw) ||
+            !decode_block(raw.data(), raw.size(), block, rows)) {
+            return fail("corrupt columnar block " + std::to_string(block_index));
+        }
+        for (const snapshot& row : rows) {
+            visitor(row);
+        }
+    }
+    std::fclose(file);
+    if (out_header != nullptr) {
+        *out_header = header;
+    }
+    return true;
+}
+
+bool orders_columnar_export(acct_orders_mon_ctx_t ctx, const std::string& path,
+                            const orders_columnar_export_options& options, orders_columnar_export_stats* out_stats,
+                            std::string* out_error) {
+    if (options.read_batch == 0) {
+        set_error(out_error, "read_batch must be positive");
+        return false;
+    }
+    acct_orders_mon_info_t info{};
+    acct_mon_error_t rc = acct_orders_mon_info(ctx, &info);
+    if (rc != ACCT_MON_OK) {
+        set_error(out_error, std::string("acct_orders_mon_info failed: ") + acct_orders_mon_strerror(rc));
+        return false;
+    }
+
+    orders_columnar_writer writer;
+    if (!writer.open(path, info, options.columnar, out_error)) {
+        return false;
+    }
+    orders_columnar_export_stats stats{};
+    std::vector<snapshot> batch(options.read_batch);
+    std::vector<uint32_t> unstable(options.read_batch);
+
+    // 大块顺序读取；写入中的槽位逐个重读后按索引并回批内，保证输出仍按索引升序
+    const auto export_range = [&](uint32_t begin, uint32_t end) {
+        for (uint32_t cursor = begin; cursor < end;) {
+            const uint32_t stop = cursor + std::min(end - cursor, options.read_batch);
+            std::size_t count = 0;
+            std::size_t unstable_count = 0;
+            rc = acct_orders_mon_read_range(ctx, cursor, stop, batch.data(), &count, unstable.data(),
+                                            &unstable_count);
+            if (rc != ACCT_MON_OK && rc != ACCT_MON_ERR_RETRY) {
+                set_error(out_error, std::string("acct_orders_mon_read_range failed: ") +
+                                         acct_orders_mon_strerror(rc));
+                return false;
+            }
+            stats.slots_scanned += stop - cursor;
+
+            const std::size_t stable = count;
+            for (std::size_t i = 0; i < unstable_count; ++i) {
+                bool reread = false;
+                for (uint32_t round = 0; round < options.retry_rounds; ++round) {
+                    rc = acct_orders_mon_read(ctx, unstable[i], &batch[count]);
+                    if (rc != ACCT_MON_ERR_RETRY) {
+                        reread = rc == ACCT_MON_OK;
+                        break;
+                    }
+                    std::this_thread::sleep_for(kRereadBackoff);
+                }
+                if (reread) {
+                    ++count;
+                    ++stats.unstable_reread;
+                } else {
+                    ++stats.unstable_lost;
+                }
+            }
+            if (count > stable) {
+                std::inplace_merge(batch.begin(), batch.begin() + static_cast<std::ptrdiff_t>(stable),
+                                   batch.begin() + static_cast<std::ptrdiff_t>(count),
+                                   [](const snapshot& lhs, const snapshot& rhs) { return lhs.index < rhs.index; });
+            }
+
+            for (std::size_t i = 0; i < count; ++i) {
+                if (!options.include_empty && batch[i].stage == ACCT_MON_STAGE_EMPTY) {
+                    continue;
+                }
+                if (!writer.append(batch[i], out_error)) {
+                    return false;
+                }
+            }
+            cursor = stop;
+        }
+        return true;
+    };
+
+    bool ok = export_range(0, info.next_index);
+    const uint32_t segments = std::min<uint32_t>(info.overflow_segments, ACCT_MON_MAX_OVERFLOW_SEGMENTS);
+    for (uint32_t k = 0; ok && k < segments; ++k) {
+        ok = export_range((k + 1) << ACCT_MON_INDEX_SEGMENT_SHIFT, info.overflow_next_index[k]);
+    }
+    ok = writer.close(ok ? out_error : nullptr) && ok;
+    stats.columnar = writer.stats();
+    if (out_stats != nullptr) {
+        *out_stats = stats;
+    }
+    return ok;
+}
+
+}  // namespace acct_service
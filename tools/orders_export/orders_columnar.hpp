@@ -0,0 +1,123 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "api/order_monitor_api.h"
+
+namespace acct_service {
+
+// 订单池日终列存文件：64 字节文件头 + 若干块，每块 = 32 字节块头 + 压缩后的列数据。
+// 块内按列连续存放：索引/订单号/时间戳为差分 zigzag varint，证券为块内字典 + 位宽压缩的字典码，
+// 阶段、方向、市场等小枚举按各列实际最大值的位宽打包；其余数值为 varint，字符串为长度前缀。
+struct orders_columnar_file_header {
+    static constexpr uint32_t kMagic = 0x4C4F434F;  // "OCOL"
+    static constexpr uint16_t kVersion = 1;
+
+    uint32_t magic = kMagic;
+    uint16_t version = kVersion;
+    uint16_t codec = 0;  // orders_columnar_codec
+    uint32_t block_rows = 0;
+    uint32_t capacity = 0;           // 主段容量
+    uint64_t create_time_ns = 0;     // 导出开始时间（Unix Epoch ns）
+    uint64_t row_count = 0;          // 全部块的行数，close() 时回填
+    uint64_t block_count = 0;        // 块数，close() 时回填
+    char trading_day[16] = {};
+    uint8_t reserved[8] = {};
+};
+
+static_assert(sizeof(orders_columnar_file_header) == 64, "orders_columnar_file_header must be 64 bytes");
+
+struct orders_columnar_block_header {
+    static constexpr uint32_t kMagic = 0x4B42434F;  // "OCBK"
+
+    uint32_t magic = kMagic;
+    uint32_t row_count = 0;
+    uint32_t raw_bytes = 0;     // 列数据解压后字节数
+    uint32_t stored_bytes = 0;  // 紧随块头的字节数
+    uint32_t first_index = 0;   // 块内首行槽位索引
+    uint32_t dictionary_size = 0;
+    uint8_t reserved[8] = {};
+};
+
+static_assert(sizeof(orders_columnar_block_header) == 32, "orders_columnar_block_header must be 32 bytes");
+
+// 块压缩算法；构建环境无 zlib 时只能写 None
+enum class orders_columnar_codec : uint16_t {
+    None = 0,
+    Zlib = 1,
+};
+
+bool orders_columnar_codec_available(orders_columnar_codec codec) noexcept;
+
+struct orders_columnar_options {
+    uint32_t block_rows = 65536;
+    orders_columnar_codec codec = orders_columnar_codec::Zlib;
+    int compression_level = 6;  // zlib 1-9
+};
+
+struct orders_columnar_stats {
+    uint64_t rows = 0;
+    uint64_t blocks = 0;
+    uint64_t raw_bytes = 0;     // 列编码后、压缩前
+    uint64_t stored_bytes = 0;  // 落盘（含文件头与块头）
+};
+
+// 顺序写出列存文件：append 只把快照拷进当前块，写满 block_rows 时编码、压缩并 fwrite
+class orders_columnar_writer {
+public:
+    orders_columnar_writer() = default;
+    ~orders_columnar_writer();
+
+    orders_columnar_writer(const orders_columnar_writer&) = delete;
+    orders_columnar_writer& operator=(const orders_columnar_writer&) = delete;
+
+    bool open(const std::string& path, const acct_orders_mon_info_t& info, const orders_columnar_options& options,
+              std::string* out_error);
+    bool append(const acct_orders_mon_snapshot_t& snapshot, std::string* out_error);
+    // 写出最后一块并回填文件头；失败时文件不完整
+    bool close(std::string* out_error);
+
+    const orders_columnar_stats& stats() const noexcept { return stats_; }
+
+private:
+    bool flush_block(std::string* out_error);
+
+    std::FILE* file_ = nullptr;
+    orders_columnar_file_header header_{};
+    orders_columnar_options options_{};
+    std::vector<acct_orders_mon_snapshot_t> rows_;
+    std::vector<uint8_t> encoded_;
+    std::vector<uint8_t> compressed_;
+    orders_columnar_stats stats_{};
+};
+
+using orders_columnar_visitor = std::function<void(const acct_orders_mon_snapshot_t&)>;
+
+// 按块解压解码并按写入顺序回调每行；文件头或任一块不合法时返回 false
+bool orders_columnar_read_file(const std::string& path, const orders_columnar_visitor& visitor,
+                               orders_columnar_file_header* out_header, std::string* out_error);
+
+struct orders_columnar_export_options {
+    orders_columnar_options columnar{};
+    uint32_t read_batch = 65536;    // 单次 acct_orders_mon_read_range 的槽位数
+    uint32_t retry_rounds = 64;     // 不稳定槽位逐个重读的轮数，每轮间隔 50us
+    bool include_empty = false;     // 是否导出已预留未使用的 Empty 槽位
+};
+
+struct orders_columnar_export_stats {
+    orders_columnar_stats columnar{};
+    uint64_t slots_scanned = 0;
+    uint64_t unstable_reread = 0;  // 批量读取时写入中、随后逐个重读成功的槽位
+    uint64_t unstable_lost = 0;    // 重读轮数用尽仍不稳定而未导出的槽位
+};
+
+// 经监控 API 批量快照读取主段与各溢出段的已发布槽位并写出列存文件；只读共享内存，可在账户服务运行时执行
+bool orders_columnar_export(acct_orders_mon_ctx_t ctx, const std::string& path,
+                            const orders_columnar_export_options& options, orders_columnar_export_stats* out_stats,
+                            std::string* out_error);
+
+}  // namespace acct_service
@@ -0,0 +1,184 @@
+#include <sched.h>
+#include <sys/resource.h>
+
+#include <cerrno>
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#include "orders_columnar.hpp"
+
+namespace acct_service {
+namespace {
+
+// 打印命令行帮助：导出模式只读打开订单池，经批量快照接口写出日终列存文件；--dump 把列存文件解码为 CSV。
+void print_usage(const char* program_name) {
+    std::fprintf(stderr,
+                 "Usage: %s --trading-day YYYYMMDD --output FILE [--orders-shm NAME] [--block-rows N]\n"
+                 "          [--read-batch N] [--codec zlib|none] [--level N] [--cpu N] [--nice N] [--include-empty]\n"
+                 "       %s --dump FILE\n",
+                 program_name, program_name);
+}
+
+bool parse_u32(const char* text, uint32_t& out) {
+    char* end = nullptr;
+    errno = 0;
+    const unsigned long value = std::strtoul(text, &end, 10);
+    if (errno != 0 || end == text || *end != '\0' || value > UINT32_MAX) {
+        return false;
+    }
+    out = static_cast<uint32_t>(value);
+    return true;
+}
+
+// 导出在账户服务运行期间执行：默认降到 nice 10，可绑到非隔离核，避免与事件循环争核
+bool leave_hot_cores(int cpu, int nice_value) {
+    if (cpu >= 0) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cpu, &set);
+        if (::sched_setaffinity(0, sizeof(set), &set) != 0) {
+            std::fprintf(stderr, "failed to pin exporter to cpu %d: %s\n", cpu, std::strerror(errno));
+            return false;
+        }
+    }
+    if (::setpriority(PRIO_PROCESS, 0, nice_value) != 0) {
+        std::fprintf(stderr, "failed to set exporter nice %d: %s\n", nice_value, std::strerror(errno));
+    }
+    return true;
+}
+
+// 每行一条订单，列顺序与快照结构一致；字符串字段不含逗号，不做转义
+void print_csv_row(const acct_orders_mon_snapshot_t& row) {
+    std::printf("%" PRIu32 ",%" PRIu64 ",%" PRIu64 ",%u,%u,%u,%u,%u,%u,%u,%u,%u,%u,%.*s,%.*s,%" PRIu32 ",%" PRIu32
+                ",%" PRIu32 ",%" PRIu32 ",%" PRIu32 ",%" PRIu32 ",%" PRIu32 ",%" PRIu32 ",%" PRIu32 ",%" PRIu32
+                ",%" PRIu64 ",%" PRIu64 ",%" PRIu64 ",%" PRIu64 ",%" PRIu64 ",%" PRIu64 ",%" PRIu64 ",%" PRIu64
+                ",%" PRIu64 ",%" PRIu64 ",%" PRIu64 ",%" PRIu64 ",%.*s\n",
+                row.index, row.seq, row.last_update_ns, static_cast<unsigned>(row.stage),
+                static_cast<unsigned>(row.source), static_cast<unsigned>(row.order_type),
+                static_cast<unsigned>(row.passive_exec_algo), static_cast<unsigned>(row.trade_side),
+                static_cast<unsigned>(row.market), static_cast<unsigned>(row.order_status),
+                static_cast<unsigned>(row.active_strategy_claimed), static_cast<unsigned>(row.execution_algo),
+                static_cast<unsigned>(row.execution_state), ACCT_MON_SECURITY_ID_LEN, row.security_id,
+                ACCT_MON_INTERNAL_SECURITY_ID_LEN, row.internal_security_id, row.internal_order_id,
+                row.orig_internal_order_id, row.md_time_driven, row.md_time_entrust, row.md_time_cancel_sent,
+                row.md_time_cancel_done, row.md_time_broker_response, row.md_time_market_response,
+                row.md_time_traded_first, row.md_time_traded_latest, row.volume_entrust, row.volume_traded,
+                row.volume_remain, row.target_volume, row.working_volume, row.schedulable_volume, row.dprice_entrust,
+                row.dprice_traded, row.dvalue_traded, row.dfee_estimate, row.dfee_executed,
+                row.broker_order_id_u64, ACCT_MON_BROKER_ORDER_ID_LEN, row.broker_order_id);
+}
+
+int dump(const std::string& path) {
+    std::printf(
+        "index,seq,last_update_ns,stage,source,order_type,passive_exec_algo,trade_side,market,order_status,"
+        "active_strategy_claimed,execution_algo,execution_state,security_id,internal_security_id,internal_order_id,"
+        "orig_internal_order_id,md_time_driven,md_time_entrust,md_time_cancel_sent,md_time_cancel_done,"
+        "md_time_broker_response,md_time_market_response,md_time_traded_first,md_time_traded_latest,"
+        "volume_entrust,volume_traded,volume_remain,target_volume,working_volume,schedulable_volume,"
+        "dprice_entrust,dprice_traded,dvalue_traded,dfee_estimate,dfee_executed,broker_order_id_u64,"
+        "broker_order_id\n");
+    orders_columnar_file_header header{};
+    std::string error;
+    if (!orders_columnar_read_file(path, print_csv_row, &header, &error)) {
+        std::fprintf(stderr, "%s\n", error.c_str());
+        return 1;
+    }
+    std::fprintf(stderr, "%s: trading_day=%s rows=%" PRIu64 " blocks=%" PRIu64 "\n", path.c_str(),
+                 header.trading_day, header.row_count, header.block_count);
+    return 0;
+}
+
+}  // namespace
+}  // namespace acct_service
+
+int main(int argc, char** argv) {
+    using namespace acct_service;
+
+    std::string orders_shm_name = "/orders_shm";
+    std::string trading_day;
+    std::string output;
+    orders_columnar_export_options options;
+    uint32_t level = static_cast<uint32_t>(options.columnar.compression_level);
+    uint32_t nice_value = 10;
+    int cpu = -1;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        const bool has_value = i + 1 < argc;
+        bool ok = true;
+        if (arg == "--dump" && has_value) {
+            return dump(argv[++i]);
+        } else if (arg == "--orders-shm" && has_value) {
+            orders_shm_name = argv[++i];
+        } else if (arg == "--trading-day" && has_value) {
+            trading_day = argv[++i];
+        } else if (arg == "--output" && has_value) {
+            output = argv[++i];
+        } else if (arg == "--block-rows" && has_value) {
+            ok = parse_u32(argv[++i], options.columnar.block_rows);
+        } else if (arg == "--read-batch" && has_value) {
+            ok = parse_u32(argv[++i], options.read_batch);
+        } else if (arg == "--level" && has_value) {
+            ok = parse_u32(argv[++i], level) && level >= 1 && level <= 9;
+        } else if (arg == "--codec" && has_value) {
+            const std::string codec = argv[++i];
+            ok = codec == "zlib" || codec == "none";
+            options.columnar.codec = codec == "none" ? orders_columnar_codec::None : orders_columnar_codec::Zlib;
+        } else if (arg == "--cpu" && has_value) {
+            uint32_t value = 0;
+            ok = parse_u32(argv[++i], value) && value < CPU_SETSIZE;
+            cpu = static_cast<int>(value);
+        } else if (arg == "--nice" && has_value) {
+            ok = parse_u32(argv[++i], nice_value) && nice_value <= 19;
+        } else if (arg == "--include-empty") {
+            options.include_empty = true;
+        } else {
+            ok = false;
+        }
+        if (!ok) {
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+    if (trading_day.empty() || output.empty()) {
+        print_usage(argv[0]);
+        return 1;
+    }
+    options.columnar.compression_level = static_cast<int>(level);
+    if (!leave_hot_cores(cpu, static_cast<int>(nice_value))) {
+        return 1;
+    }
+
+    acct_orders_mon_options_t mon_options{};
+    mon_options.orders_shm_name = orders_shm_name.c_str();
+    mon_options.trading_day = trading_day.c_str();
+    acct_orders_mon_ctx_t ctx = nullptr;
+    const acct_mon_error_t rc = acct_orders_mon_open(&mon_options, &ctx);
+    if (rc != ACCT_MON_OK) {
+        std::fprintf(stderr, "acct_orders_mon_open failed: %s\n", acct_orders_mon_strerror(rc));
+        return 1;
+    }
+
+    const auto started = std::chrono::steady_clock::now();
+    orders_columnar_export_stats stats{};
+    std::string error;
+    const bool ok = orders_columnar_export(ctx, output, options, &stats, &error);
+    const auto elapsed_ms =
+        std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - started).count();
+    (void)acct_orders_mon_close(ctx);
+    if (!ok) {
+        std::fprintf(stderr, "export failed: %s\n", error.c_str());
+        return 1;
+    }
+    std::fprintf(stderr,
+                 "%s: scanned=%" PRIu64 " rows=%" PRIu64 " blocks=%" PRIu64 " raw_bytes=%" PRIu64
+                 " stored_bytes=%" PRIu64 " unstable_reread=%" PRIu64 " unstable_lost=%" PRIu64 " elapsed_ms=%lld\n",
+                 output.c_str(), stats.slots_scanned, stats.columnar.rows, stats.columnar.blocks,
+                 stats.columnar.raw_bytes, stats.columnar.stored_bytes, stats.unstable_reread, stats.unstable_lost,
+                 static_cast<long long>(elapsed_ms));
+    return stats.unstable_lost == 0 ? 0 : 2;
+}
@@ -0,0 +1,45 @@
+#include <cinttypes>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "portfolio/position_csv_parser.hpp"
+
+namespace acct_service {
+namespace {
+
+// 打印命令行帮助：用账户服务启动时同一解析器校验持仓快照 CSV（盘后导入前检查），输出行数与分阶段耗时。
+void print_usage(const char* program_name) { std::fprintf(stderr, "Usage: %s POSITIONS_CSV [--rows]\n", program_name); }
+
+}  // namespace
+}  // namespace acct_service
+
+int main(int argc, char** argv) {
+    using namespace acct_service;
+
+    if (argc < 2 || argc > 3 || (argc == 3 && std::string(argv[2]) != "--rows")) {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    std::vector<position_seed_row> rows;
+    position_csv_timings timings;
+    bool exists = false;
+    if (!load_position_csv(argv[1], rows, exists, timings)) {
+        return 1;
+    }
+    if (!exists) {
+        std::fprintf(stderr, "position csv %s not found\n", argv[1]);
+        return 1;
+    }
+
+    if (argc == 3) {
+        for (const position_seed_row& row : rows) {
+            std::printf("%s t0=%" PRIu64 " t1=%" PRIu64 " buy=%" PRIu64 " sell=%" PRIu64 " orders=%" PRIu64 "\n",
+                        row.security_id.c_str(), row.volume_available_t0, row.volume_available_t1,
+                        row.volume_buy, row.volume_sell, row.count_order);
+        }
+    }
+    std::printf("%s\n", format_position_csv_timings(timings).c_str());
+    return 0;
+}
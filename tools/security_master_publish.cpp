@@ -0,0 +1,76 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "portfolio/security_master.hpp"
+#include "shm/orders_shm.hpp"
+#include "shm/shm_manager.hpp"
+
+namespace acct_service {
+namespace {
+
+// 打印命令行帮助：读取主数据 CSV，为 --trading-day 交易日整表发布到 --output 指定的段。
+void print_usage(const char* program_name) {
+    std::fprintf(stderr,
+                 "Usage: %s --input SECURITY_MASTER_CSV --trading-day YYYYMMDD [--output SECURITY_MASTER_SHM_NAME]\n",
+                 program_name);
+}
+
+struct options {
+    std::string input;
+    std::string output = "/security_master_shm";
+    std::string trading_day;
+};
+
+bool parse_options(int argc, char** argv, options& out) {
+    for (int i = 1; i < argc; ++i) {
+        const bool has_value = i + 1 < argc;
+        if (std::strcmp(argv[i], "--input") == 0 && has_value) {
+            out.input = argv[++i];
+        } else if (std::strcmp(argv[i], "--output") == 0 && has_value) {
+            out.output = argv[++i];
+        } else if (std::strcmp(argv[i], "--trading-day") == 0 && has_value) {
+            out.trading_day = argv[++i];
+        } else {
+            return false;
+        }
+    }
+    return !out.input.empty() && !out.output.empty() && trading_day_number(out.trading_day) != 0;
+}
+
+}  // namespace
+}  // namespace acct_service
+
+int main(int argc, char** argv) {
+    using namespace acct_service;
+
+    options opts;
+    if (!parse_options(argc, argv, opts)) {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    std::vector<security_master_record> records;
+    if (!load_security_master_csv(opts.input, records)) {
+        std::fprintf(stderr, "failed to load security master csv %s\n", opts.input.c_str());
+        return 1;
+    }
+
+    // 每次发布重新建段：已映射旧段的账户进程保留旧映射，重启后才读到新交易日数据
+    SHMManager manager;
+    (void)SHMManager::unlink(opts.output);
+    security_master_shm_layout* shm = manager.open_security_master(opts.output, shm_mode::Create);
+    if (!shm) {
+        std::fprintf(stderr, "failed to create security master shm %s\n", opts.output.c_str());
+        return 1;
+    }
+    if (!publish_security_master(*shm, records, trading_day_number(opts.trading_day))) {
+        std::fprintf(stderr, "failed to publish security master\n");
+        return 1;
+    }
+    std::printf("published %zu securities to %s (indexed=%s)\n", records.size(), opts.output.c_str(),
+                shm->slot_count > 0 ? "yes" : "no");
+    return 0;
+}
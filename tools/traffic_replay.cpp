@@ -0,0 +1,323 @@
+#include <cerrno>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <unordered_set>
+
+#include "common/time_utils.hpp"
+#include "core/event_loop.hpp"
+#include "core/traffic_capture.hpp"
+#include "order/order_router.hpp"
+#include "portfolio/position_manager.hpp"
+#include "risk/risk_manager.hpp"
+#include "shm/orders_shm.hpp"
+
+namespace acct_service {
+namespace {
+
+// 回放 CLI 参数：把 traffic_capture 录制文件喂回一个全新的进程内事件循环，下游由桩网关直接丢弃
+struct traffic_replay_options {
+    std::string file_path{};
+    double speed = 0.0;               // 回放倍速，0 表示不按录制时刻尽快推入
+    uint32_t poll_batch_size = 64;    // 回放事件循环的 poll_batch_size
+    uint64_t warmup_records = 0;      // 前若干条记录不计入吞吐与延迟统计
+};
+
+constexpr std::size_t kMaxBurstRecords = 4096;
+constexpr Volume kSeedPositionVolume = 1'000'000'000;
+constexpr DValue kSeedFund = 1'000'000'000'000'000LL;
+// 推完后连续空转这么多轮仍无工作才结束，给拆单子单与归档留出收尾
+constexpr int kDrainIdleIterations = 64;
+
+void print_usage(const char* program_name) {
+    std::fprintf(stderr,
+                 "Usage: %s --file PATH [--speed X] [--poll-batch N] [--warmup-records N]\n"
+                 "  --speed 1 replays at recorded pace, --speed 0 (default) pushes as fast as the loop drains\n",
+                 program_name);
+}
+
+bool parse_u64(const char* text, uint64_t& out_value) {
+    if (text == nullptr) {
+        return false;
+    }
+    char* end = nullptr;
+    errno = 0;
+    const unsigned long long parsed = std::strtoull(text, &end, 10);
+    if (errno != 0 || end == text || *end != '\0') {
+        return false;
+    }
+    out_value = static_cast<uint64_t>(parsed);
+    return true;
+}
+
+bool parse_double(const char* text, double& out_value) {
+    if (text == nullptr) {
+        return false;
+    }
+    char* end = nullptr;
+    errno = 0;
+    const double parsed = std::strtod(text, &end);
+    if (errno != 0 || end == text || *end != '\0' || parsed < 0.0) {
+        return false;
+    }
+    out_value = parsed;
+    return true;
+}
+
+bool parse_cli_args(int argc, char** argv, traffic_replay_options& out_options) {
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (i + 1 >= argc) {
+            std::fprintf(stderr, "missing value for %s\n", arg.c_str());
+            return false;
+        }
+        const char* value = argv[++i];
+        bool ok = true;
+        uint64_t parsed = 0;
+        if (arg == "--file") {
+            out_options.file_path = value;
+        } else if (arg == "--speed") {
+            ok = parse_double(value, out_options.speed);
+        } else if (arg == "--poll-batch") {
+            ok = parse_u64(value, parsed) && parsed > 0 && parsed <= UINT32_MAX;
+            out_options.poll_batch_size = static_cast<uint32_t>(parsed);
+        } else if (arg == "--warmup-records") {
+            ok = parse_u64(value, out_options.warmup_records);
+        } else {
+            std::fprintf(stderr, "unknown argument: %s\n", arg.c_str());
+            return false;
+        }
+        if (!ok) {
+            std::fprintf(stderr, "invalid %s value: %s\n", arg.c_str(), value);
+            return false;
+        }
+    }
+    if (out_options.file_path.empty()) {
+        print_usage(argv[0]);
+        return false;
+    }
+    return true;
+}
+
+void init_header(SHMHeader& header) {
+    header.magic = SHMHeader::kMagic;
+    header.version = SHMHeader::kVersion;
+    header.create_time = now_ns();
+    header.last_update = header.create_time;
+    header.next_id_epoch.store(1, std::memory_order_relaxed);
+}
+
+std::unique_ptr<orders_shm_layout> make_orders_shm(uint32_t trading_day) {
+    auto shm = std::make_unique<orders_shm_layout>();
+    shm->header.magic = OrdersHeader::kMagic;
+    shm->header.version = OrdersHeader::kVersion;
+    shm->header.header_size = static_cast<uint32_t>(sizeof(OrdersHeader));
+    shm->header.total_size = static_cast<uint32_t>(sizeof(orders_shm_layout));
+    shm->header.capacity = static_cast<uint32_t>(kDailyOrderPoolCapacity);
+    shm->header.init_state = 1;
+    shm->header.next_index.store(0, std::memory_order_relaxed);
+    // 录制头里的交易日超出 8 位时视为无效，与缺省一样落到 19700101
+    if (trading_day == 0 || trading_day > 99999999U) {
+        trading_day = 19700101U;
+    }
+    const std::string day = trading_day_string(trading_day);
+    std::memcpy(shm->header.trading_day, day.data(), sizeof(shm->header.trading_day) - 1);
+    shm->header.trading_day[sizeof(shm->header.trading_day) - 1] = '\0';
+    return shm;
+}
+
+std::unique_ptr<positions_shm_layout> make_positions_shm() {
+    auto shm = std::make_unique<positions_shm_layout>();
+    shm->header.magic = PositionsHeader::kMagic;
+    shm->header.version = PositionsHeader::kVersion;
+    shm->header.header_size = static_cast<uint32_t>(sizeof(PositionsHeader));
+    shm->header.total_size = static_cast<uint32_t>(sizeof(positions_shm_layout));
+    shm->header.capacity = static_cast<uint32_t>(kMaxPositions);
+    shm->header.init_state = 0;
+    shm->header.id.store(1, std::memory_order_relaxed);
+    shm->position_count.store(0, std::memory_order_relaxed);
+    return shm;
+}
+
+// 录制中出现的证券逐个登记并备足持仓，资金一次备足：回放衡量的是处理路径耗时，不复现录制时的资金与持仓约束
+bool seed_positions(const traffic_capture_file& file, PositionManager& positions) {
+    std::unordered_set<std::string> seen;
+    for (std::size_t i = 0; i < file.record_count(); ++i) {
+        const traffic_capture_record& record = file.record(i);
+        if (record.kind == traffic_capture_kind::Response) {
+            continue;
+        }
+        OrderRequest request;
+        std::memcpy(static_cast<void*>(&request), record.payload, sizeof(OrderRequest));
+        if (request.order_type != OrderType::New || request.security_id.empty()) {
+            continue;
+        }
+        const std::string key = std::to_string(static_cast<int>(request.market)) + "|" +
+                                std::string(request.security_id.view());
+        if (!seen.insert(key).second) {
+            continue;
+        }
+        const InternalSecurityId security_id =
+            positions.add_security(request.security_id.view(), request.security_id.view(), request.market);
+        (void)positions.add_position(positions.resolve_security_handle(security_id), kSeedPositionVolume, 0, 0);
+    }
+    return positions.add_fund(kSeedFund, 0);
+}
+
+// 桩网关：丢弃事件循环推入下游三条队列的消息，回报只来自录制文件
+std::size_t discard_downstream(downstream_shm_layout& downstream) {
+    std::size_t discarded = 0;
+    OrderIndex index = kInvalidOrderIndex;
+    while (downstream.order_queue.try_pop(index)) {
+        ++discarded;
+    }
+    downstream_order_message message;
+    while (downstream.order_payload_queue.try_pop(message)) {
+        ++discarded;
+    }
+    while (downstream.cancel_queue.try_pop(message)) {
+        ++discarded;
+    }
+    return discarded;
+}
+
+void print_histogram(const char* name, const latency_histogram& histogram) {
+    std::printf("  %-20s count=%llu mean_ns=%.0f p50_ns=%llu p99_ns=%llu p999_ns=%llu max_ns=%llu\n", name,
+                static_cast<unsigned long long>(histogram.count.load(std::memory_order_relaxed)),
+                histogram.mean_ns(), static_cast<unsigned long long>(histogram.percentile(0.50)),
+                static_cast<unsigned long long>(histogram.percentile(0.99)),
+                static_cast<unsigned long long>(histogram.percentile(0.999)),
+                static_cast<unsigned long long>(histogram.max_ns.load(std::memory_order_relaxed)));
+}
+
+int run_replay(const traffic_replay_options& options) {
+    traffic_capture_file file;
+    if (!file.open(options.file_path)) {
+        std::fprintf(stderr, "failed to open capture file: %s\n", options.file_path.c_str());
+        return 1;
+    }
+    (void)tsc_clock::calibrate();
+
+    auto upstream = std::make_unique<upstream_shm_layout>();
+    init_header(upstream->header);
+    auto downstream = std::make_unique<downstream_shm_layout>();
+    init_header(downstream->header);
+    auto trades = std::make_unique<trades_shm_layout>();
+    init_header(trades->header);
+    trades->response_queue.init();
+    auto orders_shm = make_orders_shm(file.header().trading_day);
+    auto positions_shm = make_positions_shm();
+
+    PositionManager positions(positions_shm.get());
+    if (!positions.initialize(file.header().account_id) || !seed_positions(file, positions)) {
+        std::fprintf(stderr, "failed to seed positions for replay\n");
+        return 1;
+    }
+
+    RiskConfig risk_cfg;
+    risk_cfg.enable_position_check = false;
+    risk_cfg.enable_price_limit_check = false;
+    risk_cfg.enable_duplicate_check = false;
+    risk_cfg.max_order_volume = 0;
+    risk_cfg.max_order_value = 0;
+    risk_cfg.max_orders_per_second = 0;
+    RiskManager risk(positions, risk_cfg);
+
+    auto book = std::make_unique<OrderBook>();
+    order_router router(*book, downstream.get(), orders_shm.get(), upstream.get());
+
+    EventLoopConfig loop_cfg;
+    loop_cfg.poll_batch_size = options.poll_batch_size;
+    loop_cfg.stats_interval_ms = 0;
+    loop_cfg.archive_terminal_orders = true;
+    loop_cfg.terminal_archive_delay_ms = 0;
+    EventLoop loop(loop_cfg, upstream.get(), downstream.get(), trades.get(), orders_shm.get(), *book, router,
+                   positions, risk);
+
+    traffic_replayer replayer(file, upstream.get(), trades.get(), orders_shm.get());
+    replayer.prepare();
+    if (!loop.start()) {
+        std::fprintf(stderr, "failed to start replay event loop\n");
+        return 1;
+    }
+
+    // 预热段按尽快推入跑完后清零统计，计时从第一条计入记录开始
+    const std::size_t warmup = static_cast<std::size_t>(std::min<uint64_t>(options.warmup_records, file.record_count()));
+    while (replayer.cursor() < warmup) {
+        (void)replayer.publish_next(std::min(kMaxBurstRecords, warmup - replayer.cursor()));
+        (void)loop.run_once();
+        (void)discard_downstream(*downstream);
+    }
+    for (int idle = 0; idle < kDrainIdleIterations;) {
+        idle = loop.run_once() == 0 ? idle + 1 : 0;
+        (void)discard_downstream(*downstream);
+    }
+    loop.reset_stats();
+    const uint64_t warmup_orders = replayer.orders_published();
+    const uint64_t warmup_responses = replayer.responses_published();
+
+    const bool as_fast_as_possible = options.speed == 0.0;
+    const uint64_t base_offset = replayer.next_offset_ns() == UINT64_MAX ? 0 : replayer.next_offset_ns();
+    uint64_t max_lag_ns = 0;
+    const TimestampNs start_ns = now_monotonic_ns();
+    int idle = 0;
+    while (!replayer.done() || idle < kDrainIdleIterations) {
+        if (!replayer.done()) {
+            if (as_fast_as_possible) {
+                (void)replayer.publish_next(kMaxBurstRecords);
+            } else {
+                const auto elapsed = static_cast<double>(now_monotonic_ns() - start_ns);
+                const uint64_t offset = base_offset + static_cast<uint64_t>(elapsed * options.speed);
+                const uint64_t next_offset = replayer.next_offset_ns();
+                if (next_offset <= offset) {
+                    const auto lag_ns = static_cast<uint64_t>(static_cast<double>(offset - next_offset) / options.speed);
+                    max_lag_ns = std::max(max_lag_ns, lag_ns);
+                    (void)replayer.publish_until(offset, kMaxBurstRecords);
+                }
+            }
+        }
+        const std::size_t work = loop.run_once();
+        (void)discard_downstream(*downstream);
+        idle = (work == 0 && replayer.done()) ? idle + 1 : 0;
+    }
+    const TimestampNs elapsed_ns = now_monotonic_ns() - start_ns;
+    loop.finish();
+
+    const event_loop_stats& stats = loop.stats();
+    const uint64_t orders = replayer.orders_published() - warmup_orders;
+    const uint64_t responses = replayer.responses_published() - warmup_responses;
+    const double elapsed_s = static_cast<double>(elapsed_ns) / 1e9;
+    const double recorded_s = static_cast<double>(file.duration_ns() - base_offset) / 1e9;
+    std::printf("[replay] records=%zu orders=%llu responses=%llu elapsed_ms=%.1f effective_speed=%.1fx "
+                "records_per_s=%.0f max_lag_us=%.1f\n",
+                file.record_count() - warmup, static_cast<unsigned long long>(orders),
+                static_cast<unsigned long long>(responses), elapsed_s * 1e3,
+                elapsed_s > 0.0 ? recorded_s / elapsed_s : 0.0,
+                elapsed_s > 0.0 ? static_cast<double>(orders + responses) / elapsed_s : 0.0,
+                static_cast<double>(max_lag_ns) / 1e3);
+    std::printf("  %-20s processed_orders=%llu processed_responses=%llu avg_ns=%.0f max_ns=%llu\n", "iteration",
+                static_cast<unsigned long long>(stats.orders_processed),
+                static_cast<unsigned long long>(stats.responses_processed), stats.avg_latency_ns(),
+                static_cast<unsigned long long>(stats.max_latency_ns));
+    const stage_latency_stats& stages = loop.stage_latency();
+    print_histogram("upstream_to_risk", stages.upstream_to_risk);
+    print_histogram("risk_to_downstream", stages.risk_to_downstream);
+    print_histogram("response_to_settle", stages.response_to_settle);
+    return 0;
+}
+
+}  // namespace
+}  // namespace acct_service
+
+int main(int argc, char** argv) {
+    using namespace acct_service;
+
+    traffic_replay_options options{};
+    if (!parse_cli_args(argc, argv, options)) {
+        return 1;
+    }
+    return run_replay(options);
+}